@@ -1,10 +1,61 @@
 #ifndef OPENMC_ANGLE_ENERGY_H
 #define OPENMC_ANGLE_ENERGY_H
 
+#include <cstddef> // for size_t
 #include <cstdint>
+#include <vector>
+
+#include "openmc/search.h"
 
 namespace openmc {
 
+//==============================================================================
+//! Incident energy at which secondaries are sampled, remembering where it was
+//! last located on an incident energy grid. When several secondaries are
+//! sampled at the same energy, as for the neutrons of a fission event, a
+//! distribution then searches its grid only once.
+//==============================================================================
+
+class EnergyContext {
+public:
+  explicit EnergyContext(double E) : E_{E} {}
+
+  //! Incident energy in [eV]
+  double E() const { return E_; }
+
+  //! Find the bin of an incident energy grid containing the energy and the
+  //! interpolation factor within it. Outside of the grid, the first or last
+  //! bin is chosen.
+  //! \param[in] grid Incident energies in [eV]
+  //! \param[out] i Index of the bin
+  //! \param[out] r Interpolation factor
+  void locate(const std::vector<double>& grid, int& i, double& r)
+  {
+    if (grid.data() != grid_) {
+      auto n = grid.size();
+      if (E_ < grid[0]) {
+        i_ = 0;
+        r_ = 0.0;
+      } else if (E_ > grid[n - 1]) {
+        i_ = n - 2;
+        r_ = 1.0;
+      } else {
+        i_ = lower_bound_index(grid.begin(), grid.end(), E_);
+        r_ = (E_ - grid[i_]) / (grid[i_ + 1] - grid[i_]);
+      }
+      grid_ = grid.data();
+    }
+    i = i_;
+    r = r_;
+  }
+
+private:
+  double E_; //!< Incident energy in [eV]
+  const double* grid_ {nullptr}; //!< Grid last searched
+  int i_; //!< Bin of the energy on the grid last searched
+  double r_; //!< Interpolation factor within the bin
+};
+
 //==============================================================================
 //! Abstract type that defines a correlated or uncorrelated angle-energy
 //! distribution that is a function of incoming energy. Each derived type must
@@ -16,6 +67,21 @@ class AngleEnergy {
 public:
   virtual void sample(double E_in, double& E_out, double& mu,
     uint64_t* seed) const = 0;
+
+  //! Sample at an incident energy whose location on the grid of the
+  //! distribution may be reused. Distributions that do not search an incident
+  //! energy grid need not override this.
+  virtual void sample(EnergyContext& E_in, double& E_out, double& mu,
+    uint64_t* seed) const
+  {
+    this->sample(E_in.E(), E_out, mu, seed);
+  }
+
+  //! Memory held by the tabulated data of the distribution, which is only
+  //! accounted for by thermal scattering distributions
+  //! \return Size in bytes
+  virtual std::size_t memory() const { return 0; }
+
   virtual ~AngleEnergy() = default;
 };
 
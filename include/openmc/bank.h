@@ -22,6 +22,17 @@ extern SharedArray<Particle::Bank> fission_bank;
 
 extern std::vector<int64_t> progeny_per_particle;
 
+extern std::vector<Particle::Bank> temp_sites;
+
+//! Particles that crossed the surfaces of the surface source
+extern SharedArray<Particle::Bank> surf_source_bank;
+
+//! Particles that reached the census time
+extern SharedArray<Particle::Bank> census_bank;
+
+//! Number of particles that reached the census time after the bank was full
+extern int64_t n_census_discarded;
+
 } // namespace simulation
 
 //==============================================================================
@@ -30,6 +41,67 @@ extern std::vector<int64_t> progeny_per_particle;
 
 void sort_fission_bank();
 
+//! Order the source sites of this process along a Morton curve over the
+//! bounding box of the sites of all processes, so that consecutive histories
+//! start close to each other. This must be called on all processes.
+//
+//! The key of each site only depends on the site and the box, so the sites of
+//! a process are in the order they would have among the sites at the same
+//! positions with a single process. Results are reproducible for a given
+//! number of processes, but not bitwise identical across numbers of processes,
+//! since each process only orders its own sites and the random number stream
+//! of a history depends on its position in the bank.
+void sort_source_bank();
+
+//! Get storage for the sites sampled from the fission bank
+//
+//! When the sites are shared among the processes on a node, the storage lives
+//! in a shared memory window and this must be called by every process on the
+//! node.
+//! \param n Number of sites that the storage must hold
+//! \return Pointer to the first site
+Particle::Bank* reserve_temp_sites(int64_t n);
+
+#ifdef OPENMC_MPI
+//! Get the sites sampled by another process on the same node
+//
+//! \param node_rank Rank of the process within the node
+//! \return Pointer to the first site sampled by the process
+const Particle::Bank* node_temp_sites(int node_rank);
+
+//! Synchronize the sampled sites shared among the processes on a node
+void sync_temp_sites();
+#endif
+
+//! Record a particle crossing one of the surfaces of the surface source
+//
+//! The site is stored in a buffer of the calling thread so that sites are added
+//! to simulation::surf_source_bank a whole history at a time.
+//! \param p Particle that is crossing the surface
+void bank_surface_source(const Particle& p);
+
+//! Add the sites recorded by the calling thread to the surface source bank.
+//! Sites that do not fit in the bank are discarded.
+void flush_surface_source();
+
+//! Record a site created by the fission event being sampled
+//
+//! The site is stored in a buffer of the calling thread so that the sites of a
+//! collision are added to simulation::fission_bank with a single atomic
+//! operation.
+//! \param site Fission site
+void bank_fission_site(const Particle::Bank& site);
+
+//! Add the sites recorded by the calling thread to the fission bank. If they
+//! do not all fit in the bank, none of them are added.
+//! \return Whether the sites were added
+bool flush_fission_sites();
+
+//! Record a particle that reached the census time in simulation::census_bank.
+//! The site is discarded if the bank is full.
+//! \param p Particle at the census time
+void bank_census_site(const Particle& p);
+
 void free_memory_bank();
 
 void init_fission_bank(int64_t max);
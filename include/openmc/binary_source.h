@@ -0,0 +1,76 @@
+//! \file binary_source.h
+//! Flat binary source files that can be memory-mapped
+
+#ifndef OPENMC_BINARY_SOURCE_H
+#define OPENMC_BINARY_SOURCE_H
+
+#include <cstdint> // for int32_t, int64_t
+#include <string>
+#include <vector>
+
+#include "openmc/particle.h"
+
+namespace openmc {
+
+//==============================================================================
+//! Header at the start of a binary source file
+//
+//! The header is followed directly by the source sites, stored as an array of
+//! Particle::Bank exactly as they are laid out in memory. Since no conversion
+//! is done, a file can only be read on machines with the same byte order and
+//! structure layout, which is checked through the size of a site.
+//==============================================================================
+
+struct BinarySourceHeader {
+  char magic[8];      //!< identifies the file as a binary source file
+  int32_t version[2]; //!< major and minor version of the format
+  int32_t site_size;  //!< size of each source site in bytes
+  int32_t reserved;   //!< unused, keeps the sites aligned
+  int64_t n_sites;    //!< number of source sites
+};
+
+//==============================================================================
+// Non-member functions
+//==============================================================================
+
+//! Check whether a file is a binary source file
+//
+//! \param filename Path to the file
+//! \return Whether the file starts with the header of a binary source file
+bool is_binary_source(const std::string& filename);
+
+//! Write the source bank of all processes to a binary source file
+//
+//! The master process writes the header and each process then writes its own
+//! sites at their offset in the file, which must be on a file system shared by
+//! all processes.
+//! \param filename Path to the file
+void write_binary_source(const std::string& filename);
+
+//! Write the sites of a bank distributed among all processes to a binary
+//! source file
+//
+//! \param filename Path to the file
+//! \param sites Sites of this process
+//! \param bank_index Index in the file of the first site of each process,
+//!   followed by the total number of sites
+void write_binary_source(const std::string& filename,
+  const Particle::Bank* sites, const std::vector<int64_t>& bank_index);
+
+//! Read the source sites of this process from a binary source file
+//
+//! The file is memory-mapped and the sites given by
+//! simulation::work_index are copied directly into the source bank.
+//! \param filename Path to the file
+void read_binary_source(const std::string& filename);
+
+//! Read all source sites of a binary source file
+//
+//! \param filename Path to the file
+//! \return Source sites
+std::vector<Particle::Bank> read_binary_source_sites(
+  const std::string& filename);
+
+} // namespace openmc
+
+#endif // OPENMC_BINARY_SOURCE_H
@@ -1,10 +1,13 @@
 #ifndef OPENMC_BREMSSTRAHLUNG_H
 #define OPENMC_BREMSSTRAHLUNG_H
 
+#include "openmc/distribution.h"
 #include "openmc/particle.h"
 
 #include "xtensor/xtensor.hpp"
 
+#include <vector>
+
 namespace openmc {
 
 //==============================================================================
@@ -17,6 +20,9 @@ public:
   xt::xtensor<double, 2> pdf; //!< Bremsstrahlung energy PDF
   xt::xtensor<double, 2> cdf; //!< Bremsstrahlung energy CDF
   xt::xtensor<double, 1> yield; //!< Photon yield
+  //! Alias table over the photon energy bins at each incident energy, only
+  //! built when settings::alias_sampling is set
+  std::vector<AliasTable> alias;
 };
 
 class Bremsstrahlung {
@@ -0,0 +1,224 @@
+//! \file bvh.h
+//! Bounding volume hierarchies for accelerating cell searches and ray tracing
+
+#ifndef OPENMC_BVH_H
+#define OPENMC_BVH_H
+
+#include <array>
+#include <cstdint> // for int32_t, int64_t
+#include <functional> // for function
+#include <vector>
+
+#include "openmc/particle.h"
+#include "openmc/position.h"
+#include "openmc/surface.h"
+
+namespace openmc {
+
+class Universe;
+
+//==============================================================================
+//! Speeds up geometry searches in universes with many cells by organizing the
+//! bounding boxes of the cells in a binary tree.
+//
+//! Each node of the tree stores a box enclosing the boxes of all cells beneath
+//! it, so a search only descends into nodes whose box contains the point.
+//! Cells whose bounding box is infinite in every direction cannot be placed in
+//! the tree and are always checked after the tree has been searched.
+//==============================================================================
+
+class CellBVH
+{
+public:
+  explicit CellBVH(const Universe& univ);
+
+  //! Find the cell of the universe containing the given coordinates.
+  //
+  //! \param r Position in the coordinate system of the universe
+  //! \param u Direction in the coordinate system of the universe
+  //! \param on_surface Surface the particle is on, if any
+  //! \param sense_cache Surface senses already evaluated at this position
+  //! \return Index of the cell or C_NONE if no cell contains the coordinates
+  int32_t find_cell(Position r, Direction u, int32_t on_surface,
+    SurfaceSenseCache* sense_cache) const;
+
+  //! Whether no cells have a finite bounding box
+  bool empty() const { return nodes_.empty(); }
+
+private:
+  //! A node of the tree
+  struct Node {
+    BoundingBox box; //!< box enclosing all cells beneath this node
+    int32_t left;    //!< index of first child or first cell for leaves
+    int32_t right;   //!< index of second child or -(number of cells) for leaves
+  };
+
+  //! Recursively build the subtree for a range of cells_
+  //
+  //! \param boxes Bounding box of each cell in cells_
+  //! \param begin Index of the first cell in the range
+  //! \param end Index one past the last cell in the range
+  //! \return Index of the node at the root of the subtree
+  int32_t build(std::vector<BoundingBox>& boxes, int32_t begin, int32_t end);
+
+  // Ranges with at most this many cells are not split further
+  static constexpr int LEAF_SIZE {4};
+
+  // Upper bound on the depth of the tree. Ranges are split at their median so
+  // the depth grows only logarithmically with the number of cells.
+  static constexpr int MAX_DEPTH {64};
+
+  std::vector<Node> nodes_;         //!< nodes of the tree, root first
+  std::vector<int32_t> cells_;      //!< cells ordered by their leaf nodes
+  std::vector<int32_t> unbounded_;  //!< cells not contained in the tree
+};
+
+//==============================================================================
+//! Finds where rays leave a volume bounded by a triangle mesh by organizing
+//! its triangles in a binary tree.
+//
+//! The boxes of the nodes are stored in single precision and rounded outward,
+//! so that traversal touches half the memory without missing any triangle.
+//! The triangles reached are then intersected in double precision. The tree
+//! is only read during transport, so any number of threads may query it.
+//==============================================================================
+
+class TriangleBVH
+{
+public:
+  //! A triangle on the boundary of the volume
+  struct Triangle {
+    //! Vertices, ordered so that the normal given by the right-hand rule
+    //! points out of the volume
+    std::array<Position, 3> v;
+    int32_t surface; //!< surface index reported when the triangle is hit
+    int64_t id;      //!< identifier shared with the volume on the other side
+    bool two_sided;  //!< whether rays entering through it are counted too
+  };
+
+  //! Nearest triangle hit by a ray
+  struct Hit {
+    double distance {INFTY}; //!< distance along the ray
+    int32_t surface {-1};    //!< surface of the triangle
+    int64_t id {-1};         //!< identifier of the triangle
+  };
+
+  explicit TriangleBVH(std::vector<Triangle> triangles);
+
+  //! Find the nearest triangle through which a ray leaves the volume.
+  //
+  //! \param r Origin of the ray
+  //! \param u Direction of the ray
+  //! \param exclude Identifier of a triangle to ignore, usually the one the
+  //!   ray starts on, or -1
+  //! \return Nearest hit, with an infinite distance if there is none
+  Hit intersect(Position r, Direction u, int64_t exclude) const;
+
+private:
+  //! A node of the tree
+  struct Node {
+    std::array<float, 3> lower; //!< lower corner of the box of the node
+    std::array<float, 3> upper; //!< upper corner of the box of the node
+    int32_t left;  //!< index of first child or first triangle for leaves
+    int32_t right; //!< index of second child or -(number of triangles)
+  };
+
+  //! Recursively build the subtree for a range of triangles_
+  //
+  //! \param begin Index of the first triangle in the range
+  //! \param end Index one past the last triangle in the range
+  //! \return Index of the node at the root of the subtree
+  int32_t build(int32_t begin, int32_t end);
+
+  // Ranges with at most this many triangles are not split further
+  static constexpr int LEAF_SIZE {4};
+
+  // Upper bound on the depth of the tree, which is split at medians
+  static constexpr int MAX_DEPTH {64};
+
+  std::vector<Node> nodes_;         //!< nodes of the tree, root first
+  std::vector<Triangle> triangles_; //!< triangles ordered by their leaves
+};
+
+//==============================================================================
+//! Finds which of many bounded items, such as mesh elements, contains a point
+//! by organizing their bounding boxes in a binary tree.
+//
+//! Like TriangleBVH, the boxes of the nodes are stored in single precision and
+//! rounded outward. The boxes of the items themselves aren't stored, so the
+//! items of each leaf reached are checked exactly by the caller.
+//==============================================================================
+
+class BoxBVH
+{
+public:
+  BoxBVH() = default;
+
+  //! Build the tree
+  //
+  //! \param n Number of items
+  //! \param box Function giving the bounding box of an item by its index
+  BoxBVH(int32_t n, const std::function<BoundingBox(int32_t)>& box);
+
+  //! Find an item containing a point.
+  //
+  //! \param r Position to locate
+  //! \param contains Function checking whether the item with a given index
+  //!   contains the point
+  //! \return Index of the first item found to contain the point or -1
+  template<typename F>
+  int32_t find(Position r, F contains) const;
+
+private:
+  //! A node of the tree
+  struct Node {
+    std::array<float, 3> lower; //!< lower corner of the box of the node
+    std::array<float, 3> upper; //!< upper corner of the box of the node
+    int32_t left;  //!< index of first child or first item for leaves
+    int32_t right; //!< index of second child or -(number of items)
+  };
+
+  //! Recursively build the subtree for a range of items_
+  int32_t build(const std::function<BoundingBox(int32_t)>& box,
+    const std::vector<std::array<float, 3>>& centers, int32_t begin,
+    int32_t end);
+
+  // Ranges with at most this many items are not split further
+  static constexpr int LEAF_SIZE {4};
+
+  // Upper bound on the depth of the tree, which is split at medians
+  static constexpr int MAX_DEPTH {64};
+
+  std::vector<Node> nodes_;     //!< nodes of the tree, root first
+  std::vector<int32_t> items_;  //!< items ordered by their leaves
+};
+
+template<typename F>
+int32_t BoxBVH::find(Position r, F contains) const
+{
+  if (nodes_.empty()) return -1;
+
+  std::array<int32_t, MAX_DEPTH + 1> stack;
+  int n = 0;
+  stack[n++] = 0;
+  while (n > 0) {
+    const auto& node {nodes_[stack[--n]]};
+    if (r.x < node.lower[0] || r.x > node.upper[0] ||
+        r.y < node.lower[1] || r.y > node.upper[1] ||
+        r.z < node.lower[2] || r.z > node.upper[2]) continue;
+
+    if (node.right > 0) {
+      stack[n++] = node.right;
+      stack[n++] = node.left;
+    } else {
+      for (int32_t i = node.left; i < node.left - node.right; ++i) {
+        if (contains(items_[i])) return items_[i];
+      }
+    }
+  }
+  return -1;
+}
+
+} // namespace openmc
+
+#endif // OPENMC_BVH_H
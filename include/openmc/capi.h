@@ -9,7 +9,10 @@
 extern "C" {
 #endif
 
+  int openmc_add_batch_callback(void (*callback)(int batch, void* data),
+    void* data);
   int openmc_calculate_volumes();
+  int openmc_clear_batch_callbacks();
   int openmc_cell_filter_get_bins(int32_t index, const int32_t** cells, int32_t* n);
   int openmc_cell_get_fill(int32_t index, int* type, int32_t** indices, int32_t* n);
   int openmc_cell_get_id(int32_t index, int32_t* id);
@@ -19,6 +22,8 @@ extern "C" {
   int openmc_cell_set_fill(int32_t index, int type, int32_t n, const int32_t* indices);
   int openmc_cell_set_id(int32_t index, int32_t id);
   int openmc_cell_set_temperature(int32_t index, double T, const int32_t* instance);
+  int openmc_cells_set_temperature(int32_t n, const int32_t* index,
+    const int32_t* instance, const double* T);
   int openmc_energy_filter_get_bins(int32_t index, const double** energies, size_t* n);
   int openmc_energy_filter_set_bins(int32_t index, size_t n, const double* energies);
   int openmc_energyfunc_filter_get_energy(int32_t index, size_t* n, const double** energy);
@@ -35,6 +40,11 @@ extern "C" {
   int openmc_filter_set_id(int32_t index, int32_t id);
   int openmc_finalize();
   int openmc_find_cell(const double* xyz, int32_t* index, int32_t* instance);
+  int openmc_find_cells(int64_t n, const double* xyz, int32_t* index,
+    int32_t* instance, int32_t* material, double* temperature);
+  int openmc_find_overlaps(const double* lower_left, const double* upper_right,
+    int64_t n_samples, int32_t max_pairs, int32_t* cells, double* xyz,
+    int32_t* n_pairs);
   int openmc_cell_bounding_box(const int32_t index, double* llc, double* urc);
   int openmc_global_bounding_box(double* llc, double* urc);
   int openmc_fission_bank(void** ptr, int64_t* n);
@@ -60,6 +70,7 @@ extern "C" {
   int openmc_material_get_id(int32_t index, int32_t* id);
   int openmc_material_get_fissionable(int32_t index, bool* fissionable);
   int openmc_material_get_density(int32_t index, double* density);
+  int openmc_material_get_temperature(int32_t index, double* temperature);
   int openmc_material_get_volume(int32_t index, double* volume);
   int openmc_material_set_density(int32_t index, double density, const char* units);
   int openmc_material_set_densities(int32_t index, int n, const char** name, const double* density);
@@ -67,8 +78,14 @@ extern "C" {
   int openmc_material_get_name(int32_t index, const char** name);
   int openmc_material_set_name(int32_t index, const char* name);
   int openmc_material_set_volume(int32_t index, double volume);
+  int openmc_materials_set_density(int32_t n, const int32_t* index,
+    const double* density, const char* units);
+  int openmc_materials_set_densities(int32_t n, const int32_t* index,
+    const int* n_nuclide, const char** name, const double* density);
   int openmc_material_filter_get_bins(int32_t index, const int32_t** bins, size_t* n);
   int openmc_material_filter_set_bins(int32_t index, size_t n, const int32_t* bins);
+  int openmc_mesh_field_set_data(int32_t id, size_t n, const double* T,
+    const double* density_mult);
   int openmc_mesh_filter_get_mesh(int32_t index, int32_t* index_mesh);
   int openmc_mesh_filter_set_mesh(int32_t index, int32_t index_mesh);
   int openmc_mesh_get_id(int32_t index, int32_t* id);
@@ -81,14 +98,20 @@ extern "C" {
   int openmc_meshsurface_filter_set_mesh(int32_t index, int32_t index_mesh);
   int openmc_new_filter(const char* type, int32_t* index);
   int openmc_next_batch(int* status);
+  int openmc_nuclide_group_xs(int index, int MT, double temperature,
+    const double* energy, size_t n, double* xs);
   int openmc_nuclide_name(int index, const char** name);
   int openmc_plot_geometry();
+  int openmc_precursor_decay_rates(double** ptr, size_t shape_[2]);
+  int openmc_precursors(double** ptr, size_t shape_[2]);
+  int openmc_precursors_advance(double dt, double source_rate);
   int openmc_id_map(const void* slice, int32_t* data_out);
   int openmc_property_map(const void* slice, double* data_out);
   int openmc_reset();
   int openmc_reset_timers();
   int openmc_run();
   void openmc_set_seed(int64_t new_seed);
+  int openmc_set_plot_cache(bool enable);
   int openmc_simulation_finalize();
   int openmc_simulation_init();
   int openmc_source_bank(void** ptr, int64_t* n);
@@ -114,6 +137,7 @@ extern "C" {
   int openmc_tally_get_writable(int32_t index, bool* writable);
   int openmc_tally_reset(int32_t index);
   int openmc_tally_results(int32_t index, double** ptr, size_t shape_[3]);
+  int openmc_tally_statistics(int32_t index, double** ptr, size_t shape_[3]);
   int openmc_tally_set_active(int32_t index, bool active);
   int openmc_tally_set_estimator(int32_t index, const char* estimator);
   int openmc_tally_set_filters(int32_t index, size_t n, const int32_t* indices);
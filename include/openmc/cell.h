@@ -14,10 +14,12 @@
 #include "pugixml.hpp"
 #include "dagmc.h"
 
+#include "openmc/bvh.h"
 #include "openmc/constants.h"
 #include "openmc/neighbor_list.h"
 #include "openmc/position.h"
 #include "openmc/surface.h"
+#include "openmc/surface_kernel.h"
 
 namespace openmc {
 
@@ -31,6 +33,12 @@ enum class Fill {
   LATTICE
 };
 
+//! Temperature index and interpolation factor of a nuclide at a temperature
+struct NuclideTemperature {
+  int index;     //!< Index of the nearest or next lower data temperature
+  double interp; //!< Interpolation factor towards the next data temperature
+};
+
 // TODO: Convert to enum
 constexpr int32_t OP_LEFT_PAREN   {std::numeric_limits<int32_t>::max()};
 constexpr int32_t OP_RIGHT_PAREN  {std::numeric_limits<int32_t>::max() - 1};
@@ -71,6 +79,7 @@ public:
   BoundingBox bounding_box() const;
 
   std::unique_ptr<UniversePartitioner> partitioner_;
+  std::unique_ptr<CellBVH> bvh_; //!< Used when partitioning is not possible
 };
 
 //==============================================================================
@@ -100,16 +109,20 @@ public:
   //! Simple cells can be evaluated with short circuit evaluation, i.e., as soon
   //! as we know that one half-space is not satisfied, we can exit. This
   //! provides a performance benefit for the common case. In
-  //! contains_complex, we evaluate the RPN expression using a stack, similar to
-  //! how a RPN calculator would work.
+  //! contains_complex, we evaluate the region compiled into a tree of n-ary
+  //! intersections and unions, skipping the remaining operands of a node as
+  //! soon as its result is known.
   //! \param r The 3D Cartesian coordinate to check.
   //! \param u A direction used to "break ties" the coordinates are very
   //!   close to a surface.
   //! \param on_surface The signed index of a surface that the coordinate is
   //!   known to be on.  This index takes precedence over surface sense
   //!   calculations.
+  //! \param sense_cache Surface senses already evaluated at this coordinate,
+  //!   which is updated with any newly evaluated senses.  May be null.
   virtual bool
-  contains(Position r, Direction u, int32_t on_surface) const = 0;
+  contains(Position r, Direction u, int32_t on_surface,
+    SurfaceSenseCache* sense_cache = nullptr) const = 0;
 
   //! Find the oncoming boundary of this cell.
   virtual std::pair<double, int32_t>
@@ -137,6 +150,19 @@ public:
   //!   all instances is set.
   void set_temperature(double T, int32_t instance = -1);
 
+  //! Update the cached temperature indices of the nuclides in a cell instance
+  //! \param[in] instance Instance index. If -1 is given, all instances are
+  //!   updated.
+  void update_nuclide_temperature(int32_t instance = -1);
+
+  //! Get the cached temperature indices of the nuclides in a cell instance
+  //! \param[in] instance Instance index
+  //! \param[in] i_material Index of the material the indices are wanted for
+  //! \return Temperature index of each nuclide and then each S(a,b) table in
+  //!   the material, or nullptr if none are cached
+  const NuclideTemperature* nuclide_temperature(int32_t instance,
+    int32_t i_material) const;
+
   //! Get the name of a cell
   //! \return Cell name
   const std::string& name() const { return name_; };
@@ -169,6 +195,15 @@ public:
   //! T. The units are sqrt(eV).
   std::vector<double> sqrtkT_;
 
+  //! \brief Temperature index of each nuclide in each instance.
+  //!
+  //! Only populated when settings::temperature_cache is set. Indexed by
+  //! instance, with a single entry if all instances have the same material and
+  //! temperature, and then by position of the nuclide in the material. The
+  //! nuclides are followed by the S(a,b) tables of the material, in the order
+  //! of Material::thermal_tables_.
+  std::vector<std::vector<NuclideTemperature>> nuclide_temperature_;
+
   //! Definition of spatial region as Boolean expression of half-spaces
   std::vector<std::int32_t> region_;
   //! Reverse Polish notation for region expression
@@ -189,6 +224,15 @@ public:
   std::vector<double> rotation_;
 
   std::vector<int32_t> offset_;  //!< Distribcell offset table
+
+  //! Bounding box of the cell in the coordinates of its universe, cached when
+  //! the geometry is finalized to reject cells before evaluating surfaces
+  BoundingBox bbox_;
+
+  //! Whether neutrons move through the contents of the cell with delta
+  //! tracking
+  bool delta_tracking_ {false};
+  int32_t majorant_ {C_NONE}; //!< Index in model::majorants
 };
 
 //==============================================================================
@@ -201,18 +245,42 @@ public:
   explicit CSGCell(pugi::xml_node cell_node);
 
   bool
-  contains(Position r, Direction u, int32_t on_surface) const;
+  contains(Position r, Direction u, int32_t on_surface,
+    SurfaceSenseCache* sense_cache = nullptr) const;
 
   std::pair<double, int32_t>
   distance(Position r, Direction u, int32_t on_surface, Particle* p) const;
 
+  //! Find the oncoming boundary of this cell for a batch of rays.
+  //
+  //! This gives the same results as calling distance() for each ray but
+  //! evaluates each surface for all rays at once.
+  //! \param rays Positions and directions of rays within this cell
+  //! \param[out] min_dist Distance to the oncoming boundary for each ray
+  //! \param[out] i_surf Signed index of the oncoming surface for each ray
+  void distance(const RayBatch& rays, double* min_dist, int32_t* i_surf) const;
+
   void to_hdf5(hid_t group_id) const;
 
   BoundingBox bounding_box() const;
 
+  friend class FlatGeometry;
+
 protected:
-  bool contains_simple(Position r, Direction u, int32_t on_surface) const;
-  bool contains_complex(Position r, Direction u, int32_t on_surface) const;
+  bool contains_simple(Position r, Direction u, int32_t on_surface,
+    SurfaceSenseCache* sense_cache) const;
+  bool contains_complex(Position r, Direction u, int32_t on_surface,
+    SurfaceSenseCache* sense_cache) const;
+
+  //! Evaluate the subtree of the compiled region rooted at a node
+  //! \param i Index of the node in region_tree_
+  //! \return Whether the coordinate is in the region of the subtree
+  bool evaluate_region(int32_t i, Position r, Direction u, int32_t on_surface,
+    SurfaceSenseCache* sense_cache) const;
+
+  //! Compile the RPN of a complex region into region_tree_
+  void compile_region();
+
   BoundingBox bounding_box_simple() const;
   static BoundingBox bounding_box_complex(std::vector<int32_t> rpn);
 
@@ -235,6 +303,23 @@ protected:
   find_left_parenthesis(std::vector<int32_t>::iterator start,
                         const std::vector<int32_t>& rpn);
 
+  //! Compact form of the surface of each non-operator token in rpn_, in order
+  std::vector<CompactSurface> surfaces_;
+
+  //! Node of the compiled region of a complex cell
+  struct RegionNode {
+    int32_t token; //!< OP_INTERSECTION, OP_UNION, or a signed surface token
+    int32_t surf;  //!< index in surfaces_ of a half-space
+    int32_t size;  //!< number of nodes in the subtree rooted at this node
+  };
+
+  //! \brief Region of a complex cell as a tree in prefix order.
+  //!
+  //! Each operator node is followed by the subtrees of its operands, which are
+  //! ordered from the cheapest to evaluate. Complements are pushed down to the
+  //! half-spaces and nested operators of the same kind are merged, so that only
+  //! n-ary intersections and unions remain.
+  std::vector<RegionNode> region_tree_;
 };
 
 //==============================================================================
@@ -245,7 +330,8 @@ class DAGCell : public Cell
 public:
   DAGCell();
 
-  bool contains(Position r, Direction u, int32_t on_surface) const;
+  bool contains(Position r, Direction u, int32_t on_surface,
+    SurfaceSenseCache* sense_cache = nullptr) const;
 
   std::pair<double, int32_t>
   distance(Position r, Direction u, int32_t on_surface, Particle* p) const;
@@ -256,15 +342,19 @@ public:
 
   moab::DagMC* dagmc_ptr_; //!< Pointer to DagMC instance
   int32_t dag_index_;      //!< DagMC index of cell
+  //! Triangles bounding the cell, used instead of DagMC ray fire if built
+  std::unique_ptr<TriangleBVH> bvh_;
 };
 #endif
 
 //==============================================================================
 //! Speeds up geometry searches by grouping cells in a search tree.
 //
-//! Currently this object only works with universes that are divided up by a
-//! bunch of z-planes.  It could be generalized to other planes, cylinders,
-//! and spheres.
+//! The universe is divided up by a family of surfaces whose senses change
+//! monotonically along a single coordinate: parallel planes (x-, y-, z-planes
+//! or general planes with a common normal), coaxial cylinders, or concentric
+//! spheres. All families present in the universe are considered and the one
+//! that minimizes the average number of cells per partition is used.
 //==============================================================================
 
 class UniversePartitioner
@@ -275,10 +365,20 @@ public:
   //! Return the list of cells that could contain the given coordinates.
   const std::vector<int32_t>& get_cells(Position r, Direction u) const;
 
+  //! Whether no family of surfaces was found that is worth partitioning on
+  bool empty() const { return surfs_.empty(); }
+
 private:
+  //! Minimum number of surfaces a family must have to be used
+  static constexpr int MIN_SURFACES {6};
+
   //! A sorted vector of indices to surfaces that partition the universe
   std::vector<int32_t> surfs_;
 
+  //! Whether the sense of each surface in surfs_ is reversed relative to the
+  //! ordering, as happens for planes whose normal points the opposite way
+  std::vector<bool> flipped_;
+
   //! Vectors listing the indices of the cells that lie within each partition
   //
   //! There are n+1 partitions with n surfaces.  `partitions_.front()` gives the
@@ -316,6 +416,11 @@ struct CellInstanceHash {
 void read_cells(pugi::xml_node node);
 
 #ifdef DAGMC
+//! Find the DAGMC cell on the other side of a surface
+//
+//! \param cur_cell Cell the particle is leaving
+//! \param surf_xed Surface bounding the cell that the particle crosses
+//! \return Index in model::cells of the cell the particle enters
 int32_t next_cell(DAGCell* cur_cell, DAGSurface* surf_xed);
 #endif
 
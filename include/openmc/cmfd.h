@@ -0,0 +1,104 @@
+//! \file cmfd.h
+//! Coarse mesh finite difference acceleration of the fission source
+
+#ifndef OPENMC_CMFD_H
+#define OPENMC_CMFD_H
+
+#include <cstdint> // for int32_t
+#include <memory> // for unique_ptr
+#include <vector>
+
+#include "pugixml.hpp"
+
+namespace openmc {
+
+class RegularMesh;
+
+//==============================================================================
+//! Accelerates the convergence of the fission source during inactive batches
+//! with coarse mesh finite difference (CMFD) feedback.
+//
+//! Reaction rates, scattering and fission matrices and partial currents are
+//! tallied on a regular mesh. At the end of each batch, a multigroup diffusion
+//! problem whose nonlinear coupling coefficients preserve the tallied net
+//! currents is solved for the fission source, and the weights of the source
+//! sites for the next batch are adjusted so that the source follows it.
+//==============================================================================
+
+class CmfdAccelerator {
+public:
+  //! Read the CMFD settings
+  //
+  //! \param node <cmfd> element of settings.xml
+  explicit CmfdAccelerator(pugi::xml_node node);
+
+  //! Create the tallies needed to build the CMFD problem. This must be called
+  //! after the user tallies were read so that their IDs are not taken.
+  void create_tallies();
+
+  //! Stop scoring the CMFD tallies once feedback is no longer applied
+  void deactivate_tallies();
+
+  //! Solve the CMFD problem with the accumulated tallies and reweight the
+  //! source sites of the next batch
+  void apply_feedback();
+
+  double keff() const { return keff_; } //!< Last CMFD eigenvalue
+
+private:
+  //! Solve the CMFD eigenvalue problem on the master process
+  //
+  //! \param[out] source Fission source in each mesh bin and group
+  //! \return Whether the solution can be used for feedback, which is only
+  //!   known on the master process
+  bool solve(std::vector<double>& source);
+
+  //! Assemble the loss and production operators and run power iterations
+  //
+  //! \param flux Accumulated flux in each mesh bin and group
+  //! \param total Accumulated total reaction rate in each mesh bin and group
+  //! \param scatter Accumulated nu-scatter rate in each mesh bin, incoming and
+  //!   outgoing group
+  //! \param fission Accumulated nu-fission rate in each mesh bin, incoming and
+  //!   outgoing group
+  //! \param current Accumulated partial currents on each mesh surface and
+  //!   group
+  //! \param[out] source Fission source in each mesh bin and group
+  //! \return Whether the solution can be used for feedback
+  bool power_iteration(const std::vector<double>& flux,
+    const std::vector<double>& total, const std::vector<double>& scatter,
+    const std::vector<double>& fission, const std::vector<double>& current,
+    std::vector<double>& source);
+
+  //! Get the accumulated sums of a score of a CMFD tally on the master process
+  std::vector<double> tally_sums(int32_t i_tally, int score) const;
+
+  // Tolerances on the eigenvalue and fission source of the power iterations
+  // and on the linear solve of each iteration
+  static constexpr double KTOL {1.0e-8};
+  static constexpr double STOL {1.0e-8};
+  static constexpr double INNER_TOL {1.0e-10};
+  static constexpr int MAX_ITERATIONS {10000};
+
+  int32_t i_mesh_;                  //!< index of the mesh in model::meshes
+  const RegularMesh* mesh_;         //!< mesh on which the problem is solved
+  std::vector<double> energy_bins_; //!< group boundaries in [eV]
+  int begin_ {1};                   //!< first batch with feedback
+  int32_t i_rates_ {-1};   //!< tally of the flux and total reaction rate
+  int32_t i_matrices_ {-1}; //!< tally of the nu-scatter and nu-fission rates
+  int32_t i_currents_ {-1}; //!< tally of the partial currents
+  double keff_ {0.0};
+};
+
+//==============================================================================
+// Global variables
+//==============================================================================
+
+namespace simulation {
+  //! CMFD acceleration of the fission source, if enabled
+  extern std::unique_ptr<CmfdAccelerator> cmfd_accelerator;
+} // namespace simulation
+
+} // namespace openmc
+
+#endif // OPENMC_CMFD_H
@@ -0,0 +1,74 @@
+//! \file condensed_history.h
+//! Condensed history transport of electrons and positrons
+
+#ifndef OPENMC_CONDENSED_HISTORY_H
+#define OPENMC_CONDENSED_HISTORY_H
+
+#include "openmc/particle.h"
+
+#include "xtensor/xtensor.hpp"
+
+namespace openmc {
+
+//==============================================================================
+// Constants
+//==============================================================================
+
+//! Largest fraction of its energy that a charged particle loses continuously
+//! in one condensed history step
+constexpr double CH_ENERGY_LOSS_FRACTION {0.1};
+
+//==============================================================================
+// Condensed history classes
+//==============================================================================
+
+//! Tables of a material for the condensed history transport of a charged
+//! particle, given on the bremsstrahlung incident energy grid
+//
+//! Energy lost in collisions with atomic electrons and to bremsstrahlung
+//! photons below the photon cutoff is deposited continuously through the
+//! restricted stopping power. Harder bremsstrahlung photons are emitted in
+//! discrete events, while elastic scattering is condensed into one deflection
+//! at the end of each step.
+class CondensedHistoryData {
+public:
+  // Data
+  double w_cut; //!< lowest energy of hard bremsstrahlung photons in [eV]
+  xt::xtensor<double, 1> range; //!< log of CSDA range in [cm]
+  xt::xtensor<double, 1> transport_xs; //!< log of first transport xs in [1/cm]
+  xt::xtensor<double, 1> brems_xs; //!< hard bremsstrahlung xs in [1/cm]
+  xt::xtensor<double, 2> dcs; //!< scaled bremsstrahlung DCS of the material
+  xt::xtensor<double, 1> dcs_max; //!< largest value of the DCS at each energy
+};
+
+class CondensedHistory {
+public:
+  // Data
+  CondensedHistoryData electron;
+  CondensedHistoryData positron;
+};
+
+//==============================================================================
+// Non-member functions
+//==============================================================================
+
+//! Sample the length of the next condensed history step
+//
+//! The step ends when the particle has lost CH_ENERGY_LOSS_FRACTION of its
+//! energy or has slowed down completely, or earlier in a hard bremsstrahlung
+//! event. Particle::step_end_ is set accordingly.
+//! \param p Electron or positron
+//! \return Length of the step in [cm]
+double condensed_history_step(Particle& p);
+
+//! Apply the energy loss, bremsstrahlung and deflection of the condensed
+//! history step the particle has just taken
+//
+//! The particle is killed, with all its remaining energy deposited, once it
+//! has slowed down below the electron energy grid or the energy cutoff.
+//! \param p Electron or positron at the end of its step
+void condensed_history_collision(Particle& p);
+
+} // namespace openmc
+
+#endif // OPENMC_CONDENSED_HISTORY_H
@@ -15,6 +15,15 @@ using double_2dvec = std::vector<std::vector<double>>;
 using double_3dvec = std::vector<std::vector<std::vector<double>>>;
 using double_4dvec = std::vector<std::vector<std::vector<std::vector<double>>>>;
 
+// Floating-point type used to store pointwise continuous-energy cross sections
+// and their energy grids. Quantities derived from them are always computed in
+// double precision.
+#ifdef OPENMC_SINGLE_PRECISION_XS
+using xs_real = float;
+#else
+using xs_real = double;
+#endif
+
 // ============================================================================
 // VERSIONING NUMBERS
 
@@ -32,10 +41,13 @@ constexpr int HDF5_VERSION[] {3, 0};
 constexpr std::array<int, 2> VERSION_STATEPOINT {17, 0};
 constexpr std::array<int, 2> VERSION_PARTICLE_RESTART {2, 0};
 constexpr std::array<int, 2> VERSION_TRACK {2, 0};
+constexpr std::array<int, 2> VERSION_TRACKS {1, 0};
 constexpr std::array<int, 2> VERSION_SUMMARY {6, 0};
+constexpr std::array<int, 2> VERSION_PERFORMANCE {1, 0};
 constexpr std::array<int, 2> VERSION_VOLUME {1, 0};
 constexpr std::array<int, 2> VERSION_VOXEL {2, 0};
 constexpr std::array<int, 2> VERSION_MGXS_LIBRARY {1, 0};
+constexpr std::array<int, 2> VERSION_BINARY_SOURCE {1, 0};
 
 // ============================================================================
 // ADJUSTABLE PARAMETERS
@@ -71,6 +83,12 @@ constexpr int MAX_WORD_LEN {150};
 constexpr int EXTSRC_REJECT_THRESHOLD {10000};
 constexpr double EXTSRC_REJECT_FRACTION {0.05};
 
+// For hashed energy searches, the maximum number of grid points per sub-bin
+// (beyond which a bin is divided further) and the maximum number of sub-bins
+// per equal-logarithmic bin
+constexpr int HASH_BIN_POINTS {4};
+constexpr int HASH_MAX_SUB_BINS {1024};
+
 // ============================================================================
 // MATH AND PHYSICAL CONSTANTS
 
@@ -271,7 +289,8 @@ enum class ResScatMethod {
 
 enum class ElectronTreatment {
   LED, // Local Energy Deposition
-  TTB  // Thick Target Bremsstrahlung
+  TTB, // Thick Target Bremsstrahlung
+  CH   // Condensed History
 };
 
 // ============================================================================
@@ -311,6 +330,11 @@ enum class TallyResult {
   SUM_SQ
 };
 
+// Indices of the accumulated sums in the results array of a tally, whose
+// values for the current realization are stored separately
+constexpr int RESULT_SUM {0};
+constexpr int RESULT_SUM_SQ {1};
+
 enum class TallyType {
   VOLUME,
   MESH_SURFACE,
@@ -383,6 +407,30 @@ enum class RunMode {
   VOLUME
 };
 
+// Policies for choosing the next event kernel in event-based mode
+enum class EventScheduler {
+  LONGEST_QUEUE, // Run the kernel with the longest queue
+  ROUND_ROBIN    // Cycle through the kernels in a fixed order
+};
+
+enum class EnergySearch {
+  LOG_GRID, // Binary search within an equal-logarithmic bin
+  HASHED    // Equal-logarithmic bins adaptively divided into sub-bins
+};
+
+enum class HistoryScheduler {
+  OPENMP,       // Use the OpenMP loop schedule given by OMP_SCHEDULE
+  WORK_STEALING // Cost-aware work stealing
+};
+
+// Placement of OpenMP threads on the CPUs of a node
+enum class ThreadAffinity {
+  NONE,    // Left to the OpenMP runtime and operating system
+  COMPACT, // Consecutive threads on adjacent CPUs
+  SPREAD,  // Threads spread evenly over the CPUs
+  NUMA     // Blocks of threads bound to the CPUs of each NUMA node
+};
+
 // ============================================================================
 // CMFD CONSTANTS
 
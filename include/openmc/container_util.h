@@ -2,6 +2,8 @@
 #define OPENMC_CONTAINER_UTIL_H
 
 #include <algorithm> // for find
+#include <cstddef>   // for size_t
+#include <cstdint>   // for uint64_t
 #include <iterator> // for begin, end
 
 namespace openmc {
@@ -12,6 +14,25 @@ inline bool contains(const C& v, const T& x)
   return std::end(v) != std::find(std::begin(v), std::end(v), x);
 }
 
+//! Offset basis of a 64-bit FNV-1a hash
+constexpr uint64_t FNV_OFFSET {14695981039346656037ull};
+
+//! Update a 64-bit FNV-1a hash with the bytes of a value
+inline void hash_bytes(uint64_t& hash, const void* data, std::size_t n)
+{
+  const auto* bytes = static_cast<const unsigned char*>(data);
+  for (std::size_t i = 0; i < n; ++i) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  }
+}
+
+template<typename T>
+inline void hash_value(uint64_t& hash, const T& value)
+{
+  hash_bytes(hash, &value, sizeof(T));
+}
+
 }
 
 #endif // OPENMC_CONTAINER_UTIL_H
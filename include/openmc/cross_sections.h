@@ -72,6 +72,14 @@ void read_ce_cross_sections_xml();
 
 void library_clear();
 
+//! Keep the continuous-energy data loaded by the current simulation so that
+//! the next read_ce_cross_sections in the same process can reuse it. This must
+//! be called before the settings are reset.
+void retain_nuclear_data();
+
+//! Release the nuclear data kept by retain_nuclear_data
+void free_retained_data();
+
 } // namespace openmc
 
 #endif // OPENMC_CROSS_SECTIONS_H
@@ -23,6 +23,10 @@ namespace model {
 //==============================================================================
 
 void load_dagmc_geometry();
+
+//! Build the triangle BVH of each DAGMC cell, which then replaces DagMC ray
+//! fire when finding distances to boundaries
+void build_dagmc_bvhs();
 void free_memory_dagmc();
 void read_geometry_dagmc();
 bool read_uwuw_materials(pugi::xml_document& doc);
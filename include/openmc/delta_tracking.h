@@ -0,0 +1,131 @@
+//! \file delta_tracking.h
+//! Delta tracking through the contents of cells or the whole geometry
+
+#ifndef OPENMC_DELTA_TRACKING_H
+#define OPENMC_DELTA_TRACKING_H
+
+#include <cstdint> // for int32_t, int64_t
+#include <unordered_set>
+#include <vector>
+
+namespace openmc {
+
+class Particle;
+class Tally;
+
+//==============================================================================
+//! Upper bound on the macroscopic total cross section of a group of materials
+//
+//! The bound is tabulated on the logarithmic energy grid used for nuclide
+//! energy lookups and holds anywhere within a bin. It is built from the
+//! pointwise total cross sections at every temperature loaded for each nuclide
+//! together with the largest values in the unresolved resonance probability
+//! tables and the thermal scattering cross sections. Cross sections that are
+//! only evaluated during transport, e.g. from windowed multipole data, may
+//! still exceed it, in which case the bound is raised where it was exceeded.
+//==============================================================================
+
+class Majorant {
+public:
+  //! Build the majorant of a group of materials
+  //
+  //! \param materials Indices of the materials in model::materials
+  //! \param nuclide_bound Largest microscopic total cross section of each
+  //!   nuclide in each bin of the logarithmic grid in [b]
+  Majorant(const std::vector<int32_t>& materials,
+    const std::vector<std::vector<double>>& nuclide_bound);
+
+  //! Get the majorant cross section at an energy
+  //
+  //! \param E Energy in [eV]
+  //! \return Macroscopic cross section in [1/cm]
+  double operator()(double E) const;
+
+  //! Raise the majorant after it was exceeded
+  //
+  //! \param E Energy in [eV] at which the majorant was exceeded
+  //! \param xs Macroscopic total cross section in [1/cm] that exceeded it
+  void raise(double E, double xs);
+
+private:
+  //! Get the bin of the logarithmic grid containing an energy
+  int bin(double E) const;
+
+  std::vector<double> xs_; //!< Majorant in each bin of the logarithmic grid
+};
+
+//==============================================================================
+// Global variables
+//==============================================================================
+
+namespace model {
+  extern std::vector<int32_t> delta_tracking_cells; //!< Cells using delta tracking
+  extern std::vector<Majorant> majorants; //!< Majorants of the contents of cells
+  //! Index in majorants of the majorant of all materials or C_NONE
+  extern int32_t global_majorant;
+  //! Surfaces with a boundary condition, crossed when delta tracking throughout
+  //! the geometry
+  extern std::vector<int32_t> boundary_condition_surfaces;
+  //! Cells within the contents of delta-tracking cells, whose surfaces are
+  //! never crossed
+  extern std::unordered_set<int32_t> delta_tracked_cells;
+} // namespace model
+
+namespace simulation {
+  //! Number of times a majorant was exceeded by the cross section of a material
+  extern int64_t n_majorant_exceeded;
+} // namespace simulation
+
+//==============================================================================
+// Non-member functions
+//==============================================================================
+
+//! Find the cells that use delta tracking and build the majorants of their
+//! contents, along with the majorant of all materials when delta tracking
+//! throughout the geometry. Cross sections must have been read.
+void initialize_delta_tracking();
+
+//! Find the outermost delta-tracking cell that a particle is in
+//
+//! \param p A particle
+//! \return Coordinate level of the cell or C_NONE if the particle is not in a
+//!   delta-tracking cell
+int delta_tracking_level(const Particle& p);
+
+//! Move a particle through the contents of a delta-tracking cell or through the
+//! whole geometry
+//
+//! The particle is moved to either its next real collision, after which it is
+//! located in the cells below the delta-tracking cell, or the boundary of the
+//! cell or one of the cells containing it. Throughout the whole geometry, the
+//! only boundaries are surfaces with a boundary condition. On return,
+//! collision_distance_ and boundary_ are set as they would be by
+//! Particle::event_advance.
+//! \param p A particle
+//! \param level Coordinate level of the delta-tracking cell or C_NONE for the
+//!   whole geometry
+void delta_tracking_advance(Particle& p, int level);
+
+//! Reject a surface tally that would miss crossings under delta tracking
+//
+//! Throughout the whole geometry, only surfaces with a boundary condition are
+//! crossed, and within a delta-tracking cell, the surfaces of the cells it
+//! contains are never crossed. A tally binning such surfaces, or the cells on
+//! either side of them, would silently score nothing there.
+//! \param tally A tally of surface crossings
+void check_delta_tracking_surface_tally(const Tally& tally);
+
+//! Determine whether a tally can score within a delta-tracked region
+//
+//! Track lengths are not known within delta-tracked regions, so such tallies
+//! need a collision estimator. Tallies whose cell, material or mesh filters
+//! keep them out of those regions can still use track lengths.
+//! \param tally A tally of volume scores
+//! \return Whether the tally can score in a delta-tracked region
+bool delta_tracking_overlaps(const Tally& tally);
+
+void free_memory_delta_tracking();
+
+} // namespace openmc
+
+#endif // OPENMC_DELTA_TRACKING_H
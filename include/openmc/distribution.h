@@ -4,7 +4,9 @@
 #ifndef OPENMC_DISTRIBUTION_H
 #define OPENMC_DISTRIBUTION_H
 
+#include <algorithm> // for sort, unique
 #include <cstddef> // for size_t
+#include <cstdint> // for uint64_t
 #include <memory> // for unique_ptr
 #include <vector> // for vector
 
@@ -24,6 +26,134 @@ public:
   virtual double sample(uint64_t* seed) const = 0;
 };
 
+//==============================================================================
+//! Alias table for sampling an index with given probabilities in constant time
+//
+//! The table is built with Vose's method and sampled with a single random
+//! number, the part of which not needed to choose the index being returned so
+//! that it can be reused by the caller.
+//==============================================================================
+
+class AliasTable {
+public:
+  AliasTable() = default;
+
+  //! Build the table
+  //! \param p Probability of each index, which need not be normalized
+  explicit AliasTable(const std::vector<double>& p);
+
+  //! Sample an index
+  //! \param xi Random number in [0,1)
+  //! \param[out] residual Random number in [0,1) independent of the index
+  //! \return Sampled index
+  std::size_t sample(double xi, double& residual) const;
+
+  bool empty() const { return prob_.empty(); }
+
+  //! Memory held by the table in bytes
+  std::size_t memory() const
+  {
+    return prob_.size()*sizeof(double) + alias_.size()*sizeof(std::size_t);
+  }
+private:
+  std::vector<double> prob_;      //!< probability of keeping each index
+  std::vector<std::size_t> alias_; //!< index chosen otherwise
+};
+
+//! Search a tabulated cumulative distribution for the bin of a value
+//
+//! The first n_discrete values are those of discrete lines, which are checked
+//! in turn. Unless the value falls below one of them, the continuous bins that
+//! follow are searched up to bin end.
+//! \param[in] c Cumulative distribution
+//! \param[in] n_discrete Number of discrete lines
+//! \param[in] end Last bin of the search
+//! \param[in] r1 Value of the cumulative distribution
+//! \param[out] k Bin
+//! \param[out] c_k Cumulative distribution used at the bin
+//! \param[out] c_k1 Cumulative distribution used at the next bin
+void find_cdf_bin(const double* c, int n_discrete, int end, double r1, int& k,
+  double& c_k, double& c_k1);
+
+//==============================================================================
+//! Ranges of a tabulated cumulative distribution over which its search gives
+//! the same bin, with an alias table of them so that the bin of a random value
+//! of the distribution is sampled without a search
+//==============================================================================
+
+class CdfBinTable {
+public:
+  //! Range of the cumulative distribution and the result of its search
+  struct Bin {
+    double c_low;  //!< Lower bound of the range
+    double c_high; //!< Upper bound of the range
+    int k;         //!< Bin
+    double c_k;    //!< Cumulative distribution used at the bin
+    double c_k1;   //!< Cumulative distribution used at the next bin
+  };
+
+  CdfBinTable() = default;
+
+  //! Precompute the ranges of a cumulative distribution
+  //! \param c Values of the cumulative distribution
+  //! \param find_bin Search called as find_bin(r1, k, c_k, c_k1) with the
+  //!   arguments of find_cdf_bin
+  template<typename T, typename F>
+  CdfBinTable(const T& c, F find_bin);
+
+  //! Sample a value of the cumulative distribution along with its bin
+  //! \param xi Random number in [0,1)
+  //! \param[out] r1 Value of the cumulative distribution
+  //! \return Range containing the value
+  const Bin& sample(double xi, double& r1) const
+  {
+    double residual;
+    const auto& bin {bins_[alias_.sample(xi, residual)]};
+    r1 = bin.c_low + residual*(bin.c_high - bin.c_low);
+    return bin;
+  }
+
+  bool empty() const { return bins_.empty(); }
+
+  //! Memory held by the table in bytes
+  std::size_t memory() const
+  {
+    return bins_.size()*sizeof(Bin) + alias_.memory();
+  }
+private:
+  std::vector<Bin> bins_; //!< Ranges of the cumulative distribution
+  AliasTable alias_;      //!< Alias table of the ranges
+};
+
+template<typename T, typename F>
+CdfBinTable::CdfBinTable(const T& c, F find_bin)
+{
+  // The result of the search only changes at values of the cumulative
+  // distribution
+  std::vector<double> bounds {0.0, 1.0};
+  for (auto c_i : c) {
+    if (c_i > 0.0 && c_i < 1.0) bounds.push_back(c_i);
+  }
+  std::sort(bounds.begin(), bounds.end());
+  bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+  std::vector<double> width;
+  for (int j = 0; j < bounds.size() - 1; ++j) {
+    Bin bin;
+    bin.c_low = bounds[j];
+    bin.c_high = bounds[j+1];
+    find_bin(0.5*(bin.c_low + bin.c_high), bin.k, bin.c_k, bin.c_k1);
+    bins_.push_back(bin);
+    width.push_back(bin.c_high - bin.c_low);
+  }
+  alias_ = AliasTable{width};
+}
+
+//! Minimum number of outcomes for which discrete and tabular distributions are
+//! sampled with an alias table rather than by searching their CDF when
+//! settings::alias_sampling is set
+constexpr std::size_t ALIAS_THRESHOLD {64};
+
 //==============================================================================
 //! A discrete distribution (probability mass function)
 //==============================================================================
@@ -44,8 +174,10 @@ public:
 private:
   std::vector<double> x_; //!< Possible outcomes
   std::vector<double> p_; //!< Probability of each outcome
+  AliasTable alias_;      //!< Alias table for large distributions
 
-  //! Normalize distribution so that probabilities sum to unity
+  //! Normalize distribution so that probabilities sum to unity, and build the
+  //! alias table if needed
   void normalize();
 };
 
@@ -183,6 +315,7 @@ private:
   std::vector<double> p_; //!< tabulated probability density
   std::vector<double> c_; //!< cumulative distribution at tabulated values
   Interpolation interp_;  //!< interpolation rule
+  AliasTable alias_;      //!< Alias table of the bins for large distributions
 
   //! Initialize tabulated probability density function
   //! \param x Array of values for independent variable
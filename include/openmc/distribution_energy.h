@@ -9,6 +9,7 @@
 #include "xtensor/xtensor.hpp"
 #include "hdf5.h"
 
+#include "openmc/angle_energy.h"
 #include "openmc/constants.h"
 #include "openmc/endf.h"
 
@@ -23,6 +24,14 @@ namespace openmc {
 class EnergyDistribution {
 public:
   virtual double sample(double E, uint64_t* seed) const = 0;
+
+  //! Sample at an incident energy whose location on the grid of the
+  //! distribution may be reused
+  virtual double sample(EnergyContext& E, uint64_t* seed) const
+  {
+    return this->sample(E.E(), seed);
+  }
+
   virtual ~EnergyDistribution() = default;
 };
 
@@ -79,6 +88,13 @@ public:
   //! \param[inout] seed Pseudorandom number seed pointer
   //! \return Sampled energy in [eV]
   double sample(double E, uint64_t* seed) const;
+
+  //! Sample energy distribution at an incident energy whose location on the
+  //! incident energy grid may be reused
+  //! \param[inout] E Incident particle energy
+  //! \param[inout] seed Pseudorandom number seed pointer
+  //! \return Sampled energy in [eV]
+  double sample(EnergyContext& E, uint64_t* seed) const;
 private:
   //! Outgoing energy for a single incoming energy
   struct CTTable {
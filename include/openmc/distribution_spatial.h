@@ -1,6 +1,10 @@
 #ifndef OPENMC_DISTRIBUTION_SPATIAL_H
 #define OPENMC_DISTRIBUTION_SPATIAL_H
 
+#include <array>
+#include <cstdint>
+#include <vector>
+
 #include "pugixml.hpp"
 
 #include "openmc/distribution.h"
@@ -100,11 +104,23 @@ class SpatialBox : public SpatialDistribution {
 public:
   explicit SpatialBox(pugi::xml_node node, bool fission=false);
 
-  //! Sample a position from the distribution
+  //! Sample a position from the distribution, only from voxels of the
+  //! acceptance grid that can accept sites if it has been built
   //! \param seed Pseudorandom number seed pointer
   //! \return Sampled position
   Position sample(uint64_t* seed) const;
 
+  //! Determine whether a site at a position would be accepted, i.e. whether
+  //! the position is in the geometry and in fissionable material if only
+  //! fissionable sites are accepted
+  //! \param r Position
+  //! \return Whether the site is accepted
+  bool accepts(Position r) const;
+
+  //! Find the voxels of the acceptance grid that can accept sites by probing
+  //! points inside each of them. This needs the geometry and the materials.
+  void build_acceptance_grid();
+
   // Properties
   bool only_fissionable() const { return only_fissionable_; }
   Position lower_left() const { return lower_left_; }
@@ -113,6 +129,9 @@ private:
   Position lower_left_; //!< Lower-left coordinates of box
   Position upper_right_; //!< Upper-right coordinates of box
   bool only_fissionable_ {false}; //!< Only accept sites in fissionable region?
+  std::array<int, 3> grid_shape_ {0, 0, 0}; //!< Voxels of the acceptance grid
+                                            //!< along x, y, z, or zeros
+  std::vector<int32_t> grid_voxels_; //!< Voxels that can accept sites
 };
 
 //==============================================================================
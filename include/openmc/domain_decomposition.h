@@ -0,0 +1,98 @@
+//! \file domain_decomposition.h
+//! Spatial decomposition of particle tracking among MPI processes
+
+#ifndef OPENMC_DOMAIN_DECOMPOSITION_H
+#define OPENMC_DOMAIN_DECOMPOSITION_H
+
+#include <cstdint> // for int32_t, int64_t
+#include <vector>
+
+#include "pugixml.hpp"
+
+#include "openmc/particle.h"
+
+namespace openmc {
+
+class Tally;
+
+//==============================================================================
+// Global variables
+//==============================================================================
+
+namespace simulation {
+
+//! Index in model::meshes of the mesh whose bins are divided among the
+//! processes, or -1 if particle tracking is not decomposed
+extern int32_t domain_mesh;
+
+//! First bin of the domain mesh owned by each process, followed by the number
+//! of bins
+extern std::vector<int32_t> domain_bin_start;
+
+//! Whether the particles tracked by this process can be in each material. It is
+//! empty when they can be in any material.
+extern std::vector<bool> domain_materials;
+
+//! Number of particles this process sent to other domains in the last
+//! generation
+extern int64_t n_migrated;
+
+} // namespace simulation
+
+//==============================================================================
+// Non-member functions
+//==============================================================================
+
+//! Whether each process only tracks particles inside its own domain
+inline bool domain_decomposed() { return simulation::domain_mesh >= 0; }
+
+//! Read the domain mesh of settings.xml. Meshes must have been read.
+//
+//! \param root Root element of settings.xml
+void read_domain_mesh(pugi::xml_node root);
+
+//! Divide the bins of the domain mesh among the processes, find the materials
+//! in the domain of this process and check that the other settings allow
+//! particles to be migrated. This must be called before the results of the
+//! tallies are allocated.
+void init_domain_decomposition();
+
+//! Whether the particles tracked by this process can be in a material, so that
+//! its unionized energy grid and cross section tables are needed
+//
+//! \param i_material Index in model::materials
+inline bool domain_has_material(int32_t i_material)
+{
+  const auto& owned {simulation::domain_materials};
+  return i_material >= static_cast<int32_t>(owned.size()) || owned[i_material];
+}
+
+//! Find the stride between the combinations of filter bins of a tally for
+//! consecutive bins of the domain mesh. Decomposed tallies with such a stride
+//! are divided among the processes along their domains, so that the particles
+//! tracked by a process score the bins it owns.
+//
+//! \param tally Tally whose first filter may be a mesh filter on the domain mesh
+//! \return The stride, or 0 if the first filter is not on the domain mesh
+int32_t domain_tally_stride(const Tally& tally);
+
+//! Determine the process whose domain a particle is in. Particles on a surface
+//! belong to the domain they are moving into, and particles outside the mesh
+//! belong to the process tracking them.
+//
+//! \param p Particle
+//! \return Rank of the owning process
+int domain_owner(const Particle& p);
+
+//! Simulate the histories of this process, tracking each particle until it
+//! leaves the domain of the process and exchanging the particles that did with
+//! the other processes until no particle is left in flight anywhere. The
+//! exchanges are non-blocking, and the particles received from each process are
+//! transported as soon as they arrive.
+void transport_domain_decomposed();
+
+void free_memory_domain_decomposition();
+
+} // namespace openmc
+
+#endif // OPENMC_DOMAIN_DECOMPOSITION_H
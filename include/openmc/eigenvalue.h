@@ -32,6 +32,14 @@ extern xt::xtensor<double, 1> source_frac; //!< Source fraction for UFS
 // Non-member functions
 //==============================================================================
 
+//! Start collecting the results of a generation from each process
+//!
+//! The tracklength keff and, if the Shannon entropy is computed, the fission
+//! sites in each entropy mesh bin are combined with non-blocking collectives so
+//! that the communication overlaps with sampling the fission bank. The results
+//! are received by calculate_generation_keff() and shannon_entropy().
+void start_generation_reductions();
+
 //! Collect/normalize the tracklength keff from each process
 void calculate_generation_keff();
 
@@ -10,6 +10,7 @@
 #include "hdf5.h"
 
 #include "openmc/constants.h"
+#include "openmc/search.h"
 
 namespace openmc {
 
@@ -48,7 +49,7 @@ public:
 //! One-dimensional function expressed as a polynomial
 //==============================================================================
 
-class Polynomial : public Function1D {
+class Polynomial final : public Function1D {
 public:
   //! Construct polynomial from HDF5 data
   //! \param[in] dset Dataset containing coefficients
@@ -58,6 +59,8 @@ public:
   //! \param[in] x independent variable
   //! \return Polynomial evaluated at x
   double operator()(double x) const override;
+
+  const std::vector<double>& coef() const { return coef_; }
 private:
   std::vector<double> coef_; //!< Polynomial coefficients
 };
@@ -66,7 +69,7 @@ private:
 //! One-dimensional interpolable function
 //==============================================================================
 
-class Tabulated1D : public Function1D {
+class Tabulated1D final : public Function1D {
 public:
   Tabulated1D() = default;
 
@@ -79,6 +82,9 @@ public:
   //! \return Function evaluated at x
   double operator()(double x) const override;
 
+  //! Whether the function is linearly interpolated between all of its points
+  bool linear() const;
+
   // Accessors
   const std::vector<double>& x() const { return x_; }
   const std::vector<double>& y() const { return y_; }
@@ -95,7 +101,7 @@ private:
 //! Coherent elastic scattering data from a crystalline material
 //==============================================================================
 
-class CoherentElasticXS : public Function1D {
+class CoherentElasticXS final : public Function1D {
 public:
   explicit CoherentElasticXS(hid_t dset);
 
@@ -112,7 +118,7 @@ private:
 //! Incoherent elastic scattering cross section
 //==============================================================================
 
-class IncoherentElasticXS : public Function1D {
+class IncoherentElasticXS final : public Function1D {
 public:
   explicit IncoherentElasticXS(hid_t dset);
 
@@ -122,6 +128,88 @@ private:
   double debye_waller_; //!< Debye-Waller integral divided by atomic mass in [eV^-1]
 };
 
+//==============================================================================
+//! Handle evaluating a one-dimensional function without virtual calls
+//
+//! Polynomials and linearly interpolated tables are evaluated inline; other
+//! functions go through Function1D. The handle only refers to the data of the
+//! function, which must outlive it.
+//==============================================================================
+
+class InlineFunction1D {
+public:
+  InlineFunction1D() = default;
+
+  //! Refer to a function
+  //! \param[in] f Function, or nullptr for an empty handle
+  explicit InlineFunction1D(const Function1D* f);
+
+  //! Evaluate the function
+  //! \param[in] x independent variable
+  //! \return Function evaluated at x
+  double operator()(double x) const
+  {
+    switch (type_) {
+    case Type::polynomial: {
+      // Horner's rule, as in Polynomial
+      double y = 0.0;
+      for (int i = n_ - 1; i >= 0; --i) {
+        y = y*x + y_[i];
+      }
+      return y;
+    }
+    case Type::linear:
+      return (*this)(x, this->interval(x));
+    default:
+      return (*f_)(x);
+    }
+  }
+
+  //! Evaluate a linear table in a given interval of its abscissa
+  //
+  //! The interval may have been found for another table on the same abscissa,
+  //! so that functions sharing a grid are searched only once.
+  //! \param[in] x independent variable
+  //! \param[in] i Interval containing x, as given by interval()
+  //! \return Function evaluated at x
+  double operator()(double x, int i) const
+  {
+    if (i < 0) return y_[0];
+    if (i >= n_ - 1) return y_[n_ - 1];
+    double r = (x - x_[i])/(x_[i + 1] - x_[i]);
+    return y_[i] + r*(y_[i + 1] - y_[i]);
+  }
+
+  //! Find the interval of the abscissa of a linear table containing x
+  //! \param[in] x independent variable
+  //! \return Index of the interval, -1 below the first point or n - 1 above
+  //!   the last of the n points
+  int interval(double x) const
+  {
+    if (x < x_[0]) return -1;
+    if (x > x_[n_ - 1]) return n_ - 1;
+    return lower_bound_index(x_, x_ + n_, x);
+  }
+
+  //! Whether the function is a linear table
+  bool linear() const { return type_ == Type::linear; }
+
+  //! Whether this and another function are linear tables on the same abscissa
+  bool same_grid(const InlineFunction1D& other) const;
+
+  explicit operator bool() const { return f_; }
+private:
+  enum class Type {
+    general, polynomial, linear
+  };
+
+  Type type_ {Type::general};
+  const Function1D* f_ {nullptr}; //!< Function referred to
+  const double* x_ {nullptr}; //!< Abscissa of a linear table
+  const double* y_ {nullptr}; //!< Ordinate or polynomial coefficients
+  int n_ {0}; //!< Number of points or coefficients
+};
+
 //! Read 1D function from HDF5 dataset
 //! \param[in] group HDF5 group containing dataset
 //! \param[in] name Name of dataset
@@ -26,27 +26,88 @@ namespace openmc {
 struct EventQueueItem{
   int64_t idx;         //!< particle index in event-based particle buffer
   Particle::Type type; //!< particle type
-  int64_t material;    //!< material that particle is in
+  int64_t material;    //!< material class (or material) that particle is in
   double E;            //!< particle energy
 
   // Constructors
   EventQueueItem() = default;
-  EventQueueItem(const Particle& p, int64_t buffer_idx) :
-    idx(buffer_idx), type(p.type_), material(p.material_), E(p.E_) {}
+  EventQueueItem(const Particle& p, int64_t buffer_idx);
 
   // Compare by particle type, then by material type (4.5% fuel/7.0% fuel/cladding/etc),
-  // then by energy.
-  // TODO: Currently in OpenMC, the material ID corresponds not only to a general
-  // type, but also specific isotopic densities. Ideally we would
-  // like to be able to just sort by general material type, regardless of densities.
-  // A more general material type ID may be added in the future, in which case we
-  // can update the material field of this struct to contain the more general id.
+  // then by energy. Rather than the material index, the material field holds
+  // the material class (see Material::init_class), so that materials that only
+  // differ in their nuclide densities, e.g., depleted fuel in different pins,
+  // are grouped together since they access the same nuclear data.
   bool operator<(const EventQueueItem& rhs) const
   {
     return std::tie(type, material, E) < std::tie(rhs.type, rhs.material, rhs.E);
   }
 };
 
+//==============================================================================
+//! Thread-local staging buffer for appending to a shared event queue
+//
+//! Appending directly to a shared queue requires an atomic operation per
+//! particle, which becomes a point of contention at high thread counts. When
+//! settings::event_local_queue_length is positive, items pushed to this buffer
+//! are instead accumulated locally and copied to the shared queue in chunks,
+//! reserving space for each chunk with a single atomic operation. Otherwise,
+//! items are appended to the shared queue immediately. Each thread should own
+//! its own buffer; any remaining items are flushed when it is destroyed.
+//==============================================================================
+
+class EventQueueBuffer {
+public:
+  explicit EventQueueBuffer(SharedArray<EventQueueItem>& queue);
+  ~EventQueueBuffer() { this->flush(); }
+
+  //! Add an item to the buffer, flushing it if it is full
+  //
+  //! \param item Item to be added to the shared queue
+  void push(const EventQueueItem& item);
+
+  //! Copy all buffered items to the shared queue
+  void flush();
+
+private:
+  SharedArray<EventQueueItem>& queue_; //!< Shared queue to append to
+  std::vector<EventQueueItem> items_;  //!< Items not yet copied to queue_
+  int64_t length_;                     //!< Number of items to buffer
+};
+
+//==============================================================================
+//! Occupancy counters for an event kernel
+//
+//! Each time a kernel is executed, the length of the queue it processes is
+//! recorded. Together with the kernel's timer, this gives the throughput and
+//! typical queue length of each kernel, which is useful for choosing
+//! settings::max_particles_in_flight.
+//==============================================================================
+
+class EventKernelStats {
+public:
+  //! Record one invocation of the kernel
+  //
+  //! \param queue_length Number of particles processed by the invocation
+  void record(int64_t queue_length);
+
+  //! Reset all counters
+  void reset();
+
+  //! Average number of particles processed per invocation
+  double mean_queue_length() const;
+
+  //! Number of particles processed per second
+  //
+  //! \param seconds Total time spent in the kernel
+  double particle_rate(double seconds) const;
+
+  int64_t n_invocations {0};    //!< number of times the kernel was run
+  int64_t n_particles {0};      //!< total number of particles processed
+  int64_t min_queue_length {0}; //!< shortest queue processed
+  int64_t max_queue_length {0}; //!< longest queue processed
+};
+
 //==============================================================================
 // Global variable declarations
 //==============================================================================
@@ -66,6 +127,14 @@ extern SharedArray<EventQueueItem> collision_queue;
 // Particle buffer
 extern std::vector<Particle>  particles;
 
+// Occupancy counters for each event kernel
+extern EventKernelStats stats_event_init;
+extern EventKernelStats stats_event_calculate_xs;
+extern EventKernelStats stats_event_advance_particle;
+extern EventKernelStats stats_event_surface_crossing;
+extern EventKernelStats stats_event_collision;
+extern EventKernelStats stats_event_death;
+
 } // namespace simulation
 
 //==============================================================================
@@ -80,11 +149,35 @@ void init_event_queues(int64_t n_particles);
 //! Free the event queues and particle buffer
 void free_event_queues(void);
 
+//! Memory needed for each particle in flight by the particle buffer and the
+//! event queues
+//
+//! \return Size in bytes
+double particle_buffer_bytes();
+
+//! Reset the occupancy counters of all event kernels
+void reset_event_kernel_stats();
+
+//! Execute the death event for a particle and start the history of the next
+//! unstarted source particle in its place, if any remain
+//
+//! \param p Particle whose history has just ended
+void refill_particle(Particle& p);
+
 //! Enqueue a particle based on if it is in fuel or a non-fuel material
 //
 //! \param buffer_idx The particle's actual index in the particle buffer
 void dispatch_xs_event(int64_t buffer_idx);
 
+//! Enqueue a particle based on if it is in fuel or a non-fuel material using
+//! thread-local staging buffers
+//
+//! \param buffer_idx The particle's actual index in the particle buffer
+//! \param fuel Staging buffer for the fuel XS lookup queue
+//! \param nonfuel Staging buffer for the non-fuel XS lookup queue
+void dispatch_xs_event(int64_t buffer_idx, EventQueueBuffer& fuel,
+  EventQueueBuffer& nonfuel);
+
 //! Execute the initialization event for all particles
 //
 //! \param n_particles The number of particles in the particle buffer
@@ -97,6 +190,10 @@ void process_init_events(int64_t n_particles, int64_t source_offset);
 void process_calculate_xs_events(SharedArray<EventQueueItem>& queue);
 
 //! Execute the advance particle event for all particles in this event's buffer
+//!
+//! If settings::event_fuse_advance is set, the following surface crossing or
+//! collision event is executed as well and particles are enqueued directly for
+//! their next cross section lookup.
 void process_advance_particle_events();
 
 //! Execute the surface crossing event for all particles in this event's buffer
@@ -110,6 +207,17 @@ void process_collision_events();
 //! \param n_particles The number of particles in the particle buffer
 void process_death_events(int64_t n_particles);
 
+//! Finish all particles remaining in the event queues using history-based
+//! tracking, leaving the queues empty
+void process_remaining_events_history_based();
+
+//! Execute event kernels as chosen by settings::event_scheduler until all
+//! event queues are empty
+//!
+//! All kernels are executed within a single OpenMP parallel region in order to
+//! avoid the cost of creating a new parallel region for every kernel.
+void process_events();
+
 } // namespace openmc
 
 #endif // OPENMC_EVENT_H
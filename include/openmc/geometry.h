@@ -4,6 +4,7 @@
 #include <array>
 #include <cmath>
 #include <cstdint>
+#include <utility> // for pair
 #include <vector>
 
 #include "openmc/particle.h"
@@ -46,11 +47,15 @@ bool check_cell_overlap(Particle& p, bool error=true);
 //! \param use_neighbor_lists If true, neighbor lists will be used to accelerate
 //!   the geometry search, but this only works if the cell attribute of the
 //!   particle's lowest coordinate level is valid and meaningful.
+//! \param use_hints If true, the cells that the particle's coordinate levels
+//!   were previously in, from its lowest level down, are checked first at each
+//!   level.  This is useful when the particle has moved into an equivalent
+//!   location, e.g., the neighboring element of a lattice.
 //! \return True if the particle's location could be found and ascribed to a
 //!   valid geometry coordinate stack.
 //==============================================================================
 
-bool find_cell(Particle& p, bool use_neighbor_lists);
+bool find_cell(Particle& p, bool use_neighbor_lists, bool use_hints = false);
 
 //==============================================================================
 //! Move a particle into a new lattice tile.
@@ -60,9 +65,27 @@ void cross_lattice(Particle& p, const BoundaryInfo& boundary);
 
 //==============================================================================
 //! Find the next boundary a particle will intersect.
+//
+//! \param p Particle
+//! \param cell_distance Distance to and signed index of the oncoming surface of
+//!   the cell at the lowest coordinate level, if already known
 //==============================================================================
 
-BoundaryInfo distance_to_boundary(Particle& p);
+BoundaryInfo distance_to_boundary(Particle& p,
+  const std::pair<double, int32_t>* cell_distance = nullptr);
+
+//==============================================================================
+//! Locate a ray in the cell past a boundary it has been moved onto.
+//
+//! Unlike Particle::cross_surface, boundary conditions are not applied, so
+//! that a ray beyond a boundary condition surface leaves the geometry.
+//!
+//! \param p Particle tracing the ray, moved onto the boundary
+//! \param boundary Boundary found by distance_to_boundary
+//! \return True if the ray could be located in a cell past the boundary
+//==============================================================================
+
+bool cross_boundary_ray(Particle& p, const BoundaryInfo& boundary);
 
 } // namespace openmc
 
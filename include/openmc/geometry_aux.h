@@ -5,15 +5,22 @@
 #define OPENMC_GEOMETRY_AUX_H
 
 #include <cstdint>
+#include <set>
 #include <string>
 #include <vector>
 #include <unordered_map>
 
+#include "hdf5.h"
+
 namespace openmc {
 
+class Cell;
+
 namespace model {
-  extern std::unordered_map<int32_t, std::unordered_map<int32_t, int32_t>> universe_cell_counts;
   extern std::unordered_map<int32_t, int32_t> universe_level_counts;
+
+  //! Universes grouped by the number of levels below them
+  extern std::vector<std::vector<int32_t>> universe_levels;
 } // namespace model
 
 void read_geometry_xml();
@@ -72,7 +79,8 @@ int32_t find_root_universe();
 void prepare_distribcell();
 
 //==============================================================================
-//! Recursively search through the geometry and count cell instances.
+//! Count cell instances by visiting each universe once, from the top of the
+//! geometry tree down.
 //!
 //! This function will update the Cell::n_instances value for each cell in the
 //! geometry.
@@ -82,20 +90,6 @@ void prepare_distribcell();
 
 void count_cell_instances(int32_t univ_indx);
 
-//==============================================================================
-//! Recursively search through universes and count universe instances.
-//! \param search_univ The index of the universe to begin searching from.
-//! \param target_univ_id The ID of the universe to be counted.
-//! \param univ_count_memo Memoized counts that make this function faster for
-//!   large systems.  The first call to this function for each target_univ_id
-//!   should start with an empty memo.
-//! \return The number of instances of target_univ_id in the geometry tree under
-//!   search_univ.
-//==============================================================================
-
-int count_universe_instances(int32_t search_univ, int32_t target_univ_id,
-  std::unordered_map<int32_t, int32_t>& univ_count_memo);
-
 //==============================================================================
 //! Build a character array representing the path to a distribcell instance.
 //! \param target_cell The index of the Cell in the global Cell array.
@@ -118,6 +112,39 @@ distribcell_path(int32_t target_cell, int32_t map, int32_t target_offset);
 
 int maximum_levels(int32_t univ);
 
+//==============================================================================
+//! Add the materials filling a cell, including those in the universes and
+//! lattices nested in it, to a set.
+//! \param c The cell
+//! \param[out] materials Indices of the materials, which do not include void
+//==============================================================================
+
+void fill_materials(const Cell& c, std::set<int32_t>& materials);
+
+//==============================================================================
+//! Compute a hash of the cells, surfaces and lattices of the geometry that
+//! identifies it for data depending on where each cell is
+//! \return 64-bit FNV-1a hash
+//==============================================================================
+
+uint64_t geometry_hash();
+
+//==============================================================================
+//! Write the neighbor lists of all cells along with the geometry hash.
+//! \param group HDF5 group to write to
+//==============================================================================
+
+void write_neighbor_lists(hid_t group);
+
+//==============================================================================
+//! Fill the neighbor lists of the cells from those written to a statepoint
+//! file by an earlier run. The lists are only used if the file was written for
+//! the same geometry.
+//! \param filename Path to the statepoint file
+//==============================================================================
+
+void read_neighbor_lists(const std::string& filename);
+
 //==============================================================================
 //! Deallocates global vectors and maps for cells, universes, and lattices.
 //==============================================================================
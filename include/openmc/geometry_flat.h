@@ -0,0 +1,349 @@
+//! \file geometry_flat.h
+//! Flat, pointer-free copy of the CSG geometry
+
+#ifndef OPENMC_GEOMETRY_FLAT_H
+#define OPENMC_GEOMETRY_FLAT_H
+
+#include <array>
+#include <cstdint>
+#include <utility> // for pair
+#include <vector>
+
+#include "openmc/cell.h"
+#include "openmc/lattice.h"
+#include "openmc/particle.h"
+#include "openmc/position.h"
+
+namespace openmc {
+
+//==============================================================================
+//! Copy of the surfaces, cells, universes and lattices of a CSG geometry held
+//! in contiguous arrays that only refer to each other by index.
+//
+//! Variable-length data of each object is stored in one array for all objects,
+//! with the data of object i in [offset[i], offset[i + 1]). Nothing refers to
+//! model::surfaces or model::cells, so the arrays can be copied as they are to
+//! another address space, e.g. an accelerator or a shared memory segment. The
+//! kernels below give the same results as the corresponding methods of the
+//! Surface, CSGCell and Lattice classes.
+//
+//! The arrays are owned by a FlatGeometryArrays. A FlatGeometry only points to
+//! them, so it is trivially copyable and a copy pointing to device copies of
+//! the arrays can be passed to an offloaded kernel.
+//
+//! DAGMC surfaces and cells have no flat form; when they are present, the flat
+//! geometry is incomplete and the kernels must not be used for them.
+//
+//! The flat geometry is only built when settings::flat_geometry is set. Once
+//! it is complete, distance_to_boundary() uses it for every particle.
+//==============================================================================
+
+struct FlatGeometryArrays;
+
+class FlatGeometry {
+public:
+  //! Type of a surface, which determines its coefficients
+  enum class SurfaceKind : int32_t {
+    X_PLANE,    //!< x0
+    Y_PLANE,    //!< y0
+    Z_PLANE,    //!< z0
+    PLANE,      //!< A, B, C, D
+    X_CYLINDER, //!< y0, z0, r
+    Y_CYLINDER, //!< x0, z0, r
+    Z_CYLINDER, //!< x0, y0, r
+    SPHERE,     //!< x0, y0, z0, r
+    X_CONE,     //!< x0, y0, z0, r^2
+    Y_CONE,     //!< x0, y0, z0, r^2
+    Z_CONE,     //!< x0, y0, z0, r^2
+    QUADRIC,    //!< A, B, C, D, E, F, G, H, J, K
+    OTHER       //!< No flat form
+  };
+
+  //! Node of the region of a complex cell, as in CSGCell::region_tree_
+  struct RegionNode {
+    int32_t token; //!< OP_INTERSECTION, OP_UNION, or a signed surface token
+    int32_t size;  //!< number of nodes in the subtree rooted at this node
+  };
+
+  //! Largest nesting of operators in the region of a cell with a flat form
+  static constexpr int MAX_REGION_DEPTH {32};
+
+  //! Build the flat geometry from model::surfaces, model::cells,
+  //! model::universes and model::lattices
+  //! \param arrays Arrays to fill, which the flat geometry then points to
+  void build(FlatGeometryArrays& arrays);
+
+  //! Stop pointing to the arrays
+  void clear();
+
+  //! Whether the flat geometry was built and every surface and cell has a
+  //! flat form
+  bool complete() const { return complete_; }
+
+  //----------------------------------------------------------------------------
+  // Surface kernels
+
+  //! Evaluate the equation of a surface, as Surface::evaluate
+  //! \param i Index of the surface
+  //! \param r Position
+  //! \return Value of the surface equation at r
+  double surface_evaluate(int32_t i, Position r) const;
+
+  //! Determine the side of a surface a point is on, as Surface::sense
+  //! \param i Index of the surface
+  //! \param r Position
+  //! \param u Direction, which resolves points coincident with the surface
+  //! \return Whether the point is on the positive side
+  bool surface_sense(int32_t i, Position r, Direction u) const;
+
+  //! Compute the distance to a surface, as Surface::distance
+  //! \param i Index of the surface
+  //! \param r Position
+  //! \param u Direction
+  //! \param coincident Whether the point lies on the surface
+  //! \return Distance along u or INFTY if the surface is not crossed
+  double surface_distance(int32_t i, Position r, Direction u,
+    bool coincident) const;
+
+  //! Compute the normal of a surface, as Surface::normal
+  //! \param i Index of the surface
+  //! \param r Position on the surface
+  //! \return Normal, pointing toward the positive side, that is not normalized
+  Direction surface_normal(int32_t i, Position r) const;
+
+  //----------------------------------------------------------------------------
+  // Cell kernels
+
+  //! Determine whether a cell contains a point, as CSGCell::contains
+  //! \param i Index of the cell
+  //! \param r Position
+  //! \param u Direction
+  //! \param on_surface Signed index of the surface the point is on, or 0
+  //! \return Whether the point is in the cell
+  bool cell_contains(int32_t i, Position r, Direction u,
+    int32_t on_surface) const;
+
+  //! Find the oncoming boundary of a cell, as CSGCell::distance
+  //! \param i Index of the cell
+  //! \param r Position
+  //! \param u Direction
+  //! \param on_surface Signed index of the surface the point is on, or 0
+  //! \param[out] i_surf Signed index of the oncoming surface
+  //! \return Distance to the boundary
+  double cell_distance(int32_t i, Position r, Direction u, int32_t on_surface,
+    int32_t& i_surf) const;
+
+  //----------------------------------------------------------------------------
+  // Lattice kernels
+
+  //! Find the tile of a lattice containing a point, as Lattice::get_indices
+  //! \param i Index of the lattice
+  //! \param r Position in the coordinates of the lattice
+  //! \param u Direction, which resolves points on the edge of a tile
+  //! \return Indices of the tile
+  std::array<int, 3> lattice_indices(int32_t i, Position r, Direction u) const;
+
+  //! Find the tile of a rectangular lattice containing a point, as
+  //! RectLattice::get_indices
+  //! \param i Index of the lattice, which must be rectangular
+  //! \param r Position in the coordinates of the lattice
+  //! \param u Direction, which resolves points on the edge of a tile
+  //! \return Indices of the tile
+  std::array<int, 3> rect_lattice_indices(int32_t i, Position r,
+    Direction u) const;
+
+  //! Find the tile of a hexagonal lattice containing a point, as
+  //! HexLattice::get_indices
+  //! \param i Index of the lattice, which must be hexagonal
+  //! \param r Position in the coordinates of the lattice
+  //! \param u Direction, which resolves points on the edge of a tile
+  //! \return Indices of the tile
+  std::array<int, 3> hex_lattice_indices(int32_t i, Position r,
+    Direction u) const;
+
+  //! Convert a position to the coordinates of a tile, as
+  //! Lattice::get_local_position
+  //! \param i Index of the lattice
+  //! \param r Position in the coordinates of the lattice
+  //! \param i_xyz Indices of the tile
+  //! \return Position relative to the center of the tile
+  Position lattice_local_position(int32_t i, Position r,
+    const std::array<int, 3>& i_xyz) const;
+
+  //! Find the distance to the next tile of a lattice, as Lattice::distance
+  //! \param i Index of the lattice
+  //! \param r Position in the coordinates of the tile for rectangular
+  //!   lattices, or of the lattice, with z in those of the tile, for
+  //!   hexagonal lattices
+  //! \param u Direction
+  //! \param i_xyz Indices of the tile
+  //! \return Distance and change of the indices when the tile is left
+  std::pair<double, std::array<int, 3>> lattice_distance(int32_t i,
+    Position r, Direction u, const std::array<int, 3>& i_xyz) const;
+
+  //! Find the universe filling a tile of a lattice
+  //! \param i Index of the lattice
+  //! \param i_xyz Indices of the tile
+  //! \return Index of the universe, the outer universe for tiles outside the
+  //!   lattice, or NO_OUTER_UNIVERSE if there is none
+  int32_t lattice_universe(int32_t i, const std::array<int, 3>& i_xyz) const;
+
+  //----------------------------------------------------------------------------
+  // Particle kernels
+
+  //! Find the nearest boundary of the cells and lattice tiles of a particle,
+  //! as openmc::distance_to_boundary
+  //! \param coord Coordinates of the particle at each level
+  //! \param n_coord Number of coordinate levels
+  //! \param on_surface Signed index of the surface the particle is on, or 0
+  //! \param cell_distance Distance to and signed index of the oncoming
+  //!   surface of the cell at the lowest level if already known, or nullptr
+  //! \param[out] lost Set if the distance to a lattice boundary was negative
+  //! \return Nearest boundary
+  BoundaryInfo distance_to_boundary(const LocalCoord* coord, int n_coord,
+    int32_t on_surface, const std::pair<double, int32_t>* cell_distance,
+    bool& lost) const;
+
+  //----------------------------------------------------------------------------
+  // Data members, pointing to the arrays of the same name in a
+  // FlatGeometryArrays
+
+  // Surfaces
+  const SurfaceKind* surface_kind_ {nullptr};
+  const int32_t* surface_offset_ {nullptr};
+  const double* surface_coeffs_ {nullptr};
+
+  // Cells
+  const Fill* cell_type_ {nullptr};
+  const int32_t* cell_universe_ {nullptr};
+  const int32_t* cell_fill_ {nullptr};
+  const uint8_t* cell_simple_ {nullptr};
+  const int32_t* cell_token_offset_ {nullptr};
+  const int32_t* cell_tokens_ {nullptr};
+  const int32_t* cell_region_offset_ {nullptr};
+  const RegionNode* cell_region_ {nullptr};
+  const int32_t* cell_material_offset_ {nullptr};
+  const int32_t* cell_materials_ {nullptr};
+  const Position* cell_translation_ {nullptr};
+  const int32_t* cell_rotation_offset_ {nullptr};
+  const double* cell_rotations_ {nullptr};
+
+  // Universes
+  const int32_t* universe_offset_ {nullptr};
+  const int32_t* universe_cells_ {nullptr};
+
+  // Lattices
+  const LatticeType* lattice_type_ {nullptr};
+  const int32_t* lattice_outer_ {nullptr};
+  const uint8_t* lattice_is_3d_ {nullptr};
+  const std::array<int, 3>* lattice_shape_ {nullptr};
+  const Position* lattice_origin_ {nullptr};
+  const Position* lattice_pitch_ {nullptr};
+  const std::array<std::array<double, 2>, 3>* lattice_face_normals_ {nullptr};
+  const int32_t* lattice_offset_ {nullptr};
+  const int32_t* lattice_universes_ {nullptr};
+
+private:
+  //! Find the tile of a hexagonal lattice whose center is closest to a
+  //! position, as HexLattice::nearest_tile
+  void hex_nearest_tile(int32_t i, Position r, int& i1, int& i2) const;
+
+  bool complete_ {false}; //!< Does every surface and cell have a flat form?
+};
+
+//==============================================================================
+//! Arrays holding the data a FlatGeometry points to
+//==============================================================================
+
+struct FlatGeometryArrays {
+  using SurfaceKind = FlatGeometry::SurfaceKind;
+  using RegionNode = FlatGeometry::RegionNode;
+
+  // Surfaces
+  std::vector<SurfaceKind> surface_kind;   //!< Type of each surface
+  std::vector<int32_t> surface_offset;     //!< Offsets in surface_coeffs
+  std::vector<double> surface_coeffs;      //!< Surface coefficients
+
+  // Cells
+  std::vector<Fill> cell_type;             //!< Fill type of each cell
+  std::vector<int32_t> cell_universe;      //!< Universe containing each cell
+  std::vector<int32_t> cell_fill;          //!< Universe or lattice filling
+                                           //!< each cell
+  std::vector<uint8_t> cell_simple;        //!< Does the region only contain
+                                           //!< intersections?
+  std::vector<int32_t> cell_token_offset;  //!< Offsets in cell_tokens
+  std::vector<int32_t> cell_tokens;        //!< Signed surface tokens of each
+                                           //!< region, in RPN order
+  std::vector<int32_t> cell_region_offset; //!< Offsets in cell_region
+  std::vector<RegionNode> cell_region;     //!< Regions of complex cells
+  std::vector<int32_t> cell_material_offset; //!< Offsets in cell_materials
+  std::vector<int32_t> cell_materials;     //!< Materials of each instance
+  std::vector<Position> cell_translation;  //!< Translation of each fill
+  std::vector<int32_t> cell_rotation_offset; //!< Offsets in cell_rotations
+  std::vector<double> cell_rotations;      //!< Rotation matrices of fills
+
+  // Universes
+  std::vector<int32_t> universe_offset;    //!< Offsets in universe_cells
+  std::vector<int32_t> universe_cells;     //!< Cells of each universe
+
+  // Lattices
+  std::vector<LatticeType> lattice_type;   //!< Type of each lattice
+  std::vector<int32_t> lattice_outer;      //!< Outer universe of each lattice
+  std::vector<uint8_t> lattice_is_3d;      //!< Has divisions along z?
+  std::vector<std::array<int, 3>> lattice_shape; //!< Tiles along x, y, z for
+                                           //!< rectangular lattices; rings,
+                                           //!< axial tiles and orientation
+                                           //!< for hexagonal lattices
+  std::vector<Position> lattice_origin;    //!< Lower-left corner or center
+  std::vector<Position> lattice_pitch;     //!< Tile widths
+  //! Unit normals of the sides of the tiles of hexagonal lattices in the
+  //! xy-plane, as HexLattice::face_normals_
+  std::vector<std::array<std::array<double, 2>, 3>> lattice_face_normals;
+  std::vector<int32_t> lattice_offset;     //!< Offsets in lattice_universes
+  std::vector<int32_t> lattice_universes;  //!< Universes filling each tile
+};
+
+//==============================================================================
+// Global variables
+//==============================================================================
+
+namespace model {
+
+extern FlatGeometry flat_geometry; //!< Flat copy of the CSG geometry
+extern FlatGeometryArrays flat_geometry_arrays; //!< Arrays of flat_geometry
+#ifdef OPENMC_OFFLOAD
+extern FlatGeometry device_flat_geometry; //!< Copy pointing to device arrays
+#endif
+
+} // namespace model
+
+#ifdef OPENMC_OFFLOAD
+
+//==============================================================================
+// Offloading
+//==============================================================================
+
+//! Copy the arrays of the flat geometry to the default offload device
+void copy_flat_geometry_to_device();
+
+//! Free the device copies of the arrays of the flat geometry
+void free_flat_geometry_device();
+
+//! Find the nearest boundaries of particles on the offload device, as
+//! FlatGeometry::distance_to_boundary
+//! \param n Number of particles
+//! \param n_levels Number of coordinate levels stored per particle
+//! \param coord Coordinates of the particles at each level
+//! \param n_coord Number of coordinate levels of each particle
+//! \param on_surface Signed index of the surface each particle is on, or 0
+//! \param[out] info Nearest boundary of each particle
+//! \param[out] lost Whether the distance to a lattice boundary was negative
+void device_distance_to_boundary(int64_t n, int n_levels,
+  const LocalCoord* coord, const int* n_coord, const int32_t* on_surface,
+  BoundaryInfo* info, uint8_t* lost);
+
+#endif
+
+} // namespace openmc
+
+#endif // OPENMC_GEOMETRY_FLAT_H
@@ -6,6 +6,7 @@
 #include <complex>
 #include <cstddef>
 #include <cstring> // for strlen
+#include <mutex>
 #include <string>
 #include <sstream>
 #include <type_traits>
@@ -21,6 +22,11 @@
 
 namespace openmc {
 
+//! Serializes calls into the HDF5 library, which is not necessarily built
+//! thread-safe, from threads that may run concurrently: background state point
+//! and summary writers and deferred reads of reaction products during transport
+extern std::mutex hdf5_mutex;
+
 //==============================================================================
 // Low-level internal functions
 //==============================================================================
@@ -40,6 +46,14 @@ void write_dataset_lowlevel(hid_t group_id, int ndim, const hsize_t* dims,
 
 bool using_mpio_device(hid_t obj_id);
 
+//! Create the dataset creation property list of tally results
+//
+//! \param n_filter Number of filter combinations
+//! \param n_score Number of scores
+//! \param compression Deflate compression level or 0 for no compression
+//! \return Property list that must be closed or H5P_DEFAULT
+hid_t tally_results_dcpl(hsize_t n_filter, hsize_t n_score, int compression);
+
 //==============================================================================
 // Normal functions that are used to read/write files
 //==============================================================================
@@ -52,16 +66,31 @@ inline hid_t create_group(hid_t parent_id, const std::stringstream& name)
 
 hid_t file_open(const std::string& filename, char mode, bool parallel=false);
 
+//! Read an HDF5 file on the master process and broadcast its contents
+//
+//! Later calls to file_open() in read mode on this file open its image in
+//! memory, so that only the master process touches the filesystem. All
+//! processes must call this function together with the same file.
+//! \param filename Path to the file
+void broadcast_file_image(const std::string& filename);
+
+//! Release the images of files broadcast by broadcast_file_image()
+void free_file_images();
+
 void write_string(hid_t group_id, const char* name, const std::string& buffer,
                   bool indep);
 
 std::vector<hsize_t> attribute_shape(hid_t obj_id, const char* name);
 std::vector<std::string> dataset_names(hid_t group_id);
 void ensure_exists(hid_t obj_id, const char* name, bool attribute=false);
+std::string file_name(hid_t obj_id);
 std::vector<std::string> group_names(hid_t group_id);
 std::vector<hsize_t> object_shape(hid_t obj_id);
 std::string object_name(hid_t obj_id);
 
+//! Whether the HDF5 library may be called from multiple threads at once
+bool using_threadsafe_hdf5();
+
 //==============================================================================
 // Fortran compatibility functions
 //==============================================================================
@@ -116,7 +145,7 @@ extern "C" {
   void write_string(hid_t group_id, int ndim, const hsize_t* dims, size_t slen,
                     const char* name, char const* buffer, bool indep);
   void write_tally_results(hid_t group_id, hsize_t n_filter, hsize_t n_score,
-                           const double* results);
+                           const double* results, int compression);
 } // extern "C"
 
 //==============================================================================
@@ -318,6 +347,20 @@ void read_dataset(hid_t obj_id, const char* name, xt::xarray<T>& arr,
 }
 
 
+//! Read a whole dataset into storage that already has its size
+template <typename T>
+inline void read_dataset_into(hid_t dset, T* buffer, bool indep)
+{
+  read_dataset_lowlevel(dset, nullptr, H5TypeMap<T>::type_id, H5S_ALL, indep,
+                        buffer);
+}
+
+inline void
+read_dataset_into(hid_t dset, std::complex<double>* buffer, bool indep)
+{
+  read_complex(dset, nullptr, buffer, indep);
+}
+
 template <typename T, std::size_t N>
 void read_dataset(hid_t obj_id, const char* name, xt::xtensor<T, N>& arr,
                   bool indep=false)
@@ -327,22 +370,23 @@ void read_dataset(hid_t obj_id, const char* name, xt::xtensor<T, N>& arr,
 
   // Get shape of dataset
   std::vector<hsize_t> hsize_t_shape = object_shape(dset);
-  close_dataset(dset);
+  if (hsize_t_shape.size() != N) {
+    close_dataset(dset);
+    fatal_error(std::string("Dataset ") + name + " does not have "
+      + std::to_string(N) + " dimensions.");
+  }
 
   // cast from hsize_t to size_t
-  std::vector<size_t> shape(hsize_t_shape.size());
-  for (int i = 0; i < shape.size(); i++) {
+  std::array<size_t, N> shape;
+  for (int i = 0; i < N; i++) {
     shape[i] = static_cast<size_t>(hsize_t_shape[i]);
   }
 
-  // Allocate new xarray to read data into
-  xt::xarray<T> xarr(shape);
-
-  // Read data from the dataset
-  read_dataset(obj_id, name, xarr);
-
-  // Copy into xtensor
-  arr = xarr;
+  // Allocate the array and read the data straight into it, converting to the
+  // element type if needed, so that no temporary copy of a large table is made
+  arr.resize(shape);
+  read_dataset_into(dset, arr.data(), indep);
+  close_dataset(dset);
 }
 
 // overload for Position
@@ -362,18 +406,8 @@ inline void read_dataset_as_shape(hid_t obj_id, const char* name,
 {
   hid_t dset = open_dataset(obj_id, name);
 
-  // Allocate new array to read data into
-  std::size_t size = 1;
-  for (const auto x : arr.shape())
-    size *= x;
-  std::vector<T> buffer(size);
-
-  // Read data from attribute
-  read_dataset_lowlevel(dset, nullptr, H5TypeMap<T>::type_id, H5S_ALL, indep,
-                        buffer.data());
-
-  // Adapt into xarray
-  arr = xt::adapt(buffer, arr.shape());
+  // The array already has its final shape, so read into its storage
+  read_dataset_into(dset, arr.data(), indep);
 
   close_dataset(dset);
 }
@@ -0,0 +1,76 @@
+//! \file instrument.h
+//! Named regions marking transport kernels for external profilers
+
+#ifndef OPENMC_INSTRUMENT_H
+#define OPENMC_INSTRUMENT_H
+
+#include "openmc/settings.h"
+
+namespace openmc {
+
+//==============================================================================
+// Regions shown in profilers. The names are given by region_name().
+//==============================================================================
+
+enum class Region {
+  EVENT_INIT,
+  EVENT_CALCULATE_XS,
+  EVENT_ADVANCE,
+  EVENT_SURFACE_CROSSING,
+  EVENT_COLLISION,
+  EVENT_DEATH,
+  EVENT_HISTORY_TAIL,
+  CALCULATE_XS,
+  DISTANCE_TO_BOUNDARY,
+  FIND_CELL,
+  TALLY_SCORING,
+  N_REGIONS
+};
+
+//==============================================================================
+//! Marks the lifetime of the object as a region of the calling thread
+//
+//! Regions are reported through the ITT API (Intel VTune) or NVTX (NVIDIA
+//! Nsight) when OpenMC is built with the itt or nvtx option, and only while
+//! settings::instrument is set. Otherwise the object does nothing and is
+//! optimized away.
+//==============================================================================
+
+class InstrumentRegion {
+public:
+#if defined(OPENMC_ITT) || defined(OPENMC_NVTX)
+  explicit InstrumentRegion(Region region) : active_ {settings::instrument}
+  {
+    if (active_) begin_region(region);
+  }
+
+  ~InstrumentRegion()
+  {
+    if (active_) end_region();
+  }
+#else
+  explicit InstrumentRegion(Region) {}
+#endif
+
+  InstrumentRegion(const InstrumentRegion&) = delete;
+  InstrumentRegion& operator=(const InstrumentRegion&) = delete;
+
+private:
+#if defined(OPENMC_ITT) || defined(OPENMC_NVTX)
+  static void begin_region(Region region);
+  static void end_region();
+
+  bool active_; //!< whether a region was begun
+#endif
+};
+
+//==============================================================================
+// Non-member functions
+//==============================================================================
+
+//! Get the name of a region as shown in profilers
+const char* region_name(Region region);
+
+} // namespace openmc
+
+#endif // OPENMC_INSTRUMENT_H
@@ -76,10 +76,6 @@ public:
   void allocate_offset_table(int n_maps)
   {offsets_.resize(n_maps * universes_.size(), C_NONE);}
 
-  //! Populate the distribcell offset tables.
-  int32_t fill_offset_table(int32_t offset, int32_t target_univ_id, int map,
-    std::unordered_map<int32_t, int32_t>& univ_count_memo);
-
   //! \brief Check lattice indices.
   //! \param i_xyz[3] The indices for a lattice tile.
   //! \return true if the given indices fit within the lattice bounds.  False
@@ -206,6 +202,8 @@ class RectLattice : public Lattice
 public:
   explicit RectLattice(pugi::xml_node lat_node);
 
+  friend class FlatGeometry;
+
   int32_t& operator[](std::array<int, 3> i_xyz);
 
   bool are_valid_indices(const int i_xyz[3]) const;
@@ -224,6 +222,17 @@ public:
 
   void to_hdf5_inner(hid_t group_id) const;
 
+  //! \brief Check whether the tiles are the elements of a regular mesh.
+  //! \param n_dimension Number of dimensions of the mesh, which must be that
+  //!   of the lattice.
+  //! \param lower_left Lower-left coordinates of the mesh.
+  //! \param width Width of the mesh elements along each axis.
+  //! \param shape Number of mesh elements along each axis.
+  //! \return Whether every tile coincides with the mesh element of the same
+  //!   indices.
+  bool tiles_match(int n_dimension, const double* lower_left,
+    const double* width, const int* shape) const;
+
 private:
   std::array<int, 3> n_cells_;    //!< Number of cells along each axis
   Position lower_left_;           //!< Global lower-left corner of the lattice
@@ -242,6 +251,8 @@ class HexLattice : public Lattice
 public:
   explicit HexLattice(pugi::xml_node lat_node);
 
+  friend class FlatGeometry;
+
   int32_t& operator[](std::array<int, 3> i_xyz);
 
   LatticeIter begin();
@@ -278,11 +289,32 @@ private:
   //! Fill universes_ vector for 'x' orientation
   void fill_lattice_x(const std::vector<std::string>& univ_words);
 
+  //! Find the tile whose center is closest to a position, ignoring ties
+  //
+  //! \param r Position relative to the lattice center
+  //! \param[out] i1 First skewed index of the tile
+  //! \param[out] i2 Second skewed index of the tile
+  void nearest_tile(Position r, int& i1, int& i2) const;
+
+  // Change in the skewed indices when moving into the neighboring tile across
+  // the beta, gamma, and delta sides of a tile.  These are the same for both
+  // orientations.
+  static constexpr int FACE_SHIFT[3][2] {{1, 0}, {1, -1}, {0, 1}};
+
+  // Relative distance from the side of a tile below which get_indices resolves
+  // the tile by comparing distances to the candidate tile centers.  This is
+  // looser than the coincidence tolerance used in that comparison so that the
+  // result only depends on the direction of the particle where it did before.
+  static constexpr double HEX_SIDE_TOLERANCE {1e-8};
+
   int n_rings_;                   //!< Number of radial tile positions
   int n_axial_;                   //!< Number of axial tile positions
   Orientation orientation_;       //!< Orientation of lattice
   Position center_;               //!< Global center of lattice
   std::array<double, 2> pitch_;   //!< Lattice tile width and height
+
+  //! Unit normals of the beta, gamma, and delta sides of a tile in the xy-plane
+  std::array<std::array<double, 2>, 3> face_normals_;
 };
 
 //==============================================================================
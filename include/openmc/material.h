@@ -1,9 +1,11 @@
 #ifndef OPENMC_MATERIAL_H
 #define OPENMC_MATERIAL_H
 
+#include <map>
 #include <memory> // for unique_ptr
 #include <string>
 #include <unordered_map>
+#include <utility> // for pair
 #include <vector>
 
 #include <gsl/gsl>
@@ -13,6 +15,7 @@
 
 #include "openmc/constants.h"
 #include "openmc/bremsstrahlung.h"
+#include "openmc/condensed_history.h"
 #include "openmc/particle.h"
 
 namespace openmc {
@@ -28,6 +31,13 @@ namespace model {
 extern std::unordered_map<int32_t, int32_t> material_map;
 extern std::vector<std::unique_ptr<Material>> materials;
 
+//! Map from the nuclide/thermal table signature of a material to the index of
+//! its material class. Materials sharing a class differ only in densities.
+extern std::map<std::vector<int>, int32_t> material_class_map;
+
+//! Largest number of nuclides in any material
+extern int max_material_nuclides;
+
 } // namespace model
 
 //==============================================================================
@@ -54,7 +64,28 @@ public:
   //----------------------------------------------------------------------------
   // Methods
 
-  void calculate_xs(Particle& p) const;
+  //! Calculate the macroscopic cross sections at the particle's energy
+  //
+  //! \param p Particle
+  //! \param table Whether the cross section table may be used instead of
+  //!   calculating the cross sections of each nuclide
+  void calculate_xs(Particle& p, bool table = true) const;
+
+  //! Prefetch the nuclide data that calculate_xs() will need for a neutron,
+  //! in two stages as Nuclide::prefetch_xs
+  //
+  //! \param E Energy of the neutron in [eV]
+  //! \param sqrtkT Square root of the temperature of the neutron in [eV]
+  //! \param rows Whether to prefetch the energy grids and cross sections
+  //!   rather than the search data
+  void prefetch_neutron_xs(double E, double sqrtkT, bool rows) const;
+
+  //! Whether the cross section table gives the macroscopic cross sections of
+  //! a particle, in which case those of the nuclides are not calculated
+  //
+  //! \param p Particle
+  //! \return Whether the table is used for the particle
+  bool xs_tabulated(const Particle& p) const;
 
   //! Assign thermal scattering tables to specific nuclides within the material
   //! so the code knows when to apply bound thermal scattering data
@@ -63,6 +94,35 @@ public:
   //! Set up mapping between global nuclides vector and indices in nuclide_
   void init_nuclide_index();
 
+  //! Assign the material class based on the nuclides and thermal scattering
+  //! tables present in the material
+  void init_class();
+
+  //! Build the unionized energy grid if requested for this material
+  //
+  //! The unionized grid is the union of the energy grids of every nuclide in
+  //! the material at every temperature. For each interval of the unionized
+  //! grid, the index of the corresponding interval in each nuclide grid is
+  //! stored so that a single search serves all nuclides.
+  void init_union_grid();
+
+  //! Tabulate the macroscopic photon cross sections if
+  //! settings::photon_material_tables is set
+  //
+  //! The tables are built on the union of the energy grids of the elements in
+  //! the material, refined to the spacing of the equal-logarithmic photon
+  //! grid, so that a lookup is a single linear interpolation. They depend on
+  //! the atom densities and must be rebuilt when these change.
+  void init_photon_tables();
+
+  //! Tabulate the macroscopic total, absorption, fission and nu-fission cross
+  //! sections if requested for this material
+  //
+  //! The table is built on the union of the energy grids of the nuclides at
+  //! the temperature of the material, where the cross sections are linear. It
+  //! depends on the atom densities and must be rebuilt when these change.
+  void init_xs_table();
+
   //! Finalize the material, assigning tables, normalize density, etc.
   void finalize();
 
@@ -127,6 +187,10 @@ public:
   //! \return Whether material is fissionable
   bool fissionable() const { return fissionable_; }
 
+  //! Get index of the material class
+  //! \return Index of the material class, or C_NONE if not yet assigned
+  int32_t material_class() const { return class_; }
+
   //! Get volume of material
   //! \return Volume in [cm^3]
   double volume() const;
@@ -143,6 +207,26 @@ public:
   double volume_ {-1.0}; //!< Volume in [cm^3]
   bool fissionable_ {false}; //!< Does this material contain fissionable nuclides
   bool depletable_ {false}; //!< Is the material depletable?
+  int32_t class_ {C_NONE}; //!< Index of material class (see init_class)
+  bool union_grid_ {false}; //!< Use a unionized energy grid for XS lookups?
+  std::vector<double> union_energy_; //!< Unionized energy grid in [eV]
+  std::vector<int> union_grid_index_; //!< Log-grid mapping into union_energy_
+  std::vector<int> union_offset_; //!< First column in union_index_ of each nuclide
+  xt::xtensor<int, 2> union_index_; //!< Index in each nuclide/temperature grid
+  std::vector<int> union_nuclides_; //!< Nuclides the unionized grid is for
+  std::vector<double> photon_energy_; //!< Log of the energies of the photon tables
+  std::vector<int> photon_grid_index_; //!< Log-grid mapping into photon_energy_
+  xt::xtensor<double, 2> photon_xs_; //!< Coherent, incoherent, photoelectric
+                                     //!< and pair production xs in [1/cm],
+                                     //!< then cumulative total xs of elements
+  bool xs_table_ {false}; //!< Tabulate macroscopic cross sections?
+  std::vector<double> table_energy_; //!< Energies of the table in [eV]
+  std::vector<int> table_grid_index_; //!< Log-grid mapping into table_energy_
+  xt::xtensor<double, 2> table_xs_; //!< Total, absorption, fission and
+                                    //!< nu-fission xs in [1/cm]
+  double table_sqrtkT_ {-1.0}; //!< Square root of kT of the table in [eV^1/2]
+  std::pair<double, double> table_urr_; //!< Energies in [eV] between which
+                                        //!< probability tables are sampled
   std::vector<bool> p0_; //!< Indicate which nuclides are to be treated with iso-in-lab scattering
 
   // To improve performance of tallying, we store an array (direct address
@@ -160,6 +244,7 @@ public:
   double temperature_ {-1};
 
   std::unique_ptr<Bremsstrahlung> ttb_;
+  std::unique_ptr<CondensedHistory> ch_;
 
 private:
   //----------------------------------------------------------------------------
@@ -168,13 +253,23 @@ private:
   //! Calculate the collision stopping power
   void collision_stopping_power(double* s_col, bool positron);
 
+  //! Calculate the scaled bremsstrahlung DCS and radiative stopping power
+  void radiative_stopping_power(xt::xtensor<double, 2>& dcs,
+    xt::xtensor<double, 1>& s_rad, bool positron);
+
   //! Initialize bremsstrahlung data
   void init_bremsstrahlung();
 
+  //! Initialize condensed history data for electrons and positrons
+  void init_condensed_history();
+
   //! Normalize density
   void normalize_density();
 
   void calculate_neutron_xs(Particle& p) const;
+
+  //! Interpolate the macroscopic cross sections in the cross section table
+  void interpolate_xs_table(Particle& p) const;
   void calculate_photon_xs(Particle& p) const;
 
   //----------------------------------------------------------------------------
@@ -118,6 +118,22 @@ extern "C" void calc_zn(int n, double rho, double phi, double zn[]);
 
 extern "C" void calc_zn_rad(int n, double rho, double zn_rad[]);
 
+//==============================================================================
+//! Sample the cosine and sine of an azimuthal angle uniformly distributed in
+//! [0, 2pi).
+//!
+//! When settings::azimuth_rejection is set, a point is sampled uniformly in
+//! the unit disk by rejection and the cosine and sine of twice its angle are
+//! formed from its coordinates, so that no trigonometric function or square
+//! root is evaluated. Otherwise, the angle is sampled directly.
+//!
+//! \param seed A pointer to the pseudorandom seed
+//! \param cosphi Cosine of the sampled angle
+//! \param sinphi Sine of the sampled angle
+//==============================================================================
+
+void sample_azimuth(uint64_t* seed, double& cosphi, double& sinphi);
+
 //==============================================================================
 //! Rotate the direction cosines through a polar angle whose cosine is mu and
 //! through an azimuthal angle sampled uniformly.
@@ -274,6 +290,28 @@ double spline_integrate(int n, const double x[], const double y[],
 //! \return Faddeeva function evaluated at z
 std::complex<double> faddeeva(std::complex<double> z);
 
+//! Evaluate the Faddeeva function with real arguments, for the C API
+//!
+//! \param z_re Real part of the argument
+//! \param z_im Imaginary part of the argument
+//! \param[out] w Real and imaginary parts of the Faddeeva function
+extern "C" void faddeeva_c(double z_re, double z_im, double w[2]);
+
+//! Evaluate the Faddeeva function for several arguments at once
+//!
+//! This uses the rational approximation of Weideman (SIAM J. Numer. Anal. 31,
+//! 1994) with 32 terms, whose relative error with respect to faddeeva() is
+//! below 1e-12. Unlike faddeeva(), it has no branches so that the loop over
+//! the arguments is vectorized.
+//!
+//! \param n Number of arguments
+//! \param z_re Real parts of the arguments
+//! \param z_im Imaginary parts of the arguments
+//! \param[out] w_re Real parts of the Faddeeva function at each argument
+//! \param[out] w_im Imaginary parts of the Faddeeva function at each argument
+extern "C" void faddeeva_batch(int n, const double* z_re,
+  const double* z_im, double* w_re, double* w_im);
+
 //! Evaluate derivative of the Faddeeva function
 //!
 //! \param z Complex argument
@@ -0,0 +1,66 @@
+//! \file memory_placement.h
+//! Placement of large, long-lived arrays on NUMA nodes and huge pages
+
+#ifndef OPENMC_MEMORY_PLACEMENT_H
+#define OPENMC_MEMORY_PLACEMENT_H
+
+#include <cstddef> // for size_t
+#include <string>
+#include <vector>
+
+namespace openmc {
+
+//==============================================================================
+//! Interleave the pages of memory first touched by the calling thread during
+//! the lifetime of the object among all NUMA nodes when
+//! settings::numa_interleave is set.
+//
+//! Pages are placed on the node of the thread that first touches them, so data
+//! read or zeroed by the master thread would otherwise all be on one socket
+//! and threads on the other sockets would reach it through the interconnect.
+//! Interleaving spreads the bandwidth of shared, read-mostly arrays over all
+//! memory controllers. The previous policy is restored on destruction.
+//==============================================================================
+
+class InterleaveScope {
+public:
+  InterleaveScope();
+  ~InterleaveScope();
+
+  InterleaveScope(const InterleaveScope&) = delete;
+  InterleaveScope& operator=(const InterleaveScope&) = delete;
+
+private:
+  bool active_ {false}; //!< Was the interleave policy set?
+};
+
+//==============================================================================
+// Non-member functions
+//==============================================================================
+
+//! Read a list of CPU or NUMA node indices, e.g. "0-3,8", from a file
+//
+//! \param path Path of the file, usually under /sys/devices/system
+//! \return Indices in the list, or none if the file could not be read
+std::vector<int> read_id_list(const std::string& path);
+
+//! Ask for an array to be backed by transparent huge pages when
+//! settings::huge_pages is set. Only the huge pages lying entirely within the
+//! array are affected, so arrays smaller than a huge page are left as they
+//! are.
+//
+//! \param data Start of the array
+//! \param size Size of the array in bytes
+void advise_huge_pages(const void* data, std::size_t size);
+
+//! Ask for the energy grids and cross sections of all nuclides to be backed
+//! by transparent huge pages when settings::huge_pages is set
+void advise_nuclear_data();
+
+//! Ask for the results of all tallies to be backed by transparent huge pages
+//! when settings::huge_pages is set
+void advise_tallies();
+
+} // namespace openmc
+
+#endif // OPENMC_MEMORY_PLACEMENT_H
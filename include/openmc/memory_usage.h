@@ -0,0 +1,61 @@
+//! \file memory_usage.h
+//! Accounting of the memory used by the main data structures
+
+#ifndef OPENMC_MEMORY_USAGE_H
+#define OPENMC_MEMORY_USAGE_H
+
+#include <vector>
+
+namespace openmc {
+
+class Nuclide;
+class Tally;
+class ThermalScattering;
+
+//==============================================================================
+// Memory used by each subsystem in bytes. Only the storage held by containers
+// is counted, not the size of the objects themselves, so that these are lower
+// bounds of the memory actually used.
+//==============================================================================
+
+//! Pointwise cross sections, energy grids, 0K elastic data and probability
+//! tables of a nuclide
+double memory_nuclide(const Nuclide& nuc);
+
+//! Cross sections and secondary distributions of an S(a,b) table
+double memory_thermal(const ThermalScattering& table);
+
+//! Data of all nuclides and S(a,b) tables
+double memory_nuclear_data();
+
+//! Accumulated results and statistics of a tally
+double memory_tally(const Tally& tally);
+
+//! Accumulated results and statistics of all tallies
+double memory_tallies();
+
+//! Source, fission and surface source banks
+double memory_banks();
+
+//! Particles in flight and the event queues of event-based transport
+double memory_particle_buffers();
+
+//! Neighbor lists of all cells
+double memory_neighbor_lists();
+
+//! Regions, fills and distribcell offsets of cells, universes and lattices
+double memory_geometry();
+
+//! Largest resident set size of this process so far
+double max_resident_memory();
+
+//! Gather the largest resident set size of each process on the master
+//! process. This must be called by all processes.
+//
+//! \return Resident set size of each process in bytes, only valid on the
+//!   master process
+std::vector<double> gather_max_resident_memory();
+
+} // namespace openmc
+
+#endif // OPENMC_MEMORY_USAGE_H
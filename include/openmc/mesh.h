@@ -4,7 +4,10 @@
 #ifndef OPENMC_MESH_H
 #define OPENMC_MESH_H
 
+#include <array>
+#include <functional> // for function
 #include <memory> // for unique_ptr
+#include <string>
 #include <vector>
 #include <unordered_map>
 
@@ -17,9 +20,10 @@
 
 #ifdef DAGMC
 #include "moab/Core.hpp"
-#include "moab/AdaptiveKDTree.hpp"
 #include "moab/Matrix3.hpp"
 #include "moab/GeomUtil.hpp"
+
+#include "openmc/bvh.h"
 #endif
 
 namespace openmc {
@@ -97,6 +101,19 @@ public:
   // Data members
   int id_ {-1};  //!< User-specified ID
   int n_dimension_; //!< Number of dimensions
+
+  //! Whether the filters of several active tracklength tallies share this
+  //! mesh, in which case the bins crossed by a track are only found once
+  bool shared_tracks_ {false};
+
+  //! Whether the mesh surface crossings of tracks are found while walking the
+  //! bins crossed by tracklength tallies, for a mesh surface tally to reuse
+  bool fused_surfaces_ {false};
+
+  //! Index in model::lattices of a lattice whose tiles are the elements of
+  //! this mesh, so that bins follow from the lattice indices of particles, or
+  //! C_NONE
+  int32_t aligned_lattice_ {C_NONE};
 };
 
 class StructuredMesh : public Mesh {
@@ -124,9 +141,27 @@ public:
   //! \param[out] ijk Mesh indices
   virtual void get_indices_from_bin(int bin, int* ijk) const = 0;
 
+  //! Get the coordinate of the lower edge of the mesh elements with an index
+  //! along a dimension
+  //
+  //! \param[in] dim Dimension
+  //! \param[in] i Mesh index, which is one past the number of elements for the
+  //!   upper edge of the mesh
+  //! \return Coordinate of the edge
+  virtual double edge(int dim, int i) const = 0;
+
   //! Get a label for the mesh bin
   std::string bin_label(int bin) const override;
 
+  //! Determine the mesh bin of a particle from its indices in the aligned
+  //! lattice
+  //
+  //! \param[in] p Particle
+  //! \param[out] bin Mesh bin, or -1 if the particle is outside the lattice
+  //! \return Whether the aligned lattice is a coordinate level of the particle
+  //!   that is neither translated nor rotated from the global frame
+  bool lattice_bin(const Particle& p, int& bin) const;
+
   // Data members
   xt::xtensor<double, 1> lower_left_; //!< Lower-left coordinates of mesh
   xt::xtensor<double, 1> upper_right_; //!< Upper-right coordinates of mesh
@@ -159,6 +194,8 @@ public:
 
   void get_indices_from_bin(int bin, int* ijk) const override;
 
+  double edge(int dim, int i) const override;
+
   int n_bins() const override;
 
   int n_surface_bins() const override;
@@ -178,6 +215,16 @@ public:
   //! \return Whether the line segment connecting r0 and r1 intersects mesh
   bool intersects(Position& r0, Position r1, int* ijk) const;
 
+  //! Find the bins crossed by a track together with the surface bins crossed
+  //! along it, which surface_bins_crossed would give for the same segment
+  //
+  //! \param[in] p Particle whose track from r_last_ to r() is walked
+  //! \param[out] bins Bins crossed by the track
+  //! \param[out] lengths Fraction of the track in each bin
+  //! \param[out] surface_bins Surface bins crossed, which are appended
+  void bins_and_surfaces_crossed(const Particle& p, std::vector<int>& bins,
+    std::vector<double>& lengths, std::vector<int>& surface_bins) const;
+
   //! Count number of bank sites in each mesh bin / energy bin
   //
   //! \param[in] bank Array of bank sites
@@ -186,6 +233,28 @@ public:
   xt::xtensor<double, 1> count_sites(const Particle::Bank* bank, int64_t length,
     bool* outside) const;
 
+  //! Count weight of bank sites in each mesh bin on this process only
+  //
+  //! \param[in] bank Array of bank sites
+  //! \param[in] length Number of bank sites
+  //! \param[out] outside Whether any bank sites are outside the mesh
+  //! \return Weight of the sites in each mesh bin
+  std::vector<double> local_site_counts(const Particle::Bank* bank,
+    int64_t length, bool* outside) const;
+
+  //! Determine the mesh bin of each of a group of bank sites
+  //
+  //! This gives the same bins as get_bin() but handles many sites at once in a
+  //! loop that can be vectorized.
+  //! \param[in] bank Array of bank sites
+  //! \param[in] n Number of bank sites
+  //! \param[out] bins Mesh bin of each site or -1 if it is outside the mesh
+  void get_bins(const Particle::Bank* bank, int n, int* bins) const;
+
+  //! Set the aligned lattice to a rectangular lattice whose tiles are the
+  //! elements of the mesh, if there is one
+  void find_aligned_lattice();
+
   // Data members
 
   double volume_frac_; //!< Volume fraction of each mesh element
@@ -193,6 +262,17 @@ public:
   xt::xtensor<double, 1> width_; //!< Width of each mesh element
 
 private:
+  //! Walk the bins crossed by a track, also giving the surface bins crossed
+  //! when that follows from the bins
+  //
+  //! \return Whether surface_bins holds the surfaces crossed by the track
+  bool walk_track(const Particle& p, std::vector<int>& bins,
+    std::vector<double>& lengths, std::vector<int>* surface_bins) const;
+
+  //! Find the surface bins crossed by a segment from r0 to r1 in direction u
+  void surface_bins_between(Position r0, Position r1, Direction u,
+    std::vector<int>& bins) const;
+
   bool intersects_1d(Position& r0, Position r1, int* ijk) const;
   bool intersects_2d(Position& r0, Position r1, int* ijk) const;
   bool intersects_3d(Position& r0, Position r1, int* ijk) const;
@@ -221,6 +301,8 @@ public:
 
   void get_indices_from_bin(int bin, int* ijk) const override;
 
+  double edge(int dim, int i) const override;
+
   int n_bins() const override;
 
   int n_surface_bins() const override;
@@ -247,6 +329,107 @@ private:
   std::vector<std::vector<double>> grid_;
 };
 
+//==============================================================================
+//! A regular mesh whose elements can each be divided in two along every axis,
+//! recursively, between batches. The bins are the elements of all levels,
+//! the first ones being those of the regular root mesh, and their number is
+//! fixed when the mesh is read so tally results never need to be resized.
+//==============================================================================
+
+class AdaptiveMesh : public Mesh
+{
+public:
+  // Constructors
+  AdaptiveMesh(pugi::xml_node node);
+
+  // Overriden methods
+
+  void bins_crossed(const Particle& p, std::vector<int>& bins,
+                    std::vector<double>& lengths) const override;
+
+  //! Surface bins are not defined for adaptive meshes
+  void surface_bins_crossed(const Particle&, std::vector<int>&)
+  const override {}
+
+  int get_bin(Position r) const override;
+
+  int n_bins() const override { return max_bins_; }
+
+  int n_surface_bins() const override { return 0; }
+
+  //! Find the lines of the root mesh that intersect a slice plot
+  std::pair<std::vector<double>, std::vector<double>>
+  plot(Position plot_ll, Position plot_ur) const override;
+
+  std::string bin_label(int bin) const override;
+
+  void to_hdf5(hid_t group) const override;
+
+  // New methods
+
+  //! Number of elements of all levels, which are the bins in use
+  int n_elements() const { return elements_.size(); }
+
+  //! Whether an element is in use and not divided, so that it is scored
+  bool is_leaf(int bin) const
+  {
+    return bin < n_elements() && elements_[bin].children < 0;
+  }
+
+  //! Choose the elements to divide from a priority for each of them, the
+  //! highest first, as long as the bins of their children fit in max_bins_
+  //
+  //! \param[in] priority Priority of each element, only those above zero
+  //!   being divided
+  //! \return Bins of the elements to divide
+  std::vector<int> select_refinement(const std::vector<double>& priority) const;
+
+  //! Divide elements, appending the bins of their children
+  //
+  //! \param[in] bins Bins of leaf elements
+  void refine(const std::vector<int>& bins);
+
+  //! Read the elements of all levels written by to_hdf5
+  //
+  //! \param[in] group HDF5 group of the mesh
+  void read_elements(hid_t group);
+
+  // Data members
+
+  int max_bins_; //!< Number of bins available to elements of all levels
+  double refine_threshold_ {0.1}; //!< Minimum score relative to the maximum
+  double refine_rel_error_ {0.1}; //!< Maximum relative error of the score
+  int refine_batches_ {5}; //!< Realizations needed before refining
+
+private:
+  //! An element of a level of the mesh
+  struct Element {
+    int level; //!< Number of divisions from the root mesh
+    std::array<int, 3> index; //!< Indices among elements of the level from 0
+    int children {-1}; //!< Bin of the first child or -1 if not divided
+  };
+
+  //! Lower and upper corners of an element
+  std::pair<Position, Position> bounds(const Element& e) const;
+
+  //! Find the leaf element containing a position inside an element
+  int find_leaf(int bin, Position r) const;
+
+  //! Divide the part of a track lying in an element among its leaves
+  //
+  //! \param[in] bin Bin of the element
+  //! \param[in] r0 Start of the track
+  //! \param[in] u Direction of the track
+  //! \param[in] t0 Distance along the track where it enters the element
+  //! \param[in] t1 Distance along the track where it leaves the element
+  //! \param[in] scale Fraction of the track per unit distance
+  void walk_element(int bin, Position r0, Direction u, double t0, double t1,
+    double scale, std::vector<int>& bins, std::vector<double>& lengths) const;
+
+  RegularMesh root_; //!< Mesh of the elements of level 0
+  std::vector<Element> elements_; //!< Elements of all levels by bin
+};
+
 #ifdef DAGMC
 
 class UnstructuredMesh : public Mesh {
@@ -286,9 +469,9 @@ public:
 
   //! Retrieve a centroid for the mesh cell
   //
-  // \param[in] tet MOAB EntityHandle of the tetrahedron
-  // \return The centroid of the element
-  Position centroid(moab::EntityHandle tet) const;
+  // \param[in] elem MOAB EntityHandle of the element
+  // \return The centroid of the element vertices
+  Position centroid(moab::EntityHandle elem) const;
 
   //! Return a string represntation of the mesh bin
   //
@@ -306,53 +489,58 @@ public:
   //! Write the mesh with any current tally data
   void write(std::string base_filename) const;
 
+  //! Write the elements of the mesh and data on them to a binary legacy VTK
+  //! file. The data are streamed one set at a time from the copies of the
+  //! mesh kept in memory, so the MOAB instance isn't needed and only one set
+  //! is held at once. Like set_score_data, values are divided by the volume
+  //! of their element.
+  //
+  //! \param[in] base_filename Name of the file without extension
+  //! \param[in] names Name of each set of data
+  //! \param[in] get_data Function filling the values on all bins of the set
+  //!   of data with the given index
+  void write_vtk(const std::string& base_filename,
+    const std::vector<std::string>& names,
+    const std::function<void(int, std::vector<double>&)>& get_data) const;
+
   std::string filename_; //!< Path to unstructured mesh file
 
 private:
 
-  //! Find all intersections with faces of the mesh.
-  //
-  //! \param[in] start Staring location
-  //! \param[in] dir Normalized particle direction
-  //! \param[in] track_len length of particle track
-  //! \param[out] Mesh intersections
-  void
-  intersect_track(const moab::CartVect& start,
-                  const moab::CartVect& dir,
-                  double track_len,
-                  std::vector<double>& hits) const;
-
-  //! Calculate the volume for a given tetrahedron handle.
-  //
-  // \param[in] tet MOAB EntityHandle of the tetrahedron
-  double tet_volume(moab::EntityHandle tet) const;
-
-  //! Find the tetrahedron for the given location if
-  //! one exists
+  //! Calculate the volume of a mesh element
   //
-  //! \param[in]
-  //! \return MOAB EntityHandle of tet
-  moab::EntityHandle get_tet(const Position& r) const;
-
-  //! Return the containing tet given a position
-  moab::EntityHandle get_tet(const moab::CartVect& r) const {
-      return get_tet(Position(r[0], r[1], r[2]));
-  };
+  //! \param[in] bin Bin of the element
+  double volume(int bin) const;
 
   //! Check for point containment within a tet; uses
   //! pre-computed barycentric data.
   //
   //! \param[in] r Position to check
-  //! \param[in] MOAB terahedron to check
+  //! \param[in] tet Index of the tetrahedron in tet_connectivity_
   //! \return True if r is inside, False if r is outside
-  bool point_in_tet(const moab::CartVect& r,
-                    moab::EntityHandle tet) const;
+  bool point_in_tet(const moab::CartVect& r, int tet) const;
+
+  //! Find the tetrahedron containing a point
+  //
+  //! \param[in] r Position to locate
+  //! \return Index of the tetrahedron in tet_connectivity_ or -1
+  int find_tet(Position r) const;
 
-  //! Compute barycentric coordinate data for all tetrahedra
-  //! in the mesh.
+  //! Copy the vertex coordinates and connectivity of all elements of the
+  //! mesh into flat arrays, split the elements into tetrahedra and compute
+  //! their barycentric coordinate data.
   //
-  //! \param[in] tets MOAB Range of tetrahedral elements
-  void compute_barycentric_data(const moab::Range& tets);
+  //! \param[in] elems MOAB Range of tetrahedral, hexahedral, wedge and
+  //!   pyramid elements
+  void compute_barycentric_data(const moab::Range& elems);
+
+  //! Find the neighbor of each tetrahedron across each of its faces by
+  //! matching the vertices of their faces.
+  void compute_adjacency();
+
+  //! Build the trees used to locate points and to find where tracks enter
+  //! the mesh.
+  void build_trees();
 
   //! Translate a MOAB EntityHandle to its corresponding bin.
   //
@@ -361,10 +549,10 @@ private:
   int get_bin_from_ent_handle(moab::EntityHandle eh) const;
 
   //! Translate a bin to its corresponding MOAB EntityHandle
-  //! for the tetrahedron representing that bin.
+  //! for the element representing that bin.
   //
   //! \param[in] bin Bin value to translate
-  //! \return MOAB EntityHandle of tet
+  //! \return MOAB EntityHandle of the element
   moab::EntityHandle get_ent_handle_from_bin(int bin) const;
 
   //! Get the bin for a given mesh cell index
@@ -385,13 +573,6 @@ private:
   //! \return Index of the bin
   int get_index_from_bin(int bin) const;
 
-  //! Build a KDTree for all tetrahedra in the mesh. All
-  //! triangles representing 2D faces of the mesh are
-  //! added to the tree as well.
-  //
-  //! \param[in] all_tets MOAB Range of tetrahedra for the tree
-  void build_kdtree(const moab::Range& all_tets);
-
   //! Get the tags for a score from the mesh instance
   //! or create them if they are not there
   //
@@ -401,12 +582,31 @@ private:
   get_score_tags(std::string score) const;
 
   // data members
-  moab::Range ehs_; //!< Range of tetrahedra EntityHandle's in the mesh
-  moab::EntityHandle tetset_; //!< EntitySet containing all tetrahedra
-  moab::EntityHandle kdtree_root_; //!< Root of the MOAB KDTree
+  moab::Range ehs_; //!< Range of element EntityHandle's in the mesh
+  moab::EntityHandle tetset_; //!< EntitySet containing all elements
   std::unique_ptr<moab::Interface> mbi_; //!< MOAB instance
-  std::unique_ptr<moab::AdaptiveKDTree> kdtree_; //!< MOAB KDTree instance
+  //! Coordinates of the mesh vertices, followed by the centroids added to
+  //! split elements other than tetrahedra
+  std::vector<moab::CartVect> vertices_;
+  //! Start of the vertices of each element in elem_vertices_, with one more
+  //! entry giving the end of the last
+  std::vector<int> elem_offsets_;
+  //! Indices in vertices_ of the vertices of each element, in MOAB order
+  std::vector<int> elem_vertices_;
+  //! Indices in vertices_ of the vertices of each tetrahedron the elements
+  //! are split into. The first vertex is the reference point of the
+  //! barycentric data. Tetrahedral elements are kept as they are, so their
+  //! index is their bin.
+  std::vector<std::array<int, 4>> tet_connectivity_;
   std::vector<moab::Matrix3> baryc_data_; //!< Barycentric data for tetrahedra
+  std::vector<int> tet_elements_; //!< Bin of the element of each tetrahedron
+  //! Tetrahedron across the face opposite each vertex of each tetrahedron,
+  //! or -1 on the boundary of the mesh
+  std::vector<std::array<int, 4>> tet_neighbors_;
+  BoxBVH tet_tree_; //!< Tree of the tetrahedra for point location
+  //! Faces on the boundary of the mesh, identified by 4 * tetrahedron + face,
+  //! for finding where tracks enter the mesh
+  std::unique_ptr<TriangleBVH> boundary_;
 };
 
 #endif
@@ -427,6 +627,11 @@ void meshes_to_hdf5(hid_t group);
 
 RegularMesh* get_regular_mesh(int32_t index);
 
+//! Divide the elements of adaptive meshes where the tallies over them score
+//! high with a low enough relative error, restarting those tallies. This is
+//! called between active batches on all processes.
+void refine_adaptive_meshes();
+
 void free_memory_mesh();
 
 } // namespace openmc
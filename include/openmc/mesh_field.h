@@ -0,0 +1,94 @@
+//! \file mesh_field.h
+//! Temperatures and densities given on the bins of a mesh overlaying cells
+
+#ifndef OPENMC_MESH_FIELD_H
+#define OPENMC_MESH_FIELD_H
+
+#include <cstdint> // for int32_t
+#include <vector>
+
+#include "pugixml.hpp"
+
+#include "openmc/particle.h"
+
+namespace openmc {
+
+//==============================================================================
+//! Temperature and density multiplier of each bin of a mesh overlaying the
+//! material cells of the geometry
+//
+//! A field lets a multiphysics code give temperatures and densities on its own
+//! mesh without the geometry needing a cell per mesh element. Where a particle
+//! in one of the cells of the field is inside the mesh, the temperature and
+//! density multiplier of its bin replace those of the cell when cross sections
+//! are evaluated, i.e. after each collision and surface crossing and, with
+//! delta tracking, at each tentative collision. Flights between those events
+//! use the values at their start, so fields varying within cells are only
+//! followed exactly by delta tracking.
+//==============================================================================
+
+class MeshField {
+public:
+  //! Read a mesh field
+  //
+  //! \param node <mesh_field> element of settings.xml
+  explicit MeshField(pugi::xml_node node);
+
+  //! Apply the field to a particle whose cross sections are about to be
+  //! evaluated
+  //
+  //! \param p Particle in a material cell
+  //! \return Whether the cell of the particle is in the field
+  bool apply(Particle& p) const;
+
+  //! Set the temperature and density multiplier of each bin
+  //
+  //! \param T Temperature in [K] of each bin, or nullptr to keep them. Bins
+  //!   with a non-positive temperature keep that of their cell.
+  //! \param density_mult Density multiplier of each bin, or nullptr to keep
+  //!   them
+  void set_data(const double* T, const double* density_mult);
+
+  //! Number of bins of the mesh of the field
+  int n_bins() const { return sqrtkT_.size(); }
+
+  int32_t id_; //!< unique ID
+
+private:
+  int32_t mesh_; //!< index in model::meshes of the mesh
+  std::vector<int32_t> cells_; //!< sorted IDs of the cells, all if empty
+  //! sqrt(k_Boltzmann * temperature) in [eV] of each bin, or negative to keep
+  //! the temperature of the cell
+  std::vector<double> sqrtkT_;
+  std::vector<double> density_mult_; //!< density multiplier of each bin
+};
+
+//==============================================================================
+// Global variables
+//==============================================================================
+
+namespace model {
+  extern std::vector<MeshField> mesh_fields;
+} // namespace model
+
+//==============================================================================
+// Non-member functions
+//==============================================================================
+
+//! Read the mesh fields of settings.xml. Meshes must have been read.
+//
+//! \param root Root element of settings.xml
+void read_mesh_fields(pugi::xml_node root);
+
+//! Set the temperature and density multiplier of a particle from the first
+//! mesh field containing its cell, or reset its density multiplier if there
+//! is none
+//
+//! \param p Particle in a material cell
+void apply_mesh_fields(Particle& p);
+
+void free_memory_mesh_fields();
+
+} // namespace openmc
+
+#endif // OPENMC_MESH_FIELD_H
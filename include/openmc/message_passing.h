@@ -1,6 +1,8 @@
 #ifndef OPENMC_MESSAGE_PASSING_H
 #define OPENMC_MESSAGE_PASSING_H
 
+#include <cstdint> // for int64_t
+
 #ifdef OPENMC_MPI
 #include <mpi.h>
 #endif
@@ -15,6 +17,15 @@ namespace mpi {
 #ifdef OPENMC_MPI
   extern MPI_Datatype bank;
   extern MPI_Comm intracomm;
+  extern MPI_Comm node_comm; //!< Ranks that can share memory with this one
+
+//! Broadcast a buffer of bytes from the master process to the others
+//
+//! The buffer is sent in chunks whose size fits in an int, so that buffers
+//! larger than 2 GB can be broadcast.
+//! \param data Buffer of at least size bytes on every process
+//! \param size Number of bytes to broadcast
+void broadcast_bytes(char* data, int64_t size);
 #endif
 
 } // namespace mpi
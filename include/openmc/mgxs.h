@@ -17,20 +17,6 @@
 
 namespace openmc {
 
-//==============================================================================
-// Cache contains the cached data for an MGXS object
-//==============================================================================
-
-struct CacheData {
-  double sqrtkT; // last temperature corresponding to t
-  int t; // temperature index
-  int a; // angle index
-  // last angle that corresponds to a
-  double u;
-  double v;
-  double w;
-};
-
 //==============================================================================
 // MGXS contains the mgxs data for a nuclide/material
 //==============================================================================
@@ -98,12 +84,17 @@ class Mgxs {
     //! @return True if they can be combined, False otherwise.
     bool equiv(const Mgxs& that);
 
+    //! \brief Makes a cache refer to this object, discarding the indices it
+    //!   held for another one.
+    //!
+    //! @param cache Temperature and angle indices.
+    void claim(MgxsCache& cache) const;
+
   public:
 
     std::string name;   // name of dataset, e.g., UO2
     double awr;         // atomic weight ratio
     bool fissionable;   // Is this fissionable
-    std::vector<CacheData> cache; // index and data cache
 
     Mgxs() = default;
 
@@ -131,6 +122,7 @@ class Mgxs {
 
     //! \brief Provides a cross section value given certain parameters
     //!
+    //! @param cache Temperature and angle indices set for this object.
     //! @param xstype Type of cross section requested, according to the
     //!   enumerated constants.
     //! @param gin Incoming energy group.
@@ -141,50 +133,66 @@ class Mgxs {
     //! @param dg delayed group index; use nullptr if irrelevant.
     //! @return Requested cross section value.
     double
-    get_xs(MgxsType xstype, int gin, const int* gout, const double* mu,
-      const int* dg);
+    get_xs(const MgxsCache& cache, MgxsType xstype, int gin, const int* gout,
+      const double* mu, const int* dg) const;
 
     inline double
-    get_xs(MgxsType xstype, int gin)
-    {return get_xs(xstype, gin, nullptr, nullptr, nullptr);}
+    get_xs(const MgxsCache& cache, MgxsType xstype, int gin) const
+    {return get_xs(cache, xstype, gin, nullptr, nullptr, nullptr);}
 
 
     //! \brief Samples the fission neutron energy and if prompt or delayed.
     //!
+    //! @param cache Temperature and angle indices set for this object.
     //! @param gin Incoming energy group.
     //! @param dg Sampled delayed group index.
     //! @param gout Sampled outgoing energy group.
     //! @param seed Pseudorandom seed pointer
     void
-    sample_fission_energy(int gin, int& dg, int& gout, uint64_t* seed);
+    sample_fission_energy(const MgxsCache& cache, int gin, int& dg, int& gout,
+      uint64_t* seed) const;
 
     //! \brief Samples the outgoing energy and angle from a scatter event.
     //!
+    //! @param cache Temperature and angle indices set for this object.
     //! @param gin Incoming energy group.
     //! @param gout Sampled outgoing energy group.
     //! @param mu Sampled cosine of the change-in-angle.
     //! @param wgt Weight of the particle to be adjusted.
     //! @param seed Pseudorandom seed pointer.
     void
-    sample_scatter(int gin, int& gout, double& mu, double& wgt, uint64_t* seed);
+    sample_scatter(const MgxsCache& cache, int gin, int& gout, double& mu,
+      double& wgt, uint64_t* seed) const;
 
     //! \brief Calculates cross section quantities needed for tracking.
     //!
+    //! The temperature and angle indices are kept in the particle's cache.
     //! @param p The particle whose attributes set which MGXS to get.
     void
-    calculate_xs(Particle& p);
+    calculate_xs(Particle& p) const;
 
     //! \brief Sets the temperature index in cache given a temperature
     //!
+    //! @param cache Temperature and angle indices to update.
     //! @param sqrtkT Temperature of the material.
     void
-    set_temperature_index(double sqrtkT);
+    set_temperature_index(MgxsCache& cache, double sqrtkT) const;
 
     //! \brief Sets the angle index in cache given a direction
     //!
+    //! @param cache Temperature and angle indices to update.
     //! @param u Incoming particle direction.
     void
-    set_angle_index(Direction u);
+    set_angle_index(MgxsCache& cache, Direction u) const;
+
+    //! \brief Shares the scattering data with identical data in a pool.
+    //!
+    //! @param pool Distinct scattering data seen so far.
+    void
+    share_scatter(ScattDataPool& pool);
+
+    //! \brief Checks whether the data are independent of the incoming angle
+    bool isotropic() const { return is_isotropic; }
 
     //! \brief Provide const access to list of XsData held by this
     const std::vector<XsData>& get_xsdata() const { return xs; }
@@ -2,66 +2,155 @@
 #define OPENMC_NEIGHBOR_LIST_H
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef> // for size_t
 #include <cstdint>
-#include <forward_list>
-#include <mutex>
-
-#include "openmc/openmp_interface.h"
+#include <utility> // for pair
 
 namespace openmc {
 
 //==============================================================================
 //! A threadsafe, dynamic container for listing neighboring cells.
 //
-//! This container is a reduced interface for a linked list with an added OpenMP
-//! lock for write operations.  It allows for threadsafe dynamic growth; any
-//! number of threads can safely read data without locks or reference counting.
+//! This container is a fixed-capacity, append-only array.  Elements are added
+//! without locks by claiming the first empty slot with a compare-and-swap, so
+//! the occupied slots always form a contiguous prefix of the array.  The size
+//! is only incremented after an element has been written, which allows any
+//! number of threads to safely read data without locks or reference counting.
+//! Storage is allocated on the first insertion so that cells which are never
+//! entered do not use any memory.
+//!
+//! During inactive batches, the number of times each neighbor is found is
+//! counted.  Once the lists are frozen at the start of the active batches, the
+//! neighbors are sorted so that the most likely neighbor is checked first.
 //==============================================================================
 
 class NeighborList
 {
 public:
   using value_type = int32_t;
-  using const_iterator = std::forward_list<value_type>::const_iterator;
+  using const_iterator = const std::atomic<value_type>*;
+
+  // Maximum number of neighbors.  Further neighbors are not stored and are
+  // found by searching the whole universe instead.
+  static constexpr int CAPACITY {64};
+
+  NeighborList() = default;
+  NeighborList(const NeighborList&) = delete;
+  NeighborList& operator=(const NeighborList&) = delete;
+  ~NeighborList() { delete storage_.load(); }
 
   // Attempt to add an element.
   //
-  // If the relevant OpenMP lock is currently owned by another thread, this
-  // function will return without actually modifying the data.  It has been
-  // found that returning the transport calculation and possibly re-adding the
-  // element later is slightly faster than waiting on the lock to be released.
+  // If the list is full, this function will return without actually modifying
+  // the data.
   void push_back(int new_elem)
   {
-    // Try to acquire the lock.
-    std::unique_lock<OpenMPMutex> lock(mutex_, std::try_to_lock);
-    if (lock) {
+    Storage* s = storage();
+    for (auto& slot : s->elems) {
       // It is possible another thread already added this element to the list
       // while this thread was searching for a cell so make sure the given
       // element isn't a duplicate before adding it.
-      if (std::find(list_.cbegin(), list_.cend(), new_elem) == list_.cend()) {
-        // Find the end of the list and add the the new element there.
-        if (!list_.empty()) {
-          auto it1 = list_.cbegin();
-          auto it2 = ++list_.cbegin();
-          while (it2 != list_.cend()) it1 = it2++;
-          list_.insert_after(it1, new_elem);
-        } else {
-          list_.push_front(new_elem);
+      value_type current = slot.load(std::memory_order_acquire);
+      if (current == EMPTY) {
+        if (slot.compare_exchange_strong(current, new_elem,
+            std::memory_order_acq_rel, std::memory_order_acquire)) {
+          size_.fetch_add(1, std::memory_order_release);
+          return;
         }
+        // Another thread claimed this slot first; current now holds the
+        // element it wrote.
       }
+      if (current == new_elem) return;
+    }
+  }
+
+  // Record that the neighbor at the given position was the one found.
+  void hit(const_iterator it) const
+  {
+    if (frozen_.load(std::memory_order_relaxed)) return;
+    Storage* s = storage_.load(std::memory_order_acquire);
+    s->hits[it - s->elems.data()].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Stop counting hits and order the neighbors from most to least frequently
+  // found.  This must not be called while other threads use the list.
+  void freeze()
+  {
+    frozen_.store(true, std::memory_order_relaxed);
+    Storage* s = storage_.load(std::memory_order_acquire);
+    if (!s) return;
+
+    int n = size_.load(std::memory_order_acquire);
+    std::array<std::pair<int64_t, value_type>, CAPACITY> order;
+    for (int i = 0; i < n; ++i) {
+      order[i] = {s->hits[i].load(std::memory_order_relaxed),
+        s->elems[i].load(std::memory_order_relaxed)};
+    }
+    std::stable_sort(order.begin(), order.begin() + n,
+      [](const std::pair<int64_t, value_type>& a,
+         const std::pair<int64_t, value_type>& b) {
+        return a.first > b.first;
+      });
+    for (int i = 0; i < n; ++i) {
+      s->hits[i].store(order[i].first, std::memory_order_relaxed);
+      s->elems[i].store(order[i].second, std::memory_order_release);
     }
   }
 
   const_iterator cbegin() const
-  {return list_.cbegin();}
+  {
+    Storage* s = storage_.load(std::memory_order_acquire);
+    return s ? s->elems.data() : nullptr;
+  }
 
   const_iterator cend() const
-  {return list_.cend();}
+  {
+    // Load the size before the storage so that all counted elements are
+    // guaranteed to be visible
+    int n = size_.load(std::memory_order_acquire);
+    return cbegin() + n;
+  }
 
+  // Memory held by the list in bytes, which is none until the first insertion
+  std::size_t memory() const
+  {
+    return storage_.load(std::memory_order_acquire) ? sizeof(Storage) : 0;
+  }
 
 private:
-  std::forward_list<value_type> list_;
-  OpenMPMutex mutex_;
+  static constexpr value_type EMPTY {-1};
+
+  struct Storage {
+    Storage()
+    {
+      for (auto& e : elems) e.store(EMPTY, std::memory_order_relaxed);
+      for (auto& h : hits) h.store(0, std::memory_order_relaxed);
+    }
+
+    std::array<std::atomic<value_type>, CAPACITY> elems;
+    std::array<std::atomic<int64_t>, CAPACITY> hits;
+  };
+
+  // Get the storage, allocating it if this is the first insertion
+  Storage* storage()
+  {
+    Storage* s = storage_.load(std::memory_order_acquire);
+    if (s) return s;
+    Storage* fresh = new Storage;
+    if (storage_.compare_exchange_strong(s, fresh, std::memory_order_acq_rel,
+        std::memory_order_acquire)) {
+      return fresh;
+    }
+    // Another thread allocated the storage first
+    delete fresh;
+    return s;
+  }
+
+  std::atomic<Storage*> storage_ {nullptr};
+  std::atomic<int> size_ {0};
+  std::atomic<bool> frozen_ {false};
 };
 
 } // namespace openmc
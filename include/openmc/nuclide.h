@@ -9,6 +9,7 @@
 #include <unordered_map>
 #include <vector>
 
+#include <gsl/gsl>
 #include <hdf5.h>
 
 #include "openmc/constants.h"
@@ -21,6 +22,8 @@
 
 namespace openmc {
 
+struct NuclideTemperature;
+
 //==============================================================================
 // Data for a nuclide
 //==============================================================================
@@ -31,7 +34,55 @@ public:
   using EmissionMode = ReactionProduct::EmissionMode;
   struct EnergyGrid {
     std::vector<int> grid_index;
-    std::vector<double> energy;
+    std::vector<xs_real> energy;
+
+    // For hashed energy searches, each equal-logarithmic bin is divided into
+    // a power-of-two number of equal-width sub-bins. The entries for bin k are
+    // those from hash_start[k] through hash_start[k+1] - 1, one per sub-bin,
+    // of hash_low and hash_high.
+    std::vector<int> hash_start; //!< Position of each bin's sub-bins
+    std::vector<int> hash_low; //!< Lowest grid index of each sub-bin
+    std::vector<int> hash_high; //!< Highest grid index of each sub-bin
+  };
+
+  //! Cross sections at one temperature stored as one record per energy point.
+  //! Each record holds all cross section channels followed by the energy and
+  //! occupies exactly one 64-byte aligned cache line (half of one when cross
+  //! sections are stored in single precision), so that interpolating between
+  //! two adjacent points touches at most two cache lines.
+  class PackedXS {
+  public:
+    static constexpr int WIDTH {8};  //!< Number of values in a record
+    static constexpr int ENERGY {5}; //!< Position of the energy in a record
+
+    //! Pack cross sections on an energy grid
+    //
+    //! \param xs Cross sections with one row per energy point
+    //! \param energy Energy at each point in [eV]
+    PackedXS(const xt::xtensor<xs_real, 2>& xs, const std::vector<xs_real>& energy);
+
+    // A copy would not necessarily be aligned, so only moves are allowed
+    PackedXS(const PackedXS&) = delete;
+    PackedXS(PackedXS&&) = default;
+    PackedXS& operator=(const PackedXS&) = delete;
+    PackedXS& operator=(PackedXS&&) = default;
+
+    //! Get the record for an energy point
+    const xs_real* operator[](int i) const { return records_ + WIDTH*i; }
+
+    //! Number of values in all records
+    std::size_t size() const { return WIDTH*n_; }
+
+    //! Use records held in memory owned elsewhere, releasing the own copy
+    //
+    //! \param records Memory for size() values with the same alignment
+    //! \param copy Whether to copy the records into the memory first
+    void relocate(xs_real* records, bool copy);
+
+  private:
+    std::vector<xs_real> data_; //!< Records, with room for alignment
+    const xs_real* records_;    //!< First aligned record
+    int n_;                     //!< Number of records
   };
 
   // Constructors
@@ -40,9 +91,84 @@ public:
   //! Initialize logarithmic grid for energy searches
   void init_grid();
 
-  void calculate_xs(int i_sab, int i_log_union, double sab_frac, Particle& p);
-
-  void calculate_sab_xs(int i_sab, double sab_frac, Particle& p);
+  //! Determine the energy grid index at a temperature
+  //
+  //! \param i_temp Temperature index
+  //! \param i_log_union Index on the equal-logarithmic energy grid
+  //! \param E Energy in [eV]
+  //! \return Index of the grid point at or below the energy
+  int find_grid_index(int i_temp, int i_log_union, double E) const;
+
+  //! Prefetch the data that a cross section lookup will need into the cache.
+  //! The index search is issued first with rows = false, which touches no
+  //! memory. Once the search data has had time to arrive, the call with rows
+  //! = true reads it to bracket the energy and prefetches that part of the
+  //! energy grid and the cross sections there.
+  //
+  //! \param i_temp Temperature index
+  //! \param i_log_union Index on the equal-logarithmic energy grid
+  //! \param E Energy in [eV]
+  //! \param rows Whether to prefetch the energy grid and cross sections
+  //!   rather than the search data
+  void prefetch_xs(int i_temp, int i_log_union, double E, bool rows) const;
+
+  //! Calculate microscopic cross sections at the particle's energy
+  //
+  //! \param i_sab Index in data::thermal_scatt, or C_NONE
+  //! \param i_log_union Index on the equal-logarithmic energy grid
+  //! \param sab_frac Fraction of the nuclide to which S(a,b) data applies
+  //! \param p Particle whose cross section cache is updated
+  //! \param union_index If not null, the grid index at each temperature as
+  //!   determined from a material's unionized energy grid
+  //! \param temperature If not null, the precomputed temperature index at the
+  //!   particle's temperature
+  //! \param sab_temperature If not null, the precomputed temperature index of
+  //!   the S(a,b) table at the particle's temperature
+  void calculate_xs(int i_sab, int i_log_union, double sab_frac, Particle& p,
+    const int* union_index = nullptr,
+    const NuclideTemperature* temperature = nullptr,
+    const NuclideTemperature* sab_temperature = nullptr)
+  {
+    (this->*calculate_xs_kernel_)(i_sab, i_log_union, sab_frac, p,
+      union_index, temperature, sab_temperature);
+  }
+
+  //! Select the version of calculate_xs() specialized for the data of the
+  //! nuclide and the current settings. This must be called again whenever
+  //! multipole data, packed cross sections, probability tables or the
+  //! temperature method change.
+  void init_calculate_xs();
+
+  //! Determine the temperature index used for cross sections
+  //
+  //! \param sqrtkT Square root of temperature times Boltzmann constant in
+  //!   [sqrt(eV)]
+  //! \return Index of the nearest temperature or, for interpolation, the next
+  //!   lower temperature along with the interpolation factor
+  NuclideTemperature temperature_index(double sqrtkT) const;
+
+  //! Average the cross section of a reaction over energy groups, as used to
+  //! collapse reaction rates against a multigroup flux spectrum
+  //
+  //! \param MT ENDF MT value of the reaction
+  //! \param temperature Temperature in [K]
+  //! \param energy Group boundaries in [eV] in increasing order
+  //! \return Average cross section in each group in [b], which is zero for
+  //!   reactions the nuclide does not have
+  std::vector<double> group_xs(int MT, double temperature,
+    gsl::span<const double> energy) const;
+
+  //! Evaluate the depletion reaction cross sections at the energy and
+  //! temperature that the other cross sections were last evaluated at
+  //
+  //! Reaction cross sections are only needed by tallies of depletion
+  //! reactions, so they are evaluated when first scored rather than with the
+  //! other cross sections.
+  //! \param micro Cached cross sections of this nuclide
+  void calculate_reaction_xs(NuclideMicroXS& micro) const;
+
+  void calculate_sab_xs(int i_sab, double sab_frac, Particle& p,
+    const NuclideTemperature* temperature = nullptr);
 
   // Methods
   double nu(double E, EmissionMode mode, int group=0) const;
@@ -52,10 +178,40 @@ public:
   //! energy used in resonance scattering
   double elastic_xs_0K(double E) const;
 
+  //! Find the index on the 0K energy grid of an energy, which is clamped to
+  //! the first or last interval outside of the grid
+  //
+  //! \param E Energy in [eV]
+  //! \return Index of the lower bound of the interval containing E
+  int index_0K(double E) const;
+
+  //! Get the maximum 0K elastic cross section over a range of the 0K energy
+  //! grid
+  //
+  //! \param i_first Index of the first point of the range
+  //! \param i_last Index past the last point of the range
+  //! \return Maximum 0K elastic cross section in [b]
+  double elastic_0K_max(int i_first, int i_last) const;
+
   //! \brief Determines cross sections in the unresolved resonance range
   //! from probability tables.
   void calculate_urr_xs(int i_temp, Particle& p) const;
 
+  //! Sample the probability tables in the unresolved resonance range
+  //
+  //! \param urr Probability tables at the temperature of the particle
+  //! \param p Particle whose energy and URR random number stream are used
+  //! \return Elastic, fission and capture cross sections or factors
+  NuclideMicroXS::UrrFactors sample_urr_factors(const UrrData& urr,
+    Particle& p) const;
+
+  //! Get the total cross section at a point of the energy grid
+  //
+  //! \param i_temp Temperature index
+  //! \param i_grid Index on the energy grid at the temperature
+  //! \return Microscopic total cross section in [b]
+  double total_xs(int i_temp, int i_grid) const;
+
   // Data members
   std::string name_; //!< Name of nuclide, e.g. "U235"
   int Z_; //!< Atomic number
@@ -67,7 +223,8 @@ public:
   // Temperature dependent cross section data
   std::vector<double> kTs_; //!< temperatures in eV (k*T)
   std::vector<EnergyGrid> grid_; //!< Energy grid at each temperature
-  std::vector<xt::xtensor<double, 2>> xs_; //!< Cross sections at each temperature
+  std::vector<xt::xtensor<xs_real, 2>> xs_; //!< Cross sections at each temperature
+  std::vector<PackedXS> xs_packed_; //!< Interleaved cross sections at each temperature
 
   // Multipole data
   std::unique_ptr<WindowedMultipole> multipole_;
@@ -80,12 +237,24 @@ public:
   std::unique_ptr<Function1D> total_nu_; //!< Total neutron yield
   std::unique_ptr<Function1D> fission_q_prompt_; //!< Prompt fission energy release
   std::unique_ptr<Function1D> fission_q_recov_; //!< Recoverable fission energy release
+  InlineFunction1D total_nu_fn_; //!< Total neutron yield without virtual calls
+  InlineFunction1D fission_q_prompt_fn_; //!< Prompt fission energy release
+                                         //!< without virtual calls
+  InlineFunction1D fission_q_recov_fn_; //!< Recoverable fission energy
+                                        //!< release without virtual calls
+  bool delayed_shared_grid_ {false}; //!< Are the delayed neutron yields
+                                     //!< tabulated on the same grid?
 
   // Resonance scattering information
   bool resonant_ {false};
   std::vector<double> energy_0K_;
   std::vector<double> elastic_0K_;
   std::vector<double> xs_cdf_;
+  std::vector<int> grid_index_0K_; //!< 0K grid index at log-spaced energies
+  double log_spacing_0K_; //!< Spacing of the log-spaced energies
+  std::vector<double> elastic_0K_block_max_; //!< Maximum 0K elastic xs in
+                                             //!< each block of the 0K grid
+  static constexpr int BLOCK_0K {64}; //!< Points in a block of the 0K grid
 
   // Unresolved resonance range information
   bool urr_present_ {false};
@@ -97,7 +266,68 @@ public:
   std::vector<int> index_inelastic_scatter_;
 
 private:
-  void create_derived(const Function1D* prompt_photons, const Function1D* delayed_photons);
+  //! Determine the range of the energy grid that contains an energy
+  //
+  //! \param grid Energy grid at a temperature
+  //! \param i_log_union Index on the equal-logarithmic energy grid
+  //! \param E Energy in [eV]
+  //! \param[out] i_low Lowest grid index of the range
+  //! \param[out] i_high One past the highest grid index of the range
+  void grid_bracket(const EnergyGrid& grid, int i_log_union, double E,
+    int& i_low, int& i_high) const;
+
+  //! Calculate microscopic cross sections at the particle's energy, as
+  //! calculate_xs(). Each template parameter being false removes a branch that
+  //! would otherwise be tested at every lookup.
+  //
+  //! \tparam MP Whether multipole data may be present
+  //! \tparam URR Whether probability tables may be used
+  //! \tparam INTERP Whether temperatures may be interpolated
+  //! \tparam PACKED Whether the cross sections may be packed
+  template<bool MP, bool URR, bool INTERP, bool PACKED>
+  void calculate_xs_kernel(int i_sab, int i_log_union, double sab_frac,
+    Particle& p, const int* union_index, const NuclideTemperature* temperature,
+    const NuclideTemperature* sab_temperature);
+
+  //! Version of calculate_xs_kernel() in use, which tests every branch until
+  //! init_calculate_xs() is called
+  void (Nuclide::*calculate_xs_kernel_)(int, int, double, Particle&,
+    const int*, const NuclideTemperature*, const NuclideTemperature*) {
+    &Nuclide::calculate_xs_kernel<true, true, true, true>};
+
+  //! Remove the points of each energy grid at which linear interpolation
+  //! between the neighbouring points reproduces every reaction cross section
+  //
+  //! \param tolerance Largest fractional difference allowed between a removed
+  //!   cross section and its interpolated value
+  void thin_energy_grids(double tolerance);
+
+  //! Compute derived cross sections, e.g., total and nu-fission
+  //
+  //! \param prompt_photons Prompt fission photon energy release, or null
+  //! \param delayed_photons Delayed fission photon energy release, or null
+  //! \param cache_file File in which derived cross sections are cached. If
+  //!   empty, no cache is used.
+  void create_derived(const Function1D* prompt_photons,
+    const Function1D* delayed_photons, const std::string& cache_file);
+
+  //! Determine the name of the file caching the derived cross sections
+  //
+  //! \param group HDF5 group the nuclide was read from
+  //! \return Path of the cache file. It changes whenever the data file, the
+  //!   temperatures read, or settings affecting derived cross sections do.
+  std::string xs_cache_file(hid_t group) const;
+
+  //! Read derived cross sections from a cache file
+  //
+  //! \param filename Path of the cache file
+  //! \return Whether the cross sections were read
+  bool read_xs_cache(const std::string& filename);
+
+  //! Write derived cross sections to a cache file
+  //
+  //! \param filename Path of the cache file
+  void write_xs_cache(const std::string& filename) const;
 
   static int XS_TOTAL;
   static int XS_ABSORPTION;
@@ -113,6 +343,10 @@ private:
 //! Checks for the right version of nuclear data within HDF5 files
 void check_data_version(hid_t file_id);
 
+//! Move interleaved nuclide cross sections into memory shared by all ranks on
+//! a node, so that only one copy is kept per node
+void share_nuclide_xs();
+
 bool multipole_in_range(const Nuclide& nuc, double E);
 
 //==============================================================================
@@ -132,6 +366,9 @@ extern double temperature_min;
 //! Maximum temperature in [K] that nuclide data is available at
 extern double temperature_max;
 
+//! Energy in [eV] at each boundary of the equal-logarithmic energy grid
+extern std::vector<double> log_grid_energy;
+
 extern std::vector<std::unique_ptr<Nuclide>> nuclides;
 extern std::unordered_map<std::string, int> nuclide_map;
 
@@ -52,6 +52,15 @@ void print_runtime();
 //! Display results for global tallies including k-effective estimators
 void print_results();
 
+//! Display the measured cost of scoring each tally. This must be called on all
+//! processes.
+void print_tally_profiles();
+
+//! Display the memory used by nuclear data, tallies, banks, particle buffers,
+//! neighbor lists and geometry, and the peak resident memory of the processes.
+//! This must be called on all processes.
+void print_memory_usage();
+
 void write_tallies();
 
 } // namespace openmc
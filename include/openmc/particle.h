@@ -9,6 +9,7 @@
 #include <memory> // for unique_ptr
 #include <sstream>
 #include <string>
+#include <utility> // for pair
 #include <vector>
 
 #include "openmc/constants.h"
@@ -40,6 +41,8 @@ constexpr double CACHE_INVALID {-1.0};
 // Class declarations
 //==============================================================================
 
+class Mgxs;
+
 class LocalCoord {
 public:
   void rotate(const std::vector<double>& rotation);
@@ -77,8 +80,10 @@ struct NuclideMicroXS {
   double photon_prod;      //!< microscopic photon production xs
 
   // Cross sections for depletion reactions (note that these are not stored in
-  // macroscopic cache)
+  // macroscopic cache). They are only evaluated when a tally scores them,
+  // see Nuclide::calculate_reaction_xs.
   double reaction[DEPLETION_RX.size()];
+  bool reaction_valid {false}; //!< Is reaction[] evaluated at last_E?
 
   // Indicies and factors needed to compute cross sections from the data tables
   int index_grid;        //!< Index on nuclide energy grid
@@ -89,6 +94,27 @@ struct NuclideMicroXS {
   double sab_frac;       //!< Fraction of atoms affected by S(a,b)
   bool use_ptable;       //!< In URR range with probability tables?
 
+  // Derivatives of multipole cross sections with respect to temperature in
+  // [b/K], evaluated together with the cross sections for differential tallies
+  bool multipole_deriv {false}; //!< Are the derivatives below set?
+  double dsig_s;         //!< Derivative of elastic scattering
+  double dsig_a;         //!< Derivative of absorption
+  double dsig_f;         //!< Derivative of fission
+
+  // Factors sampled from the probability tables in the unresolved resonance
+  // range. They only change with the energy or when the URR random number
+  // stream is advanced at a collision, so they are kept for the last two
+  // temperatures that the nuclide was evaluated at.
+  struct UrrFactors {
+    int index_temp {-1}; //!< Temperature index, or -1 if unused
+    double elastic;      //!< Elastic cross section or factor
+    double fission;      //!< Fission cross section or factor
+    double capture;      //!< Capture cross section or factor
+  };
+  UrrFactors urr_factors[2];
+  uint64_t urr_seed {0}; //!< URR stream seed that the factors were sampled with
+  double urr_E {0.0};    //!< Energy that the factors were evaluated at
+
   // Energy and temperature last used to evaluate these cross sections.  If
   // these values have changed, then the cross sections must be re-evaluated.
   double last_E {0.0};      //!< Last evaluated energy
@@ -96,6 +122,66 @@ struct NuclideMicroXS {
                             //!< * temperature (eV))
 };
 
+//==============================================================================
+//! Cache of microscopic neutron cross sections indexed by nuclide
+//
+//! By default, the cache holds one entry for every nuclide in the problem. In
+//! compact mode (settings::compact_xs_cache), it only holds entries for the
+//! nuclides of the material that cross sections were last calculated in,
+//! which bounds its size by the largest material rather than the total number
+//! of nuclides. Entries are still accessed by index in data::nuclides; lookups
+//! of a nuclide that is not in the current material give an all-zero entry.
+//==============================================================================
+
+class NuclideMicroXSCache {
+public:
+  using iterator = std::vector<NuclideMicroXS>::iterator;
+
+  //! Allocate space for the cache
+  //
+  //! \param n Number of entries, i.e., the number of nuclides in the problem
+  //!   or, in compact mode, the maximum number of nuclides in a material
+  //! \param compact Whether the cache is indexed through the current material
+  void resize(int n, bool compact);
+
+  //! Select the material whose nuclides are stored in a compact cache
+  //
+  //! If the material differs from the current one, all entries are
+  //! invalidated. This has no effect if the cache is not compact.
+  //
+  //! \param mat_nuclide_index Map from index in data::nuclides to index in
+  //!   the material, with C_NONE for nuclides not in the material
+  void set_material(const std::vector<int>& mat_nuclide_index);
+
+  //! Get the entry for a nuclide
+  //
+  //! \param i_nuclide Index in data::nuclides
+  NuclideMicroXS& operator[](int i_nuclide)
+  {
+    return xs_[compact_ ? slot(i_nuclide) : i_nuclide];
+  }
+  const NuclideMicroXS& operator[](int i_nuclide) const
+  {
+    return xs_[compact_ ? slot(i_nuclide) : i_nuclide];
+  }
+
+  iterator begin() { return xs_.begin(); }
+  iterator end() { return xs_.end(); }
+
+private:
+  //! Position in xs_ of the entry for a nuclide in compact mode. Nuclides not
+  //! in the current material map to the last entry, which is kept zeroed.
+  int slot(int i_nuclide) const
+  {
+    int j = index_ ? (*index_)[i_nuclide] : C_NONE;
+    return (j == C_NONE) ? xs_.size() - 1 : j;
+  }
+
+  std::vector<NuclideMicroXS> xs_; //!< Cached cross sections
+  bool compact_ {false}; //!< Indexed through the current material?
+  const std::vector<int>* index_ {nullptr}; //!< Current material's index map
+};
+
 //==============================================================================
 //! Cached microscopic photon cross sections for a particular element at the
 //! current energy
@@ -131,6 +217,19 @@ struct MacroXS {
   double pair_production; //!< macroscopic pair production xs
 };
 
+//==============================================================================
+// MGXSCACHE contains the temperature and angle indices last found in a
+// multigroup cross section set for a particle
+//==============================================================================
+
+struct MgxsCache {
+  const Mgxs* xs {nullptr};      //!< cross section set the indices refer to
+  double sqrtkT {CACHE_INVALID}; //!< temperature corresponding to t
+  int t {0};                     //!< temperature index
+  int a {0};                     //!< angle index
+  Direction u {0., 0., 0.};      //!< direction corresponding to a
+};
+
 //==============================================================================
 // Information about nearest boundary crossing
 //==============================================================================
@@ -142,6 +241,62 @@ struct BoundaryInfo {
   std::array<int, 3> lattice_translation {}; //!< which way lattice indices will change
 };
 
+//==============================================================================
+//! Senses of surfaces evaluated at the particle's current position
+//
+//! Cells of a universe often share surfaces, so while searching for the cell
+//! containing a point, the same surface may be checked many times. This small
+//! direct-mapped table remembers the sense of recently evaluated surfaces and
+//! is cleared whenever the position being searched changes. Rather than
+//! wiping the table, clearing increments an epoch that tags valid entries.
+//==============================================================================
+
+class SurfaceSenseCache {
+public:
+  //! Invalidate all entries
+  void clear()
+  {
+    if (++epoch_ == 0) {
+      for (auto& e : entries_) e.epoch = 0;
+      epoch_ = 1;
+    }
+  }
+
+  //! Look up the sense of a surface
+  //
+  //! \param i_surf Index in model::surfaces
+  //! \param[out] sense Sense of the surface, if present
+  //! \return Whether the sense of the surface was present
+  bool get(int32_t i_surf, bool& sense) const
+  {
+    const auto& e = entries_[i_surf % SIZE];
+    if (e.epoch != epoch_ || e.surface != i_surf) return false;
+    sense = e.sense;
+    return true;
+  }
+
+  //! Store the sense of a surface
+  //
+  //! \param i_surf Index in model::surfaces
+  //! \param sense Sense of the surface
+  void set(int32_t i_surf, bool sense)
+  {
+    entries_[i_surf % SIZE] = {epoch_, i_surf, sense};
+  }
+
+private:
+  struct Entry {
+    uint32_t epoch {0}; //!< epoch in which the entry was stored
+    int32_t surface;    //!< index in model::surfaces
+    bool sense;         //!< sense of the surface
+  };
+
+  static constexpr int SIZE {64}; //!< number of entries
+
+  std::array<Entry, SIZE> entries_;
+  uint32_t epoch_ {1}; //!< current epoch
+};
+
 //============================================================================
 //! State of a particle being transported through geometry
 //============================================================================
@@ -156,6 +311,11 @@ public:
     neutron, photon, electron, positron
   };
 
+  //! How a condensed history step of an electron or positron ends
+  enum class StepEnd {
+    energy_loss, bremsstrahlung, boundary
+  };
+
   //! Saved ("banked") state of a particle
   //! NOTE: This structure's MPI type is built in initialize_mpi() of
   //! initialize.cpp. Any changes made to the struct here must also be
@@ -168,6 +328,7 @@ public:
     Direction u;
     double E;
     double wgt;
+    double time {0.0};
     int delayed_group;
     Type particle;
     int64_t parent_id;
@@ -181,10 +342,35 @@ public:
     int delayed_group; //!< particle delayed group
   };
 
+  //! State of a particle at a point of its track
+  struct TrackState {
+    Position r; //!< position
+    double E;   //!< energy in [eV]
+    double wgt; //!< weight
+  };
+
+  //! Mesh bins crossed by the current track segment, shared by the filters of
+  //! all tracklength tallies on the same mesh
+  struct MeshTrack {
+    bool present {false}; //!< whether the bins are known for this segment
+    std::vector<int> bins; //!< bins that were crossed
+    std::vector<double> lengths; //!< fraction of the track in each bin
+    bool surfaces_present {false}; //!< whether surface_bins are known
+    std::vector<int> surface_bins; //!< surface bins crossed since surface_start
+    Position surface_start; //!< start of the tracks walked for surface_bins
+    Position surface_end; //!< end of the last track walked for surface_bins
+  };
+
   //==========================================================================
   // Constructors
 
   Particle();
+  ~Particle();
+
+  Particle(const Particle&) = default;
+  Particle(Particle&&) = default;
+  Particle& operator=(const Particle&) = default;
+  Particle& operator=(Particle&&) = default;
 
   //==========================================================================
   // Methods and accessors
@@ -227,7 +413,9 @@ public:
 
   // Coarse-grained particle events
   void event_calculate_xs();
-  void event_advance();
+  //! \param cell_distance Distance to the oncoming surface of the lowest-level
+  //!   cell, if already computed (see distance_to_boundary)
+  void event_advance(const std::pair<double, int32_t>* cell_distance = nullptr);
   void event_cross_surface();
   void event_collide();
   void event_revive_from_secondary();
@@ -249,6 +437,10 @@ public:
   //! create a particle restart HDF5 file
   void write_restart() const;
 
+  //! Get the speed of the particle from its energy
+  //! \return Speed in [cm/s]
+  double speed() const;
+
   //! Gets the pointer to the particle's current PRN seed
   uint64_t* current_seed() {return seeds_ + stream_;}
   const uint64_t* current_seed() const {return seeds_ + stream_;}
@@ -257,9 +449,12 @@ public:
   // Data members
 
   // Cross section caches
-  std::vector<NuclideMicroXS> neutron_xs_; //!< Microscopic neutron cross sections
+  NuclideMicroXSCache neutron_xs_; //!< Microscopic neutron cross sections
   std::vector<ElementMicroXS> photon_xs_; //!< Microscopic photon cross sections
   MacroXS macro_xs_; //!< Macroscopic cross sections
+  MgxsCache mg_xs_cache_; //!< Multigroup temperature and angle indices
+  std::vector<double> xs_cdf_; //!< Cumulative total XS of material nuclides
+  SurfaceSenseCache sense_cache_; //!< Surface senses during cell searches
 
   int64_t id_;  //!< Unique ID
   Type type_ {Type::neutron};   //!< Particle type (n, p, e, etc.)
@@ -280,6 +475,8 @@ public:
 
   // Other physical data
   double wgt_ {1.0};     //!< particle weight
+  double time_ {0.0};    //!< time since the birth of the history in [s]
+  double time_last_ {0.0}; //!< time at the start of the last track in [s]
   double mu_;      //!< angle of scatter
   bool alive_ {true};     //!< is particle alive?
 
@@ -314,11 +511,16 @@ public:
 
   // Boundary information
   BoundaryInfo boundary_;
+  bool boundary_cached_ {false}; //!< is boundary_ still ahead of the particle?
 
   // Temperature of current cell
   double sqrtkT_ {-1.0};      //!< sqrt(k_Boltzmann * temperature) in eV
   double sqrtkT_last_ {0.0};  //!< last temperature
 
+  // Density multiplier given by a mesh field
+  double density_mult_ {1.0};      //!< multiplier of the material density
+  double density_mult_last_ {1.0}; //!< last density multiplier
+
   // Statistical data
   int n_collision_ {0};  //!< number of collisions
 
@@ -329,16 +531,27 @@ public:
   uint64_t seeds_[N_STREAMS]; // current seeds
   int      stream_;           // current RNG stream
 
-  // Secondary particle bank
+  // Secondary particle bank. Its storage is taken from a pool of the thread
+  // constructing the particle and given back on destruction, so that the
+  // capacity it has grown to is reused by later histories.
   std::vector<Particle::Bank> secondary_bank_;
 
   int64_t current_work_; // current work index
 
   std::vector<double> flux_derivs_;  // for derivatives for this particle
+  std::vector<double> deriv_rates_;  // derivatives of the event's reaction rates
+  TallyEstimator deriv_rates_estimator_ {TallyEstimator::TRACKLENGTH}; // estimator deriv_rates_ are for, or tracklength if none
 
   std::vector<FilterMatch> filter_matches_; // tally filter matches
 
-  std::vector<std::vector<Position>> tracks_; // tracks for outputting to file
+  std::vector<int> tally_candidates_; // tallies that could score at an event
+
+  // Mesh bins crossed by the current track segment for each mesh. These are
+  // filled in while the filters are evaluated, which only have const access
+  // to the particle.
+  mutable std::vector<MeshTrack> mesh_tracks_;
+
+  std::vector<std::vector<TrackState>> tracks_; // tracks for outputting to file
 
   std::vector<NuBank> nu_bank_; // bank of most recently fissioned particles
 
@@ -351,6 +564,7 @@ public:
   bool trace_ {false};     //!< flag to show debug information
 
   double collision_distance_; // distance to particle's next closest collision
+  StepEnd step_end_ {StepEnd::energy_loss}; //!< end of condensed history step
 
   int n_event_ {0}; // number of events executed in this particle's history
 
@@ -358,6 +572,7 @@ public:
   #ifdef DAGMC
   moab::DagMC::RayHistory history_;
   Direction last_dir_;
+  int64_t last_triangle_ {-1}; //!< last triangle hit in a DAGMC cell BVH
   #endif
 
   int64_t n_progeny_ {0}; // Number of progeny produced by this particle
@@ -0,0 +1,57 @@
+//! \file performance.h
+//! Machine-readable report of the run time and memory use of a simulation
+
+#ifndef OPENMC_PERFORMANCE_H
+#define OPENMC_PERFORMANCE_H
+
+#include <vector>
+
+#include "xtensor/xtensor.hpp"
+
+namespace openmc {
+
+//==============================================================================
+// Global variables
+//==============================================================================
+
+namespace simulation {
+
+//! Transport time of each batch run by this process in [s]
+extern std::vector<double> time_batches;
+
+//! Transport time of each batch run on each process in [s], indexed by
+//! process then batch. This is only set on the master process.
+extern xt::xtensor<double, 2> time_batches_procs;
+
+} // namespace simulation
+
+//==============================================================================
+// Non-member functions
+//==============================================================================
+
+//! Record the transport time of the batch that was just run
+//
+//! \param time Transport time of the batch in [s]
+void record_batch_time(double time);
+
+//! Gather the batch transport times of all processes on the master process.
+//! This must be called by all processes.
+void gather_batch_times();
+
+//! Ratio of the largest to the mean transport time of the processes, which is
+//! one when the work is perfectly balanced. Batch times must have been
+//! gathered.
+//
+//! \param batch Index among the batches run, or -1 for all of them
+//! \return Load imbalance
+double load_imbalance(int batch = -1);
+
+//! Write performance.h5 with the timers, the calculation rate of each batch,
+//! the balance of the transport time among processes, the memory used by the
+//! main data structures and the numbers of processes and threads. This must
+//! be called by all processes.
+void write_performance_report();
+
+} // namespace openmc
+
+#endif // OPENMC_PERFORMANCE_H
@@ -1,6 +1,7 @@
 #ifndef OPENMC_PHOTON_H
 #define OPENMC_PHOTON_H
 
+#include "openmc/distribution.h"
 #include "openmc/endf.h"
 #include "openmc/particle.h"
 
@@ -44,6 +45,20 @@ public:
   // Methods
   void calculate_xs(Particle& p) const;
 
+  //! Calculate microscopic cross sections at an energy by log-log
+  //! interpolation on the energy grid
+  //
+  //! \param log_E Log of the energy
+  //! \param below Whether to take the values below the energy when it is a
+  //!   discontinuity of the grid, such as an absorption edge
+  //! \return Microscopic cross sections in [b]
+  ElementMicroXS calculate_xs(double log_E, bool below) const;
+
+  //! Index the energy grid on the equal-logarithmic photon grid and build the
+  //! cross section tables if settings::photon_xs_tables is set. The bounds of
+  //! the photon grid must have been determined.
+  void init_grid();
+
   void compton_scatter(double alpha, bool doppler, double* alpha_out,
     double* mu, int* i_shell, uint64_t* seed) const;
 
@@ -69,6 +84,19 @@ public:
   xt::xtensor<double, 1> pair_production_nuclear_;
   xt::xtensor<double, 1> heating_;
 
+  //! Index in energy_ of the last energy not above each bound of the
+  //! equal-logarithmic photon grid
+  std::vector<int> grid_index_;
+
+  // Cross sections on energy_ refined to the spacing of the photon grid, which
+  // are linearly interpolated in log energy without exponentials. These are
+  // only built when settings::photon_xs_tables is set.
+  std::vector<double> table_energy_; //!< Log of the energies of the tables
+  std::vector<int> table_grid_index_; //!< Like grid_index_ for table_energy_
+  std::vector<int> table_parent_; //!< Interval of energy_ of each energy
+  xt::xtensor<double, 2> table_xs_; //!< Coherent, incoherent, photoelectric
+                                    //!< and pair production xs in [b]
+
   // Form factors
   Tabulated1D incoherent_form_factor_;
   Tabulated1D coherent_int_form_factor_;
@@ -86,6 +114,12 @@ public:
   xt::xtensor<double, 1> binding_energy_;
   xt::xtensor<double, 1> electron_pdf_;
 
+  // Tables for sampling Compton profiles without searches, only built when
+  // settings::compton_tables is set
+  AliasTable shell_alias_; //!< Alias table of the electron shell PDF
+  xt::xtensor<int, 2> profile_index_; //!< Index in each shell's profile CDF
+                                      //!< at equally spaced CDF values
+
   // Stopping power data
   double I_; // mean excitation energy
   xt::xtensor<int, 1> n_electrons_;
@@ -98,6 +132,23 @@ public:
 private:
   void compton_doppler(double alpha, double mu, double* E_out, int* i_shell,
                        uint64_t* seed) const;
+
+  //! Find the interval of a shell's Compton profile CDF containing a value
+  //
+  //! \param shell Index of the electron shell
+  //! \param c Value of the CDF
+  //! \return Index of the lower bound of the interval
+  int profile_cdf_index(int shell, double c) const;
+
+  //! Build the cross section tables of settings::photon_xs_tables
+  void init_xs_tables();
+
+  //! Interpolate the cross sections within an interval of the energy grid
+  //
+  //! \param i_grid Index of the lower bound of the interval
+  //! \param f Interpolation factor in log energy
+  //! \param xs Microscopic cross sections to set
+  void interpolate_xs(int i_grid, double f, ElementMicroXS& xs) const;
 };
 
 //==============================================================================
@@ -106,8 +157,32 @@ private:
 
 std::pair<double, double> klein_nishina(double alpha, uint64_t* seed);
 
+//! Tabulate the inverse CDF of the Klein-Nishina distribution, which is then
+//! used by klein_nishina() instead of rejection sampling
+void init_klein_nishina_table();
+
 void free_memory_photon();
 
+//! Index a grid of log energies on the equal-logarithmic photon grid
+//
+//! \param energy Log of the energies in ascending order
+//! \param n Number of energies, at least two
+//! \return Index of the last energy not above each bound of the photon grid,
+//!   limited to the index of the last interval
+std::vector<int> log_grid_index(const double* energy, int n);
+
+//! Find the interval of a grid of log energies containing a log energy
+//
+//! The search is bounded to a bin of the photon grid when the grid has been
+//! indexed on it.
+//! \param energy Log of the energies in ascending order
+//! \param n Number of energies
+//! \param index Index of the grid on the photon grid or empty
+//! \param log_E Log of the energy
+//! \return Index of the lower bound of the interval
+int log_grid_search(const double* energy, int n, const std::vector<int>& index,
+  double log_E);
+
 //==============================================================================
 // Global variables
 //==============================================================================
@@ -116,6 +191,14 @@ namespace data {
 
 extern xt::xtensor<double, 1> compton_profile_pz; //! Compton profile momentum grid
 
+//! Quantiles of the Klein-Nishina distribution at each tabulated photon energy
+extern xt::xtensor<double, 2> klein_nishina_quantiles;
+
+//! Log of the lowest energy and lethargy spacing of the equal-logarithmic
+//! photon grid shared by all elements for energy grid searches
+extern double photon_log_E_min;
+extern double photon_log_spacing;
+
 //! Photon interaction data for each element
 extern std::vector<PhotonInteraction> elements;
 extern std::unordered_map<std::string, int> element_map;
@@ -80,8 +80,15 @@ Direction sample_target_velocity(const Nuclide& nuc, double E, Direction u,
 Direction sample_cxs_target_velocity(double awr, double E, Direction u, double kT,
   uint64_t* seed);
 
-void sample_fission_neutron(int i_nuclide, const Reaction& rx, double E_in,
-  Particle::Bank* site, uint64_t* seed);
+//! samples the delayed group, direction and energy of a fission neutron
+//! \param[in] i_nuclide Index of the fissioning nuclide
+//! \param[in] rx Fission reaction
+//! \param[inout] E_in Incident energy, whose location on the incident energy
+//!   grids is reused by the neutrons of a fission event
+//! \param[out] site Fission site
+//! \param[inout] seed Pseudorandom seed pointer
+void sample_fission_neutron(int i_nuclide, const Reaction& rx,
+  EnergyContext& E_in, Particle::Bank* site, uint64_t* seed);
 
 //! handles all reactions with a single secondary neutron (other than fission),
 //! i.e. level scattering, (n,np), (n,na), etc.
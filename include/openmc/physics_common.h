@@ -11,5 +11,13 @@ namespace openmc {
 //! \brief Performs the russian roulette operation for a particle
 void russian_roulette(Particle& p);
 
+//! \brief Combs the secondary bank of a particle down to about half
+//! of settings::max_secondaries sites
+//
+//! The sites of each particle type are combed separately, so that the total
+//! weight of each type is preserved exactly and the expected weight of each
+//! site is unchanged. The sites kept are in the same order as in the bank.
+void comb_secondaries(Particle& p);
+
 } // namespace openmc
 #endif // OPENMC_PHYSICS_COMMON_H
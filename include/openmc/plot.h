@@ -124,6 +124,7 @@ public:
   std::array<size_t, 3> pixels_; //!< Plot size in pixels
   bool color_overlaps_; //!< Show overlapping cells?
   int level_; //!< Plot universe level
+  bool ray_trace_ {false}; //!< Trace rays along rows instead of locating pixels
 };
 
 template<class T>
@@ -166,6 +167,11 @@ T PlotBase::get_map() const {
   // arbitrary direction
   Direction dir = {0.7071, 0.7071, 0.0};
 
+  // direction of rays traced along the rows
+  Direction row_dir = {0.0, 0.0, 0.0};
+  row_dir[in_i] = 1.0;
+  bool ray_trace = ray_trace_ && !color_overlaps_;
+
   #pragma omp parallel
   {
     Particle p;
@@ -178,6 +184,46 @@ T PlotBase::get_map() const {
     #pragma omp for
     for (int y = 0; y < height; y++) {
       p.r()[out_i] =  xyz[out_i] - out_pixel * y;
+
+      if (ray_trace) {
+        // Trace a ray along the row, giving each pixel whose center lies
+        // before the next boundary the cell the ray is in
+        p.u() = row_dir;
+        p.r()[in_i] = xyz[in_i];
+        p.n_coord_ = 1;
+        p.surface_ = 0;
+        bool found_cell = find_cell(p, 0);
+        int x = 0;
+        while (x < width) {
+          if (!found_cell) {
+            // Outside of the geometry, pixels are located one by one until the
+            // ray enters it again
+            p.r()[in_i] = xyz[in_i] + in_pixel * x;
+            p.n_coord_ = 1;
+            p.surface_ = 0;
+            found_cell = find_cell(p, 0);
+            if (!found_cell) ++x;
+            continue;
+          }
+
+          auto boundary = distance_to_boundary(p);
+          double s_boundary = p.r()[in_i] - xyz[in_i] + boundary.distance;
+          j = p.n_coord_ - 1;
+          if (level >=0) {j = level + 1;}
+          for (; x < width && in_pixel * x < s_boundary; ++x) {
+            data.set_value(y, x, p, j);
+          }
+          if (x == width) break;
+
+          for (int k = 0; k < p.n_coord_; ++k) {
+            p.coord_[k].r += boundary.distance * p.coord_[k].u;
+          }
+          found_cell = cross_boundary_ray(p, boundary);
+        }
+        p.u() = dir;
+        continue;
+      }
+
       for (int x = 0; x < width; x++) {
         p.r()[in_i] = xyz[in_i] + in_pixel * x;
         p.n_coord_ = 1;
@@ -219,6 +265,7 @@ private:
   void set_meshlines(pugi::xml_node plot_node);
   void set_mask(pugi::xml_node plot_node);
   void set_overlap_color(pugi::xml_node plot_node);
+  void set_ray_trace(pugi::xml_node plot_node);
 
 // Members
 public:
@@ -290,6 +337,9 @@ void create_voxel(Plot pl);
 //! \return RGBColor with random value
 RGBColor random_color();
 
+//! Free plots and the tiles cached for in-memory plots
+void free_memory_plot();
+
 
 } // namespace openmc
 #endif // OPENMC_PLOT_H
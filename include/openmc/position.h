@@ -9,6 +9,12 @@
 
 namespace openmc {
 
+// The arithmetic of positions is also compiled for the offload device, where
+// the flat geometry kernels use it
+#ifdef OPENMC_OFFLOAD
+#pragma omp declare target
+#endif
+
 //==============================================================================
 //! Type representing a position in Cartesian coordinates
 //==============================================================================
@@ -95,6 +101,10 @@ inline bool operator==(Position a, Position b)
 inline bool operator!=(Position a, Position b)
 {return a.x != b.x || a.y != b.y || a.z != b.z;}
 
+#ifdef OPENMC_OFFLOAD
+#pragma omp end declare target
+#endif
+
 std::ostream& operator<<(std::ostream& os, Position a);
 
 //==============================================================================
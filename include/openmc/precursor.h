@@ -0,0 +1,76 @@
+//! \file precursor.h
+//! Delayed neutron precursor populations on a mesh for transient calculations
+
+#ifndef OPENMC_PRECURSOR_H
+#define OPENMC_PRECURSOR_H
+
+#include <cstdint> // for int32_t
+
+#include "pugixml.hpp"
+#include "xtensor/xtensor.hpp"
+
+#include "openmc/particle.h"
+
+namespace openmc {
+
+//==============================================================================
+// Global variables
+//==============================================================================
+
+namespace simulation {
+
+//! Index in model::meshes of the mesh on which precursors are tallied, or -1
+extern int32_t precursor_mesh;
+
+//! Weight of the delayed fission sites banked in each mesh bin and delayed
+//! group during the active batches of the current simulation
+extern xt::xtensor<double, 2> precursor_weight;
+
+//! Weight of the delayed fission sites times the decay constant of their
+//! group in [1/s], tallied as precursor_weight
+extern xt::xtensor<double, 2> precursor_weight_decay;
+
+//! Precursors produced per source particle in each mesh bin and delayed group
+//! by the last simulation
+extern xt::xtensor<double, 2> precursor_yield;
+
+//! Mean decay constant in [1/s] of the precursors of each mesh bin and delayed
+//! group produced by the last simulation
+extern xt::xtensor<double, 2> precursor_decay_rate;
+
+//! Precursor population of each mesh bin and delayed group, which is kept
+//! between simulations and only changed by openmc_precursors_advance
+extern xt::xtensor<double, 2> precursors;
+
+} // namespace simulation
+
+//==============================================================================
+// Non-member functions
+//==============================================================================
+
+//! Read the precursor mesh of settings.xml. Meshes must have been read.
+//
+//! \param root Root element of settings.xml
+void read_precursor_mesh(pugi::xml_node root);
+
+//! Zero the precursor tallies at the start of a simulation
+void init_precursor_tallies();
+
+//! Tally a delayed fission site banked by a particle
+//
+//! \param p Particle causing the fission
+//! \param wgt Weight of the site relative to the source particle
+//! \param group Delayed group of the site, starting at 1
+//! \param decay_rate Decay constant of the precursors of the group in [1/s]
+void score_precursor(const Particle& p, double wgt, int group,
+  double decay_rate);
+
+//! Compute the precursor yields and decay constants from the tallies of the
+//! simulation that ended. This must be called by all processes.
+void finalize_precursor_tallies();
+
+void free_memory_precursors();
+
+} // namespace openmc
+
+#endif // OPENMC_PRECURSOR_H
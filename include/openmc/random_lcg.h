@@ -19,6 +19,12 @@ constexpr int STREAM_VOLUME     {4};
 constexpr int STREAM_PHOTON     {5};
 constexpr int64_t DEFAULT_SEED  {1};
 
+//! Pseudorandom number generators
+enum class RandomGenerator {
+  lcg,   //!< 63-bit linear congruential generator
+  philox //!< counter-based Philox-2x32-10 generator
+};
+
 //==============================================================================
 //! Generate a pseudo-random number using a linear congruential generator.
 //! @param seed Pseudorandom number seed pointer
@@ -27,6 +33,19 @@ constexpr int64_t DEFAULT_SEED  {1};
 
 double prn(uint64_t* seed);
 
+//==============================================================================
+//! Generate several pseudo-random numbers at once.
+//!
+//! The result is the same as calling `prn()` 'n' times. With the counter-based
+//! generator, the random numbers are generated independently of one another so
+//! that the loop can be vectorized.
+//! @param seed Pseudorandom number seed pointer
+//! @param n Number of random numbers to generate
+//! @param xi Array of 'n' random numbers between 0 and 1
+//==============================================================================
+
+void prn(uint64_t* seed, int n, double* xi);
+
 //==============================================================================
 //! Generate a random number which is 'n' times ahead from the current seed.
 //!
@@ -83,6 +102,19 @@ void advance_prn_seed(int64_t n, uint64_t* seed);
 
 uint64_t future_seed(uint64_t n, uint64_t seed);
 
+//==============================================================================
+//! Select the pseudorandom number generator.
+//!
+//! Seeds obtained with one generator cannot be used with the other, so this
+//! must be done before any seed is initialized.
+//! @param generator The pseudorandom number generator
+//==============================================================================
+
+void set_random_generator(RandomGenerator generator);
+
+//! Get the pseudorandom number generator in use
+RandomGenerator random_generator();
+
 //==============================================================================
 //                               API FUNCTIONS
 //==============================================================================
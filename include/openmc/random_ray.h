@@ -0,0 +1,119 @@
+//! \file random_ray.h
+//! Random ray solver for multigroup eigenvalue problems
+
+#ifndef OPENMC_RANDOM_RAY_H
+#define OPENMC_RANDOM_RAY_H
+
+#include <cstdint> // for int64_t
+#include <memory> // for unique_ptr
+#include <vector>
+
+#include "pugixml.hpp"
+
+namespace openmc {
+
+class Particle;
+
+//==============================================================================
+//! Solves multigroup eigenvalue problems with the random ray method
+//
+//! The scalar flux is assumed to be flat within flat source regions, which are
+//! the instances of material cells. In each batch, rays start at positions
+//! sampled from the external source with isotropic directions and are traced
+//! through the geometry with the same kernels as particles. Their angular flux
+//! is attenuated along each segment by the method of characteristics with the
+//! isotropic scattering and fission source of the previous batch. Over the
+//! first part of its length a ray only builds up its angular flux; over the
+//! rest, the changes in angular flux and the segment lengths are accumulated
+//! to estimate the scalar flux and volume of each region. Scattering is
+//! treated as isotropic and the cross sections must not depend on angle.
+//==============================================================================
+
+class RandomRaySolver {
+public:
+  //! Read the random ray settings
+  //
+  //! \param node <random_ray> element of settings.xml
+  explicit RandomRaySolver(pugi::xml_node node);
+
+  //! Map the flat source regions to cell instances and gather the cross
+  //! sections of their materials. Multigroup cross sections must have been
+  //! read and the instances of cells counted.
+  void initialize();
+
+  //! Check that every tally can be scored by the rays, which only provide
+  //! track-length estimates
+  void check_tallies() const;
+
+  //! Transport the rays of a batch and update the scalar flux and eigenvalue.
+  //! Track-length tallies are scored by the rays during active batches.
+  void transport();
+
+  double keff() const { return keff_; } //!< Eigenvalue of the last batch
+
+private:
+  //! Cross sections of a material at one temperature, indexed by group
+  struct GroupXS {
+    std::vector<double> total;      //!< total cross section
+    std::vector<double> nu_fission; //!< production cross section
+    //! Nu-scatter matrix, indexed by incoming then outgoing group
+    std::vector<double> scatter;
+    //! Fission neutron production matrix including the prompt and delayed
+    //! spectra, indexed by incoming then outgoing group
+    std::vector<double> fission;
+  };
+
+  //! Update the source of each region from the scalar flux of the last batch
+  void update_source();
+
+  //! Trace a ray through the geometry
+  //
+  //! \param p Particle holding the geometric state of the ray
+  //! \param psi Angular flux of the ray in each group
+  //! \param tally Whether track-length tallies are scored
+  void transport_ray(Particle& p, std::vector<double>& psi, bool tally);
+
+  //! Score track-length tallies for a segment of a ray
+  //
+  //! \param p Particle holding the geometric state of the ray at the start of
+  //!   the segment
+  //! \param mean_psi Average angular flux over the segment in each group
+  //! \param distance Length of the segment in [cm]
+  void score_segment(Particle& p, const std::vector<double>& mean_psi,
+    double distance) const;
+
+  //! Get the flat source region containing a ray
+  int64_t region(const Particle& p) const;
+
+  double distance_inactive_; //!< length over which a ray builds up in [cm]
+  double distance_active_;   //!< length over which a ray contributes in [cm]
+
+  int n_groups_; //!< number of energy groups
+  int64_t n_regions_ {0}; //!< number of flat source regions
+  std::vector<int64_t> region_offset_; //!< first region of each cell or C_NONE
+  std::vector<int> region_xs_; //!< index in xs_ of each region or C_NONE
+  std::vector<GroupXS> xs_; //!< cross sections of each material/temperature
+
+  // The following are indexed by region then group
+  std::vector<double> source_;   //!< isotropic source divided by total xs
+  std::vector<double> flux_;     //!< scalar flux of the last batch
+  std::vector<double> flux_new_; //!< accumulated angular flux changes
+
+  std::vector<double> length_;       //!< track length in each region in a batch
+  std::vector<double> length_total_; //!< track length summed over batches
+  int n_length_batches_ {0}; //!< number of batches in length_total_
+  double keff_ {1.0};
+};
+
+//==============================================================================
+// Global variables
+//==============================================================================
+
+namespace simulation {
+  //! Random ray solver replacing particle transport, if enabled
+  extern std::unique_ptr<RandomRaySolver> random_ray;
+} // namespace simulation
+
+} // namespace openmc
+
+#endif // OPENMC_RANDOM_RAY_H
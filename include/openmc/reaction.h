@@ -8,7 +8,9 @@
 #include <vector>
 
 #include "hdf5.h"
+#include <gsl/gsl>
 
+#include "openmc/constants.h"
 #include "openmc/reaction_product.h"
 
 namespace openmc {
@@ -26,10 +28,22 @@ public:
   //! \param[in] temperatures Desired temperatures for cross sections
   explicit Reaction(hid_t group, const std::vector<int>& temperatures);
 
+  //! Average the cross section over energy groups
+  //
+  //! The cross section, linear between grid points, is integrated exactly
+  //! over each group and divided by its width, which is the average weighted
+  //! by a flux that is constant in energy within the group.
+  //! \param i_temp Temperature index
+  //! \param energy Group boundaries in [eV] in increasing order
+  //! \param grid Energy grid of the nuclide at the temperature
+  //! \return Average cross section in each group in [b]
+  std::vector<double> group_xs(int i_temp, gsl::span<const double> energy,
+    const std::vector<xs_real>& grid) const;
+
   //! Cross section at a single temperature
   struct TemperatureXS {
     int threshold;
-    std::vector<double> value;
+    std::vector<xs_real> value;
   };
 
   int mt_;             //!< ENDF MT value
@@ -5,6 +5,7 @@
 #define OPENMC_REACTION_PRODUCT_H
 
 #include <memory> // for unique_ptr
+#include <string>
 #include <vector> // for vector
 
 #include "hdf5.h"
@@ -36,7 +37,9 @@ public:
 
   //! Construct reaction product from HDF5 data
   //! \param[in] group HDF5 group containing data
-  explicit ReactionProduct(hid_t group);
+  //! \param[in] lazy Whether to defer reading the angle-energy distributions
+  //!   until the product is first sampled
+  explicit ReactionProduct(hid_t group, bool lazy=false);
 
   //! Sample an outgoing angle and energy
   //! \param[in] E_in Incoming energy in [eV]
@@ -45,12 +48,36 @@ public:
   //! \param[inout] seed Pseudorandom seed pointer
   void sample(double E_in, double& E_out, double& mu, uint64_t* seed) const;
 
+  //! Sample an outgoing angle and energy at an incoming energy whose location
+  //! on the incoming energy grids may be reused
+  //! \param[inout] E_in Incoming energy
+  //! \param[out] E_out Outgoing energy in [eV]
+  //! \param[out] mu Outgoing cosine with respect to current direction
+  //! \param[inout] seed Pseudorandom seed pointer
+  void sample(EnergyContext& E_in, double& E_out, double& mu,
+    uint64_t* seed) const;
+
   Particle::Type particle_; //!< Particle type
   EmissionMode emission_mode_; //!< Emission mode
   double decay_rate_; //!< Decay rate (for delayed neutron precursors) in [1/s]
   std::unique_ptr<Function1D> yield_; //!< Yield as a function of energy
-  std::vector<Tabulated1D> applicability_; //!< Applicability of distribution
-  std::vector<Secondary> distribution_; //!< Secondary angle-energy distribution
+  InlineFunction1D yield_fn_; //!< Yield evaluated without virtual calls
+
+  // The distributions may be read on first use, from a const method
+  mutable std::vector<Tabulated1D> applicability_; //!< Applicability of distribution
+  mutable std::vector<Secondary> distribution_; //!< Secondary angle-energy distribution
+
+private:
+  //! Read angle-energy distributions and their applicability
+  //! \param[in] group HDF5 group containing data
+  void read_distributions(hid_t group) const;
+
+  //! Read deferred angle-energy distributions if that has not happened yet
+  void load_distributions() const;
+
+  mutable bool loaded_ {true}; //!< Have the distributions been read?
+  std::string filename_; //!< File containing deferred distributions
+  std::string path_;     //!< Path of the product group within the file
 };
 
 } // namespace opemc
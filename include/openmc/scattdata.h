@@ -4,6 +4,9 @@
 #ifndef OPENMC_SCATTDATA_H
 #define OPENMC_SCATTDATA_H
 
+#include <cstddef> // for size_t
+#include <memory> // for shared_ptr
+#include <unordered_map>
 #include <vector>
 
 #include "xtensor/xtensor.hpp"
@@ -31,6 +34,11 @@ class ScattData {
          const xt::xtensor<int, 1>& in_gmax, const double_2dvec& in_energy,
          const double_2dvec& in_mult);
 
+    //! \brief Packs the outgoing group data of all incoming groups into one
+    //!   block for sampling.
+    void
+    pack_outgoing();
+
     //! \brief Combines microscopic ScattDatas into a macroscopic one.
     void
     base_combine(size_t max_order, const std::vector<ScattData*>& those_scatts,
@@ -40,12 +48,22 @@ class ScattData {
 
   public:
 
+    //! Data of an outgoing group needed when sampling a scatter
+    struct Outgoing {
+      double cdf;  // probability of this and all lower outgoing groups
+      double mult; // nu-scatter multiplication (nu-scatt/scatt)
+    };
+
     double_2dvec energy;            // Normalized p0 matrix for sampling Eout
     double_2dvec mult;              // nu-scatter multiplication (nu-scatt/scatt)
     double_3dvec dist;              // Angular distribution
     xt::xtensor<int, 1> gmin;    // minimum outgoing group
     xt::xtensor<int, 1> gmax;    // maximum outgoing group
     xt::xtensor<double, 1> scattxs; // Isotropic Sigma_{s,g_{in}}
+    // Outgoing group data of all incoming groups back-to-back, with the
+    // index of the first entry of each incoming group
+    std::vector<Outgoing> outgoing;
+    std::vector<int> outgoing_start;
 
     //! \brief Calculates the value of normalized f(mu).
     //!
@@ -112,7 +130,16 @@ class ScattData {
     //! @param i_gout Sampled outgoing energy group index.
     //! @param seed Pseudorandom number seed pointer
     void
-    sample_energy(int gin, int& gout, int& i_gout, uint64_t* seed);
+    sample_energy(int gin, int& gout, int& i_gout, uint64_t* seed) const;
+
+    //! \brief Provides the nu-scatter multiplication of an outgoing group.
+    //!
+    //! @param gin Incoming energy group.
+    //! @param i_gout Outgoing energy group index.
+    //! @return The multiplication.
+    double
+    multiplicity(int gin, int i_gout) const
+    {return outgoing[outgoing_start[gin] + i_gout].mult;}
 
     //! \brief Provides a cross section value given certain parameters
     //!
@@ -126,6 +153,20 @@ class ScattData {
     //! @return Requested cross section value.
     double
     get_xs(MgxsType xstype, int gin, const int* gout, const double* mu);
+
+    //! \brief Computes a hash of the group bounds and energy distribution.
+    //!
+    //! Objects for which equals() is true have the same hash.
+    //! @return The hash.
+    size_t
+    hash() const;
+
+    //! \brief Checks whether another object holds the same data.
+    //!
+    //! @param that The object to compare to.
+    //! @return True if both are of the same type with identical data.
+    virtual bool
+    equals(const ScattData& that) const;
 };
 
 //==============================================================================
@@ -206,6 +247,9 @@ class ScattDataHistogram: public ScattData {
 
     xt::xtensor<double, 3>
     get_matrix(size_t max_order);
+
+    bool
+    equals(const ScattData& that) const;
 };
 
 //==============================================================================
@@ -247,6 +291,9 @@ class ScattDataTabular: public ScattData {
 
     xt::xtensor<double, 3>
     get_matrix(size_t max_order);
+
+    bool
+    equals(const ScattData& that) const;
 };
 
 //==============================================================================
@@ -263,5 +310,24 @@ void
 convert_legendre_to_tabular(ScattDataLegendre& leg, ScattDataTabular& tab,
                             int n_mu);
 
+//==============================================================================
+// SCATTDATAPOOL holds distinct scattering data so that identical matrices are
+// stored once and shared by all the nuclides and materials using them
+//==============================================================================
+
+class ScattDataPool {
+  public:
+    //! \brief Replaces an object by an identical one already in the pool, or
+    //!   adds it to the pool if there is none.
+    //!
+    //! @param scatt The object to share.
+    void
+    share(std::shared_ptr<ScattData>& scatt);
+
+  private:
+    // Distinct objects, grouped by their hash
+    std::unordered_map<size_t, std::vector<std::shared_ptr<ScattData>>> data_;
+};
+
 } // namespace openmc
 #endif // OPENMC_SCATTDATA_H
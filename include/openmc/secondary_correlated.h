@@ -30,6 +30,7 @@ public:
     xt::xtensor<double, 1> p; //!< Probability density
     xt::xtensor<double, 1> c; //!< Cumulative distribution
     std::vector<UPtrDist> angle; //!< Angle distribution
+    CdfBinTable bins; //!< Ranges of the cumulative distribution, if precomputed
   };
 
   explicit CorrelatedAngleEnergy(hid_t group);
@@ -42,6 +43,15 @@ public:
   void sample(double E_in, double& E_out, double& mu,
     uint64_t* seed) const override;
 
+  //! Sample distribution at an incoming energy whose location on the incoming
+  //! energy grid may be reused
+  //! \param[inout] E_in Incoming energy
+  //! \param[out] E_out Outgoing energy in [eV]
+  //! \param[out] mu Outgoing cosine with respect to current direction
+  //! \param[inout] seed Pseudorandom seed pointer
+  void sample(EnergyContext& E_in, double& E_out, double& mu,
+    uint64_t* seed) const override;
+
   // energy property
   std::vector<double>& energy() { return energy_; }
   const std::vector<double>& energy() const { return energy_; }
@@ -50,6 +60,16 @@ public:
   std::vector<CorrTable>& distribution() { return distribution_; }
   const std::vector<CorrTable>& distribution() const { return distribution_; }
 private:
+  //! Search for the outgoing energy bin of a value of the cumulative
+  //! distribution
+  //! \param[in] d Distribution at an incoming energy
+  //! \param[in] r1 Value of the cumulative distribution
+  //! \param[out] k Outgoing energy bin
+  //! \param[out] c_k Cumulative distribution used at the bin
+  //! \param[out] c_k1 Cumulative distribution used at the next bin
+  static void find_bin(const CorrTable& d, double r1, int& k, double& c_k,
+    double& c_k1);
+
   int n_region_; //!< Number of interpolation regions
   std::vector<int> breakpoints_; //!< Breakpoints between regions
   std::vector<Interpolation> interpolation_; //!< Interpolation laws
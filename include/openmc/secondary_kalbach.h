@@ -32,6 +32,15 @@ public:
   //! \param[inout] seed Pseudorandom seed pointer
   void sample(double E_in, double& E_out, double& mu,
     uint64_t* seed) const override;
+
+  //! Sample distribution at an incoming energy whose location on the incoming
+  //! energy grid may be reused
+  //! \param[inout] E_in Incoming energy
+  //! \param[out] E_out Outgoing energy in [eV]
+  //! \param[out] mu Outgoing cosine with respect to current direction
+  //! \param[inout] seed Pseudorandom seed pointer
+  void sample(EnergyContext& E_in, double& E_out, double& mu,
+    uint64_t* seed) const override;
 private:
   //! Outgoing energy/angle at a single incoming energy
   struct KMTable {
@@ -79,6 +79,8 @@ public:
   //! \param[inout] seed Pseudorandom number seed pointer
   void sample(double E_in, double& E_out, double& mu,
     uint64_t* seed) const override;
+
+  std::size_t memory() const override;
 private:
   const std::vector<double>& energy_; //!< Energies at which cosines are tabulated
   xt::xtensor<double, 2> mu_out_; //!< Cosines for each incident energy
@@ -103,6 +105,8 @@ public:
   //! \param[inout] seed Pseudorandom number seed pointer
   void sample(double E_in, double& E_out, double& mu,
     uint64_t* seed) const override;
+
+  std::size_t memory() const override;
 private:
   const std::vector<double>& energy_; //!< Incident energies
   xt::xtensor<double, 2> energy_out_; //!< Outgoing energies for each incident energy
@@ -128,6 +132,8 @@ public:
   //! \param[inout] seed Pseudorandom number seed pointer
   void sample(double E_in, double& E_out, double& mu,
     uint64_t* seed) const override;
+
+  std::size_t memory() const override;
 private:
   //! Secondary energy/angle distribution
   struct DistEnergySab {
@@ -136,8 +142,19 @@ private:
     xt::xtensor<double, 1> e_out_pdf; //!< Probability density function
     xt::xtensor<double, 1> e_out_cdf; //!< Cumulative distribution function
     xt::xtensor<double, 2> mu; //!< Equiprobable angles at each outgoing energy
+    CdfBinTable bins; //!< Ranges of the CDF, if precomputed
   };
 
+  //! Search for the outgoing energy bin of a value of the cumulative
+  //! distribution
+  //! \param[in] d Distribution at an incoming energy
+  //! \param[in] r1 Value of the cumulative distribution
+  //! \param[out] j Outgoing energy bin
+  //! \param[out] c_j Cumulative distribution used at the bin
+  //! \param[out] c_j1 Cumulative distribution used at the next bin
+  static void find_bin(const DistEnergySab& d, double r1, int& j, double& c_j,
+    double& c_j1);
+
   std::vector<double> energy_; //!< Incident energies
   std::vector<DistEnergySab> distribution_; //!< Secondary angle-energy at
                                             //!< each incident energy
@@ -33,6 +33,15 @@ public:
   void sample(double E_in, double& E_out, double& mu,
     uint64_t* seed) const override;
 
+  //! Sample distribution at an incoming energy whose location on the incoming
+  //! energy grid may be reused
+  //! \param[inout] E_in Incoming energy
+  //! \param[out] E_out Outgoing energy in [eV]
+  //! \param[out] mu Outgoing cosine with respect to current direction
+  //! \param[inout] seed Pseudorandom seed pointer
+  void sample(EnergyContext& E_in, double& E_out, double& mu,
+    uint64_t* seed) const override;
+
   // Accessors
   AngleDistribution& angle() { return angle_; }
   bool& fission() { return fission_; }
@@ -23,44 +23,89 @@ namespace openmc {
 namespace settings {
 
 // Boolean flags
+extern bool alias_sampling;           //!< sample large distributions with alias tables?
 extern bool assume_separate;          //!< assume tallies are spatially separate?
+extern bool async_statepoint;         //!< write state points in the background?
+extern bool async_summary;            //!< write the summary in the background?
+extern bool azimuth_rejection;        //!< sample azimuthal angles by rejection?
+extern bool broadcast_data;           //!< broadcast nuclear data files from master?
 extern bool check_overlaps;           //!< check overlaps in geometry?
+extern bool compact_xs_cache;         //!< only cache XS of current material?
+extern bool compton_tables;           //!< sample Compton scattering from tables?
 extern bool confidence_intervals;     //!< use confidence intervals for results?
+extern bool correlated_alias;         //!< sample correlated energies with alias tables?
 extern bool create_fission_neutrons;  //!< create fission neutrons (fixed source)?
+extern bool cumulative_xs;            //!< store cumulative XS for collision sampling?
 extern "C" bool cmfd_run;             //!< is a CMFD run?
 extern "C" bool dagmc;                //!< indicator of DAGMC geometry
+extern bool dagmc_bvh;                //!< trace DAGMC rays with OpenMC BVHs?
 extern bool delayed_photon_scaling;   //!< Scale fission photon yield to include delayed
+extern bool delta_tracking;           //!< use delta tracking in the whole geometry?
 extern "C" bool entropy_on;           //!< calculate Shannon entropy?
 extern bool event_based;              //!< use event-based mode (instead of history-based)
+extern bool event_batch_distance;     //!< batch boundary distances in event mode?
+extern bool event_fuse_advance;       //!< fuse advance with cross/collide?
+extern bool event_queue_sort;         //!< sort event-based XS lookup queues?
+extern bool event_refill;             //!< refill buffer slots of dead particles?
+extern bool flat_geometry;            //!< track with a flat copy of the geometry?
+extern "C" bool instrument;           //!< report kernel regions to profilers?
+extern bool huge_pages;               //!< back large arrays with huge pages?
+extern bool interleaved_xs;           //!< interleave XS channels with energy grid?
+extern bool lazy_products;            //!< defer reading secondary distributions?
 extern bool legendre_to_tabular;      //!< convert Legendre distributions to tabular?
+extern bool load_balance;             //!< balance work by measured rank throughput?
 extern bool material_cell_offsets;    //!< create material cells offsets?
+extern bool numa_interleave;          //!< interleave large arrays among NUMA nodes?
 extern "C" bool output_summary;       //!< write summary.h5?
 extern bool output_tallies;           //!< write tallies.out?
 extern bool particle_restart_run;     //!< particle restart run?
+extern bool performance_report;       //!< write performance.h5?
+extern bool photon_material_tables;   //!< tabulate material photon XS?
 extern "C" bool photon_transport;     //!< photon transport turned on?
+extern bool photon_xs_tables;         //!< interpolate tabulated photon XS linearly?
+extern bool pipeline_tallies;         //!< overlap tally reduction with next batch?
+extern bool private_tallies;          //!< score tallies in thread-private buffers?
 extern "C" bool reduce_tallies;       //!< reduce tallies at end of batch?
 extern bool res_scat_on;              //!< use resonance upscattering method?
 extern "C" bool restart_run;          //!< restart run?
+extern "C" bool retain_data;          //!< keep nuclear data after finalizing?
+extern "C" bool reuse_source;         //!< start from the previous source?
 extern "C" bool run_CE;               //!< run with continuous-energy data?
+extern bool shared_bank;              //!< share sampled sites among ranks on a node?
+extern bool shared_xs;                //!< share nuclide XS among ranks on a node?
+extern bool source_binary;            //!< write source points in binary format?
+extern bool source_sort;              //!< order source sites along a Morton curve?
 extern bool source_latest;            //!< write latest source at each batch?
 extern bool source_separate;          //!< write source to separate file?
 extern bool source_write;             //!< write source in HDF5 files?
+extern bool statepoint_incremental;   //!< write changes of tally results only?
 extern bool survival_biasing;         //!< use survival biasing?
+extern bool tally_profiling;          //!< measure the cost of each tally?
+extern bool temperature_cache;        //!< cache nuclide temperature indices per cell?
 extern bool temperature_multipole;    //!< use multipole data?
+extern bool thermal_alias;            //!< sample thermal energies with alias tables?
+extern bool threaded_xs_read;         //!< read nuclear data with multiple threads?
+extern bool track_single_file;        //!< write all tracks to a single file?
+extern bool trigger_freeze;           //!< stop scoring satisfied tallies?
 extern "C" bool trigger_on;           //!< tally triggers enabled?
 extern bool trigger_predict;          //!< predict batches for triggers?
+extern bool tune_particles_in_flight; //!< tune max_particles_in_flight?
 extern bool ufs_on;                   //!< uniform fission site method on?
 extern bool urr_ptables_on;           //!< use unresolved resonance prob. tables?
+extern bool vectorize_multipole;      //!< use SIMD Faddeeva for multipole?
+extern bool vectorize_xs;             //!< use SIMD to form macroscopic XS?
 extern bool write_all_tracks;         //!< write track files for every particle?
 extern bool write_initial_source;     //!< write out initial source file?
 
 // Paths to various files
 extern std::string path_cross_sections;   //!< path to cross_sections.xml
 extern std::string path_input;            //!< directory where main .xml files resides
+extern std::string path_neighbor_lists;   //!< statepoint with neighbor lists to start from
 extern std::string path_output;           //!< directory where output files are written
 extern std::string path_particle_restart; //!< path to a particle restart file
 extern std::string path_source;
 extern std::string path_source_library;   //!< path to the source shared object
+extern std::string path_xs_cache;         //!< directory for cached derived cross sections
 extern std::string path_sourcepoint;      //!< path to a source file
 extern "C" std::string path_statepoint;   //!< path to a statepoint file
 
@@ -70,13 +115,31 @@ extern "C" int32_t max_lost_particles;     //!< maximum number of lost particles
 extern double rel_max_lost_particles;   //!< maximum number of lost particles, relative to the total number of particles
 extern "C" int32_t gen_per_batch;            //!< number of generations per batch
 extern "C" int64_t n_particles;              //!< number of particles per generation
+extern double particle_ramp;  //!< fraction of particles in the first inactive batch
+extern double event_memory_budget; //!< memory for particles in flight in [MiB]
 
 
 extern int64_t max_particles_in_flight; //!< Max num. event-based particles in flight
+extern int64_t event_queue_sort_threshold; //!< Min queue length to sort
+extern int64_t event_local_queue_length; //!< Thread-local event queue length
+extern int64_t event_prefetch_distance; //!< Queue entries to prefetch XS ahead
+extern int64_t private_tallies_max_size; //!< Max results of a tally to replicate per thread
+extern int64_t max_surface_particles;   //!< Max surface source sites per process
+extern int64_t max_census_particles;    //!< Max census sites per process, or -1
+extern int64_t max_secondaries; //!< Max secondary sites of a history before combing
 
 extern ElectronTreatment electron_treatment;       //!< how to treat secondary electrons
+extern EventScheduler event_scheduler;  //!< policy for choosing event kernels
+extern int64_t event_min_queue_length;  //!< min. queue length to run a kernel
+extern int64_t event_history_threshold; //!< alive particles to switch to history
 extern std::array<double, 4> energy_cutoff;  //!< Energy cutoff in [eV] for each particle type
+extern std::array<double, 4> time_cutoff;  //!< Time cutoff in [s] for each particle type
+extern double census_time;  //!< Time in [s] at which particles are banked for the census
+extern EnergySearch energy_search;     //!< method for energy grid searches
+extern HistoryScheduler history_scheduler; //!< scheduling of histories among threads
+extern ThreadAffinity thread_affinity; //!< placement of threads on CPUs
 extern int legendre_to_tabular_points; //!< number of points to convert Legendres
+extern int history_interleave;       //!< histories in flight per thread
 extern int max_order;                //!< Maximum Legendre order for multigroup data
 extern int n_log_bins;               //!< number of bins for logarithmic energy grid
 extern int n_max_batches;            //!< Maximum number of batches
@@ -86,11 +149,14 @@ extern double res_scat_energy_max;   //!< Max energy in [eV] for res. upscatteri
 extern std::vector<std::string> res_scat_nuclides;  //!< Nuclides using res. upscattering treatment
 extern RunMode run_mode;                 //!< Run mode (eigenvalue, fixed src, etc.)
 extern std::unordered_set<int> sourcepoint_batch; //!< Batches when source should be written
+extern std::unordered_set<int> source_write_surf_id; //!< Surfaces of the surface source
 extern std::unordered_set<int> statepoint_batch; //!< Batches when state should be written
+extern int tally_compression;            //!< Deflate level of tally results or 0
 extern TemperatureMethod temperature_method;           //!< method for choosing temperatures
 extern double temperature_tolerance;     //!< Tolerance in [K] on choosing temperatures
 extern double temperature_default;       //!< Default T in [K]
 extern std::array<double, 2> temperature_range;  //!< Min/max T in [K] over which to load xs
+extern double thinning_tolerance;        //!< Fractional tolerance on removing energy points
 extern int trace_batch;                  //!< Batch to trace particle on
 extern int trace_gen;                    //!< Generation to trace particle on
 extern int64_t trace_particle;           //!< Particle ID to enable trace on
@@ -4,6 +4,8 @@
 //! \file shared_array.h
 //! \brief Shared array data structure
 
+#include <algorithm> // for copy
+#include <cstdint>
 #include <memory>
 
 
@@ -89,6 +91,36 @@ public:
     return idx;
   }
 
+  //! Increase the size of the container by n and append the given values to
+  //! the array. Only a single atomic operation is needed regardless of the
+  //! number of values, which makes this much cheaper than repeated calls to
+  //! thread_safe_append() when a thread has accumulated several values.
+  //
+  //! \param values Pointer to the values to append
+  //! \param n Number of values to append
+  //! \return The index in the array of the first value written. In the event
+  //! that the values would not fit in what was allocated for the container,
+  //! return -1.
+  int64_t thread_safe_append(const T* values, int64_t n)
+  {
+    // Atomically reserve a contiguous block of indices
+    int64_t idx;
+    #pragma omp atomic capture
+    {idx = size_; size_ += n;}
+
+    // Check that we haven't written off the end of the array
+    if (idx + n > capacity_) {
+      #pragma omp atomic write
+      size_ = capacity_;
+      return -1;
+    }
+
+    // Copy element values to the array
+    std::copy(values, values + n, data_.get() + idx);
+
+    return idx;
+  }
+
   //! Free any space that was allocated for the container. Set the
   //! container's size and capacity to 0.
   void clear()
@@ -16,6 +16,12 @@ constexpr int STATUS_EXIT_NORMAL {0};
 constexpr int STATUS_EXIT_MAX_BATCH {1};
 constexpr int STATUS_EXIT_ON_TRIGGER {2};
 
+//! Function registered through the C API to be called at the end of each batch
+struct BatchCallback {
+  void (*func)(int batch, void* data); //!< function to call
+  void* data; //!< user data passed to the function
+};
+
 //==============================================================================
 // Global variable declarations
 //==============================================================================
@@ -32,19 +38,23 @@ extern "C" double k_col_tra;     //!< sum over batches of k_collision * k_trackl
 extern "C" double k_abs_tra;     //!< sum over batches of k_absorption * k_tracklength
 extern double log_spacing;       //!< lethargy spacing for energy grid searches
 extern "C" int n_lost_particles; //!< cumulative number of lost particles
-extern "C" bool need_depletion_rx; //!< need to calculate depletion rx?
 extern "C" int restart_batch;   //!< batch at which a restart job resumed
 extern "C" bool satisfy_triggers; //!< have tally triggers been satisfied?
 extern "C" int total_gen;        //!< total number of generations simulated
 extern double total_weight;  //!< Total source weight in a batch
 extern int64_t work_per_rank;         //!< number of particles per MPI rank
+extern int64_t n_particles_batch; //!< number of particles per generation in the current batch
 
 extern const RegularMesh* entropy_mesh;
 extern const RegularMesh* ufs_mesh;
 
+extern std::vector<double> history_cost; //!< estimated cost of each history on this rank
 extern std::vector<double> k_generation;
 extern std::vector<int64_t> work_index;
 
+//! Functions called at the end of each batch, once tallies are accumulated
+extern std::vector<BatchCallback> batch_callbacks;
+
 } // namespace simulation
 
 //==============================================================================
@@ -57,6 +67,27 @@ void allocate_banks();
 //! Determine number of particles to transport per process
 void calculate_work();
 
+//! Get the number of particles per generation in a batch, which is less than
+//! the number of particles given in the settings during inactive batches when
+//! ramping up the number of particles
+//
+//! \param batch Index of the batch starting at 1
+//! \return Number of particles per generation
+int64_t particles_in_batch(int batch);
+
+//! Set the number of particles per generation in a batch and divide them among
+//! processes, resizing the banks that hold one entry per particle
+//
+//! \param batch Index of the batch starting at 1
+void set_batch_particles(int batch);
+
+#ifdef OPENMC_MPI
+//! Redistribute particles among processes in proportion to their rates
+//
+//! \param rate Number of particles transported per second by this process
+void balance_work(double rate);
+#endif
+
 //! Initialize a batch
 void initialize_batch();
 
@@ -90,7 +121,8 @@ void free_memory_simulation();
 
 //! Simulate a single particle history (and all generated secondary particles,
 //!  if enabled), from birth to death
-void transport_history_based_single_particle(Particle& p);
+//! \return Number of events executed over the history
+int64_t transport_history_based_single_particle(Particle& p);
 
 //! Simulate all particle histories using history-based parallelism
 void transport_history_based();
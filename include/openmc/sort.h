@@ -0,0 +1,99 @@
+//! \file sort.h
+//! Shared-memory parallel sorting algorithms
+
+#ifndef OPENMC_SORT_H
+#define OPENMC_SORT_H
+
+#include <algorithm> // for sort, inplace_merge
+#include <functional> // for less
+#include <iterator> // for iterator_traits
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace openmc {
+
+namespace detail {
+
+// Below this many elements, a range is sorted serially by the task that owns
+// it. Spawning tasks for smaller ranges costs more than it saves.
+constexpr std::ptrdiff_t PARALLEL_SORT_CUTOFF {4096};
+
+template<class It, class Compare>
+void parallel_sort_task(It first, It last, Compare comp)
+{
+  auto n = last - first;
+  if (n <= PARALLEL_SORT_CUTOFF) {
+    std::sort(first, last, comp);
+    return;
+  }
+
+  // Sort each half in its own task and then merge them together
+  It middle = first + n/2;
+  #pragma omp task firstprivate(first, middle, comp)
+  parallel_sort_task(first, middle, comp);
+  #pragma omp task firstprivate(middle, last, comp)
+  parallel_sort_task(middle, last, comp);
+  #pragma omp taskwait
+  std::inplace_merge(first, middle, last, comp);
+}
+
+} // namespace detail
+
+//! Sort a range of random-access iterators using all available threads
+//!
+//! The range is recursively split in half with each half sorted by a separate
+//! OpenMP task, followed by a merge. If called from within an existing
+//! parallel region or when OpenMP is not available, this falls back to a
+//! serial std::sort. Like std::sort, the ordering of equivalent elements is
+//! not preserved.
+//!
+//! \param first Iterator to the first element
+//! \param last Iterator one past the last element
+//! \param comp Comparison function object
+
+template<class It, class Compare>
+void parallel_sort(It first, It last, Compare comp)
+{
+#ifdef _OPENMP
+  if (!omp_in_parallel() && omp_get_max_threads() > 1 &&
+      last - first > detail::PARALLEL_SORT_CUTOFF) {
+    #pragma omp parallel
+    {
+      #pragma omp single nowait
+      detail::parallel_sort_task(first, last, comp);
+    }
+    return;
+  }
+#endif
+  std::sort(first, last, comp);
+}
+
+template<class It>
+void parallel_sort(It first, It last)
+{
+  using T = typename std::iterator_traits<It>::value_type;
+  parallel_sort(first, last, std::less<T>());
+}
+
+//! Sort a range of random-access iterators using the threads of the current
+//! team
+//!
+//! This must be called by one thread of an active parallel region, e.g., from
+//! within an omp single construct, while the remaining threads of the team
+//! wait at a barrier where they pick up the sorting tasks.
+//!
+//! \param first Iterator to the first element
+//! \param last Iterator one past the last element
+
+template<class It>
+void team_parallel_sort(It first, It last)
+{
+  using T = typename std::iterator_traits<It>::value_type;
+  detail::parallel_sort_task(first, last, std::less<T>());
+}
+
+} // namespace openmc
+
+#endif // OPENMC_SORT_H
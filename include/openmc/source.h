@@ -5,6 +5,7 @@
 #define OPENMC_SOURCE_H
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "pugixml.hpp"
@@ -66,13 +67,23 @@ private:
 //! Initialize source bank from file/distribution
 extern "C" void initialize_source();
 
+//! Read the source sites of this process from a source or state point file in
+//! HDF5 format or a binary source file
+//! \param[in] filename Path to the file
+void read_source_file(const std::string& filename);
+
+//! Read all sites of the source file, which are sampled uniformly in fixed
+//! source simulations, e.g. to replay a surface source
+void load_source_file();
+
 //! Sample a site from all external source distributions in proportion to their
 //! source strength
 //! \param[inout] seed Pseudorandom seed pointer
 //! \return Sampled source site
 Particle::Bank sample_external_source(uint64_t* seed);
 
-//! Sample a site from custom source library
+//! Sample a site from custom source library, using its batched function for
+//! a single site if it only has that one
 Particle::Bank sample_custom_source_library(uint64_t* seed);
 
 //! Load custom source library
@@ -81,9 +92,15 @@ void load_custom_source_library();
 //! Release custom source library
 void close_custom_source_library();
 
-//! Fill source bank at the end of a generation for dlopen based source simulation
+//! Fill source bank at the end of a generation for dlopen based source
+//! simulation. If the library defines sample_source_batch(n, seeds, sites),
+//! the sites are sampled by calling it on chunks of the bank in parallel.
 void fill_source_bank_custom_source();
 
+//! Build the acceptance grids of box spatial distributions of the external
+//! sources. This needs the geometry and the materials.
+void initialize_source_grids();
+
 void free_memory_source();
 
 } // namespace openmc
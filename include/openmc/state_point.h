@@ -2,17 +2,82 @@
 #define OPENMC_STATE_POINT_H
 
 #include <cstdint>
+#include <string>
+#include <vector>
 
 #include "hdf5.h"
 
 #include "openmc/capi.h"
+#include "openmc/particle.h"
+#include "openmc/shared_array.h"
 
 namespace openmc {
 
+//! Write a state point
+//
+//! \param filename Path of the file or nullptr for the default name
+//! \param write_source Whether to write the source bank
+//! \param background Whether the tally results and source bank may be written
+//!   on a background thread after they have been copied. This is only done
+//!   when tally results are reduced and parallel HDF5 is not used.
+void write_state_point(const char* filename, bool write_source,
+  bool background);
+
+//! Wait for a state point that is written in the background to be complete
+void wait_state_point();
+
+//! Create the HDF5 compound type of a source site
+hid_t h5banktype();
+
 void load_state_point();
+
+//! Write the full tally results in the next incremental state point
+void reset_incremental_state_points();
+
+//! Read the tally results of the state point that was restarted from
+//
+//! load_state_point() leaves the tally results in the file so that they are
+//! only read by the processes that need them, when they are accumulated. This
+//! does nothing if there are no results left to read.
+void read_tally_results_pending();
+
+//! Forget the tally results of the state point that was restarted from, e.g.
+//! when all tallies are reset
+void discard_tally_results_pending();
 void write_source_point(const char* filename);
 void write_source_bank(hid_t group_id);
+
+//! Write the sites of a bank distributed among all processes
+//
+//! \param group_id Group in which the source_bank dataset is created
+//! \param sites Sites of this process
+//! \param bank_index Index in the dataset of the first site of each process,
+//!   followed by the total number of sites
+void write_source_bank(hid_t group_id, const Particle::Bank* sites,
+  const std::vector<int64_t>& bank_index);
+
+//! Write the sites recorded on the surfaces of the surface source to
+//! surface_source.h5, or surface_source.bin in binary format
+void write_surface_source();
+
+//! Write the particles that reached the census time to census.h5, or
+//! census.bin in binary format
+void write_census();
+
+//! Write banked sites of all processes to a source file
+//
+//! \param bank Sites of this process
+//! \param description Description of the sites for the message
+//! \param name Name of the file without its extension
+void write_banked_sites(SharedArray<Particle::Bank>& bank,
+  const std::string& description, const std::string& name);
 void read_source_bank(hid_t group_id);
+
+//! Read all sites of the source bank in a group
+//
+//! \param group_id Group containing the source_bank dataset
+//! \return Source sites
+std::vector<Particle::Bank> read_source_sites(hid_t group_id);
 void write_tally_results_nr(hid_t file_id);
 void restart_set_keff();
 
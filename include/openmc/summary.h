@@ -5,12 +5,26 @@
 
 namespace openmc {
 
+//! Write summary.h5, on a background thread if settings::async_summary is set
 void write_summary();
+
+//! Rewrite the parts of summary.h5 that changed since it was written
+//
+//! Only the nuclides and the materials that changed, for instance between the
+//! simulations of a depletion calculation, are written again. The summary is
+//! written in full if it has not been written yet.
+void update_summary();
+
+//! Wait until the summary that is written in the background is complete
+void wait_summary();
+
 void write_header(hid_t file);
 void write_nuclides(hid_t file);
 void write_geometry(hid_t file);
 void write_materials(hid_t file);
 
+void free_memory_summary();
+
 }
 
 #endif // OPENMC_SUMMARY_H
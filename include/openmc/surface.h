@@ -74,6 +74,14 @@ struct BoundingBox
     return *this;
   }
 
+  //! Check whether a position lies within the box. A small tolerance is used
+  //! so that particles lying on a bounding surface are not missed.
+  inline bool contains(Position r) const {
+    return r.x >= xmin - FP_COINCIDENT && r.x <= xmax + FP_COINCIDENT &&
+           r.y >= ymin - FP_COINCIDENT && r.y <= ymax + FP_COINCIDENT &&
+           r.z >= zmin - FP_COINCIDENT && r.z <= zmax + FP_COINCIDENT;
+  }
+
 };
 
 //==============================================================================
@@ -96,6 +104,7 @@ public:
   int id_;                    //!< Unique ID
   BoundaryType bc_;                    //!< Boundary condition
   std::string name_;          //!< User-defined name
+  bool surf_source_ {false};  //!< Record crossings for a surface source?
 
   explicit Surface(pugi::xml_node surf_node);
   Surface();
@@ -178,6 +187,8 @@ public:
 
   moab::DagMC* dagmc_ptr_; //!< Pointer to DagMC instance
   int32_t dag_index_;      //!< DagMC index of surface
+  int32_t forward_cell_ {C_NONE}; //!< cell on the forward side of the surface
+  int32_t reverse_cell_ {C_NONE}; //!< cell on the reverse side of the surface
 };
 #endif
 //==============================================================================
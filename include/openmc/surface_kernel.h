@@ -0,0 +1,506 @@
+//! \file surface_kernel.h
+//! Inline surface evaluation and a compact, devirtualized surface form
+
+#ifndef OPENMC_SURFACE_KERNEL_H
+#define OPENMC_SURFACE_KERNEL_H
+
+#include <cmath>
+#include <cstdint> // for int32_t
+
+#include "openmc/constants.h"
+#include "openmc/position.h"
+#include "openmc/surface.h"
+
+namespace openmc {
+
+//==============================================================================
+// Distance and evaluation functions shared by the surface classes,
+// CompactSurface and FlatGeometry
+//==============================================================================
+
+// The template parameter indicates the axis normal to the plane.
+template<int i> inline double
+axis_aligned_plane_distance(Position r, Direction u, bool coincident, double offset)
+{
+  const double f = offset - r[i];
+  if (coincident || std::abs(f) < FP_COINCIDENT || u[i] == 0.0) return INFTY;
+  const double d = f / u[i];
+  if (d < 0.0) return INFTY;
+  return d;
+}
+
+// The template parameters indicate the axes perpendicular to the axis of the
+// cylinder.  offset1 and offset2 should correspond with i1 and i2,
+// respectively.
+template<int i1, int i2> inline double
+axis_aligned_cylinder_evaluate(Position r, double offset1,
+                               double offset2, double radius)
+{
+  const double r1 = r[i1] - offset1;
+  const double r2 = r[i2] - offset2;
+  return r1*r1 + r2*r2 - radius*radius;
+}
+
+// The first template parameter indicates which axis the cylinder is aligned to.
+// The other two parameters indicate the other two axes.  offset1 and offset2
+// should correspond with i2 and i3, respectively.
+template<int i1, int i2, int i3> inline double
+axis_aligned_cylinder_distance(Position r, Direction u,
+     bool coincident, double offset1, double offset2, double radius)
+{
+  const double a = 1.0 - u[i1]*u[i1];  // u^2 + v^2
+  if (a == 0.0) return INFTY;
+
+  const double r2 = r[i2] - offset1;
+  const double r3 = r[i3] - offset2;
+  const double k = r2 * u[i2] + r3 * u[i3];
+  const double c = r2*r2 + r3*r3 - radius*radius;
+  const double quad = k*k - a*c;
+
+  if (quad < 0.0) {
+    // No intersection with cylinder.
+    return INFTY;
+
+  } else if (coincident || std::abs(c) < FP_COINCIDENT) {
+    // Particle is on the cylinder, thus one distance is positive/negative
+    // and the other is zero. The sign of k determines if we are facing in or
+    // out.
+    if (k >= 0.0) {
+      return INFTY;
+    } else {
+      return (-k + sqrt(quad)) / a;
+    }
+
+  } else if (c < 0.0) {
+    // Particle is inside the cylinder, thus one distance must be negative
+    // and one must be positive. The positive distance will be the one with
+    // negative sign on sqrt(quad).
+    return (-k + sqrt(quad)) / a;
+
+  } else {
+    // Particle is outside the cylinder, thus both distances are either
+    // positive or negative. If positive, the smaller distance is the one
+    // with positive sign on sqrt(quad).
+    const double d = (-k - sqrt(quad)) / a;
+    if (d < 0.0) return INFTY;
+    return d;
+  }
+}
+
+// Distance to a sphere centered at (x0, y0, z0)
+inline double
+sphere_distance(Position r, Direction u, bool coincident, double x0,
+  double y0, double z0, double radius)
+{
+  const double x = r.x - x0;
+  const double y = r.y - y0;
+  const double z = r.z - z0;
+  const double k = x*u.x + y*u.y + z*u.z;
+  const double c = x*x + y*y + z*z - radius*radius;
+  const double quad = k*k - c;
+
+  if (quad < 0.0) {
+    // No intersection with sphere.
+    return INFTY;
+
+  } else if (coincident || std::abs(c) < FP_COINCIDENT) {
+    // Particle is on the sphere, thus one distance is positive/negative and
+    // the other is zero. The sign of k determines if we are facing in or out.
+    if (k >= 0.0) {
+      return INFTY;
+    } else {
+      return -k + sqrt(quad);
+    }
+
+  } else if (c < 0.0) {
+    // Particle is inside the sphere, thus one distance must be negative and
+    // one must be positive. The positive distance will be the one with
+    // negative sign on sqrt(quad)
+    return -k + sqrt(quad);
+
+  } else {
+    // Particle is outside the sphere, thus both distances are either positive
+    // or negative. If positive, the smaller distance is the one with positive
+    // sign on sqrt(quad).
+    const double d = -k - sqrt(quad);
+    if (d < 0.0) return INFTY;
+    return d;
+  }
+}
+
+// Distance to the plane A*x + B*y + C*z = D
+inline double
+plane_distance(Position r, Direction u, bool coincident, double A, double B,
+  double C, double D)
+{
+  const double f = A*r.x + B*r.y + C*r.z - D;
+  const double projection = A*u.x + B*u.y + C*u.z;
+  if (coincident || std::abs(f) < FP_COINCIDENT || projection == 0.0) {
+    return INFTY;
+  } else {
+    const double d = -f / projection;
+    if (d < 0.0) return INFTY;
+    return d;
+  }
+}
+
+// The first template parameter indicates which axis the cylinder is aligned to.
+// The other two parameters indicate the other two axes.  offset1 and offset2
+// should correspond with i2 and i3, respectively.
+template<int i1, int i2, int i3> inline Direction
+axis_aligned_cylinder_normal(Position r, double offset1, double offset2)
+{
+  Direction u;
+  u[i2] = 2.0 * (r[i2] - offset1);
+  u[i3] = 2.0 * (r[i3] - offset2);
+  u[i1] = 0.0;
+  return u;
+}
+
+// The first template parameter indicates which axis the cone is aligned to.
+// The other two parameters indicate the other two axes.  offset1, offset2,
+// and offset3 should correspond with i1, i2, and i3, respectively.
+template<int i1, int i2, int i3> inline double
+axis_aligned_cone_evaluate(Position r, double offset1,
+                           double offset2, double offset3, double radius_sq)
+{
+  const double r1 = r[i1] - offset1;
+  const double r2 = r[i2] - offset2;
+  const double r3 = r[i3] - offset3;
+  return r2*r2 + r3*r3 - radius_sq*r1*r1;
+}
+
+// The first template parameter indicates which axis the cone is aligned to.
+// The other two parameters indicate the other two axes.  offset1, offset2,
+// and offset3 should correspond with i1, i2, and i3, respectively.
+template<int i1, int i2, int i3> inline double
+axis_aligned_cone_distance(Position r, Direction u,
+     bool coincident, double offset1, double offset2, double offset3,
+     double radius_sq)
+{
+  const double r1 = r[i1] - offset1;
+  const double r2 = r[i2] - offset2;
+  const double r3 = r[i3] - offset3;
+  const double a = u[i2]*u[i2] + u[i3]*u[i3]
+                   - radius_sq*u[i1]*u[i1];
+  const double k = r2*u[i2] + r3*u[i3] - radius_sq*r1*u[i1];
+  const double c = r2*r2 + r3*r3 - radius_sq*r1*r1;
+  double quad = k*k - a*c;
+
+  double d;
+
+  if (quad < 0.0) {
+    // No intersection with cone.
+    return INFTY;
+
+  } else if (coincident || std::abs(c) < FP_COINCIDENT) {
+    // Particle is on the cone, thus one distance is positive/negative
+    // and the other is zero. The sign of k determines if we are facing in or
+    // out.
+    if (k >= 0.0) {
+      d = (-k - sqrt(quad)) / a;
+    } else {
+      d = (-k + sqrt(quad)) / a;
+    }
+
+  } else {
+    // Calculate both solutions to the quadratic.
+    quad = sqrt(quad);
+    d = (-k - quad) / a;
+    const double b = (-k + quad) / a;
+
+    // Determine the smallest positive solution.
+    if (d < 0.0) {
+      if (b > 0.0) d = b;
+    } else {
+      if (b > 0.0) {
+        if (b < d) d = b;
+      }
+    }
+  }
+
+  // If the distance was negative, set boundary distance to infinity.
+  if (d <= 0.0) return INFTY;
+  return d;
+}
+
+// The first template parameter indicates which axis the cone is aligned to.
+// The other two parameters indicate the other two axes.  offset1, offset2,
+// and offset3 should correspond with i1, i2, and i3, respectively.
+template<int i1, int i2, int i3> inline Direction
+axis_aligned_cone_normal(Position r, double offset1, double offset2,
+                         double offset3, double radius_sq)
+{
+  Direction u;
+  u[i1] = -2.0 * radius_sq * (r[i1] - offset1);
+  u[i2] = 2.0 * (r[i2] - offset2);
+  u[i3] = 2.0 * (r[i3] - offset3);
+  return u;
+}
+
+// Evaluate the equation of a quadric surface
+inline double
+quadric_evaluate(Position r, double A, double B, double C, double D, double E,
+  double F, double G, double H, double J, double K)
+{
+  const double x = r.x;
+  const double y = r.y;
+  const double z = r.z;
+  return x*(A*x + D*y + G) +
+         y*(B*y + E*z + H) +
+         z*(C*z + F*x + J) + K;
+}
+
+// Distance to the quadric surface
+// A*x^2 + B*y^2 + C*z^2 + D*x*y + E*y*z + F*x*z + G*x + H*y + J*z + K = 0
+inline double
+quadric_distance(Position r, Direction ang, bool coincident, double A,
+  double B, double C, double D, double E, double F, double G, double H,
+  double J, double K)
+{
+  const double &x = r.x;
+  const double &y = r.y;
+  const double &z = r.z;
+  const double &u = ang.x;
+  const double &v = ang.y;
+  const double &w = ang.z;
+
+  const double a = A*u*u + B*v*v + C*w*w + D*u*v + E*v*w + F*u*w;
+  const double k = A*u*x + B*v*y + C*w*z + 0.5*(D*(u*y + v*x)
+                   + E*(v*z + w*y) + F*(w*x + u*z) + G*u + H*v + J*w);
+  const double c = A*x*x + B*y*y + C*z*z + D*x*y + E*y*z +  F*x*z + G*x
+                   + H*y + J*z + K;
+  double quad = k*k - a*c;
+
+  double d;
+
+  if (quad < 0.0) {
+    // No intersection with surface.
+    return INFTY;
+
+  } else if (coincident || std::abs(c) < FP_COINCIDENT) {
+    // Particle is on the surface, thus one distance is positive/negative and
+    // the other is zero. The sign of k determines which distance is zero and
+    // which is not.
+    if (k >= 0.0) {
+      d = (-k - sqrt(quad)) / a;
+    } else {
+      d = (-k + sqrt(quad)) / a;
+    }
+
+  } else {
+    // Calculate both solutions to the quadratic.
+    quad = sqrt(quad);
+    d = (-k - quad) / a;
+    double b = (-k + quad) / a;
+
+    // Determine the smallest positive solution.
+    if (d < 0.0) {
+      if (b > 0.0) d = b;
+    } else {
+      if (b > 0.0) {
+        if (b < d) d = b;
+      }
+    }
+  }
+
+  // If the distance was negative, set boundary distance to infinity.
+  if (d <= 0.0) return INFTY;
+  return d;
+}
+
+// Normal to a quadric surface, whose constant term does not enter
+inline Direction
+quadric_normal(Position r, double A, double B, double C, double D, double E,
+  double F, double G, double H, double J)
+{
+  const double &x = r.x;
+  const double &y = r.y;
+  const double &z = r.z;
+  return {2.0*A*x + D*y + F*z + G,
+          2.0*B*y + D*x + E*z + H,
+          2.0*C*z + E*y + F*x + J};
+}
+
+//==============================================================================
+//! Positions and directions of a group of particles, stored as a structure of
+//! arrays so that distances can be computed for all of them with SIMD
+//==============================================================================
+
+struct RayBatch {
+  static constexpr int SIZE {64}; //!< maximum number of rays
+
+  int n {0};                      //!< number of rays
+  double x[SIZE], y[SIZE], z[SIZE];
+  double u[SIZE], v[SIZE], w[SIZE];
+  int32_t on_surface[SIZE];       //!< signed index of surface each ray is on
+};
+
+//==============================================================================
+//! A copy of the coefficients of a surface that can be evaluated without
+//! virtual function calls.
+//
+//! Cells store one of these for each surface in their region so that the
+//! common surface types are evaluated by a switch over a contiguous array
+//! rather than through the surface's vtable. Surface types without a compact
+//! form are evaluated through the full surface object.
+//==============================================================================
+
+struct CompactSurface {
+  enum class Kind : int32_t {
+    X_PLANE, Y_PLANE, Z_PLANE, PLANE,
+    X_CYLINDER, Y_CYLINDER, Z_CYLINDER, SPHERE,
+    OTHER
+  };
+
+  //! Make the compact form of a surface
+  //
+  //! \param i_surf Index in model::surfaces
+  explicit CompactSurface(int32_t i_surf);
+
+  //! Evaluate the surface equation, equivalent to Surface::evaluate
+  double evaluate(Position r) const
+  {
+    switch (kind) {
+    case Kind::X_PLANE: return r.x - c[0];
+    case Kind::Y_PLANE: return r.y - c[0];
+    case Kind::Z_PLANE: return r.z - c[0];
+    case Kind::PLANE: return c[0]*r.x + c[1]*r.y + c[2]*r.z - c[3];
+    case Kind::X_CYLINDER:
+      return axis_aligned_cylinder_evaluate<1, 2>(r, c[0], c[1], c[2]);
+    case Kind::Y_CYLINDER:
+      return axis_aligned_cylinder_evaluate<0, 2>(r, c[0], c[1], c[2]);
+    case Kind::Z_CYLINDER:
+      return axis_aligned_cylinder_evaluate<0, 1>(r, c[0], c[1], c[2]);
+    case Kind::SPHERE:
+      {
+        const double x = r.x - c[0];
+        const double y = r.y - c[1];
+        const double z = r.z - c[2];
+        return x*x + y*y + z*z - c[3]*c[3];
+      }
+    default:
+      return model::surfaces[index]->evaluate(r);
+    }
+  }
+
+  //! Determine the sense of a point, equivalent to Surface::sense
+  bool sense(Position r, Direction u) const
+  {
+    if (kind == Kind::OTHER) return model::surfaces[index]->sense(r, u);
+    const double f = evaluate(r);
+
+    // Points coincident with the surface are resolved using the surface normal
+    if (std::abs(f) < FP_COINCIDENT) return model::surfaces[index]->sense(r, u);
+    return f > 0.0;
+  }
+
+  //! Compute the distance to the surface, equivalent to Surface::distance
+  double distance(Position r, Direction u, bool coincident) const
+  {
+    switch (kind) {
+    case Kind::X_PLANE:
+      return axis_aligned_plane_distance<0>(r, u, coincident, c[0]);
+    case Kind::Y_PLANE:
+      return axis_aligned_plane_distance<1>(r, u, coincident, c[0]);
+    case Kind::Z_PLANE:
+      return axis_aligned_plane_distance<2>(r, u, coincident, c[0]);
+    case Kind::PLANE:
+      return plane_distance(r, u, coincident, c[0], c[1], c[2], c[3]);
+    case Kind::X_CYLINDER:
+      return axis_aligned_cylinder_distance<0, 1, 2>(r, u, coincident, c[0],
+        c[1], c[2]);
+    case Kind::Y_CYLINDER:
+      return axis_aligned_cylinder_distance<1, 0, 2>(r, u, coincident, c[0],
+        c[1], c[2]);
+    case Kind::Z_CYLINDER:
+      return axis_aligned_cylinder_distance<2, 0, 1>(r, u, coincident, c[0],
+        c[1], c[2]);
+    case Kind::SPHERE:
+      return sphere_distance(r, u, coincident, c[0], c[1], c[2], c[3]);
+    default:
+      return model::surfaces[index]->distance(r, u, coincident);
+    }
+  }
+
+  //! Compute the distance to the surface for a batch of rays
+  //
+  //! \param rays Positions and directions of the rays
+  //! \param[out] d Distance for each ray
+  void distance(const RayBatch& rays, double* d) const
+  {
+    switch (kind) {
+    case Kind::X_PLANE:
+      each_ray(rays, d, [this](Position r, Direction u, bool coincident) {
+        return axis_aligned_plane_distance<0>(r, u, coincident, c[0]);
+      });
+      break;
+    case Kind::Y_PLANE:
+      each_ray(rays, d, [this](Position r, Direction u, bool coincident) {
+        return axis_aligned_plane_distance<1>(r, u, coincident, c[0]);
+      });
+      break;
+    case Kind::Z_PLANE:
+      each_ray(rays, d, [this](Position r, Direction u, bool coincident) {
+        return axis_aligned_plane_distance<2>(r, u, coincident, c[0]);
+      });
+      break;
+    case Kind::X_CYLINDER:
+      each_ray(rays, d, [this](Position r, Direction u, bool coincident) {
+        return axis_aligned_cylinder_distance<0, 1, 2>(r, u, coincident, c[0],
+          c[1], c[2]);
+      });
+      break;
+    case Kind::Y_CYLINDER:
+      each_ray(rays, d, [this](Position r, Direction u, bool coincident) {
+        return axis_aligned_cylinder_distance<1, 0, 2>(r, u, coincident, c[0],
+          c[1], c[2]);
+      });
+      break;
+    case Kind::Z_CYLINDER:
+      each_ray(rays, d, [this](Position r, Direction u, bool coincident) {
+        return axis_aligned_cylinder_distance<2, 0, 1>(r, u, coincident, c[0],
+          c[1], c[2]);
+      });
+      break;
+    case Kind::PLANE:
+      each_ray(rays, d, [this](Position r, Direction u, bool coincident) {
+        return plane_distance(r, u, coincident, c[0], c[1], c[2], c[3]);
+      });
+      break;
+    case Kind::SPHERE:
+      each_ray(rays, d, [this](Position r, Direction u, bool coincident) {
+        return sphere_distance(r, u, coincident, c[0], c[1], c[2], c[3]);
+      });
+      break;
+    default:
+      // Remaining surfaces are evaluated one ray at a time
+      for (int k = 0; k < rays.n; ++k) {
+        d[k] = distance({rays.x[k], rays.y[k], rays.z[k]},
+          {rays.u[k], rays.v[k], rays.w[k]},
+          std::abs(rays.on_surface[k]) == index + 1);
+      }
+    }
+  }
+
+  Kind kind;     //!< type of surface
+  int32_t index; //!< index in model::surfaces
+  double c[4];   //!< surface coefficients
+
+private:
+  //! Apply a distance function to every ray of a batch in a SIMD loop
+  template<class F>
+  void each_ray(const RayBatch& rays, double* d, F f) const
+  {
+    #pragma omp simd
+    for (int k = 0; k < rays.n; ++k) {
+      d[k] = f({rays.x[k], rays.y[k], rays.z[k]},
+        {rays.u[k], rays.v[k], rays.w[k]},
+        std::abs(rays.on_surface[k]) == index + 1);
+    }
+  }
+};
+
+} // namespace openmc
+
+#endif // OPENMC_SURFACE_KERNEL_H
@@ -39,6 +39,31 @@ struct TallyDerivative {
 //! Read tally derivatives from a tallies.xml file
 void read_tally_derivatives(pugi::xml_node node);
 
+//! Number of scores whose derivatives are computed once per event: total,
+//! scatter, absorption, fission and nu-fission
+constexpr int N_DERIV_SCORES {5};
+
+//! Compute the logarithmic derivatives of the reaction rates of an event with
+//! respect to every derivative variable at once.
+//
+//! For collision estimators the rates are those of the whole material, and for
+//! analog estimators those of the event nuclide. Multipole derivatives of each
+//! nuclide are evaluated once and shared by all scores and derivatives, and
+//! apply_derivative_to_score() then only looks the rates up until
+//! clear_derivative_rates() is called.
+//
+//! \param p The particle being tracked
+//! \param estimator Estimator of the tallies scored for the event
+void prepare_derivative_rates(Particle& p, TallyEstimator estimator);
+
+//! Discard the rates computed by prepare_derivative_rates()
+//
+//! \param p The particle being tracked
+inline void clear_derivative_rates(Particle& p)
+{
+  p.deriv_rates_estimator_ = TallyEstimator::TRACKLENGTH;
+}
+
 //! Scale the given score by its logarithmic derivative
 
 void
@@ -72,6 +97,7 @@ namespace openmc {
 namespace model {
 extern std::vector<TallyDerivative> tally_derivs;
 extern std::unordered_map<int, int> tally_deriv_map;
+extern bool temperature_derivs; //!< Is any derivative w.r.t. temperature?
 } // namespace model
 
 } // namespace openmc
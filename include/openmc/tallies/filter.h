@@ -71,6 +71,10 @@ public:
   virtual void
   get_all_bins(const Particle& p, TallyEstimator estimator, FilterMatch& match) const = 0;
 
+  //! Largest number of bins usually matched by one event, which is reserved
+  //! in the matches of each particle so that scoring does not allocate
+  virtual int max_bins_per_event() const { return 1; }
+
   //! Writes data describing this filter to an HDF5 statepoint group.
   virtual void
   to_statepoint(hid_t filter_group) const
@@ -1,14 +1,87 @@
 #ifndef OPENMC_TALLIES_FILTER_ENERGY_H
 #define OPENMC_TALLIES_FILTER_ENERGY_H
 
+#include <algorithm> // for max, min
+#include <cmath>     // for log
 #include <vector>
 
 #include <gsl/gsl>
 
+#include "openmc/search.h"
 #include "openmc/tallies/filter.h"
 
 namespace openmc {
 
+//==============================================================================
+//! Locates energies among increasing bin edges without a binary search
+//
+//! The bin is computed arithmetically when the edges are equally spaced in
+//! energy or in lethargy. Other edges are indexed by cells equally spaced in
+//! lethargy, as the union energy grid of nuclides, and only the few edges in
+//! the cell of an energy are compared. Either way the result is refined
+//! against the edges, so it is the same as that of lower_bound_index.
+//==============================================================================
+
+class EnergyBinIndex
+{
+public:
+  //! Build the index
+  //
+  //! \param edges Strictly increasing bin edges, of which there are at least
+  //!   two
+  void build(const std::vector<double>& edges);
+
+  //! Find the bin containing an energy, as lower_bound_index
+  //
+  //! \param edges Bin edges the index was built from
+  //! \param E Energy between the first and last edges
+  //! \return Index of the bin
+  int find(const std::vector<double>& edges, double E) const
+  {
+    int n_bins = edges.size() - 1;
+    int i;
+    switch (spacing_) {
+    case Spacing::UNIFORM:
+      i = static_cast<int>((E - origin_)*inv_width_);
+      break;
+    case Spacing::LETHARGY:
+      i = static_cast<int>((std::log(E) - origin_)*inv_width_);
+      break;
+    case Spacing::HASHED:
+      if (E <= edges[first_]) {
+        i = first_ - 1;
+      } else {
+        int k = static_cast<int>((std::log(E) - origin_)*inv_width_);
+        k = std::max(0, std::min(k, static_cast<int>(cell_bin_.size()) - 1));
+        i = cell_bin_[k];
+      }
+      break;
+    default:
+      return lower_bound_index(edges.begin(), edges.end(), E);
+    }
+    i = std::max(0, std::min(i, n_bins - 1));
+
+    // Bins include their upper edge, and the first bin its lower edge too
+    while (i < n_bins - 1 && E > edges[i + 1]) ++i;
+    while (i > 0 && E <= edges[i]) --i;
+    return i;
+  }
+
+private:
+  enum class Spacing {
+    UNIFORM,  //!< Equal widths in energy
+    LETHARGY, //!< Equal widths in lethargy
+    HASHED,   //!< Arbitrary, indexed by cells equal in lethargy
+    SEARCH    //!< Without positive edges to index lethargy from
+  };
+
+  Spacing spacing_ {Spacing::SEARCH};
+  double origin_;    //!< First edge of the bins or cells, or its logarithm
+  double inv_width_; //!< Inverse width of the bins or cells
+  int first_ {0};    //!< First positive edge, where the cells start
+  std::vector<int> cell_bin_; //!< Bin containing the start of each cell
+};
+
 //==============================================================================
 //! Bins the incident neutron energy.
 //==============================================================================
@@ -43,12 +116,21 @@ public:
 
   bool matches_transport_groups() const { return matches_transport_groups_; }
 
+  //! Find the bin containing an energy
+  //
+  //! \param E Energy within the bins
+  //! \return Index of the bin
+  int find_bin(double E) const { return index_.find(bins_, E); }
+
 protected:
   //----------------------------------------------------------------------------
   // Data members
 
   std::vector<double> bins_;
 
+  //! Index of the bins for locating energies
+  EnergyBinIndex index_;
+
   //! True if transport group number can be used directly to get bin number
   bool matches_transport_groups_ {false};
 };
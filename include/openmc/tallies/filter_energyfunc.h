@@ -4,6 +4,7 @@
 #include <vector>
 
 #include "openmc/tallies/filter.h"
+#include "openmc/tallies/filter_energy.h"
 
 namespace openmc {
 
@@ -56,6 +57,9 @@ private:
 
   //! Interpolant values.
   std::vector<double> y_;
+
+  //! Index of the interpolation grid for locating energies
+  EnergyBinIndex index_;
 };
 
 } // namespace openmc
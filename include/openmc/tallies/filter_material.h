@@ -1,12 +1,13 @@
 #ifndef OPENMC_TALLIES_FILTER_MATERIAL_H
 #define OPENMC_TALLIES_FILTER_MATERIAL_H
 
+#include <cstddef> // for size_t
 #include <cstdint>
-#include <unordered_map>
 #include <vector>
 
 #include <gsl/gsl>
 
+#include "openmc/constants.h"
 #include "openmc/tallies/filter.h"
 
 namespace openmc {
@@ -44,6 +45,16 @@ public:
 
   const std::vector<int32_t>& materials() const { return materials_; }
 
+  //! Find the filter bin of a material
+  //
+  //! \param index Index of the material, which may be negative
+  //! \return Filter bin, or C_NONE if the material is not binned
+  int find_bin(int32_t index) const
+  {
+    return (static_cast<std::size_t>(index) < map_.size()) ? map_[index] :
+      C_NONE;
+  }
+
   void set_materials(gsl::span<const int32_t> materials);
 
 private:
@@ -53,8 +64,9 @@ private:
   //! The indices of the materials binned by this filter.
   std::vector<int32_t> materials_;
 
-  //! A map from material indices to filter bin indices.
-  std::unordered_map<int32_t, int> map_;
+  //! Filter bin of each material index up to the largest binned one, or C_NONE,
+  //! which avoids hashing when scoring
+  std::vector<int> map_;
 };
 
 } // namespace openmc
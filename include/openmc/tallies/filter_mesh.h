@@ -43,6 +43,14 @@ public:
   virtual void set_mesh(int32_t mesh);
 
 protected:
+  //----------------------------------------------------------------------------
+  // Methods
+
+  //! Find the bins crossed by a track and gather the surfaces crossed by the
+  //! tracks since the last collision for a mesh surface filter on the mesh
+  void bins_and_surfaces_crossed(const Particle& p,
+    Particle::MeshTrack& track) const;
+
   //----------------------------------------------------------------------------
   // Data members
 
@@ -33,6 +33,8 @@ public:
   void get_all_bins(const Particle& p, TallyEstimator estimator, FilterMatch& match)
   const override;
 
+  int max_bins_per_event() const override { return n_bins_; }
+
   void to_statepoint(hid_t filter_group) const override;
 
   std::string text_label(int bin) const override;
@@ -1,12 +1,13 @@
 #ifndef OPENMC_TALLIES_FILTER_SURFACE_H
 #define OPENMC_TALLIES_FILTER_SURFACE_H
 
+#include <cstddef> // for size_t
 #include <cstdint>
-#include <unordered_map>
 #include <vector>
 
 #include <gsl/gsl>
 
+#include "openmc/constants.h"
 #include "openmc/tallies/filter.h"
 
 namespace openmc {
@@ -40,6 +41,18 @@ public:
   //----------------------------------------------------------------------------
   // Accessors
 
+  //! Find the filter bin of a surface
+  //
+  //! \param index Index of the surface, which may be negative
+  //! \return Filter bin, or C_NONE if the surface is not binned
+  int find_bin(int32_t index) const
+  {
+    return (static_cast<std::size_t>(index) < map_.size()) ? map_[index] :
+      C_NONE;
+  }
+
+  const std::vector<int32_t>& surfaces() const { return surfaces_; }
+
   void set_surfaces(gsl::span<int32_t> surfaces);
 
 private:
@@ -49,8 +62,9 @@ private:
   //! The indices of the surfaces binned by this filter.
   std::vector<int32_t> surfaces_;
 
-  //! A map from surface indices to filter bin indices.
-  std::unordered_map<int32_t, int> map_;
+  //! Filter bin of each surface index up to the largest binned one, or C_NONE,
+  //! which avoids hashing when scoring
+  std::vector<int> map_;
 };
 
 } // namespace openmc
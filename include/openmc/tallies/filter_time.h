@@ -0,0 +1,58 @@
+#ifndef OPENMC_TALLIES_FILTER_TIME_H
+#define OPENMC_TALLIES_FILTER_TIME_H
+
+#include <vector>
+
+#include <gsl/gsl>
+
+#include "openmc/tallies/filter.h"
+
+namespace openmc {
+
+//==============================================================================
+//! Bins the time of events since the birth of the history.
+//!
+//! Collisions and surface crossings are binned by the time at which they
+//! happen. A track can span several bins, so track-length scores are divided
+//! among the bins in proportion to the time spent in each.
+//==============================================================================
+
+class TimeFilter : public Filter
+{
+public:
+  //----------------------------------------------------------------------------
+  // Constructors, destructors
+
+  ~TimeFilter() = default;
+
+  //----------------------------------------------------------------------------
+  // Methods
+
+  std::string type() const override {return "time";}
+
+  void from_xml(pugi::xml_node node) override;
+
+  void get_all_bins(const Particle& p, TallyEstimator estimator, FilterMatch& match)
+  const override;
+
+  int max_bins_per_event() const override { return n_bins_; }
+
+  void to_statepoint(hid_t filter_group) const override;
+
+  std::string text_label(int bin) const override;
+
+  //----------------------------------------------------------------------------
+  // Accessors
+
+  const std::vector<double>& bins() const { return bins_; }
+  void set_bins(gsl::span<const double> bins);
+
+private:
+  //----------------------------------------------------------------------------
+  // Data members
+
+  std::vector<double> bins_; //!< Bin boundaries in [s]
+};
+
+} // namespace openmc
+#endif // OPENMC_TALLIES_FILTER_TIME_H
@@ -1,12 +1,13 @@
 #ifndef OPENMC_TALLIES_FILTER_UNIVERSE_H
 #define OPENMC_TALLIES_FILTER_UNIVERSE_H
 
+#include <cstddef> // for size_t
 #include <cstdint>
-#include <unordered_map>
 #include <vector>
 
 #include <gsl/gsl>
 
+#include "openmc/constants.h"
 #include "openmc/tallies/filter.h"
 
 namespace openmc {
@@ -33,6 +34,8 @@ public:
   void get_all_bins(const Particle& p, TallyEstimator estimator, FilterMatch& match)
   const override;
 
+  int max_bins_per_event() const override;
+
   void to_statepoint(hid_t filter_group) const override;
 
   std::string text_label(int bin) const override;
@@ -40,6 +43,16 @@ public:
   //----------------------------------------------------------------------------
   // Accessors
 
+  //! Find the filter bin of a universe
+  //
+  //! \param index Index of the universe, which may be negative
+  //! \return Filter bin, or C_NONE if the universe is not binned
+  int find_bin(int32_t index) const
+  {
+    return (static_cast<std::size_t>(index) < map_.size()) ? map_[index] :
+      C_NONE;
+  }
+
   void set_universes(gsl::span<int32_t> universes);
 
 private:
@@ -49,8 +62,9 @@ private:
   //! The indices of the universes binned by this filter.
   std::vector<int32_t> universes_;
 
-  //! A map from universe indices to filter bin indices.
-  std::unordered_map<int32_t, int> map_;
+  //! Filter bin of each universe index up to the largest binned one, or C_NONE,
+  //! which avoids hashing when scoring
+  std::vector<int> map_;
 };
 
 } // namespace openmc
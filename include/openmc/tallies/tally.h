@@ -2,6 +2,10 @@
 #define OPENMC_TALLIES_TALLY_H
 
 #include "openmc/constants.h"
+#include "openmc/message_passing.h"
+#include "openmc/openmp_interface.h"
+#include "openmc/particle.h"
+#include "openmc/surface.h"
 #include "openmc/tallies/filter.h"
 #include "openmc/tallies/trigger.h"
 
@@ -10,6 +14,7 @@
 #include "xtensor/xfixed.hpp"
 #include "xtensor/xtensor.hpp"
 
+#include <array>
 #include <memory> // for unique_ptr
 #include <unordered_map>
 #include <string>
@@ -17,6 +22,25 @@
 
 namespace openmc {
 
+//! Function computing one reaction rate from a tracklength or collision
+//! estimate of the flux, given the particle, the index of the nuclide (-1 for
+//! the total material), its atom density, and the flux
+using ScoreKernel = double (*)(const Particle& p, int i_nuclide,
+  double atom_density, double flux);
+
+//==============================================================================
+//! Measured cost of scoring a tally, collected when tally profiling is on
+//==============================================================================
+
+struct TallyProfile {
+  int64_t n_events {0};     //!< Number of events the tally was considered for
+  double filter_time {0.0}; //!< Time spent matching filter bins in [s]
+  int64_t n_bins {0};       //!< Number of filter bin combinations scored
+  int64_t n_updates {0};    //!< Number of scores added to results
+
+  TallyProfile& operator+=(const TallyProfile& other);
+};
+
 //==============================================================================
 //! A user-specified flux-weighted (or current) measurement.
 //==============================================================================
@@ -72,9 +96,197 @@ public:
 
   void accumulate();
 
+  //! Compute the mean and standard deviation of the mean of each bin from the
+  //! accumulated sums into statistics_
+  void compute_statistics();
+
+  //! Find the largest standard deviation and relative error of the mean of
+  //! each score among the bins owned by this process, as checked by triggers
+  //
+  //! These are found while the realization is accumulated in batches where
+  //! the triggers are due, so this only sweeps over the sums when they are
+  //! out of date. The tally must have at least two realizations.
+  void update_max_uncertainty();
+
+  //! Largest standard deviation of the mean of each score
+  const std::vector<double>& max_std_dev() const { return max_std_dev_; }
+
+  //! Largest relative error of the mean of each score
+  const std::vector<double>& max_rel_err() const { return max_rel_err_; }
+
+  //! Add a score to a bin of the current realization
+  //
+  //! The score is added to the buffer of the calling thread if the tally has
+  //! thread-private buffers and atomically to values_ otherwise. Scores of
+  //! decomposed tallies for bins owned by other processes are collected in the
+  //! buffer of the calling thread until they are sent to their owner.
+  //! \param filter_index Index of the combination of filter bins
+  //! \param score_index Index of the score
+  //! \param score Value to add
+  void add_score(int filter_index, int score_index, double score)
+  {
+    if (!thread_profiles_.empty()) ++thread_profiles_[thread_index()].n_updates;
+
+    if (history_) {
+      history_values_[thread_index()][sparse_key(filter_index, score_index)]
+        += score;
+    } else if (!thread_results_.empty()) {
+      thread_results_[thread_index()](filter_index, score_index) += score;
+    } else if (sparse_) {
+      sparse_values_[thread_index()][sparse_key(filter_index, score_index)]
+        += score;
+    } else if (decomposed()) {
+      if (filter_index >= owned_begin() && filter_index < owned_end()) {
+        #pragma omp atomic
+        values_(filter_index - owned_begin(), score_index) += score;
+      } else {
+        auto& values {remote_values_[thread_index()]};
+        values[sparse_key(filter_index, score_index)] += score;
+        if (values.size() >= MAX_REMOTE_VALUES) flush_remote_values();
+      }
+    } else {
+      #pragma omp atomic
+      values_(filter_index, score_index) += score;
+    }
+  }
+
+  //! Add a score weighted by each moment of a functional expansion
+  //
+  //! \param filter_index Index of the combination of filter bins with the
+  //!   first moment of the expansion
+  //! \param stride Stride of the expansion filter
+  //! \param score_index Index of the score
+  //! \param moments Weight of each moment
+  //! \param score Value to add before weighting
+  void add_moments(int filter_index, int stride, int score_index,
+    const std::vector<double>& moments, double score)
+  {
+    int n = moments.size();
+    if (!thread_profiles_.empty()) {
+      thread_profiles_[thread_index()].n_updates += n;
+    }
+
+    if (!thread_results_.empty()) {
+      // Moments in a private buffer are contiguous except for the stride
+      auto& buffer {thread_results_[thread_index()]};
+      double* values = &buffer(filter_index, score_index);
+      int step = stride * buffer.shape()[1];
+      #pragma omp simd
+      for (int k = 0; k < n; ++k) {
+        values[k*step] += score * moments[k];
+      }
+    } else if (history_ || sparse_ || decomposed()) {
+      for (int k = 0; k < n; ++k) {
+        add_score(filter_index + k*stride, score_index, score * moments[k]);
+      }
+    } else {
+      int step = stride * values_.shape()[1];
+      double* values = &values_(filter_index, score_index);
+      for (int k = 0; k < n; ++k) {
+        #pragma omp atomic
+        values[k*step] += score * moments[k];
+      }
+    }
+  }
+
+  //! Add the scores in the thread-private buffers to values_ and clear them
+  void reduce_thread_results();
+
+  //! Move the scores of a decomposed tally for bins owned by other processes
+  //! from the buffer of the calling thread to the shared remote_sums_
+  void flush_remote_values();
+
+  //! Add the scores of the history that the calling thread just finished to
+  //! the sums and sums of squares of a tally with history statistics
+  //
+  //! \param norm Normalization of the scores of one history
+  void accumulate_history(double norm);
+
+  //! Get a result of a bin for either dense or sparse storage
+  //
+  //! For decomposed tallies, only the bins owned by this process are available.
+  //! \param filter_index Index of the combination of filter bins
+  //! \param score_index Index of the score
+  //! \param result Which result to get
+  //! \return The result, which is zero for bins of a sparse tally that have
+  //!   never been scored
+  double result(int filter_index, int score_index, TallyResult result) const;
+
+  //! Sums and sums of squares of the scored bins of a sparse tally, keyed by
+  //! the index the bin would have in a flattened results array
+  const std::unordered_map<int64_t, std::array<double, 2>>&
+  sparse_results() const { return sparse_results_; }
+
+  //! Write the sums and sums of squares of a sparse tally to a statepoint
+  void write_sparse_results(hid_t group) const;
+
+  //! Read the sums and sums of squares of a sparse tally from a statepoint
+  void read_sparse_results(hid_t group);
+
+  //! Whether the combinations of filter bins are divided among processes
+  bool decomposed() const { return !owned_index_.empty(); }
+
+  //! First combination of filter bins owned by this process
+  int32_t owned_begin() const
+  {
+    return owned_index_.empty() ? 0 : owned_index_[mpi::rank];
+  }
+
+  //! One past the last combination of filter bins owned by this process
+  int32_t owned_end() const
+  {
+    return owned_index_.empty() ? n_filter_bins_ : owned_index_[mpi::rank + 1];
+  }
+
+  //! Write the sums and sums of squares of a decomposed tally to a statepoint.
+  //! This must be called on all processes. With parallel HDF5, every process
+  //! writes the bins it owns to the group collectively. Otherwise the group
+  //! is only used on the master process, which collects the bins of the other
+  //! processes one at a time.
+  void write_decomposed_results(hid_t group) const;
+
+  //! Read the sums and sums of squares of the bins owned by this process from a
+  //! statepoint
+  void read_decomposed_results(hid_t group);
+
+#ifdef OPENMC_MPI
+  //! Send the values of the current realization of a decomposed tally for
+  //! bins owned by other processes to their owners and add those received
+  void exchange_remote_values();
+
+  //! Start reducing the values of the current realization onto the master
+  //! process without waiting for the reduction to complete. The values are
+  //! reset on all processes so that the next realization can be scored while
+  //! the reduction is in flight.
+  void start_reduction();
+
+  //! Wait for a reduction started by start_reduction to complete and
+  //! accumulate the reduced values on the master process
+  void finish_reduction();
+
+  //! Add the values of the current realization of a sparse tally on all
+  //! processes to those on the master process
+  void reduce_sparse_values();
+
+  //! Send the sums and sums of squares of a sparse tally from the master
+  //! process to all other processes
+  void broadcast_sparse_results();
+#endif
+
   //! A string representing the i-th score on this tally
   std::string score_name(int score_idx) const;
 
+  //! Counters of the calling thread, or nullptr if the tally is not profiled
+  TallyProfile* thread_profile() const
+  {
+    return thread_profiles_.empty() ? nullptr :
+      &thread_profiles_[thread_index()];
+  }
+
+  //! Sum the counters of all threads into profile_ and, with MPI, those of all
+  //! processes on the master process
+  void reduce_profile();
+
   //----------------------------------------------------------------------------
   // Major public data members.
 
@@ -90,6 +302,10 @@ public:
   //! Whether this tally is currently being updated
   bool active_ {false};
 
+  //! Whether scoring to this active tally stopped because its triggers were
+  //! satisfied, which keeps its results fixed
+  bool frozen_ {false};
+
   //! Number of realizations
   int n_realizations_ {0};
 
@@ -101,15 +317,39 @@ public:
   //! True if this tally has a bin for every nuclide in the problem
   bool all_nuclides_ {false};
 
-  //! Results for each bin -- the first dimension of the array is for the
-  //! combination of filters (e.g. specific cell, specific energy group, etc.)
-  //! and the second dimension of the array is for scores (e.g. flux, total
-  //! reaction rate, fission reaction rate, etc.)
+  //! Scores of each bin in the current realization -- the first dimension of
+  //! the array is for the combination of filters (e.g. specific cell, specific
+  //! energy group, etc.) and the second dimension of the array is for scores
+  //! (e.g. flux, total reaction rate, fission reaction rate, etc.). Keeping
+  //! them apart from the accumulated sums makes the buffer that is scored
+  //! into and reduced among processes contiguous.
+  xt::xtensor<double, 2> values_;
+
+  //! Sum and sum of squares of the realizations of each bin, indexed like
+  //! values_ then by RESULT_SUM or RESULT_SUM_SQ
   xt::xtensor<double, 3> results_;
 
+  //! Mean and standard deviation of the mean of each bin, indexed like
+  //! results_. Only updated by compute_statistics() so that its buffer can be
+  //! viewed through the C API without copying.
+  xt::xtensor<double, 3> statistics_;
+
   //! True if this tally should be written to statepoint files
   bool writable_ {true};
 
+  //! True if results are only stored for the bins that have been scored, in
+  //! which case values_ and results_ are not allocated
+  bool sparse_ {false};
+
+  //! True if the combinations of filter bins are divided among processes, each
+  //! of which only stores the bins it owns in values_ and results_
+  bool decomposed_ {false};
+
+  //! True if each history rather than each batch is a realization of the
+  //! tally, in which case values_ is not allocated and n_realizations_ counts
+  //! histories
+  bool history_ {false};
+
   //----------------------------------------------------------------------------
   // Miscellaneous public members.
 
@@ -125,6 +365,17 @@ public:
 
   int deriv_ {C_NONE}; //!< Index of a TallyDerivative object for diff tallies.
 
+  //! Specialized function for each score, selected when the tally becomes
+  //! active. Empty if any score needs the general scoring routines.
+  std::vector<ScoreKernel> score_kernels_;
+
+  //! Position in the filters of an expansion filter whose moments are scored
+  //! together, or C_NONE
+  int fused_expansion_ {C_NONE};
+
+  //! Cost of scoring the tally as of the last call to reduce_profile
+  TallyProfile profile_;
+
 private:
   //----------------------------------------------------------------------------
   // Private data.
@@ -136,9 +387,135 @@ private:
 
   int32_t n_filter_bins_ {0};
 
+  //! Scores of the current realization from each thread. These are only
+  //! allocated when private tally buffers are enabled and the tally is small
+  //! enough to be replicated for every thread.
+  std::vector<xt::xtensor<double, 2>> thread_results_;
+
+  //! Cost of scoring the tally on each thread when tally profiling is on
+  mutable std::vector<TallyProfile> thread_profiles_;
+
+  //! Largest standard deviation and relative error of the mean of each
+  //! score, and the number of realizations they were found for
+  std::vector<double> max_std_dev_;
+  std::vector<double> max_rel_err_;
+  int max_uncertainty_realizations_ {-1};
+
+  //! Add a realization to the sums and sums of squares of all bins
+  //
+  //! The bins are divided among threads. When the triggers are due, the
+  //! largest uncertainties are found in the same sweep.
+  //! \param values Scores of the realization, indexed like values_
+  //! \param norm Normalization of the scores
+  //! \param reset Whether to zero the scores once they are accumulated
+  void accumulate_values(xt::xtensor<double, 2>& values, double norm,
+    bool reset);
+
+  //! Index of the calling thread in the per-thread buffers
+  static int thread_index()
+  {
+#ifdef _OPENMP
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
+  }
+
+  //! Index of a bin of a sparse tally
+  int64_t sparse_key(int filter_index, int score_index) const
+  {
+    return static_cast<int64_t>(filter_index) * scores_.size() *
+      nuclides_.size() + score_index;
+  }
+
+  //! Scores of the current realization of a sparse tally from each thread,
+  //! for the bins that have been scored
+  std::vector<std::unordered_map<int64_t, double>> sparse_values_;
+
+  //! Sums and sums of squares of the bins of a sparse tally that have been
+  //! scored
+  std::unordered_map<int64_t, std::array<double, 2>> sparse_results_;
+
+  //! First combination of filter bins owned by each process, followed by the
+  //! number of combinations. Empty unless the tally is decomposed.
+  std::vector<int32_t> owned_index_;
+
+  //! Largest number of bins in the buffer of remote_values_ of a thread
+  //! before it is moved to remote_sums_
+  static constexpr size_t MAX_REMOTE_VALUES {1 << 16};
+
+  //! Scores of the current realization of a decomposed tally from each thread
+  //! for bins owned by other processes, which are moved to remote_sums_ when
+  //! they reach MAX_REMOTE_VALUES bins so that their memory is bounded
+  std::vector<std::unordered_map<int64_t, double>> remote_values_;
+
+  //! Scores of the current realization of a decomposed tally from all threads
+  //! for bins owned by other processes, which hold at most one entry for each
+  //! of these bins
+  std::unordered_map<int64_t, double> remote_sums_;
+  OpenMPMutex remote_mutex_; //!< Lock for remote_sums_
+
+  //! Scores of the history being run on each thread for a tally with history
+  //! statistics, for the bins that have been scored
+  std::vector<std::unordered_map<int64_t, double>> history_values_;
+
+#ifdef OPENMC_MPI
+  MPI_Request reduce_request_ {MPI_REQUEST_NULL}; //!< Reduction in flight
+  xt::xtensor<double, 2> reduce_send_; //!< Values being reduced
+  xt::xtensor<double, 2> reduce_recv_; //!< Reduced values on the master
+#endif
+
   gsl::index index_;
 };
 
+//==============================================================================
+//! Index of the tallies of one estimator by the cells and materials in which
+//! they can score
+//
+//! A tally with a cell filter can only score while the particle is in one of
+//! the cells of the filter at some coordinate level, and a tally with a
+//! material filter only while it is in one of the materials of the filter.
+//! Looking up the cells and material of the particle gives the tallies that
+//! could score, so the filters of all other tallies are never evaluated.
+//! Tallies with a structured mesh filter are additionally skipped when the
+//! particle is outside the box enclosing the mesh.
+//==============================================================================
+
+class TallyDomainIndex {
+public:
+  //! Build the index for a list of tallies
+  //
+  //! \param tallies Indices of the tallies in model::tallies
+  //! \param estimator Estimator used by all of the tallies
+  void build(const std::vector<int>& tallies, TallyEstimator estimator);
+
+  //! Get the tallies that could score for a particle
+  //
+  //! \param p The particle being tracked, whose tally_candidates_ is used to
+  //!   store the result if the index is used
+  //! \return Indices of the tallies in the order of the original list
+  const std::vector<int>& candidates(Particle& p) const;
+
+  void clear();
+
+private:
+  std::vector<int> tallies_; //!< Tallies in the index
+  bool indexed_ {false}; //!< Whether any tally can be skipped
+  bool tracklength_ {false}; //!< Whether scores are for track segments
+
+  //! Positions in tallies_ of the tallies with no cell or material filter
+  std::vector<int> unrestricted_;
+
+  //! Positions in tallies_ of the tallies that can score in each cell
+  std::unordered_map<int32_t, std::vector<int>> cells_;
+
+  //! Positions in tallies_ of the tallies that can score in each material
+  std::unordered_map<int32_t, std::vector<int>> materials_;
+
+  //! Box outside of which each tally cannot score
+  std::vector<BoundingBox> boxes_;
+};
+
 //==============================================================================
 // Global variable declarations
 //==============================================================================
@@ -152,6 +529,9 @@ namespace model {
   extern std::vector<int> active_collision_tallies;
   extern std::vector<int> active_meshsurf_tallies;
   extern std::vector<int> active_surface_tallies;
+  extern std::vector<int> active_history_tallies;
+  extern TallyDomainIndex tracklength_tally_index;
+  extern TallyDomainIndex collision_tally_index;
 }
 
 namespace simulation {
@@ -181,6 +561,18 @@ void accumulate_tallies();
 //! Determine which tallies should be active
 void setup_active_tallies();
 
+//! Add the scores of the history that the calling thread just finished to the
+//! tallies with history statistics
+void accumulate_history_tallies();
+
+//! Whether any tally needs the cross sections of individual nuclides along
+//! tracks, rather than only the macroscopic cross sections of materials
+bool tallies_need_nuclide_xs();
+
+//! Combine the profiling counters of each tally over all threads and processes.
+//! This must be called on all processes.
+void reduce_tally_profiles();
+
 // Alias for the type returned by xt::adapt(...). N is the dimension of the
 // multidimensional array
 template <std::size_t N>
@@ -189,6 +581,10 @@ using adaptor_type = xt::xtensor_adaptor<xt::xbuffer_adaptor<double*&, xt::no_ow
 #ifdef OPENMC_MPI
 //! Collect all tally results onto master process
 void reduce_tally_results();
+
+//! Wait for the reductions of all tallies that are still in flight when tally
+//! reduction is pipelined and accumulate their results
+void finish_tally_reductions();
 #endif
 
 void free_memory_tally();
@@ -48,6 +48,13 @@ private:
   void compute_index_weight();
 
   const Tally& tally_;
+
+  //! Position of a filter whose bins are not iterated over because all of its
+  //! moments are scored together, or C_NONE
+  int skip_ {C_NONE};
+
+  //! Counters of the calling thread if the tally is being profiled
+  TallyProfile* profile_ {nullptr};
 };
 
 //==============================================================================
@@ -89,6 +96,27 @@ void score_analog_tally_mg(Particle& p);
 //! \param distance The distance in [cm] traveled by the particle
 void score_tracklength_tally(Particle& p, double distance);
 
+//! Select specialized scoring functions for the scores of a tally
+//
+//! Specialized functions are only available for continuous-energy volume
+//! tallies with a tracklength or collision estimator, no derivative, and only
+//! scores that are a flux or a macroscopic or microscopic reaction rate
+//! available directly from the cross sections of the particle.
+//
+//! \param tally The tally to select functions for
+//! \return A function for each score, or nothing if any score needs the general
+//!   scoring routines
+std::vector<ScoreKernel> score_kernels(const Tally& tally);
+
+//! Select a functional expansion filter whose moments are scored together
+//
+//! The moments of Legendre, spherical harmonics and Zernike expansions only
+//! weight the same reaction rate differently, so tallies with specialized
+//! kernels compute each rate once and add it to all moments in one update.
+//! \param tally The tally, whose score_kernels_ must already be selected
+//! \return Position of the filter in the filters of the tally or C_NONE
+int fused_expansion(const Tally& tally);
+
 //! Score surface or mesh-surface tallies for particle currents.
 //
 //! \param p The particle being tracked
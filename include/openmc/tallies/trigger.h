@@ -1,6 +1,7 @@
 #ifndef OPENMC_TALLIES_TRIGGER_H
 #define OPENMC_TALLIES_TRIGGER_H
 
+#include <cmath> // for sqrt, abs
 #include <string>
 
 #include "pugixml.hpp"
@@ -44,7 +45,27 @@ namespace settings {
 // Non-memeber functions
 //==============================================================================
 
+//! Whether the triggers are checked at the end of the current batch
+bool triggers_due();
+
+//! Check whether the uncertainties are below the trigger thresholds. This must
+//! be called on all processes and the result is only known on the master.
 void check_triggers();
 
+//! Compute the standard deviation and relative error of the mean of a bin
+//
+//! \param sum Sum of the realizations
+//! \param sum_sq Sum of the squares of the realizations
+//! \param n Number of realizations, which must be at least two
+//! \param[out] std_dev Standard deviation of the mean
+//! \param[out] rel_err Relative error of the mean, or zero if the mean is zero
+inline void bin_uncertainty(double sum, double sum_sq, int n, double& std_dev,
+  double& rel_err)
+{
+  double mean = sum / n;
+  std_dev = std::sqrt((sum_sq/n - mean*mean) / (n - 1));
+  rel_err = (mean != 0.) ? std_dev / std::abs(mean) : 0.;
+}
+
 } // namespace openmc
 #endif // OPENMC_TALLIES_TRIGGER_H
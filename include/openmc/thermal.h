@@ -21,6 +21,7 @@ namespace openmc {
 //==============================================================================
 
 class ThermalScattering;
+struct NuclideTemperature;
 
 namespace data {
 extern std::vector<std::unique_ptr<ThermalScattering>> thermal_scatt;
@@ -43,6 +44,17 @@ public:
   //! \param[out] inelastic Inelastic scattering cross section in [b]
   void calculate_xs(double E, double* elastic, double* inelastic) const;
 
+  //! Determine the largest total cross section within an energy interval
+  //
+  //! Tabulated cross sections are monotonic between their grid points and the
+  //! coherent elastic cross section decreases between Bragg edges, so the
+  //! cross section is evaluated at the ends of the interval and at every grid
+  //! point and Bragg edge within it.
+  //! \param[in] E_low Lower energy of the interval in [eV]
+  //! \param[in] E_high Upper energy of the interval in [eV]
+  //! \return Largest elastic plus inelastic cross section in [b]
+  double max_xs(double E_low, double E_high) const;
+
   //! Sample an outgoing energy and angle
   //
   //! \param[in] micro_xs Microscopic cross sections
@@ -62,10 +74,22 @@ private:
     std::unique_ptr<AngleEnergy> distribution; //!< Secondary angle-energy distribution
   };
 
+  //! Find the concrete types of the cross sections used by calculate_xs
+  void init_xs_types();
+
   // Inelastic scattering data
   Reaction elastic_;
   Reaction inelastic_;
 
+  // The cross sections as their concrete types, so that calculate_xs makes no
+  // virtual calls. Linearly interpolated cross sections on the same grid are
+  // interpolated with a single search.
+  const CoherentElasticXS* coherent_xs_ {nullptr};
+  const IncoherentElasticXS* incoherent_xs_ {nullptr};
+  const Tabulated1D* elastic_table_ {nullptr}; //!< Linear elastic xs
+  const Tabulated1D* inelastic_table_ {nullptr}; //!< Linear inelastic xs
+  bool shared_grid_ {false}; //!< Elastic table on the inelastic grid?
+
   // ThermalScattering needs access to private data members
   friend class ThermalScattering;
 };
@@ -87,8 +111,19 @@ public:
   //! \param[out] elastic Thermal elastic scattering cross section
   //! \param[out] inelastic Thermal inelastic scattering cross section
   //! \param[inout] seed Pseudorandom seed pointer
+  //! \param[in] temperature If not null, the precomputed temperature index
+  //!   at sqrtkT
   void calculate_xs(double E, double sqrtkT, int* i_temp, double* elastic,
-                    double* inelastic, uint64_t* seed) const;
+                    double* inelastic, uint64_t* seed,
+                    const NuclideTemperature* temperature = nullptr) const;
+
+  //! Determine the temperature index used for cross sections
+  //!
+  //! \param[in] sqrtkT square-root of temperature multipled by Boltzmann's
+  //!   constant
+  //! \return Index of the nearest temperature or, for interpolation, the next
+  //!   lower temperature along with the interpolation factor
+  NuclideTemperature temperature_index(double sqrtkT) const;
 
   //! Determine whether table applies to a particular nuclide
   //!
@@ -96,6 +131,11 @@ public:
   //! \return Whether table applies to the nuclide
   bool has_nuclide(const char* name) const;
 
+  //! Memory held by the cross sections and distributions at all temperatures
+  //!
+  //! \return Size in bytes
+  std::size_t memory() const;
+
   // Sample an outgoing energy and angle
   void sample(const NuclideMicroXS& micro_xs, double E_in,
               double* E_out, double* mu);
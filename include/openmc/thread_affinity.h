@@ -0,0 +1,22 @@
+//! \file thread_affinity.h
+//! Binding of OpenMP threads to the CPUs of a node
+
+#ifndef OPENMC_THREAD_AFFINITY_H
+#define OPENMC_THREAD_AFFINITY_H
+
+namespace openmc {
+
+//==============================================================================
+// Non-member functions
+//==============================================================================
+
+//! Bind each OpenMP thread to CPUs as given by settings::thread_affinity and
+//! report the resulting binding. Only the CPUs that the process may run on
+//! when this is called are used, so that ranks bound to disjoint CPU sets by
+//! the MPI launcher stay apart. Nothing is done when the OpenMP runtime
+//! already binds threads through OMP_PROC_BIND.
+void bind_threads();
+
+} // namespace openmc
+
+#endif // OPENMC_THREAD_AFFINITY_H
@@ -31,6 +31,7 @@ extern Timer time_event_advance_particle;
 extern Timer time_event_surface_crossing;
 extern Timer time_event_collision;
 extern Timer time_event_death;
+extern Timer time_event_history_tail;
 
 } // namespace simulation
 
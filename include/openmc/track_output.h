@@ -13,6 +13,16 @@ void add_particle_track(Particle& p);
 void write_particle_track(Particle& p);
 void finalize_particle_track(Particle& p);
 
+//! Write the tracks buffered by all threads to the single track file
+//
+//! With settings::track_single_file, the tracks of finished particles are
+//! buffered by each thread and appended to one file per process. This must be
+//! called outside of parallel regions.
+void write_particle_tracks();
+
+//! Write the remaining buffered tracks and close the single track file
+void close_track_file();
+
 } // namespace openmc
 
 #endif // OPENMC_TRACK_OUTPUT_H
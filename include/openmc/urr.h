@@ -3,6 +3,8 @@
 #ifndef OPENMC_URR_H
 #define OPENMC_URR_H
 
+#include <vector>
+
 #include "xtensor/xtensor.hpp"
 
 #include "openmc/constants.h"
@@ -16,6 +18,15 @@ namespace openmc {
 
 class UrrData{
 public:
+  //! Values of a band of a probability table needed to sample cross sections,
+  //! which are stored together so that sampling a band touches one record
+  struct Band {
+    double cum_prob; //!< cumulative probability
+    double elastic;  //!< elastic cross section or factor
+    double fission;  //!< fission cross section or factor
+    double n_gamma;  //!< capture cross section or factor
+  };
+
   Interpolation interp_;          //!< interpolation type
   int inelastic_flag_;            //!< inelastic competition flag
   int absorption_flag_;           //!< other absorption flag
@@ -23,9 +34,19 @@ public:
   int n_energy_;                  //!< number of energy points
   xt::xtensor<double, 1> energy_; //!< incident energies
   xt::xtensor<double, 3> prob_;   //!< Actual probability tables
+  int n_band_;                    //!< number of bands in each table
+  std::vector<Band> bands_;       //!< bands of each table, by energy
 
   //! \brief Load the URR data from the provided HDF5 group
   explicit UrrData(hid_t group_id);
+
+  //! Get a band of the table at an incident energy
+  //! \param i_energy Index of the incident energy
+  //! \param i_band Index of the band
+  const Band& band(int i_energy, int i_band) const
+  {
+    return bands_[i_energy*n_band_ + i_band];
+  }
 };
 
 } // namespace openmc
@@ -54,25 +54,21 @@ public:
     CELL
   };
 
+  // Volume estimators
+  enum class Estimator {
+    POINT, //!< Fraction of points sampled in the bounding box
+    RAY    //!< Fraction of the length of rays fired across the bounding box
+  };
+
   // Data members
   TallyDomain domain_type_; //!< Type of domain (cell, material, etc.)
-  size_t n_samples_; //!< Number of samples to use
+  Estimator estimator_ {Estimator::POINT}; //!< Type of volume estimator
+  size_t n_samples_; //!< Number of samples (points or rays) to use
   double threshold_ {-1.0}; //!< Error threshold for domain volumes
   TriggerMetric trigger_type_ {TriggerMetric::not_active}; //!< Trigger metric for the volume calculation
   Position lower_left_; //!< Lower-left position of bounding box
   Position upper_right_; //!< Upper-right position of bounding box
   std::vector<int> domain_ids_; //!< IDs of domains to find volumes of
-
-private:
-  //! \brief Check whether a material has already been hit for a given domain.
-  //! If not, add new entries to the vectors
-  //
-  //! \param[in] i_material Index in global materials vector
-  //! \param[in,out] indices Vector of material indices
-  //! \param[in,out] hits Number of hits corresponding to each material
-  void check_hit(int i_material, std::vector<int>& indices,
-    std::vector<int>& hits) const;
-
 };
 
 //==============================================================================
@@ -0,0 +1,81 @@
+//! \file weight_windows.h
+//! Mesh-based weight windows for splitting and Russian roulette
+
+#ifndef OPENMC_WEIGHT_WINDOWS_H
+#define OPENMC_WEIGHT_WINDOWS_H
+
+#include <cstdint> // for int32_t
+#include <vector>
+
+#include "pugixml.hpp"
+#include "xtensor/xtensor.hpp"
+
+#include "openmc/particle.h"
+
+namespace openmc {
+
+//==============================================================================
+//! Weight windows of one particle type defined over the bins of a mesh and a
+//! set of energy groups
+//
+//! When a particle crosses a surface or leaves a collision, its weight is
+//! compared with the window of the mesh bin and energy group it is in. A
+//! particle above the upper bound is split into copies of equal weight, the
+//! extra copies being put in the secondary bank. A particle below the lower
+//! bound plays Russian roulette and survives with the survival weight.
+//==============================================================================
+
+class WeightWindows {
+public:
+  //! Read weight windows
+  //
+  //! \param node <weight_windows> element of settings.xml
+  explicit WeightWindows(pugi::xml_node node);
+
+  //! Apply the weight window containing a particle
+  //
+  //! \param p Particle of the type of the weight windows
+  void apply(Particle& p) const;
+
+  Particle::Type particle_; //!< type of particle the windows apply to
+
+private:
+  int32_t id_;   //!< unique ID
+  int32_t mesh_; //!< index in model::meshes of the spatial mesh
+  std::vector<double> energy_bounds_; //!< energy group boundaries in [eV]
+  //! Lower weight bound of each mesh bin and energy group. Bins with a
+  //! non-positive bound have no window.
+  xt::xtensor<double, 2> lower_ww_;
+  double upper_ratio_ {5.0};    //!< ratio of the upper to the lower bound
+  double survival_ratio_ {3.0}; //!< ratio of the survival to the lower bound
+  int max_split_ {10};          //!< largest number of copies made at once
+  double weight_cutoff_ {1.0e-38}; //!< weight below which particles are killed
+};
+
+//==============================================================================
+// Global variables
+//==============================================================================
+
+namespace variance_reduction {
+  extern std::vector<WeightWindows> weight_windows;
+} // namespace variance_reduction
+
+//==============================================================================
+// Non-member functions
+//==============================================================================
+
+//! Read the weight windows of settings.xml. Meshes must have been read.
+//
+//! \param root Root element of settings.xml
+void read_weight_windows(pugi::xml_node root);
+
+//! Apply the weight windows for the type of a particle, if any
+//
+//! \param p Particle that crossed a surface or had a collision
+void apply_weight_windows(Particle& p);
+
+void free_memory_weight_windows();
+
+} // namespace openmc
+
+#endif // OPENMC_WEIGHT_WINDOWS_H
@@ -29,6 +29,26 @@ constexpr int FIT_F {2}; // Fission
 // Multipole HDF5 file version
 constexpr std::array<int, 2> WMP_VERSION {1, 1};
 
+// Maximum number of coefficients of the curvefit polynomials
+constexpr int MAX_POLY_COEFFICIENTS {32};
+
+// Number of poles whose Faddeeva function is evaluated at once
+constexpr int FADDEEVA_BATCH {8};
+
+//========================================================================
+//! Multipole cross sections in [b] and their derivatives with respect to
+//! temperature in [b/K]
+//========================================================================
+
+struct MultipoleXS {
+  double sig_s;  //!< elastic scattering
+  double sig_a;  //!< absorption
+  double sig_f;  //!< fission
+  double dsig_s; //!< derivative of elastic scattering
+  double dsig_a; //!< derivative of absorption
+  double dsig_f; //!< derivative of fission
+};
+
 //========================================================================
 // Windowed multipole data
 //========================================================================
@@ -58,6 +78,18 @@ public:
   //!         fission cross sections in [b/K]
   std::tuple<double, double, double> evaluate_deriv(double E, double sqrtkT);
 
+  //! \brief Evaluate the cross sections and their derivatives with respect to
+  //! temperature in a single pass over the poles of the window
+  //!
+  //! The Faddeeva function of each pole gives both the cross sections and,
+  //! through the recurrence of its derivatives, their derivatives, which are
+  //! the same as those of evaluate_deriv().
+  //!
+  //! \param E Incident neutron energy in [eV]
+  //! \param sqrtkT Square root of temperature times Boltzmann constant
+  //! \return Cross sections and their derivatives
+  MultipoleXS evaluate_with_deriv(double E, double sqrtkT);
+
   // Data members
   std::string name_; //!< Name of nuclide
   bool fissionable_; //!< Is the nuclide fissionable?
@@ -70,6 +102,11 @@ public:
   xt::xtensor<int, 2> windows_; //!< Indices of pole at start/end of window
   xt::xtensor<double, 3> curvefit_; //!< Fitting function (reaction, coeff index, window index)
   xt::xtensor<bool, 1> broaden_poly_; //!< Whether to broaden curvefit
+
+private:
+  //! Add the contribution of the curvefit polynomial of a window
+  void add_curvefit(int i_window, double E, double sqrtkT, double& sig_s,
+    double& sig_a, double& sig_f) const;
 };
 
 //========================================================================
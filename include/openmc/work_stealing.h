@@ -0,0 +1,73 @@
+//! \file work_stealing.h
+//! Cost-aware work-stealing scheduler for distributing work among threads
+
+#ifndef OPENMC_WORK_STEALING_H
+#define OPENMC_WORK_STEALING_H
+
+#include <cstdint> // for int64_t
+#include <vector>
+
+#include "openmc/openmp_interface.h"
+
+namespace openmc {
+
+//==============================================================================
+//! Distributes a range of work items among threads based on estimated costs
+//
+//! Each thread initially owns a contiguous range of work items whose total
+//! estimated cost is the same for all threads. A thread takes chunks of
+//! roughly equal cost from the front of its own range. Once its range is
+//! exhausted, it steals the back half (by cost) of the range of another thread.
+//! Because ranges only shrink or are handed over whole, every item is given
+//! out exactly once.
+//==============================================================================
+
+class WorkStealingScheduler {
+public:
+  //! Divide work items among threads
+  //
+  //! \param cost Estimated cost of each work item. Costs must be positive.
+  //! \param n_threads Number of threads that will request work
+  void init(const std::vector<double>& cost, int n_threads);
+
+  //! Get the next chunk of work for a thread
+  //
+  //! \param thread Index of the calling thread
+  //! \param[out] begin Index of the first work item in the chunk
+  //! \param[out] end Index one past the last work item in the chunk
+  //! \return Whether a chunk was obtained. A return value of false indicates
+  //!   that no work remains for this thread.
+  bool next(int thread, int64_t& begin, int64_t& end);
+
+private:
+  //! Range of work items owned by a thread
+  struct Range {
+    int64_t begin {0};  //!< first unclaimed work item
+    int64_t end {0};    //!< one past the last unclaimed work item
+    OpenMPMutex mutex;  //!< protects begin and end
+  };
+
+  //! Take work items from another thread, giving them to the given thread
+  //
+  //! \param thread Index of the thread that is stealing
+  //! \return Whether any work items were obtained
+  bool steal(int thread);
+
+  //! Find the first work item at which the cumulative cost reaches a value
+  //
+  //! \param c Cumulative cost
+  //! \return Index of the work item
+  int64_t index_at(double c) const;
+
+  // Each thread is given about this many chunks worth of work up front. More
+  // chunks balance load better at the cost of more frequent locking.
+  static constexpr int CHUNKS_PER_THREAD {16};
+
+  std::vector<double> cum_cost_; //!< cumulative cost preceding each work item
+  std::vector<Range> ranges_;    //!< range of work items owned by each thread
+  double chunk_cost_;            //!< target cost of a chunk
+};
+
+} // namespace openmc
+
+#endif // OPENMC_WORK_STEALING_H
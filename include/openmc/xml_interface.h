@@ -23,6 +23,17 @@ std::string get_node_value(pugi::xml_node node, const char* name,
 
 bool get_node_value_bool(pugi::xml_node node, const char* name);
 
+//! Load an XML document from a file
+//
+//! With several MPI processes, only the master process reads the file and its
+//! contents are broadcast to the others, which then parse them from memory.
+//! All processes must call this function together.
+//! \param doc Document to load
+//! \param filename Path to the XML file
+//! \return Result of parsing the file
+pugi::xml_parse_result load_xml_file(pugi::xml_document& doc,
+  const std::string& filename);
+
 template <typename T>
 std::vector<T> get_node_array(pugi::xml_node node, const char* name,
                               bool lowercase=false)
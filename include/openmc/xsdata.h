@@ -24,6 +24,17 @@ enum class AngleDistributionType {
   HISTOGRAM
 };
 
+//==============================================================================
+// GROUPXS contains the cross sections needed to track a particle in one
+// incoming group
+//==============================================================================
+
+struct GroupXS {
+  double total;
+  double absorption;
+  double nu_fission;
+};
+
 //==============================================================================
 // XSDATA contains the temperature-independent cross section data for an MGXS
 //==============================================================================
@@ -100,6 +111,9 @@ class XsData {
     xt::xtensor<double, 4> chi_delayed;
     // scatter has the following dimensions: [angle]
     std::vector<std::shared_ptr<ScattData>> scatter;
+    // tracking holds the total, absorption and nu-fission cross sections
+    // back-to-back with the following dimensions: [angle][incoming group]
+    std::vector<GroupXS> tracking;
 
     XsData() = default;
 
@@ -149,6 +163,27 @@ class XsData {
     //! @return True if they can be combined.
     bool
     equiv(const XsData& that);
+
+    //! \brief Packs the cross sections needed for tracking into one block.
+    //!
+    //! This must be called again whenever those cross sections change.
+    void
+    pack_tracking();
+
+    //! \brief Provides the cross sections needed for tracking.
+    //!
+    //! @param a Angle index.
+    //! @param gin Incoming energy group.
+    //! @return The total, absorption and nu-fission cross sections.
+    const GroupXS&
+    tracking_xs(int a, int gin) const {return tracking[a * n_g_ + gin];}
+
+    //! \brief Shares the scattering data with identical data in a pool.
+    //!
+    //! The scattering data must not be modified afterwards.
+    //! @param pool Distinct scattering data seen so far.
+    void
+    share_scatter(ScattDataPool& pool);
 };
 
 
@@ -11,6 +11,8 @@ from openmc.plots import *
 from openmc.region import *
 from openmc.volume import *
 from openmc.source import *
+from openmc.weight_windows import *
+from openmc.mesh_field import *
 from openmc.settings import *
 from openmc.surface import *
 from openmc.universe import *
@@ -44,6 +44,13 @@ class Cell(IDManagerMixin):
         instances of a cell with different materials.
     fill_type : {'material', 'universe', 'lattice', 'distribmat', 'void'}
         Indicates what the cell is filled with.
+    delta_tracking : bool
+        If the cell is filled with a universe or lattice, whether particles
+        are moved through its contents with delta tracking rather than by
+        crossing the surfaces within it. Track-length estimators are replaced
+        by collision estimators when any cell uses delta tracking.
+
+        .. versionadded:: 0.12
     region : openmc.Region or None
         Region of space that is assigned to the cell.
     rotation : Iterable of float
@@ -108,6 +115,7 @@ class Cell(IDManagerMixin):
         self._rotation_matrix = None
         self._temperature = None
         self._translation = None
+        self._delta_tracking = False
         self._paths = None
         self._num_instances = None
         self._volume = None
@@ -185,6 +193,10 @@ class Cell(IDManagerMixin):
     def translation(self):
         return self._translation
 
+    @property
+    def delta_tracking(self):
+        return self._delta_tracking
+
     @property
     def volume(self):
         return self._volume
@@ -316,6 +328,11 @@ class Cell(IDManagerMixin):
         cv.check_length('cell translation', translation, 3)
         self._translation = np.asarray(translation)
 
+    @delta_tracking.setter
+    def delta_tracking(self, delta_tracking):
+        cv.check_type('cell delta tracking', delta_tracking, bool)
+        self._delta_tracking = delta_tracking
+
     @temperature.setter
     def temperature(self, temperature):
         # Make sure temperatures are positive
@@ -635,6 +652,9 @@ class Cell(IDManagerMixin):
         if self.rotation is not None:
             element.set("rotation", ' '.join(map(str, self.rotation.ravel())))
 
+        if self.delta_tracking:
+            element.set("delta_tracking", "true")
+
         return element
 
     @classmethod
@@ -692,6 +712,9 @@ class Cell(IDManagerMixin):
             value = get_text(elem, key)
             if value is not None:
                 setattr(c, key, [float(x) for x in value.split()])
+        delta_tracking = get_text(elem, 'delta_tracking')
+        if delta_tracking is not None:
+            c.delta_tracking = delta_tracking in ('true', '1')
 
         # Add this cell to appropriate universe
         univ_id = int(get_text(elem, 'universe', 0))
@@ -295,7 +295,10 @@ class CMFDRun:
     time_cmfdsolve : float
         Time for solving CMFD matrix equations, in seconds
     use_all_threads : bool
-        Whether to use all threads allocated to OpenMC for CMFD solver
+        Whether to use all threads allocated to OpenMC for CMFD solver. With
+        more than two energy groups, this also switches the solver to a
+        red/black ordering of the mesh elements so they can be updated
+        concurrently.
     intracomm : mpi4py.MPI.Intracomm or None
         MPI intercommunicator for running MPI commands
 
@@ -1888,7 +1891,7 @@ class CMFDRun:
 
         # Get flux from CMFD tally 0
         tally_id = self._tally_ids[0]
-        flux = tallies[tally_id].results[:,0,1]
+        flux = tallies[tally_id].results[:,0,0]
 
         # Define target tally reshape dimensions. This defines how openmc
         # tallies are ordered by dimension
@@ -1925,7 +1928,7 @@ class CMFDRun:
             raise OpenMCError(err_message)
 
         # Get total reaction rate (rr) from CMFD tally 0
-        totalrr = tallies[tally_id].results[:,1,1]
+        totalrr = tallies[tally_id].results[:,1,0]
 
         # Reshape total reaction rate array to target shape. Swap x and z axes
         # so that shape is now [nx, ny, nz, ng, 1]
@@ -1949,7 +1952,7 @@ class CMFDRun:
         # Get scattering rr from CMFD tally 1
         # flux is repeated to account for extra dimensionality of scattering xs
         tally_id = self._tally_ids[1]
-        scattrr = tallies[tally_id].results[:,0,1]
+        scattrr = tallies[tally_id].results[:,0,0]
 
         # Define target tally reshape dimensions for xs with incoming
         # and outgoing energies
@@ -1978,7 +1981,7 @@ class CMFDRun:
                                   out=np.zeros_like(self._scattxs))
 
         # Get nu-fission rr from CMFD tally 1
-        nfissrr = tallies[tally_id].results[:,1,1]
+        nfissrr = tallies[tally_id].results[:,1,0]
         num_realizations = tallies[tally_id].num_realizations
 
         # Reshape nfissrr array to target shape. Swap x and z axes so that
@@ -2023,7 +2026,7 @@ class CMFDRun:
 
         # Get surface currents from CMFD tally 2
         tally_id = self._tally_ids[2]
-        current = tallies[tally_id].results[:,0,1]
+        current = tallies[tally_id].results[:,0,0]
 
         # Define target tally reshape dimensions for current
         target_tally_shape = [nz, ny, nx, 12, ng, 1]
@@ -2047,7 +2050,7 @@ class CMFDRun:
 
         # Get p1 scatter rr from CMFD tally 3
         tally_id = self._tally_ids[3]
-        p1scattrr = tallies[tally_id].results[:,0,1]
+        p1scattrr = tallies[tally_id].results[:,0,0]
 
         # Define target tally reshape dimensions for p1 scatter tally
         target_tally_shape = [nz, ny, nx, 2, ng, 1]
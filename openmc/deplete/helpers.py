@@ -6,19 +6,24 @@ from itertools import product
 from numbers import Real
 import bisect
 from collections import defaultdict
+from collections.abc import Iterable
 
+import numpy as np
 from numpy import dot, zeros, newaxis
 
+import openmc.lib
 from . import comm
 from openmc.checkvalue import check_type, check_greater_than
+from openmc.data.reaction import REACTION_NAME
 from openmc.lib import (
     Tally, MaterialFilter, EnergyFilter, EnergyFunctionFilter)
+from openmc.mgxs import GROUP_STRUCTURES
 from .abc import (
     ReactionRateHelper, EnergyHelper, FissionYieldHelper,
     TalliedFissionYieldHelper)
 
 __all__ = (
-    "DirectReactionRateHelper", "ChainFissionHelper",
+    "DirectReactionRateHelper", "FluxCollapseHelper", "ChainFissionHelper",
     "ConstantFissionYieldHelper", "FissionYieldCutoffHelper",
     "AveragedFissionYieldHelper")
 
@@ -83,7 +88,7 @@ class DirectReactionRateHelper(ReactionRateHelper):
             reaction rates in this material
         """
         self._results_cache.fill(0.0)
-        full_tally_res = self._rate_tally.results[mat_id, :, 1]
+        full_tally_res = self._rate_tally.results[mat_id, :, 0]
         for i_tally, (i_nuc, i_react) in enumerate(
                 product(nuc_index, react_index)):
             self._results_cache[i_nuc, i_react] = full_tally_res[i_tally]
@@ -91,6 +96,183 @@ class DirectReactionRateHelper(ReactionRateHelper):
         return self._results_cache
 
 
+# MT values of the reactions of depletion chains
+_REACTION_MT = {name: mt for mt, name in REACTION_NAME.items()}
+_REACTION_MT['fission'] = 18
+
+
+class FluxCollapseHelper(ReactionRateHelper):
+    """Class that generates one-group rates from a multigroup flux spectrum
+
+    Rather than tallying every reaction of every nuclide, which requires
+    reaction cross sections to be evaluated at each cross section lookup
+    during transport, only the flux spectrum in fine energy groups is tallied
+    in each burnable material. Reaction rates are then obtained by collapsing
+    group-averaged cross sections, computed once per nuclide, reaction and
+    temperature from the pointwise data, against the spectrum. The accuracy
+    depends on how well the groups resolve variations of the flux within
+    resonances; reactions of chosen nuclides can still be tallied directly.
+
+    Parameters
+    ----------
+    n_nucs : int
+        Number of burnable nuclides tracked by :class:`openmc.deplete.Operator`
+    n_react : int
+        Number of reactions tracked by :class:`openmc.deplete.Operator`
+    energies : iterable of float or str
+        Energy group boundaries in [eV] or the name of a group structure of
+        :data:`openmc.mgxs.GROUP_STRUCTURES`
+    reactions : iterable of str, optional
+        Reactions that are tallied directly for the nuclides in `nuclides`
+    nuclides : iterable of str, optional
+        Nuclides whose reactions in `reactions` are tallied directly
+
+    Attributes
+    ----------
+    nuclides : list of str
+        All nuclides with desired reaction rates.
+    energies : numpy.ndarray
+        Energy group boundaries in [eV]
+    """
+
+    def __init__(self, n_nucs, n_react, energies, reactions=None,
+                 nuclides=None):
+        super().__init__(n_nucs, n_react)
+        if isinstance(energies, str):
+            energies = GROUP_STRUCTURES[energies]
+        check_type('energies', energies, Iterable, Real)
+        energies = np.array(energies, dtype=float)
+        if energies.size < 2 or np.any(np.diff(energies) <= 0.0):
+            raise ValueError('Energy group boundaries must be given in '
+                             'increasing order.')
+        self.energies = energies
+        self._reactions_direct = [] if reactions is None else list(reactions)
+        self._nuclides_direct = [] if nuclides is None else list(nuclides)
+        self._tallied_nuclides = []
+        self._flux_tally = None
+        self._group_xs = {}
+
+    def generate_tallies(self, materials, scores):
+        """Produce the multigroup flux tally
+
+        Uses the :mod:`openmc.lib` to generate a tally of the flux in each
+        energy group across all burnable materials. The tally of reactions
+        scored directly is created once their nuclides are known.
+
+        Parameters
+        ----------
+        materials : iterable of :class:`openmc.lib.Material`
+            Burnable materials in the problem. Used to
+            construct a :class:`openmc.MaterialFilter`
+        scores : iterable of str
+            Reaction identifiers, e.g. ``"(n, fission)"``,
+            ``"(n, gamma)"``, needed for the reaction rate tally.
+        """
+        unknown = set(scores) - set(_REACTION_MT)
+        if unknown:
+            raise ValueError('Unknown reactions: {}'.format(
+                ', '.join(sorted(unknown))))
+        unknown = set(self._reactions_direct) - set(scores)
+        if unknown:
+            raise ValueError('Reactions {} tallied directly are not in the '
+                             'depletion chain.'.format(
+                                 ', '.join(sorted(unknown))))
+
+        self._materials = list(materials)
+        self._scores = list(scores)
+        self._mts = [_REACTION_MT[score] for score in scores]
+
+        self._flux_tally = Tally()
+        self._flux_tally.writable = False
+        self._flux_tally.scores = ['flux']
+        self._flux_tally.filters = [MaterialFilter(self._materials),
+                                    EnergyFilter(self.energies)]
+
+    @property
+    def nuclides(self):
+        """List of nuclides with requested reaction rates"""
+        return self._nuclides
+
+    @nuclides.setter
+    def nuclides(self, nuclides):
+        check_type("nuclides", nuclides, list, str)
+        self._nuclides = nuclides
+
+        # Reactions are only tallied for the nuclides chosen, so as not to
+        # require reaction cross sections of the others during transport
+        tallied = [nuc for nuc in nuclides if nuc in self._nuclides_direct]
+        if not tallied or not self._reactions_direct:
+            return
+        if self._rate_tally is None:
+            self._rate_tally = Tally()
+            self._rate_tally.writable = False
+            self._rate_tally.scores = self._reactions_direct
+            self._rate_tally.filters = [MaterialFilter(self._materials)]
+        self._rate_tally.nuclides = tallied
+        self._tallied_nuclides = tallied
+
+    def _get_group_xs(self, nuclide, mt, temperature):
+        """Return group-averaged cross sections, computed once"""
+        key = (nuclide, mt, temperature)
+        if key not in self._group_xs:
+            self._group_xs[key] = openmc.lib.nuclides[nuclide].group_xs(
+                mt, temperature, self.energies)
+        return self._group_xs[key]
+
+    def get_material_rates(self, mat_id, nuc_index, react_index):
+        """Return an array of reaction rates for a material
+
+        Parameters
+        ----------
+        mat_id : int
+            Index of the material in the materials given to
+            :meth:`generate_tallies`
+        nuc_index : iterable of int
+            Index for each nuclide in :attr:`nuclides` in the
+            desired reaction rate matrix
+        react_index : iterable of int
+            Index for each reaction scored in the tally
+
+        Returns
+        -------
+        rates : numpy.ndarray
+            Array with shape ``(n_nuclides, n_rxns)`` with the
+            reaction rates in this material
+        """
+        self._results_cache.fill(0.0)
+
+        # Flux spectrum of the material
+        n_groups = len(self.energies) - 1
+        flux = self._flux_tally.results[:, 0, 0].reshape(
+            len(self._materials), n_groups)[mat_id]
+
+        # Reaction rates tallied directly
+        direct = {}
+        if self._tallied_nuclides:
+            rates = self._rate_tally.results[mat_id, :, 0]
+            for i, (nuc, score) in enumerate(product(
+                    self._tallied_nuclides, self._reactions_direct)):
+                direct[nuc, score] = rates[i]
+
+        mat = self._materials[mat_id]
+        densities = dict(zip(mat.nuclides, mat.densities))
+        temperature = mat.temperature
+
+        for name, i_nuc in zip(self.nuclides, nuc_index):
+            density = densities.get(name, 0.0)
+            for score, mt, i_rx in zip(self._scores, self._mts, react_index):
+                if (name, score) in direct:
+                    rate = direct[name, score]
+                elif density > 0.0:
+                    xs = self._get_group_xs(name, mt, temperature)
+                    rate = density * dot(xs, flux)
+                else:
+                    rate = 0.0
+                self._results_cache[i_nuc, i_rx] = rate
+
+        return self._results_cache
+
+
 # ----------------------------
 # Helpers for obtaining energy
 # ----------------------------
@@ -208,7 +390,7 @@ class EnergyScoreHelper(EnergyHelper):
         """
         super().reset()
         if comm.rank == 0:
-            self._energy = self._tally.results[0, 0, 1]
+            self._energy = self._tally.results[0, 0, 0]
 
 # ------------------------------------
 # Helper for collapsing fission yields
@@ -447,7 +629,7 @@ class FissionYieldCutoffHelper(TalliedFissionYieldHelper):
         if not self._tally_nucs or self._local_indexes.size == 0:
             self.results = None
             return
-        fission_rates = self._fission_rate_tally.results[..., 1].reshape(
+        fission_rates = self._fission_rate_tally.results[..., 0].reshape(
             self.n_bmats, 2, len(self._tally_nucs))
         self.results = fission_rates[self._local_indexes]
         total_fission = self.results.sum(axis=1)
@@ -609,9 +791,9 @@ class AveragedFissionYieldHelper(TalliedFissionYieldHelper):
             self.results = None
             return
         fission_results = (
-            self._fission_rate_tally.results[self._local_indexes, :, 1])
+            self._fission_rate_tally.results[self._local_indexes, :, 0])
         self.results = (
-            self._weighted_tally.results[self._local_indexes, :, 1]).copy()
+            self._weighted_tally.results[self._local_indexes, :, 0]).copy()
         nz_mat, nz_nuc = fission_results.nonzero()
         self.results[nz_mat, nz_nuc] /= fission_results[nz_mat, nz_nuc]
 
@@ -25,8 +25,9 @@ from .atom_number import AtomNumber
 from .reaction_rates import ReactionRates
 from .results_list import ResultsList
 from .helpers import (
-    DirectReactionRateHelper, ChainFissionHelper, ConstantFissionYieldHelper,
-    FissionYieldCutoffHelper, AveragedFissionYieldHelper, EnergyScoreHelper)
+    DirectReactionRateHelper, FluxCollapseHelper, ChainFissionHelper,
+    ConstantFissionYieldHelper, FissionYieldCutoffHelper,
+    AveragedFissionYieldHelper, EnergyScoreHelper)
 
 
 __all__ = ["Operator", "OperatorResult"]
@@ -120,6 +121,28 @@ class Operator(TransportOperator):
         if ``reduce_chain`` evaluates to true. The default value of
         ``None`` implies no limit on the depth.
 
+        .. versionadded:: 0.12
+    reaction_rate_mode : {"direct", "flux"}, optional
+        Indicate how one-group reaction rates should be calculated. The
+        "direct" method tallies the reaction rates of all nuclides directly,
+        which requires reaction cross sections at every cross section lookup.
+        The "flux" method tallies a multigroup flux spectrum in each burnable
+        material and collapses it against group-averaged cross sections, see
+        :class:`~openmc.deplete.helpers.FluxCollapseHelper`.
+
+        .. versionadded:: 0.12
+    reaction_rate_opts : dict, optional
+        Keyword arguments passed to the reaction rate helper. For the "flux"
+        method, ``energies`` is required and ``reactions`` and ``nuclides``
+        may select reactions to tally directly.
+
+        .. versionadded:: 0.12
+    reuse_source : bool, optional
+        Whether each transport simulation after the first starts from the
+        fission source of the previous one rather than the source of the
+        settings. The number of inactive batches can then be lowered through
+        :data:`openmc.lib.settings`.
+
         .. versionadded:: 0.12
 
     Attributes
@@ -167,7 +190,9 @@ class Operator(TransportOperator):
                  diff_burnable_mats=False, energy_mode="fission-q",
                  fission_q=None, dilute_initial=1.0e3,
                  fission_yield_mode="constant", fission_yield_opts=None,
-                 reduce_chain=False, reduce_chain_level=None):
+                 reduce_chain=False, reduce_chain_level=None,
+                 reaction_rate_mode="direct", reaction_rate_opts=None,
+                 reuse_source=False):
         if fission_yield_mode not in self._fission_helpers:
             raise KeyError(
                 "fission_yield_mode must be one of {}, not {}".format(
@@ -181,6 +206,10 @@ class Operator(TransportOperator):
             raise ValueError(
                 "energy_mode {} not supported. Must be energy-deposition "
                 "or fission-q".format(energy_mode))
+        if reaction_rate_mode not in ("direct", "flux"):
+            raise ValueError(
+                "reaction_rate_mode must be direct or flux, not {}".format(
+                    reaction_rate_mode))
         super().__init__(chain_file, fission_q, dilute_initial, prev_results)
         self.round_number = False
         self.prev_res = None
@@ -241,9 +270,18 @@ class Operator(TransportOperator):
         self.reaction_rates = ReactionRates(
             self.local_mats, self._burnable_nucs, self.chain.reactions)
 
+        self._reuse_source = reuse_source
+
         # Get classes to assist working with tallies
-        self._rate_helper = DirectReactionRateHelper(
-            self.reaction_rates.n_nuc, self.reaction_rates.n_react)
+        reaction_rate_opts = (
+            {} if reaction_rate_opts is None else reaction_rate_opts)
+        if reaction_rate_mode == "flux":
+            self._rate_helper = FluxCollapseHelper(
+                self.reaction_rates.n_nuc, self.reaction_rates.n_react,
+                **reaction_rate_opts)
+        else:
+            self._rate_helper = DirectReactionRateHelper(
+                self.reaction_rates.n_nuc, self.reaction_rates.n_react)
         if energy_mode == "fission-q":
             self._energy_helper = ChainFissionHelper()
         else:
@@ -489,6 +527,7 @@ class Operator(TransportOperator):
         # Initialize OpenMC library
         comm.barrier()
         openmc.lib.init(intracomm=comm)
+        openmc.lib.settings.reuse_source = self._reuse_source
 
         # Generate tallies in memory
         materials = [openmc.lib.materials[int(i)]
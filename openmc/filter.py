@@ -22,7 +22,8 @@ _FILTER_TYPES = (
     'universe', 'material', 'cell', 'cellborn', 'surface', 'mesh', 'energy',
     'energyout', 'mu', 'polar', 'azimuthal', 'distribcell', 'delayedgroup',
     'energyfunction', 'cellfrom', 'legendre', 'spatiallegendre',
-    'sphericalharmonics', 'zernike', 'zernikeradial', 'particle', 'cellinstance'
+    'sphericalharmonics', 'zernike', 'zernikeradial', 'particle', 'cellinstance',
+    'time'
 )
 
 _CURRENT_NAMES = (
@@ -814,6 +815,12 @@ class MeshFilter(Filter):
         # Append mesh ID as outermost index of multi-index
         mesh_key = 'mesh {}'.format(self.mesh.id)
 
+        # Elements of an adaptive mesh are identified by their bin
+        if isinstance(self.mesh, openmc.AdaptiveMesh):
+            filter_dict[mesh_key, 'element'] = _repeat_and_tile(
+                np.arange(1, self.mesh.max_bins + 1), stride, data_size)
+            return pd.concat([df, pd.DataFrame(filter_dict)])
+
         # Find mesh dimensions - use 3D indices for simplicity
         n_dim = len(self.mesh.dimension)
         if n_dim == 3:
@@ -1500,6 +1507,46 @@ class DistribcellFilter(Filter):
         return df
 
 
+class TimeFilter(RealFilter):
+    """Bins tally events based on the time since the birth of the history.
+
+    Collisions and surface crossings are binned by the time at which they
+    happen, while track-length scores are divided among the bins that a track
+    spans in proportion to the time spent in each.
+
+    .. versionadded:: 0.12
+
+    Parameters
+    ----------
+    values : Iterable of Real
+        A list of values for which each successive pair constitutes a range of
+        times in [s] for a single bin
+    filter_id : int
+        Unique identifier for the filter
+
+    Attributes
+    ----------
+    values : numpy.ndarray
+        An array of values for which each successive pair constitutes a range of
+        times in [s] for a single bin
+    id : int
+        Unique identifier for the filter
+    bins : numpy.ndarray
+        An array of shape (N, 2) where each row is a pair of times in [s] for a
+        single filter bin
+    num_bins : int
+        The number of filter bins
+
+    """
+    units = 's'
+
+    def check_bins(self, bins):
+        super().check_bins(bins)
+        for v0, v1 in bins:
+            cv.check_greater_than('filter value', v0, 0., equality=True)
+            cv.check_greater_than('filter value', v1, 0., equality=True)
+
+
 class MuFilter(RealFilter):
     """Bins tally events based on particle scattering angle.
 
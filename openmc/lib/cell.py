@@ -12,7 +12,7 @@ from .core import _FortranObjectWithID
 from .error import _error_handler
 from .material import Material
 
-__all__ = ['Cell', 'cells']
+__all__ = ['Cell', 'cells', 'set_cell_temperatures']
 
 # Cell functions
 _dll.openmc_extend_cells.argtypes = [c_int32, POINTER(c_int32), POINTER(c_int32)]
@@ -46,6 +46,10 @@ _dll.openmc_cell_set_temperature.argtypes = [
     c_int32, c_double, POINTER(c_int32)]
 _dll.openmc_cell_set_temperature.restype = c_int
 _dll.openmc_cell_set_temperature.errcheck = _error_handler
+_dll.openmc_cells_set_temperature.argtypes = [
+    c_int32, POINTER(c_int32), POINTER(c_int32), POINTER(c_double)]
+_dll.openmc_cells_set_temperature.restype = c_int
+_dll.openmc_cells_set_temperature.errcheck = _error_handler
 _dll.openmc_get_cell_index.argtypes = [c_int32, POINTER(c_int32)]
 _dll.openmc_get_cell_index.restype = c_int
 _dll.openmc_get_cell_index.errcheck = _error_handler
@@ -224,3 +228,37 @@ class _CellMapping(Mapping):
         return repr(dict(self))
 
 cells = _CellMapping()
+
+
+def set_cell_temperatures(cells, temperatures, instances=None):
+    """Set the temperatures of many cells or cell instances at once
+
+    The temperatures are set in parallel with a single call to the library,
+    which is much faster than calling :meth:`Cell.set_temperature` for each
+    cell. Each cell may only be given once for all of its instances or once for
+    each of its instances.
+
+    Parameters
+    ----------
+    cells : iterable of openmc.lib.Cell
+        Cells whose temperatures are set
+    temperatures : iterable of float
+        Temperature in K of each cell or cell instance
+    instances : iterable of int or None
+        Instance of each cell. If not given, the temperatures apply to all
+        instances of the cells.
+
+    """
+    index = np.array([c._index for c in cells], dtype=np.int32)
+    T = np.ascontiguousarray(temperatures, dtype=float)
+    if T.shape != index.shape:
+        raise ValueError('A temperature must be given for each cell.')
+    if instances is not None:
+        instances = np.ascontiguousarray(instances, dtype=np.int32)
+        if instances.shape != index.shape:
+            raise ValueError('An instance must be given for each cell.')
+        instances = instances.ctypes.data_as(POINTER(c_int32))
+
+    _dll.openmc_cells_set_temperature(
+        len(index), index.ctypes.data_as(POINTER(c_int32)), instances,
+        T.ctypes.data_as(POINTER(c_double)))
@@ -1,6 +1,7 @@
 from contextlib import contextmanager
 from ctypes import (c_bool, c_int, c_int32, c_int64, c_double, c_char_p,
-                    c_char, POINTER, Structure, c_void_p, create_string_buffer)
+                    c_char, c_size_t, POINTER, Structure, c_void_p,
+                    create_string_buffer, CFUNCTYPE)
 import sys
 
 import numpy as np
@@ -16,6 +17,7 @@ class _Bank(Structure):
                 ('u', c_double*3),
                 ('E', c_double),
                 ('wgt', c_double),
+                ('time', c_double),
                 ('delayed_group', c_int),
                 ('particle', c_int),
                 ('parent_id', c_int64),
@@ -29,8 +31,14 @@ _array_1d_int = np.ctypeslib.ndpointer(dtype=np.int32, ndim=1,
 _array_1d_dble = np.ctypeslib.ndpointer(dtype=np.double, ndim=1,
                                         flags='CONTIGUOUS')
 
+_batch_callback_type = CFUNCTYPE(None, c_int, c_void_p)
+_dll.openmc_add_batch_callback.argtypes = [_batch_callback_type, c_void_p]
+_dll.openmc_add_batch_callback.restype = c_int
+_dll.openmc_add_batch_callback.errcheck = _error_handler
 _dll.openmc_calculate_volumes.restype = c_int
 _dll.openmc_calculate_volumes.errcheck = _error_handler
+_dll.openmc_clear_batch_callbacks.restype = c_int
+_dll.openmc_clear_batch_callbacks.errcheck = _error_handler
 _dll.openmc_finalize.restype = c_int
 _dll.openmc_finalize.errcheck = _error_handler
 _dll.openmc_find_cell.argtypes = [POINTER(c_double*3), POINTER(c_int32),
@@ -56,6 +64,17 @@ _dll.openmc_next_batch.restype = c_int
 _dll.openmc_next_batch.errcheck = _error_handler
 _dll.openmc_plot_geometry.restype = c_int
 _dll.openmc_plot_geometry.restype = _error_handler
+_dll.openmc_precursor_decay_rates.argtypes = [POINTER(POINTER(c_double)),
+                                              POINTER(c_size_t*2)]
+_dll.openmc_precursor_decay_rates.restype = c_int
+_dll.openmc_precursor_decay_rates.errcheck = _error_handler
+_dll.openmc_precursors.argtypes = [POINTER(POINTER(c_double)),
+                                   POINTER(c_size_t*2)]
+_dll.openmc_precursors.restype = c_int
+_dll.openmc_precursors.errcheck = _error_handler
+_dll.openmc_precursors_advance.argtypes = [c_double, c_double]
+_dll.openmc_precursors_advance.restype = c_int
+_dll.openmc_precursors_advance.errcheck = _error_handler
 _dll.openmc_run.restype = c_int
 _dll.openmc_run.errcheck = _error_handler
 _dll.openmc_reset.restype = c_int
@@ -76,6 +95,16 @@ _dll.openmc_simulation_finalize.errcheck = _error_handler
 _dll.openmc_statepoint_write.argtypes = [c_char_p, POINTER(c_bool)]
 _dll.openmc_statepoint_write.restype = c_int
 _dll.openmc_statepoint_write.errcheck = _error_handler
+_dll.openmc_find_cells.argtypes = [
+    c_int64, POINTER(c_double), POINTER(c_int32), POINTER(c_int32),
+    POINTER(c_int32), POINTER(c_double)]
+_dll.openmc_find_cells.restype = c_int
+_dll.openmc_find_cells.errcheck = _error_handler
+_dll.openmc_find_overlaps.argtypes = [
+    POINTER(c_double*3), POINTER(c_double*3), c_int64, c_int32,
+    POINTER(c_int32), POINTER(c_double), POINTER(c_int32)]
+_dll.openmc_find_overlaps.restype = c_int
+_dll.openmc_find_overlaps.errcheck = _error_handler
 _dll.openmc_global_bounding_box.argtypes = [POINTER(c_double),
                                             POINTER(c_double)]
 _dll.openmc_global_bounding_box.restype = c_int
@@ -96,11 +125,59 @@ def global_bounding_box():
 
     return llc, urc
 
+# Callbacks registered with the library, kept alive while it may call them
+_batch_callbacks = []
+
+
+def add_batch_callback(func):
+    """Register a function to be called at the end of each batch
+
+    The function is called once the tallies of the batch have been
+    accumulated, so that tally results can be looked at in memory, e.g.
+    through :attr:`Tally.statistics`, without writing a statepoint. Callbacks
+    are removed when the library is finalized.
+
+    Parameters
+    ----------
+    func : callable
+        Function called with the index of the batch that finished
+
+    """
+    callback = _batch_callback_type(lambda batch, data: func(batch))
+    _dll.openmc_add_batch_callback(callback, None)
+    _batch_callbacks.append(callback)
+
+
+def advance_precursors(dt, source_rate):
+    """Advance the delayed neutron precursor populations over a time step
+
+    The populations, accessed through :func:`precursors`, are advanced
+    assuming that the production of precursors per source particle and their
+    decay constants, as tallied on the precursor mesh by the last simulation,
+    remain constant over the step.
+
+    Parameters
+    ----------
+    dt : float
+        Time step in [s]
+    source_rate : float
+        Source particles per second during the step
+
+    """
+    _dll.openmc_precursors_advance(dt, source_rate)
+
+
 def calculate_volumes():
     """Run stochastic volume calculation"""
     _dll.openmc_calculate_volumes()
 
 
+def clear_batch_callbacks():
+    """Remove the functions called at the end of each batch"""
+    _dll.openmc_clear_batch_callbacks()
+    _batch_callbacks.clear()
+
+
 def current_batch():
     """Return the current batch of the simulation.
 
@@ -116,6 +193,7 @@ def current_batch():
 def finalize():
     """Finalize simulation and free memory"""
     _dll.openmc_finalize()
+    _batch_callbacks.clear()
 
 
 def find_cell(xyz):
@@ -141,6 +219,103 @@ def find_cell(xyz):
     return openmc.lib.Cell(index=index.value), instance.value
 
 
+def find_cells(xyz):
+    """Find the cells, materials and temperatures at many points
+
+    The points are located in parallel with the OpenMP threads of OpenMC,
+    which is much faster than calling :func:`find_cell` for each of them.
+
+    .. versionadded:: 0.12
+
+    Parameters
+    ----------
+    xyz : numpy.ndarray
+        Cartesian coordinates of the points with shape (N, 3)
+
+    Returns
+    -------
+    cells : numpy.ndarray
+        Index of the cell at each point, or -1 if the point is not in any cell
+    instances : numpy.ndarray
+        Instance of the cell at each point, or -1 if the point is not in any
+        cell
+    materials : numpy.ndarray
+        Index of the material at each point, or -1 for a void or a point that
+        is not in any cell
+    temperatures : numpy.ndarray
+        Temperature in [K] at each point, or zero if the point is not in any
+        cell
+
+    """
+    xyz = np.ascontiguousarray(xyz, dtype=float)
+    if xyz.ndim != 2 or xyz.shape[1] != 3:
+        raise ValueError('Points must be given as an array with shape (N, 3).')
+    n = xyz.shape[0]
+    cells = np.empty(n, dtype=np.int32)
+    instances = np.empty(n, dtype=np.int32)
+    materials = np.empty(n, dtype=np.int32)
+    temperatures = np.empty(n)
+    _dll.openmc_find_cells(
+        n, xyz.ctypes.data_as(POINTER(c_double)),
+        cells.ctypes.data_as(POINTER(c_int32)),
+        instances.ctypes.data_as(POINTER(c_int32)),
+        materials.ctypes.data_as(POINTER(c_int32)),
+        temperatures.ctypes.data_as(POINTER(c_double)))
+    return cells, instances, materials, temperatures
+
+
+def find_overlaps(samples, lower_left=None, upper_right=None, max_pairs=1000):
+    """Find overlapping cells by sampling points in a bounding box
+
+    Points are sampled uniformly in the box, divided among threads and MPI
+    processes, and located in the geometry. At each point, every cell of each
+    universe the point is in is checked, so that a point in two cells of a
+    universe reveals an overlap. This validates a model much faster than
+    running a simulation with overlap checking.
+
+    Parameters
+    ----------
+    samples : int
+        Number of points to sample
+    lower_left : iterable of float, optional
+        Lower-left coordinates of the box. Defaults to the bounding box of the
+        geometry.
+    upper_right : iterable of float, optional
+        Upper-right coordinates of the box. Defaults to the bounding box of the
+        geometry.
+    max_pairs : int
+        Largest number of overlapping pairs of cells returned
+
+    Returns
+    -------
+    list of tuple
+        For each pair of overlapping cells, a tuple of the two
+        :class:`openmc.lib.Cell` objects and of the coordinates of a point
+        where they overlap
+
+    """
+    if lower_left is None or upper_right is None:
+        llc, urc = global_bounding_box()
+        lower_left = llc if lower_left is None else lower_left
+        upper_right = urc if upper_right is None else upper_right
+    if not (np.all(np.isfinite(lower_left)) and
+            np.all(np.isfinite(upper_right))):
+        raise ValueError('A finite bounding box must be given to find '
+                         'overlapping cells.')
+
+    cells = np.zeros((max_pairs, 2), dtype=np.int32)
+    xyz = np.zeros((max_pairs, 3))
+    n_pairs = c_int32()
+    _dll.openmc_find_overlaps(
+        (c_double*3)(*lower_left), (c_double*3)(*upper_right), samples,
+        max_pairs, cells.ctypes.data_as(POINTER(c_int32)),
+        xyz.ctypes.data_as(POINTER(c_double)), n_pairs)
+    n = min(n_pairs.value, max_pairs)
+    return [(openmc.lib.Cell(index=int(cells[i, 0])),
+             openmc.lib.Cell(index=int(cells[i, 1])), tuple(xyz[i]))
+            for i in range(n)]
+
+
 def find_material(xyz):
     """Find the material at a given point
 
@@ -300,6 +475,40 @@ def plot_geometry():
     _dll.openmc_plot_geometry()
 
 
+def precursor_decay_rates():
+    """Return the mean decay constants of the precursors produced by the last
+    simulation
+
+    Returns
+    -------
+    numpy.ndarray
+        Decay constant in [1/s] of each precursor mesh bin and delayed group
+
+    """
+    data = POINTER(c_double)()
+    shape = (c_size_t*2)()
+    _dll.openmc_precursor_decay_rates(data, shape)
+    return as_array(data, tuple(shape))
+
+
+def precursors():
+    """Return the delayed neutron precursor populations
+
+    The array is a view of the populations of the library, which can be
+    modified in place, e.g. to set the initial populations of a transient.
+
+    Returns
+    -------
+    numpy.ndarray
+        Population of each precursor mesh bin and delayed group
+
+    """
+    data = POINTER(c_double)()
+    shape = (c_size_t*2)()
+    _dll.openmc_precursors(data, shape)
+    return as_array(data, tuple(shape))
+
+
 def reset():
     """Reset tally results"""
     _dll.openmc_reset()
@@ -11,7 +11,7 @@ from .core import _FortranObjectWithID
 from .error import _error_handler
 
 
-__all__ = ['Material', 'materials']
+__all__ = ['Material', 'materials', 'set_material_densities']
 
 # Material functions
 _dll.openmc_extend_materials.argtypes = [c_int32, POINTER(c_int32), POINTER(c_int32)]
@@ -35,6 +35,9 @@ _dll.openmc_material_get_densities.errcheck = _error_handler
 _dll.openmc_material_get_density.argtypes = [c_int32, POINTER(c_double)]
 _dll.openmc_material_get_density.restype = c_int
 _dll.openmc_material_get_density.errcheck = _error_handler
+_dll.openmc_material_get_temperature.argtypes = [c_int32, POINTER(c_double)]
+_dll.openmc_material_get_temperature.restype = c_int
+_dll.openmc_material_get_temperature.errcheck = _error_handler
 _dll.openmc_material_get_volume.argtypes = [c_int32, POINTER(c_double)]
 _dll.openmc_material_get_volume.restype = c_int
 _dll.openmc_material_get_volume.errcheck = _error_handler
@@ -57,6 +60,15 @@ _dll.openmc_material_set_name.errcheck = _error_handler
 _dll.openmc_material_set_volume.argtypes = [c_int32, c_double]
 _dll.openmc_material_set_volume.restype = c_int
 _dll.openmc_material_set_volume.errcheck = _error_handler
+_dll.openmc_materials_set_density.argtypes = [
+    c_int32, POINTER(c_int32), POINTER(c_double), c_char_p]
+_dll.openmc_materials_set_density.restype = c_int
+_dll.openmc_materials_set_density.errcheck = _error_handler
+_dll.openmc_materials_set_densities.argtypes = [
+    c_int32, POINTER(c_int32), POINTER(c_int), POINTER(c_char_p),
+    POINTER(c_double)]
+_dll.openmc_materials_set_densities.restype = c_int
+_dll.openmc_materials_set_densities.errcheck = _error_handler
 _dll.n_materials.argtypes = []
 _dll.n_materials.restype = c_size_t
 
@@ -86,6 +98,9 @@ class Material(_FortranObjectWithID):
         List of nuclides in the material
     densities : numpy.ndarray
         Array of densities in atom/b-cm
+    temperature : float
+        Temperature in [K] at which the material is transported, taken from
+        the first cell instance it fills
 
     """
     __instances = WeakValueDictionary()
@@ -141,6 +156,12 @@ class Material(_FortranObjectWithID):
         name_ptr = c_char_p(name.encode())
         _dll.openmc_material_set_name(self._index, name_ptr)
 
+    @property
+    def temperature(self):
+        T = c_double()
+        _dll.openmc_material_get_temperature(self._index, T)
+        return T.value
+
     @property
     def volume(self):
         volume = c_double()
@@ -265,3 +286,56 @@ class _MaterialMapping(Mapping):
         return repr(dict(self))
 
 materials = _MaterialMapping()
+
+
+def set_material_densities(materials, densities, nuclides=None,
+                           units='atom/b-cm'):
+    """Set the densities of many materials at once
+
+    The densities are set in parallel with a single call to the library,
+    which is much faster than calling :meth:`Material.set_density` or
+    :meth:`Material.set_densities` for each material. Each material may only
+    be given once.
+
+    Parameters
+    ----------
+    materials : iterable of openmc.lib.Material
+        Distinct materials whose densities are set
+    densities : iterable of float or iterable of iterable of float
+        If `nuclides` is not given, the total density of each material.
+        Otherwise, the density in atom/b-cm of each nuclide of each material.
+    nuclides : iterable of iterable of str, optional
+        Names of the nuclides of each material
+    units : {'atom/b-cm', 'g/cm3'}
+        Units of the total densities. Only used when `nuclides` is not given.
+
+    """
+    index = np.array([m._index for m in materials], dtype=np.int32)
+    ip = index.ctypes.data_as(POINTER(c_int32))
+
+    if nuclides is None:
+        d = np.ascontiguousarray(densities, dtype=float)
+        if d.shape != index.shape:
+            raise ValueError('A density must be given for each material.')
+        _dll.openmc_materials_set_density(
+            len(index), ip, d.ctypes.data_as(POINTER(c_double)),
+            units.encode())
+        return
+
+    nuclides = [list(nucs) for nucs in nuclides]
+    densities = [list(dens) for dens in densities]
+    if len(nuclides) != len(index) or len(densities) != len(index):
+        raise ValueError('Nuclides and densities must be given for each '
+                         'material.')
+    n_nuclide = np.array([len(nucs) for nucs in nuclides], dtype=np.intc)
+    if any(len(dens) != len(nucs) for nucs, dens in zip(nuclides, densities)):
+        raise ValueError('A density must be given for each nuclide.')
+
+    # Flatten the nuclide names and densities of all materials
+    nucs = (c_char_p * int(n_nuclide.sum()))()
+    nucs[:] = [x.encode() for names in nuclides for x in names]
+    d = np.array([x for dens in densities for x in dens], dtype=float)
+
+    _dll.openmc_materials_set_densities(
+        len(index), ip, n_nuclide.ctypes.data_as(POINTER(c_int)), nucs,
+        d.ctypes.data_as(POINTER(c_double)))
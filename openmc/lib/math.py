@@ -42,6 +42,14 @@ _dll.broaden_wmp_polynomials.argtypes = [c_double, c_double, c_int,
 _dll.normal_variate.restype = c_double
 _dll.normal_variate.argtypes = [c_double, c_double, POINTER(c_uint64)]
 
+_dll.faddeeva_c.restype = None
+_dll.faddeeva_c.argtypes = [c_double, c_double, ndpointer(c_double)]
+
+_dll.faddeeva_batch.restype = None
+_dll.faddeeva_batch.argtypes = [c_int, ndpointer(c_double),
+                                ndpointer(c_double), ndpointer(c_double),
+                                ndpointer(c_double)]
+
 def t_percentile(p, df):
     """ Calculate the percentile of the Student's t distribution with a
     specified probability level and number of degrees of freedom
@@ -320,3 +328,49 @@ def broaden_wmp_polynomials(E, dopp, n):
     factors = np.zeros(n, dtype=np.float64)
     _dll.broaden_wmp_polynomials(E, dopp, n, factors)
     return factors
+
+
+def faddeeva(z):
+    """ Evaluate the Faddeeva function in the integral form used by the
+    windowed multipole method
+
+    Parameters
+    ----------
+    z : complex
+        Argument of the function
+
+    Returns
+    -------
+    complex
+        Faddeeva function evaluated at z
+
+    """
+
+    w = np.zeros(2, dtype=np.float64)
+    _dll.faddeeva_c(z.real, z.imag, w)
+    return complex(w[0], w[1])
+
+
+def faddeeva_batch(z):
+    """ Evaluate the Faddeeva function at many arguments at once with the
+    rational approximation used by vectorized multipole evaluation
+
+    Parameters
+    ----------
+    z : iterable of complex
+        Arguments of the function
+
+    Returns
+    -------
+    numpy.ndarray
+        Faddeeva function evaluated at each argument
+
+    """
+
+    z = np.asarray(z, dtype=np.complex128)
+    z_re = np.ascontiguousarray(z.real)
+    z_im = np.ascontiguousarray(z.imag)
+    w_re = np.zeros(z.size, dtype=np.float64)
+    w_im = np.zeros(z.size, dtype=np.float64)
+    _dll.faddeeva_batch(z.size, z_re, z_im, w_re, w_im)
+    return w_re + 1j*w_im
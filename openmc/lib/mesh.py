@@ -1,5 +1,5 @@
 from collections.abc import Mapping
-from ctypes import c_int, c_int32, c_double, POINTER
+from ctypes import c_int, c_int32, c_double, c_size_t, POINTER
 from weakref import WeakValueDictionary
 
 from numpy.ctypeslib import as_array
@@ -9,7 +9,7 @@ from . import _dll
 from .core import _FortranObjectWithID
 from .error import _error_handler
 
-__all__ = ['RegularMesh', 'meshes']
+__all__ = ['RegularMesh', 'meshes', 'set_mesh_field']
 
 # Mesh functions
 _dll.openmc_extend_meshes.argtypes = [c_int32, POINTER(c_int32), POINTER(c_int32)]
@@ -41,6 +41,10 @@ _dll.openmc_get_mesh_index.restype = c_int
 _dll.openmc_get_mesh_index.errcheck = _error_handler
 _dll.n_meshes.argtypes = []
 _dll.n_meshes.restype = c_int
+_dll.openmc_mesh_field_set_data.argtypes = [
+    c_int32, c_size_t, POINTER(c_double), POINTER(c_double)]
+_dll.openmc_mesh_field_set_data.restype = c_int
+_dll.openmc_mesh_field_set_data.errcheck = _error_handler
 
 
 class RegularMesh(_FortranObjectWithID):
@@ -181,3 +185,34 @@ class _MeshMapping(Mapping):
         return repr(dict(self))
 
 meshes = _MeshMapping()
+
+
+def set_mesh_field(field_id, temperatures=None, density_multipliers=None):
+    """Set the values of a mesh field in all of its bins at once
+
+    Parameters
+    ----------
+    field_id : int
+        ID of the mesh field
+    temperatures : iterable of float, optional
+        Temperature in [K] of each mesh bin. Bins with a non-positive
+        temperature keep the temperature of their cell. If not given, the
+        temperatures are left unchanged.
+    density_multipliers : iterable of float, optional
+        Factor multiplying the density of the material in each mesh bin. If
+        not given, the multipliers are left unchanged.
+
+    """
+    n = None
+    args = []
+    for values in (temperatures, density_multipliers):
+        if values is not None:
+            if n is not None and len(values) != n:
+                raise ValueError('The temperatures and density multipliers '
+                                 'of a mesh field must have the same length.')
+            n = len(values)
+            values = (c_double*n)(*values)
+        args.append(values)
+    if n is None:
+        return
+    _dll.openmc_mesh_field_set_data(field_id, n, *args)
@@ -1,7 +1,9 @@
 from collections.abc import Mapping
-from ctypes import c_int, c_char_p, POINTER, c_size_t
+from ctypes import c_int, c_char_p, c_double, POINTER, c_size_t
 from weakref import WeakValueDictionary
 
+import numpy as np
+
 from ..exceptions import DataError, AllocationError
 from . import _dll
 from .core import _FortranObject
@@ -17,6 +19,10 @@ _dll.openmc_get_nuclide_index.errcheck = _error_handler
 _dll.openmc_load_nuclide.argtypes = [c_char_p]
 _dll.openmc_load_nuclide.restype = c_int
 _dll.openmc_load_nuclide.errcheck = _error_handler
+_dll.openmc_nuclide_group_xs.argtypes = [
+    c_int, c_int, c_double, POINTER(c_double), c_size_t, POINTER(c_double)]
+_dll.openmc_nuclide_group_xs.restype = c_int
+_dll.openmc_nuclide_group_xs.errcheck = _error_handler
 _dll.openmc_nuclide_name.argtypes = [c_int, POINTER(c_char_p)]
 _dll.openmc_nuclide_name.restype = c_int
 _dll.openmc_nuclide_name.errcheck = _error_handler
@@ -70,6 +76,37 @@ class Nuclide(_FortranObject):
         _dll.openmc_nuclide_name(self._index, name)
         return name.value.decode()
 
+    def group_xs(self, mt, temperature, energies):
+        """Average the cross section of a reaction over energy groups
+
+        The pointwise cross section is averaged over each group with a flux
+        that is constant in energy within the group, so that the reaction
+        rate per atom in a multigroup flux spectrum is the dot product of the
+        group cross sections with the group fluxes.
+
+        Parameters
+        ----------
+        mt : int
+            ENDF MT value of the reaction
+        temperature : float
+            Temperature in [K]
+        energies : iterable of float
+            Group boundaries in [eV] in increasing order
+
+        Returns
+        -------
+        numpy.ndarray
+            Average cross section in each group in [b]
+
+        """
+        energies = np.ascontiguousarray(energies, dtype=float)
+        xs = np.zeros(len(energies) - 1)
+        _dll.openmc_nuclide_group_xs(
+            self._index, mt, temperature,
+            energies.ctypes.data_as(POINTER(c_double)), len(xs),
+            xs.ctypes.data_as(POINTER(c_double)))
+        return xs
+
 
 class _NuclideMapping(Mapping):
     """Provide mapping from nuclide name to index in nuclides array."""
@@ -62,6 +62,8 @@ class _PlotBase(Structure):
         The resolution of the plot in the horizontal and vertical dimensions
     level_ : c_int
         The universe level for the plot view
+    ray_trace_ : c_bool
+        Whether rays are traced along rows instead of locating each pixel
 
     Attributes
     ----------
@@ -86,11 +88,13 @@ class _PlotBase(Structure):
                 ('basis_', c_int),
                 ('pixels_', 3*c_size_t),
                 ('color_overlaps_', c_bool),
-                ('level_', c_int)]
+                ('level_', c_int),
+                ('ray_trace_', c_bool)]
 
     def __init__(self):
         self.level_ = -1
         self.color_overlaps_ = False
+        self.ray_trace_ = False
 
     @property
     def origin(self):
@@ -213,9 +217,56 @@ class _PlotBase(Structure):
 _dll.openmc_id_map.argtypes = [POINTER(_PlotBase), POINTER(c_int32)]
 _dll.openmc_id_map.restype = c_int
 _dll.openmc_id_map.errcheck = _error_handler
+_dll.openmc_set_plot_cache.argtypes = [c_bool]
+_dll.openmc_set_plot_cache.restype = c_int
+_dll.openmc_set_plot_cache.errcheck = _error_handler
 
 
-def id_map(plot):
+def set_plot_cache(enable=True):
+    """Enable or disable the tile cache of in-memory plots
+
+    When the cache is enabled, :func:`id_map` and :func:`property_map` store
+    the maps they generate in tiles and only compute the tiles that are not
+    cached yet. Panning a plot by a whole number of pixels then only computes
+    the newly exposed part of it. Calling this function clears the cache, which
+    must be done whenever the model is changed.
+
+    Parameters
+    ----------
+    enable : bool
+        Whether to cache the tiles of plots
+
+    """
+    _dll.openmc_set_plot_cache(enable)
+
+
+def _coarse_plot(plot, coarsening):
+    """Return a plot of the same region with pixels coarsening times larger,
+    sharing the top-left corner of the plot"""
+    in_i, out_i = {1: (0, 1), 2: (0, 2), 3: (1, 2)}[plot.basis_]
+    coarse = _PlotBase()
+    coarse.basis_ = plot.basis_
+    coarse.level_ = plot.level_
+    coarse.color_overlaps_ = plot.color_overlaps_
+    coarse.ray_trace_ = plot.ray_trace_
+    coarse.h_res = -(-plot.h_res // coarsening)
+    coarse.v_res = -(-plot.v_res // coarsening)
+    coarse.width = coarse.h_res*coarsening*plot.width/plot.h_res
+    coarse.height = coarse.v_res*coarsening*plot.height/plot.v_res
+    origin = list(plot.origin)
+    origin[in_i] += (coarse.width - plot.width)/2
+    origin[out_i] -= (coarse.height - plot.height)/2
+    coarse.origin = origin
+    return coarse
+
+
+def _refine(data, plot, coarsening):
+    """Expand a coarse map to the resolution of a plot"""
+    data = np.repeat(np.repeat(data, coarsening, axis=0), coarsening, axis=1)
+    return np.ascontiguousarray(data[:plot.v_res, :plot.h_res])
+
+
+def id_map(plot, coarsening=1):
     """
     Generate a 2-D map of cell and material IDs. Used for in-memory image
     generation.
@@ -224,6 +275,12 @@ def id_map(plot):
     ----------
     plot : openmc.lib.plot._PlotBase
         Object describing the slice of the model to be generated
+    coarsening : int
+        Factor by which the resolution of the map is reduced. Each block of
+        coarsening by coarsening pixels is given the values at the center of
+        the block, which gives a quick low-resolution preview of the plot
+        that can be refined by calling this function again with a smaller
+        factor.
 
     Returns
     -------
@@ -232,6 +289,9 @@ def id_map(plot):
         OpenMC property ids with dtype int32
 
     """
+    if coarsening > 1:
+        return _refine(id_map(_coarse_plot(plot, coarsening)), plot,
+                       coarsening)
     img_data = np.zeros((plot.v_res, plot.h_res, 2),
                         dtype=np.dtype('int32'))
     _dll.openmc_id_map(plot, img_data.ctypes.data_as(POINTER(c_int32)))
@@ -243,7 +303,7 @@ _dll.openmc_property_map.restype = c_int
 _dll.openmc_property_map.errcheck = _error_handler
 
 
-def property_map(plot):
+def property_map(plot, coarsening=1):
     """
     Generate a 2-D map of cell temperatures and material densities. Used for
     in-memory image generation.
@@ -252,6 +312,9 @@ def property_map(plot):
     ----------
     plot : openmc.lib.plot._PlotBase
         Object describing the slice of the model to be generated
+    coarsening : int
+        Factor by which the resolution of the map is reduced, as for
+        :func:`id_map`
 
     Returns
     -------
@@ -260,6 +323,9 @@ def property_map(plot):
         OpenMC property ids with dtype float
 
     """
+    if coarsening > 1:
+        return _refine(property_map(_coarse_plot(plot, coarsening)), plot,
+                       coarsening)
     prop_data = np.zeros((plot.v_res, plot.h_res, 2))
     _dll.openmc_property_map(plot, prop_data.ctypes.data_as(POINTER(c_double)))
     return prop_data
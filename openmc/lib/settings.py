@@ -20,10 +20,13 @@ class _Settings:
     entropy_on = _DLLGlobal(c_bool, 'entropy_on')
     generations_per_batch = _DLLGlobal(c_int32, 'gen_per_batch')
     inactive = _DLLGlobal(c_int32, 'n_inactive')
+    instrument = _DLLGlobal(c_bool, 'instrument')
     max_lost_particles = _DLLGlobal(c_int32, 'max_lost_particles')
     rel_max_lost_particles = _DLLGlobal(c_double, 'rel_max_lost_particles')
     particles = _DLLGlobal(c_int64, 'n_particles')
     restart_run = _DLLGlobal(c_bool, 'restart_run')
+    retain_data = _DLLGlobal(c_bool, 'retain_data')
+    reuse_source = _DLLGlobal(c_bool, 'reuse_source')
     run_CE = _DLLGlobal(c_bool, 'run_CE')
     verbosity = _DLLGlobal(c_int, 'verbosity')
     output_summary = _DLLGlobal(c_bool, 'output_summary')
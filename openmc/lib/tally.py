@@ -63,6 +63,10 @@ _dll.openmc_tally_results.argtypes = [
     c_int32, POINTER(POINTER(c_double)), POINTER(c_size_t*3)]
 _dll.openmc_tally_results.restype = c_int
 _dll.openmc_tally_results.errcheck = _error_handler
+_dll.openmc_tally_statistics.argtypes = [
+    c_int32, POINTER(POINTER(c_double)), POINTER(c_size_t*3)]
+_dll.openmc_tally_statistics.restype = c_int
+_dll.openmc_tally_statistics.errcheck = _error_handler
 _dll.openmc_tally_set_active.argtypes = [c_int32, c_bool]
 _dll.openmc_tally_set_active.restype = c_int
 _dll.openmc_tally_set_active.errcheck = _error_handler
@@ -176,7 +180,13 @@ class Tally(_FortranObjectWithID):
     num_realizations : int
         Number of realizations
     results : numpy.ndarray
-        Array of tally results
+        Sum (last index 0) and sum of squares (last index 1) of the
+        realizations of each bin
+    statistics : numpy.ndarray
+        Sample mean (last index 0) and standard deviation (last index 1) of
+        each bin, computed by the library. The array is a view of a buffer
+        owned by the tally that is overwritten the next time the attribute is
+        accessed.
     std_dev : numpy.ndarray
         An array containing the sample standard deviation for each bin
     type : str
@@ -270,7 +280,7 @@ class Tally(_FortranObjectWithID):
     @property
     def mean(self):
         n = self.num_realizations
-        sum_ = self.results[:, :, 1]
+        sum_ = self.results[:, :, 0]
         if n > 0:
             return sum_ / n
         else:
@@ -303,6 +313,13 @@ class Tally(_FortranObjectWithID):
         _dll.openmc_tally_results(self._index, data, shape)
         return as_array(data, tuple(shape))
 
+    @property
+    def statistics(self):
+        data = POINTER(c_double)()
+        shape = (c_size_t*3)()
+        _dll.openmc_tally_statistics(self._index, data, shape)
+        return as_array(data, tuple(shape))
+
     @property
     def scores(self):
         scores_as_int = POINTER(c_int)()
@@ -337,8 +354,8 @@ class Tally(_FortranObjectWithID):
         n = self.num_realizations
         if n > 1:
             # Get sum and sum-of-squares from results
-            sum_ = results[:, :, 1]
-            sum_sq = results[:, :, 2]
+            sum_ = results[:, :, 0]
+            sum_sq = results[:, :, 1]
 
             # Determine non-zero entries
             mean = sum_ / n
@@ -85,6 +85,19 @@ class Material(IDManagerMixin):
     fissionable_mass : float
         Mass of fissionable nuclides in the material in [g]. Requires that the
         :attr:`volume` attribute is set.
+    union_grid : bool
+        Indicate whether cross section lookups in this material should use a
+        unionized energy grid. This trades memory for faster lookups in
+        materials with many nuclides.
+
+        .. versionadded:: 0.12
+    xs_table : bool
+        Indicate whether the macroscopic cross sections of this material should
+        be tabulated so that lookups do not evaluate each nuclide. This is
+        intended for materials whose composition and temperature do not change,
+        such as moderators and structural materials.
+
+        .. versionadded:: 0.12
 
     """
 
@@ -99,6 +112,8 @@ class Material(IDManagerMixin):
         self._density = None
         self._density_units = 'sum'
         self._depletable = False
+        self._union_grid = False
+        self._xs_table = False
         self._paths = None
         self._num_instances = None
         self._volume = None
@@ -161,6 +176,14 @@ class Material(IDManagerMixin):
     def depletable(self):
         return self._depletable
 
+    @property
+    def union_grid(self):
+        return self._union_grid
+
+    @property
+    def xs_table(self):
+        return self._xs_table
+
     @property
     def paths(self):
         if self._paths is None:
@@ -226,6 +249,18 @@ class Material(IDManagerMixin):
                       depletable, bool)
         self._depletable = depletable
 
+    @union_grid.setter
+    def union_grid(self, union_grid):
+        cv.check_type('Union grid flag for Material ID="{}"'.format(self.id),
+                      union_grid, bool)
+        self._union_grid = union_grid
+
+    @xs_table.setter
+    def xs_table(self, xs_table):
+        cv.check_type('Cross section table flag for Material ID="{}"'.format(
+            self.id), xs_table, bool)
+        self._xs_table = xs_table
+
     @volume.setter
     def volume(self, volume):
         if volume is not None:
@@ -945,6 +980,12 @@ class Material(IDManagerMixin):
         if self._depletable:
             element.set("depletable", "true")
 
+        if self._union_grid:
+            element.set("union_grid", "true")
+
+        if self._xs_table:
+            element.set("xs_table", "true")
+
         if self._volume:
             element.set("volume", str(self._volume))
 
@@ -1104,6 +1145,8 @@ class Material(IDManagerMixin):
         if 'volume' in elem.attrib:
             mat.volume = float(elem.get('volume'))
         mat.depletable = bool(elem.get('depletable'))
+        mat.union_grid = elem.get('union_grid') in ('true', '1')
+        mat.xs_table = elem.get('xs_table') in ('true', '1')
 
         # Get each nuclide
         for nuclide in elem.findall('nuclide'):
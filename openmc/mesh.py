@@ -80,6 +80,8 @@ class MeshBase(IDManagerMixin, ABC):
             return RegularMesh.from_hdf5(group)
         elif mesh_type == 'rectilinear':
             return RectilinearMesh.from_hdf5(group)
+        elif mesh_type == 'adaptive':
+            return AdaptiveMesh.from_hdf5(group)
         elif mesh_type == 'unstructured':
             return UnstructuredMesh.from_hdf5(group)
         else:
@@ -455,6 +457,182 @@ def Mesh(*args, **kwargs):
     return RegularMesh(*args, **kwargs)
 
 
+class AdaptiveMesh(RegularMesh):
+    """A regular Cartesian mesh whose elements are refined between batches
+
+    Elements where the tallies over the mesh score high with a low enough
+    relative error are divided in two along each axis between active batches,
+    as long as the bins of their children fit in :attr:`max_bins`. The bins of
+    the mesh are its elements of all levels, the first being those of the
+    root mesh described by the attributes inherited from
+    :class:`openmc.RegularMesh`.
+
+    .. versionadded:: 0.12
+
+    Parameters
+    ----------
+    mesh_id : int
+        Unique identifier for the mesh
+    name : str
+        Name of the mesh
+
+    Attributes
+    ----------
+    max_bins : int
+        Number of bins of the mesh, which bounds the number of elements of all
+        levels
+    refine_threshold : float
+        Mean score relative to the highest of any element that an element
+        must reach to be divided
+    refine_rel_error : float
+        Largest relative error of the score of an element that is divided
+    refine_batches : int
+        Number of realizations the tallies over the mesh accumulate before
+        elements are considered for division
+    levels : numpy.ndarray or None
+        Number of divisions from the root mesh of each element in use, as read
+        from a statepoint
+    element_indices : numpy.ndarray or None
+        Indices of each element in use among the elements of its level, as
+        read from a statepoint
+    children : numpy.ndarray or None
+        Bin of the first child of each element in use or -1 if it is not
+        divided, as read from a statepoint
+    indices : Iterable of tuple
+        An iterable of the bin of each element, e.g. [(1,), (2,), ...]
+
+    """
+
+    def __init__(self, mesh_id=None, name=''):
+        super().__init__(mesh_id, name)
+
+        self._max_bins = None
+        self._refine_threshold = None
+        self._refine_rel_error = None
+        self._refine_batches = None
+        self.levels = None
+        self.element_indices = None
+        self.children = None
+
+    @property
+    def max_bins(self):
+        if self._max_bins is None and self._dimension is not None:
+            return int(np.prod(self._dimension))
+        return self._max_bins
+
+    @property
+    def refine_threshold(self):
+        return self._refine_threshold
+
+    @property
+    def refine_rel_error(self):
+        return self._refine_rel_error
+
+    @property
+    def refine_batches(self):
+        return self._refine_batches
+
+    @property
+    def num_mesh_cells(self):
+        return self.max_bins
+
+    @property
+    def indices(self):
+        return ((i,) for i in range(1, self.max_bins + 1))
+
+    @max_bins.setter
+    def max_bins(self, max_bins):
+        cv.check_type('adaptive mesh max_bins', max_bins, Integral)
+        cv.check_greater_than('adaptive mesh max_bins', max_bins, 0)
+        self._max_bins = max_bins
+
+    @refine_threshold.setter
+    def refine_threshold(self, threshold):
+        cv.check_type('adaptive mesh refine_threshold', threshold, Real)
+        cv.check_greater_than('adaptive mesh refine_threshold', threshold, 0.0,
+                              True)
+        self._refine_threshold = threshold
+
+    @refine_rel_error.setter
+    def refine_rel_error(self, rel_error):
+        cv.check_type('adaptive mesh refine_rel_error', rel_error, Real)
+        cv.check_greater_than('adaptive mesh refine_rel_error', rel_error, 0.0)
+        self._refine_rel_error = rel_error
+
+    @refine_batches.setter
+    def refine_batches(self, batches):
+        cv.check_type('adaptive mesh refine_batches', batches, Integral)
+        cv.check_greater_than('adaptive mesh refine_batches', batches, 2, True)
+        self._refine_batches = batches
+
+    def __repr__(self):
+        string = super().__repr__()
+        string += '{0: <16}{1}{2}\n'.format('\tMax Bins', '=\t', self.max_bins)
+        return string
+
+    @classmethod
+    def from_hdf5(cls, group):
+        mesh = super().from_hdf5(group)
+        mesh.max_bins = int(group['max_bins'][()])
+        mesh.levels = group['levels'][()]
+        mesh.element_indices = group['indices'][()]
+        mesh.children = group['children'][()]
+        return mesh
+
+    def to_xml_element(self):
+        """Return XML representation of the mesh
+
+        Returns
+        -------
+        element : xml.etree.ElementTree.Element
+            XML element containing mesh data
+
+        """
+        element = super().to_xml_element()
+        element.set("type", "adaptive")
+
+        for attr in ('max_bins', 'refine_threshold', 'refine_rel_error',
+                     'refine_batches'):
+            value = getattr(self, '_' + attr)
+            if value is not None:
+                subelement = ET.SubElement(element, attr)
+                subelement.text = str(value)
+
+        return element
+
+    @classmethod
+    def from_xml_element(cls, elem):
+        """Generate mesh from an XML element
+
+        Parameters
+        ----------
+        elem : xml.etree.ElementTree.Element
+            XML element
+
+        Returns
+        -------
+        openmc.AdaptiveMesh
+            Mesh generated from XML element
+
+        """
+        mesh = super().from_xml_element(elem)
+
+        max_bins = get_text(elem, 'max_bins')
+        if max_bins is not None:
+            mesh.max_bins = int(max_bins)
+        threshold = get_text(elem, 'refine_threshold')
+        if threshold is not None:
+            mesh.refine_threshold = float(threshold)
+        rel_error = get_text(elem, 'refine_rel_error')
+        if rel_error is not None:
+            mesh.refine_rel_error = float(rel_error)
+        batches = get_text(elem, 'refine_batches')
+        if batches is not None:
+            mesh.refine_batches = int(batches)
+
+        return mesh
+
+
 class RectilinearMesh(MeshBase):
     """A 3D rectilinear Cartesian mesh
 
@@ -0,0 +1,175 @@
+from collections.abc import Iterable
+from numbers import Integral
+from xml.etree import ElementTree as ET
+
+import numpy as np
+
+import openmc
+import openmc.checkvalue as cv
+from ._xml import get_text
+from .mixin import IDManagerMixin
+
+
+class MeshField(IDManagerMixin):
+    """Temperatures and densities given on the bins of a mesh overlaying cells
+
+    Where a particle in one of the cells of the field is inside the mesh, the
+    temperature and density multiplier of its mesh bin replace the
+    temperature of the cell and scale the density of its material when cross
+    sections are evaluated. This lets a multiphysics code give its fields on
+    its own mesh rather than on a cell per mesh element. The values are
+    evaluated after each collision and surface crossing and, with delta
+    tracking, at each tentative collision, so fields varying within a cell are
+    only followed exactly with delta tracking.
+
+    .. versionadded:: 0.12
+
+    Parameters
+    ----------
+    mesh : openmc.RegularMesh or openmc.UnstructuredMesh
+        Mesh whose bins the values are given on
+    temperatures : Iterable of float, optional
+        Temperature in [K] of each mesh bin. Bins with a non-positive
+        temperature keep the temperature of their cell.
+    density_multipliers : Iterable of float, optional
+        Factor multiplying the density of the material in each mesh bin
+    cells : Iterable of openmc.Cell or int, optional
+        Material cells the field applies to. If not given, it applies to all
+        material cells.
+    field_id : int
+        Unique identifier for the mesh field
+
+    Attributes
+    ----------
+    id : int
+        Unique identifier for the mesh field
+    mesh : openmc.RegularMesh or openmc.UnstructuredMesh
+        Mesh whose bins the values are given on
+    temperatures : numpy.ndarray or None
+        Temperature in [K] of each mesh bin
+    density_multipliers : numpy.ndarray or None
+        Factor multiplying the density of the material in each mesh bin
+    cells : list of int or None
+        IDs of the material cells the field applies to
+
+    """
+
+    next_id = 1
+    used_ids = set()
+
+    def __init__(self, mesh, temperatures=None, density_multipliers=None,
+                 cells=None, field_id=None):
+        self.id = field_id
+        self.mesh = mesh
+        self.temperatures = temperatures
+        self.density_multipliers = density_multipliers
+        self.cells = cells
+
+    @property
+    def mesh(self):
+        return self._mesh
+
+    @property
+    def temperatures(self):
+        return self._temperatures
+
+    @property
+    def density_multipliers(self):
+        return self._density_multipliers
+
+    @property
+    def cells(self):
+        return self._cells
+
+    @mesh.setter
+    def mesh(self, mesh):
+        cv.check_type('mesh field mesh', mesh,
+                      (openmc.RegularMesh, openmc.UnstructuredMesh))
+        self._mesh = mesh
+
+    def _check_values(self, name, values):
+        values = np.asarray(values, dtype=float).ravel()
+        if isinstance(self.mesh, openmc.RegularMesh) and \
+                values.size != self.mesh.num_mesh_cells:
+            raise ValueError('The number of {} of a mesh field must be the '
+                             'number of mesh cells.'.format(name))
+        return values
+
+    @temperatures.setter
+    def temperatures(self, temperatures):
+        if temperatures is not None:
+            temperatures = self._check_values('temperatures', temperatures)
+        self._temperatures = temperatures
+
+    @density_multipliers.setter
+    def density_multipliers(self, multipliers):
+        if multipliers is not None:
+            multipliers = self._check_values('density multipliers',
+                                             multipliers)
+            if (multipliers < 0.0).any():
+                raise ValueError('Density multipliers of a mesh field must '
+                                 'not be negative.')
+        self._density_multipliers = multipliers
+
+    @cells.setter
+    def cells(self, cells):
+        if cells is not None:
+            cv.check_type('mesh field cells', cells, Iterable,
+                          (openmc.Cell, Integral))
+            cells = [c.id if isinstance(c, openmc.Cell) else c for c in cells]
+        self._cells = cells
+
+    def to_xml_element(self):
+        """Return XML representation of the mesh field
+
+        Returns
+        -------
+        element : xml.etree.ElementTree.Element
+            XML element containing mesh field data
+
+        """
+        element = ET.Element('mesh_field')
+        element.set('id', str(self.id))
+
+        subelement = ET.SubElement(element, 'mesh')
+        subelement.text = str(self.mesh.id)
+
+        if self.cells is not None:
+            subelement = ET.SubElement(element, 'cells')
+            subelement.text = ' '.join(str(c) for c in self.cells)
+
+        for key in ('temperatures', 'density_multipliers'):
+            values = getattr(self, key)
+            if values is not None:
+                subelement = ET.SubElement(element, key)
+                subelement.text = ' '.join(str(x) for x in values)
+
+        return element
+
+    @classmethod
+    def from_xml_element(cls, elem, mesh):
+        """Generate a mesh field from an XML element
+
+        Parameters
+        ----------
+        elem : xml.etree.ElementTree.Element
+            XML element
+        mesh : openmc.RegularMesh or openmc.UnstructuredMesh
+            Mesh whose bins the values are given on
+
+        Returns
+        -------
+        openmc.MeshField
+            Mesh field generated from XML element
+
+        """
+        field_id = int(get_text(elem, 'id'))
+        kwargs = {}
+        for key in ('temperatures', 'density_multipliers'):
+            text = get_text(elem, key)
+            if text is not None:
+                kwargs[key] = [float(x) for x in text.split()]
+        text = get_text(elem, 'cells')
+        if text is not None:
+            kwargs['cells'] = [int(c) for c in text.split()]
+        return cls(mesh, field_id=field_id, **kwargs)
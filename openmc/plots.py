@@ -218,6 +218,10 @@ class Plot(IDManagerMixin):
     meshlines : dict
         Dictionary defining type, id, linewidth and color of a mesh to be
         plotted on top of a plot
+    ray_trace : bool
+        Indicate whether rays are traced along each row of pixels instead of
+        locating each pixel in the geometry, which is much faster for large
+        plots. Pixels are still located one by one when overlaps are shown.
 
     """
 
@@ -243,6 +247,7 @@ class Plot(IDManagerMixin):
         self._colors = {}
         self._level = None
         self._meshlines = None
+        self._ray_trace = False
 
     @property
     def name(self):
@@ -308,6 +313,10 @@ class Plot(IDManagerMixin):
     def meshlines(self):
         return self._meshlines
 
+    @property
+    def ray_trace(self):
+        return self._ray_trace
+
     @name.setter
     def name(self, name):
         cv.check_type('plot name', name, str)
@@ -394,6 +403,11 @@ class Plot(IDManagerMixin):
         cv.check_greater_than('plot level', plot_level, 0, equality=True)
         self._level = plot_level
 
+    @ray_trace.setter
+    def ray_trace(self, ray_trace):
+        cv.check_type('plot ray tracing flag', ray_trace, bool)
+        self._ray_trace = ray_trace
+
     @meshlines.setter
     def meshlines(self, meshlines):
         cv.check_type('plot meshlines', meshlines, dict)
@@ -456,6 +470,7 @@ class Plot(IDManagerMixin):
         string += '{: <16}=\t{}\n'.format('\tColors', self._colors)
         string += '{: <16}=\t{}\n'.format('\tLevel', self._level)
         string += '{: <16}=\t{}\n'.format('\tMeshlines', self._meshlines)
+        string += '{: <16}=\t{}\n'.format('\tRay trace', self._ray_trace)
         return string
 
     @classmethod
@@ -669,6 +684,10 @@ class Plot(IDManagerMixin):
                 subelement.set("color", ' '.join(map(
                     str, self._meshlines['color'])))
 
+        if self._ray_trace:
+            subelement = ET.SubElement(element, "ray_trace")
+            subelement.text = "true"
+
         return element
 
     def to_ipython_image(self, openmc_exec='openmc', cwd='.',
@@ -5,7 +5,8 @@ from numbers import Real, Integral
 from xml.etree import ElementTree as ET
 
 import openmc.checkvalue as cv
-from . import VolumeCalculation, Source, RegularMesh
+from . import (VolumeCalculation, Source, RegularMesh, UnstructuredMesh,
+               WeightWindows, MeshField)
 from ._xml import clean_indentation, get_text
 
 
@@ -25,37 +26,136 @@ class Settings:
 
     Attributes
     ----------
+    alias_sampling : bool
+        Whether discrete and tabular distributions with many outcomes and the
+        energies of thick-target bremsstrahlung photons are sampled with alias
+        tables rather than by searching their cumulative distribution
+        functions.
+
+        .. versionadded:: 0.12
+    async_statepoint : bool
+        Whether the tally results and source bank of state points written
+        during the simulation are written to the file on a background thread so
+        that the next batch can start immediately.
+
+        .. versionadded:: 0.12
+    async_summary : bool
+        Whether to write the summary file on a background thread while the
+        simulation runs.
+
+        .. versionadded:: 0.12
+    azimuth_rejection : bool
+        Whether azimuthal angles of scattered particles and isotropic
+        directions are sampled by rejection in the unit disk rather than with
+        trigonometric functions.
+
+        .. versionadded:: 0.12
     batches : int
         Number of batches to simulate
+    broadcast_data : bool
+        Whether continuous-energy nuclear data files are read by the master MPI
+        process only and broadcast to the other processes
+
+        .. versionadded:: 0.12
+    census : dict
+        Options for banking the particles that reach a census time, which are
+        written to census.h5 at the end of the simulation to serve as the
+        source of the next time step. Accepted keys are 'time' (float), the
+        census time in [s], and 'max_particles' (int), the maximum number of
+        sites banked on each process over all active batches, which defaults
+        to the number of particles of the process in all active batches.
+
+        .. versionadded:: 0.12
+    cmfd : dict
+        Settings for coarse mesh finite difference (CMFD) acceleration of the
+        fission source during inactive batches. Accepted keys are 'mesh'
+        (:class:`openmc.RegularMesh`), 'energy_groups' (iterable of float) and
+        'begin' (int). The 'energy_groups' are the boundaries of the CMFD
+        energy groups in [eV]; a single group is used if they are not given.
+        The 'begin' value is the first batch in which CMFD feedback is applied.
+
+        .. versionadded:: 0.12
+    compact_xs_cache : bool
+        If True, each particle only caches microscopic cross sections for the
+        nuclides in its current material, which limits the memory per particle
+        to that needed by the largest material.
+
+        .. versionadded:: 0.12
+    compton_tables : bool
+        Whether to sample Compton scattering from precomputed tables, i.e., a
+        tabulated inverse CDF of the Klein-Nishina distribution and indexed
+        Compton profiles, rather than by rejection sampling and searches.
+
+        .. versionadded:: 0.12
     confidence_intervals : bool
         If True, uncertainties on tally results will be reported as the
         half-width of the 95% two-sided confidence interval. If False,
         uncertainties on tally results will be reported as the sample standard
         deviation.
+    correlated_alias : bool
+        Whether to sample the outgoing energy of correlated angle-energy
+        distributions with precomputed alias tables rather than by searching
+        their cumulative distribution.
+
+        .. versionadded:: 0.12
     create_fission_neutrons : bool
         Indicate whether fission neutrons should be created or not.
+    cumulative_xs : bool
+        Whether to store the cumulative macroscopic total cross section of the
+        nuclides of a material during cross section lookups so that the
+        collision nuclide is sampled with a binary search.
+
+        .. versionadded:: 0.12
     cutoff : dict
-        Dictionary defining weight cutoff and energy cutoff. The dictionary may
-        have six keys, 'weight', 'weight_avg', 'energy_neutron', 'energy_photon',
-        'energy_electron', and 'energy_positron'. Value for 'weight'
+        Dictionary defining weight cutoff, energy cutoff and time cutoff. The
+        dictionary may have ten keys, 'weight', 'weight_avg', 'energy_neutron',
+        'energy_photon', 'energy_electron', 'energy_positron', 'time_neutron',
+        'time_photon', 'time_electron', and 'time_positron'. Value for 'weight'
         should be a float indicating weight cutoff below which particle undergo
         Russian roulette. Value for 'weight_avg' should be a float indicating
         weight assigned to particles that are not killed after Russian
         roulette. Value of energy should be a float indicating energy in eV
-        below which particle type will be killed.
+        below which particle type will be killed. Value of time should be a
+        float indicating the time in seconds since the birth of a history
+        after which particle type will be killed.
     dagmc : bool
         Indicate that a CAD-based DAGMC geometry will be used.
+    dagmc_bvh : bool
+        Whether distances to the boundaries of DAGMC volumes are found with
+        bounding volume hierarchies of their triangles built by OpenMC rather
+        than with DAGMC ray fire
+
+        .. versionadded:: 0.12
     delayed_photon_scaling : bool
         Indicate whether to scale the fission photon yield by (EGP + EGD)/EGP
         where EGP is the energy release of prompt photons and EGD is the energy
         release of delayed photons.
 
         .. versionadded:: 0.12
-    electron_treatment : {'led', 'ttb'}
-        Whether to deposit all energy from electrons locally ('led') or create
-        secondary bremsstrahlung photons ('ttb').
+    delta_tracking : bool
+        Whether to move neutrons by delta tracking throughout the geometry,
+        sampling collision sites from a majorant of all materials
+
+        .. versionadded:: 0.12
+    domain_mesh : openmc.RegularMesh
+        Mesh whose bins are divided among the MPI processes, each of which only
+        tracks the particles inside its own bins
+
+        .. versionadded:: 0.12
+    electron_treatment : {'led', 'ttb', 'ch'}
+        Whether to deposit all energy from electrons locally ('led'), create
+        secondary bremsstrahlung photons ('ttb'), or transport electrons and
+        positrons with a condensed history method ('ch').
     energy_mode : {'continuous-energy', 'multi-group'}
         Set whether the calculation should be continuous-energy or multi-group.
+    energy_search : {'log-grid', 'hashed'}
+        Method used to search for the energy grid index of each nuclide.
+        'log-grid' performs a binary search within a bin of an
+        equal-logarithmic grid. 'hashed' also divides bins containing many grid
+        points, as in resonance regions, into equal-width sub-bins so that only
+        a few points remain to be searched.
+
+        .. versionadded:: 0.12
     entropy_mesh : openmc.RegularMesh
         Mesh to be used to calculate Shannon entropy. If the mesh dimensions are
         not specified. OpenMC assigns a mesh such that 20 source sites per mesh
@@ -64,12 +164,184 @@ class Settings:
         Indicate whether to use event-based parallelism instead of the default
         history-based parallelism.
 
+        .. versionadded:: 0.12
+    event_batch_distance : bool
+        If True, the event-based advance kernel computes distances to the
+        surfaces of a cell for consecutive particles in that cell together,
+        using SIMD instructions.
+
+        .. versionadded:: 0.12
+    event_fuse_advance : bool
+        If True, the event-based advance kernel also executes the subsequent
+        surface crossing or collision so that particles are only enqueued for
+        their next cross section lookup.
+
+        .. versionadded:: 0.12
+    event_history_threshold : int
+        Number of particles in flight below which the remaining particles of an
+        event-based subiteration are finished using history-based tracking.
+
+        .. versionadded:: 0.12
+    event_local_queue_length : int
+        Number of event queue entries each thread accumulates locally before
+        copying them to the shared event queue when using event-based
+        parallelism. A value of 0 appends directly to the shared queues.
+
+        .. versionadded:: 0.12
+    event_memory_budget : float
+        Memory in MiB per process available to the particles in flight when
+        max_particles_in_flight is 'auto'.
+
+        .. versionadded:: 0.12
+    event_min_queue_length : int
+        Minimum queue length for an event kernel to be run when using
+        event-based parallelism. If all queues are shorter, the longest queue
+        is run.
+
+        .. versionadded:: 0.12
+    event_prefetch_distance : int
+        Number of entries ahead in the event queue that the nuclide data of a
+        cross section lookup is prefetched. A value of 0 disables prefetching.
+
+        .. versionadded:: 0.12
+    event_queue_sort : bool
+        Indicate whether to sort the cross section lookup queues by particle
+        type, material, and energy when using event-based parallelism.
+
+        .. versionadded:: 0.12
+    event_queue_sort_threshold : int
+        Minimum length of a cross section lookup queue for it to be sorted when
+        event_queue_sort is True.
+
+        .. versionadded:: 0.12
+    event_refill : bool
+        If True, buffer slots of particles that die during event-based
+        transport are immediately refilled with new source particles so that
+        the buffer stays full for the entire batch.
+
+        .. versionadded:: 0.12
+    event_scheduler : {'longest', 'round-robin'}
+        Policy used to choose which event kernel to run next when using
+        event-based parallelism. 'longest' runs the kernel with the longest
+        queue and 'round-robin' cycles through the kernels in a fixed order.
+
+        .. versionadded:: 0.12
+    flat_geometry : bool
+        Whether distances to boundaries are found with a flat copy of the CSG
+        geometry held in contiguous arrays. The results are identical to those
+        found with the surface, cell and lattice objects.
+
         .. versionadded:: 0.12
     generations_per_batch : int
         Number of generations per batch
+    history_interleave : int
+        Number of particle histories each thread advances in turn in
+        history-based mode, prefetching the cross section data of each one
+        before switching to the next. A value of 1 runs one history at a time.
+
+        .. versionadded:: 0.12
+    history_scheduler : {'openmp', 'work-stealing'}
+        Method used to distribute particle histories among threads in
+        history-based mode. 'openmp' uses the OpenMP loop schedule given by the
+        OMP_SCHEDULE environment variable, whereas 'work-stealing' uses a
+        scheduler that balances the estimated cost of histories between threads
+        and lets idle threads take work from busy ones.
+
+        .. versionadded:: 0.12
+    huge_pages : bool
+        Whether the energy grids and cross sections of nuclides and the
+        results of tallies should be backed by transparent huge pages to
+        reduce TLB misses. Only applies on Linux.
+
+        .. versionadded:: 0.12
+    instrument : bool
+        Whether the kernel regions marked for Intel VTune or NVIDIA Nsight are
+        reported when OpenMC is built with the itt or nvtx option
+
+        .. versionadded:: 0.12
+    interleaved_xs : bool
+        If True, the energy and all cross section channels of each energy point
+        of a nuclide are stored together in one cache-line-aligned record.
+
+        .. versionadded:: 0.12
+    lazy_products : bool
+        Whether to defer reading the secondary angle-energy distributions of
+        reaction products until a reaction is first sampled.
+
+        .. versionadded:: 0.12
+    load_balance : bool
+        Whether to distribute particles among MPI processes in proportion to
+        their measured throughput in eigenvalue calculations.
+
+        .. versionadded:: 0.12
     max_lost_particles : int
         Maximum number of lost particles
 
+        .. versionadded:: 0.12
+    numa_interleave : bool
+        Whether the pages of nuclear data and tally results should be
+        interleaved among NUMA nodes rather than placed on the node of the
+        master thread, which first touches them. Only applies on Linux.
+
+        .. versionadded:: 0.12
+    particle_ramp : float
+        Fraction of the particles per generation that are simulated in the
+        first inactive batch. The number of particles grows geometrically over
+        the inactive batches and reaches the full number in the first active
+        batch.
+
+        .. versionadded:: 0.12
+    performance_report : bool
+        Whether a machine-readable report of the timers, calculation rates, load
+        balance and memory use is written to performance.h5
+
+        .. versionadded:: 0.12
+    photon_material_tables : bool
+        Whether to tabulate the macroscopic photon cross sections of each
+        material so that a photon lookup is a single interpolation rather than
+        a sum over elements.
+
+        .. versionadded:: 0.12
+    photon_xs_tables : bool
+        Whether to interpolate photon cross sections linearly from tables that
+        are refined to the spacing of the logarithmic energy grid, rather than
+        log-log interpolating them from the data with exponentials.
+
+        .. versionadded:: 0.12
+    pipeline_tallies : bool
+        Whether the reduction of tally results across MPI processes overlaps
+        with the transport of the next batch
+
+        .. versionadded:: 0.12
+    precursor_mesh : openmc.RegularMesh
+        Mesh on which the delayed neutron precursors produced during active
+        batches are tallied by delayed group. Their populations are kept
+        between simulations and advanced in time through :mod:`openmc.lib`.
+
+        .. versionadded:: 0.12
+    private_tallies : bool
+        If True, scores are accumulated in a private buffer for each thread and
+        summed at the end of each batch instead of being added atomically to
+        shared tally results
+
+        .. versionadded:: 0.12
+    private_tallies_max_size : int
+        Largest number of results (filter bins times scores) of a tally for it
+        to be given thread-private buffers when private_tallies is True
+
+        .. versionadded:: 0.12
+    random_ray : dict
+        Settings for the random ray solver, which replaces particle transport
+        in multigroup eigenvalue calculations. Accepted keys are
+        'distance_inactive' and 'distance_active' (float), the lengths in [cm]
+        over which each ray builds up its angular flux and then contributes to
+        the scalar flux.
+
+        .. versionadded:: 0.12
+    random_generator : {'lcg', 'philox'}
+        Pseudorandom number generator, either the linear congruential generator
+        ('lcg') or the counter-based Philox-2x32-10 generator ('philox').
+
         .. versionadded:: 0.12
     rel_max_lost_particles : int
         Maximum number of lost particles, relative to the total number of particles
@@ -90,13 +362,28 @@ class Settings:
         are necessary when a particular instance of a cell needs to be tallied.
 
         .. versionadded:: 0.12
-    max_particles_in_flight : int
+    max_particles_in_flight : int or str
         Number of neutrons to run concurrently when using event-based
-        parallelism.
+        parallelism. If 'auto', the number is chosen by timing the first
+        batch with increasing numbers of particles in flight, up to the
+        memory budget given by event_memory_budget.
 
         .. versionadded:: 0.12
+    max_secondaries : int
+        Number of secondary particles a history may bank before they are
+        combed down to about half as many, preserving their weight.
     max_order : None or int
         Maximum scattering order to apply globally when in multi-group mode.
+    mesh_fields : MeshField or iterable of MeshField
+        Temperatures and density multipliers given on meshes overlaying
+        material cells
+
+        .. versionadded:: 0.12
+    neighbor_lists : str
+        Path to a statepoint file whose cell neighbor lists are loaded at
+        initialization when it was written for the same geometry
+
+        .. versionadded:: 0.12
     no_reduce : bool
         Indicate that all user-defined and global tallies should not be reduced
         across processes in a parallel calculation.
@@ -124,12 +411,36 @@ class Settings:
         applied. The 'nuclides' list indicates what nuclides the method should
         be applied to. In its absence, the method will be applied to all
         nuclides with 0 K elastic scattering data present.
+    retain_data : bool
+        Whether to keep the continuous-energy nuclear data loaded when the
+        simulation is finalized so that a later simulation in the same process
+        only reads the data it is missing
+
+        .. versionadded:: 0.12
     run_mode : {'eigenvalue', 'fixed source', 'plot', 'volume', 'particle restart'}
         The type of calculation to perform (default is 'eigenvalue')
     seed : int
         Seed for the linear congruential pseudorandom number generator
+    shared_bank : bool
+        Whether the fission sites sampled for the next generation are shared
+        among the MPI processes on a node so that they are only sent between
+        nodes.
+
+        .. versionadded:: 0.12
+    shared_xs : bool
+        Whether to keep a single copy of nuclide cross sections per node,
+        shared by all MPI ranks on that node. Implies the interleaved_xs
+        layout.
+
+        .. versionadded:: 0.12
     source : Iterable of openmc.Source
         Distribution of source sites in space, angle, and energy
+    source_sort : bool
+        Whether the source sites of each process are ordered along a Morton
+        space-filling curve before each generation, so that consecutive
+        histories start close to each other
+
+        .. versionadded:: 0.12
     sourcepoint : dict
         Options for writing source points. Acceptable keys are:
 
@@ -138,10 +449,22 @@ class Settings:
         :separate: bool indicating whether the source should be written as a
                    separate file
         :write: bool indicating whether or not to write the source
+        :format: 'hdf5' or 'binary', the format of separate source files
     statepoint : dict
         Options for writing state points. Acceptable keys are:
 
         :batches: list of batches at which to write source
+        :incremental: bool indicating whether state points only hold the
+                      changes of tally results since the previous state point
+    surf_source_write : dict
+        Options for recording the particles that cross a set of surfaces during
+        active batches as a surface source, which is written to
+        surface_source.h5 at the end of the simulation. Accepted keys are
+        'surface_ids' (iterable of int), the IDs of the surfaces, and
+        'max_particles' (int), the maximum number of sites recorded on each
+        process, which defaults to the number of particles per batch.
+
+        .. versionadded:: 0.12
     survival_biasing : bool
         Indicate whether survival biasing is to be used
     tabular_legendre : dict
@@ -151,19 +474,55 @@ class Settings:
         'enable' is a bool stating whether the conversion to tabular is
         performed; the value for 'num_points' sets the number of points to use
         in the tabular distribution, should 'enable' be True.
+    tally_compression : int
+        Deflate compression level from 1 to 9 of tally results in state points,
+        or 0 for no compression.
+
+        .. versionadded:: 0.12
+    tally_profiling : bool
+        Whether the cost of scoring each tally is measured and reported
+
+        .. versionadded:: 0.12
     temperature : dict
         Defines a default temperature and method for treating intermediate
         temperatures at which nuclear data doesn't exist. Accepted keys are
-        'default', 'method', 'range', 'tolerance', and 'multipole'. The value
-        for 'default' should be a float representing the default temperature in
-        Kelvin. The value for 'method' should be 'nearest' or 'interpolation'.
-        If the method is 'nearest', 'tolerance' indicates a range of temperature
-        within which cross sections may be used. The value for 'range' should be
-        a pair a minimum and maximum temperatures which are used to indicate
-        that cross sections be loaded at all temperatures within the
-        range. 'multipole' is a boolean indicating whether or not the windowed
+        'default', 'method', 'range', 'tolerance', 'multipole', and 'cache'. The
+        value for 'default' should be a float representing the default
+        temperature in Kelvin. The value for 'method' should be 'nearest' or
+        'interpolation'. If the method is 'nearest', 'tolerance' indicates a
+        range of temperature within which cross sections may be used. The value
+        for 'range' should be a pair a minimum and maximum temperatures which
+        are used to indicate that cross sections be loaded at all temperatures
+        within the range. 'multipole' is a boolean indicating whether or not the windowed
         multipole method should be used to evaluate resolved resonance cross
-        sections.
+        sections. 'cache' is a boolean indicating whether the temperature
+        indices of each nuclide should be precomputed for every cell instance
+        rather than searched for on each cross section lookup.
+    thermal_alias : bool
+        Whether to sample the outgoing energy of incoherent inelastic thermal
+        scattering with precomputed alias tables rather than by searching its
+        cumulative distribution.
+
+        .. versionadded:: 0.12
+    thinning_tolerance : float
+        Largest fractional difference between a cross section and its value
+        interpolated from neighbouring energy points for which the point is
+        removed from the energy grid when the data are read. Grids are not
+        thinned if it is zero.
+
+        .. versionadded:: 0.12
+    thread_affinity : {'none', 'compact', 'spread', 'numa'}
+        Placement of OpenMP threads on the CPUs available to each process.
+        'compact' binds consecutive threads to adjacent CPUs, 'spread' spaces
+        them evenly over the CPUs, and 'numa' binds blocks of threads to the
+        CPUs of each NUMA node. 'none' leaves placement to the OpenMP runtime.
+
+        .. versionadded:: 0.12
+    threaded_xs_read : bool
+        Whether to read nuclide and thermal scattering data with multiple
+        threads. Requires a thread-safe HDF5 library.
+
+        .. versionadded:: 0.12
     trace : tuple or list
         Show detailed information about a single particle, indicated by three
         integers: the batch number, generation number, and particle number
@@ -171,10 +530,23 @@ class Settings:
         Specify particles for which track files should be written. Each particle
         is identified by a triplet with the batch number, generation number, and
         particle number.
+    track_single_file : bool
+        Whether to write the tracks of all particles to a single file per
+        process instead of one file per particle. Tracks are buffered by each
+        thread and also store the energy and weight of the particle at each
+        point.
+
+        .. versionadded:: 0.12
     trigger_active : bool
         Indicate whether tally triggers are used
     trigger_batch_interval : int
         Number of batches in between convergence checks
+    trigger_freeze : bool
+        Whether tallies stop being scored once all of their triggers are
+        satisfied, so that the remaining batches are spent on the tallies that
+        have not converged
+
+        .. versionadded:: 0.12
     trigger_max_batches : int
         Maximum number of batches simulated. If this is set, the number of
         batches specified via ``batches`` is interpreted as the minimum number
@@ -182,11 +554,31 @@ class Settings:
     ufs_mesh : openmc.RegularMesh
         Mesh to be used for redistributing source sites via the uniform fision
         site (UFS) method.
+    vectorize_multipole : bool
+        Whether to evaluate the Faddeeva function of windowed multipole poles
+        in batches with a vectorized rational approximation instead of the
+        Faddeeva package.
+
+        .. versionadded:: 0.12
+    vectorize_xs : bool
+        If True, microscopic cross sections of all nuclides in a material are
+        gathered into contiguous arrays and reduced into macroscopic cross
+        sections with SIMD instructions.
+
+        .. versionadded:: 0.12
     verbosity : int
         Verbosity during simulation between 1 and 10. Verbosity levels are
         described in :ref:`verbosity`.
     volume_calculations : VolumeCalculation or iterable of VolumeCalculation
         Stochastic volume calculation specifications
+    weight_windows : WeightWindows or iterable of WeightWindows
+        Mesh-based weight windows used for splitting and Russian roulette, at
+        most one for each particle type
+    xs_cache : str
+        Directory in which derived nuclide cross sections are cached between
+        runs.
+
+        .. versionadded:: 0.12
 
     """
 
@@ -221,6 +613,7 @@ class Settings:
         self._trigger_active = None
         self._trigger_max_batches = None
         self._trigger_batch_interval = None
+        self._trigger_freeze = None
 
         self._output = None
 
@@ -244,10 +637,17 @@ class Settings:
 
         # Uniform fission source subelement
         self._ufs_mesh = None
+        self._precursor_mesh = None
+        self._domain_mesh = None
 
         self._resonance_scattering = {}
+        self._cmfd = {}
+        self._surf_source_write = {}
+        self._census = {}
         self._volume_calculations = cv.CheckedList(
             VolumeCalculation, 'volume calculations')
+        self._weight_windows = cv.CheckedList(WeightWindows, 'weight windows')
+        self._mesh_fields = cv.CheckedList(MeshField, 'mesh fields')
 
         self._create_fission_neutrons = None
         self._delayed_photon_scaling = None
@@ -258,6 +658,63 @@ class Settings:
 
         self._event_based = None
         self._max_particles_in_flight = None
+        self._event_memory_budget = None
+        self._max_secondaries = None
+        self._event_queue_sort = None
+        self._event_queue_sort_threshold = None
+        self._event_local_queue_length = None
+        self._event_prefetch_distance = None
+        self._event_scheduler = None
+        self._event_min_queue_length = None
+        self._event_history_threshold = None
+        self._event_refill = None
+        self._flat_geometry = None
+        self._event_fuse_advance = None
+        self._history_scheduler = None
+        self._history_interleave = None
+        self._thread_affinity = None
+        self._vectorize_xs = None
+        self._compact_xs_cache = None
+        self._interleaved_xs = None
+        self._energy_search = None
+        self._shared_xs = None
+        self._threaded_xs_read = None
+        self._huge_pages = None
+        self._numa_interleave = None
+        self._lazy_products = None
+        self._xs_cache = None
+        self._neighbor_lists = None
+        self._event_batch_distance = None
+        self._delta_tracking = None
+        self._private_tallies = None
+        self._private_tallies_max_size = None
+        self._pipeline_tallies = None
+        self._tally_profiling = None
+        self._load_balance = None
+        self._shared_bank = None
+        self._source_sort = None
+        self._retain_data = None
+        self._particle_ramp = None
+        self._async_statepoint = None
+        self._tally_compression = None
+        self._track_single_file = None
+        self._async_summary = None
+        self._vectorize_multipole = None
+        self._cumulative_xs = None
+        self._random_generator = None
+        self._random_ray = {}
+        self._correlated_alias = None
+        self._thermal_alias = None
+        self._thinning_tolerance = None
+        self._compton_tables = None
+        self._photon_material_tables = None
+        self._photon_xs_tables = None
+        self._broadcast_data = None
+        self._dagmc_bvh = None
+        self._performance_report = None
+        self._instrument = None
+        self._azimuth_rejection = None
+        self._alias_sampling = None
 
     @property
     def run_mode(self):
@@ -343,6 +800,10 @@ class Settings:
     def trigger_batch_interval(self):
         return self._trigger_batch_interval
 
+    @property
+    def trigger_freeze(self):
+        return self._trigger_freeze
+
     @property
     def output(self):
         return self._output
@@ -387,14 +848,42 @@ class Settings:
     def ufs_mesh(self):
         return self._ufs_mesh
 
+    @property
+    def precursor_mesh(self):
+        return self._precursor_mesh
+
+    @property
+    def domain_mesh(self):
+        return self._domain_mesh
+
     @property
     def resonance_scattering(self):
         return self._resonance_scattering
 
+    @property
+    def cmfd(self):
+        return self._cmfd
+
+    @property
+    def surf_source_write(self):
+        return self._surf_source_write
+
+    @property
+    def census(self):
+        return self._census
+
     @property
     def volume_calculations(self):
         return self._volume_calculations
 
+    @property
+    def weight_windows(self):
+        return self._weight_windows
+
+    @property
+    def mesh_fields(self):
+        return self._mesh_fields
+
     @property
     def create_fission_neutrons(self):
         return self._create_fission_neutrons
@@ -423,6 +912,234 @@ class Settings:
     def max_particles_in_flight(self):
         return self._max_particles_in_flight
 
+    @property
+    def event_memory_budget(self):
+        return self._event_memory_budget
+
+    @property
+    def max_secondaries(self):
+        return self._max_secondaries
+
+    @property
+    def event_queue_sort(self):
+        return self._event_queue_sort
+
+    @property
+    def event_queue_sort_threshold(self):
+        return self._event_queue_sort_threshold
+
+    @property
+    def event_local_queue_length(self):
+        return self._event_local_queue_length
+
+    @property
+    def event_prefetch_distance(self):
+        return self._event_prefetch_distance
+
+    @property
+    def event_scheduler(self):
+        return self._event_scheduler
+
+    @property
+    def event_min_queue_length(self):
+        return self._event_min_queue_length
+
+    @property
+    def event_history_threshold(self):
+        return self._event_history_threshold
+
+    @property
+    def event_refill(self):
+        return self._event_refill
+
+    @property
+    def flat_geometry(self):
+        return self._flat_geometry
+
+    @property
+    def event_fuse_advance(self):
+        return self._event_fuse_advance
+
+    @property
+    def history_scheduler(self):
+        return self._history_scheduler
+
+    @property
+    def history_interleave(self):
+        return self._history_interleave
+
+    @property
+    def thread_affinity(self):
+        return self._thread_affinity
+
+    @property
+    def vectorize_xs(self):
+        return self._vectorize_xs
+
+    @property
+    def compact_xs_cache(self):
+        return self._compact_xs_cache
+
+    @property
+    def interleaved_xs(self):
+        return self._interleaved_xs
+
+    @property
+    def energy_search(self):
+        return self._energy_search
+
+    @property
+    def shared_xs(self):
+        return self._shared_xs
+
+    @property
+    def threaded_xs_read(self):
+        return self._threaded_xs_read
+
+    @property
+    def huge_pages(self):
+        return self._huge_pages
+
+    @property
+    def numa_interleave(self):
+        return self._numa_interleave
+
+    @property
+    def lazy_products(self):
+        return self._lazy_products
+
+    @property
+    def xs_cache(self):
+        return self._xs_cache
+
+    @property
+    def neighbor_lists(self):
+        return self._neighbor_lists
+
+    @property
+    def event_batch_distance(self):
+        return self._event_batch_distance
+
+    @property
+    def delta_tracking(self):
+        return self._delta_tracking
+
+    @property
+    def private_tallies(self):
+        return self._private_tallies
+
+    @property
+    def private_tallies_max_size(self):
+        return self._private_tallies_max_size
+
+    @property
+    def pipeline_tallies(self):
+        return self._pipeline_tallies
+
+    @property
+    def tally_profiling(self):
+        return self._tally_profiling
+
+    @property
+    def load_balance(self):
+        return self._load_balance
+
+    @property
+    def shared_bank(self):
+        return self._shared_bank
+
+    @property
+    def source_sort(self):
+        return self._source_sort
+
+    @property
+    def retain_data(self):
+        return self._retain_data
+
+    @property
+    def particle_ramp(self):
+        return self._particle_ramp
+
+    @property
+    def async_statepoint(self):
+        return self._async_statepoint
+
+    @property
+    def tally_compression(self):
+        return self._tally_compression
+
+    @property
+    def track_single_file(self):
+        return self._track_single_file
+
+    @property
+    def async_summary(self):
+        return self._async_summary
+
+    @property
+    def vectorize_multipole(self):
+        return self._vectorize_multipole
+
+    @property
+    def cumulative_xs(self):
+        return self._cumulative_xs
+
+    @property
+    def random_generator(self):
+        return self._random_generator
+
+    @property
+    def random_ray(self):
+        return self._random_ray
+
+    @property
+    def correlated_alias(self):
+        return self._correlated_alias
+
+    @property
+    def thermal_alias(self):
+        return self._thermal_alias
+
+    @property
+    def thinning_tolerance(self):
+        return self._thinning_tolerance
+
+    @property
+    def compton_tables(self):
+        return self._compton_tables
+
+    @property
+    def photon_material_tables(self):
+        return self._photon_material_tables
+
+    @property
+    def photon_xs_tables(self):
+        return self._photon_xs_tables
+
+    @property
+    def broadcast_data(self):
+        return self._broadcast_data
+
+    @property
+    def dagmc_bvh(self):
+        return self._dagmc_bvh
+
+    @property
+    def performance_report(self):
+        return self._performance_report
+
+    @property
+    def instrument(self):
+        return self._instrument
+
+    @property
+    def azimuth_rejection(self):
+        return self._azimuth_rejection
+
+    @property
+    def alias_sampling(self):
+        return self._alias_sampling
+
     @run_mode.setter
     def run_mode(self, run_mode):
         cv.check_value('run mode', run_mode, {x.value for x in RunMode})
@@ -548,6 +1265,9 @@ class Settings:
                 cv.check_type('sourcepoint write', value, bool)
             elif key == 'overwrite':
                 cv.check_type('sourcepoint overwrite', value, bool)
+            elif key == 'format':
+                cv.check_value('sourcepoint format', value,
+                               ('hdf5', 'binary'))
             else:
                 raise ValueError("Unknown key '{}' encountered when setting "
                                  "sourcepoint options.".format(key))
@@ -561,6 +1281,8 @@ class Settings:
                 cv.check_type('statepoint batches', value, Iterable, Integral)
                 for batch in value:
                     cv.check_greater_than('statepoint batch', batch, 0)
+            elif key == 'incremental':
+                cv.check_type('statepoint incremental', value, bool)
             else:
                 raise ValueError("Unknown key '{}' encountered when setting "
                                  "statepoint options.".format(key))
@@ -573,7 +1295,8 @@ class Settings:
 
     @electron_treatment.setter
     def electron_treatment(self, electron_treatment):
-        cv.check_value('electron treatment', electron_treatment, ['led', 'ttb'])
+        cv.check_value('electron treatment', electron_treatment,
+                       ['led', 'ttb', 'ch'])
         self._electron_treatment = electron_treatment
 
     @photon_transport.setter
@@ -620,6 +1343,10 @@ class Settings:
                          'energy_positron']:
                 cv.check_type('energy cutoff', cutoff[key], Real)
                 cv.check_greater_than('energy cutoff', cutoff[key], 0.0)
+            elif key in ['time_neutron', 'time_photon', 'time_electron',
+                         'time_positron']:
+                cv.check_type('time cutoff', cutoff[key], Real)
+                cv.check_greater_than('time cutoff', cutoff[key], 0.0)
             else:
                 msg = 'Unable to set cutoff to "{0}" which is unsupported by '\
                       'OpenMC'.format(key)
@@ -648,6 +1375,11 @@ class Settings:
         cv.check_greater_than('trigger batch interval', trigger_batch_interval, 0)
         self._trigger_batch_interval = trigger_batch_interval
 
+    @trigger_freeze.setter
+    def trigger_freeze(self, trigger_freeze):
+        cv.check_type('trigger freeze', trigger_freeze, bool)
+        self._trigger_freeze = trigger_freeze
+
     @no_reduce.setter
     def no_reduce(self, no_reduce):
         cv.check_type('no reduction option', no_reduce, bool)
@@ -673,7 +1405,7 @@ class Settings:
         for key, value in temperature.items():
             cv.check_value('temperature key', key,
                            ['default', 'method', 'tolerance', 'multipole',
-                            'range'])
+                            'range', 'cache'])
             if key == 'default':
                 cv.check_type('default temperature', value, Real)
             elif key == 'method':
@@ -683,6 +1415,8 @@ class Settings:
                 cv.check_type('temperature tolerance', value, Real)
             elif key == 'multipole':
                 cv.check_type('temperature multipole', value, bool)
+            elif key == 'cache':
+                cv.check_type('temperature cache', value, bool)
             elif key == 'range':
                 cv.check_length('temperature range', value, 2)
                 for T in value:
@@ -720,6 +1454,16 @@ class Settings:
         cv.check_length('UFS mesh upper-right corner', ufs_mesh.upper_right, 3)
         self._ufs_mesh = ufs_mesh
 
+    @precursor_mesh.setter
+    def precursor_mesh(self, mesh):
+        cv.check_type('precursor mesh', mesh, RegularMesh)
+        self._precursor_mesh = mesh
+
+    @domain_mesh.setter
+    def domain_mesh(self, mesh):
+        cv.check_type('domain mesh', mesh, RegularMesh)
+        self._domain_mesh = mesh
+
     @resonance_scattering.setter
     def resonance_scattering(self, res):
         cv.check_type('resonance scattering settings', res, Mapping)
@@ -744,6 +1488,62 @@ class Settings:
                               Iterable, str)
         self._resonance_scattering = res
 
+    @cmfd.setter
+    def cmfd(self, cmfd):
+        cv.check_type('CMFD settings', cmfd, Mapping)
+        for key, value in cmfd.items():
+            cv.check_value('CMFD dictionary key', key,
+                           ('mesh', 'energy_groups', 'begin'))
+            if key == 'mesh':
+                cv.check_type('CMFD mesh', value, RegularMesh)
+            elif key == 'energy_groups':
+                cv.check_type('CMFD energy groups', value, Iterable, Real)
+                cv.check_length('CMFD energy groups', value, 2)
+                value = list(value)
+                if any(e2 <= e1 for e1, e2 in zip(value, value[1:])):
+                    msg = 'Unable to set CMFD energy groups to "{0}" which ' \
+                          'are not increasing'.format(value)
+                    raise ValueError(msg)
+            elif key == 'begin':
+                cv.check_type('CMFD first batch', value, Integral)
+                cv.check_greater_than('CMFD first batch', value, 0)
+        self._cmfd = cmfd
+
+    @surf_source_write.setter
+    def surf_source_write(self, surf_source_write):
+        cv.check_type('surface source writing options', surf_source_write,
+                      Mapping)
+        for key, value in surf_source_write.items():
+            cv.check_value('surface source writing key', key,
+                           ('surface_ids', 'max_particles'))
+            if key == 'surface_ids':
+                cv.check_type('surface IDs for source writing', value,
+                              Iterable, Integral)
+                for surf_id in value:
+                    cv.check_greater_than('surface ID for source writing',
+                                          surf_id, 0)
+            elif key == 'max_particles':
+                cv.check_type('maximum particle banks on surfaces per process',
+                              value, Integral)
+                cv.check_greater_than('maximum particle banks on surfaces per '
+                                      'process', value, 0)
+        self._surf_source_write = surf_source_write
+
+    @census.setter
+    def census(self, census):
+        cv.check_type('census options', census, Mapping)
+        for key, value in census.items():
+            cv.check_value('census key', key, ('time', 'max_particles'))
+            if key == 'time':
+                cv.check_type('census time', value, Real)
+                cv.check_greater_than('census time', value, 0.0)
+            elif key == 'max_particles':
+                cv.check_type('maximum census sites per process', value,
+                              Integral)
+                cv.check_greater_than('maximum census sites per process',
+                                      value, 0)
+        self._census = census
+
     @volume_calculations.setter
     def volume_calculations(self, vol_calcs):
         if not isinstance(vol_calcs, MutableSequence):
@@ -751,6 +1551,20 @@ class Settings:
         self._volume_calculations = cv.CheckedList(
             VolumeCalculation, 'stochastic volume calculations', vol_calcs)
 
+    @weight_windows.setter
+    def weight_windows(self, weight_windows):
+        if not isinstance(weight_windows, MutableSequence):
+            weight_windows = [weight_windows]
+        self._weight_windows = cv.CheckedList(
+            WeightWindows, 'weight windows', weight_windows)
+
+    @mesh_fields.setter
+    def mesh_fields(self, mesh_fields):
+        if not isinstance(mesh_fields, MutableSequence):
+            mesh_fields = [mesh_fields]
+        self._mesh_fields = cv.CheckedList(
+            MeshField, 'mesh fields', mesh_fields)
+
     @create_fission_neutrons.setter
     def create_fission_neutrons(self, create_fission_neutrons):
         cv.check_type('Whether create fission neutrons',
@@ -769,10 +1583,25 @@ class Settings:
 
     @max_particles_in_flight.setter
     def max_particles_in_flight(self, value):
-        cv.check_type('max particles in flight', value, Integral)
-        cv.check_greater_than('max particles in flight', value, 0)
+        if isinstance(value, str):
+            cv.check_value('max particles in flight', value, ('auto',))
+        else:
+            cv.check_type('max particles in flight', value, Integral)
+            cv.check_greater_than('max particles in flight', value, 0)
         self._max_particles_in_flight = value
 
+    @event_memory_budget.setter
+    def event_memory_budget(self, value):
+        cv.check_type('event memory budget', value, Real)
+        cv.check_greater_than('event memory budget', value, 0)
+        self._event_memory_budget = value
+
+    @max_secondaries.setter
+    def max_secondaries(self, value):
+        cv.check_type('maximum number of secondaries', value, Integral)
+        cv.check_greater_than('maximum number of secondaries', value, 2, True)
+        self._max_secondaries = value
+
     @material_cell_offsets.setter
     def material_cell_offsets(self, value):
         cv.check_type('material cell offsets', value, bool)
@@ -784,6 +1613,300 @@ class Settings:
         cv.check_greater_than('log grid bins', log_grid_bins, 0)
         self._log_grid_bins = log_grid_bins
 
+    @event_queue_sort.setter
+    def event_queue_sort(self, value):
+        cv.check_type('event queue sort', value, bool)
+        self._event_queue_sort = value
+
+    @event_queue_sort_threshold.setter
+    def event_queue_sort_threshold(self, value):
+        cv.check_type('event queue sort threshold', value, Integral)
+        cv.check_greater_than('event queue sort threshold', value, 0, True)
+        self._event_queue_sort_threshold = value
+
+    @event_local_queue_length.setter
+    def event_local_queue_length(self, value):
+        cv.check_type('event local queue length', value, Integral)
+        cv.check_greater_than('event local queue length', value, 0, True)
+        self._event_local_queue_length = value
+
+    @event_prefetch_distance.setter
+    def event_prefetch_distance(self, value):
+        cv.check_type('event prefetch distance', value, Integral)
+        cv.check_greater_than('event prefetch distance', value, 0, True)
+        self._event_prefetch_distance = value
+
+    @event_scheduler.setter
+    def event_scheduler(self, value):
+        cv.check_value('event scheduler', value, ('longest', 'round-robin'))
+        self._event_scheduler = value
+
+    @event_min_queue_length.setter
+    def event_min_queue_length(self, value):
+        cv.check_type('event min queue length', value, Integral)
+        cv.check_greater_than('event min queue length', value, 0, True)
+        self._event_min_queue_length = value
+
+    @event_history_threshold.setter
+    def event_history_threshold(self, value):
+        cv.check_type('event history threshold', value, Integral)
+        cv.check_greater_than('event history threshold', value, 0, True)
+        self._event_history_threshold = value
+
+    @event_refill.setter
+    def event_refill(self, value):
+        cv.check_type('event refill', value, bool)
+        self._event_refill = value
+
+    @flat_geometry.setter
+    def flat_geometry(self, value):
+        cv.check_type('flat geometry', value, bool)
+        self._flat_geometry = value
+
+    @event_fuse_advance.setter
+    def event_fuse_advance(self, value):
+        cv.check_type('event fuse advance', value, bool)
+        self._event_fuse_advance = value
+
+    @history_scheduler.setter
+    def history_scheduler(self, value):
+        cv.check_value('history scheduler', value, ('openmp', 'work-stealing'))
+        self._history_scheduler = value
+
+    @history_interleave.setter
+    def history_interleave(self, value):
+        cv.check_type('history interleave', value, Integral)
+        cv.check_greater_than('history interleave', value, 1, True)
+        self._history_interleave = value
+
+    @thread_affinity.setter
+    def thread_affinity(self, value):
+        cv.check_value('thread affinity', value,
+                       ('none', 'compact', 'spread', 'numa'))
+        self._thread_affinity = value
+
+    @vectorize_xs.setter
+    def vectorize_xs(self, value):
+        cv.check_type('vectorize xs', value, bool)
+        self._vectorize_xs = value
+
+    @compact_xs_cache.setter
+    def compact_xs_cache(self, value):
+        cv.check_type('compact xs cache', value, bool)
+        self._compact_xs_cache = value
+
+    @interleaved_xs.setter
+    def interleaved_xs(self, value):
+        cv.check_type('interleaved xs', value, bool)
+        self._interleaved_xs = value
+
+    @energy_search.setter
+    def energy_search(self, value):
+        cv.check_value('energy search', value, ('log-grid', 'hashed'))
+        self._energy_search = value
+
+    @shared_xs.setter
+    def shared_xs(self, value):
+        cv.check_type('shared xs', value, bool)
+        self._shared_xs = value
+
+    @threaded_xs_read.setter
+    def threaded_xs_read(self, value):
+        cv.check_type('threaded xs read', value, bool)
+        self._threaded_xs_read = value
+
+    @huge_pages.setter
+    def huge_pages(self, value):
+        cv.check_type('huge pages', value, bool)
+        self._huge_pages = value
+
+    @numa_interleave.setter
+    def numa_interleave(self, value):
+        cv.check_type('NUMA interleave', value, bool)
+        self._numa_interleave = value
+
+    @lazy_products.setter
+    def lazy_products(self, value):
+        cv.check_type('lazy products', value, bool)
+        self._lazy_products = value
+
+    @xs_cache.setter
+    def xs_cache(self, value):
+        cv.check_type('xs cache', value, str)
+        self._xs_cache = value
+
+    @neighbor_lists.setter
+    def neighbor_lists(self, value):
+        cv.check_type('neighbor lists', value, str)
+        self._neighbor_lists = value
+
+    @event_batch_distance.setter
+    def event_batch_distance(self, value):
+        cv.check_type('event batch distance', value, bool)
+        self._event_batch_distance = value
+
+    @delta_tracking.setter
+    def delta_tracking(self, value):
+        cv.check_type('delta tracking', value, bool)
+        self._delta_tracking = value
+
+    @private_tallies.setter
+    def private_tallies(self, value):
+        cv.check_type('private tallies', value, bool)
+        self._private_tallies = value
+
+    @private_tallies_max_size.setter
+    def private_tallies_max_size(self, value):
+        cv.check_type('private tallies max size', value, Integral)
+        cv.check_greater_than('private tallies max size', value, 0, True)
+        self._private_tallies_max_size = value
+
+    @pipeline_tallies.setter
+    def pipeline_tallies(self, value):
+        cv.check_type('pipeline tallies', value, bool)
+        self._pipeline_tallies = value
+
+    @tally_profiling.setter
+    def tally_profiling(self, value):
+        cv.check_type('tally profiling', value, bool)
+        self._tally_profiling = value
+
+    @load_balance.setter
+    def load_balance(self, value):
+        cv.check_type('load balance', value, bool)
+        self._load_balance = value
+
+    @shared_bank.setter
+    def shared_bank(self, value):
+        cv.check_type('shared bank', value, bool)
+        self._shared_bank = value
+
+    @source_sort.setter
+    def source_sort(self, value):
+        cv.check_type('source sort', value, bool)
+        self._source_sort = value
+
+    @retain_data.setter
+    def retain_data(self, value):
+        cv.check_type('retain data', value, bool)
+        self._retain_data = value
+
+    @particle_ramp.setter
+    def particle_ramp(self, value):
+        cv.check_type('particle ramp', value, Real)
+        cv.check_greater_than('particle ramp', value, 0)
+        cv.check_less_than('particle ramp', value, 1, True)
+        self._particle_ramp = value
+
+    @async_statepoint.setter
+    def async_statepoint(self, value):
+        cv.check_type('async statepoint', value, bool)
+        self._async_statepoint = value
+
+    @tally_compression.setter
+    def tally_compression(self, value):
+        cv.check_type('tally compression', value, Integral)
+        cv.check_greater_than('tally compression', value, 0, True)
+        cv.check_less_than('tally compression', value, 9, True)
+        self._tally_compression = value
+
+    @track_single_file.setter
+    def track_single_file(self, value):
+        cv.check_type('track single file', value, bool)
+        self._track_single_file = value
+
+    @async_summary.setter
+    def async_summary(self, value):
+        cv.check_type('async summary', value, bool)
+        self._async_summary = value
+
+    @vectorize_multipole.setter
+    def vectorize_multipole(self, value):
+        cv.check_type('vectorize multipole', value, bool)
+        self._vectorize_multipole = value
+
+    @cumulative_xs.setter
+    def cumulative_xs(self, value):
+        cv.check_type('cumulative xs', value, bool)
+        self._cumulative_xs = value
+
+    @random_generator.setter
+    def random_generator(self, value):
+        cv.check_value('random generator', value, ('lcg', 'philox'))
+        self._random_generator = value
+
+    @random_ray.setter
+    def random_ray(self, random_ray):
+        cv.check_type('random ray settings', random_ray, Mapping)
+        for key, value in random_ray.items():
+            cv.check_value('random ray dictionary key', key,
+                           ('distance_inactive', 'distance_active'))
+            cv.check_type('random ray {}'.format(key), value, Real)
+            cv.check_greater_than('random ray {}'.format(key), value, 0.0,
+                                  key == 'distance_inactive')
+        self._random_ray = random_ray
+
+    @correlated_alias.setter
+    def correlated_alias(self, value):
+        cv.check_type('correlated alias', value, bool)
+        self._correlated_alias = value
+
+    @thermal_alias.setter
+    def thermal_alias(self, value):
+        cv.check_type('thermal alias', value, bool)
+        self._thermal_alias = value
+
+    @thinning_tolerance.setter
+    def thinning_tolerance(self, value):
+        cv.check_type('thinning tolerance', value, Real)
+        cv.check_greater_than('thinning tolerance', value, 0, True)
+        self._thinning_tolerance = value
+
+    @compton_tables.setter
+    def compton_tables(self, value):
+        cv.check_type('compton tables', value, bool)
+        self._compton_tables = value
+
+    @photon_material_tables.setter
+    def photon_material_tables(self, value):
+        cv.check_type('photon material tables', value, bool)
+        self._photon_material_tables = value
+
+    @photon_xs_tables.setter
+    def photon_xs_tables(self, value):
+        cv.check_type('photon cross section tables', value, bool)
+        self._photon_xs_tables = value
+
+    @broadcast_data.setter
+    def broadcast_data(self, value):
+        cv.check_type('broadcast data', value, bool)
+        self._broadcast_data = value
+
+    @dagmc_bvh.setter
+    def dagmc_bvh(self, value):
+        cv.check_type('DAGMC BVH', value, bool)
+        self._dagmc_bvh = value
+
+    @performance_report.setter
+    def performance_report(self, value):
+        cv.check_type('performance report', value, bool)
+        self._performance_report = value
+
+    @instrument.setter
+    def instrument(self, value):
+        cv.check_type('instrument', value, bool)
+        self._instrument = value
+
+    @azimuth_rejection.setter
+    def azimuth_rejection(self, value):
+        cv.check_type('azimuth rejection', value, bool)
+        self._azimuth_rejection = value
+
+    @alias_sampling.setter
+    def alias_sampling(self, value):
+        cv.check_type('alias sampling', value, bool)
+        self._alias_sampling = value
+
     def _create_run_mode_subelement(self, root):
         elem = ET.SubElement(root, "run_mode")
         elem.text = self._run_mode.value
@@ -843,6 +1966,24 @@ class Settings:
         for calc in self.volume_calculations:
             root.append(calc.to_xml_element())
 
+    def _create_weight_windows_subelement(self, root):
+        for ww in self.weight_windows:
+            # See if a <mesh> element already exists -- if not, add it
+            path = "./mesh[@id='{}']".format(ww.mesh.id)
+            if root.find(path) is None:
+                root.append(ww.mesh.to_xml_element())
+
+            root.append(ww.to_xml_element())
+
+    def _create_mesh_fields_subelement(self, root):
+        for field in self.mesh_fields:
+            # See if a <mesh> element already exists -- if not, add it
+            path = "./mesh[@id='{}']".format(field.mesh.id)
+            if root.find(path) is None:
+                root.append(field.mesh.to_xml_element())
+
+            root.append(field.to_xml_element())
+
     def _create_output_subelement(self, root):
         if self._output is not None:
             element = ET.SubElement(root, "output")
@@ -865,6 +2006,9 @@ class Settings:
                 subelement = ET.SubElement(element, "batches")
                 subelement.text = ' '.join(
                     str(x) for x in self._statepoint['batches'])
+            if 'incremental' in self._statepoint:
+                subelement = ET.SubElement(element, "incremental")
+                subelement.text = str(self._statepoint['incremental']).lower()
 
     def _create_sourcepoint_subelement(self, root):
         if self._sourcepoint:
@@ -888,6 +2032,10 @@ class Settings:
                 subelement = ET.SubElement(element, "overwrite_latest")
                 subelement.text = str(self._sourcepoint['overwrite']).lower()
 
+            if 'format' in self._sourcepoint:
+                subelement = ET.SubElement(element, "format")
+                subelement.text = self._sourcepoint['format']
+
     def _create_confidence_intervals(self, root):
         if self._confidence_intervals is not None:
             element = ET.SubElement(root, "confidence_intervals")
@@ -949,6 +2097,10 @@ class Settings:
                 element = ET.SubElement(trigger_element, "batch_interval")
                 element.text = str(self._trigger_batch_interval)
 
+            if self._trigger_freeze is not None:
+                element = ET.SubElement(trigger_element, "freeze")
+                element.text = str(self._trigger_freeze).lower()
+
     def _create_no_reduce_subelement(self, root):
         if self._no_reduce is not None:
             element = ET.SubElement(root, "no_reduce")
@@ -995,6 +2147,24 @@ class Settings:
             subelement = ET.SubElement(root, "ufs_mesh")
             subelement.text = str(self.ufs_mesh.id)
 
+    def _create_precursor_mesh_subelement(self, root):
+        if self.precursor_mesh is not None:
+            path = "./mesh[@id='{}']".format(self.precursor_mesh.id)
+            if root.find(path) is None:
+                root.append(self.precursor_mesh.to_xml_element())
+
+            subelement = ET.SubElement(root, "precursor_mesh")
+            subelement.text = str(self.precursor_mesh.id)
+
+    def _create_domain_mesh_subelement(self, root):
+        if self.domain_mesh is not None:
+            path = "./mesh[@id='{}']".format(self.domain_mesh.id)
+            if root.find(path) is None:
+                root.append(self.domain_mesh.to_xml_element())
+
+            subelement = ET.SubElement(root, "domain_mesh")
+            subelement.text = str(self.domain_mesh.id)
+
     def _create_resonance_scattering_subelement(self, root):
         res = self.resonance_scattering
         if res:
@@ -1015,6 +2185,46 @@ class Settings:
                 subelem = ET.SubElement(elem, 'nuclides')
                 subelem.text = ' '.join(res['nuclides'])
 
+    def _create_cmfd_subelement(self, root):
+        cmfd = self.cmfd
+        if cmfd:
+            elem = ET.SubElement(root, 'cmfd')
+            if 'mesh' in cmfd:
+                # See if a <mesh> element already exists -- if not, add it
+                mesh = cmfd['mesh']
+                path = "./mesh[@id='{}']".format(mesh.id)
+                if root.find(path) is None:
+                    root.append(mesh.to_xml_element())
+                subelem = ET.SubElement(elem, 'mesh')
+                subelem.text = str(mesh.id)
+            if 'energy_groups' in cmfd:
+                subelem = ET.SubElement(elem, 'energy_groups')
+                subelem.text = ' '.join(map(str, cmfd['energy_groups']))
+            if 'begin' in cmfd:
+                subelem = ET.SubElement(elem, 'begin')
+                subelem.text = str(cmfd['begin'])
+
+    def _create_surf_source_write_subelement(self, root):
+        if self._surf_source_write:
+            elem = ET.SubElement(root, 'surf_source_write')
+            if 'surface_ids' in self._surf_source_write:
+                subelem = ET.SubElement(elem, 'surface_ids')
+                subelem.text = ' '.join(
+                    str(x) for x in self._surf_source_write['surface_ids'])
+            if 'max_particles' in self._surf_source_write:
+                subelem = ET.SubElement(elem, 'max_particles')
+                subelem.text = str(self._surf_source_write['max_particles'])
+
+    def _create_census_subelement(self, root):
+        if self._census:
+            elem = ET.SubElement(root, 'census')
+            if 'time' in self._census:
+                subelem = ET.SubElement(elem, 'time')
+                subelem.text = str(self._census['time'])
+            if 'max_particles' in self._census:
+                subelem = ET.SubElement(elem, 'max_particles')
+                subelem.text = str(self._census['max_particles'])
+
     def _create_create_fission_neutrons_subelement(self, root):
         if self._create_fission_neutrons is not None:
             elem = ET.SubElement(root, "create_fission_neutrons")
@@ -1035,6 +2245,16 @@ class Settings:
             elem = ET.SubElement(root, "max_particles_in_flight")
             elem.text = str(self._max_particles_in_flight).lower()
 
+    def _create_event_memory_budget_subelement(self, root):
+        if self._event_memory_budget is not None:
+            elem = ET.SubElement(root, "event_memory_budget")
+            elem.text = str(self._event_memory_budget)
+
+    def _create_max_secondaries_subelement(self, root):
+        if self._max_secondaries is not None:
+            elem = ET.SubElement(root, "max_secondaries")
+            elem.text = str(self._max_secondaries)
+
     def _create_material_cell_offsets_subelement(self, root):
         if self._material_cell_offsets is not None:
             elem = ET.SubElement(root, "material_cell_offsets")
@@ -1050,6 +2270,284 @@ class Settings:
             elem = ET.SubElement(root, "dagmc")
             elem.text = str(self._dagmc).lower()
 
+    def _create_event_queue_sort_subelement(self, root):
+        if self._event_queue_sort is not None:
+            elem = ET.SubElement(root, "event_queue_sort")
+            elem.text = str(self._event_queue_sort).lower()
+
+    def _create_event_queue_sort_threshold_subelement(self, root):
+        if self._event_queue_sort_threshold is not None:
+            elem = ET.SubElement(root, "event_queue_sort_threshold")
+            elem.text = str(self._event_queue_sort_threshold)
+
+    def _create_event_local_queue_length_subelement(self, root):
+        if self._event_local_queue_length is not None:
+            elem = ET.SubElement(root, "event_local_queue_length")
+            elem.text = str(self._event_local_queue_length)
+
+    def _create_event_prefetch_distance_subelement(self, root):
+        if self._event_prefetch_distance is not None:
+            elem = ET.SubElement(root, "event_prefetch_distance")
+            elem.text = str(self._event_prefetch_distance)
+
+    def _create_event_scheduler_subelement(self, root):
+        if self._event_scheduler is not None:
+            elem = ET.SubElement(root, "event_scheduler")
+            elem.text = str(self._event_scheduler)
+
+    def _create_event_min_queue_length_subelement(self, root):
+        if self._event_min_queue_length is not None:
+            elem = ET.SubElement(root, "event_min_queue_length")
+            elem.text = str(self._event_min_queue_length)
+
+    def _create_event_history_threshold_subelement(self, root):
+        if self._event_history_threshold is not None:
+            elem = ET.SubElement(root, "event_history_threshold")
+            elem.text = str(self._event_history_threshold)
+
+    def _create_event_refill_subelement(self, root):
+        if self._event_refill is not None:
+            elem = ET.SubElement(root, "event_refill")
+            elem.text = str(self._event_refill).lower()
+
+    def _create_flat_geometry_subelement(self, root):
+        if self._flat_geometry is not None:
+            elem = ET.SubElement(root, "flat_geometry")
+            elem.text = str(self._flat_geometry).lower()
+
+    def _create_event_fuse_advance_subelement(self, root):
+        if self._event_fuse_advance is not None:
+            elem = ET.SubElement(root, "event_fuse_advance")
+            elem.text = str(self._event_fuse_advance).lower()
+
+    def _create_history_scheduler_subelement(self, root):
+        if self._history_scheduler is not None:
+            elem = ET.SubElement(root, "history_scheduler")
+            elem.text = str(self._history_scheduler)
+
+    def _create_history_interleave_subelement(self, root):
+        if self._history_interleave is not None:
+            elem = ET.SubElement(root, "history_interleave")
+            elem.text = str(self._history_interleave)
+
+    def _create_thread_affinity_subelement(self, root):
+        if self._thread_affinity is not None:
+            elem = ET.SubElement(root, "thread_affinity")
+            elem.text = str(self._thread_affinity)
+
+    def _create_vectorize_xs_subelement(self, root):
+        if self._vectorize_xs is not None:
+            elem = ET.SubElement(root, "vectorize_xs")
+            elem.text = str(self._vectorize_xs).lower()
+
+    def _create_compact_xs_cache_subelement(self, root):
+        if self._compact_xs_cache is not None:
+            elem = ET.SubElement(root, "compact_xs_cache")
+            elem.text = str(self._compact_xs_cache).lower()
+
+    def _create_interleaved_xs_subelement(self, root):
+        if self._interleaved_xs is not None:
+            elem = ET.SubElement(root, "interleaved_xs")
+            elem.text = str(self._interleaved_xs).lower()
+
+    def _create_energy_search_subelement(self, root):
+        if self._energy_search is not None:
+            elem = ET.SubElement(root, "energy_search")
+            elem.text = str(self._energy_search)
+
+    def _create_shared_xs_subelement(self, root):
+        if self._shared_xs is not None:
+            elem = ET.SubElement(root, "shared_xs")
+            elem.text = str(self._shared_xs).lower()
+
+    def _create_threaded_xs_read_subelement(self, root):
+        if self._threaded_xs_read is not None:
+            elem = ET.SubElement(root, "threaded_xs_read")
+            elem.text = str(self._threaded_xs_read).lower()
+
+    def _create_huge_pages_subelement(self, root):
+        if self._huge_pages is not None:
+            elem = ET.SubElement(root, "huge_pages")
+            elem.text = str(self._huge_pages).lower()
+
+    def _create_numa_interleave_subelement(self, root):
+        if self._numa_interleave is not None:
+            elem = ET.SubElement(root, "numa_interleave")
+            elem.text = str(self._numa_interleave).lower()
+
+    def _create_lazy_products_subelement(self, root):
+        if self._lazy_products is not None:
+            elem = ET.SubElement(root, "lazy_products")
+            elem.text = str(self._lazy_products).lower()
+
+    def _create_xs_cache_subelement(self, root):
+        if self._xs_cache is not None:
+            elem = ET.SubElement(root, "xs_cache")
+            elem.text = str(self._xs_cache)
+
+    def _create_neighbor_lists_subelement(self, root):
+        if self._neighbor_lists is not None:
+            elem = ET.SubElement(root, "neighbor_lists")
+            elem.text = str(self._neighbor_lists)
+
+    def _create_event_batch_distance_subelement(self, root):
+        if self._event_batch_distance is not None:
+            elem = ET.SubElement(root, "event_batch_distance")
+            elem.text = str(self._event_batch_distance).lower()
+
+    def _create_delta_tracking_subelement(self, root):
+        if self._delta_tracking is not None:
+            elem = ET.SubElement(root, "delta_tracking")
+            elem.text = str(self._delta_tracking).lower()
+
+    def _create_private_tallies_subelement(self, root):
+        if self._private_tallies is not None:
+            elem = ET.SubElement(root, "private_tallies")
+            elem.text = str(self._private_tallies).lower()
+
+    def _create_private_tallies_max_size_subelement(self, root):
+        if self._private_tallies_max_size is not None:
+            elem = ET.SubElement(root, "private_tallies_max_size")
+            elem.text = str(self._private_tallies_max_size)
+
+    def _create_pipeline_tallies_subelement(self, root):
+        if self._pipeline_tallies is not None:
+            elem = ET.SubElement(root, "pipeline_tallies")
+            elem.text = str(self._pipeline_tallies).lower()
+
+    def _create_tally_profiling_subelement(self, root):
+        if self._tally_profiling is not None:
+            elem = ET.SubElement(root, "tally_profiling")
+            elem.text = str(self._tally_profiling).lower()
+
+    def _create_load_balance_subelement(self, root):
+        if self._load_balance is not None:
+            elem = ET.SubElement(root, "load_balance")
+            elem.text = str(self._load_balance).lower()
+
+    def _create_shared_bank_subelement(self, root):
+        if self._shared_bank is not None:
+            elem = ET.SubElement(root, "shared_bank")
+            elem.text = str(self._shared_bank).lower()
+
+    def _create_source_sort_subelement(self, root):
+        if self._source_sort is not None:
+            elem = ET.SubElement(root, "source_sort")
+            elem.text = str(self._source_sort).lower()
+
+    def _create_retain_data_subelement(self, root):
+        if self._retain_data is not None:
+            elem = ET.SubElement(root, "retain_data")
+            elem.text = str(self._retain_data).lower()
+
+    def _create_particle_ramp_subelement(self, root):
+        if self._particle_ramp is not None:
+            elem = ET.SubElement(root, "particle_ramp")
+            elem.text = str(self._particle_ramp)
+
+    def _create_async_statepoint_subelement(self, root):
+        if self._async_statepoint is not None:
+            elem = ET.SubElement(root, "async_statepoint")
+            elem.text = str(self._async_statepoint).lower()
+
+    def _create_tally_compression_subelement(self, root):
+        if self._tally_compression is not None:
+            elem = ET.SubElement(root, "tally_compression")
+            elem.text = str(self._tally_compression)
+
+    def _create_track_single_file_subelement(self, root):
+        if self._track_single_file is not None:
+            elem = ET.SubElement(root, "track_single_file")
+            elem.text = str(self._track_single_file).lower()
+
+    def _create_async_summary_subelement(self, root):
+        if self._async_summary is not None:
+            elem = ET.SubElement(root, "async_summary")
+            elem.text = str(self._async_summary).lower()
+
+    def _create_vectorize_multipole_subelement(self, root):
+        if self._vectorize_multipole is not None:
+            elem = ET.SubElement(root, "vectorize_multipole")
+            elem.text = str(self._vectorize_multipole).lower()
+
+    def _create_cumulative_xs_subelement(self, root):
+        if self._cumulative_xs is not None:
+            elem = ET.SubElement(root, "cumulative_xs")
+            elem.text = str(self._cumulative_xs).lower()
+
+    def _create_random_generator_subelement(self, root):
+        if self._random_generator is not None:
+            elem = ET.SubElement(root, "random_generator")
+            elem.text = str(self._random_generator)
+
+    def _create_random_ray_subelement(self, root):
+        if self._random_ray:
+            elem = ET.SubElement(root, "random_ray")
+            for key in ('distance_inactive', 'distance_active'):
+                if key in self._random_ray:
+                    subelem = ET.SubElement(elem, key)
+                    subelem.text = str(self._random_ray[key])
+
+    def _create_correlated_alias_subelement(self, root):
+        if self._correlated_alias is not None:
+            elem = ET.SubElement(root, "correlated_alias")
+            elem.text = str(self._correlated_alias).lower()
+
+    def _create_thermal_alias_subelement(self, root):
+        if self._thermal_alias is not None:
+            elem = ET.SubElement(root, "thermal_alias")
+            elem.text = str(self._thermal_alias).lower()
+
+    def _create_thinning_tolerance_subelement(self, root):
+        if self._thinning_tolerance is not None:
+            elem = ET.SubElement(root, "thinning_tolerance")
+            elem.text = str(self._thinning_tolerance)
+
+    def _create_compton_tables_subelement(self, root):
+        if self._compton_tables is not None:
+            elem = ET.SubElement(root, "compton_tables")
+            elem.text = str(self._compton_tables).lower()
+
+    def _create_photon_material_tables_subelement(self, root):
+        if self._photon_material_tables is not None:
+            elem = ET.SubElement(root, "photon_material_tables")
+            elem.text = str(self._photon_material_tables).lower()
+
+    def _create_photon_xs_tables_subelement(self, root):
+        if self._photon_xs_tables is not None:
+            elem = ET.SubElement(root, "photon_xs_tables")
+            elem.text = str(self._photon_xs_tables).lower()
+
+    def _create_broadcast_data_subelement(self, root):
+        if self._broadcast_data is not None:
+            elem = ET.SubElement(root, "broadcast_data")
+            elem.text = str(self._broadcast_data).lower()
+
+    def _create_dagmc_bvh_subelement(self, root):
+        if self._dagmc_bvh is not None:
+            elem = ET.SubElement(root, "dagmc_bvh")
+            elem.text = str(self._dagmc_bvh).lower()
+
+    def _create_performance_report_subelement(self, root):
+        if self._performance_report is not None:
+            elem = ET.SubElement(root, "performance_report")
+            elem.text = str(self._performance_report).lower()
+
+    def _create_instrument_subelement(self, root):
+        if self._instrument is not None:
+            elem = ET.SubElement(root, "instrument")
+            elem.text = str(self._instrument).lower()
+
+    def _create_azimuth_rejection_subelement(self, root):
+        if self._azimuth_rejection is not None:
+            elem = ET.SubElement(root, "azimuth_rejection")
+            elem.text = str(self._azimuth_rejection).lower()
+
+    def _create_alias_sampling_subelement(self, root):
+        if self._alias_sampling is not None:
+            elem = ET.SubElement(root, "alias_sampling")
+            elem.text = str(self._alias_sampling).lower()
+
     def _eigenvalue_from_xml_element(self, root):
         elem = root.find('eigenvalue')
         if elem is not None:
@@ -1124,11 +2622,15 @@ class Settings:
             text = get_text(elem, 'batches')
             if text is not None:
                 self.statepoint['batches'] = [int(x) for x in text.split()]
+            text = get_text(elem, 'incremental')
+            if text is not None:
+                self.statepoint['incremental'] = text in ('true', '1')
 
     def _sourcepoint_from_xml_element(self, root):
         elem = root.find('source_point')
         if elem is not None:
-            for key in ('separate', 'write', 'overwrite_latest', 'batches'):
+            for key in ('separate', 'write', 'overwrite_latest', 'batches',
+                        'format'):
                 value = get_text(elem, key)
                 if value is not None:
                     if key in ('separate', 'write'):
@@ -1136,6 +2638,8 @@ class Settings:
                     elif key == 'overwrite_latest':
                         value = value in ('true', '1')
                         key = 'overwrite'
+                    elif key == 'format':
+                        pass
                     else:
                         value = [int(x) for x in value.split()]
                     self.sourcepoint[key] = value
@@ -1185,7 +2689,9 @@ class Settings:
         if elem is not None:
             self.cutoff = {}
             for key in ('energy_neutron', 'energy_photon', 'energy_electron',
-                        'energy_positron', 'weight', 'weight_avg'):
+                        'energy_positron', 'weight', 'weight_avg',
+                        'time_neutron', 'time_photon', 'time_electron',
+                        'time_positron'):
                 value = get_text(elem, key)
                 if value is not None:
                     self.cutoff[key] = float(value)
@@ -1208,6 +2714,9 @@ class Settings:
             text = get_text(elem, 'batch_interval')
             if text is not None:
                 self.trigger_batch_interval = int(text)
+            text = get_text(elem, 'freeze')
+            if text is not None:
+                self.trigger_freeze = text in ('true', '1')
 
     def _no_reduce_from_xml_element(self, root):
         text = get_text(root, 'no_reduce')
@@ -1244,6 +2753,9 @@ class Settings:
         text = get_text(root, 'temperature_multipole')
         if text is not None:
             self.temperature['multipole'] = text in ('true', '1')
+        text = get_text(root, 'temperature_cache')
+        if text is not None:
+            self.temperature['cache'] = text in ('true', '1')
 
     def _trace_from_xml_element(self, root):
         text = get_text(root, 'trace')
@@ -1255,6 +2767,23 @@ class Settings:
         if text is not None:
             self.track = [int(x) for x in text.split()]
 
+    def _weight_windows_from_xml_element(self, root):
+        for elem in root.findall('weight_windows'):
+            path = "./mesh[@id='{}']".format(int(get_text(elem, 'mesh')))
+            mesh = RegularMesh.from_xml_element(root.find(path))
+            self.weight_windows.append(
+                WeightWindows.from_xml_element(elem, mesh))
+
+    def _mesh_fields_from_xml_element(self, root):
+        for elem in root.findall('mesh_field'):
+            path = "./mesh[@id='{}']".format(int(get_text(elem, 'mesh')))
+            mesh_elem = root.find(path)
+            if mesh_elem.get('type') == 'unstructured':
+                mesh = UnstructuredMesh.from_xml_element(mesh_elem)
+            else:
+                mesh = RegularMesh.from_xml_element(mesh_elem)
+            self.mesh_fields.append(MeshField.from_xml_element(elem, mesh))
+
     def _ufs_mesh_from_xml_element(self, root):
         text = get_text(root, 'ufs_mesh')
         if text is not None:
@@ -1263,6 +2792,22 @@ class Settings:
             if elem is not None:
                 self.ufs_mesh = RegularMesh.from_xml_element(elem)
 
+    def _precursor_mesh_from_xml_element(self, root):
+        text = get_text(root, 'precursor_mesh')
+        if text is not None:
+            path = "./mesh[@id='{}']".format(int(text))
+            elem = root.find(path)
+            if elem is not None:
+                self.precursor_mesh = RegularMesh.from_xml_element(elem)
+
+    def _domain_mesh_from_xml_element(self, root):
+        text = get_text(root, 'domain_mesh')
+        if text is not None:
+            path = "./mesh[@id='{}']".format(int(text))
+            elem = root.find(path)
+            if elem is not None:
+                self.domain_mesh = RegularMesh.from_xml_element(elem)
+
     def _resonance_scattering_from_xml_element(self, root):
         elem = root.find('resonance_scattering')
         if elem is not None:
@@ -1278,6 +2823,43 @@ class Settings:
                         value = value.split()
                     self.resonance_scattering[key] = value
 
+    def _cmfd_from_xml_element(self, root):
+        elem = root.find('cmfd')
+        if elem is not None:
+            text = get_text(elem, 'mesh')
+            if text is not None:
+                path = "./mesh[@id='{}']".format(int(text))
+                mesh_elem = root.find(path)
+                if mesh_elem is not None:
+                    self.cmfd['mesh'] = RegularMesh.from_xml_element(mesh_elem)
+            text = get_text(elem, 'energy_groups')
+            if text is not None:
+                self.cmfd['energy_groups'] = [float(x) for x in text.split()]
+            text = get_text(elem, 'begin')
+            if text is not None:
+                self.cmfd['begin'] = int(text)
+
+    def _surf_source_write_from_xml_element(self, root):
+        elem = root.find('surf_source_write')
+        if elem is not None:
+            text = get_text(elem, 'surface_ids')
+            if text is not None:
+                self.surf_source_write['surface_ids'] = [
+                    int(x) for x in text.split()]
+            text = get_text(elem, 'max_particles')
+            if text is not None:
+                self.surf_source_write['max_particles'] = int(text)
+
+    def _census_from_xml_element(self, root):
+        elem = root.find('census')
+        if elem is not None:
+            text = get_text(elem, 'time')
+            if text is not None:
+                self.census['time'] = float(text)
+            text = get_text(elem, 'max_particles')
+            if text is not None:
+                self.census['max_particles'] = int(text)
+
     def _create_fission_neutrons_from_xml_element(self, root):
         text = get_text(root, 'create_fission_neutrons')
         if text is not None:
@@ -1296,7 +2878,19 @@ class Settings:
     def _max_particles_in_flight_from_xml_element(self, root):
         text = get_text(root, 'max_particles_in_flight')
         if text is not None:
-            self.max_particles_in_flight = int(text)
+            text = text.strip().lower()
+            self.max_particles_in_flight = (text if text == 'auto'
+                                            else int(text))
+
+    def _event_memory_budget_from_xml_element(self, root):
+        text = get_text(root, 'event_memory_budget')
+        if text is not None:
+            self.event_memory_budget = float(text)
+
+    def _max_secondaries_from_xml_element(self, root):
+        text = get_text(root, 'max_secondaries')
+        if text is not None:
+            self.max_secondaries = int(text)
 
     def _material_cell_offsets_from_xml_element(self, root):
         text = get_text(root, 'material_cell_offsets')
@@ -1313,6 +2907,284 @@ class Settings:
         if text is not None:
             self.dagmc = text in ('true', '1')
 
+    def _event_queue_sort_from_xml_element(self, root):
+        text = get_text(root, 'event_queue_sort')
+        if text is not None:
+            self.event_queue_sort = text in ('true', '1')
+
+    def _event_queue_sort_threshold_from_xml_element(self, root):
+        text = get_text(root, 'event_queue_sort_threshold')
+        if text is not None:
+            self.event_queue_sort_threshold = int(text)
+
+    def _event_local_queue_length_from_xml_element(self, root):
+        text = get_text(root, 'event_local_queue_length')
+        if text is not None:
+            self.event_local_queue_length = int(text)
+
+    def _event_prefetch_distance_from_xml_element(self, root):
+        text = get_text(root, 'event_prefetch_distance')
+        if text is not None:
+            self.event_prefetch_distance = int(text)
+
+    def _event_scheduler_from_xml_element(self, root):
+        text = get_text(root, 'event_scheduler')
+        if text is not None:
+            self.event_scheduler = text
+
+    def _event_min_queue_length_from_xml_element(self, root):
+        text = get_text(root, 'event_min_queue_length')
+        if text is not None:
+            self.event_min_queue_length = int(text)
+
+    def _event_history_threshold_from_xml_element(self, root):
+        text = get_text(root, 'event_history_threshold')
+        if text is not None:
+            self.event_history_threshold = int(text)
+
+    def _event_refill_from_xml_element(self, root):
+        text = get_text(root, 'event_refill')
+        if text is not None:
+            self.event_refill = text in ('true', '1')
+
+    def _flat_geometry_from_xml_element(self, root):
+        text = get_text(root, 'flat_geometry')
+        if text is not None:
+            self.flat_geometry = text in ('true', '1')
+
+    def _event_fuse_advance_from_xml_element(self, root):
+        text = get_text(root, 'event_fuse_advance')
+        if text is not None:
+            self.event_fuse_advance = text in ('true', '1')
+
+    def _history_scheduler_from_xml_element(self, root):
+        text = get_text(root, 'history_scheduler')
+        if text is not None:
+            self.history_scheduler = text
+
+    def _history_interleave_from_xml_element(self, root):
+        text = get_text(root, 'history_interleave')
+        if text is not None:
+            self.history_interleave = int(text)
+
+    def _thread_affinity_from_xml_element(self, root):
+        text = get_text(root, 'thread_affinity')
+        if text is not None:
+            self.thread_affinity = text
+
+    def _vectorize_xs_from_xml_element(self, root):
+        text = get_text(root, 'vectorize_xs')
+        if text is not None:
+            self.vectorize_xs = text in ('true', '1')
+
+    def _compact_xs_cache_from_xml_element(self, root):
+        text = get_text(root, 'compact_xs_cache')
+        if text is not None:
+            self.compact_xs_cache = text in ('true', '1')
+
+    def _interleaved_xs_from_xml_element(self, root):
+        text = get_text(root, 'interleaved_xs')
+        if text is not None:
+            self.interleaved_xs = text in ('true', '1')
+
+    def _energy_search_from_xml_element(self, root):
+        text = get_text(root, 'energy_search')
+        if text is not None:
+            self.energy_search = text
+
+    def _shared_xs_from_xml_element(self, root):
+        text = get_text(root, 'shared_xs')
+        if text is not None:
+            self.shared_xs = text in ('true', '1')
+
+    def _threaded_xs_read_from_xml_element(self, root):
+        text = get_text(root, 'threaded_xs_read')
+        if text is not None:
+            self.threaded_xs_read = text in ('true', '1')
+
+    def _huge_pages_from_xml_element(self, root):
+        text = get_text(root, 'huge_pages')
+        if text is not None:
+            self.huge_pages = text in ('true', '1')
+
+    def _numa_interleave_from_xml_element(self, root):
+        text = get_text(root, 'numa_interleave')
+        if text is not None:
+            self.numa_interleave = text in ('true', '1')
+
+    def _lazy_products_from_xml_element(self, root):
+        text = get_text(root, 'lazy_products')
+        if text is not None:
+            self.lazy_products = text in ('true', '1')
+
+    def _xs_cache_from_xml_element(self, root):
+        text = get_text(root, 'xs_cache')
+        if text is not None:
+            self.xs_cache = text
+
+    def _neighbor_lists_from_xml_element(self, root):
+        text = get_text(root, 'neighbor_lists')
+        if text is not None:
+            self.neighbor_lists = text
+
+    def _event_batch_distance_from_xml_element(self, root):
+        text = get_text(root, 'event_batch_distance')
+        if text is not None:
+            self.event_batch_distance = text in ('true', '1')
+
+    def _delta_tracking_from_xml_element(self, root):
+        text = get_text(root, 'delta_tracking')
+        if text is not None:
+            self.delta_tracking = text in ('true', '1')
+
+    def _private_tallies_from_xml_element(self, root):
+        text = get_text(root, 'private_tallies')
+        if text is not None:
+            self.private_tallies = text in ('true', '1')
+
+    def _private_tallies_max_size_from_xml_element(self, root):
+        text = get_text(root, 'private_tallies_max_size')
+        if text is not None:
+            self.private_tallies_max_size = int(text)
+
+    def _pipeline_tallies_from_xml_element(self, root):
+        text = get_text(root, 'pipeline_tallies')
+        if text is not None:
+            self.pipeline_tallies = text in ('true', '1')
+
+    def _tally_profiling_from_xml_element(self, root):
+        text = get_text(root, 'tally_profiling')
+        if text is not None:
+            self.tally_profiling = text in ('true', '1')
+
+    def _load_balance_from_xml_element(self, root):
+        text = get_text(root, 'load_balance')
+        if text is not None:
+            self.load_balance = text in ('true', '1')
+
+    def _shared_bank_from_xml_element(self, root):
+        text = get_text(root, 'shared_bank')
+        if text is not None:
+            self.shared_bank = text in ('true', '1')
+
+    def _source_sort_from_xml_element(self, root):
+        text = get_text(root, 'source_sort')
+        if text is not None:
+            self.source_sort = text in ('true', '1')
+
+    def _retain_data_from_xml_element(self, root):
+        text = get_text(root, 'retain_data')
+        if text is not None:
+            self.retain_data = text in ('true', '1')
+
+    def _particle_ramp_from_xml_element(self, root):
+        text = get_text(root, 'particle_ramp')
+        if text is not None:
+            self.particle_ramp = float(text)
+
+    def _async_statepoint_from_xml_element(self, root):
+        text = get_text(root, 'async_statepoint')
+        if text is not None:
+            self.async_statepoint = text in ('true', '1')
+
+    def _tally_compression_from_xml_element(self, root):
+        text = get_text(root, 'tally_compression')
+        if text is not None:
+            self.tally_compression = int(text)
+
+    def _track_single_file_from_xml_element(self, root):
+        text = get_text(root, 'track_single_file')
+        if text is not None:
+            self.track_single_file = text in ('true', '1')
+
+    def _async_summary_from_xml_element(self, root):
+        text = get_text(root, 'async_summary')
+        if text is not None:
+            self.async_summary = text in ('true', '1')
+
+    def _vectorize_multipole_from_xml_element(self, root):
+        text = get_text(root, 'vectorize_multipole')
+        if text is not None:
+            self.vectorize_multipole = text in ('true', '1')
+
+    def _cumulative_xs_from_xml_element(self, root):
+        text = get_text(root, 'cumulative_xs')
+        if text is not None:
+            self.cumulative_xs = text in ('true', '1')
+
+    def _random_generator_from_xml_element(self, root):
+        text = get_text(root, 'random_generator')
+        if text is not None:
+            self.random_generator = text
+
+    def _random_ray_from_xml_element(self, root):
+        elem = root.find('random_ray')
+        if elem is not None:
+            for key in ('distance_inactive', 'distance_active'):
+                text = get_text(elem, key)
+                if text is not None:
+                    self.random_ray[key] = float(text)
+
+    def _correlated_alias_from_xml_element(self, root):
+        text = get_text(root, 'correlated_alias')
+        if text is not None:
+            self.correlated_alias = text in ('true', '1')
+
+    def _thermal_alias_from_xml_element(self, root):
+        text = get_text(root, 'thermal_alias')
+        if text is not None:
+            self.thermal_alias = text in ('true', '1')
+
+    def _thinning_tolerance_from_xml_element(self, root):
+        text = get_text(root, 'thinning_tolerance')
+        if text is not None:
+            self.thinning_tolerance = float(text)
+
+    def _compton_tables_from_xml_element(self, root):
+        text = get_text(root, 'compton_tables')
+        if text is not None:
+            self.compton_tables = text in ('true', '1')
+
+    def _photon_material_tables_from_xml_element(self, root):
+        text = get_text(root, 'photon_material_tables')
+        if text is not None:
+            self.photon_material_tables = text in ('true', '1')
+
+    def _photon_xs_tables_from_xml_element(self, root):
+        text = get_text(root, 'photon_xs_tables')
+        if text is not None:
+            self.photon_xs_tables = text in ('true', '1')
+
+    def _broadcast_data_from_xml_element(self, root):
+        text = get_text(root, 'broadcast_data')
+        if text is not None:
+            self.broadcast_data = text in ('true', '1')
+
+    def _dagmc_bvh_from_xml_element(self, root):
+        text = get_text(root, 'dagmc_bvh')
+        if text is not None:
+            self.dagmc_bvh = text in ('true', '1')
+
+    def _performance_report_from_xml_element(self, root):
+        text = get_text(root, 'performance_report')
+        if text is not None:
+            self.performance_report = text in ('true', '1')
+
+    def _instrument_from_xml_element(self, root):
+        text = get_text(root, 'instrument')
+        if text is not None:
+            self.instrument = text in ('true', '1')
+
+    def _azimuth_rejection_from_xml_element(self, root):
+        text = get_text(root, 'azimuth_rejection')
+        if text is not None:
+            self.azimuth_rejection = text in ('true', '1')
+
+    def _alias_sampling_from_xml_element(self, root):
+        text = get_text(root, 'alias_sampling')
+        if text is not None:
+            self.alias_sampling = text in ('true', '1')
+
     def export_to_xml(self, path='settings.xml'):
         """Export simulation settings to an XML file.
 
@@ -1356,15 +3228,79 @@ class Settings:
         self._create_trace_subelement(root_element)
         self._create_track_subelement(root_element)
         self._create_ufs_mesh_subelement(root_element)
+        self._create_precursor_mesh_subelement(root_element)
+        self._create_domain_mesh_subelement(root_element)
         self._create_resonance_scattering_subelement(root_element)
+        self._create_cmfd_subelement(root_element)
+        self._create_surf_source_write_subelement(root_element)
+        self._create_census_subelement(root_element)
         self._create_volume_calcs_subelement(root_element)
+        self._create_weight_windows_subelement(root_element)
+        self._create_mesh_fields_subelement(root_element)
         self._create_create_fission_neutrons_subelement(root_element)
         self._create_delayed_photon_scaling_subelement(root_element)
         self._create_event_based_subelement(root_element)
         self._create_max_particles_in_flight_subelement(root_element)
+        self._create_event_memory_budget_subelement(root_element)
+        self._create_max_secondaries_subelement(root_element)
         self._create_material_cell_offsets_subelement(root_element)
         self._create_log_grid_bins_subelement(root_element)
         self._create_dagmc_subelement(root_element)
+        self._create_event_queue_sort_subelement(root_element)
+        self._create_event_queue_sort_threshold_subelement(root_element)
+        self._create_event_local_queue_length_subelement(root_element)
+        self._create_event_prefetch_distance_subelement(root_element)
+        self._create_event_scheduler_subelement(root_element)
+        self._create_event_min_queue_length_subelement(root_element)
+        self._create_event_history_threshold_subelement(root_element)
+        self._create_event_refill_subelement(root_element)
+        self._create_flat_geometry_subelement(root_element)
+        self._create_event_fuse_advance_subelement(root_element)
+        self._create_history_scheduler_subelement(root_element)
+        self._create_history_interleave_subelement(root_element)
+        self._create_thread_affinity_subelement(root_element)
+        self._create_vectorize_xs_subelement(root_element)
+        self._create_compact_xs_cache_subelement(root_element)
+        self._create_interleaved_xs_subelement(root_element)
+        self._create_energy_search_subelement(root_element)
+        self._create_shared_xs_subelement(root_element)
+        self._create_threaded_xs_read_subelement(root_element)
+        self._create_huge_pages_subelement(root_element)
+        self._create_numa_interleave_subelement(root_element)
+        self._create_lazy_products_subelement(root_element)
+        self._create_xs_cache_subelement(root_element)
+        self._create_neighbor_lists_subelement(root_element)
+        self._create_event_batch_distance_subelement(root_element)
+        self._create_delta_tracking_subelement(root_element)
+        self._create_private_tallies_subelement(root_element)
+        self._create_private_tallies_max_size_subelement(root_element)
+        self._create_pipeline_tallies_subelement(root_element)
+        self._create_tally_profiling_subelement(root_element)
+        self._create_load_balance_subelement(root_element)
+        self._create_shared_bank_subelement(root_element)
+        self._create_source_sort_subelement(root_element)
+        self._create_retain_data_subelement(root_element)
+        self._create_particle_ramp_subelement(root_element)
+        self._create_async_statepoint_subelement(root_element)
+        self._create_tally_compression_subelement(root_element)
+        self._create_track_single_file_subelement(root_element)
+        self._create_async_summary_subelement(root_element)
+        self._create_vectorize_multipole_subelement(root_element)
+        self._create_cumulative_xs_subelement(root_element)
+        self._create_random_generator_subelement(root_element)
+        self._create_random_ray_subelement(root_element)
+        self._create_correlated_alias_subelement(root_element)
+        self._create_thermal_alias_subelement(root_element)
+        self._create_thinning_tolerance_subelement(root_element)
+        self._create_compton_tables_subelement(root_element)
+        self._create_photon_material_tables_subelement(root_element)
+        self._create_photon_xs_tables_subelement(root_element)
+        self._create_broadcast_data_subelement(root_element)
+        self._create_dagmc_bvh_subelement(root_element)
+        self._create_performance_report_subelement(root_element)
+        self._create_instrument_subelement(root_element)
+        self._create_azimuth_rejection_subelement(root_element)
+        self._create_alias_sampling_subelement(root_element)
 
         # Clean the indentation in the file to be user-readable
         clean_indentation(root_element)
@@ -1428,14 +3364,78 @@ class Settings:
         settings._trace_from_xml_element(root)
         settings._track_from_xml_element(root)
         settings._ufs_mesh_from_xml_element(root)
+        settings._precursor_mesh_from_xml_element(root)
+        settings._domain_mesh_from_xml_element(root)
         settings._resonance_scattering_from_xml_element(root)
+        settings._cmfd_from_xml_element(root)
+        settings._surf_source_write_from_xml_element(root)
+        settings._census_from_xml_element(root)
         settings._create_fission_neutrons_from_xml_element(root)
         settings._delayed_photon_scaling_from_xml_element(root)
         settings._event_based_from_xml_element(root)
         settings._max_particles_in_flight_from_xml_element(root)
+        settings._event_memory_budget_from_xml_element(root)
+        settings._max_secondaries_from_xml_element(root)
         settings._material_cell_offsets_from_xml_element(root)
         settings._log_grid_bins_from_xml_element(root)
         settings._dagmc_from_xml_element(root)
+        settings._event_queue_sort_from_xml_element(root)
+        settings._event_queue_sort_threshold_from_xml_element(root)
+        settings._event_local_queue_length_from_xml_element(root)
+        settings._event_prefetch_distance_from_xml_element(root)
+        settings._event_scheduler_from_xml_element(root)
+        settings._event_min_queue_length_from_xml_element(root)
+        settings._event_history_threshold_from_xml_element(root)
+        settings._event_refill_from_xml_element(root)
+        settings._flat_geometry_from_xml_element(root)
+        settings._event_fuse_advance_from_xml_element(root)
+        settings._history_scheduler_from_xml_element(root)
+        settings._history_interleave_from_xml_element(root)
+        settings._thread_affinity_from_xml_element(root)
+        settings._vectorize_xs_from_xml_element(root)
+        settings._compact_xs_cache_from_xml_element(root)
+        settings._interleaved_xs_from_xml_element(root)
+        settings._energy_search_from_xml_element(root)
+        settings._shared_xs_from_xml_element(root)
+        settings._threaded_xs_read_from_xml_element(root)
+        settings._huge_pages_from_xml_element(root)
+        settings._numa_interleave_from_xml_element(root)
+        settings._lazy_products_from_xml_element(root)
+        settings._xs_cache_from_xml_element(root)
+        settings._neighbor_lists_from_xml_element(root)
+        settings._event_batch_distance_from_xml_element(root)
+        settings._delta_tracking_from_xml_element(root)
+        settings._private_tallies_from_xml_element(root)
+        settings._private_tallies_max_size_from_xml_element(root)
+        settings._pipeline_tallies_from_xml_element(root)
+        settings._tally_profiling_from_xml_element(root)
+        settings._load_balance_from_xml_element(root)
+        settings._shared_bank_from_xml_element(root)
+        settings._source_sort_from_xml_element(root)
+        settings._retain_data_from_xml_element(root)
+        settings._particle_ramp_from_xml_element(root)
+        settings._async_statepoint_from_xml_element(root)
+        settings._tally_compression_from_xml_element(root)
+        settings._track_single_file_from_xml_element(root)
+        settings._async_summary_from_xml_element(root)
+        settings._vectorize_multipole_from_xml_element(root)
+        settings._cumulative_xs_from_xml_element(root)
+        settings._random_generator_from_xml_element(root)
+        settings._random_ray_from_xml_element(root)
+        settings._correlated_alias_from_xml_element(root)
+        settings._thermal_alias_from_xml_element(root)
+        settings._thinning_tolerance_from_xml_element(root)
+        settings._compton_tables_from_xml_element(root)
+        settings._photon_material_tables_from_xml_element(root)
+        settings._photon_xs_tables_from_xml_element(root)
+        settings._broadcast_data_from_xml_element(root)
+        settings._dagmc_bvh_from_xml_element(root)
+        settings._performance_report_from_xml_element(root)
+        settings._instrument_from_xml_element(root)
+        settings._azimuth_rejection_from_xml_element(root)
+        settings._alias_sampling_from_xml_element(root)
+        settings._weight_windows_from_xml_element(root)
+        settings._mesh_fields_from_xml_element(root)
 
         # TODO: Get volume calculations
 
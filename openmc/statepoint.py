@@ -53,6 +53,10 @@ class StatePoint:
         Date and time at which statepoint was written
     entropy : numpy.ndarray
         Shannon entropy of fission source at each batch
+    event_kernels : dict or None
+        Dictionary whose keys are names of event-based transport kernels and
+        whose values are dictionaries of occupancy and throughput metrics for
+        the kernel. None if the simulation did not use event-based transport.
     filters : dict
         Dictionary whose keys are filter IDs and whose values are Filter
         objects
@@ -126,6 +130,12 @@ class StatePoint:
         # Check filetype and version
         cv.check_filetype_version(self._f, 'statepoint', _VERSION_STATEPOINT)
 
+        # Incremental state points only hold the changes of tally results
+        if 'previous' in self._f.attrs:
+            warnings.warn("State point {} is incremental. Use "
+                          "openmc-reconstruct-statepoint to obtain the full "
+                          "tally results.".format(filename))
+
         # Set flags for what data has been read
         self._meshes_read = False
         self._filters_read = False
@@ -204,6 +214,15 @@ class StatePoint:
         else:
             return None
 
+    @property
+    def event_kernels(self):
+        if 'event_kernels' in self._f:
+            return {kernel: {name: dataset[()]
+                             for name, dataset in group.items()}
+                    for kernel, group in self._f['event_kernels'].items()}
+        else:
+            return None
+
     @property
     def filters(self):
         if not self._filters_read:
@@ -1,7 +1,7 @@
 from abc import ABC, abstractmethod
 from collections.abc import Iterable
 from math import pi
-from numbers import Real
+from numbers import Integral, Real
 from xml.etree import ElementTree as ET
 
 import numpy as np
@@ -626,6 +626,12 @@ class Box(Spatial):
     only_fissionable : bool, optional
         Whether spatial sites should only be accepted if they occur in
         fissionable materials
+    acceptance_grid : Iterable of int, optional
+        Number of voxels along x, y and z of a grid over the cuboid. Voxels
+        in which no site can be accepted, as determined by probing points
+        inside them, are never sampled.
+
+        .. versionadded:: 0.12
 
     Attributes
     ----------
@@ -636,14 +642,20 @@ class Box(Spatial):
     only_fissionable : bool, optional
         Whether spatial sites should only be accepted if they occur in
         fissionable materials
+    acceptance_grid : Iterable of int or None
+        Number of voxels along x, y and z of a grid over the cuboid. Voxels
+        in which no site can be accepted, as determined by probing points
+        inside them, are never sampled.
 
     """
 
 
-    def __init__(self, lower_left, upper_right, only_fissionable=False):
+    def __init__(self, lower_left, upper_right, only_fissionable=False,
+                 acceptance_grid=None):
         self.lower_left = lower_left
         self.upper_right = upper_right
         self.only_fissionable = only_fissionable
+        self.acceptance_grid = acceptance_grid
 
     @property
     def lower_left(self):
@@ -657,6 +669,10 @@ class Box(Spatial):
     def only_fissionable(self):
         return self._only_fissionable
 
+    @property
+    def acceptance_grid(self):
+        return self._acceptance_grid
+
     @lower_left.setter
     def lower_left(self, lower_left):
         cv.check_type('lower left coordinate', lower_left, Iterable, Real)
@@ -674,6 +690,16 @@ class Box(Spatial):
         cv.check_type('only fissionable', only_fissionable, bool)
         self._only_fissionable = only_fissionable
 
+    @acceptance_grid.setter
+    def acceptance_grid(self, acceptance_grid):
+        if acceptance_grid is not None:
+            cv.check_type('acceptance grid', acceptance_grid, Iterable,
+                          Integral)
+            cv.check_length('acceptance grid', acceptance_grid, 3)
+            for n in acceptance_grid:
+                cv.check_greater_than('acceptance grid', n, 0)
+        self._acceptance_grid = acceptance_grid
+
     def to_xml_element(self):
         """Return XML representation of the box distribution
 
@@ -691,6 +717,9 @@ class Box(Spatial):
         params = ET.SubElement(element, "parameters")
         params.text = ' '.join(map(str, self.lower_left)) + ' ' + \
                       ' '.join(map(str, self.upper_right))
+        if self.acceptance_grid is not None:
+            grid = ET.SubElement(element, "acceptance_grid")
+            grid.text = ' '.join(map(str, self.acceptance_grid))
         return element
 
     @classmethod
@@ -712,7 +741,10 @@ class Box(Spatial):
         params = [float(x) for x in get_text(elem, 'parameters').split()]
         lower_left = params[:len(params)//2]
         upper_right = params[len(params)//2:]
-        return cls(lower_left, upper_right, only_fissionable)
+        acceptance_grid = get_text(elem, 'acceptance_grid')
+        if acceptance_grid is not None:
+            acceptance_grid = [int(x) for x in acceptance_grid.split()]
+        return cls(lower_left, upper_right, only_fissionable, acceptance_grid)
 
 
 class Point(Spatial):
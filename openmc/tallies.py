@@ -92,6 +92,16 @@ class Tally(IDManagerMixin):
     sparse : bool
         Whether or not the tally uses SciPy's LIL sparse matrix format for
         compressed data storage
+    sparse_results : bool
+        Whether or not results are only stored for the bins that are scored
+        during the simulation, which saves memory for tallies with many bins
+        that are mostly empty
+    decomposed : bool
+        Whether or not the bins of the tally are divided among MPI processes,
+        each of which only stores the bins it owns
+    history_statistics : bool
+        Whether or not each history rather than each batch is a realization of
+        the tally, which saves the memory of the scores of the current batch
     derivative : openmc.TallyDerivative
         A material perturbation derivative to apply to all scores in the tally.
 
@@ -121,6 +131,9 @@ class Tally(IDManagerMixin):
         self._with_batch_statistics = False
         self._derived = False
         self._sparse = False
+        self._sparse_results = False
+        self._decomposed = False
+        self._history_statistics = False
 
         self._sp_filename = None
         self._results_read = False
@@ -202,9 +215,19 @@ class Tally(IDManagerMixin):
         # Open the HDF5 statepoint file
         with h5py.File(self._sp_filename, 'r') as f:
             # Extract Tally data from the file
-            data = f['tallies/tally {}/results'.format(self.id)]
-            sum_ = data[:, :, 0]
-            sum_sq = data[:, :, 1]
+            group = f['tallies/tally {}'.format(self.id)]
+            if 'results_index' in group:
+                # Sparse results only store the bins that were scored
+                index = group['results_index'][()]
+                data = group['results'][()]
+                sum_ = np.zeros(np.prod(self.shape))
+                sum_sq = np.zeros(np.prod(self.shape))
+                sum_[index] = data[:, 0]
+                sum_sq[index] = data[:, 1]
+            else:
+                data = group['results']
+                sum_ = data[:, :, 0]
+                sum_sq = data[:, :, 1]
 
             # Reshape the results arrays
             sum_ = np.reshape(sum_, self.shape)
@@ -306,6 +329,18 @@ class Tally(IDManagerMixin):
     def sparse(self):
         return self._sparse
 
+    @property
+    def sparse_results(self):
+        return self._sparse_results
+
+    @property
+    def decomposed(self):
+        return self._decomposed
+
+    @property
+    def history_statistics(self):
+        return self._history_statistics
+
     @estimator.setter
     def estimator(self, estimator):
         cv.check_value('estimator', estimator, ESTIMATOR_TYPES)
@@ -414,6 +449,21 @@ class Tally(IDManagerMixin):
         cv.check_type('sum_sq', sum_sq, Iterable)
         self._sum_sq = sum_sq
 
+    @sparse_results.setter
+    def sparse_results(self, sparse_results):
+        cv.check_type('sparse results', sparse_results, bool)
+        self._sparse_results = sparse_results
+
+    @decomposed.setter
+    def decomposed(self, decomposed):
+        cv.check_type('decomposed', decomposed, bool)
+        self._decomposed = decomposed
+
+    @history_statistics.setter
+    def history_statistics(self, history_statistics):
+        cv.check_type('history statistics', history_statistics, bool)
+        self._history_statistics = history_statistics
+
     @sparse.setter
     def sparse(self, sparse):
         """Convert tally data from NumPy arrays to SciPy list of lists (LIL)
@@ -858,6 +908,21 @@ class Tally(IDManagerMixin):
             subelement = ET.SubElement(element, "estimator")
             subelement.text = self.estimator
 
+        # Sparse storage of results
+        if self.sparse_results:
+            subelement = ET.SubElement(element, "sparse_results")
+            subelement.text = 'true'
+
+        # Decomposition of results across processes
+        if self.decomposed:
+            subelement = ET.SubElement(element, "decomposed")
+            subelement.text = 'true'
+
+        # Realizations of the tally
+        if self.history_statistics:
+            subelement = ET.SubElement(element, "history_statistics")
+            subelement.text = 'true'
+
         # Optional Triggers
         for trigger in self.triggers:
             trigger.get_trigger_xml(element)
@@ -0,0 +1,326 @@
+from collections.abc import Iterable
+from numbers import Real, Integral
+from xml.etree import ElementTree as ET
+
+import numpy as np
+
+import openmc
+import openmc.checkvalue as cv
+from ._xml import get_text
+from .filter import _PARTICLES
+from .mixin import IDManagerMixin
+
+
+class WeightWindows(IDManagerMixin):
+    """Mesh-based weight windows for splitting and Russian roulette
+
+    When a particle crosses a surface or leaves a collision, its weight is
+    compared with the window of the mesh cell and energy group it is in. A
+    particle whose weight is above the upper bound is split, and a particle
+    whose weight is below the lower bound plays Russian roulette.
+
+    Parameters
+    ----------
+    mesh : openmc.RegularMesh
+        Mesh over which the windows are defined
+    lower_ww_bounds : Iterable of float
+        Lower weight bound of each mesh cell and energy group, indexed by mesh
+        cell then energy group. A cell and group with a non-positive bound has
+        no window.
+    energy_bounds : Iterable of float, optional
+        Boundaries of the energy groups in [eV]. If not given, a single group
+        covers all energies.
+    particle_type : {'neutron', 'photon', 'electron', 'positron'}
+        Type of particle the windows apply to
+    ww_id : int
+        Unique identifier for the weight windows
+
+    Attributes
+    ----------
+    id : int
+        Unique identifier for the weight windows
+    mesh : openmc.RegularMesh
+        Mesh over which the windows are defined
+    lower_ww_bounds : numpy.ndarray
+        Lower weight bound of each mesh cell and energy group
+    energy_bounds : Iterable of float or None
+        Boundaries of the energy groups in [eV]
+    particle_type : {'neutron', 'photon', 'electron', 'positron'}
+        Type of particle the windows apply to
+    upper_bound_ratio : float
+        Ratio of the upper to the lower weight bound
+    survival_ratio : float
+        Ratio of the weight given to particles surviving Russian roulette to
+        the lower weight bound
+    max_split : int
+        Largest number of copies a particle is split into at once
+    weight_cutoff : float
+        Weight below which particles are killed without playing Russian
+        roulette
+
+    """
+
+    next_id = 1
+    used_ids = set()
+
+    def __init__(self, mesh, lower_ww_bounds, energy_bounds=None,
+                 particle_type='neutron', ww_id=None):
+        self.id = ww_id
+        self.mesh = mesh
+        self.energy_bounds = energy_bounds
+        self.lower_ww_bounds = lower_ww_bounds
+        self.particle_type = particle_type
+        self._upper_bound_ratio = None
+        self._survival_ratio = None
+        self._max_split = None
+        self._weight_cutoff = None
+
+    @property
+    def mesh(self):
+        return self._mesh
+
+    @property
+    def lower_ww_bounds(self):
+        return self._lower_ww_bounds
+
+    @property
+    def energy_bounds(self):
+        return self._energy_bounds
+
+    @property
+    def particle_type(self):
+        return self._particle_type
+
+    @property
+    def upper_bound_ratio(self):
+        return self._upper_bound_ratio
+
+    @property
+    def survival_ratio(self):
+        return self._survival_ratio
+
+    @property
+    def max_split(self):
+        return self._max_split
+
+    @property
+    def weight_cutoff(self):
+        return self._weight_cutoff
+
+    @property
+    def num_energy_groups(self):
+        if self.energy_bounds is None:
+            return 1
+        return len(self.energy_bounds) - 1
+
+    @mesh.setter
+    def mesh(self, mesh):
+        cv.check_type('weight windows mesh', mesh, openmc.RegularMesh)
+        self._mesh = mesh
+
+    @lower_ww_bounds.setter
+    def lower_ww_bounds(self, bounds):
+        bounds = np.asarray(bounds, dtype=float)
+        n_groups = self.num_energy_groups
+        if bounds.size != self.mesh.num_mesh_cells*n_groups:
+            raise ValueError('The number of lower weight window bounds must be '
+                             'the number of mesh cells times the number of '
+                             'energy groups.')
+        self._lower_ww_bounds = bounds.reshape(-1, n_groups)
+
+    @energy_bounds.setter
+    def energy_bounds(self, bounds):
+        if bounds is not None:
+            cv.check_type('weight windows energy bounds', bounds, Iterable,
+                          Real)
+            cv.check_length('weight windows energy bounds', bounds, 2)
+            bounds = list(bounds)
+            if any(b >= a for b, a in zip(bounds, bounds[1:])):
+                raise ValueError('Weight windows energy bounds must be given '
+                                 'in increasing order.')
+        self._energy_bounds = bounds
+
+    @particle_type.setter
+    def particle_type(self, particle_type):
+        cv.check_value('weight windows particle type', particle_type,
+                       _PARTICLES)
+        self._particle_type = particle_type
+
+    @upper_bound_ratio.setter
+    def upper_bound_ratio(self, ratio):
+        cv.check_type('upper weight bound ratio', ratio, Real)
+        cv.check_greater_than('upper weight bound ratio', ratio, 1.0)
+        self._upper_bound_ratio = ratio
+
+    @survival_ratio.setter
+    def survival_ratio(self, ratio):
+        cv.check_type('survival weight ratio', ratio, Real)
+        cv.check_greater_than('survival weight ratio', ratio, 1.0, True)
+        self._survival_ratio = ratio
+
+    @max_split.setter
+    def max_split(self, max_split):
+        cv.check_type('maximum number of splits', max_split, Integral)
+        cv.check_greater_than('maximum number of splits', max_split, 1, True)
+        self._max_split = max_split
+
+    @weight_cutoff.setter
+    def weight_cutoff(self, cutoff):
+        cv.check_type('weight windows weight cutoff', cutoff, Real)
+        cv.check_greater_than('weight windows weight cutoff', cutoff, 0.0,
+                              True)
+        self._weight_cutoff = cutoff
+
+    @classmethod
+    def from_tally(cls, tally, upper_bound_ratio=5.0, rel_err_max=0.5,
+                   particle_type=None):
+        """Generate weight windows from the flux of a previous run
+
+        The lower weight bound of each mesh cell is proportional to its flux,
+        as in the MAGIC method, so that particles keep roughly the same
+        population throughout the mesh. In each energy group, the bounds are
+        normalized so that the window of the cell with the largest flux is
+        centered on unit weight.
+
+        Parameters
+        ----------
+        tally : openmc.Tally
+            Tally with results scoring the flux with a mesh filter over a
+            regular mesh and optionally an energy filter
+        upper_bound_ratio : float
+            Ratio of the upper to the lower weight bound
+        rel_err_max : float
+            Largest relative error of the flux in a cell and energy group for
+            which a window is made. Other cells and groups have no window.
+        particle_type : {'neutron', 'photon', 'electron', 'positron'}, optional
+            Type of particle the windows apply to. If not given, it is taken
+            from the particle filter of the tally or is a neutron.
+
+        Returns
+        -------
+        openmc.WeightWindows
+            Weight windows over the mesh and energy groups of the tally
+
+        """
+        cv.check_type('tally', tally, openmc.Tally)
+        cv.check_greater_than('upper weight bound ratio', upper_bound_ratio,
+                              1.0)
+        if 'flux' not in tally.scores:
+            raise ValueError('Weight windows can only be generated from a '
+                             'tally scoring the flux.')
+
+        mesh_filter = tally.find_filter(openmc.MeshFilter)
+        try:
+            energy_filter = tally.find_filter(openmc.EnergyFilter)
+        except ValueError:
+            energy_filter = None
+        if particle_type is None:
+            particle_type = 'neutron'
+            try:
+                particle_filter = tally.find_filter(openmc.ParticleFilter)
+            except ValueError:
+                pass
+            else:
+                if len(particle_filter.bins) != 1:
+                    raise ValueError('The particle type must be given for '
+                                     'tallies of several particles.')
+                particle_type = particle_filter.bins[0]
+
+        # Arrange the flux by mesh cell then energy group, summing over any
+        # other filter
+        shape = [f.num_bins for f in tally.filters]
+        axes = [tally.filters.index(mesh_filter)]
+        if energy_filter is not None:
+            axes.append(tally.filters.index(energy_filter))
+
+        def arrange(values):
+            values = values[:, 0, 0].reshape(shape)
+            values = np.moveaxis(values, axes, range(len(axes)))
+            values = values.sum(axis=tuple(range(len(axes), len(shape))))
+            return values.reshape(mesh_filter.num_bins, -1)
+
+        mean = arrange(tally.get_values(scores=['flux']))
+        variance = arrange(tally.get_values(scores=['flux'],
+                                            value='std_dev')**2)
+
+        # Normalize the flux in each energy group so that the window of the
+        # cell with the largest flux is centered on unit weight
+        flux_max = mean.max(axis=0)
+        lower = np.full(mean.shape, -1.0)
+        valid = (mean > 0.0) & (np.sqrt(variance) <= rel_err_max*mean)
+        scale = np.divide(2.0/(upper_bound_ratio + 1.0), flux_max,
+                          out=np.zeros_like(flux_max), where=flux_max > 0.0)
+        lower[valid] = (mean*scale)[valid]
+
+        energy_bounds = None if energy_filter is None else energy_filter.values
+        ww = cls(mesh_filter.mesh, lower, energy_bounds, particle_type)
+        ww.upper_bound_ratio = upper_bound_ratio
+        return ww
+
+    def to_xml_element(self):
+        """Return XML representation of the weight windows
+
+        Returns
+        -------
+        element : xml.etree.ElementTree.Element
+            XML element containing weight windows data
+
+        """
+        element = ET.Element('weight_windows')
+        element.set('id', str(self.id))
+
+        subelement = ET.SubElement(element, 'mesh')
+        subelement.text = str(self.mesh.id)
+
+        subelement = ET.SubElement(element, 'particle_type')
+        subelement.text = self.particle_type
+
+        if self.energy_bounds is not None:
+            subelement = ET.SubElement(element, 'energy_bounds')
+            subelement.text = ' '.join(str(e) for e in self.energy_bounds)
+
+        subelement = ET.SubElement(element, 'lower_ww_bounds')
+        subelement.text = ' '.join(str(w) for w in self.lower_ww_bounds.flat)
+
+        for key in ('upper_bound_ratio', 'survival_ratio', 'max_split',
+                    'weight_cutoff'):
+            value = getattr(self, key)
+            if value is not None:
+                subelement = ET.SubElement(element, key)
+                subelement.text = str(value)
+
+        return element
+
+    @classmethod
+    def from_xml_element(cls, elem, mesh):
+        """Generate weight windows from an XML element
+
+        Parameters
+        ----------
+        elem : xml.etree.ElementTree.Element
+            XML element
+        mesh : openmc.RegularMesh
+            Mesh over which the windows are defined
+
+        Returns
+        -------
+        openmc.WeightWindows
+            Weight windows generated from XML element
+
+        """
+        ww_id = int(get_text(elem, 'id'))
+        particle_type = get_text(elem, 'particle_type', 'neutron')
+        energy_bounds = get_text(elem, 'energy_bounds')
+        if energy_bounds is not None:
+            energy_bounds = [float(e) for e in energy_bounds.split()]
+        lower = [float(w) for w in get_text(elem, 'lower_ww_bounds').split()]
+        ww = cls(mesh, lower, energy_bounds, particle_type, ww_id)
+
+        for key, type_ in (('upper_bound_ratio', float),
+                           ('survival_ratio', float), ('max_split', int),
+                           ('weight_cutoff', float)):
+            text = get_text(elem, key)
+            if text is not None:
+                setattr(ww, key, type_(text))
+
+        return ww
@@ -1,10 +1,17 @@
 #include "openmc/bank.h"
 #include "openmc/capi.h"
+#include "openmc/constants.h"
+#include "openmc/domain_decomposition.h"
 #include "openmc/error.h"
 #include "openmc/simulation.h"
 #include "openmc/message_passing.h"
+#include "openmc/openmp_interface.h"
+#include "openmc/settings.h"
 
+#include <algorithm> // for max, sort
 #include <cstdint>
+#include <utility> // for pair
+#include <vector>
 
 
 namespace openmc {
@@ -28,8 +35,47 @@ SharedArray<Particle::Bank> fission_bank;
 // used to efficiently sort the fission bank after each iteration.
 std::vector<int64_t> progeny_per_particle;
 
+// Sites sampled from the fission bank to form the source of the next
+// generation, unless they are shared among the processes on a node
+std::vector<Particle::Bank> temp_sites;
+
+SharedArray<Particle::Bank> surf_source_bank;
+
+SharedArray<Particle::Bank> census_bank;
+
+int64_t n_census_discarded {0};
+
 } // namespace simulation
 
+namespace {
+#ifdef OPENMC_MPI
+// Window holding the sites sampled on each process of a node when they are
+// shared among the processes
+MPI_Win temp_sites_window {MPI_WIN_NULL};
+Particle::Bank* temp_sites_shared {nullptr};
+int64_t temp_sites_capacity {0};
+#endif
+
+// Surface source sites recorded by each thread during the current history
+thread_local std::vector<Particle::Bank> surf_source_buffer;
+
+// Fission sites created by each thread during the current collision
+thread_local std::vector<Particle::Bank> fission_site_buffer;
+
+//! Spread the lowest 21 bits of a value so that each is followed by two zero
+//! bits, which interleaves three such values when they are shifted and or'ed
+uint64_t spread_bits(uint64_t x)
+{
+  x &= 0x1fffff;
+  x = (x | x << 32) & 0x1f00000000ffffull;
+  x = (x | x << 16) & 0x1f0000ff0000ffull;
+  x = (x | x << 8) & 0x100f00f00f00f00full;
+  x = (x | x << 4) & 0x10c30c30c30c30c3ull;
+  x = (x | x << 2) & 0x1249249249249249ull;
+  return x;
+}
+} // namespace
+
 //==============================================================================
 // Non-member functions
 //==============================================================================
@@ -39,6 +85,111 @@ void free_memory_bank()
   simulation::source_bank.clear();
   simulation::fission_bank.clear();
   simulation::progeny_per_particle.clear();
+  simulation::temp_sites.clear();
+  simulation::temp_sites.shrink_to_fit();
+  simulation::surf_source_bank.clear();
+  simulation::census_bank.clear();
+#ifdef OPENMC_MPI
+  if (temp_sites_window != MPI_WIN_NULL) MPI_Win_free(&temp_sites_window);
+  temp_sites_shared = nullptr;
+  temp_sites_capacity = 0;
+#endif
+}
+
+Particle::Bank* reserve_temp_sites(int64_t n)
+{
+#ifdef OPENMC_MPI
+  if (settings::shared_bank) {
+    // The window can only be reallocated by all processes on the node at once
+    int grow = (n > temp_sites_capacity);
+    MPI_Allreduce(MPI_IN_PLACE, &grow, 1, MPI_INT, MPI_LOR, mpi::node_comm);
+    if (grow) {
+      if (temp_sites_window != MPI_WIN_NULL) MPI_Win_free(&temp_sites_window);
+      temp_sites_capacity = std::max(n, temp_sites_capacity);
+      MPI_Win_allocate_shared(temp_sites_capacity*sizeof(Particle::Bank),
+        sizeof(Particle::Bank), MPI_INFO_NULL, mpi::node_comm,
+        &temp_sites_shared, &temp_sites_window);
+    }
+    return temp_sites_shared;
+  }
+#endif
+
+  // The vector is kept between generations so that it is only reallocated
+  // when more sites are sampled than in any previous generation
+  auto& temp_sites {simulation::temp_sites};
+  if (static_cast<int64_t>(temp_sites.size()) < n) temp_sites.resize(n);
+  return temp_sites.data();
+}
+
+#ifdef OPENMC_MPI
+const Particle::Bank* node_temp_sites(int node_rank)
+{
+  MPI_Aint size;
+  int disp_unit;
+  Particle::Bank* sites;
+  MPI_Win_shared_query(temp_sites_window, node_rank, &size, &disp_unit,
+    &sites);
+  return sites;
+}
+
+void sync_temp_sites()
+{
+  MPI_Win_fence(0, temp_sites_window);
+}
+#endif
+
+void bank_surface_source(const Particle& p)
+{
+  Particle::Bank site;
+  site.r = p.r();
+  site.u = p.u();
+  site.E = settings::run_CE ? p.E_ : static_cast<double>(p.g_);
+  site.wgt = p.wgt_;
+  site.delayed_group = p.delayed_group_;
+  site.particle = p.type_;
+  site.parent_id = p.id_;
+  site.progeny_id = p.n_progeny_;
+  surf_source_buffer.push_back(site);
+}
+
+void flush_surface_source()
+{
+  if (surf_source_buffer.empty()) return;
+  simulation::surf_source_bank.thread_safe_append(surf_source_buffer.data(),
+    surf_source_buffer.size());
+  surf_source_buffer.clear();
+}
+
+void bank_census_site(const Particle& p)
+{
+  Particle::Bank site;
+  site.r = p.r();
+  site.u = p.u();
+  site.E = settings::run_CE ? p.E_ : static_cast<double>(p.g_);
+  site.wgt = p.wgt_;
+  site.time = p.time_;
+  site.delayed_group = p.delayed_group_;
+  site.particle = p.type_;
+  site.parent_id = p.id_;
+  site.progeny_id = p.n_progeny_;
+  if (simulation::census_bank.thread_safe_append(site) == -1) {
+    #pragma omp atomic
+    ++simulation::n_census_discarded;
+  }
+}
+
+void bank_fission_site(const Particle::Bank& site)
+{
+  fission_site_buffer.push_back(site);
+}
+
+bool flush_fission_sites()
+{
+  if (fission_site_buffer.empty()) return true;
+  int64_t idx = simulation::fission_bank.thread_safe_append(
+    fission_site_buffer.data(), fission_site_buffer.size());
+  fission_site_buffer.clear();
+  return idx != -1;
 }
 
 void init_fission_bank(int64_t max)
@@ -53,25 +204,114 @@ void init_fission_bank(int64_t max)
 // "Reproducibility and Monte Carlo Eigenvalue Calculations," F.B. Brown and
 // T.M. Sutton, 1992 ANS Annual Meeting, Transactions of the American Nuclear
 // Society, Volume 65, Page 235.
+void sort_source_bank()
+{
+  auto& bank {simulation::source_bank};
+  int64_t n = simulation::work_per_rank;
+
+  // The curve spans the bounding box of the sites of all processes, which
+  // unlike that of the geometry is always finite. The key of a site therefore
+  // does not depend on how the sites are divided among the processes.
+  Position lo {INFTY, INFTY, INFTY};
+  Position hi {-INFTY, -INFTY, -INFTY};
+  for (int64_t i = 0; i < n; ++i) {
+    const auto& r {bank[i].r};
+    lo.x = std::min(lo.x, r.x);
+    lo.y = std::min(lo.y, r.y);
+    lo.z = std::min(lo.z, r.z);
+    hi.x = std::max(hi.x, r.x);
+    hi.y = std::max(hi.y, r.y);
+    hi.z = std::max(hi.z, r.z);
+  }
+#ifdef OPENMC_MPI
+  // The upper corner is negated so that both corners are reduced at once
+  double corners[] {lo.x, lo.y, lo.z, -hi.x, -hi.y, -hi.z};
+  MPI_Allreduce(MPI_IN_PLACE, corners, 6, MPI_DOUBLE, MPI_MIN, mpi::intracomm);
+  lo = {corners[0], corners[1], corners[2]};
+  hi = {-corners[3], -corners[4], -corners[5]};
+#endif
+  if (n < 2) return;
+
+  // Key each site by interleaving its coordinates quantized to 21 bits. Ties
+  // are broken by the index of the site so that the order is reproducible.
+  auto quantize = [](double x, double x_min, double x_max) -> uint64_t {
+    if (x_max <= x_min) return 0;
+    return static_cast<uint64_t>((x - x_min) / (x_max - x_min) * 0x1fffff);
+  };
+  std::vector<std::pair<uint64_t, int64_t>> keys(n);
+  #pragma omp parallel for
+  for (int64_t i = 0; i < n; ++i) {
+    const auto& r {bank[i].r};
+    uint64_t key = spread_bits(quantize(r.x, lo.x, hi.x)) |
+      spread_bits(quantize(r.y, lo.y, hi.y)) << 1 |
+      spread_bits(quantize(r.z, lo.z, hi.z)) << 2;
+    keys[i] = {key, i};
+  }
+  std::sort(keys.begin(), keys.end());
+
+  std::vector<Particle::Bank> sorted(n);
+  #pragma omp parallel for
+  for (int64_t i = 0; i < n; ++i) {
+    sorted[i] = bank[keys[i].second];
+  }
+  std::copy(sorted.begin(), sorted.end(), bank.begin());
+}
+
 void sort_fission_bank()
 {
+  // With domain decomposition, sites are banked by the process tracking their
+  // parent, which may have been started by another process, so the progeny
+  // counts of the local histories cannot be used
+  if (domain_decomposed()) {
+    auto& bank {simulation::fission_bank};
+    std::sort(bank.data(), bank.data() + bank.size(),
+      [](const Particle::Bank& a, const Particle::Bank& b) {
+        return a.parent_id < b.parent_id ||
+          (a.parent_id == b.parent_id && a.progeny_id < b.progeny_id);
+      });
+    return;
+  }
+
   // Ensure we don't read off the end of the array if we ran with 0 particles
   if (simulation::progeny_per_particle.size() == 0) {
     return;
   }
 
   // Perform exclusive scan summation to determine starting indices in fission
-  // bank for each parent particle id
-  int64_t tmp = simulation::progeny_per_particle[0];
-  simulation::progeny_per_particle[0] = 0;
-  for (int64_t i = 1; i < simulation::progeny_per_particle.size(); i++) {
-    int64_t value = simulation::progeny_per_particle[i-1] + tmp;
-    tmp = simulation::progeny_per_particle[i];
-    simulation::progeny_per_particle[i] = value;
+  // bank for each parent particle id. Each thread first sums a contiguous chunk
+  // of particles and then scans its chunk starting from the sum of all chunks
+  // before it.
+  auto& progeny {simulation::progeny_per_particle};
+  int64_t n = progeny.size();
+#ifdef _OPENMP
+  int n_chunks = omp_get_max_threads();
+#else
+  int n_chunks = 1;
+#endif
+  std::vector<int64_t> chunk_start(n_chunks + 1, 0);
+
+  #pragma omp parallel for
+  for (int c = 0; c < n_chunks; ++c) {
+    int64_t sum = 0;
+    for (int64_t i = n*c/n_chunks; i < n*(c + 1)/n_chunks; ++i) {
+      sum += progeny[i];
+    }
+    chunk_start[c + 1] = sum;
+  }
+
+  for (int c = 0; c < n_chunks; ++c) {
+    chunk_start[c + 1] += chunk_start[c];
   }
 
-  // TODO: C++17 introduces the exclusive_scan() function which could be
-  // used to replace everything above this point in this function.
+  #pragma omp parallel for
+  for (int c = 0; c < n_chunks; ++c) {
+    int64_t sum = chunk_start[c];
+    for (int64_t i = n*c/n_chunks; i < n*(c + 1)/n_chunks; ++i) {
+      int64_t value = progeny[i];
+      progeny[i] = sum;
+      sum += value;
+    }
+  }
 
   // We need a scratch vector to make permutation of the fission bank into
   // sorted order easy. Under normal usage conditions, the fission bank is
@@ -87,17 +327,22 @@ void sort_fission_bank()
     sorted_bank = &simulation::fission_bank[simulation::fission_bank.size()];
   }
 
-  // Use parent and progeny indices to sort fission bank
-  for (int64_t i = 0; i < simulation::fission_bank.size(); i++) {
+  // Use parent and progeny indices to sort fission bank. Every site has its own
+  // destination so the sites can be moved concurrently.
+  int64_t n_sites = simulation::fission_bank.size();
+  #pragma omp parallel for
+  for (int64_t i = 0; i < n_sites; i++) {
     const auto& site = simulation::fission_bank[i];
     int64_t offset = site.parent_id - 1 - simulation::work_index[mpi::rank];
-    int64_t idx = simulation::progeny_per_particle[offset] + site.progeny_id;
+    int64_t idx = progeny[offset] + site.progeny_id;
     sorted_bank[idx] = site;
   }
 
   // Copy sorted bank into the fission bank
-  std::copy(sorted_bank, sorted_bank + simulation::fission_bank.size(),
-      simulation::fission_bank.data());
+  #pragma omp parallel for
+  for (int64_t i = 0; i < n_sites; i++) {
+    simulation::fission_bank[i] = sorted_bank[i];
+  }
 }
 
 //==============================================================================
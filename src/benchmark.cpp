@@ -0,0 +1,255 @@
+//! \file benchmark.cpp
+//! Micro-benchmarks of the kernels that dominate particle transport
+//
+//! The model in the working directory (or the path given on the command line,
+//! as for the openmc executable) is loaded and particle states are sampled
+//! from its external source. Each kernel is then timed over these states,
+//! and the time per call and number of calls per second are reported.
+
+#ifdef OPENMC_MPI
+#include <mpi.h>
+#endif
+
+#include <algorithm> // for max
+#include <cmath>     // for log, isfinite
+#include <cstdint>
+#include <tuple>     // for tie
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "openmc/capi.h"
+#include "openmc/constants.h"
+#include "openmc/error.h"
+#include "openmc/geometry.h"
+#include "openmc/material.h"
+#include "openmc/mesh.h"
+#include "openmc/message_passing.h"
+#include "openmc/nuclide.h"
+#include "openmc/particle.h"
+#include "openmc/physics.h"
+#include "openmc/random_lcg.h"
+#include "openmc/settings.h"
+#include "openmc/simulation.h"
+#include "openmc/source.h"
+#include "openmc/timer.h"
+#include "openmc/wmp.h"
+
+namespace {
+
+using namespace openmc;
+
+constexpr int N_SITES {10000};   //!< number of sampled particle states
+constexpr double MIN_TIME {0.2}; //!< least time spent in each kernel in [s]
+constexpr int MAX_SWEEPS {1000}; //!< most sweeps over the states per kernel
+
+std::vector<Particle::Bank> sites; //!< source sites located in the geometry
+
+//! Keeps the results of kernels from being optimized away
+volatile double sink;
+
+//! Sample source sites that can be located in the geometry
+void sample_sites()
+{
+  Particle p;
+  for (int64_t i = 1; sites.size() < N_SITES && i <= 10*N_SITES; ++i) {
+    uint64_t seed = init_seed(i, STREAM_SOURCE);
+    auto site = sample_external_source(&seed);
+    if (site.particle != Particle::Type::neutron) continue;
+    p.from_source(&site);
+    if (find_cell(p, false)) sites.push_back(site);
+  }
+}
+
+//! Time a kernel over the sampled sites
+//
+//! The sites are swept over until enough time has been spent in the kernel.
+//! For each site, setup prepares the particle without being timed, and the
+//! kernel then returns the number of operations it did. The overhead of the
+//! timer itself, measured with an empty kernel, is subtracted.
+//! \param name Name of the kernel
+//! \param setup Function preparing the particle for a site, returning false
+//!   if the kernel does not apply to it
+//! \param kernel Function applying the kernel to the particle
+template<typename S, typename K>
+void benchmark(const char* name, S setup, K kernel)
+{
+  Particle p;
+  init_particle_seeds(1, p.seeds_);
+
+  auto sweep = [&](Timer& timer, bool empty) {
+    int64_t n = 0;
+    for (const auto& site : sites) {
+      if (!setup(p, site)) continue;
+      timer.start();
+      int64_t n_op = empty ? 1 : kernel(p);
+      timer.stop();
+      n += n_op;
+    }
+    return n;
+  };
+
+  Timer timer, overhead;
+  int64_t n_op = 0;
+  for (int i = 0; i < MAX_SWEEPS && timer.elapsed() < MIN_TIME; ++i) {
+    n_op += sweep(timer, false);
+    sweep(overhead, true);
+  }
+  if (n_op == 0) {
+    fmt::print(" {:<32} {:>12}\n", name, "not applicable");
+    return;
+  }
+
+  double t = std::max(timer.elapsed() - overhead.elapsed(), 0.0);
+  fmt::print(" {:<32} {:>12} {:>12.1f} {:>12.3f}\n", name, n_op,
+    1.0e9*t/n_op, (t > 0.0) ? 1.0e-6*n_op/t : INFTY);
+}
+
+//! Locate a particle at a site
+bool locate(Particle& p, const Particle::Bank& site)
+{
+  p.from_source(&site);
+  return find_cell(p, false);
+}
+
+//! Locate a particle at a site in a material
+bool locate_in_material(Particle& p, const Particle::Bank& site)
+{
+  return locate(p, site) && p.material_ != MATERIAL_VOID;
+}
+
+void run_benchmarks()
+{
+  fmt::print(" {:<32} {:>12} {:>12} {:>12}\n", "Kernel", "Operations",
+    "ns/op", "Mop/s");
+
+  benchmark("find_cell",
+    [](Particle& p, const Particle::Bank& site) {
+      p.from_source(&site);
+      return true;
+    },
+    [](Particle& p) {
+      sink = find_cell(p, false);
+      return 1;
+    });
+
+  benchmark("distance_to_boundary", locate,
+    [](Particle& p) {
+      sink = distance_to_boundary(p).distance;
+      return 1;
+    });
+
+  if (!settings::run_CE) return;
+
+  benchmark("Material::calculate_xs", locate_in_material,
+    [](Particle& p) {
+      model::materials[p.material_]->calculate_xs(p);
+      sink = p.macro_xs_.total;
+      return 1;
+    });
+
+  // Each operation is the lookup of one nuclide of the material, without the
+  // search on the material's unionized grid
+  benchmark("Nuclide::calculate_xs", locate_in_material,
+    [](Particle& p) {
+      const auto& mat {*model::materials[p.material_]};
+      p.neutron_xs_.set_material(mat.mat_nuclide_index_);
+      int neutron = static_cast<int>(Particle::Type::neutron);
+      int i_grid = std::log(p.E_/data::energy_min[neutron])
+        / simulation::log_spacing;
+      for (int i_nuclide : mat.nuclide_) {
+        data::nuclides[i_nuclide]->calculate_xs(C_NONE, i_grid, 0.0, p);
+        sink = p.neutron_xs_[i_nuclide].total;
+      }
+      return static_cast<int64_t>(mat.nuclide_.size());
+    });
+
+  benchmark("sample_nuclide",
+    [](Particle& p, const Particle::Bank& site) {
+      if (!locate_in_material(p, site)) return false;
+      model::materials[p.material_]->calculate_xs(p);
+      return p.macro_xs_.total > 0.0;
+    },
+    [](Particle& p) {
+      sink = sample_nuclide(p);
+      return 1;
+    });
+
+  // Every multipole nuclide is evaluated at the energies within its range
+  benchmark("WindowedMultipole::evaluate", locate_in_material,
+    [](Particle& p) {
+      int64_t n = 0;
+      for (const auto& nuc : data::nuclides) {
+        auto& wmp {nuc->multipole_};
+        if (!wmp || p.E_ < wmp->E_min_ || p.E_ > wmp->E_max_) continue;
+        double sig_s, sig_a, sig_f;
+        std::tie(sig_s, sig_a, sig_f) = wmp->evaluate(p.E_, p.sqrtkT_);
+        sink = sig_s + sig_a + sig_f;
+        ++n;
+      }
+      return n;
+    });
+
+  // Tracks run from each site to the nearest boundary
+  for (const auto& m : model::meshes) {
+    const auto* mesh = dynamic_cast<const RegularMesh*>(m.get());
+    if (!mesh) continue;
+    std::vector<int> bins;
+    std::vector<double> lengths;
+    benchmark(fmt::format("RegularMesh::bins_crossed {}", mesh->id_).c_str(),
+      [](Particle& p, const Particle::Bank& site) {
+        if (!locate(p, site)) return false;
+        double d = distance_to_boundary(p).distance;
+        if (!std::isfinite(d)) return false;
+        p.r() += d*p.u();
+        return true;
+      },
+      [&](Particle& p) {
+        bins.clear();
+        lengths.clear();
+        mesh->bins_crossed(p, bins, lengths);
+        sink = bins.size();
+        return 1;
+      });
+  }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  using namespace openmc;
+  int err;
+
+  // Initialize run -- when run with MPI, pass communicator
+#ifdef OPENMC_MPI
+  MPI_Comm world {MPI_COMM_WORLD};
+  err = openmc_init(argc, argv, &world);
+#else
+  err = openmc_init(argc, argv, nullptr);
+#endif
+  if (err == -1) {
+    // This happens for the -h and -v flags
+    return 0;
+  } else if (err) {
+    fatal_error(openmc_err_msg);
+  }
+
+  // Kernels are timed on the master process only
+  if (mpi::master) {
+    sample_sites();
+    if (sites.empty()) {
+      fatal_error("No source site could be located in the geometry.");
+    }
+    fmt::print(" Benchmarking kernels over {} source sites\n\n", sites.size());
+    run_benchmarks();
+  }
+
+  // Finalize and free up memory
+  err = openmc_finalize();
+  if (err) fatal_error(openmc_err_msg);
+
+  // If MPI is in use and enabled, terminate it
+#ifdef OPENMC_MPI
+  MPI_Finalize();
+#endif
+}
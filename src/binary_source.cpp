@@ -0,0 +1,186 @@
+#include "openmc/binary_source.h"
+
+#include <algorithm> // for copy
+#include <cstring>   // for memcmp, memcpy
+
+#include <fcntl.h>    // for open
+#include <sys/mman.h> // for mmap, munmap
+#include <sys/stat.h> // for fstat
+#include <unistd.h>   // for close, ftruncate, pwrite
+
+#include <fmt/core.h>
+
+#include "openmc/bank.h"
+#include "openmc/constants.h"
+#include "openmc/error.h"
+#include "openmc/message_passing.h"
+#include "openmc/particle.h"
+#include "openmc/simulation.h"
+
+namespace openmc {
+
+namespace {
+
+constexpr char MAGIC[8] {'O', 'M', 'C', 'S', 'R', 'C', '\0', '\0'};
+
+//! Write a whole buffer at an offset in a file, which pwrite may not do at once
+
+bool write_all(int fd, const char* buffer, size_t n, off_t offset)
+{
+  while (n > 0) {
+    ssize_t written = pwrite(fd, buffer, n, offset);
+    if (written < 0) return false;
+    buffer += written;
+    n -= written;
+    offset += written;
+  }
+  return true;
+}
+
+//! Read-only mapping of a binary source file whose header has been checked
+
+class MappedSource {
+public:
+  explicit MappedSource(const std::string& filename)
+  {
+    using Bank = Particle::Bank;
+
+    int fd = open(filename.c_str(), O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0) {
+      fatal_error(fmt::format("Could not open source file {}.", filename));
+    }
+    size_ = info.st_size;
+    if (size_ < sizeof(BinarySourceHeader)) {
+      fatal_error(fmt::format("Source file {} is truncated.", filename));
+    }
+
+    data_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data_ == MAP_FAILED) {
+      fatal_error(fmt::format("Could not map source file {}.", filename));
+    }
+
+    // Make sure the sites can be used as they are
+    std::memcpy(&header_, data_, sizeof(header_));
+    if (header_.version[0] != VERSION_BINARY_SOURCE[0]) {
+      fatal_error(fmt::format("Source file {} uses version {}.{} of the "
+        "binary source format whereas {}.{} is supported.", filename,
+        header_.version[0], header_.version[1], VERSION_BINARY_SOURCE[0],
+        VERSION_BINARY_SOURCE[1]));
+    }
+    if (header_.site_size != sizeof(Bank)) {
+      fatal_error(fmt::format("Source file {} was written with source sites "
+        "of {} bytes whereas they are {} bytes here.", filename,
+        header_.site_size, sizeof(Bank)));
+    }
+    if (size_ < sizeof(header_) + header_.n_sites*sizeof(Bank)) {
+      fatal_error(fmt::format("Source file {} is truncated.", filename));
+    }
+  }
+
+  ~MappedSource() { munmap(data_, size_); }
+
+  MappedSource(const MappedSource&) = delete;
+  MappedSource& operator=(const MappedSource&) = delete;
+
+  //! Number of sites in the file
+  int64_t n_sites() const { return header_.n_sites; }
+
+  //! First site in the file. The header keeps the sites suitably aligned.
+  const Particle::Bank* sites() const
+  {
+    return reinterpret_cast<const Particle::Bank*>(
+      static_cast<const char*>(data_) + sizeof(header_));
+  }
+
+private:
+  void* data_;
+  size_t size_;
+  BinarySourceHeader header_;
+};
+
+} // namespace
+
+//==============================================================================
+// Non-member functions
+//==============================================================================
+
+bool is_binary_source(const std::string& filename)
+{
+  char magic[sizeof(MAGIC)];
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+  bool match = read(fd, magic, sizeof(magic)) == sizeof(magic) &&
+    std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+  close(fd);
+  return match;
+}
+
+void write_binary_source(const std::string& filename)
+{
+  write_binary_source(filename, simulation::source_bank.data(),
+    simulation::work_index);
+}
+
+void write_binary_source(const std::string& filename,
+  const Particle::Bank* sites, const std::vector<int64_t>& bank_index)
+{
+  using Bank = Particle::Bank;
+  int64_t n_sites = bank_index[mpi::n_procs];
+
+  // The master process creates the file at its full size so that each process
+  // can then write its sites independently
+  if (mpi::master) {
+    BinarySourceHeader header {};
+    std::copy(MAGIC, MAGIC + sizeof(MAGIC), header.magic);
+    header.version[0] = VERSION_BINARY_SOURCE[0];
+    header.version[1] = VERSION_BINARY_SOURCE[1];
+    header.site_size = sizeof(Bank);
+    header.n_sites = n_sites;
+
+    int fd = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0 || !write_all(fd, reinterpret_cast<const char*>(&header),
+        sizeof(header), 0) ||
+        ftruncate(fd, sizeof(header) + n_sites*sizeof(Bank)) != 0) {
+      fatal_error(fmt::format("Could not create source file {}.", filename));
+    }
+    close(fd);
+  }
+#ifdef OPENMC_MPI
+  MPI_Barrier(mpi::intracomm);
+#endif
+
+  int fd = open(filename.c_str(), O_WRONLY);
+  off_t offset = sizeof(BinarySourceHeader) +
+    bank_index[mpi::rank]*sizeof(Bank);
+  int64_t n_local = bank_index[mpi::rank + 1] - bank_index[mpi::rank];
+  if (fd < 0 || !write_all(fd, reinterpret_cast<const char*>(sites),
+      n_local*sizeof(Bank), offset)) {
+    fatal_error(fmt::format("Could not write source file {}.", filename));
+  }
+  close(fd);
+}
+
+void read_binary_source(const std::string& filename)
+{
+  MappedSource source {filename};
+  if (simulation::work_index[mpi::n_procs] > source.n_sites()) {
+    fatal_error("Number of source sites in source file is less "
+                "than number of source particles per generation.");
+  }
+
+  // Copy the sites of this process into the source bank
+  std::memcpy(simulation::source_bank.data(),
+    source.sites() + simulation::work_index[mpi::rank],
+    simulation::work_per_rank*sizeof(Particle::Bank));
+}
+
+std::vector<Particle::Bank> read_binary_source_sites(
+  const std::string& filename)
+{
+  MappedSource source {filename};
+  return {source.sites(), source.sites() + source.n_sites()};
+}
+
+} // namespace openmc
@@ -91,11 +91,27 @@ void thick_target_bremsstrahlung(Particle& p, double* E_lost)
   }
 
   // Sample the energies of the emitted photons
+  const auto* alias = mat->alias.empty() ? nullptr : &mat->alias[i_e];
   for (int i = 0; i < n; ++i) {
-    // Generate a random number r and determine the index i for which
-    // cdf(i) <= r*cdf,max <= cdf(i+1)
-    double c = prn(p.current_seed())*c_max;
-    int i_w = lower_bound_index(&mat->cdf(i_e, 0), &mat->cdf(i_e, 0) + i_e, c);
+    double c;
+    int i_w;
+    if (alias && !alias->empty()) {
+      // Choose the photon energy bin i from the alias table and the value c
+      // of the CDF within it, so that cdf(i) <= c <= cdf(i+1). Values above
+      // the maximum of the CDF at the incident energy, which only occur in
+      // the last bin, are rejected.
+      do {
+        double residual;
+        i_w = alias->sample(prn(p.current_seed()), residual);
+        double c_l = mat->cdf(i_e, i_w);
+        c = c_l + residual*(mat->cdf(i_e, i_w + 1) - c_l);
+      } while (c > c_max);
+    } else {
+      // Generate a random number r and determine the index i for which
+      // cdf(i) <= r*cdf,max <= cdf(i+1)
+      c = prn(p.current_seed())*c_max;
+      i_w = lower_bound_index(&mat->cdf(i_e, 0), &mat->cdf(i_e, 0) + i_e, c);
+    }
 
     // Sample the photon energy
     double w_l = data::ttb_e_grid(i_w);
@@ -0,0 +1,402 @@
+#include "openmc/bvh.h"
+
+#include <algorithm> // for max, min, nth_element
+#include <array>
+#include <cmath>     // for nextafter
+#include <utility>   // for move
+
+#include "openmc/cell.h"
+#include "openmc/constants.h"
+
+namespace openmc {
+
+namespace {
+
+//! Get the lower and upper bounds of a box along an axis
+
+void box_bounds(const BoundingBox& b, int axis, double& lo, double& hi)
+{
+  switch (axis) {
+  case 0: lo = b.xmin; hi = b.xmax; break;
+  case 1: lo = b.ymin; hi = b.ymax; break;
+  default: lo = b.zmin; hi = b.zmax; break;
+  }
+}
+
+//! Get a representative coordinate of a box along an axis, ignoring infinite
+//! bounds
+
+double box_center(const BoundingBox& b, int axis)
+{
+  double lo, hi;
+  box_bounds(b, axis, lo, hi);
+  bool lo_finite = lo > -INFTY;
+  bool hi_finite = hi < INFTY;
+  if (lo_finite && hi_finite) return 0.5*(lo + hi);
+  if (lo_finite) return lo;
+  if (hi_finite) return hi;
+  return 0.0;
+}
+
+//! Check whether a box is infinite in every direction
+
+bool is_unbounded(const BoundingBox& b)
+{
+  for (int axis = 0; axis < 3; ++axis) {
+    double lo, hi;
+    box_bounds(b, axis, lo, hi);
+    if (lo > -INFTY || hi < INFTY) return false;
+  }
+  return true;
+}
+
+//! Round a coordinate to single precision without moving it inward
+
+float round_down(double x)
+{
+  float f = static_cast<float>(x);
+  return (f > x) ? std::nextafter(f, -INFINITY) : f;
+}
+
+float round_up(double x)
+{
+  float f = static_cast<float>(x);
+  return (f < x) ? std::nextafter(f, INFINITY) : f;
+}
+
+Direction cross(Direction a, Direction b)
+{
+  return {a.y*b.z - a.z*b.y, a.z*b.x - a.x*b.z, a.x*b.y - a.y*b.x};
+}
+
+//! Sum of the vertices of a triangle along an axis, proportional to its
+//! centroid
+
+double triangle_center(const TriangleBVH::Triangle& t, int axis)
+{
+  return t.v[0][axis] + t.v[1][axis] + t.v[2][axis];
+}
+
+} // namespace
+
+//==============================================================================
+// CellBVH implementation
+//==============================================================================
+
+constexpr int CellBVH::LEAF_SIZE;
+constexpr int CellBVH::MAX_DEPTH;
+
+CellBVH::CellBVH(const Universe& univ)
+{
+  // Separate cells that can be placed in the tree from those that cannot
+  std::vector<BoundingBox> boxes;
+  for (auto i_cell : univ.cells_) {
+    const auto& box = model::cells[i_cell]->bbox_;
+    if (is_unbounded(box)) {
+      unbounded_.push_back(i_cell);
+    } else {
+      cells_.push_back(i_cell);
+      boxes.push_back(box);
+    }
+  }
+
+  if (!cells_.empty()) build(boxes, 0, cells_.size());
+}
+
+int32_t CellBVH::build(std::vector<BoundingBox>& boxes, int32_t begin,
+  int32_t end)
+{
+  // Determine the box enclosing all cells in the range along with the spread
+  // of their centers along each axis
+  BoundingBox box = {INFTY, -INFTY, INFTY, -INFTY, INFTY, -INFTY};
+  std::array<double, 3> cmin {INFTY, INFTY, INFTY};
+  std::array<double, 3> cmax {-INFTY, -INFTY, -INFTY};
+  for (int32_t i = begin; i < end; ++i) {
+    box |= boxes[i];
+    for (int axis = 0; axis < 3; ++axis) {
+      double c = box_center(boxes[i], axis);
+      cmin[axis] = std::min(cmin[axis], c);
+      cmax[axis] = std::max(cmax[axis], c);
+    }
+  }
+
+  int32_t index = nodes_.size();
+  nodes_.push_back({box, begin, -(end - begin)});
+  if (end - begin <= LEAF_SIZE) return index;
+
+  // Split the range at the median center along the axis of largest spread
+  int axis = 0;
+  for (int i = 1; i < 3; ++i) {
+    if (cmax[i] - cmin[i] > cmax[axis] - cmin[axis]) axis = i;
+  }
+  if (cmax[axis] <= cmin[axis]) return index;
+
+  std::vector<int32_t> order;
+  for (int32_t i = begin; i < end; ++i) order.push_back(i);
+  auto middle = order.begin() + order.size() / 2;
+  std::nth_element(order.begin(), middle, order.end(),
+    [&](int32_t i, int32_t j) {
+      return box_center(boxes[i], axis) < box_center(boxes[j], axis);
+    });
+
+  // Reorder the cells and boxes in the range to match
+  std::vector<int32_t> cells;
+  std::vector<BoundingBox> sorted;
+  for (auto i : order) {
+    cells.push_back(cells_[i]);
+    sorted.push_back(boxes[i]);
+  }
+  std::copy(cells.begin(), cells.end(), cells_.begin() + begin);
+  std::copy(sorted.begin(), sorted.end(), boxes.begin() + begin);
+
+  int32_t mid = begin + (end - begin) / 2;
+  int32_t left = build(boxes, begin, mid);
+  int32_t right = build(boxes, mid, end);
+  nodes_[index].left = left;
+  nodes_[index].right = right;
+  return index;
+}
+
+int32_t CellBVH::find_cell(Position r, Direction u, int32_t on_surface,
+  SurfaceSenseCache* sense_cache) const
+{
+  if (!nodes_.empty()) {
+    std::array<int32_t, MAX_DEPTH + 1> stack;
+    int n = 0;
+    stack[n++] = 0;
+    while (n > 0) {
+      const auto& node {nodes_[stack[--n]]};
+      if (!node.box.contains(r)) continue;
+
+      if (node.right <= 0) {
+        // Check each cell of the leaf
+        for (int32_t i = node.left; i < node.left - node.right; ++i) {
+          const auto& c {*model::cells[cells_[i]]};
+          if (!c.bbox_.contains(r)) continue;
+          if (c.contains(r, u, on_surface, sense_cache)) return cells_[i];
+        }
+      } else {
+        stack[n++] = node.right;
+        stack[n++] = node.left;
+      }
+    }
+  }
+
+  for (auto i_cell : unbounded_) {
+    const auto& c {*model::cells[i_cell]};
+    if (c.contains(r, u, on_surface, sense_cache)) return i_cell;
+  }
+  return C_NONE;
+}
+
+//==============================================================================
+// TriangleBVH implementation
+//==============================================================================
+
+constexpr int TriangleBVH::LEAF_SIZE;
+constexpr int TriangleBVH::MAX_DEPTH;
+
+TriangleBVH::TriangleBVH(std::vector<Triangle> triangles)
+  : triangles_ {std::move(triangles)}
+{
+  if (!triangles_.empty()) build(0, triangles_.size());
+}
+
+int32_t TriangleBVH::build(int32_t begin, int32_t end)
+{
+  // Determine the box enclosing all triangles in the range along with the
+  // spread of their centers along each axis
+  std::array<double, 3> lower {INFTY, INFTY, INFTY};
+  std::array<double, 3> upper {-INFTY, -INFTY, -INFTY};
+  std::array<double, 3> cmin {INFTY, INFTY, INFTY};
+  std::array<double, 3> cmax {-INFTY, -INFTY, -INFTY};
+  for (int32_t i = begin; i < end; ++i) {
+    const auto& t {triangles_[i]};
+    for (int axis = 0; axis < 3; ++axis) {
+      for (const auto& v : t.v) {
+        lower[axis] = std::min(lower[axis], v[axis]);
+        upper[axis] = std::max(upper[axis], v[axis]);
+      }
+      double c = triangle_center(t, axis);
+      cmin[axis] = std::min(cmin[axis], c);
+      cmax[axis] = std::max(cmax[axis], c);
+    }
+  }
+
+  int32_t index = nodes_.size();
+  Node node;
+  for (int axis = 0; axis < 3; ++axis) {
+    node.lower[axis] = round_down(lower[axis]);
+    node.upper[axis] = round_up(upper[axis]);
+  }
+  node.left = begin;
+  node.right = -(end - begin);
+  nodes_.push_back(node);
+  if (end - begin <= LEAF_SIZE) return index;
+
+  // Split the range at the median center along the axis of largest spread
+  int axis = 0;
+  for (int i = 1; i < 3; ++i) {
+    if (cmax[i] - cmin[i] > cmax[axis] - cmin[axis]) axis = i;
+  }
+  if (cmax[axis] <= cmin[axis]) return index;
+
+  int32_t mid = begin + (end - begin) / 2;
+  std::nth_element(triangles_.begin() + begin, triangles_.begin() + mid,
+    triangles_.begin() + end, [axis](const Triangle& a, const Triangle& b) {
+      return triangle_center(a, axis) < triangle_center(b, axis);
+    });
+
+  int32_t left = build(begin, mid);
+  int32_t right = build(mid, end);
+  nodes_[index].left = left;
+  nodes_[index].right = right;
+  return index;
+}
+
+TriangleBVH::Hit TriangleBVH::intersect(Position r, Direction u,
+  int64_t exclude) const
+{
+  Hit hit;
+  if (nodes_.empty()) return hit;
+
+  // Inverse direction for the slab tests. Components along which the ray
+  // doesn't move get a huge finite value so that no product is undefined.
+  std::array<double, 3> inv_u;
+  for (int axis = 0; axis < 3; ++axis) {
+    inv_u[axis] = (u[axis] != 0.0) ? 1.0 / u[axis] : INFTY;
+  }
+
+  std::array<int32_t, MAX_DEPTH + 1> stack;
+  int n = 0;
+  stack[n++] = 0;
+  while (n > 0) {
+    const auto& node {nodes_[stack[--n]]};
+
+    // Skip nodes whose box the ray misses or only reaches beyond the
+    // nearest hit found so far
+    double t_min = 0.0;
+    double t_max = hit.distance;
+    for (int axis = 0; axis < 3; ++axis) {
+      double t0 = (node.lower[axis] - r[axis]) * inv_u[axis];
+      double t1 = (node.upper[axis] - r[axis]) * inv_u[axis];
+      if (t0 > t1) std::swap(t0, t1);
+      t_min = std::max(t_min, t0);
+      t_max = std::min(t_max, t1);
+    }
+    if (t_min > t_max) continue;
+
+    if (node.right > 0) {
+      stack[n++] = node.right;
+      stack[n++] = node.left;
+      continue;
+    }
+
+    // Intersect the ray with each triangle of the leaf
+    for (int32_t i = node.left; i < node.left - node.right; ++i) {
+      const auto& t {triangles_[i]};
+      if (t.id == exclude) continue;
+
+      Direction e1 = t.v[1] - t.v[0];
+      Direction e2 = t.v[2] - t.v[0];
+      Direction p = cross(u, e2);
+      double det = e1.dot(p);
+
+      // The determinant is minus the projection of the direction on the
+      // outward normal, so rays leaving the volume have a negative one
+      if (det == 0.0 || (det > 0.0 && !t.two_sided)) continue;
+      double inv_det = 1.0 / det;
+
+      Direction s = r - t.v[0];
+      double a = s.dot(p) * inv_det;
+      if (a < 0.0 || a > 1.0) continue;
+      Direction q = cross(s, e1);
+      double b = u.dot(q) * inv_det;
+      if (b < 0.0 || a + b > 1.0) continue;
+      double dist = e2.dot(q) * inv_det;
+      if (dist >= 0.0 && dist < hit.distance) {
+        hit.distance = dist;
+        hit.surface = t.surface;
+        hit.id = t.id;
+      }
+    }
+  }
+  return hit;
+}
+
+//==============================================================================
+// BoxBVH implementation
+//==============================================================================
+
+constexpr int BoxBVH::LEAF_SIZE;
+constexpr int BoxBVH::MAX_DEPTH;
+
+BoxBVH::BoxBVH(int32_t n, const std::function<BoundingBox(int32_t)>& box)
+{
+  if (n == 0) return;
+
+  // The centers of the items are only used to split ranges, so single
+  // precision is enough
+  std::vector<std::array<float, 3>> centers(n);
+  items_.resize(n);
+  for (int32_t i = 0; i < n; ++i) {
+    auto b = box(i);
+    for (int axis = 0; axis < 3; ++axis) {
+      centers[i][axis] = box_center(b, axis);
+    }
+    items_[i] = i;
+  }
+  build(box, centers, 0, n);
+}
+
+int32_t BoxBVH::build(const std::function<BoundingBox(int32_t)>& box,
+  const std::vector<std::array<float, 3>>& centers, int32_t begin,
+  int32_t end)
+{
+  // Determine the box enclosing all items in the range along with the spread
+  // of their centers along each axis
+  BoundingBox bounds = {INFTY, -INFTY, INFTY, -INFTY, INFTY, -INFTY};
+  std::array<float, 3> cmin {INFINITY, INFINITY, INFINITY};
+  std::array<float, 3> cmax {-INFINITY, -INFINITY, -INFINITY};
+  for (int32_t i = begin; i < end; ++i) {
+    bounds |= box(items_[i]);
+    for (int axis = 0; axis < 3; ++axis) {
+      cmin[axis] = std::min(cmin[axis], centers[items_[i]][axis]);
+      cmax[axis] = std::max(cmax[axis], centers[items_[i]][axis]);
+    }
+  }
+
+  int32_t index = nodes_.size();
+  Node node;
+  for (int axis = 0; axis < 3; ++axis) {
+    double lo, hi;
+    box_bounds(bounds, axis, lo, hi);
+    node.lower[axis] = round_down(lo);
+    node.upper[axis] = round_up(hi);
+  }
+  node.left = begin;
+  node.right = -(end - begin);
+  nodes_.push_back(node);
+  if (end - begin <= LEAF_SIZE) return index;
+
+  // Split the range at the median center along the axis of largest spread
+  int axis = 0;
+  for (int i = 1; i < 3; ++i) {
+    if (cmax[i] - cmin[i] > cmax[axis] - cmin[axis]) axis = i;
+  }
+  if (cmax[axis] <= cmin[axis]) return index;
+
+  int32_t mid = begin + (end - begin) / 2;
+  std::nth_element(items_.begin() + begin, items_.begin() + mid,
+    items_.begin() + end, [&](int32_t i, int32_t j) {
+      return centers[i][axis] < centers[j][axis];
+    });
+
+  int32_t left = build(box, centers, begin, mid);
+  int32_t right = build(box, centers, mid, end);
+  nodes_[index].left = left;
+  nodes_[index].right = right;
+  return index;
+}
+
+} // namespace openmc
@@ -2,12 +2,16 @@
 #include "openmc/cell.h"
 
 #include <algorithm>
+#include <array>
 #include <cctype>
 #include <cmath>
+#include <exception> // for exception_ptr
+#include <functional> // for function
 #include <iterator>
 #include <sstream>
 #include <set>
 #include <string>
+#include <utility> // for move
 
 #include <fmt/core.h>
 #include <gsl/gsl>
@@ -23,6 +27,7 @@
 #include "openmc/nuclide.h"
 #include "openmc/settings.h"
 #include "openmc/surface.h"
+#include "openmc/thermal.h"
 #include "openmc/xml_interface.h"
 
 namespace openmc {
@@ -264,6 +269,52 @@ Cell::set_temperature(double T, int32_t instance)
       T_ = std::sqrt(K_BOLTZMANN * T);
     }
   }
+
+  this->update_nuclide_temperature(instance);
+}
+
+void
+Cell::update_nuclide_temperature(int32_t instance)
+{
+  if (!settings::temperature_cache || !settings::run_CE ||
+      type_ != Fill::MATERIAL || data::nuclides.empty()) return;
+
+  // Update every instance if the number of distinct instances changed
+  int n = std::max(material_.size(), sqrtkT_.size());
+  if (nuclide_temperature_.size() != n) {
+    nuclide_temperature_.resize(n);
+    instance = -1;
+  }
+
+  int first = (instance >= 0 && n > 1) ? instance : 0;
+  int last = (instance >= 0 && n > 1) ? instance + 1 : n;
+  for (int i = first; i < last; ++i) {
+    int32_t i_material = material_.size() > 1 ? material_[i] : material_[0];
+    double sqrtkT = sqrtkT_.size() > 1 ? sqrtkT_[i] : sqrtkT_[0];
+
+    auto& temps {nuclide_temperature_[i]};
+    temps.clear();
+    if (i_material == MATERIAL_VOID) continue;
+    const auto& mat {*model::materials[i_material]};
+    for (int i_nuc : mat.nuclide_) {
+      temps.push_back(data::nuclides[i_nuc]->temperature_index(sqrtkT));
+    }
+    for (const auto& sab : mat.thermal_tables_) {
+      temps.push_back(
+        data::thermal_scatt[sab.index_table]->temperature_index(sqrtkT));
+    }
+  }
+}
+
+const NuclideTemperature*
+Cell::nuclide_temperature(int32_t instance, int32_t i_material) const
+{
+  if (nuclide_temperature_.empty()) return nullptr;
+
+  int i = nuclide_temperature_.size() > 1 ? instance : 0;
+  int32_t i_mat = material_.size() > 1 ? material_[i] : material_[0];
+  if (i_mat != i_material || nuclide_temperature_[i].empty()) return nullptr;
+  return nuclide_temperature_[i].data();
 }
 
 //==============================================================================
@@ -408,6 +459,13 @@ CSGCell::CSGCell(pugi::xml_node cell_node)
   }
   rpn_.shrink_to_fit();
 
+  // Store the surfaces of the region contiguously for fast evaluation.
+  for (int32_t token : rpn_) {
+    if (token < OP_UNION) surfaces_.emplace_back(std::abs(token) - 1);
+  }
+  surfaces_.shrink_to_fit();
+  if (!simple_) compile_region();
+
   // Read the translation vector.
   if (check_for_node(cell_node, "translation")) {
     if (fill_ == C_NONE) {
@@ -464,17 +522,27 @@ CSGCell::CSGCell(pugi::xml_node cell_node)
       std::copy(rot.begin(), rot.end(), std::back_inserter(rotation_));
     }
   }
+
+  // Check whether the contents are traversed with delta tracking.
+  if (check_for_node(cell_node, "delta_tracking")) {
+    delta_tracking_ = get_node_value_bool(cell_node, "delta_tracking");
+    if (delta_tracking_ && fill_ == C_NONE) {
+      fatal_error(fmt::format("Cannot use delta tracking in cell {}"
+        " because it is not filled with another universe", id_));
+    }
+  }
 }
 
 //==============================================================================
 
 bool
-CSGCell::contains(Position r, Direction u, int32_t on_surface) const
+CSGCell::contains(Position r, Direction u, int32_t on_surface,
+  SurfaceSenseCache* sense_cache) const
 {
   if (simple_) {
-    return contains_simple(r, u, on_surface);
+    return contains_simple(r, u, on_surface, sense_cache);
   } else {
-    return contains_complex(r, u, on_surface);
+    return contains_complex(r, u, on_surface, sense_cache);
   }
 }
 
@@ -486,14 +554,14 @@ CSGCell::distance(Position r, Direction u, int32_t on_surface, Particle* p) cons
   double min_dist {INFTY};
   int32_t i_surf {std::numeric_limits<int32_t>::max()};
 
+  int j = 0;
   for (int32_t token : rpn_) {
     // Ignore this token if it corresponds to an operator rather than a region.
     if (token >= OP_UNION) continue;
 
     // Calculate the distance to this surface.
-    // Note the off-by-one indexing
     bool coincident {std::abs(token) == std::abs(on_surface)};
-    double d {model::surfaces[abs(token)-1]->distance(r, u, coincident)};
+    double d {surfaces_[j++].distance(r, u, coincident)};
 
     // Check if this distance is the new minimum.
     if (d < min_dist) {
@@ -507,6 +575,34 @@ CSGCell::distance(Position r, Direction u, int32_t on_surface, Particle* p) cons
   return {min_dist, i_surf};
 }
 
+void
+CSGCell::distance(const RayBatch& rays, double* min_dist, int32_t* i_surf) const
+{
+  for (int k = 0; k < rays.n; ++k) {
+    min_dist[k] = INFTY;
+    i_surf[k] = std::numeric_limits<int32_t>::max();
+  }
+
+  double d[RayBatch::SIZE];
+  int j = 0;
+  for (int32_t token : rpn_) {
+    // Ignore this token if it corresponds to an operator rather than a region.
+    if (token >= OP_UNION) continue;
+
+    // Calculate the distance to this surface for all rays and check if each
+    // distance is the new minimum.
+    surfaces_[j++].distance(rays, d);
+    #pragma omp simd
+    for (int k = 0; k < rays.n; ++k) {
+      if (d[k] < min_dist[k] &&
+          std::abs(d[k] - min_dist[k]) / min_dist[k] >= FP_PRECISION) {
+        min_dist[k] = d[k];
+        i_surf[k] = -token;
+      }
+    }
+  }
+}
+
 //==============================================================================
 
 void
@@ -687,20 +783,102 @@ BoundingBox CSGCell::bounding_box() const {
 
 //==============================================================================
 
+namespace {
+
+//! Evaluate the sense of a surface, using and updating a cache if given
+
+bool surface_sense(const CompactSurface& surf, Position r, Direction u,
+  SurfaceSenseCache* sense_cache)
+{
+  bool sense;
+  if (sense_cache && sense_cache->get(surf.index, sense)) return sense;
+  sense = surf.sense(r, u);
+  if (sense_cache) sense_cache->set(surf.index, sense);
+  return sense;
+}
+
+//! Relative cost of evaluating the sense of a surface
+double sense_cost(const CompactSurface& surf)
+{
+  using Kind = CompactSurface::Kind;
+  switch (surf.kind) {
+  case Kind::X_PLANE:
+  case Kind::Y_PLANE:
+  case Kind::Z_PLANE:
+    return 1.0;
+  case Kind::PLANE:
+    return 2.0;
+  case Kind::OTHER:
+    return 8.0;
+  default:
+    return 3.0;
+  }
+}
+
+//! Expression tree of a region used to compile it
+struct RegionExpr {
+  int32_t token;  //!< operator or signed surface token
+  int32_t surf;   //!< index of the surface of a half-space
+  double cost {0.0}; //!< cost of evaluating the expression in full
+  std::vector<RegionExpr> operands;
+};
+
+//! Complement an expression with De Morgan's laws
+void complement(RegionExpr& expr)
+{
+  if (expr.token < OP_UNION) {
+    expr.token = -expr.token;
+  } else {
+    expr.token = (expr.token == OP_UNION) ? OP_INTERSECTION : OP_UNION;
+    for (auto& operand : expr.operands) complement(operand);
+  }
+}
+
+//! Add an operand to an operator, merging operators of the same kind
+void add_operand(RegionExpr& expr, RegionExpr&& operand)
+{
+  if (operand.token == expr.token) {
+    for (auto& x : operand.operands) expr.operands.push_back(std::move(x));
+  } else {
+    expr.operands.push_back(std::move(operand));
+  }
+}
+
+//! Order the operands of each operator from the cheapest and find the cost of
+//! the expression
+void order_operands(RegionExpr& expr,
+  const std::vector<CompactSurface>& surfaces)
+{
+  if (expr.token < OP_UNION) {
+    expr.cost = sense_cost(surfaces[expr.surf]);
+    return;
+  }
+  expr.cost = 0.0;
+  for (auto& operand : expr.operands) {
+    order_operands(operand, surfaces);
+    expr.cost += operand.cost;
+  }
+  std::stable_sort(expr.operands.begin(), expr.operands.end(),
+    [](const RegionExpr& a, const RegionExpr& b) { return a.cost < b.cost; });
+}
+
+} // namespace
+
 bool
-CSGCell::contains_simple(Position r, Direction u, int32_t on_surface) const
+CSGCell::contains_simple(Position r, Direction u, int32_t on_surface,
+  SurfaceSenseCache* sense_cache) const
 {
-  for (int32_t token : rpn_) {
+  for (int i = 0; i < rpn_.size(); ++i) {
     // Assume that no tokens are operators. Evaluate the sense of particle with
     // respect to the surface and see if the token matches the sense. If the
     // particle's surface attribute is set and matches the token, that
     // overrides the determination based on sense().
+    int32_t token = rpn_[i];
     if (token == on_surface) {
     } else if (-token == on_surface) {
       return false;
     } else {
-      // Note the off-by-one indexing
-      bool sense = model::surfaces[abs(token)-1]->sense(r, u);
+      bool sense = surface_sense(surfaces_[i], r, u, sense_cache);
       if (sense != (token > 0)) {return false;}
     }
   }
@@ -710,52 +888,77 @@ CSGCell::contains_simple(Position r, Direction u, int32_t on_surface) const
 //==============================================================================
 
 bool
-CSGCell::contains_complex(Position r, Direction u, int32_t on_surface) const
+CSGCell::contains_complex(Position r, Direction u, int32_t on_surface,
+  SurfaceSenseCache* sense_cache) const
 {
-  // Make a stack of booleans.  We don't know how big it needs to be, but we do
-  // know that rpn.size() is an upper-bound.
-  std::vector<bool> stack(rpn_.size());
-  int i_stack = -1;
+  // A cell without a region specification contains everything
+  if (region_tree_.empty()) return true;
+  return evaluate_region(0, r, u, on_surface, sense_cache);
+}
 
+bool
+CSGCell::evaluate_region(int32_t i, Position r, Direction u,
+  int32_t on_surface, SurfaceSenseCache* sense_cache) const
+{
+  const auto& node {region_tree_[i]};
+  if (node.token < OP_UNION) {
+    // Evaluate the sense of particle with respect to the surface and see if
+    // the token matches the sense. If the particle's surface attribute is set
+    // and matches the token, that overrides the determination based on
+    // sense().
+    if (node.token == on_surface) return true;
+    if (-node.token == on_surface) return false;
+    bool sense = surface_sense(surfaces_[node.surf], r, u, sense_cache);
+    return sense == (node.token > 0);
+  }
+
+  // A union is decided by its first true operand and an intersection by its
+  // first false one
+  bool decisive = (node.token == OP_UNION);
+  int32_t end = i + node.size;
+  for (int32_t j = i + 1; j < end; j += region_tree_[j].size) {
+    if (evaluate_region(j, r, u, on_surface, sense_cache) == decisive) {
+      return decisive;
+    }
+  }
+  return !decisive;
+}
+
+void
+CSGCell::compile_region()
+{
+  // Build the expression tree from the RPN
+  std::vector<RegionExpr> stack;
+  int32_t j_surf = 0;
   for (int32_t token : rpn_) {
-    // If the token is a binary operator (intersection/union), apply it to
-    // the last two items on the stack. If the token is a unary operator
-    // (complement), apply it to the last item on the stack.
-    if (token == OP_UNION) {
-      stack[i_stack-1] = stack[i_stack-1] || stack[i_stack];
-      i_stack --;
-    } else if (token == OP_INTERSECTION) {
-      stack[i_stack-1] = stack[i_stack-1] && stack[i_stack];
-      i_stack --;
+    if (token == OP_UNION || token == OP_INTERSECTION) {
+      RegionExpr expr {token, C_NONE};
+      RegionExpr right {std::move(stack.back())};
+      stack.pop_back();
+      add_operand(expr, std::move(stack.back()));
+      add_operand(expr, std::move(right));
+      stack.back() = std::move(expr);
     } else if (token == OP_COMPLEMENT) {
-      stack[i_stack] = !stack[i_stack];
+      complement(stack.back());
     } else {
-      // If the token is not an operator, evaluate the sense of particle with
-      // respect to the surface and see if the token matches the sense. If the
-      // particle's surface attribute is set and matches the token, that
-      // overrides the determination based on sense().
-      i_stack ++;
-      if (token == on_surface) {
-        stack[i_stack] = true;
-      } else if (-token == on_surface) {
-        stack[i_stack] = false;
-      } else {
-        // Note the off-by-one indexing
-        bool sense = model::surfaces[abs(token)-1]->sense(r, u);
-        stack[i_stack] = (sense == (token > 0));
-      }
+      stack.push_back({token, j_surf++});
     }
   }
-
-  if (i_stack == 0) {
-    // The one remaining bool on the stack indicates whether the particle is
-    // in the cell.
-    return stack[i_stack];
-  } else {
-    // This case occurs if there is no region specification since i_stack will
-    // still be -1.
-    return true;
-  }
+  region_tree_.clear();
+  if (stack.empty()) return;
+  Ensures(stack.size() == 1);
+  order_operands(stack.back(), surfaces_);
+
+  // Flatten the tree in prefix order, recording the size of each subtree
+  std::function<void(const RegionExpr&)> flatten = [&](const RegionExpr& expr)
+  {
+    int32_t i = region_tree_.size();
+    region_tree_.push_back({expr.token, expr.surf, 1});
+    for (const auto& operand : expr.operands) flatten(operand);
+    region_tree_[i].size = region_tree_.size() - i;
+  };
+  flatten(stack.back());
+  region_tree_.shrink_to_fit();
 }
 
 //==============================================================================
@@ -772,9 +975,18 @@ DAGCell::distance(Position r, Direction u, int32_t on_surface, Particle* p) cons
   // reset the history and update last direction
   if (u != p->last_dir_ || on_surface == 0) {
     p->history_.reset();
+    p->last_triangle_ = -1;
     p->last_dir_ = u;
   }
 
+  // the triangle the particle last crossed plays the part of the history
+  if (bvh_) {
+    auto hit = bvh_->intersect(r, u, p->last_triangle_);
+    if (hit.surface == -1) return {INFINITY, -1};
+    p->last_triangle_ = hit.id;
+    return {hit.distance, hit.surface};
+  }
+
   moab::ErrorCode rval;
   moab::EntityHandle vol = dagmc_ptr_->entity_by_index(3, dag_index_);
   moab::EntityHandle hit_surf;
@@ -795,7 +1007,8 @@ DAGCell::distance(Position r, Direction u, int32_t on_surface, Particle* p) cons
   return {dist, surf_idx};
 }
 
-bool DAGCell::contains(Position r, Direction u, int32_t on_surface) const
+bool DAGCell::contains(Position r, Direction u, int32_t on_surface,
+  SurfaceSenseCache* sense_cache) const
 {
   moab::ErrorCode rval;
   moab::EntityHandle vol = dagmc_ptr_->entity_by_index(3, dag_index_);
@@ -814,6 +1027,11 @@ BoundingBox DAGCell::bounding_box() const
 {
   moab::ErrorCode rval;
   moab::EntityHandle vol = dagmc_ptr_->entity_by_index(3, dag_index_);
+
+  // the implicit complement extends to infinity outside the other volumes,
+  // which also leaves its costly containment test for last in cell searches
+  if (dagmc_ptr_->is_implicit_complement(vol)) return {};
+
   double min[3], max[3];
   rval = dagmc_ptr_->getobb(vol, min, max);
   MB_CHK_ERR_CONT(rval);
@@ -826,104 +1044,204 @@ BoundingBox DAGCell::bounding_box() const
 // UniversePartitioner implementation
 //==============================================================================
 
-UniversePartitioner::UniversePartitioner(const Universe& univ)
-{
-  // Define an ordered set of surface indices that point to z-planes.  Use a
-  // functor to to order the set by the z0_ values of the corresponding planes.
-  struct compare_surfs {
-    bool operator()(const int32_t& i_surf, const int32_t& j_surf) const
-    {
-      const auto* surf = model::surfaces[i_surf].get();
-      const auto* zplane = dynamic_cast<const SurfaceZPlane*>(surf);
-      double zi = zplane->z0_;
-      surf = model::surfaces[j_surf].get();
-      zplane = dynamic_cast<const SurfaceZPlane*>(surf);
-      double zj = zplane->z0_;
-      return zi < zj;
-    }
-  };
-  std::set<int32_t, compare_surfs> surf_set;
+namespace {
 
-  // Find all of the z-planes in this universe.  A set is used here for the
-  // O(log(n)) insertions that will ensure entries are not repeated.
-  for (auto i_cell : univ.cells_) {
-    for (auto token : model::cells[i_cell]->rpn_) {
-      if (token < OP_UNION) {
-        auto i_surf = std::abs(token) - 1;
-        const auto* surf = model::surfaces[i_surf].get();
-        if (const auto* zplane = dynamic_cast<const SurfaceZPlane*>(surf))
-          surf_set.insert(i_surf);
+//! Kinds of surface families that can be used to partition a universe
+enum class FamilyKind {
+  PLANE, X_CYLINDER, Y_CYLINDER, Z_CYLINDER, SPHERE
+};
+
+//! A surface belonging to a family, along with its position in the family
+struct FamilyMember {
+  double key;     //!< position along the family coordinate
+  int32_t i_surf; //!< index in model::surfaces
+  bool flipped;   //!< whether the sense is reversed relative to the key
+};
+
+//! A set of surfaces whose senses change monotonically along one coordinate
+struct SurfaceFamily {
+  FamilyKind kind;
+  std::array<double, 3> param; //!< plane normal or cylinder/sphere center
+  std::vector<FamilyMember> members;
+};
+
+//! Determine the family a surface belongs to, if any
+
+bool classify_surface(const Surface& surf, FamilyKind& kind,
+  std::array<double, 3>& param, FamilyMember& member)
+{
+  member.flipped = false;
+  if (const auto* s = dynamic_cast<const SurfaceXPlane*>(&surf)) {
+    kind = FamilyKind::PLANE;
+    param = {1.0, 0.0, 0.0};
+    member.key = s->x0_;
+  } else if (const auto* s = dynamic_cast<const SurfaceYPlane*>(&surf)) {
+    kind = FamilyKind::PLANE;
+    param = {0.0, 1.0, 0.0};
+    member.key = s->y0_;
+  } else if (const auto* s = dynamic_cast<const SurfaceZPlane*>(&surf)) {
+    kind = FamilyKind::PLANE;
+    param = {0.0, 0.0, 1.0};
+    member.key = s->z0_;
+  } else if (const auto* s = dynamic_cast<const SurfacePlane*>(&surf)) {
+    // Normalize the plane so that parallel planes share the same normal. The
+    // normal is chosen so that its first nonzero component is positive;
+    // planes that had to be reversed have their senses flipped.
+    double norm = std::sqrt(s->A_*s->A_ + s->B_*s->B_ + s->C_*s->C_);
+    if (norm == 0.0) return false;
+    param = {s->A_ / norm, s->B_ / norm, s->C_ / norm};
+    member.key = s->D_ / norm;
+    for (auto c : param) {
+      if (std::abs(c) > FP_PRECISION) {
+        member.flipped = c < 0.0;
+        break;
       }
     }
+    if (member.flipped) {
+      for (auto& c : param) c = -c;
+      member.key = -member.key;
+    }
+    kind = FamilyKind::PLANE;
+  } else if (const auto* s = dynamic_cast<const SurfaceXCylinder*>(&surf)) {
+    kind = FamilyKind::X_CYLINDER;
+    param = {0.0, s->y0_, s->z0_};
+    member.key = s->radius_;
+  } else if (const auto* s = dynamic_cast<const SurfaceYCylinder*>(&surf)) {
+    kind = FamilyKind::Y_CYLINDER;
+    param = {s->x0_, 0.0, s->z0_};
+    member.key = s->radius_;
+  } else if (const auto* s = dynamic_cast<const SurfaceZCylinder*>(&surf)) {
+    kind = FamilyKind::Z_CYLINDER;
+    param = {s->x0_, s->y0_, 0.0};
+    member.key = s->radius_;
+  } else if (const auto* s = dynamic_cast<const SurfaceSphere*>(&surf)) {
+    kind = FamilyKind::SPHERE;
+    param = {s->x0_, s->y0_, s->z0_};
+    member.key = s->radius_;
+  } else {
+    return false;
   }
+  return true;
+}
 
-  // Populate the surfs_ vector from the ordered set.
-  surfs_.insert(surfs_.begin(), surf_set.begin(), surf_set.end());
+//! Assign the cells of a universe to the partitions defined by a family
+//
+//! \param univ Universe being partitioned
+//! \param family Family of surfaces, sorted by key
+//! \return Indices of the cells that lie within each partition
+
+std::vector<std::vector<int32_t>> partition_cells(const Universe& univ,
+  const SurfaceFamily& family)
+{
+  // Map from surface index to its position within the family
+  std::unordered_map<int32_t, int> position;
+  for (int i = 0; i < family.members.size(); ++i) {
+    position[family.members[i].i_surf] = i;
+  }
 
-  // Populate the partition lists.
-  partitions_.resize(surfs_.size() + 1);
+  int n = family.members.size();
+  std::vector<std::vector<int32_t>> partitions(n + 1);
   for (auto i_cell : univ.cells_) {
     // It is difficult to determine the bounds of a complex cell, so add complex
     // cells to all partitions.
-    if (!model::cells[i_cell]->simple_) {
-      for (auto& p : partitions_) p.push_back(i_cell);
-      continue;
-    }
-
-    // Find the tokens for bounding z-planes.
-    int32_t lower_token = 0, upper_token = 0;
-    double min_z, max_z;
-    for (auto token : model::cells[i_cell]->rpn_) {
-      if (token < OP_UNION) {
-        const auto* surf = model::surfaces[std::abs(token) - 1].get();
-        if (const auto* zplane = dynamic_cast<const SurfaceZPlane*>(surf)) {
-          if (lower_token == 0 || zplane->z0_ < min_z) {
-            lower_token = token;
-            min_z = zplane->z0_;
-          }
-          if (upper_token == 0 || zplane->z0_ > max_z) {
-            upper_token = token;
-            max_z = zplane->z0_;
-          }
+    const auto& c {*model::cells[i_cell]};
+    int first_partition = 0;
+    int last_partition = n;
+    if (c.simple_) {
+      // Each positive halfspace of a family surface bounds the cell from below
+      // and each negative halfspace bounds it from above.
+      for (auto token : c.rpn_) {
+        if (token >= OP_UNION) continue;
+        auto it = position.find(std::abs(token) - 1);
+        if (it == position.end()) continue;
+        int i = it->second;
+        if ((token > 0) != family.members[i].flipped) {
+          first_partition = std::max(first_partition, i + 1);
+        } else {
+          last_partition = std::min(last_partition, i);
         }
       }
+
+      // Bounds that contradict one another indicate an empty cell. Add it to
+      // all partitions rather than risk losing it.
+      if (first_partition > last_partition) {
+        first_partition = 0;
+        last_partition = n;
+      }
     }
 
-    // If there are no bounding z-planes, add this cell to all partitions.
-    if (lower_token == 0) {
-      for (auto& p : partitions_) p.push_back(i_cell);
-      continue;
+    // Add the cell to all relevant partitions.
+    for (int i = first_partition; i <= last_partition; ++i) {
+      partitions[i].push_back(i_cell);
     }
+  }
+  return partitions;
+}
 
-    // Find the first partition this cell lies in.  If the lower_token indicates
-    // a negative halfspace, then the cell is unbounded in the lower direction
-    // and it lies in the first partition onward.  Otherwise, it is bounded by
-    // the positive halfspace given by the lower_token.
-    int first_partition = 0;
-    if (lower_token > 0) {
-      for (int i = 0; i < surfs_.size(); ++i) {
-        if (lower_token == surfs_[i] + 1) {
-          first_partition = i + 1;
-          break;
-        }
-      }
+} // namespace
+
+constexpr int UniversePartitioner::MIN_SURFACES;
+
+UniversePartitioner::UniversePartitioner(const Universe& univ)
+{
+  // Group the surfaces in this universe into families. A set is used to visit
+  // each surface only once.
+  std::set<int32_t> surf_set;
+  for (auto i_cell : univ.cells_) {
+    for (auto token : model::cells[i_cell]->rpn_) {
+      if (token < OP_UNION) surf_set.insert(std::abs(token) - 1);
     }
+  }
 
-    // Find the last partition this cell lies in.  The logic is analogous to the
-    // logic for first_partition.
-    int last_partition = surfs_.size();
-    if (upper_token < 0) {
-      for (int i = first_partition; i < surfs_.size(); ++i) {
-        if (upper_token == -(surfs_[i] + 1)) {
-          last_partition = i;
-          break;
+  std::vector<SurfaceFamily> families;
+  for (auto i_surf : surf_set) {
+    FamilyKind kind;
+    std::array<double, 3> param;
+    FamilyMember member;
+    if (!classify_surface(*model::surfaces[i_surf], kind, param, member))
+      continue;
+    member.i_surf = i_surf;
+
+    // Find the family this surface belongs to, creating one if needed
+    auto it = std::find_if(families.begin(), families.end(),
+      [&](const SurfaceFamily& f) {
+        if (f.kind != kind) return false;
+        for (int i = 0; i < 3; ++i) {
+          if (std::abs(f.param[i] - param[i]) > FP_COINCIDENT) return false;
         }
-      }
+        return true;
+      });
+    if (it == families.end()) {
+      families.push_back({kind, param, {}});
+      it = families.end() - 1;
     }
+    it->members.push_back(member);
+  }
 
-    // Add the cell to all relevant partitions.
-    for (int i = first_partition; i <= last_partition; ++i) {
-      partitions_[i].push_back(i_cell);
+  // Choose the family that gives the fewest cells per partition on average.
+  // Partitioning is only worthwhile if it beats searching all cells.
+  double best_cost = univ.cells_.size();
+  for (auto& family : families) {
+    if (static_cast<int>(family.members.size()) < MIN_SURFACES) continue;
+
+    std::sort(family.members.begin(), family.members.end(),
+      [](const FamilyMember& a, const FamilyMember& b) {
+        return a.key < b.key;
+      });
+    auto partitions = partition_cells(univ, family);
+
+    double cost = 0.0;
+    for (const auto& p : partitions) cost += p.size();
+    cost /= partitions.size();
+    if (cost < best_cost) {
+      best_cost = cost;
+      surfs_.clear();
+      flipped_.clear();
+      for (const auto& m : family.members) {
+        surfs_.push_back(m.i_surf);
+        flipped_.push_back(m.flipped);
+      }
+      partitions_ = std::move(partitions);
     }
   }
 }
@@ -932,13 +1250,15 @@ const std::vector<int32_t>&
 UniversePartitioner::get_cells(Position r, Direction u) const
 {
   // Perform a binary search for the partition containing the given coordinates.
+  // The "positive halfspace" below refers to the side of increasing key, which
+  // is the negative halfspace for flipped surfaces.
   int left = 0;
   int middle = (surfs_.size() - 1) / 2;
   int right = surfs_.size() - 1;
   while (true) {
     // Check the sense of the coordinates for the current surface.
     const auto& surf = *model::surfaces[surfs_[middle]];
-    if (surf.sense(r, u)) {
+    if (surf.sense(r, u) != flipped_[middle]) {
       // The coordinates lie in the positive halfspace.  Recurse if there are
       // more surfaces to check.  Otherwise, return the cells on the positive
       // side of this surface.
@@ -971,18 +1291,34 @@ UniversePartitioner::get_cells(Position r, Direction u) const
 
 void read_cells(pugi::xml_node node)
 {
-  // Count the number of cells.
-  int n_cells = 0;
-  for (pugi::xml_node cell_node: node.children("cell")) {n_cells++;}
+  // Collect the cell elements.
+  std::vector<pugi::xml_node> cell_nodes;
+  for (pugi::xml_node cell_node: node.children("cell")) {
+    cell_nodes.push_back(cell_node);
+  }
+  int n_cells = cell_nodes.size();
   if (n_cells == 0) {
     fatal_error("No cells found in geometry.xml!");
   }
 
-  // Loop over XML cell elements and populate the array.
-  model::cells.reserve(n_cells);
-  for (pugi::xml_node cell_node : node.children("cell")) {
-    model::cells.push_back(std::make_unique<CSGCell>(cell_node));
+  // Construct the cells in parallel since they only read the XML document
+  // and the surface map. The error of the first invalid cell is rethrown.
+  model::cells.resize(n_cells);
+  std::exception_ptr error;
+  int i_error = n_cells;
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (int i = 0; i < n_cells; i++) {
+    try {
+      model::cells[i] = std::make_unique<CSGCell>(cell_nodes[i]);
+    } catch (...) {
+      #pragma omp critical (ReadCells)
+      if (i < i_error) {
+        i_error = i;
+        error = std::current_exception();
+      }
+    }
   }
+  if (error) std::rethrow_exception(error);
 
   // Fill the cell map.
   for (int i = 0; i < model::cells.size(); i++) {
@@ -1092,6 +1428,80 @@ openmc_cell_set_temperature(int32_t index, double T, const int32_t* instance)
   return 0;
 }
 
+extern "C" int
+openmc_cells_set_temperature(int32_t n, const int32_t* index,
+  const int32_t* instance, const double* T)
+{
+  for (int32_t i = 0; i < n; ++i) {
+    if (index[i] < 0 || index[i] >= model::cells.size()) {
+      set_errmsg("Index in cells array is out of bounds.");
+      return OPENMC_E_OUT_OF_BOUNDS;
+    }
+    if (instance && instance[i] >= model::cells[index[i]]->n_instances_) {
+      set_errmsg("Cell instance is out of bounds.");
+      return OPENMC_E_OUT_OF_BOUNDS;
+    }
+  }
+
+  // Temperatures set in parallel must not write to the same instance, so each
+  // cell is either given once for all of its instances or once per instance.
+  // Sorting puts an entry for all instances, marked by -1, first.
+  std::vector<std::pair<int32_t, int32_t>> entries(n);
+  for (int32_t i = 0; i < n; ++i) {
+    entries[i] = {index[i], (instance && instance[i] >= 0) ? instance[i] : -1};
+  }
+  std::sort(entries.begin(), entries.end());
+  for (int32_t i = 1; i < n; ++i) {
+    const auto& prev {entries[i - 1]};
+    if (entries[i].first == prev.first &&
+        (entries[i].second == prev.second || prev.second == -1)) {
+      set_errmsg(fmt::format("Temperature of cell {} is given more than once.",
+        model::cells[prev.first]->id_));
+      return OPENMC_E_INVALID_ARGUMENT;
+    }
+  }
+
+  // The first temperature given for each cell is set serially since it may
+  // resize the per-instance temperatures of the cell. The others only write
+  // to their own instance and can be set in parallel.
+  std::vector<bool> resized(model::cells.size(), false);
+  std::vector<int32_t> remaining;
+  remaining.reserve(n);
+  try {
+    for (int32_t i = 0; i < n; ++i) {
+      if (resized[index[i]]) {
+        remaining.push_back(i);
+      } else {
+        model::cells[index[i]]->set_temperature(T[i],
+          instance ? instance[i] : -1);
+        resized[index[i]] = true;
+      }
+    }
+  } catch (const std::exception& e) {
+    set_errmsg(e.what());
+    return OPENMC_E_UNASSIGNED;
+  }
+
+  int err = 0;
+  #pragma omp parallel for schedule(static)
+  for (int32_t j = 0; j < remaining.size(); ++j) {
+    int32_t i = remaining[j];
+    try {
+      model::cells[index[i]]->set_temperature(T[i],
+        instance ? instance[i] : -1);
+    } catch (const std::exception& e) {
+      #pragma omp critical (CellsSetTemperature)
+      {
+        if (err == 0) {
+          set_errmsg(e.what());
+          err = OPENMC_E_UNASSIGNED;
+        }
+      }
+    }
+  }
+  return err;
+}
+
 extern "C" int
 openmc_cell_get_temperature(int32_t index, const int32_t* instance, double* T)
 {
@@ -1215,15 +1625,10 @@ openmc_extend_cells(int32_t n, int32_t* index_start, int32_t* index_end)
 #ifdef DAGMC
 int32_t next_cell(DAGCell* cur_cell, DAGSurface* surf_xed)
 {
-  moab::EntityHandle surf =
-    surf_xed->dagmc_ptr_->entity_by_index(2, surf_xed->dag_index_);
-  moab::EntityHandle vol =
-    cur_cell->dagmc_ptr_->entity_by_index(3, cur_cell->dag_index_);
-
-  moab::EntityHandle new_vol;
-  cur_cell->dagmc_ptr_->next_vol(surf, vol, new_vol);
-
-  return cur_cell->dagmc_ptr_->index_by_handle(new_vol);
+  // DAGMC cells are stored in the order of their DAGMC indices
+  int32_t i_cell = cur_cell->dag_index_ - 1;
+  return (surf_xed->forward_cell_ == i_cell) ?
+    surf_xed->reverse_cell_ : surf_xed->forward_cell_;
 }
 #endif
 
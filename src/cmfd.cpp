@@ -0,0 +1,429 @@
+#include "openmc/cmfd.h"
+
+#include <array>
+#include <cmath> // for abs, isfinite, sqrt
+#include <map>
+#include <string>
+
+#include <fmt/core.h>
+
+#include "openmc/bank.h"
+#include "openmc/capi.h"
+#include "openmc/constants.h"
+#include "openmc/error.h"
+#include "openmc/mesh.h"
+#include "openmc/message_passing.h"
+#include "openmc/search.h"
+#include "openmc/settings.h"
+#include "openmc/simulation.h"
+#include "openmc/tallies/filter_energy.h"
+#include "openmc/tallies/filter_mesh.h"
+#include "openmc/tallies/filter_meshsurface.h"
+#include "openmc/tallies/tally.h"
+#include "openmc/xml_interface.h"
+
+namespace openmc {
+
+//==============================================================================
+// Global variables
+//==============================================================================
+
+namespace simulation {
+
+std::unique_ptr<CmfdAccelerator> cmfd_accelerator;
+
+} // namespace simulation
+
+//==============================================================================
+// CmfdAccelerator implementation
+//==============================================================================
+
+constexpr double CmfdAccelerator::KTOL;
+constexpr double CmfdAccelerator::STOL;
+constexpr double CmfdAccelerator::INNER_TOL;
+constexpr int CmfdAccelerator::MAX_ITERATIONS;
+
+CmfdAccelerator::CmfdAccelerator(pugi::xml_node node)
+{
+  // Get the mesh on which the CMFD problem is solved
+  if (!check_for_node(node, "mesh")) {
+    fatal_error("No mesh was specified for CMFD acceleration.");
+  }
+  int id = std::stoi(get_node_value(node, "mesh"));
+  auto it = model::mesh_map.find(id);
+  if (it == model::mesh_map.end()) {
+    fatal_error(fmt::format(
+      "Mesh {} specified for CMFD acceleration does not exist.", id));
+  }
+  i_mesh_ = it->second;
+  mesh_ = dynamic_cast<const RegularMesh*>(model::meshes[i_mesh_].get());
+  if (!mesh_) {
+    fatal_error("Only regular meshes can be used for CMFD acceleration");
+  }
+
+  // Get the energy group boundaries, using a single group by default
+  if (check_for_node(node, "energy_groups")) {
+    energy_bins_ = get_node_array<double>(node, "energy_groups");
+    if (energy_bins_.size() < 2) {
+      fatal_error("At least two CMFD energy group boundaries must be given.");
+    }
+    for (std::size_t i = 1; i < energy_bins_.size(); ++i) {
+      if (energy_bins_[i] <= energy_bins_[i - 1]) {
+        fatal_error("CMFD energy group boundaries must be increasing.");
+      }
+    }
+  } else {
+    energy_bins_ = {0.0, INFTY};
+  }
+
+  if (check_for_node(node, "begin")) {
+    begin_ = std::stoi(get_node_value(node, "begin"));
+    if (begin_ < 1) {
+      fatal_error("The first batch with CMFD feedback must be at least 1.");
+    }
+  }
+}
+
+void CmfdAccelerator::create_tallies()
+{
+  auto* mesh_filter = Filter::create<MeshFilter>();
+  mesh_filter->set_mesh(i_mesh_);
+  auto* surface_filter = Filter::create<MeshSurfaceFilter>();
+  surface_filter->set_mesh(i_mesh_);
+  auto* energy_filter = Filter::create<EnergyFilter>();
+  energy_filter->set_bins(energy_bins_);
+  auto* energyout_filter = Filter::create<EnergyoutFilter>();
+  energyout_filter->set_bins(energy_bins_);
+
+  // The tallies are scored from the first batch and never written out. Since
+  // the last filter varies fastest, the bins of a mesh element are contiguous.
+  auto create = [](std::vector<Filter*> filters,
+                  const std::vector<std::string>& scores) {
+    auto* tally = Tally::create();
+    tally->set_filters(filters);
+    tally->set_scores(scores);
+    tally->set_writable(false);
+    tally->set_active(true);
+    return static_cast<int32_t>(model::tallies.size() - 1);
+  };
+  i_rates_ = create({mesh_filter, energy_filter}, {"flux", "total"});
+  i_matrices_ = create({mesh_filter, energy_filter, energyout_filter},
+    {"nu-scatter", "nu-fission"});
+  i_currents_ = create({surface_filter, energy_filter}, {"current"});
+}
+
+void CmfdAccelerator::deactivate_tallies()
+{
+  for (auto i : {i_rates_, i_matrices_, i_currents_}) {
+    model::tallies[i]->set_active(false);
+  }
+}
+
+std::vector<double> CmfdAccelerator::tally_sums(int32_t i_tally,
+  int score) const
+{
+  const auto& tally {*model::tallies[i_tally]};
+  int n = tally.n_filter_bins();
+  std::vector<double> sums(n);
+  for (int i = 0; i < n; ++i) {
+    sums[i] = tally.results_(i, score, RESULT_SUM);
+  }
+
+#ifdef OPENMC_MPI
+  // When tallies are not reduced each process accumulates its own
+  // realizations, so they are summed here
+  if (!settings::reduce_tallies) {
+    std::vector<double> reduced(mpi::master ? n : 0);
+    MPI_Reduce(sums.data(), reduced.data(), n, MPI_DOUBLE, MPI_SUM, 0,
+      mpi::intracomm);
+    if (mpi::master) sums = reduced;
+  }
+#endif
+  return sums;
+}
+
+void CmfdAccelerator::apply_feedback()
+{
+  if (simulation::current_batch < begin_ ||
+      simulation::current_batch > settings::n_inactive) return;
+
+#ifdef OPENMC_MPI
+  // Pipelined reductions of the current batch must have completed
+  for (auto i : {i_rates_, i_matrices_, i_currents_}) {
+    model::tallies[i]->finish_reduction();
+  }
+#endif
+
+  int n_mesh = mesh_->n_bins();
+  int n_groups = energy_bins_.size() - 1;
+  int n = n_mesh * n_groups;
+
+  // Count the weight of the source sites of the next batch in each mesh bin
+  // and group
+  std::vector<double> counts(n, 0.0);
+  for (int64_t i = 0; i < simulation::work_per_rank; ++i) {
+    const auto& site {simulation::source_bank[i]};
+    int i_mesh = mesh_->get_bin(site.r);
+    if (i_mesh < 0 || site.E < energy_bins_.front() ||
+        site.E >= energy_bins_.back()) continue;
+    int g = lower_bound_index(energy_bins_.begin(), energy_bins_.end(), site.E);
+    counts[i_mesh*n_groups + g] += site.wgt;
+  }
+
+#ifdef OPENMC_MPI
+  std::vector<double> counts_reduced(mpi::master ? n : 0);
+  MPI_Reduce(counts.data(), counts_reduced.data(), n, MPI_DOUBLE, MPI_SUM, 0,
+    mpi::intracomm);
+  if (mpi::master) counts = counts_reduced;
+#endif
+
+  // Determine the factors by which the weights of sites are adjusted so that
+  // the source follows the CMFD fission source while its total weight is kept
+  std::vector<double> factors(n, 1.0);
+  std::vector<double> source;
+  int converged = solve(source);
+  if (mpi::master && converged) {
+    double sum_counts = 0.0;
+    double sum_source = 0.0;
+    for (int i = 0; i < n; ++i) {
+      if (counts[i] > 0.0 && source[i] > 0.0) {
+        sum_counts += counts[i];
+        sum_source += source[i];
+      }
+    }
+    for (int i = 0; i < n; ++i) {
+      if (counts[i] > 0.0 && source[i] > 0.0) {
+        factors[i] = (source[i] / counts[i]) * (sum_counts / sum_source);
+      }
+    }
+    write_message(fmt::format(" CMFD k-effective = {:.5f}", keff_), 7);
+  }
+
+#ifdef OPENMC_MPI
+  MPI_Bcast(&converged, 1, MPI_INT, 0, mpi::intracomm);
+  if (!converged) return;
+  MPI_Bcast(factors.data(), n, MPI_DOUBLE, 0, mpi::intracomm);
+#else
+  if (!converged) return;
+#endif
+
+  for (int64_t i = 0; i < simulation::work_per_rank; ++i) {
+    auto& site {simulation::source_bank[i]};
+    int i_mesh = mesh_->get_bin(site.r);
+    if (i_mesh < 0 || site.E < energy_bins_.front() ||
+        site.E >= energy_bins_.back()) continue;
+    int g = lower_bound_index(energy_bins_.begin(), energy_bins_.end(), site.E);
+    site.wgt *= factors[i_mesh*n_groups + g];
+  }
+}
+
+bool CmfdAccelerator::solve(std::vector<double>& source)
+{
+  auto flux = tally_sums(i_rates_, 0);
+  auto total = tally_sums(i_rates_, 1);
+  auto scatter = tally_sums(i_matrices_, 0);
+  auto fission = tally_sums(i_matrices_, 1);
+  auto current = tally_sums(i_currents_, 0);
+  if (!mpi::master) return false;
+
+  return power_iteration(flux, total, scatter, fission, current, source);
+}
+
+bool CmfdAccelerator::power_iteration(const std::vector<double>& flux,
+  const std::vector<double>& total, const std::vector<double>& scatter,
+  const std::vector<double>& fission, const std::vector<double>& current,
+  std::vector<double>& source)
+{
+  int n_mesh = mesh_->n_bins();
+  int n_groups = energy_bins_.size() - 1;
+  int n_dim = mesh_->n_dimension_;
+
+  // Only mesh elements with a nonzero flux and reaction rate in every group
+  // are accelerated
+  std::vector<int> coremap(n_mesh, CMFD_NOACCEL);
+  int n_accel = 0;
+  for (int i = 0; i < n_mesh; ++i) {
+    bool accelerated = true;
+    for (int g = 0; g < n_groups; ++g) {
+      int j = i*n_groups + g;
+      if (flux[j] <= 0.0 || total[j] <= 0.0) accelerated = false;
+    }
+    if (accelerated) coremap[i] = n_accel++;
+  }
+  if (n_accel == 0) return false;
+  int dim = n_accel * n_groups;
+
+  std::array<int, 3> shape {1, 1, 1};
+  double volume = 1.0;
+  for (int d = 0; d < n_dim; ++d) {
+    shape[d] = mesh_->shape_[d];
+    volume *= mesh_->width_[d];
+  }
+
+  // Average flux and diffusion coefficient of each row of the operators
+  std::vector<double> phi(dim);
+  std::vector<double> diffusion(dim);
+  for (int i = 0; i < n_mesh; ++i) {
+    if (coremap[i] == CMFD_NOACCEL) continue;
+    for (int g = 0; g < n_groups; ++g) {
+      int j = i*n_groups + g;
+      int row = coremap[i]*n_groups + g;
+      phi[row] = flux[j] / volume;
+      diffusion[row] = flux[j] / (3.0 * total[j]);
+    }
+  }
+
+  // Assemble the loss and production operators. Every row has a full block
+  // for the groups of its mesh element, which the two-group solver relies on.
+  std::vector<std::map<int, double>> loss(dim);
+  std::vector<std::map<int, double>> prod(dim);
+  for (int i = 0; i < n_mesh; ++i) {
+    if (coremap[i] == CMFD_NOACCEL) continue;
+    int a = coremap[i];
+
+    // Removal, in-scattering and fission production
+    for (int g = 0; g < n_groups; ++g) {
+      int row = a*n_groups + g;
+      loss[row][row] += total[i*n_groups + g] / flux[i*n_groups + g];
+      for (int h = 0; h < n_groups; ++h) {
+        int col = a*n_groups + h;
+        int j = (i*n_groups + h)*n_groups + g;
+        loss[row][col] -= scatter[j] / flux[i*n_groups + h];
+        prod[row][col] += fission[j] / flux[i*n_groups + h];
+      }
+    }
+
+    // Leakage across the faces of the mesh element. Faces between two
+    // accelerated elements are handled from the element on their lower side.
+    int ijk[3];
+    mesh_->get_indices_from_bin(i, ijk);
+    for (int d = 0; d < n_dim; ++d) {
+      double width = mesh_->width_[d];
+      double area = volume / width;
+      int i_surf = (i*4*n_dim + 4*d)*n_groups;
+
+      ijk[d] += 1;
+      int a_next = ijk[d] <= shape[d] ?
+        coremap[mesh_->get_bin_from_indices(ijk)] : CMFD_NOACCEL;
+      ijk[d] -= 2;
+      int a_prev = ijk[d] >= 1 ?
+        coremap[mesh_->get_bin_from_indices(ijk)] : CMFD_NOACCEL;
+      ijk[d] += 1;
+
+      for (int g = 0; g < n_groups; ++g) {
+        int row = a*n_groups + g;
+
+        // Net outgoing currents through the lower and upper faces
+        double out_prev = current[i_surf + g] - current[i_surf + n_groups + g];
+        double out_next = current[i_surf + 2*n_groups + g]
+          - current[i_surf + 3*n_groups + g];
+
+        if (a_prev == CMFD_NOACCEL) {
+          loss[row][row] += out_prev / flux[i*n_groups + g];
+        }
+
+        if (a_next == CMFD_NOACCEL) {
+          loss[row][row] += out_next / flux[i*n_groups + g];
+        } else {
+          // Finite difference coupling with a nonlinear correction that
+          // preserves the tallied net current
+          int col = a_next*n_groups + g;
+          double dc = diffusion[row];
+          double dn = diffusion[col];
+          double d_tilde = 2.0*dc*dn / (width*(dc + dn));
+          double j_net = out_next / area;
+          double d_hat = (j_net + d_tilde*(phi[col] - phi[row]))
+            / (phi[col] + phi[row]);
+          loss[row][row] += (d_tilde + d_hat) / width;
+          loss[row][col] += (-d_tilde + d_hat) / width;
+          loss[col][col] += (d_tilde - d_hat) / width;
+          loss[col][row] += (-d_tilde - d_hat) / width;
+        }
+      }
+    }
+  }
+
+  // Convert the loss operator to compressed sparse row format
+  std::vector<int> indptr {0};
+  std::vector<int> indices;
+  std::vector<double> data;
+  for (const auto& row : loss) {
+    for (const auto& entry : row) {
+      indices.push_back(entry.first);
+      data.push_back(entry.second);
+    }
+    indptr.push_back(indices.size());
+  }
+  std::array<int, 4> cmfd_indices {shape[0], shape[1], shape[2], n_groups};
+  openmc_initialize_linsolver(indptr.data(), indptr.size(), indices.data(),
+    indices.size(), dim, 0.0, cmfd_indices.data(), coremap.data(), true);
+
+  auto produce = [&](const std::vector<double>& x, std::vector<double>& s) {
+    double sum = 0.0;
+    for (int row = 0; row < dim; ++row) {
+      s[row] = 0.0;
+      for (const auto& entry : prod[row]) {
+        s[row] += entry.second * x[entry.first];
+      }
+      sum += s[row];
+    }
+    return sum;
+  };
+
+  // Power iterations starting from the Monte Carlo flux and eigenvalue
+  std::vector<double> x = phi;
+  std::vector<double> s(dim);
+  std::vector<double> s_next(dim);
+  std::vector<double> b(dim);
+  double k = simulation::keff > 0.0 ? simulation::keff : 1.0;
+  double s_sum = produce(x, s);
+  if (!(s_sum > 0.0)) return false;
+
+  bool converged = false;
+  for (int iter = 0; iter < MAX_ITERATIONS; ++iter) {
+    for (int row = 0; row < dim; ++row) b[row] = s[row] / k;
+    openmc_run_linsolver(data.data(), b.data(), x.data(), INNER_TOL);
+
+    double s_next_sum = produce(x, s_next);
+    if (!std::isfinite(s_next_sum) || !(s_next_sum > 0.0)) return false;
+    double k_next = k * s_next_sum / s_sum;
+
+    // Compare the normalized fission sources of successive iterations
+    double err = 0.0;
+    for (int row = 0; row < dim; ++row) {
+      if (s_next[row] > 0.0) {
+        double rel = 1.0 - (s[row] / s_sum) / (s_next[row] / s_next_sum);
+        err += rel * rel;
+      }
+    }
+    err = std::sqrt(err / dim);
+
+    // Normalize the flux to keep it from growing or shrinking without bound
+    for (int row = 0; row < dim; ++row) {
+      x[row] /= s_next_sum;
+      s[row] = s_next[row] / s_next_sum;
+    }
+    s_sum = 1.0;
+
+    converged = std::abs(k_next - k) < KTOL && err < STOL;
+    k = k_next;
+    if (converged) break;
+  }
+  if (!converged || !std::isfinite(k) || k <= 0.0) return false;
+  for (auto xi : x) {
+    if (!std::isfinite(xi) || xi < 0.0) return false;
+  }
+  keff_ = k;
+
+  // Expand the fission source to all mesh bins and groups
+  source.assign(n_mesh*n_groups, 0.0);
+  for (int i = 0; i < n_mesh; ++i) {
+    if (coremap[i] == CMFD_NOACCEL) continue;
+    for (int g = 0; g < n_groups; ++g) {
+      source[i*n_groups + g] = s[coremap[i]*n_groups + g];
+    }
+  }
+  return true;
+}
+
+} // namespace openmc
@@ -24,6 +24,8 @@ std::vector<int> indptr;
 
 std::vector<int> indices;
 
+std::vector<int> diagonal;
+
 int dim;
 
 double spectral;
@@ -116,7 +118,7 @@ int cmfd_linsolver_1g(const double* A_data, const double* b, double* x,
         if ((i+j+k) % 2 != irb) continue;
 
         // Get index of diagonal for current row
-        int didx = get_diagonal_index(irow);
+        int didx = cmfd::diagonal[irow];
 
         // Perform temporary sums, first do left of diag, then right of diag
         double tmp1 = 0.0;
@@ -183,8 +185,8 @@ int cmfd_linsolver_2g(const double* A_data, const double* b, double* x,
         if ((i+j+k) % 2 != irb) continue;
 
         // Get index of diagonals for current row and next row
-        int d1idx = get_diagonal_index(irow);
-        int d2idx = get_diagonal_index(irow+1);
+        int d1idx = cmfd::diagonal[irow];
+        int d2idx = cmfd::diagonal[irow+1];
 
         // Get block diagonal
         double m11 = A_data[d1idx];     // group 1 diagonal
@@ -245,6 +247,35 @@ int cmfd_linsolver_2g(const double* A_data, const double* b, double* x,
   return -1;
 }
 
+//==============================================================================
+// GAUSS_SEIDEL_ROW updates one unknown of a general CMFD linear system and
+// returns the square of its relative change
+//==============================================================================
+
+double gauss_seidel_row(const double* A_data, const double* b, double* x,
+                        const std::vector<double>& tmpx, int irow, double w)
+{
+  // Get index of diagonal for current row
+  int didx = cmfd::diagonal[irow];
+
+  // Perform temporary sums, first do left of diag, then right of diag
+  double tmp1 = 0.0;
+  for (int icol = cmfd::indptr[irow]; icol < didx; icol++)
+    tmp1 += A_data[icol] * x[cmfd::indices[icol]];
+  for (int icol = didx + 1; icol < cmfd::indptr[irow + 1]; icol++)
+    tmp1 += A_data[icol] * x[cmfd::indices[icol]];
+
+  // Solve for new x
+  double x1 = (b[irow] - tmp1) / A_data[didx];
+
+  // Perform overrelaxation
+  x[irow] = (1.0 - w) * x[irow] + w * x1;
+
+  // Compute residual
+  double res = (tmpx[irow] - x[irow]) / tmpx[irow];
+  return res * res;
+}
+
 //==============================================================================
 // CMFD_LINSOLVER_NG solves a general CMFD linear system
 //==============================================================================
@@ -262,27 +293,30 @@ int cmfd_linsolver_ng(const double* A_data, const double* b, double* x,
     // Copy over x vector
     std::vector<double> tmpx {x, x+cmfd::dim};
 
-    // Loop around matrix rows
-    for (int irow = 0; irow < cmfd::dim; irow++) {
-      // Get index of diagonal for current row
-      int didx = get_diagonal_index(irow);
-
-      // Perform temporary sums, first do left of diag, then right of diag
-      double tmp1 = 0.0;
-      for (int icol = cmfd::indptr[irow]; icol < didx; icol++)
-        tmp1 += A_data[icol] * x[cmfd::indices[icol]];
-      for (int icol = didx + 1; icol < cmfd::indptr[irow + 1]; icol++)
-        tmp1 += A_data[icol] * x[cmfd::indices[icol]];
-
-      // Solve for new x
-      double x1 = (b[irow] - tmp1) / A_data[didx];
-
-      // Perform overrelaxation
-      x[irow] = (1.0 - w) * x[irow] + w * x1;
-
-      // Compute residual and update error
-      double res = (tmpx[irow] - x[irow]) / tmpx[irow];
-      err += res * res;
+    if (cmfd::use_all_threads) {
+      // Perform red/black Gauss-Seidel iterations over mesh elements. The
+      // groups of an element are coupled to each other but only to the same
+      // group of neighboring elements, which have the other color, so all
+      // elements of one color can be updated concurrently.
+      int n_elements = cmfd::dim / cmfd::ng;
+      for (int irb = 0; irb < 2; irb++) {
+        #pragma omp parallel for reduction (+:err)
+        for (int ielem = 0; ielem < n_elements; ielem++) {
+          int i = cmfd::indexmap(ielem, 0);
+          int j = cmfd::indexmap(ielem, 1);
+          int k = cmfd::indexmap(ielem, 2);
+
+          // Filter out black cells
+          if ((i+j+k) % 2 != irb) continue;
+
+          for (int irow = ielem*cmfd::ng; irow < (ielem + 1)*cmfd::ng; irow++)
+            err += gauss_seidel_row(A_data, b, x, tmpx, irow, w);
+        }
+      }
+    } else {
+      // Loop around matrix rows
+      for (int irow = 0; irow < cmfd::dim; irow++)
+        err += gauss_seidel_row(A_data, b, x, tmpx, irow, w);
     }
 
     // Check convergence
@@ -327,19 +361,23 @@ void openmc_initialize_linsolver(const int* indptr, int len_indptr,
   cmfd::dim = dim;
   cmfd::spectral = spectral;
 
+  // Store the index of the diagonal of each row so that it is not searched
+  // for on every sweep of the linear solver
+  for (int i = 0; i < dim; i++)
+    cmfd::diagonal.push_back(get_diagonal_index(i));
+
   // Set number of groups
   cmfd::ng = cmfd_indices[3];
 
-  // Set problem dimensions and indexmap if 1 or 2 group problem
-  if (cmfd::ng == 1 || cmfd::ng == 2) {
-    cmfd::nx = cmfd_indices[0];
-    cmfd::ny = cmfd_indices[1];
-    cmfd::nz = cmfd_indices[2];
+  // Set problem dimensions and indexmap, which the red/black iterations use
+  // to color mesh elements
+  cmfd::nx = cmfd_indices[0];
+  cmfd::ny = cmfd_indices[1];
+  cmfd::nz = cmfd_indices[2];
 
-    // Resize indexmap and set its elements
-    cmfd::indexmap.resize({static_cast<size_t>(dim), 3});
-    set_indexmap(map);
-  }
+  // Resize indexmap and set its elements
+  cmfd::indexmap.resize({static_cast<size_t>(dim / cmfd::ng), 3});
+  set_indexmap(map);
 
   // Use all threads allocated to OpenMC simulation to run CMFD solver
   cmfd::use_all_threads = use_all_threads;
@@ -368,6 +406,7 @@ void free_memory_cmfd()
 {
   cmfd::indptr.clear();
   cmfd::indices.clear();
+  cmfd::diagonal.clear();
   // Resize indexmap to be an empty array
   cmfd::indexmap.resize({0});
 }
@@ -0,0 +1,220 @@
+#include "openmc/condensed_history.h"
+
+#include <algorithm> // for max, min
+#include <cmath>
+
+#include "openmc/bremsstrahlung.h"
+#include "openmc/constants.h"
+#include "openmc/material.h"
+#include "openmc/math_functions.h"
+#include "openmc/random_lcg.h"
+#include "openmc/search.h"
+#include "openmc/settings.h"
+
+namespace openmc {
+
+namespace {
+
+//! Position on the logarithmic incident energy grid
+struct GridPoint {
+  size_t i; //!< index of the lower bounding grid point
+  double f; //!< interpolation factor in log energy
+};
+
+GridPoint locate(double E)
+{
+  const auto& grid {data::ttb_e_grid};
+  size_t n = grid.size();
+  double log_E = std::log(E);
+  if (log_E <= grid(0)) return {0, 0.0};
+  if (log_E >= grid(n - 1)) return {n - 2, 1.0};
+  size_t i = lower_bound_index(grid.cbegin(), grid.cend(), log_E);
+  return {i, (log_E - grid(i)) / (grid(i + 1) - grid(i))};
+}
+
+double interpolate(const xt::xtensor<double, 1>& y, GridPoint g)
+{
+  return y(g.i) + g.f*(y(g.i + 1) - y(g.i));
+}
+
+const CondensedHistoryData& ch_data(const Particle& p)
+{
+  const auto& ch {*model::materials[p.material_]->ch_};
+  return (p.type_ == Particle::Type::positron) ? ch.positron : ch.electron;
+}
+
+//! Energy below which a particle is no longer transported
+double stopping_energy(const Particle& p)
+{
+  int type = static_cast<int>(p.type_);
+  return std::max(settings::energy_cutoff[type],
+    std::exp(data::ttb_e_grid(0)));
+}
+
+//! CSDA range of a particle of energy E
+double csda_range(const CondensedHistoryData& ch, double E)
+{
+  return std::exp(interpolate(ch.range, locate(E)));
+}
+
+//! Energy of a particle whose CSDA range is R, interpolated on a log-log scale
+double csda_energy(const CondensedHistoryData& ch, double R)
+{
+  const auto& grid {data::ttb_e_grid};
+  const auto& range {ch.range};
+  size_t n = range.size();
+  double log_R = std::log(R);
+
+  // The range is taken to grow as E^2 below the grid, as it was extrapolated
+  if (log_R <= range(0)) return std::exp(grid(0) + 0.5*(log_R - range(0)));
+
+  size_t i = std::min<size_t>(lower_bound_index(range.cbegin(), range.cend(),
+    log_R), n - 2);
+  double f = (log_R - range(i)) / (range(i + 1) - range(i));
+  return std::exp(grid(i) + f*(grid(i + 1) - grid(i)));
+}
+
+//! Sample the cosine of the deflection accumulated over a path
+//
+//! The deflection follows a Wentzel (screened Rutherford-like) distribution
+//! p(mu) = 2A(1 + A)/(1 - mu + 2A)^2 whose screening parameter A reproduces
+//! the mean <1 - mu> = 1 - exp(-s/lambda_1) given by Goudsmit-Saunderson
+//! theory.
+//! \param mean Mean of 1 - mu over the path
+//! \param seed Pseudorandom number seed pointer
+//! \return Cosine of the deflection
+double sample_deflection(double mean, uint64_t* seed)
+{
+  // The distribution is practically isotropic after long paths
+  if (mean >= 0.999) return 2.0*prn(seed) - 1.0;
+
+  // Find the screening parameter by bisection in log A, since the mean of the
+  // distribution strictly increases with A
+  double x_low = std::log(1.0e-12);
+  double x_high = std::log(1.0e6);
+  for (int i = 0; i < 50; ++i) {
+    double x = 0.5*(x_low + x_high);
+    double A = std::exp(x);
+    if (2.0*A*((1.0 + A)*std::log1p(1.0/A) - 1.0) < mean) {
+      x_low = x;
+    } else {
+      x_high = x;
+    }
+  }
+  double A = std::exp(0.5*(x_low + x_high));
+
+  // Sample the inverse of the cumulative distribution function
+  double xi = prn(seed);
+  return 1.0 - 2.0*A*xi/(1.0 + A - xi);
+}
+
+//! Sample the energy of a hard bremsstrahlung photon
+//
+//! \param ch Condensed history data of the material and particle
+//! \param E Energy of the particle in [eV]
+//! \param seed Pseudorandom number seed pointer
+//! \return Energy of the photon, between the hard bremsstrahlung cutoff and E
+double sample_hard_photon(const CondensedHistoryData& ch, double E,
+  uint64_t* seed)
+{
+  // The DCS is taken at one of the bounding grid energies, picked with the
+  // probability given by the interpolation factor
+  auto g = locate(E);
+  size_t j = (prn(seed) < g.f) ? g.i + 1 : g.i;
+
+  const auto& k_grid {data::ttb_k_grid};
+  size_t n_k = k_grid.size();
+  double k_cut = ch.w_cut / E;
+  while (true) {
+    // Sample the reduced photon energy k from 1/k and accept it with the
+    // ratio of the scaled DCS to its largest value
+    double k = std::pow(k_cut, prn(seed));
+    if (ch.dcs_max(j) <= 0.0) return k*E;
+    size_t i = std::min<size_t>(lower_bound_index(k_grid.cbegin(),
+      k_grid.cend(), k), n_k - 2);
+    double x = ch.dcs(j, i) + (k - k_grid(i)) / (k_grid(i + 1) - k_grid(i))
+      * (ch.dcs(j, i + 1) - ch.dcs(j, i));
+    if (prn(seed)*ch.dcs_max(j) <= x) return k*E;
+  }
+}
+
+//! Kill a particle that has slowed down, depositing its remaining energy
+void stop_particle(Particle& p)
+{
+  p.E_ = 0.0;
+  p.alive_ = false;
+  p.event_ = TallyEvent::ABSORB;
+}
+
+} // namespace
+
+//==============================================================================
+// Non-member functions
+//==============================================================================
+
+double condensed_history_step(Particle& p)
+{
+  p.step_end_ = Particle::StepEnd::energy_loss;
+  if (p.material_ == MATERIAL_VOID) return INFINITY;
+
+  // Path length over which the particle loses its fraction of energy, or
+  // slows down completely
+  const auto& ch {ch_data(p)};
+  double E_end = std::max((1.0 - CH_ENERGY_LOSS_FRACTION)*p.E_,
+    stopping_energy(p));
+  double distance = csda_range(ch, p.E_) - csda_range(ch, E_end);
+
+  // Sample the distance to a hard bremsstrahlung event
+  double xs = interpolate(ch.brems_xs, locate(p.E_));
+  if (xs > 0.0) {
+    double d = -std::log(prn(p.current_seed())) / xs;
+    if (d < distance) {
+      distance = d;
+      p.step_end_ = Particle::StepEnd::bremsstrahlung;
+    }
+  }
+  return distance;
+}
+
+void condensed_history_collision(Particle& p)
+{
+  const auto& ch {ch_data(p)};
+  double E = p.E_;
+  double E_stop = stopping_energy(p);
+
+  // Continuous slowing down along the step
+  double R_end = csda_range(ch, E) - p.collision_distance_;
+  double E_end = (R_end > 0.0) ? csda_energy(ch, R_end) : 0.0;
+  if (E_end <= E_stop*(1.0 + FP_REL_PRECISION)) {
+    stop_particle(p);
+    return;
+  }
+
+  // Elastic scattering along the step is condensed into a single deflection
+  // at its end, using the transport cross section at the mean energy. Steps
+  // cut short by a boundary are not deflected, so that the particle goes on
+  // to cross it.
+  if (p.step_end_ != Particle::StepEnd::boundary) {
+    auto g = locate(0.5*(E + E_end));
+    double xs = std::exp(interpolate(ch.transport_xs, g));
+    double mean = -std::expm1(-xs*p.collision_distance_);
+    double mu = sample_deflection(mean, p.current_seed());
+    p.u() = rotate_angle(p.u(), mu, nullptr, p.current_seed());
+  }
+
+  // Emit a hard bremsstrahlung photon in the direction of the particle
+  if (p.step_end_ == Particle::StepEnd::bremsstrahlung && E_end > ch.w_cut) {
+    double w = sample_hard_photon(ch, E_end, p.current_seed());
+    p.create_secondary(p.u(), w, Particle::Type::photon);
+    E_end -= w;
+    if (E_end <= E_stop) {
+      stop_particle(p);
+      return;
+    }
+  }
+
+  p.E_ = E_end;
+  p.event_ = TallyEvent::SCATTER;
+}
+
+} // namespace openmc
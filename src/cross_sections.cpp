@@ -1,5 +1,6 @@
 #include "openmc/cross_sections.h"
 
+#include "openmc/bremsstrahlung.h"
 #include "openmc/constants.h"
 #include "openmc/container_util.h"
 #ifdef DAGMC
@@ -9,6 +10,7 @@
 #include "openmc/file_utils.h"
 #include "openmc/hdf5_interface.h"
 #include "openmc/material.h"
+#include "openmc/memory_placement.h"
 #include "openmc/message_passing.h"
 #include "openmc/mgxs_interface.h"
 #include "openmc/nuclide.h"
@@ -21,8 +23,11 @@
 #include "openmc/wmp.h"
 
 #include "pugixml.hpp"
+#include "xtensor/xmath.hpp"
+#include <fmt/core.h>
 
 #include <cstdlib> // for getenv
+#include <unordered_map>
 #include <unordered_set>
 
 namespace openmc {
@@ -38,6 +43,110 @@ std::map<LibraryKey, std::size_t> library_map;
 
 }
 
+namespace {
+
+//! How a nuclide, thermal scattering table or element was loaded
+struct LoadRecord {
+  std::string path;                //!< Library the data was read from
+  std::string settings;            //!< Settings the data depends on
+  std::vector<double> temperature; //!< Temperatures in [K] it was read for
+};
+
+//! Data kept from a previous simulation in the same process
+template<typename T>
+struct RetainedData {
+  T data;
+  LoadRecord load;
+};
+
+// Loads of the current simulation by name
+std::unordered_map<std::string, LoadRecord> nuclide_loads;
+std::unordered_map<std::string, LoadRecord> thermal_loads;
+std::unordered_map<std::string, LoadRecord> element_loads;
+
+// Data kept from the previous simulation by name
+std::unordered_map<std::string, RetainedData<std::unique_ptr<Nuclide>>>
+  retained_nuclides;
+std::unordered_map<std::string,
+  RetainedData<std::unique_ptr<ThermalScattering>>> retained_thermal;
+std::unordered_map<std::string, RetainedData<PhotonInteraction>>
+  retained_elements;
+
+// Photon data shared by the kept elements, with the bremsstrahlung electron
+// energies on a linear scale
+xt::xtensor<double, 1> retained_compton_profile_pz;
+xt::xtensor<double, 2> retained_klein_nishina_quantiles;
+xt::xtensor<double, 1> retained_ttb_e_grid;
+xt::xtensor<double, 1> retained_ttb_k_grid;
+
+//! Settings that change the data built when a library is read. Data is only
+//! reused when they are the same.
+std::string nuclear_data_settings()
+{
+  std::string res_scat_nuclides;
+  for (const auto& name : settings::res_scat_nuclides) {
+    res_scat_nuclides += name + ' ';
+  }
+  int photon = static_cast<int>(Particle::Type::photon);
+  return fmt::format("{} {} {} {} {} {} {} {} {} {} {} {} {} {} {} {} {}[{}]",
+    static_cast<int>(settings::temperature_method),
+    settings::temperature_tolerance, settings::temperature_range[0],
+    settings::temperature_range[1], settings::delayed_photon_scaling,
+    settings::thinning_tolerance, settings::interleaved_xs,
+    settings::lazy_products, settings::correlated_alias,
+    settings::alias_sampling, settings::thermal_alias, settings::compton_tables,
+    static_cast<int>(settings::electron_treatment),
+    settings::energy_cutoff[photon], settings::n_log_bins,
+    settings::res_scat_on, res_scat_nuclides);
+}
+
+//! Path of the library of a given type for a nuclide, table or element, or an
+//! empty string if there is none
+std::string library_path(Library::Type type, const std::string& name)
+{
+  auto it = data::library_map.find({type, name});
+  if (it == data::library_map.end()) return {};
+  return data::libraries[it->second].path_;
+}
+
+//! Find data kept under a name that was read from the same library with the
+//! same settings at all the temperatures of a load
+//
+//! \param pool Kept data by name
+//! \param name Name of the nuclide, table or element
+//! \param load Library, settings and temperatures needed
+//! \return Pointer to the kept data, or nullptr if there is none that can be
+//!   reused
+template<typename T>
+RetainedData<T>* find_retained(
+  std::unordered_map<std::string, RetainedData<T>>& pool,
+  const std::string& name, const LoadRecord& load)
+{
+  auto it = pool.find(name);
+  if (it == pool.end()) return nullptr;
+  const auto& kept {it->second.load};
+  if (load.path.empty() || kept.path != load.path ||
+      kept.settings != load.settings) return nullptr;
+  for (double temp : load.temperature) {
+    if (!contains(kept.temperature, temp)) return nullptr;
+  }
+  return &it->second;
+}
+
+//! Release the kept data that was not reused
+void clear_retained_pools()
+{
+  retained_nuclides.clear();
+  retained_thermal.clear();
+  retained_elements.clear();
+  retained_compton_profile_pz.resize({0});
+  retained_klein_nishina_quantiles.resize({0, 0});
+  retained_ttb_e_grid.resize({0});
+  retained_ttb_k_grid.resize({0});
+}
+
+} // namespace
+
 //==============================================================================
 // Library methods
 //==============================================================================
@@ -103,7 +212,7 @@ void read_cross_sections_xml()
 
   if (found_uwuw_mats) {
     // if we found uwuw materials, load those
-    doc.load_file(s.c_str());
+    load_xml_file(doc, s);
   } else {
 #endif
   // Check if materials.xml exists
@@ -111,7 +220,7 @@ void read_cross_sections_xml()
     fatal_error("Material XML file '" + filename + "' does not exist.");
   }
   // Parse materials.xml file
-  doc.load_file(filename.c_str());
+  load_xml_file(doc, filename);
 #ifdef DAGMC
   }
 #endif
@@ -196,126 +305,265 @@ read_ce_cross_sections(const std::vector<std::vector<double>>& nuc_temps,
     thermal_names[kv.second] = kv.first;
   }
 
-  // Read cross sections
+  // Determine which nuclides to read, in the order they are first used
+  std::vector<int> nuclides_to_read;
   for (const auto& mat : model::materials) {
     for (int i_nuc : mat->nuclide_) {
       // Find name of corresponding nuclide. Because we haven't actually loaded
       // data, we don't have the name available, so instead we search through
       // all key/value pairs in nuclide_map
-      std::string& name = nuclide_names[i_nuc];
+      const std::string& name = nuclide_names[i_nuc];
 
-      // If we've already read this nuclide, skip it
+      // If we've already seen this nuclide, skip it
       if (already_read.find(name) != already_read.end()) continue;
+      already_read.insert(name);
+      nuclides_to_read.push_back(i_nuc);
+    }
+  }
+
+  // Reuse the nuclides kept from the previous simulation that were loaded at
+  // all the temperatures needed now
+  std::string data_settings = nuclear_data_settings();
+  int n_read = nuclides_to_read.size();
+  int n_nuclides = data::nuclides.size();
+  data::nuclides.resize(n_nuclides + n_read);
+  for (int i = 0; i < n_read; ++i) {
+    int i_nuc = nuclides_to_read[i];
+    const std::string& name = nuclide_names[i_nuc];
+    LoadRecord load {library_path(Library::Type::neutron, name), data_settings,
+      nuc_temps[i_nuc]};
+    if (auto kept = find_retained(retained_nuclides, name, load)) {
+      auto& nuc = data::nuclides[n_nuclides + i];
+      nuc = std::move(kept->data);
+      nuc->i_nuclide_ = n_nuclides + i;
+      load = kept->load;
+      retained_nuclides.erase(name);
+      write_message("Reusing " + name + " from the previous simulation", 6);
+
+      // Update the global data as reading the nuclide would have
+      if (nuc->kTs_.size() == 1 &&
+          settings::temperature_method == TemperatureMethod::INTERPOLATION) {
+        if (mpi::master) {
+          warning("Cross sections for " + name + " are only available at "
+            "one temperature. Reverting to nearest temperature method.");
+        }
+        settings::temperature_method = TemperatureMethod::NEAREST;
+      }
+      if (!nuc->kTs_.empty()) {
+        data::temperature_min = std::max(data::temperature_min,
+          std::round(nuc->kTs_.front() / K_BOLTZMANN));
+        data::temperature_max = std::min(data::temperature_max,
+          std::round(nuc->kTs_.back() / K_BOLTZMANN));
+      }
+    }
+    nuclide_loads[name] = load;
+  }
 
-      LibraryKey key {Library::Type::neutron, name};
-      int idx = data::library_map[key];
-      std::string& filename = data::libraries[idx].path_;
-
-      write_message("Reading " + name + " from " + filename, 6);
-
-      // Open file and make sure version is sufficient
-      hid_t file_id = file_open(filename, 'r');
-      check_data_version(file_id);
-
-      // Read nuclide data from HDF5
-      hid_t group = open_group(file_id, name.c_str());
-      int i_nuclide = data::nuclides.size();
-      data::nuclides.push_back(std::make_unique<Nuclide>(
-        group, nuc_temps[i_nuc], i_nuclide));
-
-      close_group(group);
-      file_close(file_id);
-
-      // Determine if minimum/maximum energy for this nuclide is greater/less
-      // than the previous
-      if (data::nuclides[i_nuclide]->grid_.size() >= 1) {
-        int neutron = static_cast<int>(Particle::Type::neutron);
-        data::energy_min[neutron] = std::max(data::energy_min[neutron],
-          data::nuclides[i_nuclide]->grid_[0].energy.front());
-        data::energy_max[neutron] = std::min(data::energy_max[neutron],
-          data::nuclides[i_nuclide]->grid_[0].energy.back());
+  // Photon data shared by all elements is kept along with them, and used again
+  // if any of them is reused
+  if (settings::photon_transport && !retained_elements.empty()) {
+    for (int i_nuc : nuclides_to_read) {
+      std::string element = to_element(nuclide_names[i_nuc]);
+      LoadRecord load {library_path(Library::Type::photon, element),
+        data_settings, {}};
+      if (find_retained(retained_elements, element, load)) {
+        data::compton_profile_pz = std::move(retained_compton_profile_pz);
+        data::klein_nishina_quantiles =
+          std::move(retained_klein_nishina_quantiles);
+        data::ttb_e_grid = std::move(retained_ttb_e_grid);
+        data::ttb_k_grid = std::move(retained_ttb_k_grid);
+        break;
       }
+    }
+  }
 
-      // Add name and alias to dictionary
-      already_read.insert(name);
+  // Nuclides are independent of one another and can be read concurrently, as
+  // long as the HDF5 library permits calls from multiple threads. Files that
+  // the master process reads and broadcasts are read one at a time, in the
+  // same order by all processes, so that only one is held in memory.
+  bool broadcast = settings::broadcast_data && mpi::n_procs > 1;
+  bool threaded = settings::threaded_xs_read && using_threadsafe_hdf5() &&
+    !broadcast;
+  if (settings::threaded_xs_read && !threaded && mpi::master) {
+    if (broadcast) {
+      warning("Nuclear data files broadcast from the master process are read "
+        "by a single thread.");
+    } else {
+      warning("HDF5 library is not thread-safe. Cross sections will be read "
+        "by a single thread.");
+    }
+  }
+
+  #pragma omp parallel for schedule(dynamic) if(threaded)
+  for (int i = 0; i < n_read; ++i) {
+    int i_nuc = nuclides_to_read[i];
+    int i_nuclide = n_nuclides + i;
+    if (data::nuclides[i_nuclide]) continue;
+    const std::string& name = nuclide_names[i_nuc];
+
+    LibraryKey key {Library::Type::neutron, name};
+    int idx = data::library_map.at(key);
+    const std::string& filename = data::libraries[idx].path_;
+
+    write_message("Reading " + name + " from " + filename, 6);
+
+    // Open file and make sure version is sufficient
+    if (broadcast) broadcast_file_image(filename);
+    hid_t file_id = file_open(filename, 'r');
+    check_data_version(file_id);
+
+    // Read nuclide data from HDF5
+    hid_t group = open_group(file_id, name.c_str());
+    data::nuclides[i_nuclide] = std::make_unique<Nuclide>(
+      group, nuc_temps[i_nuc], i_nuclide);
+
+    close_group(group);
+    file_close(file_id);
+    if (broadcast) free_file_images();
+  }
+
+  for (int i_nuclide = n_nuclides; i_nuclide < data::nuclides.size(); ++i_nuclide) {
+    const auto& nuc {data::nuclides[i_nuclide]};
+
+    // Determine if minimum/maximum energy for this nuclide is greater/less
+    // than the previous
+    if (nuc->grid_.size() >= 1) {
+      int neutron = static_cast<int>(Particle::Type::neutron);
+      data::energy_min[neutron] = std::max<double>(data::energy_min[neutron],
+        nuc->grid_[0].energy.front());
+      data::energy_max[neutron] = std::min<double>(data::energy_max[neutron],
+        nuc->grid_[0].energy.back());
+    }
 
-      // Check if elemental data has been read, if needed
-      std::string element = to_element(name);
-      if (settings::photon_transport) {
-        if (already_read.find(element) == already_read.end()) {
+    // Check if elemental data has been read, if needed. Elements share
+    // global data that the first one read initializes, so they are read in
+    // order by a single thread.
+    std::string element = to_element(nuc->name_);
+    if (settings::photon_transport) {
+      if (already_read.find(element) == already_read.end()) {
+        LibraryKey key {Library::Type::photon, element};
+        int idx = data::library_map[key];
+        std::string& filename = data::libraries[idx].path_;
+        LoadRecord load {filename, data_settings, {}};
+        if (auto kept = find_retained(retained_elements, element, load)) {
+          // Reuse the element kept from the previous simulation
+          data::elements.push_back(std::move(kept->data));
+          data::elements.back().i_element_ = data::elements.size() - 1;
+          retained_elements.erase(element);
+          write_message("Reusing " + element + " from the previous "
+            "simulation", 6);
+        } else {
           // Read photon interaction data from HDF5 photon library
-          LibraryKey key {Library::Type::photon, element};
-          int idx = data::library_map[key];
-          std::string& filename = data::libraries[idx].path_;
           write_message("Reading " + element + " from " + filename, 6);
 
           // Open file and make sure version is sufficient
+          if (broadcast) broadcast_file_image(filename);
           hid_t file_id = file_open(filename, 'r');
           check_data_version(file_id);
 
           // Read element data from HDF5
           hid_t group = open_group(file_id, element.c_str());
           data::elements.emplace_back(group, data::elements.size());
-
-          // Determine if minimum/maximum energy for this element is greater/less than
-          // the previous
-          const auto& elem {data::elements.back()};
-          if (elem.energy_.size() >= 1) {
-            int photon = static_cast<int>(Particle::Type::photon);
-            int n = elem.energy_.size();
-            data::energy_min[photon] = std::max(data::energy_min[photon],
-              std::exp(elem.energy_(1)));
-            data::energy_max[photon] = std::min(data::energy_max[photon],
-              std::exp(elem.energy_(n - 1)));
-          }
-
           close_group(group);
           file_close(file_id);
-
-          // Add element to set
-          already_read.insert(element);
+          if (broadcast) free_file_images();
+        }
+        element_loads[element] = load;
+
+        // Determine if minimum/maximum energy for this element is greater/less than
+        // the previous
+        const auto& elem {data::elements.back()};
+        if (elem.energy_.size() >= 1) {
+          int photon = static_cast<int>(Particle::Type::photon);
+          int n = elem.energy_.size();
+          data::energy_min[photon] = std::max(data::energy_min[photon],
+            std::exp(elem.energy_(1)));
+          data::energy_max[photon] = std::min(data::energy_max[photon],
+            std::exp(elem.energy_(n - 1)));
         }
+
+        // Add element to set
+        already_read.insert(element);
       }
+    }
 
-      // Read multipole file into the appropriate entry on the nuclides array
-      if (settings::temperature_multipole) read_multipole_data(i_nuclide);
+    // Read multipole file into the appropriate entry on the nuclides array,
+    // unless a reused nuclide already has it
+    if (!settings::temperature_multipole) {
+      nuc->multipole_.reset();
+    } else if (!nuc->multipole_) {
+      auto filename = library_path(Library::Type::wmp, nuc->name_);
+      if (broadcast && !filename.empty()) broadcast_file_image(filename);
+      read_multipole_data(i_nuclide);
+      if (broadcast) free_file_images();
     }
   }
 
-  // Perform final tasks -- reading S(a,b) tables, normalizing densities
-  for (auto& mat : model::materials) {
+  // Determine which S(a,b) tables to read
+  std::vector<int> thermal_to_read;
+  for (const auto& mat : model::materials) {
     for (const auto& table : mat->thermal_tables_) {
-      // Get name of S(a,b) table
       int i_table = table.index_table;
-      std::string& name = thermal_names[i_table];
-
-      if (already_read.find(name) == already_read.end()) {
-        LibraryKey key {Library::Type::thermal, name};
-        int idx = data::library_map[key];
-        std::string& filename = data::libraries[idx].path_;
-
-        write_message("Reading " + name + " from " + filename, 6);
+      const std::string& name = thermal_names[i_table];
+      if (already_read.find(name) != already_read.end()) continue;
+      already_read.insert(name);
+      thermal_to_read.push_back(i_table);
+    }
+  }
 
-        // Open file and make sure version matches
-        hid_t file_id = file_open(filename, 'r');
-        check_data_version(file_id);
+  // Reuse the S(a,b) tables kept from the previous simulation that were
+  // loaded at all the temperatures needed now
+  n_read = thermal_to_read.size();
+  int n_thermal = data::thermal_scatt.size();
+  data::thermal_scatt.resize(n_thermal + n_read);
+  for (int i = 0; i < n_read; ++i) {
+    int i_table = thermal_to_read[i];
+    const std::string& name = thermal_names[i_table];
+    LoadRecord load {library_path(Library::Type::thermal, name), data_settings,
+      thermal_temps[i_table]};
+    if (auto kept = find_retained(retained_thermal, name, load)) {
+      data::thermal_scatt[n_thermal + i] = std::move(kept->data);
+      load = kept->load;
+      retained_thermal.erase(name);
+      write_message("Reusing " + name + " from the previous simulation", 6);
+    }
+    thermal_loads[name] = load;
+  }
 
-        // Read thermal scattering data from HDF5
-        hid_t group = open_group(file_id, name.c_str());
-        data::thermal_scatt.push_back(std::make_unique<ThermalScattering>(
-          group, thermal_temps[i_table]));
-        close_group(group);
-        file_close(file_id);
+  // Read S(a,b) tables, concurrently if possible
+  #pragma omp parallel for schedule(dynamic) if(threaded)
+  for (int i = 0; i < n_read; ++i) {
+    int i_table = thermal_to_read[i];
+    const std::string& name = thermal_names[i_table];
+    if (data::thermal_scatt[n_thermal + i]) continue;
+
+    LibraryKey key {Library::Type::thermal, name};
+    int idx = data::library_map.at(key);
+    const std::string& filename = data::libraries[idx].path_;
+
+    write_message("Reading " + name + " from " + filename, 6);
+
+    // Open file and make sure version matches
+    if (broadcast) broadcast_file_image(filename);
+    hid_t file_id = file_open(filename, 'r');
+    check_data_version(file_id);
+
+    // Read thermal scattering data from HDF5
+    hid_t group = open_group(file_id, name.c_str());
+    data::thermal_scatt[n_thermal + i] = std::make_unique<ThermalScattering>(
+      group, thermal_temps[i_table]);
+    close_group(group);
+    file_close(file_id);
+    if (broadcast) free_file_images();
+  }
 
-        // Add name to dictionary
-        already_read.insert(name);
-      }
-    } // thermal_tables_
+  // Release the kept data that was not needed again
+  clear_retained_pools();
 
-    // Finish setting up materials (normalizing densities, etc.)
+  // Finish setting up materials (normalizing densities, etc.)
+  for (auto& mat : model::materials) {
     mat->finalize();
-  } // materials
-
+  }
 
   // Set up logarithmic grid for nuclides
   for (auto& nuc : data::nuclides) {
@@ -325,7 +573,8 @@ read_ce_cross_sections(const std::vector<std::vector<double>>& nuc_temps,
   simulation::log_spacing = std::log(data::energy_max[neutron] /
     data::energy_min[neutron]) / settings::n_log_bins;
 
-  if (settings::photon_transport && settings::electron_treatment == ElectronTreatment::TTB) {
+  if (settings::photon_transport &&
+      settings::electron_treatment != ElectronTreatment::LED) {
     // Determine if minimum/maximum energy for bremsstrahlung is greater/less
     // than the current minimum/maximum
     if (data::ttb_e_grid.size() >= 1) {
@@ -339,6 +588,24 @@ read_ce_cross_sections(const std::vector<std::vector<double>>& nuc_temps,
     data::ttb_e_grid = xt::log(data::ttb_e_grid);
   }
 
+  // Set up logarithmic grid for elements once the photon energy bounds are
+  // known
+  if (settings::photon_transport) {
+    int photon = static_cast<int>(Particle::Type::photon);
+    data::photon_log_E_min = std::log(data::energy_min[photon]);
+    data::photon_log_spacing = std::log(data::energy_max[photon] /
+      data::energy_min[photon]) / settings::n_log_bins;
+    for (auto& elem : data::elements) {
+      elem.init_grid();
+    }
+  }
+
+  // Keep one copy of the nuclide cross sections per node
+  if (settings::shared_xs) share_nuclide_xs();
+
+  // Back the largest arrays with huge pages to reduce TLB misses on lookups
+  advise_nuclear_data();
+
   // Show which nuclide results in lowest energy for neutron transport
   for (const auto& nuc : data::nuclides) {
     // If a nuclide is present in a material that's not used in the model, its
@@ -396,7 +663,7 @@ void read_ce_cross_sections_xml()
 
   // Parse cross_sections.xml file
   pugi::xml_document doc;
-  auto result = doc.load_file(filename.c_str());
+  auto result = load_xml_file(doc, filename);
   if (!result) {
     fatal_error("Error processing cross_sections.xml file.");
   }
@@ -434,4 +701,66 @@ void library_clear() {
   data::library_map.clear();
 }
 
+void retain_nuclear_data()
+{
+  clear_retained_pools();
+
+  // Nuclides whose cross sections live in memory shared among the ranks of a
+  // node can't outlive it
+  if (!settings::shared_xs) {
+    for (auto& nuc : data::nuclides) {
+      auto it = nuclide_loads.find(nuc->name_);
+      if (it == nuclide_loads.end()) continue;
+      std::string name = nuc->name_;
+      retained_nuclides.emplace(name,
+        RetainedData<std::unique_ptr<Nuclide>> {std::move(nuc), it->second});
+    }
+  }
+  data::nuclides.clear();
+
+  for (auto& table : data::thermal_scatt) {
+    auto it = thermal_loads.find(table->name_);
+    if (it == thermal_loads.end()) continue;
+    std::string name = table->name_;
+    retained_thermal.emplace(name,
+      RetainedData<std::unique_ptr<ThermalScattering>> {
+        std::move(table), it->second});
+  }
+  data::thermal_scatt.clear();
+
+  for (auto& elem : data::elements) {
+    auto it = element_loads.find(elem.name_);
+    if (it == element_loads.end()) continue;
+    std::string name = elem.name_;
+    retained_elements.emplace(name,
+      RetainedData<PhotonInteraction> {std::move(elem), it->second});
+  }
+  data::elements.clear();
+
+  if (!retained_elements.empty()) {
+    retained_compton_profile_pz = std::move(data::compton_profile_pz);
+    retained_klein_nishina_quantiles =
+      std::move(data::klein_nishina_quantiles);
+    retained_ttb_k_grid = std::move(data::ttb_k_grid);
+
+    // Elements read later use the electron energies on a linear scale
+    retained_ttb_e_grid = std::move(data::ttb_e_grid);
+    if (settings::electron_treatment != ElectronTreatment::LED) {
+      retained_ttb_e_grid = xt::exp(retained_ttb_e_grid);
+    }
+  }
+
+  nuclide_loads.clear();
+  thermal_loads.clear();
+  element_loads.clear();
+}
+
+void free_retained_data()
+{
+  clear_retained_pools();
+  nuclide_loads.clear();
+  thermal_loads.clear();
+  element_loads.clear();
+}
+
 } // namespace openmc
@@ -21,6 +21,7 @@
 #include <sstream>
 #include <algorithm>
 #include <fstream>
+#include <utility>
 
 namespace openmc {
 
@@ -145,6 +146,56 @@ void legacy_assign_material(const std::string& mat_string, DAGCell* c)
   }
 }
 
+void build_dagmc_bvhs()
+{
+  write_message("Building triangle BVHs of DAGMC volumes...", 6);
+  moab::Interface* mbi = model::DAG->moab_instance();
+  moab::ErrorCode rval;
+
+  for (auto& cell : model::cells) {
+    auto c = dynamic_cast<DAGCell*>(cell.get());
+    if (!c) continue;
+    moab::EntityHandle vol = model::DAG->entity_by_index(3, c->dag_index_);
+
+    moab::Range surfs;
+    rval = mbi->get_child_meshsets(vol, surfs);
+    MB_CHK_ERR_CONT(rval);
+
+    std::vector<TriangleBVH::Triangle> triangles;
+    for (auto surf : surfs) {
+      // surfaces whose sense is unknown are hit from either side
+      int sense = 0;
+      rval = model::DAG->surface_sense(vol, surf, sense);
+      bool two_sided = (rval != moab::MB_SUCCESS || sense == 0);
+      int32_t surf_idx = model::DAG->index_by_handle(surf);
+
+      moab::Range tris;
+      rval = mbi->get_entities_by_type(surf, moab::MBTRI, tris);
+      MB_CHK_ERR_CONT(rval);
+      for (auto tri : tris) {
+        const moab::EntityHandle* conn;
+        int n_conn;
+        rval = mbi->get_connectivity(tri, conn, n_conn);
+        MB_CHK_ERR_CONT(rval);
+        double x[9];
+        rval = mbi->get_coords(conn, 3, x);
+        MB_CHK_ERR_CONT(rval);
+
+        // triangle normals point out of the volume of forward sense
+        TriangleBVH::Triangle t;
+        t.v = {Position{x[0], x[1], x[2]}, Position{x[3], x[4], x[5]},
+          Position{x[6], x[7], x[8]}};
+        if (sense == -1) std::swap(t.v[1], t.v[2]);
+        t.surface = surf_idx;
+        t.id = tri;
+        t.two_sided = two_sided;
+        triangles.push_back(t);
+      }
+    }
+    c->bvh_ = std::make_unique<TriangleBVH>(std::move(triangles));
+  }
+}
+
 void load_dagmc_geometry()
 {
   if (!model::DAG) {
@@ -360,11 +411,26 @@ void load_dagmc_geometry()
       s->bc_ = Surface::BoundaryType::VACUUM;
     }
 
+    // store the cells on either side so that crossings need no MOAB queries
+    for (auto vol : parent_vols) {
+      int sense;
+      rval = model::DAG->surface_sense(vol, surf_handle, sense);
+      MB_CHK_ERR_CONT(rval);
+      int32_t i_cell = model::DAG->index_by_handle(vol) - 1;
+      if (sense == -1) {
+        s->reverse_cell_ = i_cell;
+      } else {
+        s->forward_cell_ = i_cell;
+      }
+    }
+
     // add to global array and map
     model::surfaces.emplace_back(s);
     model::surface_map[s->id_] = i;
   }
 
+  if (settings::dagmc_bvh) build_dagmc_bvhs();
+
   return;
 }
 
@@ -0,0 +1,607 @@
+#include "openmc/delta_tracking.h"
+
+#include <algorithm> // for max, min
+#include <cmath>     // for abs, log
+#include <map>
+#include <set>
+#include <utility>   // for pair
+
+#include <fmt/core.h>
+
+#include "openmc/cell.h"
+#include "openmc/constants.h"
+#include "openmc/error.h"
+#include "openmc/geometry.h"
+#include "openmc/geometry_aux.h"
+#include "openmc/lattice.h"
+#include "openmc/material.h"
+#include "openmc/mesh.h"
+#include "openmc/mesh_field.h"
+#include "openmc/nuclide.h"
+#include "openmc/particle.h"
+#include "openmc/random_lcg.h"
+#include "openmc/settings.h"
+#include "openmc/simulation.h"
+#include "openmc/surface.h"
+#include "openmc/tallies/filter_cell.h"
+#include "openmc/tallies/filter_material.h"
+#include "openmc/tallies/filter_mesh.h"
+#include "openmc/tallies/filter_surface.h"
+#include "openmc/tallies/tally.h"
+#include "openmc/thermal.h"
+
+namespace openmc {
+
+//==============================================================================
+// Global variables
+//==============================================================================
+
+namespace model {
+  std::vector<int32_t> delta_tracking_cells;
+  std::vector<Majorant> majorants;
+  int32_t global_majorant {C_NONE};
+  std::vector<int32_t> boundary_condition_surfaces;
+  std::unordered_set<int32_t> delta_tracked_cells;
+} // namespace model
+
+namespace simulation {
+  int64_t n_majorant_exceeded {0};
+} // namespace simulation
+
+namespace {
+
+//! Cells whose contents include a delta-tracking cell
+std::unordered_set<int32_t> containing_cells;
+
+//! Materials within delta-tracking cells
+std::set<int32_t> tracked_materials;
+
+//! Box enclosing the delta-tracking cells, which is infinite unless they are
+//! all in the root universe
+BoundingBox tracked_box;
+
+//! Get the bin of the logarithmic energy grid containing an energy
+
+int log_grid_bin(double E)
+{
+  int neutron = static_cast<int>(Particle::Type::neutron);
+  if (E <= data::energy_min[neutron]) return 0;
+  int k = std::log(E/data::energy_min[neutron])/simulation::log_spacing;
+  return std::min(k, settings::n_log_bins - 1);
+}
+
+//! Determine the largest microscopic total cross section of a nuclide in each
+//! bin of the logarithmic energy grid, over all temperatures
+
+std::vector<double> nuclide_bound(const Nuclide& nuc)
+{
+  std::vector<double> bound(settings::n_log_bins, 0.0);
+
+  // Cross sections are linearly interpolated between grid points, so the
+  // larger of the cross sections at the ends of each interval bounds it
+  for (int t = 0; t < nuc.kTs_.size(); ++t) {
+    const auto& energy {nuc.grid_[t].energy};
+    for (int j = 0; j + 1 < energy.size(); ++j) {
+      double xs = std::max(nuc.total_xs(t, j), nuc.total_xs(t, j + 1));
+      int k_high = log_grid_bin(energy[j + 1]);
+      for (int k = log_grid_bin(energy[j]); k <= k_high; ++k) {
+        bound[k] = std::max(bound[k], xs);
+      }
+    }
+  }
+
+  // In the unresolved resonance range, cross sections are sampled from
+  // probability tables instead
+  if (settings::urr_ptables_on && nuc.urr_present_) {
+    std::vector<double> smooth {bound};
+    for (const auto& urr : nuc.urr_data_) {
+      int n_band = urr.prob_.shape()[2];
+      for (int i = 0; i + 1 < urr.n_energy_; ++i) {
+        double elastic = 0.0;
+        double fission = 0.0;
+        double capture = 0.0;
+        for (int i_energy : {i, i + 1}) {
+          for (int b = 0; b < n_band; ++b) {
+            elastic = std::max(elastic,
+              urr.prob_(i_energy, URRTableParam::ELASTIC, b));
+            fission = std::max(fission,
+              urr.prob_(i_energy, URRTableParam::FISSION, b));
+            capture = std::max(capture,
+              urr.prob_(i_energy, URRTableParam::N_GAMMA, b));
+          }
+        }
+
+        int k_high = log_grid_bin(urr.energy_(i + 1));
+        for (int k = log_grid_bin(urr.energy_(i)); k <= k_high; ++k) {
+          double xs;
+          if (urr.multiply_smooth_) {
+            // The tables give factors multiplying the smooth cross sections
+            xs = std::max({elastic, fission, capture, 1.0}) * smooth[k];
+          } else {
+            xs = elastic + fission + capture + smooth[k];
+          }
+          bound[k] = std::max(bound[k], xs);
+        }
+      }
+    }
+  }
+
+  return bound;
+}
+
+//! Add the cells of a universe and of the universes and lattices nested in it
+//! to a set. Each universe is only visited once.
+
+void universe_cells(int32_t i_univ, std::set<int32_t>& universes,
+  std::unordered_set<int32_t>& cells)
+{
+  if (!universes.insert(i_univ).second) return;
+  for (auto i_cell : model::universes[i_univ]->cells_) {
+    cells.insert(i_cell);
+    const auto& c {*model::cells[i_cell]};
+    if (c.type_ == Fill::UNIVERSE) {
+      universe_cells(c.fill_, universes, cells);
+    } else if (c.type_ == Fill::LATTICE) {
+      Lattice& lat {*model::lattices[c.fill_]};
+      for (auto it = lat.begin(); it != lat.end(); ++it) {
+        universe_cells(*it, universes, cells);
+      }
+      if (lat.outer_ != NO_OUTER_UNIVERSE) {
+        universe_cells(lat.outer_, universes, cells);
+      }
+    }
+  }
+}
+
+//! Determine whether a universe contains a delta-tracking cell, adding the
+//! cells filled with universes or lattices that contain one to
+//! containing_cells. Results for each universe are memoized.
+
+bool contains_delta_tracking(int32_t i_univ, std::map<int32_t, bool>& memo)
+{
+  auto it = memo.find(i_univ);
+  if (it != memo.end()) return it->second;
+  memo[i_univ] = false;
+
+  bool found = false;
+  for (auto i_cell : model::universes[i_univ]->cells_) {
+    const auto& c {*model::cells[i_cell]};
+    bool contains = false;
+    if (c.type_ == Fill::UNIVERSE) {
+      contains = contains_delta_tracking(c.fill_, memo);
+    } else if (c.type_ == Fill::LATTICE) {
+      Lattice& lat {*model::lattices[c.fill_]};
+      for (auto it = lat.begin(); it != lat.end(); ++it) {
+        contains = contains_delta_tracking(*it, memo) || contains;
+      }
+      if (lat.outer_ != NO_OUTER_UNIVERSE) {
+        contains = contains_delta_tracking(lat.outer_, memo) || contains;
+      }
+    }
+    if (contains) containing_cells.insert(i_cell);
+    found = found || contains || c.delta_tracking_;
+  }
+  memo[i_univ] = found;
+  return found;
+}
+
+//! Find the distance to the nearest surface with a boundary condition, which
+//! are the only surfaces crossed when delta tracking through the whole geometry
+
+BoundaryInfo distance_to_boundary_condition(const Particle& p)
+{
+  BoundaryInfo info;
+  info.coord_level = 1;
+
+  Position r {p.r()};
+  Direction u {p.u()};
+  for (auto i_surf : model::boundary_condition_surfaces) {
+    const auto& surf {*model::surfaces[i_surf]};
+    bool coincident = std::abs(p.surface_) == i_surf + 1;
+    double d = surf.distance(r, u, coincident);
+    if (d < info.distance) {
+      info.distance = d;
+
+      // The sign of the index gives the half-space the particle moves into
+      Direction norm = surf.normal(r + d*u);
+      info.surface_index = (u.dot(norm) > 0) ? i_surf + 1 : -(i_surf + 1);
+    }
+  }
+  return info;
+}
+
+} // namespace
+
+//==============================================================================
+// Majorant implementation
+//==============================================================================
+
+Majorant::Majorant(const std::vector<int32_t>& materials,
+  const std::vector<std::vector<double>>& nuclide_bound)
+  : xs_(settings::n_log_bins, 0.0)
+{
+  int n_bins = xs_.size();
+  std::vector<double> xs(n_bins);
+  for (auto i_mat : materials) {
+    const auto& mat {*model::materials[i_mat]};
+
+    std::fill(xs.begin(), xs.end(), 0.0);
+    for (int i = 0; i < mat.nuclide_.size(); ++i) {
+      const auto& bound {nuclide_bound[mat.nuclide_[i]]};
+      double atom_density = mat.atom_density_(i);
+      for (int k = 0; k < n_bins; ++k) {
+        xs[k] += atom_density * bound[k];
+      }
+    }
+
+    // Thermal scattering replaces part of the free-atom elastic scattering
+    // cross section, so its cross section is simply added
+    for (const auto& table : mat.thermal_tables_) {
+      const auto& sab {*data::thermal_scatt[table.index_table]};
+      double atom_density = mat.atom_density_(table.index_nuclide);
+      for (int k = 0; k < n_bins; ++k) {
+        double E_low = data::log_grid_energy[k];
+        if (E_low >= sab.energy_max_) break;
+        double E_high = std::min(data::log_grid_energy[k + 1], sab.energy_max_);
+
+        double thermal = 0.0;
+        for (const auto& data : sab.data_) {
+          thermal = std::max(thermal, data.max_xs(E_low, E_high));
+        }
+        xs[k] += atom_density * table.fraction * thermal;
+      }
+    }
+
+    for (int k = 0; k < n_bins; ++k) {
+      xs_[k] = std::max(xs_[k], xs[k]);
+    }
+  }
+}
+
+int Majorant::bin(double E) const
+{
+  return log_grid_bin(E);
+}
+
+double Majorant::operator()(double E) const
+{
+  double xs;
+  const double& x {xs_[bin(E)]};
+  #pragma omp atomic read
+  xs = x;
+  return xs;
+}
+
+void Majorant::raise(double E, double xs)
+{
+  double& x {xs_[bin(E)]};
+  #pragma omp critical (RaiseMajorant)
+  {
+    if (xs > x) {
+      #pragma omp atomic write
+      x = xs;
+    }
+  }
+}
+
+//==============================================================================
+// Non-member functions
+//==============================================================================
+
+void initialize_delta_tracking()
+{
+  free_memory_delta_tracking();
+  for (int i = 0; i < model::cells.size(); ++i) {
+    if (model::cells[i]->delta_tracking_) {
+      model::delta_tracking_cells.push_back(i);
+    }
+  }
+  if (model::delta_tracking_cells.empty() && !settings::delta_tracking) return;
+
+  // The cells below delta-tracking cells are only found at collision sites
+  std::set<int32_t> universes;
+  for (auto i_cell : model::delta_tracking_cells) {
+    const auto& c {*model::cells[i_cell]};
+    if (c.type_ == Fill::UNIVERSE) {
+      universe_cells(c.fill_, universes, model::delta_tracked_cells);
+    } else if (c.type_ == Fill::LATTICE) {
+      Lattice& lat {*model::lattices[c.fill_]};
+      for (auto it = lat.begin(); it != lat.end(); ++it) {
+        universe_cells(*it, universes, model::delta_tracked_cells);
+      }
+      if (lat.outer_ != NO_OUTER_UNIVERSE) {
+        universe_cells(lat.outer_, universes, model::delta_tracked_cells);
+      }
+    }
+  }
+
+  if (!settings::run_CE) {
+    fatal_error("Delta tracking is only supported in continuous-energy mode.");
+  }
+  if (settings::delta_tracking && settings::dagmc) {
+    fatal_error("Delta tracking cannot be used with DAGMC geometry.");
+  }
+  if (settings::run_mode == RunMode::PLOTTING) return;
+
+  // Find the cells and materials that tallies restricted to parts of the
+  // geometry are compared with
+  std::map<int32_t, bool> memo;
+  contains_delta_tracking(model::root_universe, memo);
+  tracked_box = {INFTY, -INFTY, INFTY, -INFTY, INFTY, -INFTY};
+  for (auto i_cell : model::delta_tracking_cells) {
+    const auto& c {*model::cells[i_cell]};
+    fill_materials(c, tracked_materials);
+    if (c.universe_ == model::root_universe) {
+      tracked_box |= c.bounding_box();
+    } else {
+      tracked_box = {};
+    }
+  }
+
+  // Surfaces with a boundary condition are the only ones crossed when delta
+  // tracking through the whole geometry
+  if (settings::delta_tracking) {
+    for (int i = 0; i < model::surfaces.size(); ++i) {
+      if (model::surfaces[i]->bc_ != Surface::BoundaryType::TRANSMIT) {
+        model::boundary_condition_surfaces.push_back(i);
+      }
+    }
+  }
+
+  // Cells filled with the same universe or lattice share a majorant. The
+  // bounds of each nuclide are only determined once.
+  std::vector<std::vector<double>> nuclide_bounds(data::nuclides.size());
+  std::map<std::pair<int, int32_t>, int32_t> fill_majorant;
+  for (auto i_cell : model::delta_tracking_cells) {
+    auto& c {*model::cells[i_cell]};
+    std::pair<int, int32_t> key {static_cast<int>(c.type_), c.fill_};
+    auto it = fill_majorant.find(key);
+    if (it != fill_majorant.end()) {
+      c.majorant_ = it->second;
+      continue;
+    }
+
+    std::set<int32_t> materials;
+    fill_materials(c, materials);
+    for (auto i_mat : materials) {
+      for (auto i_nuc : model::materials[i_mat]->nuclide_) {
+        if (nuclide_bounds[i_nuc].empty()) {
+          nuclide_bounds[i_nuc] = nuclide_bound(*data::nuclides[i_nuc]);
+        }
+      }
+    }
+
+    c.majorant_ = model::majorants.size();
+    fill_majorant[key] = c.majorant_;
+    model::majorants.emplace_back(
+      std::vector<int32_t>(materials.begin(), materials.end()), nuclide_bounds);
+  }
+
+  // The majorant for the whole geometry covers every material
+  if (settings::delta_tracking) {
+    std::vector<int32_t> materials;
+    for (int i_mat = 0; i_mat < model::materials.size(); ++i_mat) {
+      materials.push_back(i_mat);
+      for (auto i_nuc : model::materials[i_mat]->nuclide_) {
+        if (nuclide_bounds[i_nuc].empty()) {
+          nuclide_bounds[i_nuc] = nuclide_bound(*data::nuclides[i_nuc]);
+        }
+      }
+    }
+    model::global_majorant = model::majorants.size();
+    model::majorants.emplace_back(materials, nuclide_bounds);
+  }
+}
+
+int delta_tracking_level(const Particle& p)
+{
+  for (int i = 0; i < p.n_coord_ - 1; ++i) {
+    if (model::cells[p.coord_[i].cell]->delta_tracking_) return i;
+  }
+  return C_NONE;
+}
+
+void delta_tracking_advance(Particle& p, int level)
+{
+  // Only the boundaries of the delta-tracking cell and the cells containing it
+  // are considered. The cells below it are only determined at collision sites.
+  // Throughout the whole geometry, only boundary conditions are considered.
+  int n_coord = (level == C_NONE) ? 1 : level + 1;
+  int32_t i_majorant = (level == C_NONE) ? model::global_majorant :
+    model::cells[p.coord_[level].cell]->majorant_;
+  auto& majorant {model::majorants[i_majorant]};
+
+  p.n_coord_ = n_coord;
+  if (p.boundary_cached_) {
+    p.boundary_cached_ = false;
+  } else if (level == C_NONE) {
+    p.boundary_ = distance_to_boundary_condition(p);
+  } else {
+    p.boundary_ = distance_to_boundary(p);
+  }
+
+  auto move = [&p](double distance) {
+    for (int j = 0; j < p.n_coord_; ++j) {
+      p.coord_[j].r += distance * p.coord_[j].u;
+    }
+    p.time_ += distance / p.speed();
+  };
+
+  // As in Particle::event_advance(), a particle reaching the time cutoff or
+  // the census time stops there and is then killed, or banked for the census,
+  // by event_collide()
+  double time_cutoff = std::min(
+    settings::time_cutoff[static_cast<int>(p.type_)], settings::census_time);
+  double cutoff_distance = (time_cutoff < INFTY) ?
+    std::max(0.0, (time_cutoff - p.time_) * p.speed()) : INFINITY;
+  p.time_last_ = p.time_;
+
+  double traveled = 0.0;
+  while (true) {
+    // Sample the distance to the next tentative collision
+    double xs_majorant = majorant(p.E_);
+    double d = (xs_majorant > 0.0) ?
+      -std::log(prn(p.current_seed())) / xs_majorant : INFINITY;
+    if (traveled + d >= cutoff_distance &&
+        cutoff_distance < p.boundary_.distance) {
+      move(cutoff_distance - traveled);
+      p.time_ = time_cutoff;
+      p.collision_distance_ = cutoff_distance;
+      return;
+    }
+    if (traveled + d >= p.boundary_.distance) {
+      move(p.boundary_.distance - traveled);
+      p.collision_distance_ = INFINITY;
+      return;
+    }
+    move(d);
+    traveled += d;
+    p.surface_ = 0;
+
+    // Find the cell and cross sections at the tentative collision site. The
+    // cells that the particle was last found in are tried first.
+    if (!find_cell(p, false, true)) {
+      p.mark_as_lost(fmt::format("Could not find the cell containing particle "
+        "{} during delta tracking", p.id_));
+      p.collision_distance_ = INFINITY;
+      return;
+    }
+    if (p.material_ == MATERIAL_VOID) {
+      p.macro_xs_.total      = 0.0;
+      p.macro_xs_.absorption = 0.0;
+      p.macro_xs_.fission    = 0.0;
+      p.macro_xs_.nu_fission = 0.0;
+    } else {
+      if (!model::mesh_fields.empty()) apply_mesh_fields(p);
+      if (p.material_ != p.material_last_ || p.sqrtkT_ != p.sqrtkT_last_ ||
+          p.density_mult_ != p.density_mult_last_) {
+        model::materials[p.material_]->calculate_xs(p);
+      }
+    }
+
+    // Tentative collisions occur at the rate given by the majorant, so each
+    // gives an unbiased estimate of the track-length integral
+    if (settings::run_mode == RunMode::EIGENVALUE) {
+      p.keff_tally_tracklength_ += p.wgt_ * p.macro_xs_.nu_fission
+        / xs_majorant;
+    }
+
+    // Accept the collision with the probability given by the fraction of the
+    // majorant that is real
+    if (p.macro_xs_.total > xs_majorant) {
+      #pragma omp atomic
+      ++simulation::n_majorant_exceeded;
+      majorant.raise(p.E_, p.macro_xs_.total);
+      break;
+    }
+    if (prn(p.current_seed()) * xs_majorant < p.macro_xs_.total) break;
+
+    // Continue from the virtual collision in the same direction
+    p.n_coord_ = n_coord;
+  }
+
+  p.collision_distance_ = traveled;
+}
+
+void check_delta_tracking_surface_tally(const Tally& tally)
+{
+  if (!settings::delta_tracking && model::delta_tracking_cells.empty()) return;
+
+  for (auto i_filt : tally.filters()) {
+    const auto* filt {model::tally_filters[i_filt].get()};
+    if (const auto* f = dynamic_cast<const SurfaceFilter*>(filt)) {
+      for (auto i_surf : f->surfaces()) {
+        const auto& surf {*model::surfaces[i_surf]};
+        bool missed = settings::delta_tracking &&
+          surf.bc_ == Surface::BoundaryType::TRANSMIT;
+        for (auto i_cell : model::delta_tracked_cells) {
+          if (missed) break;
+          for (auto token : model::cells[i_cell]->region_) {
+            if (token < OP_UNION && std::abs(token) == i_surf + 1) {
+              missed = true;
+              break;
+            }
+          }
+        }
+        if (missed) {
+          fatal_error(fmt::format("Tally {} scores crossings of surface {}, "
+            "which is not crossed under delta tracking.", tally.id_,
+            surf.id_));
+        }
+      }
+    } else if (const auto* f = dynamic_cast<const CellFilter*>(filt)) {
+      // Crossings between cells are only found on transmissive surfaces
+      for (auto i_cell : f->cells()) {
+        if (settings::delta_tracking ||
+            model::delta_tracked_cells.count(i_cell)) {
+          fatal_error(fmt::format("Tally {} scores crossings into or out of "
+            "cell {}, which are not found under delta tracking.", tally.id_,
+            model::cells[i_cell]->id_));
+        }
+      }
+    }
+  }
+}
+
+bool delta_tracking_overlaps(const Tally& tally)
+{
+  if (settings::delta_tracking) return true;
+  if (model::delta_tracking_cells.empty()) return false;
+
+  // Each cell, material or structured mesh filter confines the tally to its
+  // domain, which may miss the delta-tracked regions
+  for (auto i_filt : tally.filters()) {
+    const auto* filt {model::tally_filters[i_filt].get()};
+    if (filt->type() == "cell") {
+      bool overlaps = false;
+      for (auto i_cell : static_cast<const CellFilter*>(filt)->cells()) {
+        if (model::cells[i_cell]->delta_tracking_ ||
+            model::delta_tracked_cells.count(i_cell) ||
+            containing_cells.count(i_cell)) {
+          overlaps = true;
+          break;
+        }
+      }
+      if (!overlaps) return false;
+    } else if (filt->type() == "material") {
+      bool overlaps = false;
+      for (auto i_mat : static_cast<const MaterialFilter*>(filt)->materials()) {
+        if (tracked_materials.count(i_mat)) {
+          overlaps = true;
+          break;
+        }
+      }
+      if (!overlaps) return false;
+    } else if (filt->type() == "mesh") {
+      auto i_mesh = static_cast<const MeshFilter*>(filt)->mesh();
+      const auto* m =
+        dynamic_cast<const StructuredMesh*>(model::meshes[i_mesh].get());
+      if (!m) continue;
+      const auto& ll {m->lower_left_};
+      const auto& ur {m->upper_right_};
+      const auto& b {tracked_box};
+      if (ur(0) < b.xmin || ll(0) > b.xmax) return false;
+      if (m->n_dimension_ > 1 && (ur(1) < b.ymin || ll(1) > b.ymax)) {
+        return false;
+      }
+      if (m->n_dimension_ > 2 && (ur(2) < b.zmin || ll(2) > b.zmax)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void free_memory_delta_tracking()
+{
+  model::delta_tracking_cells.clear();
+  model::majorants.clear();
+  model::global_majorant = C_NONE;
+  model::boundary_condition_surfaces.clear();
+  model::delta_tracked_cells.clear();
+  containing_cells.clear();
+  tracked_materials.clear();
+  tracked_box = {};
+}
+
+} // namespace openmc
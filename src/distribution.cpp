@@ -1,6 +1,6 @@
 #include "openmc/distribution.h"
 
-#include <algorithm> // for copy
+#include <algorithm> // for copy, min
 #include <cmath>     // for sqrt, floor, max
 #include <iterator>  // for back_inserter
 #include <numeric>   // for accumulate
@@ -10,10 +10,99 @@
 #include "openmc/error.h"
 #include "openmc/math_functions.h"
 #include "openmc/random_lcg.h"
+#include "openmc/settings.h"
 #include "openmc/xml_interface.h"
 
 namespace openmc {
 
+//==============================================================================
+// AliasTable implementation
+//==============================================================================
+
+AliasTable::AliasTable(const std::vector<double>& p)
+  : prob_(p.size()), alias_(p.size())
+{
+  std::size_t n = p.size();
+  double norm = std::accumulate(p.begin(), p.end(), 0.0);
+
+  // Scale the probabilities so that their mean is one and split the indices
+  // into those below and above the mean
+  std::vector<std::size_t> small;
+  std::vector<std::size_t> large;
+  for (std::size_t i = 0; i < n; ++i) {
+    prob_[i] = p[i]*n/norm;
+    alias_[i] = i;
+    if (prob_[i] < 1.0) {
+      small.push_back(i);
+    } else {
+      large.push_back(i);
+    }
+  }
+
+  // Fill each small index up to one with part of a large one
+  while (!small.empty() && !large.empty()) {
+    std::size_t s = small.back();
+    small.pop_back();
+    std::size_t l = large.back();
+    alias_[s] = l;
+    prob_[l] -= 1.0 - prob_[s];
+    if (prob_[l] < 1.0) {
+      large.pop_back();
+      small.push_back(l);
+    }
+  }
+
+  // Whatever is left only differs from one by round-off
+  for (auto i : small) prob_[i] = 1.0;
+  for (auto i : large) prob_[i] = 1.0;
+}
+
+std::size_t AliasTable::sample(double xi, double& residual) const
+{
+  std::size_t n = prob_.size();
+  double u = xi*n;
+  std::size_t i = std::min(static_cast<std::size_t>(u), n - 1);
+  double f = u - i;
+  if (f < prob_[i]) {
+    residual = f/prob_[i];
+    return i;
+  } else {
+    residual = (f - prob_[i])/(1.0 - prob_[i]);
+    return alias_[i];
+  }
+}
+
+//==============================================================================
+// Tabulated cumulative distributions
+//==============================================================================
+
+void find_cdf_bin(const double* c, int n_discrete, int end, double r1, int& k,
+  double& c_k, double& c_k1)
+{
+  c_k = c[0];
+  k = 0;
+
+  // Discrete portion
+  for (int j = 0; j < n_discrete; ++j) {
+    k = j;
+    c_k = c[k];
+    if (r1 < c_k) {
+      end = j;
+      break;
+    }
+  }
+
+  // Continuous portion
+  c_k1 = c_k;
+  for (int j = n_discrete; j < end; ++j) {
+    k = j;
+    c_k1 = c[k+1];
+    if (r1 < c_k1) break;
+    k = j + 1;
+    c_k = c_k1;
+  }
+}
+
 //==============================================================================
 // Discrete implementation
 //==============================================================================
@@ -38,7 +127,10 @@ Discrete::Discrete(const double* x, const double* p, int n)
 double Discrete::sample(uint64_t* seed) const
 {
   int n = x_.size();
-  if (n > 1) {
+  if (!alias_.empty()) {
+    double residual;
+    return x_[alias_.sample(prn(seed), residual)];
+  } else if (n > 1) {
     double xi = prn(seed);
     double c = 0.0;
     for (int i = 0; i < n; ++i) {
@@ -58,6 +150,10 @@ void Discrete::normalize()
   for (auto& p_i : p_) {
     p_i /= norm;
   }
+
+  if (settings::alias_sampling && p_.size() >= ALIAS_THRESHOLD) {
+    alias_ = AliasTable{p_};
+  }
 }
 
 //==============================================================================
@@ -222,20 +318,39 @@ void Tabular::init(const double* x, const double* p, std::size_t n, const double
     p_[i] = p_[i]/c_[n-1];
     c_[i] = c_[i]/c_[n-1];
   }
+
+  // Large distributions may choose their bin with an alias table
+  if (settings::alias_sampling && n > ALIAS_THRESHOLD) {
+    std::vector<double> bins(n - 1);
+    for (int i = 0; i < n - 1; ++i) {
+      bins[i] = c_[i+1] - c_[i];
+    }
+    alias_ = AliasTable{bins};
+  }
 }
 
 double Tabular::sample(uint64_t* seed) const
 {
-  // Sample value of CDF
-  double c = prn(seed);
-
-  // Find first CDF bin which is above the sampled value
-  double c_i = c_[0];
+  double c;
+  double c_i;
   int i;
-  std::size_t n = c_.size();
-  for (i = 0; i < n - 1; ++i) {
-    if (c <= c_[i+1]) break;
-    c_i = c_[i+1];
+  if (!alias_.empty()) {
+    // Choose the bin from the alias table and the value of the CDF within it
+    double residual;
+    i = alias_.sample(prn(seed), residual);
+    c_i = c_[i];
+    c = c_i + residual*(c_[i+1] - c_i);
+  } else {
+    // Sample value of CDF
+    c = prn(seed);
+
+    // Find first CDF bin which is above the sampled value
+    c_i = c_[0];
+    std::size_t n = c_.size();
+    for (i = 0; i < n - 1; ++i) {
+      if (c <= c_[i+1]) break;
+      c_i = c_[i+1];
+    }
   }
 
   // Determine bounding PDF values
@@ -275,7 +390,7 @@ double Equiprobable::sample(uint64_t* seed) const
   int i = std::floor((n - 1)*r);
 
   double xl = x_[i];
-  double xr = x_[i+i];
+  double xr = x_[i+1];
   return xl + ((n - 1)*r - i) * (xr - xl);
 }
 
@@ -76,10 +76,11 @@ Direction PolarAzimuthal::sample(uint64_t* seed) const
 
 Direction Isotropic::sample(uint64_t* seed) const
 {
-  double phi = 2.0*PI*prn(seed);
+  double cosphi, sinphi;
+  sample_azimuth(seed, cosphi, sinphi);
   double mu = 2.0*prn(seed) - 1.0;
-  return {mu, std::sqrt(1.0 - mu*mu) * std::cos(phi),
-      std::sqrt(1.0 - mu*mu) * std::sin(phi)};
+  double a = std::sqrt(1.0 - mu*mu);
+  return {mu, a*cosphi, a*sinphi};
 }
 
 //==============================================================================
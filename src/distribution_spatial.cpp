@@ -1,6 +1,12 @@
 #include "openmc/distribution_spatial.h"
 
+#include <fmt/core.h>
+
+#include "openmc/capi.h"
+#include "openmc/cell.h"
 #include "openmc/error.h"
+#include "openmc/material.h"
+#include "openmc/message_passing.h"
 #include "openmc/random_lcg.h"
 #include "openmc/xml_interface.h"
 
@@ -195,12 +201,92 @@ SpatialBox::SpatialBox(pugi::xml_node node, bool fission)
 
   lower_left_ = Position{params[0], params[1], params[2]};
   upper_right_ = Position{params[3], params[4], params[5]};
+
+  // Read number of voxels of the acceptance grid
+  if (check_for_node(node, "acceptance_grid")) {
+    auto shape = get_node_array<int>(node, "acceptance_grid");
+    if (shape.size() != 3 || shape[0] < 1 || shape[1] < 1 || shape[2] < 1) {
+      fatal_error("The acceptance grid of a box spatial source must have "
+        "three positive numbers of voxels.");
+    }
+    grid_shape_ = {shape[0], shape[1], shape[2]};
+  }
 }
 
 Position SpatialBox::sample(uint64_t* seed) const
 {
   Position xi {prn(seed), prn(seed), prn(seed)};
-  return lower_left_ + xi*(upper_right_ - lower_left_);
+  if (grid_voxels_.empty()) {
+    return lower_left_ + xi*(upper_right_ - lower_left_);
+  }
+
+  // All voxels have the same volume, so one that can accept sites is chosen
+  // uniformly and the site is sampled uniformly within it
+  int32_t v = grid_voxels_[prn(seed)*grid_voxels_.size()];
+  int nx = grid_shape_[0];
+  int ny = grid_shape_[1];
+  Position ijk {static_cast<double>(v % nx),
+    static_cast<double>((v / nx) % ny), static_cast<double>(v / (nx*ny))};
+  Position n {static_cast<double>(nx), static_cast<double>(ny),
+    static_cast<double>(grid_shape_[2])};
+  return lower_left_ + (ijk + xi)/n*(upper_right_ - lower_left_);
+}
+
+bool SpatialBox::accepts(Position r) const
+{
+  double xyz[] {r.x, r.y, r.z};
+  int32_t cell_index, instance;
+  if (openmc_find_cell(xyz, &cell_index, &instance) == OPENMC_E_GEOMETRY) {
+    return false;
+  }
+  if (!only_fissionable_) return true;
+
+  const auto& c = model::cells[cell_index];
+  auto mat_index = c->material_.size() == 1
+    ? c->material_[0] : c->material_[instance];
+  return mat_index != MATERIAL_VOID && model::materials[mat_index]->fissionable_;
+}
+
+void SpatialBox::build_acceptance_grid()
+{
+  // Points probed in each voxel along each axis
+  constexpr int N_PROBE {3};
+
+  grid_voxels_.clear();
+  int nx = grid_shape_[0];
+  int ny = grid_shape_[1];
+  int nz = grid_shape_[2];
+  int32_t n_voxels = nx*ny*nz;
+  if (n_voxels == 0) return;
+
+  Position n {static_cast<double>(nx), static_cast<double>(ny),
+    static_cast<double>(nz)};
+  Position width = (upper_right_ - lower_left_)/n;
+
+  std::vector<uint8_t> accepted(n_voxels, 0);
+  #pragma omp parallel for schedule(dynamic)
+  for (int32_t v = 0; v < n_voxels; ++v) {
+    Position corner = lower_left_ + Position{static_cast<double>(v % nx),
+      static_cast<double>((v / nx) % ny), static_cast<double>(v / (nx*ny))}*width;
+    for (int k = 0; k < N_PROBE*N_PROBE*N_PROBE && !accepted[v]; ++k) {
+      Position f {(k % N_PROBE + 0.5) / N_PROBE,
+        ((k / N_PROBE) % N_PROBE + 0.5) / N_PROBE,
+        (k / (N_PROBE*N_PROBE) + 0.5) / N_PROBE};
+      if (accepts(corner + f*width)) accepted[v] = 1;
+    }
+  }
+
+  for (int32_t v = 0; v < n_voxels; ++v) {
+    if (accepted[v]) grid_voxels_.push_back(v);
+  }
+  if (grid_voxels_.empty()) {
+    fatal_error("No voxel of the acceptance grid of a box spatial source can "
+      "accept source sites.");
+  }
+  if (mpi::master) {
+    write_message(fmt::format("Source acceptance grid keeps {} of {} voxels",
+      grid_voxels_.size(), n_voxels), 6);
+  }
 }
 
 //==============================================================================
@@ -0,0 +1,545 @@
+#include "openmc/domain_decomposition.h"
+
+#include <algorithm> // for copy, max, min, upper_bound
+#include <array>
+#include <climits>   // for INT_MAX
+#include <cstring>   // for memcpy
+#include <set>
+#include <string>
+#include <utility>   // for move
+
+#include <fmt/core.h>
+
+#include "openmc/bank.h"
+#include "openmc/cell.h"
+#include "openmc/constants.h"
+#include "openmc/error.h"
+#include "openmc/geometry.h"
+#include "openmc/geometry_aux.h"
+#include "openmc/material.h"
+#include "openmc/mesh.h"
+#include "openmc/message_passing.h"
+#include "openmc/nuclide.h"
+#include "openmc/openmp_interface.h"
+#include "openmc/settings.h"
+#include "openmc/simulation.h"
+#include "openmc/surface.h"
+#include "openmc/tallies/filter.h"
+#include "openmc/tallies/filter_mesh.h"
+#include "openmc/tallies/tally.h"
+#include "openmc/xml_interface.h"
+
+namespace openmc {
+
+//==============================================================================
+// Global variables
+//==============================================================================
+
+namespace simulation {
+
+int32_t domain_mesh {-1};
+std::vector<int32_t> domain_bin_start;
+std::vector<bool> domain_materials;
+int64_t n_migrated {0};
+
+} // namespace simulation
+
+namespace {
+
+//==============================================================================
+//! State of a particle sent to another domain, followed in the message by its
+//! flux derivatives and its secondary bank. Everything else is either
+//! recomputed when the particle is located again or only used within an event.
+//==============================================================================
+
+struct MigrationHeader {
+  Position r;
+  Direction u;
+  Position r_last_current;
+  Position r_last;
+  Direction u_last;
+  double E;
+  double E_last;
+  double wgt;
+  double wgt_last;
+  double time;
+  double time_last;
+  double mu;
+  int64_t id;
+  int64_t current_work;
+  int64_t n_progeny;
+  uint64_t seeds[N_STREAMS];
+  Particle::Type type;
+  int g;
+  int g_last;
+  int surface;
+  int cell_born;
+  int n_collision;
+  int delayed_group;
+  int n_event;
+  int n_derivs;
+  int n_secondary;
+};
+
+//! Append the state of a particle to a message
+void pack_particle(const Particle& p, std::vector<char>& buffer)
+{
+  MigrationHeader h;
+  h.r = p.r();
+  h.u = p.u();
+  h.r_last_current = p.r_last_current_;
+  h.r_last = p.r_last_;
+  h.u_last = p.u_last_;
+  h.E = p.E_;
+  h.E_last = p.E_last_;
+  h.wgt = p.wgt_;
+  h.wgt_last = p.wgt_last_;
+  h.time = p.time_;
+  h.time_last = p.time_last_;
+  h.mu = p.mu_;
+  h.id = p.id_;
+  h.current_work = p.current_work_;
+  h.n_progeny = p.n_progeny_;
+  std::copy(p.seeds_, p.seeds_ + N_STREAMS, h.seeds);
+  h.type = p.type_;
+  h.g = p.g_;
+  h.g_last = p.g_last_;
+  h.surface = p.surface_;
+  h.cell_born = p.cell_born_;
+  h.n_collision = p.n_collision_;
+  h.delayed_group = p.delayed_group_;
+  h.n_event = p.n_event_;
+  h.n_derivs = p.flux_derivs_.size();
+  h.n_secondary = p.secondary_bank_.size();
+
+  auto append = [&buffer](const void* data, std::size_t n) {
+    const char* c = static_cast<const char*>(data);
+    buffer.insert(buffer.end(), c, c + n);
+  };
+  append(&h, sizeof(h));
+  append(p.flux_derivs_.data(), h.n_derivs*sizeof(double));
+  append(p.secondary_bank_.data(), h.n_secondary*sizeof(Particle::Bank));
+}
+
+//! Restore the state of a particle from a message
+//! \return Number of bytes read
+std::size_t unpack_particle(const char* data, Particle& p)
+{
+  MigrationHeader h;
+  std::memcpy(&h, data, sizeof(h));
+  std::size_t n = sizeof(h);
+
+  // The particle is located again when its cross sections are next computed,
+  // as is done for secondary particles
+  p.clear();
+  p.alive_ = true;
+  p.boundary_cached_ = false;
+  p.material_ = C_NONE;
+  p.fission_ = false;
+  p.r() = h.r;
+  p.u() = h.u;
+  p.r_last_current_ = h.r_last_current;
+  p.r_last_ = h.r_last;
+  p.u_last_ = h.u_last;
+  p.E_ = h.E;
+  p.E_last_ = h.E_last;
+  p.wgt_ = h.wgt;
+  p.wgt_last_ = h.wgt_last;
+  p.time_ = h.time;
+  p.time_last_ = h.time_last;
+  p.mu_ = h.mu;
+  p.id_ = h.id;
+  p.current_work_ = h.current_work;
+  p.n_progeny_ = h.n_progeny;
+  std::copy(h.seeds, h.seeds + N_STREAMS, p.seeds_);
+  p.type_ = h.type;
+  p.g_ = h.g;
+  p.g_last_ = h.g_last;
+  p.surface_ = h.surface;
+  p.cell_born_ = h.cell_born;
+  p.n_collision_ = h.n_collision;
+  p.delayed_group_ = h.delayed_group;
+  p.n_event_ = h.n_event;
+  p.trace_ = false;
+  p.write_track_ = false;
+
+  initialize_history_partial(p);
+
+  p.flux_derivs_.resize(h.n_derivs);
+  std::memcpy(p.flux_derivs_.data(), data + n, h.n_derivs*sizeof(double));
+  n += h.n_derivs*sizeof(double);
+  p.secondary_bank_.resize(h.n_secondary);
+  std::memcpy(p.secondary_bank_.data(), data + n,
+    h.n_secondary*sizeof(Particle::Bank));
+  n += h.n_secondary*sizeof(Particle::Bank);
+  return n;
+}
+
+//! Number of bytes of the state of a particle in a message
+std::size_t packed_size(const char* data)
+{
+  MigrationHeader h;
+  std::memcpy(&h, data, sizeof(h));
+  return sizeof(h) + h.n_derivs*sizeof(double) +
+    h.n_secondary*sizeof(Particle::Bank);
+}
+
+//! Add the global tally accumulators and the surface source sites of a particle
+//! leaving this domain, which would otherwise be added when it dies
+void suspend_particle(Particle& p)
+{
+  #pragma omp atomic
+  global_tally_absorption += p.keff_tally_absorption_;
+  #pragma omp atomic
+  global_tally_collision += p.keff_tally_collision_;
+  #pragma omp atomic
+  global_tally_tracklength += p.keff_tally_tracklength_;
+  #pragma omp atomic
+  global_tally_leakage += p.keff_tally_leakage_;
+  p.keff_tally_absorption_  = 0.0;
+  p.keff_tally_collision_   = 0.0;
+  p.keff_tally_tracklength_ = 0.0;
+  p.keff_tally_leakage_     = 0.0;
+
+  flush_surface_source();
+}
+
+//! Transport a particle until it dies or leaves the domain of this process
+//! \return Rank of the process whose domain the particle entered, or -1 if it
+//!   died
+int transport_in_domain(Particle& p)
+{
+  while (true) {
+    int owner = domain_owner(p);
+    if (owner != mpi::rank) {
+      suspend_particle(p);
+      return owner;
+    }
+
+    p.event_calculate_xs();
+    p.event_advance();
+    if (p.collision_distance_ > p.boundary_.distance) {
+      p.event_cross_surface();
+    } else {
+      p.event_collide();
+    }
+    p.event_revive_from_secondary();
+    if (!p.alive_) break;
+  }
+  p.event_death();
+  return -1;
+}
+
+//! Make room in the fission bank for the sites that the given number of
+//! particles may still bank, keeping the sites banked so far. Fission sites
+//! are banked by the process tracking the particle, so a domain can collect
+//! more sites than the histories it started.
+void reserve_fission_bank(int64_t n_particles)
+{
+  if (settings::run_mode != RunMode::EIGENVALUE) return;
+  auto& bank {simulation::fission_bank};
+  int64_t n_sites = bank.size();
+  int64_t needed = n_sites + 3*n_particles;
+  if (bank.capacity() >= needed) return;
+
+  std::vector<Particle::Bank> sites(bank.data(), bank.data() + n_sites);
+  bank.reserve(std::max(needed, 2*bank.capacity()));
+  std::copy(sites.begin(), sites.end(), bank.data());
+  bank.resize(n_sites);
+}
+
+//! Transport particles until they die or leave the domain of this process
+//
+//! \param message Particles received from another process, or nullptr to start
+//!   the histories of this process
+//! \param send Particles leaving the domain, which are appended to the message
+//!   for the process whose domain they entered
+//! \return Number of particles that left the domain
+int64_t transport_particles(const std::vector<char>* message,
+  std::vector<std::vector<char>>& send)
+{
+  std::vector<std::size_t> offsets;
+  if (message) {
+    for (std::size_t k = 0; k < message->size();
+         k += packed_size(&(*message)[k])) {
+      offsets.push_back(k);
+    }
+  }
+  int64_t n_local = message ? offsets.size() : simulation::work_per_rank;
+  reserve_fission_bank(n_local);
+
+  int64_t n_sent = 0;
+  #pragma omp parallel
+  {
+    Particle p;
+    std::vector<std::vector<char>> thread_send(mpi::n_procs);
+    int64_t thread_sent = 0;
+
+    #pragma omp for schedule(dynamic, 64)
+    for (int64_t i = 0; i < n_local; ++i) {
+      if (message) {
+        unpack_particle(&(*message)[offsets[i]], p);
+      } else {
+        initialize_history(p, i + 1);
+      }
+      int owner = transport_in_domain(p);
+      if (owner >= 0) {
+        pack_particle(p, thread_send[owner]);
+        p.secondary_bank_.clear();
+        ++thread_sent;
+      }
+    }
+
+    #pragma omp critical (DomainSend)
+    {
+      for (int j = 0; j < mpi::n_procs; ++j) {
+        send[j].insert(send[j].end(), thread_send[j].begin(),
+          thread_send[j].end());
+      }
+      n_sent += thread_sent;
+    }
+  }
+  return n_sent;
+}
+
+//! Box enclosing a range of bins of the domain mesh. It is infinite along the
+//! dimensions that the mesh does not have, and in all of them for meshes that
+//! are not structured.
+BoundingBox bins_box(int32_t begin, int32_t end)
+{
+  BoundingBox box;
+  const auto* m = dynamic_cast<const StructuredMesh*>(
+    model::meshes[simulation::domain_mesh].get());
+  if (!m) return box;
+
+  std::array<int, 3> lo {INT_MAX, INT_MAX, INT_MAX};
+  std::array<int, 3> hi {0, 0, 0};
+  std::array<int, 3> ijk;
+  for (int32_t bin = begin; bin < end; ++bin) {
+    m->get_indices_from_bin(bin, ijk.data());
+    for (int d = 0; d < m->n_dimension_; ++d) {
+      lo[d] = std::min(lo[d], ijk[d]);
+      hi[d] = std::max(hi[d], ijk[d]);
+    }
+  }
+
+  double* lower[] {&box.xmin, &box.ymin, &box.zmin};
+  double* upper[] {&box.xmax, &box.ymax, &box.zmax};
+  for (int d = 0; d < m->n_dimension_; ++d) {
+    *lower[d] = m->edge(d, lo[d]);
+    *upper[d] = m->edge(d, hi[d] + 1);
+  }
+  return box;
+}
+
+//! Find the materials that particles tracked by this process can be in from
+//! the bounding boxes of the cells of the root universe. Particles outside the
+//! mesh can be tracked by any process, so the materials of the cells that
+//! extend outside it are needed by every process.
+void find_domain_materials()
+{
+  using namespace simulation;
+
+  domain_materials.clear();
+  if (mpi::n_procs == 1) return;
+
+  BoundingBox mesh_box = bins_box(0, domain_bin_start.back());
+  BoundingBox domain_box = bins_box(domain_bin_start[mpi::rank],
+    domain_bin_start[mpi::rank + 1]);
+
+  std::set<int32_t> materials;
+  for (auto i_cell : model::universes[model::root_universe]->cells_) {
+    const Cell& c {*model::cells[i_cell]};
+    BoundingBox b = c.bounding_box();
+    BoundingBox overlap = b & domain_box;
+    bool in_domain = overlap.xmin <= overlap.xmax &&
+      overlap.ymin <= overlap.ymax && overlap.zmin <= overlap.zmax;
+    bool outside_mesh = b.xmin < mesh_box.xmin || b.xmax > mesh_box.xmax ||
+      b.ymin < mesh_box.ymin || b.ymax > mesh_box.ymax ||
+      b.zmin < mesh_box.zmin || b.zmax > mesh_box.zmax;
+    if (in_domain || outside_mesh) fill_materials(c, materials);
+  }
+
+  domain_materials.assign(model::materials.size(), false);
+  for (auto i_mat : materials) {
+    domain_materials[i_mat] = true;
+  }
+}
+
+#ifdef OPENMC_MPI
+//! Send the particles leaving this domain to their owners and transport the
+//! particles entering it. The message from each process is transported as soon
+//! as it arrives, while those from the other processes are still in flight.
+//
+//! \param send Particles sent to each process, which are replaced by those
+//!   leaving the domain again
+//! \param n_sent Number of particles sent, which is replaced by the number
+//!   leaving the domain again
+//! \return Whether any process sent a particle
+bool exchange_particles(std::vector<std::vector<char>>& send, int64_t& n_sent)
+{
+  std::vector<int> send_counts(mpi::n_procs);
+  for (int i = 0; i < mpi::n_procs; ++i) {
+    if (send[i].size() > INT_MAX) {
+      fatal_error("Too many particles are leaving the domain of a process "
+        "at once.");
+    }
+    send_counts[i] = send[i].size();
+  }
+
+  // The sizes of the messages and whether there are any are found together
+  std::vector<int> recv_counts(mpi::n_procs);
+  int64_t n_sent_all;
+  MPI_Request sizes[2];
+  MPI_Ialltoall(send_counts.data(), 1, MPI_INT, recv_counts.data(), 1, MPI_INT,
+    mpi::intracomm, &sizes[0]);
+  MPI_Iallreduce(&n_sent, &n_sent_all, 1, MPI_INT64_T, MPI_SUM,
+    mpi::intracomm, &sizes[1]);
+  MPI_Waitall(2, sizes, MPI_STATUSES_IGNORE);
+  if (n_sent_all == 0) return false;
+
+  std::vector<std::vector<char>> recv(mpi::n_procs);
+  std::vector<MPI_Request> recv_requests;
+  std::vector<int> recv_sources;
+  for (int i = 0; i < mpi::n_procs; ++i) {
+    if (recv_counts[i] > 0) {
+      recv[i].resize(recv_counts[i]);
+      recv_requests.emplace_back();
+      recv_sources.push_back(i);
+      MPI_Irecv(recv[i].data(), recv_counts[i], MPI_BYTE, i, 0,
+        mpi::intracomm, &recv_requests.back());
+    }
+  }
+  std::vector<MPI_Request> send_requests;
+  for (int i = 0; i < mpi::n_procs; ++i) {
+    if (send_counts[i] > 0) {
+      send_requests.emplace_back();
+      MPI_Isend(send[i].data(), send_counts[i], MPI_BYTE, i, 0,
+        mpi::intracomm, &send_requests.back());
+    }
+  }
+
+  std::vector<std::vector<char>> next_send(mpi::n_procs);
+  n_sent = 0;
+  for (std::size_t k = 0; k < recv_requests.size(); ++k) {
+    int index;
+    MPI_Waitany(recv_requests.size(), recv_requests.data(), &index,
+      MPI_STATUS_IGNORE);
+    auto& message {recv[recv_sources[index]]};
+    n_sent += transport_particles(&message, next_send);
+    message = std::vector<char>();
+  }
+  MPI_Waitall(send_requests.size(), send_requests.data(), MPI_STATUSES_IGNORE);
+  send = std::move(next_send);
+  return true;
+}
+#endif
+
+} // namespace
+
+//==============================================================================
+// Non-member functions
+//==============================================================================
+
+void read_domain_mesh(pugi::xml_node root)
+{
+  if (!check_for_node(root, "domain_mesh")) return;
+
+  int mesh_id = std::stoi(get_node_value(root, "domain_mesh"));
+  auto it = model::mesh_map.find(mesh_id);
+  if (it == model::mesh_map.end()) {
+    fatal_error(fmt::format("Mesh {} specified for domain decomposition does "
+      "not exist.", mesh_id));
+  }
+  simulation::domain_mesh = it->second;
+}
+
+void init_domain_decomposition()
+{
+  using namespace simulation;
+
+  if (!domain_decomposed()) return;
+
+  // Histories must be simulated one event at a time by a single process
+  if (settings::event_based) {
+    fatal_error("Domain decomposition cannot be used with event-based "
+      "transport.");
+  }
+  if (settings::dagmc) {
+    fatal_error("Domain decomposition cannot be used with DAGMC geometry.");
+  }
+  if (settings::write_all_tracks || !settings::track_identifiers.empty()) {
+    fatal_error("Particle tracks cannot be written with domain "
+      "decomposition.");
+  }
+  for (const auto& t : model::tallies) {
+    if (t->history_) {
+      fatal_error(fmt::format("Tally {} has history statistics, which cannot "
+        "be used with domain decomposition.", t->id_));
+    }
+  }
+
+  // Divide the bins in contiguous blocks
+  int32_t n_bins = model::meshes[domain_mesh]->n_bins();
+  if (n_bins < mpi::n_procs) {
+    fatal_error(fmt::format("The domain mesh has {} bins, which is fewer than "
+      "the {} processes.", n_bins, mpi::n_procs));
+  }
+  domain_bin_start.resize(mpi::n_procs + 1);
+  for (int i = 0; i <= mpi::n_procs; ++i) {
+    domain_bin_start[i] = static_cast<int64_t>(n_bins)*i / mpi::n_procs;
+  }
+
+  find_domain_materials();
+}
+
+int32_t domain_tally_stride(const Tally& tally)
+{
+  if (!domain_decomposed() || tally.filters().empty()) return 0;
+
+  // Mesh surface filters have bins for the surfaces of the mesh elements
+  const auto* filter = dynamic_cast<const MeshFilter*>(
+    model::tally_filters[tally.filters(0)].get());
+  if (!filter || filter->type() != "mesh" ||
+      filter->mesh() != simulation::domain_mesh) return 0;
+  return tally.strides(0);
+}
+
+int domain_owner(const Particle& p)
+{
+  if (mpi::n_procs == 1) return mpi::rank;
+
+  // A particle on a surface is looked up just past it, so that one crossing a
+  // domain boundary that coincides with the surface is given to the next domain
+  Position r = p.r();
+  if (p.surface_ != 0) r += TINY_BIT*p.u();
+  int bin = model::meshes[simulation::domain_mesh]->get_bin(r);
+  if (bin < 0) return mpi::rank;
+
+  const auto& start {simulation::domain_bin_start};
+  return std::upper_bound(start.begin(), start.end(), bin) - start.begin() - 1;
+}
+
+void transport_domain_decomposed()
+{
+  // The histories of this process are started first, and the particles that
+  // leave the domain are then exchanged until none is left in flight
+  std::vector<std::vector<char>> send(mpi::n_procs);
+  int64_t n_sent = transport_particles(nullptr, send);
+  simulation::n_migrated = n_sent;
+#ifdef OPENMC_MPI
+  while (exchange_particles(send, n_sent)) {
+    simulation::n_migrated += n_sent;
+  }
+#endif
+}
+
+void free_memory_domain_decomposition()
+{
+  simulation::domain_mesh = -1;
+  simulation::domain_bin_start.clear();
+  simulation::domain_materials.clear();
+  simulation::n_migrated = 0;
+}
+
+} // namespace openmc
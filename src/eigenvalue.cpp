@@ -13,6 +13,7 @@
 #include "openmc/math_functions.h"
 #include "openmc/mesh.h"
 #include "openmc/message_passing.h"
+#include "openmc/openmp_interface.h"
 #include "openmc/random_lcg.h"
 #include "openmc/search.h"
 #include "openmc/settings.h"
@@ -20,12 +21,13 @@
 #include "openmc/timer.h"
 #include "openmc/tallies/tally.h"
 
-#include <algorithm> // for min
+#include <algorithm> // for max, min, sort
 #include <array>
 #include <cmath> // for sqrt, abs, pow
 #include <iterator> // for back_inserter
 #include <string>
 #include <limits> //for infinity
+#include <utility> // for move
 
 namespace openmc {
 
@@ -42,36 +44,97 @@ xt::xtensor<double, 1> source_frac;
 
 } // namespace simulation
 
+namespace {
+
+#ifdef OPENMC_MPI
+// Transport time of this process when work was last balanced among processes
+double time_transport_balanced {0.0};
+
+// Pending reductions of the results of a generation
+MPI_Request keff_request {MPI_REQUEST_NULL};
+MPI_Request entropy_request {MPI_REQUEST_NULL};
+double keff_reduced;
+std::vector<double> entropy_local;
+#endif
+
+// Weight of the fission sites in each entropy mesh bin followed by whether any
+// sites were outside of the mesh
+std::vector<double> entropy_counts;
+
+// Number of particles in the generation whose keff is being combined, since the
+// next generation may have more when ramping up the number of particles
+int64_t n_particles_reduced;
+
+} // namespace
+
 //==============================================================================
 // Non-member functions
 //==============================================================================
 
-void calculate_generation_keff()
+void start_generation_reductions()
 {
   const auto& gt = simulation::global_tallies;
 
   // Get keff for this generation by subtracting off the starting value
   simulation::keff_generation = gt(GlobalTally::K_TRACKLENGTH, TallyResult::VALUE) - simulation::keff_generation;
+  n_particles_reduced = simulation::n_particles_batch;
+
+  // Count the fission sites in each entropy mesh bin. The flag indicating
+  // sites outside of the mesh is sent along with the counts so that a single
+  // reduction is needed.
+  if (settings::entropy_on) {
+    bool sites_outside;
+    auto counts = simulation::entropy_mesh->local_site_counts(
+      simulation::fission_bank.data(), simulation::fission_bank.size(),
+      &sites_outside);
+    counts.push_back(sites_outside ? 1.0 : 0.0);
+#ifdef OPENMC_MPI
+    entropy_local = std::move(counts);
+    entropy_counts.resize(entropy_local.size());
+    MPI_Ireduce(entropy_local.data(), entropy_counts.data(),
+      entropy_local.size(), MPI_DOUBLE, MPI_SUM, 0, mpi::intracomm,
+      &entropy_request);
+#else
+    entropy_counts = std::move(counts);
+#endif
+  }
 
-  double keff_reduced;
 #ifdef OPENMC_MPI
   // Combine values across all processors
-  MPI_Allreduce(&simulation::keff_generation, &keff_reduced, 1, MPI_DOUBLE,
-    MPI_SUM, mpi::intracomm);
+  MPI_Iallreduce(&simulation::keff_generation, &keff_reduced, 1, MPI_DOUBLE,
+    MPI_SUM, mpi::intracomm, &keff_request);
+#endif
+}
+
+void calculate_generation_keff()
+{
+#ifdef OPENMC_MPI
+  MPI_Wait(&keff_request, MPI_STATUS_IGNORE);
+  double k = keff_reduced;
 #else
-  keff_reduced = simulation::keff_generation;
+  double k = simulation::keff_generation;
 #endif
 
   // Normalize single batch estimate of k
   // TODO: This should be normalized by total_weight, not by n_particles
-  keff_reduced /= settings::n_particles;
-  simulation::k_generation.push_back(keff_reduced);
+  k /= n_particles_reduced;
+  simulation::k_generation.push_back(k);
 }
 
 void synchronize_bank()
 {
   simulation::time_bank.start();
 
+  // The source of the next batch may have more particles than this one when
+  // ramping up the number of particles over inactive batches
+#ifdef OPENMC_MPI
+  int64_t n_transported = simulation::work_per_rank;
+#endif
+  if (simulation::current_gen == settings::gen_per_batch) {
+    set_batch_particles(simulation::current_batch + 1);
+  }
+  int64_t n_particles = simulation::n_particles_batch;
+
   // In order to properly understand the fission bank algorithm, you need to
   // think of the fission and source bank as being one global array divided
   // over multiple processors. At the start, each processor has a random amount
@@ -122,10 +185,10 @@ void synchronize_bank()
   // and the probability for selecting a site.
 
   int64_t sites_needed;
-  if (total < settings::n_particles) {
-    sites_needed = settings::n_particles % total;
+  if (total < n_particles) {
+    sites_needed = n_particles % total;
   } else {
-    sites_needed = settings::n_particles;
+    sites_needed = n_particles;
   }
   double p_sample = static_cast<double>(sites_needed) / total;
 
@@ -134,69 +197,102 @@ void synchronize_bank()
   // ==========================================================================
   // SAMPLE N_PARTICLES FROM FISSION BANK AND PLACE IN TEMP_SITES
 
-  // Allocate temporary source bank -- we don't really know how many fission
-  // sites were created, so overallocate by a factor of 3
-  int64_t index_temp = 0;
-  std::vector<Particle::Bank> temp_sites(3*simulation::work_per_rank);
-
-  for (int64_t i = 0; i < simulation::fission_bank.size(); i++ ) {
-    const auto& site = simulation::fission_bank[i];
-
-    // If there are less than n_particles particles banked, automatically add
-    // int(n_particles/total) sites to temp_sites. For example, if you need
-    // 1000 and 300 were banked, this would add 3 source sites per banked site
-    // and the remaining 100 would be randomly sampled.
-    if (total < settings::n_particles) {
-      for (int64_t j = 1; j <= settings::n_particles / total; ++j) {
-        temp_sites[index_temp] = site;
-        ++index_temp;
-      }
+  // If there are less than n_particles particles banked, automatically add
+  // int(n_particles/total) sites to temp_sites. For example, if you need
+  // 1000 and 300 were banked, this would add 3 source sites per banked site
+  // and the remaining 100 would be randomly sampled.
+  int64_t n_copies = (total < n_particles) ? n_particles / total : 0;
+
+  // The fission bank is divided into chunks that are sampled by different
+  // threads. Every site draws one random number, so the seed of each chunk is
+  // the seed of the first site skipped ahead by the sites before the chunk and
+  // the sampled sites do not depend on the number of threads. The sites
+  // sampled from each chunk are first counted to find where they are placed in
+  // temp_sites and then sampled again with the same random numbers.
+  int64_t n_sites = simulation::fission_bank.size();
+#ifdef _OPENMP
+  int n_chunks = omp_get_max_threads();
+#else
+  int n_chunks = 1;
+#endif
+  std::vector<int64_t> chunk_start(n_chunks + 1, 0);
+
+  #pragma omp parallel for
+  for (int c = 0; c < n_chunks; ++c) {
+    int64_t i_start = n_sites*c/n_chunks;
+    int64_t i_end = n_sites*(c + 1)/n_chunks;
+    uint64_t chunk_seed = seed;
+    advance_prn_seed(i_start, &chunk_seed);
+    int64_t n_sampled = 0;
+    for (int64_t i = i_start; i < i_end; ++i) {
+      n_sampled += n_copies;
+      if (prn(&chunk_seed) < p_sample) ++n_sampled;
     }
+    chunk_start[c + 1] = n_sampled;
+  }
 
-    // Randomly sample sites needed
-    if (prn(&seed) < p_sample) {
-      temp_sites[index_temp] = site;
-      ++index_temp;
-    }
+  for (int c = 0; c < n_chunks; ++c) {
+    chunk_start[c + 1] += chunk_start[c];
   }
+  int64_t index_temp = chunk_start[n_chunks];
 
-  // At this point, the sampling of source sites is done and now we need to
-  // figure out where to send source sites. Since it is possible that one
-  // processor's share of the source bank spans more than just the immediate
-  // neighboring processors, we have to perform an ALLGATHER to determine the
-  // indices for all processors
+  // Now that the number of sampled sites is known, we need to figure out
+  // where they are placed in the 'global' source bank. Since it is possible
+  // that one processor's share of the source bank spans more than just the
+  // immediate neighboring processors, an exclusive scan is used to determine
+  // the starting index of the sites sampled on each processor.
 
 #ifdef OPENMC_MPI
-  // First do an exclusive scan to get the starting indices for
   start = 0;
   MPI_Exscan(&index_temp, &start, 1, MPI_INT64_T, MPI_SUM, mpi::intracomm);
+  if (mpi::rank == 0) start = 0;
   finish = start + index_temp;
-
-  // Allocate space for bank_position if this hasn't been done yet
-  int64_t bank_position[mpi::n_procs];
-  MPI_Allgather(&start, 1, MPI_INT64_T, bank_position, 1,
-    MPI_INT64_T, mpi::intracomm);
 #else
   start = 0;
   finish = index_temp;
 #endif
 
-  // Now that the sampling is complete, we need to ensure that we have exactly
-  // n_particles source sites. The way this is done in a reproducible manner is
-  // to adjust only the source sites on the last processor.
+  // We need to ensure that we have exactly n_particles source sites. The way
+  // this is done in a reproducible manner is to adjust only the source sites
+  // on the last processor. If there are too few sites, sites from the very
+  // end of the fission bank are repeated.
+  int64_t n_repeat = 0;
+  if (mpi::rank == mpi::n_procs - 1 && finish < n_particles) {
+    n_repeat = n_particles - finish;
+  }
+
+  // Size the resampling bank to hold exactly the sampled sites
+  Particle::Bank* temp_sites = reserve_temp_sites(index_temp + n_repeat);
+
+  #pragma omp parallel for
+  for (int c = 0; c < n_chunks; ++c) {
+    int64_t i_start = n_sites*c/n_chunks;
+    int64_t i_end = n_sites*(c + 1)/n_chunks;
+    uint64_t chunk_seed = seed;
+    advance_prn_seed(i_start, &chunk_seed);
+    int64_t index = chunk_start[c];
+    for (int64_t i = i_start; i < i_end; ++i) {
+      const auto& site = simulation::fission_bank[i];
+      for (int64_t j = 0; j < n_copies; ++j) {
+        temp_sites[index++] = site;
+      }
+
+      // Randomly sample sites needed
+      if (prn(&chunk_seed) < p_sample) {
+        temp_sites[index++] = site;
+      }
+    }
+  }
 
   if (mpi::rank == mpi::n_procs - 1) {
-    if (finish > settings::n_particles) {
+    if (finish > n_particles) {
       // If we have extra sites sampled, we will simply discard the extra
       // ones on the last processor
-      index_temp = settings::n_particles - start;
-
-    } else if (finish < settings::n_particles) {
-      // If we have too few sites, repeat sites from the very end of the
-      // fission bank
-      sites_needed = settings::n_particles - finish;
-      for (int i = 0; i < sites_needed; ++i) {
-        int i_bank = simulation::fission_bank.size() - sites_needed + i;
+      index_temp = n_particles - start;
+
+    } else if (n_repeat > 0) {
+      for (int64_t i = 0; i < n_repeat; ++i) {
+        int64_t i_bank = simulation::fission_bank.size() - n_repeat + i;
         temp_sites[index_temp] = simulation::fission_bank[i_bank];
         ++index_temp;
       }
@@ -210,13 +306,48 @@ void synchronize_bank()
   simulation::time_bank_sendrecv.start();
 
 #ifdef OPENMC_MPI
+  // At the end of each batch, the particles of the next generation may be
+  // redistributed among processes in proportion to the rate at which each one
+  // transported particles during the batch
+  if (settings::load_balance &&
+      simulation::current_gen == settings::gen_per_batch) {
+    double time = simulation::time_transport.elapsed();
+    if (time < time_transport_balanced) time_transport_balanced = 0.0;
+    double rate = settings::gen_per_batch*n_transported /
+      (time - time_transport_balanced);
+    time_transport_balanced = time;
+    balance_work(rate);
+  }
+
+  // Find the processes whose sampled sites can be read directly: this process
+  // and, when the resampling bank is shared, all processes on the same node
+  int64_t position = start;
+  std::vector<int> local_ranks {mpi::rank};
+  std::vector<int64_t> local_sites {position, index_temp};
+  if (settings::shared_bank) {
+    int n_node;
+    MPI_Comm_size(mpi::node_comm, &n_node);
+    local_ranks.resize(n_node);
+    MPI_Allgather(&mpi::rank, 1, MPI_INT, local_ranks.data(), 1, MPI_INT,
+      mpi::node_comm);
+    int64_t sites[] {position, index_temp};
+    local_sites.resize(2*n_node);
+    MPI_Allgather(sites, 2, MPI_INT64_T, local_sites.data(), 2, MPI_INT64_T,
+      mpi::node_comm);
+    sync_temp_sites();
+  }
+  auto is_local = [&](int rank) {
+    return std::find(local_ranks.begin(), local_ranks.end(), rank) !=
+      local_ranks.end();
+  };
+
   // ==========================================================================
   // SEND BANK SITES TO NEIGHBORS
 
   int64_t index_local = 0;
   std::vector<MPI_Request> requests;
 
-  if (start < settings::n_particles) {
+  if (start < n_particles) {
     // Determine the index of the processor which has the first part of the
     // source_bank for the local processor
     int neighbor = upper_bound_index(simulation::work_index.begin(),
@@ -227,8 +358,8 @@ void synchronize_bank()
       int64_t n = std::min(simulation::work_index[neighbor + 1], finish) - start;
 
       // Initiate an asynchronous send of source sites to the neighboring
-      // process
-      if (neighbor != mpi::rank) {
+      // process unless it can read them directly
+      if (!is_local(neighbor) && n > 0) {
         requests.emplace_back();
         MPI_Isend(&temp_sites[index_local], static_cast<int>(n), mpi::bank,
           neighbor, mpi::rank, mpi::intracomm, &requests.back());
@@ -249,49 +380,60 @@ void synchronize_bank()
   // ==========================================================================
   // RECEIVE BANK SITES FROM NEIGHBORS OR TEMPORARY BANK
 
-  start = simulation::work_index[mpi::rank];
-  index_local = 0;
-
-  // Determine what process has the source sites that will need to be stored at
-  // the beginning of this processor's source bank.
-
-  int neighbor;
-  if (start >= bank_position[mpi::n_procs - 1]) {
-    neighbor = mpi::n_procs - 1;
-  } else {
-    neighbor = upper_bound_index(bank_position, bank_position + mpi::n_procs, start);
+  // Sites that belong to the source bank of this process come either from a
+  // process whose sampled sites can be read directly or in a message
+  struct SiteBlock {
+    int rank;                       //!< process that sampled the sites
+    int64_t n;                      //!< number of sites
+    const Particle::Bank* sites;    //!< sites that can be read directly
+    MPI_Message message;            //!< message holding the sites otherwise
+  };
+  std::vector<SiteBlock> blocks;
+
+  int64_t work_start = simulation::work_index[mpi::rank];
+  int64_t work_end = simulation::work_index[mpi::rank + 1];
+  int64_t n_remote = work_end - work_start;
+  for (int i = 0; i < static_cast<int>(local_ranks.size()); ++i) {
+    int64_t lo = std::max(local_sites[2*i], work_start);
+    int64_t hi = std::min(local_sites[2*i] + local_sites[2*i + 1], work_end);
+    if (hi <= lo) continue;
+    const Particle::Bank* sites = (local_ranks[i] == mpi::rank) ?
+      temp_sites : node_temp_sites(i);
+    blocks.push_back({local_ranks[i], hi - lo, sites + (lo - local_sites[2*i]),
+      MPI_MESSAGE_NULL});
+    n_remote -= hi - lo;
   }
 
-  while (start < simulation::work_index[mpi::rank + 1]) {
-    // Determine how many sites need to be received
-    int64_t n;
-    if (neighbor == mpi::n_procs - 1) {
-      n = simulation::work_index[mpi::rank + 1] - start;
-    } else {
-      n = std::min(bank_position[neighbor + 1], simulation::work_index[mpi::rank + 1]) - start;
-    }
-
-    if (neighbor != mpi::rank) {
-      // If the source sites are not on this processor, initiate an
-      // asynchronous receive for the source sites
-
-      requests.emplace_back();
-      MPI_Irecv(&simulation::source_bank[index_local], static_cast<int>(n), mpi::bank,
-            neighbor, neighbor, mpi::intracomm, &requests.back());
+  // The remaining sites come from the processes whose sampled sites overlap
+  // the range of this process's source bank. Rather than gathering the
+  // position of every process's sites, the messages are matched as they
+  // arrive. Sites from processes with a lower rank precede those of
+  // processes with a higher rank, so once all messages have been matched
+  // their offsets follow from ordering all blocks by rank.
+  while (n_remote > 0) {
+    MPI_Message message;
+    MPI_Status status;
+    MPI_Mprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, mpi::intracomm, &message, &status);
+    int count;
+    MPI_Get_count(&status, mpi::bank, &count);
+    blocks.push_back({status.MPI_SOURCE, count, nullptr, message});
+    n_remote -= count;
+  }
 
-    } else {
-      // If the source sites are on this procesor, we can simply copy them
-      // from the temp_sites bank
+  std::sort(blocks.begin(), blocks.end(),
+    [](const SiteBlock& a, const SiteBlock& b) { return a.rank < b.rank; });
 
-      index_temp = start - bank_position[mpi::rank];
-      std::copy(&temp_sites[index_temp], &temp_sites[index_temp + n],
+  index_local = 0;
+  for (auto& block : blocks) {
+    if (block.sites) {
+      std::copy(block.sites, block.sites + block.n,
         &simulation::source_bank[index_local]);
+    } else {
+      requests.emplace_back();
+      MPI_Imrecv(&simulation::source_bank[index_local],
+        static_cast<int>(block.n), mpi::bank, &block.message, &requests.back());
     }
-
-    // Increment all indices
-    start += n;
-    index_local += n;
-    ++neighbor;
+    index_local += block.n;
   }
 
   // Since we initiated a series of asynchronous ISENDs and IRECVs, now we have
@@ -301,12 +443,20 @@ void synchronize_bank()
   int n_request = requests.size();
   MPI_Waitall(n_request, requests.data(), MPI_STATUSES_IGNORE);
 
+  // Make sure that no process on the node overwrites its sampled sites before
+  // the others have copied them
+  if (settings::shared_bank) sync_temp_sites();
+
 #else
-  std::copy(temp_sites.data(), temp_sites.data() + settings::n_particles,
+  std::copy(temp_sites, temp_sites + n_particles,
     simulation::source_bank.begin());
 #endif
 
   simulation::time_bank_sendrecv.stop();
+
+  // Start histories that are close to each other one after another
+  if (settings::source_sort) sort_source_bank();
+
   simulation::time_bank.stop();
 }
 
@@ -505,19 +655,22 @@ int openmc_get_keff(double* k_combined)
 
 void shannon_entropy()
 {
-  // Get source weight in each mesh bin
-  bool sites_outside;
-  xt::xtensor<double, 1> p = simulation::entropy_mesh->count_sites(
-    simulation::fission_bank.data(), simulation::fission_bank.size(),
-    &sites_outside);
-
-  // display warning message if there were sites outside entropy box
-  if (sites_outside) {
-    if (mpi::master) warning("Fission source site(s) outside of entropy box.");
-  }
+  // Get source weight in each mesh bin, which was reduced on the master
+#ifdef OPENMC_MPI
+  MPI_Wait(&entropy_request, MPI_STATUS_IGNORE);
+#endif
 
   if (mpi::master) {
+    // display warning message if there were sites outside entropy box
+    bool sites_outside = entropy_counts.back() > 0.0;
+    if (sites_outside) {
+      warning("Fission source site(s) outside of entropy box.");
+    }
+
     // Normalize to total weight of bank sites
+    std::size_t n = entropy_counts.size() - 1;
+    xt::xtensor<double, 1> p = xt::zeros<double>({n});
+    std::copy(entropy_counts.begin(), entropy_counts.begin() + n, p.begin());
     p /= xt::sum(p);
 
     // Sum values to obtain Shannon entropy
@@ -547,19 +700,28 @@ void ufs_count_sites()
   } else {
     // count number of source sites in each ufs mesh cell
     bool sites_outside;
-    simulation::source_frac = simulation::ufs_mesh->count_sites(
-      simulation::source_bank.data(), simulation::source_bank.size(), &sites_outside);
+    auto counts = simulation::ufs_mesh->local_site_counts(
+      simulation::source_bank.data(), simulation::source_bank.size(),
+      &sites_outside);
+
+#ifdef OPENMC_MPI
+    // Combine the counts from all processors on every processor. The flag
+    // indicating sites outside of the mesh is sent along with the counts so
+    // that a single collective is needed.
+    counts.push_back(sites_outside ? 1.0 : 0.0);
+    MPI_Allreduce(MPI_IN_PLACE, counts.data(), counts.size(), MPI_DOUBLE,
+      MPI_SUM, mpi::intracomm);
+    sites_outside = counts.back() > 0.0;
+    counts.pop_back();
+#endif
 
     // Check for sites outside of the mesh
     if (mpi::master && sites_outside) {
       fatal_error("Source sites outside of the UFS mesh!");
     }
 
-#ifdef OPENMC_MPI
-    // Send source fraction to all processors
-    int n_bins = xt::prod(simulation::ufs_mesh->shape_)();
-    MPI_Bcast(simulation::source_frac.data(), n_bins, MPI_DOUBLE, 0, mpi::intracomm);
-#endif
+    simulation::source_frac = xt::zeros<double>({counts.size()});
+    std::copy(counts.begin(), counts.end(), simulation::source_frac.begin());
 
     // Normalize to total weight to get fraction of source in each cell
     double total = xt::sum(simulation::source_frac)();
@@ -568,7 +730,7 @@ void ufs_count_sites()
     // Since the total starting weight is not equal to n_particles, we need to
     // renormalize the weight of the source sites
     for (int i = 0; i < simulation::work_per_rank; ++i) {
-      simulation::source_bank[i].wgt *= settings::n_particles / total;
+      simulation::source_bank[i].wgt *= simulation::n_particles_batch / total;
     }
   }
 }
@@ -1,6 +1,6 @@
 #include "openmc/endf.h"
 
-#include <algorithm> // for copy
+#include <algorithm> // for copy, all_of, equal
 #include <array>
 #include <cmath>     // for log, exp
 #include <iterator>  // for back_inserter
@@ -208,6 +208,12 @@ double Tabulated1D::operator()(double x) const
   }
 }
 
+bool Tabulated1D::linear() const
+{
+  return n_pairs_ >= 2 && std::all_of(int_.begin(), int_.end(),
+    [](Interpolation i) { return i == Interpolation::lin_lin; });
+}
+
 //==============================================================================
 // CoherentElasticXS implementation
 //==============================================================================
@@ -258,4 +264,31 @@ double IncoherentElasticXS::operator()(double E) const
   return bound_xs_ / 2.0 * ((1 - std::exp(-4.0*E*W))/(2.0*E*W));
 }
 
+//==============================================================================
+// InlineFunction1D implementation
+//==============================================================================
+
+InlineFunction1D::InlineFunction1D(const Function1D* f)
+  : f_{f}
+{
+  if (auto poly = dynamic_cast<const Polynomial*>(f)) {
+    type_ = Type::polynomial;
+    y_ = poly->coef().data();
+    n_ = poly->coef().size();
+  } else if (auto table = dynamic_cast<const Tabulated1D*>(f)) {
+    if (table->linear()) {
+      type_ = Type::linear;
+      x_ = table->x().data();
+      y_ = table->y().data();
+      n_ = table->x().size();
+    }
+  }
+}
+
+bool InlineFunction1D::same_grid(const InlineFunction1D& other) const
+{
+  return this->linear() && other.linear() && n_ == other.n_ &&
+    std::equal(x_, x_ + n_, other.x_);
+}
+
 } // namespace openmc
@@ -1,6 +1,19 @@
 #include "openmc/event.h"
+
+#include <algorithm> // for copy, min, max
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "openmc/cell.h"
+#include "openmc/delta_tracking.h"
+#include "openmc/geometry.h"
+#include "openmc/geometry_flat.h"
+#include "openmc/instrument.h"
 #include "openmc/material.h"
+#include "openmc/settings.h"
 #include "openmc/simulation.h"
+#include "openmc/sort.h"
 #include "openmc/timer.h"
 
 namespace openmc {
@@ -19,8 +32,89 @@ SharedArray<EventQueueItem> collision_queue;
 
 std::vector<Particle>  particles;
 
+EventKernelStats stats_event_init;
+EventKernelStats stats_event_calculate_xs;
+EventKernelStats stats_event_advance_particle;
+EventKernelStats stats_event_surface_crossing;
+EventKernelStats stats_event_collision;
+EventKernelStats stats_event_death;
+
 } // namespace simulation
 
+//==============================================================================
+// EventQueueItem implementation
+//==============================================================================
+
+EventQueueItem::EventQueueItem(const Particle& p, int64_t buffer_idx) :
+  idx(buffer_idx), type(p.type_), material(p.material_), E(p.E_)
+{
+  // Use the material class as the sort key when one has been assigned. In
+  // multigroup mode materials are never assigned a class, in which case the
+  // material index itself is used.
+  if (p.material_ != MATERIAL_VOID) {
+    int32_t mat_class = model::materials[p.material_]->material_class();
+    if (mat_class != C_NONE) material = mat_class;
+  }
+}
+
+//==============================================================================
+// EventQueueBuffer implementation
+//==============================================================================
+
+EventQueueBuffer::EventQueueBuffer(SharedArray<EventQueueItem>& queue) :
+  queue_(queue), length_(settings::event_local_queue_length)
+{
+  if (length_ > 0) items_.reserve(length_);
+}
+
+void EventQueueBuffer::push(const EventQueueItem& item)
+{
+  if (length_ <= 0) {
+    queue_.thread_safe_append(item);
+    return;
+  }
+
+  items_.push_back(item);
+  if (static_cast<int64_t>(items_.size()) >= length_) this->flush();
+}
+
+void EventQueueBuffer::flush()
+{
+  if (items_.empty()) return;
+  queue_.thread_safe_append(items_.data(), items_.size());
+  items_.clear();
+}
+
+//==============================================================================
+// EventKernelStats implementation
+//==============================================================================
+
+void EventKernelStats::record(int64_t queue_length)
+{
+  if (n_invocations == 0 || queue_length < min_queue_length) {
+    min_queue_length = queue_length;
+  }
+  max_queue_length = std::max(max_queue_length, queue_length);
+  n_particles += queue_length;
+  ++n_invocations;
+}
+
+void EventKernelStats::reset()
+{
+  *this = EventKernelStats {};
+}
+
+double EventKernelStats::mean_queue_length() const
+{
+  return n_invocations > 0 ?
+    static_cast<double>(n_particles) / n_invocations : 0.0;
+}
+
+double EventKernelStats::particle_rate(double seconds) const
+{
+  return seconds > 0.0 ? n_particles / seconds : 0.0;
+}
+
 //==============================================================================
 // Non-member functions
 //==============================================================================
@@ -47,6 +141,47 @@ void free_event_queues(void)
   simulation::particles.clear();
 }
 
+double particle_buffer_bytes()
+{
+  // A particle and its slot in each of the five event queues
+  return sizeof(Particle) + 5*sizeof(EventQueueItem);
+}
+
+void reset_event_kernel_stats()
+{
+  simulation::stats_event_init.reset();
+  simulation::stats_event_calculate_xs.reset();
+  simulation::stats_event_advance_particle.reset();
+  simulation::stats_event_surface_crossing.reset();
+  simulation::stats_event_collision.reset();
+  simulation::stats_event_death.reset();
+}
+
+namespace {
+
+// Index (one-based, relative to this rank's source work) of the last source
+// particle whose history has been started in the event-based buffer
+int64_t last_source_index {0};
+
+// Claims the next unstarted source particle, returning its one-based index or
+// zero if all work for this rank has already been started
+int64_t claim_source_index()
+{
+  int64_t index;
+  #pragma omp atomic capture
+  index = ++last_source_index;
+  return (index <= simulation::work_per_rank) ? index : 0;
+}
+
+} // namespace
+
+void refill_particle(Particle& p)
+{
+  p.event_death();
+  int64_t index = claim_source_index();
+  if (index > 0) initialize_history(p, index);
+}
+
 void dispatch_xs_event(int64_t buffer_idx)
 {
   Particle& p = simulation::particles[buffer_idx];
@@ -57,33 +192,288 @@ void dispatch_xs_event(int64_t buffer_idx)
   }
 }
 
+void dispatch_xs_event(int64_t buffer_idx, EventQueueBuffer& fuel,
+  EventQueueBuffer& nonfuel)
+{
+  Particle& p = simulation::particles[buffer_idx];
+  if (p.material_ == MATERIAL_VOID || !model::materials[p.material_]->fissionable_) {
+    nonfuel.push({p, buffer_idx});
+  } else {
+    fuel.push({p, buffer_idx});
+  }
+}
+
 void process_init_events(int64_t n_particles, int64_t source_offset)
 {
   simulation::time_event_init.start();
-  #pragma omp parallel for schedule(runtime)
-  for (int64_t i = 0; i < n_particles; i++) {
-    initialize_history(simulation::particles[i], source_offset + i + 1);
-    dispatch_xs_event(i);
+  simulation::stats_event_init.record(n_particles);
+  #pragma omp parallel
+  {
+    InstrumentRegion region {Region::EVENT_INIT};
+    EventQueueBuffer fuel {simulation::calculate_fuel_xs_queue};
+    EventQueueBuffer nonfuel {simulation::calculate_nonfuel_xs_queue};
+
+    #pragma omp for schedule(runtime)
+    for (int64_t i = 0; i < n_particles; i++) {
+      initialize_history(simulation::particles[i], source_offset + i + 1);
+      dispatch_xs_event(i, fuel, nonfuel);
+    }
   }
+  last_source_index = source_offset + n_particles;
   simulation::time_event_init.stop();
 }
 
-void process_calculate_xs_events(SharedArray<EventQueueItem>& queue)
+namespace {
+
+//==============================================================================
+// Batched boundary distances
+//==============================================================================
+
+//! Compute the distance to the boundary of the lowest-level cell for a block of
+//! queued particles
+//
+//! Runs of consecutive particles that are in the same CSG cell, which are
+//! common because queues are ordered by material, are evaluated together in a
+//! single batch. Particles that are alone in their cell are left to the usual
+//! per-particle calculation.
+//
+//! \param queue Queue of particles
+//! \param begin Index in the queue of the first particle in the block
+//! \param end Index in the queue one past the last particle in the block
+//! \param[out] dist Distance to and signed index of the oncoming surface
+//! \param[out] known Whether the distance was computed for each particle
+void batch_cell_distances(SharedArray<EventQueueItem>& queue,
+  int64_t begin, int64_t end, std::pair<double, int32_t>* dist, bool* known)
 {
-  simulation::time_event_calculate_xs.start();
+  RayBatch rays;
+  double d[RayBatch::SIZE];
+  int32_t i_surf[RayBatch::SIZE];
+
+  // Particles whose boundary is still known from before their last collision
+  // are left out
+  auto lowest_cell = [&](int64_t i) {
+    const Particle& p = simulation::particles[queue[i].idx];
+    return p.boundary_cached_ ? C_NONE : p.coord_[p.n_coord_ - 1].cell;
+  };
+
+  int64_t i = begin;
+  while (i < end) {
+    // Find the run of particles in the same cell
+    int32_t i_cell = lowest_cell(i);
+    int64_t j = i + 1;
+    while (j < end && lowest_cell(j) == i_cell) ++j;
+
+    const auto* c = (i_cell == C_NONE) ? nullptr :
+      dynamic_cast<const CSGCell*>(model::cells[i_cell].get());
+    if (c && j - i > 1) {
+      rays.n = j - i;
+      for (int k = 0; k < rays.n; ++k) {
+        const Particle& p = simulation::particles[queue[i + k].idx];
+        const auto& coord {p.coord_[p.n_coord_ - 1]};
+        rays.x[k] = coord.r.x;
+        rays.y[k] = coord.r.y;
+        rays.z[k] = coord.r.z;
+        rays.u[k] = coord.u.x;
+        rays.v[k] = coord.u.y;
+        rays.w[k] = coord.u.z;
+        rays.on_surface[k] = p.surface_;
+      }
+      c->distance(rays, d, i_surf);
+      for (int k = 0; k < rays.n; ++k) {
+        dist[i - begin + k] = {d[k], i_surf[k]};
+        known[i - begin + k] = true;
+      }
+    } else {
+      for (int64_t k = i; k < j; ++k) known[k - begin] = false;
+    }
+    i = j;
+  }
+}
+
+#ifdef OPENMC_OFFLOAD
+
+//==============================================================================
+// Offloaded boundary distances
+//==============================================================================
+
+namespace {
+
+// Staging buffers for the particle states sent to the offload device, shared
+// by the threads of the team
+std::vector<LocalCoord> offload_coord;
+std::vector<int> offload_n_coord;
+std::vector<int32_t> offload_surface;
+std::vector<BoundaryInfo> offload_info;
+std::vector<uint8_t> offload_lost;
+
+} // namespace
+
+//! Find the nearest boundaries of the particles in a queue on the offload
+//! device and leave them in the particles as if they were cached
+//
+//! Particles whose boundary is already cached are left out. Must be
+//! encountered by every thread of the team.
+//
+//! \param queue Queue of particles
+void offload_boundary_distances(SharedArray<EventQueueItem>& queue)
+{
+  int64_t n = queue.size();
+  int n_levels = model::n_coord_levels;
+
+  #pragma omp single
+  {
+    offload_coord.resize(n * n_levels);
+    offload_n_coord.resize(n);
+    offload_surface.resize(n);
+    offload_info.resize(n);
+    offload_lost.resize(n);
+  }
 
-  // TODO: If using C++17, perform a parallel sort of the queue
-  // by particle type, material type, and then energy, in order to
-  // improve cache locality and reduce thread divergence on GPU. Prior
-  // to C++17, std::sort is a serial only operation, which in this case
-  // makes it too slow to be practical for most test problems.
-  //
-  // std::sort(std::execution::par_unseq, queue.data(), queue.data() + queue.size());
+  // Gather the coordinates of the particles. Cached particles are sent with
+  // no levels, which the device skips over.
+  #pragma omp for schedule(static)
+  for (int64_t i = 0; i < n; i++) {
+    const Particle& p = simulation::particles[queue[i].idx];
+    std::copy(p.coord_.begin(), p.coord_.begin() + p.n_coord_,
+      offload_coord.begin() + i * n_levels);
+    offload_n_coord[i] = p.boundary_cached_ ? 0 : p.n_coord_;
+    offload_surface[i] = p.surface_;
+  }
+
+  #pragma omp single
+  device_distance_to_boundary(n, n_levels, offload_coord.data(),
+    offload_n_coord.data(), offload_surface.data(), offload_info.data(),
+    offload_lost.data());
+
+  #pragma omp for schedule(static)
+  for (int64_t i = 0; i < n; i++) {
+    if (offload_n_coord[i] == 0) continue;
+    Particle& p = simulation::particles[queue[i].idx];
+    p.boundary_ = offload_info[i];
+    p.boundary_cached_ = true;
+    if (offload_lost[i]) {
+      p.mark_as_lost(fmt::format(
+        "Particle {} had a negative distance to a lattice boundary", p.id_));
+    }
+  }
+}
+
+#endif // OPENMC_OFFLOAD
+
+//! Advance every particle in a queue, distributing the work over the threads
+//! of the team without a barrier at the end
+//
+//! \param queue Queue of particles to advance
+//! \param after Function called with the buffer index and particle once it has
+//!   been advanced
+template<class F>
+void advance_queue(SharedArray<EventQueueItem>& queue, F after)
+{
+#ifdef OPENMC_OFFLOAD
+  // The boundaries of particles that may be delta tracked are not needed
+  if (model::device_flat_geometry.complete() && !settings::delta_tracking &&
+      model::delta_tracking_cells.empty()) {
+    offload_boundary_distances(queue);
+  }
+#endif
+
+  // Cell boundaries are never needed when delta tracking throughout the
+  // geometry
+  if (!settings::event_batch_distance || settings::delta_tracking) {
+    #pragma omp for schedule(runtime) nowait
+    for (int64_t i = 0; i < queue.size(); i++) {
+      int64_t buffer_idx = queue[i].idx;
+      Particle& p = simulation::particles[buffer_idx];
+      p.event_advance();
+      after(buffer_idx, p);
+    }
+    return;
+  }
+
+  // Advance particles in blocks so that distances to the boundaries of their
+  // cells can be computed in batches
+  int64_t n_blocks = (queue.size() + RayBatch::SIZE - 1) / RayBatch::SIZE;
+  #pragma omp for schedule(runtime) nowait
+  for (int64_t b = 0; b < n_blocks; b++) {
+    int64_t begin = b * RayBatch::SIZE;
+    int64_t end = std::min<int64_t>(begin + RayBatch::SIZE, queue.size());
+    std::pair<double, int32_t> dist[RayBatch::SIZE];
+    bool known[RayBatch::SIZE];
+    batch_cell_distances(queue, begin, end, dist, known);
+
+    for (int64_t i = begin; i < end; i++) {
+      int64_t buffer_idx = queue[i].idx;
+      Particle& p = simulation::particles[buffer_idx];
+      p.event_advance(known[i - begin] ? &dist[i - begin] : nullptr);
+      after(buffer_idx, p);
+    }
+  }
+}
+
+//==============================================================================
+// Prefetching
+//==============================================================================
+
+//! Prefetch the nuclide data for the cross section lookup of a queued particle
+//
+//! \param queue Queue of particles
+//! \param i Index in the queue, which may be past its end
+//! \param rows Whether to prefetch the energy grids and cross sections rather
+//!   than the search data
+void prefetch_calculate_xs(SharedArray<EventQueueItem>& queue,
+  int64_t i, bool rows)
+{
+  if (i >= queue.size() || queue[i].type != Particle::Type::neutron) return;
+  const Particle& p = simulation::particles[queue[i].idx];
+  if (p.material_ == MATERIAL_VOID) return;
+  model::materials[p.material_]->prefetch_neutron_xs(p.E_, p.sqrtkT_, rows);
+}
+
+//==============================================================================
+// Team kernels
+//
+// Each of these must be encountered by every thread of the enclosing parallel
+// region. Bookkeeping on the shared queues is done by a single thread and every
+// kernel ends with a barrier, so that the queues are consistent when it
+// returns. This allows a sequence of kernels to run inside one persistent
+// parallel region (see process_events()) as well as each in its own region.
+//==============================================================================
+
+void calculate_xs_kernel(SharedArray<EventQueueItem>& queue)
+{
+  InstrumentRegion region {Region::EVENT_CALCULATE_XS};
+
+  #pragma omp master
+  {
+    simulation::time_event_calculate_xs.start();
+    simulation::stats_event_calculate_xs.record(queue.size());
+  }
+
+  // If requested, sort the queue by particle type, material, and then energy
+  // so that consecutive lookups hit the same nuclide energy grids, improving
+  // cache locality. For short queues the cost of sorting outweighs any
+  // benefit, so sorting only happens above a user-specified length.
+  if (settings::event_queue_sort &&
+      queue.size() >= settings::event_queue_sort_threshold) {
+    #pragma omp single
+    team_parallel_sort(queue.data(), queue.data() + queue.size());
+  }
 
-  int64_t offset = simulation::advance_particle_queue.size();;
+  int64_t offset = simulation::advance_particle_queue.size();
 
-  #pragma omp parallel for schedule(runtime)
+  // The lookups of the particles further down the queue are known already, so
+  // their nuclide data can be requested ahead of time. The search data is
+  // prefetched a full distance ahead and, once it has arrived, the energy
+  // grids and cross sections it points to half a distance ahead.
+  int64_t distance = settings::event_prefetch_distance;
+
+  #pragma omp for schedule(runtime)
   for (int64_t i = 0; i < queue.size(); i++) {
+    if (distance > 0) {
+      prefetch_calculate_xs(queue, i + distance, false);
+      prefetch_calculate_xs(queue, i + std::max<int64_t>(distance/2, 1), true);
+    }
+
     Particle* p = &simulation::particles[queue[i].idx];
     p->event_calculate_xs();
 
@@ -93,81 +483,395 @@ void process_calculate_xs_events(SharedArray<EventQueueItem>& queue)
     simulation::advance_particle_queue[offset + i] = queue[i];
   }
 
-  simulation::advance_particle_queue.resize(offset + queue.size());
-
-  queue.resize(0);
+  #pragma omp single
+  {
+    simulation::advance_particle_queue.resize(offset + queue.size());
+    queue.resize(0);
+  }
 
+  #pragma omp master
   simulation::time_event_calculate_xs.stop();
 }
 
-void process_advance_particle_events()
+void advance_particle_kernel()
 {
-  simulation::time_event_advance_particle.start();
+  InstrumentRegion region {Region::EVENT_ADVANCE};
+  auto& queue {simulation::advance_particle_queue};
 
-  #pragma omp parallel for schedule(runtime)
-  for (int64_t i = 0; i < simulation::advance_particle_queue.size(); i++) {
-    int64_t buffer_idx = simulation::advance_particle_queue[i].idx;
-    Particle& p = simulation::particles[buffer_idx];
-    p.event_advance();
-    if (p.collision_distance_ > p.boundary_.distance) {
-      simulation::surface_crossing_queue.thread_safe_append({p, buffer_idx});
-    } else {
-      simulation::collision_queue.thread_safe_append({p, buffer_idx});
-    }
+  #pragma omp master
+  {
+    simulation::time_event_advance_particle.start();
+    simulation::stats_event_advance_particle.record(queue.size());
+  }
+
+  if (settings::event_fuse_advance) {
+    // If requested, the surface crossing or collision is executed right away
+    // by the same thread so that particles only have to be enqueued for their
+    // next cross section lookup
+    EventQueueBuffer fuel {simulation::calculate_fuel_xs_queue};
+    EventQueueBuffer nonfuel {simulation::calculate_nonfuel_xs_queue};
+
+    advance_queue(queue, [&](int64_t buffer_idx, Particle& p) {
+      if (p.collision_distance_ > p.boundary_.distance) {
+        p.event_cross_surface();
+      } else {
+        p.event_collide();
+      }
+      p.event_revive_from_secondary();
+      if (!p.alive_ && settings::event_refill) refill_particle(p);
+      if (p.alive_)
+        dispatch_xs_event(buffer_idx, fuel, nonfuel);
+    });
+
+    fuel.flush();
+    nonfuel.flush();
+  } else {
+    // Otherwise, the particle is enqueued for its next event as soon as it has
+    // been advanced
+    EventQueueBuffer surface {simulation::surface_crossing_queue};
+    EventQueueBuffer collision {simulation::collision_queue};
+
+    advance_queue(queue, [&](int64_t buffer_idx, Particle& p) {
+      if (p.collision_distance_ > p.boundary_.distance) {
+        surface.push({p, buffer_idx});
+      } else {
+        collision.push({p, buffer_idx});
+      }
+    });
+
+    surface.flush();
+    collision.flush();
   }
 
-  simulation::advance_particle_queue.resize(0);
+  // Wait until all threads have flushed their staging buffers
+  #pragma omp barrier
+
+  #pragma omp single
+  queue.resize(0);
 
+  #pragma omp master
   simulation::time_event_advance_particle.stop();
 }
 
-void process_surface_crossing_events()
+void surface_crossing_kernel()
 {
-  simulation::time_event_surface_crossing.start();
+  InstrumentRegion region {Region::EVENT_SURFACE_CROSSING};
+  auto& queue {simulation::surface_crossing_queue};
+
+  #pragma omp master
+  {
+    simulation::time_event_surface_crossing.start();
+    simulation::stats_event_surface_crossing.record(queue.size());
+  }
+
+  EventQueueBuffer fuel {simulation::calculate_fuel_xs_queue};
+  EventQueueBuffer nonfuel {simulation::calculate_nonfuel_xs_queue};
 
-  #pragma omp parallel for schedule(runtime)
-  for (int64_t i = 0; i < simulation::surface_crossing_queue.size(); i++) {
-    int64_t buffer_idx = simulation::surface_crossing_queue[i].idx;
+  #pragma omp for schedule(runtime) nowait
+  for (int64_t i = 0; i < queue.size(); i++) {
+    int64_t buffer_idx = queue[i].idx;
     Particle& p = simulation::particles[buffer_idx];
     p.event_cross_surface();
     p.event_revive_from_secondary();
+    if (!p.alive_ && settings::event_refill) refill_particle(p);
     if (p.alive_)
-      dispatch_xs_event(buffer_idx);
+      dispatch_xs_event(buffer_idx, fuel, nonfuel);
   }
 
-  simulation::surface_crossing_queue.resize(0);
+  fuel.flush();
+  nonfuel.flush();
+  #pragma omp barrier
+
+  #pragma omp single
+  queue.resize(0);
 
+  #pragma omp master
   simulation::time_event_surface_crossing.stop();
 }
 
-void process_collision_events()
+void collision_kernel()
 {
-  simulation::time_event_collision.start();
+  InstrumentRegion region {Region::EVENT_COLLISION};
+  auto& queue {simulation::collision_queue};
+
+  #pragma omp master
+  {
+    simulation::time_event_collision.start();
+    simulation::stats_event_collision.record(queue.size());
+  }
+
+  EventQueueBuffer fuel {simulation::calculate_fuel_xs_queue};
+  EventQueueBuffer nonfuel {simulation::calculate_nonfuel_xs_queue};
 
-  #pragma omp parallel for schedule(runtime)
-  for (int64_t i = 0; i < simulation::collision_queue.size(); i++) {
-    int64_t buffer_idx = simulation::collision_queue[i].idx;
+  #pragma omp for schedule(runtime) nowait
+  for (int64_t i = 0; i < queue.size(); i++) {
+    int64_t buffer_idx = queue[i].idx;
     Particle& p = simulation::particles[buffer_idx];
     p.event_collide();
     p.event_revive_from_secondary();
+    if (!p.alive_ && settings::event_refill) refill_particle(p);
     if (p.alive_)
-      dispatch_xs_event(buffer_idx);
+      dispatch_xs_event(buffer_idx, fuel, nonfuel);
   }
 
-  simulation::collision_queue.resize(0);
+  fuel.flush();
+  nonfuel.flush();
+  #pragma omp barrier
+
+  #pragma omp single
+  queue.resize(0);
 
+  #pragma omp master
   simulation::time_event_collision.stop();
 }
 
+// Helper that completes the history of a particle whose pending event (if
+// any) has already been executed. This mirrors the loop in
+// transport_history_based_single_particle() except for the death event, which
+// is still executed by process_death_events() unless the buffer is being
+// refilled.
+void complete_history(Particle& p)
+{
+  while (p.alive_) {
+    p.event_calculate_xs();
+    p.event_advance();
+    if (p.collision_distance_ > p.boundary_.distance) {
+      p.event_cross_surface();
+    } else {
+      p.event_collide();
+    }
+    p.event_revive_from_secondary();
+
+    // When refilling, this slot goes on to run any source particles that have
+    // not yet been started
+    if (!p.alive_ && settings::event_refill) refill_particle(p);
+  }
+}
+
+void history_tail_kernel()
+{
+  InstrumentRegion region {Region::EVENT_HISTORY_TAIL};
+  auto& fuel_queue {simulation::calculate_fuel_xs_queue};
+  auto& nonfuel_queue {simulation::calculate_nonfuel_xs_queue};
+  auto& advance_queue {simulation::advance_particle_queue};
+  auto& surface_queue {simulation::surface_crossing_queue};
+  auto& collision_queue {simulation::collision_queue};
+
+  #pragma omp master
+  simulation::time_event_history_tail.start();
+
+  // Particles waiting on a cross section lookup have no pending event
+  #pragma omp for schedule(runtime) nowait
+  for (int64_t i = 0; i < fuel_queue.size(); i++) {
+    complete_history(simulation::particles[fuel_queue[i].idx]);
+  }
+  #pragma omp for schedule(runtime) nowait
+  for (int64_t i = 0; i < nonfuel_queue.size(); i++) {
+    complete_history(simulation::particles[nonfuel_queue[i].idx]);
+  }
+
+  // For the remaining queues, execute the pending event first
+  #pragma omp for schedule(runtime) nowait
+  for (int64_t i = 0; i < advance_queue.size(); i++) {
+    Particle& p = simulation::particles[advance_queue[i].idx];
+    p.event_advance();
+    if (p.collision_distance_ > p.boundary_.distance) {
+      p.event_cross_surface();
+    } else {
+      p.event_collide();
+    }
+    p.event_revive_from_secondary();
+    complete_history(p);
+  }
+  #pragma omp for schedule(runtime) nowait
+  for (int64_t i = 0; i < surface_queue.size(); i++) {
+    Particle& p = simulation::particles[surface_queue[i].idx];
+    p.event_cross_surface();
+    p.event_revive_from_secondary();
+    complete_history(p);
+  }
+  #pragma omp for schedule(runtime)
+  for (int64_t i = 0; i < collision_queue.size(); i++) {
+    Particle& p = simulation::particles[collision_queue[i].idx];
+    p.event_collide();
+    p.event_revive_from_secondary();
+    complete_history(p);
+  }
+
+  #pragma omp single
+  {
+    fuel_queue.resize(0);
+    nonfuel_queue.resize(0);
+    advance_queue.resize(0);
+    surface_queue.resize(0);
+    collision_queue.resize(0);
+  }
+
+  #pragma omp master
+  simulation::time_event_history_tail.stop();
+}
+
+//==============================================================================
+// Kernel scheduling
+//==============================================================================
+
+// Number of particles still in flight, i.e., present in any event queue
+int64_t n_particles_in_queues()
+{
+  return simulation::calculate_fuel_xs_queue.size() +
+    simulation::calculate_nonfuel_xs_queue.size() +
+    simulation::advance_particle_queue.size() +
+    simulation::surface_crossing_queue.size() +
+    simulation::collision_queue.size();
+}
+
+constexpr int N_EVENT_KERNELS {5};
+
+// Pseudo-kernel index for finishing all particles history-based
+constexpr int HISTORY_TAIL {N_EVENT_KERNELS};
+
+// Pseudo-kernel index indicating that all event queues are empty
+constexpr int NO_KERNEL {-1};
+
+// Index of the kernel that the round-robin scheduler will consider next
+int next_kernel {0};
+
+// Chooses the next kernel to execute according to settings::event_scheduler.
+// Kernels are numbered in the order used by the round-robin scheduler.
+int select_event_kernel()
+{
+  // Once few enough particles remain that event kernels can no longer make
+  // good use of the available threads, finish them off history-based
+  int64_t n_alive = n_particles_in_queues();
+  if (n_alive == 0) return NO_KERNEL;
+  if (n_alive < settings::event_history_threshold) return HISTORY_TAIL;
+
+  int64_t sizes[N_EVENT_KERNELS] {
+    simulation::calculate_fuel_xs_queue.size(),
+    simulation::calculate_nonfuel_xs_queue.size(),
+    simulation::advance_particle_queue.size(),
+    simulation::surface_crossing_queue.size(),
+    simulation::collision_queue.size()};
+
+  // Determine the kernel with the longest queue. Ties are broken in favor of
+  // the kernel that comes first.
+  int i_longest = 0;
+  for (int i = 1; i < N_EVENT_KERNELS; ++i) {
+    if (sizes[i] > sizes[i_longest]) i_longest = i;
+  }
+
+  // Kernels whose queue is shorter than the minimum length are deferred so
+  // that their queues can fill up. If every queue is below the minimum, the
+  // longest one is run so that progress is always made.
+  int64_t min_length = std::min(settings::event_min_queue_length,
+    sizes[i_longest]);
+  min_length = std::max(min_length, int64_t{1});
+
+  int i_kernel = i_longest;
+  if (settings::event_scheduler == EventScheduler::ROUND_ROBIN) {
+    for (int j = 0; j < N_EVENT_KERNELS; ++j) {
+      int i = (next_kernel + j) % N_EVENT_KERNELS;
+      if (sizes[i] >= min_length) {
+        i_kernel = i;
+        break;
+      }
+    }
+    next_kernel = (i_kernel + 1) % N_EVENT_KERNELS;
+  }
+  return i_kernel;
+}
+
+// Executes the team kernel with a given index
+void run_event_kernel(int i)
+{
+  switch (i) {
+  case 0:
+    calculate_xs_kernel(simulation::calculate_fuel_xs_queue);
+    break;
+  case 1:
+    calculate_xs_kernel(simulation::calculate_nonfuel_xs_queue);
+    break;
+  case 2:
+    advance_particle_kernel();
+    break;
+  case 3:
+    surface_crossing_kernel();
+    break;
+  case 4:
+    collision_kernel();
+    break;
+  case HISTORY_TAIL:
+    history_tail_kernel();
+    break;
+  }
+}
+
+} // namespace
+
+void process_calculate_xs_events(SharedArray<EventQueueItem>& queue)
+{
+  #pragma omp parallel
+  calculate_xs_kernel(queue);
+}
+
+void process_advance_particle_events()
+{
+  #pragma omp parallel
+  advance_particle_kernel();
+}
+
+void process_surface_crossing_events()
+{
+  #pragma omp parallel
+  surface_crossing_kernel();
+}
+
+void process_collision_events()
+{
+  #pragma omp parallel
+  collision_kernel();
+}
+
 void process_death_events(int64_t n_particles)
 {
   simulation::time_event_death.start();
-  #pragma omp parallel for schedule(runtime)
-  for (int64_t i = 0; i < n_particles; i++) {
-    Particle& p = simulation::particles[i];
-    p.event_death();
+  simulation::stats_event_death.record(n_particles);
+  #pragma omp parallel
+  {
+    InstrumentRegion region {Region::EVENT_DEATH};
+
+    #pragma omp for schedule(runtime)
+    for (int64_t i = 0; i < n_particles; i++) {
+      Particle& p = simulation::particles[i];
+      p.event_death();
+    }
   }
   simulation::time_event_death.stop();
 }
 
+void process_remaining_events_history_based()
+{
+  #pragma omp parallel
+  history_tail_kernel();
+}
+
+void process_events()
+{
+  // A single parallel region is kept open until all particles are done. One
+  // thread picks the next kernel, which the whole team then executes; the
+  // barriers implied by the single construct and at the end of each kernel
+  // keep the threads in lockstep.
+  int i_kernel;
+  #pragma omp parallel
+  {
+    while (true) {
+      #pragma omp single
+      i_kernel = select_event_kernel();
+
+      if (i_kernel == NO_KERNEL) break;
+      run_event_kernel(i_kernel);
+    }
+  }
+}
+
 } // namespace openmc
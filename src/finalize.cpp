@@ -6,24 +6,32 @@
 #include "openmc/constants.h"
 #include "openmc/cross_sections.h"
 #include "openmc/dagmc.h"
+#include "openmc/delta_tracking.h"
+#include "openmc/domain_decomposition.h"
 #include "openmc/eigenvalue.h"
 #include "openmc/event.h"
 #include "openmc/geometry.h"
 #include "openmc/geometry_aux.h"
 #include "openmc/material.h"
 #include "openmc/mesh.h"
+#include "openmc/mesh_field.h"
 #include "openmc/message_passing.h"
 #include "openmc/nuclide.h"
 #include "openmc/photon.h"
+#include "openmc/plot.h"
+#include "openmc/precursor.h"
 #include "openmc/random_lcg.h"
 #include "openmc/settings.h"
 #include "openmc/simulation.h"
 #include "openmc/source.h"
+#include "openmc/state_point.h"
+#include "openmc/summary.h"
 #include "openmc/surface.h"
 #include "openmc/thermal.h"
 #include "openmc/timer.h"
 #include "openmc/tallies/tally.h"
 #include "openmc/volume_calc.h"
+#include "openmc/weight_windows.h"
 
 #include "xtensor/xview.hpp"
 
@@ -31,18 +39,25 @@ namespace openmc {
 
 void free_memory()
 {
+  free_memory_summary();
   free_memory_geometry();
+  free_memory_delta_tracking();
   free_memory_surfaces();
   free_memory_material();
   free_memory_volume();
   free_memory_simulation();
   free_memory_photon();
+  free_memory_plot();
   free_memory_settings();
+  free_memory_weight_windows();
   free_memory_thermal();
   library_clear();
   nuclides_clear();
   free_memory_source();
   free_memory_mesh();
+  free_memory_mesh_fields();
+  free_memory_precursors();
+  free_memory_domain_decomposition();
   free_memory_tally();
   free_memory_bank();
   if (mpi::master) {
@@ -67,45 +82,85 @@ int openmc_finalize()
 
   // Reset timers
   reset_timers();
+  reset_event_kernel_stats();
+
+  // Keep the nuclear data for the next simulation if requested, before the
+  // settings it was read with are reset
+  if (settings::retain_data) {
+    retain_nuclear_data();
+  } else {
+    free_retained_data();
+  }
 
   // Reset global variables
+  settings::alias_sampling = false;
   settings::assume_separate = false;
+  settings::async_statepoint = false;
+  settings::async_summary = false;
+  settings::azimuth_rejection = false;
+  settings::broadcast_data = false;
   settings::check_overlaps = false;
   settings::confidence_intervals = false;
   settings::create_fission_neutrons = true;
   settings::electron_treatment = ElectronTreatment::LED;
   settings::delayed_photon_scaling = true;
   settings::energy_cutoff = {0.0, 1000.0, 0.0, 0.0};
+  settings::time_cutoff = {INFTY, INFTY, INFTY, INFTY};
+  settings::census_time = INFTY;
+  settings::max_census_particles = -1;
   settings::entropy_on = false;
   settings::gen_per_batch = 1;
+  settings::instrument = true;
   settings::legendre_to_tabular = true;
   settings::legendre_to_tabular_points = -1;
   settings::event_based = false;
   settings::material_cell_offsets = true;
+  settings::huge_pages = false;
+  settings::numa_interleave = false;
   settings::max_particles_in_flight = 100000;
+  settings::event_prefetch_distance = 0;
+  settings::history_interleave = 1;
+  settings::thread_affinity = ThreadAffinity::NONE;
+  settings::tune_particles_in_flight = false;
+  settings::event_memory_budget = 1024.0;
+  settings::max_secondaries = 0;
   settings::n_particles = -1;
   settings::output_summary = true;
   settings::output_tallies = true;
   settings::particle_restart_run = false;
+  settings::performance_report = false;
+  settings::photon_material_tables = false;
   settings::photon_transport = false;
+  settings::photon_xs_tables = false;
   settings::reduce_tallies = true;
   settings::res_scat_on = false;
   settings::res_scat_method = ResScatMethod::rvs;
   settings::res_scat_energy_min = 0.01;
   settings::res_scat_energy_max = 1000.0;
   settings::restart_run = false;
+  discard_tally_results_pending();
+  settings::retain_data = false;
+  settings::reuse_source = false;
   settings::run_CE = true;
   settings::run_mode = RunMode::UNSET;
   settings::dagmc = false;
+  settings::dagmc_bvh = false;
+  settings::flat_geometry = false;
+  settings::source_binary = false;
   settings::source_latest = false;
   settings::source_separate = false;
+  settings::source_sort = false;
   settings::source_write = true;
+  settings::statepoint_incremental = false;
   settings::survival_biasing = false;
   settings::temperature_default = 293.6;
   settings::temperature_method = TemperatureMethod::NEAREST;
   settings::temperature_multipole = false;
   settings::temperature_range = {0.0, 0.0};
   settings::temperature_tolerance = 10.0;
+  settings::thinning_tolerance = 0.0;
+  settings::track_single_file = false;
+  settings::trigger_freeze = false;
   settings::trigger_on = false;
   settings::trigger_predict = false;
   settings::trigger_batch_interval = 1;
@@ -119,9 +174,11 @@ int openmc_finalize()
 
   simulation::keff = 1.0;
   simulation::n_lost_particles = 0;
+  simulation::n_majorant_exceeded = 0;
   simulation::satisfy_triggers = false;
   simulation::total_gen = 0;
 
+  simulation::batch_callbacks.clear();
   simulation::entropy_mesh = nullptr;
   simulation::ufs_mesh = nullptr;
 
@@ -131,6 +188,7 @@ int openmc_finalize()
   data::temperature_max = INFTY;
   model::root_universe = -1;
   openmc::openmc_set_seed(DEFAULT_SEED);
+  set_random_generator(RandomGenerator::lcg);
 
   // Deallocate arrays
   free_memory();
@@ -138,6 +196,7 @@ int openmc_finalize()
   // Free all MPI types
 #ifdef OPENMC_MPI
   if (mpi::bank != MPI_DATATYPE_NULL) MPI_Type_free(&mpi::bank);
+  if (mpi::node_comm != MPI_COMM_NULL) MPI_Comm_free(&mpi::node_comm);
 #endif
 
   return 0;
@@ -146,12 +205,13 @@ int openmc_finalize()
 int openmc_reset()
 {
 
-  model::universe_cell_counts.clear();
   model::universe_level_counts.clear();
+  model::universe_levels.clear();
 
   for (auto& t : model::tallies) {
     t->reset();
   }
+  discard_tally_results_pending();
 
   // Reset global tallies
   simulation::n_realizations = 0;
@@ -168,6 +228,7 @@ int openmc_reset()
 int openmc_reset_timers()
 {
   reset_timers();
+  reset_event_kernel_stats();
   return 0;
 }
 
@@ -176,6 +237,7 @@ int openmc_hard_reset()
   // Reset all tallies and timers
   openmc_reset();
   reset_timers();
+  reset_event_kernel_stats();
 
   // Reset total generations and keff guess
   simulation::keff = 1.0;
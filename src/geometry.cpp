@@ -1,14 +1,23 @@
 #include "openmc/geometry.h"
 
+#include <algorithm> // for min, max
 #include <array>
+#include <map>
+#include <utility> // for pair
+#include <vector>
 
 #include <fmt/core.h>
 #include <fmt/ostream.h>
 
+#include "openmc/capi.h"
 #include "openmc/cell.h"
 #include "openmc/constants.h"
 #include "openmc/error.h"
+#include "openmc/geometry_flat.h"
+#include "openmc/instrument.h"
 #include "openmc/lattice.h"
+#include "openmc/message_passing.h"
+#include "openmc/random_lcg.h"
 #include "openmc/settings.h"
 #include "openmc/simulation.h"
 #include "openmc/string_utils.h"
@@ -66,14 +75,41 @@ bool check_cell_overlap(Particle& p, bool error)
 
 //==============================================================================
 
+// Maximum number of coordinate levels for which cells are remembered as hints
+// when relocating a particle after a lattice crossing
+constexpr int MAX_CELL_HINTS {16};
+
+//! Check whether a particle is in a cell of the universe at its lowest
+//! coordinate level
+
+bool
+cell_hint_contains(Particle& p, int32_t i_cell)
+{
+  const auto& c {*model::cells[i_cell]};
+  if (c.universe_ != p.coord_[p.n_coord_-1].universe) return false;
+  return c.contains(p.r_local(), p.u_local(), p.surface_, &p.sense_cache_);
+}
+
+//==============================================================================
+
 bool
-find_cell_inner(Particle& p, const NeighborList* neighbor_list)
+find_cell_inner(Particle& p, const NeighborList* neighbor_list,
+  const int32_t* hints = nullptr)
 {
-  // Find which cell of this universe the particle is in.  Use the neighbor list
-  // to shorten the search if one was provided.
+  // Find which cell of this universe the particle is in.  Check the hinted
+  // cell for this level first and use the neighbor list to shorten the search
+  // if one was provided.  Surface senses are remembered while searching since
+  // all candidate cells are checked at the same point.
+  p.sense_cache_.clear();
   bool found = false;
   int32_t i_cell;
-  if (neighbor_list) {
+  int32_t hint = hints ? hints[p.n_coord_-1] : C_NONE;
+  if (hint != C_NONE && cell_hint_contains(p, hint)) {
+    i_cell = hint;
+    p.coord_[p.n_coord_-1].cell = i_cell;
+    found = true;
+
+  } else if (neighbor_list) {
     for (auto it = neighbor_list->cbegin(); it != neighbor_list->cend(); ++it) {
       i_cell = *it;
 
@@ -81,17 +117,31 @@ find_cell_inner(Particle& p, const NeighborList* neighbor_list)
       int i_universe = p.coord_[p.n_coord_-1].universe;
       if (model::cells[i_cell]->universe_ != i_universe) continue;
 
-      // Check if this cell contains the particle.
+      // Check if this cell contains the particle, rejecting it first if the
+      // particle is outside its bounding box.
       Position r {p.r_local()};
+      if (!model::cells[i_cell]->bbox_.contains(r)) continue;
       Direction u {p.u_local()};
       auto surf = p.surface_;
-      if (model::cells[i_cell]->contains(r, u, surf)) {
+      if (model::cells[i_cell]->contains(r, u, surf, &p.sense_cache_)) {
         p.coord_[p.n_coord_-1].cell = i_cell;
+        neighbor_list->hit(it);
         found = true;
         break;
       }
     }
 
+  } else if (model::universes[p.coord_[p.n_coord_-1].universe]->bvh_) {
+    // Search the bounding volume hierarchy of the universe
+    int i_universe = p.coord_[p.n_coord_-1].universe;
+    const auto& bvh {*model::universes[i_universe]->bvh_};
+    i_cell = bvh.find_cell(p.r_local(), p.u_local(), p.surface_,
+      &p.sense_cache_);
+    if (i_cell != C_NONE) {
+      p.coord_[p.n_coord_-1].cell = i_cell;
+      found = true;
+    }
+
   } else {
     int i_universe = p.coord_[p.n_coord_-1].universe;
     const auto& univ {*model::universes[i_universe]};
@@ -107,11 +157,13 @@ find_cell_inner(Particle& p, const NeighborList* neighbor_list)
       int i_universe = p.coord_[p.n_coord_-1].universe;
       if (model::cells[i_cell]->universe_ != i_universe) continue;
 
-      // Check if this cell contains the particle.
+      // Check if this cell contains the particle, rejecting it first if the
+      // particle is outside its bounding box.
       Position r {p.r_local()};
+      if (!model::cells[i_cell]->bbox_.contains(r)) continue;
       Direction u {p.u_local()};
       auto surf = p.surface_;
-      if (model::cells[i_cell]->contains(r, u, surf)) {
+      if (model::cells[i_cell]->contains(r, u, surf, &p.sense_cache_)) {
         p.coord_[p.n_coord_-1].cell = i_cell;
         found = true;
         break;
@@ -189,7 +241,7 @@ find_cell_inner(Particle& p, const NeighborList* neighbor_list)
 
       // Update the coordinate level and recurse.
       ++p.n_coord_;
-      return find_cell_inner(p, nullptr);
+      return find_cell_inner(p, nullptr, hints);
 
     } else if (c.type_ == Fill::LATTICE) {
       //========================================================================
@@ -237,7 +289,7 @@ find_cell_inner(Particle& p, const NeighborList* neighbor_list)
 
       // Update the coordinate level and recurse.
       ++p.n_coord_;
-      return find_cell_inner(p, nullptr);
+      return find_cell_inner(p, nullptr, hints);
     }
   }
 
@@ -247,8 +299,10 @@ find_cell_inner(Particle& p, const NeighborList* neighbor_list)
 //==============================================================================
 
 bool
-find_cell(Particle& p, bool use_neighbor_lists)
+find_cell(Particle& p, bool use_neighbor_lists, bool use_hints)
 {
+  InstrumentRegion region {Region::FIND_CELL};
+
   // Determine universe (if not yet set, use root universe).
   int i_universe = p.coord_[p.n_coord_-1].universe;
   if (i_universe == C_NONE) {
@@ -257,11 +311,23 @@ find_cell(Particle& p, bool use_neighbor_lists)
     i_universe = model::root_universe;
   }
 
+  // Remember the cells the particle was previously in at this and the deeper
+  // coordinate levels so that they can be checked first.
+  std::array<int32_t, MAX_CELL_HINTS> hints;
+  use_hints = use_hints && p.coord_.size() <= MAX_CELL_HINTS;
+  if (use_hints) {
+    for (int i = 0; i < p.coord_.size(); i++) {
+      hints[i] = (i >= p.n_coord_ - 1) ? p.coord_[i].cell : C_NONE;
+    }
+  }
+
   // Reset all the deeper coordinate levels.
   for (int i = p.n_coord_; i < p.coord_.size(); i++) {
     p.coord_[i].reset();
   }
 
+  if (use_hints) return find_cell_inner(p, nullptr, hints.data());
+
   if (use_neighbor_lists) {
     // Get the cell this particle was in previously.
     auto coord_lvl = p.n_coord_ - 1;
@@ -326,9 +392,12 @@ cross_lattice(Particle& p, const BoundaryInfo& boundary)
     }
 
   } else {
-    // Find cell in next lattice element.
+    // Find cell in next lattice element.  Neighboring lattice elements are
+    // often filled with the same universe, in which case the particle usually
+    // enters the same cells as the ones it just left, so those are checked
+    // first.
     p.coord_[p.n_coord_-1].universe = lat[i_xyz];
-    bool found = find_cell(p, 0);
+    bool found = find_cell(p, false, true);
 
     if (!found) {
       // A particle crossing the corner of a lattice tile may not be found.  In
@@ -345,8 +414,23 @@ cross_lattice(Particle& p, const BoundaryInfo& boundary)
 
 //==============================================================================
 
-BoundaryInfo distance_to_boundary(Particle& p)
+BoundaryInfo distance_to_boundary(Particle& p,
+  const std::pair<double, int32_t>* cell_distance)
 {
+  InstrumentRegion region {Region::DISTANCE_TO_BOUNDARY};
+
+  // Use the flat copy of the geometry when it was built for every cell
+  if (model::flat_geometry.complete()) {
+    bool lost;
+    BoundaryInfo info = model::flat_geometry.distance_to_boundary(
+      p.coord_.data(), p.n_coord_, p.surface_, cell_distance, lost);
+    if (lost) {
+      p.mark_as_lost(fmt::format(
+        "Particle {} had a negative distance to a lattice boundary", p.id_));
+    }
+    return info;
+  }
+
   BoundaryInfo info;
   double d_lat = INFINITY;
   double d_surf = INFINITY;
@@ -361,7 +445,8 @@ BoundaryInfo distance_to_boundary(Particle& p)
     Cell& c {*model::cells[coord.cell]};
 
     // Find the oncoming surface in this cell and the distance to it.
-    auto surface_distance = c.distance(r, u, p.surface_, &p);
+    auto surface_distance = (cell_distance && i == p.n_coord_ - 1) ?
+      *cell_distance : c.distance(r, u, p.surface_, &p);
     d_surf = surface_distance.first;
     level_surf_cross = surface_distance.second;
 
@@ -438,19 +523,215 @@ BoundaryInfo distance_to_boundary(Particle& p)
   return info;
 }
 
+//==============================================================================
+
+bool cross_boundary_ray(Particle& p, const BoundaryInfo& boundary)
+{
+  p.surface_ = boundary.surface_index;
+  p.n_coord_ = boundary.coord_level;
+
+  // Surfaces without a boundary condition are crossed with the neighbor lists
+  bool lattice = boundary.lattice_translation[0] != 0 ||
+    boundary.lattice_translation[1] != 0 ||
+    boundary.lattice_translation[2] != 0;
+  if (!lattice && model::surfaces[std::abs(p.surface_) - 1]->bc_ ==
+      Surface::BoundaryType::TRANSMIT && find_cell(p, true)) {
+    return true;
+  }
+
+  // Locate the ray just past the boundary from the root universe down, as for
+  // lattice tiles and cells not found in the neighbor lists
+  p.n_coord_ = 1;
+  p.surface_ = 0;
+  p.r() += TINY_BIT*p.u();
+  return find_cell(p, false);
+}
+
+//==============================================================================
+
+namespace {
+
+//! First sample at which a pair of cells was found to overlap
+struct OverlapSample {
+  int64_t index; //!< index of the sample
+  Position r;    //!< global coordinates of the sample
+};
+
+//! Overlapping cells found by a scan, keyed by the pair of their indices in
+//! increasing order
+using OverlapMap = std::map<std::pair<int32_t, int32_t>, OverlapSample>;
+
+//! Record an overlap, keeping the sample with the lowest index so that the
+//! results do not depend on how the samples are divided
+void add_overlap(OverlapMap& overlaps, std::pair<int32_t, int32_t> cells,
+  const OverlapSample& sample)
+{
+  auto it = overlaps.find(cells);
+  if (it == overlaps.end()) {
+    overlaps.emplace(cells, sample);
+  } else if (sample.index < it->second.index) {
+    it->second = sample;
+  }
+}
+
+//! Find a cell overlapping a cell a particle was located in
+//
+//! \return Indices of the two cells in increasing order, or C_NONE if the
+//!   particle is in a single cell at each coordinate level
+std::pair<int32_t, int32_t> find_overlap(const Particle& p)
+{
+  for (int j = 0; j < p.n_coord_; j++) {
+    const auto& univ {*model::universes[p.coord_[j].universe]};
+    for (auto index_cell : univ.cells_) {
+      if (index_cell == p.coord_[j].cell) continue;
+      const auto& c {*model::cells[index_cell]};
+      if (c.contains(p.coord_[j].r, p.coord_[j].u, p.surface_)) {
+        return {std::min(index_cell, p.coord_[j].cell),
+          std::max(index_cell, p.coord_[j].cell)};
+      }
+    }
+  }
+  return {C_NONE, C_NONE};
+}
+
+} // namespace
+
 //==============================================================================
 // C API
 //==============================================================================
 
 extern "C" int
-openmc_find_cell(const double* xyz, int32_t* index, int32_t* instance)
+openmc_find_overlaps(const double* lower_left, const double* upper_right,
+  int64_t n_samples, int32_t max_pairs, int32_t* cells, double* xyz,
+  int32_t* n_pairs)
 {
-  Particle p;
+  Position ll {lower_left};
+  Position ur {upper_right};
+  if (!(ll.x < ur.x && ll.y < ur.y && ll.z < ur.z)) {
+    set_errmsg("The bounding box of an overlap scan must have a positive "
+      "volume.");
+    return OPENMC_E_INVALID_ARGUMENT;
+  }
+
+  // Divide the samples over MPI processes
+  int64_t i_start = n_samples * mpi::rank / mpi::n_procs;
+  int64_t i_end = n_samples * (mpi::rank + 1) / mpi::n_procs;
+
+  OverlapMap overlaps;
+  #pragma omp parallel
+  {
+    OverlapMap thread_overlaps;
+    Particle p;
+
+    #pragma omp for schedule(static)
+    for (int64_t i = i_start; i < i_end; ++i) {
+      uint64_t seed = init_seed(i, STREAM_VOLUME);
+      Position xi {prn(&seed), prn(&seed), prn(&seed)};
+      p.n_coord_ = 1;
+      p.surface_ = 0;
+      p.r() = ll + xi*(ur - ll);
+      p.u() = {0.5, 0.5, 0.5};
+      if (!find_cell(p, false)) continue;
+
+      auto pair = find_overlap(p);
+      if (pair.first != C_NONE) {
+        add_overlap(thread_overlaps, pair, {i, p.r()});
+      }
+    }
+
+    #pragma omp critical (FindOverlaps)
+    for (const auto& kv : thread_overlaps) {
+      add_overlap(overlaps, kv.first, kv.second);
+    }
+  }
+
+#ifdef OPENMC_MPI
+  // Share the overlaps found by each process with all of them
+  OverlapMap local {overlaps};
+  for (int r = 0; r < mpi::n_procs; ++r) {
+    int n = local.size();
+    MPI_Bcast(&n, 1, MPI_INT, r, mpi::intracomm);
+    std::vector<int64_t> ints;
+    std::vector<double> coords;
+    if (mpi::rank == r) {
+      for (const auto& kv : local) {
+        ints.insert(ints.end(), {kv.first.first, kv.first.second,
+          kv.second.index});
+        coords.insert(coords.end(), {kv.second.r.x, kv.second.r.y,
+          kv.second.r.z});
+      }
+    } else {
+      ints.resize(3*n);
+      coords.resize(3*n);
+    }
+    MPI_Bcast(ints.data(), 3*n, MPI_INT64_T, r, mpi::intracomm);
+    MPI_Bcast(coords.data(), 3*n, MPI_DOUBLE, r, mpi::intracomm);
+    if (mpi::rank == r) continue;
+    for (int k = 0; k < n; ++k) {
+      add_overlap(overlaps, {static_cast<int32_t>(ints[3*k]),
+        static_cast<int32_t>(ints[3*k + 1])},
+        {ints[3*k + 2], Position{&coords[3*k]}});
+    }
+  }
+#endif
+
+  // Copy the overlaps, up to the number that fits in the arrays
+  *n_pairs = overlaps.size();
+  int32_t k = 0;
+  for (const auto& kv : overlaps) {
+    if (k == max_pairs) break;
+    cells[2*k] = kv.first.first;
+    cells[2*k + 1] = kv.first.second;
+    xyz[3*k] = kv.second.r.x;
+    xyz[3*k + 1] = kv.second.r.y;
+    xyz[3*k + 2] = kv.second.r.z;
+    ++k;
+  }
+  return 0;
+}
+
+namespace {
 
-  p.r() = Position{xyz};
+// Cell of the root universe containing the last point located by
+// openmc_find_cell on this thread. Points located one after another, as when
+// sampling source sites, are often in the same cell, so it is checked first.
+thread_local int32_t last_found_cell {C_NONE};
+
+//! Locate a point, checking first the cell of the root universe containing the
+//! last point located with the same hint
+//! \param p Particle whose coordinates are set
+//! \param r Position of the point
+//! \param hint Cell of the root universe of the last point, which is updated
+//! \return Whether the point was found in a cell
+bool locate_point(Particle& p, Position r, int32_t& hint)
+{
+  p.n_coord_ = 1;
+  p.surface_ = 0;
+  p.coord_[0].universe = C_NONE;
+  p.r() = r;
   p.u() = {0.0, 0.0, 1.0};
 
-  if (!find_cell(p, false)) {
+  bool found;
+  if (hint >= 0 && hint < model::cells.size() &&
+      model::cells[hint]->universe_ == model::root_universe) {
+    p.coord_[0].universe = model::root_universe;
+    p.coord_[0].cell = hint;
+    found = find_cell(p, false, true);
+  } else {
+    found = find_cell(p, false);
+  }
+  if (found) hint = p.coord_[0].cell;
+  return found;
+}
+
+} // namespace
+
+extern "C" int
+openmc_find_cell(const double* xyz, int32_t* index, int32_t* instance)
+{
+  Particle p;
+
+  if (!locate_point(p, Position{xyz}, last_found_cell)) {
     set_errmsg(fmt::format("Could not find cell at position {}.", p.r()));
     return OPENMC_E_GEOMETRY;
   }
@@ -460,6 +741,36 @@ openmc_find_cell(const double* xyz, int32_t* index, int32_t* instance)
   return 0;
 }
 
+extern "C" int
+openmc_find_cells(int64_t n, const double* xyz, int32_t* index,
+  int32_t* instance, int32_t* material, double* temperature)
+{
+  #pragma omp parallel
+  {
+    Particle p;
+    int32_t hint {C_NONE};
+
+    #pragma omp for schedule(static)
+    for (int64_t i = 0; i < n; ++i) {
+      int32_t i_cell {C_NONE};
+      int32_t i_instance {C_NONE};
+      int32_t i_material {C_NONE};
+      double T {0.0};
+      if (locate_point(p, Position{xyz + 3*i}, hint)) {
+        i_cell = p.coord_[p.n_coord_-1].cell;
+        i_instance = p.cell_instance_;
+        i_material = p.material_;
+        T = p.sqrtkT_*p.sqrtkT_ / K_BOLTZMANN;
+      }
+      if (index) index[i] = i_cell;
+      if (instance) instance[i] = i_instance;
+      if (material) material[i] = i_material;
+      if (temperature) temperature[i] = T;
+    }
+  }
+  return 0;
+}
+
 extern "C" int openmc_global_bounding_box(double* llc, double* urc) {
   auto bbox = model::universes.at(model::root_universe)->bounding_box();
 
@@ -1,8 +1,10 @@
 #include "openmc/geometry_aux.h"
 
-#include <algorithm>  // for std::max
+#include <algorithm>  // for std::max, sort
+#include <array>
 #include <sstream>
 #include <unordered_set>
+#include <utility>    // for pair
 
 #include <fmt/core.h>
 #include <pugixml.hpp>
@@ -14,6 +16,8 @@
 #include "openmc/error.h"
 #include "openmc/file_utils.h"
 #include "openmc/geometry.h"
+#include "openmc/geometry_flat.h"
+#include "openmc/hdf5_interface.h"
 #include "openmc/lattice.h"
 #include "openmc/material.h"
 #include "openmc/settings.h"
@@ -21,25 +25,83 @@
 #include "openmc/tallies/filter.h"
 #include "openmc/tallies/filter_cell_instance.h"
 #include "openmc/tallies/filter_distribcell.h"
+#include "openmc/xml_interface.h"
 
 
 namespace openmc {
 
 namespace model {
-  std::unordered_map<int32_t, std::unordered_map<int32_t, int32_t>> universe_cell_counts;
   std::unordered_map<int32_t, int32_t> universe_level_counts;
+  std::vector<std::vector<int32_t>> universe_levels;
 } // namespace model
 
+namespace {
 
-// adds the cell counts of universe b to universe a
-void update_universe_cell_count(int32_t a, int32_t b) {
-  auto& universe_a_counts = model::universe_cell_counts[a];
-  const auto& universe_b_counts = model::universe_cell_counts[b];
-  for (const auto& it : universe_b_counts) {
-    universe_a_counts[it.first] += it.second;
+//! Number of instances of each target universe under a universe, as pairs of
+//! target and count sorted by target
+using TargetCounts = std::vector<std::pair<int32_t, int32_t>>;
+
+//! Group the universes by the number of levels below them, so that every
+//! universe is in a later group than all the universes it contains. The
+//! groups are found once and kept in model::universe_levels.
+const std::vector<std::vector<int32_t>>& universes_by_level()
+{
+  auto& levels {model::universe_levels};
+  if (levels.empty()) {
+    for (int32_t i = 0; i < model::universes.size(); ++i) {
+      int n = maximum_levels(i);
+      if (levels.size() < n) levels.resize(n);
+      levels[n - 1].push_back(i);
+    }
   }
+  return levels;
 }
 
+//! Count how many times each universe directly fills a cell or lattice tile of
+//! a universe
+std::unordered_map<int32_t, int32_t> universe_children(const Universe& univ)
+{
+  std::unordered_map<int32_t, int32_t> children;
+  for (int32_t cell_indx : univ.cells_) {
+    const Cell& c = *model::cells[cell_indx];
+    if (c.type_ == Fill::UNIVERSE) {
+      ++children[c.fill_];
+    } else if (c.type_ == Fill::LATTICE) {
+      Lattice& lat = *model::lattices[c.fill_];
+      for (auto it = lat.begin(); it != lat.end(); ++it) {
+        ++children[*it];
+      }
+    }
+  }
+  return children;
+}
+
+//! Sort target counts and combine those of the same target
+void merge_counts(TargetCounts& counts)
+{
+  std::sort(counts.begin(), counts.end());
+  size_t n = 0;
+  for (size_t i = 0; i < counts.size(); ++i) {
+    if (n > 0 && counts[n - 1].first == counts[i].first) {
+      counts[n - 1].second += counts[i].second;
+    } else {
+      counts[n++] = counts[i];
+    }
+  }
+  counts.resize(n);
+}
+
+//! Points at which each surface and lattice is evaluated, so that the geometry
+//! hash depends on their coefficients without knowing their type
+const std::array<Position, 4> PROBE_POINTS {{
+  {0.318, -0.542, 0.771},
+  {-7.63, 2.91, -4.05},
+  {53.7, 61.2, -38.4},
+  {-412.0, -287.5, 903.1}
+}};
+
+} // namespace
+
 void read_geometry_xml()
 {
 #ifdef DAGMC
@@ -60,7 +122,7 @@ void read_geometry_xml()
 
   // Parse settings.xml file
   pugi::xml_document doc;
-  auto result = doc.load_file(filename.c_str());
+  auto result = load_xml_file(doc, filename);
   if (!result) {
     fatal_error("Error processing geometry.xml file.");
   }
@@ -139,29 +201,19 @@ void
 partition_universes()
 {
   // Iterate over universes with more than 10 cells.  (Fewer than 10 is likely
-  // not worth partitioning.)
+  // not worth partitioning.)  The partitioner itself decides whether the
+  // universe has a family of surfaces worth partitioning on.  Universes that
+  // cannot be partitioned are given a bounding volume hierarchy instead.
   for (const auto& univ : model::universes) {
     if (univ->cells_.size() > 10) {
-      // Collect the set of surfaces in this universe.
-      std::unordered_set<int32_t> surf_inds;
-      for (auto i_cell : univ->cells_) {
-        for (auto token : model::cells[i_cell]->rpn_) {
-          if (token < OP_UNION) surf_inds.insert(std::abs(token) - 1);
-        }
+      auto partitioner = std::make_unique<UniversePartitioner>(*univ);
+      if (!partitioner->empty()) {
+        univ->partitioner_ = std::move(partitioner);
+        continue;
       }
 
-      // Partition the universe if there are more than 5 z-planes.  (Fewer than
-      // 5 is likely not worth it.)
-      int n_zplanes = 0;
-      for (auto i_surf : surf_inds) {
-        if (dynamic_cast<const SurfaceZPlane*>(model::surfaces[i_surf].get())) {
-          ++n_zplanes;
-          if (n_zplanes > 5) {
-            univ->partitioner_ = std::make_unique<UniversePartitioner>(*univ);
-            break;
-          }
-        }
-      }
+      auto bvh = std::make_unique<CellBVH>(*univ);
+      if (!bvh->empty()) univ->bvh_ = std::move(bvh);
     }
   }
 }
@@ -256,6 +308,9 @@ void finalize_geometry(std::vector<std::vector<double>>& nuc_temps,
   // Perform some final operations to set up the geometry
   adjust_indices();
   count_cell_instances(model::root_universe);
+  for (auto& c : model::cells) {
+    c->bbox_ = c->bounding_box();
+  }
   partition_universes();
 
   // Assign temperatures to cells that don't have temperatures already assigned
@@ -266,6 +321,27 @@ void finalize_geometry(std::vector<std::vector<double>>& nuc_temps,
 
   // Determine number of nested coordinate levels in the geometry
   model::n_coord_levels = maximum_levels(model::root_universe);
+
+  // Copy the geometry into flat arrays once all indices are final
+  if (settings::flat_geometry) {
+    model::flat_geometry.build(model::flat_geometry_arrays);
+    if (!model::flat_geometry.complete()) {
+      warning("The flat geometry is not used since the geometry contains "
+        "surfaces or cells without a flat form.");
+      model::flat_geometry.clear();
+      model::flat_geometry_arrays = {};
+    }
+  }
+
+#ifdef OPENMC_OFFLOAD
+  // Boundary distances of event-based queues are found on the offload device
+  if (model::flat_geometry.complete()) {
+    warning("Boundary distances of event-based transport are found on the "
+      "offload device by an experimental prototype. Cross section lookups and "
+      "the other kernels still run on the host.");
+    copy_flat_geometry_to_device();
+  }
+#endif
 }
 
 //==============================================================================
@@ -361,20 +437,25 @@ prepare_distribcell()
   }
 
   // Search through universes for material cells and assign each one a
-  // unique distribcell array index.
+  // unique distribcell array index. Maps of cells in the same universe share
+  // a target universe, and the distinct target universes are numbered.
+  int n_univ = model::universes.size();
   int distribcell_index = 0;
-  std::vector<int32_t> target_univ_ids;
-  for (const auto& u : model::universes) {
-    for (auto idx : u->cells_) {
+  std::vector<int32_t> map_target;
+  std::vector<int32_t> target_index(n_univ, C_NONE);
+  int n_targets = 0;
+  for (int32_t i = 0; i < n_univ; ++i) {
+    for (auto idx : model::universes[i]->cells_) {
       if (distribcells.find(idx) != distribcells.end()) {
         model::cells[idx]->distribcell_index_ = distribcell_index++;
-        target_univ_ids.push_back(u->id_);
+        if (target_index[i] == C_NONE) target_index[i] = n_targets++;
+        map_target.push_back(target_index[i]);
       }
     }
   }
 
   // Allocate the cell and lattice offset tables.
-  int n_maps = target_univ_ids.size();
+  int n_maps = map_target.size();
   for (auto& c : model::cells) {
     if (c->type_ != Fill::MATERIAL) {
       c->offset_.resize(n_maps, C_NONE);
@@ -384,28 +465,81 @@ prepare_distribcell()
     lat->allocate_offset_table(n_maps);
   }
 
-  // Fill the cell and lattice offset tables.
-  #pragma omp parallel for
-  for (int map = 0; map < target_univ_ids.size(); map++) {
-    auto target_univ_id = target_univ_ids[map];
-    std::unordered_map<int32_t, int32_t> univ_count_memo;
-    for (const auto& univ : model::universes) {
-      int32_t offset = 0;
-      for (int32_t cell_indx : univ->cells_) {
+  // Count the instances of all target universes under each universe in a
+  // single pass from the bottom of the geometry tree up. The universes of a
+  // level only contain universes of lower levels and are counted in parallel.
+  // A target universe counts as one instance of itself, in addition to the
+  // instances of other targets nested in it.
+  std::vector<TargetCounts> univ_counts(n_univ);
+  for (const auto& level : universes_by_level()) {
+    #pragma omp parallel for schedule(dynamic)
+    for (int j = 0; j < level.size(); ++j) {
+      int32_t i = level[j];
+      TargetCounts& counts = univ_counts[i];
+      if (target_index[i] != C_NONE) {
+        counts.emplace_back(target_index[i], 1);
+      }
+      for (const auto& child : universe_children(*model::universes[i])) {
+        for (const auto& tc : univ_counts[child.first]) {
+          counts.emplace_back(tc.first, tc.second*child.second);
+        }
+      }
+      merge_counts(counts);
+    }
+  }
+
+  // A lattice filling several cells gets the offsets of the last one
+  std::vector<int32_t> lattice_cell(model::lattices.size(), C_NONE);
+  for (const auto& u : model::universes) {
+    for (int32_t cell_indx : u->cells_) {
+      const Cell& c = *model::cells[cell_indx];
+      if (c.type_ == Fill::LATTICE) lattice_cell[c.fill_] = cell_indx;
+    }
+  }
+
+  // Fill the cell and lattice offset tables of all maps at once. Each universe
+  // keeps running offsets of the target universes in the cells before the
+  // current one.
+  #pragma omp parallel
+  {
+    std::vector<int32_t> offset(n_targets, 0);
+    std::vector<int32_t> touched;
+    auto add_counts = [&](const TargetCounts& counts) {
+      for (const auto& tc : counts) {
+        if (offset[tc.first] == 0) touched.push_back(tc.first);
+        offset[tc.first] += tc.second;
+      }
+    };
+
+    #pragma omp for schedule(dynamic)
+    for (int i = 0; i < n_univ; ++i) {
+      for (int32_t cell_indx : model::universes[i]->cells_) {
         Cell& c = *model::cells[cell_indx];
 
         if (c.type_ == Fill::UNIVERSE) {
-          c.offset_[map] = offset;
-          int32_t search_univ = c.fill_;
-          offset += count_universe_instances(search_univ, target_univ_id,
-                                             univ_count_memo);
+          for (int map = 0; map < n_maps; ++map) {
+            c.offset_[map] = offset[map_target[map]];
+          }
+          add_counts(univ_counts[c.fill_]);
 
         } else if (c.type_ == Fill::LATTICE) {
           Lattice& lat = *model::lattices[c.fill_];
-          offset = lat.fill_offset_table(offset, target_univ_id, map,
-                                         univ_count_memo);
+          bool write = (lattice_cell[c.fill_] == cell_indx);
+          int n_tiles = lat.universes_.size();
+          for (auto it = lat.begin(); it != lat.end(); ++it) {
+            if (write) {
+              for (int map = 0; map < n_maps; ++map) {
+                lat.offsets_[map*n_tiles + it.indx_] = offset[map_target[map]];
+              }
+            }
+            add_counts(univ_counts[*it]);
+          }
         }
       }
+
+      // Reset the running offsets for the next universe
+      for (auto t : touched) offset[t] = 0;
+      touched.clear();
     }
   }
 }
@@ -415,73 +549,25 @@ prepare_distribcell()
 void
 count_cell_instances(int32_t univ_indx)
 {
-  const auto univ_counts = model::universe_cell_counts.find(univ_indx);
-  if (univ_counts != model::universe_cell_counts.end()) {
-    for (const auto& it : univ_counts->second) {
-      model::cells[it.first]->n_instances_ += it.second;
-    }
-  } else {
-    for (int32_t cell_indx : model::universes[univ_indx]->cells_) {
-      Cell& c = *model::cells[cell_indx];
-      ++c.n_instances_;
-      model::universe_cell_counts[univ_indx][cell_indx] += 1;
-
-      if (c.type_ == Fill::UNIVERSE) {
-        // This cell contains another universe.  Recurse into that universe.
-        count_cell_instances(c.fill_);
-        update_universe_cell_count(univ_indx, c.fill_);
-      } else if (c.type_ == Fill::LATTICE) {
-        // This cell contains a lattice.  Recurse into the lattice universes.
-        Lattice& lat = *model::lattices[c.fill_];
-        for (auto it = lat.begin(); it != lat.end(); ++it) {
-          count_cell_instances(*it);
-          update_universe_cell_count(univ_indx, *it);
-        }
+  // Count the instances of each universe from the top of the geometry tree
+  // down, so that all the universes containing a universe are visited first.
+  std::vector<int32_t> univ_instances(model::universes.size(), 0);
+  univ_instances[univ_indx] = 1;
+  const auto& levels = universes_by_level();
+  for (auto level = levels.rbegin(); level != levels.rend(); ++level) {
+    for (int32_t i : *level) {
+      int32_t n = univ_instances[i];
+      if (n == 0) continue;
+
+      const Universe& univ = *model::universes[i];
+      for (int32_t cell_indx : univ.cells_) {
+        model::cells[cell_indx]->n_instances_ += n;
       }
-    }
-  }
-}
-
-//==============================================================================
-
-int
-count_universe_instances(int32_t search_univ, int32_t target_univ_id,
-  std::unordered_map<int32_t, int32_t>& univ_count_memo)
-{
-  // If this is the target, it can't contain itself.
-  if (model::universes[search_univ]->id_ == target_univ_id) {
-    return 1;
-  }
-
-  // If we have already counted the number of instances, reuse that value.
-  auto search = univ_count_memo.find(search_univ);
-  if (search != univ_count_memo.end()) {
-    return search->second;
-  }
-
-  int count {0};
-  for (int32_t cell_indx : model::universes[search_univ]->cells_) {
-    Cell& c = *model::cells[cell_indx];
-
-    if (c.type_ == Fill::UNIVERSE) {
-      int32_t next_univ = c.fill_;
-      count += count_universe_instances(next_univ, target_univ_id,
-                                        univ_count_memo);
-
-    } else if (c.type_ == Fill::LATTICE) {
-      Lattice& lat = *model::lattices[c.fill_];
-      for (auto it = lat.begin(); it != lat.end(); ++it) {
-        int32_t next_univ = *it;
-        count += count_universe_instances(next_univ, target_univ_id,
-                                          univ_count_memo);
+      for (const auto& child : universe_children(univ)) {
+        univ_instances[child.first] += n*child.second;
       }
     }
   }
-
-  // Remember the number of instances in this universe.
-  univ_count_memo[search_univ] = count;
-
-  return count;
 }
 
 //==============================================================================
@@ -599,6 +685,139 @@ maximum_levels(int32_t univ)
 
 //==============================================================================
 
+void fill_materials(const Cell& c, std::set<int32_t>& materials)
+{
+  auto add_universe = [&materials](int32_t i_univ) {
+    for (auto i_cell : model::universes[i_univ]->cells_) {
+      fill_materials(*model::cells[i_cell], materials);
+    }
+  };
+
+  switch (c.type_) {
+  case Fill::MATERIAL:
+    for (auto i_mat : c.material_) {
+      if (i_mat != MATERIAL_VOID) materials.insert(i_mat);
+    }
+    break;
+  case Fill::UNIVERSE:
+    add_universe(c.fill_);
+    break;
+  case Fill::LATTICE: {
+    Lattice& lat {*model::lattices[c.fill_]};
+    for (auto it = lat.begin(); it != lat.end(); ++it) {
+      add_universe(*it);
+    }
+    if (lat.outer_ != NO_OUTER_UNIVERSE) add_universe(lat.outer_);
+    break;
+  }
+  }
+}
+
+//==============================================================================
+
+uint64_t geometry_hash()
+{
+  uint64_t hash {FNV_OFFSET};
+  hash_value(hash, model::cells.size());
+  for (const auto& c : model::cells) {
+    hash_value(hash, c->id_);
+    hash_value(hash, c->type_);
+    hash_value(hash, c->universe_);
+    hash_value(hash, c->fill_);
+    hash_bytes(hash, c->region_.data(),
+      c->region_.size()*sizeof(c->region_[0]));
+    hash_value(hash, c->translation_);
+    hash_bytes(hash, c->rotation_.data(),
+      c->rotation_.size()*sizeof(c->rotation_[0]));
+  }
+
+  hash_value(hash, model::surfaces.size());
+  for (const auto& s : model::surfaces) {
+    hash_value(hash, s->id_);
+    hash_value(hash, s->bc_);
+    for (const auto& r : PROBE_POINTS) {
+      hash_value(hash, s->evaluate(r));
+    }
+  }
+
+  hash_value(hash, model::lattices.size());
+  for (const auto& lat : model::lattices) {
+    hash_value(hash, lat->id_);
+    hash_value(hash, lat->type_);
+    hash_value(hash, lat->outer_);
+    hash_bytes(hash, lat->universes_.data(),
+      lat->universes_.size()*sizeof(lat->universes_[0]));
+    for (const auto& r : PROBE_POINTS) {
+      hash_value(hash, lat->get_indices(r, {1.0, 0.0, 0.0}));
+    }
+  }
+  return hash;
+}
+
+//==============================================================================
+
+void write_neighbor_lists(hid_t group)
+{
+  // The lists of all cells are stored one after another
+  std::vector<int64_t> offsets {0};
+  std::vector<int> neighbors;
+  for (const auto& c : model::cells) {
+    for (auto it = c->neighbors_.cbegin(); it != c->neighbors_.cend(); ++it) {
+      neighbors.push_back(*it);
+    }
+    offsets.push_back(neighbors.size());
+  }
+
+  write_attribute(group, "geometry_hash", geometry_hash());
+  write_dataset(group, "offsets", offsets);
+  write_dataset(group, "cells", neighbors);
+}
+
+//==============================================================================
+
+void read_neighbor_lists(const std::string& filename)
+{
+  if (!file_exists(filename)) {
+    fatal_error(fmt::format("Neighbor list file '{}' does not exist.",
+      filename));
+  }
+
+  write_message(fmt::format("Reading neighbor lists from {}...", filename), 5);
+  hid_t file_id = file_open(filename, 'r');
+  if (!object_exists(file_id, "neighbor_lists")) {
+    file_close(file_id);
+    warning(fmt::format("{} does not contain neighbor lists.", filename));
+    return;
+  }
+  hid_t group = open_group(file_id, "neighbor_lists");
+  uint64_t hash;
+  read_attribute(group, "geometry_hash", hash);
+  std::vector<int64_t> offsets;
+  std::vector<int> neighbors;
+  read_dataset(group, "offsets", offsets);
+  read_dataset(group, "cells", neighbors);
+  close_group(group);
+  file_close(file_id);
+
+  // Lists written for another geometry could point at cells that can't be
+  // next to each other, which would only cost a search, or at cells that no
+  // longer exist
+  if (hash != geometry_hash() || offsets.size() != model::cells.size() + 1 ||
+      offsets.back() != neighbors.size()) {
+    warning(fmt::format("Neighbor lists in {} were written for a different "
+      "geometry and are ignored.", filename));
+    return;
+  }
+
+  for (int i = 0; i < model::cells.size(); ++i) {
+    for (int64_t k = offsets[i]; k < offsets[i + 1]; ++k) {
+      model::cells[i]->neighbors_.push_back(neighbors[k]);
+    }
+  }
+}
+
+//==============================================================================
+
 void
 free_memory_geometry()
 {
@@ -612,6 +831,12 @@ free_memory_geometry()
   model::lattice_map.clear();
 
   model::overlap_check_count.clear();
+
+  model::flat_geometry.clear();
+  model::flat_geometry_arrays = {};
+#ifdef OPENMC_OFFLOAD
+  free_flat_geometry_device();
+#endif
 }
 
 } // namespace openmc
@@ -0,0 +1,894 @@
+#include "openmc/geometry_flat.h"
+
+#include <algorithm> // for copy, max
+#include <cmath>     // for abs, copysign, floor, lround, round, sqrt
+#include <limits>    // for numeric_limits
+
+#include "openmc/constants.h"
+#include "openmc/error.h"
+#include "openmc/geometry.h"
+#include "openmc/surface.h"
+#include "openmc/surface_kernel.h"
+
+#ifdef OPENMC_OFFLOAD
+#include <omp.h>
+#endif
+
+namespace openmc {
+
+//==============================================================================
+// Global variables
+//==============================================================================
+
+namespace model {
+
+FlatGeometry flat_geometry;
+FlatGeometryArrays flat_geometry_arrays;
+#ifdef OPENMC_OFFLOAD
+FlatGeometry device_flat_geometry;
+#endif
+
+} // namespace model
+
+//==============================================================================
+// FlatGeometry implementation
+//==============================================================================
+
+constexpr int FlatGeometry::MAX_REGION_DEPTH;
+
+namespace {
+
+//! Append the flat form of a surface to the coefficients
+//! \return Type of the surface
+FlatGeometry::SurfaceKind flatten_surface(const Surface* surf,
+  std::vector<double>& c)
+{
+  using Kind = FlatGeometry::SurfaceKind;
+  if (const auto* s = dynamic_cast<const SurfaceXPlane*>(surf)) {
+    c.push_back(s->x0_);
+    return Kind::X_PLANE;
+  } else if (const auto* s = dynamic_cast<const SurfaceYPlane*>(surf)) {
+    c.push_back(s->y0_);
+    return Kind::Y_PLANE;
+  } else if (const auto* s = dynamic_cast<const SurfaceZPlane*>(surf)) {
+    c.push_back(s->z0_);
+    return Kind::Z_PLANE;
+  } else if (const auto* s = dynamic_cast<const SurfacePlane*>(surf)) {
+    c.insert(c.end(), {s->A_, s->B_, s->C_, s->D_});
+    return Kind::PLANE;
+  } else if (const auto* s = dynamic_cast<const SurfaceXCylinder*>(surf)) {
+    c.insert(c.end(), {s->y0_, s->z0_, s->radius_});
+    return Kind::X_CYLINDER;
+  } else if (const auto* s = dynamic_cast<const SurfaceYCylinder*>(surf)) {
+    c.insert(c.end(), {s->x0_, s->z0_, s->radius_});
+    return Kind::Y_CYLINDER;
+  } else if (const auto* s = dynamic_cast<const SurfaceZCylinder*>(surf)) {
+    c.insert(c.end(), {s->x0_, s->y0_, s->radius_});
+    return Kind::Z_CYLINDER;
+  } else if (const auto* s = dynamic_cast<const SurfaceSphere*>(surf)) {
+    c.insert(c.end(), {s->x0_, s->y0_, s->z0_, s->radius_});
+    return Kind::SPHERE;
+  } else if (const auto* s = dynamic_cast<const SurfaceXCone*>(surf)) {
+    c.insert(c.end(), {s->x0_, s->y0_, s->z0_, s->radius_sq_});
+    return Kind::X_CONE;
+  } else if (const auto* s = dynamic_cast<const SurfaceYCone*>(surf)) {
+    c.insert(c.end(), {s->x0_, s->y0_, s->z0_, s->radius_sq_});
+    return Kind::Y_CONE;
+  } else if (const auto* s = dynamic_cast<const SurfaceZCone*>(surf)) {
+    c.insert(c.end(), {s->x0_, s->y0_, s->z0_, s->radius_sq_});
+    return Kind::Z_CONE;
+  } else if (const auto* s = dynamic_cast<const SurfaceQuadric*>(surf)) {
+    c.insert(c.end(), {s->A_, s->B_, s->C_, s->D_, s->E_, s->F_, s->G_,
+      s->H_, s->J_, s->K_});
+    return Kind::QUADRIC;
+  }
+  return Kind::OTHER;
+}
+
+} // namespace
+
+void FlatGeometry::build(FlatGeometryArrays& arrays)
+{
+  this->clear();
+  arrays = FlatGeometryArrays {};
+  complete_ = true;
+
+  // Surfaces
+  arrays.surface_offset.push_back(0);
+  for (const auto& surf : model::surfaces) {
+    auto kind = flatten_surface(surf.get(), arrays.surface_coeffs);
+    if (kind == SurfaceKind::OTHER) complete_ = false;
+    arrays.surface_kind.push_back(kind);
+    arrays.surface_offset.push_back(arrays.surface_coeffs.size());
+  }
+
+  // Cells
+  arrays.cell_token_offset.push_back(0);
+  arrays.cell_region_offset.push_back(0);
+  arrays.cell_material_offset.push_back(0);
+  arrays.cell_rotation_offset.push_back(0);
+  for (const auto& c : model::cells) {
+    arrays.cell_type.push_back(c->type_);
+    arrays.cell_universe.push_back(c->universe_);
+    arrays.cell_fill.push_back(c->fill_);
+    arrays.cell_simple.push_back(c->simple_);
+    arrays.cell_materials.insert(arrays.cell_materials.end(),
+      c->material_.begin(), c->material_.end());
+    arrays.cell_translation.push_back(c->translation_);
+    if (!c->rotation_.empty()) {
+      arrays.cell_rotations.insert(arrays.cell_rotations.end(),
+        c->rotation_.begin(), c->rotation_.begin() + 9);
+    }
+
+    if (const auto* csg = dynamic_cast<const CSGCell*>(c.get())) {
+      for (int32_t token : csg->rpn_) {
+        if (token < OP_UNION) arrays.cell_tokens.push_back(token);
+      }
+
+      // Copy the compiled region of complex cells, checking that its operators
+      // can be tracked by cell_contains
+      if (!csg->simple_) {
+        std::vector<int32_t> ends;
+        int32_t i = 0;
+        for (const auto& node : csg->region_tree_) {
+          while (!ends.empty() && ends.back() <= i) ends.pop_back();
+          if (node.token >= OP_UNION) ends.push_back(i + node.size);
+          if (ends.size() > MAX_REGION_DEPTH) complete_ = false;
+          arrays.cell_region.push_back({node.token, node.size});
+          ++i;
+        }
+      }
+    } else {
+      complete_ = false;
+    }
+
+    arrays.cell_token_offset.push_back(arrays.cell_tokens.size());
+    arrays.cell_region_offset.push_back(arrays.cell_region.size());
+    arrays.cell_material_offset.push_back(arrays.cell_materials.size());
+    arrays.cell_rotation_offset.push_back(arrays.cell_rotations.size());
+  }
+
+  // Universes
+  arrays.universe_offset.push_back(0);
+  for (const auto& u : model::universes) {
+    arrays.universe_cells.insert(arrays.universe_cells.end(),
+      u->cells_.begin(), u->cells_.end());
+    arrays.universe_offset.push_back(arrays.universe_cells.size());
+  }
+
+  // Lattices
+  arrays.lattice_offset.push_back(0);
+  for (const auto& lat : model::lattices) {
+    arrays.lattice_type.push_back(lat->type_);
+    arrays.lattice_outer.push_back(lat->outer_);
+    if (const auto* rect = dynamic_cast<const RectLattice*>(lat.get())) {
+      arrays.lattice_is_3d.push_back(rect->is_3d_);
+      arrays.lattice_shape.push_back(rect->n_cells_);
+      arrays.lattice_origin.push_back(rect->lower_left_);
+      arrays.lattice_pitch.push_back(rect->pitch_);
+      arrays.lattice_face_normals.push_back({});
+    } else {
+      const auto* hex = dynamic_cast<const HexLattice*>(lat.get());
+      arrays.lattice_is_3d.push_back(hex->is_3d_);
+      arrays.lattice_shape.push_back({hex->n_rings_, hex->n_axial_,
+        static_cast<int>(hex->orientation_)});
+      arrays.lattice_origin.push_back(hex->center_);
+      arrays.lattice_pitch.push_back({hex->pitch_[0], hex->pitch_[1], 0.0});
+      arrays.lattice_face_normals.push_back(hex->face_normals_);
+    }
+    arrays.lattice_universes.insert(arrays.lattice_universes.end(),
+      lat->universes_.begin(), lat->universes_.end());
+    arrays.lattice_offset.push_back(arrays.lattice_universes.size());
+  }
+
+  // Point to the arrays
+  surface_kind_ = arrays.surface_kind.data();
+  surface_offset_ = arrays.surface_offset.data();
+  surface_coeffs_ = arrays.surface_coeffs.data();
+  cell_type_ = arrays.cell_type.data();
+  cell_universe_ = arrays.cell_universe.data();
+  cell_fill_ = arrays.cell_fill.data();
+  cell_simple_ = arrays.cell_simple.data();
+  cell_token_offset_ = arrays.cell_token_offset.data();
+  cell_tokens_ = arrays.cell_tokens.data();
+  cell_region_offset_ = arrays.cell_region_offset.data();
+  cell_region_ = arrays.cell_region.data();
+  cell_material_offset_ = arrays.cell_material_offset.data();
+  cell_materials_ = arrays.cell_materials.data();
+  cell_translation_ = arrays.cell_translation.data();
+  cell_rotation_offset_ = arrays.cell_rotation_offset.data();
+  cell_rotations_ = arrays.cell_rotations.data();
+  universe_offset_ = arrays.universe_offset.data();
+  universe_cells_ = arrays.universe_cells.data();
+  lattice_type_ = arrays.lattice_type.data();
+  lattice_outer_ = arrays.lattice_outer.data();
+  lattice_is_3d_ = arrays.lattice_is_3d.data();
+  lattice_shape_ = arrays.lattice_shape.data();
+  lattice_origin_ = arrays.lattice_origin.data();
+  lattice_pitch_ = arrays.lattice_pitch.data();
+  lattice_face_normals_ = arrays.lattice_face_normals.data();
+  lattice_offset_ = arrays.lattice_offset.data();
+  lattice_universes_ = arrays.lattice_universes.data();
+}
+
+void FlatGeometry::clear()
+{
+  *this = FlatGeometry {};
+}
+
+//==============================================================================
+// Kernels, which are also compiled for the offload device
+//==============================================================================
+
+#ifdef OPENMC_OFFLOAD
+#pragma omp declare target
+#endif
+
+namespace {
+
+// Same as HexLattice::FACE_SHIFT, which is only defined on the host
+constexpr int HEX_FACE_SHIFT[3][2] {{1, 0}, {1, -1}, {0, 1}};
+
+} // namespace
+
+double FlatGeometry::surface_evaluate(int32_t i, Position r) const
+{
+  const double* c = &surface_coeffs_[surface_offset_[i]];
+  switch (surface_kind_[i]) {
+  case SurfaceKind::X_PLANE: return r.x - c[0];
+  case SurfaceKind::Y_PLANE: return r.y - c[0];
+  case SurfaceKind::Z_PLANE: return r.z - c[0];
+  case SurfaceKind::PLANE: return c[0]*r.x + c[1]*r.y + c[2]*r.z - c[3];
+  case SurfaceKind::X_CYLINDER:
+    return axis_aligned_cylinder_evaluate<1, 2>(r, c[0], c[1], c[2]);
+  case SurfaceKind::Y_CYLINDER:
+    return axis_aligned_cylinder_evaluate<0, 2>(r, c[0], c[1], c[2]);
+  case SurfaceKind::Z_CYLINDER:
+    return axis_aligned_cylinder_evaluate<0, 1>(r, c[0], c[1], c[2]);
+  case SurfaceKind::SPHERE:
+    {
+      const double x = r.x - c[0];
+      const double y = r.y - c[1];
+      const double z = r.z - c[2];
+      return x*x + y*y + z*z - c[3]*c[3];
+    }
+  case SurfaceKind::X_CONE:
+    return axis_aligned_cone_evaluate<0, 1, 2>(r, c[0], c[1], c[2], c[3]);
+  case SurfaceKind::Y_CONE:
+    return axis_aligned_cone_evaluate<1, 0, 2>(r, c[1], c[0], c[2], c[3]);
+  case SurfaceKind::Z_CONE:
+    return axis_aligned_cone_evaluate<2, 0, 1>(r, c[2], c[0], c[1], c[3]);
+  case SurfaceKind::QUADRIC:
+    return quadric_evaluate(r, c[0], c[1], c[2], c[3], c[4], c[5], c[6],
+      c[7], c[8], c[9]);
+  default:
+    return 0.0;
+  }
+}
+
+bool FlatGeometry::surface_sense(int32_t i, Position r, Direction u) const
+{
+  const double f = surface_evaluate(i, r);
+
+  // Points coincident with the surface are resolved using the surface normal
+  if (std::abs(f) < FP_COINCIDENT) return u.dot(surface_normal(i, r)) > 0.0;
+  return f > 0.0;
+}
+
+double FlatGeometry::surface_distance(int32_t i, Position r, Direction u,
+  bool coincident) const
+{
+  const double* c = &surface_coeffs_[surface_offset_[i]];
+  switch (surface_kind_[i]) {
+  case SurfaceKind::X_PLANE:
+    return axis_aligned_plane_distance<0>(r, u, coincident, c[0]);
+  case SurfaceKind::Y_PLANE:
+    return axis_aligned_plane_distance<1>(r, u, coincident, c[0]);
+  case SurfaceKind::Z_PLANE:
+    return axis_aligned_plane_distance<2>(r, u, coincident, c[0]);
+  case SurfaceKind::PLANE:
+    return plane_distance(r, u, coincident, c[0], c[1], c[2], c[3]);
+  case SurfaceKind::X_CYLINDER:
+    return axis_aligned_cylinder_distance<0, 1, 2>(r, u, coincident, c[0],
+      c[1], c[2]);
+  case SurfaceKind::Y_CYLINDER:
+    return axis_aligned_cylinder_distance<1, 0, 2>(r, u, coincident, c[0],
+      c[1], c[2]);
+  case SurfaceKind::Z_CYLINDER:
+    return axis_aligned_cylinder_distance<2, 0, 1>(r, u, coincident, c[0],
+      c[1], c[2]);
+  case SurfaceKind::SPHERE:
+    return sphere_distance(r, u, coincident, c[0], c[1], c[2], c[3]);
+  case SurfaceKind::X_CONE:
+    return axis_aligned_cone_distance<0, 1, 2>(r, u, coincident, c[0], c[1],
+      c[2], c[3]);
+  case SurfaceKind::Y_CONE:
+    return axis_aligned_cone_distance<1, 0, 2>(r, u, coincident, c[1], c[0],
+      c[2], c[3]);
+  case SurfaceKind::Z_CONE:
+    return axis_aligned_cone_distance<2, 0, 1>(r, u, coincident, c[2], c[0],
+      c[1], c[3]);
+  case SurfaceKind::QUADRIC:
+    return quadric_distance(r, u, coincident, c[0], c[1], c[2], c[3], c[4],
+      c[5], c[6], c[7], c[8], c[9]);
+  default:
+    return INFTY;
+  }
+}
+
+Direction FlatGeometry::surface_normal(int32_t i, Position r) const
+{
+  const double* c = &surface_coeffs_[surface_offset_[i]];
+  switch (surface_kind_[i]) {
+  case SurfaceKind::X_PLANE: return {1., 0., 0.};
+  case SurfaceKind::Y_PLANE: return {0., 1., 0.};
+  case SurfaceKind::Z_PLANE: return {0., 0., 1.};
+  case SurfaceKind::PLANE: return {c[0], c[1], c[2]};
+  case SurfaceKind::X_CYLINDER:
+    return axis_aligned_cylinder_normal<0, 1, 2>(r, c[0], c[1]);
+  case SurfaceKind::Y_CYLINDER:
+    return axis_aligned_cylinder_normal<1, 0, 2>(r, c[0], c[1]);
+  case SurfaceKind::Z_CYLINDER:
+    return axis_aligned_cylinder_normal<2, 0, 1>(r, c[0], c[1]);
+  case SurfaceKind::SPHERE:
+    return {2.0*(r.x - c[0]), 2.0*(r.y - c[1]), 2.0*(r.z - c[2])};
+  case SurfaceKind::X_CONE:
+    return axis_aligned_cone_normal<0, 1, 2>(r, c[0], c[1], c[2], c[3]);
+  case SurfaceKind::Y_CONE:
+    return axis_aligned_cone_normal<1, 0, 2>(r, c[1], c[0], c[2], c[3]);
+  case SurfaceKind::Z_CONE:
+    return axis_aligned_cone_normal<2, 0, 1>(r, c[2], c[0], c[1], c[3]);
+  case SurfaceKind::QUADRIC:
+    return quadric_normal(r, c[0], c[1], c[2], c[3], c[4], c[5], c[6], c[7],
+      c[8]);
+  default:
+    return {0., 0., 0.};
+  }
+}
+
+//==============================================================================
+
+bool FlatGeometry::cell_contains(int32_t i, Position r, Direction u,
+  int32_t on_surface) const
+{
+  // Whether the point is on the side of a half-space given by a token. If the
+  // particle's surface attribute is set and matches the token, that overrides
+  // the determination based on the sense.
+  auto half_space = [&](int32_t token) {
+    if (token == on_surface) return true;
+    if (-token == on_surface) return false;
+    return surface_sense(std::abs(token) - 1, r, u) == (token > 0);
+  };
+
+  if (cell_simple_[i]) {
+    for (int32_t j = cell_token_offset_[i]; j < cell_token_offset_[i + 1];
+         ++j) {
+      if (!half_space(cell_tokens_[j])) return false;
+    }
+    return true;
+  }
+
+  // A cell without a region specification contains everything
+  int32_t begin = cell_region_offset_[i];
+  int32_t end = cell_region_offset_[i + 1];
+  if (begin == end) return true;
+
+  // The region is evaluated as in CSGCell::evaluate_region, keeping the
+  // operators being evaluated on a stack rather than recursing. A union is
+  // decided by its first true operand and an intersection by its first false
+  // one.
+  int32_t stack_end[MAX_REGION_DEPTH];
+  bool stack_decisive[MAX_REGION_DEPTH];
+  int depth = 0;
+  int32_t j = begin;
+  while (true) {
+    const auto& node {cell_region_[j]};
+    if (node.token >= OP_UNION) {
+      stack_end[depth] = j + node.size;
+      stack_decisive[depth] = (node.token == OP_UNION);
+      ++depth;
+      ++j;
+      continue;
+    }
+
+    // Pass the value of the half-space up to the operators it decides
+    bool value = half_space(node.token);
+    ++j;
+    while (true) {
+      if (depth == 0) return value;
+      if (value == stack_decisive[depth - 1]) {
+        j = stack_end[depth - 1];
+      } else if (j == stack_end[depth - 1]) {
+        value = !stack_decisive[depth - 1];
+      } else {
+        break;
+      }
+      --depth;
+    }
+  }
+}
+
+double FlatGeometry::cell_distance(int32_t i, Position r, Direction u,
+  int32_t on_surface, int32_t& i_surf) const
+{
+  double min_dist {INFTY};
+  i_surf = std::numeric_limits<int32_t>::max();
+  for (int32_t j = cell_token_offset_[i]; j < cell_token_offset_[i + 1]; ++j) {
+    int32_t token = cell_tokens_[j];
+
+    // Calculate the distance to this surface.
+    bool coincident {std::abs(token) == std::abs(on_surface)};
+    double d = surface_distance(std::abs(token) - 1, r, u, coincident);
+
+    // Check if this distance is the new minimum.
+    if (d < min_dist) {
+      if (std::abs(d - min_dist) / min_dist >= FP_PRECISION) {
+        min_dist = d;
+        i_surf = -token;
+      }
+    }
+  }
+  return min_dist;
+}
+
+//==============================================================================
+
+std::array<int, 3> FlatGeometry::lattice_indices(int32_t i, Position r,
+  Direction u) const
+{
+  if (lattice_type_[i] == LatticeType::rect) {
+    return rect_lattice_indices(i, r, u);
+  } else {
+    return hex_lattice_indices(i, r, u);
+  }
+}
+
+std::array<int, 3> FlatGeometry::rect_lattice_indices(int32_t i, Position r,
+  Direction u) const
+{
+  const auto& lower_left {lattice_origin_[i]};
+  const auto& pitch {lattice_pitch_[i]};
+
+  // Determine the index along an axis, accounting for coincidence
+  auto index = [](double x, double x0, double p, double u) {
+    double i_ {(x - x0) / p};
+    long i_close {std::lround(i_)};
+    if (coincident(i_, i_close)) {
+      return (u > 0) ? static_cast<int>(i_close) :
+        static_cast<int>(i_close - 1);
+    }
+    return static_cast<int>(std::floor(i_));
+  };
+
+  int ix = index(r.x, lower_left.x, pitch.x, u.x);
+  int iy = index(r.y, lower_left.y, pitch.y, u.y);
+  int iz = lattice_is_3d_[i] ? index(r.z, lower_left.z, pitch.z, u.z) : 0;
+  return {ix, iy, iz};
+}
+
+std::array<int, 3> FlatGeometry::hex_lattice_indices(int32_t i, Position r,
+  Direction u) const
+{
+  const auto& center {lattice_origin_[i]};
+  const auto& pitch {lattice_pitch_[i]};
+  int n_rings = lattice_shape_[i][0];
+  int n_axial = lattice_shape_[i][1];
+  bool orientation_y = (lattice_shape_[i][2] == 0);
+
+  // Offset the xyz by the lattice center.
+  Position r_o {r.x - center.x, r.y - center.y, r.z};
+  if (lattice_is_3d_[i]) r_o.z -= center.z;
+
+  // Index the z direction, accounting for coincidence
+  int iz = 0;
+  if (lattice_is_3d_[i]) {
+    double iz_ {r_o.z / pitch.y + 0.5 * n_axial};
+    long iz_close {std::lround(iz_)};
+    if (coincident(iz_, iz_close)) {
+      iz = (u.z > 0) ? iz_close : iz_close - 1;
+    } else {
+      iz = std::floor(iz_);
+    }
+  }
+
+  // Round to the tile with the closest center, which contains the particle
+  // unless it is on or very close to one of its sides
+  int i1, i2;
+  hex_nearest_tile(i, r_o, i1, i2);
+  i1 += n_rings - 1;
+  i2 += n_rings - 1;
+
+  Position r_t = lattice_local_position(i, r, {i1, i2, 0});
+  bool near_side = false;
+  for (const auto& n : lattice_face_normals_[i]) {
+    double proj = std::abs(n[0]*r_t.x + n[1]*r_t.y);
+    if (0.5*pitch.x - proj <= HexLattice::HEX_SIDE_TOLERANCE * pitch.x) {
+      near_side = true;
+      break;
+    }
+  }
+  if (!near_side) return {i1, i2, iz};
+
+  // Otherwise, compare the distances to the centers of the candidate tiles as
+  // HexLattice::get_indices does, which accounts for the particle's direction
+  if (orientation_y) {
+    double alpha = r_o.y - r_o.x / std::sqrt(3.0);
+    i1 = std::floor(r_o.x / (0.5*std::sqrt(3.0) * pitch.x));
+    i2 = std::floor(alpha / pitch.x);
+  } else {
+    double alpha = r_o.y - r_o.x * std::sqrt(3.0);
+    i1 = std::floor(-alpha / (std::sqrt(3.0) * pitch.x));
+    i2 = std::floor(r_o.y / (0.5*std::sqrt(3.0) * pitch.x));
+  }
+  i1 += n_rings - 1;
+  i2 += n_rings - 1;
+
+  int i1_chg {};
+  int i2_chg {};
+  double d_min {INFTY};
+  double dp_min {INFTY};
+  for (int k = 0; k < 2; k++) {
+    for (int j = 0; j < 2; j++) {
+      Position r_t = lattice_local_position(i, r, {i1 + j, i2 + k, 0});
+      double d = r_t.x*r_t.x + r_t.y*r_t.y;
+      bool on_boundary = coincident(1.0, d_min/d);
+      if (d < d_min || on_boundary) {
+        r_t /= std::sqrt(d);
+        double dp = u.x * r_t.x + u.y * r_t.y;
+        if (on_boundary && dp > dp_min) continue;
+        d_min = d;
+        i1_chg = j;
+        i2_chg = k;
+        dp_min = dp;
+      }
+    }
+  }
+
+  return {i1 + i1_chg, i2 + i2_chg, iz};
+}
+
+void FlatGeometry::hex_nearest_tile(int32_t i, Position r, int& i1,
+  int& i2) const
+{
+  // Express the position in units of the vectors between neighboring tile
+  // centers and round the equivalent cube coordinates, as
+  // HexLattice::nearest_tile
+  double pitch = lattice_pitch_[i].x;
+  double a, b;
+  if (lattice_shape_[i][2] == 0) {
+    a = r.x / (0.5*std::sqrt(3.0) * pitch);
+    b = r.y / pitch - 0.5*a;
+  } else {
+    b = r.y / (0.5*std::sqrt(3.0) * pitch);
+    a = r.x / pitch - 0.5*b;
+  }
+
+  double c = -a - b;
+  double ra = std::round(a);
+  double rb = std::round(b);
+  double rc = std::round(c);
+  double da = std::abs(ra - a);
+  double db = std::abs(rb - b);
+  double dc = std::abs(rc - c);
+  if (da > db && da > dc) {
+    ra = -rb - rc;
+  } else if (db > dc) {
+    rb = -ra - rc;
+  }
+  i1 = ra;
+  i2 = rb;
+}
+
+Position FlatGeometry::lattice_local_position(int32_t i, Position r,
+  const std::array<int, 3>& i_xyz) const
+{
+  const auto& origin {lattice_origin_[i]};
+  const auto& pitch {lattice_pitch_[i]};
+  if (lattice_type_[i] == LatticeType::rect) {
+    r.x -= (origin.x + (i_xyz[0] + 0.5)*pitch.x);
+    r.y -= (origin.y + (i_xyz[1] + 0.5)*pitch.y);
+    if (lattice_is_3d_[i]) {
+      r.z -= (origin.z + (i_xyz[2] + 0.5)*pitch.z);
+    }
+    return r;
+  }
+
+  // The same expressions as HexLattice::get_local_position, so that the
+  // results are identical
+  int n_rings = lattice_shape_[i][0];
+  int n_axial = lattice_shape_[i][1];
+  if (lattice_shape_[i][2] == 0) {
+    r.x -= origin.x
+           + std::sqrt(3.0)/2.0 * (i_xyz[0] - n_rings + 1) * pitch.x;
+    r.y -= (origin.y + (i_xyz[1] - n_rings + 1) * pitch.x
+            + (i_xyz[0] - n_rings + 1) * pitch.x / 2.0);
+  } else {
+    r.x -= (origin.x + (i_xyz[0] - n_rings + 1) * pitch.x
+            + (i_xyz[1] - n_rings + 1) * pitch.x / 2.0);
+    r.y -= origin.y
+           + std::sqrt(3.0)/2.0 * (i_xyz[1] - n_rings + 1) * pitch.x;
+  }
+  if (lattice_is_3d_[i]) {
+    r.z -= origin.z - (0.5 * n_axial - i_xyz[2] - 0.5) * pitch.y;
+  }
+  return r;
+}
+
+std::pair<double, std::array<int, 3>> FlatGeometry::lattice_distance(
+  int32_t i, Position r, Direction u, const std::array<int, 3>& i_xyz) const
+{
+  const auto& pitch {lattice_pitch_[i]};
+  double d {INFTY};
+  std::array<int, 3> lattice_trans;
+
+  if (lattice_type_[i] == LatticeType::rect) {
+    // Left and right, then front and back sides, as RectLattice::distance
+    double x0 {std::copysign(0.5 * pitch.x, u.x)};
+    double y0 {std::copysign(0.5 * pitch.y, u.y)};
+    if ((std::abs(r.x - x0) > FP_PRECISION) && u.x != 0) {
+      d = (x0 - r.x) / u.x;
+      lattice_trans = {(u.x > 0) ? 1 : -1, 0, 0};
+    }
+    if ((std::abs(r.y - y0) > FP_PRECISION) && u.y != 0) {
+      double this_d = (y0 - r.y) / u.y;
+      if (this_d < d) {
+        d = this_d;
+        lattice_trans = {0, (u.y > 0) ? 1 : -1, 0};
+      }
+    }
+  } else {
+    // Sides of the hexagonal tile, measured from the neighbor tile the
+    // particle is heading towards, as HexLattice::distance
+    for (int k = 0; k < 3; ++k) {
+      const auto& n {lattice_face_normals_[i][k]};
+      double dir = n[0]*u.x + n[1]*u.y;
+      if (dir == 0) continue;
+
+      int sign = (dir > 0) ? 1 : -1;
+      std::array<int, 3> trans {sign*HEX_FACE_SHIFT[k][0],
+        sign*HEX_FACE_SHIFT[k][1], 0};
+      Position r_t = lattice_local_position(i, r,
+        {i_xyz[0] + trans[0], i_xyz[1] + trans[1], i_xyz[2]});
+
+      double edge = -std::copysign(0.5*pitch.x, dir);
+      double proj = n[0]*r_t.x + n[1]*r_t.y;
+      if (std::abs(proj - edge) > FP_PRECISION) {
+        double this_d = (edge - proj) / dir;
+        if (this_d < d) {
+          d = this_d;
+          lattice_trans = trans;
+        }
+      }
+    }
+  }
+
+  // Top and bottom sides
+  if (lattice_is_3d_[i]) {
+    double pitch_z = (lattice_type_[i] == LatticeType::rect) ? pitch.z :
+      pitch.y;
+    double z0 {std::copysign(0.5 * pitch_z, u.z)};
+    if ((std::abs(r.z - z0) > FP_PRECISION) && u.z != 0) {
+      double this_d = (z0 - r.z) / u.z;
+      if (this_d < d) {
+        d = this_d;
+        lattice_trans = {0, 0, (u.z > 0) ? 1 : -1};
+      }
+    }
+  }
+
+  return {d, lattice_trans};
+}
+
+int32_t FlatGeometry::lattice_universe(int32_t i,
+  const std::array<int, 3>& i_xyz) const
+{
+  const auto& shape {lattice_shape_[i]};
+  int index;
+  if (lattice_type_[i] == LatticeType::rect) {
+    for (int k = 0; k < 3; ++k) {
+      if (i_xyz[k] < 0 || i_xyz[k] >= shape[k]) return lattice_outer_[i];
+    }
+    index = shape[0]*shape[1]*i_xyz[2] + shape[0]*i_xyz[1] + i_xyz[0];
+  } else {
+    // Check if (x, alpha, z) indices are valid, accounting for number of rings
+    int n_rings = shape[0];
+    int n = 2*n_rings - 1;
+    if (i_xyz[0] < 0 || i_xyz[1] < 0 || i_xyz[2] < 0 || i_xyz[0] >= n ||
+        i_xyz[1] >= n || i_xyz[0] + i_xyz[1] <= n_rings - 2 ||
+        i_xyz[0] + i_xyz[1] >= 3*n_rings - 2 || i_xyz[2] >= shape[1]) {
+      return lattice_outer_[i];
+    }
+    index = n*n*i_xyz[2] + n*i_xyz[1] + i_xyz[0];
+  }
+  return lattice_universes_[lattice_offset_[i] + index];
+}
+
+//==============================================================================
+
+BoundaryInfo FlatGeometry::distance_to_boundary(const LocalCoord* coord,
+  int n_coord, int32_t on_surface,
+  const std::pair<double, int32_t>* cell_distance, bool& lost) const
+{
+  // The levels are visited as in openmc::distance_to_boundary, which this
+  // must match exactly
+  BoundaryInfo info;
+  double d_lat = INFINITY;
+  double d_surf = INFINITY;
+  int32_t level_surf_cross;
+  std::array<int, 3> level_lat_trans {};
+  lost = false;
+
+  for (int i = 0; i < n_coord; i++) {
+    Position r {coord[i].r};
+    Direction u {coord[i].u};
+    int32_t i_cell = coord[i].cell;
+
+    // Find the oncoming surface in this cell and the distance to it
+    if (cell_distance && i == n_coord - 1) {
+      d_surf = cell_distance->first;
+      level_surf_cross = cell_distance->second;
+    } else {
+      d_surf = this->cell_distance(i_cell, r, u, on_surface,
+        level_surf_cross);
+    }
+
+    // Find the distance to the next lattice tile crossing. Hexagonal lattices
+    // measure it in the coordinates of the lattice.
+    if (coord[i].lattice != C_NONE) {
+      int32_t i_lat = coord[i].lattice;
+      std::array<int, 3> i_xyz {coord[i].lattice_x, coord[i].lattice_y,
+        coord[i].lattice_z};
+      Position r_lat {r};
+      if (lattice_type_[i_lat] == LatticeType::hex) {
+        int32_t above = coord[i-1].cell;
+        r_lat = coord[i-1].r;
+        r_lat -= cell_translation_[above];
+        if (coord[i].rotated) {
+          const double* m = &cell_rotations_[cell_rotation_offset_[above]];
+          r_lat = {
+            r_lat.x*m[0] + r_lat.y*m[1] + r_lat.z*m[2],
+            r_lat.x*m[3] + r_lat.y*m[4] + r_lat.z*m[5],
+            r_lat.x*m[6] + r_lat.y*m[7] + r_lat.z*m[8]
+          };
+        }
+        r_lat.z = r.z;
+      }
+      auto lattice_distance = this->lattice_distance(i_lat, r_lat, u, i_xyz);
+      d_lat = lattice_distance.first;
+      level_lat_trans = lattice_distance.second;
+      if (d_lat < 0) lost = true;
+    }
+
+    // Boundaries coincident with one on a higher level are left to the higher
+    // level, within floating point precision
+    double& d = info.distance;
+    if (d_surf < d_lat - FP_COINCIDENT) {
+      if (d == INFINITY || (d - d_surf)/d >= FP_REL_PRECISION) {
+        d = d_surf;
+
+        // The region of a complex cell may hold both half-spaces of the
+        // surface, so the one the particle moves into is found from its normal
+        if (cell_simple_[i_cell]) {
+          info.surface_index = level_surf_cross;
+        } else {
+          Position r_hit = r + d_surf * u;
+          Direction norm = surface_normal(std::abs(level_surf_cross) - 1,
+            r_hit);
+          if (u.dot(norm) > 0) {
+            info.surface_index = std::abs(level_surf_cross);
+          } else {
+            info.surface_index = -std::abs(level_surf_cross);
+          }
+        }
+
+        info.lattice_translation = {0, 0, 0};
+        info.coord_level = i + 1;
+      }
+    } else {
+      if (d == INFINITY || (d - d_lat)/d >= FP_REL_PRECISION) {
+        d = d_lat;
+        info.surface_index = 0;
+        info.lattice_translation = level_lat_trans;
+        info.coord_level = i + 1;
+      }
+    }
+  }
+  return info;
+}
+
+#ifdef OPENMC_OFFLOAD
+#pragma omp end declare target
+
+//==============================================================================
+// Offloading
+//==============================================================================
+
+namespace {
+
+//! Device memory holding copies of the arrays of the flat geometry
+std::vector<void*> device_allocations;
+
+//! Copy an array to the default offload device
+//! \param v Array on the host
+//! \return Pointer to the copy on the device, or nullptr if v is empty
+template<typename T>
+const T* copy_to_device(const std::vector<T>& v)
+{
+  if (v.empty()) return nullptr;
+  int device = omp_get_default_device();
+  size_t bytes = v.size() * sizeof(T);
+  void* d = omp_target_alloc(bytes, device);
+  if (!d) fatal_error("Could not allocate the flat geometry on the device.");
+  omp_target_memcpy(d, v.data(), bytes, 0, 0, device,
+    omp_get_initial_device());
+  device_allocations.push_back(d);
+  return static_cast<const T*>(d);
+}
+
+} // namespace
+
+void copy_flat_geometry_to_device()
+{
+  free_flat_geometry_device();
+
+  const auto& a {model::flat_geometry_arrays};
+  auto& g {model::device_flat_geometry};
+  g = model::flat_geometry;
+  g.surface_kind_ = copy_to_device(a.surface_kind);
+  g.surface_offset_ = copy_to_device(a.surface_offset);
+  g.surface_coeffs_ = copy_to_device(a.surface_coeffs);
+  g.cell_type_ = copy_to_device(a.cell_type);
+  g.cell_universe_ = copy_to_device(a.cell_universe);
+  g.cell_fill_ = copy_to_device(a.cell_fill);
+  g.cell_simple_ = copy_to_device(a.cell_simple);
+  g.cell_token_offset_ = copy_to_device(a.cell_token_offset);
+  g.cell_tokens_ = copy_to_device(a.cell_tokens);
+  g.cell_region_offset_ = copy_to_device(a.cell_region_offset);
+  g.cell_region_ = copy_to_device(a.cell_region);
+  g.cell_material_offset_ = copy_to_device(a.cell_material_offset);
+  g.cell_materials_ = copy_to_device(a.cell_materials);
+  g.cell_translation_ = copy_to_device(a.cell_translation);
+  g.cell_rotation_offset_ = copy_to_device(a.cell_rotation_offset);
+  g.cell_rotations_ = copy_to_device(a.cell_rotations);
+  g.universe_offset_ = copy_to_device(a.universe_offset);
+  g.universe_cells_ = copy_to_device(a.universe_cells);
+  g.lattice_type_ = copy_to_device(a.lattice_type);
+  g.lattice_outer_ = copy_to_device(a.lattice_outer);
+  g.lattice_is_3d_ = copy_to_device(a.lattice_is_3d);
+  g.lattice_shape_ = copy_to_device(a.lattice_shape);
+  g.lattice_origin_ = copy_to_device(a.lattice_origin);
+  g.lattice_pitch_ = copy_to_device(a.lattice_pitch);
+  g.lattice_face_normals_ = copy_to_device(a.lattice_face_normals);
+  g.lattice_offset_ = copy_to_device(a.lattice_offset);
+  g.lattice_universes_ = copy_to_device(a.lattice_universes);
+}
+
+void free_flat_geometry_device()
+{
+  int device = omp_get_default_device();
+  for (void* d : device_allocations) omp_target_free(d, device);
+  device_allocations.clear();
+  model::device_flat_geometry.clear();
+}
+
+void device_distance_to_boundary(int64_t n, int n_levels,
+  const LocalCoord* coord, const int* n_coord, const int32_t* on_surface,
+  BoundaryInfo* info, uint8_t* lost)
+{
+  // The flat geometry only holds pointers to device memory, so it is copied to
+  // the device as it is
+  FlatGeometry geom {model::device_flat_geometry};
+  #pragma omp target teams distribute parallel for firstprivate(geom) \
+    map(to: coord[:n*n_levels], n_coord[:n], on_surface[:n]) \
+    map(from: info[:n], lost[:n])
+  for (int64_t i = 0; i < n; ++i) {
+    bool lost_i;
+    info[i] = geom.distance_to_boundary(&coord[i*n_levels], n_coord[i],
+      on_surface[i], nullptr, lost_i);
+    lost[i] = lost_i;
+  }
+}
+
+#endif // OPENMC_OFFLOAD
+
+} // namespace openmc
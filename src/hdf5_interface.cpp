@@ -1,9 +1,14 @@
 #include "openmc/hdf5_interface.h"
 
+#include <algorithm> // for max, min
 #include <array>
+#include <cstdint> // for int64_t
 #include <cstring>
+#include <fstream>
 #include <stdexcept>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "xtensor/xtensor.hpp"
 #include "xtensor/xarray.hpp"
@@ -19,6 +24,15 @@
 
 namespace openmc {
 
+std::mutex hdf5_mutex;
+
+namespace {
+
+//! Contents of HDF5 files read by the master process, indexed by path
+std::unordered_map<std::string, std::vector<char>> file_images;
+
+} // namespace
+
 bool
 attribute_exists(hid_t obj_id, const char* name)
 {
@@ -191,6 +205,21 @@ file_open(const char* filename, char mode, bool parallel)
       fatal_error(fmt::format("Invalid file mode: ", mode));
   }
 
+  // Open the image of a file broadcast from the master process. The image
+  // stays owned by file_images.
+  if (mode == 'r' && !parallel && !file_images.empty()) {
+    auto it = file_images.find(filename);
+    if (it != file_images.end()) {
+      hid_t file_id = H5LTopen_file_image(it->second.data(), it->second.size(),
+        H5LT_FILE_IMAGE_DONT_COPY | H5LT_FILE_IMAGE_DONT_RELEASE);
+      if (file_id < 0) {
+        fatal_error(fmt::format(
+          "Failed to open image of HDF5 file: {}", filename));
+      }
+      return file_id;
+    }
+  }
+
   hid_t plist = H5P_DEFAULT;
 #ifdef PHDF5
   if (parallel) {
@@ -226,6 +255,38 @@ file_open(const std::string& filename, char mode, bool parallel)
   return file_open(filename.c_str(), mode, parallel);
 }
 
+void broadcast_file_image(const std::string& filename)
+{
+#ifdef OPENMC_MPI
+  if (mpi::n_procs == 1) return;
+  if (file_images.find(filename) != file_images.end()) return;
+
+  // A negative size tells the other processes that the master process
+  // couldn't open the file, which is then opened from disk as usual
+  std::ifstream file;
+  int64_t size = -1;
+  if (mpi::master) {
+    file.open(filename, std::ios::binary | std::ios::ate);
+    if (file) size = file.tellg();
+  }
+  MPI_Bcast(&size, 1, MPI_INT64_T, 0, mpi::intracomm);
+  if (size < 0) return;
+
+  auto& image = file_images[filename];
+  image.resize(size);
+  if (mpi::master) {
+    file.seekg(0);
+    file.read(image.data(), size);
+  }
+  mpi::broadcast_bytes(image.data(), size);
+#endif
+}
+
+void free_file_images()
+{
+  file_images.clear();
+}
+
 void file_close(hid_t file_id)
 {
   H5Fclose(file_id);
@@ -406,6 +467,20 @@ object_name(hid_t obj_id)
 }
 
 
+std::string
+file_name(hid_t obj_id)
+{
+  // Determine size and create buffer
+  size_t size = 1 + H5Fget_name(obj_id, nullptr, 0);
+  std::string str(size, '\0');
+
+  // Read and return name, removing the trailing null character
+  H5Fget_name(obj_id, &str[0], size);
+  str.resize(size - 1);
+  return str;
+}
+
+
 hid_t
 open_dataset(hid_t group_id, const char* name)
 {
@@ -494,17 +569,10 @@ void read_dataset(hid_t dset, xt::xarray<std::complex<double>>& arr, bool indep)
   // Get shape of dataset
   std::vector<hsize_t> shape = object_shape(dset);
 
-  // Allocate new array to read data into
-  std::size_t size = 1;
-  for (const auto x : shape)
-    size *= x;
-  std::vector<std::complex<double>> buffer(size);
-
-  // Read data from attribute
-  read_complex(dset, nullptr, buffer.data(), indep);
-
-  // Adapt into xarray
-  arr = xt::adapt(buffer, shape);
+  // Read data into the array itself. std::complex<double> has the layout of
+  // the compound type of real and imaginary parts.
+  arr.resize(shape);
+  read_complex(dset, nullptr, arr.data(), indep);
 }
 
 
@@ -574,13 +642,11 @@ void
 read_tally_results(hid_t group_id, hsize_t n_filter, hsize_t n_score,
                    double* results)
 {
-  // Create dataspace for hyperslab in memory
+  // The sums and sums of squares are laid out in memory as in the dataset.
+  // Giving the shape of the buffer makes HDF5 check that the dataset fits it.
   constexpr int ndim = 3;
-  hsize_t dims[ndim] {n_filter, n_score, 3};
-  hsize_t start[ndim] {0, 0, 1};
-  hsize_t count[ndim] {n_filter, n_score, 2};
+  hsize_t dims[ndim] {n_filter, n_score, 2};
   hid_t memspace = H5Screate_simple(ndim, dims, nullptr);
-  H5Sselect_hyperslab(memspace, H5S_SELECT_SET, start, nullptr, count, nullptr);
 
   // Read the dataset
   read_dataset_lowlevel(group_id, "results", H5T_NATIVE_DOUBLE, memspace,
@@ -742,26 +808,66 @@ write_string(hid_t group_id, const char* name, const std::string& buffer,
 }
 
 
+hid_t
+tally_results_dcpl(hsize_t n_filter, hsize_t n_score, int compression)
+{
+  // Datasets are only compressed when requested and the filter is available
+  if (compression <= 0 || n_filter == 0 || n_score == 0) return H5P_DEFAULT;
+  if (H5Zfilter_avail(H5Z_FILTER_DEFLATE) <= 0) return H5P_DEFAULT;
+
+  // Chunks hold whole combinations of filter bins and are no larger than the
+  // default chunk cache of 1 MiB so that each is compressed only once
+  constexpr hsize_t CHUNK_BYTES {1 << 20};
+  hsize_t bytes_per_bin = n_score * 2 * sizeof(double);
+  hsize_t n_bins = std::max<hsize_t>(1, CHUNK_BYTES / bytes_per_bin);
+  hsize_t chunk[] {std::min(n_filter, n_bins), n_score, 2};
+
+  // Shuffling the bytes of the values first makes the long runs of zeros in
+  // sparsely populated tallies compress much better
+  hid_t dcpl = H5Pcreate(H5P_DATASET_CREATE);
+  H5Pset_chunk(dcpl, 3, chunk);
+  H5Pset_shuffle(dcpl);
+  H5Pset_deflate(dcpl, compression);
+  return dcpl;
+}
+
+
 void
 write_tally_results(hid_t group_id, hsize_t n_filter, hsize_t n_score,
-                    const double* results)
+                    const double* results, int compression)
 {
-  // Set dimensions of sum/sum_sq hyperslab to store
+  // The sums and sums of squares are laid out in memory as in the dataset
   constexpr int ndim = 3;
   hsize_t count[ndim] {n_filter, n_score, 2};
 
-  // Set dimensions of results array
-  hsize_t dims[ndim] {n_filter, n_score, 3};
-  hsize_t start[ndim] {0, 0, 1};
-  hid_t memspace = H5Screate_simple(ndim, dims, nullptr);
-  H5Sselect_hyperslab(memspace, H5S_SELECT_SET, start, nullptr, count, nullptr);
-
   // Create and write dataset
-  write_dataset_lowlevel(group_id, ndim, count, "results", H5T_NATIVE_DOUBLE,
-                         memspace, false, results);
+  // Compressed datasets can't be written collectively by older versions of
+  // HDF5, so results are only compressed in files written by one process
+  hid_t dcpl = H5P_DEFAULT;
+  if (!using_mpio_device(group_id)) {
+    dcpl = tally_results_dcpl(n_filter, n_score, compression);
+  }
+  if (dcpl == H5P_DEFAULT) {
+    write_dataset_lowlevel(group_id, ndim, count, "results", H5T_NATIVE_DOUBLE,
+                           H5S_ALL, false, results);
+  } else {
+    hid_t dspace = H5Screate_simple(ndim, count, nullptr);
+    hid_t dset = H5Dcreate(group_id, "results", H5T_NATIVE_DOUBLE, dspace,
+                           H5P_DEFAULT, dcpl, H5P_DEFAULT);
+    H5Dwrite(dset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, results);
+    H5Dclose(dset);
+    H5Sclose(dspace);
+    H5Pclose(dcpl);
+  }
+}
 
-  // Free resources
-  H5Sclose(memspace);
+
+bool
+using_threadsafe_hdf5()
+{
+  hbool_t threadsafe;
+  H5is_library_threadsafe(&threadsafe);
+  return threadsafe;
 }
 
 
@@ -799,6 +905,8 @@ template<>
 const hid_t H5TypeMap<int64_t>::type_id = H5T_NATIVE_INT64;
 template<>
 const hid_t H5TypeMap<double>::type_id = H5T_NATIVE_DOUBLE;
+template<>
+const hid_t H5TypeMap<float>::type_id = H5T_NATIVE_FLOAT;
 template <>
 const hid_t H5TypeMap<char>::type_id = H5T_NATIVE_CHAR;
 
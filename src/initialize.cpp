@@ -12,24 +12,30 @@
 #include <fmt/core.h>
 
 #include "openmc/capi.h"
+#include "openmc/cmfd.h"
 #include "openmc/constants.h"
 #include "openmc/cross_sections.h"
+#include "openmc/delta_tracking.h"
 #include "openmc/error.h"
 #include "openmc/geometry_aux.h"
 #include "openmc/hdf5_interface.h"
 #include "openmc/material.h"
+#include "openmc/memory_placement.h"
 #include "openmc/message_passing.h"
 #include "openmc/mgxs_interface.h"
 #include "openmc/nuclide.h"
 #include "openmc/output.h"
 #include "openmc/plot.h"
 #include "openmc/random_lcg.h"
+#include "openmc/random_ray.h"
 #include "openmc/settings.h"
 #include "openmc/simulation.h"
+#include "openmc/source.h"
 #include "openmc/string_utils.h"
 #include "openmc/summary.h"
 #include "openmc/tallies/tally.h"
 #include "openmc/thermal.h"
+#include "openmc/thread_affinity.h"
 #include "openmc/timer.h"
 
 
@@ -100,24 +106,36 @@ void initialize_mpi(MPI_Comm intracomm)
   MPI_Comm_rank(intracomm, &mpi::rank);
   mpi::master = (mpi::rank == 0);
 
-  // Create bank datatype
+  // Group the ranks that are able to share memory, i.e., those on one node
+  MPI_Comm_split_type(intracomm, MPI_COMM_TYPE_SHARED, mpi::rank,
+    MPI_INFO_NULL, &mpi::node_comm);
+
+  // Create bank datatype. Banks are only exchanged once the fission bank has
+  // been sorted, after which the parent and progeny ids are no longer needed,
+  // so they are left out of the datatype and are not sent between processes.
   Particle::Bank b;
-  MPI_Aint disp[8];
+  MPI_Aint disp[7];
   MPI_Get_address(&b.r, &disp[0]);
   MPI_Get_address(&b.u, &disp[1]);
   MPI_Get_address(&b.E, &disp[2]);
   MPI_Get_address(&b.wgt, &disp[3]);
-  MPI_Get_address(&b.delayed_group, &disp[4]);
-  MPI_Get_address(&b.particle, &disp[5]);
-  MPI_Get_address(&b.parent_id, &disp[6]);
-  MPI_Get_address(&b.progeny_id, &disp[7]);
-  for (int i = 7; i >= 0; --i) {
+  MPI_Get_address(&b.time, &disp[4]);
+  MPI_Get_address(&b.delayed_group, &disp[5]);
+  MPI_Get_address(&b.particle, &disp[6]);
+  for (int i = 6; i >= 0; --i) {
     disp[i] -= disp[0];
   }
 
-  int blocks[] {3, 3, 1, 1, 1, 1, 1, 1};
-  MPI_Datatype types[] {MPI_DOUBLE, MPI_DOUBLE, MPI_DOUBLE, MPI_DOUBLE, MPI_INT, MPI_INT, MPI_LONG, MPI_LONG};
-  MPI_Type_create_struct(8, blocks, disp, types, &mpi::bank);
+  int blocks[] {3, 3, 1, 1, 1, 1, 1};
+  MPI_Datatype types[] {MPI_DOUBLE, MPI_DOUBLE, MPI_DOUBLE, MPI_DOUBLE,
+    MPI_DOUBLE, MPI_INT, MPI_INT};
+  MPI_Datatype site;
+  MPI_Type_create_struct(7, blocks, disp, types, &site);
+
+  // Give the datatype the extent of a full bank site so that arrays of sites
+  // can be exchanged
+  MPI_Type_create_resized(site, 0, sizeof(Particle::Bank), &mpi::bank);
+  MPI_Type_free(&site);
   MPI_Type_commit(&mpi::bank);
 }
 #endif // OPENMC_MPI
@@ -252,6 +270,11 @@ parse_command_line(int argc, char* argv[])
 void read_input_xml()
 {
   read_settings_xml();
+
+  // Pin threads before any data is read so that its pages are placed on the
+  // nodes of the threads that will use them
+  bind_threads();
+
   read_cross_sections_xml();
   read_materials_xml();
   read_geometry_xml();
@@ -261,10 +284,17 @@ void read_input_xml()
   double_2dvec thermal_temps(data::thermal_scatt_map.size());
   finalize_geometry(nuc_temps, thermal_temps);
 
+  // Start from the neighbor lists found by an earlier run
+  if (!settings::path_neighbor_lists.empty()) {
+    read_neighbor_lists(settings::path_neighbor_lists);
+  }
+
   if (settings::run_mode != RunMode::PLOTTING) {
     simulation::time_read_xs.start();
     if (settings::run_CE) {
-      // Read continuous-energy cross sections
+      // Read continuous-energy cross sections, spreading the pages first
+      // touched by the master thread among the NUMA nodes if requested
+      InterleaveScope interleave;
       read_ce_cross_sections(nuc_temps, thermal_temps);
     } else {
       // Create material macroscopic data for MGXS
@@ -275,7 +305,23 @@ void read_input_xml()
     simulation::time_read_xs.stop();
   }
 
+  // Build the acceptance grids of the source, which need to know which
+  // materials are fissionable
+  if (settings::run_mode != RunMode::PLOTTING) initialize_source_grids();
+
+  // Set up delta tracking, which needs the cross sections
+  initialize_delta_tracking();
+
+  // Set up the random ray solver, which also needs the cross sections
+  if (simulation::random_ray && (settings::run_mode == RunMode::EIGENVALUE ||
+      settings::run_mode == RunMode::FIXED_SOURCE)) {
+    simulation::random_ray->initialize();
+  }
+
   read_tallies_xml();
+  if (simulation::cmfd_accelerator) {
+    simulation::cmfd_accelerator->create_tallies();
+  }
 
   // Initialize distribcell_filters
   prepare_distribcell();
@@ -286,8 +332,11 @@ void read_input_xml()
     if (mpi::master && settings::verbosity >= 5) print_plot();
 
   } else {
-    // Write summary information
-    if (mpi::master && settings::output_summary) write_summary();
+    // Write summary information. A summary written in the background is only
+    // started once the simulation is initialized.
+    if (mpi::master && settings::output_summary && !settings::async_summary) {
+      write_summary();
+    }
 
     // Warn if overlap checking is on
     if (mpi::master && settings::check_overlaps) {
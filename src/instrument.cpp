@@ -0,0 +1,103 @@
+#include "openmc/instrument.h"
+
+#include <array>
+
+#ifdef OPENMC_ITT
+#include <ittnotify.h>
+#endif
+#ifdef OPENMC_NVTX
+#include <nvtx3/nvToolsExt.h>
+#endif
+
+namespace openmc {
+
+namespace {
+
+#ifdef OPENMC_ITT
+//! ITT domain and string handles of all regions, created on first use
+struct IttHandles {
+  IttHandles() : domain {__itt_domain_create("openmc")}
+  {
+    for (int i = 0; i < names.size(); ++i) {
+      names[i] = __itt_string_handle_create(region_name(
+        static_cast<Region>(i)));
+    }
+  }
+
+  __itt_domain* domain;
+  std::array<__itt_string_handle*,
+    static_cast<int>(Region::N_REGIONS)> names;
+};
+
+const IttHandles& itt_handles()
+{
+  static const IttHandles handles;
+  return handles;
+}
+#endif
+
+} // namespace
+
+//==============================================================================
+// InstrumentRegion implementation
+//==============================================================================
+
+#if defined(OPENMC_ITT) || defined(OPENMC_NVTX)
+void InstrumentRegion::begin_region(Region region)
+{
+#ifdef OPENMC_ITT
+  const auto& itt {itt_handles()};
+  __itt_task_begin(itt.domain, __itt_null, __itt_null,
+    itt.names[static_cast<int>(region)]);
+#endif
+#ifdef OPENMC_NVTX
+  nvtxRangePushA(region_name(region));
+#endif
+}
+
+void InstrumentRegion::end_region()
+{
+#ifdef OPENMC_ITT
+  __itt_task_end(itt_handles().domain);
+#endif
+#ifdef OPENMC_NVTX
+  nvtxRangePop();
+#endif
+}
+#endif
+
+//==============================================================================
+// Non-member functions
+//==============================================================================
+
+const char* region_name(Region region)
+{
+  switch (region) {
+  case Region::EVENT_INIT:
+    return "event initialization";
+  case Region::EVENT_CALCULATE_XS:
+    return "event calculate xs";
+  case Region::EVENT_ADVANCE:
+    return "event advance particle";
+  case Region::EVENT_SURFACE_CROSSING:
+    return "event surface crossing";
+  case Region::EVENT_COLLISION:
+    return "event collision";
+  case Region::EVENT_DEATH:
+    return "event death";
+  case Region::EVENT_HISTORY_TAIL:
+    return "event history tail";
+  case Region::CALCULATE_XS:
+    return "calculate xs";
+  case Region::DISTANCE_TO_BOUNDARY:
+    return "distance to boundary";
+  case Region::FIND_CELL:
+    return "find cell";
+  case Region::TALLY_SCORING:
+    return "tally scoring";
+  default:
+    return "unknown";
+  }
+}
+
+} // namespace openmc
@@ -1,5 +1,6 @@
 #include "openmc/lattice.h"
 
+#include <algorithm> // for max
 #include <cmath>
 #include <string>
 #include <vector>
@@ -92,19 +93,6 @@ Lattice::adjust_indices()
 
 //==============================================================================
 
-int32_t
-Lattice::fill_offset_table(int32_t offset, int32_t target_univ_id, int map,
-  std::unordered_map<int32_t, int32_t>& univ_count_memo)
-{
-  for (LatticeIter it = begin(); it != end(); ++it) {
-    offsets_[map * universes_.size() + it.indx_] = offset;
-    offset += count_universe_instances(*it, target_univ_id, univ_count_memo);
-  }
-  return offset;
-}
-
-//==============================================================================
-
 void
 Lattice::to_hdf5(hid_t lattices_group) const
 {
@@ -222,6 +210,26 @@ RectLattice::are_valid_indices(const int i_xyz[3]) const
 
 //==============================================================================
 
+bool
+RectLattice::tiles_match(int n_dimension, const double* lower_left,
+  const double* width, const int* shape) const
+{
+  if (n_dimension != (is_3d_ ? 3 : 2)) return false;
+
+  auto close = [](double a, double b) {
+    return std::abs(a - b) <= FP_COINCIDENT*std::max(1.0, std::abs(a));
+  };
+  for (int i = 0; i < n_dimension; ++i) {
+    if (shape[i] != n_cells_[i] || !close(lower_left[i], lower_left_[i]) ||
+        !close(width[i], pitch_[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+//==============================================================================
+
 std::pair<double, std::array<int, 3>>
 RectLattice::distance(Position r, Direction u, const std::array<int, 3>& i_xyz)
 const
@@ -421,6 +429,9 @@ RectLattice::to_hdf5_inner(hid_t lat_group) const
 // HexLattice implementation
 //==============================================================================
 
+constexpr int HexLattice::FACE_SHIFT[3][2];
+constexpr double HexLattice::HEX_SIDE_TOLERANCE;
+
 HexLattice::HexLattice(pugi::xml_node lat_node)
   : Lattice {lat_node}
 {
@@ -451,6 +462,18 @@ HexLattice::HexLattice(pugi::xml_node lat_node)
     orientation_ = Orientation::y;
   }
 
+  // The beta, gamma, and delta vectors point towards the flat sides of each
+  // hexagonal tile (see HexLattice::distance).
+  if (orientation_ == Orientation::y) {
+    face_normals_ = {{{std::sqrt(3.0) / 2.0, 0.5},
+                      {std::sqrt(3.0) / 2.0, -0.5},
+                      {0.0, 1.0}}};
+  } else {
+    face_normals_ = {{{1.0, 0.0},
+                      {0.5, -std::sqrt(3.0) / 2.0},
+                      {0.5, std::sqrt(3.0) / 2.0}}};
+  }
+
   // Read the lattice center.
   std::string center_str {get_node_value(lat_node, "center")};
   std::vector<std::string> center_words {split(center_str)};
@@ -699,104 +722,37 @@ const
   //   beta   = (1, 0)            = +30 degrees from basis0
   //   gamma  = (1/2, -sqrt(3)/2) = -60 degrees from beta
   //   delta  = (1/2, sqrt(3)/2)  = +60 degrees from beta
-  // The z-axis is considered separately.
-  double beta_dir;
-  double gamma_dir;
-  double delta_dir;
-  if (orientation_ == Orientation::y) {
-    beta_dir = u.x * std::sqrt(3.0) / 2.0  + u.y / 2.0;
-    gamma_dir = u.x * std::sqrt(3.0) / 2.0  - u.y / 2.0;
-    delta_dir = u.y;
-  } else {
-    beta_dir = u.x;
-    gamma_dir = u.x / 2.0  - u.y * std::sqrt(3.0) / 2.0;
-    delta_dir = u.x / 2.0  + u.y * std::sqrt(3.0) / 2.0;
-  }
+  // The normals of these sides are stored in face_normals_.  The z-axis is
+  // considered separately.
 
   // Note that hexagonal lattice distance calculations are performed
   // using the particle's coordinates relative to the neighbor lattice
   // cells, not relative to the particle's current cell.  This is done
   // because there is significant disagreement between neighboring cells
   // on where the lattice boundary is due to finite precision issues.
-
-  // beta direction
   double d {INFTY};
   std::array<int, 3> lattice_trans;
-  double edge = -copysign(0.5*pitch_[0], beta_dir);  // Oncoming edge
-  Position r_t;
-  if (beta_dir > 0) {
-    const std::array<int, 3> i_xyz_t {i_xyz[0]+1, i_xyz[1], i_xyz[2]};
-    r_t = get_local_position(r, i_xyz_t);
-  } else {
-    const std::array<int, 3> i_xyz_t {i_xyz[0]-1, i_xyz[1], i_xyz[2]};
-    r_t = get_local_position(r, i_xyz_t);
-  }
-  double beta;
-  if (orientation_ == Orientation::y) {
-    beta = r_t.x * std::sqrt(3.0) / 2.0 + r_t.y / 2.0;
-  } else {
-    beta = r_t.x;
-  }
-  if ((std::abs(beta - edge) > FP_PRECISION) && beta_dir != 0) {
-    d = (edge - beta) / beta_dir;
-    if (beta_dir > 0) {
-      lattice_trans = {1, 0, 0};
-    } else {
-      lattice_trans = {-1, 0, 0};
-    }
-  }
-
-  // gamma direction
-  edge = -copysign(0.5*pitch_[0], gamma_dir);
-  if (gamma_dir > 0) {
-    const std::array<int, 3> i_xyz_t {i_xyz[0]+1, i_xyz[1]-1, i_xyz[2]};
-    r_t = get_local_position(r, i_xyz_t);
-  } else {
-    const std::array<int, 3> i_xyz_t {i_xyz[0]-1, i_xyz[1]+1, i_xyz[2]};
-    r_t = get_local_position(r, i_xyz_t);
-  }
-  double gamma;
-  if (orientation_ == Orientation::y) {
-    gamma = r_t.x * std::sqrt(3.0) / 2.0 - r_t.y / 2.0;
-  } else {
-    gamma = r_t.x  / 2.0 - r_t.y * std::sqrt(3.0) / 2.0;
-  }
-  if ((std::abs(gamma - edge) > FP_PRECISION) && gamma_dir != 0) {
-    double this_d = (edge - gamma) / gamma_dir;
-    if (this_d < d) {
-      if (gamma_dir > 0) {
-        lattice_trans = {1, -1, 0};
-      } else {
-        lattice_trans = {-1, 1, 0};
-      }
-      d = this_d;
-    }
-  }
-
-  // delta direction
-  edge = -copysign(0.5*pitch_[0], delta_dir);
-  if (delta_dir > 0) {
-    const std::array<int, 3> i_xyz_t {i_xyz[0], i_xyz[1]+1, i_xyz[2]};
-    r_t = get_local_position(r, i_xyz_t);
-  } else {
-    const std::array<int, 3> i_xyz_t {i_xyz[0], i_xyz[1]-1, i_xyz[2]};
-    r_t = get_local_position(r, i_xyz_t);
-  }
-  double delta;
-  if (orientation_ == Orientation::y) {
-    delta =  r_t.y;
-  } else {
-    delta = r_t.x  / 2.0 + r_t.y * std::sqrt(3.0) / 2.0;
-  }
-  if ((std::abs(delta - edge) > FP_PRECISION) && delta_dir != 0) {
-    double this_d = (edge - delta) / delta_dir;
-    if (this_d < d) {
-      if (delta_dir > 0) {
-        lattice_trans = {0, 1, 0};
-      } else {
-        lattice_trans = {0, -1, 0};
+  for (int k = 0; k < 3; ++k) {
+    const auto& n {face_normals_[k]};
+    double dir = n[0]*u.x + n[1]*u.y;
+    if (dir == 0) continue;
+
+    // Position relative to the neighbor cell that the particle is heading
+    // towards along this direction
+    int sign = (dir > 0) ? 1 : -1;
+    std::array<int, 3> trans {sign*FACE_SHIFT[k][0], sign*FACE_SHIFT[k][1], 0};
+    const std::array<int, 3> i_xyz_t {i_xyz[0] + trans[0],
+      i_xyz[1] + trans[1], i_xyz[2]};
+    Position r_t = get_local_position(r, i_xyz_t);
+
+    double edge = -copysign(0.5*pitch_[0], dir);  // Oncoming edge
+    double proj = n[0]*r_t.x + n[1]*r_t.y;
+    if (std::abs(proj - edge) > FP_PRECISION) {
+      double this_d = (edge - proj) / dir;
+      if (this_d < d) {
+        d = this_d;
+        lattice_trans = trans;
       }
-      d = this_d;
     }
   }
 
@@ -842,7 +798,26 @@ HexLattice::get_indices(Position r, Direction u) const
     }
   }
 
+  // Round to the tile with the closest center.  Unless the particle is on or
+  // very close to the side of that tile, this is the tile containing it.
   int i1, i2;
+  nearest_tile(r_o, i1, i2);
+  i1 += n_rings_-1;
+  i2 += n_rings_-1;
+
+  Position r_t = get_local_position(r, {i1, i2, 0});
+  bool near_side = false;
+  for (const auto& n : face_normals_) {
+    double proj = std::abs(n[0]*r_t.x + n[1]*r_t.y);
+    if (0.5*pitch_[0] - proj <= HEX_SIDE_TOLERANCE * pitch_[0]) {
+      near_side = true;
+      break;
+    }
+  }
+  if (!near_side) return {i1, i2, iz};
+
+  // Otherwise, fall back to comparing the distances to the centers of the
+  // candidate tiles, which accounts for the particle's direction
   if (orientation_ == Orientation::y) {
     // Convert coordinates into skewed bases.  The (x, alpha) basis is used to
     // find the index of the global coordinates to within 4 cells.
@@ -921,6 +896,41 @@ HexLattice::get_indices(Position r, Direction u) const
 
 //==============================================================================
 
+void
+HexLattice::nearest_tile(Position r, int& i1, int& i2) const
+{
+  // Express the position in units of the vectors between neighboring tile
+  // centers, which are 60 degrees apart
+  double a, b;
+  if (orientation_ == Orientation::y) {
+    a = r.x / (0.5*std::sqrt(3.0) * pitch_[0]);
+    b = r.y / pitch_[0] - 0.5*a;
+  } else {
+    b = r.y / (0.5*std::sqrt(3.0) * pitch_[0]);
+    a = r.x / pitch_[0] - 0.5*b;
+  }
+
+  // Round the equivalent cube coordinates (a, b, -a - b) and restore the
+  // constraint that they sum to zero by recomputing the coordinate that
+  // changed the most
+  double c = -a - b;
+  double ra = std::round(a);
+  double rb = std::round(b);
+  double rc = std::round(c);
+  double da = std::abs(ra - a);
+  double db = std::abs(rb - b);
+  double dc = std::abs(rc - c);
+  if (da > db && da > dc) {
+    ra = -rb - rc;
+  } else if (db > dc) {
+    rb = -ra - rc;
+  }
+  i1 = ra;
+  i2 = rb;
+}
+
+//==============================================================================
+
 Position
 HexLattice::get_local_position(Position r, const std::array<int, 3> i_xyz)
 const
@@ -6,18 +6,23 @@
 #include <string>
 #include <sstream>
 
+#include <fmt/core.h>
 #include "xtensor/xbuilder.hpp"
+#include "xtensor/xmath.hpp"
 #include "xtensor/xoperation.hpp"
 #include "xtensor/xview.hpp"
 
 #include "openmc/capi.h"
+#include "openmc/cell.h"
 #include "openmc/cross_sections.h"
 #include "openmc/container_util.h"
 #include "openmc/dagmc.h"
 #include "openmc/error.h"
 #include "openmc/file_utils.h"
 #include "openmc/hdf5_interface.h"
+#include "openmc/instrument.h"
 #include "openmc/math_functions.h"
+#include "openmc/mesh_field.h"
 #include "openmc/message_passing.h"
 #include "openmc/mgxs_interface.h"
 #include "openmc/nuclide.h"
@@ -26,6 +31,7 @@
 #include "openmc/settings.h"
 #include "openmc/simulation.h"
 #include "openmc/string_utils.h"
+#include "openmc/tallies/tally.h"
 #include "openmc/thermal.h"
 #include "openmc/xml_interface.h"
 
@@ -39,9 +45,68 @@ namespace model {
 
 std::unordered_map<int32_t, int32_t> material_map;
 std::vector<std::unique_ptr<Material>> materials;
+std::map<std::vector<int>, int32_t> material_class_map;
+int max_material_nuclides {0};
 
 } // namespace model
 
+namespace {
+
+// Per-thread scratch arrays that hold the microscopic cross sections of each
+// nuclide in a material contiguously, so that the macroscopic cross sections
+// can be formed with a SIMD reduction (see settings::vectorize_xs)
+struct MicroXSScratch {
+  std::vector<double> total;
+  std::vector<double> absorption;
+  std::vector<double> fission;
+  std::vector<double> nu_fission;
+};
+
+thread_local MicroXSScratch micro_scratch;
+
+//! Map each bound of the equal-logarithmic neutron energy grid to the last
+//! interval of an energy grid that starts at or below it
+//
+//! \param energy Energies in [eV] in ascending order, at least two
+//! \return Index of the interval at each bound of the logarithmic grid
+std::vector<int> neutron_log_grid_index(const std::vector<double>& energy)
+{
+  int neutron = static_cast<int>(Particle::Type::neutron);
+  double E_min = data::energy_min[neutron];
+  int M = settings::n_log_bins;
+  int n = energy.size();
+  std::vector<int> index(M + 1);
+  int j = 0;
+  for (int k = 0; k <= M; ++k) {
+    while (std::log(energy[j + 1]/E_min) <= k*simulation::log_spacing) {
+      if (j + 2 == n) break;
+      ++j;
+    }
+    index[k] = j;
+  }
+  return index;
+}
+
+//! Find the interval of an energy grid indexed on the logarithmic grid
+//
+//! \param energy Energies in [eV] in ascending order
+//! \param index Index of the grid on the logarithmic grid
+//! \param i_log Bin of the logarithmic grid containing the energy
+//! \param E Energy in [eV]
+//! \return Index of the lower bound of the interval
+int neutron_log_grid_search(const std::vector<double>& energy,
+  const std::vector<int>& index, int i_log, double E)
+{
+  int n = energy.size();
+  if (E <= energy.front()) return 0;
+  if (E >= energy.back()) return n - 2;
+  int i_low  = index[i_log];
+  int i_high = index[i_log + 1] + 1;
+  return i_low + lower_bound_index(&energy[i_low], &energy[i_high], E);
+}
+
+} // namespace
+
 //==============================================================================
 // Material implementation
 //==============================================================================
@@ -64,6 +129,14 @@ Material::Material(pugi::xml_node node)
     depletable_ = get_node_value_bool(node, "depletable");
   }
 
+  if (check_for_node(node, "union_grid")) {
+    union_grid_ = get_node_value_bool(node, "union_grid");
+  }
+
+  if (check_for_node(node, "xs_table")) {
+    xs_table_ = get_node_value_bool(node, "xs_table");
+  }
+
   bool sum_density {false};
   pugi::xml_node density_node = node.child("density");
   std::string units;
@@ -349,13 +422,20 @@ void Material::finalize()
   }
 
   // Generate material bremsstrahlung data for electrons and positrons
-  if (settings::photon_transport && settings::electron_treatment == ElectronTreatment::TTB) {
+  if (settings::photon_transport &&
+      settings::electron_treatment != ElectronTreatment::LED) {
     this->init_bremsstrahlung();
+    if (settings::electron_treatment == ElectronTreatment::CH) {
+      this->init_condensed_history();
+    }
   }
 
   // Assign thermal scattering tables
   this->init_thermal();
 
+  // Determine which material class this material belongs to
+  this->init_class();
+
   // Normalize density
   this->normalize_density();
 }
@@ -457,6 +537,34 @@ void Material::init_thermal()
   thermal_tables_ = tables;
 }
 
+void Material::init_class()
+{
+  // Materials with the same nuclides (in the same order) and the same thermal
+  // scattering tables access exactly the same nuclear data during a cross
+  // section lookup and only differ in their atom densities. The signature
+  // below uniquely identifies such a set, and each distinct signature is
+  // given a dense index.
+  std::vector<int> signature {nuclide_};
+  signature.push_back(C_NONE);
+  for (const auto& table : thermal_tables_) {
+    signature.push_back(table.index_table);
+    signature.push_back(table.index_nuclide);
+  }
+
+  auto& class_map {model::material_class_map};
+  auto it = class_map.find(signature);
+  if (it == class_map.end()) {
+    int32_t index = class_map.size();
+    it = class_map.emplace(std::move(signature), index).first;
+  }
+  class_ = it->second;
+
+  // Since the class is updated whenever the nuclides change, this is also
+  // where the size needed for compact cross section caches is tracked
+  model::max_material_nuclides = std::max(model::max_material_nuclides,
+    static_cast<int>(nuclide_.size()));
+}
+
 void Material::collision_stopping_power(double* s_col, bool positron)
 {
   // Average electron number and average atomic weight
@@ -552,6 +660,56 @@ void Material::collision_stopping_power(double* s_col, bool positron)
   }
 }
 
+void Material::radiative_stopping_power(xt::xtensor<double, 2>& dcs,
+  xt::xtensor<double, 1>& s_rad, bool positron)
+{
+  double Z_eq_sq = 0.0;
+  double sum_density = 0.0;
+
+  // Calculate the molecular DCS and the molecular radiative stopping power using
+  // Bragg's additivity rule.
+  for (int i = 0; i < element_.size(); ++i) {
+    // Get pointer to current element
+    const auto& elm = data::elements[element_[i]];
+    double awr = data::nuclides[nuclide_[i]]->awr_;
+
+    // Get atomic density and mass density of nuclide given atom/weight percent
+    double atom_density = (atom_density_[0] > 0.0) ?
+      atom_density_[i] : -atom_density_[i] / awr;
+
+    // Calculate the "equivalent" atomic number Zeq of the material
+    Z_eq_sq += atom_density * elm.Z_ * elm.Z_;
+    sum_density += atom_density;
+
+    // Accumulate material DCS
+    dcs += (atom_density * elm.Z_ * elm.Z_) * elm.dcs_;
+
+    // Accumulate material radiative stopping power
+    s_rad += atom_density * elm.stopping_power_radiative_;
+  }
+  Z_eq_sq /= sum_density;
+
+  // Calculate the positron DCS and radiative stopping power. These are
+  // obtained by multiplying the electron DCS and radiative stopping powers by
+  // a factor r, which is a numerical approximation of the ratio of the
+  // radiative stopping powers for positrons and electrons. Source: F. Salvat,
+  // J. M. Fernández-Varea, and J. Sempau, "PENELOPE-2011: A Code System for
+  // Monte Carlo Simulation of Electron and Photon Transport," OECD-NEA,
+  // Issy-les-Moulineaux, France (2011).
+  if (positron) {
+    for (int i = 0; i < data::ttb_e_grid.size(); ++i) {
+      double t = std::log(1.0 + 1.0e6*data::ttb_e_grid(i)/(Z_eq_sq*MASS_ELECTRON_EV));
+      double r = 1.0 - std::exp(-1.2359e-1*t + 6.1274e-2*std::pow(t, 2)
+        - 3.1516e-2*std::pow(t, 3) + 7.7446e-3*std::pow(t, 4)
+        - 1.0595e-3*std::pow(t, 5) + 7.0568e-5*std::pow(t, 6)
+        - 1.808e-6*std::pow(t, 7));
+      s_rad(i) *= r;
+      auto dcs_i = xt::view(dcs, i, xt::all());
+      dcs_i *= r;
+    }
+  }
+}
+
 void Material::init_bremsstrahlung()
 {
   // Create new object
@@ -561,9 +719,6 @@ void Material::init_bremsstrahlung()
   auto n_k = data::ttb_k_grid.size();
   auto n_e = data::ttb_e_grid.size();
 
-  // Determine number of elements
-  int n = element_.size();
-
   for (int particle = 0; particle < 2; ++particle) {
     // Loop over logic twice, once for electron, once for positron
     BremsstrahlungData* ttb = (particle == 0) ? &ttb_->electron : &ttb_->positron;
@@ -573,60 +728,16 @@ void Material::init_bremsstrahlung()
     ttb->pdf = xt::zeros<double>({n_e, n_e});
     ttb->cdf = xt::zeros<double>({n_e, n_e});
     ttb->yield = xt::empty<double>({n_e});
+    if (settings::alias_sampling) ttb->alias.resize(n_e);
 
     // Allocate temporary arrays
     xt::xtensor<double, 1> stopping_power_collision({n_e}, 0.0);
     xt::xtensor<double, 1> stopping_power_radiative({n_e}, 0.0);
     xt::xtensor<double, 2> dcs({n_e, n_k}, 0.0);
 
-    double Z_eq_sq = 0.0;
-    double sum_density = 0.0;
-
-    // Get the collision stopping power of the material
+    // Get the collision and radiative stopping powers of the material
     this->collision_stopping_power(stopping_power_collision.data(), positron);
-
-    // Calculate the molecular DCS and the molecular radiative stopping power using
-    // Bragg's additivity rule.
-    for (int i = 0; i < n; ++i) {
-      // Get pointer to current element
-      const auto& elm = data::elements[element_[i]];
-      double awr = data::nuclides[nuclide_[i]]->awr_;
-
-      // Get atomic density and mass density of nuclide given atom/weight percent
-      double atom_density = (atom_density_[0] > 0.0) ?
-        atom_density_[i] : -atom_density_[i] / awr;
-
-      // Calculate the "equivalent" atomic number Zeq of the material
-      Z_eq_sq += atom_density * elm.Z_ * elm.Z_;
-      sum_density += atom_density;
-
-      // Accumulate material DCS
-      dcs += (atom_density * elm.Z_ * elm.Z_) * elm.dcs_;
-
-      // Accumulate material radiative stopping power
-      stopping_power_radiative += atom_density * elm.stopping_power_radiative_;
-    }
-    Z_eq_sq /= sum_density;
-
-    // Calculate the positron DCS and radiative stopping power. These are
-    // obtained by multiplying the electron DCS and radiative stopping powers by
-    // a factor r, which is a numerical approximation of the ratio of the
-    // radiative stopping powers for positrons and electrons. Source: F. Salvat,
-    // J. M. Fernández-Varea, and J. Sempau, "PENELOPE-2011: A Code System for
-    // Monte Carlo Simulation of Electron and Photon Transport," OECD-NEA,
-    // Issy-les-Moulineaux, France (2011).
-    if (positron) {
-      for (int i = 0; i < n_e; ++i) {
-        double t = std::log(1.0 + 1.0e6*data::ttb_e_grid(i)/(Z_eq_sq*MASS_ELECTRON_EV));
-        double r = 1.0 - std::exp(-1.2359e-1*t + 6.1274e-2*std::pow(t, 2)
-          - 3.1516e-2*std::pow(t, 3) + 7.7446e-3*std::pow(t, 4)
-          - 1.0595e-3*std::pow(t, 5) + 7.0568e-5*std::pow(t, 6)
-          - 1.808e-6*std::pow(t, 7));
-        stopping_power_radiative(i) *= r;
-        auto dcs_i = xt::view(dcs, i, xt::all());
-        dcs_i *= r;
-      }
-    }
+    this->radiative_stopping_power(dcs, stopping_power_radiative, positron);
 
     // Total material stopping power
     xt::xtensor<double, 1> stopping_power = stopping_power_collision +
@@ -717,6 +828,15 @@ void Material::init_bremsstrahlung()
 
       // Set photon number yield
       ttb->yield(j) = c;
+
+      // Build the alias table over the photon energy bins of the CDF
+      if (settings::alias_sampling && c > 0.0) {
+        std::vector<double> width(j);
+        for (int i = 0; i < j; ++i) {
+          width[i] = ttb->cdf(j,i+1) - ttb->cdf(j,i);
+        }
+        ttb->alias[j] = AliasTable{width};
+      }
     }
 
     // Use logarithm of number yield since it is log-log interpolated
@@ -724,6 +844,119 @@ void Material::init_bremsstrahlung()
   }
 }
 
+void Material::init_condensed_history()
+{
+  // Create new object
+  ch_ = std::make_unique<CondensedHistory>();
+
+  // Get the size of the energy grids
+  const auto& E {data::ttb_e_grid};
+  const auto& k {data::ttb_k_grid};
+  auto n_k = k.size();
+  auto n_e = E.size();
+
+  // Photons below the lowest energy of the grid or the photon cutoff are
+  // deposited along the step, harder ones are emitted in discrete events
+  int photon = static_cast<int>(Particle::Type::photon);
+  double w_cut = std::max(settings::energy_cutoff[photon], E(0));
+
+  // Bohr radius in Angstroms and classical electron radius in cm
+  constexpr double CM_PER_ANGSTROM {1.0e-8};
+  constexpr double a_0 = PLANCK_C * FINE_STRUCTURE / (2.0 * PI *
+    MASS_ELECTRON_EV);
+  constexpr double r_e = CM_PER_ANGSTROM * PLANCK_C / (2.0 * PI *
+    FINE_STRUCTURE * MASS_ELECTRON_EV);
+  constexpr double BARN_PER_CM_SQ {1.0e24};
+
+  for (int particle = 0; particle < 2; ++particle) {
+    // Loop over logic twice, once for electron, once for positron
+    CondensedHistoryData* ch = (particle == 0) ? &ch_->electron : &ch_->positron;
+    bool positron = (particle == 1);
+
+    ch->w_cut = w_cut;
+    ch->range = xt::empty<double>({n_e});
+    ch->transport_xs = xt::zeros<double>({n_e});
+    ch->brems_xs = xt::empty<double>({n_e});
+    ch->dcs = xt::zeros<double>({n_e, n_k});
+    ch->dcs_max = xt::empty<double>({n_e});
+
+    // Get the collision and radiative stopping powers of the material
+    xt::xtensor<double, 1> stopping_power({n_e}, 0.0);
+    xt::xtensor<double, 1> stopping_power_radiative({n_e}, 0.0);
+    this->collision_stopping_power(stopping_power.data(), positron);
+    this->radiative_stopping_power(ch->dcs, stopping_power_radiative, positron);
+
+    for (int j = 0; j < n_e; ++j) {
+      // Square of the ratio of the speed of light to the velocity of the
+      // charged particle
+      double beta_sq = E(j) * (E(j) + 2.0 * MASS_ELECTRON_EV) / ((E(j) +
+        MASS_ELECTRON_EV) * (E(j) + MASS_ELECTRON_EV));
+
+      // Split the integral of the scaled DCS, which is linear in the reduced
+      // photon energy between grid points, at the cutoff. Below it, the DCS
+      // weighted by the photon energy gives the restricted radiative stopping
+      // power; above it, the DCS gives the hard bremsstrahlung cross section.
+      double k_cut = w_cut / E(j);
+      double soft = 0.0;
+      double hard = 0.0;
+      for (int i = 0; i < n_k - 1; ++i) {
+        double k_l = k(i);
+        double k_r = k(i+1);
+        double x_l = ch->dcs(j, i);
+        double x_r = ch->dcs(j, i+1);
+        double b = (x_r - x_l) / (k_r - k_l);
+        if (k_l < k_cut) {
+          double k_c = std::min(k_cut, k_r);
+          double x_c = x_l + b * (k_c - k_l);
+          soft += 0.5 * (x_l + x_c) * (k_c - k_l);
+          if (k_c == k_r) continue;
+          k_l = k_c;
+          x_l = x_c;
+        }
+        hard += (x_l - b * k_l) * std::log(k_r / k_l) + b * (k_r - k_l);
+      }
+      stopping_power(j) += E(j) * soft / beta_sq;
+      ch->brems_xs(j) = hard / beta_sq;
+      ch->dcs_max(j) = xt::amax(xt::view(ch->dcs, j, xt::all()))();
+
+      // Calculate the first transport cross section of elastic scattering
+      // from the screened Rutherford cross section with the screening
+      // parameter of Moliere
+      double pc_sq = E(j) * (E(j) + 2.0 * MASS_ELECTRON_EV);
+      for (int i = 0; i < element_.size(); ++i) {
+        const auto& elm = data::elements[element_[i]];
+        double awr = data::nuclides[nuclide_[i]]->awr_;
+        double atom_density = (atom_density_[0] > 0.0) ?
+          atom_density_[i] : -atom_density_[i] / awr;
+
+        double Z = elm.Z_;
+        double a = 0.885 * a_0 * std::pow(Z, -1.0/3.0);
+        double eta = 0.25 * PLANCK_C * PLANCK_C / (4.0 * PI * PI * pc_sq *
+          a * a) * (1.13 + 3.76 * Z * Z / (FINE_STRUCTURE * FINE_STRUCTURE *
+          beta_sq));
+        double sigma = 2.0 * PI * Z * (Z + 1.0) * r_e * r_e *
+          MASS_ELECTRON_EV * MASS_ELECTRON_EV / (beta_sq * pc_sq) *
+          (std::log1p(1.0 / eta) - 1.0 / (1.0 + eta));
+        ch->transport_xs(j) += BARN_PER_CM_SQ * atom_density * sigma;
+      }
+    }
+
+    // Integrate the inverse of the restricted stopping power to get the CSDA
+    // range, using the trapezoidal rule in log energy. Below the grid, the
+    // stopping power is taken to fall as 1/E so that the range grows as E^2.
+    ch->range(0) = 0.5 * E(0) / stopping_power(0);
+    for (int j = 1; j < n_e; ++j) {
+      ch->range(j) = ch->range(j-1) + 0.5 * (E(j-1) / stopping_power(j-1) +
+        E(j) / stopping_power(j)) * std::log(E(j) / E(j-1));
+    }
+
+    // Use logarithms since the range and transport cross section are log-log
+    // interpolated
+    ch->range = xt::log(ch->range);
+    ch->transport_xs = xt::log(ch->transport_xs);
+  }
+}
+
 void Material::init_nuclide_index()
 {
   int n = settings::run_CE ?
@@ -735,19 +968,331 @@ void Material::init_nuclide_index()
   }
 }
 
-void Material::calculate_xs(Particle& p) const
+void Material::init_union_grid()
+{
+  // The grid only depends on the nuclides, so it is kept across simulations
+  // unless they changed
+  if (!union_energy_.empty() && union_nuclides_ == nuclide_) return;
+
+  union_energy_.clear();
+  union_grid_index_.clear();
+  union_offset_.clear();
+  union_index_ = xt::xtensor<int, 2>();
+  if (!union_grid_ || !settings::run_CE) return;
+
+  // Merge the energy grids of all nuclides at all temperatures. Each
+  // nuclide/temperature pair is assigned a column of union_index_.
+  int n_columns = 0;
+  for (int i_nuc : nuclide_) {
+    union_offset_.push_back(n_columns);
+    for (const auto& grid : data::nuclides[i_nuc]->grid_) {
+      union_energy_.insert(union_energy_.end(), grid.energy.begin(),
+        grid.energy.end());
+      ++n_columns;
+    }
+  }
+  std::sort(union_energy_.begin(), union_energy_.end());
+  union_energy_.erase(std::unique(union_energy_.begin(), union_energy_.end()),
+    union_energy_.end());
+
+  int n_union = union_energy_.size();
+  if (n_union < 2) {
+    union_energy_.clear();
+    return;
+  }
+  union_nuclides_ = nuclide_;
+
+  // For each interval (E_k, E_k+1] of the unionized grid, find the interval in
+  // each nuclide grid that contains it. This matches the index that
+  // lower_bound_index would give for any energy within the interval.
+  union_index_ = xt::empty<int>({static_cast<size_t>(n_union - 1),
+    static_cast<size_t>(n_columns)});
+  for (int i = 0; i < nuclide_.size(); ++i) {
+    const auto& grids {data::nuclides[nuclide_[i]]->grid_};
+    for (int t = 0; t < grids.size(); ++t) {
+      const auto& energy {grids[t].energy};
+      int col = union_offset_[i] + t;
+      int j = 0;
+      int j_max = energy.size() - 2;
+      for (int k = 0; k < n_union - 1; ++k) {
+        while (j < j_max && energy[j + 1] < union_energy_[k + 1]) ++j;
+        union_index_(k, col) = j;
+      }
+    }
+  }
+
+  // Create the logarithmic mapping into the unionized grid, as is done for
+  // each nuclide grid in Nuclide::init_grid()
+  union_grid_index_ = neutron_log_grid_index(union_energy_);
+}
+
+void Material::init_xs_table()
+{
+  table_energy_.clear();
+  table_grid_index_.clear();
+  table_xs_ = xt::xtensor<double, 2>();
+  table_sqrtkT_ = -1.0;
+  if (!xs_table_ || !settings::run_CE || nuclide_.empty()) return;
+
+  // Tallies along tracks may need the cross sections of each nuclide, and a
+  // temperature sampled between two data sets is not represented by a table
+  if (tallies_need_nuclide_xs() ||
+      settings::temperature_method == TemperatureMethod::INTERPOLATION) {
+    warning(fmt::format("Cross section table of material {} is not used "
+      "with the tallies or temperature method of this model.", id_));
+    return;
+  }
+
+  // The table is for the temperature of the first cell instance filled with
+  // the material. Lookups at other temperatures do not use it.
+  for (const auto& c : model::cells) {
+    if (c->type_ != Fill::MATERIAL) continue;
+    for (int i = 0; i < c->material_.size(); ++i) {
+      if (c->material_[i] == index_) {
+        table_sqrtkT_ = (c->sqrtkT_.size() > 1) ? c->sqrtkT_[i] :
+          c->sqrtkT_[0];
+        break;
+      }
+    }
+    if (table_sqrtkT_ >= 0.0) break;
+  }
+  if (table_sqrtkT_ < 0.0) return;
+
+  // Cross sections are only tabulated where they are interpolated on the
+  // pointwise grids: above thermal scattering and windowed multipole data, and
+  // outside of the unresolved resonance ranges whose probability tables are
+  // sampled
+  int neutron = static_cast<int>(Particle::Type::neutron);
+  double E_low = data::energy_min[neutron];
+  double E_high = data::energy_max[neutron];
+  for (const auto& sab : thermal_tables_) {
+    E_low = std::max(E_low, data::thermal_scatt[sab.index_table]->energy_max_);
+  }
+  std::vector<int> temperature;
+  double urr_low = INFTY;
+  double urr_high = -INFTY;
+  for (int i_nuc : nuclide_) {
+    const auto& nuc {*data::nuclides[i_nuc]};
+    if (nuc.multipole_) E_low = std::max(E_low, nuc.multipole_->E_max_);
+    int i_temp = nuc.temperature_index(table_sqrtkT_).index;
+    temperature.push_back(i_temp);
+    if (settings::urr_ptables_on && nuc.urr_present_) {
+      const auto& urr {nuc.urr_data_[i_temp]};
+      urr_low = std::min(urr_low, urr.energy_(0));
+      urr_high = std::max(urr_high, urr.energy_(urr.n_energy_ - 1));
+    }
+  }
+  if (E_low >= E_high) return;
+  table_urr_ = {urr_low, urr_high};
+
+  // Merge the energy grids of all nuclides. The macroscopic cross sections
+  // are then linear within each interval, so that interpolating them is exact
+  // to round-off. Energies appearing twice in a grid are discontinuities,
+  // which are kept twice in the table as well.
+  std::vector<double> energy {E_low, E_high};
+  std::vector<double> edges;
+  for (int i = 0; i < nuclide_.size(); ++i) {
+    const auto& E {data::nuclides[nuclide_[i]]->grid_[temperature[i]].energy};
+    for (int k = 0; k < E.size(); ++k) {
+      if (E[k] <= E_low || E[k] >= E_high) continue;
+      if (E[k] > urr_low && E[k] < urr_high) continue;
+      energy.push_back(E[k]);
+      if (k + 1 < E.size() && E[k + 1] == E[k]) edges.push_back(E[k]);
+    }
+  }
+  if (urr_low > E_low && urr_low < E_high) energy.push_back(urr_low);
+  if (urr_high > E_low && urr_high < E_high) energy.push_back(urr_high);
+  std::sort(energy.begin(), energy.end());
+  energy.erase(std::unique(energy.begin(), energy.end()), energy.end());
+  std::sort(edges.begin(), edges.end());
+  for (double E : energy) {
+    if (std::binary_search(edges.begin(), edges.end(), E)) {
+      table_energy_.push_back(E);
+    }
+    table_energy_.push_back(E);
+  }
+
+  // Evaluate the nuclides at each energy, approaching a discontinuity from
+  // below for its first point and from above for its second
+  int n_energy = table_energy_.size();
+  table_xs_ = xt::empty<double>({static_cast<size_t>(n_energy), size_t {4}});
+#pragma omp parallel
+  {
+    Particle p;
+    p.neutron_xs_.set_material(mat_nuclide_index_);
+    p.sqrtkT_ = table_sqrtkT_;
+#pragma omp for
+    for (int k = 0; k < n_energy; ++k) {
+      double E = table_energy_[k];
+      if (k > 0 && table_energy_[k - 1] == E) {
+        E = std::nextafter(E, INFTY);
+      } else if (k + 1 < n_energy && table_energy_[k + 1] == E) {
+        E = std::nextafter(E, 0.0);
+      }
+      p.E_ = E;
+      int i_log = std::log(E/data::energy_min[neutron])/simulation::log_spacing;
+      double xs[4] {0.0, 0.0, 0.0, 0.0};
+      for (int i = 0; i < nuclide_.size(); ++i) {
+        auto& nuc {*data::nuclides[nuclide_[i]]};
+        nuc.calculate_xs(C_NONE, i_log, 0.0, p);
+        const auto& micro {p.neutron_xs_[nuclide_[i]]};
+        double atom_density = atom_density_(i);
+        xs[0] += atom_density * micro.total;
+        xs[1] += atom_density * micro.absorption;
+        xs[2] += atom_density * micro.fission;
+        xs[3] += atom_density * micro.nu_fission;
+      }
+      for (int c = 0; c < 4; ++c) table_xs_(k, c) = xs[c];
+    }
+  }
+  table_grid_index_ = neutron_log_grid_index(table_energy_);
+}
+
+bool Material::xs_tabulated(const Particle& p) const
 {
+  return !table_energy_.empty() && p.sqrtkT_ == table_sqrtkT_ &&
+    p.E_ >= table_energy_.front() && p.E_ < table_energy_.back() &&
+    !(p.E_ > table_urr_.first && p.E_ < table_urr_.second);
+}
+
+void Material::prefetch_neutron_xs(double E, double sqrtkT, bool rows) const
+{
+  // Cross sections from the material table need no nuclide data
+  if (!table_energy_.empty() && sqrtkT == table_sqrtkT_ &&
+      E >= table_energy_.front() && E < table_energy_.back() &&
+      !(E > table_urr_.first && E < table_urr_.second)) return;
+
+  int neutron = static_cast<int>(Particle::Type::neutron);
+  int i_log = std::log(E/data::energy_min[neutron])/simulation::log_spacing;
+  i_log = std::min(std::max(i_log, 0), settings::n_log_bins - 1);
+  for (int i_nuc : nuclide_) {
+    const auto& nuc {*data::nuclides[i_nuc]};
+    int i_temp = nuc.temperature_index(sqrtkT).index;
+    nuc.prefetch_xs(i_temp, i_log, E, rows);
+  }
+}
+
+void Material::interpolate_xs_table(Particle& p) const
+{
+  int neutron = static_cast<int>(Particle::Type::neutron);
+  int i_log = std::log(p.E_/data::energy_min[neutron])/simulation::log_spacing;
+  int k = neutron_log_grid_search(table_energy_, table_grid_index_, i_log,
+    p.E_);
+  if (table_energy_[k] == table_energy_[k + 1]) ++k;
+  double f = (p.E_ - table_energy_[k]) /
+    (table_energy_[k + 1] - table_energy_[k]);
+
+  const double* lo = &table_xs_(k, 0);
+  const double* hi = &table_xs_(k + 1, 0);
+  p.macro_xs_.total = lo[0] + f*(hi[0] - lo[0]);
+  p.macro_xs_.absorption = lo[1] + f*(hi[1] - lo[1]);
+  p.macro_xs_.fission = lo[2] + f*(hi[2] - lo[2]);
+  p.macro_xs_.nu_fission = lo[3] + f*(hi[3] - lo[3]);
+}
+
+void Material::init_photon_tables()
+{
+  photon_energy_.clear();
+  photon_grid_index_.clear();
+  photon_xs_ = xt::xtensor<double, 2>();
+  if (!settings::photon_material_tables || !settings::photon_transport ||
+      element_.empty()) return;
+
+  // Merge the energy grids of all elements within the photon energy bounds.
+  // Energies at which an element grid is discontinuous, such as absorption
+  // edges, are noted so that the tables are discontinuous there too.
+  int photon = static_cast<int>(Particle::Type::photon);
+  double log_E_min = std::log(data::energy_min[photon]);
+  double log_E_max = std::log(data::energy_max[photon]);
+  std::vector<double> energy {log_E_min, log_E_max};
+  std::vector<double> edges;
+  for (int i_element : element_) {
+    const auto& E {data::elements[i_element].energy_};
+    for (int i = 0; i < E.size(); ++i) {
+      if (E(i) <= log_E_min || E(i) >= log_E_max) continue;
+      energy.push_back(E(i));
+      if (i + 1 < E.size() && E(i + 1) == E(i)) edges.push_back(E(i));
+    }
+  }
+  std::sort(energy.begin(), energy.end());
+  energy.erase(std::unique(energy.begin(), energy.end()), energy.end());
+  std::sort(edges.begin(), edges.end());
+
+  // Divide each interval into intervals no wider than those of the photon
+  // grid. An energy at a discontinuity is kept twice, with the values below
+  // then above it.
+  std::vector<bool> below;
+  for (int k = 0; k < energy.size() - 1; ++k) {
+    if (std::binary_search(edges.begin(), edges.end(), energy[k])) {
+      photon_energy_.push_back(energy[k]);
+      below.push_back(true);
+    }
+    double width = energy[k + 1] - energy[k];
+    int n_sub = std::max(1,
+      static_cast<int>(std::ceil(width / data::photon_log_spacing)));
+    for (int m = 0; m < n_sub; ++m) {
+      photon_energy_.push_back(energy[k] + width*m/n_sub);
+      below.push_back(false);
+    }
+  }
+  photon_energy_.push_back(energy.back());
+  below.push_back(true);
+
+  // Add the contribution of each element at each energy
+  int n_energy = photon_energy_.size();
+  int n = element_.size();
+  photon_xs_ = xt::zeros<double>({static_cast<size_t>(n_energy),
+    static_cast<size_t>(4 + n)});
+  for (int j = 0; j < n_energy; ++j) {
+    double total = 0.0;
+    for (int i = 0; i < n; ++i) {
+      const auto& element {data::elements[element_[i]]};
+      auto micro = element.calculate_xs(photon_energy_[j], below[j]);
+      double atom_density = atom_density_(i);
+      photon_xs_(j, 0) += atom_density * micro.coherent;
+      photon_xs_(j, 1) += atom_density * micro.incoherent;
+      photon_xs_(j, 2) += atom_density * micro.photoelectric;
+      photon_xs_(j, 3) += atom_density * micro.pair_production;
+      total += atom_density * micro.total;
+      photon_xs_(j, 4 + i) = total;
+    }
+  }
+  photon_grid_index_ = log_grid_index(photon_energy_.data(), n_energy);
+}
+
+void Material::calculate_xs(Particle& p, bool table) const
+{
+  InstrumentRegion region {Region::CALCULATE_XS};
+
   // Set all material macroscopic cross sections to zero
   p.macro_xs_.total = 0.0;
   p.macro_xs_.absorption = 0.0;
   p.macro_xs_.fission = 0.0;
   p.macro_xs_.nu_fission = 0.0;
 
+  // The cumulative cross sections are only kept for the latest lookup
+  p.xs_cdf_.clear();
+
   if (p.type_ == Particle::Type::neutron) {
-    this->calculate_neutron_xs(p);
+    if (table && this->xs_tabulated(p)) {
+      this->interpolate_xs_table(p);
+    } else {
+      this->calculate_neutron_xs(p);
+    }
   } else if (p.type_ == Particle::Type::photon) {
     this->calculate_photon_xs(p);
   }
+
+  // Scale by the density multiplier of a mesh field. The cumulative cross
+  // sections are only used relative to their sum, so they are left as is.
+  if (p.density_mult_ != 1.0) {
+    auto& xs {p.macro_xs_};
+    for (double* x : {&xs.total, &xs.absorption, &xs.fission, &xs.nu_fission,
+         &xs.coherent, &xs.incoherent, &xs.photoelectric,
+         &xs.pair_production}) {
+      *x *= p.density_mult_;
+    }
+  }
 }
 
 void Material::calculate_neutron_xs(Particle& p) const
@@ -756,6 +1301,47 @@ void Material::calculate_neutron_xs(Particle& p) const
   int neutron = static_cast<int>(Particle::Type::neutron);
   int i_grid = std::log(p.E_/data::energy_min[neutron])/simulation::log_spacing;
 
+  // With a unionized grid, a single search gives the grid index for every
+  // nuclide at every temperature
+  const int* union_row = nullptr;
+  if (!union_energy_.empty()) {
+    int n_union = union_energy_.size();
+    int k;
+    if (p.E_ <= union_energy_.front()) {
+      k = 0;
+    } else if (p.E_ >= union_energy_.back()) {
+      k = n_union - 2;
+    } else {
+      int i_low  = union_grid_index_[i_grid];
+      int i_high = union_grid_index_[i_grid + 1] + 1;
+      k = i_low + lower_bound_index(&union_energy_[i_low],
+        &union_energy_[i_high], p.E_);
+    }
+    union_row = &union_index_(k, 0);
+  }
+
+  // A compact cross section cache only holds this material's nuclides
+  p.neutron_xs_.set_material(mat_nuclide_index_);
+
+  // Temperature indices may have been precomputed for the particle's cell.
+  // Mesh fields replace the temperature of the cell, so they bypass the cache.
+  const NuclideTemperature* temperature = nullptr;
+  if (settings::temperature_cache && model::mesh_fields.empty()) {
+    const auto& c {*model::cells[p.coord_[p.n_coord_ - 1].cell]};
+    temperature = c.nuclide_temperature(p.cell_instance_, p.material_);
+  }
+
+  // When vectorizing, microscopic cross sections are first gathered into
+  // contiguous arrays and then reduced all at once
+  bool vectorize = settings::vectorize_xs;
+  auto& scratch {micro_scratch};
+  if (vectorize && scratch.total.size() < nuclide_.size()) {
+    for (auto* a : {&scratch.total, &scratch.absorption, &scratch.fission,
+        &scratch.nu_fission}) {
+      a->resize(nuclide_.size());
+    }
+  }
+
   // Determine if this material has S(a,b) tables
   bool check_sab = (thermal_tables_.size() > 0);
 
@@ -769,6 +1355,7 @@ void Material::calculate_neutron_xs(Particle& p) const
 
     int i_sab = C_NONE;
     double sab_frac = 0.0;
+    const NuclideTemperature* sab_temperature = nullptr;
 
     // Check if this nuclide matches one of the S(a,b) tables specified.
     // This relies on thermal_tables_ being sorted by .index_nuclide
@@ -783,6 +1370,9 @@ void Material::calculate_neutron_xs(Particle& p) const
         // S(a,b) table, then don't use the S(a,b) table
         if (p.E_ > data::thermal_scatt[i_sab]->energy_max_) i_sab = C_NONE;
 
+        // Cached temperature indices of S(a,b) tables follow the nuclides
+        if (temperature) sab_temperature = temperature + nuclide_.size() + j;
+
         // Increment position in thermal_tables_
         ++j;
 
@@ -803,12 +1393,23 @@ void Material::calculate_neutron_xs(Particle& p) const
         || p.sqrtkT_ != micro.last_sqrtkT
         || i_sab != micro.index_sab
         || sab_frac != micro.sab_frac) {
-      data::nuclides[i_nuclide]->calculate_xs(i_sab, i_grid, sab_frac, p);
+      const int* union_index = union_row ?
+        union_row + union_offset_[i] : nullptr;
+      data::nuclides[i_nuclide]->calculate_xs(i_sab, i_grid, sab_frac, p,
+        union_index, temperature ? temperature + i : nullptr, sab_temperature);
     }
 
     // ======================================================================
     // ADD TO MACROSCOPIC CROSS SECTION
 
+    if (vectorize) {
+      scratch.total[i] = micro.total;
+      scratch.absorption[i] = micro.absorption;
+      scratch.fission[i] = micro.fission;
+      scratch.nu_fission[i] = micro.nu_fission;
+      continue;
+    }
+
     // Copy atom density of nuclide in material
     double atom_density = atom_density_(i);
 
@@ -817,11 +1418,77 @@ void Material::calculate_neutron_xs(Particle& p) const
     p.macro_xs_.absorption += atom_density * micro.absorption;
     p.macro_xs_.fission += atom_density * micro.fission;
     p.macro_xs_.nu_fission += atom_density * micro.nu_fission;
+    if (settings::cumulative_xs) p.xs_cdf_.push_back(p.macro_xs_.total);
+  }
+
+  if (vectorize) {
+    const double* density = atom_density_.data();
+    const double* total = scratch.total.data();
+    const double* absorption = scratch.absorption.data();
+    const double* fission = scratch.fission.data();
+    const double* nu_fission = scratch.nu_fission.data();
+
+    double sum_total = 0.0;
+    double sum_absorption = 0.0;
+    double sum_fission = 0.0;
+    double sum_nu_fission = 0.0;
+    int n = nuclide_.size();
+    #pragma omp simd reduction(+:sum_total,sum_absorption,sum_fission,sum_nu_fission)
+    for (int i = 0; i < n; ++i) {
+      sum_total += density[i] * total[i];
+      sum_absorption += density[i] * absorption[i];
+      sum_fission += density[i] * fission[i];
+      sum_nu_fission += density[i] * nu_fission[i];
+    }
+
+    p.macro_xs_.total += sum_total;
+    p.macro_xs_.absorption += sum_absorption;
+    p.macro_xs_.fission += sum_fission;
+    p.macro_xs_.nu_fission += sum_nu_fission;
+
+    // The running sum cannot be part of the reduction
+    if (settings::cumulative_xs) {
+      double sum = 0.0;
+      for (int i = 0; i < n; ++i) {
+        sum += density[i] * total[i];
+        p.xs_cdf_.push_back(sum);
+      }
+    }
   }
 }
 
 void Material::calculate_photon_xs(Particle& p) const
 {
+  // Interpolate the tabulated cross sections when the energy is within the
+  // tables. The cumulative cross sections of the elements are then always
+  // kept so that an element can be sampled without calculating microscopic
+  // cross sections.
+  int n_table = photon_energy_.size();
+  if (n_table > 0) {
+    double log_E = std::log(p.E_);
+    if (log_E >= photon_energy_.front() && log_E < photon_energy_.back()) {
+      int j = log_grid_search(photon_energy_.data(), n_table,
+        photon_grid_index_, log_E);
+      if (photon_energy_[j] == photon_energy_[j + 1]) ++j;
+      double f = (log_E - photon_energy_[j]) /
+        (photon_energy_[j + 1] - photon_energy_[j]);
+
+      const double* lo = &photon_xs_(j, 0);
+      const double* hi = &photon_xs_(j + 1, 0);
+      auto& xs {p.macro_xs_};
+      xs.coherent = lo[0] + f*(hi[0] - lo[0]);
+      xs.incoherent = lo[1] + f*(hi[1] - lo[1]);
+      xs.photoelectric = lo[2] + f*(hi[2] - lo[2]);
+      xs.pair_production = lo[3] + f*(hi[3] - lo[3]);
+      xs.total = xs.coherent + xs.incoherent + xs.photoelectric +
+        xs.pair_production;
+      for (int i = 4; i < photon_xs_.shape()[1]; ++i) {
+        p.xs_cdf_.push_back(lo[i] + f*(hi[i] - lo[i]));
+      }
+      return;
+    }
+  }
+
   p.macro_xs_.coherent = 0.0;
   p.macro_xs_.incoherent = 0.0;
   p.macro_xs_.photoelectric = 0.0;
@@ -853,6 +1520,7 @@ void Material::calculate_photon_xs(Particle& p) const
     p.macro_xs_.incoherent += atom_density * micro.incoherent;
     p.macro_xs_.photoelectric += atom_density * micro.photoelectric;
     p.macro_xs_.pair_production += atom_density * micro.pair_production;
+    if (settings::cumulative_xs) p.xs_cdf_.push_back(p.macro_xs_.total);
   }
 }
 
@@ -924,6 +1592,11 @@ void Material::set_density(double density, gsl::cstring_span units)
     throw std::invalid_argument{"Invalid units '" + std::string(units.data())
       + "' specified."};
   }
+
+  // Tabulated cross sections are no longer valid until the tables are rebuilt
+  // when a simulation is initialized
+  table_energy_.clear();
+  photon_energy_.clear();
 }
 
 void Material::set_densities(const std::vector<std::string>& name,
@@ -957,6 +1630,9 @@ void Material::set_densities(const std::vector<std::string>& name,
 
   // Assign S(a,b) tables
   this->init_thermal();
+
+  // Nuclides may have changed, so update the material class
+  this->init_class();
 }
 
 double Material::volume() const
@@ -1060,6 +1736,13 @@ void Material::add_nuclide(const std::string& name, double density)
   density_ += density;
   density_gpcc_ += density * data::nuclides[i_nuc]->awr_
     * MASS_NEUTRON / N_AVOGADRO;
+
+  // Update the material class and unionized grid now that the nuclide list
+  // has changed
+  if (class_ != C_NONE) this->init_class();
+  if (!union_energy_.empty()) this->init_union_grid();
+  table_energy_.clear();
+  photon_energy_.clear();
 }
 
 //==============================================================================
@@ -1206,7 +1889,7 @@ void read_materials_xml()
     }
 
     // Parse materials.xml file and get root element
-    doc.load_file(filename.c_str());
+    load_xml_file(doc, filename);
   }
 
   // Loop over XML material elements and populate the array.
@@ -1221,6 +1904,8 @@ void free_memory_material()
 {
   model::materials.clear();
   model::material_map.clear();
+  model::material_class_map.clear();
+  model::max_material_nuclides = 0;
 }
 
 //==============================================================================
@@ -1314,6 +1999,32 @@ openmc_material_get_id(int32_t index, int32_t* id)
   }
 }
 
+extern "C" int
+openmc_material_get_temperature(int32_t index, double* temperature)
+{
+  if (index < 0 || index >= model::materials.size()) {
+    set_errmsg("Index in materials array is out of bounds.");
+    return OPENMC_E_OUT_OF_BOUNDS;
+  }
+
+  // Transport uses the temperatures of the cells filled with the material,
+  // of which the first instance found is taken
+  for (const auto& c : model::cells) {
+    if (c->type_ != Fill::MATERIAL || c->sqrtkT_.empty()) continue;
+    for (int i = 0; i < c->material_.size(); ++i) {
+      if (c->material_[i] == index) {
+        *temperature = c->temperature(i);
+        return 0;
+      }
+    }
+  }
+
+  const auto& m {model::materials[index]};
+  *temperature = (m->temperature_ > 0.0) ? m->temperature_ :
+    settings::temperature_default;
+  return 0;
+}
+
 extern "C" int
 openmc_material_get_volume(int32_t index, double* volume)
 {
@@ -1365,6 +2076,118 @@ openmc_material_set_densities(int32_t index, int n, const char** name, const dou
   return 0;
 }
 
+namespace {
+
+//! Check that indices in the materials array are valid and distinct, so that
+//! the materials can be modified in parallel
+int check_material_indices(int32_t n, const int32_t* index)
+{
+  std::vector<bool> seen(model::materials.size(), false);
+  for (int32_t i = 0; i < n; ++i) {
+    if (index[i] < 0 || index[i] >= model::materials.size()) {
+      set_errmsg("Index in materials array is out of bounds.");
+      return OPENMC_E_OUT_OF_BOUNDS;
+    }
+    if (seen[index[i]]) {
+      set_errmsg("Material " + std::to_string(model::materials[index[i]]->id_)
+        + " is given more than once.");
+      return OPENMC_E_INVALID_ARGUMENT;
+    }
+    seen[index[i]] = true;
+  }
+  return 0;
+}
+
+} // namespace
+
+extern "C" int
+openmc_materials_set_density(int32_t n, const int32_t* index,
+  const double* density, const char* units)
+{
+  int err = check_material_indices(n, index);
+  if (err < 0) return err;
+
+  #pragma omp parallel for schedule(static)
+  for (int32_t i = 0; i < n; ++i) {
+    try {
+      model::materials[index[i]]->set_density(density[i], units);
+    } catch (const std::exception& e) {
+      #pragma omp critical (MaterialsSetDensity)
+      {
+        if (err == 0) {
+          set_errmsg(e.what());
+          err = OPENMC_E_UNASSIGNED;
+        }
+      }
+    }
+  }
+  return err;
+}
+
+extern "C" int
+openmc_materials_set_densities(int32_t n, const int32_t* index,
+  const int* n_nuclide, const char** name, const double* density)
+{
+  int err = check_material_indices(n, index);
+  if (err < 0) return err;
+
+  // Offset of the nuclides of each material in the name and density arrays
+  std::vector<int64_t> offset(n + 1, 0);
+  for (int32_t i = 0; i < n; ++i) {
+    if (n_nuclide[i] <= 0) {
+      set_errmsg("Number of nuclides must be positive.");
+      return OPENMC_E_INVALID_ARGUMENT;
+    }
+    offset[i + 1] = offset[i] + n_nuclide[i];
+  }
+  for (int64_t k = 0; k < offset[n]; ++k) {
+    if (density[k] <= 0.0) {
+      set_errmsg("Nuclide densities must be positive.");
+      return OPENMC_E_INVALID_ARGUMENT;
+    }
+  }
+
+  // Materials whose nuclides change need nuclides to be loaded and their
+  // S(a,b) tables and class updated, which is done serially. The others only
+  // have their atom densities replaced and are updated in parallel.
+  std::vector<int32_t> unchanged;
+  unchanged.reserve(n);
+  try {
+    for (int32_t i = 0; i < n; ++i) {
+      auto& mat {*model::materials[index[i]]};
+      const char** nucs = name + offset[i];
+      bool same = (mat.nuclide_.size() == n_nuclide[i]);
+      for (int j = 0; same && j < n_nuclide[i]; ++j) {
+        auto it = data::nuclide_map.find(nucs[j]);
+        same = (it != data::nuclide_map.end() && it->second == mat.nuclide_[j]);
+      }
+
+      if (same) {
+        unchanged.push_back(i);
+      } else {
+        mat.set_densities({nucs, nucs + n_nuclide[i]},
+          {density + offset[i], density + offset[i + 1]});
+      }
+    }
+  } catch (const std::exception& e) {
+    set_errmsg(e.what());
+    return OPENMC_E_UNASSIGNED;
+  }
+
+  #pragma omp parallel for schedule(static)
+  for (int32_t j = 0; j < unchanged.size(); ++j) {
+    int32_t i = unchanged[j];
+    auto& mat {*model::materials[index[i]]};
+    double sum_density = 0.0;
+    for (int k = 0; k < n_nuclide[i]; ++k) {
+      mat.atom_density_(k) = density[offset[i] + k];
+      sum_density += density[offset[i] + k];
+    }
+    mat.set_density(sum_density, "atom/b-cm");
+  }
+  return 0;
+}
+
 extern "C" int
 openmc_material_set_id(int32_t index, int32_t id)
 {
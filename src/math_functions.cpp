@@ -2,8 +2,43 @@
 
 #include "Faddeeva.hh"
 
+#include <algorithm> // for min
+#include <array>
+
+#include "openmc/settings.h"
+
 namespace openmc {
 
+namespace {
+
+// Number of terms and length scale of the rational approximation of the
+// Faddeeva function used by faddeeva_batch()
+constexpr int N_WEIDEMAN {32};
+const double L_WEIDEMAN {std::sqrt(N_WEIDEMAN / std::sqrt(2.0))};
+
+//! Compute the coefficients of the polynomial in Weideman's approximation,
+//! which are the Fourier coefficients of exp(-t^2)(L^2 + t^2) mapped with
+//! t = L tan(theta/2)
+std::array<double, N_WEIDEMAN> weideman_coefficients()
+{
+  constexpr int M = 2*N_WEIDEMAN;
+  const double L = L_WEIDEMAN;
+  std::array<double, N_WEIDEMAN> a;
+  for (int n = 1; n <= N_WEIDEMAN; ++n) {
+    double sum = 0.0;
+    for (int k = -M + 1; k < M; ++k) {
+      double t = L*std::tan(k*PI/(2*M));
+      sum += std::exp(-t*t)*(L*L + t*t)*std::cos(PI*n*k/M);
+    }
+    a[n - 1] = sum / (2*M);
+  }
+  return a;
+}
+
+const std::array<double, N_WEIDEMAN> WEIDEMAN_COEFFS {weideman_coefficients()};
+
+} // namespace
+
 //==============================================================================
 // Mathematical methods
 //==============================================================================
@@ -638,19 +673,39 @@ void rotate_angle_c(double uvw[3], double mu, const double* phi, uint64_t* seed)
 }
 
 
+void sample_azimuth(uint64_t* seed, double& cosphi, double& sinphi)
+{
+  if (!settings::azimuth_rejection) {
+    double phi = 2.0*PI*prn(seed);
+    cosphi = std::cos(phi);
+    sinphi = std::sin(phi);
+    return;
+  }
+
+  // The angle of a point uniform in the unit disk is uniform in [0,2pi) and
+  // doubling it covers [0,2pi) twice, so the double-angle formulas apply
+  double x, y, r2;
+  do {
+    x = 2.0*prn(seed) - 1.0;
+    y = 2.0*prn(seed) - 1.0;
+    r2 = x*x + y*y;
+  } while (r2 > 1.0 || r2 == 0.0);
+  cosphi = (x*x - y*y) / r2;
+  sinphi = 2.0*x*y / r2;
+}
+
 Direction rotate_angle(Direction u, double mu, const double* phi, uint64_t* seed)
 {
   // Sample azimuthal angle in [0,2pi) if none provided
-  double phi_;
+  double sinphi, cosphi;
   if (phi != nullptr) {
-    phi_ = (*phi);
+    sinphi = std::sin(*phi);
+    cosphi = std::cos(*phi);
   } else {
-    phi_ = 2.0*PI*prn(seed);
+    sample_azimuth(seed, cosphi, sinphi);
   }
 
   // Precompute factors to save flops
-  double sinphi = std::sin(phi_);
-  double cosphi = std::cos(phi_);
   double a = std::sqrt(std::fmax(0., 1. - mu*mu));
   double b = std::sqrt(std::fmax(0., 1. - u.z*u.z));
 
@@ -879,6 +934,70 @@ std::complex<double> faddeeva(std::complex<double> z)
     -std::conj(Faddeeva::w(std::conj(z)));
 }
 
+void faddeeva_c(double z_re, double z_im, double w[2])
+{
+  std::complex<double> w_z = faddeeva({z_re, z_im});
+  w[0] = w_z.real();
+  w[1] = w_z.imag();
+}
+
+void faddeeva_batch(int n, const double* z_re, const double* z_im,
+  double* w_re, double* w_im)
+{
+  // The arguments are processed in blocks so that every step is a simple loop
+  // over the arguments of a block
+  constexpr int BLOCK {8};
+  const double L = L_WEIDEMAN;
+
+  for (int first = 0; first < n; first += BLOCK) {
+    int m = std::min(BLOCK, n - first);
+    const double* x = z_re + first;
+    const double* y = z_im + first;
+    double inv_re[BLOCK], inv_im[BLOCK]; // 1/(L - iz)
+    double zz_re[BLOCK], zz_im[BLOCK];   // Z = (L + iz)/(L - iz)
+    double p_re[BLOCK], p_im[BLOCK];     // polynomial in Z
+
+    // The approximation holds in the upper half plane. As in faddeeva(), the
+    // value in the lower half plane is -conj(w(conj(z))).
+    #pragma omp simd
+    for (int i = 0; i < m; ++i) {
+      double y_abs = std::abs(y[i]);
+      double d_re = L + y_abs;
+      double d_norm = d_re*d_re + x[i]*x[i];
+      inv_re[i] = d_re / d_norm;
+      inv_im[i] = x[i] / d_norm;
+      zz_re[i] = (L - y_abs)*inv_re[i] - x[i]*inv_im[i];
+      zz_im[i] = (L - y_abs)*inv_im[i] + x[i]*inv_re[i];
+      p_re[i] = WEIDEMAN_COEFFS[N_WEIDEMAN - 1];
+      p_im[i] = 0.0;
+    }
+
+    // Evaluate the polynomial with Horner's method
+    for (int j = N_WEIDEMAN - 2; j >= 0; --j) {
+      double a = WEIDEMAN_COEFFS[j];
+      #pragma omp simd
+      for (int i = 0; i < m; ++i) {
+        double t = p_re[i]*zz_re[i] - p_im[i]*zz_im[i] + a;
+        p_im[i] = p_re[i]*zz_im[i] + p_im[i]*zz_re[i];
+        p_re[i] = t;
+      }
+    }
+
+    // w = 2 p/(L - iz)^2 + 1/(sqrt(pi)(L - iz))
+    #pragma omp simd
+    for (int i = 0; i < m; ++i) {
+      double inv2_re = inv_re[i]*inv_re[i] - inv_im[i]*inv_im[i];
+      double inv2_im = 2.0*inv_re[i]*inv_im[i];
+      double re = 2.0*(p_re[i]*inv2_re - p_im[i]*inv2_im) +
+        inv_re[i] / SQRT_PI;
+      double im = 2.0*(p_re[i]*inv2_im + p_im[i]*inv2_re) +
+        inv_im[i] / SQRT_PI;
+      w_re[first + i] = y[i] > 0.0 ? re : -re;
+      w_im[first + i] = im;
+    }
+  }
+}
+
 std::complex<double> w_derivative(std::complex<double> z, int order)
 {
   using namespace std::complex_literals;
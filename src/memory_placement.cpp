@@ -0,0 +1,156 @@
+#include "openmc/memory_placement.h"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/mman.h>    // for madvise
+#include <sys/syscall.h> // for SYS_set_mempolicy
+#include <unistd.h>      // for sysconf, syscall
+#endif
+
+#include "openmc/error.h"
+#include "openmc/nuclide.h"
+#include "openmc/settings.h"
+#include "openmc/tallies/tally.h"
+
+namespace openmc {
+
+namespace {
+
+// Policies of set_mempolicy(2), which are not declared by the C library
+constexpr int MPOL_DEFAULT_ {0};
+constexpr int MPOL_INTERLEAVE_ {3};
+
+// Size of a transparent huge page on x86-64 and most aarch64 kernels
+constexpr std::uintptr_t HUGE_PAGE_SIZE {2*1024*1024};
+
+//! Get the online NUMA nodes as a bit mask
+std::vector<unsigned long> online_nodes()
+{
+  std::vector<unsigned long> mask;
+  constexpr int BITS = 8*sizeof(unsigned long);
+  for (int node : read_id_list("/sys/devices/system/node/online")) {
+    std::size_t word = node/BITS;
+    if (word >= mask.size()) mask.resize(word + 1, 0);
+    mask[word] |= 1ul << (node % BITS);
+  }
+  return mask;
+}
+
+//! Count the nodes in a mask
+int count_nodes(const std::vector<unsigned long>& mask)
+{
+  int n = 0;
+  for (auto word : mask) {
+    for (; word != 0; word &= word - 1) ++n;
+  }
+  return n;
+}
+
+} // namespace
+
+//==============================================================================
+// InterleaveScope implementation
+//==============================================================================
+
+InterleaveScope::InterleaveScope()
+{
+  if (!settings::numa_interleave) return;
+#if defined(__linux__) && defined(SYS_set_mempolicy)
+  auto mask = online_nodes();
+
+  // Nothing to gain on a single node
+  if (count_nodes(mask) < 2) return;
+
+  unsigned long max_node = 8*sizeof(unsigned long)*mask.size() + 1;
+  if (syscall(SYS_set_mempolicy, MPOL_INTERLEAVE_, mask.data(), max_node) == 0) {
+    active_ = true;
+  } else {
+    warning("Could not interleave memory among NUMA nodes.");
+  }
+#endif
+}
+
+InterleaveScope::~InterleaveScope()
+{
+#if defined(__linux__) && defined(SYS_set_mempolicy)
+  if (active_) syscall(SYS_set_mempolicy, MPOL_DEFAULT_, nullptr, 0);
+#endif
+}
+
+//==============================================================================
+// Non-member functions
+//==============================================================================
+
+std::vector<int> read_id_list(const std::string& path)
+{
+  std::vector<int> ids;
+  std::ifstream file {path};
+  std::string list;
+  if (!(file >> list)) return ids;
+
+  std::size_t pos = 0;
+  while (pos < list.size()) {
+    std::size_t end = list.find(',', pos);
+    if (end == std::string::npos) end = list.size();
+    std::string range = list.substr(pos, end - pos);
+    std::size_t dash = range.find('-');
+    int first = std::stoi(range.substr(0, dash));
+    int last = (dash == std::string::npos) ? first :
+      std::stoi(range.substr(dash + 1));
+    for (int id = first; id <= last; ++id) ids.push_back(id);
+    pos = end + 1;
+  }
+  return ids;
+}
+
+void advise_huge_pages(const void* data, std::size_t size)
+{
+  if (!settings::huge_pages) return;
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  // Round the range inward to whole huge pages
+  auto start = reinterpret_cast<std::uintptr_t>(data);
+  auto first = (start + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+  auto last = (start + size) & ~(HUGE_PAGE_SIZE - 1);
+  if (last <= first) return;
+
+  // The pages are already populated, so khugepaged would only collapse them
+  // into huge pages in the background. Where supported, collapse them now.
+  void* addr = reinterpret_cast<void*>(first);
+  madvise(addr, last - first, MADV_HUGEPAGE);
+#ifdef MADV_COLLAPSE
+  madvise(addr, last - first, MADV_COLLAPSE);
+#endif
+#endif
+}
+
+void advise_nuclear_data()
+{
+  if (!settings::huge_pages) return;
+  for (const auto& nuc : data::nuclides) {
+    for (const auto& grid : nuc->grid_) {
+      advise_huge_pages(grid.energy.data(), grid.energy.size()*sizeof(xs_real));
+      advise_huge_pages(grid.grid_index.data(),
+        grid.grid_index.size()*sizeof(int));
+    }
+    for (const auto& xs : nuc->xs_) {
+      advise_huge_pages(xs.data(), xs.size()*sizeof(xs_real));
+    }
+    for (const auto& xs : nuc->xs_packed_) {
+      advise_huge_pages(xs[0], xs.size()*sizeof(xs_real));
+    }
+  }
+}
+
+void advise_tallies()
+{
+  if (!settings::huge_pages) return;
+  for (const auto& t : model::tallies) {
+    advise_huge_pages(t->results_.data(), t->results_.size()*sizeof(double));
+  }
+}
+
+} // namespace openmc
@@ -0,0 +1,158 @@
+#include "openmc/memory_usage.h"
+
+#include <sys/resource.h> // for getrusage
+
+#include "openmc/bank.h"
+#include "openmc/cell.h"
+#include "openmc/event.h"
+#include "openmc/lattice.h"
+#include "openmc/message_passing.h"
+#include "openmc/nuclide.h"
+#include "openmc/surface.h"
+#include "openmc/tallies/tally.h"
+#include "openmc/thermal.h"
+
+namespace openmc {
+
+namespace {
+
+template<typename T>
+double bytes(const std::vector<T>& v)
+{
+  return static_cast<double>(v.capacity()*sizeof(T));
+}
+
+} // namespace
+
+//==============================================================================
+// Non-member functions
+//==============================================================================
+
+double memory_nuclide(const Nuclide& nuc)
+{
+  double total = bytes(nuc.kTs_);
+  for (const auto& grid : nuc.grid_) {
+    total += bytes(grid.grid_index) + bytes(grid.energy) +
+      bytes(grid.hash_start) +
+        bytes(grid.hash_low) + bytes(grid.hash_high);
+  }
+  for (const auto& xs : nuc.xs_) {
+    total += xs.size()*sizeof(xs_real);
+  }
+  for (const auto& xs : nuc.xs_packed_) {
+    total += xs.size()*sizeof(xs_real);
+  }
+  for (const auto& rx : nuc.reactions_) {
+    for (const auto& xs : rx->xs_) total += bytes(xs.value);
+  }
+  total += bytes(nuc.energy_0K_) + bytes(nuc.elastic_0K_) +
+    bytes(nuc.xs_cdf_) + bytes(nuc.grid_index_0K_) +
+    bytes(nuc.elastic_0K_block_max_);
+  for (const auto& urr : nuc.urr_data_) {
+    total += (urr.energy_.size() + urr.prob_.size())*sizeof(double) +
+      bytes(urr.bands_);
+  }
+  return total;
+}
+
+double memory_thermal(const ThermalScattering& table)
+{
+  return static_cast<double>(table.memory());
+}
+
+double memory_nuclear_data()
+{
+  double total = 0.0;
+  for (const auto& nuc : data::nuclides) {
+    total += memory_nuclide(*nuc);
+  }
+  for (const auto& table : data::thermal_scatt) {
+    total += memory_thermal(*table);
+  }
+  return total;
+}
+
+double memory_tally(const Tally& tally)
+{
+  return (tally.values_.size() + tally.results_.size() +
+    tally.statistics_.size())*sizeof(double);
+}
+
+double memory_tallies()
+{
+  double total = 0.0;
+  for (const auto& t : model::tallies) {
+    total += memory_tally(*t);
+  }
+  return total;
+}
+
+double memory_banks()
+{
+  return bytes(simulation::source_bank) + sizeof(Particle::Bank)*(
+    simulation::fission_bank.capacity() +
+    simulation::surf_source_bank.capacity() +
+    simulation::census_bank.capacity());
+}
+
+double memory_particle_buffers()
+{
+  double total = bytes(simulation::particles);
+  for (auto* queue : {&simulation::calculate_fuel_xs_queue,
+      &simulation::calculate_nonfuel_xs_queue,
+      &simulation::advance_particle_queue,
+      &simulation::surface_crossing_queue, &simulation::collision_queue}) {
+    total += queue->capacity()*sizeof(EventQueueItem);
+  }
+  return total;
+}
+
+double memory_neighbor_lists()
+{
+  double total = 0.0;
+  for (const auto& c : model::cells) {
+    total += c->neighbors_.memory();
+  }
+  return total;
+}
+
+double memory_geometry()
+{
+  double total = 0.0;
+  for (const auto& c : model::cells) {
+    total += bytes(c->material_) + bytes(c->sqrtkT_) + bytes(c->region_) +
+      bytes(c->rpn_) + bytes(c->rotation_) + bytes(c->offset_);
+  }
+  for (const auto& u : model::universes) {
+    total += bytes(u->cells_);
+  }
+  for (const auto& lat : model::lattices) {
+    total += bytes(lat->universes_) + bytes(lat->offsets_);
+  }
+  total += model::surfaces.size()*sizeof(Surface);
+  return total;
+}
+
+double max_resident_memory()
+{
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return 0.0;
+#ifdef __APPLE__
+  return static_cast<double>(usage.ru_maxrss);
+#else
+  return 1024.0*usage.ru_maxrss;
+#endif
+}
+
+std::vector<double> gather_max_resident_memory()
+{
+  double value = max_resident_memory();
+  std::vector<double> values(mpi::n_procs, value);
+#ifdef OPENMC_MPI
+  MPI_Gather(&value, 1, MPI_DOUBLE, values.data(), 1, MPI_DOUBLE, 0,
+    mpi::intracomm);
+#endif
+  return values;
+}
+
+} // namespace openmc
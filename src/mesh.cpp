@@ -1,8 +1,11 @@
 #include "openmc/mesh.h"
 
 #include <algorithm> // for copy, equal, min, min_element
+#include <array>
 #include <cstddef> // for size_t
 #include <cmath>  // for ceil
+#include <cstdint> // for int32_t, uint16_t
+#include <fstream>
 #include <memory> // for allocator
 #include <string>
 
@@ -18,13 +21,18 @@
 #include "xtensor/xview.hpp"
 
 #include "openmc/capi.h"
+#include "openmc/cell.h"
 #include "openmc/constants.h"
 #include "openmc/error.h"
 #include "openmc/hdf5_interface.h"
+#include "openmc/lattice.h"
 #include "openmc/message_passing.h"
+#include "openmc/openmp_interface.h"
 #include "openmc/search.h"
 #include "openmc/settings.h"
 #include "openmc/tallies/filter.h"
+#include "openmc/tallies/filter_mesh.h"
+#include "openmc/tallies/tally.h"
 #include "openmc/xml_interface.h"
 
 namespace openmc {
@@ -102,6 +110,34 @@ StructuredMesh::bin_label(int bin) const {
   }
 }
 
+bool StructuredMesh::lattice_bin(const Particle& p, int& bin) const
+{
+  for (int j = 0; j < p.n_coord_; ++j) {
+    const auto& coord {p.coord_[j]};
+    if (coord.rotated) return false;
+
+    if (coord.lattice == aligned_lattice_) {
+      const auto& lat {*model::lattices[aligned_lattice_]};
+      int i_xyz[3] {coord.lattice_x, coord.lattice_y, coord.lattice_z};
+      if (lat.are_valid_indices(i_xyz)) {
+        int ijk[3] {i_xyz[0] + 1, i_xyz[1] + 1, i_xyz[2] + 1};
+        bin = get_bin_from_indices(ijk);
+      } else {
+        bin = -1;
+      }
+      return true;
+    }
+
+    // The next level is only in the global frame if this one is not a lattice
+    // tile and its cell is not translated
+    if (coord.lattice != C_NONE || coord.cell == C_NONE) return false;
+    if (!(model::cells[coord.cell]->translation_ == Position {0, 0, 0})) {
+      return false;
+    }
+  }
+  return false;
+}
+
 //==============================================================================
 // RegularMesh implementation
 //==============================================================================
@@ -253,6 +289,11 @@ void RegularMesh::get_indices_from_bin(int bin, int* ijk) const
   }
 }
 
+double RegularMesh::edge(int dim, int i) const
+{
+  return lower_left_[dim] + (i - 1) * width_[dim];
+}
+
 int RegularMesh::n_bins() const
 {
   int n_bins = 1;
@@ -510,6 +551,25 @@ bool RegularMesh::intersects_3d(Position& r0, Position r1, int* ijk) const
 
 void RegularMesh::bins_crossed(const Particle& p, std::vector<int>& bins,
                                std::vector<double>& lengths) const
+{
+  walk_track(p, bins, lengths, nullptr);
+}
+
+void RegularMesh::bins_and_surfaces_crossed(const Particle& p,
+  std::vector<int>& bins, std::vector<double>& lengths,
+  std::vector<int>& surface_bins) const
+{
+  std::size_t n_surface = surface_bins.size();
+  if (!walk_track(p, bins, lengths, &surface_bins)) {
+    // The surfaces crossed at the ends of the track don't follow from the
+    // cells traversed, so they are found separately
+    surface_bins.resize(n_surface);
+    surface_bins_between(p.r_last_, p.r(), p.u(), surface_bins);
+  }
+}
+
+bool RegularMesh::walk_track(const Particle& p, std::vector<int>& bins,
+  std::vector<double>& lengths, std::vector<int>* surface_bins) const
 {
   // ========================================================================
   // Determine where the track intersects the mesh and if it intersects at all.
@@ -530,7 +590,7 @@ void RegularMesh::bins_crossed(const Particle& p, std::vector<int>& bins,
 
   // Determine the mesh indices for the starting and ending coords.
   int n = n_dimension_;
-  std::vector<int> ijk0(n), ijk1(n);
+  std::array<int, 3> ijk0 {}, ijk1 {};
   bool start_in_mesh;
   get_indices(r0, ijk0.data(), &start_in_mesh);
   bool end_in_mesh;
@@ -544,10 +604,24 @@ void RegularMesh::bins_crossed(const Particle& p, std::vector<int>& bins,
     // The initial coords do not lie in the mesh.  Check to see if the particle
     // eventually intersects the mesh and compute the relevant coords and
     // indices.
-    if (!intersects(r0, r1, ijk0.data())) return;
+    if (!intersects(r0, r1, ijk0.data())) return false;
   }
   r1 = r;
 
+  // The surfaces crossed are those between the cells traversed when the track
+  // starts inside the mesh and its ends are in the same cells as the points
+  // just inside them. Otherwise the surface crossings at the ends are found by
+  // the caller.
+  std::array<int, 3> ijk_start {}, ijk_end {};
+  bool in_mesh;
+  get_indices(last_r, ijk_start.data(), &in_mesh);
+  get_indices(r, ijk_end.data(), &in_mesh);
+  bool surfaces = surface_bins && start_in_mesh &&
+    total_distance >= 2*TINY_BIT;
+  for (int i = 0; i < n; ++i) {
+    if (ijk_start[i] != ijk0[i] || ijk_end[i] != ijk1[i]) surfaces = false;
+  }
+
   // The TINY_BIT offsets above mean that the preceding logic cannot always find
   // the correct ijk0 and ijk1 indices. For tracks shorter than 2*TINY_BIT, just
   // assume the track lies in only one mesh bin. These tracks are very short so
@@ -560,71 +634,98 @@ void RegularMesh::bins_crossed(const Particle& p, std::vector<int>& bins,
 
   // ========================================================================
   // Find which mesh cells are traversed and the length of each traversal.
+  // The cells are visited incrementally (Amanatides and Woo): the distance
+  // along the track to the next mesh plane on each axis, t_max, and the
+  // distance between consecutive planes, t_delta, are computed once, so each
+  // step only compares the axes and advances one of them.
+
+  std::array<double, 3> t_max {INFTY, INFTY, INFTY};
+  std::array<double, 3> t_delta {INFTY, INFTY, INFTY};
+  std::array<int, 3> step {0, 0, 0};
+  std::array<int, 3> stride {1, 0, 0};
+  for (int k = 0; k < n; ++k) {
+    if (k > 0) stride[k] = stride[k - 1] * shape_[k - 1];
+    if (std::fabs(u[k]) < FP_PRECISION) continue;
+    if (u[k] > 0) {
+      step[k] = 1;
+      t_max[k] = (lower_left_[k] + ijk0[k] * width_[k] - r0[k]) / u[k];
+    } else {
+      step[k] = -1;
+      t_max[k] = (lower_left_[k] + (ijk0[k] - 1) * width_[k] - r0[k]) / u[k];
+    }
+    t_delta[k] = width_[k] / std::fabs(u[k]);
+  }
+  for (int k = 0; k < n; ++k) {
+    if (step[k] == 0 && ijk0[k] != ijk1[k]) surfaces = false;
+  }
 
+  int bin = get_bin_from_indices(ijk0.data());
+  double t_end = (r1 - r0).norm();
+  double t = 0.0;
   while (true) {
     if (ijk0 == ijk1) {
       // The track ends in this cell.  Use the particle end location rather
       // than the mesh surface and stop iterating.
-      double distance = (r1 - r0).norm();
-      bins.push_back(get_bin_from_indices(ijk0.data()));
-      lengths.push_back(distance / total_distance);
+      bins.push_back(bin);
+      lengths.push_back((t_end - t) / total_distance);
       break;
     }
 
-    // The track exits this cell.  Determine the distance to each mesh surface.
-    std::vector<double> d(n);
-    for (int k = 0; k < n; ++k) {
-      if (std::fabs(u[k]) < FP_PRECISION) {
-        d[k] = INFTY;
-      } else if (u[k] > 0) {
-        double xyz_cross = lower_left_[k] + ijk0[k] * width_[k];
-        d[k] = (xyz_cross - r0[k]) / u[k];
-      } else {
-        double xyz_cross = lower_left_[k] + (ijk0[k] - 1) * width_[k];
-        d[k] = (xyz_cross - r0[k]) / u[k];
+    // The track exits this cell through the closest mesh plane.  Append this
+    // traversal to the output.
+    int j = 0;
+    for (int k = 1; k < n; ++k) {
+      if (t_max[k] < t_max[j]) j = k;
+    }
+    if (step[j] == 0) {
+      surfaces = false;
+      break;
+    }
+    bins.push_back(bin);
+    lengths.push_back((t_max[j] - t) / total_distance);
+
+    // Record the outward current through the plane. Planes crossed at the same
+    // distance along the track are ordered differently by the surface walk,
+    // so the crossings are then left to it.
+    if (surfaces) {
+      for (int k = 0; k < n; ++k) {
+        if (k != j && t_max[k] == t_max[j]) surfaces = false;
       }
+      int i_surf = step[j] > 0 ? 4*j + 3 : 4*j + 1;
+      surface_bins->push_back(4*n*bin + i_surf - 1);
     }
 
-    // Pick the closest mesh surface and append this traversal to the output.
-    auto j = std::min_element(d.begin(), d.end()) - d.begin();
-    double distance = d[j];
-    bins.push_back(get_bin_from_indices(ijk0.data()));
-    lengths.push_back(distance / total_distance);
-
-    // Translate to the oncoming mesh surface.
-    r0 += distance * u;
-
-    // Increment the indices into the next mesh cell.
-    if (u[j] > 0.0) {
-      ++ijk0[j];
-    } else {
-      --ijk0[j];
-    }
+    // Move into the next mesh cell.
+    t = t_max[j];
+    t_max[j] += t_delta[j];
+    ijk0[j] += step[j];
+    bin += step[j] * stride[j];
 
     // If the next indices are invalid, then the track has left the mesh and
     // we are done.
-    bool in_mesh = true;
-    for (int i = 0; i < n; ++i) {
-      if (ijk0[i] < 1 || ijk0[i] > shape_[i]) {
-        in_mesh = false;
-        break;
-      }
+    if (ijk0[j] < 1 || ijk0[j] > shape_[j]) break;
+
+    // Record the inward current into the next cell
+    if (surfaces) {
+      int i_surf = step[j] > 0 ? 4*j + 2 : 4*j + 4;
+      surface_bins->push_back(4*n*bin + i_surf - 1);
     }
-    if (!in_mesh) break;
   }
+  return surfaces;
 }
 
 void RegularMesh::surface_bins_crossed(const Particle& p,
                                        std::vector<int>& bins) const
+{
+  surface_bins_between(p.r_last_current_, p.r(), p.u(), bins);
+}
+
+void RegularMesh::surface_bins_between(Position r0, Position r1, Direction u,
+  std::vector<int>& bins) const
 {
   // ========================================================================
   // Determine if the track intersects the tally mesh.
 
-  // Copy the starting and ending coordinates of the particle.
-  Position r0 {p.r_last_current_};
-  Position r1 {p.r()};
-  Direction u {p.u()};
-
   // Determine indices for starting and ending location.
   int n = n_dimension_;
   std::vector<int> ijk0(n), ijk1(n);
@@ -821,25 +922,8 @@ RegularMesh::count_sites(const Particle::Bank* bank,
   std::size_t m = this->n_bins();
   std::vector<std::size_t> shape = {m};
 
-  // Create array of zeros
-  xt::xarray<double> cnt {shape, 0.0};
-  bool outside_ = false;
-
-  for (int64_t i = 0; i < length; i++) {
-    const auto& site = bank[i];
-
-    // determine scoring bin for entropy mesh
-    int mesh_bin = get_bin(site.r);
-
-    // if outside mesh, skip particle
-    if (mesh_bin < 0) {
-      outside_ = true;
-      continue;
-    }
-
-    // Add to appropriate bin
-    cnt(mesh_bin) += site.wgt;
-  }
+  bool outside_;
+  std::vector<double> cnt = local_site_counts(bank, length, &outside_);
 
   // Create copy of count data. Since ownership will be acquired by xtensor,
   // std::allocator must be used to avoid Valgrind mismatched free() / delete
@@ -868,6 +952,131 @@ RegularMesh::count_sites(const Particle::Bank* bank,
   return counts;
 }
 
+std::vector<double>
+RegularMesh::local_site_counts(const Particle::Bank* bank, int64_t length,
+  bool* outside) const
+{
+  std::size_t m = this->n_bins();
+#ifdef _OPENMP
+  int n_threads = omp_get_max_threads();
+#else
+  int n_threads = 1;
+#endif
+
+  // Each thread counts a contiguous part of the bank in its own array unless
+  // the arrays of all threads would take too much memory, in which case the
+  // threads add to a single array
+  constexpr std::size_t MAX_PRIVATE_BINS {1 << 24};
+  bool private_bins = m*n_threads <= MAX_PRIVATE_BINS;
+  std::vector<double> cnt(private_bins ? m*n_threads : m, 0.0);
+
+  // Sites are binned in blocks so that the bins can be computed together
+  constexpr int BLOCK {256};
+  bool outside_ = false;
+  #pragma omp parallel reduction(||: outside_)
+  {
+    double* thread_cnt = cnt.data();
+#ifdef _OPENMP
+    if (private_bins) thread_cnt += m*omp_get_thread_num();
+#endif
+    std::array<int, BLOCK> bins;
+
+    #pragma omp for schedule(static)
+    for (int64_t i_start = 0; i_start < length; i_start += BLOCK) {
+      int n = std::min<int64_t>(BLOCK, length - i_start);
+      get_bins(bank + i_start, n, bins.data());
+
+      for (int j = 0; j < n; ++j) {
+        // if outside mesh, skip particle
+        if (bins[j] < 0) {
+          outside_ = true;
+          continue;
+        }
+
+        // Add to appropriate bin
+        double wgt = bank[i_start + j].wgt;
+        if (private_bins) {
+          thread_cnt[bins[j]] += wgt;
+        } else {
+          #pragma omp atomic
+          thread_cnt[bins[j]] += wgt;
+        }
+      }
+    }
+  }
+
+  // Combine the counts of the threads in a fixed order so that the result
+  // does not depend on how the threads were scheduled
+  if (private_bins) {
+    #pragma omp parallel for
+    for (std::size_t b = 0; b < m; ++b) {
+      for (int t = 1; t < n_threads; ++t) {
+        cnt[b] += cnt[m*t + b];
+      }
+    }
+    cnt.resize(m);
+  }
+
+  *outside = outside_;
+  return cnt;
+}
+
+void RegularMesh::get_bins(const Particle::Bank* bank, int n, int* bins) const
+{
+  // Copy the mesh parameters into fixed-size arrays. Dimensions that the mesh
+  // does not have are given parameters that place every site in their only
+  // element.
+  std::array<double, 3> ll {0.0, 0.0, 0.0};
+  std::array<double, 3> ur {INFTY, INFTY, INFTY};
+  std::array<double, 3> w {INFTY, INFTY, INFTY};
+  std::array<double, 3> n_i {1.0, 1.0, 1.0};
+  std::array<double, 3> stride {0.0, 0.0, 0.0};
+  double s = 1.0;
+  for (int i = 0; i < n_dimension_; ++i) {
+    ll[i] = lower_left_[i];
+    ur[i] = upper_right_[i];
+    w[i] = width_[i];
+    n_i[i] = shape_[i];
+    stride[i] = s;
+    s *= shape_[i];
+  }
+
+  #pragma omp simd
+  for (int j = 0; j < n; ++j) {
+    const Position& r = bank[j].r;
+    std::array<double, 3> x {r.x, r.y, r.z};
+    bool in_mesh = true;
+    double bin = 0.0;
+    for (int i = 0; i < 3; ++i) {
+      // Dimensions that the mesh does not have accept any coordinate
+      bool active = i < n_dimension_;
+      double ijk = std::ceil((x[i] - ll[i]) / w[i]);
+      bool in_i = x[i] >= ll[i] && x[i] <= ur[i] && ijk >= 1.0 && ijk <= n_i[i];
+      in_mesh = in_mesh && (in_i || !active);
+      bin += active ? (ijk - 1.0)*stride[i] : 0.0;
+    }
+    bins[j] = static_cast<int>(in_mesh ? bin : -1.0);
+  }
+}
+
+void RegularMesh::find_aligned_lattice()
+{
+  aligned_lattice_ = C_NONE;
+
+  // With delta tracking, the coordinate levels of particles are only found at
+  // real collisions
+  if (settings::delta_tracking) return;
+
+  for (int i = 0; i < model::lattices.size(); ++i) {
+    const auto* lat {dynamic_cast<const RectLattice*>(model::lattices[i].get())};
+    if (lat && lat->tiles_match(n_dimension_, lower_left_.data(),
+        width_.data(), shape_.data())) {
+      aligned_lattice_ = i;
+      return;
+    }
+  }
+}
+
 //==============================================================================
 // RectilinearMesh implementation
 //==============================================================================
@@ -950,57 +1159,53 @@ void RectilinearMesh::bins_crossed(const Particle& p, std::vector<int>& bins,
 
   // ========================================================================
   // Find which mesh cells are traversed and the length of each traversal.
-
+  // As for regular meshes, the distance along the track to the next mesh plane
+  // on each axis is kept so that each step only advances one axis. The planes
+  // are not evenly spaced, so the distance to the next plane on that axis is
+  // computed from the start of the track when it is crossed.
+
+  auto plane_distance = [&](int k) {
+    double xyz_cross = (u[k] > 0) ? grid_[k][ijk0[k]] : grid_[k][ijk0[k] - 1];
+    return (xyz_cross - r0[k]) / u[k];
+  };
+
+  double t_max[3] {INFTY, INFTY, INFTY};
+  int step[3] {0, 0, 0};
+  int stride[3] {1, shape_[0], shape_[0] * shape_[1]};
+  for (int k = 0; k < 3; ++k) {
+    if (std::fabs(u[k]) < FP_PRECISION) continue;
+    step[k] = (u[k] > 0) ? 1 : -1;
+    t_max[k] = plane_distance(k);
+  }
+
+  int bin = get_bin_from_indices(ijk0);
+  double t_end = (r1 - r0).norm();
+  double t = 0.0;
   while (true) {
     if (std::equal(ijk0, ijk0+3, ijk1)) {
       // The track ends in this cell.  Use the particle end location rather
       // than the mesh surface and stop iterating.
-      double distance = (r1 - r0).norm();
-      bins.push_back(get_bin_from_indices(ijk0));
-      lengths.push_back(distance / total_distance);
+      bins.push_back(bin);
+      lengths.push_back((t_end - t) / total_distance);
       break;
     }
 
-    // The track exits this cell.  Determine the distance to each mesh surface.
-    double d[3];
-    for (int k = 0; k < 3; ++k) {
-      if (std::fabs(u[k]) < FP_PRECISION) {
-        d[k] = INFTY;
-      } else if (u[k] > 0) {
-        double xyz_cross = grid_[k][ijk0[k]];
-        d[k] = (xyz_cross - r0[k]) / u[k];
-      } else {
-        double xyz_cross = grid_[k][ijk0[k] - 1];
-        d[k] = (xyz_cross - r0[k]) / u[k];
-      }
-    }
-
-    // Pick the closest mesh surface and append this traversal to the output.
-    auto j = std::min_element(d, d+3) - d;
-    double distance = d[j];
-    bins.push_back(get_bin_from_indices(ijk0));
-    lengths.push_back(distance / total_distance);
-
-    // Translate to the oncoming mesh surface.
-    r0 += distance * u;
+    // The track exits this cell through the closest mesh plane.  Append this
+    // traversal to the output.
+    auto j = std::min_element(t_max, t_max+3) - t_max;
+    if (step[j] == 0) break;
+    bins.push_back(bin);
+    lengths.push_back((t_max[j] - t) / total_distance);
 
-    // Increment the indices into the next mesh cell.
-    if (u[j] > 0.0) {
-      ++ijk0[j];
-    } else {
-      --ijk0[j];
-    }
+    // Move into the next mesh cell.
+    t = t_max[j];
+    ijk0[j] += step[j];
+    bin += step[j] * stride[j];
 
     // If the next indices are invalid, then the track has left the mesh and
     // we are done.
-    bool in_mesh = true;
-    for (int i = 0; i < 3; ++i) {
-      if (ijk0[i] < 1 || ijk0[i] > shape_[i]) {
-        in_mesh = false;
-        break;
-      }
-    }
-    if (!in_mesh) break;
+    if (ijk0[j] < 1 || ijk0[j] > shape_[j]) break;
+    t_max[j] = plane_distance(j);
   }
 }
 
@@ -1210,6 +1415,11 @@ void RectilinearMesh::get_indices_from_bin(int bin, int* ijk) const
   ijk[2] = bin / (shape_[0] * shape_[1]) + 1;
 }
 
+double RectilinearMesh::edge(int dim, int i) const
+{
+  return grid_[dim][i - 1];
+}
+
 int RectilinearMesh::n_bins() const
 {
   return xt::prod(shape_)();
@@ -1373,6 +1583,288 @@ bool RectilinearMesh::intersects(Position& r0, Position r1, int* ijk) const
   return min_dist < INFTY;
 }
 
+//==============================================================================
+// AdaptiveMesh implementation
+//==============================================================================
+
+AdaptiveMesh::AdaptiveMesh(pugi::xml_node node)
+  : Mesh {node}, root_ {node}
+{
+  n_dimension_ = root_.n_dimension_;
+
+  // Elements of the root mesh are the first bins, in the same order
+  int n_root = root_.n_bins();
+  elements_.resize(n_root);
+  for (int bin = 0; bin < n_root; ++bin) {
+    std::array<int, 3> ijk {1, 1, 1};
+    root_.get_indices_from_bin(bin, ijk.data());
+    elements_[bin].level = 0;
+    for (int k = 0; k < 3; ++k) elements_[bin].index[k] = ijk[k] - 1;
+  }
+
+  if (check_for_node(node, "max_bins")) {
+    max_bins_ = std::stoi(get_node_value(node, "max_bins"));
+    if (max_bins_ < n_root) {
+      fatal_error(fmt::format("The <max_bins> of adaptive mesh {} must be at "
+        "least the number of elements of its root mesh, {}.", id_, n_root));
+    }
+  } else {
+    max_bins_ = n_root;
+  }
+  if (check_for_node(node, "refine_threshold")) {
+    refine_threshold_ = std::stod(get_node_value(node, "refine_threshold"));
+  }
+  if (check_for_node(node, "refine_rel_error")) {
+    refine_rel_error_ = std::stod(get_node_value(node, "refine_rel_error"));
+  }
+  if (check_for_node(node, "refine_batches")) {
+    refine_batches_ = std::stoi(get_node_value(node, "refine_batches"));
+    if (refine_batches_ < 2) {
+      fatal_error(fmt::format("The <refine_batches> of adaptive mesh {} must "
+        "be at least 2 to estimate relative errors.", id_));
+    }
+  }
+}
+
+std::pair<Position, Position> AdaptiveMesh::bounds(const Element& e) const
+{
+  Position lo, hi;
+  double f = 1.0 / (1 << e.level);
+  for (int k = 0; k < n_dimension_; ++k) {
+    double w = root_.width_[k] * f;
+    lo[k] = root_.lower_left_[k] + e.index[k] * w;
+    hi[k] = lo[k] + w;
+  }
+  return {lo, hi};
+}
+
+int AdaptiveMesh::find_leaf(int bin, Position r) const
+{
+  while (elements_[bin].children >= 0) {
+    const auto& e {elements_[bin]};
+    auto box = bounds(e);
+    int child = 0;
+    for (int k = 0; k < n_dimension_; ++k) {
+      if (r[k] >= 0.5*(box.first[k] + box.second[k])) child |= 1 << k;
+    }
+    bin = e.children + child;
+  }
+  return bin;
+}
+
+int AdaptiveMesh::get_bin(Position r) const
+{
+  int bin = root_.get_bin(r);
+  return (bin < 0) ? bin : find_leaf(bin, r);
+}
+
+void AdaptiveMesh::bins_crossed(const Particle& p, std::vector<int>& bins,
+  std::vector<double>& lengths) const
+{
+  // The elements of the root mesh are found as for a regular mesh
+  std::size_t start = bins.size();
+  root_.bins_crossed(p, bins, lengths);
+  if (elements_.size() == root_.n_bins()) return;
+
+  bool divided = false;
+  for (std::size_t i = start; i < bins.size(); ++i) {
+    if (elements_[bins[i]].children >= 0) divided = true;
+  }
+  if (!divided) return;
+
+  // Divide the parts of the track in elements that have children among their
+  // leaves. Each part is found by clipping the track to the element, and the
+  // lengths of its leaves are scaled to add up to the length given above.
+  std::vector<int> root_bins(bins.begin() + start, bins.end());
+  std::vector<double> root_lengths(lengths.begin() + start, lengths.end());
+  bins.resize(start);
+  lengths.resize(start);
+
+  Position r0 {p.r_last_};
+  Direction u {p.u()};
+  double total_distance = (p.r() - r0).norm();
+  for (std::size_t i = 0; i < root_bins.size(); ++i) {
+    int bin = root_bins[i];
+    if (elements_[bin].children < 0) {
+      bins.push_back(bin);
+      lengths.push_back(root_lengths[i]);
+      continue;
+    }
+
+    auto box = bounds(elements_[bin]);
+    double t0 = 0.0;
+    double t1 = total_distance;
+    for (int k = 0; k < n_dimension_; ++k) {
+      if (u[k] == 0.0) continue;
+      double ta = (box.first[k] - r0[k]) / u[k];
+      double tb = (box.second[k] - r0[k]) / u[k];
+      if (ta > tb) std::swap(ta, tb);
+      t0 = std::max(t0, ta);
+      t1 = std::min(t1, tb);
+    }
+    if (t1 > t0) {
+      walk_element(bin, r0, u, t0, t1, root_lengths[i] / (t1 - t0), bins,
+        lengths);
+    } else {
+      bins.push_back(find_leaf(bin, r0 + 0.5*(t0 + t1)*u));
+      lengths.push_back(root_lengths[i]);
+    }
+  }
+}
+
+void AdaptiveMesh::walk_element(int bin, Position r0, Direction u, double t0,
+  double t1, double scale, std::vector<int>& bins,
+  std::vector<double>& lengths) const
+{
+  const auto& e {elements_[bin]};
+  if (e.children < 0) {
+    bins.push_back(bin);
+    lengths.push_back((t1 - t0) * scale);
+    return;
+  }
+
+  // The children are visited in order like cells of a mesh two elements wide,
+  // stepping at the distances where the track crosses the planes dividing
+  // the element
+  auto box = bounds(e);
+  Position mid = 0.5*(box.first + box.second);
+  std::array<double, 5> t {t0};
+  int m = 1;
+  for (int k = 0; k < n_dimension_; ++k) {
+    if (u[k] == 0.0) continue;
+    double t_plane = (mid[k] - r0[k]) / u[k];
+    if (t_plane > t0 && t_plane < t1) t[m++] = t_plane;
+  }
+  std::sort(t.begin() + 1, t.begin() + m);
+  t[m++] = t1;
+
+  for (int i = 0; i < m - 1; ++i) {
+    if (t[i + 1] <= t[i]) continue;
+    Position r = r0 + 0.5*(t[i] + t[i + 1])*u;
+    int child = 0;
+    for (int k = 0; k < n_dimension_; ++k) {
+      if (r[k] >= mid[k]) child |= 1 << k;
+    }
+    walk_element(e.children + child, r0, u, t[i], t[i + 1], scale, bins,
+      lengths);
+  }
+}
+
+std::vector<int>
+AdaptiveMesh::select_refinement(const std::vector<double>& priority) const
+{
+  std::vector<int> candidates;
+  for (int bin = 0; bin < elements_.size(); ++bin) {
+    if (elements_[bin].children < 0 && priority[bin] > 0.0) {
+      candidates.push_back(bin);
+    }
+  }
+  std::stable_sort(candidates.begin(), candidates.end(),
+    [&](int a, int b) { return priority[a] > priority[b]; });
+
+  int n_children = 1 << n_dimension_;
+  int n_free = (max_bins_ - n_elements()) / n_children;
+  if (candidates.size() > n_free) candidates.resize(n_free);
+  return candidates;
+}
+
+void AdaptiveMesh::refine(const std::vector<int>& bins)
+{
+  int n_children = 1 << n_dimension_;
+  for (int bin : bins) {
+    int first = elements_.size();
+    Element parent = elements_[bin];
+    for (int child = 0; child < n_children; ++child) {
+      Element e;
+      e.level = parent.level + 1;
+      for (int k = 0; k < 3; ++k) {
+        e.index[k] = 2*parent.index[k] + ((k < n_dimension_) ?
+          (child >> k) & 1 : 0);
+      }
+      elements_.push_back(e);
+    }
+    elements_[bin].children = first;
+  }
+}
+
+void AdaptiveMesh::read_elements(hid_t group)
+{
+  std::vector<int> levels, children;
+  xt::xarray<int> indices;
+  read_dataset(group, "levels", levels);
+  read_dataset(group, "indices", indices);
+  read_dataset(group, "children", children);
+  if (levels.size() < root_.n_bins() || levels.size() > max_bins_ ||
+      indices.shape()[1] != n_dimension_) {
+    fatal_error(fmt::format("The elements of adaptive mesh {} in the state "
+      "point don't fit its root mesh and number of bins.", id_));
+  }
+
+  elements_.resize(levels.size());
+  for (std::size_t i = 0; i < levels.size(); ++i) {
+    elements_[i].level = levels[i];
+    elements_[i].children = children[i];
+    elements_[i].index = {0, 0, 0};
+    for (int k = 0; k < n_dimension_; ++k) {
+      elements_[i].index[k] = indices(i, k) - 1;
+    }
+  }
+}
+
+std::pair<std::vector<double>, std::vector<double>>
+AdaptiveMesh::plot(Position plot_ll, Position plot_ur) const
+{
+  return root_.plot(plot_ll, plot_ur);
+}
+
+std::string AdaptiveMesh::bin_label(int bin) const
+{
+  if (bin >= elements_.size()) {
+    return fmt::format("Mesh Element {} (Unused)", bin);
+  }
+  const auto& e {elements_[bin]};
+  if (n_dimension_ > 2) {
+    return fmt::format("Mesh Element {} (Level {}, Index ({}, {}, {}))", bin,
+      e.level, e.index[0] + 1, e.index[1] + 1, e.index[2] + 1);
+  } else if (n_dimension_ > 1) {
+    return fmt::format("Mesh Element {} (Level {}, Index ({}, {}))", bin,
+      e.level, e.index[0] + 1, e.index[1] + 1);
+  } else {
+    return fmt::format("Mesh Element {} (Level {}, Index ({}))", bin,
+      e.level, e.index[0] + 1);
+  }
+}
+
+void AdaptiveMesh::to_hdf5(hid_t group) const
+{
+  hid_t mesh_group = create_group(group, "mesh " + std::to_string(id_));
+
+  write_dataset(mesh_group, "type", "adaptive");
+  write_dataset(mesh_group, "dimension", root_.shape_);
+  write_dataset(mesh_group, "lower_left", root_.lower_left_);
+  write_dataset(mesh_group, "upper_right", root_.upper_right_);
+  write_dataset(mesh_group, "width", root_.width_);
+  write_dataset(mesh_group, "max_bins", max_bins_);
+
+  // Elements of all levels, with their indices starting at 1 like those of
+  // regular meshes
+  std::vector<int> levels, children;
+  std::size_t n = n_dimension_;
+  xt::xtensor<int, 2> indices({elements_.size(), n});
+  for (std::size_t i = 0; i < elements_.size(); ++i) {
+    levels.push_back(elements_[i].level);
+    children.push_back(elements_[i].children);
+    for (std::size_t k = 0; k < n; ++k) {
+      indices(i, k) = elements_[i].index[k] + 1;
+    }
+  }
+  write_dataset(mesh_group, "levels", levels);
+  write_dataset(mesh_group, "indices", indices);
+  write_dataset(mesh_group, "children", children);
+
+  close_group(mesh_group);
+}
+
 //==============================================================================
 // Helper functions for the C API
 //==============================================================================
@@ -1556,97 +2048,224 @@ UnstructuredMesh::UnstructuredMesh(pugi::xml_node node) : Mesh(node)
     fatal_error("Failed to load the unstructured mesh file: " + filename_);
   }
 
-  // set member range of tetrahedral entities
+  // set member range of mesh elements
   rval = mbi_->get_entities_by_dimension(0, n_dimension_, ehs_);
   if (rval != moab::MB_SUCCESS) {
-    fatal_error("Failed to get all tetrahedral elements");
+    fatal_error("Failed to get all elements of unstructured mesh: " +
+                filename_);
   }
 
-  if (!ehs_.all_of_type(moab::MBTET)) {
-    warning("Non-tetrahedral elements found in unstructured "
-            "mesh file: " + filename_);
+  size_t n_supported = 0;
+  for (auto type : {moab::MBTET, moab::MBHEX, moab::MBPRISM,
+                    moab::MBPYRAMID}) {
+    n_supported += ehs_.num_of_type(type);
+  }
+  if (n_supported != ehs_.size()) {
+    fatal_error("Unsupported elements found in unstructured mesh file: " +
+                filename_ + ". Only tetrahedra, hexahedra, wedges and "
+                "pyramids are supported.");
   }
 
-  // make an entity set for all tetrahedra
+  // make an entity set for all elements
   // this is used for convenience later in output
   rval = mbi_->create_meshset(moab::MESHSET_SET, tetset_);
   if (rval != moab::MB_SUCCESS) {
-    fatal_error("Failed to create an entity set for the tetrahedral elements");
+    fatal_error("Failed to create an entity set for the mesh elements");
   }
 
   rval = mbi_->add_entities(tetset_, ehs_);
   if (rval != moab::MB_SUCCESS) {
-    fatal_error("Failed to add tetrahedra to an entity set.");
+    fatal_error("Failed to add elements to an entity set.");
   }
 
   // build acceleration data structures
   compute_barycentric_data(ehs_);
-  build_kdtree(ehs_);
+  compute_adjacency();
+  build_trees();
 }
 
+namespace {
+
+//! Faces of the hexahedron, wedge and pyramid by local vertex indices, in
+//! the MOAB (Exodus) vertex order of each element
+
+const std::vector<std::vector<int>> HEX_FACES {{0, 1, 5, 4}, {1, 2, 6, 5},
+  {2, 3, 7, 6}, {3, 0, 4, 7}, {0, 3, 2, 1}, {4, 5, 6, 7}};
+const std::vector<std::vector<int>> PRISM_FACES {{0, 1, 4, 3}, {1, 2, 5, 4},
+  {2, 0, 3, 5}, {0, 2, 1}, {3, 4, 5}};
+const std::vector<std::vector<int>> PYRAMID_FACES {{0, 1, 2, 3}, {0, 1, 4},
+  {1, 2, 4}, {2, 3, 4}, {3, 0, 4}};
+
+Position to_position(const moab::CartVect& v)
+{
+  return {v[0], v[1], v[2]};
+}
+
+} // namespace
+
 void
-UnstructuredMesh::build_kdtree(const moab::Range& all_tets)
-{
-  moab::Range all_tris;
-  int adj_dim = 2;
-  moab::ErrorCode rval = mbi_->get_adjacencies(all_tets,
-                                               adj_dim,
-                                               true,
-                                               all_tris,
-                                               moab::Interface::UNION);
+UnstructuredMesh::compute_barycentric_data(const moab::Range& elems) {
+  moab::ErrorCode rval;
+
+  // copy the coordinates of all corner vertices of the elements into one
+  // array
+  moab::Range all_verts;
+  rval = mbi_->get_connectivity(elems, all_verts, true);
   if (rval != moab::MB_SUCCESS) {
-    fatal_error("Failed to get adjacent triangles for tets");
+    fatal_error("Failed to get vertices of elements on umesh: " + filename_);
   }
-
-  if (!all_tris.all_of_type(moab::MBTRI)) {
-    warning("Non-triangle elements found in tet adjacencies in "
-            "unstructured mesh file: " + filename_);
+  vertices_.resize(all_verts.size());
+  rval = mbi_->get_coords(all_verts, vertices_[0].array());
+  if (rval != moab::MB_SUCCESS) {
+    fatal_error("Failed to get vertex coordinates on umesh: " + filename_);
   }
 
-  // combine into one range
-  moab::Range all_tets_and_tris;
-  all_tets_and_tris.merge(all_tets);
-  all_tets_and_tris.merge(all_tris);
+  elem_offsets_.assign(1, 0);
+  elem_vertices_.clear();
+  tet_connectivity_.clear();
+  tet_elements_.clear();
 
-  // create a kd-tree instance
-  kdtree_ = std::make_unique<moab::AdaptiveKDTree>(mbi_.get());
+  for (auto& elem : elems) {
+    std::vector<moab::EntityHandle> verts;
+    rval = mbi_->get_connectivity(&elem, 1, verts, true);
+    if (rval != moab::MB_SUCCESS) {
+      fatal_error("Failed to get connectivity of element on umesh: " +
+                  filename_);
+    }
 
-  // build the tree
-  rval = kdtree_->build_tree(all_tets_and_tris, &kdtree_root_);
-  if (rval != moab::MB_SUCCESS) {
-    fatal_error("Failed to construct KDTree for the "
-                "unstructured mesh file: " + filename_);
+    int bin = get_bin_from_ent_handle(elem);
+    std::vector<int> conn;
+    for (auto v : verts) {
+      conn.push_back(all_verts.index(v));
+    }
+    elem_vertices_.insert(elem_vertices_.end(), conn.begin(), conn.end());
+    elem_offsets_.push_back(elem_vertices_.size());
+
+    // tetrahedra are kept as they are
+    if (conn.size() == 4) {
+      tet_connectivity_.push_back({conn[0], conn[1], conn[2], conn[3]});
+      tet_elements_.push_back(bin);
+      continue;
+    }
+
+    // Other elements are split into tetrahedra joining a vertex added at
+    // their centroid to the triangles of their faces. Quadrilateral faces
+    // are split along the diagonal through their vertex of lowest index, so
+    // that the two elements sharing a face split it the same way and the
+    // tetrahedra of the whole mesh are conforming.
+    const auto& faces = conn.size() == 8 ? HEX_FACES :
+      conn.size() == 6 ? PRISM_FACES : PYRAMID_FACES;
+    moab::CartVect center(0.0, 0.0, 0.0);
+    for (int v : conn) {
+      center += vertices_[v];
+    }
+    vertices_.push_back(center / conn.size());
+    int c = vertices_.size() - 1;
+
+    for (const auto& face : faces) {
+      if (face.size() == 3) {
+        tet_connectivity_.push_back({conn[face[0]], conn[face[1]],
+                                     conn[face[2]], c});
+        tet_elements_.push_back(bin);
+        continue;
+      }
+      std::array<int, 4> q;
+      for (int j = 0; j < 4; ++j) {
+        q[j] = conn[face[j]];
+      }
+      int k = std::min_element(q.begin(), q.end()) - q.begin();
+      tet_connectivity_.push_back({q[k], q[(k + 1) % 4], q[(k + 2) % 4], c});
+      tet_connectivity_.push_back({q[k], q[(k + 2) % 4], q[(k + 3) % 4], c});
+      tet_elements_.push_back(bin);
+      tet_elements_.push_back(bin);
+    }
   }
-}
 
-void
-UnstructuredMesh::intersect_track(const moab::CartVect& start,
-                                  const moab::CartVect& dir,
-                                  double track_len,
-                                  std::vector<double>& hits) const {
-  hits.clear();
+  // compute the barycentric data for each tet
+  // and store it as a 3x3 matrix
+  baryc_data_.resize(tet_connectivity_.size());
+  for (size_t i = 0; i < tet_connectivity_.size(); ++i) {
+    const auto& conn = tet_connectivity_[i];
+    const moab::CartVect& p0 = vertices_[conn[0]];
+    moab::Matrix3 a(vertices_[conn[1]] - p0, vertices_[conn[2]] - p0,
+                    vertices_[conn[3]] - p0, true);
 
-  moab::ErrorCode rval;
-  std::vector<moab::EntityHandle> tris;
-  // get all intersections with triangles in the tet mesh
-  // (distances are relative to the start point, not the previous intersection)
-  rval = kdtree_->ray_intersect_triangles(kdtree_root_,
-                                          FP_COINCIDENT,
-                                          dir.array(),
-                                          start.array(),
-                                          tris,
-                                          hits,
-                                          0,
-                                          track_len);
-  if (rval != moab::MB_SUCCESS) {
-    fatal_error("Failed to compute intersections on unstructured mesh: " + filename_);
+    // invert now to avoid this cost later
+    baryc_data_[i] = a.transpose().inverse();
   }
+}
 
-  // remove duplicate intersection distances
-  std::unique(hits.begin(), hits.end());
+void
+UnstructuredMesh::compute_adjacency() {
+  // Sort the faces of all tets by their vertices so that the two tets
+  // sharing a face are next to each other
+  struct Face {
+    std::array<int, 3> verts; //!< sorted vertices of the face
+    int id;                   //!< 4 * tet + index of the opposite vertex
+  };
+  std::vector<Face> faces;
+  faces.reserve(4 * tet_connectivity_.size());
+  for (int i = 0; i < tet_connectivity_.size(); ++i) {
+    const auto& conn = tet_connectivity_[i];
+    for (int k = 0; k < 4; ++k) {
+      Face f {{}, 4 * i + k};
+      int n = 0;
+      for (int j = 0; j < 4; ++j) {
+        if (j != k) f.verts[n++] = conn[j];
+      }
+      std::sort(f.verts.begin(), f.verts.end());
+      faces.push_back(f);
+    }
+  }
+  std::sort(faces.begin(), faces.end(),
+    [](const Face& a, const Face& b) { return a.verts < b.verts; });
+
+  tet_neighbors_.assign(tet_connectivity_.size(), {-1, -1, -1, -1});
+  for (size_t i = 0; i + 1 < faces.size(); ++i) {
+    const auto& a = faces[i];
+    const auto& b = faces[i + 1];
+    if (a.verts == b.verts) {
+      tet_neighbors_[a.id / 4][a.id % 4] = b.id / 4;
+      tet_neighbors_[b.id / 4][b.id % 4] = a.id / 4;
+      ++i;
+    }
+  }
+}
 
-  // sorts by first component of std::pair by default
-  std::sort(hits.begin(), hits.end());
+void
+UnstructuredMesh::build_trees() {
+  tet_tree_ = BoxBVH(tet_connectivity_.size(), [this](int32_t tet) {
+    BoundingBox box = {INFTY, -INFTY, INFTY, -INFTY, INFTY, -INFTY};
+    for (int v : tet_connectivity_[tet]) {
+      const auto& p = vertices_[v];
+      box.xmin = std::min(box.xmin, p[0]);
+      box.xmax = std::max(box.xmax, p[0]);
+      box.ymin = std::min(box.ymin, p[1]);
+      box.ymax = std::max(box.ymax, p[1]);
+      box.zmin = std::min(box.zmin, p[2]);
+      box.zmax = std::max(box.zmax, p[2]);
+    }
+    return box;
+  });
+
+  // The faces without a neighbor bound the mesh. Tracks may enter the mesh
+  // through any of them, so they are two-sided.
+  std::vector<TriangleBVH::Triangle> triangles;
+  for (int i = 0; i < tet_connectivity_.size(); ++i) {
+    for (int k = 0; k < 4; ++k) {
+      if (tet_neighbors_[i][k] != -1) continue;
+      TriangleBVH::Triangle t;
+      int n = 0;
+      for (int j = 0; j < 4; ++j) {
+        if (j != k) t.v[n++] = to_position(vertices_[tet_connectivity_[i][j]]);
+      }
+      t.surface = 0;
+      t.id = 4 * i + k;
+      t.two_sided = true;
+      triangles.push_back(t);
+    }
+  }
+  boundary_ = std::make_unique<TriangleBVH>(std::move(triangles));
 }
 
 void
@@ -1658,27 +2277,13 @@ UnstructuredMesh::bins_crossed(const Particle& p,
   Position r{p.r()};
   Direction u{p.u()};
   u /= u.norm();
-  moab::CartVect r0(last_r.x, last_r.y, last_r.z);
-  moab::CartVect r1(r.x, r.y, r.z);
-  moab::CartVect dir(u.x, u.y, u.z);
-
-  double track_len = (r1 - r0).length();
-
-  r0 -= TINY_BIT * dir;
-  r1 += TINY_BIT * dir;
-
-  std::vector<double> hits;
-  intersect_track(r0, dir, track_len, hits);
+  double track_len = (r - last_r).norm();
 
   bins.clear();
   lengths.clear();
 
-  // if there are no intersections the track may lie entirely
-  // within a single tet. If this is the case, apply entire
-  // score to that tet and return.
-  if (hits.size() == 0) {
-    Position midpoint = last_r + u * (track_len * 0.5);
-    int bin = this->get_bin(midpoint);
+  if (track_len == 0.0) {
+    int bin = this->get_bin(last_r);
     if (bin != -1) {
       bins.push_back(bin);
       lengths.push_back(1.0);
@@ -1686,88 +2291,93 @@ UnstructuredMesh::bins_crossed(const Particle& p,
     return;
   }
 
-  // for each segment in the set of tracks, try to look up a tet
-  // at the midpoint of the segment
-  Position current = last_r;
-  double last_dist = 0.0;
-  for (const auto& hit : hits) {
-    // get the segment length
-    double segment_length = hit - last_dist;
-    last_dist = hit;
-    // find the midpoint of this segment
-    Position midpoint = current + u * (segment_length * 0.5);
-    // try to find a tet for this position
-    int bin = this->get_bin(midpoint);
-
-    // determine the start point for this segment
-    current = last_r + u * hit;
-
-    if (bin == -1) {
+  // Walk from the tet containing the track to its neighbors through the
+  // faces crossed. The barycentric coordinates vary linearly along the
+  // track, so each exit face is the one whose coordinate first drops to
+  // zero. Outside of the mesh, the track is intersected with the faces on
+  // its boundary to find where it enters again. A track grazing an edge or
+  // a vertex may not advance through a few tets, but one that stalls is
+  // left unscored from there.
+  moab::CartVect r0(last_r.x, last_r.y, last_r.z);
+  moab::CartVect dir(u.x, u.y, u.z);
+  double t = 0.0;
+  int tet = find_tet(last_r);
+  int64_t exclude = -1;
+  int n_stalled = 0;
+  while (n_stalled <= 4) {
+    if (tet == -1) {
+      auto hit = boundary_->intersect(last_r + u * t, u, exclude);
+      if (t + hit.distance >= track_len) break;
+      t += hit.distance;
+      exclude = hit.id;
+      tet = find_tet(last_r + u * (t + TINY_BIT));
+      if (tet == -1) ++n_stalled;
       continue;
     }
 
-    bins.push_back(bin);
-    lengths.push_back(segment_length / track_len);
-
-  }
-
-  // tally remaining portion of track after last hit if
-  // the last segment of the track is in the mesh but doesn't
-  // reach the other side of the tet
-  if (hits.back() < track_len) {
-    Position segment_start = last_r + u * hits.back();
-    double segment_length = track_len - hits.back();
-    Position midpoint = segment_start + u * (segment_length * 0.5);
-    int bin = this->get_bin(midpoint);
-    if (bin != -1) {
-      bins.push_back(bin);
-      lengths.push_back(segment_length / track_len);
+    const auto& a_inv = baryc_data_[tet];
+    moab::CartVect l = a_inv * (r0 - vertices_[tet_connectivity_[tet][0]]);
+    moab::CartVect dl = a_inv * dir;
+    std::array<double, 4> lambda {1.0 - l[0] - l[1] - l[2], l[0], l[1], l[2]};
+    std::array<double, 4> rate {-dl[0] - dl[1] - dl[2], dl[0], dl[1], dl[2]};
+
+    double t_exit = INFTY;
+    int face = 0;
+    for (int k = 0; k < 4; ++k) {
+      if (rate[k] < 0.0 && -lambda[k] / rate[k] < t_exit) {
+        t_exit = -lambda[k] / rate[k];
+        face = k;
+      }
     }
+    t_exit = std::max(t_exit, t);
+
+    // Score the segment in the element of this tet, adding it to the
+    // previous segment if that was in the same element
+    double t_end = std::min(t_exit, track_len);
+    if (t_end > t) {
+      int bin = tet_elements_[tet];
+      if (!bins.empty() && bins.back() == bin) {
+        lengths.back() += t_end - t;
+      } else {
+        bins.push_back(bin);
+        lengths.push_back(t_end - t);
+      }
+      n_stalled = 0;
+    } else {
+      ++n_stalled;
+    }
+    if (t_exit >= track_len) break;
+    t = t_exit;
+
+    // Move into the neighbor across the exit face if the track goes on into
+    // it, since it may actually leave through an edge or a vertex
+    Position ahead = last_r + u * (t + TINY_BIT);
+    moab::CartVect pos(ahead.x, ahead.y, ahead.z);
+    int next = tet_neighbors_[tet][face];
+    if (next == -1 || !point_in_tet(pos, next)) {
+      next = find_tet(ahead);
+    }
+    if (next == -1) exclude = 4 * tet + face;
+    tet = next;
   }
-};
 
-moab::EntityHandle
-UnstructuredMesh::get_tet(const Position& r) const
-{
-  moab::CartVect pos(r.x, r.y, r.z);
-  // find the leaf of the kd-tree for this position
-  moab::AdaptiveKDTreeIter kdtree_iter;
-  moab::ErrorCode rval = kdtree_->point_search(pos.array(), kdtree_iter);
-  if (rval != moab::MB_SUCCESS) { return 0; }
-
-  // retrieve the tet elements of this leaf
-  moab::EntityHandle leaf = kdtree_iter.handle();
-  moab::Range tets;
-  rval = mbi_->get_entities_by_dimension(leaf, 3, tets, false);
-  if (rval != moab::MB_SUCCESS) {
-    warning("MOAB error finding tets.");
+  for (auto& length : lengths) {
+    length /= track_len;
   }
+};
 
-  // loop over the tets in this leaf, returning the containing tet if found
-  for (const auto& tet : tets) {
-    if (point_in_tet(pos, tet)) {
-      return tet;
-    }
+double UnstructuredMesh::volume(int bin) const {
+  // the tets of each element are contiguous
+  auto range = std::equal_range(tet_elements_.begin(), tet_elements_.end(),
+                                bin);
+  double volume = 0.0;
+  for (auto it = range.first; it != range.second; ++it) {
+    const auto& conn = tet_connectivity_[it - tet_elements_.begin()];
+    const moab::CartVect& p0 = vertices_[conn[0]];
+    volume += std::abs(((vertices_[conn[1]] - p0) * (vertices_[conn[2]] - p0))
+      % (vertices_[conn[3]] - p0));
   }
-
-  // if no tet is found, return an invalid handle
-  return 0;
-}
-
-double UnstructuredMesh::tet_volume(moab::EntityHandle tet) const {
- std::vector<moab::EntityHandle> conn;
- moab::ErrorCode rval = mbi_->get_connectivity(&tet, 1, conn);
- if (rval != moab::MB_SUCCESS) {
-   fatal_error("Failed to get tet connectivity");
- }
-
- moab::CartVect p[4];
- rval = mbi_->get_coords(conn.data(), conn.size(), p[0].array());
- if (rval != moab::MB_SUCCESS) {
-   fatal_error("Failed to get tet coords");
- }
-
- return 1.0 / 6.0 * (((p[1] - p[0]) * (p[2] - p[0])) % (p[3] - p[0]));
+  return volume / 6.0;
 }
 
 void UnstructuredMesh::surface_bins_crossed(const Particle& p, std::vector<int>& bins) const {
@@ -1776,43 +2386,16 @@ void UnstructuredMesh::surface_bins_crossed(const Particle& p, std::vector<int>&
 }
 
 int
-UnstructuredMesh::get_bin(Position r) const {
-  moab::EntityHandle tet = get_tet(r);
-  if (tet == 0) {
-    return -1;
-  } else {
-    return get_bin_from_ent_handle(tet);
-  }
+UnstructuredMesh::find_tet(Position r) const {
+  moab::CartVect pos(r.x, r.y, r.z);
+  return tet_tree_.find(r,
+    [this, &pos](int32_t tet) { return point_in_tet(pos, tet); });
 }
 
-void
-UnstructuredMesh::compute_barycentric_data(const moab::Range& tets) {
-  moab::ErrorCode rval;
-
-  baryc_data_.clear();
-  baryc_data_.resize(tets.size());
-
-  // compute the barycentric data for each tet element
-  // and store it as a 3x3 matrix
-  for (auto& tet : tets) {
-    std::vector<moab::EntityHandle> verts;
-    rval = mbi_->get_connectivity(&tet, 1, verts);
-    if (rval != moab::MB_SUCCESS) {
-      fatal_error("Failed to get connectivity of tet on umesh: " + filename_);
-    }
-
-    moab::CartVect p[4];
-    rval = mbi_->get_coords(verts.data(), verts.size(), p[0].array());
-    if (rval != moab::MB_SUCCESS) {
-      fatal_error("Failed to get coordinates of a tet in umesh: " + filename_);
-    }
-
-    moab::Matrix3 a(p[1] - p[0], p[2] - p[0], p[3] - p[0], true);
-
-    // invert now to avoid this cost later
-    a = a.transpose().inverse();
-    baryc_data_.at(get_bin_from_ent_handle(tet)) = a;
-  }
+int
+UnstructuredMesh::get_bin(Position r) const {
+  int tet = find_tet(r);
+  return tet == -1 ? -1 : tet_elements_[tet];
 }
 
 void
@@ -1823,12 +2406,12 @@ UnstructuredMesh::to_hdf5(hid_t group) const
     write_dataset(mesh_group, "type", "unstructured");
     write_dataset(mesh_group, "filename", filename_);
 
-    // write volume and centroid of each tet
+    // write volume and centroid of each element
     std::vector<double> tet_vols;
     xt::xtensor<double, 2> centroids({ehs_.size(), 3});
     for (int i = 0; i < ehs_.size(); i++) {
       const auto& eh = ehs_[i];
-      tet_vols.emplace_back(this->tet_volume(eh));
+      tet_vols.emplace_back(this->volume(i));
       Position c = this->centroid(eh);
       xt::view(centroids, i, xt::all()) = xt::xarray<double>({c.x, c.y, c.z});
     }
@@ -1840,31 +2423,11 @@ UnstructuredMesh::to_hdf5(hid_t group) const
 }
 
 bool
-UnstructuredMesh::point_in_tet(const moab::CartVect& r, moab::EntityHandle tet) const {
-
-  moab::ErrorCode rval;
-
-  // get tet vertices
-  std::vector<moab::EntityHandle> verts;
-  rval = mbi_->get_connectivity(&tet, 1, verts);
-  if (rval != moab::MB_SUCCESS) {
-    warning("Failed to get vertices of tet in umesh: " + filename_);
-    return false;
-  }
+UnstructuredMesh::point_in_tet(const moab::CartVect& r, int tet) const {
 
-  // first vertex is used as a reference point for the barycentric data -
-  // retrieve its coordinates
-  moab::CartVect p_zero;
-  rval = mbi_->get_coords(verts.data(), 1, p_zero.array());
-  if (rval != moab::MB_SUCCESS) {
-    warning("Failed to get coordinates of a vertex in "
-            "unstructured mesh: " + filename_);
-    return false;
-  }
-
-  // look up barycentric data
-  int idx = get_bin_from_ent_handle(tet);
-  const moab::Matrix3& a_inv = baryc_data_[idx];
+  // first vertex is used as a reference point for the barycentric data
+  const moab::CartVect& p_zero = vertices_[tet_connectivity_[tet][0]];
+  const moab::Matrix3& a_inv = baryc_data_[tet];
 
   moab::CartVect bary_coords = a_inv * (r - p_zero);
 
@@ -1879,7 +2442,7 @@ UnstructuredMesh::get_bin_from_index(int idx) const {
   if (idx >= n_bins()) {
     fatal_error(fmt::format("Invalid bin index: {}", idx));
   }
-  return ehs_[idx] - ehs_[0];
+  return idx;
 }
 
 int
@@ -1902,8 +2465,9 @@ UnstructuredMesh::plot(Position plot_ll, Position plot_ur) const {
 
 int
 UnstructuredMesh::get_bin_from_ent_handle(moab::EntityHandle eh) const {
-  int bin = eh - ehs_[0];
-  if (bin >= n_bins()) {
+  // the elements may be of several types, whose handles aren't contiguous
+  int bin = ehs_.index(eh);
+  if (bin < 0) {
     fatal_error(fmt::format("Invalid bin: {}", bin));
   }
   return bin;
@@ -1934,31 +2498,14 @@ int UnstructuredMesh::n_surface_bins() const {
 }
 
 Position
-UnstructuredMesh::centroid(moab::EntityHandle tet) const {
-  moab::ErrorCode rval;
-
-  // look up the tet connectivity
-  std::vector<moab::EntityHandle> conn;
-  rval = mbi_->get_connectivity(&tet, 1, conn);
-  if (rval != moab::MB_SUCCESS) {
-    warning("Failed to get connectivity of a mesh element.");
-    return {};
-  }
-
-  // get the coordinates
-  std::vector<moab::CartVect> coords(conn.size());
-  rval = mbi_->get_coords(conn.data(), conn.size(), coords[0].array());
-  if (rval != moab::MB_SUCCESS) {
-    warning("Failed to get the coordinates of a mesh element.");
-    return {};
-  }
-
+UnstructuredMesh::centroid(moab::EntityHandle elem) const {
   // compute the centroid of the element vertices
+  int bin = get_bin_from_ent_handle(elem);
   moab::CartVect centroid(0.0, 0.0, 0.0);
-  for(const auto& coord : coords) {
-    centroid += coord;
+  for (int i = elem_offsets_[bin]; i < elem_offsets_[bin + 1]; ++i) {
+    centroid += vertices_[elem_vertices_[i]];
   }
-  centroid /= double(coords.size());
+  centroid /= elem_offsets_[bin + 1] - elem_offsets_[bin];
 
   return {centroid[0], centroid[1], centroid[2]};
 }
@@ -2023,8 +2570,7 @@ UnstructuredMesh::set_score_data(const std::string& score,
 
   // normalize tally values by element volume
   for (int i = 0; i < ehs_.size(); i++) {
-    auto eh = this->get_ent_handle_from_bin(i);
-    double volume = this->tet_volume(eh);
+    double volume = this->volume(i);
     values[i] /= volume;
     std_dev[i] /= volume;
   }
@@ -2047,6 +2593,118 @@ UnstructuredMesh::set_score_data(const std::string& score,
   }
 }
 
+namespace {
+
+//! Write values in the big-endian byte order of binary legacy VTK files
+
+template<typename T>
+void write_big_endian(std::ostream& out, const T* values, size_t n)
+{
+  const uint16_t one = 1;
+  bool little_endian = *reinterpret_cast<const char*>(&one) == 1;
+  if (!little_endian) {
+    out.write(reinterpret_cast<const char*>(values), n * sizeof(T));
+    return;
+  }
+
+  // swap bytes through a buffer of limited size
+  constexpr size_t BUFFER_SIZE {1 << 16};
+  std::vector<T> buffer(std::min(n, BUFFER_SIZE));
+  for (size_t start = 0; start < n; start += BUFFER_SIZE) {
+    size_t count = std::min(n - start, BUFFER_SIZE);
+    std::copy(values + start, values + start + count, buffer.begin());
+    for (size_t i = 0; i < count; ++i) {
+      auto bytes = reinterpret_cast<char*>(&buffer[i]);
+      std::reverse(bytes, bytes + sizeof(T));
+    }
+    out.write(reinterpret_cast<const char*>(buffer.data()), count * sizeof(T));
+  }
+}
+
+} // namespace
+
+void
+UnstructuredMesh::write_vtk(const std::string& base_filename,
+  const std::vector<std::string>& names,
+  const std::function<void(int, std::vector<double>&)>& get_data) const
+{
+  auto filename = base_filename + ".vtk";
+  write_message("Writing unstructured mesh " + filename + "...", 5);
+  filename = settings::path_output + filename;
+
+  std::ofstream out(filename, std::ios::binary);
+  if (!out) {
+    warning(fmt::format("Failed to write unstructured mesh {}", id_));
+    return;
+  }
+
+  out << "# vtk DataFile Version 3.0\n";
+  out << fmt::format("OpenMC unstructured mesh {}\n", id_);
+  out << "BINARY\nDATASET UNSTRUCTURED_GRID\n";
+
+  // vertices, which are stored contiguously
+  out << fmt::format("POINTS {} double\n", vertices_.size());
+  write_big_endian(out, vertices_[0].array(), 3 * vertices_.size());
+
+  // connectivity, each element being preceded by its number of vertices.
+  // VTK orders the vertices of elements as MOAB does, except that the
+  // triangles of wedges are wound the other way.
+  size_t n_elems = ehs_.size();
+  out << fmt::format("\nCELLS {} {}\n", n_elems,
+    n_elems + elem_vertices_.size());
+  std::vector<int32_t> cell;
+  cell.reserve(n_elems + elem_vertices_.size());
+  for (size_t i = 0; i < n_elems; ++i) {
+    const int* conn = &elem_vertices_[elem_offsets_[i]];
+    int n = elem_offsets_[i + 1] - elem_offsets_[i];
+    cell.push_back(n);
+    if (n == 6) {
+      for (int j : {0, 2, 1, 3, 5, 4}) {
+        cell.push_back(conn[j]);
+      }
+    } else {
+      cell.insert(cell.end(), conn, conn + n);
+    }
+  }
+  write_big_endian(out, cell.data(), cell.size());
+
+  // VTK cell types of tetrahedra, pyramids, wedges and hexahedra
+  out << fmt::format("\nCELL_TYPES {}\n", n_elems);
+  cell.resize(n_elems);
+  for (size_t i = 0; i < n_elems; ++i) {
+    switch (elem_offsets_[i + 1] - elem_offsets_[i]) {
+    case 4: cell[i] = 10; break;
+    case 5: cell[i] = 14; break;
+    case 6: cell[i] = 13; break;
+    default: cell[i] = 12;
+    }
+  }
+  write_big_endian(out, cell.data(), n_elems);
+  cell = {};
+
+  // data, divided by the volume of their element
+  std::vector<double> volumes(n_elems);
+  for (size_t i = 0; i < n_elems; ++i) {
+    volumes[i] = volume(i);
+  }
+  out << fmt::format("\nCELL_DATA {}\n", n_elems);
+  std::vector<double> values(n_elems);
+  for (int j = 0; j < names.size(); ++j) {
+    get_data(j, values);
+    for (size_t i = 0; i < n_elems; ++i) {
+      values[i] /= volumes[i];
+    }
+    out << fmt::format("SCALARS {} double 1\nLOOKUP_TABLE default\n",
+      names[j]);
+    write_big_endian(out, values.data(), n_elems);
+    out << "\n";
+  }
+
+  if (!out) {
+    warning(fmt::format("Failed to write unstructured mesh {}", id_));
+  }
+}
+
 void
 UnstructuredMesh::write(std::string base_filename) const {
   // add extension to the base name
@@ -2054,7 +2712,7 @@ UnstructuredMesh::write(std::string base_filename) const {
   write_message("Writing unstructured mesh " + filename + "...", 5);
   filename = settings::path_output + filename;
 
-  // write the tetrahedral elements of the mesh only
+  // write the volume elements of the mesh only
   // to avoid clutter from zero-value data on other
   // elements during visualization
   moab::ErrorCode rval;
@@ -2086,6 +2744,8 @@ void read_meshes(pugi::xml_node root)
       model::meshes.push_back(std::make_unique<RegularMesh>(node));
     } else if (mesh_type == "rectilinear") {
       model::meshes.push_back(std::make_unique<RectilinearMesh>(node));
+    } else if (mesh_type == "adaptive") {
+      model::meshes.push_back(std::make_unique<AdaptiveMesh>(node));
 #ifdef DAGMC
     } else if (mesh_type == "unstructured") {
       model::meshes.push_back(std::make_unique<UnstructuredMesh>(node));
@@ -2122,6 +2782,94 @@ void meshes_to_hdf5(hid_t group)
   close_group(meshes_group);
 }
 
+void refine_adaptive_meshes()
+{
+  for (int i_mesh = 0; i_mesh < model::meshes.size(); ++i_mesh) {
+    auto* m = dynamic_cast<AdaptiveMesh*>(model::meshes[i_mesh].get());
+    if (!m || m->n_elements() + (1 << m->n_dimension_) > m->max_bins_) {
+      continue;
+    }
+
+    // Find the tallies over the mesh and the stride of its filter in each.
+    // Elements are only divided once every tally has enough realizations.
+    std::vector<std::pair<Tally*, int>> tallies;
+    bool ready = true;
+    for (int i_tally : model::active_tallies) {
+      auto& t {*model::tallies[i_tally]};
+      for (int j = 0; j < t.filters().size(); ++j) {
+        const auto* filt {model::tally_filters[t.filters(j)].get()};
+        if (filt->type() == "mesh" &&
+            static_cast<const MeshFilter*>(filt)->mesh() == i_mesh) {
+          tallies.emplace_back(&t, t.strides(j));
+          if (t.n_realizations_ < m->refine_batches_) ready = false;
+        }
+      }
+    }
+    if (tallies.empty() || !ready) continue;
+
+#ifdef OPENMC_MPI
+    // Results that are still being reduced are needed on the master process
+    finish_tally_reductions();
+#endif
+
+    // An element whose score is high relative to the highest of its tally and
+    // precise enough gets the largest such relative score as its priority
+    std::vector<int> refined;
+    if (mpi::master) {
+      std::vector<double> priority(m->n_elements(), 0.0);
+      for (const auto& tally_stride : tallies) {
+        const auto& t {*tally_stride.first};
+        int stride = tally_stride.second;
+        if (t.decomposed()) continue;
+
+        int n = t.n_realizations_;
+        int n_columns = t.scores_.size() * t.nuclides_.size();
+        for (int s = 0; s < n_columns; ++s) {
+          double max_mean = 0.0;
+          for (int c = 0; c < t.n_filter_bins(); ++c) {
+            int bin = (c / stride) % m->n_bins();
+            if (!m->is_leaf(bin)) continue;
+            max_mean = std::max(max_mean,
+              t.result(c, s, TallyResult::SUM) / n);
+          }
+          if (max_mean <= 0.0) continue;
+
+          for (int c = 0; c < t.n_filter_bins(); ++c) {
+            int bin = (c / stride) % m->n_bins();
+            if (!m->is_leaf(bin)) continue;
+            double mean = t.result(c, s, TallyResult::SUM) / n;
+            if (mean <= 0.0 || mean < m->refine_threshold_ * max_mean) {
+              continue;
+            }
+            double var = t.result(c, s, TallyResult::SUM_SQ) / n - mean*mean;
+            double rel_error = std::sqrt(std::max(var, 0.0) / (n - 1)) / mean;
+            if (rel_error <= m->refine_rel_error_) {
+              priority[bin] = std::max(priority[bin], mean / max_mean);
+            }
+          }
+        }
+      }
+      refined = m->select_refinement(priority);
+    }
+
+#ifdef OPENMC_MPI
+    int n_refined = refined.size();
+    MPI_Bcast(&n_refined, 1, MPI_INT, 0, mpi::intracomm);
+    refined.resize(n_refined);
+    MPI_Bcast(refined.data(), n_refined, MPI_INT, 0, mpi::intracomm);
+#endif
+    if (refined.empty()) continue;
+
+    // Results of the divided elements can't be split among their children, so
+    // the tallies over the mesh start again
+    m->refine(refined);
+    for (auto& tally_stride : tallies) tally_stride.first->reset();
+    write_message(fmt::format("Divided {} elements of adaptive mesh {}, "
+      "which now has {} of {} bins in use. Restarting its tallies.",
+      refined.size(), m->id_, m->n_elements(), m->max_bins_), 6);
+  }
+}
+
 void free_memory_mesh()
 {
   model::meshes.clear();
@@ -0,0 +1,189 @@
+#include "openmc/mesh_field.h"
+
+#include <algorithm> // for binary_search, sort
+#include <cmath>     // for sqrt
+#include <stdexcept> // for invalid_argument
+#include <string>
+
+#include <fmt/core.h>
+
+#include "openmc/capi.h"
+#include "openmc/cell.h"
+#include "openmc/constants.h"
+#include "openmc/error.h"
+#include "openmc/mesh.h"
+#include "openmc/settings.h"
+#include "openmc/xml_interface.h"
+
+namespace openmc {
+
+//==============================================================================
+// Global variables
+//==============================================================================
+
+namespace model {
+
+std::vector<MeshField> mesh_fields;
+
+} // namespace model
+
+//==============================================================================
+// MeshField implementation
+//==============================================================================
+
+MeshField::MeshField(pugi::xml_node node)
+{
+  if (check_for_node(node, "id")) {
+    id_ = std::stoi(get_node_value(node, "id"));
+  } else {
+    fatal_error("Must specify id of mesh field in settings XML file.");
+  }
+
+  if (!check_for_node(node, "mesh")) {
+    fatal_error(fmt::format("No mesh specified for mesh field {}.", id_));
+  }
+  int mesh_id = std::stoi(get_node_value(node, "mesh"));
+  auto it = model::mesh_map.find(mesh_id);
+  if (it == model::mesh_map.end()) {
+    fatal_error(fmt::format("Mesh {} specified for mesh field {} does not "
+      "exist.", mesh_id, id_));
+  }
+  mesh_ = it->second;
+
+  if (check_for_node(node, "cells")) {
+    cells_ = get_node_array<int32_t>(node, "cells");
+    std::sort(cells_.begin(), cells_.end());
+  }
+
+  // Bins keep the temperature and density of their cell by default
+  size_t n = model::meshes[mesh_]->n_bins();
+  sqrtkT_.assign(n, -1.0);
+  density_mult_.assign(n, 1.0);
+
+  std::vector<double> T;
+  std::vector<double> density_mult;
+  if (check_for_node(node, "temperatures")) {
+    T = get_node_array<double>(node, "temperatures");
+  }
+  if (check_for_node(node, "density_multipliers")) {
+    density_mult = get_node_array<double>(node, "density_multipliers");
+  }
+  for (const auto* values : {&T, &density_mult}) {
+    if (!values->empty() && values->size() != n) {
+      fatal_error(fmt::format("Mesh field {} has {} values whereas its mesh "
+        "has {} bins.", id_, values->size(), n));
+    }
+  }
+  try {
+    set_data(T.empty() ? nullptr : T.data(),
+      density_mult.empty() ? nullptr : density_mult.data());
+  } catch (const std::invalid_argument& e) {
+    fatal_error(fmt::format("{} in mesh field {}.", e.what(), id_));
+  }
+}
+
+bool MeshField::apply(Particle& p) const
+{
+  const auto& c {*model::cells[p.coord_[p.n_coord_ - 1].cell]};
+  if (!cells_.empty() &&
+      !std::binary_search(cells_.begin(), cells_.end(), c.id_)) {
+    return false;
+  }
+
+  // The particle may have moved out of the mesh or into a bin without a
+  // temperature within the cell, so start from the temperature of the cell
+  p.sqrtkT_ = (c.sqrtkT_.size() > 1) ? c.sqrtkT_[p.cell_instance_] :
+    c.sqrtkT_[0];
+  int bin = model::meshes[mesh_]->get_bin(p.r());
+  if (bin >= 0) {
+    if (sqrtkT_[bin] >= 0.0) p.sqrtkT_ = sqrtkT_[bin];
+    p.density_mult_ = density_mult_[bin];
+  }
+  return true;
+}
+
+void MeshField::set_data(const double* T, const double* density_mult)
+{
+  // Check all values before changing any
+  if (density_mult) {
+    if (!settings::run_CE) {
+      throw std::invalid_argument{"Density multipliers are only supported in "
+        "continuous-energy mode"};
+    }
+    for (int i = 0; i < n_bins(); ++i) {
+      if (!(density_mult[i] >= 0.0)) {
+        throw std::invalid_argument{"Density multipliers must not be "
+          "negative"};
+      }
+    }
+    density_mult_.assign(density_mult, density_mult + n_bins());
+  }
+  if (T) {
+    for (int i = 0; i < n_bins(); ++i) {
+      sqrtkT_[i] = (T[i] > 0.0) ? std::sqrt(K_BOLTZMANN * T[i]) : -1.0;
+    }
+  }
+}
+
+//==============================================================================
+// Non-member functions
+//==============================================================================
+
+void read_mesh_fields(pugi::xml_node root)
+{
+  auto& fields {model::mesh_fields};
+  for (auto node : root.children("mesh_field")) {
+    fields.emplace_back(node);
+    for (size_t i = 0; i < fields.size() - 1; ++i) {
+      if (fields[i].id_ == fields.back().id_) {
+        fatal_error(fmt::format("Two or more mesh fields use the same unique "
+          "ID: {}", fields.back().id_));
+      }
+    }
+  }
+}
+
+void apply_mesh_fields(Particle& p)
+{
+  p.density_mult_last_ = p.density_mult_;
+  p.density_mult_ = 1.0;
+  for (const auto& field : model::mesh_fields) {
+    if (field.apply(p)) return;
+  }
+}
+
+void free_memory_mesh_fields()
+{
+  model::mesh_fields.clear();
+}
+
+//==============================================================================
+// C-API functions
+//==============================================================================
+
+extern "C" int
+openmc_mesh_field_set_data(int32_t id, size_t n, const double* T,
+  const double* density_mult)
+{
+  for (auto& field : model::mesh_fields) {
+    if (field.id_ != id) continue;
+
+    if (n != field.n_bins()) {
+      set_errmsg(fmt::format("Mesh field {} has {} bins but {} values were "
+        "given.", id, field.n_bins(), n));
+      return OPENMC_E_INVALID_SIZE;
+    }
+    try {
+      field.set_data(T, density_mult);
+    } catch (const std::exception& e) {
+      set_errmsg(e.what());
+      return OPENMC_E_INVALID_ARGUMENT;
+    }
+    return 0;
+  }
+
+  set_errmsg("No mesh field exists with ID=" + std::to_string(id) + ".");
+  return OPENMC_E_INVALID_ID;
+}
+
+} // namespace openmc
@@ -1,5 +1,8 @@
 #include "openmc/message_passing.h"
 
+#include <algorithm> // for min
+#include <climits>   // for INT_MAX
+
 namespace openmc {
 namespace mpi {
 
@@ -9,7 +12,16 @@ bool master {true};
 
 #ifdef OPENMC_MPI
 MPI_Comm intracomm {MPI_COMM_NULL};
+MPI_Comm node_comm {MPI_COMM_NULL};
 MPI_Datatype bank {MPI_DATATYPE_NULL};
+
+void broadcast_bytes(char* data, int64_t size)
+{
+  for (int64_t offset = 0; offset < size; offset += INT_MAX) {
+    int count = std::min<int64_t>(size - offset, INT_MAX);
+    MPI_Bcast(data + offset, count, MPI_CHAR, 0, intracomm);
+  }
+}
 #endif
 
 extern "C" bool openmc_master() { return mpi::master; }
@@ -5,10 +5,6 @@
 #include <algorithm>
 #include <sstream>
 
-#ifdef _OPENMP
-#include <omp.h>
-#endif
-
 #include <fmt/core.h>
 #include "xtensor/xmath.hpp"
 #include "xtensor/xsort.hpp"
@@ -48,15 +44,6 @@ Mgxs::init(const std::string& in_name, double in_awr,
   n_azi = in_azimuthal.size();
   polar = in_polar;
   azimuthal = in_azimuthal;
-
-  // Set the cross section index cache
-#ifdef _OPENMP
-  int n_threads = omp_get_max_threads();
-#else
-  int n_threads = 1;
-#endif
-  cache.resize(n_threads);
-  // std::vector.resize() will value-initialize the members of cache[:]
 }
 
 //==============================================================================
@@ -419,18 +406,12 @@ Mgxs::combine(const std::vector<Mgxs*>& micros, const std::vector<double>& scala
 //==============================================================================
 
 double
-Mgxs::get_xs(MgxsType xstype, int gin, const int* gout, const double* mu,
-  const int* dg)
+Mgxs::get_xs(const MgxsCache& cache, MgxsType xstype, int gin,
+  const int* gout, const double* mu, const int* dg) const
 {
   // This method assumes that the temperature and angle indices are set
-#ifdef _OPENMP
-  int tid = omp_get_thread_num();
-  XsData* xs_t = &xs[cache[tid].t];
-  int a = cache[tid].a;
-#else
-  XsData* xs_t = &xs[cache[0].t];
-  int a = cache[0].a;
-#endif
+  const XsData* xs_t = &xs[cache.t];
+  int a = cache.a;
   double val;
   switch(xstype) {
   case MgxsType::TOTAL:
@@ -532,19 +513,16 @@ Mgxs::get_xs(MgxsType xstype, int gin, const int* gout, const double* mu,
 //==============================================================================
 
 void
-Mgxs::sample_fission_energy(int gin, int& dg, int& gout, uint64_t* seed)
+Mgxs::sample_fission_energy(const MgxsCache& cache, int gin, int& dg,
+  int& gout, uint64_t* seed) const
 {
   // This method assumes that the temperature and angle indices are set
-#ifdef _OPENMP
-  int tid = omp_get_thread_num();
-#else
-  int tid = 0;
-#endif
-  XsData* xs_t = &xs[cache[tid].t];
-  double nu_fission = xs_t->nu_fission(cache[tid].a, gin);
+  const XsData* xs_t = &xs[cache.t];
+  int a = cache.a;
+  double nu_fission = xs_t->nu_fission(a, gin);
 
   // Find the probability of having a prompt neutron
-  double prob_prompt = xs_t->prompt_nu_fission(cache[tid].a, gin);
+  double prob_prompt = xs_t->prompt_nu_fission(a, gin);
 
   // sample random numbers
   double xi_pd = prn(seed) * nu_fission;
@@ -560,7 +538,7 @@ Mgxs::sample_fission_energy(int gin, int& dg, int& gout, uint64_t* seed)
     // sample the outgoing energy group
     double prob_gout = 0.;
     for (gout = 0; gout < num_groups; ++gout) {
-      prob_gout += xs_t->chi_prompt(cache[tid].a, gin, gout);
+      prob_gout += xs_t->chi_prompt(a, gin, gout);
       if (xi_gout < prob_gout) break;
     }
 
@@ -569,7 +547,7 @@ Mgxs::sample_fission_energy(int gin, int& dg, int& gout, uint64_t* seed)
 
     // get the delayed group
     for (dg = 0; dg < num_delayed_groups; ++dg) {
-      prob_prompt += xs_t->delayed_nu_fission(cache[tid].a, dg, gin);
+      prob_prompt += xs_t->delayed_nu_fission(a, dg, gin);
       if (xi_pd < prob_prompt) break;
     }
 
@@ -579,7 +557,7 @@ Mgxs::sample_fission_energy(int gin, int& dg, int& gout, uint64_t* seed)
     // sample the outgoing energy group
     double prob_gout = 0.;
     for (gout = 0; gout < num_groups; ++gout) {
-      prob_gout += xs_t->chi_delayed(cache[tid].a, dg, gin, gout);
+      prob_gout += xs_t->chi_delayed(a, dg, gin, gout);
       if (xi_gout < prob_gout) break;
     }
   }
@@ -588,36 +566,27 @@ Mgxs::sample_fission_energy(int gin, int& dg, int& gout, uint64_t* seed)
 //==============================================================================
 
 void
-Mgxs::sample_scatter(int gin, int& gout, double& mu, double& wgt, uint64_t* seed)
+Mgxs::sample_scatter(const MgxsCache& cache, int gin, int& gout, double& mu,
+  double& wgt, uint64_t* seed) const
 {
   // This method assumes that the temperature and angle indices are set
   // Sample the data
-#ifdef _OPENMP
-  int tid = omp_get_thread_num();
-#else
-  int tid = 0;
-#endif
-  xs[cache[tid].t].scatter[cache[tid].a]->sample(gin, gout, mu, wgt, seed);
+  xs[cache.t].scatter[cache.a]->sample(gin, gout, mu, wgt, seed);
 }
 
 //==============================================================================
 
 void
-Mgxs::calculate_xs(Particle& p)
+Mgxs::calculate_xs(Particle& p) const
 {
   // Set our indices
-#ifdef _OPENMP
-  int tid = omp_get_thread_num();
-#else
-  int tid = 0;
-#endif
-  set_temperature_index(p.sqrtkT_);
-  set_angle_index(p.u_local());
-  XsData* xs_t = &xs[cache[tid].t];
-  p.macro_xs_.total = xs_t->total(cache[tid].a, p.g_);
-  p.macro_xs_.absorption = xs_t->absorption(cache[tid].a, p.g_);
-  p.macro_xs_.nu_fission =
-    fissionable ? xs_t->nu_fission(cache[tid].a, p.g_) : 0.;
+  MgxsCache& cache = p.mg_xs_cache_;
+  set_temperature_index(cache, p.sqrtkT_);
+  set_angle_index(cache, p.u_local());
+  const GroupXS& group_xs = xs[cache.t].tracking_xs(cache.a, p.g_);
+  p.macro_xs_.total = group_xs.total;
+  p.macro_xs_.absorption = group_xs.absorption;
+  p.macro_xs_.nu_fission = fissionable ? group_xs.nu_fission : 0.;
 }
 
 //==============================================================================
@@ -637,34 +606,44 @@ Mgxs::equiv(const Mgxs& that)
 //==============================================================================
 
 void
-Mgxs::set_temperature_index(double sqrtkT)
+Mgxs::share_scatter(ScattDataPool& pool)
+{
+  for (auto& xs_t : xs) xs_t.share_scatter(pool);
+}
+
+//==============================================================================
+
+void
+Mgxs::claim(MgxsCache& cache) const
+{
+  if (cache.xs != this) {
+    cache = MgxsCache {};
+    cache.xs = this;
+  }
+}
+
+//==============================================================================
+
+void
+Mgxs::set_temperature_index(MgxsCache& cache, double sqrtkT) const
 {
   // See if we need to find the new index
-#ifdef _OPENMP
-  int tid = omp_get_thread_num();
-#else
-  int tid = 0;
-#endif
-  if (sqrtkT != cache[tid].sqrtkT) {
-    cache[tid].t = xt::argmin(xt::abs(kTs - sqrtkT * sqrtkT))[0];
-    cache[tid].sqrtkT = sqrtkT;
+  claim(cache);
+  if (sqrtkT != cache.sqrtkT) {
+    cache.t = xt::argmin(xt::abs(kTs - sqrtkT * sqrtkT))[0];
+    cache.sqrtkT = sqrtkT;
   }
 }
 
 //==============================================================================
 
 void
-Mgxs::set_angle_index(Direction u)
+Mgxs::set_angle_index(MgxsCache& cache, Direction u) const
 {
   // See if we need to find the new index
-#ifdef _OPENMP
-  int tid = omp_get_thread_num();
-#else
-  int tid = 0;
-#endif
+  claim(cache);
   if (!is_isotropic &&
-      ((u.x != cache[tid].u) || (u.y != cache[tid].v) ||
-       (u.z != cache[tid].w))) {
+      ((u.x != cache.u.x) || (u.y != cache.u.y) || (u.z != cache.u.z))) {
     // convert direction to polar and azimuthal angles
     double my_pol = std::acos(u.z);
     double my_azi = std::atan2(u.y, u.x);
@@ -675,12 +654,10 @@ Mgxs::set_angle_index(Direction u)
     delta_angle = 2. * PI / n_azi;
     int a = std::floor((my_azi + PI) / delta_angle);
 
-    cache[tid].a = n_azi * p + a;
+    cache.a = n_azi * p + a;
 
     // store this direction as the last one used
-    cache[tid].u = u.x;
-    cache[tid].v = u.y;
-    cache[tid].w = u.z;
+    cache.u = u;
   }
 }
 
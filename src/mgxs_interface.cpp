@@ -2,6 +2,7 @@
 
 #include <string>
 #include <unordered_set>
+#include <utility> // for move
 
 #include "openmc/cell.h"
 #include "openmc/cross_sections.h"
@@ -13,6 +14,7 @@
 #include "openmc/material.h"
 #include "openmc/math_functions.h"
 #include "openmc/nuclide.h"
+#include "openmc/scattdata.h"
 #include "openmc/settings.h"
 
 
@@ -121,11 +123,21 @@ void MgxsInterface::create_macro_xs()
   // Get temperatures to read for each material
   auto kTs = get_mat_kTs();
 
+  // Identical scattering matrices, e.g. of materials that only differ in
+  // density, are stored once and shared
+  ScattDataPool pool;
+  for (auto& nuc : nuclides_) nuc.share_scatter(pool);
+
   // Force all nuclides in a material to be the same representation.
   // Therefore type(nuclides[mat->nuclide_[0]]) dictates type(macroxs).
   // At the same time, we will find the scattering type, as that will dictate
   // how we allocate the scatter object within macroxs.
-  for (int i = 0; i < model::materials.size(); ++i) {
+  // The materials are combined in parallel. Those without temperatures keep
+  // a blank entry to preserve the ordering of materials.
+  int n_materials = model::materials.size();
+  macro_xs_.resize(n_materials);
+#pragma omp parallel for schedule(dynamic)
+  for (int i = 0; i < n_materials; ++i) {
     if (kTs[i].size() > 0) {
       // Convert atom_densities to a vector
       auto& mat {model::materials[i]};
@@ -139,11 +151,11 @@ void MgxsInterface::create_macro_xs()
         mgxs_ptr.push_back(&nuclides_[i_nuclide]);
       }
 
-      macro_xs_.emplace_back(mat->name_, kTs[i], mgxs_ptr, atom_densities,
-          num_energy_groups_, num_delayed_groups_);
-    } else {
-      // Preserve the ordering of materials by including a blank entry
-      macro_xs_.emplace_back();
+      Mgxs macro {mat->name_, kTs[i], mgxs_ptr, atom_densities,
+        num_energy_groups_, num_delayed_groups_};
+#pragma omp critical (ShareScatter)
+      macro.share_scatter(pool);
+      macro_xs_[i] = std::move(macro);
     }
   }
 }
@@ -1,6 +1,7 @@
 #include "openmc/nuclide.h"
 
 #include "openmc/capi.h"
+#include "openmc/cell.h"
 #include "openmc/container_util.h"
 #include "openmc/cross_sections.h"
 #include "openmc/endf.h"
@@ -13,13 +14,24 @@
 #include "openmc/settings.h"
 #include "openmc/simulation.h"
 #include "openmc/string_utils.h"
+#include "openmc/tallies/derivative.h"
 #include "openmc/thermal.h"
 
 #include "xtensor/xbuilder.hpp"
 #include "xtensor/xview.hpp"
 
-#include <algorithm> // for sort, min_element
+#include <fmt/core.h>
+
+#if defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))
+#include <sys/stat.h> // for stat
+#endif
+
+#include <algorithm> // for copy, sort, min_element
+#include <cstdint> // for uintptr_t, uint64_t
+#include <cstdio> // for rename
+#include <fstream>
 #include <string> // for to_string, stoi
+#include <utility> // for swap
 
 namespace openmc {
 
@@ -32,10 +44,67 @@ std::array<double, 2> energy_min {0.0, 0.0};
 std::array<double, 2> energy_max {INFTY, INFTY};
 double temperature_min {0.0};
 double temperature_max {INFTY};
+std::vector<double> log_grid_energy;
 std::vector<std::unique_ptr<Nuclide>> nuclides;
 std::unordered_map<std::string, int> nuclide_map;
 } // namespace data
 
+namespace {
+#ifdef OPENMC_MPI
+// Window holding the nuclide cross sections shared among ranks on a node
+MPI_Win shared_xs_window {MPI_WIN_NULL};
+#endif
+
+// Identifies a derived cross section cache file. The last character is the
+// format version and should be changed whenever the layout changes.
+constexpr char XS_CACHE_MAGIC[] {"OPENMCX1"};
+
+// Ask for the cache line holding an address to be loaded without waiting
+inline void prefetch(const void* addr)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_prefetch(addr, 0, 3);
+#endif
+}
+} // namespace
+
+//==============================================================================
+// Nuclide::PackedXS implementation
+//==============================================================================
+
+constexpr int Nuclide::PackedXS::WIDTH;
+constexpr int Nuclide::PackedXS::ENERGY;
+
+Nuclide::PackedXS::PackedXS(const xt::xtensor<xs_real, 2>& xs,
+  const std::vector<xs_real>& energy)
+{
+  // Allocate one extra record so that the records can start on a cache line
+  // boundary
+  constexpr std::size_t alignment {WIDTH*sizeof(xs_real)};
+  n_ = energy.size();
+  data_.resize(WIDTH*(n_ + 1));
+  auto address = reinterpret_cast<std::uintptr_t>(data_.data());
+  int offset = ((alignment - address % alignment) % alignment) / sizeof(xs_real);
+  xs_real* records = data_.data() + offset;
+  records_ = records;
+
+  int n_channels = xs.shape()[1];
+  for (int i = 0; i < n_; ++i) {
+    xs_real* record = records + WIDTH*i;
+    for (int c = 0; c < n_channels; ++c) {
+      record[c] = xs(i, c);
+    }
+    record[ENERGY] = energy[i];
+  }
+}
+
+void Nuclide::PackedXS::relocate(xs_real* records, bool copy)
+{
+  if (copy) std::copy(records_, records_ + size(), records);
+  records_ = records;
+  data_ = std::vector<xs_real>();
+}
+
 //==============================================================================
 // Nuclide implementation
 //==============================================================================
@@ -68,13 +137,20 @@ Nuclide::Nuclide(hid_t group, const std::vector<double>& temperature, int i_nucl
   }
   std::sort(temps_available.begin(), temps_available.end());
 
-  // If only one temperature is available, revert to nearest temperature
-  if (temps_available.size() == 1 && settings::temperature_method == TemperatureMethod::INTERPOLATION) {
-    if (mpi::master) {
-      warning("Cross sections for " + name_ + " are only available at one "
-        "temperature. Reverting to nearest temperature method.");
+  // If only one temperature is available, revert to nearest temperature.
+  // Nuclides may be read concurrently, so global data is accessed by one
+  // thread at a time.
+  TemperatureMethod method;
+  #pragma omp critical (nuclide_globals)
+  {
+    if (temps_available.size() == 1 && settings::temperature_method == TemperatureMethod::INTERPOLATION) {
+      if (mpi::master) {
+        warning("Cross sections for " + name_ + " are only available at one "
+          "temperature. Reverting to nearest temperature method.");
+      }
+      settings::temperature_method = TemperatureMethod::NEAREST;
     }
-    settings::temperature_method = TemperatureMethod::NEAREST;
+    method = settings::temperature_method;
   }
 
   // Determine actual temperatures to read -- start by checking whether a
@@ -92,7 +168,7 @@ Nuclide::Nuclide(hid_t group, const std::vector<double>& temperature, int i_nucl
     }
   }
 
-  switch (settings::temperature_method) {
+  switch (method) {
   case TemperatureMethod::NEAREST:
     // Find nearest temperatures
     for (double T_desired : temperature) {
@@ -159,8 +235,11 @@ Nuclide::Nuclide(hid_t group, const std::vector<double>& temperature, int i_nucl
   double T_min_read = *std::min_element(temps_to_read.cbegin(), temps_to_read.cend());
   double T_max_read = *std::max_element(temps_to_read.cbegin(), temps_to_read.cend());
 
-  data::temperature_min = std::max(data::temperature_min, T_min_read);
-  data::temperature_max = std::min(data::temperature_max, T_max_read);
+  #pragma omp critical (nuclide_globals)
+  {
+    data::temperature_min = std::max(data::temperature_min, T_min_read);
+    data::temperature_max = std::min(data::temperature_max, T_max_read);
+  }
 
   hid_t energy_group = open_group(group, "energy");
   for (const auto& T : temps_to_read) {
@@ -209,6 +288,12 @@ Nuclide::Nuclide(hid_t group, const std::vector<double>& temperature, int i_nucl
   }
   close_group(rxs_group);
 
+  // Drop energy points that interpolation reproduces before anything is
+  // derived from the grids
+  if (settings::thinning_tolerance > 0.0) {
+    thin_energy_grids(settings::thinning_tolerance);
+  }
+
   // Read unresolved resonance probability tables if present
   if (object_exists(group, "urr")) {
     urr_present_ = true;
@@ -255,6 +340,7 @@ Nuclide::Nuclide(hid_t group, const std::vector<double>& temperature, int i_nucl
     // Read total nu data
     hid_t nu_group = open_group(group, "total_nu");
     total_nu_ = read_function(nu_group, "yield");
+    total_nu_fn_ = InlineFunction1D{total_nu_.get()};
     close_group(nu_group);
   }
 
@@ -265,6 +351,8 @@ Nuclide::Nuclide(hid_t group, const std::vector<double>& temperature, int i_nucl
     hid_t fer_group = open_group(group, "fission_energy_release");
     fission_q_prompt_ = read_function(fer_group, "q_prompt");
     fission_q_recov_ = read_function(fer_group, "q_recoverable");
+    fission_q_prompt_fn_ = InlineFunction1D{fission_q_prompt_.get()};
+    fission_q_recov_fn_ = InlineFunction1D{fission_q_recov_.get()};
 
     // We need prompt/delayed photon energy release for scaling fission photon
     // production
@@ -273,10 +361,97 @@ Nuclide::Nuclide(hid_t group, const std::vector<double>& temperature, int i_nucl
     close_group(fer_group);
   }
 
-  this->create_derived(prompt_photons.get(), delayed_photons.get());
+  std::string cache_file;
+  if (!settings::path_xs_cache.empty()) cache_file = xs_cache_file(group);
+  this->create_derived(prompt_photons.get(), delayed_photons.get(), cache_file);
 }
 
-void Nuclide::create_derived(const Function1D* prompt_photons, const Function1D* delayed_photons)
+void Nuclide::thin_energy_grids(double tolerance)
+{
+  for (int t = 0; t < kTs_.size(); ++t) {
+    const auto& E {grid_[t].energy};
+    int n = E.size();
+    if (n < 3) continue;
+
+    // Cross section of a reaction at a point of the grid, which is zero below
+    // its threshold
+    auto value = [&](int i_rx, int k) -> double {
+      const auto& xs {reactions_[i_rx]->xs_[t]};
+      int j = k - xs.threshold;
+      return (j >= 0 && j < xs.value.size()) ? xs.value[j] : 0.0;
+    };
+
+    // Points where a cross section is discontinuous are always kept: the
+    // ends of the grid, repeated energies, and each threshold along with the
+    // point below it, since cross sections are zero up to the threshold
+    std::vector<bool> keep(n, false);
+    keep[0] = true;
+    keep[n - 1] = true;
+    for (int k = 1; k < n; ++k) {
+      if (E[k] == E[k - 1]) keep[k - 1] = keep[k] = true;
+    }
+    for (const auto& rx : reactions_) {
+      int j = rx->xs_[t].threshold;
+      if (j < n) keep[j] = true;
+      if (j > 0 && j <= n) keep[j - 1] = true;
+    }
+
+    // Whether interpolating between points a and c reproduces every reaction
+    // at the points in between
+    auto reproduces = [&](int a, int c) {
+      for (int k = a + 1; k < c; ++k) {
+        double f = (E[k] - E[a]) / (E[c] - E[a]);
+        for (int i = 0; i < reactions_.size(); ++i) {
+          double xs = value(i, k);
+          double xs_a = value(i, a);
+          double interp = xs_a + f*(value(i, c) - xs_a);
+          if (std::abs(interp - xs) > tolerance*std::abs(xs)) return false;
+        }
+      }
+      return true;
+    };
+
+    // Extend each segment from the last point kept for as long as the points
+    // it skips are reproduced. Checking a segment costs its length, so its
+    // length is bounded to keep thinning linear in the size of the grid.
+    constexpr int MAX_SPAN {64};
+    int a = 0;
+    while (a < n - 1) {
+      int b = a + 1;
+      while (!keep[b] && b - a < MAX_SPAN && reproduces(a, b + 1)) ++b;
+      keep[b] = true;
+      a = b;
+    }
+
+    // Number of points kept below each point, which is the new index of the
+    // points kept
+    std::vector<int> index(n + 1, 0);
+    for (int k = 0; k < n; ++k) index[k + 1] = index[k] + keep[k];
+    if (index[n] == n) continue;
+
+    for (auto& rx : reactions_) {
+      auto& xs {rx->xs_[t]};
+      std::vector<xs_real> thinned;
+      thinned.reserve(xs.value.size());
+      for (int j = 0; j < xs.value.size(); ++j) {
+        int k = xs.threshold + j;
+        if (k < n && keep[k]) thinned.push_back(xs.value[j]);
+      }
+      xs.value = std::move(thinned);
+      xs.threshold = index[xs.threshold];
+    }
+
+    std::vector<double> energy;
+    energy.reserve(index[n]);
+    for (int k = 0; k < n; ++k) {
+      if (keep[k]) energy.push_back(E[k]);
+    }
+    grid_[t].energy = std::move(energy);
+  }
+}
+
+void Nuclide::create_derived(const Function1D* prompt_photons,
+  const Function1D* delayed_photons, const std::string& cache_file)
 {
   for (const auto& grid : grid_) {
     // Allocate and initialize cross section
@@ -284,6 +459,9 @@ void Nuclide::create_derived(const Function1D* prompt_photons, const Function1D*
     xs_.emplace_back(shape, 0.0);
   }
 
+  // When the cross sections are cached, only the bookkeeping below is needed
+  bool cached = !cache_file.empty() && read_xs_cache(cache_file);
+
   reaction_index_.fill(C_NONE);
   for (int i = 0; i < reactions_.size(); ++i) {
     const auto& rx {reactions_[i]};
@@ -297,7 +475,7 @@ void Nuclide::create_derived(const Function1D* prompt_photons, const Function1D*
       auto xs = xt::adapt(rx->xs_[t].value);
 
       for (const auto& p : rx->products_) {
-        if (p.particle_ == Particle::Type::photon) {
+        if (p.particle_ == Particle::Type::photon && !cached) {
           auto pprod = xt::view(xs_[t], xt::range(j, j+n), XS_PHOTON_PROD);
           for (int k = 0; k < n; ++k) {
             double E = grid_[t].energy[k+j];
@@ -315,7 +493,7 @@ void Nuclide::create_derived(const Function1D* prompt_photons, const Function1D*
               }
             }
 
-            pprod[k] += f * xs[k] * (*p.yield_)(E);
+            pprod[k] += f * xs[k] * p.yield_fn_(E);
           }
         }
       }
@@ -323,21 +501,26 @@ void Nuclide::create_derived(const Function1D* prompt_photons, const Function1D*
       // Skip redundant reactions
       if (rx->redundant_) continue;
 
-      // Add contribution to total cross section
-      auto total = xt::view(xs_[t], xt::range(j,j+n), XS_TOTAL);
-      total += xs;
+      if (!cached) {
+        // Add contribution to total cross section
+        auto total = xt::view(xs_[t], xt::range(j,j+n), XS_TOTAL);
+        total += xs;
 
-      // Add contribution to absorption cross section
-      auto absorption = xt::view(xs_[t], xt::range(j,j+n), XS_ABSORPTION);
-      if (is_disappearance(rx->mt_)) {
-        absorption += xs;
+        // Add contribution to absorption cross section
+        auto absorption = xt::view(xs_[t], xt::range(j,j+n), XS_ABSORPTION);
+        if (is_disappearance(rx->mt_)) {
+          absorption += xs;
+        }
+
+        if (is_fission(rx->mt_)) {
+          auto fission = xt::view(xs_[t], xt::range(j,j+n), XS_FISSION);
+          fission += xs;
+          absorption += xs;
+        }
       }
 
       if (is_fission(rx->mt_)) {
         fissionable_ = true;
-        auto fission = xt::view(xs_[t], xt::range(j,j+n), XS_FISSION);
-        fission += xs;
-        absorption += xs;
 
         // Keep track of fission reactions
         if (t == 0) {
@@ -348,18 +531,24 @@ void Nuclide::create_derived(const Function1D* prompt_photons, const Function1D*
     }
   }
 
-  // Determine number of delayed neutron precursors
+  // Determine number of delayed neutron precursors and whether their yields
+  // can be evaluated with a single search
   if (fissionable_) {
+    const InlineFunction1D* first = nullptr;
+    delayed_shared_grid_ = true;
     for (const auto& product : fission_rx_[0]->products_) {
       if (product.emission_mode_ == EmissionMode::delayed) {
         ++n_precursor_;
+        if (product.particle_ != Particle::Type::neutron) continue;
+        if (!first) first = &product.yield_fn_;
+        if (!first->same_grid(product.yield_fn_)) delayed_shared_grid_ = false;
       }
     }
   }
 
   // Calculate nu-fission cross section
   for (int t = 0; t < kTs_.size(); ++t) {
-    if (fissionable_) {
+    if (fissionable_ && !cached) {
       int n = grid_[t].energy.size();
       for (int i = 0; i < n; ++i) {
         double E = grid_[t].energy[i];
@@ -369,6 +558,22 @@ void Nuclide::create_derived(const Function1D* prompt_photons, const Function1D*
     }
   }
 
+  // Save the derived cross sections for later runs. Only one rank writes,
+  // since the cache directory is normally on a shared file system.
+  if (!cache_file.empty() && !cached && mpi::master) {
+    write_xs_cache(cache_file);
+  }
+
+  // If requested, store the cross sections interleaved with the energy grid
+  // instead, releasing the original arrays. Only the interleaved layout can be
+  // shared among ranks.
+  if (settings::interleaved_xs || settings::shared_xs) {
+    for (int t = 0; t < kTs_.size(); ++t) {
+      xs_packed_.emplace_back(xs_[t], grid_[t].energy);
+      xs_[t] = xt::xtensor<xs_real, 2>();
+    }
+  }
+
   if (settings::res_scat_on) {
     // Determine if this nuclide should be treated as a resonant scatterer
     if (!settings::res_scat_nuclides.empty()) {
@@ -409,10 +614,138 @@ void Nuclide::create_derived(const Function1D* prompt_photons, const Function1D*
               / 2.0 * (E[i+1] - E[i]);
         xs_cdf_[i] = xs_cdf_sum;
       }
+
+      // Index the 0K grid at equal-logarithmic energies so that trial
+      // relative energies don't need a search over the whole grid
+      int M = settings::n_log_bins;
+      log_spacing_0K_ = std::log(E.back()/E.front())/M;
+      grid_index_0K_.resize(M + 1);
+      int j = 0;
+      for (int k = 0; k <= M; ++k) {
+        double E_k = E.front()*std::exp(k*log_spacing_0K_);
+        while (j + 2 < E.size() && E[j + 1] <= E_k) ++j;
+        grid_index_0K_[k] = j;
+      }
+
+      // Maximum cross section in each block of the grid for the majorant of
+      // the Doppler broadening rejection correction
+      for (int i = 0; i < xs.size(); i += BLOCK_0K) {
+        int i_end = std::min<int>(i + BLOCK_0K, xs.size());
+        elastic_0K_block_max_.push_back(
+          *std::max_element(&xs[i], &xs[0] + i_end));
+      }
     }
   }
 }
 
+std::string Nuclide::xs_cache_file(hid_t group) const
+{
+  uint64_t hash {FNV_OFFSET};
+
+  // The code that derives the cross sections, identified by the cache format
+  // and the version of OpenMC
+  hash_bytes(hash, XS_CACHE_MAGIC, sizeof(XS_CACHE_MAGIC));
+  hash_value(hash, VERSION);
+  hash_value(hash, VERSION_DEV);
+#ifdef GIT_SHA1
+  hash_bytes(hash, GIT_SHA1, sizeof(GIT_SHA1));
+#endif
+
+  // Identify the data file by its path, size, and modification time rather
+  // than its contents, which may be hundreds of megabytes, and the nuclide
+  // within it by its name
+  std::string path = file_name(group);
+  hash_bytes(hash, path.data(), path.size());
+  hash_bytes(hash, name_.data(), name_.size());
+  int64_t size {0};
+  int64_t mtime {0};
+  int64_t mtime_ns {0};
+#if defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))
+  struct stat info;
+  if (stat(path.c_str(), &info) == 0) {
+    size = info.st_size;
+    mtime = info.st_mtime;
+#if defined(__APPLE__)
+    mtime_ns = info.st_mtimespec.tv_nsec;
+#else
+    mtime_ns = info.st_mtim.tv_nsec;
+#endif
+  }
+#endif
+  hash_value(hash, size);
+  hash_value(hash, mtime);
+  hash_value(hash, mtime_ns);
+
+  // Everything else that the derived cross sections depend on: the
+  // temperatures read, the energy grid thinning, the scaling of fission photon
+  // yields for delayed photons, and the precision they are stored with
+  hash_value(hash, kTs_.size());
+  for (double kT : kTs_) {
+    hash_value(hash, kT);
+  }
+  hash_value(hash, settings::thinning_tolerance);
+  hash_value(hash, settings::delayed_photon_scaling);
+  hash_value(hash, sizeof(xs_real));
+
+  return fmt::format("{}{}_{:016x}.bin", settings::path_xs_cache, name_, hash);
+}
+
+bool Nuclide::read_xs_cache(const std::string& filename)
+{
+  std::ifstream file {filename, std::ios::binary};
+  if (!file) return false;
+
+  // Check that the file has the expected format and shape
+  char magic[sizeof(XS_CACHE_MAGIC)];
+  file.read(magic, sizeof(magic));
+  bool valid = file &&
+    std::equal(magic, magic + sizeof(magic), XS_CACHE_MAGIC);
+  int32_t n_temps;
+  file.read(reinterpret_cast<char*>(&n_temps), sizeof(n_temps));
+  valid = valid && file && n_temps == static_cast<int32_t>(kTs_.size());
+
+  // The cross sections at each temperature are stored contiguously in the
+  // same layout as in memory
+  for (int t = 0; valid && t < n_temps; ++t) {
+    int64_t n;
+    file.read(reinterpret_cast<char*>(&n), sizeof(n));
+    valid = file && n == static_cast<int64_t>(xs_[t].size());
+    if (valid) {
+      file.read(reinterpret_cast<char*>(xs_[t].data()), n*sizeof(xs_real));
+      valid = static_cast<bool>(file);
+    }
+  }
+
+  if (!valid) {
+    for (auto& xs : xs_) xs.fill(0.0);
+    warning("Ignoring invalid cross section cache file " + filename + ".");
+  }
+  return valid;
+}
+
+void Nuclide::write_xs_cache(const std::string& filename) const
+{
+  // Write to a temporary file first so that a partially written cache is
+  // never read by another process
+  std::string temp_file = filename + ".tmp";
+  {
+    std::ofstream file {temp_file, std::ios::binary};
+    if (!file) {
+      warning("Could not write cross section cache file " + filename + ".");
+      return;
+    }
+    file.write(XS_CACHE_MAGIC, sizeof(XS_CACHE_MAGIC));
+    int32_t n_temps = xs_.size();
+    file.write(reinterpret_cast<const char*>(&n_temps), sizeof(n_temps));
+    for (const auto& xs : xs_) {
+      int64_t n = xs.size();
+      file.write(reinterpret_cast<const char*>(&n), sizeof(n));
+      file.write(reinterpret_cast<const char*>(xs.data()), n*sizeof(xs_real));
+    }
+  }
+  std::rename(temp_file.c_str(), filename.c_str());
+}
+
 void Nuclide::init_grid()
 {
   int neutron = static_cast<int>(Particle::Type::neutron);
@@ -443,6 +776,118 @@ void Nuclide::init_grid()
       grid.grid_index[k] = j;
     }
   }
+
+  if (settings::energy_search != EnergySearch::HASHED) return;
+
+  // Energies at the boundaries of the equal-logarithmic bins are needed to
+  // locate sub-bins during a search
+  data::log_grid_energy.resize(M + 1);
+  for (int k = 0; k <= M; ++k) {
+    data::log_grid_energy[k] = E_min*std::exp(k*spacing);
+  }
+
+  for (auto& grid : grid_) {
+    grid.hash_start.resize(M + 1);
+    grid.hash_low.clear();
+    grid.hash_high.clear();
+
+    for (int k = 0; k < M; ++k) {
+      int j_low = grid.grid_index[k];
+      int j_high = grid.grid_index[k + 1];
+
+      // Divide bins that contain many grid points, as happens in resonance
+      // regions, until each sub-bin contains only a few of them
+      int n_sub = 1;
+      while (j_high - j_low > HASH_BIN_POINTS*n_sub && n_sub < HASH_MAX_SUB_BINS) {
+        n_sub *= 2;
+      }
+
+      // Find the grid point at or below each sub-bin boundary. Each sub-bin
+      // extends by one point past the boundaries on either side to guard
+      // against roundoff when locating the sub-bin.
+      grid.hash_start[k] = grid.hash_low.size();
+      double E_low = data::log_grid_energy[k];
+      double width = data::log_grid_energy[k + 1] - E_low;
+      int j_below = j_low;
+      for (int s = 1; s <= n_sub; ++s) {
+        int j = j_high;
+        if (s < n_sub) {
+          double E = E_low + s*width/n_sub;
+          j = j_low + upper_bound_index(&grid.energy[j_low],
+            &grid.energy[j_high + 1], E);
+        }
+        grid.hash_low.push_back(std::max(j_low, j_below - 1));
+        grid.hash_high.push_back(std::min(j_high, j + 1));
+        j_below = j;
+      }
+    }
+    grid.hash_start[M] = grid.hash_low.size();
+  }
+}
+
+void Nuclide::grid_bracket(const EnergyGrid& grid, int i_log_union, double E,
+  int& i_low, int& i_high) const
+{
+  if (grid.hash_start.empty()) {
+    i_low  = grid.grid_index[i_log_union];
+    i_high = grid.grid_index[i_log_union + 1] + 1;
+  } else {
+    // Narrow the range further to the sub-bin containing the energy
+    int start = grid.hash_start[i_log_union];
+    int n_sub = grid.hash_start[i_log_union + 1] - start;
+    if (n_sub > 1) {
+      double E_low = data::log_grid_energy[i_log_union];
+      double E_high = data::log_grid_energy[i_log_union + 1];
+      int s = (E - E_low)/(E_high - E_low)*n_sub;
+      start += std::min(std::max(s, 0), n_sub - 1);
+    }
+    i_low  = grid.hash_low[start];
+    i_high = grid.hash_high[start] + 1;
+  }
+}
+
+int Nuclide::find_grid_index(int i_temp, int i_log_union, double E) const
+{
+  const auto& grid {grid_[i_temp]};
+
+  // Determine bounding indices based on which equal log-spaced interval the
+  // energy is in
+  int i_low, i_high;
+  grid_bracket(grid, i_log_union, E, i_low, i_high);
+
+  // Perform binary search over reduced range
+  return i_low + lower_bound_index(&grid.energy[i_low], &grid.energy[i_high], E);
+}
+
+void Nuclide::prefetch_xs(int i_temp, int i_log_union, double E, bool rows) const
+{
+  const auto& grid {grid_[i_temp]};
+  if (!rows) {
+    if (grid.hash_start.empty()) {
+      prefetch(&grid.grid_index[i_log_union]);
+    } else {
+      prefetch(&grid.hash_start[i_log_union]);
+    }
+    return;
+  }
+
+  // Bracket the energy as find_grid_index does, stopping short of the search
+  int i_low, i_high;
+  grid_bracket(grid, i_log_union, E, i_low, i_high);
+  i_high = std::min<int>(i_high, grid.energy.size() - 1);
+  prefetch(&grid.energy[i_low]);
+  prefetch(&grid.energy[i_high]);
+
+  // The cross sections at the lower end of the bracket, which is where short
+  // brackets end up
+  if (!xs_packed_.empty()) {
+    prefetch(xs_packed_[i_temp][i_low]);
+    prefetch(xs_packed_[i_temp][i_low + 1]);
+  } else {
+    const auto& xs {xs_[i_temp]};
+    prefetch(&xs(i_low, 0));
+    prefetch(&xs(i_low + 1, xs.shape()[1] - 1));
+  }
 }
 
 double Nuclide::nu(double E, EmissionMode mode, int group) const
@@ -451,16 +896,19 @@ double Nuclide::nu(double E, EmissionMode mode, int group) const
 
   switch (mode) {
   case EmissionMode::prompt:
-    return (*fission_rx_[0]->products_[0].yield_)(E);
+    return fission_rx_[0]->products_[0].yield_fn_(E);
   case EmissionMode::delayed:
     if (n_precursor_ > 0) {
       auto rx = fission_rx_[0];
       if (group >= 1 && group < rx->products_.size()) {
         // If delayed group specified, determine yield immediately
-        return (*rx->products_[group].yield_)(E);
+        return rx->products_[group].yield_fn_(E);
       } else {
         double nu {0.0};
 
+        // When the yields share a grid, it is searched only once
+        bool located = false;
+        int interval;
         for (int i = 1; i < rx->products_.size(); ++i) {
           // Skip any non-neutron products
           const auto& product = rx->products_[i];
@@ -468,7 +916,15 @@ double Nuclide::nu(double E, EmissionMode mode, int group) const
 
           // Evaluate yield
           if (product.emission_mode_ == EmissionMode::delayed) {
-            nu += (*product.yield_)(E);
+            if (delayed_shared_grid_) {
+              if (!located) {
+                interval = product.yield_fn_.interval(E);
+                located = true;
+              }
+              nu += product.yield_fn_(E, interval);
+            } else {
+              nu += product.yield_fn_(E);
+            }
           }
         }
         return nu;
@@ -478,9 +934,9 @@ double Nuclide::nu(double E, EmissionMode mode, int group) const
     }
   case EmissionMode::total:
     if (total_nu_) {
-      return (*total_nu_)(E);
+      return total_nu_fn_(E);
     } else {
-      return (*fission_rx_[0]->products_[0].yield_)(E);
+      return fission_rx_[0]->products_[0].yield_fn_(E);
     }
   }
   UNREACHABLE();
@@ -500,17 +956,58 @@ void Nuclide::calculate_elastic_xs(Particle& p) const
   }
 }
 
+int Nuclide::index_0K(double E) const
+{
+  const auto& energy {energy_0K_};
+  if (E < energy.front()) {
+    return 0;
+  } else if (E > energy.back()) {
+    return energy.size() - 2;
+  }
+
+  // Limit the search to the bounds given by the equal-logarithmic index, as
+  // long as round-off did not put the energy outside of them
+  if (!grid_index_0K_.empty()) {
+    int M = grid_index_0K_.size() - 1;
+    int k = std::min<int>(std::log(E/energy.front())/log_spacing_0K_, M - 1);
+    int i_low = grid_index_0K_[k];
+    int i_high = std::min<int>(grid_index_0K_[k + 1] + 2, energy.size());
+    if (energy[i_low] < E && E <= energy[i_high - 1]) {
+      return i_low + lower_bound_index(energy.begin() + i_low,
+        energy.begin() + i_high, E);
+    }
+  }
+  return lower_bound_index(energy.begin(), energy.end(), E);
+}
+
+double Nuclide::elastic_0K_max(int i_first, int i_last) const
+{
+  const auto& xs {elastic_0K_};
+  int b_first = (i_first + BLOCK_0K - 1) / BLOCK_0K;
+  int b_last = i_last / BLOCK_0K;
+  if (elastic_0K_block_max_.empty() || b_first >= b_last) {
+    return *std::max_element(&xs[i_first], &xs[0] + i_last);
+  }
+
+  // Whole blocks within the range are covered by their maximum, leaving the
+  // partial blocks at either end
+  double xs_max = *std::max_element(&elastic_0K_block_max_[b_first],
+    &elastic_0K_block_max_[0] + b_last);
+  if (i_first < b_first*BLOCK_0K) {
+    xs_max = std::max(xs_max, *std::max_element(&xs[i_first],
+      &xs[0] + b_first*BLOCK_0K));
+  }
+  if (b_last*BLOCK_0K < i_last) {
+    xs_max = std::max(xs_max, *std::max_element(&xs[0] + b_last*BLOCK_0K,
+      &xs[0] + i_last));
+  }
+  return xs_max;
+}
+
 double Nuclide::elastic_xs_0K(double E) const
 {
   // Determine index on nuclide energy grid
-  int i_grid;
-  if (E < energy_0K_.front()) {
-    i_grid = 0;
-  } else if (E > energy_0K_.back()) {
-    i_grid = energy_0K_.size() - 2;
-  } else {
-    i_grid = lower_bound_index(energy_0K_.begin(), energy_0K_.end(), E);
-  }
+  int i_grid = index_0K(E);
 
   // check for rare case where two energy points are the same
   if (energy_0K_[i_grid] == energy_0K_[i_grid+1]) ++i_grid;
@@ -523,7 +1020,64 @@ double Nuclide::elastic_xs_0K(double E) const
   return (1.0 - f)*elastic_0K_[i_grid] + f*elastic_0K_[i_grid + 1];
 }
 
-void Nuclide::calculate_xs(int i_sab, int i_log_union, double sab_frac, Particle& p)
+NuclideTemperature Nuclide::temperature_index(double sqrtkT) const
+{
+  double kT = sqrtkT*sqrtkT;
+  NuclideTemperature temp {-1, 0.0};
+  switch (settings::temperature_method) {
+  case TemperatureMethod::NEAREST:
+    {
+      double max_diff = INFTY;
+      for (int t = 0; t < kTs_.size(); ++t) {
+        double diff = std::abs(kTs_[t] - kT);
+        if (diff < max_diff) {
+          temp.index = t;
+          max_diff = diff;
+        }
+      }
+    }
+    break;
+
+  case TemperatureMethod::INTERPOLATION:
+    // Find temperatures that bound the actual temperature
+    int i_temp;
+    for (i_temp = 0; i_temp < kTs_.size() - 1; ++i_temp) {
+      if (kTs_[i_temp] <= kT && kT < kTs_[i_temp + 1]) break;
+    }
+    temp.index = i_temp;
+    temp.interp = (kT - kTs_[i_temp]) / (kTs_[i_temp + 1] - kTs_[i_temp]);
+    break;
+  }
+  return temp;
+}
+
+std::vector<double> Nuclide::group_xs(int MT, double temperature,
+  gsl::span<const double> energy) const
+{
+  int n_groups = energy.size() - 1;
+  int i_rx = (MT > 0 && MT < reaction_index_.size()) ?
+    reaction_index_[MT] : C_NONE;
+  if (i_rx < 0) return std::vector<double>(n_groups, 0.0);
+  const auto& rx {*reactions_[i_rx]};
+
+  // Interpolate between the bounding temperatures if needed
+  auto temp = temperature_index(std::sqrt(K_BOLTZMANN * temperature));
+  auto xs = rx.group_xs(temp.index, energy, grid_[temp.index].energy);
+  if (settings::temperature_method == TemperatureMethod::INTERPOLATION &&
+      temp.interp > 0.0) {
+    auto xs_high = rx.group_xs(temp.index + 1, energy,
+      grid_[temp.index + 1].energy);
+    for (int g = 0; g < n_groups; ++g) {
+      xs[g] += temp.interp*(xs_high[g] - xs[g]);
+    }
+  }
+  return xs;
+}
+
+template<bool MP, bool URR, bool INTERP, bool PACKED>
+void Nuclide::calculate_xs_kernel(int i_sab, int i_log_union, double sab_frac,
+  Particle& p, const int* union_index, const NuclideTemperature* temperature,
+  const NuclideTemperature* sab_temperature)
 {
   auto& micro {p.neutron_xs_[i_nuclide_]};
 
@@ -531,10 +1085,12 @@ void Nuclide::calculate_xs(int i_sab, int i_log_union, double sab_frac, Particle
   micro.elastic = CACHE_INVALID;
   micro.thermal = 0.0;
   micro.thermal_elastic = 0.0;
+  micro.multipole_deriv = false;
+  micro.reaction_valid = false;
 
   // Check to see if there is multipole data present at this energy
   bool use_mp = false;
-  if (multipole_) {
+  if (MP && multipole_) {
     use_mp = (p.E_ >= multipole_->E_min_ && p.E_ <= multipole_->E_max_);
   }
 
@@ -542,7 +1098,20 @@ void Nuclide::calculate_xs(int i_sab, int i_log_union, double sab_frac, Particle
   if (use_mp) {
     // Call multipole kernel
     double sig_s, sig_a, sig_f;
-    std::tie(sig_s, sig_a, sig_f) = multipole_->evaluate(p.E_, p.sqrtkT_);
+    if (model::temperature_derivs && p.sqrtkT_ > 0.0) {
+      // Get the derivatives for differential tallies in the same pass over
+      // the poles
+      auto xs = multipole_->evaluate_with_deriv(p.E_, p.sqrtkT_);
+      sig_s = xs.sig_s;
+      sig_a = xs.sig_a;
+      sig_f = xs.sig_f;
+      micro.multipole_deriv = true;
+      micro.dsig_s = xs.dsig_s;
+      micro.dsig_a = xs.dsig_a;
+      micro.dsig_f = xs.dsig_f;
+    } else {
+      std::tie(sig_s, sig_a, sig_f) = multipole_->evaluate(p.E_, p.sqrtkT_);
+    }
 
     micro.total = sig_s + sig_a;
     micro.elastic = sig_s;
@@ -551,16 +1120,6 @@ void Nuclide::calculate_xs(int i_sab, int i_log_union, double sab_frac, Particle
     micro.nu_fission = fissionable_ ?
       sig_f * this->nu(p.E_, EmissionMode::total) : 0.0;
 
-    if (simulation::need_depletion_rx) {
-      // Only non-zero reaction is (n,gamma)
-      micro.reaction[0] = sig_a - sig_f;
-
-      // Set all other reaction cross sections to zero
-      for (int i = 1; i < DEPLETION_RX.size(); ++i) {
-        micro.reaction[i] = 0.0;
-      }
-    }
-
     // Ensure these values are set
     // Note, the only time either is used is in one of 4 places:
     // 1. physics.cpp - scatter - For inelastic scatter.
@@ -576,131 +1135,86 @@ void Nuclide::calculate_xs(int i_sab, int i_log_union, double sab_frac, Particle
     micro.interp_factor = 0.0;
 
   } else {
-    // Find the appropriate temperature index.
-    double kT = p.sqrtkT_*p.sqrtkT_;
-    double f;
-    int i_temp = -1;
-    switch (settings::temperature_method) {
-    case TemperatureMethod::NEAREST:
-      {
-        double max_diff = INFTY;
-        for (int t = 0; t < kTs_.size(); ++t) {
-          double diff = std::abs(kTs_[t] - kT);
-          if (diff < max_diff) {
-            i_temp = t;
-            max_diff = diff;
-          }
-        }
-      }
-      break;
-
-    case TemperatureMethod::INTERPOLATION:
-      // Find temperatures that bound the actual temperature
-      for (i_temp = 0; i_temp < kTs_.size() - 1; ++i_temp) {
-        if (kTs_[i_temp] <= kT && kT < kTs_[i_temp + 1]) break;
-      }
-
-      // Randomly sample between temperature i and i+1
-      f = (kT - kTs_[i_temp]) / (kTs_[i_temp + 1] - kTs_[i_temp]);
-      if (f > prn(p.current_seed())) ++i_temp;
-      break;
+    // Find the appropriate temperature index, unless it was precomputed for
+    // the particle's cell
+    NuclideTemperature temp = temperature ? *temperature :
+      temperature_index(p.sqrtkT_);
+    int i_temp = temp.index;
+
+    // With interpolation, randomly sample between temperature i and i+1
+    if (INTERP &&
+        settings::temperature_method == TemperatureMethod::INTERPOLATION) {
+      if (temp.interp > prn(p.current_seed())) ++i_temp;
     }
+    double f;
 
     // Determine the energy grid index using a logarithmic mapping to
     // reduce the energy range over which a binary search needs to be
     // performed
 
     const auto& grid {grid_[i_temp]};
-    const auto& xs {xs_[i_temp]};
 
     int i_grid;
     if (p.E_ < grid.energy.front()) {
       i_grid = 0;
     } else if (p.E_ > grid.energy.back()) {
       i_grid = grid.energy.size() - 2;
+    } else if (union_index) {
+      // The material has already searched its unionized energy grid
+      i_grid = union_index[i_temp];
     } else {
-      // Determine bounding indices based on which equal log-spaced
-      // interval the energy is in
-      int i_low  = grid.grid_index[i_log_union];
-      int i_high = grid.grid_index[i_log_union + 1] + 1;
-
-      // Perform binary search over reduced range
-      i_grid = i_low + lower_bound_index(&grid.energy[i_low], &grid.energy[i_high], p.E_);
+      i_grid = find_grid_index(i_temp, i_log_union, p.E_);
     }
 
     // check for rare case where two energy points are the same
     if (grid.energy[i_grid] == grid.energy[i_grid + 1]) ++i_grid;
 
-    // calculate interpolation factor
-    f = (p.E_ - grid.energy[i_grid]) /
-      (grid.energy[i_grid + 1]- grid.energy[i_grid]);
+    // Get the cross sections at the bounding energies. In either layout, all
+    // channels at a grid point are stored contiguously.
+    const xs_real* xs_lo;
+    const xs_real* xs_hi;
+    if (PACKED && !xs_packed_.empty()) {
+      xs_lo = xs_packed_[i_temp][i_grid];
+      xs_hi = xs_lo + PackedXS::WIDTH;
+
+      // calculate interpolation factor
+      f = (p.E_ - xs_lo[PackedXS::ENERGY]) /
+        (xs_hi[PackedXS::ENERGY] - xs_lo[PackedXS::ENERGY]);
+    } else {
+      const auto& xs {xs_[i_temp]};
+      xs_lo = &xs(i_grid, 0);
+      xs_hi = &xs(i_grid + 1, 0);
+
+      // calculate interpolation factor
+      f = (p.E_ - grid.energy[i_grid]) /
+        (grid.energy[i_grid + 1]- grid.energy[i_grid]);
+    }
 
     micro.index_temp = i_temp;
     micro.index_grid = i_grid;
     micro.interp_factor = f;
 
     // Calculate microscopic nuclide total cross section
-    micro.total = (1.0 - f)*xs(i_grid, XS_TOTAL)
-          + f*xs(i_grid + 1, XS_TOTAL);
+    micro.total = (1.0 - f)*xs_lo[XS_TOTAL] + f*xs_hi[XS_TOTAL];
 
     // Calculate microscopic nuclide absorption cross section
-    micro.absorption = (1.0 - f)*xs(i_grid, XS_ABSORPTION)
-      + f*xs(i_grid + 1, XS_ABSORPTION);
+    micro.absorption = (1.0 - f)*xs_lo[XS_ABSORPTION] + f*xs_hi[XS_ABSORPTION];
 
     if (fissionable_) {
       // Calculate microscopic nuclide total cross section
-      micro.fission = (1.0 - f)*xs(i_grid, XS_FISSION)
-            + f*xs(i_grid + 1, XS_FISSION);
+      micro.fission = (1.0 - f)*xs_lo[XS_FISSION] + f*xs_hi[XS_FISSION];
 
       // Calculate microscopic nuclide nu-fission cross section
-      micro.nu_fission = (1.0 - f)*xs(i_grid, XS_NU_FISSION)
-        + f*xs(i_grid + 1, XS_NU_FISSION);
+      micro.nu_fission = (1.0 - f)*xs_lo[XS_NU_FISSION]
+        + f*xs_hi[XS_NU_FISSION];
     } else {
       micro.fission = 0.0;
       micro.nu_fission = 0.0;
     }
 
     // Calculate microscopic nuclide photon production cross section
-    micro.photon_prod = (1.0 - f)*xs(i_grid, XS_PHOTON_PROD)
-      + f*xs(i_grid + 1, XS_PHOTON_PROD);
-
-    // Depletion-related reactions
-    if (simulation::need_depletion_rx) {
-      // Initialize all reaction cross sections to zero
-      for (double& xs_i : micro.reaction) {
-        xs_i = 0.0;
-      }
-
-      for (int j = 0; j < DEPLETION_RX.size(); ++j) {
-        // If reaction is present and energy is greater than threshold, set the
-        // reaction xs appropriately
-        int i_rx = reaction_index_[DEPLETION_RX[j]];
-        if (i_rx >= 0) {
-          const auto& rx = reactions_[i_rx];
-          const auto& rx_xs = rx->xs_[i_temp].value;
-
-          // Physics says that (n,gamma) is not a threshold reaction, so we don't
-          // need to specifically check its threshold index
-          if (j == 0) {
-            micro.reaction[0] = (1.0 - f)*rx_xs[i_grid]
-              + f*rx_xs[i_grid + 1];
-            continue;
-          }
-
-          int threshold = rx->xs_[i_temp].threshold;
-          if (i_grid >= threshold) {
-            micro.reaction[j] = (1.0 - f)*rx_xs[i_grid - threshold] +
-              f*rx_xs[i_grid - threshold + 1];
-          } else if (j >= 3) {
-            // One can show that the the threshold for (n,(x+1)n) is always
-            // higher than the threshold for (n,xn). Thus, if we are below
-            // the threshold for, e.g., (n,2n), there is no reason to check
-            // the threshold for (n,3n) and (n,4n).
-            break;
-          }
-        }
-      }
-    }
+    micro.photon_prod = (1.0 - f)*xs_lo[XS_PHOTON_PROD]
+      + f*xs_hi[XS_PHOTON_PROD];
   }
 
   // Initialize sab treatment to false
@@ -714,11 +1228,11 @@ void Nuclide::calculate_xs(int i_sab, int i_log_union, double sab_frac, Particle
   // and sab_elastic cross sections and correct the total and elastic cross
   // sections.
 
-  if (i_sab >= 0) this->calculate_sab_xs(i_sab, sab_frac, p);
+  if (i_sab >= 0) this->calculate_sab_xs(i_sab, sab_frac, p, sab_temperature);
 
   // If the particle is in the unresolved resonance range and there are
   // probability tables, we need to determine cross sections from the table
-  if (settings::urr_ptables_on && urr_present_ && !use_mp) {
+  if (URR && settings::urr_ptables_on && urr_present_ && !use_mp) {
     int n = urr_data_[micro.index_temp].n_energy_;
     if ((p.E_ > urr_data_[micro.index_temp].energy_(0)) &&
         (p.E_ < urr_data_[micro.index_temp].energy_(n-1))) {
@@ -730,7 +1244,85 @@ void Nuclide::calculate_xs(int i_sab, int i_log_union, double sab_frac, Particle
   micro.last_sqrtkT = p.sqrtkT_;
 }
 
-void Nuclide::calculate_sab_xs(int i_sab, double sab_frac, Particle& p)
+void Nuclide::init_calculate_xs()
+{
+  using Kernel = decltype(calculate_xs_kernel_);
+  static const Kernel kernels[] {
+    &Nuclide::calculate_xs_kernel<false, false, false, false>,
+    &Nuclide::calculate_xs_kernel<false, false, false, true>,
+    &Nuclide::calculate_xs_kernel<false, false, true, false>,
+    &Nuclide::calculate_xs_kernel<false, false, true, true>,
+    &Nuclide::calculate_xs_kernel<false, true, false, false>,
+    &Nuclide::calculate_xs_kernel<false, true, false, true>,
+    &Nuclide::calculate_xs_kernel<false, true, true, false>,
+    &Nuclide::calculate_xs_kernel<false, true, true, true>,
+    &Nuclide::calculate_xs_kernel<true, false, false, false>,
+    &Nuclide::calculate_xs_kernel<true, false, false, true>,
+    &Nuclide::calculate_xs_kernel<true, false, true, false>,
+    &Nuclide::calculate_xs_kernel<true, false, true, true>,
+    &Nuclide::calculate_xs_kernel<true, true, false, false>,
+    &Nuclide::calculate_xs_kernel<true, true, false, true>,
+    &Nuclide::calculate_xs_kernel<true, true, true, false>,
+    &Nuclide::calculate_xs_kernel<true, true, true, true>
+  };
+  bool mp = static_cast<bool>(multipole_);
+  bool urr = settings::urr_ptables_on && urr_present_;
+  bool interp =
+    (settings::temperature_method == TemperatureMethod::INTERPOLATION);
+  bool packed = !xs_packed_.empty();
+  calculate_xs_kernel_ = kernels[8*mp + 4*urr + 2*interp + packed];
+}
+
+void Nuclide::calculate_reaction_xs(NuclideMicroXS& micro) const
+{
+  // Initialize all reaction cross sections to zero
+  for (double& xs_i : micro.reaction) {
+    xs_i = 0.0;
+  }
+  micro.reaction_valid = true;
+
+  // With multipole data, the only non-zero reaction is (n,gamma)
+  int i_temp = micro.index_temp;
+  if (i_temp < 0) {
+    micro.reaction[0] = micro.absorption - micro.fission;
+    return;
+  }
+
+  int i_grid = micro.index_grid;
+  double f = micro.interp_factor;
+  for (int j = 0; j < DEPLETION_RX.size(); ++j) {
+    // If reaction is present and energy is greater than threshold, set the
+    // reaction xs appropriately
+    int i_rx = reaction_index_[DEPLETION_RX[j]];
+    if (i_rx >= 0) {
+      const auto& rx = reactions_[i_rx];
+      const auto& rx_xs = rx->xs_[i_temp].value;
+
+      // Physics says that (n,gamma) is not a threshold reaction, so we don't
+      // need to specifically check its threshold index
+      if (j == 0) {
+        micro.reaction[0] = (1.0 - f)*rx_xs[i_grid]
+          + f*rx_xs[i_grid + 1];
+        continue;
+      }
+
+      int threshold = rx->xs_[i_temp].threshold;
+      if (i_grid >= threshold) {
+        micro.reaction[j] = (1.0 - f)*rx_xs[i_grid - threshold] +
+          f*rx_xs[i_grid - threshold + 1];
+      } else if (j >= 3) {
+        // One can show that the the threshold for (n,(x+1)n) is always
+        // higher than the threshold for (n,xn). Thus, if we are below
+        // the threshold for, e.g., (n,2n), there is no reason to check
+        // the threshold for (n,3n) and (n,4n).
+        break;
+      }
+    }
+  }
+}
+
+void Nuclide::calculate_sab_xs(int i_sab, double sab_frac, Particle& p,
+  const NuclideTemperature* temperature)
 {
   auto& micro {p.neutron_xs_[i_nuclide_]};
 
@@ -741,7 +1333,8 @@ void Nuclide::calculate_sab_xs(int i_sab, double sab_frac, Particle& p)
   int i_temp;
   double elastic;
   double inelastic;
-  data::thermal_scatt[i_sab]->calculate_xs(p.E_, p.sqrtkT_, &i_temp, &elastic, &inelastic, p.current_seed());
+  data::thermal_scatt[i_sab]->calculate_xs(p.E_, p.sqrtkT_, &i_temp, &elastic,
+    &inelastic, p.current_seed(), temperature);
 
   // Store the S(a,b) cross sections.
   micro.thermal = sab_frac * (elastic + inelastic);
@@ -759,14 +1352,15 @@ void Nuclide::calculate_sab_xs(int i_sab, double sab_frac, Particle& p)
   micro.sab_frac = sab_frac;
 }
 
-void Nuclide::calculate_urr_xs(int i_temp, Particle& p) const
+double Nuclide::total_xs(int i_temp, int i_grid) const
 {
-  auto& micro = p.neutron_xs_[i_nuclide_];
-  micro.use_ptable = true;
-
-  // Create a shorthand for the URR data
-  const auto& urr = urr_data_[i_temp];
+  if (!xs_packed_.empty()) return xs_packed_[i_temp][i_grid][XS_TOTAL];
+  return xs_[i_temp](i_grid, XS_TOTAL);
+}
 
+NuclideMicroXS::UrrFactors
+Nuclide::sample_urr_factors(const UrrData& urr, Particle& p) const
+{
   // Determine the energy table
   int i_energy = 0;
   while (p.E_ >= urr.energy_(i_energy + 1)) {++i_energy;};
@@ -784,72 +1378,74 @@ void Nuclide::calculate_urr_xs(int i_temp, Particle& p) const
   p.stream_ = STREAM_TRACKING;
 
   int i_low = 0;
-  while (urr.prob_(i_energy, URRTableParam::CUM_PROB, i_low) <= r) {++i_low;};
+  while (urr.band(i_energy, i_low).cum_prob <= r) {++i_low;};
 
   int i_up = 0;
-  while (urr.prob_(i_energy + 1, URRTableParam::CUM_PROB, i_up) <= r) {++i_up;};
+  while (urr.band(i_energy + 1, i_up).cum_prob <= r) {++i_up;};
 
   // Determine elastic, fission, and capture cross sections from the
   // probability table
-  double elastic = 0.;
-  double fission = 0.;
-  double capture = 0.;
-  double f;
+  const auto& low {urr.band(i_energy, i_low)};
+  const auto& up {urr.band(i_energy + 1, i_up)};
+  NuclideMicroXS::UrrFactors factors {};
   if (urr.interp_ == Interpolation::lin_lin) {
     // Determine the interpolation factor on the table
-    f = (p.E_ - urr.energy_(i_energy)) /
+    double f = (p.E_ - urr.energy_(i_energy)) /
          (urr.energy_(i_energy + 1) - urr.energy_(i_energy));
 
-    elastic = (1. - f) * urr.prob_(i_energy, URRTableParam::ELASTIC, i_low) +
-         f * urr.prob_(i_energy + 1, URRTableParam::ELASTIC, i_up);
-    fission = (1. - f) * urr.prob_(i_energy, URRTableParam::FISSION, i_low) +
-         f * urr.prob_(i_energy + 1, URRTableParam::FISSION, i_up);
-    capture = (1. - f) * urr.prob_(i_energy, URRTableParam::N_GAMMA, i_low) +
-         f * urr.prob_(i_energy + 1, URRTableParam::N_GAMMA, i_up);
+    factors.elastic = (1. - f) * low.elastic + f * up.elastic;
+    factors.fission = (1. - f) * low.fission + f * up.fission;
+    factors.capture = (1. - f) * low.n_gamma + f * up.n_gamma;
   } else if (urr.interp_ == Interpolation::log_log) {
     // Determine interpolation factor on the table
-    f = std::log(p.E_ / urr.energy_(i_energy)) /
+    double f = std::log(p.E_ / urr.energy_(i_energy)) /
          std::log(urr.energy_(i_energy + 1) / urr.energy_(i_energy));
 
-    // Calculate the elastic cross section/factor
-    if ((urr.prob_(i_energy, URRTableParam::ELASTIC, i_low) > 0.) &&
-        (urr.prob_(i_energy + 1, URRTableParam::ELASTIC, i_up) > 0.)) {
-      elastic =
-           std::exp((1. - f) *
-                    std::log(urr.prob_(i_energy, URRTableParam::ELASTIC, i_low)) +
-                    f * std::log(urr.prob_(i_energy + 1, URRTableParam::ELASTIC, i_up)));
-    } else {
-      elastic = 0.;
-    }
+    // Calculate the elastic, fission and capture cross sections/factors
+    auto interpolate = [f](double a, double b) {
+      return (a > 0. && b > 0.) ?
+        std::exp((1. - f) * std::log(a) + f * std::log(b)) : 0.;
+    };
+    factors.elastic = interpolate(low.elastic, up.elastic);
+    factors.fission = interpolate(low.fission, up.fission);
+    factors.capture = interpolate(low.n_gamma, up.n_gamma);
+  }
+  return factors;
+}
 
-    // Calculate the fission cross section/factor
-    if ((urr.prob_(i_energy, URRTableParam::FISSION, i_low) > 0.) &&
-        (urr.prob_(i_energy + 1, URRTableParam::FISSION, i_up) > 0.)) {
-      fission =
-           std::exp((1. - f) *
-                    std::log(urr.prob_(i_energy, URRTableParam::FISSION, i_low)) +
-                    f * std::log(urr.prob_(i_energy + 1, URRTableParam::FISSION, i_up)));
-    } else {
-      fission = 0.;
-    }
+void Nuclide::calculate_urr_xs(int i_temp, Particle& p) const
+{
+  auto& micro = p.neutron_xs_[i_nuclide_];
+  micro.use_ptable = true;
 
-    // Calculate the capture cross section/factor
-    if ((urr.prob_(i_energy, URRTableParam::N_GAMMA, i_low) > 0.) &&
-        (urr.prob_(i_energy + 1, URRTableParam::N_GAMMA, i_up) > 0.)) {
-      capture =
-           std::exp((1. - f) *
-                    std::log(urr.prob_(i_energy, URRTableParam::N_GAMMA, i_low)) +
-                    f * std::log(urr.prob_(i_energy + 1, URRTableParam::N_GAMMA, i_up)));
-    } else {
-      capture = 0.;
+  // Create a shorthand for the URR data
+  const auto& urr = urr_data_[i_temp];
+
+  // Factors sampled since the last collision at this energy can be reused
+  uint64_t seed = p.seeds_[STREAM_URR_PTABLE];
+  if (micro.urr_seed != seed || micro.urr_E != p.E_) {
+    micro.urr_seed = seed;
+    micro.urr_E = p.E_;
+    micro.urr_factors[0].index_temp = -1;
+    micro.urr_factors[1].index_temp = -1;
+  }
+  if (micro.urr_factors[0].index_temp != i_temp) {
+    // Keep the factors of the previous temperature in the second slot
+    std::swap(micro.urr_factors[0], micro.urr_factors[1]);
+    if (micro.urr_factors[0].index_temp != i_temp) {
+      micro.urr_factors[0] = sample_urr_factors(urr, p);
+      micro.urr_factors[0].index_temp = i_temp;
     }
   }
+  double elastic = micro.urr_factors[0].elastic;
+  double fission = micro.urr_factors[0].fission;
+  double capture = micro.urr_factors[0].capture;
 
   // Determine the treatment of inelastic scattering
   double inelastic = 0.;
   if (urr.inelastic_flag_ != C_NONE) {
     // get interpolation factor
-    f = micro.interp_factor;
+    double f = micro.interp_factor;
 
     // Determine inelastic scattering cross section
     Reaction* rx = reactions_[urr_inelastic_].get();
@@ -983,10 +1579,84 @@ openmc_nuclide_name(int index, const char** name)
   }
 }
 
+extern "C" int
+openmc_nuclide_group_xs(int index, int MT, double temperature,
+  const double* energy, size_t n, double* xs)
+{
+  if (index < 0 || index >= data::nuclides.size()) {
+    set_errmsg("Index in nuclides vector is out of bounds.");
+    return OPENMC_E_OUT_OF_BOUNDS;
+  }
+  for (size_t g = 0; g < n; ++g) {
+    if (energy[g + 1] <= energy[g]) {
+      set_errmsg("Group boundaries must be given in increasing order.");
+      return OPENMC_E_INVALID_ARGUMENT;
+    }
+  }
+
+  auto xs_group = data::nuclides[index]->group_xs(MT, temperature,
+    {energy, n + 1});
+  std::copy(xs_group.begin(), xs_group.end(), xs);
+  return 0;
+}
+
+void share_nuclide_xs()
+{
+#ifdef OPENMC_MPI
+  // Determine the space needed for the cross sections of all nuclides
+  MPI_Aint n {0};
+  for (const auto& nuc : data::nuclides) {
+    for (const auto& xs : nuc->xs_packed_) {
+      n += xs.size();
+    }
+  }
+
+  // Only the first rank on each node allocates memory, with one extra record
+  // so that the records can start on a cache line boundary; the others get a
+  // pointer to it
+  constexpr int width {Nuclide::PackedXS::WIDTH};
+  int node_rank;
+  MPI_Comm_rank(mpi::node_comm, &node_rank);
+  bool owner = (node_rank == 0);
+  MPI_Aint bytes = owner ? (n + width)*sizeof(xs_real) : 0;
+  xs_real* base;
+  MPI_Win_allocate_shared(bytes, sizeof(xs_real), MPI_INFO_NULL,
+    mpi::node_comm, &base, &shared_xs_window);
+  if (!owner) {
+    MPI_Aint size;
+    int disp_unit;
+    MPI_Win_shared_query(shared_xs_window, 0, &size, &disp_unit, &base);
+  }
+
+  // The segment may be mapped at a different address in each rank, so all
+  // ranks use the offset determined by the owner
+  constexpr std::size_t alignment {width*sizeof(xs_real)};
+  auto address = reinterpret_cast<std::uintptr_t>(base);
+  int offset = ((alignment - address % alignment) % alignment) / sizeof(xs_real);
+  MPI_Bcast(&offset, 1, MPI_INT, 0, mpi::node_comm);
+
+  // The owner copies its cross sections into the window. Every rank read the
+  // same data, so the others can simply discard their own copies.
+  MPI_Win_fence(0, shared_xs_window);
+  xs_real* records = base + offset;
+  for (auto& nuc : data::nuclides) {
+    for (auto& xs : nuc->xs_packed_) {
+      xs.relocate(records, owner);
+      records += xs.size();
+    }
+  }
+  MPI_Win_fence(0, shared_xs_window);
+#endif
+}
+
 void nuclides_clear()
 {
   data::nuclides.clear();
   data::nuclide_map.clear();
+  data::log_grid_energy.clear();
+#ifdef OPENMC_MPI
+  if (shared_xs_window != MPI_WIN_NULL) MPI_Win_free(&shared_xs_window);
+#endif
 }
 
 bool multipole_in_range(const Nuclide& nuc, double E)
@@ -23,12 +23,15 @@
 #include "openmc/constants.h"
 #include "openmc/eigenvalue.h"
 #include "openmc/error.h"
+#include "openmc/event.h"
 #include "openmc/geometry.h"
 #include "openmc/lattice.h"
 #include "openmc/math_functions.h"
+#include "openmc/memory_usage.h"
 #include "openmc/message_passing.h"
 #include "openmc/mgxs_interface.h"
 #include "openmc/nuclide.h"
+#include "openmc/performance.h"
 #include "openmc/plot.h"
 #include "openmc/reaction.h"
 #include "openmc/settings.h"
@@ -38,6 +41,7 @@
 #include "openmc/tallies/filter.h"
 #include "openmc/tallies/tally.h"
 #include "openmc/tallies/tally_scoring.h"
+#include "openmc/thermal.h"
 #include "openmc/timer.h"
 
 namespace openmc {
@@ -298,6 +302,87 @@ print_overlap_check()
 
 //==============================================================================
 
+void print_tally_profiles()
+{
+  reduce_tally_profiles();
+
+  if (mpi::master) {
+    header("Tally Profiles", 6);
+    if (settings::verbosity < 6) return;
+
+    fmt::print(" Tally ID       Events  Filter time [s]          Bins       "
+      "Updates\n");
+    for (const auto& t : model::tallies) {
+      const auto& profile {t->profile_};
+      fmt::print(" {:8} {:12} {:16.4e} {:13} {:13}\n", t->id_,
+        profile.n_events, profile.filter_time, profile.n_bins,
+        profile.n_updates);
+    }
+    fmt::print("\n");
+  }
+}
+
+//==============================================================================
+
+void show_memory(const std::string& label, double bytes, int indent_level=0)
+{
+  int width = 33 - indent_level*2;
+  fmt::print("{0:{1}} {2:<{3}} = {4:>10.3f} MiB\n",
+    "", 2*indent_level, label, width, bytes / (1024.0*1024.0));
+}
+
+void print_memory_usage()
+{
+  auto max_memory = gather_max_resident_memory();
+  if (!mpi::master) return;
+
+  header("Memory Usage", 6);
+  if (settings::verbosity < 6) return;
+
+  // Breakdown by subsystem, with each nuclide, S(a,b) table and tally shown
+  // at higher verbosity
+  show_memory("Nuclear data", memory_nuclear_data());
+  if (settings::verbosity >= 8) {
+    for (const auto& nuc : data::nuclides) {
+      show_memory(nuc->name_, memory_nuclide(*nuc), 1);
+    }
+    for (const auto& table : data::thermal_scatt) {
+      show_memory(table->name_, memory_thermal(*table), 1);
+    }
+  }
+  show_memory("Tallies", memory_tallies());
+  if (settings::verbosity >= 8) {
+    for (const auto& t : model::tallies) {
+      show_memory(fmt::format("Tally {}", t->id_), memory_tally(*t), 1);
+    }
+  }
+  show_memory("Particle banks", memory_banks());
+  show_memory("Particle buffers", memory_particle_buffers());
+  show_memory("Neighbor lists", memory_neighbor_lists());
+  show_memory("Geometry", memory_geometry());
+
+  // Memory high-water mark of the processes
+  int i_max = std::max_element(max_memory.begin(), max_memory.end()) -
+    max_memory.begin();
+  if (mpi::n_procs > 1) {
+    double mean = 0.0;
+    for (double m : max_memory) mean += m;
+    mean /= mpi::n_procs;
+    show_memory(fmt::format("Peak resident memory (rank {})", i_max),
+      max_memory[i_max]);
+    show_memory("Mean peak resident memory", mean);
+    if (settings::verbosity >= 8) {
+      for (int i = 0; i < mpi::n_procs; ++i) {
+        show_memory(fmt::format("Rank {}", i), max_memory[i], 1);
+      }
+    }
+  } else {
+    show_memory("Peak resident memory", max_memory[0]);
+  }
+}
+
+//==============================================================================
+
 void print_usage()
 {
   if (mpi::master) {
@@ -388,6 +473,37 @@ void show_rate(const char* label, double particles_per_sec)
   fmt::print(" {:<33} = {:.6} particles/second\n", label, particles_per_sec);
 }
 
+void print_event_kernel_stats()
+{
+  using namespace simulation;
+
+  struct KernelInfo {
+    const char* label;
+    const EventKernelStats& stats;
+    double secs;
+  };
+  const KernelInfo kernels[] {
+    {"Particle initialization", stats_event_init, time_event_init.elapsed()},
+    {"XS lookups", stats_event_calculate_xs,
+      time_event_calculate_xs.elapsed()},
+    {"Advancing", stats_event_advance_particle,
+      time_event_advance_particle.elapsed()},
+    {"Surface crossings", stats_event_surface_crossing,
+      time_event_surface_crossing.elapsed()},
+    {"Collisions", stats_event_collision, time_event_collision.elapsed()},
+    {"Particle death", stats_event_death, time_event_death.elapsed()}
+  };
+
+  fmt::print("\n {:<23} {:>9} {:>10} {:>9} {:>9} {:>12}\n", "Event kernel",
+    "Calls", "Mean queue", "Min queue", "Max queue", "Particles/s");
+  for (const auto& k : kernels) {
+    fmt::print(" {:<23} {:>9} {:>10.1f} {:>9} {:>9} {:>12.4e}\n", k.label,
+      k.stats.n_invocations, k.stats.mean_queue_length(),
+      k.stats.min_queue_length, k.stats.max_queue_length,
+      k.stats.particle_rate(k.secs));
+  }
+}
+
 void print_runtime()
 {
   using namespace simulation;
@@ -409,6 +525,9 @@ void print_runtime()
     show_time("Surface crossings", time_event_surface_crossing.elapsed(), 2);
     show_time("Collisions", time_event_collision.elapsed(), 2);
     show_time("Particle death", time_event_death.elapsed(), 2);
+    if (settings::event_history_threshold > 0) {
+      show_time("History-based tail", time_event_history_tail.elapsed(), 2);
+    }
   }
   if (settings::run_mode == RunMode::EIGENVALUE) {
     show_time("Time in inactive batches", time_inactive.elapsed(), 1);
@@ -427,10 +546,18 @@ void print_runtime()
   int n_active = simulation::current_batch - settings::n_inactive;
   double speed_inactive = 0.0;
   double speed_active;
+
+  // Count the particles of the inactive batches that were run, which may have
+  // fewer particles than the active batches
+  int first_batch = settings::restart_run ? simulation::restart_batch + 1 : 1;
+  int64_t n_particles_inactive = 0;
+  for (int i = first_batch; i <= settings::n_inactive; ++i) {
+    n_particles_inactive += particles_in_batch(i);
+  }
+
   if (settings::restart_run) {
     if (simulation::restart_batch < settings::n_inactive) {
-      speed_inactive = (settings::n_particles * (settings::n_inactive
-        - simulation::restart_batch) * settings::gen_per_batch)
+      speed_inactive = (n_particles_inactive * settings::gen_per_batch)
         / time_inactive.elapsed();
       speed_active = (settings::n_particles * n_active
         * settings::gen_per_batch) / time_active.elapsed();
@@ -441,8 +568,8 @@ void print_runtime()
     }
   } else {
     if (settings::n_inactive > 0) {
-      speed_inactive = (settings::n_particles * settings::n_inactive
-        * settings::gen_per_batch) / time_inactive.elapsed();
+      speed_inactive = (n_particles_inactive * settings::gen_per_batch)
+        / time_inactive.elapsed();
     }
     speed_active = (settings::n_particles * n_active * settings::gen_per_batch)
       / time_active.elapsed();
@@ -454,6 +581,19 @@ void print_runtime()
     show_rate("Calculation Rate (inactive)", speed_inactive);
   }
   show_rate("Calculation Rate (active)", speed_active);
+
+  // display how evenly the transport time was spread among processes
+  if (mpi::n_procs > 1 && !simulation::time_batches.empty()) {
+    double worst = 1.0;
+    for (int i = 0; i < simulation::time_batches.size(); ++i) {
+      worst = std::max(worst, load_imbalance(i));
+    }
+    fmt::print(" {:<33} = {:.4f} (worst batch {:.4f})\n",
+      "Load imbalance (max/mean)", load_imbalance(), worst);
+  }
+
+  // display occupancy and throughput of each event kernel
+  if (settings::event_based) print_event_kernel_stats();
 }
 
 //==============================================================================
@@ -575,6 +715,12 @@ write_tallies()
       continue;
     }
 
+    if (tally.decomposed()) {
+      fmt::print(tallies_out, " Decomposed across processes, results are only "
+        "written to statepoint files\n\n");
+      continue;
+    }
+
     // Calculate t-value for confidence intervals
     double t_value = 1;
     if (settings::confidence_intervals) {
@@ -650,9 +796,12 @@ write_tallies()
         for (auto score : tally.scores_) {
           std::string score_name = score > 0 ? reaction_name(score)
             : score_names.at(score);
+          double result[3] {
+            tally.result(filter_index, score_index, TallyResult::VALUE),
+            tally.result(filter_index, score_index, TallyResult::SUM),
+            tally.result(filter_index, score_index, TallyResult::SUM_SQ)};
           double mean, stdev;
-          std::tie(mean, stdev) = mean_stdev(
-            &tally.results_(filter_index, score_index, 0), tally.n_realizations_);
+          std::tie(mean, stdev) = mean_stdev(result, tally.n_realizations_);
           fmt::print(tallies_out, "{0:{1}}{2:<36} {3:.6} +/- {4:.6}\n",
             "", indent + 1, score_name, mean, t_value * stdev);
           score_index += 1;
@@ -1,33 +1,41 @@
 #include "openmc/particle.h"
 
 #include <algorithm> // copy, min
-#include <cmath>     // log, abs
+#include <cmath>     // log, abs, sqrt
+#include <utility>   // move
 
 #include <fmt/core.h>
 
 #include "openmc/bank.h"
 #include "openmc/capi.h"
 #include "openmc/cell.h"
+#include "openmc/condensed_history.h"
 #include "openmc/constants.h"
+#include "openmc/delta_tracking.h"
+#include "openmc/domain_decomposition.h"
 #include "openmc/error.h"
 #include "openmc/geometry.h"
 #include "openmc/hdf5_interface.h"
 #include "openmc/material.h"
+#include "openmc/mesh_field.h"
 #include "openmc/message_passing.h"
 #include "openmc/mgxs_interface.h"
 #include "openmc/nuclide.h"
 #include "openmc/photon.h"
 #include "openmc/physics.h"
+#include "openmc/physics_common.h"
 #include "openmc/physics_mg.h"
 #include "openmc/random_lcg.h"
 #include "openmc/settings.h"
 #include "openmc/source.h"
+#include "openmc/state_point.h"
 #include "openmc/surface.h"
 #include "openmc/simulation.h"
 #include "openmc/tallies/derivative.h"
 #include "openmc/tallies/tally.h"
 #include "openmc/tallies/tally_scoring.h"
 #include "openmc/track_output.h"
+#include "openmc/weight_windows.h"
 
 namespace openmc {
 
@@ -55,6 +63,38 @@ LocalCoord::reset()
   rotated = false;
 }
 
+//==============================================================================
+// NuclideMicroXSCache implementation
+//==============================================================================
+
+void NuclideMicroXSCache::resize(int n, bool compact)
+{
+  // In compact mode, an extra zeroed entry is used for nuclides that are not
+  // in the current material
+  compact_ = compact;
+  index_ = nullptr;
+  xs_.assign(compact ? n + 1 : n, NuclideMicroXS {});
+}
+
+void NuclideMicroXSCache::set_material(const std::vector<int>& mat_nuclide_index)
+{
+  if (!compact_ || index_ == &mat_nuclide_index) return;
+
+  // Entries now belong to different nuclides, so clear them all, which also
+  // resets their last evaluated energy
+  index_ = &mat_nuclide_index;
+  std::fill(xs_.begin(), xs_.end(), NuclideMicroXS {});
+}
+
+namespace {
+
+// Storage of the secondary banks given back by destroyed particles. Each
+// thread keeps its own so that taking and giving back storage needs no
+// synchronization.
+thread_local std::vector<std::vector<Particle::Bank>> secondary_bank_pool;
+
+} // namespace
+
 //==============================================================================
 // Particle implementation
 //==============================================================================
@@ -71,8 +111,29 @@ Particle::Particle()
   }
 
   // Create microscopic cross section caches
-  neutron_xs_.resize(data::nuclides.size());
+  if (settings::compact_xs_cache) {
+    neutron_xs_.resize(model::max_material_nuclides, true);
+  } else {
+    neutron_xs_.resize(data::nuclides.size(), false);
+  }
   photon_xs_.resize(data::elements.size());
+
+  // Reuse the storage of a secondary bank given back by an earlier particle.
+  // Otherwise nothing is reserved, since the event buffers hold many particles
+  // that mostly never bank a secondary.
+  if (!secondary_bank_pool.empty()) {
+    secondary_bank_ = std::move(secondary_bank_pool.back());
+    secondary_bank_pool.pop_back();
+  }
+}
+
+Particle::~Particle()
+{
+  // Moved-from particles have no storage left to give back
+  if (secondary_bank_.capacity() > 0) {
+    secondary_bank_.clear();
+    secondary_bank_pool.push_back(std::move(secondary_bank_));
+  }
 }
 
 void
@@ -94,6 +155,7 @@ Particle::create_secondary(Direction u, double E, Type type)
   bank.r = this->r();
   bank.u = u;
   bank.E = settings::run_CE ? E : g_;
+  bank.time = time_;
 
   n_bank_second_ += 1;
 }
@@ -105,6 +167,7 @@ Particle::from_source(const Bank* src)
   this->clear();
   alive_ = true;
   surface_ = 0;
+  boundary_cached_ = false;
   cell_born_ = C_NONE;
   material_ = C_NONE;
   n_collision_ = 0;
@@ -115,6 +178,7 @@ Particle::from_source(const Bank* src)
   type_ = src->particle;
   wgt_ = src->wgt;
   wgt_last_ = src->wgt;
+  time_ = src->time;
   this->r() = src->r;
   this->u() = src->u;
   r_last_current_ = src->r;
@@ -173,11 +237,13 @@ Particle::event_calculate_xs()
 
   // Calculate microscopic and macroscopic cross sections
   if (material_ != MATERIAL_VOID) {
+    if (!model::mesh_fields.empty()) apply_mesh_fields(*this);
     if (settings::run_CE) {
-      if (material_ != material_last_ || sqrtkT_ != sqrtkT_last_) {
+      if (material_ != material_last_ || sqrtkT_ != sqrtkT_last_ ||
+          density_mult_ != density_mult_last_) {
         // If the material is the same as the last material and the
-        // temperature hasn't changed, we don't need to lookup cross
-        // sections again.
+        // temperature and density haven't changed, we don't need to lookup
+        // cross sections again.
         model::materials[material_]->calculate_xs(*this);
       }
     } else {
@@ -198,15 +264,46 @@ Particle::event_calculate_xs()
 }
 
 void
-Particle::event_advance()
+Particle::event_advance(const std::pair<double, int32_t>* cell_distance)
 {
-  // Find the distance to the nearest boundary
-  boundary_ = distance_to_boundary(*this);
+  // Within a delta-tracking cell, the particle moves straight to its next real
+  // collision or the boundary of the cell. When delta tracking throughout the
+  // geometry, only boundary conditions stop it.
+  if (settings::delta_tracking && type_ == Type::neutron) {
+    delta_tracking_advance(*this, C_NONE);
+    return;
+  } else if (!model::delta_tracking_cells.empty() && type_ == Type::neutron) {
+    int level = delta_tracking_level(*this);
+    if (level != C_NONE) {
+      delta_tracking_advance(*this, level);
+      return;
+    }
+  }
+
+  // Find the distance to the nearest boundary, unless it is still known from
+  // before the last collision
+  if (boundary_cached_) {
+    boundary_cached_ = false;
+  } else {
+    boundary_ = distance_to_boundary(*this, cell_distance);
+  }
 
   // Sample a distance to collision
   if (type_ == Particle::Type::electron ||
       type_ == Particle::Type::positron) {
-    collision_distance_ = 0.0;
+    if (settings::electron_treatment == ElectronTreatment::CH) {
+      // A condensed history step ends at the boundary so that its energy is
+      // deposited in the cell it was taken in. The particle then crosses the
+      // boundary on its next, zero-length advance.
+      collision_distance_ = condensed_history_step(*this);
+      if (boundary_.distance > 0.0 &&
+          boundary_.distance <= collision_distance_) {
+        collision_distance_ = boundary_.distance;
+        step_end_ = StepEnd::boundary;
+      }
+    } else {
+      collision_distance_ = 0.0;
+    }
   } else if (macro_xs_.total == 0.0) {
     collision_distance_ = INFINITY;
   } else {
@@ -216,6 +313,21 @@ Particle::event_advance()
   // Select smaller of the two distances
   double distance = std::min(boundary_.distance, collision_distance_);
 
+  // Advance the time of the particle. A particle reaching the time cutoff or
+  // the census time stops there and is then killed, or banked for the census,
+  // by event_collide().
+  double v = this->speed();
+  double time_cutoff = std::min(settings::time_cutoff[static_cast<int>(type_)],
+    settings::census_time);
+  time_last_ = time_;
+  if (time_cutoff < INFTY && time_ + distance / v > time_cutoff) {
+    distance = std::max(0.0, (time_cutoff - time_) * v);
+    collision_distance_ = distance;
+    time_ = time_cutoff;
+  } else if (distance > 0.0) {
+    time_ += distance / v;
+  }
+
   // Advance particle
   for (int j = 0; j < n_coord_; ++j) {
     coord_[j].r += distance * coord_[j].u;
@@ -266,11 +378,33 @@ Particle::event_cross_surface()
   if (!model::active_surface_tallies.empty()) {
     score_surface_tally(*this, model::active_surface_tallies);
   }
+
+  // Split or roulette the particle entering a new weight window
+  if (alive_ && !variance_reduction::weight_windows.empty()) {
+    apply_weight_windows(*this);
+  }
 }
 
 void
 Particle::event_collide()
 {
+  // Kill the particle if it was stopped by the time cutoff
+  double time_cutoff = settings::time_cutoff[static_cast<int>(type_)];
+  if (time_cutoff < INFTY && time_ >= time_cutoff) {
+    alive_ = false;
+    return;
+  }
+
+  // A particle that reached the census time is banked to continue from there
+  // in the next time step
+  if (settings::census_time < INFTY && time_ >= settings::census_time) {
+    if (simulation::current_batch > settings::n_inactive) {
+      bank_census_site(*this);
+    }
+    alive_ = false;
+    return;
+  }
+
   // Score collision estimate of keff
   if (settings::run_mode == RunMode::EIGENVALUE &&
       type_ == Particle::Type::neutron) {
@@ -315,6 +449,19 @@ Particle::event_collide()
   // Reset fission logical
   fission_ = false;
 
+  // Split or roulette the particle according to its weight after the
+  // collision. This is done once the secondaries of the collision have been
+  // scored so that the split copies are not counted among them.
+  if (alive_ && !variance_reduction::weight_windows.empty()) {
+    apply_weight_windows(*this);
+  }
+
+  // Keep the number of secondaries of the history under its cap
+  if (settings::max_secondaries > 0 &&
+      secondary_bank_.size() > settings::max_secondaries) {
+    comb_secondaries(*this);
+  }
+
   // Save coordinates for tallying purposes
   r_last_current_ = this->r();
 
@@ -336,10 +483,29 @@ Particle::event_collide()
     }
   }
 
+  // If the collision left the direction unchanged, e.g. for implicit capture
+  // with survival biasing, the boundary found before it is still ahead of the
+  // particle
+  if (alive_ && this->u() == u_last_) {
+    boundary_.distance -= collision_distance_;
+    boundary_cached_ = true;
+  }
+
   // Score flux derivative accumulators for differential tallies.
   if (!model::active_tallies.empty()) score_collision_derivative(*this);
 }
 
+double
+Particle::speed() const
+{
+  if (type_ == Type::photon) return C_LIGHT * 100.0;
+
+  // Relativistic speed from the kinetic energy and rest mass energy
+  double mass = (type_ == Type::neutron) ? MASS_NEUTRON_EV : MASS_ELECTRON_EV;
+  double gamma = (E_ + mass) / mass;
+  return C_LIGHT * 100.0 * std::sqrt(1.0 - 1.0 / (gamma * gamma));
+}
+
 void
 Particle::event_revive_from_secondary()
 {
@@ -369,7 +535,10 @@ void
 Particle::event_death()
 {
   #ifdef DAGMC
-  if (settings::dagmc) history_.reset();
+  if (settings::dagmc) {
+    history_.reset();
+    last_triangle_ = -1;
+  }
   #endif
 
   // Finish particle track output.
@@ -394,12 +563,21 @@ Particle::event_death()
   keff_tally_tracklength_ = 0.0;
   keff_tally_leakage_     = 0.0;
 
+  // The history is a realization of tallies with history statistics
+  if (!model::active_history_tallies.empty()) accumulate_history_tallies();
+
   // Record the number of progeny created by this particle.
   // This data will be used to efficiently sort the fission bank.
-  if (settings::run_mode == RunMode::EIGENVALUE) {
+  // With domain decomposition, the particle may have been started by another
+  // process and the fission bank is sorted without these counts.
+  if (settings::run_mode == RunMode::EIGENVALUE && !domain_decomposed()) {
     int64_t offset = id_ - 1 - simulation::work_index[mpi::rank];
     simulation::progeny_per_particle[offset] = n_progeny_;
   }
+
+  // Add the surface crossings recorded during the history to the surface
+  // source bank
+  flush_surface_source();
 }
 
 
@@ -413,6 +591,14 @@ Particle::cross_surface()
     write_message("    Crossing surface " + std::to_string(surf->id_));
   }
 
+  // Record particles crossing or leaking through the surfaces of the surface
+  // source during active batches
+  if (surf->surf_source_ && simulation::current_batch > settings::n_inactive &&
+      (surf->bc_ == Surface::BoundaryType::TRANSMIT ||
+       surf->bc_ == Surface::BoundaryType::VACUUM)) {
+    bank_surface_source(*this);
+  }
+
   if (surf->bc_ == Surface::BoundaryType::VACUUM && (settings::run_mode != RunMode::PLOTTING)) {
     // =======================================================================
     // PARTICLE LEAKS OUT OF PROBLEM
@@ -488,9 +674,15 @@ Particle::cross_surface()
     // boundary, it is necessary to redetermine the particle's coordinates in
     // the lower universes.
     // (unless we're using a dagmc model, which has exactly one universe)
+    // The particle stays in the same cell of the root universe, so nothing
+    // changes if it is filled with a material. Otherwise the cells it was in
+    // before are checked first at each lower level.
     if (!settings::dagmc) {
       n_coord_ = 1;
-      if (!find_cell(*this, true)) {
+      if (model::cells[coord_[0].cell]->type_ == Fill::MATERIAL) {
+        material_last_ = material_;
+        sqrtkT_last_ = sqrtkT_;
+      } else if (!find_cell(*this, false, true)) {
         this->mark_as_lost("Couldn't find particle after reflecting from surface "
                            + std::to_string(surf->id_) + ".");
         return;
@@ -570,7 +762,13 @@ Particle::cross_surface()
     auto cellp = dynamic_cast<DAGCell*>(model::cells[cell_last_[0]].get());
     // TODO: off-by-one
     auto surfp = dynamic_cast<DAGSurface*>(model::surfaces[std::abs(surface_) - 1].get());
-    int32_t i_cell = next_cell(cellp, surfp) - 1;
+    int32_t i_cell = next_cell(cellp, surfp);
+    if (i_cell == C_NONE) {
+      this->mark_as_lost("No DAGMC volume found across surface "
+        + std::to_string(surfp->id_) + " for particle "
+        + std::to_string(id_) + ".");
+      return;
+    }
     // save material and temp
     material_last_ = material_;
     sqrtkT_last_ = sqrtkT_;
@@ -644,12 +842,22 @@ Particle::write_restart() const
   // Dont write another restart file if in particle restart mode
   if (settings::run_mode == RunMode::PARTICLE) return;
 
+  // The source site of a particle that migrated from another domain is only
+  // known by the process that started it
+  if (domain_decomposed()) {
+    int64_t offset = id_ - simulation::work_index[mpi::rank];
+    if (offset < 1 || offset > simulation::work_per_rank) return;
+  }
+
   // Set up file name
   auto filename = fmt::format("{}particle_{}_{}.h5", settings::path_output,
     simulation::current_batch, id_);
 
   #pragma omp critical (WriteParticleRestart)
   {
+    // Don't use HDF5 while a state point is written in the background
+    wait_state_point();
+
     // Create file
     hid_t file_id = file_open(filename, 'w');
 
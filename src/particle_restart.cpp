@@ -124,6 +124,7 @@ void run_particle_restart()
 
   // Write output if particle made it
   print_particle(p);
+  if (settings::track_single_file) close_track_file();
 }
 
 } // namespace openmc
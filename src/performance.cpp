@@ -0,0 +1,160 @@
+#include "openmc/performance.h"
+
+#include <algorithm> // for copy, max
+#include <cstdint>
+#include <numeric>   // for accumulate
+#include <string>
+#include <utility>   // for pair
+
+#include "xtensor/xview.hpp"
+
+#include "openmc/constants.h"
+#include "openmc/hdf5_interface.h"
+#include "openmc/memory_usage.h"
+#include "openmc/message_passing.h"
+#include "openmc/openmp_interface.h"
+#include "openmc/output.h"
+#include "openmc/settings.h"
+#include "openmc/simulation.h"
+#include "openmc/timer.h"
+
+namespace openmc {
+
+//==============================================================================
+// Global variables
+//==============================================================================
+
+namespace simulation {
+
+std::vector<double> time_batches;
+xt::xtensor<double, 2> time_batches_procs;
+
+} // namespace simulation
+
+//==============================================================================
+// Non-member functions
+//==============================================================================
+
+void record_batch_time(double time)
+{
+  simulation::time_batches.push_back(time);
+}
+
+void gather_batch_times()
+{
+  const auto& t {simulation::time_batches};
+  auto& t_procs {simulation::time_batches_procs};
+  t_procs.resize({static_cast<size_t>(mpi::n_procs), t.size()});
+#ifdef OPENMC_MPI
+  int n = t.size();
+  MPI_Gather(t.data(), n, MPI_DOUBLE, t_procs.data(), n, MPI_DOUBLE, 0,
+    mpi::intracomm);
+#else
+  std::copy(t.begin(), t.end(), t_procs.begin());
+#endif
+}
+
+double load_imbalance(int batch)
+{
+  const auto& t_procs {simulation::time_batches_procs};
+  double t_max = 0.0;
+  double t_sum = 0.0;
+  for (int i = 0; i < t_procs.shape()[0]; ++i) {
+    auto row = xt::view(t_procs, i, xt::all());
+    double t = (batch < 0) ? std::accumulate(row.begin(), row.end(), 0.0) :
+      row(batch);
+    t_max = std::max(t_max, t);
+    t_sum += t;
+  }
+  return (t_sum > 0.0) ? t_max*t_procs.shape()[0] / t_sum : 1.0;
+}
+
+void write_performance_report()
+{
+  using namespace simulation;
+
+  // Memory high-water mark of each process
+  auto max_memory = gather_max_resident_memory();
+  if (!mpi::master) return;
+
+  std::string filename = settings::path_output + "performance.h5";
+  write_message("Writing performance report " + filename + "...", 5);
+  hid_t file = file_open(filename, 'w');
+  write_attribute(file, "filetype", "performance");
+  write_attribute(file, "version", VERSION_PERFORMANCE);
+  write_attribute(file, "openmc_version", VERSION);
+  write_attribute(file, "date_and_time", time_stamp());
+  write_attribute(file, "n_procs", mpi::n_procs);
+  write_attribute(file, "n_threads", omp_get_max_threads());
+
+  // Timers, as in the runtime group of statepoints
+  hid_t group = create_group(file, "timers");
+  std::vector<std::pair<const char*, Timer*>> timers {
+    {"total initialization", &time_initialize},
+    {"reading cross sections", &time_read_xs},
+    {"transport", &time_transport},
+    {"inactive batches", &time_inactive},
+    {"active batches", &time_active},
+    {"synchronizing fission bank", &time_bank},
+    {"sampling source sites", &time_bank_sample},
+    {"SEND-RECV source sites", &time_bank_sendrecv},
+    {"sampling external source", &time_sample_source},
+    {"accumulating tallies", &time_tallies},
+    {"total finalization", &time_finalize},
+    {"total", &time_total}};
+  if (settings::event_based) {
+    timers.insert(timers.end(), {
+      {"event initialization", &time_event_init},
+      {"event calculate xs", &time_event_calculate_xs},
+      {"event advance particle", &time_event_advance_particle},
+      {"event surface crossing", &time_event_surface_crossing},
+      {"event collision", &time_event_collision},
+      {"event death", &time_event_death},
+      {"event history tail", &time_event_history_tail}});
+  }
+  for (const auto& timer : timers) {
+    write_dataset(group, timer.first, timer.second->elapsed());
+  }
+  close_group(group);
+
+  // Calculation rate of each batch in particles per second of transport
+  group = create_group(file, "batches");
+  int n_run = time_batches.size();
+  int first_batch = current_batch - n_run + 1;
+  std::vector<double> rates;
+  for (int i = 0; i < n_run; ++i) {
+    double n = particles_in_batch(first_batch + i)*settings::gen_per_batch;
+    rates.push_back(time_batches[i] > 0.0 ? n / time_batches[i] : 0.0);
+  }
+  std::vector<double> imbalance;
+  for (int i = 0; i < n_run; ++i) {
+    imbalance.push_back(load_imbalance(i));
+  }
+  write_attribute(group, "first_batch", first_batch);
+  write_dataset(group, "transport_time", time_batches);
+  write_dataset(group, "calculation_rate", rates);
+  write_dataset(group, "load_imbalance", imbalance);
+  close_group(group);
+
+  // Balance of the work among processes
+  group = create_group(file, "processes");
+  write_dataset(group, "batch_transport_time", time_batches_procs);
+  write_dataset(group, "max_resident_memory", max_memory);
+  write_attribute(group, "load_imbalance", load_imbalance());
+  close_group(group);
+
+  // Memory of the master process in bytes
+  group = create_group(file, "memory");
+  write_dataset(group, "max_resident", max_memory[0]);
+  write_dataset(group, "nuclear_data", memory_nuclear_data());
+  write_dataset(group, "tallies", memory_tallies());
+  write_dataset(group, "banks", memory_banks());
+  write_dataset(group, "particle_buffers", memory_particle_buffers());
+  write_dataset(group, "neighbor_lists", memory_neighbor_lists());
+  write_dataset(group, "geometry", memory_geometry());
+  close_group(group);
+
+  file_close(file);
+}
+
+} // namespace openmc
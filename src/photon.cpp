@@ -19,6 +19,28 @@
 
 namespace openmc {
 
+//==============================================================================
+// Constants
+//==============================================================================
+
+namespace {
+
+// Photon energies, as alpha = E/(m_e c^2), at which the inverse CDF of the
+// Klein-Nishina distribution is tabulated, equally spaced in log10(alpha)
+constexpr double KN_LOG_ALPHA_MIN {-6.0};
+constexpr double KN_LOG_ALPHA_MAX {6.0};
+constexpr int KN_PER_DECADE {16};
+
+// Number of equiprobable quantiles at each photon energy and number of
+// intervals used to integrate the distribution
+constexpr int KN_QUANTILES {129};
+constexpr int KN_INTEGRATION {4096};
+
+// Number of equally spaced CDF values at which Compton profiles are indexed
+constexpr int PROFILE_INDEX_BINS {64};
+
+} // namespace
+
 //==============================================================================
 // Global variables
 //==============================================================================
@@ -26,6 +48,10 @@ namespace openmc {
 namespace data {
 
 xt::xtensor<double, 1> compton_profile_pz;
+xt::xtensor<double, 2> klein_nishina_quantiles;
+
+double photon_log_E_min;
+double photon_log_spacing;
 
 std::vector<PhotonInteraction> elements;
 std::unordered_map<std::string, int> element_map;
@@ -204,10 +230,29 @@ PhotonInteraction::PhotonInteraction(hid_t group, int i_element)
     }
   }
 
+  if (settings::compton_tables) {
+    shell_alias_ = AliasTable{{electron_pdf_.begin(), electron_pdf_.end()}};
+
+    // Index each shell's profile CDF at equally spaced values so that a
+    // value can be located without searching the whole CDF
+    profile_index_ = xt::empty<int>({n_shell,
+      static_cast<size_t>(PROFILE_INDEX_BINS + 1)});
+    for (int i = 0; i < n_shell; ++i) {
+      double c_total = profile_cdf_(i, n_profile - 1);
+      int j = 0;
+      for (int m = 0; m <= PROFILE_INDEX_BINS; ++m) {
+        double c_m = c_total*m/PROFILE_INDEX_BINS;
+        while (j + 2 < n_profile && profile_cdf_(i, j + 1) <= c_m) ++j;
+        profile_index_(i, m) = j;
+      }
+    }
+    init_klein_nishina_table();
+  }
+
   // Calculate total pair production
   pair_production_total_ = pair_production_nuclear_ + pair_production_electron_;
 
-  if (settings::electron_treatment == ElectronTreatment::TTB) {
+  if (settings::electron_treatment != ElectronTreatment::LED) {
     // Read bremsstrahlung scaled DCS
     rgroup = open_group(group, "bremsstrahlung");
     read_dataset(rgroup, "dcs", dcs_);
@@ -337,9 +382,14 @@ void PhotonInteraction::compton_doppler(double alpha, double mu,
     // Sample electron shell
     double rn = prn(seed);
     double c = 0.0;
-    for (shell = 0; shell < electron_pdf_.size(); ++shell) {
-      c += electron_pdf_(shell);
-      if (rn < c) break;
+    if (!shell_alias_.empty()) {
+      double residual;
+      shell = shell_alias_.sample(rn, residual);
+    } else {
+      for (shell = 0; shell < electron_pdf_.size(); ++shell) {
+        c += electron_pdf_(shell);
+        if (rn < c) break;
+      }
     }
 
     // Determine binding energy of shell
@@ -385,8 +435,7 @@ void PhotonInteraction::compton_doppler(double alpha, double mu,
     c = prn(seed)*c_max;
 
     // Determine pz corresponding to sampled cdf value
-    auto cdf_shell = xt::view(profile_cdf_, shell, xt::all());
-    int i = lower_bound_index(cdf_shell.cbegin(), cdf_shell.cend(), c);
+    int i = profile_cdf_index(shell, c);
     double pz_l = data::compton_profile_pz(i);
     double pz_r = data::compton_profile_pz(i + 1);
     double p_l = profile_pdf_(shell, i);
@@ -441,33 +490,140 @@ void PhotonInteraction::compton_doppler(double alpha, double mu,
   *i_shell = shell;
 }
 
-void PhotonInteraction::calculate_xs(Particle& p) const
+void PhotonInteraction::init_grid()
 {
-  // Perform binary search on the element energy grid in order to determine
-  // which points to interpolate between
+  grid_index_ = log_grid_index(energy_.data(), energy_.size());
+  if (settings::photon_xs_tables) init_xs_tables();
+}
+
+void PhotonInteraction::init_xs_tables()
+{
+  // Each interval of the energy grid is divided into intervals no wider than
+  // those of the photon grid. Both energies at an absorption edge are kept so
+  // that the tables are discontinuous there.
   int n_grid = energy_.size();
+  table_energy_.clear();
+  table_parent_.clear();
+  std::vector<std::array<double, 4>> xs;
+  for (int i = 0; i < n_grid - 1; ++i) {
+    double width = energy_(i + 1) - energy_(i);
+    int n_sub = std::max(1,
+      static_cast<int>(std::ceil(width / data::photon_log_spacing)));
+    for (int m = 0; m < n_sub; ++m) {
+      double f = static_cast<double>(m) / n_sub;
+      table_energy_.push_back(energy_(i) + f*width);
+      table_parent_.push_back(i);
+      xs.emplace_back();
+      auto interp = [&](const xt::xtensor<double, 1>& y, int i_start) {
+        return std::exp(y(i - i_start) + f*(y(i + 1 - i_start) -
+          y(i - i_start)));
+      };
+      xs.back()[0] = interp(coherent_, 0);
+      xs.back()[1] = interp(incoherent_, 0);
+      xs.back()[2] = 0.0;
+      for (const auto& shell : shells_) {
+        if (i >= shell.threshold) {
+          xs.back()[2] += interp(shell.cross_section, shell.threshold);
+        }
+      }
+      xs.back()[3] = interp(pair_production_total_, 0);
+    }
+  }
+
+  // The last energy closes the last interval
+  int i = n_grid - 2;
+  table_energy_.push_back(energy_(n_grid - 1));
+  table_parent_.push_back(i);
+  xs.push_back({std::exp(coherent_(i + 1)), std::exp(incoherent_(i + 1)),
+    0.0, std::exp(pair_production_total_(i + 1))});
+  for (const auto& shell : shells_) {
+    if (i >= shell.threshold) {
+      xs.back()[2] += std::exp(shell.cross_section(i + 1 - shell.threshold));
+    }
+  }
+
+  table_xs_ = xt::empty<double>({xs.size(), std::size_t {4}});
+  for (int j = 0; j < xs.size(); ++j) {
+    for (int c = 0; c < 4; ++c) {
+      table_xs_(j, c) = xs[j][c];
+    }
+  }
+  table_grid_index_ = log_grid_index(table_energy_.data(),
+    table_energy_.size());
+}
+
+void PhotonInteraction::calculate_xs(Particle& p) const
+{
+  auto& xs {p.photon_xs_[i_element_]};
   double log_E = std::log(p.E_);
-  int i_grid;
-  if (log_E <= energy_[0]) {
-    i_grid = 0;
-  } else if (log_E > energy_(n_grid - 1)) {
-    i_grid = n_grid - 2;
-  } else {
-    // We use upper_bound_index here because sometimes photons are created with
-    // energies that exactly match a grid point
-    i_grid = upper_bound_index(energy_.cbegin(), energy_.cend(), log_E);
+
+  if (!table_energy_.empty()) {
+    // Find the interval of the tables, which lies within an interval of the
+    // energy grid
+    int n_table = table_energy_.size();
+    int j = log_grid_search(table_energy_.data(), n_table, table_grid_index_,
+      log_E);
+    if (table_energy_[j] == table_energy_[j + 1]) ++j;
+    double f = (log_E - table_energy_[j]) /
+      (table_energy_[j + 1] - table_energy_[j]);
+
+    // The interval on the energy grid is still needed to sample subshells
+    int i_grid = table_parent_[j];
+    xs.index_grid = i_grid;
+    xs.interp_factor = (log_E - energy_(i_grid)) /
+      (energy_(i_grid + 1) - energy_(i_grid));
+
+    const double* lo = &table_xs_(j, 0);
+    const double* hi = &table_xs_(j + 1, 0);
+    xs.coherent = lo[0] + f*(hi[0] - lo[0]);
+    xs.incoherent = lo[1] + f*(hi[1] - lo[1]);
+    xs.photoelectric = lo[2] + f*(hi[2] - lo[2]);
+    xs.pair_production = lo[3] + f*(hi[3] - lo[3]);
+    xs.total = xs.coherent + xs.incoherent + xs.photoelectric +
+      xs.pair_production;
+    xs.last_E = p.E_;
+    return;
   }
 
+  // Search the element energy grid in order to determine which points to
+  // interpolate between
+  int i_grid = log_grid_search(energy_.data(), energy_.size(), grid_index_,
+    log_E);
+
   // check for case where two energy points are the same
   if (energy_(i_grid) == energy_(i_grid+1)) ++i_grid;
 
   // calculate interpolation factor
   double f = (log_E - energy_(i_grid)) / (energy_(i_grid+1) - energy_(i_grid));
 
-  auto& xs {p.photon_xs_[i_element_]};
   xs.index_grid = i_grid;
   xs.interp_factor = f;
+  this->interpolate_xs(i_grid, f, xs);
+  xs.last_E = p.E_;
+}
+
+ElementMicroXS PhotonInteraction::calculate_xs(double log_E, bool below) const
+{
+  // Find the interval whose upper bound is the energy when taking the values
+  // below it and whose lower bound is the energy otherwise
+  const double* first = energy_.data();
+  const double* last = first + energy_.size();
+  int n = energy_.size();
+  int i_grid = (below ? std::lower_bound(first, last, log_E) :
+    std::upper_bound(first, last, log_E)) - first - 1;
+  i_grid = std::max(0, std::min(i_grid, n - 2));
+  double f = (log_E - energy_(i_grid)) / (energy_(i_grid+1) - energy_(i_grid));
 
+  ElementMicroXS xs;
+  xs.index_grid = i_grid;
+  xs.interp_factor = f;
+  this->interpolate_xs(i_grid, f, xs);
+  return xs;
+}
+
+void PhotonInteraction::interpolate_xs(int i_grid, double f,
+  ElementMicroXS& xs) const
+{
   // Calculate microscopic coherent cross section
   xs.coherent = std::exp(coherent_(i_grid) +
     f*(coherent_(i_grid+1) - coherent_(i_grid)));
@@ -498,7 +654,6 @@ void PhotonInteraction::calculate_xs(Particle& p) const
 
   // Calculate microscopic total cross section
   xs.total = xs.coherent + xs.incoherent + xs.photoelectric + xs.pair_production;
-  xs.last_E = p.E_;
 }
 
 double PhotonInteraction::rayleigh_scatter(double alpha, uint64_t* seed) const
@@ -716,9 +871,135 @@ void PhotonInteraction::atomic_relaxation(const ElectronSubshell& shell, Particl
 // Non-member functions
 //==============================================================================
 
+std::vector<int> log_grid_index(const double* energy, int n)
+{
+  int M = settings::n_log_bins;
+  std::vector<int> index(M + 1);
+  int j = 0;
+  for (int k = 0; k <= M; ++k) {
+    double u = data::photon_log_E_min + k*data::photon_log_spacing;
+    while (j + 2 < n && energy[j + 1] <= u) ++j;
+    index[k] = j;
+  }
+  return index;
+}
+
+int log_grid_search(const double* energy, int n, const std::vector<int>& index,
+  double log_E)
+{
+  if (log_E <= energy[0]) return 0;
+  if (log_E > energy[n - 1]) return n - 2;
+
+  // We use upper_bound_index here because sometimes photons are created with
+  // energies that exactly match a grid point
+  double x = (log_E - data::photon_log_E_min) / data::photon_log_spacing;
+  if (index.empty() || !(x >= 0.0 && x < settings::n_log_bins)) {
+    return upper_bound_index(energy, energy + n, log_E);
+  }
+  int k = x;
+  int i_low = index[k];
+  int i_high = index[k + 1] + 1;
+  return i_low + upper_bound_index(energy + i_low, energy + i_high, log_E);
+}
+
+int PhotonInteraction::profile_cdf_index(int shell, double c) const
+{
+  auto cdf_shell = xt::view(profile_cdf_, shell, xt::all());
+
+  // Limit the search to the bounds given by the index, as long as round-off
+  // did not put the value outside of them
+  if (profile_index_.size() > 0) {
+    int n = cdf_shell.size();
+    double c_total = cdf_shell(n - 1);
+    int m = std::min<int>(c/c_total*PROFILE_INDEX_BINS, PROFILE_INDEX_BINS - 1);
+    if (m >= 0) {
+      int i_low = profile_index_(shell, m);
+      int i_high = std::min(profile_index_(shell, m + 1) + 2, n);
+      if (cdf_shell(i_low) < c && c <= cdf_shell(i_high - 1)) {
+        return i_low + lower_bound_index(cdf_shell.cbegin() + i_low,
+          cdf_shell.cbegin() + i_high, c);
+      }
+    }
+  }
+  return lower_bound_index(cdf_shell.cbegin(), cdf_shell.cend(), c);
+}
+
+void init_klein_nishina_table()
+{
+  if (data::klein_nishina_quantiles.size() > 0) return;
+
+  int n_alpha = (KN_LOG_ALPHA_MAX - KN_LOG_ALPHA_MIN)*KN_PER_DECADE + 1;
+  data::klein_nishina_quantiles = xt::empty<double>({
+    static_cast<size_t>(n_alpha), static_cast<size_t>(KN_QUANTILES)});
+
+  // The distribution is tabulated in s = log(x)/log(1 + 2*alpha), where
+  // x = alpha/alpha' ranges from 1 to 1 + 2*alpha. The dominant 1/x behavior
+  // of the distribution is uniform in s, which keeps the quantiles smooth.
+  std::vector<double> cdf(KN_INTEGRATION + 1);
+  for (int l = 0; l < n_alpha; ++l) {
+    double alpha = std::pow(10.0, KN_LOG_ALPHA_MIN +
+      static_cast<double>(l)/KN_PER_DECADE);
+    double log_beta = std::log1p(2.0*alpha);
+
+    // Density in s of the Klein-Nishina distribution, up to a constant
+    auto density = [alpha, log_beta](double s) {
+      double x = std::exp(s*log_beta);
+      double mu = 1.0 - std::expm1(s*log_beta)/alpha;
+      return (1.0/x + x - 1.0 + mu*mu)/x;
+    };
+
+    // Integrate with the trapezoidal rule
+    cdf[0] = 0.0;
+    double ds = 1.0/KN_INTEGRATION;
+    double g_left = density(0.0);
+    for (int k = 1; k <= KN_INTEGRATION; ++k) {
+      double g_right = density(k*ds);
+      cdf[k] = cdf[k - 1] + 0.5*(g_left + g_right)*ds;
+      g_left = g_right;
+    }
+
+    // Invert the CDF at equiprobable values
+    int k = 0;
+    for (int j = 0; j < KN_QUANTILES; ++j) {
+      double c = cdf.back()*j/(KN_QUANTILES - 1);
+      while (k + 2 < cdf.size() && cdf[k + 1] <= c) ++k;
+      double f = (c - cdf[k])/(cdf[k + 1] - cdf[k]);
+      data::klein_nishina_quantiles(l, j) = std::min((k + f)*ds, 1.0);
+    }
+  }
+}
+
 std::pair<double, double> klein_nishina(double alpha, uint64_t* seed)
 {
   double alpha_out, mu;
+
+  // With the tabulated inverse CDF, choose one of the bounding photon
+  // energies by statistical interpolation and interpolate its quantiles
+  const auto& q {data::klein_nishina_quantiles};
+  if (q.size() > 0) {
+    int n_alpha = q.shape()[0];
+    double u = (std::log10(alpha) - KN_LOG_ALPHA_MIN)*KN_PER_DECADE;
+    int l;
+    if (u <= 0.0) {
+      l = 0;
+    } else if (u >= n_alpha - 1) {
+      l = n_alpha - 1;
+    } else {
+      l = static_cast<int>(u);
+      if (prn(seed) < u - l) ++l;
+    }
+
+    double r = prn(seed)*(KN_QUANTILES - 1);
+    int j = std::min(static_cast<int>(r), KN_QUANTILES - 2);
+    double s = q(l, j) + (r - j)*(q(l, j + 1) - q(l, j));
+
+    // Apply the sampled value at the actual energy
+    double log_beta = std::log1p(2.0*alpha);
+    alpha_out = alpha*std::exp(-s*log_beta);
+    mu = 1.0 - std::expm1(s*log_beta)/alpha;
+    return {alpha_out, mu};
+  }
+
   double beta = 1.0 + 2.0*alpha;
   if (alpha < 3.0) {
     // Kahn's rejection method
@@ -775,6 +1056,7 @@ void free_memory_photon()
 {
   data::elements.clear();
   data::compton_profile_pz.resize({0});
+  data::klein_nishina_quantiles.resize({0, 0});
   data::ttb_e_grid.resize({0});
   data::ttb_k_grid.resize({0});
 }
@@ -2,6 +2,7 @@
 
 #include "openmc/bank.h"
 #include "openmc/bremsstrahlung.h"
+#include "openmc/condensed_history.h"
 #include "openmc/constants.h"
 #include "openmc/eigenvalue.h"
 #include "openmc/error.h"
@@ -11,6 +12,7 @@
 #include "openmc/nuclide.h"
 #include "openmc/photon.h"
 #include "openmc/physics_common.h"
+#include "openmc/precursor.h"
 #include "openmc/random_lcg.h"
 #include "openmc/reaction.h"
 #include "openmc/secondary_uncorrelated.h"
@@ -23,7 +25,7 @@
 
 #include <fmt/core.h>
 
-#include <algorithm> // for max, min, max_element
+#include <algorithm> // for max, min, max_element, lower_bound, upper_bound
 #include <cmath> // for sqrt, exp, log, abs, copysign
 
 namespace openmc {
@@ -104,11 +106,14 @@ void sample_neutron_reaction(Particle& p)
       create_fission_sites(p, i_nuclide, rx);
 
       // Make sure particle population doesn't grow out of control for
-      // subcritical multiplication problems.
-      if (p.secondary_bank_.size() >= 10000) {
+      // subcritical multiplication problems, unless the secondaries are
+      // combed to keep them under a cap
+      if (settings::max_secondaries == 0 &&
+          p.secondary_bank_.size() >= 10000) {
         fatal_error("The secondary particle bank appears to be growing without "
         "bound. You are likely running a subcritical multiplication problem "
-        "with k-effective close to or greater than one.");
+        "with k-effective close to or greater than one. Setting "
+        "<max_secondaries> combs the secondaries of a history instead.");
       }
     }
   }
@@ -175,12 +180,15 @@ create_fission_sites(Particle& p, int i_nuclide, const Reaction& rx)
   p.nu_bank_.clear();
 
   p.fission_ = true;
-  int skipped = 0;
 
   // Determine whether to place fission sites into the shared fission bank
   // or the secondary particle bank.
   bool use_fission_bank = (settings::run_mode == RunMode::EIGENVALUE);
 
+  // All neutrons are sampled at the same incident energy, whose location on
+  // the grids of the distributions is kept between them
+  EnergyContext E_in {p.E_};
+
   for (int i = 0; i < nu; ++i) {
     // Initialize fission site object with particle data
     Particle::Bank site;
@@ -191,18 +199,21 @@ create_fission_sites(Particle& p, int i_nuclide, const Reaction& rx)
     site.progeny_id = p.n_progeny_++;
 
     // Sample delayed group and angle/energy for fission reaction
-    sample_fission_neutron(i_nuclide, rx, p.E_, &site, p.current_seed());
+    sample_fission_neutron(i_nuclide, rx, E_in, &site, p.current_seed());
+
+    // Tally the precursor that emits a delayed neutron, undoing the
+    // normalization of the number of sites by k-effective
+    if (site.delayed_group > 0 && simulation::precursor_mesh >= 0) {
+      score_precursor(p, site.wgt*simulation::keff, site.delayed_group,
+        rx.products_[site.delayed_group].decay_rate_);
+    }
 
-    // Store fission site in bank
+    // Store fission site in bank, which happens for all sites of the
+    // collision at once
     if (use_fission_bank) {
-      int64_t idx = simulation::fission_bank.thread_safe_append(site);
-      if (idx == -1) {
-        warning("The shared fission bank is full. Additional fission sites created "
-            "in this generation will not be banked.");
-        skipped++;
-        break;
-      }
+      bank_fission_site(site);
     } else {
+      site.time = p.time_;
       p.secondary_bank_.push_back(site);
     }
 
@@ -224,17 +235,16 @@ create_fission_sites(Particle& p, int i_nuclide, const Reaction& rx)
     }
   }
 
-  // If shared fission bank was full, and no fissions could be added,
-  // set the particle fission flag to false.
-  if (nu == skipped) {
+  // If shared fission bank was full, the fissions could not be added, so set
+  // the particle fission flag to false.
+  if (use_fission_bank && !flush_fission_sites()) {
+    warning("The shared fission bank is full. Additional fission sites created "
+        "in this generation will not be banked.");
+    p.nu_bank_.clear();
     p.fission_ = false;
     return;
   }
 
-  // If shared fission bank was full, but some fissions could be added,
-  // reduce nu accordingly
-  nu -= skipped;
-
   // Store the total weight banked for analog fission tallies
   p.n_bank_ = nu;
   p.wgt_bank_ = nu / weight;
@@ -260,6 +270,10 @@ void sample_photon_reaction(Particle& p)
   const auto& micro {p.photon_xs_[i_element]};
   const auto& element {data::elements[i_element]};
 
+  // The microscopic cross sections are not calculated by lookups in tabulated
+  // material cross sections
+  if (micro.last_E != p.E_) element.calculate_xs(p);
+
   // Calculate photon energy over electron rest mass equivalent
   double alpha = p.E_/MASS_ELECTRON_EV;
 
@@ -405,7 +419,10 @@ void sample_electron_reaction(Particle& p)
 {
   // TODO: create reaction types
 
-  if (settings::electron_treatment == ElectronTreatment::TTB) {
+  if (settings::electron_treatment == ElectronTreatment::CH) {
+    condensed_history_collision(p);
+    return;
+  } else if (settings::electron_treatment == ElectronTreatment::TTB) {
     double E_lost;
     thick_target_bremsstrahlung(p, &E_lost);
   }
@@ -419,18 +436,23 @@ void sample_positron_reaction(Particle& p)
 {
   // TODO: create reaction types
 
-  if (settings::electron_treatment == ElectronTreatment::TTB) {
+  if (settings::electron_treatment == ElectronTreatment::CH) {
+    // The positron only annihilates once it has slowed down
+    condensed_history_collision(p);
+    if (p.alive_) return;
+  } else if (settings::electron_treatment == ElectronTreatment::TTB) {
     double E_lost;
     thick_target_bremsstrahlung(p, &E_lost);
   }
 
   // Sample angle isotropically
   double mu = 2.0*prn(p.current_seed()) - 1.0;
-  double phi = 2.0*PI*prn(p.current_seed());
+  double cosphi, sinphi;
+  sample_azimuth(p.current_seed(), cosphi, sinphi);
   Direction u;
   u.x = mu;
-  u.y = std::sqrt(1.0 - mu*mu)*std::cos(phi);
-  u.z = std::sqrt(1.0 - mu*mu)*std::sin(phi);
+  u.y = std::sqrt(1.0 - mu*mu)*cosphi;
+  u.z = std::sqrt(1.0 - mu*mu)*sinphi;
 
   // Create annihilation photon pair traveling in opposite directions
   p.create_secondary(u, MASS_ELECTRON_EV, Particle::Type::photon);
@@ -443,18 +465,30 @@ void sample_positron_reaction(Particle& p)
 
 int sample_nuclide(Particle& p)
 {
-  // Sample cumulative distribution function
-  double cutoff = prn(p.current_seed()) * p.macro_xs_.total;
-
   // Get pointers to nuclide/density arrays
   const auto& mat {model::materials[p.material_]};
   int n = mat->nuclide_.size();
 
+  // A lookup in a cross section table does not calculate the cross sections
+  // of the nuclides, which are needed at collisions
+  if (mat->xs_tabulated(p)) mat->calculate_xs(p, false);
+
+  // Search the cumulative cross sections stored during the lookup
+  const auto& cdf {p.xs_cdf_};
+  if (cdf.size() == n && n > 0) {
+    double cutoff = prn(p.current_seed()) * cdf.back();
+    int i = std::lower_bound(cdf.begin(), cdf.end(), cutoff) - cdf.begin();
+    return mat->nuclide_[std::min(i, n - 1)];
+  }
+
+  // Sample cumulative distribution function
+  double cutoff = prn(p.current_seed()) * p.macro_xs_.total;
+
   double prob = 0.0;
   for (int i = 0; i < n; ++i) {
     // Get atom density
     int i_nuclide = mat->nuclide_[i];
-    double atom_density = mat->atom_density_[i];
+    double atom_density = mat->atom_density_[i] * p.density_mult_;
 
     // Increment probability to compare to cutoff
     prob += atom_density * p.neutron_xs_[i_nuclide].total;
@@ -468,17 +502,30 @@ int sample_nuclide(Particle& p)
 
 int sample_element(Particle& p)
 {
-  // Sample cumulative distribution function
-  double cutoff = prn(p.current_seed()) * p.macro_xs_.total;
-
   // Get pointers to elements, densities
   const auto& mat {model::materials[p.material_]};
 
+  // Search the cumulative cross sections stored during the lookup
+  const auto& cdf {p.xs_cdf_};
+  int n = mat->element_.size();
+  if (cdf.size() == n && n > 0) {
+    double cutoff = prn(p.current_seed()) * cdf.back();
+    int i = std::upper_bound(cdf.begin(), cdf.end(), cutoff) - cdf.begin();
+    i = std::min(i, n - 1);
+
+    // Save which nuclide particle had collision with for tally purpose
+    p.event_nuclide_ = mat->nuclide_[i];
+    return mat->element_[i];
+  }
+
+  // Sample cumulative distribution function
+  double cutoff = prn(p.current_seed()) * p.macro_xs_.total;
+
   double prob = 0.0;
   for (int i = 0; i < mat->element_.size(); ++i) {
     // Find atom density
     int i_element = mat->element_[i];
-    double atom_density = mat->atom_density_[i];
+    double atom_density = mat->atom_density_[i] * p.density_mult_;
 
     // Determine microscopic cross section
     double sigma = atom_density * p.photon_xs_[i_element].total;
@@ -568,7 +615,7 @@ void sample_photon_product(int i_nuclide, Particle& p, int* i_rx, int* i_product
     for (int j = 0; j < rx->products_.size(); ++j) {
       if (rx->products_[j].particle_ == Particle::Type::photon) {
         // add to cumulative probability
-        prob += (*rx->products_[j].yield_)(p.E_) * xs;
+        prob += rx->products_[j].yield_fn_(p.E_) * xs;
 
         *i_rx = i;
         *i_product = j;
@@ -834,27 +881,8 @@ Direction sample_target_velocity(const Nuclide& nuc, double E, Direction u,
     double E_up = (E_red + 4.0)*(E_red + 4.0) * kT / nuc.awr_;
 
     // find lower and upper energy bound indices
-    // lower index
-    int i_E_low;
-    if (E_low < nuc.energy_0K_.front()) {
-      i_E_low = 0;
-    } else if (E_low > nuc.energy_0K_.back()) {
-      i_E_low = nuc.energy_0K_.size() - 2;
-    } else {
-      i_E_low = lower_bound_index(nuc.energy_0K_.begin(),
-        nuc.energy_0K_.end(), E_low);
-    }
-
-    // upper index
-    int i_E_up;
-    if (E_up < nuc.energy_0K_.front()) {
-      i_E_up = 0;
-    } else if (E_up > nuc.energy_0K_.back()) {
-      i_E_up = nuc.energy_0K_.size() - 2;
-    } else {
-      i_E_up = lower_bound_index(nuc.energy_0K_.begin(),
-        nuc.energy_0K_.end(), E_up);
-    }
+    int i_E_low = nuc.index_0K(E_low);
+    int i_E_up = nuc.index_0K(E_up);
 
     if (i_E_up == i_E_low) {
       // Handle degenerate case -- if the upper/lower bounds occur for the same
@@ -874,8 +902,7 @@ Direction sample_target_velocity(const Nuclide& nuc, double E, Direction u,
       xs_up += m * (E_up - nuc.energy_0K_[i_E_up]);
 
       // get max 0K xs value over range of practical relative energies
-      double xs_max = *std::max_element(&nuc.elastic_0K_[i_E_low + 1],
-        &nuc.elastic_0K_[i_E_up + 1]);
+      double xs_max = nuc.elastic_0K_max(i_E_low + 1, i_E_up + 1);
       xs_max = std::max({xs_low, xs_max, xs_up});
 
       while (true) {
@@ -994,7 +1021,8 @@ sample_cxs_target_velocity(double awr, double E, Direction u, double kT, uint64_
   return vt * rotate_angle(u, mu, nullptr, seed);
 }
 
-void sample_fission_neutron(int i_nuclide, const Reaction& rx, double E_in, Particle::Bank* site, uint64_t* seed)
+void sample_fission_neutron(int i_nuclide, const Reaction& rx,
+  EnergyContext& E_in, Particle::Bank* site, uint64_t* seed)
 {
   // Sample cosine of angle -- fission neutrons are always emitted
   // isotropically. Sometimes in ACE data, fission reactions actually have
@@ -1010,8 +1038,8 @@ void sample_fission_neutron(int i_nuclide, const Reaction& rx, double E_in, Part
 
   // Determine total nu, delayed nu, and delayed neutron fraction
   const auto& nuc {data::nuclides[i_nuclide]};
-  double nu_t = nuc->nu(E_in, Nuclide::EmissionMode::total);
-  double nu_d = nuc->nu(E_in, Nuclide::EmissionMode::delayed);
+  double nu_t = nuc->nu(E_in.E(), Nuclide::EmissionMode::total);
+  double nu_d = nuc->nu(E_in.E(), Nuclide::EmissionMode::delayed);
   double beta = nu_d / nu_t;
 
   if (prn(seed) < beta) {
@@ -1024,7 +1052,7 @@ void sample_fission_neutron(int i_nuclide, const Reaction& rx, double E_in, Part
     int group;
     for (group = 1; group < nuc->n_precursor_; ++group) {
       // determine delayed neutron precursor yield for group j
-      double yield = (*rx.products_[group].yield_)(E_in);
+      double yield = rx.products_[group].yield_fn_(E_in.E());
 
       // Check if this group is sampled
       prob += yield;
@@ -1122,7 +1150,7 @@ void inelastic_scatter(const Nuclide& nuc, const Reaction& rx, Particle& p)
   p.u() = rotate_angle(p.u(), mu, nullptr, p.current_seed());
 
   // evaluate yield
-  double yield = (*rx.products_[0].yield_)(E_in);
+  double yield = rx.products_[0].yield_fn_(E_in);
   if (std::floor(yield) == yield) {
     // If yield is integral, create exactly that many secondary particles
     for (int i = 0; i < static_cast<int>(std::round(yield)) - 1; ++i) {
@@ -1,5 +1,10 @@
 #include "openmc/physics_common.h"
 
+#include <algorithm> // for max
+#include <array>
+#include <cmath>     // for llround
+#include <vector>
+
 #include "openmc/settings.h"
 #include "openmc/random_lcg.h"
 
@@ -23,4 +28,55 @@ void russian_roulette(Particle& p)
   }
 }
 
+//==============================================================================
+// COMB_SECONDARIES
+//==============================================================================
+
+void comb_secondaries(Particle& p)
+{
+  auto& bank {p.secondary_bank_};
+  int64_t n = bank.size();
+  int64_t n_target = settings::max_secondaries / 2;
+
+  // Count the sites and weight of each particle type
+  std::array<int64_t, 4> count {};
+  std::array<double, 4> weight {};
+  for (const auto& site : bank) {
+    int t = static_cast<int>(site.particle);
+    ++count[t];
+    weight[t] += site.wgt;
+  }
+
+  // Give each type a share of the teeth of the comb according to its number
+  // of sites, and place its first tooth at random
+  std::array<int64_t, 4> n_teeth {};
+  std::array<double, 4> spacing {};
+  std::array<double, 4> tooth {};
+  for (int t = 0; t < 4; ++t) {
+    if (count[t] == 0) continue;
+    n_teeth[t] = std::max<int64_t>(1, std::llround(
+      static_cast<double>(count[t]) * n_target / n));
+    spacing[t] = weight[t] / n_teeth[t];
+    tooth[t] = prn(p.current_seed()) * spacing[t];
+  }
+
+  // Each tooth falling within the cumulative weight of a site keeps a copy of
+  // the site with the weight of one tooth
+  thread_local std::vector<Particle::Bank> combed;
+  combed.clear();
+  std::array<double, 4> cumulative {};
+  std::array<int64_t, 4> n_kept {};
+  for (const auto& site : bank) {
+    int t = static_cast<int>(site.particle);
+    cumulative[t] += site.wgt;
+    while (n_kept[t] < n_teeth[t] && tooth[t] < cumulative[t]) {
+      combed.push_back(site);
+      combed.back().wgt = spacing[t];
+      tooth[t] += spacing[t];
+      ++n_kept[t];
+    }
+  }
+  bank.swap(combed);
+}
+
 } //namespace openmc
@@ -74,8 +74,8 @@ sample_reaction(Particle& p)
 void
 scatter(Particle& p)
 {
-  data::mg.macro_xs_[p.material_].sample_scatter(p.g_last_, p.g_, p.mu_,
-                                                  p.wgt_, p.current_seed());
+  data::mg.macro_xs_[p.material_].sample_scatter(p.mg_xs_cache_, p.g_last_,
+    p.g_, p.mu_, p.wgt_, p.current_seed());
 
   // Rotate the angle
   p.u() = rotate_angle(p.u(), p.mu_, nullptr, p.current_seed());
@@ -116,7 +116,6 @@ create_fission_sites(Particle& p)
   p.nu_bank_.clear();
 
   p.fission_ = true;
-  int skipped = 0;
 
   // Determine whether to place fission sites into the shared fission bank
   // or the secondary particle bank.
@@ -144,8 +143,8 @@ create_fission_sites(Particle& p)
     // Sample secondary energy distribution for the fission reaction
     int dg;
     int gout;
-    data::mg.macro_xs_[p.material_].sample_fission_energy(p.g_, dg, gout,
-      p.current_seed());
+    data::mg.macro_xs_[p.material_].sample_fission_energy(p.mg_xs_cache_,
+      p.g_, dg, gout, p.current_seed());
 
     // Store the energy and delayed groups on the fission bank
     site.E = gout;
@@ -154,16 +153,12 @@ create_fission_sites(Particle& p)
     // of the code, 0 is prompt.
     site.delayed_group = dg + 1;
 
-    // Store fission site in bank
+    // Store fission site in bank, which happens for all sites of the
+    // collision at once
     if (use_fission_bank) {
-      int64_t idx = simulation::fission_bank.thread_safe_append(site);
-      if (idx == -1) {
-        warning("The shared fission bank is full. Additional fission sites created "
-            "in this generation will not be banked.");
-        skipped++;
-        break;
-      }
+      bank_fission_site(site);
     } else {
+      site.time = p.time_;
       p.secondary_bank_.push_back(site);
     }
 
@@ -185,17 +180,16 @@ create_fission_sites(Particle& p)
     }
   }
 
-  // If shared fission bank was full, and no fissions could be added,
-  // set the particle fission flag to false.
-  if (nu == skipped) {
+  // If shared fission bank was full, the fissions could not be added, so set
+  // the particle fission flag to false.
+  if (use_fission_bank && !flush_fission_sites()) {
+    warning("The shared fission bank is full. Additional fission sites created "
+        "in this generation will not be banked.");
+    p.nu_bank_.clear();
     p.fission_ = false;
     return;
   }
 
-  // If shared fission bank was full, but some fissions could be added,
-  // reduce nu accordingly
-  nu -= skipped;
-
   // Store the total weight banked for analog fission tallies
   p.n_bank_ = nu;
   p.wgt_bank_ = nu / weight;
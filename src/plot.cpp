@@ -1,8 +1,14 @@
 #include "openmc/plot.h"
 
 #include <algorithm>
+#include <cmath> // for llround
 #include <fstream>
+#include <future> // for async, future
+#include <iterator> // for next
+#include <map>
 #include <sstream>
+#include <tuple>
+#include <utility> // for move, pair, swap
 
 #include <fmt/core.h>
 #include <fmt/ostream.h>
@@ -23,6 +29,7 @@
 #include "openmc/settings.h"
 #include "openmc/simulation.h"
 #include "openmc/string_utils.h"
+#include "openmc/xml_interface.h"
 
 namespace openmc {
 
@@ -121,7 +128,7 @@ void read_plots_xml()
 
   // Parse plots.xml file
   pugi::xml_document doc;
-  doc.load_file(filename.c_str());
+  load_xml_file(doc, filename);
 
   pugi::xml_node root = doc.document_element();
   for (auto node : root.children("plot")) {
@@ -148,8 +155,9 @@ void create_ppm(Plot pl)
   auto ids = pl.get_map<IdData>();
 
   // assign colors
-  for (size_t y = 0; y < height; y++) {
-    for (size_t x = 0; x < width; x++) {
+  #pragma omp parallel for
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
       auto id = ids.data_(y, x, pl.color_by_);
       // no setting needed if not found
       if (id == NOT_FOUND) { continue; }
@@ -158,13 +166,13 @@ void create_ppm(Plot pl)
         continue;
       }
       if (PlotColorBy::cells == pl.color_by_) {
-        data(x,y) = pl.colors_[model::cell_map[id]];
+        data(x,y) = pl.colors_[model::cell_map.at(id)];
       } else if (PlotColorBy::mats == pl.color_by_) {
         if (id == MATERIAL_VOID) {
           data(x,y) = WHITE;
           continue;
         }
-        data(x,y) = pl.colors_[model::material_map[id]];
+        data(x,y) = pl.colors_[model::material_map.at(id)];
       } // color_by if-else
     } // x for loop
   } // y for loop
@@ -611,6 +619,16 @@ void Plot::set_overlap_color(pugi::xml_node plot_node) {
   }
 }
 
+void Plot::set_ray_trace(pugi::xml_node plot_node) {
+  if (check_for_node(plot_node, "ray_trace")) {
+    ray_trace_ = get_node_value_bool(plot_node, "ray_trace");
+    if (ray_trace_ && color_overlaps_) {
+      warning(fmt::format("Overlaps are shown in plot {}, so its pixels will "
+        "be located one by one instead of by tracing rays.", id_));
+    }
+  }
+}
+
 Plot::Plot(pugi::xml_node plot_node)
   : index_meshlines_mesh_{-1}, overlap_color_{RED}
 {
@@ -627,6 +645,7 @@ Plot::Plot(pugi::xml_node plot_node)
   set_meshlines(plot_node);
   set_mask(plot_node);
   set_overlap_color(plot_node);
+  set_ray_trace(plot_node);
 } // End Plot constructor
 
 //==============================================================================
@@ -714,11 +733,13 @@ void draw_mesh_lines(Plot pl, ImageData& data)
     ax2_max = pl.pixels_[1];
   }
 
-  // Iterate across the first axis and draw lines.
-  for (auto ax1_val : axis_lines.first) {
-    double frac = (ax1_val - ll_plot[ax1]) / width[ax1];
-    int ax1_ind = frac * pl.pixels_[0];
-    for (int ax2_ind = ax2_min; ax2_ind < ax2_max; ++ax2_ind) {
+  // Iterate across the first axis and draw lines. Each thread draws all the
+  // lines over its own pixels along the second axis.
+  #pragma omp parallel for
+  for (int ax2_ind = ax2_min; ax2_ind < ax2_max; ++ax2_ind) {
+    for (auto ax1_val : axis_lines.first) {
+      double frac = (ax1_val - ll_plot[ax1]) / width[ax1];
+      int ax1_ind = frac * pl.pixels_[0];
       for (int plus = 0; plus <= pl.meshlines_width_; plus++) {
         if (ax1_ind+plus >= 0 && ax1_ind+plus < pl.pixels_[0])
           data(ax1_ind+plus, ax2_ind) = rgb;
@@ -742,11 +763,13 @@ void draw_mesh_lines(Plot pl, ImageData& data)
     ax1_max = pl.pixels_[0];
   }
 
-  // Iterate across the second axis and draw lines.
-  for (auto ax2_val : axis_lines.second) {
-    double frac = (ax2_val - ll_plot[ax2]) / width[ax2];
-    int ax2_ind = (1.0 - frac) * pl.pixels_[1];
-    for (int ax1_ind = ax1_min; ax1_ind < ax1_max; ++ax1_ind) {
+  // Iterate across the second axis and draw lines. Each thread draws all the
+  // lines over its own pixels along the first axis.
+  #pragma omp parallel for
+  for (int ax1_ind = ax1_min; ax1_ind < ax1_max; ++ax1_ind) {
+    for (auto ax2_val : axis_lines.second) {
+      double frac = (ax2_val - ll_plot[ax2]) / width[ax2];
+      int ax2_ind = (1.0 - frac) * pl.pixels_[1];
       for (int plus = 0; plus <= pl.meshlines_width_; plus++) {
         if (ax2_ind+plus >= 0 && ax2_ind+plus < pl.pixels_[1])
           data(ax1_ind, ax2_ind+plus) = rgb;
@@ -781,37 +804,39 @@ void create_voxel(Plot pl)
   // initial particle position
   Position ll = pl.origin_ - pl.width_ / 2.;
 
-  // Open binary plot file for writing
-  std::ofstream of;
-  std::string fname = std::string(pl.path_plot_);
-  fname = strtrim(fname);
-  hid_t file_id = file_open(fname, 'w');
-
-  // write header info
-  write_attribute(file_id, "filetype", "voxel");
-  write_attribute(file_id, "version", VERSION_VOXEL);
-  write_attribute(file_id, "openmc_version", VERSION);
-
-#ifdef GIT_SHA1
-  write_attribute(file_id, "git_sha1", GIT_SHA1);
-#endif
-
-  // Write current date and time
-  write_attribute(file_id, "date_and_time", time_stamp().c_str());
-  std::array<int, 3> pixels;
-  std::copy(pl.pixels_.begin(), pl.pixels_.end(), pixels.begin());
-  write_attribute(file_id, "num_voxels", pixels);
-  write_attribute(file_id, "voxel_width", vox);
-  write_attribute(file_id, "lower_left", ll);
-
   // Create dataset for voxel data -- note that the dimensions are reversed
   // since we want the order in the file to be z, y, x
   hsize_t dims[3];
   dims[0] = pl.pixels_[2];
   dims[1] = pl.pixels_[1];
   dims[2] = pl.pixels_[0];
-  hid_t dspace, dset, memspace;
-  voxel_init(file_id, &(dims[0]), &dspace, &dset, &memspace);
+
+  // Only the master process writes the voxel file
+  hid_t file_id, dspace, dset, memspace;
+  if (mpi::master) {
+    std::string fname = std::string(pl.path_plot_);
+    fname = strtrim(fname);
+    file_id = file_open(fname, 'w');
+
+    // write header info
+    write_attribute(file_id, "filetype", "voxel");
+    write_attribute(file_id, "version", VERSION_VOXEL);
+    write_attribute(file_id, "openmc_version", VERSION);
+
+#ifdef GIT_SHA1
+    write_attribute(file_id, "git_sha1", GIT_SHA1);
+#endif
+
+    // Write current date and time
+    write_attribute(file_id, "date_and_time", time_stamp().c_str());
+    std::array<int, 3> pixels;
+    std::copy(pl.pixels_.begin(), pl.pixels_.end(), pixels.begin());
+    write_attribute(file_id, "num_voxels", pixels);
+    write_attribute(file_id, "voxel_width", vox);
+    write_attribute(file_id, "lower_left", ll);
+
+    voxel_init(file_id, &(dims[0]), &dspace, &dset, &memspace);
+  }
 
   PlotBase pltbase;
   pltbase.width_ = pl.width_;
@@ -820,29 +845,61 @@ void create_voxel(Plot pl)
   pltbase.pixels_ = pl.pixels_;
   pltbase.level_ = -1; // all universes for voxel files
   pltbase.color_overlaps_ = pl.color_overlaps_;
+  pltbase.ray_trace_ = pl.ray_trace_;
+
+  // Slices are computed round-robin by the MPI processes and sent to the
+  // master process. Each slice is written in the background while the next one
+  // is computed.
+  int idx = pl.color_by_ == PlotColorBy::cells ? 0 : 1;
+  xt::xtensor<int32_t, 2> data_flipped;
+  xt::xtensor<int32_t, 2> data_written;
+  std::future<void> slice_write;
 
   ProgressBar pb;
   for (int z = 0; z < pl.pixels_[2]; z++) {
-    // update progress bar
-    pb.set_value(100.*(double)z/(double)(pl.pixels_[2]-1));
+    int owner = z % mpi::n_procs;
+    if (mpi::rank == owner) {
+      // update z coordinate
+      pltbase.origin_.z = ll.z + z * vox[2];
 
-    // update z coordinate
-    pltbase.origin_.z = ll.z + z * vox[2];
+      // generate ids using plotbase
+      IdData ids = pltbase.get_map<IdData>();
 
-    // generate ids using plotbase
-    IdData ids = pltbase.get_map<IdData>();
+      // select only cell/material ID data and flip the y-axis
+      xt::xtensor<int32_t, 2> data_slice = xt::view(ids.data_, xt::all(), xt::all(), idx);
+      data_flipped = xt::flip(data_slice, 0);
+    }
 
-    // select only cell/material ID data and flip the y-axis
-    int idx = pl.color_by_ == PlotColorBy::cells ? 0 : 1;
-    xt::xtensor<int32_t, 2> data_slice = xt::view(ids.data_, xt::all(), xt::all(), idx);
-    xt::xtensor<int32_t, 2> data_flipped = xt::flip(data_slice, 0);
+#ifdef OPENMC_MPI
+    if (owner != 0) {
+      int count = dims[1]*dims[2];
+      if (mpi::master) {
+        data_flipped.resize({pl.pixels_[1], pl.pixels_[0]});
+        MPI_Recv(data_flipped.data(), count, MPI_INT, owner, 0,
+          mpi::intracomm, MPI_STATUS_IGNORE);
+      } else if (mpi::rank == owner) {
+        MPI_Send(data_flipped.data(), count, MPI_INT, 0, 0, mpi::intracomm);
+      }
+    }
+#endif
 
-    // Write to HDF5 dataset
-    voxel_write_slice(z, dspace, dset, memspace, data_flipped.data());
+    if (mpi::master) {
+      // update progress bar
+      pb.set_value(100.*(double)z/(double)(pl.pixels_[2]-1));
+
+      // Write to HDF5 dataset once the previous slice has been written
+      if (slice_write.valid()) slice_write.get();
+      std::swap(data_written, data_flipped);
+      slice_write = std::async(std::launch::async, voxel_write_slice, z,
+        dspace, dset, memspace, data_written.data());
+    }
   }
 
-  voxel_finalize(dspace, dset, memspace);
-  file_close(file_id);
+  if (mpi::master) {
+    if (slice_write.valid()) slice_write.get();
+    voxel_finalize(dspace, dset, memspace);
+    file_close(file_id);
+  }
 }
 
 void
@@ -888,6 +945,182 @@ RGBColor random_color(void) {
           int(prn(&model::plotter_seed)*255)};
 }
 
+//==============================================================================
+// Tile cache for in-memory plots
+//==============================================================================
+
+namespace {
+
+constexpr int64_t PLOT_TILE_SIZE {64}; //!< width and height of tiles in pixels
+constexpr size_t PLOT_CACHE_MAX_TILES {1024}; //!< tiles kept per type of map
+constexpr double PLOT_PHASE_RESOLUTION {1.0e6}; //!< subdivisions of a pixel
+
+bool plot_cache_enabled {false};
+
+//! Pixel grid of a plot. Plots panned by whole pixels share the same grid,
+//! whose pixels have the same values, so only their extent differs. The key
+//! holds the basis, level, overlap coloring, ray tracing, pixel sizes, the
+//! coordinate normal to the plot and the offset of the pixel centers from
+//! multiples of the pixel size.
+using PlotGridKey = std::tuple<PlotBasis, int, bool, bool, double, double,
+  double, int64_t, int64_t>;
+
+//! Tiles of a pixel grid keyed by their horizontal and vertical indices
+template<class T>
+using TileMap = std::map<std::pair<int64_t, int64_t>, T>;
+
+//! Cached tiles of each pixel grid, for maps of type T
+template<class T>
+std::map<PlotGridKey, TileMap<T>>& tile_cache()
+{
+  static std::map<PlotGridKey, TileMap<T>> cache;
+  return cache;
+}
+
+void clear_tile_caches()
+{
+  tile_cache<IdData>().clear();
+  tile_cache<PropertyData>().clear();
+}
+
+//! Division rounding toward negative infinity
+int64_t floor_div(int64_t a, int64_t b)
+{
+  return (a >= 0) ? a / b : -((-a + b - 1) / b);
+}
+
+//! Generate the map of a plot from cached tiles, computing only those that are
+//! not cached yet
+template<class T>
+T get_map_cached(const PlotBase& plot)
+{
+  int64_t width = plot.pixels_[0];
+  int64_t height = plot.pixels_[1];
+
+  int in_i, out_i;
+  switch(plot.basis_) {
+  case PlotBasis::xy :
+    in_i = 0;
+    out_i = 1;
+    break;
+  case PlotBasis::xz :
+    in_i = 0;
+    out_i = 2;
+    break;
+  case PlotBasis::yz :
+    in_i = 1;
+    out_i = 2;
+    break;
+  default:
+    UNREACHABLE();
+  }
+  int normal_i = 3 - in_i - out_i;
+
+  // Center of the top-left pixel in units of the pixel size. Pixel (x, y) of
+  // the plot is pixel (x0 + x, y0 - y) of the grid.
+  double in_pixel = plot.width_[0] / width;
+  double out_pixel = plot.width_[1] / height;
+  double c_in = (plot.origin_[in_i] - plot.width_[0] / 2.) / in_pixel + 0.5;
+  double c_out = (plot.origin_[out_i] + plot.width_[1] / 2.) / out_pixel - 0.5;
+  int64_t x0 = std::llround(c_in);
+  int64_t y0 = std::llround(c_out);
+  int64_t phase_in = std::llround((c_in - x0)*PLOT_PHASE_RESOLUTION);
+  int64_t phase_out = std::llround((c_out - y0)*PLOT_PHASE_RESOLUTION);
+
+  PlotGridKey key {plot.basis_, plot.level_, plot.color_overlaps_,
+    plot.ray_trace_, in_pixel, out_pixel, plot.origin_[normal_i], phase_in,
+    phase_out};
+
+  // Tiles overlapping the plot
+  int64_t tx_min = floor_div(x0, PLOT_TILE_SIZE);
+  int64_t tx_max = floor_div(x0 + width - 1, PLOT_TILE_SIZE);
+  int64_t ty_min = floor_div(y0 - height + 1, PLOT_TILE_SIZE);
+  int64_t ty_max = floor_div(y0, PLOT_TILE_SIZE);
+
+  auto& cache {tile_cache<T>()};
+  auto& tiles {cache[key]};
+  std::vector<std::pair<int64_t, int64_t>> missing;
+  for (int64_t ty = ty_min; ty <= ty_max; ++ty) {
+    for (int64_t tx = tx_min; tx <= tx_max; ++tx) {
+      if (tiles.find({tx, ty}) == tiles.end()) missing.emplace_back(tx, ty);
+    }
+  }
+
+  // Compute the missing tiles, each as a small plot of its own
+  std::vector<T> new_tiles(missing.size(), T(0, 0));
+  #pragma omp parallel for schedule(dynamic)
+  for (int i = 0; i < missing.size(); ++i) {
+    PlotBase tile {plot};
+    tile.origin_[in_i] = (missing[i].first*PLOT_TILE_SIZE
+      + (PLOT_TILE_SIZE - 1) / 2. + phase_in / PLOT_PHASE_RESOLUTION)
+      * in_pixel;
+    tile.origin_[out_i] = (missing[i].second*PLOT_TILE_SIZE
+      + (PLOT_TILE_SIZE - 1) / 2. + phase_out / PLOT_PHASE_RESOLUTION)
+      * out_pixel;
+    tile.width_[0] = PLOT_TILE_SIZE*in_pixel;
+    tile.width_[1] = PLOT_TILE_SIZE*out_pixel;
+    tile.pixels_ = {PLOT_TILE_SIZE, PLOT_TILE_SIZE, 1};
+    new_tiles[i] = tile.get_map<T>();
+  }
+
+  // Make room for the new tiles, first by dropping other pixel grids and then
+  // the tiles of this grid outside of the plot
+  size_t n_tiles = missing.size();
+  for (const auto& grid : cache) n_tiles += grid.second.size();
+  if (n_tiles > PLOT_CACHE_MAX_TILES) {
+    for (auto it = cache.begin(); it != cache.end();) {
+      it = (it->first == key) ? std::next(it) : cache.erase(it);
+    }
+    if (tiles.size() + missing.size() > PLOT_CACHE_MAX_TILES) {
+      for (auto it = tiles.begin(); it != tiles.end();) {
+        int64_t tx = it->first.first;
+        int64_t ty = it->first.second;
+        bool visible = tx >= tx_min && tx <= tx_max && ty >= ty_min &&
+          ty <= ty_max;
+        it = visible ? std::next(it) : tiles.erase(it);
+      }
+    }
+  }
+  for (int i = 0; i < missing.size(); ++i) {
+    tiles.emplace(missing[i], std::move(new_tiles[i]));
+  }
+
+  // Assemble the plot from the tiles
+  T data(width, height);
+  #pragma omp parallel for
+  for (int64_t y = 0; y < height; ++y) {
+    int64_t Y = y0 - y;
+    int64_t ty = floor_div(Y, PLOT_TILE_SIZE);
+    int64_t row = (ty + 1)*PLOT_TILE_SIZE - 1 - Y;
+    for (int64_t x = 0; x < width; ++x) {
+      int64_t X = x0 + x;
+      int64_t tx = floor_div(X, PLOT_TILE_SIZE);
+      const auto& tile {tiles.at({tx, ty}).data_};
+      int64_t col = X - tx*PLOT_TILE_SIZE;
+      data.data_(y, x, 0) = tile(row, col, 0);
+      data.data_(y, x, 1) = tile(row, col, 1);
+    }
+  }
+  return data;
+}
+
+} // namespace
+
+void free_memory_plot()
+{
+  model::plots.clear();
+  model::plot_map.clear();
+  clear_tile_caches();
+  plot_cache_enabled = false;
+}
+
+extern "C" int openmc_set_plot_cache(bool enable)
+{
+  plot_cache_enabled = enable;
+  clear_tile_caches();
+  return 0;
+}
+
 extern "C" int openmc_id_map(const void* plot, int32_t* data_out)
 {
 
@@ -901,7 +1134,8 @@ extern "C" int openmc_id_map(const void* plot, int32_t* data_out)
     model::overlap_check_count.resize(model::cells.size());
   }
 
-  auto ids = plt->get_map<IdData>();
+  auto ids = plot_cache_enabled ? get_map_cached<IdData>(*plt) :
+    plt->get_map<IdData>();
 
   // write id data to array
   std::copy(ids.data_.begin(), ids.data_.end(), data_out);
@@ -921,7 +1155,8 @@ extern "C" int openmc_property_map(const void* plot, double* data_out) {
     model::overlap_check_count.resize(model::cells.size());
   }
 
-  auto props = plt->get_map<PropertyData>();
+  auto props = plot_cache_enabled ? get_map_cached<PropertyData>(*plt) :
+    plt->get_map<PropertyData>();
 
   // write id data to array
   std::copy(props.data_.begin(), props.data_.end(), data_out);
@@ -6,6 +6,10 @@ namespace openmc {
 // Position implementation
 //==============================================================================
 
+#ifdef OPENMC_OFFLOAD
+#pragma omp declare target
+#endif
+
 Position&
 Position::operator+=(Position other)
 {
@@ -84,6 +88,10 @@ Position::operator-() const
   return {-x, -y, -z};
 }
 
+#ifdef OPENMC_OFFLOAD
+#pragma omp end declare target
+#endif
+
 Position
 Position::rotate(const std::vector<double>& rotation) const
 {
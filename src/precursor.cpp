@@ -0,0 +1,176 @@
+#include "openmc/precursor.h"
+
+#include <cmath>   // for exp, expm1
+#include <cstddef> // for size_t
+#include <string>
+
+#include <fmt/core.h>
+
+#include "openmc/capi.h"
+#include "openmc/error.h"
+#include "openmc/mesh.h"
+#include "openmc/message_passing.h"
+#include "openmc/settings.h"
+#include "openmc/simulation.h"
+#include "openmc/xml_interface.h"
+
+namespace openmc {
+
+//==============================================================================
+// Global variables
+//==============================================================================
+
+namespace simulation {
+
+int32_t precursor_mesh {-1};
+xt::xtensor<double, 2> precursor_weight;
+xt::xtensor<double, 2> precursor_weight_decay;
+xt::xtensor<double, 2> precursor_yield;
+xt::xtensor<double, 2> precursor_decay_rate;
+xt::xtensor<double, 2> precursors;
+
+} // namespace simulation
+
+//==============================================================================
+// Non-member functions
+//==============================================================================
+
+void read_precursor_mesh(pugi::xml_node root)
+{
+  if (!check_for_node(root, "precursor_mesh")) return;
+
+  int mesh_id = std::stoi(get_node_value(root, "precursor_mesh"));
+  auto it = model::mesh_map.find(mesh_id);
+  if (it == model::mesh_map.end()) {
+    fatal_error(fmt::format("Mesh {} specified for delayed neutron precursors "
+      "does not exist.", mesh_id));
+  }
+  simulation::precursor_mesh = it->second;
+
+  // Populations start at zero and are only changed through the C API
+  std::size_t n = model::meshes[simulation::precursor_mesh]->n_bins();
+  simulation::precursors = xt::zeros<double>({n,
+    static_cast<std::size_t>(MAX_DELAYED_GROUPS)});
+  simulation::precursor_yield = simulation::precursors;
+  simulation::precursor_decay_rate = simulation::precursors;
+}
+
+void init_precursor_tallies()
+{
+  if (simulation::precursor_mesh < 0) return;
+  simulation::precursor_weight = xt::zeros_like(simulation::precursors);
+  simulation::precursor_weight_decay = xt::zeros_like(simulation::precursors);
+}
+
+void score_precursor(const Particle& p, double wgt, int group,
+  double decay_rate)
+{
+  if (simulation::current_batch <= settings::n_inactive) return;
+
+  int bin = model::meshes[simulation::precursor_mesh]->get_bin(p.r());
+  if (bin < 0) return;
+
+  #pragma omp atomic
+  simulation::precursor_weight(bin, group - 1) += wgt;
+  #pragma omp atomic
+  simulation::precursor_weight_decay(bin, group - 1) += wgt*decay_rate;
+}
+
+void finalize_precursor_tallies()
+{
+  using namespace simulation;
+
+  if (precursor_mesh < 0) return;
+
+#ifdef OPENMC_MPI
+  MPI_Allreduce(MPI_IN_PLACE, precursor_weight.data(), precursor_weight.size(),
+    MPI_DOUBLE, MPI_SUM, mpi::intracomm);
+  MPI_Allreduce(MPI_IN_PLACE, precursor_weight_decay.data(),
+    precursor_weight_decay.size(), MPI_DOUBLE, MPI_SUM, mpi::intracomm);
+#endif
+
+  // Number of source particles of the active batches
+  double n_source = 0.0;
+  for (int b = settings::n_inactive + 1; b <= current_batch; ++b) {
+    n_source += particles_in_batch(b)*settings::gen_per_batch;
+  }
+  if (n_source == 0.0) return;
+
+  for (std::size_t i = 0; i < precursor_weight.size(); ++i) {
+    double w = precursor_weight.data()[i];
+    precursor_yield.data()[i] = w / n_source;
+    precursor_decay_rate.data()[i] =
+      (w > 0.0) ? precursor_weight_decay.data()[i] / w : 0.0;
+  }
+}
+
+void free_memory_precursors()
+{
+  simulation::precursor_mesh = -1;
+  simulation::precursor_weight.resize({0, 0});
+  simulation::precursor_weight_decay.resize({0, 0});
+  simulation::precursor_yield.resize({0, 0});
+  simulation::precursor_decay_rate.resize({0, 0});
+  simulation::precursors.resize({0, 0});
+}
+
+//==============================================================================
+// C-API functions
+//==============================================================================
+
+extern "C" int
+openmc_precursors(double** ptr, size_t shape_[2])
+{
+  if (simulation::precursor_mesh < 0) {
+    set_errmsg("No precursor mesh was specified.");
+    return OPENMC_E_ALLOCATE;
+  }
+  *ptr = simulation::precursors.data();
+  shape_[0] = simulation::precursors.shape()[0];
+  shape_[1] = simulation::precursors.shape()[1];
+  return 0;
+}
+
+extern "C" int
+openmc_precursor_decay_rates(double** ptr, size_t shape_[2])
+{
+  if (simulation::precursor_mesh < 0) {
+    set_errmsg("No precursor mesh was specified.");
+    return OPENMC_E_ALLOCATE;
+  }
+  *ptr = simulation::precursor_decay_rate.data();
+  shape_[0] = simulation::precursor_decay_rate.shape()[0];
+  shape_[1] = simulation::precursor_decay_rate.shape()[1];
+  return 0;
+}
+
+extern "C" int
+openmc_precursors_advance(double dt, double source_rate)
+{
+  using namespace simulation;
+
+  if (precursor_mesh < 0) {
+    set_errmsg("No precursor mesh was specified.");
+    return OPENMC_E_ALLOCATE;
+  }
+  if (dt < 0.0) {
+    set_errmsg("The time step of precursors must not be negative.");
+    return OPENMC_E_INVALID_ARGUMENT;
+  }
+
+  // Exact solution of dC/dt = S*y - lambda*C over the step, assuming the
+  // production rate and decay constant are constant during it
+  for (std::size_t i = 0; i < precursors.size(); ++i) {
+    double production = source_rate*precursor_yield.data()[i];
+    double lambda = precursor_decay_rate.data()[i];
+    double& c = precursors.data()[i];
+    if (lambda > 0.0) {
+      c = c*std::exp(-lambda*dt) - production/lambda*std::expm1(-lambda*dt);
+    } else {
+      c += production*dt;
+    }
+  }
+  return 0;
+}
+
+} // namespace openmc
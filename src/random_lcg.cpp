@@ -18,12 +18,61 @@ constexpr uint64_t prn_stride {152917LL};                // stride between
                                                          //   particles
 constexpr double   prn_norm   {1.0 / prn_mod};           // 2^-63
 
+// Philox-2x32-10 parameters. With this generator, a seed is the counter of the
+// next random number, made of the stream in its 3 most significant bits, the
+// particle ID in the next 37 bits and the position in the stream in the
+// remaining 24 bits.
+constexpr uint32_t philox_mult  {0xD256D193};             // multiplier
+constexpr uint32_t philox_weyl  {0x9E3779B9};             // key increment
+constexpr int      philox_rounds {10};
+constexpr int      philox_id_shift {24};
+constexpr int      philox_stream_shift {61};
+constexpr double   philox_norm  {1.0 / (UINT64_C(1) << 53)}; // 2^-53
+
+// Pseudorandom number generator in use
+RandomGenerator generator {RandomGenerator::lcg};
+
+//==============================================================================
+// PHILOX
+//==============================================================================
+
+//! Key of the counter-based generator, derived from the master seed
+
+inline uint32_t philox_key()
+{
+  uint64_t s = static_cast<uint64_t>(master_seed);
+  return static_cast<uint32_t>(s ^ (s >> 32));
+}
+
+//! Random number of a counter with the Philox-2x32-10 bijection
+
+#pragma omp declare simd uniform(key)
+inline double philox(uint64_t counter, uint32_t key)
+{
+  uint32_t x0 = static_cast<uint32_t>(counter >> 32);
+  uint32_t x1 = static_cast<uint32_t>(counter);
+  for (int i = 0; i < philox_rounds; ++i) {
+    uint64_t product = static_cast<uint64_t>(philox_mult) * x0;
+    x0 = static_cast<uint32_t>(product >> 32) ^ key ^ x1;
+    x1 = static_cast<uint32_t>(product);
+    key += philox_weyl;
+  }
+
+  // Use the 53 most significant bits of the result
+  uint64_t bits = (static_cast<uint64_t>(x0) << 32) | x1;
+  return (bits >> 11) * philox_norm;
+}
+
 //==============================================================================
 // PRN
 //==============================================================================
 
 double prn(uint64_t* seed)
 {
+  if (generator == RandomGenerator::philox) {
+    return philox(++(*seed), philox_key());
+  }
+
   // This algorithm uses bit-masking to find the next integer(8) value to be
   // used to calculate the random number.
   *seed = (prn_mult * (*seed) + prn_add) & prn_mask;
@@ -33,12 +82,32 @@ double prn(uint64_t* seed)
   return (*seed) * prn_norm;
 }
 
+void prn(uint64_t* seed, int n, double* xi)
+{
+  if (generator == RandomGenerator::philox) {
+    uint64_t counter = *seed;
+    uint32_t key = philox_key();
+    #pragma omp simd
+    for (int i = 0; i < n; ++i) {
+      xi[i] = philox(counter + i + 1, key);
+    }
+    *seed += n;
+  } else {
+    for (int i = 0; i < n; ++i) {
+      xi[i] = prn(seed);
+    }
+  }
+}
+
 //==============================================================================
 // FUTURE_PRN
 //==============================================================================
 
 double future_prn(int64_t n, uint64_t seed)
 {
+  if (generator == RandomGenerator::philox) {
+    return philox(seed + static_cast<uint64_t>(n), philox_key());
+  }
   return future_seed(static_cast<uint64_t>(n), seed) * prn_norm;
 }
 
@@ -48,6 +117,10 @@ double future_prn(int64_t n, uint64_t seed)
 
 uint64_t init_seed(int64_t id, int offset)
 {
+  if (generator == RandomGenerator::philox) {
+    return (static_cast<uint64_t>(offset) << philox_stream_shift) +
+      (static_cast<uint64_t>(id) << philox_id_shift);
+  }
   return future_seed(static_cast<uint64_t>(id) * prn_stride, master_seed + offset);
 }
 
@@ -58,7 +131,7 @@ uint64_t init_seed(int64_t id, int offset)
 void init_particle_seeds(int64_t id, uint64_t* seeds)
 {
   for (int i = 0; i < N_STREAMS; i++) {
-    seeds[i] = future_seed(static_cast<uint64_t>(id) * prn_stride, master_seed + i);
+    seeds[i] = init_seed(id, i);
   }
 }
 
@@ -77,6 +150,9 @@ void advance_prn_seed(int64_t n, uint64_t* seed)
 
 uint64_t future_seed(uint64_t n, uint64_t seed)
 {
+  // The seed of a counter-based generator is the counter itself
+  if (generator == RandomGenerator::philox) return seed + n;
+
   // Make sure nskip is less than 2^M.
   n &= prn_mask;
 
@@ -109,6 +185,20 @@ uint64_t future_seed(uint64_t n, uint64_t seed)
   return (g_new * seed + c_new) & prn_mask;
 }
 
+//==============================================================================
+// RANDOM_GENERATOR
+//==============================================================================
+
+void set_random_generator(RandomGenerator gen)
+{
+  generator = gen;
+}
+
+RandomGenerator random_generator()
+{
+  return generator;
+}
+
 //==============================================================================
 //                               API FUNCTIONS
 //==============================================================================
@@ -0,0 +1,394 @@
+#include "openmc/random_ray.h"
+
+#include <algorithm> // for copy, fill
+#include <cmath> // for expm1
+#include <map>
+#include <string>
+#include <utility> // for make_pair, pair
+
+#include <fmt/core.h>
+
+#include "openmc/cell.h"
+#include "openmc/cmfd.h"
+#include "openmc/constants.h"
+#include "openmc/distribution_multi.h"
+#include "openmc/error.h"
+#include "openmc/geometry.h"
+#include "openmc/material.h"
+#include "openmc/message_passing.h"
+#include "openmc/mgxs_interface.h"
+#include "openmc/particle.h"
+#include "openmc/random_lcg.h"
+#include "openmc/settings.h"
+#include "openmc/simulation.h"
+#include "openmc/source.h"
+#include "openmc/tallies/tally.h"
+#include "openmc/tallies/tally_scoring.h"
+#include "openmc/xml_interface.h"
+
+namespace openmc {
+
+//==============================================================================
+// Global variables
+//==============================================================================
+
+namespace simulation {
+
+std::unique_ptr<RandomRaySolver> random_ray;
+
+} // namespace simulation
+
+//==============================================================================
+// RandomRaySolver implementation
+//==============================================================================
+
+RandomRaySolver::RandomRaySolver(pugi::xml_node node)
+{
+  if (!check_for_node(node, "distance_inactive") ||
+      !check_for_node(node, "distance_active")) {
+    fatal_error("Both the inactive and active distances of random rays must "
+      "be specified.");
+  }
+  distance_inactive_ = std::stod(get_node_value(node, "distance_inactive"));
+  distance_active_ = std::stod(get_node_value(node, "distance_active"));
+  if (distance_inactive_ < 0.0 || distance_active_ <= 0.0) {
+    fatal_error("The inactive distance of random rays must not be negative "
+      "and their active distance must be positive.");
+  }
+}
+
+void RandomRaySolver::check_tallies() const
+{
+  // Rays have no collisions and do not cross surfaces with a weight, so
+  // collision and analog estimators, including those of surface tallies,
+  // would silently score nothing
+  for (const auto& t : model::tallies) {
+    if (t->estimator_ != TallyEstimator::TRACKLENGTH) {
+      fatal_error(fmt::format("Tally {} needs a {} estimator, but random ray "
+        "only scores track-length tallies.", t->id_,
+        t->estimator_ == TallyEstimator::ANALOG ? "analog" : "collision"));
+    }
+  }
+}
+
+void RandomRaySolver::initialize()
+{
+  if (settings::run_CE) {
+    fatal_error("Random ray requires multigroup cross sections.");
+  }
+  if (settings::run_mode != RunMode::EIGENVALUE) {
+    fatal_error("Random ray is only available for eigenvalue calculations.");
+  }
+  if (simulation::cmfd_accelerator) {
+    fatal_error("CMFD acceleration cannot be combined with random ray.");
+  }
+  if (!settings::source_write_surf_id.empty()) {
+    fatal_error("A surface source cannot be written with random ray.");
+  }
+
+  // Flat source regions are cell instances, which can only be told apart
+  // when the offsets of all material cells are computed
+  settings::material_cell_offsets = true;
+
+  // Without a fission bank there are no sites to compute the entropy of
+  if (settings::entropy_on) {
+    warning("Shannon entropy is not computed with random ray.");
+    settings::entropy_on = false;
+  }
+
+  n_groups_ = data::mg.num_energy_groups_;
+  int n_g = n_groups_;
+
+  // Each instance of a material cell is a flat source region. Regions whose
+  // material has the same cross sections at the same temperature share them.
+  std::map<std::pair<int32_t, int>, int> xs_index;
+  bool fissionable = false;
+  region_offset_.assign(model::cells.size(), C_NONE);
+  n_regions_ = 0;
+  region_xs_.clear();
+  xs_.clear();
+  for (int i = 0; i < model::cells.size(); ++i) {
+    const auto& c {*model::cells[i]};
+    if (c.type_ != Fill::MATERIAL) continue;
+    region_offset_[i] = n_regions_;
+    n_regions_ += c.n_instances_;
+
+    for (int j = 0; j < c.n_instances_; ++j) {
+      int32_t i_mat = c.material_.size() > 1 ? c.material_[j] : c.material_[0];
+      if (i_mat == MATERIAL_VOID) {
+        region_xs_.push_back(C_NONE);
+        continue;
+      }
+      double sqrtkT = c.sqrtkT_.size() > 1 ? c.sqrtkT_[j] : c.sqrtkT_[0];
+
+      const auto& macro {data::mg.macro_xs_[i_mat]};
+      if (!macro.isotropic()) {
+        fatal_error(fmt::format("Random ray requires cross sections that do "
+          "not depend on angle, which is not the case for material {}.",
+          model::materials[i_mat]->id_));
+      }
+      MgxsCache cache;
+      macro.set_temperature_index(cache, sqrtkT);
+      macro.set_angle_index(cache, {0., 0., 1.});
+
+      auto key = std::make_pair(i_mat, cache.t);
+      auto it = xs_index.find(key);
+      if (it == xs_index.end()) {
+        it = xs_index.emplace(key, xs_.size()).first;
+
+        GroupXS xs;
+        xs.total.resize(n_g);
+        xs.nu_fission.resize(n_g);
+        xs.scatter.resize(n_g*n_g);
+        xs.fission.resize(n_g*n_g);
+        for (int gin = 0; gin < n_g; ++gin) {
+          xs.total[gin] = macro.get_xs(cache, MgxsType::TOTAL, gin);
+          xs.nu_fission[gin] = macro.get_xs(cache, MgxsType::NU_FISSION, gin);
+          fissionable = fissionable || xs.nu_fission[gin] > 0.0;
+          double prompt = macro.get_xs(cache, MgxsType::PROMPT_NU_FISSION,
+            gin);
+          for (int gout = 0; gout < n_g; ++gout) {
+            xs.scatter[gin*n_g + gout] = macro.get_xs(cache,
+              MgxsType::SCATTER, gin, &gout, nullptr, nullptr);
+            double f = prompt * macro.get_xs(cache, MgxsType::CHI_PROMPT,
+              gin, &gout, nullptr, nullptr);
+            for (int d = 0; d < data::mg.num_delayed_groups_; ++d) {
+              f += macro.get_xs(cache, MgxsType::DELAYED_NU_FISSION, gin,
+                nullptr, nullptr, &d) * macro.get_xs(cache,
+                MgxsType::CHI_DELAYED, gin, &gout, nullptr, &d);
+            }
+            xs.fission[gin*n_g + gout] = f;
+          }
+        }
+        xs_.push_back(std::move(xs));
+      }
+      region_xs_.push_back(it->second);
+    }
+  }
+  if (!fissionable) {
+    fatal_error("Random ray eigenvalue calculations need fissionable "
+      "material.");
+  }
+
+  // Start from a flat scalar flux
+  source_.assign(n_regions_*n_g, 0.0);
+  flux_.assign(n_regions_*n_g, 1.0);
+  flux_new_.assign(n_regions_*n_g, 0.0);
+  length_.assign(n_regions_, 0.0);
+  length_total_.assign(n_regions_, 0.0);
+  n_length_batches_ = 0;
+  keff_ = 1.0;
+}
+
+void RandomRaySolver::transport()
+{
+  int n_g = n_groups_;
+  update_source();
+  std::fill(flux_new_.begin(), flux_new_.end(), 0.0);
+  std::fill(length_.begin(), length_.end(), 0.0);
+
+  bool tally = simulation::current_batch > settings::n_inactive &&
+    !model::active_tracklength_tallies.empty();
+
+  #pragma omp parallel
+  {
+    Particle p;
+    p.filter_matches_.resize(model::tally_filters.size());
+    std::vector<double> psi(n_g);
+
+    #pragma omp for schedule(runtime)
+    for (int64_t i = 1; i <= simulation::work_per_rank; ++i) {
+      // Rays are seeded like the particles of a fixed source calculation
+      int64_t id = simulation::work_index[mpi::rank] + i;
+      int64_t index = (simulation::total_gen + overall_generation() - 1)
+        * settings::n_particles + id;
+      uint64_t seed = init_seed(index, STREAM_SOURCE);
+      auto site = sample_external_source(&seed);
+      site.u = Isotropic().sample(&seed);
+      site.wgt = 0.0;
+
+      p.from_source(&site);
+      p.id_ = id;
+      p.stream_ = STREAM_TRACKING;
+      init_particle_seeds(index, p.seeds_);
+      if (!find_cell(p, false)) {
+        p.mark_as_lost("Could not find the cell containing ray "
+          + std::to_string(id));
+        continue;
+      }
+      transport_ray(p, psi, tally);
+    }
+  }
+
+  // Each ray has unit weight when normalizing tallies
+  simulation::total_weight += simulation::work_per_rank;
+
+#ifdef OPENMC_MPI
+  MPI_Allreduce(MPI_IN_PLACE, flux_new_.data(), flux_new_.size(), MPI_DOUBLE,
+    MPI_SUM, mpi::intracomm);
+  MPI_Allreduce(MPI_IN_PLACE, length_.data(), length_.size(), MPI_DOUBLE,
+    MPI_SUM, mpi::intracomm);
+#endif
+
+  // The volume of each region is estimated from its track length averaged over
+  // all batches, which is less noisy than the track length of one batch
+  ++n_length_batches_;
+  double production_old = 0.0;
+  double production_new = 0.0;
+  for (int64_t r = 0; r < n_regions_; ++r) {
+    length_total_[r] += length_[r];
+    double volume = length_total_[r] / n_length_batches_;
+    int i_xs = region_xs_[r];
+
+    for (int g = 0; g < n_g; ++g) {
+      int64_t k = r*n_g + g;
+      double phi;
+      if (i_xs == C_NONE) {
+        phi = volume > 0.0 ? 4.0*PI*flux_new_[k] / volume : 0.0;
+      } else {
+        const auto& xs {xs_[i_xs]};
+        phi = 4.0*PI*source_[k];
+        if (volume > 0.0) {
+          phi += 4.0*PI*flux_new_[k] / (xs.total[g]*volume);
+        }
+        production_old += length_total_[r] * xs.nu_fission[g] * flux_[k];
+        production_new += length_total_[r] * xs.nu_fission[g] * phi;
+      }
+      flux_[k] = phi;
+    }
+  }
+  if (production_old > 0.0) keff_ *= production_new / production_old;
+
+  // The eigenvalue is reported through the global estimators of k so that
+  // it is combined over batches like the eigenvalue of particle transport
+  double k_weight = keff_ * simulation::work_per_rank;
+  global_tally_collision += k_weight;
+  global_tally_absorption += k_weight;
+  global_tally_tracklength += k_weight;
+}
+
+void RandomRaySolver::update_source()
+{
+  int n_g = n_groups_;
+
+  #pragma omp parallel for
+  for (int64_t r = 0; r < n_regions_; ++r) {
+    double* q = &source_[r*n_g];
+    int i_xs = region_xs_[r];
+    if (i_xs == C_NONE) {
+      std::fill(q, q + n_g, 0.0);
+      continue;
+    }
+
+    // Isotropic scattering and fission source per unit solid angle, divided by
+    // the total cross section
+    const auto& xs {xs_[i_xs]};
+    const double* phi = &flux_[r*n_g];
+    for (int g = 0; g < n_g; ++g) {
+      double s = 0.0;
+      for (int h = 0; h < n_g; ++h) {
+        s += (xs.scatter[h*n_g + g] + xs.fission[h*n_g + g] / keff_) * phi[h];
+      }
+      q[g] = s / (4.0*PI*xs.total[g]);
+    }
+  }
+}
+
+void RandomRaySolver::transport_ray(Particle& p, std::vector<double>& psi,
+  bool tally)
+{
+  int n_g = n_groups_;
+  std::vector<double> mean_psi(n_g);
+  double length = distance_inactive_ + distance_active_;
+  double traveled = 0.0;
+
+  // The angular flux of a ray starts from the source of its first region
+  int64_t r = region(p);
+  std::copy(&source_[r*n_g], &source_[r*n_g] + n_g, psi.begin());
+
+  while (traveled < length) {
+    r = region(p);
+    p.boundary_ = distance_to_boundary(p);
+
+    // A segment ends at a boundary, where the ray starts contributing or at
+    // the end of the ray
+    double end = traveled < distance_inactive_ ? distance_inactive_ : length;
+    double distance = p.boundary_.distance;
+    bool crossing = distance < end - traveled;
+    if (!crossing) distance = end - traveled;
+    bool active = traveled >= distance_inactive_;
+
+    // Attenuate the angular flux along the segment
+    int i_xs = region_xs_[r];
+    const double* q = &source_[r*n_g];
+    for (int g = 0; g < n_g; ++g) {
+      double contribution;
+      if (i_xs == C_NONE) {
+        mean_psi[g] = psi[g];
+        contribution = psi[g] * distance;
+      } else {
+        double tau = xs_[i_xs].total[g] * distance;
+        double delta = (psi[g] - q[g]) * -std::expm1(-tau);
+        mean_psi[g] = tau > 0.0 ? q[g] + delta / tau : psi[g];
+        psi[g] -= delta;
+        contribution = delta;
+      }
+      if (active) {
+        #pragma omp atomic
+        flux_new_[r*n_g + g] += contribution;
+      }
+    }
+
+    // Move the ray to the end of the segment
+    p.r_last_ = p.r();
+    for (int j = 0; j < p.n_coord_; ++j) {
+      p.coord_[j].r += distance * p.coord_[j].u;
+    }
+    traveled += distance;
+
+    if (active) {
+      #pragma omp atomic
+      length_[r] += distance;
+      if (tally) score_segment(p, mean_psi, distance);
+    }
+
+    // Rays have no weight when crossing surfaces so that they do not
+    // contribute to surface tallies
+    if (crossing) {
+      p.wgt_ = 0.0;
+      p.event_cross_surface();
+      if (!p.alive_) break;
+    }
+  }
+}
+
+void RandomRaySolver::score_segment(Particle& p,
+  const std::vector<double>& mean_psi, double distance) const
+{
+  // Tallies see the segment once for each group with a weight that makes the
+  // track-length flux equal to the scalar flux the segment contributes
+  for (int g = 0; g < n_groups_; ++g) {
+    p.g_ = g;
+    p.g_last_ = g;
+    p.E_ = data::mg.energy_bin_avg_[g];
+    p.E_last_ = p.E_;
+    p.wgt_ = 4.0*PI*mean_psi[g];
+    if (p.material_ != MATERIAL_VOID) {
+      data::mg.macro_xs_[p.material_].calculate_xs(p);
+    } else {
+      p.macro_xs_.total = 0.0;
+      p.macro_xs_.absorption = 0.0;
+      p.macro_xs_.nu_fission = 0.0;
+    }
+    score_tracklength_tally(p, distance);
+  }
+  p.wgt_ = 0.0;
+}
+
+int64_t RandomRaySolver::region(const Particle& p) const
+{
+  int32_t i_cell = p.coord_[p.n_coord_ - 1].cell;
+  return region_offset_[i_cell] + p.cell_instance_;
+}
+
+} // namespace openmc
@@ -1,5 +1,6 @@
 #include "openmc/reaction.h"
 
+#include <algorithm> // for max, min
 #include <string>
 #include <unordered_map>
 #include <utility> // for move
@@ -11,6 +12,7 @@
 #include "openmc/endf.h"
 #include "openmc/random_lcg.h"
 #include "openmc/secondary_uncorrelated.h"
+#include "openmc/settings.h"
 
 namespace openmc {
 
@@ -54,11 +56,13 @@ Reaction::Reaction(hid_t group, const std::vector<int>& temperatures)
     xs_.push_back(std::move(xs));
   }
 
-  // Read products
+  // Read products. Distributions for fission, which are adjusted below, and
+  // elastic scattering, which are accessed directly, are always read.
+  bool lazy = settings::lazy_products && !is_fission(mt_) && mt_ != ELASTIC;
   for (const auto& name : group_names(group)) {
     if (name.rfind("product_", 0) == 0) {
       hid_t pgroup = open_group(group, name.c_str());
-      products_.emplace_back(pgroup);
+      products_.emplace_back(pgroup, lazy);
       close_group(pgroup);
     }
   }
@@ -83,6 +87,42 @@ Reaction::Reaction(hid_t group, const std::vector<int>& temperatures)
   // <<<<<<<<<<<<<<<<<<<<<<<<<<<< REMOVE THIS <<<<<<<<<<<<<<<<<<<<<<<<<
 }
 
+std::vector<double> Reaction::group_xs(int i_temp,
+  gsl::span<const double> energy, const std::vector<xs_real>& grid) const
+{
+  int n_groups = energy.size() - 1;
+  std::vector<double> xs_group(n_groups, 0.0);
+
+  const auto& xs {xs_[i_temp]};
+  int first = xs.threshold;
+  int last = first + static_cast<int>(xs.value.size()) - 1;
+
+  // Integrate over the overlap of each grid interval with each group. Both
+  // are in increasing order, so the first group that can overlap an interval
+  // only moves up.
+  int j = 0;
+  for (int i = first; i < last && j < n_groups; ++i) {
+    double E_l = grid[i];
+    double E_r = grid[i + 1];
+    if (E_r <= E_l) continue;
+    double xs_l = xs.value[i - first];
+    double slope = (xs.value[i + 1 - first] - xs_l) / (E_r - E_l);
+
+    while (j < n_groups && energy[j + 1] <= E_l) ++j;
+    for (int g = j; g < n_groups && energy[g] < E_r; ++g) {
+      double E_low = std::max(E_l, energy[g]);
+      double E_high = std::min(E_r, energy[g + 1]);
+      double xs_mid = xs_l + slope*(0.5*(E_low + E_high) - E_l);
+      xs_group[g] += xs_mid*(E_high - E_low);
+    }
+  }
+
+  for (int g = 0; g < n_groups; ++g) {
+    xs_group[g] /= energy[g + 1] - energy[g];
+  }
+  return xs_group;
+}
+
 //==============================================================================
 // Non-member functions
 //==============================================================================
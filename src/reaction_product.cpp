@@ -1,6 +1,7 @@
 #include "openmc/reaction_product.h"
 
 #include <memory> // for unique_ptr
+#include <mutex> // for lock_guard
 #include <string> // for string
 
 #include "openmc/endf.h"
@@ -18,7 +19,7 @@ namespace openmc {
 // ReactionProduct implementation
 //==============================================================================
 
-ReactionProduct::ReactionProduct(hid_t group)
+ReactionProduct::ReactionProduct(hid_t group, bool lazy)
 {
   // Read particle type
   std::string temp;
@@ -41,7 +42,22 @@ ReactionProduct::ReactionProduct(hid_t group)
 
   // Read secondary particle yield
   yield_ = read_function(group, "yield");
+  yield_fn_ = InlineFunction1D{yield_.get()};
+
+  // Distributions make up most of the data, so reading them can be deferred
+  // by remembering where they are
+  if (lazy) {
+    loaded_ = false;
+    filename_ = file_name(group);
+    path_ = object_name(group);
+  } else {
+    read_distributions(group);
+  }
+}
 
+void ReactionProduct::read_distributions(hid_t group) const
+{
+  std::string temp;
   int n;
   read_attribute(group, "n_distribution", n);
 
@@ -73,16 +89,47 @@ ReactionProduct::ReactionProduct(hid_t group)
   }
 }
 
+void ReactionProduct::load_distributions() const
+{
+  // Deferred distributions may be read by several transport threads while a
+  // state point is written in the background
+  std::lock_guard<std::mutex> lock(hdf5_mutex);
+
+  // Another thread may have read the distributions while this one waited
+  if (loaded_) return;
+
+  hid_t file_id = file_open(filename_, 'r');
+  hid_t group = open_group(file_id, path_.c_str());
+  read_distributions(group);
+  close_group(group);
+  file_close(file_id);
+
+  #pragma omp atomic write seq_cst
+  loaded_ = true;
+}
+
 void ReactionProduct::sample(double E_in, double& E_out, double& mu,
   uint64_t* seed) const
 {
+  EnergyContext context {E_in};
+  this->sample(context, E_out, mu, seed);
+}
+
+void ReactionProduct::sample(EnergyContext& E_in, double& E_out, double& mu,
+  uint64_t* seed) const
+{
+  bool loaded;
+  #pragma omp atomic read seq_cst
+  loaded = loaded_;
+  if (!loaded) load_distributions();
+
   auto n = applicability_.size();
   if (n > 1) {
     double prob = 0.0;
     double c = prn(seed);
     for (int i = 0; i < n; ++i) {
       // Determine probability that i-th energy distribution is sampled
-      prob += applicability_[i](E_in);
+      prob += applicability_[i](E_in.E());
 
       // If i-th distribution is sampled, sample energy from the distribution
       if (c <= prob) {
@@ -1,8 +1,10 @@
 #include "openmc/scattdata.h"
 
 #include <algorithm>
+#include <functional> // for hash
 #include <numeric>
 #include <cmath>
+#include <typeinfo>
 
 #include "xtensor/xbuilder.hpp"
 
@@ -49,6 +51,31 @@ ScattData::base_init(int order, const xt::xtensor<int, 1>& in_gmin,
       v.resize(order);
     }
   }
+
+  pack_outgoing();
+}
+
+//==============================================================================
+
+void
+ScattData::pack_outgoing()
+{
+  size_t groups = energy.size();
+  outgoing.clear();
+  outgoing_start.resize(groups + 1);
+
+  for (int gin = 0; gin < groups; gin++) {
+    outgoing_start[gin] = outgoing.size();
+
+    // Accumulate the probabilities in the same order as they would be summed
+    // when sampling from the unpacked data
+    double prob = 0.;
+    for (int i_gout = 0; i_gout < energy[gin].size(); i_gout++) {
+      prob += energy[gin][i_gout];
+      outgoing.push_back({prob, mult[gin][i_gout]});
+    }
+  }
+  outgoing_start[groups] = outgoing.size();
 }
 
 //==============================================================================
@@ -181,17 +208,16 @@ ScattData::base_combine(size_t max_order,
 //==============================================================================
 
 void
-ScattData::sample_energy(int gin, int& gout, int& i_gout, uint64_t* seed)
+ScattData::sample_energy(int gin, int& gout, int& i_gout, uint64_t* seed) const
 {
-  // Sample the outgoing group
+  // Sample the outgoing group; the last group is taken if round-off leaves
+  // the cumulative probability below xi
   double xi = prn(seed);
-  double prob = 0.;
+  const Outgoing* row = &outgoing[outgoing_start[gin]];
+  int n = gmax[gin] - gmin[gin];
   i_gout = 0;
-  for (gout = gmin[gin]; gout < gmax[gin]; ++gout) {
-    prob += energy[gin][i_gout];
-    if (xi < prob) break;
-    ++i_gout;
-  }
+  while (i_gout < n && xi >= row[i_gout].cdf) ++i_gout;
+  gout = gmin[gin] + i_gout;
 }
 
 //==============================================================================
@@ -247,6 +273,35 @@ ScattData::get_xs(MgxsType xstype, int gin, const int* gout, const double* mu)
   return val;
 }
 
+//==============================================================================
+
+size_t
+ScattData::hash() const
+{
+  // Mix the hash of each value in as boost::hash_combine does
+  size_t seed = 0;
+  auto combine = [&seed](size_t h) {
+    seed ^= h + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+  };
+  for (int g : gmin) combine(std::hash<int>{}(g));
+  for (int g : gmax) combine(std::hash<int>{}(g));
+  for (double xs : scattxs) combine(std::hash<double>{}(xs));
+  for (const auto& row : energy) {
+    for (double p : row) combine(std::hash<double>{}(p));
+  }
+  return seed;
+}
+
+//==============================================================================
+
+bool
+ScattData::equals(const ScattData& that) const
+{
+  return typeid(*this) == typeid(that) && gmin == that.gmin &&
+    gmax == that.gmax && scattxs == that.scattxs && energy == that.energy &&
+    mult == that.mult && dist == that.dist;
+}
+
 //==============================================================================
 // ScattDataLegendre methods
 //==============================================================================
@@ -387,7 +442,7 @@ ScattDataLegendre::sample(int gin, int& gout, double& mu, double& wgt,
   }
 
   // Update the weight to reflect neutron multiplicity
-  wgt *= mult[gin][i_gout];
+  wgt *= multiplicity(gin, i_gout);
 }
 
 //==============================================================================
@@ -581,7 +636,7 @@ ScattDataHistogram::sample(int gin, int& gout, double& mu, double& wgt,
   }
 
   // Update the weight to reflect neutron multiplicity
-  wgt *= mult[gin][i_gout];
+  wgt *= multiplicity(gin, i_gout);
 }
 
 //==============================================================================
@@ -609,6 +664,16 @@ ScattDataHistogram::get_matrix(size_t max_order)
 
 //==============================================================================
 
+bool
+ScattDataHistogram::equals(const ScattData& that) const
+{
+  if (!ScattData::equals(that)) return false;
+  const auto& other = static_cast<const ScattDataHistogram&>(that);
+  return mu == other.mu && fmu == other.fmu;
+}
+
+//==============================================================================
+
 void
 ScattDataHistogram::combine(const std::vector<ScattData*>& those_scatts,
                             const std::vector<double>& scalars)
@@ -799,7 +864,7 @@ ScattDataTabular::sample(int gin, int& gout, double& mu, double& wgt,
   }
 
   // Update the weight to reflect neutron multiplicity
-  wgt *= mult[gin][i_gout];
+  wgt *= multiplicity(gin, i_gout);
 }
 
 //==============================================================================
@@ -827,6 +892,16 @@ ScattDataTabular::get_matrix(size_t max_order)
 
 //==============================================================================
 
+bool
+ScattDataTabular::equals(const ScattData& that) const
+{
+  if (!ScattData::equals(that)) return false;
+  const auto& other = static_cast<const ScattDataTabular&>(that);
+  return mu == other.mu && fmu == other.fmu;
+}
+
+//==============================================================================
+
 void
 ScattDataTabular::combine(const std::vector<ScattData*>& those_scatts,
                           const std::vector<double>& scalars)
@@ -887,9 +962,11 @@ convert_legendre_to_tabular(ScattDataLegendre& leg, ScattDataTabular& tab)
   tab.mu = xt::linspace(-1., 1., n_mu);
   tab.dmu = 2. / (n_mu - 1);
 
-  // Calculate f(mu) and integrate it so we can avoid rejection sampling
-  size_t groups = tab.energy.size();
+  // Calculate f(mu) and integrate it so we can avoid rejection sampling. The
+  // incoming groups are independent of each other.
+  int groups = tab.energy.size();
   tab.fmu.resize(groups);
+#pragma omp parallel for schedule(dynamic)
   for (int gin = 0; gin < groups; gin++) {
     int num_groups = tab.gmax[gin] - tab.gmin[gin] + 1;
     tab.fmu[gin].resize(num_groups);
@@ -928,4 +1005,21 @@ convert_legendre_to_tabular(ScattDataLegendre& leg, ScattDataTabular& tab)
   }
 }
 
+//==============================================================================
+// ScattDataPool methods
+//==============================================================================
+
+void
+ScattDataPool::share(std::shared_ptr<ScattData>& scatt)
+{
+  auto& candidates = data_[scatt->hash()];
+  for (const auto& known : candidates) {
+    if (known->equals(*scatt)) {
+      scatt = known;
+      return;
+    }
+  }
+  candidates.push_back(scatt);
+}
+
 } // namespace openmc
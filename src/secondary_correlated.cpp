@@ -12,6 +12,7 @@
 #include "openmc/endf.h"
 #include "openmc/random_lcg.h"
 #include "openmc/search.h"
+#include "openmc/settings.h"
 
 namespace openmc {
 
@@ -148,12 +149,35 @@ CorrelatedAngleEnergy::CorrelatedAngleEnergy(hid_t group)
       d.angle.emplace_back(mudist);
     } // outgoing energies
 
+    // Precompute the ranges of the cumulative distribution so that the
+    // outgoing energy bin is sampled without a search
+    if (settings::correlated_alias) {
+      d.bins = CdfBinTable{d.c,
+        [&d](double r1, int& k, double& c_k, double& c_k1) {
+          find_bin(d, r1, k, c_k, c_k1);
+        }};
+    }
+
     distribution_.push_back(std::move(d));
   } // incoming energies
 }
 
+void CorrelatedAngleEnergy::find_bin(const CorrTable& d, double r1, int& k,
+  double& c_k, double& c_k1)
+{
+  int n_energy_out = d.e_out.size();
+  find_cdf_bin(d.c.data(), d.n_discrete, n_energy_out - 2, r1, k, c_k, c_k1);
+}
+
 void CorrelatedAngleEnergy::sample(double E_in, double& E_out, double& mu,
   uint64_t* seed) const
+{
+  EnergyContext context {E_in};
+  this->sample(context, E_out, mu, seed);
+}
+
+void CorrelatedAngleEnergy::sample(EnergyContext& E_in, double& E_out,
+  double& mu, uint64_t* seed) const
 {
   // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<< REMOVE THIS <<<<<<<<<<<<<<<<<<<<<<<<<<<<<
   // Before the secondary distribution refactor, an isotropic polar cosine was
@@ -165,19 +189,9 @@ void CorrelatedAngleEnergy::sample(double E_in, double& E_out, double& mu,
 
   // Find energy bin and calculate interpolation factor -- if the energy is
   // outside the range of the tabulated energies, choose the first or last bins
-  auto n_energy_in = energy_.size();
   int i;
   double r;
-  if (E_in < energy_[0]) {
-    i = 0;
-    r = 0.0;
-  } else if (E_in > energy_[n_energy_in - 1]) {
-    i = n_energy_in - 2;
-    r = 1.0;
-  } else {
-    i = lower_bound_index(energy_.begin(), energy_.end(), E_in);
-    r = (E_in - energy_[i]) / (energy_[i+1] - energy_[i]);
-  }
+  E_in.locate(energy_, i, r);
 
   // Sample between the ith and [i+1]th bin
   int l = r > prn(seed) ? i + 1 : i;
@@ -196,32 +210,21 @@ void CorrelatedAngleEnergy::sample(double E_in, double& E_out, double& mu,
   double E_1 = E_i_1 + r*(E_i1_1 - E_i_1);
   double E_K = E_i_K + r*(E_i1_K - E_i_K);
 
-  // Determine outgoing energy bin
-  n_energy_out = distribution_[l].e_out.size();
+  // Determine outgoing energy bin, either from the precomputed ranges of the
+  // cumulative distribution or by searching it
   n_discrete = distribution_[l].n_discrete;
-  double r1 = prn(seed);
-  double c_k = distribution_[l].c[0];
-  int k = 0;
-  int end = n_energy_out - 2;
-
-  // Discrete portion
-  for (int j = 0; j < n_discrete; ++j) {
-    k = j;
-    c_k = distribution_[l].c[k];
-    if (r1 < c_k) {
-      end = j;
-      break;
-    }
-  }
-
-  // Continuous portion
+  double r1;
+  double c_k;
   double c_k1;
-  for (int j = n_discrete; j < end; ++j) {
-    k = j;
-    c_k1 = distribution_[l].c[k+1];
-    if (r1 < c_k1) break;
-    k = j + 1;
-    c_k = c_k1;
+  int k;
+  if (!distribution_[l].bins.empty()) {
+    const auto& bin {distribution_[l].bins.sample(prn(seed), r1)};
+    k = bin.k;
+    c_k = bin.c_k;
+    c_k1 = bin.c_k1;
+  } else {
+    r1 = prn(seed);
+    find_bin(distribution_[l], r1, k, c_k, c_k1);
   }
 
   double E_l_k = distribution_[l].e_out[k];
@@ -114,6 +114,13 @@ KalbachMann::KalbachMann(hid_t group)
 }
 
 void KalbachMann::sample(double E_in, double& E_out, double& mu, uint64_t* seed) const
+{
+  EnergyContext context {E_in};
+  this->sample(context, E_out, mu, seed);
+}
+
+void KalbachMann::sample(EnergyContext& E_in, double& E_out, double& mu,
+  uint64_t* seed) const
 {
   // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<< REMOVE THIS <<<<<<<<<<<<<<<<<<<<<<<<<<<<<
   // Before the secondary distribution refactor, an isotropic polar cosine was
@@ -125,19 +132,9 @@ void KalbachMann::sample(double E_in, double& E_out, double& mu, uint64_t* seed)
 
   // Find energy bin and calculate interpolation factor -- if the energy is
   // outside the range of the tabulated energies, choose the first or last bins
-  auto n_energy_in = energy_.size();
   int i;
   double r;
-  if (E_in < energy_[0]) {
-    i = 0;
-    r = 0.0;
-  } else if (E_in > energy_[n_energy_in - 1]) {
-    i = n_energy_in - 2;
-    r = 1.0;
-  } else {
-    i = lower_bound_index(energy_.begin(), energy_.end(), E_in);
-    r = (E_in - energy_[i]) / (energy_[i+1] - energy_[i]);
-  }
+  E_in.locate(energy_, i, r);
 
   // Sample between the ith and [i+1]th bin
   int l = r > prn(seed) ? i + 1 : i;
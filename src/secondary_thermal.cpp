@@ -3,9 +3,11 @@
 #include "openmc/hdf5_interface.h"
 #include "openmc/random_lcg.h"
 #include "openmc/search.h"
+#include "openmc/settings.h"
 
 #include "xtensor/xview.hpp"
 
+#include <algorithm> // for copy, min
 #include <cmath> // for log, exp
 
 namespace openmc {
@@ -88,6 +90,11 @@ IncoherentElasticAEDiscrete::IncoherentElasticAEDiscrete(hid_t group,
   read_dataset(group, "mu_out", mu_out_);
 }
 
+std::size_t IncoherentElasticAEDiscrete::memory() const
+{
+  return mu_out_.size()*sizeof(double);
+}
+
 void
 IncoherentElasticAEDiscrete::sample(double E_in, double& E_out, double& mu,
   uint64_t* seed) const
@@ -144,6 +151,11 @@ IncoherentInelasticAEDiscrete::IncoherentInelasticAEDiscrete(hid_t group,
   read_dataset(group, "skewed", skewed_);
 }
 
+std::size_t IncoherentInelasticAEDiscrete::memory() const
+{
+  return (energy_out_.size() + mu_out_.size())*sizeof(double);
+}
+
 void
 IncoherentInelasticAEDiscrete::sample(double E_in, double& E_out, double& mu,
   uint64_t* seed) const
@@ -243,11 +255,41 @@ IncoherentInelasticAE::IncoherentInelasticAE(hid_t group)
       }
     }
 
+    // Precompute the ranges of the cumulative distribution so that the
+    // outgoing energy bin is sampled without a search
+    if (settings::thermal_alias) {
+      d.bins = CdfBinTable{d.e_out_cdf,
+        [&d](double r1, int& j, double& c_j, double& c_j1) {
+          find_bin(d, r1, j, c_j, c_j1);
+        }};
+    }
     distribution_.emplace_back(std::move(d));
   }
 
 }
 
+void
+IncoherentInelasticAE::find_bin(const DistEnergySab& d, double r1, int& j,
+  double& c_j, double& c_j1)
+{
+  // The search may run past the last bin at the end of the CDF, so make sure
+  // j is <= n_energy_out - 2
+  int n = d.n_e_out;
+  find_cdf_bin(d.e_out_cdf.data(), 0, n - 1, r1, j, c_j, c_j1);
+  j = std::min(j, n - 2);
+}
+
+std::size_t IncoherentInelasticAE::memory() const
+{
+  std::size_t n = energy_.size()*sizeof(double);
+  for (const auto& d : distribution_) {
+    n += (d.e_out.size() + d.e_out_pdf.size() + d.e_out_cdf.size() +
+      d.mu.size())*sizeof(double);
+    n += d.bins.memory();
+  }
+  return n;
+}
+
 void
 IncoherentInelasticAE::sample(double E_in, double& E_out, double& mu,
   uint64_t* seed) const
@@ -260,22 +302,22 @@ IncoherentInelasticAE::sample(double E_in, double& E_out, double& mu,
   // Pick closer energy based on interpolation factor
   int l = f > 0.5 ? i + 1 : i;
 
-  // Determine outgoing energy bin
-  // (First reset n_energy_out to the right value)
-  auto n = distribution_[l].n_e_out;
-  double r1 = prn(seed);
-  double c_j = distribution_[l].e_out_cdf[0];
+  // Determine outgoing energy bin, either from the precomputed ranges of the
+  // cumulative distribution or by searching it
+  double r1;
+  double c_j;
   double c_j1;
-  std::size_t j;
-  for (j = 0; j < n - 1; ++j) {
-    c_j1 = distribution_[l].e_out_cdf[j + 1];
-    if (r1 < c_j1) break;
-    c_j = c_j1;
+  int j;
+  if (!distribution_[l].bins.empty()) {
+    const auto& bin {distribution_[l].bins.sample(prn(seed), r1)};
+    j = bin.k;
+    c_j = bin.c_k;
+    c_j1 = bin.c_k1;
+  } else {
+    r1 = prn(seed);
+    find_bin(distribution_[l], r1, j, c_j, c_j1);
   }
 
-  // check to make sure j is <= n_energy_out - 2
-  j = std::min(j, n - 2);
-
   // Get the data to interpolate between
   double E_l_j = distribution_[l].e_out[j];
   double p_l_j = distribution_[l].e_out_pdf[j];
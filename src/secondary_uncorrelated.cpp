@@ -53,6 +53,14 @@ UncorrelatedAngleEnergy::UncorrelatedAngleEnergy(hid_t group)
 void
 UncorrelatedAngleEnergy::sample(double E_in, double& E_out, double& mu,
   uint64_t* seed) const
+{
+  EnergyContext context {E_in};
+  this->sample(context, E_out, mu, seed);
+}
+
+void
+UncorrelatedAngleEnergy::sample(EnergyContext& E_in, double& E_out, double& mu,
+  uint64_t* seed) const
 {
   // Sample cosine of scattering angle
   if (fission_) {
@@ -61,7 +69,7 @@ UncorrelatedAngleEnergy::sample(double E_in, double& E_out, double& mu,
     mu = 1.0;
     // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<< REMOVE THIS <<<<<<<<<<<<<<<<<<<<<<<<<<<<<
   } else if (!angle_.empty()) {
-    mu = angle_.sample(E_in, seed);
+    mu = angle_.sample(E_in.E(), seed);
   } else {
     // no angle distribution given => assume isotropic for all energies
     mu = 2.0*prn(seed) - 1.0;
@@ -10,23 +10,29 @@
 #endif
 
 #include "openmc/capi.h"
+#include "openmc/cmfd.h"
 #include "openmc/constants.h"
 #include "openmc/container_util.h"
 #include "openmc/distribution.h"
 #include "openmc/distribution_multi.h"
 #include "openmc/distribution_spatial.h"
+#include "openmc/domain_decomposition.h"
 #include "openmc/eigenvalue.h"
 #include "openmc/error.h"
 #include "openmc/file_utils.h"
 #include "openmc/mesh.h"
+#include "openmc/mesh_field.h"
 #include "openmc/message_passing.h"
 #include "openmc/output.h"
+#include "openmc/precursor.h"
 #include "openmc/random_lcg.h"
+#include "openmc/random_ray.h"
 #include "openmc/simulation.h"
 #include "openmc/source.h"
 #include "openmc/string_utils.h"
 #include "openmc/tallies/trigger.h"
 #include "openmc/volume_calc.h"
+#include "openmc/weight_windows.h"
 #include "openmc/xml_interface.h"
 
 namespace openmc {
@@ -38,43 +44,88 @@ namespace openmc {
 namespace settings {
 
 // Default values for boolean flags
+bool alias_sampling          {false};
 bool assume_separate         {false};
+bool async_statepoint        {false};
+bool async_summary           {false};
+bool azimuth_rejection       {false};
+bool broadcast_data          {false};
 bool check_overlaps          {false};
 bool cmfd_run                {false};
+bool compact_xs_cache        {false};
+bool compton_tables          {false};
 bool confidence_intervals    {false};
+bool correlated_alias        {false};
 bool create_fission_neutrons {true};
+bool cumulative_xs           {false};
 bool dagmc                   {false};
+bool dagmc_bvh               {false};
 bool delayed_photon_scaling  {true};
+bool delta_tracking          {false};
 bool entropy_on              {false};
 bool event_based             {false};
+bool event_batch_distance    {false};
+bool event_fuse_advance      {false};
+bool event_queue_sort        {false};
+bool event_refill            {false};
+bool flat_geometry           {false};
+bool instrument              {true};
+bool huge_pages              {false};
+bool interleaved_xs          {false};
+bool lazy_products           {false};
 bool legendre_to_tabular     {true};
+bool load_balance            {false};
 bool material_cell_offsets   {true};
+bool numa_interleave         {false};
 bool output_summary          {true};
 bool output_tallies          {true};
 bool particle_restart_run    {false};
+bool performance_report      {false};
+bool photon_material_tables  {false};
 bool photon_transport        {false};
+bool photon_xs_tables        {false};
+bool pipeline_tallies        {false};
+bool private_tallies         {false};
 bool reduce_tallies          {true};
 bool res_scat_on             {false};
 bool restart_run             {false};
+bool retain_data             {false};
+bool reuse_source            {false};
 bool run_CE                  {true};
+bool shared_bank             {false};
+bool shared_xs               {false};
+bool source_binary           {false};
+bool source_sort             {false};
 bool source_latest           {false};
 bool source_separate         {false};
 bool source_write            {true};
+bool statepoint_incremental  {false};
 bool survival_biasing        {false};
+bool tally_profiling         {false};
+bool temperature_cache       {false};
 bool temperature_multipole   {false};
+bool thermal_alias           {false};
+bool threaded_xs_read        {false};
+bool track_single_file       {false};
+bool trigger_freeze          {false};
 bool trigger_on              {false};
 bool trigger_predict         {false};
+bool tune_particles_in_flight {false};
 bool ufs_on                  {false};
 bool urr_ptables_on          {true};
+bool vectorize_multipole     {false};
+bool vectorize_xs            {false};
 bool write_all_tracks        {false};
 bool write_initial_source    {false};
 
 std::string path_cross_sections;
 std::string path_input;
+std::string path_neighbor_lists;
 std::string path_output;
 std::string path_particle_restart;
 std::string path_source;
 std::string path_source_library;
+std::string path_xs_cache;
 std::string path_sourcepoint;
 std::string path_statepoint;
 
@@ -84,12 +135,30 @@ int32_t max_lost_particles {10};
 double rel_max_lost_particles {1.0e-6};
 int32_t gen_per_batch {1};
 int64_t n_particles {-1};
+double particle_ramp {1.0};
+double event_memory_budget {1024.0};
 
 int64_t max_particles_in_flight {100000};
+int64_t event_queue_sort_threshold {20000};
+int64_t event_local_queue_length {0};
+int64_t event_prefetch_distance {0};
+int64_t private_tallies_max_size {1000000};
+int64_t max_surface_particles;
+int64_t max_census_particles {-1};
+int64_t max_secondaries {0};
 
 ElectronTreatment electron_treatment {ElectronTreatment::TTB};
+HistoryScheduler history_scheduler {HistoryScheduler::OPENMP};
+ThreadAffinity thread_affinity {ThreadAffinity::NONE};
+EventScheduler event_scheduler {EventScheduler::LONGEST_QUEUE};
+int64_t event_min_queue_length {0};
+int64_t event_history_threshold {0};
 std::array<double, 4> energy_cutoff {0.0, 1000.0, 0.0, 0.0};
+std::array<double, 4> time_cutoff {INFTY, INFTY, INFTY, INFTY};
+double census_time {INFTY};
+EnergySearch energy_search {EnergySearch::LOG_GRID};
 int legendre_to_tabular_points {C_NONE};
+int history_interleave {1};
 int max_order {0};
 int n_log_bins {8000};
 int n_max_batches;
@@ -99,11 +168,14 @@ double res_scat_energy_max {1000.0};
 std::vector<std::string> res_scat_nuclides;
 RunMode run_mode {RunMode::UNSET};
 std::unordered_set<int> sourcepoint_batch;
+std::unordered_set<int> source_write_surf_id;
 std::unordered_set<int> statepoint_batch;
+int tally_compression {0};
 TemperatureMethod temperature_method {TemperatureMethod::NEAREST};
 double temperature_tolerance {10.0};
 double temperature_default {293.6};
 std::array<double, 2> temperature_range {0.0, 0.0};
+double thinning_tolerance {0.0};
 int trace_batch;
 int trace_gen;
 int64_t trace_particle;
@@ -136,8 +208,22 @@ void get_run_parameters(pugi::xml_node node_base)
 
   // Get maximum number of in flight particles for event-based mode
   if (check_for_node(node_base, "max_particles_in_flight")) {
-    max_particles_in_flight = std::stoll(get_node_value(node_base,
-      "max_particles_in_flight"));
+    std::string value = get_node_value(node_base, "max_particles_in_flight",
+      true, true);
+    if (value == "auto") {
+      tune_particles_in_flight = true;
+    } else {
+      max_particles_in_flight = std::stoll(value);
+    }
+  }
+
+  // Get the memory available to particles in flight when it is tuned
+  if (check_for_node(node_base, "event_memory_budget")) {
+    event_memory_budget = std::stod(get_node_value(node_base,
+      "event_memory_budget"));
+    if (event_memory_budget <= 0.0) {
+      fatal_error("The event memory budget must be positive.");
+    }
   }
 
   // Get number of basic batches
@@ -165,6 +251,14 @@ void get_run_parameters(pugi::xml_node node_base)
       gen_per_batch = std::stoi(get_node_value(node_base, "generations_per_batch"));
     }
 
+    // Get the fraction of particles to start the inactive batches with
+    if (check_for_node(node_base, "particle_ramp")) {
+      particle_ramp = std::stod(get_node_value(node_base, "particle_ramp"));
+      if (particle_ramp <= 0.0 || particle_ramp > 1.0) {
+        fatal_error("Particle ramp must be greater than zero and at most one.");
+      }
+    }
+
     // Preallocate space for keff and entropy by generation
     int m = settings::n_max_batches * settings::gen_per_batch;
     simulation::k_generation.reserve(m);
@@ -226,7 +320,7 @@ void read_settings_xml()
 
   // Parse settings.xml file
   xml_document doc;
-  auto result = doc.load_file(filename.c_str());
+  auto result = load_xml_file(doc, filename);
   if (!result) {
     fatal_error("Error processing settings.xml file.");
   }
@@ -244,6 +338,15 @@ void read_settings_xml()
     dagmc = get_node_value_bool(root, "dagmc");
   }
 
+  if (check_for_node(root, "dagmc_bvh")) {
+    dagmc_bvh = get_node_value_bool(root, "dagmc_bvh");
+  }
+
+  // Flat copy of the CSG geometry
+  if (check_for_node(root, "flat_geometry")) {
+    flat_geometry = get_node_value_bool(root, "flat_geometry");
+  }
+
 #ifndef DAGMC
   if (dagmc) {
     fatal_error("DAGMC mode unsupported for this build of OpenMC");
@@ -313,6 +416,11 @@ void read_settings_xml()
           fatal_error("Trigger batch interval must be greater than zero");
         }
       }
+
+      // Whether tallies stop being scored once their triggers are satisfied
+      if (check_for_node(node_trigger, "freeze")) {
+        trigger_freeze = get_node_value_bool(node_trigger, "freeze");
+      }
     }
   }
 
@@ -379,6 +487,18 @@ void read_settings_xml()
     openmc_set_seed(seed);
   }
 
+  // Check for the pseudorandom number generator
+  if (check_for_node(root, "random_generator")) {
+    auto temp_str = get_node_value(root, "random_generator", true, true);
+    if (temp_str == "lcg") {
+      set_random_generator(RandomGenerator::lcg);
+    } else if (temp_str == "philox") {
+      set_random_generator(RandomGenerator::philox);
+    } else {
+      fatal_error("Unrecognized random number generator: " + temp_str);
+    }
+  }
+
   // Check for electron treatment
   if (check_for_node(root, "electron_treatment")) {
     auto temp_str = get_node_value(root, "electron_treatment", true, true);
@@ -386,6 +506,8 @@ void read_settings_xml()
       electron_treatment = ElectronTreatment::LED;
     } else if (temp_str == "ttb") {
       electron_treatment = ElectronTreatment::TTB;
+    } else if (temp_str == "ch") {
+      electron_treatment = ElectronTreatment::CH;
     } else {
       fatal_error("Unrecognized electron treatment: " + temp_str + ".");
     }
@@ -410,12 +532,30 @@ void read_settings_xml()
     }
   }
 
+  // Method for energy grid searches
+  if (check_for_node(root, "energy_search")) {
+    auto temp = get_node_value(root, "energy_search", true, true);
+    if (temp == "log-grid") {
+      energy_search = EnergySearch::LOG_GRID;
+    } else if (temp == "hashed") {
+      energy_search = EnergySearch::HASHED;
+    } else {
+      fatal_error("Unrecognized energy search method: " + temp);
+    }
+  }
+
   // Number of OpenMP threads
   if (check_for_node(root, "threads")) {
     if (mpi::master) warning("The <threads> element has been deprecated. Use "
       "the OMP_NUM_THREADS environment variable to set the number of threads.");
   }
 
+  // Check whether large discrete and tabular distributions, including those of
+  // the sources below, should be sampled with alias tables
+  if (check_for_node(root, "alias_sampling")) {
+    alias_sampling = get_node_value_bool(root, "alias_sampling");
+  }
+
   // ==========================================================================
   // EXTERNAL SOURCE
 
@@ -474,6 +614,18 @@ void read_settings_xml()
     if (check_for_node(node_cutoff, "energy_positron")) {
       energy_cutoff[3] = std::stod(get_node_value(node_cutoff, "energy_positron"));
     }
+    if (check_for_node(node_cutoff, "time_neutron")) {
+      time_cutoff[0] = std::stod(get_node_value(node_cutoff, "time_neutron"));
+    }
+    if (check_for_node(node_cutoff, "time_photon")) {
+      time_cutoff[1] = std::stod(get_node_value(node_cutoff, "time_photon"));
+    }
+    if (check_for_node(node_cutoff, "time_electron")) {
+      time_cutoff[2] = std::stod(get_node_value(node_cutoff, "time_electron"));
+    }
+    if (check_for_node(node_cutoff, "time_positron")) {
+      time_cutoff[3] = std::stod(get_node_value(node_cutoff, "time_positron"));
+    }
   }
 
   // Particle trace
@@ -506,6 +658,11 @@ void read_settings_xml()
     }
   }
 
+  // Check whether the tracks of all particles go to a single file
+  if (check_for_node(root, "track_single_file")) {
+    track_single_file = get_node_value_bool(root, "track_single_file");
+  }
+
   // Read meshes
   read_meshes(root);
 
@@ -594,6 +751,30 @@ void read_settings_xml()
     ufs_on = true;
   }
 
+  // Coarse mesh finite difference acceleration of the fission source
+  if (check_for_node(root, "cmfd")) {
+    simulation::cmfd_accelerator =
+      std::make_unique<CmfdAccelerator>(root.child("cmfd"));
+  }
+
+  // Mesh-based weight windows
+  read_weight_windows(root);
+
+  // Temperatures and densities given on meshes overlaying cells
+  read_mesh_fields(root);
+
+  // Mesh on which delayed neutron precursors are tallied
+  read_precursor_mesh(root);
+
+  // Mesh whose bins are divided among the processes for particle tracking
+  read_domain_mesh(root);
+
+  // Random ray solver replacing particle transport
+  if (check_for_node(root, "random_ray")) {
+    simulation::random_ray =
+      std::make_unique<RandomRaySolver>(root.child("random_ray"));
+  }
+
   // Check if the user has specified to write state points
   if (check_for_node(root, "state_point")) {
 
@@ -611,6 +792,11 @@ void read_settings_xml()
       // If neither were specified, write state point at last batch
       statepoint_batch.insert(n_batches);
     }
+
+    // Check whether only the changes of tally results are written
+    if (check_for_node(node_sp, "incremental")) {
+      statepoint_incremental = get_node_value_bool(node_sp, "incremental");
+    }
   } else {
     // If no <state_point> tag was present, by default write state point at
     // last batch only
@@ -645,6 +831,14 @@ void read_settings_xml()
       source_latest = get_node_value_bool(node_sp, "overwrite_latest");
       source_separate = source_latest;
     }
+    if (check_for_node(node_sp, "format")) {
+      std::string format = get_node_value(node_sp, "format", true, true);
+      if (format == "binary") {
+        source_binary = true;
+      } else if (format != "hdf5") {
+        fatal_error("Unknown source point format: " + format);
+      }
+    }
   } else {
     // If no <source_point> tag was present, by default we keep source bank in
     // statepoint file and write it out at statepoints intervals
@@ -663,12 +857,65 @@ void read_settings_xml()
     }
   }
 
+  // Check if the user has specified surfaces whose crossings are recorded as a
+  // surface source
+  if (check_for_node(root, "surf_source_write")) {
+    xml_node node_ssw = root.child("surf_source_write");
+    if (!check_for_node(node_ssw, "surface_ids")) {
+      fatal_error("Must specify the surfaces of the surface source with "
+        "<surface_ids>.");
+    }
+    for (int id : get_node_array<int>(node_ssw, "surface_ids")) {
+      source_write_surf_id.insert(id);
+    }
+
+    // By default, as many sites as particles in a batch may be recorded
+    max_surface_particles = n_particles;
+    if (check_for_node(node_ssw, "max_particles")) {
+      max_surface_particles = std::stoll(get_node_value(node_ssw,
+        "max_particles"));
+      if (max_surface_particles <= 0) {
+        fatal_error("Maximum number of surface source sites must be "
+          "positive.");
+      }
+    }
+  }
+
+  // Check if particles are banked at a census time to continue from in the
+  // next time step
+  if (check_for_node(root, "census")) {
+    xml_node node_census = root.child("census");
+    if (!check_for_node(node_census, "time")) {
+      fatal_error("Must specify the census time with <time>.");
+    }
+    census_time = std::stod(get_node_value(node_census, "time"));
+    if (census_time <= 0.0) {
+      fatal_error("Census time must be positive.");
+    }
+
+    // By default, the bank holds a site for each particle of every active
+    // batch, which is determined once the work of each process is known
+    max_census_particles = -1;
+    if (check_for_node(node_census, "max_particles")) {
+      max_census_particles = std::stoll(get_node_value(node_census,
+        "max_particles"));
+      if (max_census_particles <= 0) {
+        fatal_error("Maximum number of census sites must be positive.");
+      }
+    }
+  }
+
   // Check if the user has specified to not reduce tallies at the end of every
   // batch
   if (check_for_node(root, "no_reduce")) {
     reduce_tallies = get_node_value_bool(root, "no_reduce");
   }
 
+  // Check whether to use compact microscopic cross section caches
+  if (check_for_node(root, "compact_xs_cache")) {
+    compact_xs_cache = get_node_value_bool(root, "compact_xs_cache");
+  }
+
   // Check if the user has specified to use confidence intervals for
   // uncertainties rather than standard deviations
   if (check_for_node(root, "confidence_intervals")) {
@@ -771,12 +1018,23 @@ void read_settings_xml()
   if (check_for_node(root, "temperature_multipole")) {
     temperature_multipole = get_node_value_bool(root, "temperature_multipole");
   }
+  if (check_for_node(root, "temperature_cache")) {
+    temperature_cache = get_node_value_bool(root, "temperature_cache");
+  }
   if (check_for_node(root, "temperature_range")) {
     auto range = get_node_array<double>(root, "temperature_range");
     temperature_range[0] = range.at(0);
     temperature_range[1] = range.at(1);
   }
 
+  // Fractional tolerance for removing energy points of cross sections
+  if (check_for_node(root, "thinning_tolerance")) {
+    thinning_tolerance = std::stod(get_node_value(root, "thinning_tolerance"));
+    if (thinning_tolerance < 0.0) {
+      fatal_error("The thinning tolerance must not be negative.");
+    }
+  }
+
   // Check for tabular_legendre options
   if (check_for_node(root, "tabular_legendre")) {
     // Get pointer to tabular_legendre node
@@ -805,16 +1063,313 @@ void read_settings_xml()
     }
   }
 
+  // Number of secondary sites a history may bank before they are combed
+  if (check_for_node(root, "max_secondaries")) {
+    max_secondaries = std::stoll(get_node_value(root, "max_secondaries"));
+    if (max_secondaries < 2) {
+      fatal_error("The maximum number of secondary particles must be at "
+        "least two.");
+    }
+  }
+
+  // Check whether kernel regions should be reported to profilers
+  if (check_for_node(root, "instrument")) {
+    instrument = get_node_value_bool(root, "instrument");
+  }
+
+  // Check whether to store nuclide cross sections interleaved with energies
+  if (check_for_node(root, "interleaved_xs")) {
+    interleaved_xs = get_node_value_bool(root, "interleaved_xs");
+  }
+
+  // Statepoint file from which the neighbor lists of the cells are read
+  if (check_for_node(root, "neighbor_lists")) {
+    path_neighbor_lists = get_node_value(root, "neighbor_lists");
+  }
+
+  // Directory in which derived nuclide cross sections are cached
+  if (check_for_node(root, "xs_cache")) {
+    path_xs_cache = get_node_value(root, "xs_cache");
+    if (!ends_with(path_xs_cache, "/")) {
+      path_xs_cache += "/";
+    }
+  }
+
+  // Check whether nuclear data files are read by the master process only
+  if (check_for_node(root, "broadcast_data")) {
+    broadcast_data = get_node_value_bool(root, "broadcast_data");
+  }
+
+  // Check whether to read nuclear data with multiple threads
+  if (check_for_node(root, "threaded_xs_read")) {
+    threaded_xs_read = get_node_value_bool(root, "threaded_xs_read");
+  }
+
+  // Check whether to defer reading secondary angle-energy distributions
+  if (check_for_node(root, "lazy_products")) {
+    lazy_products = get_node_value_bool(root, "lazy_products");
+  }
+
+  // Deferred products would be read from disk by every process once the
+  // broadcast images of the files are released, so they are read up front
+  if (lazy_products && broadcast_data && mpi::n_procs > 1) {
+    if (mpi::master) {
+      warning("Secondary distributions are read when nuclear data is loaded "
+        "since nuclear data files are broadcast from the master process.");
+    }
+    lazy_products = false;
+  }
+
+  // Check whether to share sites sampled for the source among ranks on a node
+  if (check_for_node(root, "shared_bank")) {
+    shared_bank = get_node_value_bool(root, "shared_bank");
+  }
+
+  // Check whether to order source sites along a space-filling curve
+  if (check_for_node(root, "source_sort")) {
+    source_sort = get_node_value_bool(root, "source_sort");
+  }
+
+  // Check whether to keep nuclear data loaded for the next simulation in the
+  // same process
+  if (check_for_node(root, "retain_data")) {
+    retain_data = get_node_value_bool(root, "retain_data");
+  }
+
+  // Check whether to share nuclide cross sections among ranks on a node
+  if (check_for_node(root, "shared_xs")) {
+    shared_xs = get_node_value_bool(root, "shared_xs");
+  }
+
+  // Check whether to evaluate the Faddeeva function of multipole poles in
+  // batches with a SIMD rational approximation
+  if (check_for_node(root, "vectorize_multipole")) {
+    vectorize_multipole = get_node_value_bool(root, "vectorize_multipole");
+  }
+
+  // Check whether to sample Compton scattering from precomputed tables
+  if (check_for_node(root, "compton_tables")) {
+    compton_tables = get_node_value_bool(root, "compton_tables");
+  }
+
+  // Check whether to back nuclear data and tallies with huge pages
+  if (check_for_node(root, "huge_pages")) {
+    huge_pages = get_node_value_bool(root, "huge_pages");
+  }
+
+  // Check whether to interleave nuclear data and tallies among NUMA nodes
+  if (check_for_node(root, "numa_interleave")) {
+    numa_interleave = get_node_value_bool(root, "numa_interleave");
+  }
+
+  // Check whether to tabulate macroscopic photon cross sections of materials
+  if (check_for_node(root, "photon_material_tables")) {
+    photon_material_tables = get_node_value_bool(root,
+      "photon_material_tables");
+  }
+
+  // Check whether to tabulate photon cross sections for linear interpolation
+  if (check_for_node(root, "photon_xs_tables")) {
+    photon_xs_tables = get_node_value_bool(root, "photon_xs_tables");
+  }
+
+  // Check whether to sample correlated outgoing energies with alias tables
+  if (check_for_node(root, "correlated_alias")) {
+    correlated_alias = get_node_value_bool(root, "correlated_alias");
+  }
+
+  // Check whether to sample thermal scattering energies with alias tables
+  if (check_for_node(root, "thermal_alias")) {
+    thermal_alias = get_node_value_bool(root, "thermal_alias");
+  }
+
+  // Check whether to store cumulative cross sections for collision sampling
+  if (check_for_node(root, "cumulative_xs")) {
+    cumulative_xs = get_node_value_bool(root, "cumulative_xs");
+  }
+
+  // Check whether to form macroscopic cross sections with a SIMD reduction
+  if (check_for_node(root, "vectorize_xs")) {
+    vectorize_xs = get_node_value_bool(root, "vectorize_xs");
+  }
+
   // Check whether to scale fission photon yields
   if (check_for_node(root, "delayed_photon_scaling")) {
     delayed_photon_scaling = get_node_value_bool(root, "delayed_photon_scaling");
   }
 
+  // Policy for distributing histories among threads in history-based mode
+  if (check_for_node(root, "history_scheduler")) {
+    auto temp = get_node_value(root, "history_scheduler", true, true);
+    if (temp == "openmp") {
+      history_scheduler = HistoryScheduler::OPENMP;
+    } else if (temp == "work-stealing") {
+      history_scheduler = HistoryScheduler::WORK_STEALING;
+    } else {
+      fatal_error("Unrecognized history scheduler: " + temp);
+    }
+  }
+
+  // Placement of OpenMP threads on the CPUs of the node
+  if (check_for_node(root, "thread_affinity")) {
+    auto temp = get_node_value(root, "thread_affinity", true, true);
+    if (temp == "none") {
+      thread_affinity = ThreadAffinity::NONE;
+    } else if (temp == "compact") {
+      thread_affinity = ThreadAffinity::COMPACT;
+    } else if (temp == "spread") {
+      thread_affinity = ThreadAffinity::SPREAD;
+    } else if (temp == "numa") {
+      thread_affinity = ThreadAffinity::NUMA;
+    } else {
+      fatal_error("Unrecognized thread affinity: " + temp);
+    }
+  }
+
+  // Number of histories each thread interleaves in history-based mode
+  if (check_for_node(root, "history_interleave")) {
+    history_interleave = std::stoi(get_node_value(root, "history_interleave"));
+    if (history_interleave < 1) {
+      fatal_error("Number of interleaved histories must be positive.");
+    }
+  }
+
   // Check whether to use event-based parallelism
   if (check_for_node(root, "event_based")) {
     event_based = get_node_value_bool(root, "event_based");
   }
 
+  // Check whether to sort the event-based cross section lookup queues
+  if (check_for_node(root, "event_queue_sort")) {
+    event_queue_sort = get_node_value_bool(root, "event_queue_sort");
+  }
+  if (check_for_node(root, "event_queue_sort_threshold")) {
+    event_queue_sort_threshold = std::stoll(get_node_value(root,
+      "event_queue_sort_threshold"));
+    if (event_queue_sort_threshold < 0) {
+      fatal_error("Event queue sort threshold must be non-negative.");
+    }
+  }
+
+  // Check whether to use delta tracking throughout the geometry
+  if (check_for_node(root, "delta_tracking")) {
+    delta_tracking = get_node_value_bool(root, "delta_tracking");
+  }
+
+  // Check whether to compute boundary distances for batches of particles
+  if (check_for_node(root, "event_batch_distance")) {
+    event_batch_distance = get_node_value_bool(root, "event_batch_distance");
+  }
+
+  // Check whether to execute crossings and collisions in the advance kernel
+  if (check_for_node(root, "event_fuse_advance")) {
+    event_fuse_advance = get_node_value_bool(root, "event_fuse_advance");
+  }
+
+  // Check whether to refill the event-based particle buffer as particles die
+  if (check_for_node(root, "event_refill")) {
+    event_refill = get_node_value_bool(root, "event_refill");
+  }
+
+  // Policy for choosing which event kernel to run next
+  if (check_for_node(root, "event_scheduler")) {
+    auto temp = get_node_value(root, "event_scheduler", true, true);
+    if (temp == "longest") {
+      event_scheduler = EventScheduler::LONGEST_QUEUE;
+    } else if (temp == "round-robin") {
+      event_scheduler = EventScheduler::ROUND_ROBIN;
+    } else {
+      fatal_error("Unrecognized event scheduler: " + temp);
+    }
+  }
+  if (check_for_node(root, "event_min_queue_length")) {
+    event_min_queue_length = std::stoll(get_node_value(root,
+      "event_min_queue_length"));
+    if (event_min_queue_length < 0) {
+      fatal_error("Event minimum queue length must be non-negative.");
+    }
+  }
+  if (check_for_node(root, "event_history_threshold")) {
+    event_history_threshold = std::stoll(get_node_value(root,
+      "event_history_threshold"));
+    if (event_history_threshold < 0) {
+      fatal_error("Event history threshold must be non-negative.");
+    }
+  }
+
+  // Check whether to stage event queue appends in thread-local buffers
+  if (check_for_node(root, "event_local_queue_length")) {
+    event_local_queue_length = std::stoll(get_node_value(root,
+      "event_local_queue_length"));
+    if (event_local_queue_length < 0) {
+      fatal_error("Event local queue length must be non-negative.");
+    }
+  }
+
+  // Check how far ahead in the event queue cross section data is prefetched
+  if (check_for_node(root, "event_prefetch_distance")) {
+    event_prefetch_distance = std::stoll(get_node_value(root,
+      "event_prefetch_distance"));
+    if (event_prefetch_distance < 0) {
+      fatal_error("Event prefetch distance must be non-negative.");
+    }
+  }
+
+  // Check whether to score tallies in thread-private buffers
+  if (check_for_node(root, "private_tallies")) {
+    private_tallies = get_node_value_bool(root, "private_tallies");
+  }
+  if (check_for_node(root, "private_tallies_max_size")) {
+    private_tallies_max_size = std::stoll(get_node_value(root,
+      "private_tallies_max_size"));
+    if (private_tallies_max_size < 0) {
+      fatal_error("Maximum size of private tallies must be non-negative.");
+    }
+  }
+
+  // Check whether tally reduction should overlap with the next batch
+  if (check_for_node(root, "pipeline_tallies")) {
+    pipeline_tallies = get_node_value_bool(root, "pipeline_tallies");
+  }
+
+  // Check whether a machine-readable performance report should be written
+  if (check_for_node(root, "performance_report")) {
+    performance_report = get_node_value_bool(root, "performance_report");
+  }
+
+  // Check whether the cost of scoring each tally should be measured
+  if (check_for_node(root, "tally_profiling")) {
+    tally_profiling = get_node_value_bool(root, "tally_profiling");
+  }
+
+  // Get the compression level of tally results in state points
+  if (check_for_node(root, "tally_compression")) {
+    tally_compression = std::stoi(get_node_value(root, "tally_compression"));
+    if (tally_compression < 0 || tally_compression > 9) {
+      fatal_error("Tally compression level must be between 0 and 9.");
+    }
+  }
+
+  // Check whether state points should be written on a background thread
+  if (check_for_node(root, "async_statepoint")) {
+    async_statepoint = get_node_value_bool(root, "async_statepoint");
+  }
+
+  // Check whether the summary should be written on a background thread
+  if (check_for_node(root, "async_summary")) {
+    async_summary = get_node_value_bool(root, "async_summary");
+  }
+
+  // Check whether azimuthal angles should be sampled by rejection
+  if (check_for_node(root, "azimuth_rejection")) {
+    azimuth_rejection = get_node_value_bool(root, "azimuth_rejection");
+  }
+
+  // Check whether work should be balanced among processes by their throughput
+  if (check_for_node(root, "load_balance")) {
+    load_balance = get_node_value_bool(root, "load_balance");
+  }
+
   // Check whether material cell offsets should be generated
   if (check_for_node(root, "material_cell_offsets")) {
     material_cell_offsets = get_node_value_bool(root, "material_cell_offsets");
@@ -824,7 +1379,10 @@ void read_settings_xml()
 void free_memory_settings() {
   settings::statepoint_batch.clear();
   settings::sourcepoint_batch.clear();
+  settings::source_write_surf_id.clear();
   settings::res_scat_nuclides.clear();
+  simulation::cmfd_accelerator.reset();
+  simulation::random_ray.reset();
 }
 
 } // namespace openmc
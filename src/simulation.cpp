@@ -2,27 +2,38 @@
 
 #include "openmc/bank.h"
 #include "openmc/capi.h"
+#include "openmc/cell.h"
+#include "openmc/cmfd.h"
 #include "openmc/container_util.h"
+#include "openmc/delta_tracking.h"
+#include "openmc/domain_decomposition.h"
 #include "openmc/eigenvalue.h"
 #include "openmc/error.h"
 #include "openmc/event.h"
 #include "openmc/geometry_aux.h"
 #include "openmc/material.h"
+#include "openmc/memory_placement.h"
+#include "openmc/mesh.h"
 #include "openmc/message_passing.h"
 #include "openmc/nuclide.h"
 #include "openmc/output.h"
+#include "openmc/performance.h"
 #include "openmc/particle.h"
 #include "openmc/photon.h"
+#include "openmc/precursor.h"
 #include "openmc/random_lcg.h"
+#include "openmc/random_ray.h"
 #include "openmc/settings.h"
 #include "openmc/source.h"
 #include "openmc/state_point.h"
+#include "openmc/summary.h"
 #include "openmc/timer.h"
 #include "openmc/tallies/derivative.h"
 #include "openmc/tallies/filter.h"
 #include "openmc/tallies/tally.h"
 #include "openmc/tallies/trigger.h"
 #include "openmc/track_output.h"
+#include "openmc/work_stealing.h"
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -34,8 +45,20 @@
 #endif
 
 #include <algorithm>
+#include <cmath> // for llround, pow
+#include <numeric> // for accumulate
 #include <string>
 
+#include <fmt/core.h>
+
+namespace openmc {
+namespace {
+
+//! Whether the number of particles in flight is still to be tuned
+bool tuning_pending {false};
+
+} // namespace
+} // namespace openmc
 
 //==============================================================================
 // C API functions
@@ -69,29 +92,85 @@ int openmc_simulation_init()
   if (simulation::initialized) return 0;
 
   // Determine how much work each process should do
+  simulation::n_particles_batch = particles_in_batch(1);
   calculate_work();
 
+  // The source bank left by a previous eigenvalue simulation, which holds the
+  // source of its next generation, can be reused if it is divided among
+  // processes in the same way
+  bool reuse_source = settings::reuse_source && !settings::restart_run &&
+    settings::run_mode == RunMode::EIGENVALUE &&
+    simulation::source_bank.size() == simulation::work_per_rank;
+
   // Allocate source and fission banks for eigenvalue simulations
   if (settings::run_mode == RunMode::EIGENVALUE) {
     allocate_banks();
   }
 
+  // Allocate the bank of particles reaching the census time during all active
+  // batches
+  if (settings::census_time < INFTY) {
+    int64_t n = settings::max_census_particles;
+    if (n < 0) {
+      n = simulation::work_per_rank *
+        (settings::n_max_batches - settings::n_inactive);
+    }
+    simulation::census_bank.reserve(n);
+    simulation::census_bank.resize(0);
+    simulation::n_census_discarded = 0;
+  }
+
   // If doing an event-based simulation, intialize the particle buffer
   // and event queues
   if (settings::event_based) {
+    // When the number of particles in flight is tuned, the buffers are first
+    // sized for the most particles that fit in the memory budget
+    if (settings::tune_particles_in_flight) {
+      settings::max_particles_in_flight = std::max<int64_t>(1,
+        settings::event_memory_budget*1024.0*1024.0 / particle_buffer_bytes());
+      tuning_pending = true;
+    }
     int64_t event_buffer_length = std::min(simulation::work_per_rank,
       settings::max_particles_in_flight);
     init_event_queues(event_buffer_length);
   }
 
-  // Allocate tally results arrays if they're not allocated yet
-  for (auto& t : model::tallies) {
-    t->init_results();
+  // Domains are needed to divide the results of decomposed tallies along them
+  init_domain_decomposition();
+
+  // Allocate tally results arrays if they're not allocated yet. They are
+  // zeroed by the master thread but scored into by all of them, so their
+  // pages are interleaved among NUMA nodes if requested.
+  {
+    InterleaveScope interleave;
+    for (auto& t : model::tallies) {
+      t->init_results();
+    }
   }
+  advise_tallies();
+  if (simulation::random_ray) simulation::random_ray->check_tallies();
+  init_precursor_tallies();
 
-  // Set up material nuclide index mapping
-  for (auto& mat : model::materials) {
+  // Specialize the cross section lookups for the data that was loaded
+  for (auto& nuc : data::nuclides) {
+    nuc->init_calculate_xs();
+  }
+
+  // Set up material nuclide index mapping, unionized energy grids and photon
+  // cross section tables. With domain decomposition, the grids and tables are
+  // only built for the materials in the domain of this process.
+  for (int i = 0; i < model::materials.size(); ++i) {
+    auto& mat {model::materials[i]};
     mat->init_nuclide_index();
+    if (!domain_has_material(i)) continue;
+    mat->init_union_grid();
+    mat->init_photon_tables();
+    mat->init_xs_table();
+  }
+
+  // Precompute nuclide temperature indices for each cell instance
+  for (auto& c : model::cells) {
+    c->update_nuclide_temperature();
   }
 
   // Reset global variables -- this is done before loading state point (as that
@@ -99,7 +178,7 @@ int openmc_simulation_init()
   simulation::current_batch = 0;
   simulation::k_generation.clear();
   simulation::entropy.clear();
-  simulation::need_depletion_rx = false;
+  simulation::time_batches.clear();
   openmc_reset();
 
   // If this is a restart run, load the state point data and binary source
@@ -107,6 +186,8 @@ int openmc_simulation_init()
   if (settings::restart_run) {
     load_state_point();
     write_message("Resuming simulation...", 6);
+  } else if (reuse_source) {
+    write_message("Reusing the source of the previous simulation...", 6);
   } else {
     // Only initialize primary source bank for eigenvalue simulations
     if (settings::run_mode == RunMode::EIGENVALUE) {
@@ -120,6 +201,16 @@ int openmc_simulation_init()
     load_custom_source_library();
   }
 
+  // If fixed source from a source file, read the sites to sample from
+  if (settings::run_mode == RunMode::FIXED_SOURCE &&
+      !settings::path_source.empty()) {
+    load_source_file();
+  }
+
+  // Show the memory used once cross sections are read and banks, particle
+  // buffers and tally results are allocated
+  print_memory_usage();
+
   // Display header
   if (mpi::master) {
     if (settings::run_mode == RunMode::FIXED_SOURCE) {
@@ -130,6 +221,10 @@ int openmc_simulation_init()
     }
   }
 
+  // Write the summary, or the parts of it that changed since the last
+  // simulation
+  if (mpi::master && settings::output_summary) update_summary();
+
   // Set flag indicating initialization is done
   simulation::initialized = true;
   return 0;
@@ -142,6 +237,24 @@ int openmc_simulation_finalize()
   // Skip if simulation was never run
   if (!simulation::initialized) return 0;
 
+  // Make sure the last state point has been written
+  wait_state_point();
+
+  // Results of a restarted run that ended without running any batch
+  read_tally_results_pending();
+
+  // A later simulation starts over with full state points
+  reset_incremental_state_points();
+
+  // Write the sites recorded on the surfaces of the surface source
+  if (!settings::source_write_surf_id.empty()) write_surface_source();
+
+  // Write the particles that reached the census time
+  if (settings::census_time < INFTY) write_census();
+
+  // Write the remaining tracks of the particles
+  if (settings::track_single_file) close_track_file();
+
   // Stop active batch timer and start finalization timer
   simulation::time_active.stop();
   simulation::time_finalize.start();
@@ -155,9 +268,13 @@ int openmc_simulation_finalize()
   simulation::total_gen += simulation::current_batch*settings::gen_per_batch;
 
 #ifdef OPENMC_MPI
+  finish_tally_reductions();
   broadcast_results();
 #endif
 
+  // Precursors produced by the simulation, for advancing their populations
+  finalize_precursor_tallies();
+
   // Write tally results to tallies.out
   if (settings::output_tallies && mpi::master) write_tallies();
 
@@ -175,14 +292,28 @@ int openmc_simulation_finalize()
   // Stop timers and show timing statistics
   simulation::time_finalize.stop();
   simulation::time_total.stop();
+  gather_batch_times();
+  if (settings::performance_report) write_performance_report();
   if (mpi::master) {
     if (settings::verbosity >= 6) print_runtime();
     if (settings::verbosity >= 4) print_results();
   }
   if (settings::check_overlaps) print_overlap_check();
+  if (settings::tally_profiling) print_tally_profiles();
+  print_memory_usage();
+
+  // Results are slightly biased by steps sampled before a majorant was raised
+  int64_t n_exceeded = simulation::n_majorant_exceeded;
+#ifdef OPENMC_MPI
+  MPI_Reduce(&simulation::n_majorant_exceeded, &n_exceeded, 1, MPI_INT64_T,
+    MPI_SUM, 0, mpi::intracomm);
+#endif
+  if (mpi::master && n_exceeded > 0) {
+    warning(fmt::format("Cross sections exceeded the majorant used for delta "
+      "tracking {} times.", n_exceeded));
+  }
 
   // Reset flags
-  simulation::need_depletion_rx = false;
   simulation::initialized = false;
   return 0;
 }
@@ -199,6 +330,7 @@ int openmc_next_batch(int* status)
   }
 
   initialize_batch();
+  double time_transport = simulation::time_transport.elapsed();
 
   // =======================================================================
   // LOOP OVER GENERATIONS
@@ -210,7 +342,11 @@ int openmc_next_batch(int* status)
     simulation::time_transport.start();
 
     // Transport loop
-    if (settings::event_based) {
+    if (simulation::random_ray) {
+      simulation::random_ray->transport();
+    } else if (domain_decomposed()) {
+      transport_domain_decomposed();
+    } else if (settings::event_based) {
       transport_event_based();
     } else {
       transport_history_based();
@@ -222,6 +358,7 @@ int openmc_next_batch(int* status)
     finalize_generation();
   }
 
+  record_batch_time(simulation::time_transport.elapsed() - time_transport);
   finalize_batch();
 
   // Check simulation ending criteria
@@ -237,6 +374,25 @@ int openmc_next_batch(int* status)
   return 0;
 }
 
+int openmc_add_batch_callback(void (*callback)(int batch, void* data),
+  void* data)
+{
+  using namespace openmc;
+
+  if (!callback) {
+    set_errmsg("No batch callback given.");
+    return OPENMC_E_INVALID_ARGUMENT;
+  }
+  simulation::batch_callbacks.push_back({callback, data});
+  return 0;
+}
+
+int openmc_clear_batch_callbacks()
+{
+  openmc::simulation::batch_callbacks.clear();
+  return 0;
+}
+
 bool openmc_is_statepoint_batch() {
   using namespace openmc;
   using openmc::simulation::current_gen;
@@ -265,19 +421,21 @@ double k_col_tra {0.0};
 double k_abs_tra {0.0};
 double log_spacing;
 int n_lost_particles {0};
-bool need_depletion_rx {false};
 int restart_batch;
 bool satisfy_triggers {false};
 int total_gen {0};
 double total_weight;
 int64_t work_per_rank;
+int64_t n_particles_batch;
 
 const RegularMesh* entropy_mesh {nullptr};
 const RegularMesh* ufs_mesh {nullptr};
 
+std::vector<double> history_cost;
 std::vector<double> k_generation;
 std::vector<int64_t> work_index;
 
+std::vector<BatchCallback> batch_callbacks;
 
 } // namespace simulation
 
@@ -291,6 +449,10 @@ void allocate_banks()
   simulation::source_bank.resize(simulation::work_per_rank);
   // Allocate fission bank
   init_fission_bank(3*simulation::work_per_rank);
+  // Allocate surface source bank
+  if (!settings::source_write_surf_id.empty()) {
+    simulation::surf_source_bank.reserve(settings::max_surface_particles);
+  }
 }
 
 void initialize_batch()
@@ -325,6 +487,18 @@ void initialize_batch()
     simulation::time_active.start();
     for (auto& t : model::tallies) {
       t->active_ = true;
+      t->frozen_ = false;
+    }
+
+    // CMFD feedback is only applied during inactive batches
+    if (simulation::cmfd_accelerator) {
+      simulation::cmfd_accelerator->deactivate_tallies();
+    }
+
+    // Order neighbor lists by how often each neighbor was found during the
+    // inactive batches
+    for (auto& c : model::cells) {
+      c->neighbors_.freeze();
     }
   }
 
@@ -334,19 +508,54 @@ void initialize_batch()
 
 void finalize_batch()
 {
+  // Histories that did not end in event_death(), e.g. those that left the
+  // domain of this process, may have left surface source sites in the buffer
+  // of their thread
+  if (!settings::source_write_surf_id.empty()) {
+    #pragma omp parallel
+    flush_surface_source();
+  }
+
   // Reduce tallies onto master process and accumulate
   simulation::time_tallies.start();
   accumulate_tallies();
   simulation::time_tallies.stop();
 
+  // Let coupled codes and monitors look at the results of this batch, which
+  // are available in memory through the C API
+  for (const auto& cb : simulation::batch_callbacks) {
+    cb.func(simulation::current_batch, cb.data);
+  }
+
+  // Write the tracks of the particles of this batch
+  if (settings::track_single_file) write_particle_tracks();
+
+  // Adjust the source of the next batch with CMFD feedback, which needs the
+  // tallies of this batch to have been accumulated
+  if (simulation::cmfd_accelerator &&
+      settings::run_mode == RunMode::EIGENVALUE) {
+    simulation::cmfd_accelerator->apply_feedback();
+  }
+
+  // Divide elements of adaptive meshes based on the active batches so far
+  if (simulation::current_batch > settings::n_inactive) {
+    refine_adaptive_meshes();
+  }
+
   // Reset global tally results
   if (simulation::current_batch <= settings::n_inactive) {
     xt::view(simulation::global_tallies, xt::all()) = 0.0;
     simulation::n_realizations = 0;
   }
 
+  // Triggers need the results of the current batch, so pipelined reductions
+  // only complete early in the batches they are checked
+#ifdef OPENMC_MPI
+  if (triggers_due()) finish_tally_reductions();
+#endif
+
   // Check_triggers
-  if (mpi::master) check_triggers();
+  check_triggers();
 #ifdef OPENMC_MPI
   MPI_Bcast(&simulation::satisfy_triggers, 1, MPI_C_BOOL, 0, mpi::intracomm);
 #endif
@@ -362,10 +571,9 @@ void finalize_batch()
     if (contains(settings::sourcepoint_batch, simulation::current_batch)
         && settings::source_write && !settings::source_separate) {
       bool b = (settings::run_mode == RunMode::EIGENVALUE);
-      openmc_statepoint_write(nullptr, &b);
+      write_state_point(nullptr, b, settings::async_statepoint);
     } else {
-      bool b = false;
-      openmc_statepoint_write(nullptr, &b);
+      write_state_point(nullptr, false, settings::async_statepoint);
     }
   }
 
@@ -378,7 +586,8 @@ void finalize_batch()
 
     // Write a continously-overwritten source point if requested.
     if (settings::source_latest) {
-      auto filename = settings::path_output + "source.h5";
+      auto filename = settings::path_output +
+        (settings::source_binary ? "source.bin" : "source.h5");
       write_source_point(filename.c_str());
     }
   }
@@ -387,7 +596,11 @@ void finalize_batch()
 void initialize_generation()
 {
   if (settings::run_mode == RunMode::EIGENVALUE) {
-    // Clear out the fission bank
+    // Clear out the fission bank, enlarging it if work was moved to this
+    // process when balancing work among processes
+    if (simulation::fission_bank.capacity() < 3*simulation::work_per_rank) {
+      init_fission_bank(3*simulation::work_per_rank);
+    }
     simulation::fission_bank.resize(0);
 
     // Count source sites if using uniform fission source weighting
@@ -420,16 +633,26 @@ void finalize_generation()
   global_tally_leakage = 0.0;
 
   if (settings::run_mode == RunMode::EIGENVALUE) {
+    // The random ray solver updates the fission source itself, so there is no
+    // fission bank to sample the next source from
+    bool fission_bank = !simulation::random_ray;
+
     // If using shared memory, stable sort the fission bank (by parent IDs)
     // so as to allow for reproducibility regardless of which order particles
     // are run in.
-    sort_fission_bank();
+    if (fission_bank) sort_fission_bank();
 
-    // Distribute fission bank across processors evenly
-    synchronize_bank();
+    // Start combining keff and the entropy counts from all processors while
+    // the fission bank is sampled
+    start_generation_reductions();
 
-    // Calculate shannon entropy
-    if (settings::entropy_on) shannon_entropy();
+    if (fission_bank) {
+      // Distribute fission bank across processors evenly
+      synchronize_bank();
+
+      // Calculate shannon entropy
+      if (settings::entropy_on) shannon_entropy();
+    }
 
     // Collect results and statistics
     calculate_generation_keff();
@@ -521,8 +744,16 @@ void initialize_history_partial(Particle& p)
     std::fill(p.flux_derivs_.begin(), p.flux_derivs_.end(), 0.0);
   }
 
-  // Allocate space for tally filter matches
+  // Allocate space for tally filter matches, with room for the bins each
+  // filter usually matches in an event. Particles are reused for many
+  // histories and clearing a match keeps its storage, so scoring does not
+  // allocate once this is done.
   p.filter_matches_.resize(model::tally_filters.size());
+  for (int i = 0; i < p.filter_matches_.size(); ++i) {
+    int n = model::tally_filters[i]->max_bins_per_event();
+    p.filter_matches_[i].bins_.reserve(n);
+    p.filter_matches_[i].weights_.reserve(n);
+  }
 }
 
 int overall_generation()
@@ -534,10 +765,10 @@ int overall_generation()
 void calculate_work()
 {
   // Determine minimum amount of particles to simulate on each processor
-  int64_t min_work = settings::n_particles / mpi::n_procs;
+  int64_t min_work = simulation::n_particles_batch / mpi::n_procs;
 
   // Determine number of processors that have one extra particle
-  int64_t remainder = settings::n_particles % mpi::n_procs;
+  int64_t remainder = simulation::n_particles_batch % mpi::n_procs;
 
   int64_t i_bank = 0;
   simulation::work_index.resize(mpi::n_procs + 1);
@@ -555,10 +786,96 @@ void calculate_work()
   }
 }
 
+int64_t particles_in_batch(int batch)
+{
+  if (settings::run_mode != RunMode::EIGENVALUE ||
+      settings::particle_ramp >= 1.0 || batch > settings::n_inactive) {
+    return settings::n_particles;
+  }
+
+  // Grow the number of particles geometrically from the given fraction in the
+  // first batch to the full number in the first active batch
+  double exponent = static_cast<double>(settings::n_inactive + 1 -
+    std::max(batch, 1)) / settings::n_inactive;
+  int64_t n = std::llround(settings::n_particles *
+    std::pow(settings::particle_ramp, exponent));
+  return std::max<int64_t>(n, mpi::n_procs);
+}
+
+void set_batch_particles(int batch)
+{
+  int64_t n = particles_in_batch(batch);
+  if (n == simulation::n_particles_batch) return;
+  simulation::n_particles_batch = n;
+  calculate_work();
+
+  // Resize the banks that hold one entry per particle. The fission bank is
+  // enlarged, if needed, when it is next cleared.
+  simulation::source_bank.resize(simulation::work_per_rank);
+  simulation::progeny_per_particle.resize(simulation::work_per_rank);
+  if (settings::event_based) {
+    int64_t event_buffer_length = std::min(simulation::work_per_rank,
+      settings::max_particles_in_flight);
+    if (static_cast<int64_t>(simulation::particles.size()) < event_buffer_length) {
+      init_event_queues(event_buffer_length);
+    }
+  }
+}
+
+#ifdef OPENMC_MPI
+void balance_work(double rate)
+{
+  std::vector<double> rates(mpi::n_procs);
+  MPI_Allgather(&rate, 1, MPI_DOUBLE, rates.data(), 1, MPI_DOUBLE,
+    mpi::intracomm);
+
+  // Keep the current distribution if any rate could not be measured
+  double total = 0.0;
+  for (auto r : rates) {
+    if (!(r > 0.0)) return;
+    total += r;
+  }
+
+  // Give each process a share of the particles proportional to its rate while
+  // making sure that every process keeps at least one particle
+  double sum = 0.0;
+  for (int i = 0; i < mpi::n_procs; ++i) {
+    sum += rates[i];
+    int64_t n = simulation::n_particles_batch;
+    int64_t i_bank = std::llround(n*sum/total);
+    i_bank = std::max(i_bank, simulation::work_index[i] + 1);
+    i_bank = std::min(i_bank, n - (mpi::n_procs - 1 - i));
+    simulation::work_index[i + 1] = i_bank;
+  }
+  simulation::work_per_rank = simulation::work_index[mpi::rank + 1] -
+    simulation::work_index[mpi::rank];
+
+  // Resize the banks that hold one entry per particle. The fission bank is
+  // enlarged, if needed, when it is next cleared.
+  simulation::source_bank.resize(simulation::work_per_rank);
+  simulation::progeny_per_particle.resize(simulation::work_per_rank);
+  if (settings::event_based) {
+    int64_t event_buffer_length = std::min(simulation::work_per_rank,
+      settings::max_particles_in_flight);
+    if (static_cast<int64_t>(simulation::particles.size()) < event_buffer_length) {
+      init_event_queues(event_buffer_length);
+    }
+  }
+}
+#endif
+
 #ifdef OPENMC_MPI
 void broadcast_results() {
   // Broadcast tally results so that each process has access to results
   for (auto& t : model::tallies) {
+    if (t->sparse_) {
+      t->broadcast_sparse_results();
+      continue;
+    }
+
+    // Each process keeps only the bins it owns for decomposed tallies
+    if (t->decomposed()) continue;
+
     // Create a new datatype that consists of all values for a given filter
     // bin and then use that to broadcast. This is done to minimize the
     // chance of the 'count' argument of MPI_BCAST exceeding 2**31
@@ -593,10 +910,12 @@ void free_memory_simulation()
 {
   simulation::k_generation.clear();
   simulation::entropy.clear();
+  simulation::history_cost.clear();
 }
 
-void transport_history_based_single_particle(Particle& p)
+int64_t transport_history_based_single_particle(Particle& p)
 {
+  int64_t n_event = 0;
   while (true) {
     p.event_calculate_xs();
     p.event_advance();
@@ -606,27 +925,289 @@ void transport_history_based_single_particle(Particle& p)
       p.event_collide();
     }
     p.event_revive_from_secondary();
+    ++n_event;
     if (!p.alive_)
       break;
   }
   p.event_death();
+  return n_event;
+}
+
+namespace {
+
+//! Prefetch the nuclide data for the next cross section lookup of a particle,
+//! in two stages as Material::prefetch_neutron_xs
+void prefetch_calculate_xs(const Particle& p, bool rows)
+{
+  if (p.type_ != Particle::Type::neutron || p.material_ == MATERIAL_VOID) {
+    return;
+  }
+  model::materials[p.material_]->prefetch_neutron_xs(p.E_, p.sqrtkT_, rows);
+}
+
+//! Simulate histories on one thread with several in flight at once
+//
+//! Each history is a state machine that is suspended twice per event: once
+//! after the search data for its next cross section lookup has been
+//! prefetched, and once after the energy grids and cross sections found from
+//! it have been prefetched. The histories are resumed round-robin, so each
+//! prefetch has the time taken by the other histories to complete.
+//
+//! \param n_slots Number of histories in flight
+//! \param next Function that takes the index of the next history to run and
+//!   returns whether there is one
+//! \param finish Function called with the index of each history and the
+//!   number of events it executed once it has died
+template<typename Next, typename Finish>
+void transport_history_interleaved(int n_slots, Next next, Finish finish)
+{
+  enum class Stage { EMPTY, SEARCH_PREFETCHED, ROWS_PREFETCHED };
+  struct Slot {
+    Particle p;
+    Stage stage {Stage::EMPTY};
+    int64_t index;
+    int64_t n_event;
+  };
+  std::vector<Slot> slots(n_slots);
+
+  // Start a new history in a slot, if any are left
+  auto start = [&](Slot& s) {
+    int64_t i;
+    if (next(i)) {
+      initialize_history(s.p, i + 1);
+      s.index = i;
+      s.n_event = 0;
+      prefetch_calculate_xs(s.p, false);
+      s.stage = Stage::SEARCH_PREFETCHED;
+    } else {
+      s.stage = Stage::EMPTY;
+    }
+  };
+  for (auto& s : slots) start(s);
+
+  int n_active = n_slots;
+  while (n_active > 0) {
+    n_active = 0;
+    for (auto& s : slots) {
+      switch (s.stage) {
+      case Stage::EMPTY:
+        continue;
+      case Stage::SEARCH_PREFETCHED:
+        prefetch_calculate_xs(s.p, true);
+        s.stage = Stage::ROWS_PREFETCHED;
+        break;
+      case Stage::ROWS_PREFETCHED:
+        // A single event of transport_history_based_single_particle()
+        s.p.event_calculate_xs();
+        s.p.event_advance();
+        if (s.p.collision_distance_ > s.p.boundary_.distance) {
+          s.p.event_cross_surface();
+        } else {
+          s.p.event_collide();
+        }
+        s.p.event_revive_from_secondary();
+        ++s.n_event;
+
+        if (s.p.alive_) {
+          prefetch_calculate_xs(s.p, false);
+          s.stage = Stage::SEARCH_PREFETCHED;
+        } else {
+          s.p.event_death();
+          finish(s.index, s.n_event);
+          start(s);
+        }
+        break;
+      }
+      if (s.stage != Stage::EMPTY) ++n_active;
+    }
+  }
 }
 
+} // namespace
+
 void transport_history_based()
 {
-  #pragma omp parallel for schedule(runtime)
-  for (int64_t i_work = 1; i_work <= simulation::work_per_rank; ++i_work) {
+  int n_slots = settings::history_interleave;
+
+  if (settings::history_scheduler == HistoryScheduler::WORK_STEALING) {
+    // The cost of each history is estimated by the number of events that the
+    // history with the same index had in the previous batch. Before any
+    // histories have been run, all are assumed to cost the same.
+    auto& cost {simulation::history_cost};
+    if (static_cast<int64_t>(cost.size()) != simulation::work_per_rank) {
+      cost.assign(simulation::work_per_rank, 1.0);
+    }
+
+#ifdef _OPENMP
+    int n_threads = omp_get_max_threads();
+#else
+    int n_threads = 1;
+#endif
+    WorkStealingScheduler scheduler;
+    scheduler.init(cost, n_threads);
+
+    #pragma omp parallel
+    {
+#ifdef _OPENMP
+      int thread = omp_get_thread_num();
+#else
+      int thread = 0;
+#endif
+      if (n_slots > 1) {
+        int64_t begin = 0, end = 0;
+        transport_history_interleaved(n_slots,
+          [&](int64_t& i) {
+            if (begin == end && !scheduler.next(thread, begin, end)) {
+              return false;
+            }
+            i = begin++;
+            return true;
+          },
+          [&](int64_t i, int64_t n_event) { cost[i] = n_event; });
+      } else {
+        Particle p;
+        int64_t begin, end;
+        while (scheduler.next(thread, begin, end)) {
+          for (int64_t i = begin; i < end; ++i) {
+            initialize_history(p, i + 1);
+            cost[i] = transport_history_based_single_particle(p);
+          }
+        }
+      }
+    }
+    return;
+  }
+
+  if (n_slots > 1) {
+    // Histories are handed out one at a time from a shared counter, since the
+    // histories of each thread are not run in order
+    int64_t next_history = 0;
+    #pragma omp parallel
+    transport_history_interleaved(n_slots,
+      [&](int64_t& i) {
+        #pragma omp atomic capture
+        i = next_history++;
+        return i < simulation::work_per_rank;
+      },
+      [](int64_t, int64_t) {});
+    return;
+  }
+
+  // Each thread reuses one particle for all of its histories, as is done for
+  // the particles of the event buffers, so that the storage of its vectors is
+  // not allocated and freed again for every history
+  #pragma omp parallel
+  {
     Particle p;
-    initialize_history(p, i_work);
-    transport_history_based_single_particle(p);
+    #pragma omp for schedule(runtime)
+    for (int64_t i_work = 1; i_work <= simulation::work_per_rank; ++i_work) {
+      initialize_history(p, i_work);
+      transport_history_based_single_particle(p);
+    }
   }
 }
 
+namespace {
+
+//! Fewest particles in flight tried when tuning
+constexpr int64_t MIN_TUNED_PARTICLES_IN_FLIGHT {1000};
+
+//! Time spent in all event kernels so far in [s]
+double event_time()
+{
+  using namespace simulation;
+  return time_event_init.elapsed() + time_event_calculate_xs.elapsed() +
+    time_event_advance_particle.elapsed() +
+    time_event_surface_crossing.elapsed() + time_event_collision.elapsed() +
+    time_event_death.elapsed() + time_event_history_tail.elapsed();
+}
+
+//! Run the particles of one subiteration of event-based transport
+//
+//! \param n_particles Number of particles in flight
+//! \param source_offset Number of source particles of the batch already run
+void transport_subiteration(int64_t n_particles, int64_t source_offset)
+{
+  // Initialize all particle histories for this subiteration
+  process_init_events(n_particles, source_offset);
+
+  // Event-based transport loop. The policy used to pick the next event
+  // kernel is determined by settings::event_scheduler.
+  process_events();
+
+  // When refilling, each particle's death event was executed as soon as it
+  // died and the freed slot was reused
+  if (!settings::event_refill) process_death_events(n_particles);
+}
+
+//! Choose the number of particles in flight by running the first
+//! subiterations of a batch with sizes doubling up to the memory budget
+//
+//! \param[inout] remaining_work Number of particles of the batch left to run
+//! \param[inout] source_offset Number of source particles already run
+void tune_particles_in_flight(int64_t& remaining_work, int64_t& source_offset)
+{
+  tuning_pending = false;
+
+  // Halve the largest size until the trials fit in the batch
+  std::vector<int64_t> sizes;
+  for (int64_t n = settings::max_particles_in_flight;
+       n >= MIN_TUNED_PARTICLES_IN_FLIGHT; n /= 2) {
+    sizes.insert(sizes.begin(), n);
+  }
+  int64_t n_trial = std::accumulate(sizes.begin(), sizes.end(), int64_t {0});
+  while (!sizes.empty() && n_trial > remaining_work) {
+    n_trial -= sizes.back();
+    sizes.pop_back();
+  }
+  if (sizes.size() < 2) {
+    if (mpi::master) {
+      warning("Too few particles per batch to tune the number of particles "
+        "in flight.");
+    }
+    return;
+  }
+
+  // Trials are run without refilling so that each runs exactly its number
+  // of particles
+  bool refill = settings::event_refill;
+  settings::event_refill = false;
+  int64_t best = sizes[0];
+  double best_rate = 0.0;
+  for (int64_t n : sizes) {
+    double t = event_time();
+    transport_subiteration(n, source_offset);
+    t = event_time() - t;
+    double rate = (t > 0.0) ? n / t : INFTY;
+    write_message(fmt::format(" Particles in flight: {:>10}  Rate: {:.4e} "
+      "particles/s", n, rate), 7);
+    if (rate > best_rate) {
+      best = n;
+      best_rate = rate;
+    }
+    remaining_work -= n;
+    source_offset += n;
+  }
+  settings::event_refill = refill;
+
+  // Release the memory of the larger buffers
+  settings::max_particles_in_flight = best;
+  free_event_queues();
+  init_event_queues(std::min(simulation::work_per_rank, best));
+  write_message(fmt::format("Running {} particles in flight per process",
+    best), 6);
+}
+
+} // namespace
+
 void transport_event_based()
 {
   int64_t remaining_work = simulation::work_per_rank;
   int64_t source_offset = 0;
 
+  // Tune the number of particles in flight on the first batch
+  if (tuning_pending) tune_particles_in_flight(remaining_work, source_offset);
+
   // To cap the total amount of memory used to store particle object data, the
   // number of particles in flight at any point in time can bet set. In the case
   // that the maximum in flight particle count is lower than the total number
@@ -635,38 +1216,11 @@ void transport_event_based()
   while (remaining_work > 0) {
     // Figure out # of particles to run for this subiteration
     int64_t n_particles = std::min(remaining_work, settings::max_particles_in_flight);
+    transport_subiteration(n_particles, source_offset);
 
-    // Initialize all particle histories for this subiteration
-    process_init_events(n_particles, source_offset);
-
-    // Event-based transport loop
-    while (true) {
-      // Determine which event kernel has the longest queue
-      int64_t max = std::max({
-        simulation::calculate_fuel_xs_queue.size(),
-        simulation::calculate_nonfuel_xs_queue.size(),
-        simulation::advance_particle_queue.size(),
-        simulation::surface_crossing_queue.size(),
-        simulation::collision_queue.size()});
-
-      // Execute event with the longest queue
-      if (max == 0) {
-        break;
-      } else if (max == simulation::calculate_fuel_xs_queue.size()) {
-        process_calculate_xs_events(simulation::calculate_fuel_xs_queue);
-      } else if (max == simulation::calculate_nonfuel_xs_queue.size()) {
-        process_calculate_xs_events(simulation::calculate_nonfuel_xs_queue);
-      } else if (max == simulation::advance_particle_queue.size()) {
-        process_advance_particle_events();
-      } else if (max == simulation::surface_crossing_queue.size()) {
-        process_surface_crossing_events();
-      } else if (max == simulation::collision_queue.size()) {
-        process_collision_events();
-      }
-    }
-
-    // Execute death event for all particles
-    process_death_events(n_particles);
+    // When refilling, the freed slots ran the rest of the source particles,
+    // so the whole batch is complete
+    if (settings::event_refill) break;
 
     // Adjust remaining work and source offset variables
     remaining_work -= n_particles;
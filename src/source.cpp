@@ -4,7 +4,7 @@
 #define HAS_DYNAMIC_LINKING
 #endif
 
-#include <algorithm> // for move
+#include <algorithm> // for min, move
 
 #ifdef HAS_DYNAMIC_LINKING
 #include <dlfcn.h> // for dlopen, dlsym, dlclose, dlerror
@@ -14,6 +14,7 @@
 #include "xtensor/xadapt.hpp"
 
 #include "openmc/bank.h"
+#include "openmc/binary_source.h"
 #include "openmc/cell.h"
 #include "openmc/error.h"
 #include "openmc/file_utils.h"
@@ -45,9 +46,18 @@ std::vector<SourceDistribution> external_sources;
 namespace {
 
 using sample_t = Particle::Bank (*)(uint64_t* seed);
+using sample_batch_t = void (*)(int64_t n, uint64_t* seeds,
+  Particle::Bank* sites);
 sample_t custom_source_function;
+sample_batch_t custom_source_batch_function;
 void* custom_source_library;
 
+// Number of sites a batched custom source samples per call
+constexpr int64_t CUSTOM_SOURCE_CHUNK {1024};
+
+// Sites of the source file sampled in fixed source simulations
+std::vector<Particle::Bank> source_file_sites;
+
 }
 
 
@@ -182,28 +192,15 @@ Particle::Bank SourceDistribution::sample(uint64_t* seed) const
     site.r = space_->sample(seed);
     double xyz[] {site.r.x, site.r.y, site.r.z};
 
-    // Now search to see if location exists in geometry
-    int32_t cell_index, instance;
-    int err = openmc_find_cell(xyz, &cell_index, &instance);
-    found = (err != OPENMC_E_GEOMETRY);
-
-    // Check if spatial site is in fissionable material
-    if (found) {
-      auto space_box = dynamic_cast<SpatialBox*>(space_.get());
-      if (space_box) {
-        if (space_box->only_fissionable()) {
-          // Determine material
-          const auto& c = model::cells[cell_index];
-          auto mat_index = c->material_.size() == 1
-            ? c->material_[0] : c->material_[instance];
-
-          if (mat_index == MATERIAL_VOID) {
-            found = false;
-          } else {
-            if (!model::materials[mat_index]->fissionable_) found = false;
-          }
-        }
-      }
+    // Now search to see if location exists in geometry and, for box
+    // distributions, if spatial site is in fissionable material
+    auto space_box = dynamic_cast<SpatialBox*>(space_.get());
+    if (space_box) {
+      found = space_box->accepts(site.r);
+    } else {
+      int32_t cell_index, instance;
+      int err = openmc_find_cell(xyz, &cell_index, &instance);
+      found = (err != OPENMC_E_GEOMETRY);
     }
 
     // Check for rejection
@@ -265,24 +262,7 @@ void initialize_source()
 
     write_message(fmt::format("Reading source file from {}...",
       settings::path_source), 6);
-
-    // Open the binary file
-    hid_t file_id = file_open(settings::path_source, 'r', true);
-
-    // Read the file type
-    std::string filetype;
-    read_attribute(file_id, "filetype", filetype);
-
-    // Check to make sure this is a source file
-    if (filetype != "source" && filetype != "statepoint") {
-      fatal_error("Specified starting source file not a source file type.");
-    }
-
-    // Read in the source bank
-    read_source_bank(file_id);
-
-    // Close file
-    file_close(file_id);
+    read_source_file(settings::path_source);
   } else if (!settings::path_source_library.empty()) {
 
     write_message(fmt::format("Sampling from library source {}...",
@@ -303,6 +283,9 @@ void initialize_source()
     }
   }
 
+  // Order the initial source as the source of each later generation
+  if (settings::source_sort) sort_source_bank();
+
   // Write out initial source
   if (settings::write_initial_source) {
     write_message("Writing out initial source...", 5);
@@ -313,6 +296,56 @@ void initialize_source()
   }
 }
 
+void read_source_file(const std::string& filename)
+{
+  if (is_binary_source(filename)) {
+    read_binary_source(filename);
+    return;
+  }
+
+  // Open the binary file
+  hid_t file_id = file_open(filename, 'r', true);
+
+  // Read the file type
+  std::string filetype;
+  read_attribute(file_id, "filetype", filetype);
+
+  // Check to make sure this is a source file
+  if (filetype != "source" && filetype != "statepoint") {
+    fatal_error("Specified starting source file not a source file type.");
+  }
+
+  // Read in the source bank
+  read_source_bank(file_id);
+
+  // Close file
+  file_close(file_id);
+}
+
+void load_source_file()
+{
+  write_message(fmt::format("Reading source file from {}...",
+    settings::path_source), 6);
+
+  if (is_binary_source(settings::path_source)) {
+    source_file_sites = read_binary_source_sites(settings::path_source);
+  } else {
+    hid_t file_id = file_open(settings::path_source, 'r');
+    std::string filetype;
+    read_attribute(file_id, "filetype", filetype);
+    if (filetype != "source" && filetype != "statepoint") {
+      fatal_error("Specified starting source file not a source file type.");
+    }
+    source_file_sites = read_source_sites(file_id);
+    file_close(file_id);
+  }
+
+  if (source_file_sites.empty()) {
+    fatal_error(fmt::format("Source file {} contains no source sites.",
+      settings::path_source));
+  }
+}
+
 Particle::Bank sample_external_source(uint64_t* seed)
 {
   // return values from custom source if using
@@ -320,6 +353,12 @@ Particle::Bank sample_external_source(uint64_t* seed)
     return sample_custom_source_library(seed);
   }
 
+  // Sample a site of the source file uniformly
+  if (!source_file_sites.empty()) {
+    int64_t i = prn(seed)*source_file_sites.size();
+    return source_file_sites[i];
+  }
+
   // Determine total source strength
   double total_strength = 0.0;
   for (auto& s : model::external_sources)
@@ -349,9 +388,18 @@ Particle::Bank sample_external_source(uint64_t* seed)
   return site;
 }
 
+void initialize_source_grids()
+{
+  for (auto& s : model::external_sources) {
+    auto space_box = dynamic_cast<SpatialBox*>(s.space());
+    if (space_box) space_box->build_acceptance_grid();
+  }
+}
+
 void free_memory_source()
 {
   model::external_sources.clear();
+  source_file_sites.clear();
 }
 
 void load_custom_source_library()
@@ -367,15 +415,22 @@ void load_custom_source_library()
   // reset errors
   dlerror();
 
+  // get the batched function from the library, which is optional
+  custom_source_batch_function = reinterpret_cast<sample_batch_t>(
+    dlsym(custom_source_library, "sample_source_batch"));
+  if (dlerror()) custom_source_batch_function = nullptr;
+
   // get the function from the library
-  using sample_t = Particle::Bank (*)(uint64_t* seed);
   custom_source_function = reinterpret_cast<sample_t>(dlsym(custom_source_library, "sample_source"));
 
   // check for any dlsym errors
   auto dlsym_error = dlerror();
   if (dlsym_error) {
-    dlclose(custom_source_library);
-    fatal_error(fmt::format("Couldn't open the sample_source symbol: {}", dlsym_error));
+    custom_source_function = nullptr;
+    if (!custom_source_batch_function) {
+      dlclose(custom_source_library);
+      fatal_error(fmt::format("Couldn't open the sample_source symbol: {}", dlsym_error));
+    }
   }
 
 #else
@@ -391,6 +446,11 @@ void close_custom_source_library()
 
 Particle::Bank sample_custom_source_library(uint64_t* seed)
 {
+  if (!custom_source_function) {
+    Particle::Bank site;
+    custom_source_batch_function(1, seed, &site);
+    return site;
+  }
   return custom_source_function(seed);
 }
 
@@ -399,6 +459,28 @@ void fill_source_bank_custom_source()
   // Load the custom library
   load_custom_source_library();
 
+  // Sample the sites in chunks when the library has a batched function
+  if (custom_source_batch_function) {
+    int64_t n = simulation::work_per_rank;
+    std::vector<uint64_t> seeds(n);
+    for (int64_t i = 0; i < n; ++i) {
+      int64_t id = (simulation::total_gen + overall_generation()) *
+        settings::n_particles + simulation::work_index[mpi::rank] + i + 1;
+      seeds[i] = init_seed(id, STREAM_SOURCE);
+    }
+
+    int64_t n_chunks = (n + CUSTOM_SOURCE_CHUNK - 1) / CUSTOM_SOURCE_CHUNK;
+    #pragma omp parallel for schedule(dynamic)
+    for (int64_t c = 0; c < n_chunks; ++c) {
+      int64_t i = c*CUSTOM_SOURCE_CHUNK;
+      int64_t m = std::min(CUSTOM_SOURCE_CHUNK, n - i);
+      custom_source_batch_function(m, &seeds[i], &simulation::source_bank[i]);
+    }
+
+    close_custom_source_library();
+    return;
+  }
+
   // Generation source sites from specified distribution in the
   // library source
   for (int64_t i = 0; i < simulation::work_per_rank; ++i) {
@@ -2,7 +2,11 @@
 
 #include <algorithm>
 #include <cstdint> // for int64_t
+#include <future>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <utility> // for move
 #include <vector>
 
 #include <fmt/core.h>
@@ -10,10 +14,13 @@
 #include "xtensor/xview.hpp"
 
 #include "openmc/bank.h"
+#include "openmc/binary_source.h"
 #include "openmc/capi.h"
 #include "openmc/constants.h"
 #include "openmc/eigenvalue.h"
 #include "openmc/error.h"
+#include "openmc/event.h"
+#include "openmc/geometry_aux.h"
 #include "openmc/hdf5_interface.h"
 #include "openmc/mesh.h"
 #include "openmc/message_passing.h"
@@ -22,6 +29,8 @@
 #include "openmc/output.h"
 #include "openmc/settings.h"
 #include "openmc/simulation.h"
+#include "openmc/source.h"
+#include "openmc/summary.h"
 #include "openmc/tallies/derivative.h"
 #include "openmc/tallies/filter.h"
 #include "openmc/tallies/filter_mesh.h"
@@ -30,9 +39,297 @@
 
 namespace openmc {
 
+namespace {
+
+// Writes the counters of an event kernel to a new group
+void write_event_kernel_stats(hid_t parent, const char* name,
+  const EventKernelStats& stats, double secs)
+{
+  hid_t group = create_group(parent, name);
+  write_dataset(group, "invocations", stats.n_invocations);
+  write_dataset(group, "particles", stats.n_particles);
+  write_dataset(group, "mean queue length", stats.mean_queue_length());
+  write_dataset(group, "min queue length", stats.min_queue_length);
+  write_dataset(group, "max queue length", stats.max_queue_length);
+  write_dataset(group, "time", secs);
+  write_dataset(group, "particle rate", stats.particle_rate(secs));
+  close_group(group);
+}
+
+//! Tally results copied to be written on a background thread
+struct TallyResultsCopy {
+  int32_t id;                     //!< ID of the tally
+  xt::xtensor<double, 3> results; //!< copy of the tally results
+  bool incremental;               //!< only write the changed blocks?
+  std::vector<int64_t> blocks;    //!< blocks of the results that changed
+  std::vector<double> values;     //!< values of the blocks that changed
+};
+
+// State point that is being written on a background thread and a lock held
+// while waiting for it to be complete
+std::future<void> background_write;
+std::mutex background_mutex;
+
+// Whether the tally results of the state point that was restarted from have
+// yet to be read
+bool tally_results_pending {false};
+
+// Number of values of tally results in each block that an incremental state
+// point writes only if it changed
+constexpr int64_t RESULTS_BLOCK_SIZE {1024};
+
+// Hashes of the blocks of the results of each tally as of the last incremental
+// state point, which holds the blocks that changed since the state point
+// before it, given by its filename
+std::unordered_map<int32_t, std::vector<uint64_t>> written_hashes;
+std::string previous_statepoint;
+
+//! Hash the bytes of a block of tally results with FNV-1a
+uint64_t hash_block(const double* values, int64_t n)
+{
+  uint64_t hash = 14695981039346656037ull;
+  const auto* bytes = reinterpret_cast<const unsigned char*>(values);
+  for (int64_t i = 0; i < n * static_cast<int64_t>(sizeof(double)); ++i) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+//! Find the blocks of the results of a tally that changed since the last
+//! incremental state point
+//
+//! Only a hash of each block is kept between state points, so that the
+//! results are not copied. The changed blocks are written with their exact
+//! values and the full results are rebuilt from them without rounding.
+//
+//! \param tally Tally whose results are written
+//! \param[out] blocks Indices of the blocks that changed
+//! \param[out] values Values of the blocks that changed
+//! \return Whether the tally was written to an earlier state point, in which
+//!   case only the blocks that changed need to be written
+bool changed_blocks(const Tally& tally, std::vector<int64_t>& blocks,
+  std::vector<double>& values)
+{
+  const double* results = tally.results_.data();
+  int64_t n = tally.results_.size();
+  int64_t n_blocks = (n + RESULTS_BLOCK_SIZE - 1) / RESULTS_BLOCK_SIZE;
+
+  auto it = written_hashes.find(tally.id_);
+  bool written = (it != written_hashes.end() && it->second.size() == n_blocks);
+  auto& hashes = written_hashes[tally.id_];
+  hashes.resize(n_blocks);
+
+  for (int64_t b = 0; b < n_blocks; ++b) {
+    int64_t begin = b * RESULTS_BLOCK_SIZE;
+    int64_t size = std::min(RESULTS_BLOCK_SIZE, n - begin);
+    uint64_t hash = hash_block(results + begin, size);
+    if (written && hash != hashes[b]) {
+      blocks.push_back(b);
+      values.insert(values.end(), results + begin, results + begin + size);
+    }
+    hashes[b] = hash;
+  }
+  return written;
+}
+
+//! Write the blocks of the results of a tally that changed since the last
+//! incremental state point. The datasets are left out if none changed.
+void write_changed_blocks(hid_t group, const std::vector<int64_t>& blocks,
+  const std::vector<double>& values)
+{
+  write_attribute(group, "block_size", RESULTS_BLOCK_SIZE);
+  if (!blocks.empty()) {
+    write_dataset(group, "blocks", blocks);
+    write_dataset(group, "block_results", values);
+  }
+}
+
+//! Collect the source banks of all processes on the master process
+std::vector<Particle::Bank> gather_source_bank()
+{
+  std::vector<Particle::Bank> sites;
+  if (mpi::master) sites.resize(simulation::work_index[mpi::n_procs]);
+#ifdef OPENMC_MPI
+  std::vector<int> counts(mpi::n_procs);
+  std::vector<int> displs(mpi::n_procs);
+  for (int i = 0; i < mpi::n_procs; ++i) {
+    counts[i] = simulation::work_index[i + 1] - simulation::work_index[i];
+    displs[i] = simulation::work_index[i];
+  }
+  MPI_Gatherv(simulation::source_bank.data(), simulation::work_per_rank,
+    mpi::bank, sites.data(), counts.data(), displs.data(), mpi::bank, 0,
+    mpi::intracomm);
+#else
+  std::copy(simulation::source_bank.begin(),
+    simulation::source_bank.begin() + simulation::work_per_rank, sites.begin());
+#endif
+  return sites;
+}
+
+//! Write the tally results and source bank of a state point whose other
+//! contents have already been written
+void write_state_point_data(std::string filename,
+  std::vector<TallyResultsCopy> tallies, std::vector<Particle::Bank> sites,
+  bool write_source)
+{
+  std::lock_guard<std::mutex> lock(hdf5_mutex);
+  hid_t file_id = file_open(filename, 'a');
+
+  if (!tallies.empty()) {
+    hid_t tallies_group = open_group(file_id, "tallies");
+    for (const auto& t : tallies) {
+      std::string name = "tally " + std::to_string(t.id);
+      hid_t tally_group = open_group(tallies_group, name.c_str());
+      if (t.incremental) {
+        write_changed_blocks(tally_group, t.blocks, t.values);
+      } else {
+        write_tally_results(tally_group, t.results.shape()[0],
+          t.results.shape()[1], t.results.data(), settings::tally_compression);
+      }
+      close_group(tally_group);
+    }
+    close_group(tallies_group);
+  }
+
+  if (write_source) {
+    hid_t banktype = h5banktype();
+    hsize_t dims[] {static_cast<hsize_t>(sites.size())};
+    hid_t dspace = H5Screate_simple(1, dims, nullptr);
+    hid_t dset = H5Dcreate(file_id, "source_bank", banktype, dspace,
+      H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    H5Dwrite(dset, banktype, H5S_ALL, H5S_ALL, H5P_DEFAULT, sites.data());
+    H5Dclose(dset);
+    H5Sclose(dspace);
+    H5Tclose(banktype);
+  }
+
+  file_close(file_id);
+}
+
+#ifdef PHDF5
+//! Reduce the results of each tally without tally reduction and write them
+//! collectively. Every process reduces and writes the results of a contiguous
+//! range of filter bins so that no single process holds or writes them all.
+void write_tally_results_collective(const std::string& filename)
+{
+  bool last = simulation::current_batch == settings::n_max_batches ||
+    simulation::satisfy_triggers;
+
+  hid_t file_id = file_open(filename, 'a', true);
+  hid_t tallies_group = open_group(file_id, "tallies");
+
+  hid_t plist = H5Pcreate(H5P_DATASET_XFER);
+  H5Pset_dxpl_mpio(plist, H5FD_MPIO_COLLECTIVE);
+
+  for (const auto& t : model::tallies) {
+    if (!t->active_ || !t->writable_) continue;
+
+    // The sums and sums of squares are already contiguous
+    auto& values = t->results_;
+
+    // Determine the range of filter bins of each process
+    hsize_t n_filter = values.shape()[0];
+    hsize_t n_score = values.shape()[1];
+    std::vector<int> counts(mpi::n_procs);
+    std::vector<int> displs(mpi::n_procs);
+    for (int i = 0; i < mpi::n_procs; ++i) {
+      hsize_t begin = n_filter * i / mpi::n_procs;
+      hsize_t end = n_filter * (i + 1) / mpi::n_procs;
+      counts[i] = (end - begin) * n_score * 2;
+      displs[i] = begin * n_score * 2;
+    }
+    hsize_t bin_begin = n_filter * mpi::rank / mpi::n_procs;
+    hsize_t n_bins = n_filter * (mpi::rank + 1) / mpi::n_procs - bin_begin;
+
+    // Reduce the results of the bins of this process onto it
+    std::vector<double> slice(counts[mpi::rank]);
+    MPI_Reduce_scatter(values.data(), slice.data(), counts.data(), MPI_DOUBLE,
+      MPI_SUM, mpi::intracomm);
+
+    // Create the dataset and write the bins of each process to it
+    std::string groupname {"tally " + std::to_string(t->id_)};
+    hid_t tally_group = open_group(tallies_group, groupname.c_str());
+    hsize_t dims[] {n_filter, n_score, 2};
+    hid_t dspace = H5Screate_simple(3, dims, nullptr);
+    hid_t dset = H5Dcreate(tally_group, "results", H5T_NATIVE_DOUBLE, dspace,
+      H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+
+    hsize_t count[] {n_bins, n_score, 2};
+    hsize_t start[] {bin_begin, 0, 0};
+    hid_t memspace = H5Screate_simple(3, count, nullptr);
+    if (n_bins > 0) {
+      H5Sselect_hyperslab(dspace, H5S_SELECT_SET, start, nullptr, count,
+        nullptr);
+    } else {
+      H5Sselect_none(dspace);
+      H5Sselect_none(memspace);
+    }
+    H5Dwrite(dset, H5T_NATIVE_DOUBLE, memspace, dspace, plist, slice.data());
+
+    H5Sclose(memspace);
+    H5Sclose(dspace);
+    H5Dclose(dset);
+    close_group(tally_group);
+
+    // At the end of the simulation, store the results back in the regular
+    // TallyResults array of the master process
+    if (last) {
+      MPI_Gatherv(slice.data(), counts[mpi::rank], MPI_DOUBLE, values.data(),
+        counts.data(), displs.data(), MPI_DOUBLE, 0, mpi::intracomm);
+    }
+  }
+
+  H5Pclose(plist);
+  close_group(tallies_group);
+  file_close(file_id);
+}
+#endif
+
+} // namespace
+
 extern "C" int
 openmc_statepoint_write(const char* filename, bool* write_source)
 {
+  write_state_point(filename, write_source ? *write_source : true, false);
+  return 0;
+}
+
+void wait_state_point()
+{
+  std::lock_guard<std::mutex> lock(background_mutex);
+  if (background_write.valid()) background_write.get();
+  wait_summary();
+}
+
+void write_state_point(const char* filename, bool write_source,
+  bool background)
+{
+  // Only one state point is written at a time
+  wait_state_point();
+
+  // Results of the state point that was restarted from that are still in its
+  // file must be read before they are written again
+  read_tally_results_pending();
+
+#ifdef PHDF5
+  bool parallel = true;
+#else
+  bool parallel = false;
+#endif
+  background = background && settings::reduce_tallies && !parallel;
+
+  // Tally results that are written in the background
+  std::vector<TallyResultsCopy> copies;
+
+#ifdef OPENMC_MPI
+  // Make sure the results of all batches have been accumulated
+  finish_tally_reductions();
+#endif
+
+  // Combine the cost of scoring each tally over all threads and processes
+  if (settings::tally_profiling) reduce_tally_profiles();
+
   // Set the filename
   std::string filename_;
   if (filename) {
@@ -47,7 +344,7 @@ openmc_statepoint_write(const char* filename, bool* write_source)
   }
 
   // Determine whether or not to write the source bank
-  bool write_source_ = write_source ? *write_source : true;
+  bool write_source_ = write_source;
 
   // Write message
   write_message("Creating state point " + filename_ + "...", 5);
@@ -72,6 +369,11 @@ openmc_statepoint_write(const char* filename, bool* write_source)
     // Write current date and time
     write_attribute(file_id, "date_and_time", time_stamp());
 
+    // Write the state point that the changes of tally results are relative to
+    if (settings::statepoint_incremental && !previous_statepoint.empty()) {
+      write_attribute(file_id, "previous", previous_statepoint);
+    }
+
     // Write path to input
     write_attribute(file_id, "path", settings::path_input);
 
@@ -105,6 +407,12 @@ openmc_statepoint_write(const char* filename, bool* write_source)
     if (settings::run_mode == RunMode::EIGENVALUE)
       write_eigenvalue_hdf5(file_id);
 
+    // Write the neighbor lists of the master process so that later runs on
+    // the same geometry can start from them
+    hid_t neighbors_group = create_group(file_id, "neighbor_lists");
+    write_neighbor_lists(neighbors_group);
+    close_group(neighbors_group);
+
     hid_t tallies_group = create_group(file_id, "tallies");
 
     // Write meshes
@@ -229,6 +537,17 @@ openmc_statepoint_write(const char* filename, bool* write_source)
         write_dataset(tally_group, "n_score_bins", scores.size());
         write_dataset(tally_group, "score_bins", scores);
 
+        // Write the measured cost of scoring the tally
+        if (settings::tally_profiling) {
+          const auto& profile {tally->profile_};
+          hid_t profile_group = create_group(tally_group, "profile");
+          write_dataset(profile_group, "events", profile.n_events);
+          write_dataset(profile_group, "filter_time", profile.filter_time);
+          write_dataset(profile_group, "bins", profile.n_bins);
+          write_dataset(profile_group, "updates", profile.n_updates);
+          close_group(profile_group);
+        }
+
         close_group(tally_group);
       }
 
@@ -238,8 +557,10 @@ openmc_statepoint_write(const char* filename, bool* write_source)
       // Write global tallies
       write_dataset(file_id, "global_tallies", simulation::global_tallies);
 
-      // Write tallies
-      if (model::active_tallies.size() > 0) {
+      // Write tallies, including those frozen by their triggers that are no
+      // longer in the active list
+      if (std::any_of(model::tallies.begin(), model::tallies.end(),
+          [](const std::unique_ptr<Tally>& t) { return t->active_; })) {
         // Indicate that tallies are on
         write_attribute(file_id, "tallies_present", 1);
 
@@ -249,9 +570,34 @@ openmc_statepoint_write(const char* filename, bool* write_source)
           // Write sum and sum_sq for each bin
           std::string name = "tally " + std::to_string(tally->id_);
           hid_t tally_group = open_group(tallies_group, name.c_str());
-          auto& results = tally->results_;
-          write_tally_results(tally_group, results.shape()[0],
-            results.shape()[1], results.data());
+          if (tally->sparse_) {
+            tally->write_sparse_results(tally_group);
+          } else if (tally->decomposed()) {
+            // Results are collected from all processes below
+          } else {
+            // Once a tally was written to an incremental state point, only
+            // the blocks of its results that changed are written
+            std::vector<int64_t> blocks;
+            std::vector<double> values;
+            bool incremental = settings::statepoint_incremental &&
+              changed_blocks(*tally, blocks, values);
+            if (settings::statepoint_incremental) {
+              write_attribute(tally_group, "incremental",
+                static_cast<int>(incremental));
+            }
+            if (background) {
+              // Results are copied and written in the background below
+              copies.push_back({tally->id_, incremental ?
+                xt::xtensor<double, 3>() : tally->results_, incremental,
+                std::move(blocks), std::move(values)});
+            } else if (incremental) {
+              write_changed_blocks(tally_group, blocks, values);
+            } else {
+              const auto& results = tally->results_;
+              write_tally_results(tally_group, results.shape()[0],
+                results.shape()[1], results.data(), settings::tally_compression);
+            }
+          }
           close_group(tally_group);
         }
       } else {
@@ -268,6 +614,10 @@ openmc_statepoint_write(const char* filename, bool* write_source)
     // If using the no-tally-reduction method, we need to collect tally
     // results before writing them to the state point file.
     write_tally_results_nr(file_id);
+    if (mpi::master) file_close(file_id);
+#ifdef PHDF5
+    write_tally_results_collective(filename_);
+#endif
 
   } else if (mpi::master) {
     // Write number of global realizations
@@ -296,23 +646,86 @@ openmc_statepoint_write(const char* filename, bool* write_source)
     write_dataset(runtime_group, "total", time_total.elapsed());
     close_group(runtime_group);
 
+    // Write out occupancy and throughput of each event kernel
+    if (settings::event_based) {
+      hid_t kernels_group = create_group(file_id, "event_kernels");
+      write_event_kernel_stats(kernels_group, "initialization",
+        stats_event_init, time_event_init.elapsed());
+      write_event_kernel_stats(kernels_group, "calculate_xs",
+        stats_event_calculate_xs, time_event_calculate_xs.elapsed());
+      write_event_kernel_stats(kernels_group, "advance_particle",
+        stats_event_advance_particle, time_event_advance_particle.elapsed());
+      write_event_kernel_stats(kernels_group, "surface_crossing",
+        stats_event_surface_crossing, time_event_surface_crossing.elapsed());
+      write_event_kernel_stats(kernels_group, "collision",
+        stats_event_collision, time_event_collision.elapsed());
+      write_event_kernel_stats(kernels_group, "death",
+        stats_event_death, time_event_death.elapsed());
+      close_group(kernels_group);
+    }
+
     file_close(file_id);
   }
 
-#ifdef PHDF5
-  bool parallel = true;
-#else
-  bool parallel = false;
-#endif
+  // Write the results of decomposed tallies, which each process writes to
+  // the file with parallel HDF5 or the master process collects from one
+  // process at a time otherwise
+  bool decomposed = std::any_of(model::tallies.begin(), model::tallies.end(),
+    [](const std::unique_ptr<Tally>& t) {
+      return t->decomposed() && t->writable_ && t->active_;
+    });
+  if (decomposed && settings::reduce_tallies) {
+    hid_t tallies_group;
+    if (mpi::master || parallel) {
+      file_id = file_open(filename_, 'a', parallel);
+      tallies_group = open_group(file_id, "tallies");
+    }
+    for (const auto& tally : model::tallies) {
+      if (!tally->decomposed() || !tally->writable_) continue;
+      hid_t tally_group;
+      if (mpi::master || parallel) {
+        std::string name = "tally " + std::to_string(tally->id_);
+        tally_group = open_group(tallies_group, name.c_str());
+      }
+      tally->write_decomposed_results(tally_group);
+      if (mpi::master || parallel) close_group(tally_group);
+    }
+    if (mpi::master || parallel) {
+      close_group(tallies_group);
+      file_close(file_id);
+    }
+  }
+
+  if (background) {
+    // Copy the source bank and tally results so that the next batch can change
+    // them while they are written
+    std::vector<Particle::Bank> sites;
+    if (write_source_) sites = gather_source_bank();
 
-  // Write the source bank if desired
-  if (write_source_) {
+    if (mpi::master) {
+      background_write = std::async(std::launch::async,
+        write_state_point_data, filename_, std::move(copies),
+        std::move(sites), write_source_);
+    }
+
+  } else if (write_source_) {
+    // Write the source bank if desired
     if (mpi::master || parallel) file_id = file_open(filename_, 'a', true);
     write_source_bank(file_id);
     if (mpi::master || parallel) file_close(file_id);
   }
 
-  return 0;
+  // The next incremental state point is relative to this one, which is in the
+  // same directory
+  if (settings::statepoint_incremental) {
+    previous_statepoint = filename_.substr(filename_.find_last_of('/') + 1);
+  }
+}
+
+void reset_incremental_state_points()
+{
+  written_hashes.clear();
+  previous_statepoint.clear();
 }
 
 void restart_set_keff()
@@ -413,6 +826,18 @@ void load_state_point()
   // Read number of realizations for global tallies
   read_dataset(file_id, "n_realizations", simulation::n_realizations);
 
+  // Adaptive meshes start from the elements they had divided, which the
+  // tally results read later refer to
+  for (auto& m : model::meshes) {
+    auto* am = dynamic_cast<AdaptiveMesh*>(m.get());
+    if (!am) continue;
+    std::string name = "tallies/meshes/mesh " + std::to_string(am->id_);
+    if (!object_exists(file_id, name.c_str())) continue;
+    hid_t mesh_group = open_group(file_id, name.c_str());
+    am->read_elements(mesh_group);
+    close_group(mesh_group);
+  }
+
   // Set k_sum, keff, and current_batch based on whether restart file is part
   // of active cycle or inactive cycle
   if (settings::run_mode == RunMode::EIGENVALUE) {
@@ -422,50 +847,27 @@ void load_state_point()
   // Set current batch number
   simulation::current_batch = simulation::restart_batch;
 
-  // Read tallies to master. If we are using Parallel HDF5, all processes
-  // need to be included in the HDF5 calls.
+  // The source that is read below is that of the next batch, which may have
+  // fewer particles when ramping up the number of particles
+  if (settings::run_mode == RunMode::EIGENVALUE) {
+    set_batch_particles(simulation::restart_batch + 1);
+  }
+
+  // Read global tallies to master. If we are using Parallel HDF5, all
+  // processes need to be included in the HDF5 calls.
 #ifdef PHDF5
   if (true) {
 #else
   if (mpi::master) {
 #endif
-    // Read global tally data
     read_dataset_lowlevel(file_id, "global_tallies", H5T_NATIVE_DOUBLE,
       H5S_ALL, false, simulation::global_tallies.data());
-
-    // Check if tally results are present
-    bool present;
-    read_attribute(file_id, "tallies_present", present);
-
-    // Read in sum and sum squared
-    if (present) {
-      hid_t tallies_group = open_group(file_id, "tallies");
-
-      for (auto& tally : model::tallies) {
-        // Read sum, sum_sq, and N for each bin
-        std::string name = "tally " + std::to_string(tally->id_);
-        hid_t tally_group = open_group(tallies_group, name.c_str());
-
-        int internal=0;
-        if (attribute_exists(tally_group, "internal")) {
-          read_attribute(tally_group, "internal", internal);
-        }
-        if (internal) {
-          tally->writable_ = false;
-        } else {
-
-          auto& results = tally->results_;
-          read_tally_results(tally_group, results.shape()[0],
-            results.shape()[1], results.data());
-          read_dataset(tally_group, "n_realizations", tally->n_realizations_);
-          close_group(tally_group);
-        }
-      }
-
-      close_group(tallies_group);
-    }
   }
 
+  // The results of the tallies are only read once they are accumulated so
+  // that the processes that don't hold any of them never touch them
+  tally_results_pending = true;
+
   // Read source if in eigenvalue mode
   if (settings::run_mode == RunMode::EIGENVALUE) {
 
@@ -479,8 +881,9 @@ void load_state_point()
       write_message("Loading source file " + settings::path_sourcepoint
         + "...", 5);
 
-      // Open source file
-      file_id = file_open(settings::path_source.c_str(), 'r', true);
+      // Read source
+      read_source_file(settings::path_sourcepoint);
+      return;
     }
 
     // Read source
@@ -493,6 +896,87 @@ void load_state_point()
 }
 
 
+void discard_tally_results_pending()
+{
+  tally_results_pending = false;
+}
+
+void read_tally_results_pending()
+{
+  if (!tally_results_pending) return;
+  tally_results_pending = false;
+
+  // The state point may be the one that is being written in the background
+  wait_state_point();
+
+  // Only the master process holds the sums of the tallies, except for the bins
+  // of decomposed tallies that each process owns
+  bool decomposed = std::any_of(model::tallies.begin(), model::tallies.end(),
+    [](const std::unique_ptr<Tally>& t) { return t->decomposed(); });
+  if (!mpi::master && !decomposed) return;
+
+  // Each process opens the file on its own since it reads different data
+  hid_t file_id = file_open(settings::path_statepoint, 'r');
+
+  // Check if tally results are present
+  bool present;
+  read_attribute(file_id, "tallies_present", present);
+
+  // Read in sum and sum squared
+  if (present) {
+    hid_t tallies_group = open_group(file_id, "tallies");
+
+    for (auto& tally : model::tallies) {
+      if (!mpi::master && !tally->decomposed()) continue;
+
+      // Read sum, sum_sq, and N for each bin
+      std::string name = "tally " + std::to_string(tally->id_);
+      hid_t tally_group = open_group(tallies_group, name.c_str());
+
+      int internal = 0;
+      if (attribute_exists(tally_group, "internal")) {
+        read_attribute(tally_group, "internal", internal);
+      }
+      if (internal) {
+        tally->writable_ = false;
+      } else {
+        int incremental = 0;
+        if (attribute_exists(tally_group, "incremental")) {
+          read_attribute(tally_group, "incremental", incremental);
+        }
+        if (incremental) {
+          fatal_error(fmt::format("State point {} only holds the results of "
+            "tally {} that changed since an earlier state point. Use "
+            "openmc-reconstruct-statepoint to restart from it.",
+            settings::path_statepoint, tally->id_));
+        }
+
+        if (tally->sparse_) {
+          tally->read_sparse_results(tally_group);
+        } else if (tally->decomposed()) {
+          tally->read_decomposed_results(tally_group);
+        } else if (tally->history_) {
+          // The histories run since the restart are already in the sums
+          xt::xtensor<double, 3> results = tally->results_;
+          read_tally_results(tally_group, results.shape()[0],
+            results.shape()[1], tally->results_.data());
+          tally->results_ += results;
+        } else {
+          auto& results = tally->results_;
+          read_tally_results(tally_group, results.shape()[0],
+            results.shape()[1], results.data());
+        }
+        read_dataset(tally_group, "n_realizations", tally->n_realizations_);
+      }
+      close_group(tally_group);
+    }
+
+    close_group(tallies_group);
+  }
+
+  file_close(file_id);
+}
+
 hid_t h5banktype() {
   // Create compound type for position
   hid_t postype = H5Tcreate(H5T_COMPOUND, sizeof(struct Position));
@@ -506,6 +990,7 @@ hid_t h5banktype() {
   H5Tinsert(banktype, "u", HOFFSET(Particle::Bank, u), postype);
   H5Tinsert(banktype, "E", HOFFSET(Particle::Bank, E), H5T_NATIVE_DOUBLE);
   H5Tinsert(banktype, "wgt", HOFFSET(Particle::Bank, wgt), H5T_NATIVE_DOUBLE);
+  H5Tinsert(banktype, "time", HOFFSET(Particle::Bank, time), H5T_NATIVE_DOUBLE);
   H5Tinsert(banktype, "delayed_group", HOFFSET(Particle::Bank, delayed_group), H5T_NATIVE_INT);
   H5Tinsert(banktype, "particle", HOFFSET(Particle::Bank, particle), H5T_NATIVE_INT);
 
@@ -516,6 +1001,8 @@ hid_t h5banktype() {
 void
 write_source_point(const char* filename)
 {
+  wait_state_point();
+
   // When using parallel HDF5, the file is written to collectively by all
   // processes. With MPI-only, the file is opened and written by the master
   // (note that the call to write_source_bank is by all processes since slave
@@ -533,8 +1020,14 @@ write_source_point(const char* filename)
     // Determine width for zero padding
     int w = std::to_string(settings::n_max_batches).size();
 
-    filename_ = fmt::format("{0}source.{1:0{2}}.h5",
-      settings::path_output, simulation::current_batch, w);
+    filename_ = fmt::format("{0}source.{1:0{2}}.{3}",
+      settings::path_output, simulation::current_batch, w,
+      settings::source_binary ? "bin" : "h5");
+  }
+
+  if (settings::source_binary) {
+    write_binary_source(filename_);
+    return;
   }
 
   hid_t file_id;
@@ -549,24 +1042,101 @@ write_source_point(const char* filename)
   if (mpi::master || parallel) file_close(file_id);
 }
 
+void write_surface_source()
+{
+  write_banked_sites(simulation::surf_source_bank, "surface source",
+    "surface_source");
+}
+
+void write_census()
+{
+  // Sites are discarded once the bank of a process is full
+  int64_t n_discarded = simulation::n_census_discarded;
+#ifdef OPENMC_MPI
+  MPI_Reduce(&simulation::n_census_discarded, &n_discarded, 1, MPI_INT64_T,
+    MPI_SUM, 0, mpi::intracomm);
+#endif
+  if (mpi::master && n_discarded > 0) {
+    warning(fmt::format("{} particles that reached the census time were not "
+      "banked since the census bank was full. Increase max_particles of the "
+      "census settings to keep them.", n_discarded));
+  }
+
+  write_banked_sites(simulation::census_bank, "census", "census");
+}
+
+void write_banked_sites(SharedArray<Particle::Bank>& bank,
+  const std::string& description, const std::string& name)
+{
+  wait_state_point();
+
+  // Determine the index of the first site of each process
+  int64_t n_sites = bank.size();
+  std::vector<int64_t> bank_index(mpi::n_procs + 1, 0);
+#ifdef OPENMC_MPI
+  std::vector<int64_t> counts(mpi::n_procs);
+  MPI_Allgather(&n_sites, 1, MPI_INT64_T, counts.data(), 1, MPI_INT64_T,
+    mpi::intracomm);
+  for (int i = 0; i < mpi::n_procs; ++i) {
+    bank_index[i + 1] = bank_index[i] + counts[i];
+  }
+#else
+  bank_index[1] = n_sites;
+#endif
+
+  auto filename = settings::path_output + name + "." +
+    (settings::source_binary ? "bin" : "h5");
+  write_message(fmt::format("Writing {} {} sites to {}...",
+    bank_index[mpi::n_procs], description, filename), 5);
+
+  const auto* sites = bank.data();
+  if (settings::source_binary) {
+    write_binary_source(filename, sites, bank_index);
+    return;
+  }
+
+#ifdef PHDF5
+  bool parallel = true;
+#else
+  bool parallel = false;
+#endif
+
+  hid_t file_id;
+  if (mpi::master || parallel) {
+    file_id = file_open(filename, 'w', true);
+    write_attribute(file_id, "filetype", "source");
+  }
+  write_source_bank(file_id, sites, bank_index);
+  if (mpi::master || parallel) file_close(file_id);
+}
+
 void
 write_source_bank(hid_t group_id)
+{
+  write_source_bank(group_id, simulation::source_bank.data(),
+    simulation::work_index);
+}
+
+void
+write_source_bank(hid_t group_id, const Particle::Bank* sites,
+  const std::vector<int64_t>& bank_index)
 {
   hid_t banktype = h5banktype();
+  int64_t n_local = bank_index[mpi::rank + 1] - bank_index[mpi::rank];
 
 #ifdef PHDF5
   // Set size of total dataspace for all procs and rank
-  hsize_t dims[] {static_cast<hsize_t>(settings::n_particles)};
+  hsize_t dims[] {static_cast<hsize_t>(bank_index[mpi::n_procs])};
   hid_t dspace = H5Screate_simple(1, dims, nullptr);
   hid_t dset = H5Dcreate(group_id, "source_bank", banktype, dspace,
                          H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
 
   // Create another data space but for each proc individually
-  hsize_t count[] {static_cast<hsize_t>(simulation::work_per_rank)};
+  hsize_t count[] {static_cast<hsize_t>(n_local)};
   hid_t memspace = H5Screate_simple(1, count, nullptr);
 
   // Select hyperslab for this dataspace
-  hsize_t start[] {static_cast<hsize_t>(simulation::work_index[mpi::rank])};
+  hsize_t start[] {static_cast<hsize_t>(bank_index[mpi::rank])};
   H5Sselect_hyperslab(dspace, H5S_SELECT_SET, start, nullptr, count, nullptr);
 
   // Set up the property list for parallel writing
@@ -574,7 +1144,7 @@ write_source_bank(hid_t group_id)
   H5Pset_dxpl_mpio(plist, H5FD_MPIO_COLLECTIVE);
 
   // Write data to file in parallel
-  H5Dwrite(dset, banktype, memspace, dspace, plist, simulation::source_bank.data());
+  H5Dwrite(dset, banktype, memspace, dspace, plist, sites);
 
   // Free resources
   H5Sclose(dspace);
@@ -584,56 +1154,84 @@ write_source_bank(hid_t group_id)
 
 #else
 
+  // Sites of other processes are sent to the master in chunks of at most this
+  // many sites
+  constexpr int64_t CHUNK_SIZE {1 << 18};
+
   if (mpi::master) {
     // Create dataset big enough to hold all source sites
-    hsize_t dims[] {static_cast<hsize_t>(settings::n_particles)};
+    hsize_t dims[] {static_cast<hsize_t>(bank_index[mpi::n_procs])};
     hid_t dspace = H5Screate_simple(1, dims, nullptr);
     hid_t dset = H5Dcreate(group_id, "source_bank", banktype, dspace,
                            H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    H5Sclose(dspace);
 
-    // Save source bank sites since the souce_bank array is overwritten below
-#ifdef OPENMC_MPI
-    std::vector<Particle::Bank> temp_source {simulation::source_bank.begin(),
-      simulation::source_bank.begin() + simulation::work_per_rank};
-#endif
-
-    for (int i = 0; i < mpi::n_procs; ++i) {
-      // Create memory space
-      hsize_t count[] {static_cast<hsize_t>(simulation::work_index[i+1] -
-        simulation::work_index[i])};
+    // Writes sites to the hyperslab starting at a given index
+    auto write_sites = [&](const Particle::Bank* sites, int64_t start,
+      int64_t n) {
+      if (n == 0) return;
+      hsize_t count[] {static_cast<hsize_t>(n)};
       hid_t memspace = H5Screate_simple(1, count, nullptr);
+      hid_t filespace = H5Dget_space(dset);
+      hsize_t offset[] {static_cast<hsize_t>(start)};
+      H5Sselect_hyperslab(filespace, H5S_SELECT_SET, offset, nullptr, count,
+        nullptr);
+      H5Dwrite(dset, banktype, memspace, filespace, H5P_DEFAULT, sites);
+      H5Sclose(memspace);
+      H5Sclose(filespace);
+    };
 
 #ifdef OPENMC_MPI
-      // Receive source sites from other processes
-      if (i > 0)
-        MPI_Recv(simulation::source_bank.data(), count[0], mpi::bank, i, i,
-                 mpi::intracomm, MPI_STATUS_IGNORE);
-#endif
+    // Determine the chunks that are received from the other processes
+    struct Chunk {
+      int rank;
+      int64_t start;
+      int64_t n;
+    };
+    std::vector<Chunk> chunks;
+    for (int i = 1; i < mpi::n_procs; ++i) {
+      for (int64_t start = bank_index[i];
+           start < bank_index[i + 1]; start += CHUNK_SIZE) {
+        chunks.push_back({i, start,
+          std::min(CHUNK_SIZE, bank_index[i + 1] - start)});
+      }
+    }
 
-      // Select hyperslab for this dataspace
-      dspace = H5Dget_space(dset);
-      hsize_t start[] {static_cast<hsize_t>(simulation::work_index[i])};
-      H5Sselect_hyperslab(dspace, H5S_SELECT_SET, start, nullptr, count, nullptr);
+    // Start receiving the first chunk while the sites of the master are
+    // written. Afterwards, each chunk is received into one buffer while the
+    // previous one is written from the other.
+    std::vector<Particle::Bank> buffers[2];
+    MPI_Request request;
+    if (!chunks.empty()) {
+      buffers[0].resize(CHUNK_SIZE);
+      buffers[1].resize(CHUNK_SIZE);
+      MPI_Irecv(buffers[0].data(), chunks[0].n, mpi::bank, chunks[0].rank,
+        chunks[0].rank, mpi::intracomm, &request);
+    }
+#endif
 
-      // Write data to hyperslab
-      H5Dwrite(dset, banktype, memspace, dspace, H5P_DEFAULT,
-        simulation::source_bank.data());
+    write_sites(sites, bank_index[0], n_local);
 
-      H5Sclose(memspace);
-      H5Sclose(dspace);
+#ifdef OPENMC_MPI
+    for (int k = 0; k < chunks.size(); ++k) {
+      MPI_Wait(&request, MPI_STATUS_IGNORE);
+      if (k + 1 < chunks.size()) {
+        const auto& next {chunks[k + 1]};
+        MPI_Irecv(buffers[(k + 1) % 2].data(), next.n, mpi::bank, next.rank,
+          next.rank, mpi::intracomm, &request);
+      }
+      write_sites(buffers[k % 2].data(), chunks[k].start, chunks[k].n);
     }
+#endif
 
     // Close all ids
     H5Dclose(dset);
-
-#ifdef OPENMC_MPI
-    // Restore state of source bank
-    std::copy(temp_source.begin(), temp_source.end(), simulation::source_bank.begin());
-#endif
   } else {
 #ifdef OPENMC_MPI
-    MPI_Send(simulation::source_bank.data(), simulation::work_per_rank, mpi::bank,
-      0, mpi::rank, mpi::intracomm);
+    for (int64_t i = 0; i < n_local; i += CHUNK_SIZE) {
+      MPI_Send(sites + i, std::min(CHUNK_SIZE, n_local - i), mpi::bank, 0,
+        mpi::rank, mpi::intracomm);
+    }
 #endif
   }
 #endif
@@ -642,6 +1240,23 @@ write_source_bank(hid_t group_id)
 }
 
 
+std::vector<Particle::Bank> read_source_sites(hid_t group_id)
+{
+  hid_t banktype = h5banktype();
+  hid_t dset = H5Dopen(group_id, "source_bank", H5P_DEFAULT);
+
+  hid_t dspace = H5Dget_space(dset);
+  hsize_t dims[1];
+  H5Sget_simple_extent_dims(dspace, dims, nullptr);
+  std::vector<Particle::Bank> sites(dims[0]);
+  H5Dread(dset, banktype, H5S_ALL, H5S_ALL, H5P_DEFAULT, sites.data());
+
+  H5Sclose(dspace);
+  H5Dclose(dset);
+  H5Tclose(banktype);
+  return sites;
+}
+
 void read_source_bank(hid_t group_id)
 {
   hid_t banktype = h5banktype();
@@ -698,6 +1313,14 @@ void write_unstructured_mesh_results() {
 
       if (!umesh) continue;
 
+      // results of decomposed tallies are not available on any one process
+      if (tally->decomposed()) {
+        warning(fmt::format("Skipping unstructured mesh writing for tally "
+                            "{}. Its results are decomposed across processes.",
+                            tally->id_));
+        break;
+      }
+
       // if this tally has more than one filter, print
       // warning and skip writing the mesh
       if (tally->filters().size() > 1) {
@@ -709,31 +1332,11 @@ void write_unstructured_mesh_results() {
 
       int n_realizations = tally->n_realizations_;
 
-      // write each score/nuclide combination for this tally
-      for (int i_score = 0; i_score < tally->scores_.size(); i_score++) {
-        for (int i_nuc = 0; i_nuc < tally->nuclides_.size(); i_nuc++) {
-
-          // index for this nuclide and score
-          int nuc_score_idx = i_score + i_nuc*tally->scores_.size();
-
-          // construct result vectors
-          std::vector<double> mean_vec, std_dev_vec;
-          for (int j = 0; j < tally->results_.shape()[0]; j++) {
-            // mean
-            double mean = tally->results_(j, nuc_score_idx, TallyResult::SUM) / n_realizations;
-            mean_vec.push_back(mean);
-            // std. dev.
-            double sum_sq = tally->results_(j , nuc_score_idx, TallyResult::SUM_SQ);
-            if (n_realizations > 1) {
-              double std_dev = sum_sq/n_realizations - mean*mean;
-              std_dev = std::sqrt(std_dev / (n_realizations - 1));
-              std_dev_vec.push_back(std_dev);
-            } else {
-              std_dev_vec.push_back(0.0);
-            }
-          }
-
-          // generate a name for the value
+      // name the mean and standard deviation of each score/nuclide
+      // combination for this tally
+      std::vector<std::string> names;
+      for (int i_nuc = 0; i_nuc < tally->nuclides_.size(); i_nuc++) {
+        for (int i_score = 0; i_score < tally->scores_.size(); i_score++) {
           std::string nuclide_name = "total"; // start with total by default
           if (tally->nuclides_[i_nuc] > -1) {
             nuclide_name = data::nuclides[tally->nuclides_[i_nuc]]->name_;
@@ -741,10 +1344,33 @@ void write_unstructured_mesh_results() {
 
           std::string score_name = tally->score_name(i_score);
           auto score_str = fmt::format("{}_{}", score_name, nuclide_name);
-          umesh->set_score_data(score_str, mean_vec, std_dev_vec);
+          names.push_back(score_str + "_mean");
+          names.push_back(score_str + "_std_dev");
         }
       }
 
+      // compute the results of one combination at a time as they're written,
+      // the combinations being ordered like the scores of the tally
+      auto get_data = [&](int i, std::vector<double>& values) {
+        int nuc_score_idx = i / 2;
+        bool std_dev = i % 2;
+        values.resize(tally->n_filter_bins());
+        for (int j = 0; j < tally->n_filter_bins(); j++) {
+          double mean = tally->result(j, nuc_score_idx, TallyResult::SUM) /
+            n_realizations;
+          if (!std_dev) {
+            values[j] = mean;
+          } else if (n_realizations > 1) {
+            double sum_sq = tally->result(j, nuc_score_idx,
+              TallyResult::SUM_SQ);
+            double var = sum_sq/n_realizations - mean*mean;
+            values[j] = std::sqrt(var / (n_realizations - 1));
+          } else {
+            values[j] = 0.0;
+          }
+        }
+      };
+
       // Generate a file name based on the tally id
       // and the current batch number
       int w = std::to_string(settings::n_max_batches).size();
@@ -753,7 +1379,7 @@ void write_unstructured_mesh_results() {
                                          simulation::current_batch,
                                          w);
       // Write the unstructured mesh and data to file
-      umesh->write(filename);
+      umesh->write_vtk(filename, names, get_data);
     }
   }
 }
@@ -807,12 +1433,14 @@ void write_tally_results_nr(hid_t file_id)
       write_attribute(file_id, "tallies_present", 1);
     }
 
-    // Get view of accumulated tally values
-    auto values_view = xt::view(t->results_, xt::all(), xt::all(),
-      xt::range(static_cast<int>(TallyResult::SUM), static_cast<int>(TallyResult::SUM_SQ) + 1));
+#ifdef PHDF5
+    // Results are written collectively by all processes once the file has been
+    // closed by the master process
+    continue;
+#endif
 
-    // Make copy of tally values in contiguous array
-    xt::xtensor<double, 2> values = values_view;
+    // Make copy of accumulated tally values
+    xt::xtensor<double, 3> values = t->results_;
 
     if (mpi::master) {
       // Open group for tally
@@ -830,18 +1458,13 @@ void write_tally_results_nr(hid_t file_id)
       // regular TallyResults array
       if (simulation::current_batch == settings::n_max_batches ||
           simulation::satisfy_triggers) {
-        values_view = values;
+        t->results_ = values;
       }
 
-      // Put in temporary tally result
-      xt::xtensor<double, 3> results_copy = xt::zeros_like(t->results_);
-      auto copy_view = xt::view(results_copy, xt::all(), xt::all(),
-        xt::range(static_cast<int>(TallyResult::SUM), static_cast<int>(TallyResult::SUM_SQ) + 1));
-      copy_view = values;
-
       // Write reduced tally results to file
-      auto shape = results_copy.shape();
-      write_tally_results(tally_group, shape[0], shape[1], results_copy.data());
+      auto shape = values.shape();
+      write_tally_results(tally_group, shape[0], shape[1], values.data(),
+        settings::tally_compression);
 
       close_group(tally_group);
     } else {
@@ -858,6 +1481,7 @@ void write_tally_results_nr(hid_t file_id)
       // Indicate that tallies are off
       write_dataset(file_id, "tallies_present", 0);
     }
+    close_group(tallies_group);
   }
 }
 
@@ -1,5 +1,12 @@
 #include "openmc/summary.h"
 
+#include <cstdint> // for int32_t
+#include <future>
+#include <mutex> // for lock_guard
+#include <string>
+#include <utility> // for move
+#include <vector>
+
 #include "openmc/cell.h"
 #include "openmc/hdf5_interface.h"
 #include "openmc/lattice.h"
@@ -12,10 +19,50 @@
 
 namespace openmc {
 
-void write_summary()
+namespace {
+
+//! Data of a material that is written to the summary file
+struct MaterialState {
+  int32_t id;
+  std::string name;
+  std::vector<int> nuclides;
+  std::vector<double> densities;
+  double density;
+  double volume;
+  double temperature;
+
+  bool operator==(const MaterialState& other) const
+  {
+    return id == other.id && name == other.name &&
+      nuclides == other.nuclides && densities == other.densities &&
+      density == other.density && volume == other.volume &&
+      temperature == other.temperature;
+  }
+};
+
+MaterialState material_state(const Material& mat)
 {
-  // Display output message
-  write_message("Writing summary.h5 file...", 5);
+  return {mat.id_, mat.name_, mat.nuclide_,
+    {mat.atom_density_.begin(), mat.atom_density_.end()}, mat.density_,
+    mat.volume_, mat.temperature_};
+}
+
+size_t n_nuclides()
+{
+  return settings::run_CE ? data::nuclides.size() : data::mg.nuclides_.size();
+}
+
+// Summary that is being written on a background thread
+std::future<void> background_write;
+
+// State of the model when the summary was last written
+bool summary_written {false};
+size_t n_nuclides_written {0};
+std::vector<MaterialState> written_materials;
+
+void write_summary_file()
+{
+  std::lock_guard<std::mutex> lock(hdf5_mutex);
 
   // Create a new file using default properties.
   hid_t file = file_open("summary.h5", 'w');
@@ -29,6 +76,111 @@ void write_summary()
   file_close(file);
 }
 
+//! Rewrite parts of the summary file
+//
+//! \param nuclides Whether to rewrite the nuclides
+//! \param all_materials Whether to rewrite all materials
+//! \param materials Indices of the other materials to rewrite
+//! \param old_ids IDs with which these materials were written
+void update_summary_file(bool nuclides, bool all_materials,
+  std::vector<int> materials, std::vector<int32_t> old_ids)
+{
+  std::lock_guard<std::mutex> lock(hdf5_mutex);
+  hid_t file = file_open("summary.h5", 'a');
+
+  if (nuclides) {
+    H5Ldelete(file, "nuclides", H5P_DEFAULT);
+    H5Ldelete(file, "macroscopics", H5P_DEFAULT);
+    write_nuclides(file);
+  }
+
+  if (all_materials) {
+    H5Ldelete(file, "n_materials", H5P_DEFAULT);
+    H5Ldelete(file, "materials", H5P_DEFAULT);
+    write_materials(file);
+  } else if (!materials.empty()) {
+    hid_t materials_group = open_group(file, "materials");
+    for (int i = 0; i < materials.size(); ++i) {
+      std::string name = "material " + std::to_string(old_ids[i]);
+      H5Ldelete(materials_group, name.c_str(), H5P_DEFAULT);
+      model::materials[materials[i]]->to_hdf5(materials_group);
+    }
+    close_group(materials_group);
+  }
+
+  file_close(file);
+}
+
+//! Remember the state of the model that is written to the summary file
+void record_state()
+{
+  summary_written = true;
+  n_nuclides_written = n_nuclides();
+  written_materials.clear();
+  for (const auto& mat : model::materials) {
+    written_materials.push_back(material_state(*mat));
+  }
+}
+
+} // namespace
+
+void write_summary()
+{
+  wait_summary();
+
+  // Display output message
+  write_message("Writing summary.h5 file...", 5);
+
+  record_state();
+  if (settings::async_summary) {
+    background_write = std::async(std::launch::async, write_summary_file);
+  } else {
+    write_summary_file();
+  }
+}
+
+void update_summary()
+{
+  if (!summary_written) {
+    write_summary();
+    return;
+  }
+  wait_summary();
+
+  // Find the parts of the model that changed
+  bool nuclides = n_nuclides() != n_nuclides_written;
+  bool all_materials = model::materials.size() != written_materials.size();
+  std::vector<int> materials;
+  std::vector<int32_t> old_ids;
+  if (!all_materials) {
+    for (int i = 0; i < model::materials.size(); ++i) {
+      auto state = material_state(*model::materials[i]);
+      if (!(state == written_materials[i])) {
+        materials.push_back(i);
+        old_ids.push_back(written_materials[i].id);
+      }
+    }
+    if (!nuclides && materials.empty()) return;
+  }
+
+  // Display output message
+  write_message("Updating summary.h5 file...", 5);
+
+  record_state();
+  if (settings::async_summary) {
+    background_write = std::async(std::launch::async, update_summary_file,
+      nuclides, all_materials, std::move(materials), std::move(old_ids));
+  } else {
+    update_summary_file(nuclides, all_materials, std::move(materials),
+      std::move(old_ids));
+  }
+}
+
+void wait_summary()
+{
+  if (background_write.valid()) background_write.get();
+}
+
 void write_header(hid_t file)
 {
   // Write filetype and version info
@@ -133,4 +285,12 @@ void write_materials(hid_t file)
   close_group(materials_group);
 }
 
+void free_memory_summary()
+{
+  wait_summary();
+  summary_written = false;
+  n_nuclides_written = 0;
+  written_materials.clear();
+}
+
 } // namespace openmc
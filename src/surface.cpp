@@ -7,11 +7,13 @@
 #include <fmt/core.h>
 #include <gsl/gsl>
 
+#include "openmc/container_util.h"
 #include "openmc/error.h"
 #include "openmc/dagmc.h"
 #include "openmc/hdf5_interface.h"
 #include "openmc/settings.h"
 #include "openmc/string_utils.h"
+#include "openmc/surface_kernel.h"
 #include "openmc/xml_interface.h"
 #include "openmc/random_lcg.h"
 #include "openmc/math_functions.h"
@@ -147,6 +149,7 @@ Surface::Surface(pugi::xml_node surf_node)
     bc_ = BoundaryType::TRANSMIT;
   }
 
+  surf_source_ = contains(settings::source_write_surf_id, id_);
 }
 
 bool
@@ -299,18 +302,52 @@ PeriodicSurface::PeriodicSurface(pugi::xml_node surf_node)
 }
 
 //==============================================================================
-// Generic functions for x-, y-, and z-, planes.
+// CompactSurface implementation
 //==============================================================================
 
-// The template parameter indicates the axis normal to the plane.
-template<int i> double
-axis_aligned_plane_distance(Position r, Direction u, bool coincident, double offset)
-{
-  const double f = offset - r[i];
-  if (coincident || std::abs(f) < FP_COINCIDENT || u[i] == 0.0) return INFTY;
-  const double d = f / u[i];
-  if (d < 0.0) return INFTY;
-  return d;
+constexpr int RayBatch::SIZE;
+
+CompactSurface::CompactSurface(int32_t i_surf)
+  : kind {Kind::OTHER}, index {i_surf}, c {}
+{
+  const Surface* surf = model::surfaces[i_surf].get();
+  if (const auto* s = dynamic_cast<const SurfaceXPlane*>(surf)) {
+    kind = Kind::X_PLANE;
+    c[0] = s->x0_;
+  } else if (const auto* s = dynamic_cast<const SurfaceYPlane*>(surf)) {
+    kind = Kind::Y_PLANE;
+    c[0] = s->y0_;
+  } else if (const auto* s = dynamic_cast<const SurfaceZPlane*>(surf)) {
+    kind = Kind::Z_PLANE;
+    c[0] = s->z0_;
+  } else if (const auto* s = dynamic_cast<const SurfacePlane*>(surf)) {
+    kind = Kind::PLANE;
+    c[0] = s->A_;
+    c[1] = s->B_;
+    c[2] = s->C_;
+    c[3] = s->D_;
+  } else if (const auto* s = dynamic_cast<const SurfaceXCylinder*>(surf)) {
+    kind = Kind::X_CYLINDER;
+    c[0] = s->y0_;
+    c[1] = s->z0_;
+    c[2] = s->radius_;
+  } else if (const auto* s = dynamic_cast<const SurfaceYCylinder*>(surf)) {
+    kind = Kind::Y_CYLINDER;
+    c[0] = s->x0_;
+    c[1] = s->z0_;
+    c[2] = s->radius_;
+  } else if (const auto* s = dynamic_cast<const SurfaceZCylinder*>(surf)) {
+    kind = Kind::Z_CYLINDER;
+    c[0] = s->x0_;
+    c[1] = s->y0_;
+    c[2] = s->radius_;
+  } else if (const auto* s = dynamic_cast<const SurfaceSphere*>(surf)) {
+    kind = Kind::SPHERE;
+    c[0] = s->x0_;
+    c[1] = s->y0_;
+    c[2] = s->z0_;
+    c[3] = s->radius_;
+  }
 }
 
 //==============================================================================
@@ -513,15 +550,7 @@ SurfacePlane::evaluate(Position r) const
 double
 SurfacePlane::distance(Position r, Direction u, bool coincident) const
 {
-  const double f = A_*r.x + B_*r.y + C_*r.z - D_;
-  const double projection = A_*u.x + B_*u.y + C_*u.z;
-  if (coincident || std::abs(f) < FP_COINCIDENT || projection == 0.0) {
-    return INFTY;
-  } else {
-    const double d = -f / projection;
-    if (d < 0.0) return INFTY;
-    return d;
-  }
+  return plane_distance(r, u, coincident, A_, B_, C_, D_);
 }
 
 Direction
@@ -553,81 +582,6 @@ bool SurfacePlane::periodic_translate(const PeriodicSurface* other, Position& r,
   return false;
 }
 
-//==============================================================================
-// Generic functions for x-, y-, and z-, cylinders
-//==============================================================================
-
-// The template parameters indicate the axes perpendicular to the axis of the
-// cylinder.  offset1 and offset2 should correspond with i1 and i2,
-// respectively.
-template<int i1, int i2> double
-axis_aligned_cylinder_evaluate(Position r, double offset1,
-                               double offset2, double radius)
-{
-  const double r1 = r[i1] - offset1;
-  const double r2 = r[i2] - offset2;
-  return r1*r1 + r2*r2 - radius*radius;
-}
-
-// The first template parameter indicates which axis the cylinder is aligned to.
-// The other two parameters indicate the other two axes.  offset1 and offset2
-// should correspond with i2 and i3, respectively.
-template<int i1, int i2, int i3> double
-axis_aligned_cylinder_distance(Position r, Direction u,
-     bool coincident, double offset1, double offset2, double radius)
-{
-  const double a = 1.0 - u[i1]*u[i1];  // u^2 + v^2
-  if (a == 0.0) return INFTY;
-
-  const double r2 = r[i2] - offset1;
-  const double r3 = r[i3] - offset2;
-  const double k = r2 * u[i2] + r3 * u[i3];
-  const double c = r2*r2 + r3*r3 - radius*radius;
-  const double quad = k*k - a*c;
-
-  if (quad < 0.0) {
-    // No intersection with cylinder.
-    return INFTY;
-
-  } else if (coincident || std::abs(c) < FP_COINCIDENT) {
-    // Particle is on the cylinder, thus one distance is positive/negative
-    // and the other is zero. The sign of k determines if we are facing in or
-    // out.
-    if (k >= 0.0) {
-      return INFTY;
-    } else {
-      return (-k + sqrt(quad)) / a;
-    }
-
-  } else if (c < 0.0) {
-    // Particle is inside the cylinder, thus one distance must be negative
-    // and one must be positive. The positive distance will be the one with
-    // negative sign on sqrt(quad).
-    return (-k + sqrt(quad)) / a;
-
-  } else {
-    // Particle is outside the cylinder, thus both distances are either
-    // positive or negative. If positive, the smaller distance is the one
-    // with positive sign on sqrt(quad).
-    const double d = (-k - sqrt(quad)) / a;
-    if (d < 0.0) return INFTY;
-    return d;
-  }
-}
-
-// The first template parameter indicates which axis the cylinder is aligned to.
-// The other two parameters indicate the other two axes.  offset1 and offset2
-// should correspond with i2 and i3, respectively.
-template<int i1, int i2, int i3> Direction
-axis_aligned_cylinder_normal(Position r, double offset1, double offset2)
-{
-  Direction u;
-  u[i2] = 2.0 * (r[i2] - offset1);
-  u[i3] = 2.0 * (r[i3] - offset2);
-  u[i1] = 0.0;
-  return u;
-}
-
 //==============================================================================
 // SurfaceXCylinder implementation
 //==============================================================================
@@ -771,40 +725,7 @@ double SurfaceSphere::evaluate(Position r) const
 
 double SurfaceSphere::distance(Position r, Direction u, bool coincident) const
 {
-  const double x = r.x - x0_;
-  const double y = r.y - y0_;
-  const double z = r.z - z0_;
-  const double k = x*u.x + y*u.y + z*u.z;
-  const double c = x*x + y*y + z*z - radius_*radius_;
-  const double quad = k*k - c;
-
-  if (quad < 0.0) {
-    // No intersection with sphere.
-    return INFTY;
-
-  } else if (coincident || std::abs(c) < FP_COINCIDENT) {
-    // Particle is on the sphere, thus one distance is positive/negative and
-    // the other is zero. The sign of k determines if we are facing in or out.
-    if (k >= 0.0) {
-      return INFTY;
-    } else {
-      return -k + sqrt(quad);
-    }
-
-  } else if (c < 0.0) {
-    // Particle is inside the sphere, thus one distance must be negative and
-    // one must be positive. The positive distance will be the one with
-    // negative sign on sqrt(quad)
-    return -k + sqrt(quad);
-
-  } else {
-    // Particle is outside the sphere, thus both distances are either positive
-    // or negative. If positive, the smaller distance is the one with positive
-    // sign on sqrt(quad).
-    const double d = -k - sqrt(quad);
-    if (d < 0.0) return INFTY;
-    return d;
-  }
+  return sphere_distance(r, u, coincident, x0_, y0_, z0_, radius_);
 }
 
 Direction SurfaceSphere::normal(Position r) const
@@ -829,91 +750,6 @@ BoundingBox SurfaceSphere::bounding_box(bool pos_side) const {
   }
 }
 
-//==============================================================================
-// Generic functions for x-, y-, and z-, cones
-//==============================================================================
-
-// The first template parameter indicates which axis the cone is aligned to.
-// The other two parameters indicate the other two axes.  offset1, offset2,
-// and offset3 should correspond with i1, i2, and i3, respectively.
-template<int i1, int i2, int i3> double
-axis_aligned_cone_evaluate(Position r, double offset1,
-                           double offset2, double offset3, double radius_sq)
-{
-  const double r1 = r[i1] - offset1;
-  const double r2 = r[i2] - offset2;
-  const double r3 = r[i3] - offset3;
-  return r2*r2 + r3*r3 - radius_sq*r1*r1;
-}
-
-// The first template parameter indicates which axis the cone is aligned to.
-// The other two parameters indicate the other two axes.  offset1, offset2,
-// and offset3 should correspond with i1, i2, and i3, respectively.
-template<int i1, int i2, int i3> double
-axis_aligned_cone_distance(Position r, Direction u,
-     bool coincident, double offset1, double offset2, double offset3,
-     double radius_sq)
-{
-  const double r1 = r[i1] - offset1;
-  const double r2 = r[i2] - offset2;
-  const double r3 = r[i3] - offset3;
-  const double a = u[i2]*u[i2] + u[i3]*u[i3]
-                   - radius_sq*u[i1]*u[i1];
-  const double k = r2*u[i2] + r3*u[i3] - radius_sq*r1*u[i1];
-  const double c = r2*r2 + r3*r3 - radius_sq*r1*r1;
-  double quad = k*k - a*c;
-
-  double d;
-
-  if (quad < 0.0) {
-    // No intersection with cone.
-    return INFTY;
-
-  } else if (coincident || std::abs(c) < FP_COINCIDENT) {
-    // Particle is on the cone, thus one distance is positive/negative
-    // and the other is zero. The sign of k determines if we are facing in or
-    // out.
-    if (k >= 0.0) {
-      d = (-k - sqrt(quad)) / a;
-    } else {
-      d = (-k + sqrt(quad)) / a;
-    }
-
-  } else {
-    // Calculate both solutions to the quadratic.
-    quad = sqrt(quad);
-    d = (-k - quad) / a;
-    const double b = (-k + quad) / a;
-
-    // Determine the smallest positive solution.
-    if (d < 0.0) {
-      if (b > 0.0) d = b;
-    } else {
-      if (b > 0.0) {
-        if (b < d) d = b;
-      }
-    }
-  }
-
-  // If the distance was negative, set boundary distance to infinity.
-  if (d <= 0.0) return INFTY;
-  return d;
-}
-
-// The first template parameter indicates which axis the cone is aligned to.
-// The other two parameters indicate the other two axes.  offset1, offset2,
-// and offset3 should correspond with i1, i2, and i3, respectively.
-template<int i1, int i2, int i3> Direction
-axis_aligned_cone_normal(Position r, double offset1, double offset2,
-                         double offset3, double radius_sq)
-{
-  Direction u;
-  u[i1] = -2.0 * radius_sq * (r[i1] - offset1);
-  u[i2] = 2.0 * (r[i2] - offset2);
-  u[i3] = 2.0 * (r[i3] - offset3);
-  return u;
-}
-
 //==============================================================================
 // SurfaceXCone implementation
 //==============================================================================
@@ -1026,77 +862,20 @@ SurfaceQuadric::SurfaceQuadric(pugi::xml_node surf_node)
 double
 SurfaceQuadric::evaluate(Position r) const
 {
-  const double x = r.x;
-  const double y = r.y;
-  const double z = r.z;
-  return x*(A_*x + D_*y + G_) +
-         y*(B_*y + E_*z + H_) +
-         z*(C_*z + F_*x + J_) + K_;
+  return quadric_evaluate(r, A_, B_, C_, D_, E_, F_, G_, H_, J_, K_);
 }
 
 double
 SurfaceQuadric::distance(Position r, Direction ang, bool coincident) const
 {
-  const double &x = r.x;
-  const double &y = r.y;
-  const double &z = r.z;
-  const double &u = ang.x;
-  const double &v = ang.y;
-  const double &w = ang.z;
-
-  const double a = A_*u*u + B_*v*v + C_*w*w + D_*u*v + E_*v*w + F_*u*w;
-  const double k = A_*u*x + B_*v*y + C_*w*z + 0.5*(D_*(u*y + v*x)
-                   + E_*(v*z + w*y) + F_*(w*x + u*z) + G_*u + H_*v + J_*w);
-  const double c = A_*x*x + B_*y*y + C_*z*z + D_*x*y + E_*y*z +  F_*x*z + G_*x
-                   + H_*y + J_*z + K_;
-  double quad = k*k - a*c;
-
-  double d;
-
-  if (quad < 0.0) {
-    // No intersection with surface.
-    return INFTY;
-
-  } else if (coincident || std::abs(c) < FP_COINCIDENT) {
-    // Particle is on the surface, thus one distance is positive/negative and
-    // the other is zero. The sign of k determines which distance is zero and
-    // which is not.
-    if (k >= 0.0) {
-      d = (-k - sqrt(quad)) / a;
-    } else {
-      d = (-k + sqrt(quad)) / a;
-    }
-
-  } else {
-    // Calculate both solutions to the quadratic.
-    quad = sqrt(quad);
-    d = (-k - quad) / a;
-    double b = (-k + quad) / a;
-
-    // Determine the smallest positive solution.
-    if (d < 0.0) {
-      if (b > 0.0) d = b;
-    } else {
-      if (b > 0.0) {
-        if (b < d) d = b;
-      }
-    }
-  }
-
-  // If the distance was negative, set boundary distance to infinity.
-  if (d <= 0.0) return INFTY;
-  return d;
+  return quadric_distance(r, ang, coincident, A_, B_, C_, D_, E_, F_, G_, H_,
+    J_, K_);
 }
 
 Direction
 SurfaceQuadric::normal(Position r) const
 {
-  const double &x = r.x;
-  const double &y = r.y;
-  const double &z = r.z;
-  return {2.0*A_*x + D_*y + F_*z + G_,
-          2.0*B_*y + D_*x + E_*z + H_,
-          2.0*C_*z + E_*y + F_*x + J_};
+  return quadric_normal(r, A_, B_, C_, D_, E_, F_, G_, H_, J_);
 }
 
 void SurfaceQuadric::to_hdf5_inner(hid_t group_id) const
@@ -1180,6 +959,14 @@ void read_surfaces(pugi::xml_node node)
     }
   }
 
+  // Make sure the surfaces of the surface source exist
+  for (int id : settings::source_write_surf_id) {
+    if (model::surface_map.find(id) == model::surface_map.end()) {
+      fatal_error(fmt::format("Surface {} of the surface source does not "
+        "exist.", id));
+    }
+  }
+
   // Find the global bounding box (of periodic BC surfaces).
   double xmin {INFTY}, xmax {-INFTY}, ymin {INFTY}, ymax {-INFTY},
          zmin {INFTY}, zmax {-INFTY};
@@ -9,6 +9,8 @@
 
 #include <fmt/core.h>
 
+#include <algorithm> // for copy, fill
+
 template class std::vector<openmc::TallyDerivative>;
 
 namespace openmc {
@@ -20,8 +22,106 @@ namespace openmc {
 namespace model {
   std::vector<TallyDerivative> tally_derivs;
   std::unordered_map<int, int> tally_deriv_map;
+  bool temperature_derivs {false};
 }
 
+//==============================================================================
+// Helper functions
+//==============================================================================
+
+namespace {
+
+//! Get the derivatives of the multipole cross sections of a nuclide with
+//! respect to temperature, reusing those evaluated with its cross sections if
+//! they are at the same energy and temperature
+std::tuple<double, double, double>
+multipole_deriv(const Particle& p, int i_nuclide, double E)
+{
+  const auto& micro {p.neutron_xs_[i_nuclide]};
+  if (micro.multipole_deriv && micro.last_E == E &&
+      micro.last_sqrtkT == p.sqrtkT_) {
+    return std::make_tuple(micro.dsig_s, micro.dsig_a, micro.dsig_f);
+  }
+  return data::nuclides[i_nuclide]->multipole_->evaluate_deriv(E, p.sqrtkT_);
+}
+
+//! Index of a score among those whose derivatives are computed once per event,
+//! or -1
+int derivative_score_index(int score_bin)
+{
+  switch (score_bin) {
+  case SCORE_TOTAL: return 0;
+  case SCORE_SCATTER: return 1;
+  case SCORE_ABSORPTION: return 2;
+  case SCORE_FISSION: return 3;
+  case SCORE_NU_FISSION: return 4;
+  default: return -1;
+  }
+}
+
+//! Logarithmic derivatives of the reaction rates of an event with respect to
+//! the temperature of its material, as in apply_derivative_to_score()
+void temperature_rates(const Particle& p, TallyEstimator estimator,
+  const Material& material, double* m)
+{
+  const auto& macro {p.macro_xs_};
+  double scatter = macro.total - macro.absorption;
+
+  if (estimator == TallyEstimator::ANALOG) {
+    int i;
+    for (i = 0; i < material.nuclide_.size(); ++i)
+      if (material.nuclide_[i] == p.event_nuclide_) break;
+
+    const auto& nuc {*data::nuclides[p.event_nuclide_]};
+    if (!multipole_in_range(nuc, p.E_last_)) return;
+
+    const auto& micro {p.neutron_xs_[p.event_nuclide_]};
+    double dsig_s, dsig_a, dsig_f;
+    std::tie(dsig_s, dsig_a, dsig_f)
+      = multipole_deriv(p, p.event_nuclide_, p.E_last_);
+    double N = material.atom_density_(i);
+    if (micro.total) m[0] = (dsig_s + dsig_a) * N / macro.total;
+    if (micro.total - micro.absorption) m[1] = dsig_s * N / scatter;
+    if (micro.absorption) m[2] = dsig_a * N / macro.absorption;
+    if (micro.fission) {
+      double nu = micro.nu_fission / micro.fission;
+      m[3] = dsig_f * N / macro.fission;
+      m[4] = nu * dsig_f * N / macro.nu_fission;
+    }
+    return;
+  }
+
+  // Sum the derivatives over the nuclides of the material for all scores in
+  // one pass
+  double cum_dsig[N_DERIV_SCORES] {};
+  for (auto i = 0; i < material.nuclide_.size(); ++i) {
+    auto i_nuc = material.nuclide_[i];
+    const auto& nuc {*data::nuclides[i_nuc]};
+    if (!multipole_in_range(nuc, p.E_last_)) continue;
+
+    const auto& micro {p.neutron_xs_[i_nuc]};
+    if (!micro.total && !micro.absorption && !micro.fission) continue;
+    double dsig_s, dsig_a, dsig_f;
+    std::tie(dsig_s, dsig_a, dsig_f) = multipole_deriv(p, i_nuc, p.E_last_);
+    double N = material.atom_density_(i);
+    if (micro.total) cum_dsig[0] += (dsig_s + dsig_a) * N;
+    if (micro.total - micro.absorption) cum_dsig[1] += dsig_s * N;
+    if (micro.absorption) cum_dsig[2] += dsig_a * N;
+    if (micro.fission) {
+      double nu = micro.nu_fission / micro.fission;
+      cum_dsig[3] += dsig_f * N;
+      cum_dsig[4] += nu * dsig_f * N;
+    }
+  }
+  if (macro.total > 0.0) m[0] = cum_dsig[0] / macro.total;
+  if (scatter) m[1] = cum_dsig[1] / scatter;
+  if (macro.absorption > 0.0) m[2] = cum_dsig[2] / macro.absorption;
+  if (macro.fission > 0.0) m[3] = cum_dsig[3] / macro.fission;
+  if (macro.nu_fission > 0.0) m[4] = cum_dsig[4] / macro.nu_fission;
+}
+
+} // namespace
+
 //==============================================================================
 // TallyDerivative implementation
 //==============================================================================
@@ -90,11 +190,70 @@ read_tally_derivatives(pugi::xml_node node)
     }
   }
 
+  for (const auto& deriv : model::tally_derivs) {
+    if (deriv.variable == DerivativeVariable::TEMPERATURE)
+      model::temperature_derivs = true;
+  }
+
   // Make sure derivatives were not requested for an MG run.
   if (!settings::run_CE && !model::tally_derivs.empty())
     fatal_error("Differential tallies not supported in multi-group mode");
 }
 
+void prepare_derivative_rates(Particle& p, TallyEstimator estimator)
+{
+  p.deriv_rates_.assign(N_DERIV_SCORES*model::tally_derivs.size(), 0.0);
+  p.deriv_rates_estimator_ = estimator;
+
+  // A void material cannot be perturbed, so only flux derivatives apply
+  if (p.material_ == MATERIAL_VOID) return;
+  const Material& material {*model::materials[p.material_]};
+  const auto& macro {p.macro_xs_};
+
+  // Rates with respect to temperature are the same for every derivative on
+  // the material and are only computed for the first one
+  const double* temperature = nullptr;
+
+  for (auto idx = 0; idx < model::tally_derivs.size(); ++idx) {
+    const auto& deriv {model::tally_derivs[idx]};
+    if (deriv.diff_material != material.id_) continue;
+    double* m = &p.deriv_rates_[N_DERIV_SCORES*idx];
+
+    switch (deriv.variable) {
+    case DerivativeVariable::DENSITY:
+      std::fill(m, m + N_DERIV_SCORES, 1. / material.density_gpcc_);
+      break;
+
+    case DerivativeVariable::NUCLIDE_DENSITY:
+      if (estimator == TallyEstimator::ANALOG) {
+        if (p.event_nuclide_ != deriv.diff_nuclide) break;
+        int i;
+        for (i = 0; i < material.nuclide_.size(); ++i)
+          if (material.nuclide_[i] == deriv.diff_nuclide) break;
+        std::fill(m, m + N_DERIV_SCORES, 1. / material.atom_density_(i));
+      } else {
+        const auto& micro {p.neutron_xs_[deriv.diff_nuclide]};
+        double scatter = macro.total - macro.absorption;
+        if (macro.total > 0.0) m[0] = micro.total / macro.total;
+        if (scatter > 0.0) m[1] = (micro.total - micro.absorption) / scatter;
+        if (macro.absorption > 0.0) m[2] = micro.absorption / macro.absorption;
+        if (macro.fission > 0.0) m[3] = micro.fission / macro.fission;
+        if (macro.nu_fission > 0.0) m[4] = micro.nu_fission / macro.nu_fission;
+      }
+      break;
+
+    case DerivativeVariable::TEMPERATURE:
+      if (temperature) {
+        std::copy(temperature, temperature + N_DERIV_SCORES, m);
+      } else {
+        temperature_rates(p, estimator, material, m);
+        temperature = m;
+      }
+      break;
+    }
+  }
+}
+
 void
 apply_derivative_to_score(const Particle& p, int i_tally, int i_nuclide,
   double atom_density, int score_bin, double& score)
@@ -125,6 +284,15 @@ apply_derivative_to_score(const Particle& p, int i_tally, int i_nuclide,
     return;
   }
 
+  // Rates of the whole material, or of the event nuclide for analog tallies,
+  // may have been computed once for the event
+  int k = derivative_score_index(score_bin);
+  if (k >= 0 && p.deriv_rates_estimator_ == tally.estimator_ &&
+      (tally.estimator_ == TallyEstimator::ANALOG || i_nuclide == -1)) {
+    score *= flux_deriv + p.deriv_rates_[N_DERIV_SCORES*tally.deriv_ + k];
+    return;
+  }
+
   switch (deriv.variable) {
 
   //============================================================================
@@ -323,7 +491,7 @@ apply_derivative_to_score(const Particle& p, int i_tally, int i_nuclide,
           if (p.neutron_xs_[p.event_nuclide_].total) {
             double dsig_s, dsig_a, dsig_f;
             std::tie(dsig_s, dsig_a, dsig_f)
-              = nuc.multipole_->evaluate_deriv(p.E_last_, p.sqrtkT_);
+              = multipole_deriv(p, p.event_nuclide_, p.E_last_);
             score *= flux_deriv + (dsig_s + dsig_a) * material.atom_density_(i)
               / p.macro_xs_.total;
           } else {
@@ -336,7 +504,7 @@ apply_derivative_to_score(const Particle& p, int i_tally, int i_nuclide,
               - p.neutron_xs_[p.event_nuclide_].absorption) {
             double dsig_s, dsig_a, dsig_f;
             std::tie(dsig_s, dsig_a, dsig_f)
-              = nuc.multipole_->evaluate_deriv(p.E_last_, p.sqrtkT_);
+              = multipole_deriv(p, p.event_nuclide_, p.E_last_);
             score *= flux_deriv + dsig_s * material.atom_density_(i)
               / (p.macro_xs_.total - p.macro_xs_.absorption);
           } else {
@@ -348,7 +516,7 @@ apply_derivative_to_score(const Particle& p, int i_tally, int i_nuclide,
           if (p.neutron_xs_[p.event_nuclide_].absorption) {
             double dsig_s, dsig_a, dsig_f;
             std::tie(dsig_s, dsig_a, dsig_f)
-              = nuc.multipole_->evaluate_deriv(p.E_last_, p.sqrtkT_);
+              = multipole_deriv(p, p.event_nuclide_, p.E_last_);
             score *= flux_deriv + dsig_a * material.atom_density_(i)
               / p.macro_xs_.absorption;
           } else {
@@ -360,7 +528,7 @@ apply_derivative_to_score(const Particle& p, int i_tally, int i_nuclide,
           if (p.neutron_xs_[p.event_nuclide_].fission) {
             double dsig_s, dsig_a, dsig_f;
             std::tie(dsig_s, dsig_a, dsig_f)
-              = nuc.multipole_->evaluate_deriv(p.E_last_, p.sqrtkT_);
+              = multipole_deriv(p, p.event_nuclide_, p.E_last_);
             score *= flux_deriv + dsig_f * material.atom_density_(i)
               / p.macro_xs_.fission;
           } else {
@@ -374,7 +542,7 @@ apply_derivative_to_score(const Particle& p, int i_tally, int i_nuclide,
               / p.neutron_xs_[p.event_nuclide_].fission;
             double dsig_s, dsig_a, dsig_f;
             std::tie(dsig_s, dsig_a, dsig_f)
-              = nuc.multipole_->evaluate_deriv(p.E_last_, p.sqrtkT_);
+              = multipole_deriv(p, p.event_nuclide_, p.E_last_);
             score *= flux_deriv + nu * dsig_f * material.atom_density_(i)
               / p.macro_xs_.nu_fission;
           } else {
@@ -410,16 +578,15 @@ apply_derivative_to_score(const Particle& p, int i_tally, int i_nuclide,
                 && p.neutron_xs_[i_nuc].total) {
               double dsig_s, dsig_a, dsig_f;
               std::tie(dsig_s, dsig_a, dsig_f)
-                = nuc.multipole_->evaluate_deriv(p.E_last_, p.sqrtkT_);
+                = multipole_deriv(p, i_nuc, p.E_last_);
               cum_dsig += (dsig_s + dsig_a) * material.atom_density_(i);
             }
           }
           score *= flux_deriv + cum_dsig / p.macro_xs_.total;
         } else if (p.neutron_xs_[i_nuclide].total) {
-          const auto& nuc {*data::nuclides[i_nuclide]};
           double dsig_s, dsig_a, dsig_f;
           std::tie(dsig_s, dsig_a, dsig_f)
-            = nuc.multipole_->evaluate_deriv(p.E_last_, p.sqrtkT_);
+            = multipole_deriv(p, i_nuclide, p.E_last_);
           score *= flux_deriv
             + (dsig_s + dsig_a) / p.neutron_xs_[i_nuclide].total;
         } else {
@@ -439,7 +606,7 @@ apply_derivative_to_score(const Particle& p, int i_tally, int i_nuclide,
                 - p.neutron_xs_[i_nuc].absorption)) {
               double dsig_s, dsig_a, dsig_f;
               std::tie(dsig_s, dsig_a, dsig_f)
-                = nuc.multipole_->evaluate_deriv(p.E_last_, p.sqrtkT_);
+                = multipole_deriv(p, i_nuc, p.E_last_);
               cum_dsig += dsig_s * material.atom_density_(i);
             }
           }
@@ -447,10 +614,9 @@ apply_derivative_to_score(const Particle& p, int i_tally, int i_nuclide,
             - p.macro_xs_.absorption);
         } else if (p.neutron_xs_[i_nuclide].total
                    - p.neutron_xs_[i_nuclide].absorption) {
-          const auto& nuc {*data::nuclides[i_nuclide]};
           double dsig_s, dsig_a, dsig_f;
           std::tie(dsig_s, dsig_a, dsig_f)
-            = nuc.multipole_->evaluate_deriv(p.E_last_, p.sqrtkT_);
+            = multipole_deriv(p, i_nuclide, p.E_last_);
           score *= flux_deriv + dsig_s / (p.neutron_xs_[i_nuclide].total
             - p.neutron_xs_[i_nuclide].absorption);
         } else {
@@ -468,16 +634,15 @@ apply_derivative_to_score(const Particle& p, int i_tally, int i_nuclide,
                 && p.neutron_xs_[i_nuc].absorption) {
               double dsig_s, dsig_a, dsig_f;
               std::tie(dsig_s, dsig_a, dsig_f)
-                = nuc.multipole_->evaluate_deriv(p.E_last_, p.sqrtkT_);
+                = multipole_deriv(p, i_nuc, p.E_last_);
               cum_dsig += dsig_a * material.atom_density_(i);
             }
           }
           score *= flux_deriv + cum_dsig / p.macro_xs_.absorption;
         } else if (p.neutron_xs_[i_nuclide].absorption) {
-          const auto& nuc {*data::nuclides[i_nuclide]};
           double dsig_s, dsig_a, dsig_f;
           std::tie(dsig_s, dsig_a, dsig_f)
-            = nuc.multipole_->evaluate_deriv(p.E_last_, p.sqrtkT_);
+            = multipole_deriv(p, i_nuclide, p.E_last_);
           score *= flux_deriv
             + dsig_a / p.neutron_xs_[i_nuclide].absorption;
         } else {
@@ -495,16 +660,15 @@ apply_derivative_to_score(const Particle& p, int i_tally, int i_nuclide,
                 && p.neutron_xs_[i_nuc].fission) {
               double dsig_s, dsig_a, dsig_f;
               std::tie(dsig_s, dsig_a, dsig_f)
-                = nuc.multipole_->evaluate_deriv(p.E_last_, p.sqrtkT_);
+                = multipole_deriv(p, i_nuc, p.E_last_);
               cum_dsig += dsig_f * material.atom_density_(i);
             }
           }
           score *= flux_deriv + cum_dsig / p.macro_xs_.fission;
         } else if (p.neutron_xs_[i_nuclide].fission) {
-          const auto& nuc {*data::nuclides[i_nuclide]};
           double dsig_s, dsig_a, dsig_f;
           std::tie(dsig_s, dsig_a, dsig_f)
-            = nuc.multipole_->evaluate_deriv(p.E_last_, p.sqrtkT_);
+            = multipole_deriv(p, i_nuclide, p.E_last_);
           score *= flux_deriv
             + dsig_f / p.neutron_xs_[i_nuclide].fission;
         } else {
@@ -524,16 +688,15 @@ apply_derivative_to_score(const Particle& p, int i_tally, int i_nuclide,
                 / p.neutron_xs_[i_nuc].fission;
               double dsig_s, dsig_a, dsig_f;
               std::tie(dsig_s, dsig_a, dsig_f)
-                = nuc.multipole_->evaluate_deriv(p.E_last_, p.sqrtkT_);
+                = multipole_deriv(p, i_nuc, p.E_last_);
               cum_dsig += nu * dsig_f * material.atom_density_(i);
             }
           }
           score *= flux_deriv + cum_dsig / p.macro_xs_.nu_fission;
         } else if (p.neutron_xs_[i_nuclide].fission) {
-          const auto& nuc {*data::nuclides[i_nuclide]};
           double dsig_s, dsig_a, dsig_f;
           std::tie(dsig_s, dsig_a, dsig_f)
-            = nuc.multipole_->evaluate_deriv(p.E_last_, p.sqrtkT_);
+            = multipole_deriv(p, i_nuclide, p.E_last_);
           score *= flux_deriv
             + dsig_f / p.neutron_xs_[i_nuclide].fission;
         } else {
@@ -594,7 +757,7 @@ score_track_derivative(Particle& p, double distance)
           // (1 / phi) * (d_phi / d_T) = - N (d_sigma_tot / d_T) * dist
           double dsig_s, dsig_a, dsig_f;
           std::tie(dsig_s, dsig_a, dsig_f)
-            = nuc.multipole_->evaluate_deriv(p.E_, p.sqrtkT_);
+            = multipole_deriv(p, material.nuclide_[i], p.E_);
           flux_deriv -= distance * (dsig_s + dsig_a)
             * material.atom_density_(i);
         }
@@ -656,7 +819,7 @@ void score_collision_derivative(Particle& p)
           const auto& micro_xs {p.neutron_xs_[i_nuc]};
           double dsig_s, dsig_a, dsig_f;
           std::tie(dsig_s, dsig_a, dsig_f)
-            = nuc.multipole_->evaluate_deriv(p.E_last_, p.sqrtkT_);
+            = multipole_deriv(p, i_nuc, p.E_last_);
           flux_deriv += dsig_s / (micro_xs.total - micro_xs.absorption);
           // Note that this is an approximation!  The real scattering cross
           // section is
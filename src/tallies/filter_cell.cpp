@@ -5,6 +5,7 @@
 #include "openmc/capi.h"
 #include "openmc/cell.h"
 #include "openmc/error.h"
+#include "openmc/geometry.h"
 #include "openmc/xml_interface.h"
 
 namespace openmc {
@@ -39,6 +40,7 @@ CellFilter::set_cells(gsl::span<int32_t> cells)
     Expects(index >= 0);
     Expects(index < model::cells.size());
     cells_.push_back(index);
+    if (index >= map_.size()) map_.resize(index + 1, C_NONE);
     map_[index] = cells_.size() - 1;
   }
 
@@ -50,14 +52,21 @@ CellFilter::get_all_bins(const Particle& p, TallyEstimator estimator,
                          FilterMatch& match) const
 {
   for (int i = 0; i < p.n_coord_; i++) {
-    auto search = map_.find(p.coord_[i].cell);
-    if (search != map_.end()) {
-      match.bins_.push_back(search->second);
+    int bin = find_bin(p.coord_[i].cell);
+    if (bin != C_NONE) {
+      match.bins_.push_back(bin);
       match.weights_.push_back(1.0);
     }
   }
 }
 
+int
+CellFilter::max_bins_per_event() const
+{
+  // A match is possible at each coordinate level
+  return model::n_coord_levels;
+}
+
 void
 CellFilter::to_statepoint(hid_t filter_group) const
 {
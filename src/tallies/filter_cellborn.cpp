@@ -8,9 +8,9 @@ void
 CellbornFilter::get_all_bins(const Particle& p, TallyEstimator estimator,
                              FilterMatch& match) const
 {
-  auto search = map_.find(p.cell_born_);
-  if (search != map_.end()) {
-    match.bins_.push_back(search->second);
+  int bin = find_bin(p.cell_born_);
+  if (bin != C_NONE) {
+    match.bins_.push_back(bin);
     match.weights_.push_back(1.0);
   }
 }
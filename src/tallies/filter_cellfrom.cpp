@@ -9,9 +9,9 @@ CellFromFilter::get_all_bins(const Particle& p, TallyEstimator estimator,
                              FilterMatch& match) const
 {
   for (int i = 0; i < p.n_coord_last_; i++) {
-    auto search = map_.find(p.cell_last_[i]);
-    if (search != map_.end()) {
-      match.bins_.push_back(search->second);
+    int bin = find_bin(p.cell_last_[i]);
+    if (bin != C_NONE) {
+      match.bins_.push_back(bin);
       match.weights_.push_back(1.0);
     }
   }
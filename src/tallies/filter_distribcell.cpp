@@ -41,6 +41,15 @@ void
 DistribcellFilter::get_all_bins(const Particle& p, TallyEstimator estimator,
                                 FilterMatch& match) const
 {
+  // The instance of the material cell the particle is in was found along
+  // with the cell, so only cells filled with universes or lattices need the
+  // offsets of the coordinate levels to be summed
+  if (p.coord_[p.n_coord_ - 1].cell == cell_) {
+    match.bins_.push_back(p.cell_instance_);
+    match.weights_.push_back(1.0);
+    return;
+  }
+
   int offset = 0;
   auto distribcell_index = model::cells[cell_]->distribcell_index_;
   for (int i = 0; i < p.n_coord_; i++) {
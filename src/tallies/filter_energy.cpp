@@ -1,16 +1,86 @@
 #include "openmc/tallies/filter_energy.h"
 
+#include <cmath> // for abs, exp, log
+
 #include <fmt/core.h>
 
 #include "openmc/capi.h"
 #include "openmc/constants.h"  // For F90_NONE
 #include "openmc/mgxs_interface.h"
-#include "openmc/search.h"
 #include "openmc/settings.h"
 #include "openmc/xml_interface.h"
 
 namespace openmc {
 
+//==============================================================================
+// EnergyBinIndex implementation
+//==============================================================================
+
+void
+EnergyBinIndex::build(const std::vector<double>& edges)
+{
+  // Relative tolerance on the spacing of edges, whose rounding when they are
+  // written out is absorbed by refining the result against them
+  constexpr double rtol {1.0e-6};
+
+  int n_bins = edges.size() - 1;
+  spacing_ = Spacing::SEARCH;
+  if (n_bins < 1) return;
+
+  double width = (edges.back() - edges.front()) / n_bins;
+  bool uniform = true;
+  for (int i = 0; i < n_bins; ++i) {
+    if (std::abs(edges[i + 1] - edges[i] - width) > rtol*width) {
+      uniform = false;
+      break;
+    }
+  }
+  if (uniform) {
+    spacing_ = Spacing::UNIFORM;
+    origin_ = edges.front();
+    inv_width_ = 1.0 / width;
+    return;
+  }
+
+  if (edges.front() > 0.0) {
+    double u = std::log(edges.back() / edges.front()) / n_bins;
+    bool lethargy = true;
+    for (int i = 0; i < n_bins; ++i) {
+      if (std::abs(std::log(edges[i + 1] / edges[i]) - u) > rtol*u) {
+        lethargy = false;
+        break;
+      }
+    }
+    if (lethargy) {
+      spacing_ = Spacing::LETHARGY;
+      origin_ = std::log(edges.front());
+      inv_width_ = 1.0 / u;
+      return;
+    }
+  }
+
+  // Index the edges from the first positive one with a few cells per bin
+  first_ = 0;
+  while (first_ < n_bins - 1 && edges[first_] <= 0.0) ++first_;
+  if (edges[first_] <= 0.0) {
+    spacing_ = Spacing::SEARCH;
+    return;
+  }
+  spacing_ = Spacing::HASHED;
+  int n_cells = std::max(64, 4*n_bins);
+  origin_ = std::log(edges[first_]);
+  double u = (std::log(edges.back()) - origin_) / n_cells;
+  inv_width_ = 1.0 / u;
+
+  cell_bin_.resize(n_cells);
+  int i = first_;
+  for (int k = 0; k < n_cells; ++k) {
+    double E = std::exp(origin_ + k*u);
+    while (i < n_bins - 1 && E > edges[i + 1]) ++i;
+    cell_bin_[k] = i;
+  }
+}
+
 //==============================================================================
 // EnergyFilter implementation
 //==============================================================================
@@ -38,6 +108,7 @@ EnergyFilter::set_bins(gsl::span<const double> bins)
   }
 
   n_bins_ = bins_.size() - 1;
+  index_.build(bins_);
 
   // In MG mode, check if the filter bins match the transport bins.
   // We can save tallying time if we know that the tally bins match the energy
@@ -75,8 +146,7 @@ const
 
     // Bin the energy.
     if (E >= bins_.front() && E <= bins_.back()) {
-      auto bin = lower_bound_index(bins_.begin(), bins_.end(), E);
-      match.bins_.push_back(bin);
+      match.bins_.push_back(find_bin(E));
       match.weights_.push_back(1.0);
     }
   }
@@ -109,8 +179,7 @@ EnergyoutFilter::get_all_bins(const Particle& p, TallyEstimator estimator,
 
   } else {
     if (p.E_ >= bins_.front() && p.E_ <= bins_.back()) {
-      auto bin = lower_bound_index(bins_.begin(), bins_.end(), p.E_);
-      match.bins_.push_back(bin);
+      match.bins_.push_back(find_bin(p.E_));
       match.weights_.push_back(1.0);
     }
   }
@@ -3,7 +3,6 @@
 #include <fmt/core.h>
 
 #include "openmc/error.h"
-#include "openmc/search.h"
 #include "openmc/settings.h"
 #include "openmc/xml_interface.h"
 
@@ -50,6 +49,7 @@ EnergyFunctionFilter::set_data(gsl::span<const double> energy,
     energy_.push_back(energy[i]);
     y_.push_back(y[i]);
   }
+  index_.build(energy_);
 }
 
 void
@@ -58,7 +58,7 @@ EnergyFunctionFilter::get_all_bins(const Particle& p, TallyEstimator estimator,
 {
   if (p.E_last_ >= energy_.front() && p.E_last_ <= energy_.back()) {
     // Search for the incoming energy bin.
-    auto i = lower_bound_index(energy_.begin(), energy_.end(), p.E_last_);
+    auto i = index_.find(energy_, p.E_last_);
 
     // Compute the interpolation factor between the nearest bins.
     double f = (p.E_last_ - energy_[i]) / (energy_[i+1] - energy_[i]);
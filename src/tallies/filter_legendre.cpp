@@ -27,11 +27,12 @@ void
 LegendreFilter::get_all_bins(const Particle& p, TallyEstimator estimator,
                              FilterMatch& match) const
 {
-  std::vector<double> wgt(n_bins_);
-  calc_pn_c(order_, p.mu_, wgt.data());
+  // The weights are computed in place to avoid allocating on every event
+  auto n = match.weights_.size();
+  match.weights_.resize(n + n_bins_);
+  calc_pn_c(order_, p.mu_, match.weights_.data() + n);
   for (int i = 0; i < n_bins_; i++) {
     match.bins_.push_back(i);
-    match.weights_.push_back(wgt[i]);
   }
 }
 
@@ -38,6 +38,7 @@ MaterialFilter::set_materials(gsl::span<const int32_t> materials)
     Expects(index >= 0);
     Expects(index < model::materials.size());
     materials_.push_back(index);
+    if (index >= map_.size()) map_.resize(index + 1, C_NONE);
     map_[index] = materials_.size() - 1;
   }
 
@@ -48,9 +49,9 @@ void
 MaterialFilter::get_all_bins(const Particle& p, TallyEstimator estimator,
                              FilterMatch& match) const
 {
-  auto search = map_.find(p.material_);
-  if (search != map_.end()) {
-    match.bins_.push_back(search->second);
+  int bin = find_bin(p.material_);
+  if (bin != C_NONE) {
+    match.bins_.push_back(bin);
     match.weights_.push_back(1.0);
   }
 }
@@ -30,10 +30,49 @@ MeshFilter::from_xml(pugi::xml_node node)
   }
 }
 
+void
+MeshFilter::bins_and_surfaces_crossed(const Particle& p,
+  Particle::MeshTrack& track) const
+{
+  const auto& m {static_cast<const RegularMesh&>(*model::meshes[mesh_])};
+
+  // The surfaces crossed since the last collision or source site are gathered
+  // over the consecutive tracks ending there, as long as none was skipped
+  if (p.r_last_ == p.r_last_current_) {
+    track.surface_bins.clear();
+    track.surface_start = p.r_last_;
+    track.surfaces_present = true;
+  } else if (!track.surfaces_present || track.surface_end != p.r_last_) {
+    track.surfaces_present = false;
+  }
+
+  if (track.surfaces_present) {
+    m.bins_and_surfaces_crossed(p, track.bins, track.lengths,
+      track.surface_bins);
+    track.surface_end = p.r();
+  } else {
+    m.bins_crossed(p, track.bins, track.lengths);
+  }
+}
+
 void
 MeshFilter::get_all_bins(const Particle& p, TallyEstimator estimator, FilterMatch& match)
 const
 {
+  // The bin of a mesh aligned with a lattice is the lattice tile of the
+  // particle. Tracks end at lattice boundaries, so a whole track lies in it.
+  if (model::meshes[mesh_]->aligned_lattice_ != C_NONE) {
+    const auto& m {static_cast<const StructuredMesh&>(*model::meshes[mesh_])};
+    int bin;
+    if (m.lattice_bin(p, bin)) {
+      if (bin >= 0) {
+        match.bins_.push_back(bin);
+        match.weights_.push_back(1.0);
+      }
+      return;
+    }
+  }
+
   if (estimator != TallyEstimator::TRACKLENGTH) {
     auto bin = model::meshes[mesh_]->get_bin(p.r());
     if (bin >= 0) {
@@ -41,7 +80,30 @@ const
       match.weights_.push_back(1.0);
     }
   } else {
-    model::meshes[mesh_]->bins_crossed(p, match.bins_, match.weights_);
+    const auto& m {*model::meshes[mesh_]};
+    if (!m.shared_tracks_ && !m.fused_surfaces_) {
+      m.bins_crossed(p, match.bins_, match.weights_);
+      return;
+    }
+
+    // Other tallies on the same mesh reuse the bins crossed by this track
+    if (p.mesh_tracks_.size() <= static_cast<size_t>(mesh_)) {
+      p.mesh_tracks_.resize(mesh_ + 1);
+    }
+    auto& track {p.mesh_tracks_[mesh_]};
+    if (!track.present) {
+      track.bins.clear();
+      track.lengths.clear();
+      if (m.fused_surfaces_) {
+        bins_and_surfaces_crossed(p, track);
+      } else {
+        m.bins_crossed(p, track.bins, track.lengths);
+      }
+      track.present = true;
+    }
+    match.bins_.insert(match.bins_.end(), track.bins.begin(), track.bins.end());
+    match.weights_.insert(match.weights_.end(), track.lengths.begin(),
+      track.lengths.end());
   }
 }
 
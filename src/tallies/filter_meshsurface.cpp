@@ -1,5 +1,7 @@
 #include "openmc/tallies/filter_meshsurface.h"
 
+#include <fmt/core.h>
+
 #include "openmc/capi.h"
 #include "openmc/constants.h"
 #include "openmc/error.h"
@@ -11,7 +13,21 @@ void
 MeshSurfaceFilter::get_all_bins(const Particle& p, TallyEstimator estimator,
                                 FilterMatch& match) const
 {
-  model::meshes[mesh_]->surface_bins_crossed(p, match.bins_);
+  // The surfaces crossed may have been found with the bins crossed by the
+  // tracks since the start of this segment
+  const auto& m {*model::meshes[mesh_]};
+  if (m.fused_surfaces_ && p.mesh_tracks_.size() > static_cast<size_t>(mesh_)) {
+    const auto& track {p.mesh_tracks_[mesh_]};
+    if (track.surfaces_present && track.surface_start == p.r_last_current_ &&
+        track.surface_end == p.r()) {
+      match.bins_.insert(match.bins_.end(), track.surface_bins.begin(),
+        track.surface_bins.end());
+      for (auto b : match.bins_) match.weights_.push_back(1.0);
+      return;
+    }
+  }
+
+  m.surface_bins_crossed(p, match.bins_);
   for (auto b : match.bins_) match.weights_.push_back(1.0);
 }
 
@@ -74,6 +90,10 @@ MeshSurfaceFilter::text_label(int bin) const
 void
 MeshSurfaceFilter::set_mesh(int32_t mesh)
 {
+  if (dynamic_cast<const AdaptiveMesh*>(model::meshes[mesh].get())) {
+    fatal_error(fmt::format("Mesh surface filters can't be used with adaptive "
+      "mesh {}.", model::meshes[mesh]->id_));
+  }
   mesh_ = mesh;
   n_bins_ = model::meshes[mesh_]->n_surface_bins();
 }
@@ -48,31 +48,31 @@ void
 SphericalHarmonicsFilter::get_all_bins(const Particle& p, TallyEstimator estimator,
                                        FilterMatch& match) const
 {
-  // Determine cosine term for scatter expansion if necessary
-  std::vector<double> wgt(order_ + 1);
-  if (cosine_ == SphericalHarmonicsCosine::scatter) {
-    calc_pn_c(order_, p.mu_, wgt.data());
-  } else {
-    for (int i = 0; i < order_ + 1; i++) {
-      wgt[i] = 1;
+  // The Rn,m values are computed in place to avoid allocating on every event,
+  // followed by the cosine terms of a scatter expansion, which are dropped
+  // once applied
+  bool scatter = (cosine_ == SphericalHarmonicsCosine::scatter);
+  auto n0 = match.weights_.size();
+  match.weights_.resize(n0 + n_bins_ + (scatter ? order_ + 1 : 0));
+  double* rn = match.weights_.data() + n0;
+  calc_rn(order_, p.u_last_, rn);
+
+  if (scatter) {
+    double* wgt = rn + n_bins_;
+    calc_pn_c(order_, p.mu_, wgt);
+    int j = 0;
+    for (int n = 0; n < order_ + 1; n++) {
+      // Scale the n-th order spherical harmonics for (u,v,w)
+      int num_nm = 2*n + 1;
+      for (int i = 0; i < num_nm; i++) {
+        rn[j++] *= wgt[n];
+      }
     }
+    match.weights_.resize(n0 + n_bins_);
   }
 
-  // Find the Rn,m values
-  std::vector<double> rn(n_bins_);
-  calc_rn(order_, p.u_last_, rn.data());
-
-  int j = 0;
-  for (int n = 0; n < order_ + 1; n++) {
-    // Calculate n-th order spherical harmonics for (u,v,w)
-    int num_nm = 2*n + 1;
-
-    // Append the matching (bin,weight) for each moment
-    for (int i = 0; i < num_nm; i++) {
-      match.weights_.push_back(wgt[n] * rn[j]);
-      match.bins_.push_back(j);
-      ++j;
-    }
+  for (int j = 0; j < n_bins_; j++) {
+    match.bins_.push_back(j);
   }
 }
 
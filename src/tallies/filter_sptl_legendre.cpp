@@ -81,11 +81,11 @@ SpatialLegendreFilter::get_all_bins(const Particle& p, TallyEstimator estimator,
     double x_norm = 2.0*(x - min_) / (max_ - min_) - 1.0;
 
     // Compute and return the Legendre weights.
-    std::vector<double> wgt(order_ + 1);
-    calc_pn_c(order_, x_norm, wgt.data());
+    auto n = match.weights_.size();
+    match.weights_.resize(n + order_ + 1);
+    calc_pn_c(order_, x_norm, match.weights_.data() + n);
     for (int i = 0; i < order_ + 1; i++) {
       match.bins_.push_back(i);
-      match.weights_.push_back(wgt[i]);
     }
   }
 }
@@ -40,6 +40,7 @@ SurfaceFilter::set_surfaces(gsl::span<int32_t> surfaces)
     Expects(index >= 0);
     Expects(index < model::surfaces.size());
     surfaces_.push_back(index);
+    if (index >= map_.size()) map_.resize(index + 1, C_NONE);
     map_[index] = surfaces_.size() - 1;
   }
 
@@ -50,9 +51,9 @@ void
 SurfaceFilter::get_all_bins(const Particle& p, TallyEstimator estimator,
                             FilterMatch& match) const
 {
-  auto search = map_.find(std::abs(p.surface_)-1);
-  if (search != map_.end()) {
-    match.bins_.push_back(search->second);
+  int bin = find_bin(std::abs(p.surface_)-1);
+  if (bin != C_NONE) {
+    match.bins_.push_back(bin);
     if (p.surface_ < 0) {
       match.weights_.push_back(-1.0);
     } else {
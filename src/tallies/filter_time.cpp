@@ -0,0 +1,89 @@
+#include "openmc/tallies/filter_time.h"
+
+#include <algorithm> // for max, min
+
+#include <fmt/core.h>
+
+#include "openmc/search.h"
+#include "openmc/xml_interface.h"
+
+namespace openmc {
+
+//==============================================================================
+// TimeFilter implementation
+//==============================================================================
+
+void
+TimeFilter::from_xml(pugi::xml_node node)
+{
+  auto bins = get_node_array<double>(node, "bins");
+  this->set_bins(bins);
+}
+
+void
+TimeFilter::set_bins(gsl::span<const double> bins)
+{
+  // Clear existing bins
+  bins_.clear();
+  bins_.reserve(bins.size());
+
+  // Copy bins, ensuring they are valid
+  for (gsl::index i = 0; i < bins.size(); ++i) {
+    if (bins[i] < 0.0) {
+      throw std::runtime_error{"Time bins must be non-negative."};
+    }
+    if (i > 0 && bins[i] <= bins[i-1]) {
+      throw std::runtime_error{"Time bins must be monotonically increasing."};
+    }
+    bins_.push_back(bins[i]);
+  }
+
+  n_bins_ = bins_.size() - 1;
+}
+
+void
+TimeFilter::get_all_bins(const Particle& p, TallyEstimator estimator,
+                         FilterMatch& match) const
+{
+  double t_end = p.time_;
+  double t_start = (estimator == TallyEstimator::TRACKLENGTH) ?
+    p.time_last_ : t_end;
+
+  if (t_end <= t_start) {
+    // The event happens at a single time
+    if (t_end >= bins_.front() && t_end < bins_.back()) {
+      auto bin = upper_bound_index(bins_.begin(), bins_.end(), t_end);
+      match.bins_.push_back(bin);
+      match.weights_.push_back(1.0);
+    }
+    return;
+  }
+
+  // Divide the track among the bins it overlaps
+  if (t_end <= bins_.front() || t_start >= bins_.back()) return;
+  double dt = t_end - t_start;
+  int i_start = (t_start < bins_.front()) ? 0 :
+    upper_bound_index(bins_.begin(), bins_.end(), t_start);
+  for (int i = i_start; i < n_bins_; ++i) {
+    if (bins_[i] >= t_end) break;
+    double overlap = std::min(bins_[i + 1], t_end) -
+      std::max(bins_[i], t_start);
+    match.bins_.push_back(i);
+    match.weights_.push_back(overlap / dt);
+  }
+}
+
+void
+TimeFilter::to_statepoint(hid_t filter_group) const
+{
+  Filter::to_statepoint(filter_group);
+  write_dataset(filter_group, "bins", bins_);
+}
+
+std::string
+TimeFilter::text_label(int bin) const
+{
+  return fmt::format("Time [{}, {})", bins_[bin], bins_[bin+1]);
+}
+
+} // namespace openmc
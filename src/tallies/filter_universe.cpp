@@ -4,6 +4,7 @@
 
 #include "openmc/cell.h"
 #include "openmc/error.h"
+#include "openmc/geometry.h"
 #include "openmc/xml_interface.h"
 
 namespace openmc {
@@ -38,6 +39,7 @@ UniverseFilter::set_universes(gsl::span<int32_t> universes)
     Expects(index >= 0);
     Expects(index < model::universes.size());
     universes_.push_back(index);
+    if (index >= map_.size()) map_.resize(index + 1, C_NONE);
     map_[index] = universes_.size() - 1;
   }
 
@@ -49,14 +51,21 @@ UniverseFilter::get_all_bins(const Particle& p, TallyEstimator estimator,
                              FilterMatch& match) const
 {
   for (int i = 0; i < p.n_coord_; i++) {
-    auto search = map_.find(p.coord_[i].universe);
-    if (search != map_.end()) {
-      match.bins_.push_back(search->second);
+    int bin = find_bin(p.coord_[i].universe);
+    if (bin != C_NONE) {
+      match.bins_.push_back(bin);
       match.weights_.push_back(1.0);
     }
   }
 }
 
+int
+UniverseFilter::max_bins_per_event() const
+{
+  // A match is possible at each coordinate level
+  return model::n_coord_levels;
+}
+
 void
 UniverseFilter::to_statepoint(hid_t filter_group) const
 {
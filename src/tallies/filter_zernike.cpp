@@ -39,11 +39,11 @@ ZernikeFilter::get_all_bins(const Particle& p, TallyEstimator estimator,
 
   if (r <= 1.0) {
     // Compute and return the Zernike weights.
-    std::vector<double> zn(n_bins_);
-    calc_zn(order_, r, theta, zn.data());
+    auto n = match.weights_.size();
+    match.weights_.resize(n + n_bins_);
+    calc_zn(order_, r, theta, match.weights_.data() + n);
     for (int i = 0; i < n_bins_; i++) {
       match.bins_.push_back(i);
-      match.weights_.push_back(zn[i]);
     }
   }
 }
@@ -98,11 +98,11 @@ ZernikeRadialFilter::get_all_bins(const Particle& p, TallyEstimator estimator,
 
   if (r <= 1.0) {
     // Compute and return the Zernike weights.
-    std::vector<double> zn(n_bins_);
-    calc_zn_rad(order_, r, zn.data());
+    auto n = match.weights_.size();
+    match.weights_.resize(n + n_bins_);
+    calc_zn_rad(order_, r, match.weights_.data() + n);
     for (int i = 0; i < n_bins_; i++) {
       match.bins_.push_back(i);
-      match.weights_.push_back(zn[i]);
     }
   }
 }
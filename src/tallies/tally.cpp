@@ -2,8 +2,12 @@
 
 #include "openmc/capi.h"
 #include "openmc/constants.h"
+#include "openmc/container_util.h"
+#include "openmc/delta_tracking.h"
+#include "openmc/domain_decomposition.h"
 #include "openmc/error.h"
 #include "openmc/file_utils.h"
+#include "openmc/hdf5_interface.h"
 #include "openmc/message_passing.h"
 #include "openmc/mesh.h"
 #include "openmc/mgxs_interface.h"
@@ -14,6 +18,7 @@
 #include "openmc/settings.h"
 #include "openmc/simulation.h"
 #include "openmc/source.h"
+#include "openmc/state_point.h"
 #include "openmc/tallies/derivative.h"
 #include "openmc/tallies/filter.h"
 #include "openmc/tallies/filter_cell.h"
@@ -21,21 +26,26 @@
 #include "openmc/tallies/filter_delayedgroup.h"
 #include "openmc/tallies/filter_energy.h"
 #include "openmc/tallies/filter_legendre.h"
+#include "openmc/tallies/filter_material.h"
 #include "openmc/tallies/filter_mesh.h"
 #include "openmc/tallies/filter_meshsurface.h"
 #include "openmc/tallies/filter_particle.h"
 #include "openmc/tallies/filter_sph_harm.h"
 #include "openmc/tallies/filter_surface.h"
+#include "openmc/tallies/tally_scoring.h"
 #include "openmc/xml_interface.h"
 
 #include <fmt/core.h>
 #include "xtensor/xadapt.hpp"
-#include "xtensor/xbuilder.hpp" // for empty_like
+#include "xtensor/xbuilder.hpp" // for empty, empty_like
 #include "xtensor/xview.hpp"
 
-#include <algorithm> // for max
+#include <algorithm> // for find, max, min, sort, unique
 #include <array>
+#include <cmath> // for sqrt
 #include <cstddef> // for size_t
+#include <limits>  // for numeric_limits
+#include <mutex>   // for lock_guard
 #include <string>
 
 namespace openmc {
@@ -53,6 +63,9 @@ namespace model {
   std::vector<int> active_collision_tallies;
   std::vector<int> active_meshsurf_tallies;
   std::vector<int> active_surface_tallies;
+  std::vector<int> active_history_tallies;
+  TallyDomainIndex tracklength_tally_index;
+  TallyDomainIndex collision_tally_index;
 }
 
 namespace simulation {
@@ -65,6 +78,35 @@ double global_tally_collision;
 double global_tally_tracklength;
 double global_tally_leakage;
 
+namespace {
+
+//! Fewest values of a tally for its accumulation to be divided among threads
+constexpr int64_t MIN_PARALLEL_VALUES {16384};
+
+//! Normalization of the values of a realization of a tally
+
+double realization_norm()
+{
+  // Calculate total source strength for normalization
+  double total_source = 0.0;
+  if (settings::run_mode == RunMode::FIXED_SOURCE) {
+    for (const auto& s : model::external_sources) {
+      total_source += s.strength();
+    }
+  } else {
+    total_source = 1.0;
+  }
+
+  // Account for number of source particles in normalization
+  return total_source / (settings::n_particles * settings::gen_per_batch);
+}
+
+//! Normalization of the scores of one history of a tally with history
+//! statistics, set when the active tallies are
+double history_norm {1.0};
+
+} // namespace
+
 int
 score_str_to_int(std::string score_str)
 {
@@ -239,6 +281,19 @@ score_str_to_int(std::string score_str)
   return MT;
 }
 
+//==============================================================================
+// TallyProfile implementation
+//==============================================================================
+
+TallyProfile& TallyProfile::operator+=(const TallyProfile& other)
+{
+  n_events += other.n_events;
+  filter_time += other.filter_time;
+  n_bins += other.n_bins;
+  n_updates += other.n_updates;
+  return *this;
+}
+
 //==============================================================================
 // Tally object implementation
 //==============================================================================
@@ -378,6 +433,25 @@ Tally::Tally(pugi::xml_node node)
     }
   }
 
+  // Tabulated material cross sections do not give the microscopic photon
+  // cross sections needed for total scores of individual nuclides
+  if (settings::photon_transport && settings::photon_material_tables &&
+      contains(scores_, SCORE_TOTAL) &&
+      std::any_of(nuclides_.begin(), nuclides_.end(),
+        [](int i_nuclide) { return i_nuclide >= 0; })) {
+    bool photons = true;
+    if (particle_filter_index >= 0) {
+      const auto& f = model::tally_filters[particle_filter_index].get();
+      photons = contains(dynamic_cast<ParticleFilter*>(f)->particles(),
+        Particle::Type::photon);
+    }
+    if (photons) {
+      fatal_error(fmt::format("Total scores of individual nuclides for "
+        "photons on tally {} are not supported with photon material tables.",
+        id_));
+    }
+  }
+
   // Check for a tally derivative.
   if (check_for_node(node, "derivative")) {
     int deriv_id = std::stoi(get_node_value(node, "derivative"));
@@ -456,6 +530,33 @@ Tally::Tally(pugi::xml_node node)
         "Invalid estimator '{}' on tally {}", est, id_)};
     }
   }
+
+  // Check whether only the scored bins should be stored
+  if (check_for_node(node, "sparse_results")) {
+    sparse_ = get_node_value_bool(node, "sparse_results");
+  }
+
+  // Check whether the bins should be divided among processes
+  if (check_for_node(node, "decomposed")) {
+    decomposed_ = get_node_value_bool(node, "decomposed");
+  }
+
+  // Check whether each history is a realization
+  if (check_for_node(node, "history_statistics")) {
+    history_ = get_node_value_bool(node, "history_statistics");
+  }
+
+  // Surfaces within delta-tracked regions are never crossed
+  if (type_ == TallyType::SURFACE) check_delta_tracking_surface_tally(*this);
+
+  // Track lengths through the contents of delta-tracking cells are not known
+  if (estimator_ == TallyEstimator::TRACKLENGTH &&
+      delta_tracking_overlaps(*this)) {
+    estimator_ = TallyEstimator::COLLISION;
+    warning(fmt::format("Tally {} uses a collision estimator instead of a "
+      "track-length estimator since it can score within delta-tracked "
+      "regions.", id_));
+  }
 }
 
 Tally::~Tally()
@@ -793,49 +894,741 @@ Tally::init_triggers(pugi::xml_node node)
 
 void Tally::init_results()
 {
+#ifdef _OPENMP
+  int n_threads = omp_get_max_threads();
+#else
+  int n_threads = 1;
+#endif
+
+  // Each thread counts the cost of scoring the tally separately
+  thread_profiles_.clear();
+  if (settings::tally_profiling) thread_profiles_.resize(n_threads);
+  profile_ = {};
+
+  if (sparse_ && decomposed_) {
+    fatal_error(fmt::format("Tally {} cannot use both sparse and decomposed "
+      "results.", id_));
+  }
+
+  // Tallies with history statistics fold the scores of each history into
+  // their sums when it ends, so only the sums are stored. Each thread collects
+  // the scores of its history, which requires the whole history to be run on
+  // one thread.
+  history_values_.clear();
+  if (history_) {
+    if (sparse_ || decomposed_) {
+      fatal_error(fmt::format("Tally {} cannot use history statistics with "
+        "sparse or decomposed results.", id_));
+    }
+    if (settings::event_based) {
+      fatal_error(fmt::format("Tally {} cannot use history statistics with "
+        "event-based transport.", id_));
+    }
+    if (settings::history_interleave > 1) {
+      fatal_error(fmt::format("Tally {} cannot use history statistics with "
+        "interleaved histories.", id_));
+    }
+    int64_t n_histories = static_cast<int64_t>(settings::n_particles) *
+      settings::gen_per_batch * (settings::n_max_batches - settings::n_inactive);
+    if (n_histories > std::numeric_limits<int>::max()) {
+      fatal_error(fmt::format("Tally {} cannot use history statistics for more "
+        "than {} histories.", id_, std::numeric_limits<int>::max()));
+    }
+    int n_scores = scores_.size() * nuclides_.size();
+    values_ = xt::xtensor<double, 2>();
+    results_ = xt::empty<double>({n_filter_bins_, n_scores, 2});
+    thread_results_.clear();
+    owned_index_.clear();
+    remote_values_.clear();
+    remote_sums_.clear();
+    history_values_.resize(n_threads);
+    return;
+  }
+
+  // Sparse tallies only store the bins that are scored. Each thread collects
+  // its own scores so that no locks are needed to insert new bins.
+  if (sparse_) {
+    if (!settings::reduce_tallies) {
+      fatal_error(fmt::format("Tally {} cannot use sparse results without "
+        "tally reduction.", id_));
+    }
+    values_ = xt::xtensor<double, 2>();
+    results_ = xt::xtensor<double, 3>();
+    thread_results_.clear();
+    sparse_values_.resize(n_threads);
+    return;
+  }
+
+  // Divide the combinations of filter bins of decomposed tallies evenly among
+  // the processes, or along the domains if the tally is on the domain mesh so
+  // that each process scores the bins it owns. With a single process the tally
+  // is stored as usual.
+  owned_index_.clear();
+  remote_values_.clear();
+  remote_sums_.clear();
+  if (decomposed_ && mpi::n_procs > 1) {
+    if (!settings::reduce_tallies) {
+      fatal_error(fmt::format("Tally {} cannot use decomposed results without "
+        "tally reduction.", id_));
+    }
+    int32_t stride = domain_tally_stride(*this);
+    for (int i = 0; i <= mpi::n_procs; ++i) {
+      if (stride > 0) {
+        owned_index_.push_back(simulation::domain_bin_start[i] * stride);
+      } else {
+        owned_index_.push_back(static_cast<int64_t>(n_filter_bins_) * i /
+          mpi::n_procs);
+      }
+    }
+    remote_values_.resize(n_threads);
+  }
+
   int n_scores = scores_.size() * nuclides_.size();
-  results_ = xt::empty<double>({n_filter_bins_, n_scores, 3});
+  int n_owned = owned_end() - owned_begin();
+  values_ = xt::empty<double>({n_owned, n_scores});
+  results_ = xt::empty<double>({n_owned, n_scores, 2});
+
+  // Give each thread its own buffer for the scores of a realization if the
+  // tally is small enough. Each thread allocates and zeroes its own buffer so
+  // that the memory is placed close to the thread that uses it.
+  thread_results_.clear();
+  int64_t size = static_cast<int64_t>(n_filter_bins_) * n_scores;
+  if (settings::private_tallies && n_threads > 1 && !decomposed() &&
+      size <= settings::private_tallies_max_size) {
+    thread_results_.resize(n_threads);
+    #pragma omp parallel
+    {
+      int i = thread_index();
+      if (i < n_threads) {
+        thread_results_[i] = xt::zeros<double>({n_filter_bins_, n_scores});
+      }
+    }
+
+    // Allocate the buffers of any threads that were not started
+    for (auto& buffer : thread_results_) {
+      if (static_cast<int64_t>(buffer.size()) != size) {
+        buffer = xt::zeros<double>({n_filter_bins_, n_scores});
+      }
+    }
+  }
 }
 
 void Tally::reset()
 {
+#ifdef OPENMC_MPI
+  // Discard a realization that is still being reduced
+  if (reduce_request_ != MPI_REQUEST_NULL) {
+    MPI_Wait(&reduce_request_, MPI_STATUS_IGNORE);
+  }
+#endif
+
   n_realizations_ = 0;
+  max_uncertainty_realizations_ = -1;
+  frozen_ = false;
   if (results_.size() != 0) {
-    xt::view(results_, xt::all()) = 0.0;
+    values_.fill(0.0);
+    results_.fill(0.0);
+  }
+  for (auto& buffer : thread_results_) {
+    buffer.fill(0.0);
+  }
+  for (auto& values : sparse_values_) {
+    values.clear();
+  }
+  sparse_results_.clear();
+  for (auto& values : remote_values_) {
+    values.clear();
+  }
+  remote_sums_.clear();
+  for (auto& values : history_values_) {
+    values.clear();
+  }
+  for (auto& profile : thread_profiles_) {
+    profile = {};
+  }
+  profile_ = {};
+}
+
+void Tally::accumulate_history(double norm)
+{
+  // Bins scored several times in the history are squared once
+  auto& values {history_values_[thread_index()]};
+  double* results = results_.data();
+  for (const auto& kv : values) {
+    double val = kv.second * norm;
+    #pragma omp atomic
+    results[2*kv.first + RESULT_SUM] += val;
+    #pragma omp atomic
+    results[2*kv.first + RESULT_SUM_SQ] += val*val;
+  }
+  values.clear();
+}
+
+void Tally::reduce_thread_results()
+{
+  // Each thread sums the buffers of all threads over its own bins, in the
+  // same order for every bin, and zeroes them for the next realization
+  if (!thread_results_.empty()) {
+    int n_scores = values_.shape()[1];
+    #pragma omp parallel for
+    for (int i = 0; i < n_filter_bins_; ++i) {
+      for (auto& buffer : thread_results_) {
+        for (int j = 0; j < n_scores; ++j) {
+          values_(i, j) += buffer(i, j);
+          buffer(i, j) = 0.0;
+        }
+      }
+    }
+  }
+
+  // Collect the scores of sparse tallies from all threads in the first
+  for (int i = 1; i < sparse_values_.size(); ++i) {
+    for (const auto& kv : sparse_values_[i]) {
+      sparse_values_[0][kv.first] += kv.second;
+    }
+    sparse_values_[i].clear();
+  }
+
+  // Likewise for the scores of decomposed tallies owned by other processes
+  for (auto& values : remote_values_) {
+    for (const auto& kv : values) {
+      remote_sums_[kv.first] += kv.second;
+    }
+    values.clear();
+  }
+}
+
+void Tally::flush_remote_values()
+{
+  auto& values {remote_values_[thread_index()]};
+  {
+    std::lock_guard<OpenMPMutex> lock(remote_mutex_);
+    for (const auto& kv : values) {
+      remote_sums_[kv.first] += kv.second;
+    }
+  }
+  values.clear();
+}
+
+double Tally::result(int filter_index, int score_index,
+  TallyResult result) const
+{
+  if (!sparse_) {
+    int i = filter_index - owned_begin();
+    switch (result) {
+    case TallyResult::VALUE:
+      return history_ ? 0.0 : values_(i, score_index);
+    case TallyResult::SUM:
+      return results_(i, score_index, RESULT_SUM);
+    default:
+      return results_(i, score_index, RESULT_SUM_SQ);
+    }
+  }
+
+  auto key = sparse_key(filter_index, score_index);
+  if (result == TallyResult::VALUE) {
+    if (sparse_values_.empty()) return 0.0;
+    auto it = sparse_values_[0].find(key);
+    return (it != sparse_values_[0].end()) ? it->second : 0.0;
+  }
+  auto it = sparse_results_.find(key);
+  if (it == sparse_results_.end()) return 0.0;
+  return it->second[result == TallyResult::SUM ? 0 : 1];
+}
+
+void Tally::write_sparse_results(hid_t group) const
+{
+  // Bins are written in order of their index in the dense results array
+  std::vector<int64_t> index;
+  index.reserve(sparse_results_.size());
+  for (const auto& kv : sparse_results_) index.push_back(kv.first);
+  std::sort(index.begin(), index.end());
+
+  xt::xtensor<double, 2> results({index.size(), 2});
+  for (int i = 0; i < index.size(); ++i) {
+    const auto& r {sparse_results_.at(index[i])};
+    results(i, 0) = r[0];
+    results(i, 1) = r[1];
+  }
+
+  write_dataset(group, "results_index", index);
+  write_dataset(group, "results", results);
+}
+
+void Tally::read_sparse_results(hid_t group)
+{
+  std::vector<int64_t> index;
+  xt::xtensor<double, 2> results;
+  read_dataset(group, "results_index", index);
+  read_dataset(group, "results", results);
+
+  sparse_results_.clear();
+  for (int i = 0; i < index.size(); ++i) {
+    sparse_results_[index[i]] = {results(i, 0), results(i, 1)};
+  }
+}
+
+void Tally::write_decomposed_results(hid_t group) const
+{
+  size_t n_scores = results_.shape()[1];
+#ifdef PHDF5
+  // All processes create the dataset together and write the bins they own
+  // into it collectively
+  hsize_t dims[] {static_cast<hsize_t>(n_filter_bins_), n_scores, 2};
+  hid_t dspace = H5Screate_simple(3, dims, nullptr);
+  hid_t dcpl = tally_results_dcpl(dims[0], dims[1],
+    settings::tally_compression);
+  hid_t dset = H5Dcreate(group, "results", H5T_NATIVE_DOUBLE, dspace,
+    H5P_DEFAULT, dcpl, H5P_DEFAULT);
+  if (dcpl != H5P_DEFAULT) H5Pclose(dcpl);
+
+  // Select the bins of this process in the dataset. Processes owning no bins
+  // still take part in the collective write with empty selections.
+  hsize_t n_bins = results_.shape()[0];
+  hsize_t mem_dims[] {std::max<hsize_t>(n_bins, 1), n_scores, 2};
+  hid_t memspace = H5Screate_simple(3, mem_dims, nullptr);
+  if (n_bins > 0) {
+    hsize_t count[] {n_bins, n_scores, 2};
+    hsize_t start[] {static_cast<hsize_t>(owned_begin()), 0, 0};
+    H5Sselect_hyperslab(dspace, H5S_SELECT_SET, start, nullptr, count,
+      nullptr);
+  } else {
+    H5Sselect_none(memspace);
+    H5Sselect_none(dspace);
+  }
+
+  hid_t plist = H5Pcreate(H5P_DATASET_XFER);
+  H5Pset_dxpl_mpio(plist, H5FD_MPIO_COLLECTIVE);
+  H5Dwrite(dset, H5T_NATIVE_DOUBLE, memspace, dspace, plist, results_.data());
+
+  H5Pclose(plist);
+  H5Sclose(memspace);
+  H5Sclose(dspace);
+  H5Dclose(dset);
+#else
+#ifdef OPENMC_MPI
+  // Send all results of each combination of filter bins as one block so that
+  // the counts do not exceed 2**31
+  MPI_Datatype result_block;
+  MPI_Type_contiguous(n_scores * 2, MPI_DOUBLE, &result_block);
+  MPI_Type_commit(&result_block);
+#endif
+
+  if (mpi::master) {
+    // Create dataset big enough to hold the results of all bins
+    hsize_t dims[] {static_cast<hsize_t>(n_filter_bins_), n_scores, 2};
+    hid_t dspace = H5Screate_simple(3, dims, nullptr);
+    hid_t dcpl = tally_results_dcpl(dims[0], dims[1],
+      settings::tally_compression);
+    hid_t dset = H5Dcreate(group, "results", H5T_NATIVE_DOUBLE, dspace,
+      H5P_DEFAULT, dcpl, H5P_DEFAULT);
+    if (dcpl != H5P_DEFAULT) H5Pclose(dcpl);
+    H5Sclose(dspace);
+
+    // The bins of other processes are received one process at a time
+    xt::xtensor<double, 3> buffer;
+    for (int i = 0; i < mpi::n_procs; ++i) {
+      size_t n_bins = owned_index_[i + 1] - owned_index_[i];
+      const double* data = results_.data();
+#ifdef OPENMC_MPI
+      if (i > 0) {
+        buffer = xt::empty<double>({n_bins, n_scores, size_t(2)});
+        MPI_Recv(buffer.data(), n_bins, result_block, i, i, mpi::intracomm,
+          MPI_STATUS_IGNORE);
+        data = buffer.data();
+      }
+#endif
+      if (n_bins == 0) continue;
+
+      hsize_t count[] {n_bins, n_scores, 2};
+      hid_t memspace = H5Screate_simple(3, count, nullptr);
+
+      // Select the bins of the process in the dataset
+      hsize_t start[] {static_cast<hsize_t>(owned_index_[i]), 0, 0};
+      dspace = H5Dget_space(dset);
+      H5Sselect_hyperslab(dspace, H5S_SELECT_SET, start, nullptr, count,
+        nullptr);
+
+      H5Dwrite(dset, H5T_NATIVE_DOUBLE, memspace, dspace, H5P_DEFAULT, data);
+
+      H5Sclose(memspace);
+      H5Sclose(dspace);
+    }
+    H5Dclose(dset);
+  } else {
+#ifdef OPENMC_MPI
+    MPI_Send(results_.data(), results_.shape()[0], result_block, 0, mpi::rank,
+      mpi::intracomm);
+#endif
+  }
+
+#ifdef OPENMC_MPI
+  MPI_Type_free(&result_block);
+#endif
+#endif // PHDF5
+}
+
+void Tally::read_decomposed_results(hid_t group)
+{
+  hsize_t n_bins = results_.shape()[0];
+  hsize_t n_scores = results_.shape()[1];
+  if (n_bins == 0) return;
+
+  hsize_t count[] {n_bins, n_scores, 2};
+  hid_t memspace = H5Screate_simple(3, count, nullptr);
+
+  // Select the bins owned by this process in the dataset
+  hid_t dset = H5Dopen(group, "results", H5P_DEFAULT);
+  hid_t dspace = H5Dget_space(dset);
+  hsize_t start[] {static_cast<hsize_t>(owned_begin()), 0, 0};
+  H5Sselect_hyperslab(dspace, H5S_SELECT_SET, start, nullptr, count, nullptr);
+
+  H5Dread(dset, H5T_NATIVE_DOUBLE, memspace, dspace, H5P_DEFAULT,
+    results_.data());
+
+  H5Sclose(memspace);
+  H5Sclose(dspace);
+  H5Dclose(dset);
+}
+
+#ifdef OPENMC_MPI
+void Tally::exchange_remote_values()
+{
+  // Count the scores for bins owned by each process
+  auto& values {remote_sums_};
+  int n_scores = scores_.size() * nuclides_.size();
+  auto owner = [&](int64_t key) {
+    auto it = std::upper_bound(owned_index_.begin(), owned_index_.end(),
+      key / n_scores);
+    return static_cast<int>(it - owned_index_.begin()) - 1;
+  };
+  std::vector<int> send_counts(mpi::n_procs, 0);
+  for (const auto& kv : values) ++send_counts[owner(kv.first)];
+
+  // Pack the scores in order of their owner
+  std::vector<int> send_displs(mpi::n_procs, 0);
+  for (int i = 1; i < mpi::n_procs; ++i) {
+    send_displs[i] = send_displs[i - 1] + send_counts[i - 1];
+  }
+  std::vector<int64_t> send_keys(values.size());
+  std::vector<double> send_vals(values.size());
+  std::vector<int> position {send_displs};
+  for (const auto& kv : values) {
+    int j = position[owner(kv.first)]++;
+    send_keys[j] = kv.first;
+    send_vals[j] = kv.second;
+  }
+  values.clear();
+
+  // Let each process know how many scores it will receive from the others
+  std::vector<int> recv_counts(mpi::n_procs);
+  MPI_Alltoall(send_counts.data(), 1, MPI_INT, recv_counts.data(), 1, MPI_INT,
+    mpi::intracomm);
+  std::vector<int> recv_displs(mpi::n_procs, 0);
+  for (int i = 1; i < mpi::n_procs; ++i) {
+    recv_displs[i] = recv_displs[i - 1] + recv_counts[i - 1];
+  }
+  int n_recv = recv_displs.back() + recv_counts.back();
+  std::vector<int64_t> recv_keys(n_recv);
+  std::vector<double> recv_vals(n_recv);
+
+  // Exchange the scores with every process that has any to send or receive
+  std::vector<MPI_Request> requests;
+  for (int i = 0; i < mpi::n_procs; ++i) {
+    if (recv_counts[i] > 0) {
+      requests.emplace_back();
+      MPI_Irecv(&recv_keys[recv_displs[i]], recv_counts[i], MPI_INT64_T, i, 0,
+        mpi::intracomm, &requests.back());
+      requests.emplace_back();
+      MPI_Irecv(&recv_vals[recv_displs[i]], recv_counts[i], MPI_DOUBLE, i, 1,
+        mpi::intracomm, &requests.back());
+    }
+    if (send_counts[i] > 0) {
+      requests.emplace_back();
+      MPI_Isend(&send_keys[send_displs[i]], send_counts[i], MPI_INT64_T, i, 0,
+        mpi::intracomm, &requests.back());
+      requests.emplace_back();
+      MPI_Isend(&send_vals[send_displs[i]], send_counts[i], MPI_DOUBLE, i, 1,
+        mpi::intracomm, &requests.back());
+    }
+  }
+  MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+
+  // Add the received scores to the bins of this process
+  for (int i = 0; i < n_recv; ++i) {
+    int filter_index = recv_keys[i] / n_scores;
+    int score_index = recv_keys[i] % n_scores;
+    values_(filter_index - owned_begin(), score_index) += recv_vals[i];
+  }
+}
+
+void Tally::start_reduction()
+{
+  // Only one realization is reduced at a time
+  finish_reduction();
+
+  // Copy the values to a separate buffer that is reduced while the next
+  // realization is scored
+  reduce_send_ = values_;
+  values_.fill(0.0);
+  if (mpi::master) reduce_recv_ = xt::empty_like(reduce_send_);
+
+  MPI_Ireduce(reduce_send_.data(), reduce_recv_.data(), reduce_send_.size(),
+    MPI_DOUBLE, MPI_SUM, 0, mpi::intracomm, &reduce_request_);
+}
+
+void Tally::finish_reduction()
+{
+  if (reduce_request_ == MPI_REQUEST_NULL) return;
+  MPI_Wait(&reduce_request_, MPI_STATUS_IGNORE);
+
+  ++n_realizations_;
+  if (mpi::master) accumulate_values(reduce_recv_, realization_norm(), false);
+}
+
+void Tally::reduce_sparse_values()
+{
+  // Pack the scored bins of this process
+  auto& values {sparse_values_[0]};
+  std::vector<int64_t> keys;
+  std::vector<double> vals;
+  keys.reserve(values.size());
+  vals.reserve(values.size());
+  for (const auto& kv : values) {
+    keys.push_back(kv.first);
+    vals.push_back(kv.second);
+  }
+
+  // Gather the bins of all processes on the master
+  int n = keys.size();
+  std::vector<int> counts(mpi::n_procs);
+  MPI_Gather(&n, 1, MPI_INT, counts.data(), 1, MPI_INT, 0, mpi::intracomm);
+  std::vector<int> displs(mpi::n_procs, 0);
+  for (int i = 1; i < mpi::n_procs; ++i) {
+    displs[i] = displs[i - 1] + counts[i - 1];
+  }
+  int n_total = mpi::master ? displs.back() + counts.back() : 0;
+  std::vector<int64_t> all_keys(n_total);
+  std::vector<double> all_vals(n_total);
+  MPI_Gatherv(keys.data(), n, MPI_INT64_T, all_keys.data(), counts.data(),
+    displs.data(), MPI_INT64_T, 0, mpi::intracomm);
+  MPI_Gatherv(vals.data(), n, MPI_DOUBLE, all_vals.data(), counts.data(),
+    displs.data(), MPI_DOUBLE, 0, mpi::intracomm);
+
+  // Combine them on the master and reset on other ranks
+  values.clear();
+  if (mpi::master) {
+    for (int i = 0; i < n_total; ++i) {
+      values[all_keys[i]] += all_vals[i];
+    }
+  }
+}
+
+void Tally::broadcast_sparse_results()
+{
+  std::vector<int64_t> keys;
+  std::vector<double> vals;
+  if (mpi::master) {
+    for (const auto& kv : sparse_results_) {
+      keys.push_back(kv.first);
+      vals.push_back(kv.second[0]);
+      vals.push_back(kv.second[1]);
+    }
+  }
+
+  int64_t n = keys.size();
+  MPI_Bcast(&n, 1, MPI_INT64_T, 0, mpi::intracomm);
+  keys.resize(n);
+  vals.resize(2*n);
+  MPI_Bcast(keys.data(), n, MPI_INT64_T, 0, mpi::intracomm);
+  MPI_Bcast(vals.data(), 2*n, MPI_DOUBLE, 0, mpi::intracomm);
+
+  if (!mpi::master) {
+    sparse_results_.clear();
+    for (int64_t i = 0; i < n; ++i) {
+      sparse_results_[keys[i]] = {vals[2*i], vals[2*i + 1]};
+    }
   }
 }
+#endif
 
 void Tally::accumulate()
 {
+#ifdef OPENMC_MPI
+  // A realization that is still being reduced is accumulated once the
+  // reduction completes
+  if (reduce_request_ != MPI_REQUEST_NULL) return;
+#endif
+
+  // The histories of the batch were accumulated as they ended
+  if (history_) {
+    n_realizations_ += settings::n_particles * settings::gen_per_batch;
+    return;
+  }
+
   // Increment number of realizations
   n_realizations_ += settings::reduce_tallies ? 1 : mpi::n_procs;
 
-  if (mpi::master || !settings::reduce_tallies) {
-    // Calculate total source strength for normalization
-    double total_source = 0.0;
-    if (settings::run_mode == RunMode::FIXED_SOURCE) {
-      for (const auto& s : model::external_sources) {
-        total_source += s.strength();
+  // Each process accumulates the bins it owns for decomposed tallies
+  if (mpi::master || !settings::reduce_tallies || decomposed()) {
+    double norm = realization_norm();
+
+    // Accumulate the bins of sparse tallies that were scored
+    if (sparse_) {
+      for (const auto& kv : sparse_values_[0]) {
+        double val = kv.second * norm;
+        auto& r {sparse_results_[kv.first]};
+        r[0] += val;
+        r[1] += val*val;
       }
-    } else {
-      total_source = 1.0;
     }
 
-    // Account for number of source particles in normalization
-    double norm = total_source / (settings::n_particles * settings::gen_per_batch);
-
     // Accumulate each result
-    for (int i = 0; i < results_.shape()[0]; ++i) {
-      for (int j = 0; j < results_.shape()[1]; ++j) {
-        double val = results_(i, j, TallyResult::VALUE) * norm;
-        results_(i, j, TallyResult::VALUE) = 0.0;
-        results_(i, j, TallyResult::SUM) += val;
-        results_(i, j, TallyResult::SUM_SQ) += val*val;
+    if (!sparse_) accumulate_values(values_, norm, true);
+  }
+
+  // Clear the values of the realization of sparse tallies
+  if (sparse_) sparse_values_[0].clear();
+}
+
+void Tally::accumulate_values(xt::xtensor<double, 2>& values, double norm,
+  bool reset)
+{
+  int n_bins = values.shape()[0];
+  int n_scores = values.shape()[1];
+  int n = n_realizations_;
+  bool uncertainty = !triggers_.empty() && n > 1 && triggers_due();
+  if (uncertainty) {
+    max_std_dev_.assign(n_scores, 0.);
+    max_rel_err_.assign(n_scores, 0.);
+    max_uncertainty_realizations_ = n;
+  }
+
+  int64_t size = values.size();
+  #pragma omp parallel if (size >= MIN_PARALLEL_VALUES)
+  {
+    // Largest uncertainties of the bins of this thread
+    std::vector<double> std_dev(uncertainty ? n_scores : 0, 0.);
+    std::vector<double> rel_err(uncertainty ? n_scores : 0, 0.);
+
+    #pragma omp for schedule(static)
+    for (int i = 0; i < n_bins; ++i) {
+      double* value = &values(i, 0);
+      double* result = &results_(i, 0, 0);
+      #pragma omp simd
+      for (int j = 0; j < n_scores; ++j) {
+        double val = value[j] * norm;
+        result[2*j + RESULT_SUM] += val;
+        result[2*j + RESULT_SUM_SQ] += val*val;
+      }
+      if (reset) std::fill(value, value + n_scores, 0.0);
+
+      // The sums of the bin are still in cache
+      if (uncertainty) {
+        #pragma omp simd
+        for (int j = 0; j < n_scores; ++j) {
+          double s, r;
+          bin_uncertainty(result[2*j + RESULT_SUM],
+            result[2*j + RESULT_SUM_SQ], n, s, r);
+          std_dev[j] = (s > std_dev[j]) ? s : std_dev[j];
+          rel_err[j] = (r > rel_err[j]) ? r : rel_err[j];
+        }
+      }
+    }
+
+    if (uncertainty) {
+      #pragma omp critical (TallyMaxUncertainty)
+      for (int j = 0; j < n_scores; ++j) {
+        if (std_dev[j] > max_std_dev_[j]) max_std_dev_[j] = std_dev[j];
+        if (rel_err[j] > max_rel_err_[j]) max_rel_err_[j] = rel_err[j];
       }
     }
   }
 }
 
+void Tally::update_max_uncertainty()
+{
+  int n = n_realizations_;
+  if (max_uncertainty_realizations_ == n) return;
+  max_uncertainty_realizations_ = n;
+
+  int n_scores = scores_.size() * nuclides_.size();
+  max_std_dev_.assign(n_scores, 0.);
+  max_rel_err_.assign(n_scores, 0.);
+  auto update = [&](int score_index, double sum, double sum_sq) {
+    double std_dev, rel_err;
+    bin_uncertainty(sum, sum_sq, n, std_dev, rel_err);
+    auto& s {max_std_dev_[score_index]};
+    auto& r {max_rel_err_[score_index]};
+    s = (std_dev > s) ? std_dev : s;
+    r = (rel_err > r) ? rel_err : r;
+  };
+
+  // Bins of sparse tallies that were never scored have no uncertainty
+  if (sparse_) {
+    for (const auto& kv : sparse_results_) {
+      update(kv.first % n_scores, kv.second[0], kv.second[1]);
+    }
+    return;
+  }
+  for (int i = 0; i < results_.shape()[0]; ++i) {
+    for (int j = 0; j < n_scores; ++j) {
+      update(j, results_(i, j, RESULT_SUM), results_(i, j, RESULT_SUM_SQ));
+    }
+  }
+}
+
+void Tally::compute_statistics()
+{
+  auto n_filter = results_.shape()[0];
+  auto n_score = results_.shape()[1];
+  if (statistics_.shape()[0] != n_filter || statistics_.shape()[1] != n_score) {
+    statistics_ = xt::empty<double>({n_filter, n_score, size_t {2}});
+  }
+
+  // As for openmc.Tally.std_dev, the standard deviation of bins with a zero
+  // mean is zero. Otherwise, it is infinite when it cannot be estimated.
+  int n = n_realizations_;
+  for (int i = 0; i < n_filter; ++i) {
+    for (int j = 0; j < n_score; ++j) {
+      double sum = results_(i, j, RESULT_SUM);
+      double mean = (n > 0) ? sum / n : sum;
+      double std_dev = 0.0;
+      if (mean != 0.0) {
+        double sum_sq = results_(i, j, RESULT_SUM_SQ);
+        std_dev = (n > 1) ?
+          std::sqrt(std::max(sum_sq/n - mean*mean, 0.0) / (n - 1)) : INFTY;
+      }
+      statistics_(i, j, 0) = mean;
+      statistics_(i, j, 1) = std_dev;
+    }
+  }
+}
+
+void Tally::reduce_profile()
+{
+  profile_ = {};
+  for (const auto& profile : thread_profiles_) {
+    profile_ += profile;
+  }
+
+#ifdef OPENMC_MPI
+  int64_t counts[] {profile_.n_events, profile_.n_bins, profile_.n_updates};
+  int64_t counts_reduced[3];
+  double time_reduced;
+  MPI_Reduce(counts, counts_reduced, 3, MPI_INT64_T, MPI_SUM, 0,
+    mpi::intracomm);
+  MPI_Reduce(&profile_.filter_time, &time_reduced, 1, MPI_DOUBLE, MPI_SUM, 0,
+    mpi::intracomm);
+  if (mpi::master) {
+    profile_.n_events = counts_reduced[0];
+    profile_.n_bins = counts_reduced[1];
+    profile_.n_updates = counts_reduced[2];
+    profile_.filter_time = time_reduced;
+  }
+#endif
+}
+
 std::string
 Tally::score_name(int score_idx) const {
   if (score_idx < 0 || score_idx >= scores_.size()) {
@@ -844,6 +1637,125 @@ Tally::score_name(int score_idx) const {
   return reaction_name(scores_[score_idx]);
 }
 
+//==============================================================================
+// TallyDomainIndex implementation
+//==============================================================================
+
+void TallyDomainIndex::build(const std::vector<int>& tallies,
+  TallyEstimator estimator)
+{
+  clear();
+  tallies_ = tallies;
+  tracklength_ = (estimator == TallyEstimator::TRACKLENGTH);
+
+  for (int i = 0; i < tallies_.size(); ++i) {
+    const auto& tally {*model::tallies[tallies_[i]]};
+
+    // Find the first cell or material filter of the tally along with the box
+    // enclosing any structured mesh it is tallied on
+    const CellFilter* cell_filter {nullptr};
+    const MaterialFilter* material_filter {nullptr};
+    BoundingBox box;
+    for (auto i_filt : tally.filters()) {
+      const auto* filt {model::tally_filters[i_filt].get()};
+      if (filt->type() == "cell" && !cell_filter && !material_filter) {
+        cell_filter = static_cast<const CellFilter*>(filt);
+      } else if (filt->type() == "material" && !cell_filter &&
+          !material_filter) {
+        material_filter = static_cast<const MaterialFilter*>(filt);
+      } else if (filt->type() == "mesh") {
+        auto i_mesh = static_cast<const MeshFilter*>(filt)->mesh();
+        const auto* m =
+          dynamic_cast<const StructuredMesh*>(model::meshes[i_mesh].get());
+        if (m) {
+          const auto& ll {m->lower_left_};
+          const auto& ur {m->upper_right_};
+          box.xmin = std::max(box.xmin, ll(0) - FP_COINCIDENT);
+          box.xmax = std::min(box.xmax, ur(0) + FP_COINCIDENT);
+          if (m->n_dimension_ > 1) {
+            box.ymin = std::max(box.ymin, ll(1) - FP_COINCIDENT);
+            box.ymax = std::min(box.ymax, ur(1) + FP_COINCIDENT);
+          }
+          if (m->n_dimension_ > 2) {
+            box.zmin = std::max(box.zmin, ll(2) - FP_COINCIDENT);
+            box.zmax = std::min(box.zmax, ur(2) + FP_COINCIDENT);
+          }
+          indexed_ = true;
+        }
+      }
+    }
+    boxes_.push_back(box);
+
+    if (cell_filter) {
+      for (auto i_cell : cell_filter->cells()) cells_[i_cell].push_back(i);
+      indexed_ = true;
+    } else if (material_filter) {
+      for (auto i_mat : material_filter->materials()) {
+        materials_[i_mat].push_back(i);
+      }
+      indexed_ = true;
+    } else {
+      unrestricted_.push_back(i);
+    }
+  }
+}
+
+const std::vector<int>& TallyDomainIndex::candidates(Particle& p) const
+{
+  if (!indexed_) return tallies_;
+
+  // Gather the positions of the tallies that can score in the cells and
+  // material of the particle
+  auto& positions {p.tally_candidates_};
+  positions = unrestricted_;
+  if (!cells_.empty()) {
+    for (int j = 0; j < p.n_coord_; ++j) {
+      auto it = cells_.find(p.coord_[j].cell);
+      if (it != cells_.end()) {
+        positions.insert(positions.end(), it->second.begin(), it->second.end());
+      }
+    }
+  }
+  if (!materials_.empty()) {
+    auto it = materials_.find(p.material_);
+    if (it != materials_.end()) {
+      positions.insert(positions.end(), it->second.begin(), it->second.end());
+    }
+  }
+
+  // The tallies are scored in their original order, once each
+  std::sort(positions.begin(), positions.end());
+  positions.erase(std::unique(positions.begin(), positions.end()),
+    positions.end());
+
+  // Skip tallies on a mesh that the particle, or its track segment, does not
+  // come near. Surviving positions are replaced by the tally indices.
+  Position r {p.r()};
+  Position r_last {tracklength_ ? p.r_last_ : r};
+  int n = 0;
+  for (auto i : positions) {
+    const auto& b {boxes_[i]};
+    if (std::max(r.x, r_last.x) < b.xmin || std::min(r.x, r_last.x) > b.xmax ||
+        std::max(r.y, r_last.y) < b.ymin || std::min(r.y, r_last.y) > b.ymax ||
+        std::max(r.z, r_last.z) < b.zmin || std::min(r.z, r_last.z) > b.zmax) {
+      continue;
+    }
+    positions[n++] = tallies_[i];
+  }
+  positions.resize(n);
+  return positions;
+}
+
+void TallyDomainIndex::clear()
+{
+  tallies_.clear();
+  indexed_ = false;
+  unrestricted_.clear();
+  cells_.clear();
+  materials_.clear();
+  boxes_.clear();
+}
+
 //==============================================================================
 // Non-member functions
 //==============================================================================
@@ -858,7 +1770,7 @@ void read_tallies_xml()
 
   // Parse tallies.xml file
   pugi::xml_document doc;
-  doc.load_file(filename.c_str());
+  load_xml_file(doc, filename);
   pugi::xml_node root = doc.document_element();
 
   // Check for <assume_separate> setting
@@ -905,22 +1817,48 @@ void reduce_tally_results()
     // Skip any tallies that are not active
     auto& tally {model::tallies[i_tally]};
 
-    // Get view of accumulated tally values
-    auto values_view = xt::view(tally->results_, xt::all(), xt::all(), static_cast<int>(TallyResult::VALUE));
+    if (tally->sparse_) {
+      tally->reduce_sparse_values();
+      continue;
+    }
 
-    // Make copy of tally values in contiguous array
-    xt::xtensor<double, 2> values = values_view;
-    xt::xtensor<double, 2> values_reduced = xt::empty_like(values);
+    // The sums of tallies with history statistics hold the histories of the
+    // batch run by each process, which are added to those of the master
+    if (tally->history_) {
+      auto& results = tally->results_;
+      if (mpi::master) {
+        MPI_Reduce(MPI_IN_PLACE, results.data(), results.size(), MPI_DOUBLE,
+          MPI_SUM, 0, mpi::intracomm);
+      } else {
+        MPI_Reduce(results.data(), nullptr, results.size(), MPI_DOUBLE,
+          MPI_SUM, 0, mpi::intracomm);
+        results.fill(0.0);
+      }
+      continue;
+    }
 
-    // Reduce contiguous set of tally results
-    MPI_Reduce(values.data(), values_reduced.data(), values.size(),
-      MPI_DOUBLE, MPI_SUM, 0, mpi::intracomm);
+    // Decomposed tallies only need the scores for bins owned by this process
+    if (tally->decomposed()) {
+      tally->exchange_remote_values();
+      continue;
+    }
 
-    // Transfer values on master and reset on other ranks
+    // Let the reduction complete while the next batch is transported
+    if (settings::pipeline_tallies) {
+      tally->start_reduction();
+      continue;
+    }
+
+    // The tally values are contiguous, so they are reduced in place on the
+    // master and reset on other ranks
+    auto& values = tally->values_;
     if (mpi::master) {
-      values_view = values_reduced;
+      MPI_Reduce(MPI_IN_PLACE, values.data(), values.size(), MPI_DOUBLE,
+        MPI_SUM, 0, mpi::intracomm);
     } else {
-      values_view = 0.0;
+      MPI_Reduce(values.data(), nullptr, values.size(), MPI_DOUBLE, MPI_SUM,
+        0, mpi::intracomm);
+      values.fill(0.0);
     }
   }
 
@@ -950,11 +1888,26 @@ void reduce_tally_results()
     0, mpi::intracomm);
   if (mpi::master) simulation::total_weight = weight_reduced;
 }
+
+void finish_tally_reductions()
+{
+  for (auto& t : model::tallies) {
+    t->finish_reduction();
+  }
+}
 #endif
 
 void
 accumulate_tallies()
 {
+  // Add the scores of this batch to the sums of a restarted run
+  read_tally_results_pending();
+
+  // Combine the scores from the thread-private buffers of each tally
+  for (int i_tally : model::active_tallies) {
+    model::tallies[i_tally]->reduce_thread_results();
+  }
+
 #ifdef OPENMC_MPI
   // Combine tally results onto master process
   if (settings::reduce_tallies) reduce_tally_results();
@@ -995,6 +1948,46 @@ accumulate_tallies()
   }
 }
 
+void
+accumulate_history_tallies()
+{
+  for (int i_tally : model::active_history_tallies) {
+    model::tallies[i_tally]->accumulate_history(history_norm);
+  }
+}
+
+bool
+tallies_need_nuclide_xs()
+{
+  for (const auto& t : model::tallies) {
+    // Derivatives are accumulated along tracks whatever the estimator
+    if (t->deriv_ != C_NONE) return true;
+    if (t->estimator_ != TallyEstimator::TRACKLENGTH) continue;
+
+    if (std::any_of(t->nuclides_.begin(), t->nuclides_.end(),
+        [](int i_nuclide) { return i_nuclide >= 0; })) return true;
+
+    // These scores only need macroscopic cross sections for the total of a
+    // material; the others sum over its nuclides
+    for (int score : t->scores_) {
+      switch (score) {
+      case SCORE_FLUX:
+      case SCORE_TOTAL:
+      case SCORE_SCATTER:
+      case SCORE_ABSORPTION:
+      case SCORE_FISSION:
+      case SCORE_NU_FISSION:
+      case SCORE_EVENTS:
+      case SCORE_INVERSE_VELOCITY:
+        break;
+      default:
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 void
 setup_active_tallies()
 {
@@ -1004,12 +1997,20 @@ setup_active_tallies()
   model::active_collision_tallies.clear();
   model::active_meshsurf_tallies.clear();
   model::active_surface_tallies.clear();
+  model::active_history_tallies.clear();
+  history_norm = realization_norm() * settings::n_particles *
+    settings::gen_per_batch;
 
   for (auto i = 0; i < model::tallies.size(); ++i) {
-    const auto& tally {*model::tallies[i]};
+    auto& tally {*model::tallies[i]};
 
-    if (tally.active_) {
+    if (tally.active_ && !tally.frozen_) {
       model::active_tallies.push_back(i);
+      if (tally.history_) model::active_history_tallies.push_back(i);
+
+      // Select specialized scoring functions now that the tally is final
+      tally.score_kernels_ = score_kernels(tally);
+      tally.fused_expansion_ = fused_expansion(tally);
       switch (tally.type_) {
 
       case TallyType::VOLUME:
@@ -1032,11 +2033,59 @@ setup_active_tallies()
       case TallyType::SURFACE:
         model::active_surface_tallies.push_back(i);
       }
+    }
+  }
 
-      // Check if tally contains depletion reactions and if so, set flag
-      if (tally.depletion_rx_) simulation::need_depletion_rx = true;
+  // Find the meshes that several filters of tracklength tallies traverse
+  std::vector<std::vector<int32_t>> mesh_filters(model::meshes.size());
+  for (auto i_tally : model::active_tracklength_tallies) {
+    for (auto i_filt : model::tallies[i_tally]->filters()) {
+      const auto* filt {model::tally_filters[i_filt].get()};
+      if (filt->type() != "mesh") continue;
+      auto& filters {mesh_filters[static_cast<const MeshFilter*>(filt)->mesh()]};
+      if (std::find(filters.begin(), filters.end(), i_filt) == filters.end()) {
+        filters.push_back(i_filt);
+      }
     }
   }
+  for (int i = 0; i < model::meshes.size(); ++i) {
+    model::meshes[i]->shared_tracks_ = mesh_filters[i].size() > 1;
+  }
+
+  // Bins of meshes whose elements are the tiles of a lattice follow from the
+  // coordinates of particles
+  for (auto& m : model::meshes) {
+    if (auto* rm = dynamic_cast<RegularMesh*>(m.get())) {
+      rm->find_aligned_lattice();
+    }
+  }
+
+  // Surface crossings of regular meshes that are also traversed by
+  // tracklength tallies are found while walking the bins crossed
+  for (auto& m : model::meshes) m->fused_surfaces_ = false;
+  for (auto i_tally : model::active_meshsurf_tallies) {
+    for (auto i_filt : model::tallies[i_tally]->filters()) {
+      const auto* filt {model::tally_filters[i_filt].get()};
+      if (filt->type() != "meshsurface") continue;
+      int32_t i_mesh = static_cast<const MeshSurfaceFilter*>(filt)->mesh();
+      auto& m {*model::meshes[i_mesh]};
+      if (mesh_filters[i_mesh].empty() || m.aligned_lattice_ != C_NONE ||
+          !dynamic_cast<RegularMesh*>(&m)) continue;
+      m.fused_surfaces_ = true;
+    }
+  }
+
+  model::tracklength_tally_index.build(model::active_tracklength_tallies,
+    TallyEstimator::TRACKLENGTH);
+  model::collision_tally_index.build(model::active_collision_tallies,
+    TallyEstimator::COLLISION);
+}
+
+void reduce_tally_profiles()
+{
+  for (auto& t : model::tallies) {
+    t->reduce_profile();
+  }
 }
 
 void
@@ -1044,6 +2093,7 @@ free_memory_tally()
 {
   model::tally_derivs.clear();
   model::tally_deriv_map.clear();
+  model::temperature_derivs = false;
 
   model::tally_filters.clear();
   model::filter_map.clear();
@@ -1056,6 +2106,9 @@ free_memory_tally()
   model::active_collision_tallies.clear();
   model::active_meshsurf_tallies.clear();
   model::active_surface_tallies.clear();
+  model::active_history_tallies.clear();
+  model::tracklength_tally_index.clear();
+  model::collision_tally_index.clear();
 
   model::tally_map.clear();
 }
@@ -1364,6 +2417,9 @@ openmc_tally_reset(int32_t index)
     return OPENMC_E_OUT_OF_BOUNDS;
   }
 
+  // The other tallies keep the results of the state point that was restarted
+  // from, which must be read before this one is reset
+  read_tally_results_pending();
   model::tallies[index]->reset();
   return 0;
 }
@@ -1381,8 +2437,9 @@ openmc_tally_get_n_realizations(int32_t index, int32_t* n)
   return 0;
 }
 
-//! \brief Returns a pointer to a tally results array along with its shape. This
-//! allows a user to obtain in-memory tally results from Python directly.
+//! \brief Returns a pointer to the sums and sums of squares of a tally along
+//! with their shape. This allows a user to obtain in-memory tally results from
+//! Python directly.
 extern "C" int
 openmc_tally_results(int32_t index, double** results, size_t* shape)
 {
@@ -1393,6 +2450,17 @@ openmc_tally_results(int32_t index, double** results, size_t* shape)
   }
 
   const auto& t {model::tallies[index]};
+  read_tally_results_pending();
+  if (t->sparse_) {
+    set_errmsg("Results of tallies with sparse storage are not available as "
+      "an array.");
+    return OPENMC_E_INVALID_TYPE;
+  }
+  if (t->decomposed()) {
+    set_errmsg("Results of tallies decomposed across processes are not "
+      "available as an array.");
+    return OPENMC_E_INVALID_TYPE;
+  }
   if (t->results_.size() == 0) {
     set_errmsg("Tally results have not been allocated yet.");
     return OPENMC_E_ALLOCATE;
@@ -1407,6 +2475,34 @@ openmc_tally_results(int32_t index, double** results, size_t* shape)
   return 0;
 }
 
+//! \brief Computes the mean and standard deviation of each bin of a tally and
+//! returns a pointer to them along with their shape. The buffer is owned by
+//! the tally and overwritten by the next call.
+extern "C" int
+openmc_tally_statistics(int32_t index, double** stats, size_t* shape)
+{
+  // Make sure the index fits in the array bounds.
+  if (index < 0 || index >= model::tallies.size()) {
+    set_errmsg("Index in tallies array is out of bounds.");
+    return OPENMC_E_OUT_OF_BOUNDS;
+  }
+
+  // The statistics are computed from the same array as the results
+  double* results;
+  size_t results_shape[3];
+  int err = openmc_tally_results(index, &results, results_shape);
+  if (err < 0) return err;
+
+  auto& t {model::tallies[index]};
+  t->compute_statistics();
+  *stats = t->statistics_.data();
+  auto s = t->statistics_.shape();
+  shape[0] = s[0];
+  shape[1] = s[1];
+  shape[2] = s[2];
+  return 0;
+}
+
 extern "C" int
 openmc_global_tallies(double** ptr)
 {
@@ -4,12 +4,12 @@
 #include "openmc/capi.h"
 #include "openmc/constants.h"
 #include "openmc/error.h"
+#include "openmc/instrument.h"
 #include "openmc/material.h"
 #include "openmc/mgxs_interface.h"
 #include "openmc/nuclide.h"
 #include "openmc/photon.h"
 #include "openmc/reaction_product.h"
-#include "openmc/search.h"
 #include "openmc/settings.h"
 #include "openmc/simulation.h"
 #include "openmc/string_utils.h"
@@ -18,17 +18,62 @@
 #include "openmc/tallies/filter_delayedgroup.h"
 #include "openmc/tallies/filter_energy.h"
 
+#include <chrono>
 #include <string>
 
 namespace openmc {
 
+namespace {
+
+//! Counts an event of a profiled tally and adds the time until it is destroyed
+//! to the time spent matching filter bins
+
+class FilterTimer {
+public:
+  explicit FilterTimer(TallyProfile* profile) : profile_{profile}
+  {
+    if (profile_) start_ = std::chrono::steady_clock::now();
+  }
+
+  ~FilterTimer()
+  {
+    if (!profile_) return;
+    std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start_;
+    ++profile_->n_events;
+    profile_->filter_time += elapsed.count();
+  }
+
+private:
+  TallyProfile* profile_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+//! Get a depletion reaction cross section of a nuclide at the last energy its
+//! cross sections were evaluated at, evaluating it when first needed
+
+double depletion_rx_xs(Particle& p, int i_nuclide, int m)
+{
+  auto& micro {p.neutron_xs_[i_nuclide]};
+  if (!micro.reaction_valid) {
+    data::nuclides[i_nuclide]->calculate_reaction_xs(micro);
+  }
+  return micro.reaction[m];
+}
+
+} // namespace
+
 //==============================================================================
 // FilterBinIter implementation
 //==============================================================================
 
 FilterBinIter::FilterBinIter(const Tally& tally, Particle& p)
-  : filter_matches_{p.filter_matches_}, tally_{tally}
+  : filter_matches_{p.filter_matches_}, tally_{tally},
+    skip_{tally.fused_expansion_}, profile_{tally.thread_profile()}
 {
+  // Measure the time spent matching filters if the tally is being profiled
+  FilterTimer timer {profile_};
+
   // Find all valid bins in each relevant filter if they have not already been
   // found for this event.
   for (auto i_filt : tally_.filters()) {
@@ -97,6 +142,7 @@ FilterBinIter::operator++()
   // can be incremented.
   bool visited_all_combinations = true;
   for (int i = tally_.filters().size()-1; i >= 0; --i) {
+    if (i == skip_) continue;
     auto i_filt = tally_.filters(i);
     auto& match {filter_matches_[i_filt]};
     if (match.i_bin_ < match.bins_.size()-1) {
@@ -127,9 +173,12 @@ FilterBinIter::operator++()
 void
 FilterBinIter::compute_index_weight()
 {
+  if (profile_) ++profile_->n_bins;
+
   index_ = 0;
   weight_ = 1.;
   for (auto i = 0; i < tally_.filters().size(); ++i) {
+    if (i == skip_) continue;
     auto i_filt = tally_.filters(i);
     auto& match {filter_matches_[i_filt]};
     auto i_bin = match.i_bin_;
@@ -168,8 +217,7 @@ score_fission_delayed_dg(int i_tally, int d_bin, double score, int score_index,
   }
 
   // Update the tally result
-  #pragma omp atomic
-  tally.results_(filter_index, score_index, TallyResult::VALUE) += score*filter_weight;
+  tally.add_score(filter_index, score_index, score*filter_weight);
 
   // Reset the original delayed group bin
   dg_match.bins_[i_bin] = original_bin;
@@ -181,11 +229,11 @@ double get_nuc_fission_q(const Nuclide& nuc, const Particle& p, int score_bin)
 {
   if (score_bin == SCORE_FISS_Q_PROMPT) {
     if (nuc.fission_q_prompt_) {
-      return (*nuc.fission_q_prompt_)(p.E_last_);
+      return nuc.fission_q_prompt_fn_(p.E_last_);
     }
   } else if (score_bin == SCORE_FISS_Q_RECOV) {
     if (nuc.fission_q_recov_) {
-      return (*nuc.fission_q_recov_)(p.E_last_);
+      return nuc.fission_q_recov_fn_(p.E_last_);
     }
   }
   return 0.0;
@@ -232,7 +280,7 @@ double score_fission_q(const Particle& p, int score_bin, const Tally& tally,
       double score {0.0};
       for (auto i = 0; i < material.nuclide_.size(); ++i) {
         auto j_nuclide = material.nuclide_[i];
-        auto atom_density = material.atom_density_(i);
+        auto atom_density = material.atom_density_(i) * p.density_mult_;
         const Nuclide& nuc {*data::nuclides[j_nuclide]};
         score += get_nuc_fission_q(nuc, p, score_bin) * atom_density
           * p.neutron_xs_[j_nuclide].fission;
@@ -286,7 +334,7 @@ double score_neutron_heating(const Particle& p, const Tally& tally, double flux,
       const Material& material {*model::materials[p.material_]};
       for (auto i = 0; i< material.nuclide_.size(); ++i) {
         int j_nuclide = material.nuclide_[i];
-        double atom_density {material.atom_density_(i)};
+        double atom_density {material.atom_density_(i) * p.density_mult_};
         const Nuclide& nuc {*data::nuclides[j_nuclide]};
         heating_xs += atom_density * get_nuclide_neutron_heating(p, nuc, rxn_bin, j_nuclide);
       }
@@ -372,9 +420,7 @@ score_fission_eout(Particle& p, int i_tally, int i_score, int score_bin)
       if (E_out < eo_filt.bins().front() || E_out > eo_filt.bins().back()) {
         continue;
       } else {
-        auto i_match = lower_bound_index(eo_filt.bins().begin(),
-          eo_filt.bins().end(), E_out);
-        p.filter_matches_[i_eout_filt].bins_[i_bin] = i_match;
+        p.filter_matches_[i_eout_filt].bins_[i_bin] = eo_filt.find_bin(E_out);
       }
 
     }
@@ -395,8 +441,7 @@ score_fission_eout(Particle& p, int i_tally, int i_score, int score_bin)
       }
 
       // Update tally results
-      #pragma omp atomic
-      tally.results_(filter_index, i_score, TallyResult::VALUE) += score*filter_weight;
+      tally.add_score(filter_index, i_score, score*filter_weight);
 
     } else if (score_bin == SCORE_DELAYED_NU_FISSION && g != 0) {
 
@@ -442,8 +487,7 @@ score_fission_eout(Particle& p, int i_tally, int i_score, int score_bin)
         }
 
         // Update tally results
-        #pragma omp atomic
-        tally.results_(filter_index, i_score, TallyResult::VALUE) += score*filter_weight;
+        tally.add_score(filter_index, i_score, score*filter_weight);
       }
     }
   }
@@ -580,7 +624,7 @@ score_general_ce(Particle& p, int i_tally, int start_index, int filter_index,
         // Get yield and apply to score
         auto m = data::nuclides[p.event_nuclide_]->reaction_index_[p.event_mt_];
         const auto& rxn {*data::nuclides[p.event_nuclide_]->reactions_[m]};
-        score = p.wgt_last_ * flux * (*rxn.products_[0].yield_)(E);
+        score = p.wgt_last_ * flux * rxn.products_[0].yield_fn_(E);
       }
       break;
 
@@ -736,7 +780,7 @@ score_general_ce(Particle& p, int i_tally, int start_index, int filter_index,
             const Material& material {*model::materials[p.material_]};
             for (auto i = 0; i < material.nuclide_.size(); ++i) {
               auto j_nuclide = material.nuclide_[i];
-              auto atom_density = material.atom_density_(i);
+              auto atom_density = material.atom_density_(i) * p.density_mult_;
               score += p.neutron_xs_[j_nuclide].fission
                 * data::nuclides[j_nuclide]
                 ->nu(E, ReactionProduct::EmissionMode::prompt)
@@ -860,7 +904,7 @@ score_general_ce(Particle& p, int i_tally, int start_index, int filter_index,
               const Material& material {*model::materials[p.material_]};
               for (auto i = 0; i < material.nuclide_.size(); ++i) {
                 auto j_nuclide = material.nuclide_[i];
-                auto atom_density = material.atom_density_(i);
+                auto atom_density = material.atom_density_(i) * p.density_mult_;
                 // Tally each delayed group bin individually
                 for (auto d_bin = 0; d_bin < filt.n_bins(); ++d_bin) {
                   auto d = filt.groups()[d_bin];
@@ -880,7 +924,7 @@ score_general_ce(Particle& p, int i_tally, int start_index, int filter_index,
               const Material& material {*model::materials[p.material_]};
               for (auto i = 0; i < material.nuclide_.size(); ++i) {
                 auto j_nuclide = material.nuclide_[i];
-                auto atom_density = material.atom_density_(i);
+                auto atom_density = material.atom_density_(i) * p.density_mult_;
                 score += p.neutron_xs_[j_nuclide].fission
                   * data::nuclides[j_nuclide]
                   ->nu(E, ReactionProduct::EmissionMode::delayed)
@@ -1026,7 +1070,7 @@ score_general_ce(Particle& p, int i_tally, int start_index, int filter_index,
               const Material& material {*model::materials[p.material_]};
               for (auto i = 0; i < material.nuclide_.size(); ++i) {
                 auto j_nuclide = material.nuclide_[i];
-                auto atom_density = material.atom_density_(i);
+                auto atom_density = material.atom_density_(i) * p.density_mult_;
                 const auto& nuc {*data::nuclides[j_nuclide]};
                 if (nuc.fissionable_) {
                   const auto& rxn {*nuc.fission_rx_[0]};
@@ -1051,7 +1095,7 @@ score_general_ce(Particle& p, int i_tally, int start_index, int filter_index,
               const Material& material {*model::materials[p.material_]};
               for (auto i = 0; i < material.nuclide_.size(); ++i) {
                 auto j_nuclide = material.nuclide_[i];
-                auto atom_density = material.atom_density_(i);
+                auto atom_density = material.atom_density_(i) * p.density_mult_;
                 const auto& nuc {*data::nuclides[j_nuclide]};
                 if (nuc.fissionable_) {
                   const auto& rxn {*nuc.fission_rx_[0]};
@@ -1121,7 +1165,7 @@ score_general_ce(Particle& p, int i_tally, int start_index, int filter_index,
           const Material& material {*model::materials[p.material_]};
           for (auto i = 0; i < material.nuclide_.size(); ++i) {
             auto j_nuclide = material.nuclide_[i];
-            auto atom_density = material.atom_density_(i);
+            auto atom_density = material.atom_density_(i) * p.density_mult_;
             const auto& nuc {*data::nuclides[j_nuclide]};
             if (nuc.fissionable_) {
               const auto& rxn {*nuc.fission_rx_[0]};
@@ -1136,8 +1180,7 @@ score_general_ce(Particle& p, int i_tally, int start_index, int filter_index,
 
     case SCORE_EVENTS:
       // Simply count the number of scoring events
-      #pragma omp atomic
-      tally.results_(filter_index, score_index, TallyResult::VALUE) += 1.0;
+      tally.add_score(filter_index, score_index, 1.0);
       continue;
 
 
@@ -1157,7 +1200,7 @@ score_general_ce(Particle& p, int i_tally, int start_index, int filter_index,
             const Material& material {*model::materials[p.material_]};
             for (auto i = 0; i < material.nuclide_.size(); ++i) {
               auto j_nuclide = material.nuclide_[i];
-              auto atom_density = material.atom_density_(i);
+              auto atom_density = material.atom_density_(i) * p.density_mult_;
               if (p.neutron_xs_[j_nuclide].elastic == CACHE_INVALID)
                 data::nuclides[j_nuclide]->calculate_elastic_xs(p);
               score += p.neutron_xs_[j_nuclide].elastic * atom_density
@@ -1196,17 +1239,16 @@ score_general_ce(Particle& p, int i_tally, int start_index, int filter_index,
         case N_4N: m = 5; break;
         }
         if (i_nuclide >= 0) {
-          score = p.neutron_xs_[i_nuclide].reaction[m] * atom_density
-            * flux;
+          score = (atom_density > 0.0) ? depletion_rx_xs(p, i_nuclide, m)
+            * atom_density * flux : 0.0;
         } else {
           score = 0.;
           if (p.material_ != MATERIAL_VOID) {
             const Material& material {*model::materials[p.material_]};
             for (auto i = 0; i < material.nuclide_.size(); ++i) {
               auto j_nuclide = material.nuclide_[i];
-              auto atom_density = material.atom_density_(i);
-              score += p.neutron_xs_[j_nuclide].reaction[m]
-                * atom_density * flux;
+              auto atom_density = material.atom_density_(i) * p.density_mult_;
+              score += depletion_rx_xs(p, j_nuclide, m) * atom_density * flux;
             }
           }
         }
@@ -1270,7 +1312,7 @@ score_general_ce(Particle& p, int i_tally, int start_index, int filter_index,
           const Material& material {*model::materials[p.material_]};
           for (auto i = 0; i < material.nuclide_.size(); ++i) {
             auto j_nuclide = material.nuclide_[i];
-            auto atom_density = material.atom_density_(i);
+            auto atom_density = material.atom_density_(i) * p.density_mult_;
             const auto& nuc {*data::nuclides[j_nuclide]};
             auto m = nuc.reaction_index_[score_bin];
             if (m == C_NONE) continue;
@@ -1297,8 +1339,7 @@ score_general_ce(Particle& p, int i_tally, int start_index, int filter_index,
         score);
 
     // Update tally results
-    #pragma omp atomic
-    tally.results_(filter_index, score_index, TallyResult::VALUE) += score*filter_weight;
+    tally.add_score(filter_index, score_index, score*filter_weight);
   }
 }
 
@@ -1353,11 +1394,15 @@ score_general_mg(Particle& p, int i_tally, int start_index, int filter_index,
   auto& nuc_xs = data::mg.nuclides_[i_nuclide];
   auto& macro_xs = data::mg.macro_xs_[p.material_];
 
-  // Find the temperature and angle indices of interest
-  macro_xs.set_angle_index(p_u);
+  // Find the temperature and angle indices of interest, leaving those the
+  // particle tracks with untouched
+  MgxsCache macro_cache = p.mg_xs_cache_;
+  macro_xs.set_temperature_index(macro_cache, p.sqrtkT_);
+  macro_xs.set_angle_index(macro_cache, p_u);
+  MgxsCache nuc_cache;
   if (i_nuclide >= 0) {
-    nuc_xs.set_temperature_index(p.sqrtkT_);
-    nuc_xs.set_angle_index(p_u);
+    nuc_xs.set_temperature_index(nuc_cache, p.sqrtkT_);
+    nuc_xs.set_angle_index(nuc_cache, p_u);
   }
 
   for (auto i = 0; i < tally.scores_.size(); ++i) {
@@ -1401,12 +1446,14 @@ score_general_mg(Particle& p, int i_tally, int start_index, int filter_index,
         }
         //TODO: should flux be multiplied in above instead of below?
         if (i_nuclide >= 0) {
-          score *= flux * atom_density * nuc_xs.get_xs(MgxsType::TOTAL, p_g)
-            / macro_xs.get_xs(MgxsType::TOTAL, p_g);
+          score *= flux * atom_density * nuc_xs.get_xs(nuc_cache,
+            MgxsType::TOTAL, p_g)
+            / macro_xs.get_xs(macro_cache, MgxsType::TOTAL, p_g);
         }
       } else {
         if (i_nuclide >= 0) {
-          score = atom_density * flux * nuc_xs.get_xs(MgxsType::TOTAL, p_g);
+          score = atom_density * flux * nuc_xs.get_xs(nuc_cache,
+            MgxsType::TOTAL, p_g);
         } else {
           score = p.macro_xs_.total * flux;
         }
@@ -1428,17 +1475,21 @@ score_general_mg(Particle& p, int i_tally, int start_index, int filter_index,
           score = p.wgt_last_;
         }
         if (i_nuclide >= 0) {
-          score *= flux * nuc_xs.get_xs(MgxsType::INVERSE_VELOCITY, p_g)
-            / macro_xs.get_xs(MgxsType::TOTAL, p_g);
+          score *= flux * nuc_xs.get_xs(nuc_cache,
+            MgxsType::INVERSE_VELOCITY, p_g)
+            / macro_xs.get_xs(macro_cache, MgxsType::TOTAL, p_g);
         } else {
-          score *= flux * macro_xs.get_xs(MgxsType::INVERSE_VELOCITY, p_g)
-            / macro_xs.get_xs(MgxsType::TOTAL, p_g);
+          score *= flux * macro_xs.get_xs(macro_cache,
+            MgxsType::INVERSE_VELOCITY, p_g)
+            / macro_xs.get_xs(macro_cache, MgxsType::TOTAL, p_g);
         }
       } else {
         if (i_nuclide >= 0) {
-          score = flux * nuc_xs.get_xs(MgxsType::INVERSE_VELOCITY, p_g);
+          score = flux * nuc_xs.get_xs(nuc_cache,
+            MgxsType::INVERSE_VELOCITY, p_g);
         } else {
-          score = flux * macro_xs.get_xs(MgxsType::INVERSE_VELOCITY, p_g);
+          score = flux * macro_xs.get_xs(macro_cache,
+            MgxsType::INVERSE_VELOCITY, p_g);
         }
       }
       break;
@@ -1452,17 +1503,17 @@ score_general_mg(Particle& p, int i_tally, int start_index, int filter_index,
         // weight entering the collision as the estimator for the reaction rate
         score = p.wgt_last_ * flux;
         if (i_nuclide >= 0) {
-          score *= atom_density * nuc_xs.get_xs(
+          score *= atom_density * nuc_xs.get_xs(nuc_cache,
               MgxsType::SCATTER_FMU_MULT, p.g_last_, &p.g_, &p.mu_, nullptr)
-            / macro_xs.get_xs(
+            / macro_xs.get_xs(macro_cache,
               MgxsType::SCATTER_FMU_MULT, p.g_last_, &p.g_, &p.mu_, nullptr);
         }
       } else {
         if (i_nuclide >= 0) {
-          score = atom_density * flux * nuc_xs.get_xs(
+          score = atom_density * flux * nuc_xs.get_xs(nuc_cache,
             MgxsType::SCATTER_MULT, p_g, nullptr, &p.mu_, nullptr);
         } else {
-          score = flux * macro_xs.get_xs(
+          score = flux * macro_xs.get_xs(macro_cache,
             MgxsType::SCATTER_MULT, p_g, nullptr, &p.mu_, nullptr);
         }
       }
@@ -1482,16 +1533,17 @@ score_general_mg(Particle& p, int i_tally, int start_index, int filter_index,
         // adjust the score by the actual probability for that nuclide.
         if (i_nuclide >= 0) {
           score *= atom_density
-            * nuc_xs.get_xs(MgxsType::SCATTER_FMU, p.g_last_, &p.g_,
-                            &p.mu_, nullptr)
-            / macro_xs.get_xs(MgxsType::SCATTER_FMU, p.g_last_, &p.g_,
-                              &p.mu_, nullptr);
+            * nuc_xs.get_xs(nuc_cache, MgxsType::SCATTER_FMU, p.g_last_,
+                            &p.g_, &p.mu_, nullptr)
+            / macro_xs.get_xs(macro_cache, MgxsType::SCATTER_FMU, p.g_last_,
+                              &p.g_, &p.mu_, nullptr);
         }
       } else {
         if (i_nuclide >= 0) {
-          score = atom_density * flux * nuc_xs.get_xs(MgxsType::SCATTER, p_g);
+          score = atom_density * flux * nuc_xs.get_xs(nuc_cache,
+            MgxsType::SCATTER, p_g);
         } else {
-          score = flux * macro_xs.get_xs(MgxsType::SCATTER, p_g);
+          score = flux * macro_xs.get_xs(macro_cache, MgxsType::SCATTER, p_g);
         }
       }
       break;
@@ -1511,13 +1563,14 @@ score_general_mg(Particle& p, int i_tally, int start_index, int filter_index,
           score = p.wgt_last_ * flux;
         }
         if (i_nuclide >= 0) {
-          score *= atom_density * nuc_xs.get_xs(MgxsType::ABSORPTION, p_g)
-            / macro_xs.get_xs(MgxsType::ABSORPTION, p_g);
+          score *= atom_density * nuc_xs.get_xs(nuc_cache,
+            MgxsType::ABSORPTION, p_g)
+            / macro_xs.get_xs(macro_cache, MgxsType::ABSORPTION, p_g);
         }
       } else {
         if (i_nuclide >= 0) {
           score = atom_density * flux
-            * nuc_xs.get_xs(MgxsType::ABSORPTION, p_g);
+            * nuc_xs.get_xs(nuc_cache, MgxsType::ABSORPTION, p_g);
         } else {
           score = p.macro_xs_.absorption * flux;
         }
@@ -1541,17 +1594,19 @@ score_general_mg(Particle& p, int i_tally, int start_index, int filter_index,
           score = p.wgt_last_ * flux;
         }
         if (i_nuclide >= 0) {
-          score *= atom_density * nuc_xs.get_xs(MgxsType::FISSION, p_g)
-            / macro_xs.get_xs(MgxsType::ABSORPTION, p_g);
+          score *= atom_density * nuc_xs.get_xs(nuc_cache,
+            MgxsType::FISSION, p_g)
+            / macro_xs.get_xs(macro_cache, MgxsType::ABSORPTION, p_g);
         } else {
-          score *= macro_xs.get_xs(MgxsType::FISSION, p_g)
-            / macro_xs.get_xs(MgxsType::ABSORPTION, p_g);
+          score *= macro_xs.get_xs(macro_cache, MgxsType::FISSION, p_g)
+            / macro_xs.get_xs(macro_cache, MgxsType::ABSORPTION, p_g);
         }
       } else {
         if (i_nuclide >= 0) {
-          score = atom_density * flux * nuc_xs.get_xs(MgxsType::FISSION, p_g);
+          score = atom_density * flux * nuc_xs.get_xs(nuc_cache,
+            MgxsType::FISSION, p_g);
         } else {
-          score = flux * macro_xs.get_xs(MgxsType::FISSION, p_g);
+          score = flux * macro_xs.get_xs(macro_cache, MgxsType::FISSION, p_g);
         }
       }
       break;
@@ -1573,11 +1628,12 @@ score_general_mg(Particle& p, int i_tally, int start_index, int filter_index,
           // nu-fission
           score = p.wgt_absorb_ * flux;
           if (i_nuclide >= 0) {
-            score *= atom_density * nuc_xs.get_xs(MgxsType::NU_FISSION, p_g)
-              / macro_xs.get_xs(MgxsType::ABSORPTION, p_g);
+            score *= atom_density * nuc_xs.get_xs(nuc_cache,
+              MgxsType::NU_FISSION, p_g)
+              / macro_xs.get_xs(macro_cache, MgxsType::ABSORPTION, p_g);
           } else {
-            score *= macro_xs.get_xs(MgxsType::NU_FISSION, p_g)
-              / macro_xs.get_xs(MgxsType::ABSORPTION, p_g);
+            score *= macro_xs.get_xs(macro_cache, MgxsType::NU_FISSION, p_g)
+              / macro_xs.get_xs(macro_cache, MgxsType::ABSORPTION, p_g);
           }
         } else {
           // Skip any non-fission events
@@ -1589,16 +1645,18 @@ score_general_mg(Particle& p, int i_tally, int start_index, int filter_index,
           // score.
           score = simulation::keff * p.wgt_bank_ * flux;
           if (i_nuclide >= 0) {
-            score *= atom_density * nuc_xs.get_xs(MgxsType::FISSION, p_g)
-              / macro_xs.get_xs(MgxsType::FISSION, p_g);
+            score *= atom_density * nuc_xs.get_xs(nuc_cache,
+              MgxsType::FISSION, p_g)
+              / macro_xs.get_xs(macro_cache, MgxsType::FISSION, p_g);
           }
         }
       } else {
         if (i_nuclide >= 0) {
           score = atom_density * flux
-            * nuc_xs.get_xs(MgxsType::NU_FISSION, p_g);
+            * nuc_xs.get_xs(nuc_cache, MgxsType::NU_FISSION, p_g);
         } else {
-          score = flux * macro_xs.get_xs(MgxsType::NU_FISSION, p_g);
+          score = flux * macro_xs.get_xs(macro_cache,
+            MgxsType::NU_FISSION, p_g);
         }
       }
       break;
@@ -1621,11 +1679,12 @@ score_general_mg(Particle& p, int i_tally, int start_index, int filter_index,
           score = p.wgt_absorb_ * flux;
           if (i_nuclide >= 0) {
             score *= atom_density *
-              nuc_xs.get_xs(MgxsType::PROMPT_NU_FISSION, p_g)
-              / macro_xs.get_xs(MgxsType::ABSORPTION, p_g);
+              nuc_xs.get_xs(nuc_cache, MgxsType::PROMPT_NU_FISSION, p_g)
+              / macro_xs.get_xs(macro_cache, MgxsType::ABSORPTION, p_g);
           } else {
-            score *= macro_xs.get_xs(MgxsType::PROMPT_NU_FISSION, p_g)
-              / macro_xs.get_xs(MgxsType::ABSORPTION, p_g);
+            score *= macro_xs.get_xs(macro_cache,
+              MgxsType::PROMPT_NU_FISSION, p_g)
+              / macro_xs.get_xs(macro_cache, MgxsType::ABSORPTION, p_g);
           }
         } else {
           // Skip any non-fission events
@@ -1640,16 +1699,18 @@ score_general_mg(Particle& p, int i_tally, int start_index, int filter_index,
           auto prompt_frac = 1. - n_delayed / static_cast<double>(p.n_bank_);
           score = simulation::keff * p.wgt_bank_ * prompt_frac * flux;
           if (i_nuclide >= 0) {
-            score *= atom_density * nuc_xs.get_xs(MgxsType::FISSION, p_g)
-              / macro_xs.get_xs(MgxsType::FISSION, p_g);
+            score *= atom_density * nuc_xs.get_xs(nuc_cache,
+              MgxsType::FISSION, p_g)
+              / macro_xs.get_xs(macro_cache, MgxsType::FISSION, p_g);
           }
         }
       } else {
         if (i_nuclide >= 0) {
           score = atom_density * flux *
-            nuc_xs.get_xs(MgxsType::PROMPT_NU_FISSION, p_g);
+            nuc_xs.get_xs(nuc_cache, MgxsType::PROMPT_NU_FISSION, p_g);
         } else {
-          score = flux * macro_xs.get_xs(MgxsType::PROMPT_NU_FISSION, p_g);
+          score = flux * macro_xs.get_xs(macro_cache,
+            MgxsType::PROMPT_NU_FISSION, p_g);
         }
       }
       break;
@@ -1669,7 +1730,8 @@ score_general_mg(Particle& p, int i_tally, int start_index, int filter_index,
           // No fission events occur if survival biasing is on -- need to
           // calculate fraction of absorptions that would have resulted in
           // delayed-nu-fission
-          double abs_xs = macro_xs.get_xs(MgxsType::ABSORPTION, p_g);
+          double abs_xs = macro_xs.get_xs(macro_cache,
+            MgxsType::ABSORPTION, p_g);
           if (abs_xs > 0.) {
             if (tally.delayedgroup_filter_ != C_NONE) {
               auto i_dg_filt = tally.filters()[tally.delayedgroup_filter_];
@@ -1681,12 +1743,12 @@ score_general_mg(Particle& p, int i_tally, int start_index, int filter_index,
                 auto d = filt.groups()[d_bin] - 1;
                 score = p.wgt_absorb_ * flux;
                 if (i_nuclide >= 0) {
-                  score *= nuc_xs.get_xs(MgxsType::DELAYED_NU_FISSION, p_g,
-                                         nullptr, nullptr, &d)
+                  score *= nuc_xs.get_xs(nuc_cache,
+                    MgxsType::DELAYED_NU_FISSION, p_g, nullptr, nullptr, &d)
                     / abs_xs;
                 } else {
-                  score *= macro_xs.get_xs(MgxsType::DELAYED_NU_FISSION, p_g,
-                                           nullptr, nullptr, &d)
+                  score *= macro_xs.get_xs(macro_cache,
+                    MgxsType::DELAYED_NU_FISSION, p_g, nullptr, nullptr, &d)
                     / abs_xs;
                 }
                 score_fission_delayed_dg(i_tally, d_bin, score, score_index, p.filter_matches_);
@@ -1698,10 +1760,12 @@ score_general_mg(Particle& p, int i_tally, int start_index, int filter_index,
               // delayed-nu-fission xs to the absorption xs
               score = p.wgt_absorb_ * flux;
               if (i_nuclide >= 0) {
-                score *= nuc_xs.get_xs(MgxsType::DELAYED_NU_FISSION, p_g)
+                score *= nuc_xs.get_xs(nuc_cache,
+                  MgxsType::DELAYED_NU_FISSION, p_g)
                   / abs_xs;
               } else {
-                score *= macro_xs.get_xs(MgxsType::DELAYED_NU_FISSION, p_g)
+                score *= macro_xs.get_xs(macro_cache,
+                  MgxsType::DELAYED_NU_FISSION, p_g)
                   / abs_xs;
               }
             }
@@ -1727,8 +1791,9 @@ score_general_mg(Particle& p, int i_tally, int start_index, int filter_index,
               score = simulation::keff * p.wgt_bank_ / p.n_bank_
                 * p.n_delayed_bank_[d-1] * flux;
               if (i_nuclide >= 0) {
-                score *= atom_density * nuc_xs.get_xs(MgxsType::FISSION, p_g)
-                  / macro_xs.get_xs(MgxsType::FISSION, p_g);
+                score *= atom_density * nuc_xs.get_xs(nuc_cache,
+                  MgxsType::FISSION, p_g)
+                  / macro_xs.get_xs(macro_cache, MgxsType::FISSION, p_g);
               }
               score_fission_delayed_dg(i_tally, d_bin, score, score_index, p.filter_matches_);
             }
@@ -1740,8 +1805,9 @@ score_general_mg(Particle& p, int i_tally, int start_index, int filter_index,
             score = simulation::keff * p.wgt_bank_ / p.n_bank_ * n_delayed
               * flux;
             if (i_nuclide >= 0) {
-              score *= atom_density * nuc_xs.get_xs(MgxsType::FISSION, p_g)
-                / macro_xs.get_xs(MgxsType::FISSION, p_g);
+              score *= atom_density * nuc_xs.get_xs(nuc_cache,
+                MgxsType::FISSION, p_g)
+                / macro_xs.get_xs(macro_cache, MgxsType::FISSION, p_g);
             }
           }
         }
@@ -1755,10 +1821,10 @@ score_general_mg(Particle& p, int i_tally, int start_index, int filter_index,
           for (auto d_bin = 0; d_bin < filt.n_bins(); ++d_bin) {
             auto d = filt.groups()[d_bin] - 1;
             if (i_nuclide >= 0) {
-              score = flux * atom_density * nuc_xs.get_xs(
+              score = flux * atom_density * nuc_xs.get_xs(nuc_cache,
                 MgxsType::DELAYED_NU_FISSION, p_g, nullptr, nullptr, &d);
             } else {
-              score = flux * macro_xs.get_xs(
+              score = flux * macro_xs.get_xs(macro_cache,
                 MgxsType::DELAYED_NU_FISSION, p_g, nullptr, nullptr, &d);
             }
             score_fission_delayed_dg(i_tally, d_bin, score, score_index, p.filter_matches_);
@@ -1767,9 +1833,10 @@ score_general_mg(Particle& p, int i_tally, int start_index, int filter_index,
         } else {
           if (i_nuclide >= 0) {
             score = flux * atom_density *
-              nuc_xs.get_xs(MgxsType::DELAYED_NU_FISSION, p_g);
+              nuc_xs.get_xs(nuc_cache, MgxsType::DELAYED_NU_FISSION, p_g);
           } else {
-            score = flux * macro_xs.get_xs(MgxsType::DELAYED_NU_FISSION, p_g);
+            score = flux * macro_xs.get_xs(macro_cache,
+              MgxsType::DELAYED_NU_FISSION, p_g);
           }
         }
       }
@@ -1782,7 +1849,8 @@ score_general_mg(Particle& p, int i_tally, int start_index, int filter_index,
           // No fission events occur if survival biasing is on -- need to
           // calculate fraction of absorptions that would have resulted in
           // delayed-nu-fission
-          double abs_xs = macro_xs.get_xs(MgxsType::ABSORPTION, p_g);
+          double abs_xs = macro_xs.get_xs(macro_cache,
+            MgxsType::ABSORPTION, p_g);
           if (abs_xs > 0) {
             if (tally.delayedgroup_filter_ != C_NONE) {
               auto i_dg_filt = tally.filters()[tally.delayedgroup_filter_];
@@ -1794,15 +1862,17 @@ score_general_mg(Particle& p, int i_tally, int start_index, int filter_index,
                 auto d = filt.groups()[d_bin] - 1;
                 score = p.wgt_absorb_ * flux;
                 if (i_nuclide >= 0) {
-                  score *= nuc_xs.get_xs(MgxsType::DECAY_RATE, p_g,
-                                         nullptr, nullptr, &d)
-                    * nuc_xs.get_xs(MgxsType::DELAYED_NU_FISSION, p_g,
-                                    nullptr, nullptr, &d) / abs_xs;
+                  score *= nuc_xs.get_xs(nuc_cache,
+                    MgxsType::DECAY_RATE, p_g, nullptr, nullptr, &d)
+                    * nuc_xs.get_xs(nuc_cache,
+                      MgxsType::DELAYED_NU_FISSION, p_g, nullptr, nullptr, &d)
+                    / abs_xs;
                 } else {
-                  score *= macro_xs.get_xs(MgxsType::DECAY_RATE, p_g, nullptr,
-                                           nullptr, &d)
-                    * macro_xs.get_xs(MgxsType::DELAYED_NU_FISSION, p_g,
-                                      nullptr, nullptr, &d) / abs_xs;
+                  score *= macro_xs.get_xs(macro_cache,
+                    MgxsType::DECAY_RATE, p_g, nullptr, nullptr, &d)
+                    * macro_xs.get_xs(macro_cache,
+                      MgxsType::DELAYED_NU_FISSION, p_g, nullptr, nullptr, &d)
+                    / abs_xs;
                 }
                 score_fission_delayed_dg(i_tally, d_bin, score, score_index, p.filter_matches_);
               }
@@ -1816,16 +1886,18 @@ score_general_mg(Particle& p, int i_tally, int start_index, int filter_index,
               for (auto d = 0; d < data::mg.num_delayed_groups_; ++d) {
                 if (i_nuclide >= 0) {
                   score += p.wgt_absorb_ * flux
-                    * nuc_xs.get_xs(MgxsType::DECAY_RATE, p_g, nullptr,
-                                    nullptr, &d)
-                    * nuc_xs.get_xs(MgxsType::DELAYED_NU_FISSION, p_g,
-                                    nullptr, nullptr, &d) / abs_xs;
+                    * nuc_xs.get_xs(nuc_cache,
+                      MgxsType::DECAY_RATE, p_g, nullptr, nullptr, &d)
+                    * nuc_xs.get_xs(nuc_cache,
+                      MgxsType::DELAYED_NU_FISSION, p_g, nullptr, nullptr, &d)
+                    / abs_xs;
                 } else {
                   score += p.wgt_absorb_ * flux
-                    * macro_xs.get_xs(MgxsType::DECAY_RATE, p_g, nullptr,
-                                      nullptr, &d)
-                    * macro_xs.get_xs(MgxsType::DELAYED_NU_FISSION, p_g,
-                                      nullptr, nullptr, &d) / abs_xs;
+                    * macro_xs.get_xs(macro_cache,
+                      MgxsType::DECAY_RATE, p_g, nullptr, nullptr, &d)
+                    * macro_xs.get_xs(macro_cache,
+                      MgxsType::DELAYED_NU_FISSION, p_g, nullptr, nullptr, &d)
+                    / abs_xs;
                 }
               }
             }
@@ -1847,12 +1919,14 @@ score_general_mg(Particle& p, int i_tally, int start_index, int filter_index,
             if (d != -1) {
               if (i_nuclide >= 0) {
                 score += simulation::keff * atom_density * bank.wgt * flux
-                  * nuc_xs.get_xs(MgxsType::DECAY_RATE, p_g, nullptr, nullptr, &d)
-                  * nuc_xs.get_xs(MgxsType::FISSION, p_g)
-                  / macro_xs.get_xs(MgxsType::FISSION, p_g);
+                  * nuc_xs.get_xs(nuc_cache,
+                    MgxsType::DECAY_RATE, p_g, nullptr, nullptr, &d)
+                  * nuc_xs.get_xs(nuc_cache, MgxsType::FISSION, p_g)
+                  / macro_xs.get_xs(macro_cache, MgxsType::FISSION, p_g);
               } else {
                 score += simulation::keff * bank.wgt * flux
-                  * macro_xs.get_xs(MgxsType::DECAY_RATE, p_g, nullptr, nullptr, &d);
+                  * macro_xs.get_xs(macro_cache,
+                    MgxsType::DECAY_RATE, p_g, nullptr, nullptr, &d);
               }
               if (tally.delayedgroup_filter_ != C_NONE) {
                 auto i_dg_filt = tally.filters()[tally.delayedgroup_filter_];
@@ -1883,16 +1957,16 @@ score_general_mg(Particle& p, int i_tally, int start_index, int filter_index,
             auto d = filt.groups()[d_bin] - 1;
             if (i_nuclide >= 0) {
               score += atom_density * flux
-                * nuc_xs.get_xs(MgxsType::DECAY_RATE, p_g, nullptr,
-                                nullptr, &d)
-                * nuc_xs.get_xs(MgxsType::DELAYED_NU_FISSION, p_g, nullptr,
-                                nullptr, &d);
+                * nuc_xs.get_xs(nuc_cache,
+                  MgxsType::DECAY_RATE, p_g, nullptr, nullptr, &d)
+                * nuc_xs.get_xs(nuc_cache,
+                  MgxsType::DELAYED_NU_FISSION, p_g, nullptr, nullptr, &d);
             } else {
               score += flux
-                * macro_xs.get_xs(MgxsType::DECAY_RATE, p_g, nullptr,
-                                  nullptr, &d)
-                * macro_xs.get_xs(MgxsType::DELAYED_NU_FISSION, p_g, nullptr,
-                                  nullptr, &d);
+                * macro_xs.get_xs(macro_cache,
+                  MgxsType::DECAY_RATE, p_g, nullptr, nullptr, &d)
+                * macro_xs.get_xs(macro_cache,
+                  MgxsType::DELAYED_NU_FISSION, p_g, nullptr, nullptr, &d);
             }
             score_fission_delayed_dg(i_tally, d_bin, score, score_index, p.filter_matches_);
           }
@@ -1902,12 +1976,16 @@ score_general_mg(Particle& p, int i_tally, int start_index, int filter_index,
           for (auto d = 0; d < data::mg.num_delayed_groups_; ++d) {
             if (i_nuclide >= 0) {
               score += atom_density * flux
-                * nuc_xs.get_xs(MgxsType::DECAY_RATE, p_g, nullptr, nullptr, &d)
-                * nuc_xs.get_xs(MgxsType::DELAYED_NU_FISSION, p_g, nullptr, nullptr, &d);
+                * nuc_xs.get_xs(nuc_cache,
+                  MgxsType::DECAY_RATE, p_g, nullptr, nullptr, &d)
+                * nuc_xs.get_xs(nuc_cache,
+                  MgxsType::DELAYED_NU_FISSION, p_g, nullptr, nullptr, &d);
             } else {
               score += flux
-                * macro_xs.get_xs(MgxsType::DECAY_RATE, p_g, nullptr, nullptr, &d)
-                * macro_xs.get_xs(MgxsType::DELAYED_NU_FISSION, p_g, nullptr, nullptr, &d);
+                * macro_xs.get_xs(macro_cache,
+                  MgxsType::DECAY_RATE, p_g, nullptr, nullptr, &d)
+                * macro_xs.get_xs(macro_cache,
+                  MgxsType::DELAYED_NU_FISSION, p_g, nullptr, nullptr, &d);
             }
           }
         }
@@ -1932,26 +2010,27 @@ score_general_mg(Particle& p, int i_tally, int start_index, int filter_index,
         }
         if (i_nuclide >= 0) {
           score *= atom_density
-            * nuc_xs.get_xs(MgxsType::KAPPA_FISSION, p_g)
-            / macro_xs.get_xs(MgxsType::ABSORPTION, p_g);
+            * nuc_xs.get_xs(nuc_cache, MgxsType::KAPPA_FISSION, p_g)
+            / macro_xs.get_xs(macro_cache, MgxsType::ABSORPTION, p_g);
         } else {
           score *=
-            macro_xs.get_xs(MgxsType::KAPPA_FISSION, p_g)
-            / macro_xs.get_xs(MgxsType::ABSORPTION, p_g);
+            macro_xs.get_xs(macro_cache, MgxsType::KAPPA_FISSION, p_g)
+            / macro_xs.get_xs(macro_cache, MgxsType::ABSORPTION, p_g);
         }
       } else {
         if (i_nuclide >= 0) {
-          score = atom_density * flux * nuc_xs.get_xs(MgxsType::KAPPA_FISSION, p_g);
+          score = atom_density * flux * nuc_xs.get_xs(nuc_cache,
+            MgxsType::KAPPA_FISSION, p_g);
         } else {
-          score = flux * macro_xs.get_xs(MgxsType::KAPPA_FISSION, p_g);
+          score = flux * macro_xs.get_xs(macro_cache,
+            MgxsType::KAPPA_FISSION, p_g);
         }
       }
       break;
 
     case SCORE_EVENTS:
       // Simply count the number of scoring events
-      #pragma omp atomic
-      tally.results_(filter_index, score_index, TallyResult::VALUE) += 1.0;
+      tally.add_score(filter_index, score_index, 1.0);
       continue;
 
 
@@ -1960,8 +2039,159 @@ score_general_mg(Particle& p, int i_tally, int start_index, int filter_index,
     }
 
     // Update tally results
-    #pragma omp atomic
-    tally.results_(filter_index, score_index, TallyResult::VALUE) += score*filter_weight;
+    tally.add_score(filter_index, score_index, score*filter_weight);
+  }
+}
+
+//==============================================================================
+// Specialized scoring kernels
+//==============================================================================
+
+//! Reaction rate of a single score for tracklength and collision estimators.
+//! These match the corresponding cases of score_general_ce.
+
+template<int SCORE>
+double score_kernel(const Particle& p, int i_nuclide, double atom_density,
+  double flux);
+
+template<>
+double score_kernel<SCORE_FLUX>(const Particle& p, int i_nuclide,
+  double atom_density, double flux)
+{
+  return flux;
+}
+
+template<>
+double score_kernel<SCORE_TOTAL>(const Particle& p, int i_nuclide,
+  double atom_density, double flux)
+{
+  if (i_nuclide < 0) return p.macro_xs_.total * flux;
+  if (p.type_ == Particle::Type::neutron) {
+    return p.neutron_xs_[i_nuclide].total * atom_density * flux;
+  } else if (p.type_ == Particle::Type::photon) {
+    return p.photon_xs_[i_nuclide].total * atom_density * flux;
+  }
+  return 0.0;
+}
+
+template<>
+double score_kernel<SCORE_SCATTER>(const Particle& p, int i_nuclide,
+  double atom_density, double flux)
+{
+  if (i_nuclide < 0) {
+    return (p.macro_xs_.total - p.macro_xs_.absorption) * flux;
+  }
+  const auto& micro {p.neutron_xs_[i_nuclide]};
+  return (micro.total - micro.absorption) * atom_density * flux;
+}
+
+template<>
+double score_kernel<SCORE_ABSORPTION>(const Particle& p, int i_nuclide,
+  double atom_density, double flux)
+{
+  if (i_nuclide < 0) return p.macro_xs_.absorption * flux;
+  return p.neutron_xs_[i_nuclide].absorption * atom_density * flux;
+}
+
+template<>
+double score_kernel<SCORE_FISSION>(const Particle& p, int i_nuclide,
+  double atom_density, double flux)
+{
+  if (p.macro_xs_.absorption == 0) return 0.0;
+  if (i_nuclide < 0) return p.macro_xs_.fission * flux;
+  return p.neutron_xs_[i_nuclide].fission * atom_density * flux;
+}
+
+template<>
+double score_kernel<SCORE_NU_FISSION>(const Particle& p, int i_nuclide,
+  double atom_density, double flux)
+{
+  if (p.macro_xs_.absorption == 0) return 0.0;
+  if (i_nuclide < 0) return p.macro_xs_.nu_fission * flux;
+  return p.neutron_xs_[i_nuclide].nu_fission * atom_density * flux;
+}
+
+std::vector<ScoreKernel> score_kernels(const Tally& tally)
+{
+  if (!settings::run_CE || tally.type_ != TallyType::VOLUME ||
+      tally.estimator_ == TallyEstimator::ANALOG || tally.deriv_ != C_NONE) {
+    return {};
+  }
+
+  std::vector<ScoreKernel> kernels;
+  for (auto score_bin : tally.scores_) {
+    switch (score_bin) {
+    case SCORE_FLUX:
+      kernels.push_back(score_kernel<SCORE_FLUX>);
+      break;
+    case SCORE_TOTAL:
+      kernels.push_back(score_kernel<SCORE_TOTAL>);
+      break;
+    case SCORE_SCATTER:
+      kernels.push_back(score_kernel<SCORE_SCATTER>);
+      break;
+    case SCORE_ABSORPTION:
+      kernels.push_back(score_kernel<SCORE_ABSORPTION>);
+      break;
+    case SCORE_FISSION:
+      kernels.push_back(score_kernel<SCORE_FISSION>);
+      break;
+    case SCORE_NU_FISSION:
+      kernels.push_back(score_kernel<SCORE_NU_FISSION>);
+      break;
+    default:
+      return {};
+    }
+  }
+  return kernels;
+}
+
+int fused_expansion(const Tally& tally)
+{
+  if (tally.score_kernels_.empty()) return C_NONE;
+
+  // These filters always match all of their bins in order, or none
+  for (int i = tally.filters().size() - 1; i >= 0; --i) {
+    auto type = model::tally_filters[tally.filters(i)]->type();
+    if (type == "legendre" || type == "sphericalharmonics" ||
+        type == "spatiallegendre" || type == "zernike" ||
+        type == "zernikeradial") {
+      return i;
+    }
+  }
+  return C_NONE;
+}
+
+//! Update tally results for tracklength and collision estimators, using the
+//! specialized kernels of the tally if it has them.
+
+void
+score_general(Particle& p, int i_tally, int start_index, int filter_index,
+  double filter_weight, int i_nuclide, double atom_density, double flux)
+{
+  Tally& tally {*model::tallies[i_tally]};
+  const auto& kernels {tally.score_kernels_};
+  if (!kernels.empty() && tally.fused_expansion_ != C_NONE) {
+    // Each rate is computed once and weighted by every moment of the expansion
+    int i_filt = tally.fused_expansion_;
+    const auto& moments {p.filter_matches_[tally.filters(i_filt)].weights_};
+    for (auto i = 0; i < kernels.size(); ++i) {
+      double score = kernels[i](p, i_nuclide, atom_density, flux);
+      if (score == 0.0) continue;
+      tally.add_moments(filter_index, tally.strides(i_filt), start_index + i,
+        moments, score*filter_weight);
+    }
+  } else if (!kernels.empty()) {
+    for (auto i = 0; i < kernels.size(); ++i) {
+      double score = kernels[i](p, i_nuclide, atom_density, flux);
+      tally.add_score(filter_index, start_index + i, score*filter_weight);
+    }
+  } else if (settings::run_CE) {
+    score_general_ce(p, i_tally, start_index, filter_index, filter_weight,
+      i_nuclide, atom_density, flux);
+  } else {
+    score_general_mg(p, i_tally, start_index, filter_index, filter_weight,
+      i_nuclide, atom_density, flux);
   }
 }
 
@@ -1971,40 +2201,51 @@ void
 score_all_nuclides(Particle& p, int i_tally, double flux,
   int filter_index, double filter_weight)
 {
-  const Tally& tally {*model::tallies[i_tally]};
+  Tally& tally {*model::tallies[i_tally]};
   const Material& material {*model::materials[p.material_]};
+  const auto& kernels {tally.score_kernels_};
+  auto n_scores = tally.scores_.size();
+
+  if (!kernels.empty() && tally.fused_expansion_ == C_NONE) {
+    // Sweep the cached micro cross sections of the material once per score,
+    // writing each nuclide's rate into its slice of the results
+    for (auto j = 0; j < kernels.size(); ++j) {
+      for (auto i = 0; i < material.nuclide_.size(); ++i) {
+        auto i_nuclide = material.nuclide_[i];
+        auto atom_density = material.atom_density_(i) * p.density_mult_;
+        double score = kernels[j](p, i_nuclide, atom_density, flux);
+        if (score == 0.0) continue;
+        tally.add_score(filter_index, i_nuclide*n_scores + j,
+          score*filter_weight);
+      }
+      double score = kernels[j](p, -1, 0.0, flux);
+      tally.add_score(filter_index, data::nuclides.size()*n_scores + j,
+        score*filter_weight);
+    }
+    return;
+  }
 
   // Score all individual nuclide reaction rates.
   for (auto i = 0; i < material.nuclide_.size(); ++i) {
     auto i_nuclide = material.nuclide_[i];
-    auto atom_density = material.atom_density_(i);
+    auto atom_density = material.atom_density_(i) * p.density_mult_;
 
-    //TODO: consider replacing this "if" with pointers or templates
-    if (settings::run_CE) {
-      score_general_ce(p, i_tally, i_nuclide*tally.scores_.size(), filter_index,
-        filter_weight, i_nuclide, atom_density, flux);
-    } else {
-      score_general_mg(p, i_tally, i_nuclide*tally.scores_.size(), filter_index,
-        filter_weight, i_nuclide, atom_density, flux);
-    }
+    score_general(p, i_tally, i_nuclide*tally.scores_.size(), filter_index,
+      filter_weight, i_nuclide, atom_density, flux);
   }
 
   // Score total material reaction rates.
   int i_nuclide = -1;
   double atom_density = 0.;
   auto n_nuclides = data::nuclides.size();
-  //TODO: consider replacing this "if" with pointers or templates
-  if (settings::run_CE) {
-    score_general_ce(p, i_tally, n_nuclides*tally.scores_.size(), filter_index,
-      filter_weight, i_nuclide, atom_density, flux);
-  } else {
-    score_general_mg(p, i_tally, n_nuclides*tally.scores_.size(), filter_index,
-      filter_weight, i_nuclide, atom_density, flux);
-  }
+  score_general(p, i_tally, n_nuclides*tally.scores_.size(), filter_index,
+    filter_weight, i_nuclide, atom_density, flux);
 }
 
 void score_analog_tally_ce(Particle& p)
 {
+  InstrumentRegion region {Region::TALLY_SCORING};
+
   // Since electrons/positrons are not transported, we assign a flux of zero.
   // Note that the heating score does NOT use the flux and will be non-zero for
   // electrons/positrons.
@@ -2012,6 +2253,11 @@ void score_analog_tally_ce(Particle& p)
     (p.type_ == Particle::Type::neutron || p.type_ == Particle::Type::photon) ?
     1.0 : 0.0;
 
+  // Derivatives of the rates of the event are shared by all tallies
+  if (!model::tally_derivs.empty()) {
+    prepare_derivative_rates(p, TallyEstimator::ANALOG);
+  }
+
   for (auto i_tally : model::active_analog_tallies) {
     const Tally& tally {*model::tallies[i_tally]};
 
@@ -2062,6 +2308,8 @@ void score_analog_tally_ce(Particle& p)
     if (settings::assume_separate) break;
   }
 
+  clear_derivative_rates(p);
+
   // Reset all the filter matches for the next tally event.
   for (auto& match : p.filter_matches_)
     match.bins_present_ = false;
@@ -2069,6 +2317,8 @@ void score_analog_tally_ce(Particle& p)
 
 void score_analog_tally_mg(Particle& p)
 {
+  InstrumentRegion region {Region::TALLY_SCORING};
+
   for (auto i_tally : model::active_analog_tallies) {
     const Tally& tally {*model::tallies[i_tally]};
 
@@ -2092,7 +2342,8 @@ void score_analog_tally_mg(Particle& p)
         if (i_nuclide >= 0) {
           auto j = model::materials[p.material_]->mat_nuclide_index_[i_nuclide];
           if (j == C_NONE) continue;
-          atom_density = model::materials[p.material_]->atom_density_(j);
+          atom_density = model::materials[p.material_]->atom_density_(j)
+            * p.density_mult_;
         }
 
         score_general_mg(p, i_tally, i*tally.scores_.size(), filter_index,
@@ -2115,10 +2366,13 @@ void score_analog_tally_mg(Particle& p)
 void
 score_tracklength_tally(Particle& p, double distance)
 {
+  InstrumentRegion region {Region::TALLY_SCORING};
+
   // Determine the tracklength estimate of the flux
   double flux = p.wgt_ * distance;
 
-  for (auto i_tally : model::active_tracklength_tallies) {
+  // Only the tallies that can score where the particle is are considered
+  for (auto i_tally : model::tracklength_tally_index.candidates(p)) {
     const Tally& tally {*model::tallies[i_tally]};
 
     // Initialize an iterator over valid filter bin combinations.  If there are
@@ -2148,18 +2402,13 @@ score_tracklength_tally(Particle& p, double distance)
             if (p.material_ != MATERIAL_VOID) {
               auto j = model::materials[p.material_]->mat_nuclide_index_[i_nuclide];
               if (j == C_NONE) continue;
-              atom_density = model::materials[p.material_]->atom_density_(j);
+              atom_density = model::materials[p.material_]->atom_density_(j)
+                * p.density_mult_;
             }
           }
 
-          //TODO: consider replacing this "if" with pointers or templates
-          if (settings::run_CE) {
-            score_general_ce(p, i_tally, i*tally.scores_.size(), filter_index,
-              filter_weight, i_nuclide, atom_density, flux);
-          } else {
-            score_general_mg(p, i_tally, i*tally.scores_.size(), filter_index,
-              filter_weight, i_nuclide, atom_density, flux);
-          }
+          score_general(p, i_tally, i*tally.scores_.size(), filter_index,
+            filter_weight, i_nuclide, atom_density, flux);
         }
       }
 
@@ -2175,10 +2424,14 @@ score_tracklength_tally(Particle& p, double distance)
   // Reset all the filter matches for the next tally event.
   for (auto& match : p.filter_matches_)
     match.bins_present_ = false;
+  for (auto& track : p.mesh_tracks_)
+    track.present = false;
 }
 
 void score_collision_tally(Particle& p)
 {
+  InstrumentRegion region {Region::TALLY_SCORING};
+
   // Determine the collision estimate of the flux
   double flux = 0.0;
   if (p.type_ == Particle::Type::neutron || p.type_ == Particle::Type::photon) {
@@ -2189,7 +2442,13 @@ void score_collision_tally(Particle& p)
     }
   }
 
-  for (auto i_tally : model::active_collision_tallies) {
+  // Derivatives of the rates of the material are shared by all tallies
+  if (!model::tally_derivs.empty()) {
+    prepare_derivative_rates(p, TallyEstimator::COLLISION);
+  }
+
+  // Only the tallies that can score where the particle is are considered
+  for (auto i_tally : model::collision_tally_index.candidates(p)) {
     const Tally& tally {*model::tallies[i_tally]};
 
     // Initialize an iterator over valid filter bin combinations.  If there are
@@ -2217,17 +2476,12 @@ void score_collision_tally(Particle& p)
           if (i_nuclide >= 0) {
             auto j = model::materials[p.material_]->mat_nuclide_index_[i_nuclide];
             if (j == C_NONE) continue;
-            atom_density = model::materials[p.material_]->atom_density_(j);
+            atom_density = model::materials[p.material_]->atom_density_(j)
+              * p.density_mult_;
           }
 
-          //TODO: consider replacing this "if" with pointers or templates
-          if (settings::run_CE) {
-            score_general_ce(p, i_tally, i*tally.scores_.size(), filter_index,
-              filter_weight, i_nuclide, atom_density, flux);
-          } else {
-            score_general_mg(p, i_tally, i*tally.scores_.size(), filter_index,
-              filter_weight, i_nuclide, atom_density, flux);
-          }
+          score_general(p, i_tally, i*tally.scores_.size(), filter_index,
+            filter_weight, i_nuclide, atom_density, flux);
         }
       }
     }
@@ -2239,6 +2493,8 @@ void score_collision_tally(Particle& p)
     if (settings::assume_separate) break;
   }
 
+  clear_derivative_rates(p);
+
   // Reset all the filter matches for the next tally event.
   for (auto& match : p.filter_matches_)
     match.bins_present_ = false;
@@ -2247,6 +2503,8 @@ void score_collision_tally(Particle& p)
 void
 score_surface_tally(Particle& p, const std::vector<int>& tallies)
 {
+  InstrumentRegion region {Region::TALLY_SCORING};
+
   // No collision, so no weight change when survival biasing
   double flux = p.wgt_;
 
@@ -2271,8 +2529,7 @@ score_surface_tally(Particle& p, const std::vector<int>& tallies)
       double score = flux * filter_weight;
       for (auto score_index = 0; score_index < tally.scores_.size();
            ++score_index) {
-        #pragma omp atomic
-        tally.results_(filter_index, score_index, TallyResult::VALUE) += score;
+        tally.add_score(filter_index, score_index, score);
       }
     }
 
@@ -1,13 +1,15 @@
 #include "openmc/tallies/trigger.h"
 
+#include <algorithm> // for any_of
 #include <cmath>
-#include <utility> // for std::pair
+#include <vector>
 
 #include <fmt/core.h>
 
 #include "openmc/capi.h"
 #include "openmc/constants.h"
 #include "openmc/error.h"
+#include "openmc/message_passing.h"
 #include "openmc/reaction.h"
 #include "openmc/settings.h"
 #include "openmc/simulation.h"
@@ -27,24 +29,78 @@ namespace settings {
 // Non-member functions
 //==============================================================================
 
-std::pair<double, double>
-get_tally_uncertainty(int i_tally, int score_index, int filter_index)
+namespace {
+
+//! Find the limiting trigger of a tally with at least two realizations
+//
+//! \param t Tally with triggers
+//! \param[out] score The most limiting score bin, or C_NONE if no trigger is
+//!   active
+//! \return The largest uncertainty/threshold ratio of the triggers
+double tally_trigger_ratio(Tally& t, int& score)
 {
-  const auto& tally {model::tallies[i_tally]};
+  double ratio = 0.;
+  score = C_NONE;
+
+  // The largest uncertainty of each score limits the triggers, and is
+  // usually found when the realization is accumulated
+  t.update_max_uncertainty();
+  int n_scores = t.scores_.size() * t.nuclides_.size();
+
+  for (const auto& trigger : t.triggers_) {
+    // Skip trigger if it is not active
+    if (trigger.metric == TriggerMetric::not_active) continue;
+
+    for (auto score_index = 0; score_index < n_scores; ++score_index) {
+      double std_dev = t.max_std_dev()[score_index];
+      double rel_err = t.max_rel_err()[score_index];
+
+      // Pick out the relevant uncertainty metric for this trigger.
+      double uncertainty;
+      switch (trigger.metric) {
+        case TriggerMetric::variance:
+          uncertainty = std_dev * std_dev;
+          break;
+        case TriggerMetric::standard_deviation:
+          uncertainty = std_dev;
+          break;
+        case TriggerMetric::relative_error:
+          uncertainty = rel_err;
+          break;
+      }
+
+      // Compute the uncertainty / threshold ratio.
+      double this_ratio = uncertainty / trigger.threshold;
+      if (trigger.metric == TriggerMetric::variance) {
+        this_ratio = std::sqrt(this_ratio);
+      }
 
-  auto sum = tally->results_(filter_index, score_index, TallyResult::SUM);
-  auto sum_sq = tally->results_(filter_index, score_index, TallyResult::SUM_SQ);
+      // If this is the most uncertain value, set the output variables.
+      if (this_ratio > ratio) {
+        ratio = this_ratio;
+        score = t.scores_[trigger.score_index];
+      }
+    }
+  }
+  return ratio;
+}
 
-  int n = tally->n_realizations_;
-  auto mean = sum / n;
-  double std_dev = std::sqrt((sum_sq/n - mean*mean) / (n-1));
-  double rel_err = (mean != 0.) ? std_dev / std::abs(mean) : 0.;
+} // namespace
 
-  return {std_dev, rel_err};
+bool
+triggers_due()
+{
+  const auto current_batch {simulation::current_batch};
+  const auto n_batches {settings::n_batches};
+  return settings::trigger_on && current_batch >= n_batches &&
+    (current_batch - n_batches) % settings::trigger_batch_interval == 0;
 }
 
 //! Find the limiting limiting tally trigger.
 //
+//! All processes take part so that the bins of decomposed tallies can be
+//! checked by the processes that own them. The outputs are only set on the
+//! master process.
 //! param[out] ratio The uncertainty/threshold ratio for the most limiting
 //!   tally trigger
 //! param[out] tally_id The ID number of the most limiting tally
@@ -54,57 +110,84 @@ void
 check_tally_triggers(double& ratio, int& tally_id, int& score)
 {
   ratio = 0.;
+  tally_id = C_NONE;
+  score = C_NONE;
   for (auto i_tally = 0; i_tally < model::tallies.size(); ++i_tally) {
-    const Tally& t {*model::tallies[i_tally]};
+    Tally& t {*model::tallies[i_tally]};
+
+    // Only the master process has the results of tallies that are not
+    // decomposed
+    if (!mpi::master && !t.decomposed()) continue;
 
     // Ignore tallies with less than two realizations.
-    if (t.n_realizations_ < 2) continue;
-
-    for (const auto& trigger : t.triggers_) {
-      // Skip trigger if it is not active
-      if (trigger.metric == TriggerMetric::not_active) continue;
-
-      const auto& results = t.results_;
-      for (auto filter_index = 0; filter_index < results.shape()[0];
-           ++filter_index) {
-        for (auto score_index = 0; score_index < results.shape()[1];
-             ++score_index) {
-          // Compute the tally uncertainty metrics.
-          auto uncert_pair = get_tally_uncertainty(i_tally, score_index,
-            filter_index);
-          double std_dev = uncert_pair.first;
-          double rel_err = uncert_pair.second;
-
-          // Pick out the relevant uncertainty metric for this trigger.
-          double uncertainty;
-          switch (trigger.metric) {
-            case TriggerMetric::variance:
-              uncertainty = std_dev * std_dev;
-              break;
-            case TriggerMetric::standard_deviation:
-              uncertainty = std_dev;
-              break;
-            case TriggerMetric::relative_error:
-              uncertainty = rel_err;
-              break;
-          }
-
-          // Compute the uncertainty / threshold ratio.
-          double this_ratio = uncertainty / trigger.threshold;
-          if (trigger.metric == TriggerMetric::variance) {
-            this_ratio = std::sqrt(ratio);
-          }
-
-          // If this is the most uncertain value, set the output variables.
-          if (this_ratio > ratio) {
-            ratio = this_ratio;
-            score = t.scores_[trigger.score_index];
-            tally_id = t.id_;
-          }
+    if (t.n_realizations_ < 2 || t.triggers_.empty()) continue;
+
+    int tally_score;
+    double tally_ratio = tally_trigger_ratio(t, tally_score);
+    if (tally_ratio > ratio) {
+      ratio = tally_ratio;
+      score = tally_score;
+      tally_id = t.id_;
+    }
+  }
+
+#ifdef OPENMC_MPI
+  // Find the most limiting trigger among the bins owned by each process
+  if (std::any_of(model::tallies.begin(), model::tallies.end(),
+      [](const std::unique_ptr<Tally>& t) { return t->decomposed(); })) {
+    std::vector<double> ratios(mpi::n_procs);
+    MPI_Gather(&ratio, 1, MPI_DOUBLE, ratios.data(), 1, MPI_DOUBLE, 0,
+      mpi::intracomm);
+    int ids[] {tally_id, score};
+    std::vector<int> all_ids(2*mpi::n_procs);
+    MPI_Gather(ids, 2, MPI_INT, all_ids.data(), 2, MPI_INT, 0, mpi::intracomm);
+    if (mpi::master) {
+      for (int i = 1; i < mpi::n_procs; ++i) {
+        if (ratios[i] > ratio) {
+          ratio = ratios[i];
+          tally_id = all_ids[2*i];
+          score = all_ids[2*i + 1];
         }
       }
     }
   }
+#endif
+}
+
+//! Stop scoring to the tallies whose triggers are all satisfied, so that the
+//! remaining batches are spent on the tallies that have not converged.
+//
+//! The master process decides for the tallies it holds the results of, so
+//! decomposed tallies are never frozen. This must be called on all processes.
+
+void
+freeze_satisfied_tallies()
+{
+  int n = model::tallies.size();
+  std::vector<int> satisfied(n, 0);
+  if (mpi::master) {
+    for (int i = 0; i < n; ++i) {
+      Tally& t {*model::tallies[i]};
+      if (!t.active_ || t.frozen_ || t.decomposed()) continue;
+      if (t.n_realizations_ < 2 || t.triggers_.empty()) continue;
+      int score;
+      satisfied[i] = tally_trigger_ratio(t, score) <= 1.;
+    }
+  }
+#ifdef OPENMC_MPI
+  MPI_Bcast(satisfied.data(), n, MPI_INT, 0, mpi::intracomm);
+#endif
+
+  bool changed = false;
+  for (int i = 0; i < n; ++i) {
+    if (!satisfied[i]) continue;
+    Tally& t {*model::tallies[i]};
+    t.frozen_ = true;
+    changed = true;
+    write_message(fmt::format("Triggers satisfied for tally {} after {} "
+      "realizations, which is no longer scored", t.id_, t.n_realizations_), 7);
+  }
+  if (changed) setup_active_tallies();
 }
 
 //! Compute the uncertainty/threshold ratio for the eigenvalue trigger.
@@ -145,21 +228,18 @@ check_keff_trigger()
 void
 check_triggers()
 {
-  // Make some aliases.
-  const auto current_batch {simulation::current_batch};
-  const auto n_batches {settings::n_batches};
-  const auto interval {settings::trigger_batch_interval};
-
   // See if the current batch is one for which the triggers must be checked.
-  if (!settings::trigger_on) return;
-  if (current_batch < n_batches) return;
-  if (((current_batch - n_batches) % interval) != 0) return;
+  if (!triggers_due()) return;
+  const auto current_batch {simulation::current_batch};
 
-  // Check the eigenvalue and tally triggers.
-  double keff_ratio = check_keff_trigger();
+  // Check the tally triggers on all processes and the eigenvalue trigger on
+  // the master process.
   double tally_ratio;
   int tally_id, score;
   check_tally_triggers(tally_ratio, tally_id, score);
+  if (settings::trigger_freeze) freeze_satisfied_tallies();
+  if (!mpi::master) return;
+  double keff_ratio = check_keff_trigger();
 
   // If all the triggers are satisfied, alert the user and return.
   if (std::max(keff_ratio, tally_ratio) <= 1.) {
@@ -11,6 +11,7 @@
 #include "xtensor/xtensor.hpp"
 #include "xtensor/xview.hpp"
 
+#include "openmc/cell.h"
 #include "openmc/constants.h"
 #include "openmc/endf.h"
 #include "openmc/error.h"
@@ -147,9 +148,30 @@ ThermalScattering::ThermalScattering(hid_t group, const std::vector<double>& tem
 void
 ThermalScattering::calculate_xs(double E, double sqrtkT, int* i_temp,
                                 double* elastic, double* inelastic,
-                                uint64_t* seed) const
+                                uint64_t* seed,
+                                const NuclideTemperature* temperature) const
+{
+  // Determine temperature for S(a,b) table, unless it was precomputed for the
+  // particle's cell
+  NuclideTemperature temp = temperature ? *temperature :
+    this->temperature_index(sqrtkT);
+  int i = temp.index;
+
+  // Randomly sample between temperature i and i+1
+  if (settings::temperature_method == TemperatureMethod::INTERPOLATION) {
+    if (temp.interp > prn(seed)) ++i;
+  }
+
+  // Set temperature index
+  *i_temp = i;
+
+  // Calculate cross sections for ith temperature
+  data_[i].calculate_xs(E, elastic, inelastic);
+}
+
+NuclideTemperature
+ThermalScattering::temperature_index(double sqrtkT) const
 {
-  // Determine temperature for S(a,b) table
   double kT = sqrtkT*sqrtkT;
   int i;
   if (settings::temperature_method == TemperatureMethod::NEAREST) {
@@ -159,24 +181,17 @@ ThermalScattering::calculate_xs(double E, double sqrtkT, int* i_temp,
         break;
       }
     }
-  } else {
-    // Find temperatures that bound the actual temperature
-    for (i = 0; i < kTs_.size() - 1; ++i) {
-      if (kTs_[i] <= kT && kT < kTs_[i+1]) {
-        break;
-      }
-    }
-
-    // Randomly sample between temperature i and i+1
-    double f = (kT - kTs_[i]) / (kTs_[i+1] - kTs_[i]);
-    if (f > prn(seed)) ++i;
+    return {i, 0.0};
   }
 
-  // Set temperature index
-  *i_temp = i;
-
-  // Calculate cross sections for ith temperature
-  data_[i].calculate_xs(E, elastic, inelastic);
+  // Find temperatures that bound the actual temperature
+  if (kTs_.size() == 1) return {0, 0.0};
+  for (i = 0; i < kTs_.size() - 1; ++i) {
+    if (kTs_[i] <= kT && kT < kTs_[i+1]) {
+      break;
+    }
+  }
+  return {i, (kT - kTs_[i]) / (kTs_[i+1] - kTs_[i])};
 }
 
 bool
@@ -186,6 +201,29 @@ ThermalScattering::has_nuclide(const char* name) const
   return std::find(nuclides_.begin(), nuclides_.end(), nuc) != nuclides_.end();
 }
 
+std::size_t
+ThermalScattering::memory() const
+{
+  // Tabulated cross sections and Bragg edges
+  auto xs_memory = [](const Function1D* f) -> std::size_t {
+    if (auto xs = dynamic_cast<const Tabulated1D*>(f)) {
+      return (xs->x().size() + xs->y().size())*sizeof(double);
+    } else if (auto xs = dynamic_cast<const CoherentElasticXS*>(f)) {
+      return (xs->bragg_edges().size() + xs->factors().size())*sizeof(double);
+    }
+    return 0;
+  };
+
+  std::size_t n = 0;
+  for (const auto& d : data_) {
+    for (const auto* rx : {&d.elastic_, &d.inelastic_}) {
+      n += xs_memory(rx->xs.get());
+      if (rx->distribution) n += rx->distribution->memory();
+    }
+  }
+  return n;
+}
+
 //==============================================================================
 // ThermalData implementation
 //==============================================================================
@@ -244,20 +282,102 @@ ThermalData::ThermalData(hid_t group)
 
     close_group(inelastic_group);
   }
+
+  this->init_xs_types();
+}
+
+void
+ThermalData::init_xs_types()
+{
+  // The fast path of calculate_xs needs linearly interpolated inelastic data
+  auto inelastic = dynamic_cast<const Tabulated1D*>(inelastic_.xs.get());
+  if (!inelastic || !inelastic->linear()) return;
+  inelastic_table_ = inelastic;
+
+  const auto* xs = elastic_.xs.get();
+  coherent_xs_ = dynamic_cast<const CoherentElasticXS*>(xs);
+  incoherent_xs_ = dynamic_cast<const IncoherentElasticXS*>(xs);
+  auto elastic = dynamic_cast<const Tabulated1D*>(xs);
+  if (elastic && elastic->linear()) {
+    elastic_table_ = elastic;
+    shared_grid_ = (elastic->x() == inelastic->x());
+  }
 }
 
 void
 ThermalData::calculate_xs(double E, double* elastic, double* inelastic) const
 {
-  // Calculate thermal elastic scattering cross section
-  if (elastic_.xs) {
+  if (!inelastic_table_) {
+    // Calculate thermal elastic scattering cross section
+    if (elastic_.xs) {
+      *elastic = (*elastic_.xs)(E);
+    } else {
+      *elastic = 0.0;
+    }
+
+    // Calculate thermal inelastic scattering cross section
+    *inelastic = (*inelastic_.xs)(E);
+    return;
+  }
+
+  // Interpolate the inelastic cross section, which is constant outside of its
+  // grid as for Tabulated1D
+  const auto& x {inelastic_table_->x()};
+  const auto& y {inelastic_table_->y()};
+  int n = x.size();
+  int i;
+  double r;
+  if (E <= x[0]) {
+    i = 0;
+    r = 0.0;
+  } else if (E >= x[n - 1]) {
+    i = n - 2;
+    r = 1.0;
+  } else {
+    i = lower_bound_index(x.begin(), x.end(), E);
+    r = (E - x[i]) / (x[i + 1] - x[i]);
+  }
+  *inelastic = y[i] + r*(y[i + 1] - y[i]);
+
+  // The elastic cross section reuses the interval when on the same grid
+  if (coherent_xs_) {
+    *elastic = (*coherent_xs_)(E);
+  } else if (incoherent_xs_) {
+    *elastic = (*incoherent_xs_)(E);
+  } else if (shared_grid_) {
+    const auto& y_el {elastic_table_->y()};
+    *elastic = y_el[i] + r*(y_el[i + 1] - y_el[i]);
+  } else if (elastic_.xs) {
     *elastic = (*elastic_.xs)(E);
   } else {
     *elastic = 0.0;
   }
+}
+
+double
+ThermalData::max_xs(double E_low, double E_high) const
+{
+  std::vector<double> energies {E_low, E_high};
+  auto add_points = [&](const std::vector<double>& x) {
+    auto first = std::lower_bound(x.begin(), x.end(), E_low);
+    auto last = std::upper_bound(first, x.end(), E_high);
+    energies.insert(energies.end(), first, last);
+  };
+  for (const auto* f : {elastic_.xs.get(), inelastic_.xs.get()}) {
+    if (auto table = dynamic_cast<const Tabulated1D*>(f)) {
+      add_points(table->x());
+    } else if (auto coherent = dynamic_cast<const CoherentElasticXS*>(f)) {
+      add_points(coherent->bragg_edges());
+    }
+  }
 
-  // Calculate thermal inelastic scattering cross section
-  *inelastic = (*inelastic_.xs)(E);
+  double xs = 0.0;
+  for (double E : energies) {
+    double elastic, inelastic;
+    this->calculate_xs(E, &elastic, &inelastic);
+    xs = std::max(xs, elastic + inelastic);
+  }
+  return xs;
 }
 
 void
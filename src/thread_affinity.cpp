@@ -0,0 +1,176 @@
+#include "openmc/thread_affinity.h"
+
+#include <algorithm> // for find, sort
+#include <cstdint>
+#include <string>
+#include <tuple>     // for tie
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h> // for sched_getaffinity, sched_setaffinity
+#endif
+
+#include <fmt/core.h>
+
+#include "openmc/error.h"
+#include "openmc/memory_placement.h"
+#include "openmc/message_passing.h"
+#include "openmc/openmp_interface.h"
+#include "openmc/settings.h"
+
+namespace openmc {
+
+namespace {
+
+#if defined(__linux__) && defined(_OPENMP)
+
+//! Position of a CPU in the topology of the node
+struct Cpu {
+  int id;      //!< Index of the CPU
+  int node;    //!< NUMA node
+  int package; //!< Socket
+  int core;    //!< Core within the socket
+
+  //! Order CPUs so that those sharing a core, then a node, then a socket are
+  //! adjacent
+  bool operator<(const Cpu& rhs) const
+  {
+    return std::tie(node, package, core, id) <
+      std::tie(rhs.node, rhs.package, rhs.core, rhs.id);
+  }
+};
+
+//! Read an integer from a file, with a default if it cannot be read
+int read_id(const std::string& path, int fallback)
+{
+  auto ids = read_id_list(path);
+  return ids.empty() ? fallback : ids[0];
+}
+
+//! Format the CPUs in a set as, e.g., "0-3,8"
+std::string format_cpu_set(const cpu_set_t& set)
+{
+  std::string list;
+  for (int i = 0; i < CPU_SETSIZE; ++i) {
+    if (!CPU_ISSET(i, &set)) continue;
+    int last = i;
+    while (last + 1 < CPU_SETSIZE && CPU_ISSET(last + 1, &set)) ++last;
+    if (!list.empty()) list += ',';
+    list += (last == i) ? std::to_string(i) : fmt::format("{}-{}", i, last);
+    i = last;
+  }
+  return list;
+}
+
+#endif
+
+} // namespace
+
+//==============================================================================
+// Non-member functions
+//==============================================================================
+
+void bind_threads()
+{
+  using settings::thread_affinity;
+  if (thread_affinity == ThreadAffinity::NONE) return;
+
+#if defined(__linux__) && defined(_OPENMP)
+  if (omp_get_proc_bind() != omp_proc_bind_false) {
+    warning("Thread affinity is left to OMP_PROC_BIND since it is set.");
+    return;
+  }
+
+  // Find the topology of the CPUs the process may run on
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+    warning("Could not determine the CPUs available for threads.");
+    return;
+  }
+  std::vector<Cpu> cpus;
+  for (int i = 0; i < CPU_SETSIZE; ++i) {
+    if (CPU_ISSET(i, &allowed)) cpus.push_back({i, 0, 0, i});
+  }
+  for (int node : read_id_list("/sys/devices/system/node/online")) {
+    auto list = read_id_list(
+      fmt::format("/sys/devices/system/node/node{}/cpulist", node));
+    for (auto& c : cpus) {
+      if (std::find(list.begin(), list.end(), c.id) != list.end()) {
+        c.node = node;
+      }
+    }
+  }
+  for (auto& c : cpus) {
+    std::string topology =
+      fmt::format("/sys/devices/system/cpu/cpu{}/topology/", c.id);
+    c.package = read_id(topology + "physical_package_id", 0);
+    c.core = read_id(topology + "core_id", c.id);
+  }
+  std::sort(cpus.begin(), cpus.end());
+
+  // Distinct nodes in order
+  std::vector<int> nodes;
+  for (const auto& c : cpus) {
+    if (nodes.empty() || nodes.back() != c.node) nodes.push_back(c.node);
+  }
+
+  int n_threads = omp_get_max_threads();
+  int n_cpus = cpus.size();
+  std::vector<std::string> binding(n_threads);
+  bool failed = false;
+
+  #pragma omp parallel
+  {
+    int t = omp_get_thread_num();
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    switch (thread_affinity) {
+    case ThreadAffinity::COMPACT:
+      // Consecutive threads fill the hardware threads of a core, then the
+      // cores of a node
+      CPU_SET(cpus[t % n_cpus].id, &set);
+      break;
+    case ThreadAffinity::SPREAD:
+      // Threads are spaced evenly over the CPUs, so each gets its own core
+      // and the nodes are shared equally when there are fewer threads
+      CPU_SET(cpus[static_cast<int64_t>(t)*n_cpus / n_threads % n_cpus].id,
+        &set);
+      break;
+    case ThreadAffinity::NUMA: {
+      // Blocks of consecutive threads share the CPUs of a node, on which the
+      // operating system is free to move them
+      int node = nodes[static_cast<int64_t>(t)*nodes.size() / n_threads];
+      for (const auto& c : cpus) {
+        if (c.node == node) CPU_SET(c.id, &set);
+      }
+      break;
+    }
+    default:
+      break;
+    }
+
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+      #pragma omp atomic write
+      failed = true;
+    }
+    CPU_ZERO(&set);
+    sched_getaffinity(0, sizeof(set), &set);
+    binding[t] = format_cpu_set(set);
+  }
+
+  if (failed) warning("Could not bind all threads to their CPUs.");
+
+  // Report the binding of each thread on the master process
+  if (mpi::master) {
+    for (int t = 0; t < n_threads; ++t) {
+      write_message(fmt::format(" Thread {} bound to CPUs {}", t, binding[t]),
+        6);
+    }
+  }
+#else
+  warning("Thread affinity is only supported on Linux with OpenMP.");
+#endif
+}
+
+} // namespace openmc
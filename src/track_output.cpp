@@ -2,22 +2,162 @@
 
 #include "openmc/constants.h"
 #include "openmc/hdf5_interface.h"
+#include "openmc/message_passing.h"
 #include "openmc/position.h"
 #include "openmc/settings.h"
 #include "openmc/simulation.h"
+#include "openmc/state_point.h"
 
 #include <fmt/core.h>
 #include "xtensor/xtensor.hpp"
 
 #include <cstddef> // for size_t
+#include <cstdint> // for int64_t
 #include <string>
 #include <vector>
 
 namespace openmc {
 
-//==============================================================================
-// Global variables
-//==============================================================================
+namespace {
+
+// Number of values stored for each state and each track in a single track file
+constexpr hsize_t STATE_SIZE {5};
+constexpr hsize_t TRACK_SIZE {5};
+
+// Number of states a thread buffers before they are appended to the file
+constexpr size_t BUFFER_STATES {1 << 16};
+
+//! Tracks finished by one thread that have not been written yet
+struct TrackBuffer {
+  bool registered {false};
+  std::vector<double> states;  //!< x, y, z, E and weight of each state
+  std::vector<int64_t> tracks; //!< batch, generation, particle, index of the
+                               //!< first state and number of states
+};
+
+thread_local TrackBuffer thread_buffer;
+std::vector<TrackBuffer*> buffers; //!< buffers of all threads
+hid_t track_file {-1};             //!< single track file, if open
+hsize_t n_states_written {0};
+hsize_t n_tracks_written {0};
+
+//! Create an empty two-dimensional dataset that can grow along its rows
+
+void create_extendable_dataset(hid_t group_id, const char* name, hid_t type,
+  hsize_t n_cols, hsize_t chunk_rows)
+{
+  hsize_t dims[] {0, n_cols};
+  hsize_t maxdims[] {H5S_UNLIMITED, n_cols};
+  hsize_t chunk[] {chunk_rows, n_cols};
+  hid_t dspace = H5Screate_simple(2, dims, maxdims);
+  hid_t dcpl = H5Pcreate(H5P_DATASET_CREATE);
+  H5Pset_chunk(dcpl, 2, chunk);
+  hid_t dset = H5Dcreate(group_id, name, type, dspace, H5P_DEFAULT, dcpl,
+    H5P_DEFAULT);
+  H5Dclose(dset);
+  H5Pclose(dcpl);
+  H5Sclose(dspace);
+}
+
+//! Append rows to a dataset made by create_extendable_dataset
+
+void append_rows(hid_t group_id, const char* name, hid_t type, hsize_t n_cols,
+  hsize_t n_rows_old, hsize_t n_rows, const void* buffer)
+{
+  hid_t dset = H5Dopen(group_id, name, H5P_DEFAULT);
+  hsize_t dims[] {n_rows_old + n_rows, n_cols};
+  H5Dset_extent(dset, dims);
+
+  hsize_t start[] {n_rows_old, 0};
+  hsize_t count[] {n_rows, n_cols};
+  hid_t filespace = H5Dget_space(dset);
+  H5Sselect_hyperslab(filespace, H5S_SELECT_SET, start, nullptr, count,
+    nullptr);
+  hid_t memspace = H5Screate_simple(2, count, nullptr);
+  H5Dwrite(dset, type, memspace, filespace, H5P_DEFAULT, buffer);
+
+  H5Sclose(memspace);
+  H5Sclose(filespace);
+  H5Dclose(dset);
+}
+
+//! Create the single track file of this process
+
+void open_track_file()
+{
+  std::string filename = mpi::n_procs > 1 ?
+    fmt::format("{}tracks_{}.h5", settings::path_output, mpi::rank) :
+    fmt::format("{}tracks.h5", settings::path_output);
+
+  track_file = file_open(filename, 'w');
+  write_attribute(track_file, "filetype", "tracks");
+  write_attribute(track_file, "version", VERSION_TRACKS);
+  create_extendable_dataset(track_file, "states", H5T_NATIVE_DOUBLE,
+    STATE_SIZE, 4096);
+  create_extendable_dataset(track_file, "tracks", H5T_NATIVE_INT64,
+    TRACK_SIZE, 1024);
+  n_states_written = 0;
+  n_tracks_written = 0;
+}
+
+//! Append the tracks of a buffer to the single track file. This must only be
+//! called by one thread at a time.
+
+void write_buffer(TrackBuffer& buffer)
+{
+  if (buffer.tracks.empty()) return;
+
+  // Don't use HDF5 while a state point is written in the background
+  wait_state_point();
+  if (track_file < 0) open_track_file();
+
+  // The states of each track were indexed within the buffer
+  for (size_t i = 3; i < buffer.tracks.size(); i += TRACK_SIZE) {
+    buffer.tracks[i] += n_states_written;
+  }
+
+  hsize_t n_states = buffer.states.size() / STATE_SIZE;
+  hsize_t n_tracks = buffer.tracks.size() / TRACK_SIZE;
+  append_rows(track_file, "states", H5T_NATIVE_DOUBLE, STATE_SIZE,
+    n_states_written, n_states, buffer.states.data());
+  append_rows(track_file, "tracks", H5T_NATIVE_INT64, TRACK_SIZE,
+    n_tracks_written, n_tracks, buffer.tracks.data());
+  n_states_written += n_states;
+  n_tracks_written += n_tracks;
+
+  buffer.states.clear();
+  buffer.tracks.clear();
+}
+
+//! Add the tracks of a particle to the buffer of the current thread
+
+void buffer_particle_track(const Particle& p)
+{
+  auto& buffer = thread_buffer;
+  if (!buffer.registered) {
+    #pragma omp critical (FinalizeParticleTrack)
+    buffers.push_back(&buffer);
+    buffer.registered = true;
+  }
+
+  for (const auto& track : p.tracks_) {
+    buffer.tracks.insert(buffer.tracks.end(), {simulation::current_batch,
+      simulation::current_gen, p.id_,
+      static_cast<int64_t>(buffer.states.size() / STATE_SIZE),
+      static_cast<int64_t>(track.size())});
+    for (const auto& state : track) {
+      buffer.states.insert(buffer.states.end(),
+        {state.r.x, state.r.y, state.r.z, state.E, state.wgt});
+    }
+  }
+
+  if (buffer.states.size() >= BUFFER_STATES*STATE_SIZE) {
+    #pragma omp critical (FinalizeParticleTrack)
+    write_buffer(buffer);
+  }
+}
+
+} // namespace
 
 //==============================================================================
 // Non-member functions
@@ -30,11 +170,17 @@ void add_particle_track(Particle& p)
 
 void write_particle_track(Particle& p)
 {
-  p.tracks_.back().push_back(p.r());
+  p.tracks_.back().push_back({p.r(), p.E_, p.wgt_});
 }
 
 void finalize_particle_track(Particle& p)
 {
+  if (settings::track_single_file) {
+    buffer_particle_track(p);
+    p.tracks_.clear();
+    return;
+  }
+
   std::string filename = fmt::format("{}track_{}_{}_{}.h5",
     settings::path_output, simulation::current_batch, simulation::current_gen,
     p.id_);
@@ -47,6 +193,9 @@ void finalize_particle_track(Particle& p)
 
   #pragma omp critical (FinalizeParticleTrack)
   {
+    // Don't use HDF5 while a state point is written in the background
+    wait_state_point();
+
     hid_t file_id = file_open(filename, 'w');
     write_attribute(file_id, "filetype", "track");
     write_attribute(file_id, "version", VERSION_TRACK);
@@ -57,9 +206,9 @@ void finalize_particle_track(Particle& p)
       size_t n = t.size();
       xt::xtensor<double, 2> data({n,3});
       for (int j = 0; j < n; ++j) {
-        data(j, 0) = t[j].x;
-        data(j, 1) = t[j].y;
-        data(j, 2) = t[j].z;
+        data(j, 0) = t[j].r.x;
+        data(j, 1) = t[j].r.y;
+        data(j, 2) = t[j].r.z;
       }
       std::string name = fmt::format("coordinates_{}", i);
       write_dataset(file_id, name.c_str(), data);
@@ -71,4 +220,21 @@ void finalize_particle_track(Particle& p)
   p.tracks_.clear();
 }
 
+void write_particle_tracks()
+{
+  for (auto buffer : buffers) {
+    write_buffer(*buffer);
+  }
+  if (track_file >= 0) H5Fflush(track_file, H5F_SCOPE_LOCAL);
+}
+
+void close_track_file()
+{
+  write_particle_tracks();
+  if (track_file >= 0) {
+    file_close(track_file);
+    track_file = -1;
+  }
+}
+
 } // namespace openmc
@@ -26,6 +26,18 @@ UrrData::UrrData(hid_t group_id)
 
   // Read URR tables
   read_dataset(group_id, "table", prob_);
+
+  // Gather the values used during tracking band by band
+  n_band_ = prob_.shape()[2];
+  bands_.reserve(n_energy_*n_band_);
+  for (int i = 0; i < n_energy_; ++i) {
+    for (int b = 0; b < n_band_; ++b) {
+      bands_.push_back({prob_(i, URRTableParam::CUM_PROB, b),
+        prob_(i, URRTableParam::ELASTIC, b),
+        prob_(i, URRTableParam::FISSION, b),
+        prob_(i, URRTableParam::N_GAMMA, b)});
+    }
+  }
 }
 
 }
\ No newline at end of file
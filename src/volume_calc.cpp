@@ -12,6 +12,7 @@
 #include "openmc/output.h"
 #include "openmc/random_lcg.h"
 #include "openmc/settings.h"
+#include "openmc/surface.h"
 #include "openmc/timer.h"
 #include "openmc/xml_interface.h"
 
@@ -22,9 +23,11 @@
 #include "xtensor/xadapt.hpp"
 #include "xtensor/xview.hpp"
 
-#include <algorithm> // for copy
+#include <algorithm> // for copy, max, min, sort
 #include <cmath> // for pow, sqrt
+#include <unordered_map>
 #include <unordered_set>
+#include <utility> // for pair
 
 namespace openmc {
 
@@ -36,6 +39,143 @@ namespace model {
   std::vector<VolumeCalculation> volume_calcs;
 }
 
+namespace {
+
+//! Sum over samples (points or rays) of the fraction of a sample in a pair of
+//! domain and material, and of its square, for estimating the variance
+struct HitSum {
+  double sum {0.0};
+  double sum_sq {0.0};
+};
+
+//! Sums over samples keyed by hit_key() or domain_key()
+using HitMap = std::unordered_map<int64_t, HitSum>;
+
+//! Key of a pair of domain and material in a HitMap
+//
+//! \param i_domain Index of the domain in the volume calculation
+//! \param i_material Index in global materials vector, or MATERIAL_VOID
+//! \param n_materials Number of materials in the model
+int64_t hit_key(int i_domain, int i_material, int n_materials)
+{
+  return static_cast<int64_t>(i_domain)*(n_materials + 2) + i_material + 1;
+}
+
+//! Key of a domain as a whole, over all its materials, in a HitMap
+int64_t domain_key(int i_domain, int n_materials)
+{
+  return hit_key(i_domain, n_materials, n_materials);
+}
+
+//! Variance of the mean fraction of samples in a domain and material. For
+//! points, whose fractions are 0 or 1, this is f(1 - f)/n.
+double variance_of_mean(const HitSum& hit, size_t n)
+{
+  double f = hit.sum / n;
+  return std::max(hit.sum_sq / n - f*f, 0.0) / n;
+}
+
+//! Find the keys of the domains and material a particle is in
+//
+//! \param p Particle located in the geometry
+//! \param type Type of the domains
+//! \param domain_index Index of the domain of each cell, material or universe
+//! \param n_materials Number of materials in the model
+//! \param[out] keys Key of each pair of domain and material and of each domain
+void find_keys(const Particle& p, VolumeCalculation::TallyDomain type,
+  const std::vector<int>& domain_index, int n_materials,
+  std::vector<int64_t>& keys)
+{
+  keys.clear();
+  if (type == VolumeCalculation::TallyDomain::MATERIAL) {
+    if (p.material_ == MATERIAL_VOID) return;
+    int i_domain = domain_index[p.material_];
+    if (i_domain != C_NONE) {
+      keys.push_back(hit_key(i_domain, p.material_, n_materials));
+      keys.push_back(domain_key(i_domain, n_materials));
+    }
+  } else {
+    // A location is in every cell or universe it is found in at any
+    // coordinate level
+    for (int level = 0; level < p.n_coord_; ++level) {
+      int i_domain = (type == VolumeCalculation::TallyDomain::CELL) ?
+        domain_index[p.coord_[level].cell] :
+        domain_index[p.coord_[level].universe];
+      if (i_domain != C_NONE) {
+        keys.push_back(hit_key(i_domain, p.material_, n_materials));
+        keys.push_back(domain_key(i_domain, n_materials));
+      }
+    }
+  }
+}
+
+//! Move a particle that is outside the geometry to the next surface along its
+//! direction, which bounds the region outside the geometry
+//
+//! \param p Particle outside of any cell
+//! \return Distance moved, or INFTY if no surface is ahead
+double move_to_next_surface(Particle& p)
+{
+  double distance = INFTY;
+  for (const auto& surf : model::surfaces) {
+    distance = std::min(distance, surf->distance(p.r(), p.u(), false));
+  }
+  if (distance < INFTY) {
+    distance += TINY_BIT;
+    p.r() += distance*p.u();
+  }
+  return distance;
+}
+
+//! Trace a ray through the geometry, adding the length it travels in each
+//! domain and material
+//
+//! \param p Particle at the start of the ray, moving along it
+//! \param length Length of the ray
+//! \param type Type of the domains
+//! \param domain_index Index of the domain of each cell, material or universe
+//! \param n_materials Number of materials in the model
+//! \param keys Scratch space for the keys of the current location
+//! \param[in,out] lengths Length of the ray keyed by hit_key() or domain_key()
+void trace_ray(Particle& p, double length,
+  VolumeCalculation::TallyDomain type, const std::vector<int>& domain_index,
+  int n_materials, std::vector<int64_t>& keys,
+  std::unordered_map<int64_t, double>& lengths)
+{
+  p.n_coord_ = 1;
+  p.surface_ = 0;
+  bool found = find_cell(p, false);
+  double traveled = 0.0;
+  while (traveled < length) {
+    // Parts of the ray outside the geometry are skipped
+    if (!found) {
+      traveled += move_to_next_surface(p);
+      if (traveled >= length) return;
+      p.n_coord_ = 1;
+      p.surface_ = 0;
+      found = find_cell(p, false);
+      continue;
+    }
+
+    auto boundary = distance_to_boundary(p);
+    double distance = std::min(boundary.distance, length - traveled);
+    find_keys(p, type, domain_index, n_materials, keys);
+    for (auto key : keys) {
+      lengths[key] += distance;
+    }
+    traveled += distance;
+    if (traveled >= length) return;
+
+    for (int j = 0; j < p.n_coord_; ++j) {
+      p.coord_[j].r += distance * p.coord_[j].u;
+    }
+
+    found = cross_boundary_ray(p, boundary);
+  }
+}
+
+} // namespace
+
 //==============================================================================
 // VolumeCalculation implementation
 //==============================================================================
@@ -61,6 +201,18 @@ VolumeCalculation::VolumeCalculation(pugi::xml_node node)
   upper_right_ = get_node_array<double>(node, "upper_right");
   n_samples_ = std::stoull(get_node_value(node, "samples"));
 
+  if (check_for_node(node, "estimator")) {
+    std::string estimator = get_node_value(node, "estimator", true, true);
+    if (estimator == "point") {
+      estimator_ = Estimator::POINT;
+    } else if (estimator == "ray") {
+      estimator_ = Estimator::RAY;
+    } else {
+      fatal_error(fmt::format("Unrecognized estimator '{}' for stochastic "
+        "volume calculation.", estimator));
+    }
+  }
+
   if (check_for_node(node, "threshold")) {
     pugi::xml_node threshold_node = node.child("threshold");
 
@@ -96,10 +248,39 @@ VolumeCalculation::VolumeCalculation(pugi::xml_node node)
 
 std::vector<VolumeCalculation::Result> VolumeCalculation::execute() const
 {
-  // Shared data that is collected from all threads
   int n = domain_ids_.size();
-  std::vector<std::vector<int>> master_indices(n); // List of material indices for each domain
-  std::vector<std::vector<int>> master_hits(n); // Number of hits for each material in each domain
+  int n_materials = model::materials.size();
+
+  // Map the index of each cell, material or universe to the domain it is, so
+  // that the domains of a sample are found without searching
+  std::vector<int> domain_index;
+  switch (domain_type_) {
+  case TallyDomain::MATERIAL:
+    domain_index.assign(model::materials.size(), C_NONE);
+    for (int i_domain = 0; i_domain < n; ++i_domain) {
+      auto it = model::material_map.find(domain_ids_[i_domain]);
+      if (it != model::material_map.end()) domain_index[it->second] = i_domain;
+    }
+    break;
+  case TallyDomain::CELL:
+    domain_index.assign(model::cells.size(), C_NONE);
+    for (int i_domain = 0; i_domain < n; ++i_domain) {
+      auto it = model::cell_map.find(domain_ids_[i_domain]);
+      if (it != model::cell_map.end()) domain_index[it->second] = i_domain;
+    }
+    break;
+  case TallyDomain::UNIVERSE:
+    domain_index.assign(model::universes.size(), C_NONE);
+    for (int i_domain = 0; i_domain < n; ++i_domain) {
+      auto it = model::universe_map.find(domain_ids_[i_domain]);
+      if (it != model::universe_map.end()) domain_index[it->second] = i_domain;
+    }
+    break;
+  }
+
+  // Number of hits of each material in each domain over all iterations, only
+  // accumulated on the master process
+  HitMap total_hits;
   int iterations = 0;
 
   // Divide work over MPI processes
@@ -114,95 +295,154 @@ std::vector<VolumeCalculation::Result> VolumeCalculation::execute() const
     i_end = i_start + min_samples;
   }
 
+#ifdef _OPENMP
+  int n_threads = omp_get_max_threads();
+#else
+  int n_threads = 1;
+#endif
+  std::vector<HitMap> thread_hits(n_threads);
+
   while (true) {
 
     #pragma omp parallel
     {
-      // Variables that are private to each thread
-      std::vector<std::vector<int>> indices(n);
-      std::vector<std::vector<int>> hits(n);
+#ifdef _OPENMP
+      int thread = omp_get_thread_num();
+      int n_team = omp_get_num_threads();
+#else
+      int thread = 0;
+      int n_team = 1;
+#endif
+      // Hits counted by this thread
+      auto& hits {thread_hits[thread]};
+      hits.clear();
       Particle p;
+      std::vector<int64_t> keys;
+      std::unordered_map<int64_t, double> lengths;
 
-      // Sample locations and count hits
+      // Sample locations or rays and count hits
       #pragma omp for
       for (size_t i = i_start; i < i_end; i++) {
         int64_t id = iterations * n_samples_ + i;
         uint64_t seed = init_seed(id, STREAM_VOLUME);
 
-        p.n_coord_ = 1;
-        Position xi {prn(&seed), prn(&seed), prn(&seed)};
-        p.r() = lower_left_ + xi*(upper_right_ - lower_left_);
-        p.u() = {0.5, 0.5, 0.5};
-
-        // If this location is not in the geometry at all, move on to next block
-        if (!find_cell(p, false)) continue;
-
-        if (domain_type_ == TallyDomain::MATERIAL) {
-          if (p.material_ != MATERIAL_VOID) {
-            for (int i_domain = 0; i_domain < n; i_domain++) {
-              if (model::materials[p.material_]->id_ == domain_ids_[i_domain]) {
-                this->check_hit(p.material_, indices[i_domain], hits[i_domain]);
-                break;
-              }
-            }
-          }
-        } else if (domain_type_ == TallyDomain::CELL) {
-          for (int level = 0; level < p.n_coord_; ++level) {
-            for (int i_domain=0; i_domain < n; i_domain++) {
-              if (model::cells[p.coord_[level].cell]->id_ == domain_ids_[i_domain]) {
-                this->check_hit(p.material_, indices[i_domain], hits[i_domain]);
-                break;
-              }
-            }
+        if (estimator_ == Estimator::POINT) {
+          p.n_coord_ = 1;
+          Position xi {prn(&seed), prn(&seed), prn(&seed)};
+          p.r() = lower_left_ + xi*(upper_right_ - lower_left_);
+          p.u() = {0.5, 0.5, 0.5};
+
+          // If this location is not in the geometry at all, move on to next
+          // block
+          if (!find_cell(p, false)) continue;
+
+          find_keys(p, domain_type_, domain_index, n_materials, keys);
+          for (auto key : keys) {
+            auto& hit {hits[key]};
+            hit.sum += 1.0;
+            hit.sum_sq += 1.0;
           }
-        } else if (domain_type_ == TallyDomain::UNIVERSE) {
-          for (int level = 0; level < p.n_coord_; ++level) {
-            for (int i_domain = 0; i_domain < n; ++i_domain) {
-              if (model::universes[p.coord_[level].universe]->id_ == domain_ids_[i_domain]) {
-                check_hit(p.material_, indices[i_domain], hits[i_domain]);
-                break;
-              }
-            }
+        } else {
+          // Fire a ray across the bounding box, parallel to an axis picked at
+          // random from a point sampled uniformly on the face it is normal
+          // to. The fraction of the ray in a domain is then an unbiased
+          // estimate of the fraction of the box's volume it fills.
+          int axis = std::min(static_cast<int>(3.0*prn(&seed)), 2);
+          Position xi {prn(&seed), prn(&seed), prn(&seed)};
+          xi[axis] = 0.0;
+          p.r() = lower_left_ + xi*(upper_right_ - lower_left_);
+          p.r()[axis] += TINY_BIT;
+          Direction u {0.0, 0.0, 0.0};
+          u[axis] = 1.0;
+          p.u() = u;
+          double length = upper_right_[axis] - lower_left_[axis] - TINY_BIT;
+
+          lengths.clear();
+          trace_ray(p, length, domain_type_, domain_index, n_materials, keys,
+            lengths);
+          for (const auto& kv : lengths) {
+            double f = kv.second / length;
+            auto& hit {hits[kv.first]};
+            hit.sum += f;
+            hit.sum_sq += f*f;
           }
         }
       }
 
-      // At this point, each thread has its own pair of index/hits lists and we now
-      // need to reduce them. OpenMP is not nearly smart enough to do this on its own,
-      // so we have to manually reduce them
-
-  #ifdef _OPENMP
-      int n_threads = omp_get_num_threads();
-  #else
-      int n_threads = 1;
-  #endif
-
-      #pragma omp for ordered schedule(static)
-      for (int i = 0; i < n_threads; ++i) {
-        #pragma omp ordered
-        for (int i_domain = 0; i_domain < n; ++i_domain) {
-          for (int j = 0; j < indices[i_domain].size(); ++j) {
-            // Check if this material has been added to the master list and if so,
-            // accumulate the number of hits
-            bool already_added = false;
-            for (int k = 0; k < master_indices[i_domain].size(); k++) {
-              if (indices[i_domain][j] == master_indices[i_domain][k]) {
-                master_hits[i_domain][k] += hits[i_domain][j];
-                already_added = true;
-              }
-            }
-            if (!already_added) {
-              // If we made it here, the material hasn't yet been added to the master
-              // list, so add entries to the master indices and master hits lists
-              master_indices[i_domain].push_back(indices[i_domain][j]);
-              master_hits[i_domain].push_back(hits[i_domain][j]);
-            }
+      // Reduce the hits of all threads pairwise onto the first thread, in
+      // log2(n_threads) rounds
+      for (int stride = 1; stride < n_team; stride *= 2) {
+        #pragma omp barrier
+        if (thread % (2*stride) == 0 && thread + stride < n_team) {
+          for (const auto& kv : thread_hits[thread + stride]) {
+            auto& hit {hits[kv.first]};
+            hit.sum += kv.second.sum;
+            hit.sum_sq += kv.second.sum_sq;
           }
         }
       }
     } // omp parallel
 
-    // Reduce hits onto master process
+    // Reduce the hits of this iteration onto the master process
+    auto& hits {thread_hits[0]};
+#ifdef OPENMC_MPI
+    if (mpi::master) {
+      for (int j = 1; j < mpi::n_procs; j++) {
+        int64_t q;
+        MPI_Recv(&q, 1, MPI_INT64_T, j, 0, mpi::intracomm, MPI_STATUS_IGNORE);
+        std::vector<int64_t> key_buffer(q);
+        std::vector<double> sum_buffer(2*q);
+        MPI_Recv(key_buffer.data(), q, MPI_INT64_T, j, 1, mpi::intracomm,
+          MPI_STATUS_IGNORE);
+        MPI_Recv(sum_buffer.data(), 2*q, MPI_DOUBLE, j, 2, mpi::intracomm,
+          MPI_STATUS_IGNORE);
+        for (int64_t k = 0; k < q; ++k) {
+          auto& hit {hits[key_buffer[k]]};
+          hit.sum += sum_buffer[2*k];
+          hit.sum_sq += sum_buffer[2*k + 1];
+        }
+      }
+    } else {
+      int64_t q = hits.size();
+      std::vector<int64_t> key_buffer;
+      std::vector<double> sum_buffer;
+      key_buffer.reserve(q);
+      sum_buffer.reserve(2*q);
+      for (const auto& kv : hits) {
+        key_buffer.push_back(kv.first);
+        sum_buffer.push_back(kv.second.sum);
+        sum_buffer.push_back(kv.second.sum_sq);
+      }
+      MPI_Send(&q, 1, MPI_INT64_T, 0, 0, mpi::intracomm);
+      MPI_Send(key_buffer.data(), q, MPI_INT64_T, 0, 1, mpi::intracomm);
+      MPI_Send(sum_buffer.data(), 2*q, MPI_DOUBLE, 0, 2, mpi::intracomm);
+    }
+#endif
+    for (const auto& kv : hits) {
+      auto& hit {total_hits[kv.first]};
+      hit.sum += kv.second.sum;
+      hit.sum_sq += kv.second.sum_sq;
+    }
+
+    // Gather the materials hit in each domain, ordered by material index so
+    // that the results do not depend on the order of the hash map
+    std::vector<std::vector<std::pair<int, HitSum>>> master_hits(n);
+    std::vector<HitSum> domain_hits(n);
+    if (mpi::master) {
+      for (const auto& kv : total_hits) {
+        int i_domain = kv.first / (n_materials + 2);
+        int i_material = kv.first % (n_materials + 2) - 1;
+        if (i_material == n_materials) {
+          domain_hits[i_domain] = kv.second;
+        } else {
+          master_hits[i_domain].emplace_back(i_material, kv.second);
+        }
+      }
+      for (auto& v : master_hits) {
+        std::sort(v.begin(), v.end(), [](const auto& a, const auto& b) {
+          return a.first < b.first; });
+      }
+    }
 
     // Determine volume of bounding box
     Position d {upper_right_ - lower_left_};
@@ -228,43 +468,13 @@ std::vector<VolumeCalculation::Result> VolumeCalculation::execute() const
       auto n_nuc = data::nuclides.size();
       xt::xtensor<double, 2> atoms({n_nuc, 2}, 0.0);
 
-#ifdef OPENMC_MPI
-      if (mpi::master) {
-        for (int j = 1; j < mpi::n_procs; j++) {
-          int q;
-          MPI_Recv(&q, 1, MPI_INTEGER, j, 0, mpi::intracomm, MPI_STATUS_IGNORE);
-          int buffer[2*q];
-          MPI_Recv(&buffer[0], 2*q, MPI_INTEGER, j, 1, mpi::intracomm, MPI_STATUS_IGNORE);
-          for (int k = 0; k < q; ++k) {
-            for (int m = 0; m < master_indices[i_domain].size(); ++m) {
-              if (buffer[2*k] == master_indices[i_domain][m]) {
-                master_hits[i_domain][m] += buffer[2*k + 1];
-                break;
-              }
-            }
-          }
-        }
-      } else {
-        int q = master_indices[i_domain].size();
-        int buffer[2*q];
-        for (int k = 0; k < q; ++k) {
-          buffer[2*k] = master_indices[i_domain][k];
-          buffer[2*k + 1] = master_hits[i_domain][k];
-        }
-
-        MPI_Send(&q, 1, MPI_INTEGER, 0, 0, mpi::intracomm);
-        MPI_Send(&buffer[0], 2*q, MPI_INTEGER, 0, 1, mpi::intracomm);
-      }
-#endif
 
       if (mpi::master) {
-        int total_hits = 0;
-        for (int j = 0; j < master_indices[i_domain].size(); ++j) {
-          total_hits += master_hits[i_domain][j];
-          double f = static_cast<double>(master_hits[i_domain][j]) / total_samples;
-          double var_f = f*(1.0 - f) / total_samples;
+        for (const auto& hit : master_hits[i_domain]) {
+          double f = hit.second.sum / total_samples;
+          double var_f = variance_of_mean(hit.second, total_samples);
 
-          int i_material = master_indices[i_domain][j];
+          int i_material = hit.first;
           if (i_material == MATERIAL_VOID) continue;
 
           const auto& mat = model::materials[i_material];
@@ -277,9 +487,10 @@ std::vector<VolumeCalculation::Result> VolumeCalculation::execute() const
         }
 
         // Determine volume
-        result.volume[0] = static_cast<double>(total_hits) / total_samples * volume_sample;
-        result.volume[1] = std::sqrt(result.volume[0]
-          * (volume_sample - result.volume[0]) / total_samples);
+        const auto& hit {domain_hits[i_domain]};
+        result.volume[0] = hit.sum / total_samples * volume_sample;
+        result.volume[1] = volume_sample *
+          std::sqrt(variance_of_mean(hit, total_samples));
         result.iterations = iterations;
 
         // update threshold value if needed
@@ -329,14 +540,6 @@ std::vector<VolumeCalculation::Result> VolumeCalculation::execute() const
     // return results of the calculation
     if (trigger_val < threshold_) { return results; }
 
-#ifdef OPENMC_MPI
-    // if iterating in an MPI run, need to zero indices and hits so they aren't counted twice
-    if (!mpi::master) {
-      for (auto& v : master_indices) { std::fill(v.begin(), v.end(), 0); }
-      for (auto& v : master_hits) { std::fill(v.begin(), v.end(), 0); }
-    }
-#endif
-
   } // end while
 }
 
@@ -359,6 +562,8 @@ void VolumeCalculation::to_hdf5(const std::string& filename,
 
   // Write basic metadata
   write_attribute(file_id, "samples", n_samples_);
+  write_attribute(file_id, "estimator",
+    estimator_ == Estimator::RAY ? "ray" : "point");
   write_attribute(file_id, "lower_left", lower_left_);
   write_attribute(file_id, "upper_right", upper_right_);
   // Write trigger info
@@ -425,27 +630,6 @@ void VolumeCalculation::to_hdf5(const std::string& filename,
   file_close(file_id);
 }
 
-void VolumeCalculation::check_hit(int i_material, std::vector<int>& indices,
-  std::vector<int>& hits) const
-{
-
-  // Check if this material was previously hit and if so, increment count
-  bool already_hit = false;
-  for (int j = 0; j < indices.size(); j++) {
-    if (indices[j] == i_material) {
-      hits[j]++;
-      already_hit = true;
-    }
-  }
-
-  // If the material was not previously hit, append an entry to the material
-  // indices and hits lists
-  if (!already_hit) {
-    indices.push_back(i_material);
-    hits.push_back(1);
-  }
-}
-
 void free_memory_volume()
 {
   openmc::model::volume_calcs.clear();
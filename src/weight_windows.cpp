@@ -0,0 +1,187 @@
+#include "openmc/weight_windows.h"
+
+#include <algorithm> // for is_sorted, min
+#include <cmath>     // for ceil
+#include <stdexcept> // for invalid_argument
+
+#include <fmt/core.h>
+#include "xtensor/xadapt.hpp"
+
+#include "openmc/constants.h"
+#include "openmc/error.h"
+#include "openmc/mesh.h"
+#include "openmc/random_lcg.h"
+#include "openmc/search.h"
+#include "openmc/settings.h"
+#include "openmc/xml_interface.h"
+
+namespace openmc {
+
+//==============================================================================
+// Global variables
+//==============================================================================
+
+namespace variance_reduction {
+
+std::vector<WeightWindows> weight_windows;
+
+} // namespace variance_reduction
+
+//==============================================================================
+// WeightWindows implementation
+//==============================================================================
+
+WeightWindows::WeightWindows(pugi::xml_node node)
+{
+  if (check_for_node(node, "id")) {
+    id_ = std::stoi(get_node_value(node, "id"));
+  } else {
+    fatal_error("Must specify id of weight windows in settings XML file.");
+  }
+
+  particle_ = Particle::Type::neutron;
+  if (check_for_node(node, "particle_type")) {
+    try {
+      particle_ = str_to_particle_type(
+        get_node_value(node, "particle_type", true, true));
+    } catch (const std::invalid_argument& e) {
+      fatal_error(fmt::format("{} in weight windows {}.", e.what(), id_));
+    }
+  }
+
+  // Spatial mesh
+  if (!check_for_node(node, "mesh")) {
+    fatal_error(fmt::format("No mesh specified for weight windows {}.", id_));
+  }
+  int mesh_id = std::stoi(get_node_value(node, "mesh"));
+  auto it = model::mesh_map.find(mesh_id);
+  if (it == model::mesh_map.end()) {
+    fatal_error(fmt::format("Mesh {} specified for weight windows {} does "
+      "not exist.", mesh_id, id_));
+  }
+  mesh_ = it->second;
+
+  // Energy groups, a single group covering all energies by default
+  if (check_for_node(node, "energy_bounds")) {
+    energy_bounds_ = get_node_array<double>(node, "energy_bounds");
+  } else {
+    energy_bounds_ = {0.0, INFTY};
+  }
+  if (energy_bounds_.size() < 2 ||
+      !std::is_sorted(energy_bounds_.begin(), energy_bounds_.end())) {
+    fatal_error(fmt::format("Energy bounds of weight windows {} must be "
+      "given in increasing order.", id_));
+  }
+
+  // Lower weight bounds, indexed by mesh bin then energy group
+  size_t n_bins = model::meshes[mesh_]->n_bins();
+  size_t n_groups = energy_bounds_.size() - 1;
+  auto lower = get_node_array<double>(node, "lower_ww_bounds");
+  if (lower.size() != n_bins*n_groups) {
+    fatal_error(fmt::format("Weight windows {} have {} lower bounds whereas "
+      "their mesh and energy groups have {} bins.", id_, lower.size(),
+      n_bins*n_groups));
+  }
+  lower_ww_ = xt::adapt(lower, {n_bins, n_groups});
+
+  if (check_for_node(node, "upper_bound_ratio")) {
+    upper_ratio_ = std::stod(get_node_value(node, "upper_bound_ratio"));
+  }
+  if (check_for_node(node, "survival_ratio")) {
+    survival_ratio_ = std::stod(get_node_value(node, "survival_ratio"));
+  }
+  if (upper_ratio_ <= 1.0 || survival_ratio_ < 1.0 ||
+      survival_ratio_ > upper_ratio_) {
+    fatal_error(fmt::format("The survival weight of weight windows {} must "
+      "lie between their lower and upper bounds.", id_));
+  }
+  if (check_for_node(node, "max_split")) {
+    max_split_ = std::stoi(get_node_value(node, "max_split"));
+    if (max_split_ < 1) {
+      fatal_error(fmt::format("Maximum number of splits of weight windows {} "
+        "must be positive.", id_));
+    }
+  }
+  if (check_for_node(node, "weight_cutoff")) {
+    weight_cutoff_ = std::stod(get_node_value(node, "weight_cutoff"));
+  }
+}
+
+void WeightWindows::apply(Particle& p) const
+{
+  // Find the window containing the particle
+  int bin = model::meshes[mesh_]->get_bin(p.r());
+  if (bin < 0) return;
+  if (p.E_ < energy_bounds_.front() || p.E_ >= energy_bounds_.back()) return;
+  int g = lower_bound_index(energy_bounds_.begin(), energy_bounds_.end(),
+    p.E_);
+  double lower = lower_ww_(bin, g);
+  if (lower <= 0.0) return;
+
+  double upper = upper_ratio_*lower;
+  if (p.wgt_ > upper) {
+    // Split the particle into copies that are within the window if possible.
+    // The particle goes on as one of them and the others are banked.
+    int n = std::min(static_cast<int>(std::ceil(p.wgt_ / upper)), max_split_);
+    p.wgt_ /= n;
+    for (int i = 1; i < n; ++i) {
+      Particle::Bank site;
+      site.r = p.r();
+      site.u = p.u();
+      site.E = settings::run_CE ? p.E_ : p.g_;
+      site.wgt = p.wgt_;
+      site.time = p.time_;
+      site.delayed_group = 0;
+      site.particle = p.type_;
+      site.parent_id = p.id_;
+      site.progeny_id = 0;
+      p.secondary_bank_.push_back(site);
+    }
+  } else if (p.wgt_ < lower) {
+    // Play Russian roulette, surviving with the survival weight
+    double survival = survival_ratio_*lower;
+    if (p.wgt_ > weight_cutoff_ && prn(p.current_seed()) < p.wgt_ / survival) {
+      p.wgt_ = survival;
+    } else {
+      p.wgt_ = 0.0;
+      p.alive_ = false;
+    }
+  }
+  p.wgt_last_ = p.wgt_;
+}
+
+//==============================================================================
+// Non-member functions
+//==============================================================================
+
+void read_weight_windows(pugi::xml_node root)
+{
+  auto& windows {variance_reduction::weight_windows};
+  for (auto node : root.children("weight_windows")) {
+    windows.emplace_back(node);
+    const auto& ww {windows.back()};
+    for (size_t i = 0; i < windows.size() - 1; ++i) {
+      if (windows[i].particle_ == ww.particle_) {
+        fatal_error(fmt::format("More than one set of weight windows was "
+          "given for {}s.", particle_type_to_str(ww.particle_)));
+      }
+    }
+  }
+}
+
+void apply_weight_windows(Particle& p)
+{
+  for (const auto& ww : variance_reduction::weight_windows) {
+    if (ww.particle_ == p.type_) {
+      ww.apply(p);
+      return;
+    }
+  }
+}
+
+void free_memory_weight_windows()
+{
+  variance_reduction::weight_windows.clear();
+}
+
+} // namespace openmc
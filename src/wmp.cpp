@@ -5,9 +5,11 @@
 #include "openmc/hdf5_interface.h"
 #include "openmc/math_functions.h"
 #include "openmc/nuclide.h"
+#include "openmc/settings.h"
 
 #include <fmt/core.h>
 
+#include <algorithm> // for min
 #include <cmath>
 
 namespace openmc {
@@ -54,6 +56,11 @@ WindowedMultipole::WindowedMultipole(hid_t group)
       "array shape in WMP library for " + name_ + ".");
   }
   fit_order_ = curvefit_.shape()[1] - 1;
+  if (fit_order_ + 1 > MAX_POLY_COEFFICIENTS) {
+    fatal_error(fmt::format("Curvefit polynomials of order {} in WMP library "
+      "for {} exceed the maximum order of {}.", fit_order_, name_,
+      MAX_POLY_COEFFICIENTS - 1));
+  }
 }
 
 std::tuple<double, double, double>
@@ -81,30 +88,7 @@ WindowedMultipole::evaluate(double E, double sqrtkT)
   // ==========================================================================
   // Add the contribution from the curvefit polynomial.
 
-  if (sqrtkT > 0.0 && broaden_poly_(i_window)) {
-    // Broaden the curvefit.
-    double dopp = sqrt_awr_ / sqrtkT;
-    std::vector<double> broadened_polynomials(fit_order_ + 1);
-    broaden_wmp_polynomials(E, dopp, fit_order_ + 1, broadened_polynomials.data());
-    for (int i_poly = 0; i_poly < fit_order_ + 1; ++i_poly) {
-      sig_s += curvefit_(i_window, i_poly, FIT_S) * broadened_polynomials[i_poly];
-      sig_a += curvefit_(i_window, i_poly, FIT_A) * broadened_polynomials[i_poly];
-      if (fissionable_) {
-        sig_f += curvefit_(i_window, i_poly, FIT_F) * broadened_polynomials[i_poly];
-      }
-    }
-  } else {
-    // Evaluate as if it were a polynomial
-    double temp = invE;
-    for (int i_poly = 0; i_poly < fit_order_ + 1; ++i_poly) {
-      sig_s += curvefit_(i_window, i_poly, FIT_S) * temp;
-      sig_a += curvefit_(i_window, i_poly, FIT_A) * temp;
-      if (fissionable_) {
-        sig_f += curvefit_(i_window, i_poly, FIT_F) * temp;
-      }
-      temp *= sqrtE;
-    }
-  }
+  add_curvefit(i_window, E, sqrtkT, sig_s, sig_a, sig_f);
 
   // ==========================================================================
   // Add the contribution from the poles in this window.
@@ -120,6 +104,30 @@ WindowedMultipole::evaluate(double E, double sqrtkT)
         sig_f += (data_(i_pole, MP_RF) * c_temp).real();
       }
     }
+  } else if (settings::vectorize_multipole) {
+    // At temperature, use Faddeeva function-based form with the function
+    // evaluated for a batch of poles at a time.
+    double dopp = sqrt_awr_ / sqrtkT;
+    double factor = dopp * invE * SQRT_PI;
+    for (int first = startw; first <= endw; first += FADDEEVA_BATCH) {
+      int n = std::min(FADDEEVA_BATCH, endw - first + 1);
+      double z_re[FADDEEVA_BATCH], z_im[FADDEEVA_BATCH];
+      double w_re[FADDEEVA_BATCH], w_im[FADDEEVA_BATCH];
+      for (int i = 0; i < n; ++i) {
+        std::complex<double> z = (sqrtE - data_(first + i, MP_EA)) * dopp;
+        z_re[i] = z.real();
+        z_im[i] = z.imag();
+      }
+      faddeeva_batch(n, z_re, z_im, w_re, w_im);
+      for (int i = 0; i < n; ++i) {
+        std::complex<double> w_val {w_re[i] * factor, w_im[i] * factor};
+        sig_s += (data_(first + i, MP_RS) * w_val).real();
+        sig_a += (data_(first + i, MP_RA) * w_val).real();
+        if (fissionable_) {
+          sig_f += (data_(first + i, MP_RF) * w_val).real();
+        }
+      }
+    }
   } else {
     // At temperature, use Faddeeva function-based form.
     double dopp = sqrt_awr_ / sqrtkT;
@@ -139,6 +147,57 @@ WindowedMultipole::evaluate(double E, double sqrtkT)
   return std::make_tuple(sig_s, sig_a, sig_f);
 }
 
+MultipoleXS WindowedMultipole::evaluate_with_deriv(double E, double sqrtkT)
+{
+  using namespace std::complex_literals;
+
+  if (sqrtkT == 0.0) {
+    fatal_error("Windowed multipole temperature derivatives are not implemented"
+      " for 0 Kelvin cross sections.");
+  }
+
+  // Define some frequently used variables.
+  double sqrtE = std::sqrt(E);
+  double invE = 1.0 / E;
+  double T = sqrtkT*sqrtkT / K_BOLTZMANN;
+  double dopp = sqrt_awr_ / sqrtkT;
+
+  // Locate window containing energy
+  int i_window = (sqrtE - std::sqrt(E_min_)) / spacing_;
+  int startw = windows_(i_window, 0) - 1;
+  int endw = windows_(i_window, 1) - 1;
+
+  // As in evaluate_deriv(), the derivative of the curvefit is neglected
+  MultipoleXS xs {};
+  add_curvefit(i_window, E, sqrtkT, xs.sig_s, xs.sig_a, xs.sig_f);
+
+  // The second derivative of the Faddeeva function in the derivative follows
+  // from its value: w' = -2zw + 2i/sqrt(pi) and w'' = -2zw' - 2w
+  for (int i_pole = startw; i_pole <= endw; ++i_pole) {
+    std::complex<double> z = (sqrtE - data_(i_pole, MP_EA)) * dopp;
+    std::complex<double> w = faddeeva(z);
+    std::complex<double> w1 = -2.0*z*w + 2.0i / SQRT_PI;
+    std::complex<double> w2 = -2.0*z*w1 - 2.0*w;
+
+    std::complex<double> w_val = w * dopp * invE * SQRT_PI;
+    std::complex<double> dw_val = -invE * SQRT_PI * 0.5 * w2;
+    xs.sig_s += (data_(i_pole, MP_RS) * w_val).real();
+    xs.sig_a += (data_(i_pole, MP_RA) * w_val).real();
+    xs.dsig_s += (data_(i_pole, MP_RS) * dw_val).real();
+    xs.dsig_a += (data_(i_pole, MP_RA) * dw_val).real();
+    if (fissionable_) {
+      xs.sig_f += (data_(i_pole, MP_RF) * w_val).real();
+      xs.dsig_f += (data_(i_pole, MP_RF) * dw_val).real();
+    }
+  }
+
+  double factor = -0.5*sqrt_awr_ / std::sqrt(K_BOLTZMANN) * std::pow(T, -1.5);
+  xs.dsig_s *= factor;
+  xs.dsig_a *= factor;
+  xs.dsig_f *= factor;
+  return xs;
+}
+
 std::tuple<double, double, double>
 WindowedMultipole::evaluate_deriv(double E, double sqrtkT)
 {
@@ -192,6 +251,36 @@ WindowedMultipole::evaluate_deriv(double E, double sqrtkT)
   return std::make_tuple(sig_s, sig_a, sig_f);
 }
 
+void WindowedMultipole::add_curvefit(int i_window, double E, double sqrtkT,
+  double& sig_s, double& sig_a, double& sig_f) const
+{
+  if (sqrtkT > 0.0 && broaden_poly_(i_window)) {
+    // Broaden the curvefit.
+    double dopp = sqrt_awr_ / sqrtkT;
+    double broadened_polynomials[MAX_POLY_COEFFICIENTS];
+    broaden_wmp_polynomials(E, dopp, fit_order_ + 1, broadened_polynomials);
+    for (int i_poly = 0; i_poly < fit_order_ + 1; ++i_poly) {
+      sig_s += curvefit_(i_window, i_poly, FIT_S) * broadened_polynomials[i_poly];
+      sig_a += curvefit_(i_window, i_poly, FIT_A) * broadened_polynomials[i_poly];
+      if (fissionable_) {
+        sig_f += curvefit_(i_window, i_poly, FIT_F) * broadened_polynomials[i_poly];
+      }
+    }
+  } else {
+    // Evaluate as if it were a polynomial
+    double sqrtE = std::sqrt(E);
+    double temp = 1.0 / E;
+    for (int i_poly = 0; i_poly < fit_order_ + 1; ++i_poly) {
+      sig_s += curvefit_(i_window, i_poly, FIT_S) * temp;
+      sig_a += curvefit_(i_window, i_poly, FIT_A) * temp;
+      if (fissionable_) {
+        sig_f += curvefit_(i_window, i_poly, FIT_F) * temp;
+      }
+      temp *= sqrtE;
+    }
+  }
+}
+
 //========================================================================
 // Non-member functions
 //========================================================================
@@ -0,0 +1,90 @@
+#include "openmc/work_stealing.h"
+
+#include <algorithm> // for lower_bound, max, min
+#include <mutex> // for lock_guard
+
+namespace openmc {
+
+constexpr int WorkStealingScheduler::CHUNKS_PER_THREAD;
+
+void WorkStealingScheduler::init(const std::vector<double>& cost, int n_threads)
+{
+  // Determine the cost of all work items preceding each item
+  int64_t n = cost.size();
+  cum_cost_.resize(n + 1);
+  cum_cost_[0] = 0.0;
+  for (int64_t i = 0; i < n; ++i) {
+    cum_cost_[i + 1] = cum_cost_[i] + cost[i];
+  }
+  double total = cum_cost_[n];
+
+  // Give each thread a contiguous range with an equal share of the total cost
+  ranges_ = std::vector<Range>(n_threads);
+  int64_t begin = 0;
+  for (int i = 0; i < n_threads; ++i) {
+    int64_t end = (i == n_threads - 1) ? n :
+      std::max(begin, index_at(total * (i + 1) / n_threads));
+    ranges_[i].begin = begin;
+    ranges_[i].end = end;
+    begin = end;
+  }
+
+  chunk_cost_ = total / (n_threads * CHUNKS_PER_THREAD);
+}
+
+bool WorkStealingScheduler::next(int thread, int64_t& begin, int64_t& end)
+{
+  Range& own = ranges_[thread];
+  while (true) {
+    {
+      std::lock_guard<OpenMPMutex> lock(own.mutex);
+      if (own.begin < own.end) {
+        // Take at least one item and otherwise enough items to reach the
+        // target chunk cost
+        begin = own.begin;
+        end = std::max(begin + 1, index_at(cum_cost_[begin] + chunk_cost_));
+        end = std::min(end, own.end);
+        own.begin = end;
+        return true;
+      }
+    }
+    if (!steal(thread)) return false;
+  }
+}
+
+bool WorkStealingScheduler::steal(int thread)
+{
+  int n_threads = ranges_.size();
+  for (int j = 1; j < n_threads; ++j) {
+    Range& victim = ranges_[(thread + j) % n_threads];
+
+    int64_t begin, end;
+    {
+      std::lock_guard<OpenMPMutex> lock(victim.mutex);
+      if (victim.begin >= victim.end) continue;
+
+      // Split the remaining range in half by cost, always taking at least one
+      // item
+      double c_mid = 0.5*(cum_cost_[victim.begin] + cum_cost_[victim.end]);
+      begin = std::min(std::max(index_at(c_mid), victim.begin), victim.end - 1);
+      end = victim.end;
+      victim.end = begin;
+    }
+
+    Range& own = ranges_[thread];
+    std::lock_guard<OpenMPMutex> lock(own.mutex);
+    own.begin = begin;
+    own.end = end;
+    return true;
+  }
+  return false;
+}
+
+int64_t WorkStealingScheduler::index_at(double c) const
+{
+  auto it = std::lower_bound(cum_cost_.begin(), cum_cost_.end(), c);
+  int64_t i = it - cum_cost_.begin();
+  return std::min(i, static_cast<int64_t>(cum_cost_.size()) - 1);
+}
+
+} // namespace openmc
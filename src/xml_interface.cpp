@@ -1,8 +1,13 @@
 #include "openmc/xml_interface.h"
 
+#include <algorithm> // for max
+#include <cstdint>   // for int64_t
+#include <fstream>
+
 #include <fmt/core.h>
 
 #include "openmc/error.h"
+#include "openmc/message_passing.h"
 #include "openmc/string_utils.h"
 
 namespace openmc {
@@ -49,4 +54,40 @@ get_node_value_bool(pugi::xml_node node, const char* name)
   return false;
 }
 
+pugi::xml_parse_result
+load_xml_file(pugi::xml_document& doc, const std::string& filename)
+{
+#ifdef OPENMC_MPI
+  if (mpi::n_procs > 1) {
+    // Read the whole file on the master process. A negative size tells the
+    // other processes that it couldn't be opened.
+    std::ifstream file;
+    int64_t size = -1;
+    if (mpi::master) {
+      file.open(filename, std::ios::binary | std::ios::ate);
+      if (file) size = file.tellg();
+    }
+    MPI_Bcast(&size, 1, MPI_INT64_T, 0, mpi::intracomm);
+    if (size < 0) {
+      pugi::xml_parse_result result;
+      result.status = pugi::status_file_not_found;
+      return result;
+    }
+
+    // The buffer is handed over to the document, so it is allocated with the
+    // pugixml allocator
+    auto* buffer = static_cast<char*>(
+      pugi::get_memory_allocation_function()(std::max<int64_t>(size, 1)));
+    if (mpi::master) {
+      file.seekg(0);
+      file.read(buffer, size);
+    }
+
+    mpi::broadcast_bytes(buffer, size);
+    return doc.load_buffer_inplace_own(buffer, size);
+  }
+#endif
+  return doc.load_file(filename.c_str());
+}
+
 } // namespace openmc
@@ -118,6 +118,8 @@ XsData::from_hdf5(hid_t xsdata_grp, bool fissionable, AngleDistributionType scat
 
   // Fix if total is 0, since it is in the denominator when tallying
   xt::filtration(total, xt::equal(total, 0.)) = 1.e-10;
+
+  pack_tracking();
 }
 
 //==============================================================================
@@ -546,6 +548,16 @@ XsData::combine(const std::vector<XsData*>& those_xs,
     // Now combine these guys
     scatter[a]->combine(those_scatts, scalars);
   }
+
+  pack_tracking();
+}
+
+//==============================================================================
+
+void
+XsData::share_scatter(ScattDataPool& pool)
+{
+  for (auto& scatt : scatter) pool.share(scatt);
 }
 
 //==============================================================================
@@ -556,4 +568,20 @@ XsData::equiv(const XsData& that)
   return (absorption.shape() == that.absorption.shape());
 }
 
+//==============================================================================
+
+void
+XsData::pack_tracking()
+{
+  size_t n_ang = total.shape()[0];
+  bool fissionable = nu_fission.size() > 0;
+  tracking.resize(n_ang * n_g_);
+  for (size_t a = 0; a < n_ang; a++) {
+    for (size_t gin = 0; gin < n_g_; gin++) {
+      tracking[a * n_g_ + gin] = {total(a, gin), absorption(a, gin),
+        fissionable ? nu_fission(a, gin) : 0.};
+    }
+  }
+}
+
 } //namespace openmc
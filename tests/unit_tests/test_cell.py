@@ -284,11 +284,13 @@ def test_to_xml_element(cell_with_lattice):
     cells, mats, univ, lattice = cell_with_lattice
 
     c = cells[-1]
+    c.delta_tracking = True
     root = ET.Element('geometry')
     elem = c.create_xml_subelement(root)
     assert elem.tag == 'cell'
     assert elem.get('id') == str(c.id)
     assert elem.get('region') is None
+    assert elem.get('delta_tracking') == 'true'
     surf_elem = root.find('surface')
     assert surf_elem.get('id') == str(cells[0].region.surface.id)
 
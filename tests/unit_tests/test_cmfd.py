@@ -0,0 +1,38 @@
+import numpy as np
+import openmc
+import openmc.examples
+
+
+def run_eigenvalue(model):
+    sp_name = model.run()
+    with openmc.StatePoint(sp_name) as sp:
+        return sp.k_generation.copy(), sp.k_combined
+
+
+def test_feedback(run_in_tmpdir):
+    model = openmc.examples.pwr_assembly()
+    model.settings.particles = 1000
+    model.settings.batches = 12
+    model.settings.inactive = 6
+    k_gen, k = run_eigenvalue(model)
+
+    # The assembly is infinite in z, so the CMFD mesh only needs to be
+    # refined in the radial directions
+    mesh = openmc.RegularMesh()
+    mesh.dimension = [3, 3, 1]
+    mesh.lower_left = [-10.71, -10.71, -1.0e6]
+    mesh.upper_right = [10.71, 10.71, 1.0e6]
+    begin = 3
+    model.settings.cmfd = {'mesh': mesh, 'energy_groups': [0.0, 0.625, 20.0e6],
+                           'begin': begin}
+    k_gen_cmfd, k_cmfd = run_eigenvalue(model)
+
+    # The source is unchanged until the end of the first batch with feedback,
+    # after which the weights of the source sites are adjusted
+    assert np.array_equal(k_gen_cmfd[:begin], k_gen[:begin])
+    assert not np.array_equal(k_gen_cmfd[begin:], k_gen[begin:])
+
+    # Feedback is limited to inactive batches, so the active batches still
+    # give an unbiased estimate of the eigenvalue
+    diff = k_cmfd - k
+    assert abs(diff.nominal_value) < 4*diff.std_dev
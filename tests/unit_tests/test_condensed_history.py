@@ -0,0 +1,62 @@
+import numpy as np
+import openmc
+import pytest
+
+
+def electron_model():
+    openmc.reset_auto_ids()
+    water = openmc.Material()
+    water.set_density('g/cm3', 1.0)
+    water.add_element('H', 2.0)
+    water.add_element('O', 1.0)
+
+    # The CSDA range of a 1 MeV electron in water is about 0.44 cm, while the
+    # outer sphere is large enough to absorb nearly all bremsstrahlung photons
+    radii = [0.1, 0.6, 200.0]
+    spheres = [openmc.Sphere(r=r) for r in radii]
+    spheres[-1].boundary_type = 'vacuum'
+    cells = [openmc.Cell(fill=water, region=-spheres[0])]
+    for inner, outer in zip(spheres[:-1], spheres[1:]):
+        cells.append(openmc.Cell(fill=water, region=+inner & -outer))
+
+    model = openmc.model.Model()
+    model.materials = openmc.Materials([water])
+    model.geometry = openmc.Geometry(cells)
+    model.settings.run_mode = 'fixed source'
+    model.settings.particles = 1000
+    model.settings.batches = 2
+    model.settings.photon_transport = True
+    model.settings.source = openmc.Source(
+        space=openmc.stats.Point(), angle=openmc.stats.Isotropic(),
+        energy=openmc.stats.Discrete([1.0e6], [1.0]), particle='electron')
+
+    tally = openmc.Tally()
+    tally.filters = [openmc.CellFilter(cells)]
+    tally.scores = ['heating']
+    model.tallies = [tally]
+    return model
+
+
+def run_heating(model, treatment):
+    model.settings.electron_treatment = treatment
+    sp_name = model.run()
+    with openmc.StatePoint(sp_name) as sp:
+        return sp.tallies[model.tallies[0].id].mean.ravel()
+
+
+def test_energy_deposition(run_in_tmpdir):
+    model = electron_model()
+    heating_ttb = run_heating(model, 'ttb')
+    heating_ch = run_heating(model, 'ch')
+
+    # Both treatments deposit the energy of the source electrons, apart from
+    # the few bremsstrahlung photons that escape
+    assert heating_ttb.sum() == pytest.approx(1.0e6, rel=0.01)
+    assert heating_ch.sum() == pytest.approx(1.0e6, rel=0.01)
+
+    # The thick-target approximation deposits the electron energy at the
+    # source, while condensed history spreads it along the electron path
+    # within the CSDA range
+    assert heating_ttb[0] > 0.95*heating_ttb.sum()
+    assert heating_ch[1] > 0.5*heating_ch.sum()
+    assert heating_ch[2] < 0.05*heating_ch.sum()
@@ -0,0 +1,72 @@
+import numpy as np
+import openmc
+import pytest
+
+
+def sphere_model(material, radius):
+    openmc.reset_auto_ids()
+    sphere = openmc.Sphere(r=radius, boundary_type='vacuum')
+    cell = openmc.Cell(fill=material, region=-sphere)
+
+    model = openmc.model.Model()
+    model.materials = openmc.Materials([material])
+    model.geometry = openmc.Geometry([cell])
+    model.settings.run_mode = 'fixed source'
+    model.settings.particles = 1000
+    model.settings.batches = 5
+    model.settings.source = openmc.Source(
+        space=openmc.stats.Point(), angle=openmc.stats.Isotropic(),
+        energy=openmc.stats.Discrete([2.0e6], [1.0]))
+    return model
+
+
+def run_tally(model):
+    sp_name = model.run()
+    with openmc.StatePoint(sp_name) as sp:
+        tally = sp.tallies[model.tallies[0].id]
+        return tally.mean.ravel(), tally.std_dev.ravel()
+
+
+def test_time_cutoff(run_in_tmpdir):
+    water = openmc.Material()
+    water.add_nuclide('H1', 2.0)
+    water.add_nuclide('O16', 1.0)
+    water.set_density('g/cm3', 1.0)
+    model = sphere_model(water, 50.0)
+
+    # Neutrons take microseconds to thermalize in water, so most of the flux
+    # of a history comes long after the cutoff
+    t_cut = 1.0e-8
+    tally = openmc.Tally()
+    tally.filters = [openmc.TimeFilter([0.0, t_cut, 1.0])]
+    tally.scores = ['flux', 'absorption']
+    model.tallies = [tally]
+    mean, _ = run_tally(model)
+    assert np.all(mean > 0.0)
+
+    # Particles are killed when they reach the cutoff, so nothing scores after
+    # it and the scores before it are unchanged
+    model.settings.cutoff = {'time_neutron': t_cut}
+    mean_cut, _ = run_tally(model)
+    mean, mean_cut = mean.reshape(2, 2), mean_cut.reshape(2, 2)
+    assert np.all(mean_cut[1] == 0.0)
+    assert mean_cut[0] == pytest.approx(mean[0], rel=1e-6)
+
+
+def test_comb(run_in_tmpdir):
+    uranium = openmc.Material()
+    uranium.add_nuclide('U235', 1.0)
+    uranium.set_density('g/cm3', 18.7)
+    # A subcritical sphere whose histories bank many fission neutrons
+    model = sphere_model(uranium, 6.0)
+    tally = openmc.Tally()
+    tally.scores = ['fission', 'absorption']
+    model.tallies = [tally]
+    mean, std_dev = run_tally(model)
+
+    # Combing the secondaries of a history down preserves their weight, so it
+    # changes the histories but not the expected results
+    model.settings.max_secondaries = 4
+    mean_comb, std_dev_comb = run_tally(model)
+    assert not np.array_equal(mean_comb, mean)
+    assert np.all(np.abs(mean_comb - mean) < 4.0*np.hypot(std_dev, std_dev_comb))
@@ -0,0 +1,173 @@
+import subprocess
+
+import numpy as np
+import openmc
+import pytest
+
+
+def pin_model():
+    """A pin cell next to a box of water, with the pin cell able to use delta
+    tracking"""
+    openmc.reset_auto_ids()
+    fuel = openmc.Material()
+    fuel.add_nuclide('U235', 0.05)
+    fuel.add_nuclide('U238', 0.95)
+    fuel.add_nuclide('O16', 2.0)
+    fuel.set_density('g/cm3', 10.0)
+    water = openmc.Material()
+    water.add_nuclide('H1', 2.0)
+    water.add_nuclide('O16', 1.0)
+    water.set_density('g/cm3', 1.0)
+
+    fuel_or = openmc.ZCylinder(r=0.4)
+    fuel_cell = openmc.Cell(fill=fuel, region=-fuel_or)
+    pin = openmc.Universe(cells=[fuel_cell,
+                                 openmc.Cell(fill=water, region=+fuel_or)])
+    box = openmc.model.rectangular_prism(2.52, 1.26, origin=(0.63, 0.0),
+                                         boundary_type='reflective')
+    middle = openmc.XPlane(0.63)
+    pin_cell = openmc.Cell(fill=pin, region=box & -middle)
+    water_cell = openmc.Cell(fill=water, region=box & +middle)
+
+    model = openmc.model.Model()
+    model.materials = openmc.Materials([fuel, water])
+    model.geometry = openmc.Geometry([pin_cell, water_cell])
+    model.settings.particles = 100
+    model.settings.batches = 2
+    model.settings.inactive = 0
+    model.settings.source = openmc.Source(space=openmc.stats.Point())
+    return model, pin_cell, fuel_or
+
+
+def assert_rejected(model, message):
+    with pytest.raises(subprocess.CalledProcessError) as excinfo:
+        model.run()
+    output = ' '.join(excinfo.value.output.split())
+    assert message in output
+
+
+@pytest.mark.parametrize('whole_geometry', [False, True])
+def test_reject_surface_tally(run_in_tmpdir, whole_geometry):
+    model, pin_cell, fuel_or = pin_model()
+    if whole_geometry:
+        model.settings.delta_tracking = True
+    else:
+        pin_cell.delta_tracking = True
+
+    # The surface of the fuel is within the delta-tracked region, so it is
+    # never crossed
+    tally = openmc.Tally()
+    tally.filters = [openmc.SurfaceFilter(fuel_or)]
+    tally.scores = ['current']
+    model.tallies = [tally]
+    assert_rejected(model, f'surface {fuel_or.id}, which is not crossed')
+
+    # Neither are the cells on either side of it
+    fuel_cell = next(iter(pin_cell.fill.cells.values()))
+    tally.filters = [openmc.CellFromFilter(fuel_cell)]
+    assert_rejected(model, f'cell {fuel_cell.id}, which are not found')
+
+
+def test_boundary_surface_tally(run_in_tmpdir):
+    model, _, _ = pin_model()
+    model.settings.delta_tracking = True
+
+    # Surfaces with a boundary condition are still crossed, so their tallies
+    # are accepted
+    xmin = next(s for s in model.geometry.get_all_surfaces().values()
+                if isinstance(s, openmc.XPlane) and
+                s.boundary_type == 'reflective')
+    tally = openmc.Tally()
+    tally.filters = [openmc.SurfaceFilter(xmin)]
+    tally.scores = ['current']
+    model.tallies = [tally]
+    sp_name = model.run()
+    with openmc.StatePoint(sp_name) as sp:
+        assert sp.tallies[tally.id].num_realizations == 2
+
+
+def test_tracklength_outside(run_in_tmpdir, capfd):
+    model, pin_cell, _ = pin_model()
+    pin_cell.delta_tracking = True
+    fuel_cell = next(iter(pin_cell.fill.cells.values()))
+    fuel, water = model.materials
+    water_cell = next(c for c in model.geometry.root_universe.cells.values()
+                      if c.fill is water)
+
+    # Only the tallies that can score within the pin cell need a collision
+    # estimator
+    tallies = {}
+    for name, domain_filter in [
+        ('pin', openmc.CellFilter(pin_cell)),
+        ('fuel cell', openmc.CellFilter(fuel_cell)),
+        ('fuel', openmc.MaterialFilter(fuel)),
+        ('water', openmc.MaterialFilter(water)),
+        ('water cell', openmc.CellFilter(water_cell))
+    ]:
+        tally = openmc.Tally(name=name)
+        tally.filters = [domain_filter]
+        tally.scores = ['flux']
+        tallies[name] = tally
+    tallies['water cell'].estimator = 'tracklength'
+    model.tallies = list(tallies.values())
+
+    sp_name = model.run()
+    out, err = capfd.readouterr()
+    output = ' '.join((out + err).split())
+    with openmc.StatePoint(sp_name) as sp:
+        for name, tally in tallies.items():
+            estimator = sp.tallies[tally.id].estimator
+            switched = f'Tally {tally.id} uses a collision estimator' in output
+            if name == 'water cell':
+                assert estimator == 'tracklength'
+                assert not switched
+            else:
+                assert estimator == 'collision'
+                assert switched
+
+
+def run_model(model):
+    sp_name = model.run()
+    with openmc.StatePoint(sp_name) as sp:
+        tally = sp.tallies[model.tallies[0].id]
+        return sp.keff, tally.mean.ravel(), tally.std_dev.ravel()
+
+
+def assert_consistent(x, sigma_x, y, sigma_y, n_sigma=4.0):
+    assert np.all(np.abs(x - y) <= n_sigma*np.hypot(sigma_x, sigma_y))
+
+
+@pytest.mark.parametrize('whole_geometry', [False, True])
+def test_same_expectations(run_in_tmpdir, capfd, whole_geometry):
+    # With S(a,b) data, the cross sections of the water peak within the bins
+    # of the majorant
+    model, pin_cell, _ = pin_model()
+    fuel, water = model.materials
+    water.add_s_alpha_beta('c_H_in_H2O')
+    model.settings.particles = 1000
+    model.settings.batches = 12
+    model.settings.inactive = 2
+    tally = openmc.Tally()
+    tally.filters = [
+        openmc.MaterialFilter([fuel, water]),
+        openmc.EnergyFilter([0.0, 0.1, 0.625, 1.0e3, 20.0e6])
+    ]
+    tally.scores = ['flux', 'total', 'absorption', 'fission']
+    model.tallies = [tally]
+    keff, mean, std_dev = run_model(model)
+    capfd.readouterr()
+
+    if whole_geometry:
+        model.settings.delta_tracking = True
+    else:
+        pin_cell.delta_tracking = True
+    keff_dt, mean_dt, std_dev_dt = run_model(model)
+
+    # The majorant bounds every cross section, including thermal scattering
+    out, err = capfd.readouterr()
+    assert 'majorant' not in out + err
+
+    # Delta tracking samples different histories with the same expectations
+    assert_consistent(keff_dt.n, keff_dt.s, keff.n, keff.s)
+    assert np.count_nonzero(mean) > 0
+    assert_consistent(mean_dt, std_dev_dt, mean, std_dev)
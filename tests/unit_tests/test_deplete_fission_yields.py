@@ -55,7 +55,7 @@ def proxy_tally_data(tally, fill=None):
     """Construct an empty matrix built from a C tally
 
     The shape of tally.results will be
-    ``(n_bins, n_nuc * n_scores, 3)``
+    ``(n_bins, n_nuc * n_scores, 2)``
     """
     n_nucs = max(len(tally.nuclides), 1)
     n_scores = max(len(tally.scores), 1)
@@ -67,7 +67,7 @@ def proxy_tally_data(tally, fill=None):
         if isinstance(tfilter, lib.EnergyFilter):
             this_bins -= 1
         n_bins *= max(this_bins, 1)
-    data = np.empty((n_bins, n_nucs * n_scores, 3))
+    data = np.empty((n_bins, n_nucs * n_scores, 2))
     if fill is not None:
         data.fill(fill)
     return data
@@ -199,12 +199,12 @@ def test_cutoff_helper(materials, nuclide_bundle, therm_frac):
     assert len(filters[1].bins) == 3
 
     # Emulate building tallies
-    # material x energy, tallied_nuclides, 3
+    # material x energy, tallied_nuclides, 2
     tally_data = proxy_tally_data(fission_tally)
     helper._fission_rate_tally = Mock()
     helper_flux = 1e6
-    tally_data[0, :, 1] = therm_frac * helper_flux
-    tally_data[1, :, 1] = (1 - therm_frac) * helper_flux
+    tally_data[0, :, 0] = therm_frac * helper_flux
+    tally_data[1, :, 0] = (1 - therm_frac) * helper_flux
     helper._fission_rate_tally.results = tally_data
 
     helper.unpack()
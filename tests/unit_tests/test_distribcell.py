@@ -0,0 +1,128 @@
+import numpy as np
+import pytest
+import openmc
+import openmc.lib
+
+from tests import cdtemp
+
+
+def build_nested_model():
+    """Assemblies whose moderator cell surrounds a lattice of fuel pins, so
+    that one distribcell target universe contains another"""
+    openmc.reset_auto_ids()
+    fuel = openmc.Material()
+    fuel.add_nuclide('U235', 1.0)
+    fuel.set_density('g/cm3', 10.0)
+    water = openmc.Material()
+    water.add_nuclide('H1', 2.0)
+    water.add_nuclide('O16', 1.0)
+    water.set_density('g/cm3', 1.0)
+
+    pin_or = openmc.ZCylinder(r=0.4)
+    fuel_cell = openmc.Cell(fill=fuel, region=-pin_or)
+    clad_cell = openmc.Cell(fill=water, region=+pin_or)
+    pin = openmc.Universe(cells=[fuel_cell, clad_cell])
+
+    pins = openmc.RectLattice()
+    pins.lower_left = (-1.26, -1.26)
+    pins.pitch = (1.26, 1.26)
+    pins.universes = [[pin, pin], [pin, pin]]
+
+    box = openmc.model.rectangular_prism(2.52, 2.52)
+    moderator = openmc.Cell(fill=water, region=~box)
+    assembly = openmc.Universe(cells=[openmc.Cell(fill=pins, region=box),
+                                      moderator])
+
+    core = openmc.RectLattice()
+    core.lower_left = (-4.0, -2.0)
+    core.pitch = (4.0, 4.0)
+    core.universes = [[assembly, assembly]]
+    root = openmc.Cell(fill=core, region=openmc.model.rectangular_prism(
+        8.0, 4.0, boundary_type='reflective'))
+
+    model = openmc.model.Model()
+    model.materials = openmc.Materials([fuel, water])
+    model.geometry = openmc.Geometry([root])
+    model.settings.particles = 100
+    model.settings.batches = 2
+    model.settings.verbosity = 1
+    return model, fuel_cell, clad_cell, moderator
+
+
+# Centers of the fuel pins of both assemblies
+PIN_CENTERS = [(x0 + dx, dy, 0.0) for x0 in (-2.0, 2.0)
+               for dx in (-0.63, 0.63) for dy in (-0.63, 0.63)]
+
+
+@pytest.fixture(scope='module')
+def nested_model():
+    model, fuel_cell, clad_cell, moderator = build_nested_model()
+    with cdtemp():
+        model.export_to_xml()
+        openmc.lib.init()
+        yield fuel_cell, clad_cell, moderator
+        openmc.lib.finalize()
+
+
+def test_nested_instances(nested_model):
+    fuel_cell, clad_cell, moderator = nested_model
+
+    # Every pin of every assembly is a distinct instance of the pin cells
+    fuel = [openmc.lib.find_cell(r) for r in PIN_CENTERS]
+    assert all(c.id == fuel_cell.id for c, _ in fuel)
+    assert sorted(i for _, i in fuel) == list(range(8))
+    clad = [openmc.lib.find_cell((x + 0.5, y, z)) for x, y, z in PIN_CENTERS]
+    assert all(c.id == clad_cell.id for c, _ in clad)
+    assert sorted(i for _, i in clad) == list(range(8))
+
+    # The moderator cell containing the pins has one instance per assembly
+    mod = [openmc.lib.find_cell((x0 + 1.6, 1.6, 0.0)) for x0 in (-2.0, 2.0)]
+    assert all(c.id == moderator.id for c, _ in mod)
+    assert sorted(i for _, i in mod) == [0, 1]
+
+
+def test_tally_results(nested_model, run_in_tmpdir):
+    # Instances of the fuel pins, from the geometry loaded by the fixture
+    instances = [openmc.lib.find_cell(r)[1] for r in PIN_CENTERS]
+
+    model, fuel_cell, _, moderator = build_nested_model()
+    model.settings.particles = 1000
+    model.settings.batches = 5
+    model.settings.inactive = 2
+    model.settings.source = openmc.Source(space=openmc.stats.Box(
+        (-4.0, -2.0, -1.0), (4.0, 2.0, 1.0), only_fissionable=True))
+
+    # Each fuel pin lies in its own element of a mesh, apart from the gap
+    # between the assemblies
+    mesh = openmc.RectilinearMesh()
+    mesh.x_grid = [-3.26, -2.0, -0.74, 0.74, 2.0, 3.26]
+    mesh.y_grid = [-1.26, 0.0, 1.26]
+    mesh.z_grid = [-1.0e6, 1.0e6]
+    mesh_tally = openmc.Tally()
+    mesh_tally.filters = [openmc.MeshFilter(mesh)]
+    mesh_tally.scores = ['fission']
+    fuel_tally = openmc.Tally()
+    fuel_tally.filters = [openmc.DistribcellFilter(fuel_cell)]
+    fuel_tally.scores = ['fission']
+    moderator_tally = openmc.Tally()
+    moderator_tally.filters = [openmc.DistribcellFilter(moderator)]
+    moderator_tally.scores = ['flux']
+    model.tallies = [mesh_tally, fuel_tally, moderator_tally]
+
+    sp_name = model.run()
+    with openmc.StatePoint(sp_name) as sp:
+        mesh_fission = sp.tallies[mesh_tally.id].mean.reshape(2, 5)
+        fuel_fission = sp.tallies[fuel_tally.id].mean.ravel()
+        moderator_flux = sp.tallies[moderator_tally.id].mean.ravel()
+    assert fuel_fission.size == 8
+    assert moderator_flux.size == 2
+    assert np.all(moderator_flux > 0.0)
+
+    # The fission rate of each distribcell instance is the one of the mesh
+    # element around the pin found at that instance
+    for (x, y, _), instance in zip(PIN_CENTERS, instances):
+        i = np.searchsorted(mesh.x_grid, x) - 1
+        j = np.searchsorted(mesh.y_grid, y) - 1
+        assert fuel_fission[instance] > 0.0
+        assert fuel_fission[instance] == pytest.approx(mesh_fission[j, i],
+                                                       rel=1e-10)
@@ -0,0 +1,32 @@
+import numpy as np
+import openmc
+import openmc.examples
+
+
+def run_tallies(model):
+    sp_name = model.run()
+    with openmc.StatePoint(sp_name) as sp:
+        return {t.id: t.mean.copy() for t in sp.tallies.values()}, sp.k_combined
+
+
+def test_hashed_matches_binary_search(run_in_tmpdir):
+    # Hashed searches only narrow the range of the binary search, so they find
+    # the same grid indices and give identical results
+    model = openmc.examples.pwr_pin_cell()
+    model.settings.particles = 1000
+    model.settings.batches = 5
+    model.settings.inactive = 0
+    tally = openmc.Tally()
+    tally.filters = [openmc.EnergyFilter(np.logspace(-5, 7, 50))]
+    tally.scores = ['total', 'fission', 'absorption']
+    tally.nuclides = ['U235', 'U238', 'H1']
+    model.tallies = [tally]
+
+    model.settings.energy_search = 'log-grid'
+    means_log, k_log = run_tallies(model)
+    model.settings.energy_search = 'hashed'
+    means_hashed, k_hashed = run_tallies(model)
+
+    assert k_hashed.nominal_value == k_log.nominal_value
+    for tally_id, mean in means_log.items():
+        assert np.array_equal(means_hashed[tally_id], mean)
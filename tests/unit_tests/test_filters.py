@@ -46,6 +46,21 @@ def test_cell_instance():
     assert instances.apply(lambda x: x in (0, 1, 2)).all()
 
 
+def test_time():
+    f = openmc.TimeFilter([0.0, 1.0e-6, 1.0e-3])
+    assert f.num_bins == 2
+    assert f.bins[1][0] == 1.0e-6
+
+    # to_xml_element()
+    elem = f.to_xml_element()
+    assert elem.tag == 'filter'
+    assert elem.attrib['type'] == 'time'
+
+    # get_pandas_dataframe()
+    df = f.get_pandas_dataframe(f.num_bins, 1)
+    assert 'time low [s]' in df.columns
+
+
 def test_legendre():
     n = 5
     f = openmc.LegendreFilter(n)
@@ -0,0 +1,102 @@
+import numpy as np
+import pytest
+import openmc
+import openmc.examples
+
+
+def run_tallies(model):
+    sp_name = model.run()
+    with openmc.StatePoint(sp_name) as sp:
+        return {t.id: t.mean.copy() for t in sp.tallies.values()}, sp.k_combined
+
+
+def assert_flat_geometry_parity(model):
+    # The flat geometry mirrors the surface, cell and lattice methods exactly,
+    # so both give the same particle histories
+    model.settings.flat_geometry = False
+    means, k = run_tallies(model)
+    model.settings.flat_geometry = True
+    means_flat, k_flat = run_tallies(model)
+
+    assert k_flat.nominal_value == k.nominal_value
+    for tally_id, mean in means.items():
+        assert np.array_equal(means_flat[tally_id], mean)
+
+
+def hex_model(orientation, axial):
+    openmc.reset_auto_ids()
+    fuel = openmc.Material()
+    fuel.add_nuclide('U235', 0.05)
+    fuel.add_nuclide('U238', 0.95)
+    fuel.add_nuclide('O16', 2.0)
+    fuel.set_density('g/cm3', 10.0)
+    water = openmc.Material()
+    water.add_nuclide('H1', 2.0)
+    water.add_nuclide('O16', 1.0)
+    water.set_density('g/cm3', 1.0)
+
+    pin_or = openmc.ZCylinder(r=0.4)
+    pin = openmc.Universe(cells=[openmc.Cell(fill=fuel, region=-pin_or),
+                                 openmc.Cell(fill=water, region=+pin_or)])
+    moderator = openmc.Universe(cells=[openmc.Cell(fill=water)])
+
+    lattice = openmc.HexLattice()
+    lattice.orientation = orientation
+    lattice.outer = moderator
+    rings = [[pin]*12, [moderator]*6, [pin]]
+    if axial:
+        lattice.center = (0.0, 0.0, 0.0)
+        lattice.pitch = (1.26, 10.0)
+        lattice.universes = [rings, [[moderator]*12, [pin]*6, [moderator]]]
+    else:
+        lattice.center = (0.0, 0.0)
+        lattice.pitch = (1.26,)
+        lattice.universes = rings
+
+    # The rotated fill exercises the transformation of positions into the
+    # coordinates of the hexagonal lattice
+    prism = openmc.model.hexagonal_prism(edge_length=4.0,
+                                         orientation=orientation)
+    inner = openmc.Cell(fill=lattice, region=prism)
+    inner.rotation = (0.0, 0.0, 30.0)
+    outer = openmc.Cell(fill=water, region=~prism)
+    box = openmc.model.rectangular_prism(10.0, 10.0,
+                                         boundary_type='reflective')
+    zmin = openmc.ZPlane(z0=-10.0, boundary_type='reflective')
+    zmax = openmc.ZPlane(z0=10.0, boundary_type='reflective')
+    root = openmc.Universe(cells=[inner, outer])
+    core = openmc.Cell(fill=root, region=box & +zmin & -zmax)
+
+    model = openmc.model.Model()
+    model.materials = openmc.Materials([fuel, water])
+    model.geometry = openmc.Geometry([core])
+    model.settings.particles = 1000
+    model.settings.batches = 5
+    model.settings.inactive = 0
+    model.settings.source = openmc.Source(space=openmc.stats.Box(
+        (-4.0, -4.0, -10.0), (4.0, 4.0, 10.0), only_fissionable=True))
+
+    tally = openmc.Tally()
+    tally.filters = [openmc.DistribcellFilter(pin.cells[1])]
+    tally.scores = ['flux', 'fission']
+    model.tallies = [tally]
+    return model
+
+
+def test_rect_lattice(run_in_tmpdir):
+    model = openmc.examples.pwr_assembly()
+    model.settings.particles = 1000
+    model.settings.batches = 5
+    model.settings.inactive = 0
+    tally = openmc.Tally()
+    fuel = next(iter(model.geometry.get_all_material_cells().values()))
+    tally.filters = [openmc.DistribcellFilter(fuel)]
+    tally.scores = ['flux', 'fission']
+    model.tallies = [tally]
+    assert_flat_geometry_parity(model)
+
+
+@pytest.mark.parametrize('orientation', ['y', 'x'])
+@pytest.mark.parametrize('axial', [False, True])
+def test_hex_lattice(run_in_tmpdir, orientation, axial):
+    assert_flat_geometry_parity(hex_model(orientation, axial))
@@ -0,0 +1,48 @@
+import subprocess
+
+import openmc
+import openmc.examples
+import pytest
+
+
+@pytest.fixture
+def model(run_in_tmpdir):
+    model = openmc.examples.pwr_assembly()
+    model.settings.particles = 1000
+    model.settings.batches = 5
+    model.settings.inactive = 2
+    tally = openmc.Tally()
+    fuel = next(iter(model.geometry.get_all_material_cells().values()))
+    tally.filters = [openmc.DistribcellFilter(fuel),
+                     openmc.EnergyFilter([0.0, 0.625, 20.0e6])]
+    tally.scores = ['flux', 'fission']
+    model.tallies = [tally]
+    return model
+
+
+def run_results(model):
+    sp_name = model.run(threads=2)
+    with openmc.StatePoint(sp_name) as sp:
+        return sp.k_generation.copy(), sp.tallies[model.tallies[0].id].mean
+
+
+@pytest.mark.parametrize('interleave', [2, 7])
+def test_same_histories(model, interleave):
+    k_gen, mean = run_results(model)
+
+    # Each history keeps its own random number stream while the histories of
+    # a thread are advanced in turn, so only the order in which scores are
+    # summed changes
+    model.settings.history_interleave = interleave
+    k_gen_interleaved, mean_interleaved = run_results(model)
+    assert k_gen_interleaved == pytest.approx(k_gen, rel=1e-10)
+    assert mean_interleaved == pytest.approx(mean, rel=1e-10)
+
+
+def test_reject_history_statistics(model):
+    model.tallies[0].history_statistics = True
+    model.settings.history_interleave = 4
+    with pytest.raises(subprocess.CalledProcessError) as excinfo:
+        model.run()
+    output = ' '.join(excinfo.value.output.split())
+    assert 'cannot use history statistics with interleaved histories' in output
@@ -0,0 +1,45 @@
+import numpy as np
+import openmc
+import openmc.examples
+import pytest
+
+
+def test_history_statistics(run_in_tmpdir):
+    model = openmc.examples.pwr_pin_cell()
+    model.settings.particles = 1000
+    model.settings.batches = 8
+    model.settings.inactive = 3
+
+    mesh = openmc.RegularMesh()
+    mesh.dimension = [4, 4, 1]
+    mesh.lower_left = [-0.63, -0.63, -1.0e6]
+    mesh.upper_right = [0.63, 0.63, 1.0e6]
+    filters = [openmc.MeshFilter(mesh),
+               openmc.EnergyFilter([0.0, 0.625, 20.0e6])]
+    batch_tally = openmc.Tally()
+    batch_tally.filters = filters
+    batch_tally.scores = ['flux', 'fission']
+    history_tally = openmc.Tally()
+    history_tally.filters = filters
+    history_tally.scores = ['flux', 'fission']
+    history_tally.history_statistics = True
+    model.tallies = [batch_tally, history_tally]
+
+    sp_name = model.run()
+    with openmc.StatePoint(sp_name) as sp:
+        batch = sp.tallies[batch_tally.id]
+        history = sp.tallies[history_tally.id]
+
+        # Each history of the active batches is a realization, and the means
+        # are the same as with batch statistics
+        assert batch.num_realizations == 5
+        assert history.num_realizations == 5*1000
+        assert history.mean == pytest.approx(batch.mean, rel=1e-10)
+
+        # Both estimate the same uncertainty of the mean, the batch estimate
+        # itself being uncertain with only five realizations. The corners of
+        # the mesh have no fuel and so no fission.
+        scored = batch.std_dev > 0.0
+        assert np.array_equal(history.std_dev > 0.0, scored)
+        ratio = history.std_dev[scored] / batch.std_dev[scored]
+        assert np.all((ratio > 0.3) & (ratio < 3.0))
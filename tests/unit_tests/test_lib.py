@@ -93,6 +93,24 @@ def test_cell_temperature(lib_init):
     assert cell.get_temperature() == 200.0
 
 
+def test_set_cell_temperatures(lib_init):
+    cell = openmc.lib.cells[1]
+    openmc.lib.set_cell_temperatures([cell], [300.0], [0])
+    assert cell.get_temperature(0) == 300.0
+    openmc.lib.set_cell_temperatures([cell], [400.0])
+    assert cell.get_temperature() == 400.0
+
+    # Temperatures that would be written by several threads at once are
+    # rejected before any of them is set
+    with pytest.raises(exc.InvalidArgumentError):
+        openmc.lib.set_cell_temperatures([cell, cell], [100.0, 200.0])
+    with pytest.raises(exc.InvalidArgumentError):
+        openmc.lib.set_cell_temperatures([cell, cell], [100.0, 200.0], [0, 0])
+    with pytest.raises(exc.InvalidArgumentError):
+        openmc.lib.set_cell_temperatures([cell, cell], [100.0, 200.0], [-1, 0])
+    assert cell.get_temperature() == 400.0
+
+
 def test_new_cell(lib_init):
     with pytest.raises(exc.AllocationError):
         openmc.lib.Cell(1)
@@ -274,6 +292,24 @@ def test_tally_results(lib_run):
     assert t2.mean.size == (n + 1) * (n + 2) // 2 * 3 # Number of Zernike coeffs * 3 cells
 
 
+def test_tally_statistics(lib_run):
+    # Statistics match those of openmc.Tally, including a zero standard
+    # deviation for bins with a zero mean
+    t = openmc.lib.tallies[1]
+    n = t.num_realizations
+    sum_ = t.results[:, :, 0]
+    sum_sq = t.results[:, :, 1]
+    mean = sum_ / n
+    nonzero = mean != 0.0
+    std_dev = np.zeros_like(mean)
+    std_dev[nonzero] = np.sqrt((sum_sq[nonzero]/n - mean[nonzero]**2)/(n - 1))
+
+    stats = t.statistics
+    assert np.allclose(stats[:, :, 0], mean)
+    assert np.allclose(stats[:, :, 1], std_dev)
+    assert np.all(stats[:, :, 1][~nonzero] == 0.0)
+
+
 def test_global_tallies(lib_run):
     assert openmc.lib.num_realizations() == 5
     gt = openmc.lib.global_tallies()
@@ -371,6 +407,29 @@ def test_find_cell(lib_init):
         openmc.lib.find_cell((100., 100., 100.))
 
 
+def test_find_cells(lib_init):
+    xyz = [(0., 0., 0.), (0.4, 0., 0.), (100., 100., 100.)]
+    cells, instances, materials, temperatures = openmc.lib.find_cells(xyz)
+    assert cells[0] == openmc.lib.cells[1]._index
+    assert cells[1] == openmc.lib.cells[2]._index
+    assert cells[2] == -1
+    assert materials[0] == openmc.lib.materials[1]._index
+    assert materials[1] == openmc.lib.materials[2]._index
+    assert materials[2] == -1
+    assert temperatures[0] == pytest.approx(openmc.lib.cells[1].get_temperature())
+    assert temperatures[2] == 0.0
+    with pytest.raises(ValueError):
+        openmc.lib.find_cells([0., 0., 0.])
+
+
+def test_find_overlaps(lib_init):
+    overlaps = openmc.lib.find_overlaps(1000, (-0.63, -0.63, -1.),
+                                        (0.63, 0.63, 1.))
+    assert overlaps == []
+    with pytest.raises(ValueError):
+        openmc.lib.find_overlaps(1000)
+
+
 def test_find_material(lib_init):
     mat = openmc.lib.find_material((0., 0., 0.))
     assert mat is openmc.lib.materials[1]
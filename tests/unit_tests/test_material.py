@@ -347,6 +347,8 @@ def test_from_xml(run_in_tmpdir):
     m1.volume = 100
     m1.set_density('g/cm3', 0.9)
     m1.isotropic = ['H1']
+    m1.union_grid = True
+    m1.xs_table = True
     m2 = openmc.Material(2, 'zirc')
     m2.add_nuclide('Zr90', 1.0, 'wo')
     m2.set_density('kg/m3', 10.0)
@@ -367,10 +369,14 @@ def test_from_xml(run_in_tmpdir):
     assert m1.isotropic == ['H1']
     assert m1.temperature == 300
     assert m1.volume == 100
+    assert m1.union_grid
+    assert m1.xs_table
     m2 = mats[1]
     assert m2.nuclides == [('Zr90', 1.0, 'wo')]
     assert m2.density == 10.0
     assert m2.density_units == 'kg/m3'
+    assert not m2.union_grid
+    assert not m2.xs_table
     assert mats[2].density_units == 'sum'
 
 
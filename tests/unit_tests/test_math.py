@@ -241,3 +241,29 @@ def test_broaden_wmp_polynomials():
     test_val = openmc.lib.math.broaden_wmp_polynomials(test_E, test_dopp, n)
 
     assert np.allclose(ref_val, test_val)
+
+
+def test_faddeeva():
+    # In the upper half plane the integral form is the usual Faddeeva function
+    for z in (0.5 + 1.0j, -3.0 + 0.01j, 100.0 + 20.0j):
+        assert openmc.lib.math.faddeeva(z) == pytest.approx(
+            sp.special.wofz(z))
+
+    # In the lower half plane it is -conj(w(conj(z)))
+    z = 2.0 - 0.5j
+    assert openmc.lib.math.faddeeva(z) == pytest.approx(
+        -np.conj(sp.special.wofz(np.conj(z))))
+
+
+def test_faddeeva_batch():
+    # Arguments in both half planes over the range met in multipole
+    # evaluation. The number of arguments is not a multiple of the block size.
+    x = np.concatenate((-np.logspace(-3, 6, 23), [0.0], np.logspace(-3, 6, 23)))
+    y = np.concatenate((-np.logspace(-8, 3, 12), np.logspace(-8, 3, 12)))
+    z = (x[:, np.newaxis] + 1j*y).ravel()
+
+    ref_val = np.array([openmc.lib.math.faddeeva(zi) for zi in z])
+    test_val = openmc.lib.math.faddeeva_batch(z)
+
+    assert test_val.shape == z.shape
+    assert np.all(np.abs(test_val - ref_val) <= 1e-12*np.abs(ref_val))
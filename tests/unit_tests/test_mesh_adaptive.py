@@ -0,0 +1,122 @@
+import os
+
+import h5py
+import numpy as np
+import openmc
+import pytest
+
+
+@pytest.fixture
+def mesh():
+    mesh = openmc.AdaptiveMesh()
+    mesh.dimension = [2, 2, 2]
+    mesh.lower_left = [-1., -1., -1.]
+    mesh.upper_right = [1., 1., 1.]
+    return mesh
+
+
+def test_bins(mesh):
+    assert mesh.max_bins == 8
+    mesh.max_bins = 64
+    assert mesh.num_mesh_cells == 64
+    assert len(list(mesh.indices)) == 64
+    assert len(openmc.MeshFilter(mesh).bins) == 64
+    with pytest.raises(ValueError):
+        mesh.refine_rel_error = 0.0
+    with pytest.raises(ValueError):
+        mesh.refine_batches = 1
+
+
+def test_xml_roundtrip(mesh):
+    mesh.max_bins = 1000
+    mesh.refine_threshold = 0.2
+    mesh.refine_rel_error = 0.05
+    mesh.refine_batches = 4
+
+    elem = mesh.to_xml_element()
+    assert elem.get('type') == 'adaptive'
+    new_mesh = openmc.AdaptiveMesh.from_xml_element(elem)
+    assert new_mesh.id == mesh.id
+    assert new_mesh.dimension == mesh.dimension
+    assert new_mesh.max_bins == 1000
+    assert new_mesh.refine_threshold == 0.2
+    assert new_mesh.refine_rel_error == 0.05
+    assert new_mesh.refine_batches == 4
+
+
+def adaptive_model(mesh):
+    water = openmc.Material()
+    water.add_nuclide('H1', 2.0)
+    water.add_nuclide('O16', 1.0)
+    water.set_density('g/cm3', 1.0)
+    box = openmc.model.rectangular_prism(2.0, 2.0, boundary_type='vacuum')
+    zmin = openmc.ZPlane(z0=-1.0, boundary_type='vacuum')
+    zmax = openmc.ZPlane(z0=1.0, boundary_type='vacuum')
+    cell = openmc.Cell(fill=water, region=box & +zmin & -zmax)
+
+    model = openmc.model.Model()
+    model.materials = openmc.Materials([water])
+    model.geometry = openmc.Geometry([cell])
+    model.settings.run_mode = 'fixed source'
+    model.settings.particles = 2000
+    model.settings.batches = 10
+    model.settings.statepoint = {'batches': list(range(1, 11))}
+    model.settings.source = openmc.Source(
+        space=openmc.stats.Point((0.1, 0.2, 0.3)),
+        energy=openmc.stats.Discrete([1.0e6], [1.0]))
+
+    # Every track lies within the mesh, so its leaves see the same track
+    # length as a tally without a filter
+    mesh.max_bins = 64
+    mesh.refine_threshold = 0.1
+    mesh.refine_rel_error = 0.5
+    mesh.refine_batches = 2
+    mesh_tally = openmc.Tally()
+    mesh_tally.filters = [openmc.MeshFilter(mesh)]
+    mesh_tally.scores = ['flux']
+    total_tally = openmc.Tally()
+    total_tally.scores = ['flux']
+    model.tallies = [mesh_tally, total_tally]
+    return model
+
+
+def read_elements(filename, mesh):
+    with h5py.File(filename, 'r') as f:
+        group = f['tallies/meshes/mesh {}'.format(mesh.id)]
+        return {name: group[name][()]
+                for name in ('levels', 'indices', 'children')}
+
+
+def test_refinement(run_in_tmpdir, mesh):
+    model = adaptive_model(mesh)
+    model.run()
+    mesh_tally, total_tally = model.tallies
+
+    # Tracks through divided elements are split among their leaves. The
+    # tally over the mesh restarts after each refinement, so it is compared
+    # with the other tally over the same batches.
+    elements = read_elements('statepoint.10.h5', mesh)
+    assert elements['levels'].size > 8
+    assert elements['levels'].max() >= 1
+    with openmc.StatePoint('statepoint.10.h5') as sp:
+        leaves = sp.tallies[mesh_tally.id]
+        n = leaves.num_realizations
+        leaf_sum = leaves.sum.sum()
+        total_sum = sp.tallies[total_tally.id].sum.sum()
+    assert 0 < n < 10
+    with openmc.StatePoint('statepoint.{}.h5'.format(10 - n)) as sp:
+        total_sum -= sp.tallies[total_tally.id].sum.sum()
+    assert leaf_sum == pytest.approx(total_sum, rel=1e-10)
+
+    # The tree of elements is read back when restarting, so the run
+    # continues exactly as before
+    with openmc.StatePoint('statepoint.10.h5') as sp:
+        mean = sp.tallies[mesh_tally.id].mean.copy()
+    assert read_elements('statepoint.5.h5', mesh)['levels'].size > 8
+    for i in range(1, 11):
+        os.rename('statepoint.{}.h5'.format(i), 'full.{}.h5'.format(i))
+    openmc.run(restart_file='full.5.h5')
+    for name, value in read_elements('statepoint.10.h5', mesh).items():
+        assert np.array_equal(value, elements[name])
+    with openmc.StatePoint('statepoint.10.h5') as sp:
+        assert np.array_equal(sp.tallies[mesh_tally.id].mean, mean)
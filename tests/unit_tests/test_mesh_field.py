@@ -0,0 +1,39 @@
+import numpy as np
+import pytest
+
+import openmc
+
+
+@pytest.fixture
+def mesh():
+    mesh = openmc.RegularMesh()
+    mesh.dimension = [2, 2, 1]
+    mesh.lower_left = [-1., -1., -1.]
+    mesh.upper_right = [1., 1., 1.]
+    return mesh
+
+
+def test_values(mesh):
+    field = openmc.MeshField(mesh, temperatures=[[300.0, 600.0],
+                                                 [900.0, 0.0]])
+    assert field.temperatures.shape == (4,)
+    assert field.density_multipliers is None
+    assert field.cells is None
+    with pytest.raises(ValueError):
+        openmc.MeshField(mesh, temperatures=[300.0]*3)
+    with pytest.raises(ValueError):
+        openmc.MeshField(mesh, density_multipliers=[1.0, 1.0, -0.5, 1.0])
+
+
+def test_xml_roundtrip(mesh):
+    cell = openmc.Cell()
+    field = openmc.MeshField(mesh, density_multipliers=[0.5, 1.0, 1.5, 2.0],
+                             cells=[cell, 10])
+    assert field.cells == [cell.id, 10]
+
+    elem = field.to_xml_element()
+    assert elem.find('temperatures') is None
+    new_field = openmc.MeshField.from_xml_element(elem, mesh)
+    assert new_field.id == field.id
+    assert new_field.cells == field.cells
+    assert np.all(new_field.density_multipliers == field.density_multipliers)
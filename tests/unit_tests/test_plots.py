@@ -35,6 +35,7 @@ def myplot():
         'linewidth': 2,
         'color': (40, 30, 20)
     }
+    plot.ray_trace = True
     return plot
 
 
@@ -79,6 +80,7 @@ def test_to_xml_element(myplot):
     assert elem.find('width') is not None
     assert elem.find('pixels') is not None
     assert elem.find('background').text == '0 0 0'
+    assert elem.find('ray_trace').text == 'true'
 
 
 def test_plots(run_in_tmpdir):
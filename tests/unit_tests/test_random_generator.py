@@ -0,0 +1,40 @@
+import numpy as np
+import pytest
+import openmc
+import openmc.examples
+
+
+def run_results(model, **kwargs):
+    sp_name = model.run(**kwargs)
+    with openmc.StatePoint(sp_name) as sp:
+        tally = sp.tallies[model.tallies[0].id]
+        return sp.k_generation.copy(), sp.k_combined, tally.mean.ravel()
+
+
+def test_philox(run_in_tmpdir):
+    model = openmc.examples.pwr_pin_cell()
+    model.settings.particles = 1000
+    model.settings.batches = 10
+    model.settings.inactive = 5
+    tally = openmc.Tally()
+    tally.filters = [openmc.EnergyFilter([0.0, 0.625, 20.0e6])]
+    tally.scores = ['flux', 'fission']
+    model.tallies = [tally]
+    k_gen_lcg, k_lcg, mean_lcg = run_results(model)
+
+    model.settings.random_generator = 'philox'
+    k_gen, k, mean = run_results(model, threads=1)
+
+    # The random numbers of a particle only depend on its ID, so the results
+    # do not depend on the number of threads or on the transport mode, up to
+    # the order in which the scores are summed
+    for kwargs in ({'threads': 2}, {'threads': 2, 'event_based': True}):
+        k_gen_other, _, mean_other = run_results(model, **kwargs)
+        assert k_gen_other == pytest.approx(k_gen, rel=1e-10)
+        assert mean_other == pytest.approx(mean, rel=1e-10)
+
+    # A different sequence of random numbers gives statistically consistent
+    # results
+    assert not np.array_equal(k_gen, k_gen_lcg)
+    diff = k - k_lcg
+    assert abs(diff.nominal_value) < 4*diff.std_dev
@@ -0,0 +1,71 @@
+import subprocess
+
+import numpy as np
+import openmc
+from openmc.examples import slab_mg
+import pytest
+
+
+@pytest.fixture
+def model(run_in_tmpdir):
+    # Isotropic two-group cross sections
+    groups = openmc.mgxs.EnergyGroups(group_edges=[0.0, 0.625, 20.0e6])
+    xsdata = openmc.XSdata('mat_1', groups)
+    xsdata.order = 0
+    fiss = np.array([0.002817, 0.097])
+    capture = np.array([0.008708, 0.02518])
+    xsdata.set_fission(fiss)
+    xsdata.set_nu_fission(2.5*fiss)
+    xsdata.set_absorption(capture + fiss)
+    xsdata.set_scatter_matrix(np.array([[[0.31980], [0.004555]],
+                                        [[0.00000], [0.424100]]]))
+    xsdata.set_total(np.array([0.33588, 0.54628]))
+    xsdata.set_chi(np.array([1.0, 0.0]))
+    library = openmc.MGXSLibrary(groups)
+    library.add_xsdata(xsdata)
+    library.export_to_hdf5('2g.h5')
+
+    model = slab_mg()
+    model.settings.random_ray = {'distance_inactive': 100.0,
+                                 'distance_active': 500.0}
+    model.settings.particles = 100
+    model.settings.batches = 10
+    model.settings.inactive = 5
+    return model
+
+
+def assert_rejected(model):
+    with pytest.raises(subprocess.CalledProcessError) as excinfo:
+        model.run()
+    output = ' '.join(excinfo.value.output.split())
+    assert 'random ray only scores track-length tallies' in output
+
+
+def test_tracklength_tally(model):
+    tally = openmc.Tally()
+    tally.filters = [openmc.EnergyFilter([0.0, 0.625, 20.0e6])]
+    tally.scores = ['flux', 'fission']
+    tally.estimator = 'tracklength'
+    model.tallies = [tally]
+
+    sp_name = model.run()
+    with openmc.StatePoint(sp_name) as sp:
+        assert np.all(sp.tallies[tally.id].mean > 0.0)
+
+
+@pytest.mark.parametrize('estimator', ['collision', 'analog'])
+def test_reject_estimator(model, estimator):
+    tally = openmc.Tally()
+    tally.scores = ['flux']
+    tally.estimator = estimator
+    model.tallies = [tally]
+    assert_rejected(model)
+
+
+def test_reject_surface_tally(model):
+    tally = openmc.Tally()
+    tally.filters = [openmc.SurfaceFilter(
+        model.geometry.get_all_surfaces().values())]
+    tally.scores = ['current']
+    model.tallies = [tally]
+    assert_rejected(model)
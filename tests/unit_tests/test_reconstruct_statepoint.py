@@ -0,0 +1,78 @@
+from pathlib import Path
+import subprocess
+import sys
+
+import h5py
+import numpy as np
+import openmc
+import openmc.examples
+import pytest
+
+SCRIPT = Path(__file__).parents[2] / 'scripts' / 'openmc-reconstruct-statepoint'
+
+
+@pytest.fixture
+def model():
+    model = openmc.examples.pwr_pin_cell()
+    model.settings.particles = 200
+    model.settings.batches = 5
+    model.settings.inactive = 0
+
+    # A fine mesh tally spans many blocks, of which only some are scored in
+    # each batch
+    mesh = openmc.RegularMesh()
+    mesh.dimension = (60, 60)
+    mesh.lower_left = (-0.63, -0.63)
+    mesh.upper_right = (0.63, 0.63)
+    tally = openmc.Tally()
+    tally.filters = [openmc.MeshFilter(mesh),
+                     openmc.EnergyFilter([0.0, 0.625, 1.0e3, 20.0e6])]
+    tally.scores = ['flux', 'absorption']
+    model.tallies = [tally]
+    return model
+
+
+def tally_results(filename):
+    with h5py.File(filename, 'r') as f:
+        return {name: group['results'][()]
+                for name, group in f['tallies'].items()
+                if name.startswith('tally ')}
+
+
+def test_reconstruct_statepoint(run_in_tmpdir, model):
+    # Full state points of every batch
+    model.settings.statepoint = {'batches': [1, 2, 3, 4, 5]}
+    model.run()
+    full = {b: tally_results(f'statepoint.{b}.h5') for b in (3, 5)}
+    for b in range(1, 6):
+        Path(f'statepoint.{b}.h5').rename(f'full.{b}.h5')
+
+    # The same run with incremental state points
+    model.settings.statepoint = {'batches': [1, 2, 3, 4, 5],
+                                 'incremental': True}
+    model.run()
+    with h5py.File('statepoint.5.h5', 'r') as f:
+        assert f.attrs['previous'] == b'statepoint.4.h5'
+        for name, group in f['tallies'].items():
+            if name.startswith('tally '):
+                assert group.attrs['incremental'] == 1
+                assert 'results' not in group
+
+    # Rebuilding the full results from the changed blocks is exact
+    for b in (3, 5):
+        subprocess.run([sys.executable, str(SCRIPT), f'statepoint.{b}.h5',
+                        '-o', f'rebuilt.{b}.h5'], check=True)
+        rebuilt = tally_results(f'rebuilt.{b}.h5')
+        assert rebuilt.keys() == full[b].keys()
+        for name, results in full[b].items():
+            assert np.array_equal(rebuilt[name], results)
+        with h5py.File(f'rebuilt.{b}.h5', 'r') as f:
+            assert 'previous' not in f.attrs
+
+    # A run can be restarted from the rebuilt state point
+    model.settings.batches = 6
+    model.settings.statepoint = {'batches': [6]}
+    model.export_to_xml()
+    openmc.run(restart_file='rebuilt.5.h5')
+    with openmc.StatePoint('statepoint.6.h5') as sp:
+        assert sp.n_realizations == 6
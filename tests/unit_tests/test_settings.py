@@ -18,15 +18,16 @@ def test_export_to_xml(run_in_tmpdir):
     s.output = {'summary': True, 'tallies': False, 'path': 'here'}
     s.verbosity = 7
     s.sourcepoint = {'batches': [50, 150, 500, 1000], 'separate': True,
-                     'write': True, 'overwrite': True}
-    s.statepoint = {'batches': [50, 150, 500, 1000]}
+                     'write': True, 'overwrite': True, 'format': 'binary'}
+    s.statepoint = {'batches': [50, 150, 500, 1000], 'incremental': True}
     s.confidence_intervals = True
     s.ptables = True
     s.seed = 17
     s.survival_biasing = True
     s.cutoff = {'weight': 0.25, 'weight_avg': 0.5, 'energy_neutron': 1.0e-5,
                 'energy_photon': 1000.0, 'energy_electron': 1.0e-5,
-                'energy_positron': 1.0e-5}
+                'energy_positron': 1.0e-5, 'time_neutron': 1.0e-3}
+    s.max_secondaries = 1000
     mesh = openmc.RegularMesh()
     mesh.lower_left = (-10., -10., -10.)
     mesh.upper_right = (10., 10., 10.)
@@ -35,24 +36,98 @@ def test_export_to_xml(run_in_tmpdir):
     s.trigger_active = True
     s.trigger_max_batches = 10000
     s.trigger_batch_interval = 50
+    s.trigger_freeze = True
     s.no_reduce = False
     s.tabular_legendre = {'enable': True, 'num_points': 50}
     s.temperature = {'default': 293.6, 'method': 'interpolation',
-                     'multipole': True, 'range': (200., 1000.)}
+                     'multipole': True, 'range': (200., 1000.),
+                     'cache': True}
     s.trace = (10, 1, 20)
     s.track = [1, 1, 1, 2, 1, 1]
     s.ufs_mesh = mesh
+    s.precursor_mesh = mesh
+    s.domain_mesh = mesh
     s.resonance_scattering = {'enable': True, 'method': 'rvs',
                               'energy_min': 1.0, 'energy_max': 1000.0,
                               'nuclides': ['U235', 'U238', 'Pu239']}
+    s.cmfd = {'mesh': mesh, 'energy_groups': [0.0, 0.625, 20.0e6],
+              'begin': 3}
+    s.surf_source_write = {'surface_ids': [2], 'max_particles': 200}
+    s.census = {'time': 1.0e-6, 'max_particles': 300}
     s.volume_calculations = openmc.VolumeCalculation(
         domains=[openmc.Cell()], samples=1000, lower_left=(-10., -10., -10.),
         upper_right = (10., 10., 10.))
+    s.volume_calculations.append(openmc.VolumeCalculation(
+        domains=[openmc.Material()], samples=100, lower_left=(-10., -10., -10.),
+        upper_right=(10., 10., 10.), estimator='ray'))
     s.create_fission_neutrons = True
     s.log_grid_bins = 2000
     s.photon_transport = False
     s.electron_treatment = 'led'
     s.dagmc = False
+    s.event_queue_sort = True
+    s.event_queue_sort_threshold = 5000
+    s.event_local_queue_length = 128
+    s.event_prefetch_distance = 8
+    s.event_memory_budget = 512.0
+    s.event_scheduler = 'round-robin'
+    s.event_min_queue_length = 1000
+    s.event_history_threshold = 500
+    s.event_refill = True
+    s.event_fuse_advance = True
+    s.history_scheduler = 'work-stealing'
+    s.history_interleave = 4
+    s.thread_affinity = 'spread'
+    s.vectorize_xs = True
+    s.compact_xs_cache = True
+    s.interleaved_xs = True
+    s.energy_search = 'hashed'
+    s.shared_xs = True
+    s.threaded_xs_read = True
+    s.lazy_products = True
+    s.xs_cache = 'cache/'
+    s.neighbor_lists = 'statepoint.10.h5'
+    s.event_batch_distance = True
+    s.delta_tracking = True
+    s.private_tallies = True
+    s.private_tallies_max_size = 500000
+    s.pipeline_tallies = True
+    s.tally_profiling = True
+    s.load_balance = True
+    s.shared_bank = True
+    s.particle_ramp = 0.1
+    s.async_statepoint = True
+    s.tally_compression = 4
+    s.track_single_file = True
+    s.async_summary = True
+    s.vectorize_multipole = True
+    s.cumulative_xs = True
+    s.random_generator = 'philox'
+    s.random_ray = {'distance_inactive': 10.0, 'distance_active': 100.0}
+    s.correlated_alias = True
+    s.thermal_alias = True
+    s.thinning_tolerance = 1e-3
+    s.compton_tables = True
+    s.broadcast_data = True
+    s.dagmc_bvh = True
+    ww = openmc.WeightWindows(mesh, [0.5]*250, [0.0, 1.0, 2.0e7], 'neutron')
+    ww.upper_bound_ratio = 4.0
+    ww.max_split = 5
+    s.weight_windows = ww
+    s.mesh_fields = openmc.MeshField(
+        mesh, temperatures=[600.0]*125, density_multipliers=[0.9]*125,
+        cells=[1, 2])
+    s.performance_report = True
+    s.instrument = True
+    s.photon_xs_tables = True
+    s.photon_material_tables = True
+    s.huge_pages = True
+    s.numa_interleave = True
+    s.azimuth_rejection = True
+    s.source_sort = True
+    s.retain_data = True
+    s.alias_sampling = True
+    s.flat_geometry = True
 
     # Make sure exporting XML works
     s.export_to_xml()
@@ -74,15 +149,19 @@ def test_export_to_xml(run_in_tmpdir):
     assert s.output == {'summary': True, 'tallies': False, 'path': 'here'}
     assert s.verbosity == 7
     assert s.sourcepoint == {'batches': [50, 150, 500, 1000], 'separate': True,
-                             'write': True, 'overwrite': True}
-    assert s.statepoint == {'batches': [50, 150, 500, 1000]}
+                             'write': True, 'overwrite': True,
+                             'format': 'binary'}
+    assert s.statepoint == {'batches': [50, 150, 500, 1000],
+                            'incremental': True}
     assert s.confidence_intervals
     assert s.ptables
     assert s.seed == 17
     assert s.survival_biasing
     assert s.cutoff == {'weight': 0.25, 'weight_avg': 0.5,
                         'energy_neutron': 1.0e-5, 'energy_photon': 1000.0,
-                        'energy_electron': 1.0e-5, 'energy_positron': 1.0e-5}
+                        'energy_electron': 1.0e-5, 'energy_positron': 1.0e-5,
+                        'time_neutron': 1.0e-3}
+    assert s.max_secondaries == 1000
     assert isinstance(s.entropy_mesh, openmc.RegularMesh)
     assert s.entropy_mesh.lower_left == [-10., -10., -10.]
     assert s.entropy_mesh.upper_right == [10., 10., 10.]
@@ -90,21 +169,105 @@ def test_export_to_xml(run_in_tmpdir):
     assert s.trigger_active
     assert s.trigger_max_batches == 10000
     assert s.trigger_batch_interval == 50
+    assert s.trigger_freeze
     assert not s.no_reduce
     assert s.tabular_legendre == {'enable': True, 'num_points': 50}
     assert s.temperature == {'default': 293.6, 'method': 'interpolation',
-                             'multipole': True, 'range': [200., 1000.]}
+                             'multipole': True, 'range': [200., 1000.],
+                             'cache': True}
     assert s.trace == [10, 1, 20]
     assert s.track == [1, 1, 1, 2, 1, 1]
     assert isinstance(s.ufs_mesh, openmc.RegularMesh)
     assert s.ufs_mesh.lower_left == [-10., -10., -10.]
     assert s.ufs_mesh.upper_right == [10., 10., 10.]
     assert s.ufs_mesh.dimension == [5, 5, 5]
+    assert isinstance(s.precursor_mesh, openmc.RegularMesh)
+    assert s.precursor_mesh.dimension == [5, 5, 5]
+    assert isinstance(s.domain_mesh, openmc.RegularMesh)
+    assert s.domain_mesh.dimension == [5, 5, 5]
     assert s.resonance_scattering == {'enable': True, 'method': 'rvs',
                                       'energy_min': 1.0, 'energy_max': 1000.0,
                                       'nuclides': ['U235', 'U238', 'Pu239']}
+    assert isinstance(s.cmfd['mesh'], openmc.RegularMesh)
+    assert s.cmfd['mesh'].dimension == [5, 5, 5]
+    assert s.cmfd['energy_groups'] == [0.0, 0.625, 20.0e6]
+    assert s.cmfd['begin'] == 3
+    assert s.surf_source_write == {'surface_ids': [2], 'max_particles': 200}
+    assert s.census == {'time': 1.0e-6, 'max_particles': 300}
     assert s.create_fission_neutrons
     assert s.log_grid_bins == 2000
     assert not s.photon_transport
     assert s.electron_treatment == 'led'
     assert not s.dagmc
+    assert s.event_queue_sort
+    assert s.event_queue_sort_threshold == 5000
+    assert s.event_local_queue_length == 128
+    assert s.event_prefetch_distance == 8
+    assert s.event_memory_budget == 512.0
+    assert s.event_scheduler == 'round-robin'
+    assert s.event_min_queue_length == 1000
+    assert s.event_history_threshold == 500
+    assert s.event_refill
+    assert s.event_fuse_advance
+    assert s.history_scheduler == 'work-stealing'
+    assert s.history_interleave == 4
+    assert s.thread_affinity == 'spread'
+    assert s.vectorize_xs
+    assert s.compact_xs_cache
+    assert s.interleaved_xs
+    assert s.energy_search == 'hashed'
+    assert s.shared_xs
+    assert s.threaded_xs_read
+    assert s.lazy_products
+    assert s.xs_cache == 'cache/'
+    assert s.neighbor_lists == 'statepoint.10.h5'
+    assert s.event_batch_distance
+    assert s.delta_tracking
+    assert s.private_tallies
+    assert s.private_tallies_max_size == 500000
+    assert s.pipeline_tallies
+    assert s.tally_profiling
+    assert s.load_balance
+    assert s.shared_bank
+    assert s.particle_ramp == 0.1
+    assert s.async_statepoint
+    assert s.tally_compression == 4
+    assert s.track_single_file
+    assert s.async_summary
+    assert s.vectorize_multipole
+    assert s.cumulative_xs
+    assert s.random_generator == 'philox'
+    assert s.random_ray == {'distance_inactive': 10.0,
+                            'distance_active': 100.0}
+    assert s.correlated_alias
+    assert s.thermal_alias
+    assert s.thinning_tolerance == 1e-3
+    assert s.compton_tables
+    assert s.broadcast_data
+    assert s.dagmc_bvh
+    assert len(s.weight_windows) == 1
+    ww = s.weight_windows[0]
+    assert ww.mesh.dimension == [5, 5, 5]
+    assert ww.lower_ww_bounds.shape == (125, 2)
+    assert ww.energy_bounds == [0.0, 1.0, 2.0e7]
+    assert ww.particle_type == 'neutron'
+    assert ww.upper_bound_ratio == 4.0
+    assert ww.max_split == 5
+    assert ww.survival_ratio is None
+    assert len(s.mesh_fields) == 1
+    field = s.mesh_fields[0]
+    assert field.mesh.dimension == [5, 5, 5]
+    assert (field.temperatures == 600.0).all()
+    assert (field.density_multipliers == 0.9).all()
+    assert field.cells == [1, 2]
+    assert s.performance_report
+    assert s.instrument
+    assert s.photon_xs_tables
+    assert s.photon_material_tables
+    assert s.huge_pages
+    assert s.numa_interleave
+    assert s.azimuth_rejection
+    assert s.source_sort
+    assert s.retain_data
+    assert s.alias_sampling
+    assert s.flat_geometry
@@ -201,6 +201,16 @@ def test_box():
     d = openmc.stats.Spatial.from_xml_element(elem)
     assert isinstance(d, openmc.stats.Box)
 
+    # acceptance grid
+    assert d.acceptance_grid is None
+    d3 = openmc.stats.Box(lower_left, upper_right, True, (4, 5, 6))
+    elem = d3.to_xml_element()
+    assert elem.find('acceptance_grid').text == '4 5 6'
+    d = openmc.stats.Box.from_xml_element(elem)
+    assert d.acceptance_grid == [4, 5, 6]
+    with pytest.raises(ValueError):
+        openmc.stats.Box(lower_left, upper_right, acceptance_grid=(4, 0, 6))
+
 
 def test_point():
     p = (-4., 2., 10.)
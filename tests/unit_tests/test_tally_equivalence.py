@@ -0,0 +1,261 @@
+import re
+
+import numpy as np
+import openmc
+import openmc.examples
+import pytest
+
+from tests.regression_tests import config
+
+
+@pytest.fixture
+def model(run_in_tmpdir):
+    model = openmc.examples.pwr_assembly()
+    model.settings.particles = 1000
+    model.settings.batches = 5
+    model.settings.inactive = 2
+
+    # The mesh tally has enough bins that it is accumulated by several threads
+    mesh = openmc.RegularMesh()
+    mesh.lower_left = (-10.71, -10.71)
+    mesh.upper_right = (10.71, 10.71)
+    mesh.dimension = (68, 68)
+    mesh_tally = openmc.Tally()
+    mesh_tally.filters = [openmc.MeshFilter(mesh)]
+    mesh_tally.scores = ['flux', 'total', 'absorption', 'nu-fission']
+
+    cells = model.geometry.get_all_material_cells().values()
+    cell_tally = openmc.Tally()
+    cell_tally.filters = [openmc.CellFilter(list(cells)),
+                          openmc.EnergyFilter([0.0, 0.625, 20.0e6])]
+    cell_tally.scores = ['flux', 'scatter', 'fission']
+
+    model.tallies = [mesh_tally, cell_tally]
+    return model
+
+
+def run_results(model, threads=2):
+    kwargs = {'threads': threads}
+    if config['mpi']:
+        kwargs['mpi_args'] = [config['mpiexec'], '-n', config['mpi_np']]
+    sp_name = model.run(**kwargs)
+    with openmc.StatePoint(sp_name) as sp:
+        return {tally_id: (t.sum.copy(), t.sum_sq.copy())
+                for tally_id, t in sp.tallies.items()}
+
+
+def assert_same_results(results, reference, rel=1e-10):
+    # Only the order in which the scores of a batch are summed may differ
+    assert results.keys() == reference.keys()
+    for tally_id, (sum_, sum_sq) in reference.items():
+        assert results[tally_id][0] == pytest.approx(sum_, rel=rel)
+        assert results[tally_id][1] == pytest.approx(sum_sq, rel=rel)
+
+
+def test_sparse_results(model):
+    dense = run_results(model)
+    for tally in model.tallies:
+        tally.sparse_results = True
+    assert_same_results(run_results(model), dense)
+
+
+@pytest.mark.parametrize('max_size', [None, 1000])
+def test_private_tallies(model, max_size):
+    atomic = run_results(model)
+
+    # With the smaller limit, only the cell tally has thread-private buffers
+    model.settings.private_tallies = True
+    if max_size is not None:
+        model.settings.private_tallies_max_size = max_size
+    assert_same_results(run_results(model), atomic)
+
+
+def test_pipeline_tallies(model):
+    # Reductions can only be in flight during the next batch across processes
+    if not config['mpi']:
+        pytest.skip('Tally reductions are only pipelined with MPI.')
+    blocking = run_results(model)
+    model.settings.pipeline_tallies = True
+    assert_same_results(run_results(model), blocking)
+
+
+def statepoint_contents(batch):
+    with openmc.StatePoint('statepoint.{}.h5'.format(batch)) as sp:
+        tallies = {tally_id: (t.sum.copy(), t.sum_sq.copy())
+                   for tally_id, t in sp.tallies.items()}
+        return (sp.current_batch, sp.n_realizations, sp.k_generation.copy(),
+                sp.global_tallies.copy(), sp.source.copy(), tallies)
+
+
+def test_async_statepoint(model):
+    # With a single thread, both runs score exactly the same values
+    model.settings.statepoint = {'batches': [3, 5]}
+    model.settings.sourcepoint = {'write': True}
+    model.run(threads=1)
+    sync = [statepoint_contents(batch) for batch in (3, 5)]
+
+    model.settings.async_statepoint = True
+    model.run(threads=1)
+    for batch, reference in zip((3, 5), sync):
+        contents = statepoint_contents(batch)
+        assert contents[:2] == reference[:2]
+        for array, expected in zip(contents[2:5], reference[2:5]):
+            assert np.array_equal(array, expected)
+        for tally_id, (sum_, sum_sq) in reference[5].items():
+            assert np.array_equal(contents[5][tally_id][0], sum_)
+            assert np.array_equal(contents[5][tally_id][1], sum_sq)
+
+
+def test_parallel_accumulate(model, capfd):
+    # The mesh tally is accumulated by a single thread in the first run
+    serial = run_results(model, threads=1)
+    assert_same_results(run_results(model, threads=4), serial)
+
+    # An unreachable trigger is checked every batch up to the last one, with
+    # the uncertainties found while the last batch is accumulated
+    threshold = 1.0e-6
+    trigger = openmc.Trigger('rel_err', threshold)
+    trigger.scores = ['flux']
+    mesh_tally = model.tallies[0]
+    mesh_tally.triggers = [trigger]
+    model.settings.trigger_active = True
+    model.settings.trigger_max_batches = 7
+    model.settings.trigger_batch_interval = 1
+    capfd.readouterr()
+    sp_name = model.run(threads=4)
+    out, err = capfd.readouterr()
+    ratios = re.findall(r'max unc\./thresh\. is (\S+) for flux in tally {}'
+                        .format(mesh_tally.id), out + err)
+
+    # Those must be the uncertainties of the final results
+    with openmc.StatePoint(sp_name) as sp:
+        assert sp.current_batch == 7
+        tally = sp.tallies[mesh_tally.id]
+        flux = tally.get_slice(scores=['flux'])
+        mean = flux.mean.ravel()
+        std_dev = flux.std_dev.ravel()
+    scored = mean > 0.0
+    expected = np.max(std_dev[scored] / mean[scored]) / threshold
+    assert float(ratios[-1]) == pytest.approx(expected, rel=1e-8)
+
+
+@pytest.mark.parametrize('estimator', ['tracklength', 'collision'])
+@pytest.mark.parametrize('nuclides', [['U235', 'total'], ['all']])
+def test_score_kernels(model, estimator, nuclides):
+    # The first tally only has scores with specialized kernels, while the
+    # elastic score makes the second one use score_general for all of them
+    scores = ['flux', 'total', 'scatter', 'absorption', 'fission',
+              'nu-fission']
+    cells = model.geometry.get_all_material_cells().values()
+    tallies = []
+    for extra in ([], ['elastic']):
+        tally = openmc.Tally()
+        tally.filters = [openmc.CellFilter(list(cells)),
+                         openmc.EnergyFilter([0.0, 0.625, 20.0e6])]
+        tally.nuclides = nuclides
+        tally.scores = scores + extra
+        tally.estimator = estimator
+        tallies.append(tally)
+    model.tallies = tallies
+
+    sp_name = model.run(threads=1)
+    with openmc.StatePoint(sp_name) as sp:
+        specialized = sp.tallies[tallies[0].id]
+        general = sp.tallies[tallies[1].id]
+        for nuclide in specialized.nuclides:
+            expected = general.get_values(scores=scores, nuclides=[nuclide])
+            values = specialized.get_values(scores=scores, nuclides=[nuclide])
+            assert values == pytest.approx(expected, rel=1e-12)
+
+
+@pytest.mark.parametrize('estimator', ['tracklength', 'collision'])
+def test_domain_index(model, estimator):
+    # Cell, material and mesh filters let the scoring skip the tallies whose
+    # domain the particle is not in, while distribcell filters do not
+    cells = model.geometry.get_all_material_cells().values()
+    fuel_cell = next(c for c in cells if c.name == 'fuel')
+    mesh = model.tallies[0].filters[0].mesh
+    quarter = openmc.RegularMesh()
+    quarter.lower_left = mesh.lower_left
+    quarter.upper_right = (0.0, 0.0)
+    quarter.dimension = (34, 34)
+    filters = {
+        'cell': openmc.CellFilter(fuel_cell),
+        'material': openmc.MaterialFilter(fuel_cell.fill),
+        'distribcell': openmc.DistribcellFilter(fuel_cell),
+        'mesh': openmc.MeshFilter(mesh),
+        'quarter': openmc.MeshFilter(quarter)
+    }
+    tallies = {}
+    for name, domain_filter in filters.items():
+        tally = openmc.Tally(name=name)
+        tally.filters = [domain_filter]
+        tally.scores = ['flux', 'fission']
+        tally.estimator = estimator
+        tallies[name] = tally
+    model.tallies = list(tallies.values())
+
+    sp_name = model.run(threads=1)
+    with openmc.StatePoint(sp_name) as sp:
+        mean = {name: sp.tallies[t.id].mean for name, t in tallies.items()}
+    full_scan = mean['distribcell'].sum(axis=0)
+    assert mean['cell'][0] == pytest.approx(full_scan, rel=1e-10)
+    assert mean['material'][0] == pytest.approx(full_scan, rel=1e-10)
+    lower_left = mean['mesh'].reshape(68, 68, 2)[:34, :34]
+    assert mean['quarter'].reshape(34, 34, 2) == pytest.approx(lower_left,
+                                                              rel=1e-10)
+
+
+def test_decomposed(model):
+    # Tally bins are only divided among several processes
+    if not config['mpi']:
+        pytest.skip('Tally results are only decomposed with MPI.')
+
+    # The mesh tally has many more bins than the buffers of remote scores, so
+    # that most scores are moved from the buffers of the threads before they
+    # are sent to the owner of their bin
+    mesh = openmc.RegularMesh()
+    mesh.lower_left = (-10.71, -10.71)
+    mesh.upper_right = (10.71, 10.71)
+    mesh.dimension = (256, 256)
+    tally = openmc.Tally()
+    tally.filters = [openmc.MeshFilter(mesh)]
+    tally.scores = ['flux', 'fission']
+    model.tallies = [tally]
+
+    replicated = run_results(model)
+    tally.decomposed = True
+    assert_same_results(run_results(model), replicated)
+
+
+def test_fused_mesh_walk(model):
+    # The surface tally reuses the crossings found by the tracklength tally
+    # only when both are over the same mesh, while an identical copy of the
+    # mesh gives separate walks. Neither mesh is aligned with the lattice.
+    def regular_mesh():
+        mesh = openmc.RegularMesh()
+        mesh.dimension = (10, 10, 3)
+        mesh.lower_left = (-10.71, -10.71, -100.0)
+        mesh.upper_right = (10.71, 10.71, 100.0)
+        return mesh
+
+    mesh = regular_mesh()
+    flux_filter = openmc.MeshFilter(regular_mesh())
+    flux_tally = openmc.Tally()
+    flux_tally.filters = [flux_filter]
+    flux_tally.scores = ['flux', 'total']
+    flux_tally.estimator = 'tracklength'
+    current_tally = openmc.Tally()
+    current_tally.filters = [openmc.MeshSurfaceFilter(mesh),
+                             openmc.EnergyFilter([0.0, 0.625, 20.0e6])]
+    current_tally.scores = ['current']
+    model.tallies = [flux_tally, current_tally]
+
+    # With a single thread, both walks score exactly the same values
+    separate = run_results(model, threads=1)
+    flux_filter.mesh = mesh
+    fused = run_results(model, threads=1)
+    assert np.count_nonzero(separate[current_tally.id][0]) > 0
+    for tally_id, (sum_, sum_sq) in separate.items():
+        assert np.array_equal(fused[tally_id][0], sum_)
+        assert np.array_equal(fused[tally_id][1], sum_sq)
@@ -0,0 +1,51 @@
+import glob
+import os
+
+import h5py
+import numpy as np
+import openmc
+import openmc.examples
+
+
+def test_single_file(run_in_tmpdir):
+    model = openmc.examples.pwr_pin_cell()
+    model.settings.particles = 100
+    model.settings.batches = 3
+    model.settings.inactive = 0
+    tracked = [(1, 1, 1), (1, 1, 7), (3, 1, 42)]
+    model.settings.track = [i for t in tracked for i in t]
+
+    # Coordinates of each particle from the files written per particle
+    model.run()
+    per_particle = {}
+    for batch, gen, particle in tracked:
+        with h5py.File(f'track_{batch}_{gen}_{particle}.h5', 'r') as f:
+            n = f.attrs['n_particles']
+            per_particle[batch, gen, particle] = [
+                f[f'coordinates_{i}'][()] for i in range(1, n + 1)]
+
+    for f in glob.glob('track_*.h5'):
+        os.remove(f)
+    model.settings.track_single_file = True
+    model.run()
+    assert not glob.glob('track_*.h5')
+
+    # The same tracks are found in the single file, where each row of "tracks"
+    # gives the batch, generation, particle, first state and number of states
+    with h5py.File('tracks.h5', 'r') as f:
+        assert f.attrs['filetype'].decode() == 'tracks'
+        states = f['states'][()]
+        tracks = f['tracks'][()]
+    single_file = {}
+    for batch, gen, particle, start, n in tracks:
+        single_file.setdefault((batch, gen, particle), []).append(
+            states[start:start + n])
+    assert sorted(single_file) == sorted(per_particle)
+
+    for key, coords in per_particle.items():
+        assert len(single_file[key]) == len(coords)
+        for s, c in zip(single_file[key], coords):
+            assert np.array_equal(s[:, :3], c)
+            # Each point also records the energy and weight of the particle
+            assert np.all(s[:, 3] > 0.0)
+            assert np.all(s[:, 4] > 0.0)
@@ -0,0 +1,115 @@
+import numpy as np
+import pytest
+
+import openmc
+
+
+@pytest.fixture
+def mesh():
+    mesh = openmc.RegularMesh()
+    mesh.dimension = [3, 1, 1]
+    mesh.lower_left = [-3., -1., -1.]
+    mesh.upper_right = [3., 1., 1.]
+    return mesh
+
+
+def test_bounds(mesh):
+    ww = openmc.WeightWindows(mesh, [0.1, 0.2, 0.3])
+    assert ww.lower_ww_bounds.shape == (3, 1)
+    assert ww.num_energy_groups == 1
+    with pytest.raises(ValueError):
+        openmc.WeightWindows(mesh, [0.1, 0.2, 0.3], [0.0, 1.0, 2.0e7])
+    with pytest.raises(ValueError):
+        openmc.WeightWindows(mesh, [0.1]*6, [1.0, 0.0, 2.0e7])
+
+
+def test_from_tally(mesh):
+    tally = openmc.Tally()
+    tally.filters = [openmc.MeshFilter(mesh),
+                     openmc.EnergyFilter([0.0, 1.0, 2.0e7])]
+    tally.scores = ['flux']
+
+    # Flux indexed by mesh cell then energy group. The last cell has no
+    # reliable estimate in the thermal group.
+    flux = np.array([[4.0, 10.0], [2.0, 5.0], [1.0, 1.0]])
+    std_dev = 0.1*flux
+    std_dev[2, 0] = 0.9
+    tally._mean = flux.reshape(-1, 1, 1)
+    tally._std_dev = std_dev.reshape(-1, 1, 1)
+
+    ww = openmc.WeightWindows.from_tally(tally, upper_bound_ratio=3.0)
+    assert ww.mesh is mesh
+    assert ww.energy_bounds == [0.0, 1.0, 2.0e7]
+    assert ww.particle_type == 'neutron'
+    assert ww.upper_bound_ratio == 3.0
+
+    # The window of the largest flux of each group is centered on unit weight
+    expected = 0.5*flux/flux.max(axis=0)
+    expected[2, 0] = -1.0
+    assert ww.lower_ww_bounds == pytest.approx(expected)
+
+
+def shield_model():
+    openmc.reset_auto_ids()
+    water = openmc.Material()
+    water.add_nuclide('H1', 2.0)
+    water.add_nuclide('O16', 1.0)
+    water.set_density('g/cm3', 1.0)
+
+    # A slab that is infinite in y and z, with a beam entering at x = 0
+    xmin = openmc.XPlane(0.0, boundary_type='vacuum')
+    xmax = openmc.XPlane(80.0, boundary_type='vacuum')
+    ymin = openmc.YPlane(-1.0, boundary_type='reflective')
+    ymax = openmc.YPlane(1.0, boundary_type='reflective')
+    zmin = openmc.ZPlane(-1.0, boundary_type='reflective')
+    zmax = openmc.ZPlane(1.0, boundary_type='reflective')
+    cell = openmc.Cell(fill=water,
+                       region=+xmin & -xmax & +ymin & -ymax & +zmin & -zmax)
+
+    model = openmc.model.Model()
+    model.materials = openmc.Materials([water])
+    model.geometry = openmc.Geometry([cell])
+    model.settings.run_mode = 'fixed source'
+    model.settings.particles = 1000
+    model.settings.batches = 10
+    model.settings.source = openmc.Source(
+        space=openmc.stats.Point((1.0e-6, 0.0, 0.0)),
+        angle=openmc.stats.Monodirectional((1.0, 0.0, 0.0)),
+        energy=openmc.stats.Discrete([2.0e6], [1.0]))
+
+    mesh = openmc.RegularMesh()
+    mesh.dimension = [8, 1, 1]
+    mesh.lower_left = [0.0, -1.0, -1.0]
+    mesh.upper_right = [80.0, 1.0, 1.0]
+    tally = openmc.Tally()
+    tally.filters = [openmc.MeshFilter(mesh)]
+    tally.scores = ['flux']
+    model.tallies = [tally]
+    return model
+
+
+def run_flux(model):
+    sp_name = model.run()
+    with openmc.StatePoint(sp_name) as sp:
+        tally = sp.tallies[model.tallies[0].id]
+        return tally, tally.mean.ravel(), tally.std_dev.ravel()
+
+
+def test_splitting_and_roulette(run_in_tmpdir):
+    model = shield_model()
+    tally, mean, std_dev = run_flux(model)
+
+    model.settings.weight_windows = openmc.WeightWindows.from_tally(tally)
+    _, mean_ww, std_dev_ww = run_flux(model)
+
+    # Splitting and Russian roulette preserve the expected flux, which is
+    # compared where the analog estimate is reliable
+    reliable = std_dev < 0.1*mean
+    assert np.all(mean_ww > 0.0)
+    diff = np.abs(mean_ww - mean)[reliable]
+    assert np.all(diff < 4.0*np.hypot(std_dev, std_dev_ww)[reliable])
+
+    # Particles are split as they penetrate the shield, which reduces the
+    # relative error of the flux far from the source
+    i = 5
+    assert std_dev_ww[i]/mean_ww[i] < std_dev[i]/mean[i]